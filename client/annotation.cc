@@ -27,10 +27,18 @@ static_assert(std::is_standard_layout<Annotation>::value,
 // static
 constexpr size_t Annotation::kNameMaxLength;
 constexpr size_t Annotation::kValueMaxSize;
+constexpr uint16_t Annotation::kFlagVersioned;
 
 void Annotation::SetSize(ValueSizeType size) {
   DCHECK_LT(size, kValueMaxSize);
   size_ = size;
+
+  // An annotation that is already in a list can’t be added again, so skip the
+  // list’s bookkeeping when called repeatedly.
+  if (link_node_.load(std::memory_order_relaxed)) {
+    return;
+  }
+
   // Use Register() instead of Get() in case the calling module has not
   // explicitly initialized the annotation list, to avoid crashing.
   AnnotationList::Register()->Add(this);
@@ -18,6 +18,7 @@
 #include <algorithm>
 #include <atomic>
 
+#include <stddef.h>
 #include <stdint.h>
 #include <string.h>
 #include <sys/types.h>
@@ -81,6 +82,11 @@ class Annotation {
   //! \brief The type used for \a SetSize().
   using ValueSizeType = uint32_t;
 
+  //! \brief A bit in \a flags() indicating that the annotation’s value is
+  //!     preceded by a VersionedAnnotationHeader, as written by
+  //!     VersionedAnnotation.
+  static constexpr uint16_t kFlagVersioned = 1 << 0;
+
   //! \brief The type of data stored in the annotation.
   enum class Type : uint16_t {
     //! \brief An invalid annotation. Reserved for internal use.
@@ -133,11 +139,7 @@ class Annotation {
   //!     pointer may not be changed once associated with an annotation, but
   //!     the data may be mutated.
   constexpr Annotation(Type type, const char name[], void* const value_ptr)
-      : link_node_(nullptr),
-        name_(name),
-        value_ptr_(value_ptr),
-        size_(0),
-        type_(type) {}
+      : Annotation(type, name, value_ptr, 0) {}
 
   Annotation(const Annotation&) = delete;
   Annotation& operator=(const Annotation&) = delete;
@@ -171,6 +173,7 @@ class Annotation {
   ValueSizeType size() const { return size_; }
   const char* name() const { return name_; }
   const void* value() const { return value_ptr_; }
+  uint16_t flags() const { return flags_; }
 
  protected:
   friend class AnnotationList;
@@ -178,6 +181,21 @@ class Annotation {
   friend class internal::InProcessIntermediateDumpHandler;
 #endif
 
+  //! \brief Constructs a new annotation with \a flags describing how its
+  //!     value is stored.
+  //!
+  //! \sa Annotation(Type, const char[], void* const)
+  constexpr Annotation(Type type,
+                       const char name[],
+                       void* const value_ptr,
+                       uint16_t flags)
+      : link_node_(nullptr),
+        name_(name),
+        value_ptr_(value_ptr),
+        size_(0),
+        type_(type),
+        flags_(flags) {}
+
   std::atomic<Annotation*>& link_node() { return link_node_; }
 
  private:
@@ -192,6 +210,10 @@ class Annotation {
   void* const value_ptr_;
   ValueSizeType size_;
   const Type type_;
+
+  //! \brief Bits such as \a kFlagVersioned. This occupies what would otherwise
+  //!     be padding, so readers that predate it ignore it.
+  const uint16_t flags_;
 };
 
 //! \brief An \sa Annotation that stores a `NUL`-terminated C-string value.
@@ -268,6 +290,170 @@ class StringAnnotation : public Annotation {
   char value_[MaxSize];
 };
 
+//! \brief The header that immediately precedes the value of an annotation with
+//!     Annotation::kFlagVersioned set.
+//!
+//! The value that Annotation::value() points to is the primary copy, which is
+//! followed, \a capacity bytes later, by a backup copy. Readers of the primary
+//! copy alone, unaware of versioning, see the annotation as they would any
+//! other.
+struct VersionedAnnotationHeader {
+  //! \brief A sequence number, odd while the primary copy is being written.
+  //!
+  //! While the sequence number is odd, the primary copy and Annotation::size()
+  //! may be inconsistent, and the backup copy holds the annotation’s value.
+  uint32_t sequence;
+
+  //! \brief The number of bytes of the backup copy that make up its value.
+  uint32_t backup_size;
+
+  //! \brief The size of each copy, and the offset from the primary copy to the
+  //!     backup copy.
+  uint32_t capacity;
+
+  uint32_t reserved;
+
+  //! \brief Determines which copy holds the value of an annotation, given
+  //!     this header as read from a process being examined.
+  //!
+  //! While the primary copy was being written, the backup copy holds the last
+  //! consistent value, and is used. Otherwise, the primary copy is. A header
+  //! that can’t describe the backup copy, because it isn’t consistent with the
+  //! primary copy’s size or exceeds Annotation::kValueMaxSize, is ignored, and
+  //! the primary copy is used.
+  //!
+  //! \param[in] size The size of the primary copy, Annotation::size().
+  //! \param[out] value_offset The offset of the copy holding the value from
+  //!     the primary copy: `0` for the primary copy, or #capacity for the
+  //!     backup copy.
+  //! \param[out] value_size The number of bytes in the value.
+  //!
+  //! \return `true` on success. `false` if this header is invalid, with \a
+  //!     value_offset and \a value_size describing the primary copy.
+  bool GetValueLocation(uint32_t size,
+                        uint32_t* value_offset,
+                        uint32_t* value_size) const {
+    *value_offset = 0;
+    *value_size = size;
+    if (capacity > Annotation::kValueMaxSize || backup_size > capacity ||
+        size > capacity) {
+      return false;
+    }
+    if (sequence & 1) {
+      *value_offset = capacity;
+      *value_size = backup_size;
+    }
+    return true;
+  }
+};
+
+//! \brief An \sa Annotation whose value is replaced without a crash report
+//!     being able to capture a partially-written value.
+//!
+//! Set() first writes the new value to a backup copy, then marks the primary
+//! copy as being written by making the sequence number in its
+//! VersionedAnnotationHeader odd, writes the primary copy, and makes the
+//! sequence number even again. A reader of the annotation from a crash, which
+//! will have stopped Set() at any point, uses the backup copy if it finds the
+//! sequence number odd, and the primary copy otherwise. This requires no
+//! synchronization heavier than release stores of the sequence number, so
+//! values may be replaced frequently.
+//!
+//! As with other annotations, Set() must not be called concurrently from
+//! multiple threads without external synchronization.
+//!
+//! \tparam MaxSize The maximum size of the value, in bytes.
+template <Annotation::ValueSizeType MaxSize>
+class VersionedAnnotation : public Annotation {
+ public:
+  //! \brief Constructs a new VersionedAnnotation.
+  //!
+  //! \param[in] type The data type of the value of the annotation.
+  //! \param[in] name The Annotation name.
+  constexpr VersionedAnnotation(Type type, const char name[])
+      : Annotation(type, name, storage_.primary, kFlagVersioned),
+        storage_{{0}, 0, MaxSize, 0, {}, {}} {}
+
+  VersionedAnnotation(const VersionedAnnotation&) = delete;
+  VersionedAnnotation& operator=(const VersionedAnnotation&) = delete;
+
+  //! \brief Sets the annotation’s value.
+  //!
+  //! \param[in] value The value.
+  //! \param[in] size The size of \a value, in bytes. At most \a MaxSize bytes
+  //!     are recorded.
+  void SetValue(const void* value, ValueSizeType size) {
+    size = std::min(MaxSize, size);
+    memcpy(storage_.backup, value, size);
+    storage_.backup_size = size;
+
+    const uint32_t sequence =
+        storage_.sequence.load(std::memory_order_relaxed);
+    storage_.sequence.store(sequence + 1, std::memory_order_release);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    memcpy(storage_.primary, value, size);
+    SetSize(size);
+
+    storage_.sequence.store(sequence + 2, std::memory_order_release);
+  }
+
+ private:
+  // The layout of this structure matches the VersionedAnnotationHeader
+  // followed by the primary and backup copies.
+  struct Storage {
+    std::atomic<uint32_t> sequence;
+    uint32_t backup_size;
+    uint32_t capacity;
+    uint32_t reserved;
+    char primary[MaxSize];
+    char backup[MaxSize];
+  };
+
+  static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t),
+                "std::atomic<uint32_t> size mismatch");
+  static_assert(offsetof(Storage, primary) ==
+                    sizeof(VersionedAnnotationHeader),
+                "VersionedAnnotationHeader size mismatch");
+  static_assert(offsetof(Storage, backup) ==
+                    offsetof(Storage, primary) + MaxSize,
+                "backup copy offset mismatch");
+
+  Storage storage_;
+};
+
+//! \brief A VersionedAnnotation that stores a string value, which is not
+//!     `NUL`-terminated, in the manner of StringAnnotation.
+template <Annotation::ValueSizeType MaxSize>
+class VersionedStringAnnotation : public VersionedAnnotation<MaxSize> {
+ public:
+  //! \brief Constructs a new VersionedStringAnnotation with the given \a name.
+  //!
+  //! \param[in] name The Annotation name.
+  constexpr explicit VersionedStringAnnotation(const char name[])
+      : VersionedAnnotation<MaxSize>(Annotation::Type::kString, name) {}
+
+  VersionedStringAnnotation(const VersionedStringAnnotation&) = delete;
+  VersionedStringAnnotation& operator=(const VersionedStringAnnotation&) =
+      delete;
+
+  //! \brief Sets the Annotation's string value.
+  //!
+  //! \param[in] string The string value.
+  void Set(base::StringPiece string) {
+    // Check for no embedded `NUL` characters.
+    DCHECK(!memchr(string.data(), '\0', string.size())) << "embedded NUL";
+    this->SetValue(string.data(),
+                   base::saturated_cast<Annotation::ValueSizeType>(
+                       string.size()));
+  }
+
+  const base::StringPiece value() const {
+    return base::StringPiece(
+        static_cast<const char*>(Annotation::value()), this->size());
+  }
+};
+
 }  // namespace crashpad
 
 #endif  // CRASHPAD_CLIENT_ANNOTATION_H_
@@ -14,11 +14,117 @@
 
 #include "client/annotation_list.h"
 
+#include <stdint.h>
+
 #include "base/check_op.h"
+#include "base/logging.h"
+#include "base/synchronization/lock.h"
+#include "build/build_config.h"
 #include "client/crashpad_info.h"
+#include "util/misc/from_pointer_cast.h"
+
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+#include <sys/syscall.h>
+#include <unistd.h>
+#elif BUILDFLAG(IS_APPLE)
+#include <errno.h>
+#include <pthread.h>
+#elif BUILDFLAG(IS_WIN)
+#include <windows.h>
+#elif BUILDFLAG(IS_FUCHSIA)
+#include <lib/zx/thread.h>
+
+#include "util/fuchsia/koid_utilities.h"
+#endif
 
 namespace crashpad {
 
+namespace {
+
+// Returns the calling thread’s ID, as ThreadSnapshot::ThreadID() reports it.
+uint64_t CurrentThreadID() {
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+  return syscall(SYS_gettid);
+#elif BUILDFLAG(IS_APPLE)
+  uint64_t thread_id;
+  errno = pthread_threadid_np(pthread_self(), &thread_id);
+  PCHECK(errno == 0) << "pthread_threadid_np";
+  return thread_id;
+#elif BUILDFLAG(IS_WIN)
+  return GetCurrentThreadId();
+#elif BUILDFLAG(IS_FUCHSIA)
+  return GetKoidForHandle(*zx::thread::self());
+#endif
+}
+
+// Guards the reuse and addition of per-thread list entries, which happen only
+// when a thread first requests its list and when it exits.
+base::Lock* ThreadListsLock() {
+  static base::Lock* lock = new base::Lock();
+  return lock;
+}
+
+}  // namespace
+
+// Owns the calling thread’s use of a per-thread list entry, releasing the entry
+// for reuse when the thread exits.
+class AnnotationList::ThreadListOwner {
+ public:
+  ThreadListOwner() : entry_(nullptr), list_(nullptr) {}
+
+  ThreadListOwner(const ThreadListOwner&) = delete;
+  ThreadListOwner& operator=(const ThreadListOwner&) = delete;
+
+  ~ThreadListOwner() {
+    if (!entry_) {
+      return;
+    }
+
+    base::AutoLock lock(*ThreadListsLock());
+
+    // Mark the entry unused before emptying the list, so that a crash in
+    // between doesn’t attribute another thread’s annotations to this one.
+    entry_->thread_id = 0;
+    list_->head_.link_node().store(&list_->tail_);
+  }
+
+  AnnotationList* Get() {
+    if (list_) {
+      return list_;
+    }
+
+    base::AutoLock lock(*ThreadListsLock());
+
+    CrashpadInfo* crashpad_info = CrashpadInfo::GetCrashpadInfo();
+    for (internal::ThreadAnnotationListEntry* entry =
+             crashpad_info->thread_annotation_lists();
+         entry;
+         entry = reinterpret_cast<internal::ThreadAnnotationListEntry*>(
+             static_cast<uintptr_t>(entry->next))) {
+      if (entry->thread_id == 0) {
+        entry_ = entry;
+        break;
+      }
+    }
+
+    if (!entry_) {
+      entry_ = new internal::ThreadAnnotationListEntry();
+      entry_->annotations_list =
+          FromPointerCast<uint64_t>(new AnnotationList());
+      crashpad_info->AddThreadAnnotationList(entry_);
+    }
+
+    entry_->thread_id = CurrentThreadID();
+    list_ = reinterpret_cast<AnnotationList*>(
+        static_cast<uintptr_t>(entry_->annotations_list));
+    return list_;
+  }
+
+ private:
+  internal::ThreadAnnotationListEntry* entry_;  // weak
+  AnnotationList* list_;  // weak
+};
+
 AnnotationList::AnnotationList()
     : tail_pointer_(&tail_),
       head_(Annotation::Type::kInvalid, nullptr, nullptr),
@@ -43,6 +149,12 @@ AnnotationList* AnnotationList::Register() {
   return list;
 }
 
+// static
+AnnotationList* AnnotationList::ForCurrentThread() {
+  thread_local ThreadListOwner owner;
+  return owner.Get();
+}
+
 void AnnotationList::Add(Annotation* annotation) {
   Annotation* null = nullptr;
   Annotation* head_next = head_.link_node().load(std::memory_order_relaxed);
@@ -48,6 +48,25 @@ class AnnotationList {
   //!     it if one is not already set on the CrashapdInfo structure.
   static AnnotationList* Register();
 
+  //! \brief Returns the calling thread’s list, creating it and registering it
+  //!     on the CrashpadInfo structure the first time it is requested on each
+  //!     thread.
+  //!
+  //! Annotations added to a thread’s list are reported with the ID of the
+  //! thread. Since only the calling thread adds to its list, Add() never
+  //! contends with other threads, as it can for the global list. An annotation
+  //! must be added explicitly, before it’s first set, or it will be added to
+  //! the global list instead.
+  //!
+  //! When the thread exits, its list is emptied and may be reused by another
+  //! thread. Annotations that were in it are no longer reported, and can’t be
+  //! added to any list again, so they should be used only by the thread that
+  //! added them, for example by giving them thread storage duration.
+  //!
+  //! Per-thread lists are currently only read from modules on Linux, ChromeOS,
+  //! Android, and Fuchsia.
+  static AnnotationList* ForCurrentThread();
+
   //! \brief Adds \a annotation to the global list. This method does not need
   //!     to be called by clients directly. The Annotation object will do so
   //!     automatically.
@@ -98,6 +117,8 @@ class AnnotationList {
   const Annotation* head() const { return &head_; }
 
  private:
+  class ThreadListOwner;
+
   // To make it easier for the handler to locate the dummy tail node, store the
   // pointer. Placed first for packing.
   const Annotation* const tail_pointer_;
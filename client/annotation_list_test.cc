@@ -21,6 +21,7 @@
 #include "client/crashpad_info.h"
 #include "gtest/gtest.h"
 #include "util/misc/clock.h"
+#include "util/misc/from_pointer_cast.h"
 #include "util/thread/thread.h"
 
 namespace crashpad {
@@ -178,6 +179,87 @@ TEST_F(AnnotationList, MultipleThreads) {
   }
 }
 
+internal::ThreadAnnotationListEntry* EntryForList(
+    crashpad::AnnotationList* list) {
+  for (internal::ThreadAnnotationListEntry* entry =
+           CrashpadInfo::GetCrashpadInfo()->thread_annotation_lists();
+       entry;
+       entry = reinterpret_cast<internal::ThreadAnnotationListEntry*>(
+           static_cast<uintptr_t>(entry->next))) {
+    if (entry->annotations_list == FromPointerCast<uint64_t>(list)) {
+      return entry;
+    }
+  }
+  return nullptr;
+}
+
+class ThreadListThread : public Thread {
+ public:
+  ThreadListThread()
+      : Thread(),
+        list_(nullptr),
+        entry_thread_id_(0),
+        list_had_annotation_(false) {}
+
+  crashpad::AnnotationList* list() const { return list_; }
+  uint64_t entry_thread_id() const { return entry_thread_id_; }
+  bool list_had_annotation() const { return list_had_annotation_; }
+
+ private:
+  void ThreadMain() override {
+    list_ = crashpad::AnnotationList::ForCurrentThread();
+    EXPECT_EQ(list_, crashpad::AnnotationList::ForCurrentThread());
+
+    thread_local crashpad::StringAnnotation<8> annotation("thread");
+    list_->Add(&annotation);
+    annotation.Set("value");
+    list_had_annotation_ = list_->begin() != list_->end() &&
+                           *list_->begin() == &annotation;
+
+    internal::ThreadAnnotationListEntry* entry = EntryForList(list_);
+    if (entry) {
+      entry_thread_id_ = entry->thread_id;
+    }
+  }
+
+  crashpad::AnnotationList* list_;
+  uint64_t entry_thread_id_;
+  bool list_had_annotation_;
+};
+
+TEST(AnnotationListStatic, ForCurrentThread) {
+  crashpad::AnnotationList* list =
+      crashpad::AnnotationList::ForCurrentThread();
+  ASSERT_TRUE(list);
+  EXPECT_EQ(list, crashpad::AnnotationList::ForCurrentThread());
+  EXPECT_NE(list, crashpad::AnnotationList::Get());
+
+  internal::ThreadAnnotationListEntry* entry = EntryForList(list);
+  ASSERT_TRUE(entry);
+  EXPECT_NE(entry->thread_id, 0u);
+
+  ThreadListThread thread;
+  thread.Start();
+  thread.Join();
+
+  EXPECT_NE(thread.list(), list);
+  EXPECT_TRUE(thread.list_had_annotation());
+  EXPECT_NE(thread.entry_thread_id(), 0u);
+  EXPECT_NE(thread.entry_thread_id(), entry->thread_id);
+
+  // Once the thread has exited, its list is empty and available for reuse.
+  internal::ThreadAnnotationListEntry* thread_entry =
+      EntryForList(thread.list());
+  ASSERT_TRUE(thread_entry);
+  EXPECT_EQ(thread_entry->thread_id, 0u);
+  EXPECT_TRUE(thread.list()->begin() == thread.list()->end());
+
+  ThreadListThread reuse_thread;
+  reuse_thread.Start();
+  reuse_thread.Join();
+  EXPECT_EQ(reuse_thread.list(), thread.list());
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace crashpad
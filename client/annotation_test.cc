@@ -14,6 +14,8 @@
 
 #include "client/annotation.h"
 
+#include <string.h>
+
 #include <array>
 #include <string>
 
@@ -108,6 +110,86 @@ TEST_F(Annotation, StringType) {
   EXPECT_EQ("loooo", annotation.value());
 }
 
+TEST_F(Annotation, VersionedStringType) {
+  crashpad::VersionedStringAnnotation<5> annotation("name");
+
+  EXPECT_FALSE(annotation.is_set());
+
+  EXPECT_EQ(crashpad::Annotation::Type::kString, annotation.type());
+  EXPECT_EQ(crashpad::Annotation::kFlagVersioned, annotation.flags());
+  EXPECT_EQ(0u, annotation.size());
+  EXPECT_EQ(0u, annotation.value().size());
+
+  const crashpad::VersionedAnnotationHeader* header =
+      reinterpret_cast<const crashpad::VersionedAnnotationHeader*>(
+          static_cast<const char*>(
+              static_cast<const crashpad::Annotation&>(annotation).value()) -
+          sizeof(crashpad::VersionedAnnotationHeader));
+  EXPECT_EQ(0u, header->sequence);
+  EXPECT_EQ(5u, header->capacity);
+
+  annotation.Set("test");
+
+  EXPECT_TRUE(annotation.is_set());
+  EXPECT_EQ(1u, AnnotationsCount());
+  EXPECT_EQ("test", annotation.value());
+
+  // Each update leaves the sequence number even, with the backup copy matching
+  // the primary copy.
+  EXPECT_EQ(2u, header->sequence);
+  EXPECT_EQ(4u, header->backup_size);
+  EXPECT_EQ(0,
+            memcmp(reinterpret_cast<const char*>(header + 1) + header->capacity,
+                   "test",
+                   4));
+
+  annotation.Set("loooooooooooong");
+
+  EXPECT_EQ(1u, AnnotationsCount());
+  EXPECT_EQ("loooo", annotation.value());
+  EXPECT_EQ(4u, header->sequence);
+  EXPECT_EQ(5u, header->backup_size);
+
+  annotation.Clear();
+
+  EXPECT_FALSE(annotation.is_set());
+  EXPECT_EQ(0u, AnnotationsCount());
+}
+
+TEST(VersionedAnnotationHeader, GetValueLocation) {
+  crashpad::VersionedAnnotationHeader header = {};
+  header.backup_size = 3;
+  header.capacity = 8;
+
+  uint32_t value_offset;
+  uint32_t value_size;
+  EXPECT_TRUE(header.GetValueLocation(5, &value_offset, &value_size));
+  EXPECT_EQ(0u, value_offset);
+  EXPECT_EQ(5u, value_size);
+
+  // While the primary copy is being written, the backup copy is used.
+  header.sequence = 1;
+  EXPECT_TRUE(header.GetValueLocation(5, &value_offset, &value_size));
+  EXPECT_EQ(8u, value_offset);
+  EXPECT_EQ(3u, value_size);
+
+  // An invalid header leaves the primary copy in use.
+  EXPECT_FALSE(header.GetValueLocation(9, &value_offset, &value_size));
+  EXPECT_EQ(0u, value_offset);
+  EXPECT_EQ(9u, value_size);
+
+  header.backup_size = 9;
+  EXPECT_FALSE(header.GetValueLocation(5, &value_offset, &value_size));
+  EXPECT_EQ(0u, value_offset);
+  EXPECT_EQ(5u, value_size);
+
+  header.backup_size = 3;
+  header.capacity = crashpad::Annotation::kValueMaxSize + 1;
+  EXPECT_FALSE(header.GetValueLocation(5, &value_offset, &value_size));
+  EXPECT_EQ(0u, value_offset);
+  EXPECT_EQ(5u, value_size);
+}
+
 TEST(StringAnnotation, ArrayOfString) {
   static crashpad::StringAnnotation<4> annotations[] = {
       {"test-1", crashpad::StringAnnotation<4>::Tag::kArray},
@@ -14,12 +14,23 @@
 
 #include "client/crash_report_database.h"
 
+#include <inttypes.h>
+#include <string.h>
 #include <sys/stat.h>
+#include <time.h>
+
+#include <algorithm>
+#include <iterator>
+#include <tuple>
+#include <vector>
 
 #include "base/logging.h"
+#include "base/strings/stringprintf.h"
 #include "base/strings/utf_string_conversions.h"
 #include "build/build_config.h"
+#include "third_party/zlib/zlib_crashpad.h"
 #include "util/file/directory_reader.h"
+#include "util/file/file_helper.h"
 #include "util/file/filesystem.h"
 
 namespace crashpad {
@@ -27,6 +38,12 @@ namespace crashpad {
 namespace {
 constexpr base::FilePath::CharType kAttachmentsDirectory[] =
     FILE_PATH_LITERAL("attachments");
+constexpr base::FilePath::CharType kSharedAttachmentsDirectory[] =
+    FILE_PATH_LITERAL("shared_attachments");
+constexpr base::FilePath::CharType kTemporaryExtension[] =
+    FILE_PATH_LITERAL(".tmp");
+
+constexpr size_t kAttachmentBufferSize = 64 * 1024;
 
 bool AttachmentNameIsOK(const std::string& name) {
   for (const char c : name) {
@@ -35,6 +52,82 @@ bool AttachmentNameIsOK(const std::string& name) {
   }
   return true;
 }
+
+// Reads |file| from its start to its end, computing the size and CRC-32 of its
+// contents.
+bool DigestFile(FileHandle file, uint64_t* size, uint32_t* crc) {
+  if (LoggingSeekFile(file, 0, SEEK_SET) != 0) {
+    return false;
+  }
+
+  WeakFileHandleFileReader reader(file);
+  std::vector<uint8_t> buffer(kAttachmentBufferSize);
+  uLong crc_value = crc32(0, nullptr, 0);
+  uint64_t total = 0;
+  FileOperationResult read_result;
+  while ((read_result = reader.Read(buffer.data(), buffer.size())) > 0) {
+    crc_value = crc32(crc_value, buffer.data(), static_cast<uInt>(read_result));
+    total += read_result;
+  }
+  if (read_result < 0) {
+    return false;
+  }
+
+  *size = total;
+  *crc = static_cast<uint32_t>(crc_value);
+  return true;
+}
+
+// Returns whether the file at |path| has the same contents as |file|.
+bool FileContentsEqual(const base::FilePath& path, FileHandle file) {
+  FileReader stored;
+  if (!stored.Open(path) || LoggingSeekFile(file, 0, SEEK_SET) != 0) {
+    return false;
+  }
+
+  WeakFileHandleFileReader reader(file);
+  std::vector<uint8_t> buffer(kAttachmentBufferSize);
+  std::vector<uint8_t> stored_buffer(kAttachmentBufferSize);
+  FileOperationResult read_result;
+  while ((read_result = reader.Read(buffer.data(), buffer.size())) > 0) {
+    if (!stored.ReadExactly(stored_buffer.data(), read_result) ||
+        memcmp(buffer.data(), stored_buffer.data(), read_result) != 0) {
+      return false;
+    }
+  }
+  return read_result == 0 && stored.Read(stored_buffer.data(), 1) == 0;
+}
+
+// Copies the contents of |file| to a new file at |path|, returning false
+// without leaving a file at |path| if they can’t be copied in full.
+bool CopyToNewFile(FileHandle file, const base::FilePath& path) {
+  if (LoggingSeekFile(file, 0, SEEK_SET) != 0) {
+    return false;
+  }
+
+  FileWriter writer;
+  if (!writer.Open(
+          path, FileWriteMode::kCreateOrFail, FilePermissions::kOwnerOnly)) {
+    return false;
+  }
+  ScopedRemoveFile remover(path);
+
+  WeakFileHandleFileReader reader(file);
+  std::vector<uint8_t> buffer(kAttachmentBufferSize);
+  FileOperationResult read_result;
+  while ((read_result = reader.Read(buffer.data(), buffer.size())) > 0) {
+    if (!writer.Write(buffer.data(), read_result)) {
+      return false;
+    }
+  }
+  if (read_result < 0) {
+    return false;
+  }
+
+  writer.Close();
+  std::ignore = remover.release();
+  return true;
+}
 }  // namespace
 
 CrashReportDatabase::Report::Report()
@@ -92,23 +185,33 @@ FileReaderInterface* CrashReportDatabase::NewReport::Reader() {
   return reader_.get();
 }
 
-FileWriter* CrashReportDatabase::NewReport::AddAttachment(
-    const std::string& name) {
+bool CrashReportDatabase::NewReport::PrepareAttachmentPath(
+    const std::string& name,
+    base::FilePath* path) {
   if (!AttachmentNameIsOK(name)) {
     LOG(ERROR) << "invalid name for attachment " << name;
-    return nullptr;
+    return false;
   }
   base::FilePath report_attachments_dir = database_->AttachmentsPath(uuid_);
   if (!LoggingCreateDirectory(
           report_attachments_dir, FilePermissions::kOwnerOnly, true)) {
-    return nullptr;
+    return false;
   }
 #if BUILDFLAG(IS_WIN)
   const std::wstring name_string = base::UTF8ToWide(name);
 #else
   const std::string name_string = name;
 #endif
-  base::FilePath attachment_path = report_attachments_dir.Append(name_string);
+  *path = report_attachments_dir.Append(name_string);
+  return true;
+}
+
+FileWriter* CrashReportDatabase::NewReport::AddAttachment(
+    const std::string& name) {
+  base::FilePath attachment_path;
+  if (!PrepareAttachmentPath(name, &attachment_path)) {
+    return nullptr;
+  }
   auto writer = std::make_unique<FileWriter>();
   if (!writer->Open(attachment_path,
                     FileWriteMode::kCreateOrFail,
@@ -120,6 +223,78 @@ FileWriter* CrashReportDatabase::NewReport::AddAttachment(
   return attachment_writers_.back().get();
 }
 
+bool CrashReportDatabase::NewReport::AddAttachmentFromFile(
+    const std::string& name,
+    FileHandle file) {
+  if (database_->deduplicate_attachments_ && AddSharedAttachment(name, file)) {
+    return true;
+  }
+
+  FileWriter* writer = AddAttachment(name);
+  if (!writer || LoggingSeekFile(file, 0, SEEK_SET) != 0) {
+    return false;
+  }
+
+  CloneOrCopyFileContent(file, writer);
+  return true;
+}
+
+bool CrashReportDatabase::NewReport::AddSharedAttachment(
+    const std::string& name,
+    FileHandle file) {
+  base::FilePath attachment_path;
+  if (!PrepareAttachmentPath(name, &attachment_path)) {
+    return false;
+  }
+
+  uint64_t size;
+  uint32_t crc;
+  if (!DigestFile(file, &size, &crc)) {
+    return false;
+  }
+
+  const base::FilePath shared_dir = database_->SharedAttachmentsPath();
+  if (!LoggingCreateDirectory(shared_dir, FilePermissions::kOwnerOnly, true)) {
+    return false;
+  }
+
+  // The size and CRC-32 locate a stored attachment that may be the same, and
+  // comparing the contents confirms it.
+  const std::string shared_name =
+      base::StringPrintf("%016" PRIx64 "-%08" PRIx32, size, crc);
+#if BUILDFLAG(IS_WIN)
+  const base::FilePath shared_path =
+      shared_dir.Append(base::UTF8ToWide(shared_name));
+  const base::FilePath temporary_path = shared_dir.Append(
+      base::UTF8ToWide(shared_name + "." + uuid_.ToString()) +
+      kTemporaryExtension);
+#else
+  const base::FilePath shared_path = shared_dir.Append(shared_name);
+  const base::FilePath temporary_path = shared_dir.Append(
+      shared_name + "." + uuid_.ToString() + kTemporaryExtension);
+#endif
+
+  if (!IsRegularFile(shared_path) || !FileContentsEqual(shared_path, file)) {
+    // This is stored under a temporary name first, so that a partial copy is
+    // never linked to. Different contents with the same size and CRC-32
+    // replace the stored attachment, but reports already linked to it keep
+    // their own links to its contents.
+    if (!CopyToNewFile(file, temporary_path)) {
+      return false;
+    }
+    if (!MoveFileOrDirectory(temporary_path, shared_path)) {
+      LoggingRemoveFile(temporary_path);
+      return false;
+    }
+  }
+
+  if (!MakeHardLink(shared_path, attachment_path)) {
+    return false;
+  }
+  attachment_removers_.emplace_back(ScopedRemoveFile(attachment_path));
+  return true;
+}
+
 void CrashReportDatabase::UploadReport::InitializeAttachments() {
   base::FilePath report_attachments_dir = database_->AttachmentsPath(uuid);
   DirectoryReader dir_reader;
@@ -176,6 +351,89 @@ CrashReportDatabase::OperationStatus CrashReportDatabase::RecordUploadComplete(
   return RecordUploadAttempt(report, true, id);
 }
 
+CrashReportDatabase::OperationStatus CrashReportDatabase::GetOldestReports(
+    size_t max_reports,
+    std::vector<Report>* reports,
+    uint64_t* total_size) {
+  DCHECK(reports->empty());
+
+  std::vector<Report> all_reports;
+  OperationStatus status = GetPendingReports(&all_reports);
+  if (status != kNoError) {
+    return status;
+  }
+
+  std::vector<Report> completed_reports;
+  status = GetCompletedReports(&completed_reports);
+  if (status != kNoError) {
+    return status;
+  }
+  all_reports.insert(all_reports.end(),
+                     std::make_move_iterator(completed_reports.begin()),
+                     std::make_move_iterator(completed_reports.end()));
+
+  uint64_t size = 0;
+  for (const Report& report : all_reports) {
+    size += report.total_size;
+  }
+
+  // Order reports created at the same time by UUID, as databases that track
+  // report ages do.
+  std::sort(all_reports.begin(),
+            all_reports.end(),
+            [](const Report& lhs, const Report& rhs) {
+              return lhs.creation_time != rhs.creation_time
+                         ? lhs.creation_time < rhs.creation_time
+                         : lhs.uuid < rhs.uuid;
+            });
+  if (all_reports.size() > max_reports) {
+    all_reports.resize(max_reports);
+  }
+
+  reports->swap(all_reports);
+  *total_size = size;
+  return kNoError;
+}
+
+CrashReportDatabase::OperationStatus CrashReportDatabase::GetStatistics(
+    Statistics* statistics) {
+  std::vector<Report> pending_reports;
+  OperationStatus status = GetPendingReports(&pending_reports);
+  if (status != kNoError) {
+    return status;
+  }
+
+  std::vector<Report> completed_reports;
+  status = GetCompletedReports(&completed_reports);
+  if (status != kNoError) {
+    return status;
+  }
+
+  *statistics = Statistics();
+  statistics->pending_reports = pending_reports.size();
+  statistics->completed_reports = completed_reports.size();
+  for (const Report& report : pending_reports) {
+    statistics->total_size += report.total_size;
+  }
+  for (const Report& report : completed_reports) {
+    statistics->total_size += report.total_size;
+  }
+  return kNoError;
+}
+
+std::unique_ptr<const CrashReportDatabase::UploadReport>
+CrashReportDatabase::OpenReportForReading(const Report& report) {
+  auto upload_report = std::make_unique<UploadReport>();
+  *static_cast<Report*>(upload_report.get()) = report;
+  if (!upload_report->Initialize(report.file_path, this)) {
+    return nullptr;
+  }
+
+  // The report isn’t being uploaded, so nothing is recorded when it’s closed.
+  upload_report->database_ = nullptr;
+  return upload_report;
+}
+
 base::FilePath CrashReportDatabase::AttachmentsPath(const UUID& uuid) {
 #if BUILDFLAG(IS_WIN)
   const std::wstring uuid_string = uuid.ToWString();
@@ -190,6 +448,10 @@ base::FilePath CrashReportDatabase::AttachmentsRootPath() {
   return DatabasePath().Append(kAttachmentsDirectory);
 }
 
+base::FilePath CrashReportDatabase::SharedAttachmentsPath() {
+  return DatabasePath().Append(kSharedAttachmentsDirectory);
+}
+
 void CrashReportDatabase::RemoveAttachmentsByUUID(const UUID& uuid) {
   base::FilePath report_attachment_dir = AttachmentsPath(uuid);
   if (!IsDirectory(report_attachment_dir, /*allow_symlinks=*/false)) {
@@ -212,4 +474,34 @@ void CrashReportDatabase::RemoveAttachmentsByUUID(const UUID& uuid) {
   LoggingRemoveDirectory(report_attachment_dir);
 }
 
+void CrashReportDatabase::CleanSharedAttachments(time_t lockfile_ttl) {
+  const base::FilePath shared_dir = SharedAttachmentsPath();
+  if (!IsDirectory(shared_dir, /*allow_symlinks=*/false)) {
+    return;
+  }
+  DirectoryReader reader;
+  if (!reader.Open(shared_dir)) {
+    return;
+  }
+
+  const time_t now = time(nullptr);
+  base::FilePath filename;
+  DirectoryReader::Result result;
+  while ((result = reader.NextFile(&filename)) ==
+         DirectoryReader::Result::kSuccess) {
+    const base::FilePath path(shared_dir.Append(filename));
+    timespec filetime;
+    if (!FileModificationTime(path, &filetime) ||
+        filetime.tv_sec > now - lockfile_ttl) {
+      continue;
+    }
+
+    // A stored attachment with no links but its own belongs to no report.
+    if (filename.FinalExtension() == kTemporaryExtension ||
+        GetFileLinkCount(path) == 1) {
+      LoggingRemoveFile(path);
+    }
+  }
+}
+
 }  // namespace crashpad
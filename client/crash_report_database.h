@@ -24,6 +24,7 @@
 #include <vector>
 
 #include "base/files/file_path.h"
+#include "build/build_config.h"
 #include "util/file/file_io.h"
 #include "util/file/file_reader.h"
 #include "util/file/file_writer.h"
@@ -104,6 +105,19 @@ class CrashReportDatabase {
     uint64_t total_size;
   };
 
+  //! \brief The numbers of reports in a database, and the space they take, as
+  //!     obtained by GetStatistics().
+  struct Statistics {
+    //! The number of reports in the pending state, eligible for upload.
+    size_t pending_reports = 0;
+
+    //! The number of reports in the completed state, not eligible for upload.
+    size_t completed_reports = 0;
+
+    //! The sum of Report::total_size over all pending and completed reports.
+    uint64_t total_size = 0;
+  };
+
   //! \brief A crash report that is in the process of being written.
   //!
   //! An instance of this class should be created via PrepareNewCrashReport().
@@ -137,6 +151,21 @@ class CrashReportDatabase {
     //!     the attachment, or `nullptr` on failure with an error logged.
     FileWriter* AddAttachment(const std::string& name);
 
+    //! \brief Adds an attachment to the report with the contents of a file.
+    //!
+    //! If the database has attachment deduplication enabled by
+    //! CrashReportDatabase::EnableAttachmentDeduplication(), contents identical
+    //! to an attachment already stored in the database are linked to it
+    //! instead of being written again. Otherwise, or if they can’t be linked,
+    //! the contents are copied as they would be to a FileWriter returned by
+    //! AddAttachment().
+    //!
+    //! \param[in] name The key and name for the attachment, as for
+    //!     AddAttachment().
+    //! \param[in] file The file whose whole contents are attached.
+    //! \return `true` on success, `false` on failure with an error logged.
+    bool AddAttachmentFromFile(const std::string& name, FileHandle file);
+
    private:
     friend class CrashReportDatabaseGeneric;
     friend class CrashReportDatabaseMac;
@@ -146,6 +175,14 @@ class CrashReportDatabase {
                     const base::FilePath& directory,
                     const base::FilePath::StringType& extension);
 
+    // Validates |name|, creates the report’s attachments directory, and
+    // returns the path for the attachment named |name| in |path|.
+    bool PrepareAttachmentPath(const std::string& name, base::FilePath* path);
+
+    // Links the attachment named |name| to the database’s stored copy of the
+    // contents of |file|, storing them first if there isn’t one.
+    bool AddSharedAttachment(const std::string& name, FileHandle file);
+
     std::unique_ptr<FileWriter> writer_;
     std::unique_ptr<FileReader> reader_;
     ScopedRemoveFile file_remover_;
@@ -266,6 +303,61 @@ class CrashReportDatabase {
   static std::unique_ptr<CrashReportDatabase> InitializeWithoutCreating(
       const base::FilePath& path);
 
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID) || \
+    DOXYGEN
+  //! \brief Opens a database of crash reports, creating it with compact
+  //!     metadata if it does not yet exist.
+  //!
+  //! A database with compact metadata keeps each report’s metadata only in
+  //! the database’s index, a single file of appended records, rather than in
+  //! a metadata file beside each report, and locks reports with byte-range
+  //! locks on a single file rather than by creating a lock file for each
+  //! report, so that a report’s state changes create and remove far fewer
+  //! files. A database keeps the mode that it was created with, whichever
+  //! method opens it later. A database with compact metadata must not be
+  //! opened by versions of Crashpad that predate it.
+  //!
+  //! If the system doesn’t support open file description locks, the database
+  //! is created without compact metadata.
+  //!
+  //! \param[in] path A path to the database to be created or opened.
+  //!
+  //! \return A database object on success, `nullptr` on failure with an error
+  //!     logged.
+  //!
+  //! \sa Initialize
+  static std::unique_ptr<CrashReportDatabase> InitializeWithCompactMetadata(
+      const base::FilePath& path);
+
+  //! \brief Opens a database of crash reports, creating it if it does not yet
+  //!     exist, and keeps its reports in shards.
+  //!
+  //! A sharded database keeps each pending or completed report in a
+  //! subdirectory of its state’s directory named for the first characters of
+  //! the report’s UUID, so that no directory grows large when many reports
+  //! accumulate, and finding a report only reads small directories. An
+  //! existing database adopts shards when it is opened by this method, and
+  //! its reports are moved into them. A database keeps its reports in shards
+  //! from then on, whichever method opens it later, and its reports in shards
+  //! can’t be found by versions of Crashpad that predate them. Reports that
+  //! such versions add outside of shards are found there, and are moved into
+  //! shards when the database is next opened or cleaned.
+  //!
+  //! \param[in] path A path to the database to be created or opened.
+  //! \param[in] compact_metadata Whether the database is created with compact
+  //!     metadata, as by InitializeWithCompactMetadata(), if it does not yet
+  //!     exist.
+  //!
+  //! \return A database object on success, `nullptr` on failure with an error
+  //!     logged.
+  //!
+  //! \sa Initialize
+  static std::unique_ptr<CrashReportDatabase> InitializeWithShardedReports(
+      const base::FilePath& path,
+      bool compact_metadata);
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID) || DOXYGEN
+
   //! \brief Returns the Settings object for this database.
   //!
   //! \return A weak pointer to the Settings object, which is owned by the
@@ -277,6 +369,56 @@ class CrashReportDatabase {
   //! \return The filepath of the database;
   virtual base::FilePath DatabasePath() = 0;
 
+  //! \brief The path to a file that is written each time a report becomes
+  //!     pending.
+  //!
+  //! The file is written once the report can be found by GetPendingReports()
+  //! and checked out by GetReportForUploading(), so a process watching it can
+  //! notice reports made pending by other processes without periodically
+  //! scanning the database. The file may also be written when no report has
+  //! become pending, and may be opened for writing without being written.
+  //!
+  //! \return The path to the file, or an empty path if the database doesn’t
+  //!     have one. The default implementation returns an empty path.
+  virtual base::FilePath PendingReportsChangePath() { return base::FilePath(); }
+
+  //! \brief Makes each report durable before FinishedWritingCrashReport()
+  //!     returns, sharing the syncs that do so among reports finished at about
+  //!     the same time.
+  //!
+  //! By default, a report’s files are not synced to storage, so a report
+  //! finished shortly before the system crashes or loses power may be lost or
+  //! left incomplete. Once this is called, FinishedWritingCrashReport() syncs
+  //! each report’s files before moving the report into place, and then waits
+  //! for a sync that makes the move durable. That sync is shared by all of the
+  //! reports finished within \a window of one another, so that a burst of
+  //! crashes isn’t slowed by a sync for each. A report finished while no other
+  //! is being finished is synced right away.
+  //!
+  //! This is only implemented on Linux, ChromeOS, Android, and Fuchsia, and
+  //! does nothing elsewhere. It must be called before any report is finished.
+  //!
+  //! \param[in] window The longest time, in seconds, that a finished report
+  //!     waits for others being finished to share its sync.
+  virtual void EnableGroupCommit(double window) { (void)window; }
+
+  //! \brief Stores attachments added with NewReport::AddAttachmentFromFile()
+  //!     once for all of the reports that have them.
+  //!
+  //! Each distinct attachment is stored in the database under a digest of its
+  //! contents, and is hard-linked into each report that has it, so that reports
+  //! with the same attachment, such as those from a crash loop, don’t each
+  //! take the time and space to write a copy. A stored attachment’s link
+  //! count is its reference count: deleting a report removes only its links,
+  //! and CleanDatabase() removes stored attachments that no report links to.
+  //!
+  //! Report::total_size still counts each report’s attachments in full, so
+  //! pruning by size may remove more reports than needed, but never too few.
+  //!
+  //! Where the filesystem doesn’t support hard links, attachments are copied
+  //! as they are without deduplication.
+  void EnableAttachmentDeduplication() { deduplicate_attachments_ = true; }
+
   //! \brief Creates a record of a new crash report.
   //!
   //! Callers should write the crash report using the FileWriter provided.
@@ -332,6 +474,42 @@ class CrashReportDatabase {
   //! \return The operation status code.
   virtual OperationStatus GetCompletedReports(std::vector<Report>* reports) = 0;
 
+  //! \brief Returns the oldest pending and completed crash report records,
+  //!     along with the total size of all pending and completed reports.
+  //!
+  //! This allows a database to be pruned from its oldest reports without
+  //! evaluating every report. The default implementation obtains all reports
+  //! with GetPendingReports() and GetCompletedReports(). Implementations that
+  //! keep track of report ages and sizes as reports are added and removed may
+  //! override it to avoid doing so.
+  //!
+  //! \param[in] max_reports The maximum number of records to return.
+  //! \param[out] reports Up to \a max_reports crash report record objects,
+  //!     sorted in ascending order by Report::creation_time. This must be empty
+  //!     on entry. Only valid if this returns #kNoError.
+  //! \param[out] total_size The sum of Report::total_size over all pending and
+  //!     completed reports, including those not returned in \a reports. Only
+  //!     valid if this returns #kNoError.
+  //!
+  //! \return The operation status code.
+  virtual OperationStatus GetOldestReports(size_t max_reports,
+                                           std::vector<Report>* reports,
+                                           uint64_t* total_size);
+
+  //! \brief Returns the numbers of pending and completed reports, and the
+  //!     total size of those reports.
+  //!
+  //! The default implementation obtains all reports with GetPendingReports()
+  //! and GetCompletedReports(). Implementations that keep track of report
+  //! states and sizes may override it to avoid reading every report’s
+  //! metadata.
+  //!
+  //! \param[out] statistics The statistics. Only valid if this returns
+  //!     #kNoError.
+  //!
+  //! \return The operation status code.
+  virtual OperationStatus GetStatistics(Statistics* statistics);
+
   //! \brief Obtains and locks a report object for uploading to a collection
   //!     server. On iOS the file lock is released and mutual-exclusion is kept
   //!     via a file attribute.
@@ -363,6 +541,22 @@ class CrashReportDatabase {
       std::unique_ptr<const UploadReport>* report,
       bool report_metrics = true) = 0;
 
+  //! \brief Opens a report’s minidump and attachments for reading, without
+  //!     locking the report for upload or recording an upload attempt.
+  //!
+  //! This allows a report to be examined while it remains pending, for
+  //! example to prepare for its upload. Nothing prevents the report from
+  //! being uploaded or deleted while it is open, although files that are
+  //! already open can still be read on POSIX systems.
+  //!
+  //! \param[in] report A report obtained from this database.
+  //!
+  //! \return The opened report, whose UploadReport::Reader() and
+  //!     UploadReport::GetAttachments() may be used, or `nullptr` with a
+  //!     message logged if the report’s minidump could not be opened.
+  std::unique_ptr<const UploadReport> OpenReportForReading(
+      const Report& report);
+
   //! \brief Records a successful upload for a report and updates the last
   //!     upload attempt time as returned by
   //!     Settings::GetLastUploadAttemptTime().
@@ -442,6 +636,20 @@ class CrashReportDatabase {
   //! \param[in] uuid The unique identifier for the crash report record.
   void RemoveAttachmentsByUUID(const UUID& uuid);
 
+  //! \brief Builds a filepath for the directory holding attachments stored
+  //!     once for all of the reports that have them.
+  //!
+  //! \return The filepath to the shared attachments directory.
+  base::FilePath SharedAttachmentsPath();
+
+  //! \brief Removes stored shared attachments that no report links to, and
+  //!     abandoned temporary files from storing them.
+  //!
+  //! \param[in] lockfile_ttl The number of seconds for which a stored
+  //!     attachment or temporary file is kept after it was written, so that
+  //!     one being added to a report isn’t removed.
+  void CleanSharedAttachments(time_t lockfile_ttl);
+
  private:
   //! \brief Adjusts a crash report record’s metadata to account for an upload
   //!     attempt, and updates the last upload attempt time as returned by
@@ -458,6 +666,8 @@ class CrashReportDatabase {
   virtual OperationStatus RecordUploadAttempt(UploadReport* report,
                                               bool successful,
                                               const std::string& id) = 0;
+
+  bool deduplicate_attachments_ = false;
 };
 
 }  // namespace crashpad
@@ -0,0 +1,771 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Measures CrashReportDatabase operations with the implementation that this
+// build uses: CrashReportDatabaseGeneric on Linux and Android,
+// CrashReportDatabaseWin on Windows, and CrashReportDatabaseMac on macOS. On
+// Linux and Android, --compact uses a database with compact metadata instead.
+//
+// For each configured report count, a new database is filled with that many
+// reports, half of which are then moved to the completed state, and these are
+// timed:
+//  - Write: PrepareNewCrashReport(), writing the report, and
+//    FinishedWritingCrashReport(), for each report written to fill the
+//    database. The throughput is also reported.
+//  - Open: InitializeWithoutCreating().
+//  - GetPendingReports and GetCompletedReports.
+//  - GetReportForUploading: each of several threads, each with its own database
+//    object, and then each of several processes, checks out the pending
+//    reports in the same order so that they contend for the same reports. The
+//    portion of attempts that found the report busy is also reported.
+//  - Prune and PruneIncrementally: PruneCrashReportDatabase() and
+//    PruneCrashReportDatabaseIncrementally() with a condition that keeps every
+//    report, which is the usual case.
+//  - PruneHalf: PruneCrashReportDatabase() deleting the older half of the
+//    reports, timed once.
+
+#include <getopt.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/files/file_path.h"
+#include "base/logging.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/stringprintf.h"
+#include "build/build_config.h"
+#include "client/crash_report_database.h"
+#include "client/prune_crash_reports.h"
+#include "test/scoped_temp_dir.h"
+#include "tools/tool_support.h"
+#include "util/file/file_io.h"
+#include "util/file/file_writer.h"
+#include "util/misc/clock.h"
+#include "util/misc/metrics.h"
+#include "util/misc/paths.h"
+#include "util/string/split_string.h"
+#include "util/thread/thread.h"
+
+#if BUILDFLAG(IS_POSIX)
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "base/posix/eintr_wrapper.h"
+#elif BUILDFLAG(IS_WIN)
+#include <windows.h>
+
+#include "base/strings/utf_string_conversions.h"
+#include "util/win/command_line.h"
+#endif  // BUILDFLAG(IS_POSIX)
+
+namespace crashpad {
+namespace test {
+namespace {
+
+struct Options {
+  std::vector<size_t> counts;
+  size_t iterations;
+  size_t processes;
+  size_t report_size;
+  size_t threads;
+  size_t uploads;
+  bool compact;
+};
+
+void Usage(const std::string& me) {
+  // clang-format off
+  fprintf(stderr,
+"Usage: %s [OPTION]...\n"
+"Benchmark crash report database operations.\n"
+"\n"
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+"      --compact          use a database with compact metadata\n"
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+"      --counts=N[,N...]  numbers of reports in the database\n"
+"                         (default 100,1000,10000)\n"
+"      --iterations=N     repetitions of each benchmark (default 20)\n"
+"      --processes=N      processes contending for uploads (default 4)\n"
+"      --report-size=N    bytes in each report (default 65536)\n"
+"      --threads=N        threads contending for uploads (default 8)\n"
+"      --uploads=N        reports each contending thread or process checks\n"
+"                         out (default 200)\n"
+"      --help             display this help and exit\n",
+          me.c_str());
+  // clang-format on
+}
+
+double MillisecondsSince(uint64_t start_ns) {
+  return (ClockMonotonicNanoseconds() - start_ns) / 1e6;
+}
+
+std::unique_ptr<CrashReportDatabase> CreateDatabase(
+    const base::FilePath& path,
+    bool compact) {
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+  if (compact) {
+    return CrashReportDatabase::InitializeWithCompactMetadata(path);
+  }
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+  return CrashReportDatabase::Initialize(path);
+}
+
+// Writes |count| reports of |report_size| bytes to |database|, recording the
+// time taken for each in |times|.
+bool WriteReports(CrashReportDatabase* database,
+                  size_t count,
+                  size_t report_size,
+                  std::vector<double>* times) {
+  const std::string contents(report_size, 'r');
+  for (size_t index = 0; index < count; ++index) {
+    const uint64_t start_ns = ClockMonotonicNanoseconds();
+    std::unique_ptr<CrashReportDatabase::NewReport> new_report;
+    if (database->PrepareNewCrashReport(&new_report) !=
+        CrashReportDatabase::kNoError) {
+      return false;
+    }
+    if (!new_report->Writer()->Write(contents.data(), contents.size())) {
+      return false;
+    }
+    UUID uuid;
+    if (database->FinishedWritingCrashReport(std::move(new_report), &uuid) !=
+        CrashReportDatabase::kNoError) {
+      return false;
+    }
+    times->push_back(MillisecondsSince(start_ns));
+  }
+  return true;
+}
+
+struct ContentionResults {
+  std::vector<double> times;
+  size_t busy;
+};
+
+// Checks out |uploads| pending reports from the database at |path|, in the
+// order that GetPendingReports() returns them, recording the time taken for
+// each GetReportForUploading() call. Each report that is checked out is
+// released without recording an upload, so it remains pending.
+bool RunContentionWorker(const base::FilePath& path,
+                         size_t uploads,
+                         ContentionResults* results) {
+  std::unique_ptr<CrashReportDatabase> database(
+      CrashReportDatabase::InitializeWithoutCreating(path));
+  if (!database) {
+    return false;
+  }
+
+  std::vector<CrashReportDatabase::Report> reports;
+  if (database->GetPendingReports(&reports) != CrashReportDatabase::kNoError) {
+    return false;
+  }
+  if (reports.empty()) {
+    LOG(ERROR) << "no pending reports";
+    return false;
+  }
+  std::sort(reports.begin(),
+            reports.end(),
+            [](const CrashReportDatabase::Report& lhs,
+               const CrashReportDatabase::Report& rhs) {
+              return lhs.uuid < rhs.uuid;
+            });
+
+  results->times.clear();
+  results->times.reserve(uploads);
+  results->busy = 0;
+  for (size_t index = 0; index < uploads; ++index) {
+    const UUID& uuid = reports[index % reports.size()].uuid;
+    const uint64_t start_ns = ClockMonotonicNanoseconds();
+    std::unique_ptr<const CrashReportDatabase::UploadReport> upload_report;
+    CrashReportDatabase::OperationStatus status =
+        database->GetReportForUploading(uuid, &upload_report, false);
+    results->times.push_back(MillisecondsSince(start_ns));
+    if (status == CrashReportDatabase::kBusyError) {
+      ++results->busy;
+    } else if (status != CrashReportDatabase::kNoError) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Runs RunContentionWorker() on a thread.
+class ContentionThread : public Thread {
+ public:
+  ContentionThread(const base::FilePath& path, size_t uploads)
+      : Thread(), results_(), path_(path), uploads_(uploads), success_(false) {}
+
+  ContentionThread(const ContentionThread&) = delete;
+  ContentionThread& operator=(const ContentionThread&) = delete;
+
+  ~ContentionThread() override {}
+
+  const ContentionResults& results() const { return results_; }
+  bool success() const { return success_; }
+
+ private:
+  // Thread:
+  void ThreadMain() override {
+    success_ = RunContentionWorker(path_, uploads_, &results_);
+  }
+
+  ContentionResults results_;
+  base::FilePath path_;
+  size_t uploads_;
+  bool success_;
+};
+
+// The results of a contention worker process are written to a file as the
+// busy count followed by the times.
+bool WriteContentionResults(const base::FilePath& path,
+                            const ContentionResults& results) {
+  FileWriter writer;
+  if (!writer.Open(path, FileWriteMode::kTruncateOrCreate,
+                   FilePermissions::kOwnerOnly)) {
+    return false;
+  }
+  const uint64_t busy = results.busy;
+  return writer.Write(&busy, sizeof(busy)) &&
+         writer.Write(results.times.data(),
+                      results.times.size() * sizeof(results.times[0]));
+}
+
+bool ReadContentionResults(const base::FilePath& path,
+                           ContentionResults* results) {
+  std::string contents;
+  if (!LoggingReadEntireFile(path, &contents)) {
+    return false;
+  }
+  uint64_t busy;
+  if (contents.size() < sizeof(busy) ||
+      (contents.size() - sizeof(busy)) % sizeof(results->times[0]) != 0) {
+    LOG(ERROR) << "unexpected results size " << contents.size();
+    return false;
+  }
+  memcpy(&busy, contents.data(), sizeof(busy));
+  results->busy = static_cast<size_t>(busy);
+  results->times.resize((contents.size() - sizeof(busy)) /
+                        sizeof(results->times[0]));
+  memcpy(results->times.data(),
+         contents.data() + sizeof(busy),
+         results->times.size() * sizeof(results->times[0]));
+  return true;
+}
+
+#if BUILDFLAG(IS_POSIX)
+using WorkerProcess = pid_t;
+#elif BUILDFLAG(IS_WIN)
+using WorkerProcess = HANDLE;
+#endif  // BUILDFLAG(IS_POSIX)
+
+// Starts this executable as a contention worker process. The process is
+// started anew, rather than forked, because not every database implementation
+// is safe to use in a forked child.
+bool StartContentionProcess(const base::FilePath& database_path,
+                            const base::FilePath& results_path,
+                            size_t uploads,
+                            WorkerProcess* process) {
+  base::FilePath executable;
+  if (!Paths::Executable(&executable)) {
+    return false;
+  }
+
+#if BUILDFLAG(IS_POSIX)
+  const std::vector<std::string> arguments = {
+      executable.value(),
+      "--contention-worker=" + results_path.value(),
+      "--database=" + database_path.value(),
+      base::StringPrintf("--uploads=%zu", uploads),
+  };
+  std::vector<char*> argv;
+  for (const std::string& argument : arguments) {
+    argv.push_back(const_cast<char*>(argument.c_str()));
+  }
+  argv.push_back(nullptr);
+
+  pid_t pid = fork();
+  if (pid < 0) {
+    PLOG(ERROR) << "fork";
+    return false;
+  }
+  if (pid == 0) {
+    execv(argv[0], &argv[0]);
+    PLOG(ERROR) << "execv";
+    _exit(EXIT_FAILURE);
+  }
+  *process = pid;
+#elif BUILDFLAG(IS_WIN)
+  std::wstring command_line;
+  AppendCommandLineArgument(executable.value(), &command_line);
+  AppendCommandLineArgument(L"--contention-worker=" + results_path.value(),
+                            &command_line);
+  AppendCommandLineArgument(L"--database=" + database_path.value(),
+                            &command_line);
+  AppendCommandLineArgument(
+      base::UTF8ToWide(base::StringPrintf("--uploads=%zu", uploads)),
+      &command_line);
+
+  STARTUPINFO startup_info = {};
+  startup_info.cb = sizeof(startup_info);
+  PROCESS_INFORMATION process_info;
+  if (!CreateProcess(executable.value().c_str(),
+                     &command_line[0],  // This cannot be constant, per MSDN.
+                     nullptr,
+                     nullptr,
+                     FALSE,
+                     0,
+                     nullptr,
+                     nullptr,
+                     &startup_info,
+                     &process_info)) {
+    PLOG(ERROR) << "CreateProcess";
+    return false;
+  }
+  CloseHandle(process_info.hThread);
+  *process = process_info.hProcess;
+#endif  // BUILDFLAG(IS_POSIX)
+
+  return true;
+}
+
+// Waits for a process started by StartContentionProcess() to exit, returning
+// `true` if it was successful.
+bool WaitForContentionProcess(WorkerProcess process) {
+#if BUILDFLAG(IS_POSIX)
+  int status;
+  if (HANDLE_EINTR(waitpid(process, &status, 0)) != process) {
+    PLOG(ERROR) << "waitpid";
+    return false;
+  }
+  return WIFEXITED(status) && WEXITSTATUS(status) == EXIT_SUCCESS;
+#elif BUILDFLAG(IS_WIN)
+  DWORD exit_code;
+  const bool exited = WaitForSingleObject(process, INFINITE) == WAIT_OBJECT_0 &&
+                      GetExitCodeProcess(process, &exit_code);
+  CloseHandle(process);
+  return exited && exit_code == EXIT_SUCCESS;
+#endif  // BUILDFLAG(IS_POSIX)
+}
+
+double Percentile(const std::vector<double>& sorted, double percentile) {
+  const size_t rank = static_cast<size_t>(percentile * sorted.size() / 100);
+  return sorted[std::min(rank, sorted.size() - 1)];
+}
+
+void PrintHeader() {
+  printf("%-40s %10s %10s %10s %10s  %s\n",
+         "Benchmark",
+         "p50",
+         "p90",
+         "p99",
+         "Max",
+         "");
+}
+
+void PrintPercentiles(const std::string& name,
+                      std::vector<double> values,
+                      const std::string& note = std::string()) {
+  std::sort(values.begin(), values.end());
+  printf("%-40s %7.3f ms %7.3f ms %7.3f ms %7.3f ms  %s\n",
+         name.c_str(),
+         Percentile(values, 50),
+         Percentile(values, 90),
+         Percentile(values, 99),
+         values.back(),
+         note.c_str());
+}
+
+// Measures uploads contending from |workers| threads or processes.
+bool RunContention(const Options& options,
+                   const base::FilePath& database_path,
+                   const base::FilePath& temp_path,
+                   size_t count,
+                   size_t workers,
+                   bool use_processes) {
+  std::vector<ContentionResults> results(workers);
+  if (use_processes) {
+    std::vector<WorkerProcess> processes;
+    std::vector<base::FilePath> results_paths;
+    bool success = true;
+    for (size_t index = 0; index < workers; ++index) {
+      results_paths.push_back(
+          temp_path.Append(ToolSupport::CommandLineArgumentToFilePathStringType(
+              base::StringPrintf("contention_%zu", index))));
+      WorkerProcess process;
+      if (!StartContentionProcess(
+              database_path, results_paths.back(), options.uploads, &process)) {
+        success = false;
+        break;
+      }
+      processes.push_back(process);
+    }
+    for (WorkerProcess process : processes) {
+      success &= WaitForContentionProcess(process);
+    }
+    if (!success) {
+      return false;
+    }
+    for (size_t index = 0; index < workers; ++index) {
+      if (!ReadContentionResults(results_paths[index], &results[index])) {
+        return false;
+      }
+    }
+  } else {
+    std::vector<std::unique_ptr<ContentionThread>> threads;
+    for (size_t index = 0; index < workers; ++index) {
+      threads.push_back(
+          std::make_unique<ContentionThread>(database_path, options.uploads));
+      threads.back()->Start();
+    }
+    bool success = true;
+    for (size_t index = 0; index < workers; ++index) {
+      threads[index]->Join();
+      success &= threads[index]->success();
+      results[index] = threads[index]->results();
+    }
+    if (!success) {
+      return false;
+    }
+  }
+
+  std::vector<double> times;
+  size_t busy = 0;
+  for (const ContentionResults& result : results) {
+    times.insert(times.end(), result.times.begin(), result.times.end());
+    busy += result.busy;
+  }
+  if (times.empty()) {
+    return true;
+  }
+  PrintPercentiles(
+      base::StringPrintf("GetReportForUploading/%zu/%s=%zu",
+                         count,
+                         use_processes ? "processes" : "threads",
+                         workers),
+      times,
+      base::StringPrintf("%.1f%% busy", busy * 100.0 / times.size()));
+  return true;
+}
+
+// Runs every benchmark against a new database filled with |count| reports.
+bool RunCount(const Options& options,
+              const base::FilePath& temp_path,
+              size_t count) {
+  const base::FilePath database_path =
+      temp_path.Append(ToolSupport::CommandLineArgumentToFilePathStringType(
+          base::StringPrintf("database_%zu", count)));
+  std::unique_ptr<CrashReportDatabase> database(
+      CreateDatabase(database_path, options.compact));
+  if (!database) {
+    return false;
+  }
+
+  std::vector<double> times;
+  const uint64_t write_start_ns = ClockMonotonicNanoseconds();
+  if (!WriteReports(database.get(), count, options.report_size, &times)) {
+    return false;
+  }
+  const double write_seconds = MillisecondsSince(write_start_ns) / 1e3;
+  PrintPercentiles(base::StringPrintf("Write/%zu", count),
+                   times,
+                   base::StringPrintf("%.0f reports/s", count / write_seconds));
+
+  std::vector<CrashReportDatabase::Report> reports;
+  if (database->GetPendingReports(&reports) != CrashReportDatabase::kNoError ||
+      reports.size() != count) {
+    LOG(ERROR) << "unexpected pending reports";
+    return false;
+  }
+  for (size_t index = 0; index < reports.size(); index += 2) {
+    if (database->SkipReportUpload(
+            reports[index].uuid,
+            Metrics::CrashSkippedReason::kUploadsDisabled) !=
+        CrashReportDatabase::kNoError) {
+      return false;
+    }
+  }
+  const size_t completed_count = (count + 1) / 2;
+
+  times.clear();
+  for (size_t iteration = 0; iteration < options.iterations; ++iteration) {
+    const uint64_t start_ns = ClockMonotonicNanoseconds();
+    std::unique_ptr<CrashReportDatabase> reopened(
+        CrashReportDatabase::InitializeWithoutCreating(database_path));
+    times.push_back(MillisecondsSince(start_ns));
+    if (!reopened) {
+      return false;
+    }
+  }
+  PrintPercentiles(base::StringPrintf("Open/%zu", count), times);
+
+  times.clear();
+  for (size_t iteration = 0; iteration < options.iterations; ++iteration) {
+    const uint64_t start_ns = ClockMonotonicNanoseconds();
+    CrashReportDatabase::OperationStatus status =
+        database->GetPendingReports(&reports);
+    times.push_back(MillisecondsSince(start_ns));
+    if (status != CrashReportDatabase::kNoError ||
+        reports.size() != count - completed_count) {
+      LOG(ERROR) << "unexpected pending reports";
+      return false;
+    }
+  }
+  PrintPercentiles(base::StringPrintf("GetPendingReports/%zu", count), times);
+
+  times.clear();
+  for (size_t iteration = 0; iteration < options.iterations; ++iteration) {
+    const uint64_t start_ns = ClockMonotonicNanoseconds();
+    CrashReportDatabase::OperationStatus status =
+        database->GetCompletedReports(&reports);
+    times.push_back(MillisecondsSince(start_ns));
+    if (status != CrashReportDatabase::kNoError ||
+        reports.size() != completed_count) {
+      LOG(ERROR) << "unexpected completed reports";
+      return false;
+    }
+  }
+  PrintPercentiles(base::StringPrintf("GetCompletedReports/%zu", count), times);
+
+  if (count > completed_count) {
+    if (options.threads > 0 &&
+        !RunContention(options,
+                       database_path,
+                       temp_path,
+                       count,
+                       options.threads,
+                       false)) {
+      return false;
+    }
+    if (options.processes > 0 &&
+        !RunContention(options,
+                       database_path,
+                       temp_path,
+                       count,
+                       options.processes,
+                       true)) {
+      return false;
+    }
+  }
+
+  static constexpr struct {
+    const char* name;
+    size_t (*prune)(CrashReportDatabase*, PruneCondition*);
+  } kPruneFunctions[] = {
+      {"Prune", PruneCrashReportDatabase},
+      {"PruneIncrementally", PruneCrashReportDatabaseIncrementally},
+  };
+  for (const auto& prune_function : kPruneFunctions) {
+    times.clear();
+    for (size_t iteration = 0; iteration < options.iterations; ++iteration) {
+      AgePruneCondition keep_all(365);
+      const uint64_t start_ns = ClockMonotonicNanoseconds();
+      const size_t pruned = prune_function.prune(database.get(), &keep_all);
+      times.push_back(MillisecondsSince(start_ns));
+      if (pruned != 0) {
+        LOG(ERROR) << "unexpected pruned reports";
+        return false;
+      }
+    }
+    PrintPercentiles(
+        base::StringPrintf("%s/%zu", prune_function.name, count), times);
+  }
+
+  DatabaseSizePruneCondition prune_half(count / 2 *
+                                        ((options.report_size + 1023) / 1024));
+  const uint64_t start_ns = ClockMonotonicNanoseconds();
+  const size_t pruned = PruneCrashReportDatabase(database.get(), &prune_half);
+  PrintPercentiles(base::StringPrintf("PruneHalf/%zu", count),
+                   {MillisecondsSince(start_ns)},
+                   base::StringPrintf("%zu pruned", pruned));
+
+  return true;
+}
+
+int DatabaseBenchmarksMain(int argc, char* argv[]) {
+  const base::FilePath argv0(
+      ToolSupport::CommandLineArgumentToFilePathStringType(argv[0]));
+  const base::FilePath me(argv0.BaseName());
+
+  enum OptionFlags {
+    // Long options without short equivalents.
+    kOptionLastChar = 255,
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+    kOptionCompact,
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+    kOptionContentionWorker,
+    kOptionCounts,
+    kOptionDatabase,
+    kOptionIterations,
+    kOptionProcesses,
+    kOptionReportSize,
+    kOptionThreads,
+    kOptionUploads,
+
+    // Standard options.
+    kOptionHelp = -2,
+  };
+
+  Options options = {};
+  options.counts = {100, 1000, 10000};
+  options.iterations = 20;
+  options.processes = 4;
+  options.report_size = 64 * 1024;
+  options.threads = 8;
+  options.uploads = 200;
+
+  // --contention-worker and --database are used by StartContentionProcess().
+  base::FilePath contention_results_path;
+  base::FilePath database_path;
+
+  static constexpr option long_options[] = {
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+      {"compact", no_argument, nullptr, kOptionCompact},
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+      {"contention-worker",
+       required_argument,
+       nullptr,
+       kOptionContentionWorker},
+      {"counts", required_argument, nullptr, kOptionCounts},
+      {"database", required_argument, nullptr, kOptionDatabase},
+      {"iterations", required_argument, nullptr, kOptionIterations},
+      {"processes", required_argument, nullptr, kOptionProcesses},
+      {"report-size", required_argument, nullptr, kOptionReportSize},
+      {"threads", required_argument, nullptr, kOptionThreads},
+      {"uploads", required_argument, nullptr, kOptionUploads},
+      {"help", no_argument, nullptr, kOptionHelp},
+      {nullptr, 0, nullptr, 0},
+  };
+
+  int opt;
+  while ((opt = getopt_long(argc, argv, "", long_options, nullptr)) != -1) {
+    size_t* size_option = nullptr;
+    switch (opt) {
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+      case kOptionCompact:
+        options.compact = true;
+        break;
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+      case kOptionContentionWorker:
+        contention_results_path = base::FilePath(
+            ToolSupport::CommandLineArgumentToFilePathStringType(optarg));
+        break;
+      case kOptionCounts:
+        options.counts.clear();
+        for (const std::string& count : SplitString(optarg, ',')) {
+          options.counts.push_back(0);
+          if (!base::StringToSizeT(count, &options.counts.back()) ||
+              !options.counts.back()) {
+            ToolSupport::UsageHint(me, "invalid count");
+            return EXIT_FAILURE;
+          }
+        }
+        break;
+      case kOptionDatabase:
+        database_path = base::FilePath(
+            ToolSupport::CommandLineArgumentToFilePathStringType(optarg));
+        break;
+      case kOptionIterations:
+        size_option = &options.iterations;
+        break;
+      case kOptionProcesses:
+        size_option = &options.processes;
+        break;
+      case kOptionReportSize:
+        size_option = &options.report_size;
+        break;
+      case kOptionThreads:
+        size_option = &options.threads;
+        break;
+      case kOptionUploads:
+        size_option = &options.uploads;
+        break;
+      case kOptionHelp:
+        Usage(ToolSupport::FilePathToCommandLineArgument(me));
+        return EXIT_SUCCESS;
+      default:
+        ToolSupport::UsageHint(me, nullptr);
+        return EXIT_FAILURE;
+    }
+
+    if (size_option && !base::StringToSizeT(optarg, size_option)) {
+      ToolSupport::UsageHint(me, "invalid number");
+      return EXIT_FAILURE;
+    }
+  }
+
+  if (optind != argc || options.iterations == 0 || options.counts.empty()) {
+    ToolSupport::UsageHint(me, nullptr);
+    return EXIT_FAILURE;
+  }
+
+  if (!contention_results_path.empty()) {
+    ContentionResults results;
+    return !database_path.empty() &&
+                   RunContentionWorker(
+                       database_path, options.uploads, &results) &&
+                   WriteContentionResults(contention_results_path, results)
+               ? EXIT_SUCCESS
+               : EXIT_FAILURE;
+  }
+
+  printf("report-size=%zu iterations=%zu threads=%zu processes=%zu "
+         "uploads=%zu%s\n\n",
+         options.report_size,
+         options.iterations,
+         options.threads,
+         options.processes,
+         options.uploads,
+         options.compact ? " compact" : "");
+  PrintHeader();
+
+  ScopedTempDir temp_dir;
+  for (size_t count : options.counts) {
+    if (!RunCount(options, temp_dir.path(), count)) {
+      fprintf(stderr,
+              "%s: %zu reports failed\n",
+              ToolSupport::FilePathToCommandLineArgument(me).c_str(),
+              count);
+      return EXIT_FAILURE;
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
+
+#if BUILDFLAG(IS_POSIX)
+int main(int argc, char* argv[]) {
+  return crashpad::test::DatabaseBenchmarksMain(argc, argv);
+}
+#elif BUILDFLAG(IS_WIN)
+int wmain(int argc, wchar_t* argv[]) {
+  return crashpad::ToolSupport::Wmain(
+      argc, argv, crashpad::test::DatabaseBenchmarksMain);
+}
+#endif  // BUILDFLAG(IS_POSIX)
@@ -15,21 +15,34 @@
 #include "client/crash_report_database.h"
 
 #include <stdint.h>
+#include <string.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 
+#include <functional>
+#include <map>
+#include <memory>
 #include <mutex>
+#include <set>
 #include <tuple>
 #include <utility>
 
 #include "base/logging.h"
+#include "base/posix/eintr_wrapper.h"
 #include "build/build_config.h"
 #include "client/settings.h"
+#include "third_party/zlib/zlib_crashpad.h"
 #include "util/file/directory_reader.h"
 #include "util/file/filesystem.h"
+#include "util/file/group_commit.h"
 #include "util/misc/initialization_state_dcheck.h"
 #include "util/misc/memory_sanitizer.h"
 
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+#include <fcntl.h>
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+
 namespace crashpad {
 
 namespace {
@@ -50,6 +63,21 @@ using OperationStatus = CrashReportDatabase::OperationStatus;
 
 constexpr base::FilePath::CharType kSettings[] =
     FILE_PATH_LITERAL("settings.dat");
+constexpr base::FilePath::CharType kIndex[] = FILE_PATH_LITERAL("index.dat");
+
+// Present in a database with compact metadata, where it holds the byte-range
+// locks of its reports.
+constexpr base::FilePath::CharType kRangeLocks[] =
+    FILE_PATH_LITERAL("locks.dat");
+
+// Present in a database whose pending and completed reports are kept in
+// shards, subdirectories of their state’s directory named for the first
+// characters of their UUIDs.
+constexpr base::FilePath::CharType kShardedReports[] =
+    FILE_PATH_LITERAL("shards.dat");
+
+// The number of characters of a report’s UUID that name its shard.
+constexpr size_t kShardNameLength = 2;
 
 constexpr base::FilePath::CharType kCrashReportExtension[] =
     FILE_PATH_LITERAL(".dmp");
@@ -88,6 +116,103 @@ struct ReportMetadata {
   uint8_t attributes = 0;
 };
 
+// The index caches the metadata of the reports in the pending and completed
+// states, so that they can be listed without opening every metadata file. It
+// is an IndexHeader followed by an append-only log of IndexRecords, each
+// followed by its report’s upload ID. The last record for a UUID describes
+// that report. An index that is empty, truncated, or fails a checksum is
+// rebuilt from the metadata files.
+//
+// The header’s generation changes each time the index is rewritten, rather
+// than appended to. While it is unchanged, a copy of the index read earlier can
+// be brought up to date by reading only the records appended since.
+struct IndexHeader {
+  static constexpr uint32_t kMagic = 'CPri';
+  static constexpr uint32_t kVersion = 2;
+
+  uint32_t magic = kMagic;
+  uint32_t version = kVersion;
+  UUID generation;
+};
+
+struct IndexRecord {
+  // The CRC-32 of the rest of this record and the upload ID that follows it.
+  uint32_t checksum;
+  uint32_t id_size;
+  UUID uuid;
+  // A ReportState. kUninitialized marks a report that was removed.
+  int32_t state;
+  int32_t upload_attempts;
+  int64_t last_upload_attempt_time;
+  int64_t creation_time;
+  uint64_t total_size;
+  uint8_t attributes;
+  uint8_t reserved[7];
+};
+static_assert(sizeof(IndexRecord) == 64, "IndexRecord size");
+
+// Upload IDs are short. A larger id_size indicates a corrupt index.
+constexpr uint32_t kMaxIndexedIDSize = 4096;
+
+// The index is compacted once it holds this many more records than reports.
+constexpr size_t kIndexCompactionSlack = 64;
+
+uint32_t IndexRecordChecksum(const IndexRecord& record, const std::string& id) {
+  uLong crc = crc32(0, nullptr, 0);
+  crc = crc32(crc,
+              reinterpret_cast<const Bytef*>(&record) + sizeof(record.checksum),
+              sizeof(record) - sizeof(record.checksum));
+  crc = crc32(crc, reinterpret_cast<const Bytef*>(id.data()), id.size());
+  return static_cast<uint32_t>(crc);
+}
+
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+// Takes an open file description lock on the byte of the range lock file that
+// stands for uuid. These locks are released when handle is closed, including
+// when the process holding them exits, and conflict with those taken through
+// any other open of the file, even by the same process.
+bool LockRange(FileHandle handle, const UUID& uuid) {
+  // A UUID’s first eight bytes are random enough to spread reports across the
+  // file’s range without them colliding in practice. A collision would only
+  // make one report appear busy while the other was locked. The offset is
+  // kept well within the range of off_t.
+  uint64_t offset;
+  static_assert(sizeof(uuid) >= sizeof(offset), "UUID size");
+  memcpy(&offset, &uuid, sizeof(offset));
+
+  struct flock lock = {};
+  lock.l_type = F_WRLCK;
+  lock.l_whence = SEEK_SET;
+  lock.l_start = static_cast<off_t>(offset >> 2);
+  lock.l_len = 1;
+  if (HANDLE_EINTR(fcntl(handle, F_OFD_SETLK, &lock)) != 0) {
+    PLOG(ERROR) << "fcntl";
+    return false;
+  }
+  return true;
+}
+
+// Creates the range lock file at path for a new database with compact
+// metadata. The file is only kept if open file description locks work, as
+// older kernels and some file systems don’t support them.
+bool CreateRangeLockFile(const base::FilePath& path) {
+  ScopedFileHandle handle(
+      LoggingOpenFileForReadAndWrite(path,
+                                     FileWriteMode::kCreateOrFail,
+                                     FilePermissions::kOwnerOnly));
+  if (!handle.is_valid()) {
+    return false;
+  }
+  if (!LockRange(handle.get(), UUID())) {
+    handle.reset();
+    LoggingRemoveFile(path);
+    return false;
+  }
+  return true;
+}
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+
 // A lock held while using database resources.
 class ScopedLockFile {
  public:
@@ -100,13 +225,36 @@ class ScopedLockFile {
 
   ScopedLockFile& operator=(ScopedLockFile&& other) {
     lock_file_.reset(other.lock_file_.release());
+    range_lock_.reset(other.range_lock_.release());
     return *this;
   }
 
-  // Attempt to acquire a lock for the report at report_path.
+  // Attempt to acquire a lock for the report at report_path. If
+  // range_lock_path is empty, the lock is a lock file created beside the
+  // report. Otherwise, it is a byte-range lock on the file at range_lock_path
+  // that stands for the report’s UUID, whatever state the report is in.
   // Return `true` on success, otherwise `false`.
-  bool ResetAcquire(const base::FilePath& report_path) {
-    lock_file_.reset();
+  bool ResetAcquire(const base::FilePath& report_path,
+                    const base::FilePath& range_lock_path) {
+    Reset();
+
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+    if (!range_lock_path.empty()) {
+      ScopedFileHandle handle(
+          LoggingOpenFileForReadAndWrite(range_lock_path,
+                                         FileWriteMode::kReuseOrCreate,
+                                         FilePermissions::kOwnerOnly));
+      if (!handle.is_valid() ||
+          !LockRange(handle.get(), UUIDFromReportPath(report_path))) {
+        return false;
+      }
+      range_lock_ = std::move(handle);
+      return true;
+    }
+#else
+    DCHECK(range_lock_path.empty());
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
 
     base::FilePath lock_path(report_path.RemoveFinalExtension().value() +
                              kLockExtension);
@@ -125,8 +273,16 @@ class ScopedLockFile {
     return true;
   }
 
+  // Releases the lock, if it is held.
+  void Reset() {
+    lock_file_.reset();
+    range_lock_.reset();
+  }
+
   // Returns `true` if the lock is held.
-  bool is_valid() const { return lock_file_.is_valid(); }
+  bool is_valid() const {
+    return lock_file_.is_valid() || range_lock_.is_valid();
+  }
 
   // Returns `true` if the lockfile at lock_path has expired.
   static bool IsExpired(const base::FilePath& lock_path, time_t lockfile_ttl) {
@@ -154,6 +310,7 @@ class ScopedLockFile {
 
  private:
   ScopedRemoveFile lock_file_;
+  ScopedFileHandle range_lock_;
 };
 }  // namespace
 
@@ -167,7 +324,15 @@ class CrashReportDatabaseGeneric : public CrashReportDatabase {
 
   ~CrashReportDatabaseGeneric() override;
 
-  bool Initialize(const base::FilePath& path, bool may_create);
+  // If compact_metadata is true and the database is created, it will keep its
+  // reports’ metadata in the index and lock them with byte-range locks. An
+  // existing database keeps the mode that it was created with. If
+  // sharded_reports is true, the database keeps its reports in shards from
+  // then on, and reports kept outside of shards are moved into them.
+  bool Initialize(const base::FilePath& path,
+                  bool may_create,
+                  bool compact_metadata,
+                  bool sharded_reports);
 
   // CrashReportDatabase:
   Settings* GetSettings() override;
@@ -178,6 +343,10 @@ class CrashReportDatabaseGeneric : public CrashReportDatabase {
   OperationStatus LookUpCrashReport(const UUID& uuid, Report* report) override;
   OperationStatus GetPendingReports(std::vector<Report>* reports) override;
   OperationStatus GetCompletedReports(std::vector<Report>* reports) override;
+  OperationStatus GetOldestReports(size_t max_reports,
+                                   std::vector<Report>* reports,
+                                   uint64_t* total_size) override;
+  OperationStatus GetStatistics(Statistics* statistics) override;
   OperationStatus GetReportForUploading(
       const UUID& uuid,
       std::unique_ptr<const UploadReport>* report,
@@ -188,6 +357,8 @@ class CrashReportDatabaseGeneric : public CrashReportDatabase {
   OperationStatus RequestUpload(const UUID& uuid) override;
   int CleanDatabase(time_t lockfile_ttl) override;
   base::FilePath DatabasePath() override;
+  base::FilePath PendingReportsChangePath() override;
+  void EnableGroupCommit(double window) override;
 
  private:
   struct LockfileUploadReport : public UploadReport {
@@ -210,14 +381,53 @@ class CrashReportDatabaseGeneric : public CrashReportDatabase {
     kSearchable,
   };
 
+  struct IndexedReport {
+    Report report;
+    ReportState state;
+  };
+
   // CrashReportDatabase:
   OperationStatus RecordUploadAttempt(UploadReport* report,
                                       bool successful,
                                       const std::string& id) override;
 
-  // Builds a filepath for the report with the specified uuid and state.
+  // Returns `true` if the database keeps its reports’ metadata in the index,
+  // rather than in a metadata file beside each report, and locks its reports
+  // with byte-range locks on the file at range_lock_path_, rather than with
+  // lock files.
+  bool compact_metadata() const { return !range_lock_path_.empty(); }
+
+  // Builds a filepath for the report with the specified uuid and state. In a
+  // sharded database, a pending or completed report is kept in a shard named
+  // for the first kShardNameLength characters of its UUID.
   base::FilePath ReportPath(const UUID& uuid, ReportState state);
 
+  // Builds the filepath that the report with the specified uuid and state has
+  // in a database without shards. A sharded database still finds reports
+  // there, where versions that predate shards put them, until they are moved
+  // into their shards by MigrateUnshardedReports().
+  base::FilePath UnshardedReportPath(const UUID& uuid, ReportState state);
+
+  // Creates the shard that the report at path is kept in, if the database is
+  // sharded and the shard doesn’t exist yet.
+  bool CreateShardDirectory(const base::FilePath& path);
+
+  // Calls visit with the path of each file in the directory of reports in
+  // state and, in a sharded database, in each of its shards. Returns `false`
+  // if the directory couldn’t be read.
+  bool VisitReportFiles(
+      ReportState state,
+      const std::function<void(const base::FilePath&)>& visit);
+
+  // Moves the pending and completed reports that are kept outside of shards
+  // into their shards.
+  void MigrateUnshardedReports();
+
+  // Moves the report with uuid in state, and its metadata file, from its
+  // UnshardedReportPath() to its ReportPath(). Returns `false` if the report
+  // couldn’t be locked or moved.
+  bool MoveReportToShard(const UUID& uuid, ReportState state);
+
   // Locates the report with id uuid and returns its file path in path and a
   // lock for the report in lock_file. This method succeeds as long as the
   // report file exists and the lock can be acquired. No validation is done on
@@ -236,10 +446,75 @@ class CrashReportDatabaseGeneric : public CrashReportDatabase {
                                  ScopedLockFile* lock_file,
                                  Report* report);
 
-  // Reads metadata for all reports in state and returns it in reports.
+  // Reads metadata for all reports in state and returns it in reports. The
+  // index is used when possible, and ScanReportsInState() otherwise.
   OperationStatus ReportsInState(ReportState state,
                                  std::vector<Report>* reports);
 
+  // Reads the metadata file of each report in state and returns it in reports.
+  OperationStatus ScanReportsInState(ReportState state,
+                                     std::vector<Report>* reports);
+
+  // Opens the index and locks it exclusively, creating it if necessary.
+  // Returns an invalid handle if the index can’t be used.
+  ScopedFileHandle OpenIndex();
+
+  // Brings indexed_reports_ up to date with the index, reading only the
+  // records appended since it was last read if the index hasn’t been rewritten
+  // since then. Compacts the index if it holds many superseded records.
+  // Returns `false` with indexed_reports_ cleared if the index is empty or
+  // corrupt.
+  bool ReadIndex(FileHandle index);
+
+  // Replaces the index’s contents with records of all pending and completed
+  // reports, and sets indexed_reports_ to match. The records are read from the
+  // reports’ metadata files, or with compact metadata, are taken from
+  // indexed_reports_ by ReadMetadataForRebuild().
+  bool RebuildIndex(FileHandle index);
+
+  // Marks the read of the index in progress as failed, so that the index is
+  // next read in full. With compact metadata, what was read from it before
+  // the failure is kept for RebuildIndex().
+  void AbandonIndexRead();
+
+  // Appends a record of the report at path, which is in state, to the index.
+  // This is called after each state transition. The record is of the
+  // report’s metadata file, or with compact metadata, of report.
+  void UpdateIndex(const base::FilePath& path,
+                   ReportState state,
+                   const Report& report);
+
+  // Appends a record of the removal of the report with uuid to the index.
+  void RemoveFromIndex(const UUID& uuid);
+
+  // Empties the index so that it will be rebuilt when next read. This is used
+  // when a state transition fails part way through. It does nothing with
+  // compact metadata, where the index can’t be rebuilt from metadata files.
+  void InvalidateIndex();
+
+  // Replaces the index’s contents with records for reports under a new
+  // generation, and sets indexed_reports_ to match.
+  bool WriteIndex(FileHandle index, const std::vector<IndexedReport>& reports);
+
+  // Applies an index record and its report’s upload ID to indexed_reports_.
+  // Returns `false` if the record is invalid.
+  bool ApplyIndexRecord(const IndexRecord& record, std::string id);
+
+  // Adds indexed_report to indexed_reports_, replacing any report with the same
+  // UUID.
+  void AddIndexedReport(const IndexedReport& indexed_report);
+
+  // Removes the report with uuid from indexed_reports_, if it is present.
+  void RemoveIndexedReport(const UUID& uuid);
+
+  // Clears indexed_reports_ so that the index is next read in full.
+  void ResetIndexedReports();
+
+  // Appends an index record for report in state to buffer.
+  static void SerializeIndexRecord(const Report& report,
+                                   ReportState state,
+                                   std::string* buffer);
+
   // Cleans lone metadata, reports, or expired locks in a particular state.
   int CleanReportsInState(ReportState state, time_t lockfile_ttl);
 
@@ -250,13 +525,40 @@ class CrashReportDatabaseGeneric : public CrashReportDatabase {
   bool ReadMetadata(const base::FilePath& path, Report* report);
 
   // Wraps ReadMetadata and removes the report from the database on failure.
+  // With compact metadata, a report is never removed, as failure only means
+  // that the index couldn’t be used.
   bool CleaningReadMetadata(const base::FilePath& path, Report* report);
 
-  // Writes metadata for a new report to the filesystem at path.
-  static bool WriteNewMetadata(const base::FilePath& path);
+  // ReadMetadata() for a database with compact metadata. If the index has no
+  // record of the report at path in the state that its path implies, one is
+  // appended.
+  bool ReadIndexedMetadata(const base::FilePath& path, Report* report);
 
-  // Writes the metadata for report to the filesystem at path.
-  static bool WriteMetadata(const base::FilePath& path, const Report& report);
+  // Reads the metadata for the report at path for RebuildIndex().
+  bool ReadMetadataForRebuild(const base::FilePath& path, Report* report);
+
+  // Fills in report with what can be found for the report at path without a
+  // record of it: its modification time as its creation time, and its total
+  // size.
+  bool ReadUnrecordedMetadata(const base::FilePath& path, Report* report);
+
+  // Writes metadata for a new report to the filesystem at path, and syncs it
+  // with group commit. This does nothing with compact metadata.
+  bool WriteNewMetadata(const base::FilePath& path);
+
+  // Writes the metadata for report to the filesystem at path. This does
+  // nothing with compact metadata.
+  bool WriteMetadata(const base::FilePath& path, const Report& report);
+
+  // Removes the metadata file of the report at path. This does nothing with
+  // compact metadata.
+  bool RemoveMetadata(const base::FilePath& path);
+
+  // Makes the moves of finished reports into the pending directory or its
+  // shards, and the creation of their attachment directories, durable. With
+  // compact metadata, the index holds the reports’ metadata, so it is synced
+  // too. This is the sync shared by reports through group_commit_.
+  bool SyncFinishedReports();
 
   Settings& SettingsInternal() {
     std::call_once(settings_init_, [this]() {
@@ -266,8 +568,47 @@ class CrashReportDatabaseGeneric : public CrashReportDatabase {
   }
 
   base::FilePath base_dir_;
+
+  // The file that reports are locked with byte-range locks on, in a database
+  // with compact metadata. Empty otherwise.
+  base::FilePath range_lock_path_;
+
+  // Whether the database keeps its pending and completed reports in shards.
+  bool sharded_ = false;
+
+  // The shards that finished reports have been moved into since the last
+  // SyncFinishedReports(), which syncs them.
+  std::set<base::FilePath> unsynced_shards_;
+  std::mutex unsynced_shards_mutex_;
+
   Settings settings_;
   std::once_flag settings_init_;
+
+  // Set by EnableGroupCommit().
+  std::unique_ptr<GroupCommit> group_commit_;
+
+  // A copy of the reports recorded in the index, kept so that reading the
+  // index only needs to read the records appended to it since it was last
+  // read. These are only used while the index is locked. flock() locks taken
+  // through separate opens of the index conflict even within a process, so this
+  // also serializes their use by this process’ threads.
+  std::map<UUID, IndexedReport> indexed_reports_;
+
+  // indexed_reports_ ordered by Report::creation_time and then UUID, the sum
+  // of their Report::total_size, and the numbers of them in the pending and
+  // completed states.
+  std::set<std::pair<time_t, UUID>> indexed_reports_by_age_;
+  uint64_t indexed_total_size_ = 0;
+  size_t indexed_pending_reports_ = 0;
+  size_t indexed_completed_reports_ = 0;
+
+  // The generation of the index that indexed_reports_ was read from, the number
+  // of bytes of it that have been read, and the number of records in those
+  // bytes. index_size_read_ is 0 if the index must be read in full.
+  UUID index_generation_;
+  FileOffset index_size_read_ = 0;
+  size_t index_record_count_ = 0;
+
   InitializationStateDcheck initialized_;
 };
 
@@ -276,7 +617,9 @@ CrashReportDatabaseGeneric::CrashReportDatabaseGeneric() = default;
 CrashReportDatabaseGeneric::~CrashReportDatabaseGeneric() = default;
 
 bool CrashReportDatabaseGeneric::Initialize(const base::FilePath& path,
-                                            bool may_create) {
+                                            bool may_create,
+                                            bool compact_metadata,
+                                            bool sharded_reports) {
   INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
   base_dir_ = path;
 
@@ -286,6 +629,11 @@ bool CrashReportDatabaseGeneric::Initialize(const base::FilePath& path,
     return false;
   }
 
+  // A database’s mode is chosen when it is created, as an existing database’s
+  // metadata files would be ignored in compact mode, and its index wouldn’t be
+  // kept up to date by older versions that don’t know about compact mode.
+  const bool is_new = !IsDirectory(base_dir_.Append(kPendingDirectory), true);
+
   for (const base::FilePath::CharType* subdir : kReportDirectories) {
     if (!LoggingCreateDirectory(
             base_dir_.Append(subdir), FilePermissions::kOwnerOnly, true)) {
@@ -298,6 +646,37 @@ bool CrashReportDatabaseGeneric::Initialize(const base::FilePath& path,
     return false;
   }
 
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+  const base::FilePath range_lock_path(base_dir_.Append(kRangeLocks));
+  if (compact_metadata && is_new) {
+    CreateRangeLockFile(range_lock_path);
+  }
+  if (IsRegularFile(range_lock_path)) {
+    range_lock_path_ = range_lock_path;
+  }
+#else
+  DCHECK(!compact_metadata);
+  std::ignore = is_new;
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+
+  // Unlike compact metadata, shards can be adopted by an existing database, as
+  // its reports are found outside of shards until they are moved into them.
+  const base::FilePath sharded_reports_path(base_dir_.Append(kShardedReports));
+  if (sharded_reports && !IsRegularFile(sharded_reports_path)) {
+    ScopedFileHandle handle(
+        LoggingOpenFileForWrite(sharded_reports_path,
+                                FileWriteMode::kReuseOrCreate,
+                                FilePermissions::kOwnerOnly));
+    if (!handle.is_valid()) {
+      return false;
+    }
+  }
+  sharded_ = IsRegularFile(sharded_reports_path);
+  if (sharded_) {
+    MigrateUnshardedReports();
+  }
+
   INITIALIZATION_STATE_SET_VALID(initialized_);
   return true;
 }
@@ -306,20 +685,57 @@ bool CrashReportDatabaseGeneric::Initialize(const base::FilePath& path,
 std::unique_ptr<CrashReportDatabase> CrashReportDatabase::Initialize(
     const base::FilePath& path) {
   auto database = std::make_unique<CrashReportDatabaseGeneric>();
-  return database->Initialize(path, true) ? std::move(database) : nullptr;
+  return database->Initialize(path, true, false, false) ? std::move(database)
+                                                        : nullptr;
 }
 
 // static
 std::unique_ptr<CrashReportDatabase>
 CrashReportDatabase::InitializeWithoutCreating(const base::FilePath& path) {
   auto database = std::make_unique<CrashReportDatabaseGeneric>();
-  return database->Initialize(path, false) ? std::move(database) : nullptr;
+  return database->Initialize(path, false, false, false)
+             ? std::move(database)
+             : nullptr;
 }
 
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+// static
+std::unique_ptr<CrashReportDatabase>
+CrashReportDatabase::InitializeWithCompactMetadata(const base::FilePath& path) {
+  auto database = std::make_unique<CrashReportDatabaseGeneric>();
+  return database->Initialize(path, true, true, false) ? std::move(database)
+                                                       : nullptr;
+}
+
+// static
+std::unique_ptr<CrashReportDatabase>
+CrashReportDatabase::InitializeWithShardedReports(const base::FilePath& path,
+                                                  bool compact_metadata) {
+  auto database = std::make_unique<CrashReportDatabaseGeneric>();
+  return database->Initialize(path, true, compact_metadata, true)
+             ? std::move(database)
+             : nullptr;
+}
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+
 base::FilePath CrashReportDatabaseGeneric::DatabasePath() {
   return base_dir_;
 }
 
+base::FilePath CrashReportDatabaseGeneric::PendingReportsChangePath() {
+  // Every change in a report’s state is appended to the index after the change
+  // is made.
+  return base_dir_.Append(kIndex);
+}
+
+void CrashReportDatabaseGeneric::EnableGroupCommit(double window) {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  DCHECK(!group_commit_);
+  group_commit_ = std::make_unique<GroupCommit>(
+      [this]() { return SyncFinishedReports(); }, window);
+}
+
 Settings* CrashReportDatabaseGeneric::GetSettings() {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
   return &SettingsInternal();
@@ -344,9 +760,19 @@ OperationStatus CrashReportDatabaseGeneric::FinishedWritingCrashReport(
     UUID* uuid) {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
 
+  // With group commit, the report’s files are synced before it is moved into
+  // place, and the move is made durable by a sync shared with other reports.
+  std::unique_ptr<GroupCommit::Change> commit;
+  if (group_commit_) {
+    commit = std::make_unique<GroupCommit::Change>(group_commit_.get());
+  }
+
   base::FilePath path = ReportPath(report->ReportID(), kPending);
+  if (!CreateShardDirectory(path)) {
+    return kFileSystemError;
+  }
   ScopedLockFile lock_file;
-  if (!lock_file.ResetAcquire(path)) {
+  if (!lock_file.ResetAcquire(path, range_lock_path_)) {
     return kBusyError;
   }
 
@@ -356,12 +782,31 @@ OperationStatus CrashReportDatabaseGeneric::FinishedWritingCrashReport(
 
   FileOffset size = report->Writer()->Seek(0, SEEK_END);
 
+  if (commit) {
+    if (!report->Writer()->Sync()) {
+      return kFileSystemError;
+    }
+    for (auto& writer : report->attachment_writers_) {
+      if (!writer->Sync()) {
+        return kFileSystemError;
+      }
+    }
+    if (!report->attachment_writers_.empty() &&
+        !LoggingSyncDirectory(AttachmentsPath(report->ReportID()))) {
+      return kFileSystemError;
+    }
+  }
+
   report->Writer()->Close();
   if (!MoveFileOrDirectory(report->file_remover_.get(), path)) {
     return kFileSystemError;
   }
   // We've moved the report to pending, so it no longer needs to be removed.
   std::ignore = report->file_remover_.release();
+  if (commit && sharded_) {
+    std::lock_guard<std::mutex> lock(unsynced_shards_mutex_);
+    unsynced_shards_.insert(path.DirName());
+  }
 
   // Close all the attachments and disarm their removers too.
   for (auto& writer : report->attachment_writers_) {
@@ -373,6 +818,25 @@ OperationStatus CrashReportDatabaseGeneric::FinishedWritingCrashReport(
 
   *uuid = report->ReportID();
 
+  Report new_report;
+  if (compact_metadata()) {
+    new_report.uuid = *uuid;
+    new_report.creation_time = time(nullptr);
+    new_report.total_size =
+        GetFileSize(path) + GetDirectorySize(AttachmentsPath(*uuid));
+  }
+
+  // Release the lock before the index is written, so that a watcher of
+  // PendingReportsChangePath() can check out the report as soon as it’s
+  // notified.
+  lock_file.Reset();
+  UpdateIndex(path, kPending, new_report);
+
+  // A failed sync has been logged. The report is in the database either way.
+  if (commit) {
+    commit->Commit();
+  }
+
   Metrics::CrashReportPending(Metrics::PendingReportReason::kNewlyCreated);
   Metrics::CrashReportSize(size);
 
@@ -400,6 +864,53 @@ OperationStatus CrashReportDatabaseGeneric::GetCompletedReports(
   return ReportsInState(kCompleted, reports);
 }
 
+OperationStatus CrashReportDatabaseGeneric::GetOldestReports(
+    size_t max_reports,
+    std::vector<Report>* reports,
+    uint64_t* total_size) {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  DCHECK(reports->empty());
+
+  ScopedFileHandle index(OpenIndex());
+  if (!index.is_valid() ||
+      (!ReadIndex(index.get()) && !RebuildIndex(index.get()))) {
+    index.reset();
+    return CrashReportDatabase::GetOldestReports(
+        max_reports, reports, total_size);
+  }
+
+  for (const auto& age_and_uuid : indexed_reports_by_age_) {
+    if (reports->size() == max_reports) {
+      break;
+    }
+    const IndexedReport& indexed_report =
+        indexed_reports_.at(age_and_uuid.second);
+    reports->push_back(indexed_report.report);
+    reports->back().file_path =
+        ReportPath(indexed_report.report.uuid, indexed_report.state);
+  }
+  *total_size = indexed_total_size_;
+  return kNoError;
+}
+
+OperationStatus CrashReportDatabaseGeneric::GetStatistics(
+    Statistics* statistics) {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+
+  ScopedFileHandle index(OpenIndex());
+  if (!index.is_valid() ||
+      (!ReadIndex(index.get()) && !RebuildIndex(index.get()))) {
+    index.reset();
+    return CrashReportDatabase::GetStatistics(statistics);
+  }
+
+  *statistics = Statistics();
+  statistics->pending_reports = indexed_pending_reports_;
+  statistics->completed_reports = indexed_completed_reports_;
+  statistics->total_size = indexed_total_size_;
+  return kNoError;
+}
+
 OperationStatus CrashReportDatabaseGeneric::GetReportForUploading(
     const UUID& uuid,
     std::unique_ptr<const UploadReport>* report,
@@ -440,9 +951,14 @@ OperationStatus CrashReportDatabaseGeneric::SkipReportUpload(
     return os;
   }
 
+  // A byte-range lock covers the report in every state, and is already held.
   base::FilePath completed_path(ReportPath(uuid, kCompleted));
+  if (!CreateShardDirectory(completed_path)) {
+    return kFileSystemError;
+  }
   ScopedLockFile completed_lock_file;
-  if (!completed_lock_file.ResetAcquire(completed_path)) {
+  if (!compact_metadata() &&
+      !completed_lock_file.ResetAcquire(completed_path, range_lock_path_)) {
     return kBusyError;
   }
 
@@ -455,10 +971,12 @@ OperationStatus CrashReportDatabaseGeneric::SkipReportUpload(
     return kFileSystemError;
   }
 
-  if (!LoggingRemoveFile(ReplaceFinalExtension(path, kMetadataExtension))) {
+  if (!RemoveMetadata(path)) {
+    InvalidateIndex();
     return kDatabaseError;
   }
 
+  UpdateIndex(completed_path, kCompleted, report);
   return kNoError;
 }
 
@@ -476,8 +994,9 @@ OperationStatus CrashReportDatabaseGeneric::DeleteReport(const UUID& uuid) {
   if (!LoggingRemoveFile(path)) {
     return kFileSystemError;
   }
+  RemoveFromIndex(uuid);
 
-  if (!LoggingRemoveFile(ReplaceFinalExtension(path, kMetadataExtension))) {
+  if (!RemoveMetadata(path)) {
     return kDatabaseError;
   }
 
@@ -504,19 +1023,23 @@ OperationStatus CrashReportDatabaseGeneric::RequestUpload(const UUID& uuid) {
 
   report.upload_explicitly_requested = true;
   base::FilePath pending_path = ReportPath(uuid, kPending);
-  if (!MoveFileOrDirectory(path, pending_path)) {
+  if (!CreateShardDirectory(pending_path) ||
+      !MoveFileOrDirectory(path, pending_path)) {
     return kFileSystemError;
   }
 
   if (!WriteMetadata(pending_path, report)) {
+    InvalidateIndex();
     return kDatabaseError;
   }
 
   if (pending_path != path) {
-    if (!LoggingRemoveFile(ReplaceFinalExtension(path, kMetadataExtension))) {
+    if (!RemoveMetadata(path)) {
+      InvalidateIndex();
       return kDatabaseError;
     }
   }
+  UpdateIndex(pending_path, kPending, report);
 
   Metrics::CrashReportPending(Metrics::PendingReportReason::kUserInitiated);
   return kNoError;
@@ -526,6 +1049,11 @@ int CrashReportDatabaseGeneric::CleanDatabase(time_t lockfile_ttl) {
   int removed = 0;
   time_t now = time(nullptr);
 
+  // Versions that predate shards may have added reports outside of them.
+  if (sharded_) {
+    MigrateUnshardedReports();
+  }
+
   DirectoryReader reader;
   const base::FilePath new_dir(base_dir_.Append(kNewDirectory));
   if (reader.Open(new_dir)) {
@@ -549,6 +1077,19 @@ int CrashReportDatabaseGeneric::CleanDatabase(time_t lockfile_ttl) {
   removed += CleanReportsInState(kPending, lockfile_ttl);
   removed += CleanReportsInState(kCompleted, lockfile_ttl);
   CleanOrphanedAttachments();
+  CleanSharedAttachments(lockfile_ttl);
+
+  // Cleaning bypasses the index, and a state transition interrupted by a crash
+  // may have left it stale, so rebuild it. With compact metadata, the index
+  // holds the reports’ metadata, so it’s read first and the rebuild reconciles
+  // it with the report files.
+  ScopedFileHandle index(OpenIndex());
+  if (index.is_valid()) {
+    if (compact_metadata()) {
+      ReadIndex(index.get());
+    }
+    RebuildIndex(index.get());
+  }
   return removed;
 }
 
@@ -575,8 +1116,14 @@ OperationStatus CrashReportDatabaseGeneric::RecordUploadAttempt(
     report->upload_explicitly_requested = false;
 
     base::FilePath completed_report_path = ReportPath(report->uuid, kCompleted);
+    if (!CreateShardDirectory(completed_report_path)) {
+      return kFileSystemError;
+    }
 
-    if (!lock_file.ResetAcquire(completed_report_path)) {
+    // A byte-range lock covers the report in every state, and is already
+    // held.
+    if (!compact_metadata() &&
+        !lock_file.ResetAcquire(completed_report_path, range_lock_path_)) {
       return kBusyError;
     }
 
@@ -585,13 +1132,15 @@ OperationStatus CrashReportDatabaseGeneric::RecordUploadAttempt(
       return kFileSystemError;
     }
 
-    LoggingRemoveFile(ReplaceFinalExtension(report_path, kMetadataExtension));
+    RemoveMetadata(report_path);
     report_path = completed_report_path;
   }
 
   if (!WriteMetadata(report_path, *report)) {
+    InvalidateIndex();
     return kDatabaseError;
   }
+  UpdateIndex(report_path, successful ? kCompleted : kPending, *report);
 
   if (!SettingsInternal().SetLastUploadAttemptTime(now)) {
     return kDatabaseError;
@@ -602,6 +1151,20 @@ OperationStatus CrashReportDatabaseGeneric::RecordUploadAttempt(
 
 base::FilePath CrashReportDatabaseGeneric::ReportPath(const UUID& uuid,
                                                       ReportState state) {
+  const base::FilePath path(UnshardedReportPath(uuid, state));
+  if (!sharded_ || state == kNew) {
+    return path;
+  }
+
+  const base::FilePath::StringType filename(path.BaseName().value());
+  return path.DirName()
+      .Append(filename.substr(0, kShardNameLength))
+      .Append(filename);
+}
+
+base::FilePath CrashReportDatabaseGeneric::UnshardedReportPath(
+    const UUID& uuid,
+    ReportState state) {
   DCHECK_NE(state, kUninitialized);
   DCHECK_NE(state, kSearchable);
 
@@ -615,6 +1178,107 @@ base::FilePath CrashReportDatabaseGeneric::ReportPath(const UUID& uuid,
       .Append(uuid_string + kCrashReportExtension);
 }
 
+bool CrashReportDatabaseGeneric::CreateShardDirectory(
+    const base::FilePath& path) {
+  return !sharded_ || LoggingCreateDirectory(
+                          path.DirName(), FilePermissions::kOwnerOnly, true);
+}
+
+bool CrashReportDatabaseGeneric::VisitReportFiles(
+    ReportState state,
+    const std::function<void(const base::FilePath&)>& visit) {
+  const base::FilePath dir_path(base_dir_.Append(kReportDirectories[state]));
+  DirectoryReader reader;
+  if (!reader.Open(dir_path)) {
+    return false;
+  }
+
+  base::FilePath filename;
+  while (reader.NextFile(&filename) == DirectoryReader::Result::kSuccess) {
+    const base::FilePath path(dir_path.Append(filename));
+    if (!sharded_ || filename.value().size() != kShardNameLength ||
+        !IsDirectory(path, false)) {
+      visit(path);
+      continue;
+    }
+
+    DirectoryReader shard_reader;
+    if (!shard_reader.Open(path)) {
+      continue;
+    }
+    base::FilePath shard_filename;
+    while (shard_reader.NextFile(&shard_filename) ==
+           DirectoryReader::Result::kSuccess) {
+      visit(path.Append(shard_filename));
+    }
+  }
+  return true;
+}
+
+void CrashReportDatabaseGeneric::MigrateUnshardedReports() {
+  DCHECK(sharded_);
+
+  for (const ReportState state : {kPending, kCompleted}) {
+    const base::FilePath dir_path(base_dir_.Append(kReportDirectories[state]));
+    DirectoryReader reader;
+    if (!reader.Open(dir_path)) {
+      continue;
+    }
+
+    // A metadata file is moved after its report, so one left behind by an
+    // interrupted move is found on its own.
+    base::FilePath filename;
+    while (reader.NextFile(&filename) == DirectoryReader::Result::kSuccess) {
+      const base::FilePath::StringType extension(filename.FinalExtension());
+      UUID uuid;
+      if ((extension.compare(kCrashReportExtension) == 0 ||
+           extension.compare(kMetadataExtension) == 0) &&
+          uuid.InitializeFromString(filename.RemoveFinalExtension().value())) {
+        MoveReportToShard(uuid, state);
+      }
+    }
+  }
+}
+
+bool CrashReportDatabaseGeneric::MoveReportToShard(const UUID& uuid,
+                                                   ReportState state) {
+  const base::FilePath path(UnshardedReportPath(uuid, state));
+  const base::FilePath sharded_path(ReportPath(uuid, state));
+  if (!CreateShardDirectory(sharded_path)) {
+    return false;
+  }
+
+  // With lock files, the report is locked at both of its paths so that it
+  // can’t be found part way through the move. A byte-range lock covers both.
+  ScopedLockFile lock_file;
+  ScopedLockFile sharded_lock_file;
+  if (!lock_file.ResetAcquire(path, range_lock_path_) ||
+      (!compact_metadata() &&
+       !sharded_lock_file.ResetAcquire(sharded_path, range_lock_path_))) {
+    return false;
+  }
+
+  // Another database object may have moved the report since it was listed.
+  const bool moving_report = IsRegularFile(path);
+  if (moving_report && !MoveFileOrDirectory(path, sharded_path)) {
+    return false;
+  }
+
+  const base::FilePath metadata_path(
+      ReplaceFinalExtension(path, kMetadataExtension));
+  if (!compact_metadata() && IsRegularFile(metadata_path) &&
+      !MoveFileOrDirectory(
+          metadata_path,
+          ReplaceFinalExtension(sharded_path, kMetadataExtension))) {
+    // Keep the report beside its metadata, where it can still be found.
+    if (moving_report) {
+      MoveFileOrDirectory(sharded_path, path);
+    }
+    return false;
+  }
+  return true;
+}
+
 OperationStatus CrashReportDatabaseGeneric::LocateAndLockReport(
     const UUID& uuid,
     ReportState desired_state,
@@ -630,19 +1294,30 @@ OperationStatus CrashReportDatabaseGeneric::LocateAndLockReport(
   }
 
   for (const ReportState state : searchable_states) {
-    base::FilePath local_path(ReportPath(uuid, state));
-    ScopedLockFile local_lock;
-    if (!local_lock.ResetAcquire(local_path)) {
-      return kBusyError;
+    std::vector<base::FilePath> local_paths(1, ReportPath(uuid, state));
+    if (sharded_) {
+      // The report’s shard may not exist yet, and the report may still be
+      // where a version that predates shards put it.
+      if (!IsDirectory(local_paths[0].DirName(), false)) {
+        local_paths.clear();
+      }
+      local_paths.push_back(UnshardedReportPath(uuid, state));
     }
 
-    if (!IsRegularFile(local_path)) {
-      continue;
-    }
+    for (const base::FilePath& local_path : local_paths) {
+      ScopedLockFile local_lock;
+      if (!local_lock.ResetAcquire(local_path, range_lock_path_)) {
+        return kBusyError;
+      }
 
-    *path = local_path;
-    *lock_file = std::move(local_lock);
-    return kNoError;
+      if (!IsRegularFile(local_path)) {
+        continue;
+      }
+
+      *path = local_path;
+      *lock_file = std::move(local_lock);
+      return kNoError;
+    }
   }
 
   return kReportNotFound;
@@ -679,64 +1354,75 @@ OperationStatus CrashReportDatabaseGeneric::ReportsInState(
   DCHECK_NE(state, kSearchable);
   DCHECK_NE(state, kNew);
 
-  const base::FilePath dir_path(base_dir_.Append(kReportDirectories[state]));
-  DirectoryReader reader;
-  if (!reader.Open(dir_path)) {
-    return kDatabaseError;
+  ScopedFileHandle index(OpenIndex());
+  if (!index.is_valid() ||
+      (!ReadIndex(index.get()) && !RebuildIndex(index.get()))) {
+    // The scan may remove reports, which updates the index, so the index must
+    // not remain locked.
+    index.reset();
+    return ScanReportsInState(state, reports);
   }
 
-  base::FilePath filename;
-  DirectoryReader::Result result;
-  while ((result = reader.NextFile(&filename)) ==
-         DirectoryReader::Result::kSuccess) {
-    const base::FilePath::StringType extension(filename.FinalExtension());
-    if (extension.compare(kCrashReportExtension) != 0) {
-      continue;
-    }
-
-    const base::FilePath filepath(dir_path.Append(filename));
-    ScopedLockFile lock_file;
-    if (!lock_file.ResetAcquire(filepath)) {
-      continue;
+  for (const auto& uuid_and_report : indexed_reports_) {
+    const IndexedReport& indexed_report = uuid_and_report.second;
+    if (indexed_report.state == state) {
+      reports->push_back(indexed_report.report);
+      reports->back().file_path = ReportPath(indexed_report.report.uuid, state);
     }
-
-    Report report;
-    if (!CleaningReadMetadata(filepath, &report)) {
-      continue;
-    }
-    reports->push_back(report);
-    reports->back().file_path = filepath;
   }
   return kNoError;
 }
 
+OperationStatus CrashReportDatabaseGeneric::ScanReportsInState(
+    ReportState state,
+    std::vector<Report>* reports) {
+  const bool visited =
+      VisitReportFiles(state, [this, reports](const base::FilePath& filepath) {
+        const base::FilePath::StringType extension(filepath.FinalExtension());
+        if (extension.compare(kCrashReportExtension) != 0) {
+          return;
+        }
+
+        ScopedLockFile lock_file;
+        if (!lock_file.ResetAcquire(filepath, range_lock_path_)) {
+          return;
+        }
+
+        Report report;
+        if (!CleaningReadMetadata(filepath, &report)) {
+          return;
+        }
+        reports->push_back(report);
+        reports->back().file_path = filepath;
+      });
+  return visited ? kNoError : kDatabaseError;
+}
+
 int CrashReportDatabaseGeneric::CleanReportsInState(ReportState state,
                                                     time_t lockfile_ttl) {
-  const base::FilePath dir_path(base_dir_.Append(kReportDirectories[state]));
-  DirectoryReader reader;
-  if (!reader.Open(dir_path)) {
+  // With compact metadata, there are no metadata or lock files, and reports
+  // without records are given them when the index is rebuilt.
+  if (compact_metadata()) {
     return 0;
   }
 
   int removed = 0;
-  base::FilePath filename;
-  DirectoryReader::Result result;
-  while ((result = reader.NextFile(&filename)) ==
-         DirectoryReader::Result::kSuccess) {
-    const base::FilePath::StringType extension(filename.FinalExtension());
-    const base::FilePath filepath(dir_path.Append(filename));
+  VisitReportFiles(state, [this, lockfile_ttl, &removed](
+                              const base::FilePath& filepath) {
+    const base::FilePath::StringType extension(filepath.FinalExtension());
 
     // Remove any report files without metadata.
     if (extension.compare(kCrashReportExtension) == 0) {
       const base::FilePath metadata_path(
           ReplaceFinalExtension(filepath, kMetadataExtension));
       ScopedLockFile report_lock;
-      if (report_lock.ResetAcquire(filepath) && !IsRegularFile(metadata_path) &&
+      if (report_lock.ResetAcquire(filepath, base::FilePath()) &&
+          !IsRegularFile(metadata_path) &&
           LoggingRemoveFile(filepath)) {
         ++removed;
         RemoveAttachmentsByUUID(UUIDFromReportPath(filepath));
       }
-      continue;
+      return;
     }
 
     // Remove any metadata files without report files.
@@ -744,12 +1430,12 @@ int CrashReportDatabaseGeneric::CleanReportsInState(ReportState state,
       const base::FilePath report_path(
           ReplaceFinalExtension(filepath, kCrashReportExtension));
       ScopedLockFile report_lock;
-      if (report_lock.ResetAcquire(report_path) &&
+      if (report_lock.ResetAcquire(report_path, base::FilePath()) &&
           !IsRegularFile(report_path) && LoggingRemoveFile(filepath)) {
         ++removed;
         RemoveAttachmentsByUUID(UUIDFromReportPath(filepath));
       }
-      continue;
+      return;
     }
 
     // Remove any expired locks only if we can remove the report and metadata.
@@ -760,16 +1446,15 @@ int CrashReportDatabaseGeneric::CleanReportsInState(ReportState state,
       const base::FilePath metadata_path(no_ext.value() + kMetadataExtension);
       if ((IsRegularFile(report_path) && !LoggingRemoveFile(report_path)) ||
           (IsRegularFile(metadata_path) && !LoggingRemoveFile(metadata_path))) {
-        continue;
+        return;
       }
 
       if (LoggingRemoveFile(filepath)) {
         ++removed;
         RemoveAttachmentsByUUID(UUIDFromReportPath(filepath));
       }
-      continue;
     }
-  }
+  });
 
   return removed;
 }
@@ -819,6 +1504,10 @@ void CrashReportDatabaseGeneric::CleanOrphanedAttachments() {
 
 bool CrashReportDatabaseGeneric::ReadMetadata(const base::FilePath& path,
                                               Report* report) {
+  if (compact_metadata()) {
+    return ReadIndexedMetadata(path, report);
+  }
+
   const base::FilePath metadata_path(
       ReplaceFinalExtension(path, kMetadataExtension));
 
@@ -872,14 +1561,119 @@ bool CrashReportDatabaseGeneric::CleaningReadMetadata(
     return true;
   }
 
+  if (compact_metadata()) {
+    return false;
+  }
+
   LoggingRemoveFile(path);
   LoggingRemoveFile(ReplaceFinalExtension(path, kMetadataExtension));
   RemoveAttachmentsByUUID(report->uuid);
+  RemoveFromIndex(UUIDFromReportPath(path));
   return false;
 }
 
-// static
+bool CrashReportDatabaseGeneric::ReadIndexedMetadata(const base::FilePath& path,
+                                                     Report* report) {
+  UUID uuid;
+  if (!uuid.InitializeFromString(
+          path.BaseName().RemoveFinalExtension().value())) {
+    LOG(ERROR) << "Couldn't interpret report uuid";
+    return false;
+  }
+
+  ReportState state = kUninitialized;
+  for (const ReportState candidate : {kPending, kCompleted}) {
+    if (path == ReportPath(uuid, candidate) ||
+        path == UnshardedReportPath(uuid, candidate)) {
+      state = candidate;
+      break;
+    }
+  }
+  if (state == kUninitialized) {
+    LOG(ERROR) << "unexpected report path " << path.value();
+    return false;
+  }
+
+  ScopedFileHandle index(OpenIndex());
+  if (!index.is_valid() ||
+      (!ReadIndex(index.get()) && !RebuildIndex(index.get()))) {
+    return false;
+  }
+
+  auto iterator = indexed_reports_.find(uuid);
+  if (iterator != indexed_reports_.end() && iterator->second.state == state) {
+    *report = iterator->second.report;
+    report->file_path = path;
+    return true;
+  }
+
+  // Either the report’s record was lost, or a state transition was interrupted
+  // between moving the report and recording it. Record the report where it was
+  // found, keeping what was recorded about it before.
+  if (iterator != indexed_reports_.end()) {
+    *report = iterator->second.report;
+  } else if (!ReadUnrecordedMetadata(path, report)) {
+    return false;
+  }
+  report->file_path = path;
+
+  // The appended record is picked up by the next read of the index.
+  std::string record;
+  SerializeIndexRecord(*report, state, &record);
+  if (LoggingSeekFile(index.get(), 0, SEEK_END) < 0) {
+    return false;
+  }
+  LoggingWriteFile(index.get(), record.data(), record.size());
+  return true;
+}
+
+bool CrashReportDatabaseGeneric::ReadMetadataForRebuild(
+    const base::FilePath& path,
+    Report* report) {
+  if (!compact_metadata()) {
+    return ReadMetadata(path, report);
+  }
+
+  // indexed_reports_ holds what could be read from the index before it was
+  // found to need rebuilding.
+  auto iterator = indexed_reports_.find(UUIDFromReportPath(path));
+  if (iterator == indexed_reports_.end()) {
+    return ReadUnrecordedMetadata(path, report);
+  }
+  *report = iterator->second.report;
+  report->file_path = path;
+  return true;
+}
+
+bool CrashReportDatabaseGeneric::ReadUnrecordedMetadata(
+    const base::FilePath& path,
+    Report* report) {
+  UUID uuid;
+  if (!uuid.InitializeFromString(
+          path.BaseName().RemoveFinalExtension().value())) {
+    LOG(ERROR) << "Couldn't interpret report uuid";
+    return false;
+  }
+
+  timespec modification_time;
+  if (!FileModificationTime(path, &modification_time)) {
+    return false;
+  }
+
+  *report = Report();
+  report->uuid = uuid;
+  report->creation_time = modification_time.tv_sec;
+  report->file_path = path;
+  report->total_size =
+      GetFileSize(path) + GetDirectorySize(AttachmentsPath(uuid));
+  return true;
+}
+
 bool CrashReportDatabaseGeneric::WriteNewMetadata(const base::FilePath& path) {
+  if (compact_metadata()) {
+    return true;
+  }
+
   const base::FilePath metadata_path(
       ReplaceFinalExtension(path, kMetadataExtension));
 
@@ -898,12 +1692,16 @@ bool CrashReportDatabaseGeneric::WriteNewMetadata(const base::FilePath& path) {
   metadata = {};
   metadata.creation_time = time(nullptr);
 
-  return LoggingWriteFile(handle.get(), &metadata, sizeof(metadata));
+  return LoggingWriteFile(handle.get(), &metadata, sizeof(metadata)) &&
+         (!group_commit_ || LoggingSyncFile(handle.get()));
 }
 
-// static
 bool CrashReportDatabaseGeneric::WriteMetadata(const base::FilePath& path,
                                                const Report& report) {
+  if (compact_metadata()) {
+    return true;
+  }
+
   const base::FilePath metadata_path(
       ReplaceFinalExtension(path, kMetadataExtension));
 
@@ -933,4 +1731,355 @@ bool CrashReportDatabaseGeneric::WriteMetadata(const base::FilePath& path,
          LoggingWriteFile(handle.get(), report.id.c_str(), report.id.size());
 }
 
+bool CrashReportDatabaseGeneric::RemoveMetadata(const base::FilePath& path) {
+  return compact_metadata() ||
+         LoggingRemoveFile(ReplaceFinalExtension(path, kMetadataExtension));
+}
+
+bool CrashReportDatabaseGeneric::SyncFinishedReports() {
+  std::set<base::FilePath> shards;
+  {
+    std::lock_guard<std::mutex> lock(unsynced_shards_mutex_);
+    shards.swap(unsynced_shards_);
+  }
+
+  // The pending directory is synced even in a sharded database, in case a
+  // report’s shard was created for it.
+  bool synced = LoggingSyncDirectory(base_dir_.Append(kPendingDirectory)) &&
+                LoggingSyncDirectory(AttachmentsRootPath());
+  for (const base::FilePath& shard : shards) {
+    synced = synced && LoggingSyncDirectory(shard);
+  }
+  if (synced && compact_metadata()) {
+    ScopedFileHandle index(LoggingOpenFileForRead(base_dir_.Append(kIndex)));
+    synced = index.is_valid() && LoggingSyncFile(index.get());
+  }
+  return synced;
+}
+
+ScopedFileHandle CrashReportDatabaseGeneric::OpenIndex() {
+#if BUILDFLAG(IS_FUCHSIA)
+  // Without file locking, concurrent users of the database could interleave
+  // their index updates, so the index is not used.
+  return ScopedFileHandle();
+#else
+  ScopedFileHandle handle(
+      LoggingOpenFileForReadAndWrite(base_dir_.Append(kIndex),
+                                     FileWriteMode::kReuseOrCreate,
+                                     FilePermissions::kOwnerOnly));
+  // The lock is released when the handle is closed.
+  if (handle.is_valid() &&
+      LoggingLockFile(handle.get(),
+                      FileLocking::kExclusive,
+                      FileLockingBlocking::kBlocking) !=
+          FileLockingResult::kSuccess) {
+    handle.reset();
+  }
+  return handle;
+#endif  // BUILDFLAG(IS_FUCHSIA)
+}
+
+bool CrashReportDatabaseGeneric::ReadIndex(FileHandle index) {
+  IndexHeader header;
+  if (LoggingSeekFile(index, 0, SEEK_SET) != 0 ||
+      !ReadFileExactly(index, &header, sizeof(header))) {
+    AbandonIndexRead();
+    return false;
+  }
+  if (header.magic != IndexHeader::kMagic ||
+      header.version != IndexHeader::kVersion) {
+    LOG(ERROR) << "index header mismatch";
+    AbandonIndexRead();
+    return false;
+  }
+
+  // Read only what was appended since the last read unless the index has been
+  // rewritten since then. An index that was rewritten under the same generation
+  // would have failed to read, and been rebuilt under a new one.
+  const FileOffset index_size = LoggingSeekFile(index, 0, SEEK_END);
+  if (index_size < 0) {
+    AbandonIndexRead();
+    return false;
+  }
+  if (index_size_read_ == 0 || header.generation != index_generation_ ||
+      index_size < index_size_read_) {
+    ResetIndexedReports();
+    index_generation_ = header.generation;
+    index_size_read_ = sizeof(header);
+  }
+
+  std::string contents;
+  if (LoggingSeekFile(index, index_size_read_, SEEK_SET) != index_size_read_ ||
+      !LoggingReadToEOF(index, &contents)) {
+    AbandonIndexRead();
+    return false;
+  }
+
+  size_t offset = 0;
+  while (offset < contents.size()) {
+    IndexRecord record;
+    if (contents.size() - offset < sizeof(record)) {
+      LOG(ERROR) << "truncated index";
+      AbandonIndexRead();
+      return false;
+    }
+    memcpy(&record, contents.data() + offset, sizeof(record));
+    offset += sizeof(record);
+
+    if (record.id_size > kMaxIndexedIDSize ||
+        contents.size() - offset < record.id_size) {
+      LOG(ERROR) << "truncated index";
+      AbandonIndexRead();
+      return false;
+    }
+    std::string id(contents, offset, record.id_size);
+    offset += record.id_size;
+
+    if (record.checksum != IndexRecordChecksum(record, id)) {
+      LOG(ERROR) << "index checksum mismatch";
+      AbandonIndexRead();
+      return false;
+    }
+    if (!ApplyIndexRecord(record, std::move(id))) {
+      AbandonIndexRead();
+      return false;
+    }
+    ++index_record_count_;
+  }
+  index_size_read_ += contents.size();
+
+  if (index_record_count_ >
+      indexed_reports_.size() * 2 + kIndexCompactionSlack) {
+    std::vector<IndexedReport> reports;
+    reports.reserve(indexed_reports_.size());
+    for (const auto& uuid_and_report : indexed_reports_) {
+      reports.push_back(uuid_and_report.second);
+    }
+    WriteIndex(index, reports);
+  }
+  return true;
+}
+
+bool CrashReportDatabaseGeneric::ApplyIndexRecord(const IndexRecord& record,
+                                                  std::string id) {
+  if (record.state == kUninitialized) {
+    RemoveIndexedReport(record.uuid);
+    return true;
+  }
+  if (record.state != kPending && record.state != kCompleted) {
+    LOG(ERROR) << "unexpected index state " << record.state;
+    return false;
+  }
+
+  IndexedReport indexed_report;
+  indexed_report.state = static_cast<ReportState>(record.state);
+  Report& report = indexed_report.report;
+  report.uuid = record.uuid;
+  report.id = std::move(id);
+  report.creation_time = record.creation_time;
+  report.uploaded = (record.attributes & kAttributeUploaded) != 0;
+  report.last_upload_attempt_time = record.last_upload_attempt_time;
+  report.upload_attempts = record.upload_attempts;
+  report.upload_explicitly_requested =
+      (record.attributes & kAttributeUploadExplicitlyRequested) != 0;
+  report.total_size = record.total_size;
+  AddIndexedReport(indexed_report);
+  return true;
+}
+
+void CrashReportDatabaseGeneric::AddIndexedReport(
+    const IndexedReport& indexed_report) {
+  const Report& report = indexed_report.report;
+  RemoveIndexedReport(report.uuid);
+  indexed_reports_.emplace(report.uuid, indexed_report);
+  indexed_reports_by_age_.insert(
+      std::make_pair(report.creation_time, report.uuid));
+  indexed_total_size_ += report.total_size;
+  if (indexed_report.state == kPending) {
+    ++indexed_pending_reports_;
+  } else if (indexed_report.state == kCompleted) {
+    ++indexed_completed_reports_;
+  }
+}
+
+void CrashReportDatabaseGeneric::RemoveIndexedReport(const UUID& uuid) {
+  auto iterator = indexed_reports_.find(uuid);
+  if (iterator == indexed_reports_.end()) {
+    return;
+  }
+
+  const Report& report = iterator->second.report;
+  indexed_reports_by_age_.erase(
+      std::make_pair(report.creation_time, report.uuid));
+  indexed_total_size_ -= report.total_size;
+  if (iterator->second.state == kPending) {
+    --indexed_pending_reports_;
+  } else if (iterator->second.state == kCompleted) {
+    --indexed_completed_reports_;
+  }
+  indexed_reports_.erase(iterator);
+}
+
+void CrashReportDatabaseGeneric::AbandonIndexRead() {
+  if (!compact_metadata()) {
+    ResetIndexedReports();
+    return;
+  }
+
+  index_size_read_ = 0;
+  index_record_count_ = 0;
+}
+
+void CrashReportDatabaseGeneric::ResetIndexedReports() {
+  indexed_reports_.clear();
+  indexed_reports_by_age_.clear();
+  indexed_total_size_ = 0;
+  indexed_pending_reports_ = 0;
+  indexed_completed_reports_ = 0;
+  index_size_read_ = 0;
+  index_record_count_ = 0;
+}
+
+bool CrashReportDatabaseGeneric::RebuildIndex(FileHandle index) {
+  std::vector<IndexedReport> reports;
+
+  // Reports are not locked while the index is rebuilt, so that reports locked
+  // for a long time, such as during upload, remain in the index. A report that
+  // is in the middle of a state transition may be missed or recorded in its
+  // previous state, but the transition will append an up-to-date record once
+  // it can lock the index.
+  for (const ReportState state : {kPending, kCompleted}) {
+    const bool visited = VisitReportFiles(
+        state, [this, state, &reports](const base::FilePath& filepath) {
+          if (filepath.FinalExtension().compare(kCrashReportExtension) != 0) {
+            return;
+          }
+
+          IndexedReport indexed_report;
+          indexed_report.state = state;
+          if (ReadMetadataForRebuild(filepath, &indexed_report.report)) {
+            reports.push_back(std::move(indexed_report));
+          }
+        });
+    if (!visited) {
+      return false;
+    }
+  }
+
+  return WriteIndex(index, reports);
+}
+
+void CrashReportDatabaseGeneric::UpdateIndex(const base::FilePath& path,
+                                             ReportState state,
+                                             const Report& report) {
+  ScopedFileHandle index(OpenIndex());
+  if (!index.is_valid()) {
+    return;
+  }
+
+  std::string record;
+  if (compact_metadata()) {
+    // The record is the only copy of the report’s metadata, so it must be
+    // appended even to an index that needs rebuilding, after the rebuild.
+    if ((!ReadIndex(index.get()) && !RebuildIndex(index.get())) ||
+        LoggingSeekFile(index.get(), 0, SEEK_END) < 0) {
+      return;
+    }
+    SerializeIndexRecord(report, state, &record);
+  } else {
+    // An empty index is rebuilt when it is next read, so there is no need to
+    // append to it.
+    if (LoggingSeekFile(index.get(), 0, SEEK_END) <= 0) {
+      return;
+    }
+
+    Report metadata;
+    if (!ReadMetadata(path, &metadata)) {
+      LoggingTruncateFile(index.get());
+      return;
+    }
+    SerializeIndexRecord(metadata, state, &record);
+  }
+
+  LoggingWriteFile(index.get(), record.data(), record.size());
+}
+
+void CrashReportDatabaseGeneric::RemoveFromIndex(const UUID& uuid) {
+  ScopedFileHandle index(OpenIndex());
+  if (!index.is_valid() || LoggingSeekFile(index.get(), 0, SEEK_END) <= 0) {
+    return;
+  }
+
+  Report report;
+  report.uuid = uuid;
+  std::string record;
+  SerializeIndexRecord(report, kUninitialized, &record);
+  LoggingWriteFile(index.get(), record.data(), record.size());
+}
+
+void CrashReportDatabaseGeneric::InvalidateIndex() {
+  if (compact_metadata()) {
+    return;
+  }
+
+  ScopedFileHandle index(OpenIndex());
+  if (index.is_valid()) {
+    LoggingTruncateFile(index.get());
+  }
+}
+
+bool CrashReportDatabaseGeneric::WriteIndex(
+    FileHandle index,
+    const std::vector<IndexedReport>& reports) {
+  ResetIndexedReports();
+
+  IndexHeader header;
+  if (!header.generation.InitializeWithNew()) {
+    return false;
+  }
+  std::string contents(reinterpret_cast<const char*>(&header), sizeof(header));
+  for (const IndexedReport& indexed_report : reports) {
+    SerializeIndexRecord(indexed_report.report, indexed_report.state, &contents);
+  }
+
+  // If this is interrupted, the index will fail to read and be rebuilt.
+  if (LoggingSeekFile(index, 0, SEEK_SET) != 0 || !LoggingTruncateFile(index) ||
+      !LoggingWriteFile(index, contents.data(), contents.size())) {
+    return false;
+  }
+
+  for (const IndexedReport& indexed_report : reports) {
+    AddIndexedReport(indexed_report);
+  }
+  index_generation_ = header.generation;
+  index_size_read_ = contents.size();
+  index_record_count_ = reports.size();
+  return true;
+}
+
+// static
+void CrashReportDatabaseGeneric::SerializeIndexRecord(const Report& report,
+                                                      ReportState state,
+                                                      std::string* buffer) {
+  std::string id(report.id, 0, kMaxIndexedIDSize);
+
+  IndexRecord record;
+  memset(&record, 0, sizeof(record));
+  record.id_size = static_cast<uint32_t>(id.size());
+  record.uuid = report.uuid;
+  record.state = state;
+  record.upload_attempts = report.upload_attempts;
+  record.last_upload_attempt_time = report.last_upload_attempt_time;
+  record.creation_time = report.creation_time;
+  record.total_size = report.total_size;
+  record.attributes =
+      (report.uploaded ? kAttributeUploaded : 0) |
+      (report.upload_explicitly_requested ? kAttributeUploadExplicitlyRequested
+                                          : 0);
+  record.checksum = IndexRecordChecksum(record, id);
+
+  buffer->append(reinterpret_cast<const char*>(&record), sizeof(record));
+  buffer->append(id);
+}
+
 }  // namespace crashpad
@@ -19,6 +19,7 @@
 #include <fcntl.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <string.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <time.h>
@@ -28,6 +29,7 @@
 #include <array>
 #include <iterator>
 #include <mutex>
+#include <string>
 #include <tuple>
 
 #include "base/logging.h"
@@ -67,6 +69,11 @@ constexpr std::array<const char*, 3> kReportDirectories = {
 
 constexpr char kCrashReportFileExtension[] = "dmp";
 
+constexpr char kXattrMetadata[] = "metadata";
+
+// These per-field xattrs held report metadata before kXattrMetadata. They are
+// still written alongside it, so that an older version sharing the database
+// can read reports, but are only read to migrate reports written before it.
 constexpr char kXattrUUID[] = "uuid";
 constexpr char kXattrCollectorID[] = "id";
 constexpr char kXattrCreationTime[] = "creation_time";
@@ -81,6 +88,70 @@ constexpr char kXattrIsUploadExplicitlyRequested[] =
 
 constexpr char kXattrDatabaseInitialized[] = "initialized";
 
+constexpr uint32_t kReportMetadataVersion = 1;
+
+enum : uint32_t {
+  kReportMetadataAttributeUploaded = 1 << 0,
+  kReportMetadataAttributeUploadExplicitlyRequested = 1 << 1,
+};
+
+// The value of the kXattrMetadata xattr, which holds all of a report’s
+// metadata so that it can be read with a single getxattr(). It is followed by
+// the report’s collector ID, without a NUL terminator.
+struct ReportMetadataXattr {
+  uint32_t version;  // kReportMetadataVersion
+  uint32_t attributes;  // kReportMetadataAttribute* values
+  UUID uuid;
+  int64_t creation_time;
+  int64_t last_upload_attempt_time;
+  int32_t upload_attempts;
+  uint32_t padding;
+};
+
+std::string PackReportMetadata(const CrashReportDatabase::Report& report) {
+  ReportMetadataXattr packed = {};
+  packed.version = kReportMetadataVersion;
+  packed.attributes =
+      (report.uploaded ? kReportMetadataAttributeUploaded : 0) |
+      (report.upload_explicitly_requested
+           ? kReportMetadataAttributeUploadExplicitlyRequested
+           : 0);
+  packed.uuid = report.uuid;
+  packed.creation_time = report.creation_time;
+  packed.last_upload_attempt_time = report.last_upload_attempt_time;
+  packed.upload_attempts = report.upload_attempts;
+
+  std::string value(reinterpret_cast<const char*>(&packed), sizeof(packed));
+  value.append(report.id);
+  return value;
+}
+
+bool UnpackReportMetadata(const std::string& value,
+                          CrashReportDatabase::Report* report) {
+  ReportMetadataXattr packed;
+  if (value.size() < sizeof(packed)) {
+    LOG(ERROR) << "report metadata size " << value.size();
+    return false;
+  }
+  memcpy(&packed, value.data(), sizeof(packed));
+  if (packed.version != kReportMetadataVersion) {
+    LOG(ERROR) << "report metadata version " << packed.version;
+    return false;
+  }
+
+  report->uuid = packed.uuid;
+  report->id = value.substr(sizeof(packed));
+  report->creation_time = packed.creation_time;
+  report->uploaded =
+      (packed.attributes & kReportMetadataAttributeUploaded) != 0;
+  report->last_upload_attempt_time = packed.last_upload_attempt_time;
+  report->upload_attempts = packed.upload_attempts;
+  report->upload_explicitly_requested =
+      (packed.attributes & kReportMetadataAttributeUploadExplicitlyRequested) !=
+      0;
+  return true;
+}
+
 // Ensures that the node at |path| is a directory. If the |path| refers to a
 // file, rather than a directory, returns false. Otherwise, returns true,
 // indicating that |path| already was a directory.
@@ -157,6 +228,7 @@ class CrashReportDatabaseMac : public CrashReportDatabase {
   OperationStatus LookUpCrashReport(const UUID& uuid, Report* report) override;
   OperationStatus GetPendingReports(std::vector<Report>* reports) override;
   OperationStatus GetCompletedReports(std::vector<Report>* reports) override;
+  OperationStatus GetStatistics(Statistics* statistics) override;
   OperationStatus GetReportForUploading(
       const UUID& uuid,
       std::unique_ptr<const UploadReport>* report,
@@ -235,6 +307,64 @@ class CrashReportDatabaseMac : public CrashReportDatabase {
   //!     otherwise.
   bool ReadReportMetadataLocked(const base::FilePath& path, Report* report);
 
+  //! \brief Reads the metadata xattrs from a report file into a Report,
+  //!     without its size.
+  //!
+  //! The metadata is read from the packed metadata xattr. For a report written
+  //! before that existed, it is read from the older per-field xattrs instead,
+  //! and the packed xattr is written so that later reads are a single
+  //! `getxattr()`.
+  //!
+  //! The file must be locked with ObtainReportLock, unless it is a new report
+  //! still being written.
+  //!
+  //! \param[in] path The path of the report.
+  //! \param[out] report The object into which data will be read.
+  //!
+  //! \return `true` if all the metadata was read successfully, `false`
+  //!     otherwise.
+  bool ReadReportXattrs(const base::FilePath& path, Report* report);
+
+  //! \brief Reads a report’s metadata from the older per-field xattrs.
+  //!
+  //! \param[in] path The path of the report.
+  //! \param[out] report The object into which data will be read.
+  //!
+  //! \return `true` if all the metadata was read successfully, `false`
+  //!     otherwise.
+  bool ReadReportFieldXattrs(const base::FilePath& path, Report* report);
+
+  //! \brief Writes a report’s metadata to the packed metadata xattr, and to
+  //!     the older per-field xattrs.
+  //!
+  //! The per-field xattrs are kept current so that an older version sharing
+  //! the database can still find the report and read its metadata.
+  //!
+  //! The file must be locked as for ReadReportXattrs().
+  //!
+  //! \param[in] path The path of the report.
+  //! \param[in] report The metadata to write.
+  //!
+  //! \return `true` on success, `false` on failure with a message logged.
+  bool WriteReportXattrs(const base::FilePath& path, const Report& report);
+
+  //! \brief Writes a report’s metadata to the older per-field xattrs.
+  //!
+  //! \param[in] path The path of the report.
+  //! \param[in] report The metadata to write.
+  //!
+  //! \return `true` on success, `false` on failure with a message logged.
+  bool WriteReportFieldXattrs(const base::FilePath& path, const Report& report);
+
+  //! \brief Reads the UUID of a report, from the packed metadata xattr or, for
+  //!     an older report, the UUID xattr.
+  //!
+  //! \param[in] path The path of the report.
+  //! \param[out] uuid The report’s UUID.
+  //!
+  //! \return `true` on success, `false` on failure.
+  bool ReadReportUUID(const base::FilePath& path, UUID* uuid);
+
   //! \brief Reads the metadata from all the reports in a database subdirectory.
   //!      Invalid reports are skipped.
   //!
@@ -245,6 +375,19 @@ class CrashReportDatabaseMac : public CrashReportDatabase {
   OperationStatus ReportsInDirectory(const base::FilePath& path,
                                      std::vector<Report>* reports);
 
+  //! \brief Counts the reports in a database subdirectory and sums their
+  //!     sizes, without reading their metadata or locking them.
+  //!
+  //! \param[in] path The database subdirectory path.
+  //! \param[out] count The number of reports in the subdirectory.
+  //! \param[in,out] total_size The sizes of the reports, including their
+  //!     attachments, are added to this.
+  //!
+  //! \return The operation status code.
+  OperationStatus StatisticsInDirectory(const base::FilePath& path,
+                                        size_t* count,
+                                        uint64_t* total_size);
+
   //! \brief Creates a database xattr name from the short constant name.
   //!
   //! \param[in] name The short name of the extended attribute.
@@ -359,9 +502,9 @@ CrashReportDatabaseMac::PrepareNewCrashReport(
   }
 
   // TODO(rsesek): Potentially use an fsetxattr() here instead.
-  if (!WriteXattr(report->file_remover_.get(),
-                  XattrName(kXattrUUID),
-                  report->ReportID().ToString())) {
+  Report metadata;
+  metadata.uuid = report->ReportID();
+  if (!WriteReportXattrs(report->file_remover_.get(), metadata)) {
     return kDatabaseError;
   }
 
@@ -378,13 +521,12 @@ CrashReportDatabaseMac::FinishedWritingCrashReport(
   const base::FilePath& path = report->file_remover_.get();
 
   // Get the report's UUID to return.
-  std::string uuid_string;
-  if (ReadXattr(path, XattrName(kXattrUUID), &uuid_string) !=
-          XattrStatus::kOK ||
-      !uuid->InitializeFromString(uuid_string)) {
+  Report metadata;
+  if (!ReadReportXattrs(path, &metadata)) {
     LOG(ERROR) << "Failed to read UUID for crash report " << path.value();
     return kDatabaseError;
   }
+  *uuid = metadata.uuid;
 
   if (*uuid != report->ReportID()) {
     LOG(ERROR) << "UUID mismatch for crash report " << path.value();
@@ -392,7 +534,8 @@ CrashReportDatabaseMac::FinishedWritingCrashReport(
   }
 
   // Record the creation time of this report.
-  if (!WriteXattrTimeT(path, XattrName(kXattrCreationTime), time(nullptr))) {
+  metadata.creation_time = time(nullptr);
+  if (!WriteReportXattrs(path, metadata)) {
     return kDatabaseError;
   }
 
@@ -458,6 +601,23 @@ CrashReportDatabaseMac::GetCompletedReports(
   return ReportsInDirectory(base_dir_.Append(kCompletedDirectory), reports);
 }
 
+CrashReportDatabase::OperationStatus CrashReportDatabaseMac::GetStatistics(
+    Statistics* statistics) {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+
+  *statistics = Statistics();
+  OperationStatus status =
+      StatisticsInDirectory(base_dir_.Append(kUploadPendingDirectory),
+                            &statistics->pending_reports,
+                            &statistics->total_size);
+  if (status != kNoError) {
+    return status;
+  }
+  return StatisticsInDirectory(base_dir_.Append(kCompletedDirectory),
+                               &statistics->completed_reports,
+                               &statistics->total_size);
+}
+
 CrashReportDatabase::OperationStatus
 CrashReportDatabaseMac::GetReportForUploading(
     const UUID& uuid,
@@ -559,25 +719,17 @@ CrashReportDatabaseMac::RecordUploadAttempt(UploadReport* report,
   }
 #endif
 
-  if (!WriteXattrBool(report_path, XattrName(kXattrIsUploaded), successful)) {
-    return kDatabaseError;
-  }
-  if (!WriteXattr(report_path, XattrName(kXattrCollectorID), id)) {
+  Report metadata;
+  if (!ReadReportXattrs(report_path, &metadata)) {
     return kDatabaseError;
   }
 
   time_t now = time(nullptr);
-  if (!WriteXattrTimeT(report_path, XattrName(kXattrLastUploadTime), now)) {
-    return kDatabaseError;
-  }
-
-  int upload_attempts = 0;
-  std::string name = XattrName(kXattrUploadAttemptCount);
-  if (ReadXattrInt(report_path, name, &upload_attempts) ==
-          XattrStatus::kOtherError) {
-    return kDatabaseError;
-  }
-  if (!WriteXattrInt(report_path, name, ++upload_attempts)) {
+  metadata.uploaded = successful;
+  metadata.id = id;
+  metadata.last_upload_attempt_time = now;
+  ++metadata.upload_attempts;
+  if (!WriteReportXattrs(report_path, metadata)) {
     return kDatabaseError;
   }
 
@@ -663,10 +815,8 @@ base::FilePath CrashReportDatabaseMac::LocateCrashReport(
     }
 
     // Check that the UUID of the report matches.
-    std::string uuid_string;
-    if (ReadXattr(path, XattrName(kXattrUUID),
-                  &uuid_string) == XattrStatus::kOK &&
-        uuid_string == target_uuid) {
+    UUID report_uuid;
+    if (ReadReportUUID(path, &report_uuid) && report_uuid == uuid) {
       return path;
     }
   }
@@ -688,18 +838,16 @@ CrashReportDatabase::OperationStatus CrashReportDatabaseMac::RequestUpload(
     return kBusyError;
 
   // If the crash report has already been uploaded, don't request new upload.
-  bool uploaded = false;
-  XattrStatus status =
-      ReadXattrBool(report_path, XattrName(kXattrIsUploaded), &uploaded);
-  if (status == XattrStatus::kOtherError)
+  Report metadata;
+  if (!ReadReportXattrs(report_path, &metadata))
     return kDatabaseError;
-  if (uploaded)
+  if (metadata.uploaded)
     return kCannotRequestUpload;
 
   // Mark the crash report as having upload explicitly requested by the user,
   // and move it to the pending state.
-  if (!WriteXattrBool(
-          report_path, XattrName(kXattrIsUploadExplicitlyRequested), true)) {
+  metadata.upload_explicitly_requested = true;
+  if (!WriteReportXattrs(report_path, metadata)) {
     return kDatabaseError;
   }
 
@@ -741,6 +889,7 @@ int CrashReportDatabaseMac::CleanDatabase(time_t lockfile_ttl) {
   }
 
   CleanOrphanedAttachments();
+  CleanSharedAttachments(lockfile_ttl);
   return removed;
 }
 
@@ -756,6 +905,73 @@ base::ScopedFD CrashReportDatabaseMac::ObtainReportLock(
 
 bool CrashReportDatabaseMac::ReadReportMetadataLocked(
     const base::FilePath& path, Report* report) {
+  if (!ReadReportXattrs(path, report)) {
+    return false;
+  }
+
+  // Seed the total size with the main report size and then add the sizes of any
+  // potential attachments.
+  uint64_t total_size = GetFileSize(path);
+  total_size += GetDirectorySize(AttachmentsPath(report->uuid));
+  report->total_size = total_size;
+
+  return true;
+}
+
+CrashReportDatabase::OperationStatus
+CrashReportDatabaseMac::StatisticsInDirectory(const base::FilePath& path,
+                                              size_t* count,
+                                              uint64_t* total_size) {
+  DirectoryReader reader;
+  if (!reader.Open(path)) {
+    return kFileSystemError;
+  }
+
+  *count = 0;
+  base::FilePath filename;
+  DirectoryReader::Result result;
+  while ((result = reader.NextFile(&filename)) ==
+         DirectoryReader::Result::kSuccess) {
+    // Reports are named for their UUIDs, which locates their attachments.
+    UUID uuid;
+    if (filename.FinalExtension() !=
+            std::string(".") + kCrashReportFileExtension ||
+        !uuid.InitializeFromString(filename.RemoveFinalExtension().value())) {
+      continue;
+    }
+
+    ++*count;
+    *total_size += GetFileSize(path.Append(filename));
+    *total_size += GetDirectorySize(AttachmentsPath(uuid));
+  }
+  return result == DirectoryReader::Result::kNoMoreFiles ? kNoError
+                                                         : kFileSystemError;
+}
+
+bool CrashReportDatabaseMac::ReadReportXattrs(const base::FilePath& path,
+                                              Report* report) {
+  std::string value;
+  switch (ReadXattr(path, XattrName(kXattrMetadata), &value)) {
+    case XattrStatus::kOK:
+      return UnpackReportMetadata(value, report);
+    case XattrStatus::kNoAttribute:
+      break;
+    case XattrStatus::kOtherError:
+      return false;
+  }
+
+  if (!ReadReportFieldXattrs(path, report)) {
+    return false;
+  }
+
+  // The report can still be used if this fails, and migrating it will be tried
+  // again the next time it is read.
+  WriteReportXattrs(path, *report);
+  return true;
+}
+
+bool CrashReportDatabaseMac::ReadReportFieldXattrs(const base::FilePath& path,
+                                                   Report* report) {
   std::string uuid_string;
   if (ReadXattr(path, XattrName(kXattrUUID),
                 &uuid_string) != XattrStatus::kOK ||
@@ -801,15 +1017,56 @@ bool CrashReportDatabaseMac::ReadReportMetadataLocked(
     return false;
   }
 
-  // Seed the total size with the main report size and then add the sizes of any
-  // potential attachments.
-  uint64_t total_size = GetFileSize(path);
-  total_size += GetDirectorySize(AttachmentsPath(report->uuid));
-  report->total_size = total_size;
-
   return true;
 }
 
+bool CrashReportDatabaseMac::WriteReportXattrs(const base::FilePath& path,
+                                               const Report& report) {
+  return WriteXattr(
+             path, XattrName(kXattrMetadata), PackReportMetadata(report)) &&
+         WriteReportFieldXattrs(path, report);
+}
+
+bool CrashReportDatabaseMac::WriteReportFieldXattrs(const base::FilePath& path,
+                                                    const Report& report) {
+  return WriteXattr(path, XattrName(kXattrUUID), report.uuid.ToString()) &&
+         WriteXattrTimeT(
+             path, XattrName(kXattrCreationTime), report.creation_time) &&
+         WriteXattr(path, XattrName(kXattrCollectorID), report.id) &&
+         WriteXattrBool(path, XattrName(kXattrIsUploaded), report.uploaded) &&
+         WriteXattrTimeT(path,
+                         XattrName(kXattrLastUploadTime),
+                         report.last_upload_attempt_time) &&
+         WriteXattrInt(path,
+                       XattrName(kXattrUploadAttemptCount),
+                       report.upload_attempts) &&
+         WriteXattrBool(path,
+                        XattrName(kXattrIsUploadExplicitlyRequested),
+                        report.upload_explicitly_requested);
+}
+
+bool CrashReportDatabaseMac::ReadReportUUID(const base::FilePath& path,
+                                            UUID* uuid) {
+  std::string value;
+  switch (ReadXattr(path, XattrName(kXattrMetadata), &value)) {
+    case XattrStatus::kOK: {
+      Report report;
+      if (!UnpackReportMetadata(value, &report)) {
+        return false;
+      }
+      *uuid = report.uuid;
+      return true;
+    }
+    case XattrStatus::kNoAttribute:
+      break;
+    case XattrStatus::kOtherError:
+      return false;
+  }
+
+  return ReadXattr(path, XattrName(kXattrUUID), &value) == XattrStatus::kOK &&
+         uuid->InitializeFromString(value);
+}
+
 CrashReportDatabase::OperationStatus CrashReportDatabaseMac::ReportsInDirectory(
     const base::FilePath& path,
     std::vector<CrashReportDatabase::Report>* reports) {
@@ -854,10 +1111,16 @@ CrashReportDatabase::OperationStatus
 CrashReportDatabaseMac::MarkReportCompletedLocked(
     const base::FilePath& report_path,
     base::FilePath* out_path) {
-  if (RemoveXattr(report_path, XattrName(kXattrIsUploadExplicitlyRequested)) ==
-      XattrStatus::kOtherError) {
+  Report metadata;
+  if (!ReadReportXattrs(report_path, &metadata)) {
     return kDatabaseError;
   }
+  if (metadata.upload_explicitly_requested) {
+    metadata.upload_explicitly_requested = false;
+    if (!WriteReportXattrs(report_path, metadata)) {
+      return kDatabaseError;
+    }
+  }
 
   base::FilePath new_path =
       base_dir_.Append(kCompletedDirectory).Append(report_path.BaseName());
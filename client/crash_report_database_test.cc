@@ -14,6 +14,11 @@
 
 #include "client/crash_report_database.h"
 
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
 #include "build/build_config.h"
 #include "client/settings.h"
 #include "gtest/gtest.h"
@@ -21,13 +26,19 @@
 #include "test/file.h"
 #include "test/filesystem.h"
 #include "test/scoped_temp_dir.h"
+#include "util/file/directory_reader.h"
 #include "util/file/file_io.h"
 #include "util/file/filesystem.h"
 
-#if BUILDFLAG(IS_IOS)
+#if BUILDFLAG(IS_APPLE)
 #include "util/mac/xattr.h"
 #endif
 
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+#include "util/linux/directory_watcher.h"
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+
 namespace crashpad {
 namespace test {
 namespace {
@@ -42,6 +53,14 @@ class CrashReportDatabaseTest : public testing::Test {
  protected:
   // testing::Test:
   void SetUp() override {
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+    if (compact_metadata_) {
+      db_ = CrashReportDatabase::InitializeWithCompactMetadata(path());
+      ASSERT_TRUE(db_);
+      return;
+    }
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
     db_ = CrashReportDatabase::Initialize(path());
     ASSERT_TRUE(db_);
   }
@@ -50,9 +69,35 @@ class CrashReportDatabaseTest : public testing::Test {
 
   CrashReportDatabase* db() { return db_.get(); }
   base::FilePath path() const {
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+    if (compact_metadata_) {
+      return temp_dir_.path().Append(
+          FILE_PATH_LITERAL("crashpad_compact_test_database"));
+    }
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
     return temp_dir_.path().Append(FILE_PATH_LITERAL("crashpad_test_database"));
   }
 
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+  // Replaces the database with a new one, at a different path, that is
+  // created with compact metadata.
+  void UseCompactMetadata() {
+    ResetDatabase();
+    compact_metadata_ = true;
+    SetUp();
+  }
+
+  // Reopens the database so that it keeps its reports in shards.
+  void UseShardedReports() {
+    ResetDatabase();
+    db_ = CrashReportDatabase::InitializeWithShardedReports(path(),
+                                                            compact_metadata_);
+    ASSERT_TRUE(db_);
+  }
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+
   void CreateCrashReport(CrashReportDatabase::Report* report) {
     std::unique_ptr<CrashReportDatabase::NewReport> new_report;
     ASSERT_EQ(db_->PrepareNewCrashReport(&new_report),
@@ -132,6 +177,10 @@ class CrashReportDatabaseTest : public testing::Test {
  private:
   ScopedTempDir temp_dir_;
   std::unique_ptr<CrashReportDatabase> db_;
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+  bool compact_metadata_ = false;
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
 };
 
 TEST_F(CrashReportDatabaseTest, Initialize) {
@@ -555,6 +604,90 @@ TEST_F(CrashReportDatabaseTest, InterruptedIOSUploads) {
 }
 #endif
 
+#if BUILDFLAG(IS_APPLE)
+TEST_F(CrashReportDatabaseTest, MigrateFieldXattrs) {
+  CrashReportDatabase::Report report;
+  CreateCrashReport(&report);
+
+  // Replace the packed metadata with the per-field xattrs that reports were
+  // written with before it.
+  static constexpr char kPrefix[] = "org.chromium.crashpad.database.";
+  const std::string metadata_name = std::string(kPrefix) + "metadata";
+  ASSERT_EQ(RemoveXattr(report.file_path, metadata_name), XattrStatus::kOK);
+  ASSERT_TRUE(WriteXattr(report.file_path,
+                         std::string(kPrefix) + "uuid",
+                         report.uuid.ToString()));
+  ASSERT_TRUE(WriteXattrTimeT(report.file_path,
+                              std::string(kPrefix) + "creation_time",
+                              report.creation_time));
+  ASSERT_TRUE(WriteXattrInt(
+      report.file_path, std::string(kPrefix) + "upload_count", 3));
+  ASSERT_TRUE(WriteXattrBool(
+      report.file_path,
+      std::string(kPrefix) + "upload_explicitly_requested",
+      true));
+
+  CrashReportDatabase::Report migrated;
+  ASSERT_EQ(db()->LookUpCrashReport(report.uuid, &migrated),
+            CrashReportDatabase::kNoError);
+  EXPECT_EQ(migrated.uuid, report.uuid);
+  EXPECT_EQ(migrated.creation_time, report.creation_time);
+  EXPECT_EQ(migrated.upload_attempts, 3);
+  EXPECT_TRUE(migrated.upload_explicitly_requested);
+  EXPECT_FALSE(migrated.uploaded);
+
+  // The packed metadata was written when the report was read.
+  std::string value;
+  EXPECT_EQ(ReadXattr(report.file_path, metadata_name, &value),
+            XattrStatus::kOK);
+
+  UploadReport(report.uuid, true, "1");
+  ASSERT_EQ(db()->LookUpCrashReport(report.uuid, &migrated),
+            CrashReportDatabase::kNoError);
+  EXPECT_TRUE(migrated.uploaded);
+  EXPECT_EQ(migrated.id, "1");
+  EXPECT_EQ(migrated.upload_attempts, 4);
+  EXPECT_FALSE(migrated.upload_explicitly_requested);
+}
+
+TEST_F(CrashReportDatabaseTest, FieldXattrsKeptCurrent) {
+  CrashReportDatabase::Report report;
+  CreateCrashReport(&report);
+  ASSERT_EQ(db()->RequestUpload(report.uuid), CrashReportDatabase::kNoError);
+
+  // An older version only reads the per-field xattrs, so it can find the
+  // report by its UUID.
+  static constexpr char kPrefix[] = "org.chromium.crashpad.database.";
+  std::string uuid_string;
+  ASSERT_EQ(ReadXattr(report.file_path,
+                      std::string(kPrefix) + "uuid",
+                      &uuid_string),
+            XattrStatus::kOK);
+  EXPECT_EQ(uuid_string, report.uuid.ToString());
+
+  UploadReport(report.uuid, true, "1");
+  CrashReportDatabase::Report uploaded;
+  ASSERT_EQ(db()->LookUpCrashReport(report.uuid, &uploaded),
+            CrashReportDatabase::kNoError);
+
+  // Without the packed metadata, the report is read from the per-field xattrs
+  // as an older version would read it, and they reflect the update.
+  ASSERT_EQ(RemoveXattr(uploaded.file_path, std::string(kPrefix) + "metadata"),
+            XattrStatus::kOK);
+  CrashReportDatabase::Report field_report;
+  ASSERT_EQ(db()->LookUpCrashReport(report.uuid, &field_report),
+            CrashReportDatabase::kNoError);
+  EXPECT_EQ(field_report.uuid, report.uuid);
+  EXPECT_EQ(field_report.creation_time, report.creation_time);
+  EXPECT_TRUE(field_report.uploaded);
+  EXPECT_EQ(field_report.id, "1");
+  EXPECT_EQ(field_report.last_upload_attempt_time,
+            uploaded.last_upload_attempt_time);
+  EXPECT_EQ(field_report.upload_attempts, 1);
+  EXPECT_FALSE(field_report.upload_explicitly_requested);
+}
+#endif  // BUILDFLAG(IS_APPLE)
+
 TEST_F(CrashReportDatabaseTest, UploadAlreadyUploaded) {
   CrashReportDatabase::Report report;
   CreateCrashReport(&report);
@@ -855,6 +988,75 @@ TEST_F(CrashReportDatabaseTest, OrphanedAttachments) {
   EXPECT_FALSE(FileExists(report_attachments_dir));
 }
 
+#if !BUILDFLAG(IS_FUCHSIA)
+TEST_F(CrashReportDatabaseTest, DeduplicatedAttachments) {
+  db()->EnableAttachmentDeduplication();
+
+  const base::FilePath source_path(path().Append(FILE_PATH_LITERAL("source")));
+  static constexpr char test_data[] = "shared attachment data";
+  {
+    ScopedFileHandle source(
+        LoggingOpenFileForWrite(source_path,
+                                FileWriteMode::kCreateOrFail,
+                                FilePermissions::kOwnerOnly));
+    ASSERT_TRUE(source.is_valid());
+    ASSERT_TRUE(LoggingWriteFile(source.get(), test_data, sizeof(test_data)));
+  }
+
+  UUID uuids[2];
+  for (UUID& uuid : uuids) {
+    std::unique_ptr<CrashReportDatabase::NewReport> new_report;
+    ASSERT_EQ(db()->PrepareNewCrashReport(&new_report),
+              CrashReportDatabase::kNoError);
+    ScopedFileHandle source(LoggingOpenFileForRead(source_path));
+    ASSERT_TRUE(source.is_valid());
+    EXPECT_FALSE(
+        new_report->AddAttachmentFromFile("not/a valid fi!e", source.get()));
+    ASSERT_TRUE(new_report->AddAttachmentFromFile("log", source.get()));
+    ASSERT_EQ(db()->FinishedWritingCrashReport(std::move(new_report), &uuid),
+              CrashReportDatabase::kNoError);
+  }
+
+  for (const UUID& uuid : uuids) {
+    std::unique_ptr<const CrashReportDatabase::UploadReport> upload_report;
+    ASSERT_EQ(db()->GetReportForUploading(uuid, &upload_report),
+              CrashReportDatabase::kNoError);
+    std::map<std::string, FileReader*> result_attachments =
+        upload_report->GetAttachments();
+    ASSERT_EQ(result_attachments.size(), 1u);
+    ASSERT_NE(result_attachments.find("log"), result_attachments.end());
+    char result_buffer[sizeof(test_data)];
+    ASSERT_TRUE(result_attachments["log"]->ReadExactly(result_buffer,
+                                                       sizeof(result_buffer)));
+    EXPECT_EQ(memcmp(test_data, result_buffer, sizeof(test_data)), 0);
+  }
+
+  // Both reports’ attachments are links to a single stored copy.
+  const base::FilePath shared_dir(
+      path().Append(FILE_PATH_LITERAL("shared_attachments")));
+  std::vector<base::FilePath> shared_files;
+  {
+    DirectoryReader reader;
+    ASSERT_TRUE(reader.Open(shared_dir));
+    base::FilePath filename;
+    while (reader.NextFile(&filename) == DirectoryReader::Result::kSuccess) {
+      shared_files.push_back(shared_dir.Append(filename));
+    }
+  }
+  ASSERT_EQ(shared_files.size(), 1u);
+  EXPECT_EQ(GetFileLinkCount(shared_files[0]), 3u);
+
+  // The stored copy is kept until no report refers to it.
+  EXPECT_EQ(db()->DeleteReport(uuids[0]), CrashReportDatabase::kNoError);
+  db()->CleanDatabase(0);
+  EXPECT_EQ(GetFileLinkCount(shared_files[0]), 2u);
+
+  EXPECT_EQ(db()->DeleteReport(uuids[1]), CrashReportDatabase::kNoError);
+  db()->CleanDatabase(0);
+  EXPECT_FALSE(FileExists(shared_files[0]));
+}
+#endif  // !BUILDFLAG(IS_FUCHSIA)
+
 // This test uses knowledge of the database format to break it, so it only
 // applies to the unfified database implementation.
 #if !BUILDFLAG(IS_APPLE) && !BUILDFLAG(IS_WIN)
@@ -924,6 +1126,544 @@ TEST_F(CrashReportDatabaseTest, CleanBrokenDatabase) {
 }
 #endif  // !BUILDFLAG(IS_APPLE) && !BUILDFLAG(IS_WIN)
 
+#if !BUILDFLAG(IS_APPLE) && !BUILDFLAG(IS_WIN) && !BUILDFLAG(IS_FUCHSIA)
+TEST_F(CrashReportDatabaseTest, RebuildCorruptIndex) {
+  CrashReportDatabase::Report pending;
+  ASSERT_NO_FATAL_FAILURE(CreateCrashReport(&pending));
+  CrashReportDatabase::Report completed;
+  ASSERT_NO_FATAL_FAILURE(CreateCrashReport(&completed));
+  ASSERT_NO_FATAL_FAILURE(UploadReport(completed.uuid, true, "server_id"));
+
+  auto expect_reports = [this, &pending, &completed]() {
+    std::vector<CrashReportDatabase::Report> reports;
+    EXPECT_EQ(db()->GetPendingReports(&reports),
+              CrashReportDatabase::kNoError);
+    ASSERT_EQ(reports.size(), 1u);
+    EXPECT_EQ(reports[0].uuid, pending.uuid);
+    EXPECT_EQ(reports[0].file_path, pending.file_path);
+    EXPECT_EQ(reports[0].upload_attempts, 0);
+
+    reports.clear();
+    EXPECT_EQ(db()->GetCompletedReports(&reports),
+              CrashReportDatabase::kNoError);
+    ASSERT_EQ(reports.size(), 1u);
+    EXPECT_EQ(reports[0].uuid, completed.uuid);
+    EXPECT_EQ(reports[0].id, "server_id");
+    EXPECT_TRUE(reports[0].uploaded);
+    EXPECT_EQ(reports[0].upload_attempts, 1);
+    EXPECT_EQ(reports[0].total_size, completed.total_size);
+  };
+  ASSERT_NO_FATAL_FAILURE(expect_reports());
+
+  const base::FilePath index_path(
+      path().Append(FILE_PATH_LITERAL("index.dat")));
+  auto rewrite_index = [this, &index_path](const std::string& contents) {
+    ScopedFileHandle handle(
+        LoggingOpenFileForWrite(index_path,
+                                FileWriteMode::kTruncateOrCreate,
+                                FilePermissions::kOwnerOnly));
+    ASSERT_TRUE(handle.is_valid());
+    ASSERT_TRUE(
+        LoggingWriteFile(handle.get(), contents.data(), contents.size()));
+
+    // Reopen the database so that it reads the whole index, rather than only
+    // what was appended since it last read it.
+    ResetDatabase();
+    SetUp();
+  };
+
+  // A record that fails its checksum causes the index to be rebuilt.
+  std::string contents;
+  ASSERT_TRUE(LoggingReadEntireFile(index_path, &contents));
+  ASSERT_FALSE(contents.empty());
+  contents.back() ^= 0xff;
+  ASSERT_NO_FATAL_FAILURE(rewrite_index(contents));
+  ASSERT_NO_FATAL_FAILURE(expect_reports());
+
+  // So does a truncated record.
+  ASSERT_TRUE(LoggingReadEntireFile(index_path, &contents));
+  contents.resize(contents.size() - 1);
+  ASSERT_NO_FATAL_FAILURE(rewrite_index(contents));
+  ASSERT_NO_FATAL_FAILURE(expect_reports());
+
+  // So does a missing index.
+  ASSERT_TRUE(LoggingRemoveFile(index_path));
+  ASSERT_NO_FATAL_FAILURE(expect_reports());
+}
+
+TEST_F(CrashReportDatabaseTest, IndexUpdatedByAnotherDatabase) {
+  CrashReportDatabase::Report first;
+  ASSERT_NO_FATAL_FAILURE(CreateCrashReport(&first));
+
+  std::vector<CrashReportDatabase::Report> reports;
+  EXPECT_EQ(db()->GetPendingReports(&reports), CrashReportDatabase::kNoError);
+  EXPECT_EQ(reports.size(), 1u);
+
+  // Reports added and removed through another database object are seen by the
+  // reads that follow, whether they were appended to the index or the index
+  // was rewritten.
+  std::unique_ptr<CrashReportDatabase> other =
+      CrashReportDatabase::Initialize(path());
+  ASSERT_TRUE(other);
+  std::unique_ptr<CrashReportDatabase::NewReport> new_report;
+  ASSERT_EQ(other->PrepareNewCrashReport(&new_report),
+            CrashReportDatabase::kNoError);
+  UUID second_uuid;
+  ASSERT_EQ(other->FinishedWritingCrashReport(std::move(new_report),
+                                              &second_uuid),
+            CrashReportDatabase::kNoError);
+
+  reports.clear();
+  EXPECT_EQ(db()->GetPendingReports(&reports), CrashReportDatabase::kNoError);
+  EXPECT_EQ(reports.size(), 2u);
+
+  EXPECT_EQ(other->DeleteReport(first.uuid), CrashReportDatabase::kNoError);
+  other->CleanDatabase(60 * 60 * 24 * 3);
+
+  reports.clear();
+  EXPECT_EQ(db()->GetPendingReports(&reports), CrashReportDatabase::kNoError);
+  ASSERT_EQ(reports.size(), 1u);
+  EXPECT_EQ(reports[0].uuid, second_uuid);
+}
+
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+TEST_F(CrashReportDatabaseTest, PendingReportsChangePath) {
+  CrashReportDatabase::Report first;
+  ASSERT_NO_FATAL_FAILURE(CreateCrashReport(&first));
+
+  std::vector<CrashReportDatabase::Report> reports;
+  EXPECT_EQ(db()->GetPendingReports(&reports), CrashReportDatabase::kNoError);
+  EXPECT_EQ(reports.size(), 1u);
+
+  const base::FilePath change_path = db()->PendingReportsChangePath();
+  ASSERT_FALSE(change_path.empty());
+  DirectoryWatcher watcher;
+  ASSERT_TRUE(watcher.Initialize(change_path.DirName()));
+
+  // A report made pending by another database object is announced by a change
+  // to the file, after which it can be checked out for upload.
+  std::unique_ptr<CrashReportDatabase> other =
+      CrashReportDatabase::Initialize(path());
+  ASSERT_TRUE(other);
+  std::unique_ptr<CrashReportDatabase::NewReport> new_report;
+  ASSERT_EQ(other->PrepareNewCrashReport(&new_report),
+            CrashReportDatabase::kNoError);
+  UUID second_uuid;
+  ASSERT_EQ(other->FinishedWritingCrashReport(std::move(new_report),
+                                              &second_uuid),
+            CrashReportDatabase::kNoError);
+
+  std::vector<base::FilePath> names;
+  ASSERT_TRUE(watcher.WaitForChanges(&names));
+  EXPECT_NE(std::find(names.begin(), names.end(), change_path.BaseName()),
+            names.end());
+
+  reports.clear();
+  EXPECT_EQ(db()->GetPendingReports(&reports), CrashReportDatabase::kNoError);
+  EXPECT_EQ(reports.size(), 2u);
+
+  std::unique_ptr<const CrashReportDatabase::UploadReport> upload_report;
+  EXPECT_EQ(db()->GetReportForUploading(second_uuid, &upload_report),
+            CrashReportDatabase::kNoError);
+}
+
+TEST_F(CrashReportDatabaseTest, CompactMetadata) {
+  // An existing database keeps the mode it was created with.
+  const base::FilePath legacy_path(path());
+  ASSERT_TRUE(CrashReportDatabase::InitializeWithCompactMetadata(legacy_path));
+  EXPECT_FALSE(PathExists(legacy_path.Append(FILE_PATH_LITERAL("locks.dat"))));
+
+  UseCompactMetadata();
+  EXPECT_TRUE(FileExists(path().Append(FILE_PATH_LITERAL("locks.dat"))));
+
+  CrashReportDatabase::Report pending;
+  ASSERT_NO_FATAL_FAILURE(CreateCrashReport(&pending));
+  CrashReportDatabase::Report completed;
+  ASSERT_NO_FATAL_FAILURE(CreateCrashReport(&completed));
+  ASSERT_NO_FATAL_FAILURE(UploadReport(completed.uuid, true, "server_id"));
+  CrashReportDatabase::Report deleted;
+  ASSERT_NO_FATAL_FAILURE(CreateCrashReport(&deleted));
+  EXPECT_EQ(db()->DeleteReport(deleted.uuid), CrashReportDatabase::kNoError);
+
+  // Reports are kept without metadata files, and are locked without lock
+  // files.
+  std::unique_ptr<const CrashReportDatabase::UploadReport> upload_report;
+  ASSERT_EQ(db()->GetReportForUploading(pending.uuid, &upload_report),
+            CrashReportDatabase::kNoError);
+  const std::string pending_base(
+      upload_report->file_path.RemoveFinalExtension().value());
+  EXPECT_FALSE(PathExists(base::FilePath(pending_base + ".meta")));
+  EXPECT_FALSE(PathExists(base::FilePath(pending_base + ".lock")));
+
+  CrashReportDatabase::Report report;
+  ASSERT_EQ(db()->LookUpCrashReport(completed.uuid, &report),
+            CrashReportDatabase::kNoError);
+  EXPECT_FALSE(PathExists(
+      base::FilePath(report.file_path.RemoveFinalExtension().value() +
+                     ".meta")));
+
+  // A report checked out through one database object is busy to another,
+  // which can still use the database’s other reports. The metadata is kept
+  // when the database is reopened.
+  std::unique_ptr<CrashReportDatabase> other =
+      CrashReportDatabase::Initialize(path());
+  ASSERT_TRUE(other);
+  std::unique_ptr<const CrashReportDatabase::UploadReport> other_upload_report;
+  EXPECT_EQ(other->GetReportForUploading(pending.uuid, &other_upload_report),
+            CrashReportDatabase::kBusyError);
+
+  ASSERT_EQ(other->LookUpCrashReport(completed.uuid, &report),
+            CrashReportDatabase::kNoError);
+  EXPECT_EQ(report.file_path.DirName().BaseName().value(), "completed");
+  EXPECT_TRUE(report.uploaded);
+  EXPECT_EQ(report.id, "server_id");
+  EXPECT_EQ(report.upload_attempts, 1);
+  EXPECT_GT(report.last_upload_attempt_time, 0);
+  EXPECT_EQ(report.creation_time, completed.creation_time);
+  EXPECT_EQ(report.total_size, completed.total_size);
+  EXPECT_EQ(other->LookUpCrashReport(deleted.uuid, &report),
+            CrashReportDatabase::kReportNotFound);
+
+  upload_report.reset();
+  EXPECT_EQ(other->RequestUpload(pending.uuid), CrashReportDatabase::kNoError);
+  ASSERT_EQ(db()->LookUpCrashReport(pending.uuid, &report),
+            CrashReportDatabase::kNoError);
+  EXPECT_TRUE(report.upload_explicitly_requested);
+  EXPECT_EQ(report.creation_time, pending.creation_time);
+
+  std::vector<CrashReportDatabase::Report> reports;
+  EXPECT_EQ(other->GetPendingReports(&reports), CrashReportDatabase::kNoError);
+  ASSERT_EQ(reports.size(), 1u);
+  EXPECT_EQ(reports[0].uuid, pending.uuid);
+  EXPECT_TRUE(reports[0].upload_explicitly_requested);
+
+  // Cleaning keeps reports, which have no metadata files.
+  EXPECT_EQ(other->CleanDatabase(0), 0);
+  reports.clear();
+  EXPECT_EQ(db()->GetCompletedReports(&reports), CrashReportDatabase::kNoError);
+  ASSERT_EQ(reports.size(), 1u);
+  EXPECT_EQ(reports[0].uuid, completed.uuid);
+  EXPECT_EQ(reports[0].id, "server_id");
+}
+
+TEST_F(CrashReportDatabaseTest, CompactMetadataCorruptIndex) {
+  UseCompactMetadata();
+
+  CrashReportDatabase::Report completed;
+  ASSERT_NO_FATAL_FAILURE(CreateCrashReport(&completed));
+  ASSERT_NO_FATAL_FAILURE(UploadReport(completed.uuid, true, "server_id"));
+  CrashReportDatabase::Report last;
+  ASSERT_NO_FATAL_FAILURE(CreateCrashReport(&last));
+
+  const base::FilePath index_path(
+      path().Append(FILE_PATH_LITERAL("index.dat")));
+  std::string contents;
+  ASSERT_TRUE(LoggingReadEntireFile(index_path, &contents));
+  ASSERT_FALSE(contents.empty());
+  contents.back() ^= 0xff;
+  {
+    ScopedFileHandle handle(
+        LoggingOpenFileForWrite(index_path,
+                                FileWriteMode::kTruncateOrCreate,
+                                FilePermissions::kOwnerOnly));
+    ASSERT_TRUE(handle.is_valid());
+    ASSERT_TRUE(
+        LoggingWriteFile(handle.get(), contents.data(), contents.size()));
+  }
+  ResetDatabase();
+  SetUp();
+
+  // The index is the only record of the reports’ metadata, so what was read
+  // before the corrupt record is kept. The report whose record was lost is
+  // still listed, with what can be found from its file.
+  std::vector<CrashReportDatabase::Report> reports;
+  EXPECT_EQ(db()->GetCompletedReports(&reports), CrashReportDatabase::kNoError);
+  ASSERT_EQ(reports.size(), 1u);
+  EXPECT_EQ(reports[0].uuid, completed.uuid);
+  EXPECT_EQ(reports[0].id, "server_id");
+  EXPECT_EQ(reports[0].upload_attempts, 1);
+
+  reports.clear();
+  EXPECT_EQ(db()->GetPendingReports(&reports), CrashReportDatabase::kNoError);
+  ASSERT_EQ(reports.size(), 1u);
+  EXPECT_EQ(reports[0].uuid, last.uuid);
+  EXPECT_GT(reports[0].creation_time, 0);
+  EXPECT_EQ(reports[0].total_size, last.total_size);
+
+  // Without an index, every report is still listed in its state.
+  ASSERT_TRUE(LoggingRemoveFile(index_path));
+  reports.clear();
+  EXPECT_EQ(db()->GetCompletedReports(&reports), CrashReportDatabase::kNoError);
+  ASSERT_EQ(reports.size(), 1u);
+  EXPECT_EQ(reports[0].uuid, completed.uuid);
+
+  std::unique_ptr<const CrashReportDatabase::UploadReport> upload_report;
+  EXPECT_EQ(db()->GetReportForUploading(last.uuid, &upload_report),
+            CrashReportDatabase::kNoError);
+}
+
+// Returns the name of the directory that a report at path is in, and of the
+// directory that that is in.
+std::pair<std::string, std::string> ReportDirectories(
+    const base::FilePath& path) {
+  return std::make_pair(path.DirName().DirName().BaseName().value(),
+                        path.DirName().BaseName().value());
+}
+
+TEST_F(CrashReportDatabaseTest, ShardedReports) {
+  CrashReportDatabase::Report pending;
+  ASSERT_NO_FATAL_FAILURE(CreateCrashReport(&pending));
+  CrashReportDatabase::Report completed;
+  ASSERT_NO_FATAL_FAILURE(CreateCrashReport(&completed));
+  ASSERT_NO_FATAL_FAILURE(UploadReport(completed.uuid, true, "server_id"));
+  ASSERT_EQ(ReportDirectories(pending.file_path).second, "pending");
+
+  // An existing database’s reports are moved into shards named for the start
+  // of their UUIDs, along with their metadata.
+  ASSERT_NO_FATAL_FAILURE(UseShardedReports());
+  EXPECT_FALSE(PathExists(pending.file_path));
+  const std::string pending_shard(pending.uuid.ToString().substr(0, 2));
+  const std::string completed_shard(completed.uuid.ToString().substr(0, 2));
+
+  CrashReportDatabase::Report report;
+  ASSERT_EQ(db()->LookUpCrashReport(pending.uuid, &report),
+            CrashReportDatabase::kNoError);
+  EXPECT_EQ(ReportDirectories(report.file_path),
+            std::make_pair(std::string("pending"), pending_shard));
+  EXPECT_EQ(report.creation_time, pending.creation_time);
+  ASSERT_EQ(db()->LookUpCrashReport(completed.uuid, &report),
+            CrashReportDatabase::kNoError);
+  EXPECT_EQ(ReportDirectories(report.file_path),
+            std::make_pair(std::string("completed"), completed_shard));
+  EXPECT_TRUE(report.uploaded);
+  EXPECT_EQ(report.id, "server_id");
+
+  // The database keeps its reports in shards when opened by any method.
+  ResetDatabase();
+  SetUp();
+  CrashReportDatabase::Report created;
+  ASSERT_NO_FATAL_FAILURE(CreateCrashReport(&created));
+  EXPECT_EQ(ReportDirectories(created.file_path).second,
+            created.uuid.ToString().substr(0, 2));
+  ASSERT_NO_FATAL_FAILURE(UploadReport(pending.uuid, true, "other_id"));
+  ASSERT_EQ(db()->LookUpCrashReport(pending.uuid, &report),
+            CrashReportDatabase::kNoError);
+  EXPECT_EQ(ReportDirectories(report.file_path),
+            std::make_pair(std::string("completed"), pending_shard));
+
+  // A report added outside of shards, as by a version that predates them, is
+  // found there until the database is cleaned, which moves it into its shard.
+  const base::FilePath unsharded_path(
+      path()
+          .Append(FILE_PATH_LITERAL("pending"))
+          .Append(created.file_path.BaseName()));
+  ASSERT_TRUE(MoveFileOrDirectory(created.file_path, unsharded_path));
+  ASSERT_TRUE(MoveFileOrDirectory(
+      base::FilePath(created.file_path.RemoveFinalExtension().value() +
+                     ".meta"),
+      base::FilePath(unsharded_path.RemoveFinalExtension().value() +
+                     ".meta")));
+  ASSERT_EQ(db()->LookUpCrashReport(created.uuid, &report),
+            CrashReportDatabase::kNoError);
+  EXPECT_EQ(report.file_path, unsharded_path);
+
+  EXPECT_EQ(db()->CleanDatabase(0), 0);
+  EXPECT_FALSE(PathExists(unsharded_path));
+  std::vector<CrashReportDatabase::Report> reports;
+  EXPECT_EQ(db()->GetPendingReports(&reports), CrashReportDatabase::kNoError);
+  ASSERT_EQ(reports.size(), 1u);
+  EXPECT_EQ(reports[0].uuid, created.uuid);
+  EXPECT_EQ(reports[0].file_path, created.file_path);
+  EXPECT_TRUE(FileExists(reports[0].file_path));
+
+  reports.clear();
+  EXPECT_EQ(db()->GetCompletedReports(&reports), CrashReportDatabase::kNoError);
+  EXPECT_EQ(reports.size(), 2u);
+
+  EXPECT_EQ(db()->DeleteReport(created.uuid), CrashReportDatabase::kNoError);
+  EXPECT_EQ(db()->LookUpCrashReport(created.uuid, &report),
+            CrashReportDatabase::kReportNotFound);
+}
+
+TEST_F(CrashReportDatabaseTest, ShardedReportsWithCompactMetadata) {
+  UseCompactMetadata();
+
+  CrashReportDatabase::Report pending;
+  ASSERT_NO_FATAL_FAILURE(CreateCrashReport(&pending));
+  ASSERT_NO_FATAL_FAILURE(UseShardedReports());
+  EXPECT_FALSE(PathExists(pending.file_path));
+
+  // The reports’ metadata is kept in the index as they move into shards.
+  CrashReportDatabase::Report report;
+  ASSERT_EQ(db()->LookUpCrashReport(pending.uuid, &report),
+            CrashReportDatabase::kNoError);
+  EXPECT_EQ(ReportDirectories(report.file_path).second,
+            pending.uuid.ToString().substr(0, 2));
+  EXPECT_EQ(report.creation_time, pending.creation_time);
+  EXPECT_FALSE(PathExists(
+      base::FilePath(report.file_path.RemoveFinalExtension().value() +
+                     ".meta")));
+
+  ASSERT_NO_FATAL_FAILURE(UploadReport(pending.uuid, true, "server_id"));
+  std::vector<CrashReportDatabase::Report> reports;
+  EXPECT_EQ(db()->GetCompletedReports(&reports), CrashReportDatabase::kNoError);
+  ASSERT_EQ(reports.size(), 1u);
+  EXPECT_EQ(ReportDirectories(reports[0].file_path).first, "completed");
+  EXPECT_EQ(reports[0].id, "server_id");
+}
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+#endif  // !BUILDFLAG(IS_APPLE) && !BUILDFLAG(IS_WIN) && !BUILDFLAG(IS_FUCHSIA)
+
+TEST_F(CrashReportDatabaseTest, GroupCommit) {
+  db()->EnableGroupCommit(0.01);
+
+  std::unique_ptr<CrashReportDatabase::NewReport> new_report;
+  ASSERT_EQ(db()->PrepareNewCrashReport(&new_report),
+            CrashReportDatabase::kNoError);
+  static constexpr char kReportData[] = "report";
+  ASSERT_TRUE(new_report->Writer()->Write(kReportData, sizeof(kReportData)));
+  FileWriter* attachment = new_report->AddAttachment("attachment");
+  ASSERT_NE(attachment, nullptr);
+  static constexpr char kAttachmentData[] = "attachment";
+  ASSERT_TRUE(attachment->Write(kAttachmentData, sizeof(kAttachmentData)));
+
+  UUID uuid;
+  ASSERT_EQ(db()->FinishedWritingCrashReport(std::move(new_report), &uuid),
+            CrashReportDatabase::kNoError);
+
+  CrashReportDatabase::Report report;
+  ASSERT_EQ(db()->LookUpCrashReport(uuid, &report),
+            CrashReportDatabase::kNoError);
+  EXPECT_EQ(report.total_size, sizeof(kReportData) + sizeof(kAttachmentData));
+
+  CrashReportDatabase::Report other_report;
+  ASSERT_NO_FATAL_FAILURE(CreateCrashReport(&other_report));
+  std::vector<CrashReportDatabase::Report> reports;
+  EXPECT_EQ(db()->GetPendingReports(&reports), CrashReportDatabase::kNoError);
+  EXPECT_EQ(reports.size(), 2u);
+}
+
+TEST_F(CrashReportDatabaseTest, GetStatistics) {
+  CrashReportDatabase::Statistics statistics;
+  ASSERT_EQ(db()->GetStatistics(&statistics), CrashReportDatabase::kNoError);
+  EXPECT_EQ(statistics.pending_reports, 0u);
+  EXPECT_EQ(statistics.completed_reports, 0u);
+  EXPECT_EQ(statistics.total_size, 0u);
+
+  std::vector<CrashReportDatabase::Report> created(4);
+  for (CrashReportDatabase::Report& report : created) {
+    ASSERT_NO_FATAL_FAILURE(CreateCrashReport(&report));
+  }
+  UploadReport(created[0].uuid, true, "1");
+  EXPECT_EQ(db()->DeleteReport(created[1].uuid), CrashReportDatabase::kNoError);
+
+  std::vector<CrashReportDatabase::Report> pending;
+  ASSERT_EQ(db()->GetPendingReports(&pending), CrashReportDatabase::kNoError);
+  std::vector<CrashReportDatabase::Report> completed;
+  ASSERT_EQ(db()->GetCompletedReports(&completed),
+            CrashReportDatabase::kNoError);
+  uint64_t total_size = 0;
+  for (const CrashReportDatabase::Report& report : pending) {
+    total_size += report.total_size;
+  }
+  for (const CrashReportDatabase::Report& report : completed) {
+    total_size += report.total_size;
+  }
+
+  ASSERT_EQ(db()->GetStatistics(&statistics), CrashReportDatabase::kNoError);
+  EXPECT_EQ(statistics.pending_reports, 2u);
+  EXPECT_EQ(statistics.pending_reports, pending.size());
+  EXPECT_EQ(statistics.completed_reports, 1u);
+  EXPECT_EQ(statistics.completed_reports, completed.size());
+  EXPECT_EQ(statistics.total_size, total_size);
+  EXPECT_GT(statistics.total_size, 0u);
+}
+
+TEST_F(CrashReportDatabaseTest, ManyChangesPersist) {
+  // Enough changes are made for the Windows metadata journal to be compacted
+  // at least once, as well as to be appended to.
+  std::vector<CrashReportDatabase::Report> reports(80);
+  for (CrashReportDatabase::Report& report : reports) {
+    ASSERT_NO_FATAL_FAILURE(CreateCrashReport(&report));
+  }
+  for (size_t index = 0; index < reports.size(); index += 2) {
+    UploadReport(reports[index].uuid, true, std::to_string(index));
+  }
+  for (size_t index = 0; index < reports.size(); index += 5) {
+    EXPECT_EQ(db()->DeleteReport(reports[index].uuid),
+              CrashReportDatabase::kNoError);
+  }
+
+  RelocateDatabase();
+
+  for (size_t index = 0; index < reports.size(); ++index) {
+    CrashReportDatabase::Report report;
+    if (index % 5 == 0) {
+      EXPECT_EQ(db()->LookUpCrashReport(reports[index].uuid, &report),
+                CrashReportDatabase::kReportNotFound);
+    } else if (index % 2 == 0) {
+      ASSERT_EQ(db()->LookUpCrashReport(reports[index].uuid, &report),
+                CrashReportDatabase::kNoError);
+      EXPECT_TRUE(report.uploaded);
+      EXPECT_EQ(report.id, std::to_string(index));
+      EXPECT_EQ(report.upload_attempts, 1);
+    } else {
+      ASSERT_EQ(db()->LookUpCrashReport(reports[index].uuid, &report),
+                CrashReportDatabase::kNoError);
+      EXPECT_FALSE(report.uploaded);
+    }
+  }
+
+  std::vector<CrashReportDatabase::Report> pending;
+  EXPECT_EQ(db()->GetPendingReports(&pending), CrashReportDatabase::kNoError);
+  EXPECT_EQ(pending.size(), 32u);
+  std::vector<CrashReportDatabase::Report> completed;
+  EXPECT_EQ(db()->GetCompletedReports(&completed),
+            CrashReportDatabase::kNoError);
+  EXPECT_EQ(completed.size(), 32u);
+}
+
+TEST_F(CrashReportDatabaseTest, GetOldestReports) {
+  std::vector<CrashReportDatabase::Report> created(3);
+  for (CrashReportDatabase::Report& report : created) {
+    ASSERT_NO_FATAL_FAILURE(CreateCrashReport(&report));
+  }
+  ASSERT_NO_FATAL_FAILURE(UploadReport(created[1].uuid, true, "server_id"));
+
+  const uint64_t total_size = created[0].total_size + created[1].total_size +
+                              created[2].total_size;
+  std::vector<CrashReportDatabase::Report> reports;
+  uint64_t size;
+  ASSERT_EQ(db()->GetOldestReports(10, &reports, &size),
+            CrashReportDatabase::kNoError);
+  EXPECT_EQ(size, total_size);
+  ASSERT_EQ(reports.size(), 3u);
+  for (size_t index = 1; index < reports.size(); ++index) {
+    EXPECT_LE(reports[index - 1].creation_time, reports[index].creation_time);
+  }
+
+  // The size covers all reports, even those not returned.
+  reports.clear();
+  ASSERT_EQ(db()->GetOldestReports(1, &reports, &size),
+            CrashReportDatabase::kNoError);
+  EXPECT_EQ(size, total_size);
+  ASSERT_EQ(reports.size(), 1u);
+  const UUID oldest_uuid = reports[0].uuid;
+
+  EXPECT_EQ(db()->DeleteReport(oldest_uuid), CrashReportDatabase::kNoError);
+  reports.clear();
+  ASSERT_EQ(db()->GetOldestReports(10, &reports, &size),
+            CrashReportDatabase::kNoError);
+  ASSERT_EQ(reports.size(), 2u);
+  uint64_t remaining_size = 0;
+  for (const CrashReportDatabase::Report& report : reports) {
+    EXPECT_NE(report.uuid, oldest_uuid);
+    remaining_size += report.total_size;
+  }
+  EXPECT_EQ(size, remaining_size);
+}
+
 TEST_F(CrashReportDatabaseTest, TotalSize_MainReportOnly) {
   std::unique_ptr<CrashReportDatabase::NewReport> new_report;
   ASSERT_EQ(db()->PrepareNewCrashReport(&new_report),
@@ -21,7 +21,10 @@
 #include <time.h>
 #include <wchar.h>
 
+#include <algorithm>
+#include <map>
 #include <mutex>
+#include <set>
 #include <tuple>
 #include <utility>
 
@@ -47,7 +50,17 @@ constexpr wchar_t kSettings[] = L"settings.dat";
 constexpr wchar_t kCrashReportFileExtension[] = L"dmp";
 
 constexpr uint32_t kMetadataFileHeaderMagic = 'CPAD';
-constexpr uint32_t kMetadataFileVersion = 1;
+constexpr uint32_t kMetadataFileVersion = 2;
+
+// Version 1 metadata files have no journal, and their string table extends to
+// the end of the file. They are still read, and are rewritten as the current
+// version when they are next changed.
+constexpr uint32_t kMetadataFileVersionWithoutJournal = 1;
+
+// The number of journal entries that the metadata file may hold, regardless of
+// how many reports it holds, before it is compacted by being rewritten in full.
+// Beyond this, it may hold as many journal entries as reports.
+constexpr size_t kMinJournalEntriesBeforeCompaction = 64;
 
 using OperationStatus = CrashReportDatabase::OperationStatus;
 
@@ -93,11 +106,35 @@ bool UUIDFromReportPath(const base::FilePath& path, UUID* uuid) {
 // The format of the on disk metadata file is a MetadataFileHeader, followed by
 // a number of fixed size records of MetadataFileReportRecord, followed by a
 // string table in UTF8 format, where each string is \0 terminated.
+//
+// The string table is followed by a journal of the changes made to reports
+// since the file was last written in full, so that a change doesn’t require
+// the whole file to be rewritten. Each journal entry is a
+// MetadataJournalEntryHeader followed by |size| bytes. For
+// kJournalEntryReport, these are a MetadataFileReportRecord followed by a
+// string table of the entry’s own, which the record’s indices refer to. For
+// kJournalEntryDelete, they are the UUID of a report that was removed. Later
+// entries take precedence over earlier ones and over the records. A partial
+// entry at the end of the file, left by an interrupted write, is ignored, and
+// is overwritten by the next entries appended.
 struct MetadataFileHeader {
   uint32_t magic;
   uint32_t version;
   uint32_t num_records;
-  uint32_t padding;
+  uint32_t string_table_size;  // 0 in version 1 files.
+};
+
+enum : uint32_t {
+  //! \brief A journal entry that adds or replaces a report.
+  kJournalEntryReport = 1,
+
+  //! \brief A journal entry that removes a report.
+  kJournalEntryDelete = 2,
+};
+
+struct MetadataJournalEntryHeader {
+  uint32_t type;  // A kJournalEntry* value.
+  uint32_t size;  // The number of bytes that follow this header.
 };
 
 struct ReportDisk;
@@ -235,6 +272,15 @@ class Metadata {
       ReportState desired_state,
       std::vector<CrashReportDatabase::Report>* reports) const;
 
+  //! \brief Counts the reports in the pending and completed states, and sums
+  //!     their sizes.
+  //!
+  //! Unlike FindReports(), this does not verify that each report file exists,
+  //! so it does not need to access any report files.
+  //!
+  //! \param[out] statistics The statistics.
+  void GetStatistics(CrashReportDatabase::Statistics* statistics) const;
+
   //! \brief Finds the report matching the given UUID.
   //!
   //! The returned report is only valid if CrashReportDatabase::kNoError is
@@ -288,8 +334,34 @@ class Metadata {
   bool Rewind();
 
   void Read();
+
+  //! \brief Reads the journal that follows the string table, applying its
+  //!     entries to \a reports, and sets journal_end_ and journal_entries_.
+  void ReadJournal(std::vector<ReportDisk>* reports);
+
+  //! \brief Writes the changes made since Read(), by appending them to the
+  //!     journal, or by rewriting the whole file if it is to be compacted.
   void Write();
 
+  //! \brief Appends an entry for each report in changed_uuids_ to the journal.
+  void AppendToJournal();
+
+  //! \brief Writes the whole file, without a journal.
+  void WriteAll();
+
+  //! \brief Records that the report identified by \a uuid was added, changed,
+  //!     or removed, so that Write() will write it.
+  void MarkDirty(const UUID& uuid);
+
+  //! \brief Sets the total size of a report read from disk, from its file and
+  //!     its attachments.
+  void SetTotalSize(ReportDisk* report_disk) const;
+
+  //! \brief Confirms that a record’s string table indices are within
+  //!     \a string_table.
+  static bool RecordStringsValid(const MetadataFileReportRecord& record,
+                                 const std::string& string_table);
+
   //! \brief Confirms that the corresponding report actually exists on disk
   //!     (that is, the dump file has not been removed), and that the report is
   //!     in the given state.
@@ -304,6 +376,18 @@ class Metadata {
   const base::FilePath attachments_dir_;
   bool dirty_;  //! \brief `true` when a Write() is required on destruction.
   std::vector<ReportDisk> reports_;
+
+  // The reports added, changed, or removed since Read().
+  std::set<UUID> changed_uuids_;
+
+  // The offset of the end of the valid data read from the file, where journal
+  // entries are appended, and the number of journal entries read.
+  FileOffset journal_end_;
+  size_t journal_entries_;
+
+  // `true` when Write() must rewrite the whole file, because it couldn’t be
+  // read or is in an older format.
+  bool rewrite_;
 };
 
 Metadata::~Metadata() {
@@ -357,7 +441,7 @@ std::unique_ptr<Metadata> Metadata::Create(
 void Metadata::AddNewRecord(const ReportDisk& new_report_disk) {
   DCHECK(new_report_disk.state == ReportState::kPending);
   reports_.push_back(new_report_disk);
-  dirty_ = true;
+  MarkDirty(new_report_disk.uuid);
 }
 
 OperationStatus Metadata::FindReports(
@@ -373,6 +457,21 @@ OperationStatus Metadata::FindReports(
   return CrashReportDatabase::kNoError;
 }
 
+void Metadata::GetStatistics(
+    CrashReportDatabase::Statistics* statistics) const {
+  *statistics = CrashReportDatabase::Statistics();
+  for (const auto& report : reports_) {
+    if (report.state == ReportState::kPending) {
+      ++statistics->pending_reports;
+    } else if (report.state == ReportState::kCompleted) {
+      ++statistics->completed_reports;
+    } else {
+      continue;
+    }
+    statistics->total_size += report.total_size;
+  }
+}
+
 OperationStatus Metadata::FindSingleReport(
     const UUID& uuid,
     const ReportDisk** out_report) const {
@@ -400,7 +499,7 @@ OperationStatus Metadata::FindSingleReportAndMarkDirty(
     return CrashReportDatabase::kReportNotFound;
   OperationStatus os = VerifyReport(*report_iter, desired_state);
   if (os == CrashReportDatabase::kNoError) {
-    dirty_ = true;
+    MarkDirty(uuid);
     *report_disk = &*report_iter;
   }
   return os;
@@ -416,7 +515,7 @@ OperationStatus Metadata::DeleteReport(const UUID& uuid,
     return CrashReportDatabase::kReportNotFound;
   *report_path = report_iter->file_path;
   reports_.erase(report_iter);
-  dirty_ = true;
+  MarkDirty(uuid);
   return CrashReportDatabase::kNoError;
 }
 
@@ -424,9 +523,9 @@ int Metadata::CleanDatabase() {
   int removed = 0;
   for (auto report_iter = reports_.begin(); report_iter != reports_.end();) {
     if (!IsRegularFile(report_iter->file_path)) {
+      MarkDirty(report_iter->uuid);
       report_iter = reports_.erase(report_iter);
       ++removed;
-      dirty_ = true;
     } else {
       ++report_iter;
     }
@@ -441,7 +540,11 @@ Metadata::Metadata(FileHandle handle,
       report_dir_(report_dir),
       attachments_dir_(attachments_dir),
       dirty_(false),
-      reports_() {}
+      reports_(),
+      changed_uuids_(),
+      journal_end_(0),
+      journal_entries_(0),
+      rewrite_(true) {}
 
 bool Metadata::Rewind() {
   FileOffset result = LoggingSeekFile(handle_.get(), 0, SEEK_SET);
@@ -464,7 +567,8 @@ void Metadata::Read() {
     return;
   }
   if (header.magic != kMetadataFileHeaderMagic ||
-      header.version != kMetadataFileVersion) {
+      (header.version != kMetadataFileVersion &&
+       header.version != kMetadataFileVersionWithoutJournal)) {
     LOG(ERROR) << "unexpected header";
     return;
   }
@@ -486,57 +590,189 @@ void Metadata::Read() {
       return;
     }
 
-    std::string string_table = ReadRestOfFileAsString(handle_.get());
+    std::string string_table;
+    if (header.version == kMetadataFileVersionWithoutJournal) {
+      string_table = ReadRestOfFileAsString(handle_.get());
+    } else {
+      string_table.resize(header.string_table_size);
+      if (!string_table.empty() &&
+          !LoggingReadFileExactly(
+              handle_.get(), &string_table[0], string_table.size())) {
+        string_table.clear();
+      }
+    }
     if (string_table.empty() || string_table.back() != '\0') {
       LOG(ERROR) << "bad string table";
       return;
     }
 
     for (const auto& record : records) {
-      if (record.file_path_index >= string_table.size() ||
-          record.id_index >= string_table.size()) {
+      if (!RecordStringsValid(record, string_table)) {
         LOG(ERROR) << "invalid string table index";
         return;
       }
       ReportDisk report_disk(record, report_dir_, string_table);
-
-      report_disk.total_size = GetFileSize(report_disk.file_path);
-      base::FilePath report_attachment_dir =
-          attachments_dir_.Append(report_disk.uuid.ToWString());
-      report_disk.total_size += GetDirectorySize(report_attachment_dir);
+      SetTotalSize(&report_disk);
       reports.push_back(report_disk);
     }
+  } else if (header.version != kMetadataFileVersionWithoutJournal &&
+             header.string_table_size != 0) {
+    LOG(ERROR) << "bad string table";
+    return;
+  }
+
+  if (header.version == kMetadataFileVersion) {
+    ReadJournal(&reports);
+    rewrite_ = false;
   }
   reports_.swap(reports);
 }
 
+void Metadata::ReadJournal(std::vector<ReportDisk>* reports) {
+  journal_end_ = LoggingSeekFile(handle_.get(), 0, SEEK_CUR);
+  journal_entries_ = 0;
+  const std::string journal = ReadRestOfFileAsString(handle_.get());
+
+  std::map<UUID, size_t> report_indices;
+  for (size_t index = 0; index < reports->size(); ++index) {
+    report_indices[(*reports)[index].uuid] = index;
+  }
+  std::vector<bool> removed(reports->size(), false);
+
+  size_t offset = 0;
+  while (journal.size() - offset >= sizeof(MetadataJournalEntryHeader)) {
+    MetadataJournalEntryHeader entry_header;
+    memcpy(&entry_header, &journal[offset], sizeof(entry_header));
+    const size_t entry_start = offset + sizeof(entry_header);
+    if (entry_header.size > journal.size() - entry_start) {
+      break;
+    }
+    const std::string entry(journal, entry_start, entry_header.size);
+
+    if (entry_header.type == kJournalEntryReport) {
+      MetadataFileReportRecord record;
+      if (entry.size() <= sizeof(record)) {
+        break;
+      }
+      memcpy(&record, entry.data(), sizeof(record));
+      const std::string string_table = entry.substr(sizeof(record));
+      if (string_table.back() != '\0' ||
+          !RecordStringsValid(record, string_table)) {
+        break;
+      }
+
+      ReportDisk report_disk(record, report_dir_, string_table);
+      SetTotalSize(&report_disk);
+      const auto it = report_indices.find(report_disk.uuid);
+      if (it != report_indices.end()) {
+        (*reports)[it->second] = report_disk;
+      } else {
+        report_indices[report_disk.uuid] = reports->size();
+        reports->push_back(report_disk);
+        removed.push_back(false);
+      }
+    } else if (entry_header.type == kJournalEntryDelete) {
+      UUID uuid;
+      if (entry.size() != sizeof(uuid)) {
+        break;
+      }
+      memcpy(&uuid, entry.data(), sizeof(uuid));
+      const auto it = report_indices.find(uuid);
+      if (it != report_indices.end()) {
+        removed[it->second] = true;
+        report_indices.erase(it);
+      }
+    } else {
+      break;
+    }
+
+    offset = entry_start + entry_header.size;
+    ++journal_entries_;
+  }
+
+  if (offset != journal.size()) {
+    LOG(WARNING) << "discarding partial journal entry";
+  }
+  journal_end_ += offset;
+
+  size_t kept = 0;
+  for (size_t index = 0; index < reports->size(); ++index) {
+    if (!removed[index]) {
+      if (kept != index) {
+        (*reports)[kept] = (*reports)[index];
+      }
+      ++kept;
+    }
+  }
+  reports->erase(reports->begin() + kept, reports->end());
+}
+
 void Metadata::Write() {
-  if (!Rewind()) {
-    LOG(ERROR) << "failed to rewind to write";
+  if (rewrite_ ||
+      journal_entries_ + changed_uuids_.size() >
+          std::max(kMinJournalEntriesBeforeCompaction, reports_.size())) {
+    WriteAll();
+  } else {
+    AppendToJournal();
+  }
+}
+
+void Metadata::AppendToJournal() {
+  std::map<UUID, const ReportDisk*> reports_by_uuid;
+  for (const auto& report : reports_) {
+    reports_by_uuid[report.uuid] = &report;
+  }
+
+  // All of the entries are written at once, so that an interruption leaves at
+  // most a partial entry at the end of the file.
+  std::string journal;
+  for (const UUID& uuid : changed_uuids_) {
+    MetadataJournalEntryHeader entry_header;
+    std::string entry;
+    const auto it = reports_by_uuid.find(uuid);
+    if (it == reports_by_uuid.end()) {
+      entry_header.type = kJournalEntryDelete;
+      entry.assign(reinterpret_cast<const char*>(&uuid), sizeof(uuid));
+    } else {
+      const ReportDisk& report = *it->second;
+      if (report.file_path.DirName() != report_dir_) {
+        LOG(ERROR) << report.file_path.value().c_str()
+                   << " expected to start with "
+                   << base::WideToUTF8(report_dir_.value());
+        return;
+      }
+      std::string string_table;
+      MetadataFileReportRecord record(report, &string_table);
+      entry_header.type = kJournalEntryReport;
+      entry.assign(reinterpret_cast<const char*>(&record), sizeof(record));
+      entry += string_table;
+    }
+    entry_header.size = base::checked_cast<uint32_t>(entry.size());
+    journal.append(reinterpret_cast<const char*>(&entry_header),
+                   sizeof(entry_header));
+    journal += entry;
+  }
+
+  if (LoggingSeekFile(handle_.get(), journal_end_, SEEK_SET) != journal_end_) {
+    LOG(ERROR) << "failed to seek to journal end";
     return;
   }
 
-  // Truncate to ensure that a partial write doesn't cause a mix of old and new
-  // data causing an incorrect interpretation on read.
+  // Truncate to remove any partial entry left by an earlier interrupted write,
+  // which would otherwise hide the entries appended after it.
   if (!SetEndOfFile(handle_.get())) {
     PLOG(ERROR) << "failed to truncate";
     return;
   }
 
-  size_t num_records = reports_.size();
-
-  // Fill and write out the header.
-  MetadataFileHeader header = {0};
-  header.magic = kMetadataFileHeaderMagic;
-  header.version = kMetadataFileVersion;
-  header.num_records = base::checked_cast<uint32_t>(num_records);
-  if (!LoggingWriteFile(handle_.get(), &header, sizeof(header))) {
-    LOG(ERROR) << "failed to write header";
+  if (!LoggingWriteFile(handle_.get(), journal.data(), journal.size())) {
+    LOG(ERROR) << "failed to write journal";
     return;
   }
+}
 
-  if (num_records == 0)
-    return;
+void Metadata::WriteAll() {
+  size_t num_records = reports_.size();
 
   // Build the records and string table we're going to write.
   std::string string_table;
@@ -552,6 +788,32 @@ void Metadata::Write() {
     records.push_back(MetadataFileReportRecord(report, &string_table));
   }
 
+  if (!Rewind()) {
+    LOG(ERROR) << "failed to rewind to write";
+    return;
+  }
+
+  // Truncate to ensure that a partial write doesn't cause a mix of old and new
+  // data causing an incorrect interpretation on read.
+  if (!SetEndOfFile(handle_.get())) {
+    PLOG(ERROR) << "failed to truncate";
+    return;
+  }
+
+  // Fill and write out the header.
+  MetadataFileHeader header = {0};
+  header.magic = kMetadataFileHeaderMagic;
+  header.version = kMetadataFileVersion;
+  header.num_records = base::checked_cast<uint32_t>(num_records);
+  header.string_table_size = base::checked_cast<uint32_t>(string_table.size());
+  if (!LoggingWriteFile(handle_.get(), &header, sizeof(header))) {
+    LOG(ERROR) << "failed to write header";
+    return;
+  }
+
+  if (num_records == 0)
+    return;
+
   if (!LoggingWriteFile(handle_.get(),
                         &records[0],
                         records.size() * sizeof(MetadataFileReportRecord))) {
@@ -565,6 +827,25 @@ void Metadata::Write() {
   }
 }
 
+void Metadata::MarkDirty(const UUID& uuid) {
+  dirty_ = true;
+  changed_uuids_.insert(uuid);
+}
+
+void Metadata::SetTotalSize(ReportDisk* report_disk) const {
+  report_disk->total_size = GetFileSize(report_disk->file_path);
+  base::FilePath report_attachment_dir =
+      attachments_dir_.Append(report_disk->uuid.ToWString());
+  report_disk->total_size += GetDirectorySize(report_attachment_dir);
+}
+
+// static
+bool Metadata::RecordStringsValid(const MetadataFileReportRecord& record,
+                                  const std::string& string_table) {
+  return record.file_path_index < string_table.size() &&
+         record.id_index < string_table.size();
+}
+
 // static
 OperationStatus Metadata::VerifyReportAnyState(const ReportDisk& report_disk) {
   DWORD fileattr = GetFileAttributes(report_disk.file_path.value().c_str());
@@ -641,6 +922,7 @@ class CrashReportDatabaseWin : public CrashReportDatabase {
   OperationStatus LookUpCrashReport(const UUID& uuid, Report* report) override;
   OperationStatus GetPendingReports(std::vector<Report>* reports) override;
   OperationStatus GetCompletedReports(std::vector<Report>* reports) override;
+  OperationStatus GetStatistics(Statistics* statistics) override;
   OperationStatus GetReportForUploading(
       const UUID& uuid,
       std::unique_ptr<const UploadReport>* report,
@@ -796,6 +1078,16 @@ OperationStatus CrashReportDatabaseWin::GetCompletedReports(
                   : kDatabaseError;
 }
 
+OperationStatus CrashReportDatabaseWin::GetStatistics(Statistics* statistics) {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+
+  std::unique_ptr<Metadata> metadata(AcquireMetadata());
+  if (!metadata)
+    return kDatabaseError;
+  metadata->GetStatistics(statistics);
+  return kNoError;
+}
+
 OperationStatus CrashReportDatabaseWin::GetReportForUploading(
     const UUID& uuid,
     std::unique_ptr<const UploadReport>* report,
@@ -1002,6 +1294,7 @@ int CrashReportDatabaseWin::CleanDatabase(time_t lockfile_ttl) {
   removed += metadata->CleanDatabase();
 
   CleanOrphanedAttachments();
+  CleanSharedAttachments(lockfile_ttl);
   return removed;
 }
 
@@ -174,6 +174,19 @@ class CrashpadClient {
   //! \return `true` on success. Otherwise `false` with a message logged.
   static bool GetHandlerSocket(int* sock, pid_t* pid);
 
+  //! \brief Asks the handler to periodically sample the stacks of this
+  //!     process’ threads.
+  //!
+  //! The samples taken in the last moments before a crash or hang are added to
+  //! its report. This has no effect unless the handler was started with
+  //! `--stack-sample-interval`. Sampling stops when this process exits.
+  //!
+  //! `StartHandler()` must have successfully been called before calling this
+  //!     method.
+  //!
+  //! \return `true` on success. Otherwise `false` with a message logged.
+  static bool RequestStackSampling();
+
   //! \brief Sets the socket to a presumably-running Crashpad handler process
   //!      which was started with StartHandler().
   //!
@@ -186,6 +199,58 @@ class CrashpadClient {
   //!     process ID should be determined by communicating over the socket.
   bool SetHandlerSocket(ScopedFileHandle sock, pid_t pid);
 
+  //! \brief Connects to a running Crashpad handler process started with
+  //!     `--daemon`, which is shared with other clients.
+  //!
+  //! This lets many processes use one handler, instead of each starting a
+  //! handler of its own with StartHandler(). The handler is identified by the
+  //! credentials of the connection, and is set as this process' ptracer if
+  //! necessary. This method installs a signal handler to request crash dumps
+  //! on the connection, which children forked from this process share. If no
+  //! handler is listening, this method fails, and the caller may start a
+  //! handler with StartHandler() instead.
+  //!
+  //! Crash loop detection is not available with a shared handler.
+  //!
+  //! \param[in] socket_name The name the handler listens on in the abstract
+  //!     socket namespace, given by its `--daemon-socket-name` argument. If
+  //!     empty, the name used by `--daemon` is used.
+  //! \param[in] annotations Process annotations to set in each crash report
+  //!     for this process. These take precedence over annotations given to
+  //!     the handler with `--annotation`.
+  //! \return `true` on success. Otherwise `false` with a message logged.
+  bool SetHandlerDaemon(const std::string& socket_name,
+                        const std::map<std::string, std::string>& annotations);
+
+  //! \brief Requests crash dumps through memory shared with the handler
+  //!     instead of a message on the handler socket.
+  //!
+  //! The shared memory is registered with the handler by StartHandler() or
+  //! SetHandlerSocket(), which saves the handler a message and a credentials
+  //! check at crash time. If the handler doesn't accept the registration, crash
+  //! dumps are requested on the socket as usual. The handler must be recent
+  //! enough to understand the registration, or it will disconnect the socket.
+  //!
+  //! This method must be called prior to `StartHandler()` or
+  //! `SetHandlerSocket()`.
+  void EnableCrashSignalRegion();
+
+  //! \brief Launches a handler at crash time if the handler started by
+  //!     StartHandler() can’t be reached.
+  //!
+  //! If the handler process has exited, or its socket has been closed, a crash
+  //! dump request fails and the crash would otherwise be lost. With this
+  //! enabled, the signal handler instead launches a single-use handler to
+  //! snapshot this process, as StartHandlerAtCrash() does, with the arguments
+  //! given to StartHandler(). The fallback isn’t used if the handler received
+  //! the request but didn’t complete it in time, because it may still be
+  //! writing the dump.
+  //!
+  //! This method must be called prior to `StartHandler()`. It has no effect on
+  //! `SetHandlerSocket()` or `SetHandlerDaemon()`, which don’t know how to
+  //! launch a handler.
+  void EnableLaunchAtCrashFallback();
+
   //! \brief Uses `sigaltstack()` to allocate a signal stack for the calling
   //!     thread.
   //!
@@ -208,10 +273,42 @@ class CrashpadClient {
   //!
   //! \return `true` on success. Otherwise `false` with a message logged.
   static bool InitializeSignalStackForThread();
+
+  //! \brief Sets the number of signal stacks that are kept for reuse once
+  //!     their threads exit.
+  //!
+  //! Rather than being freed when its thread exits, a signal stack allocated
+  //! by InitializeSignalStackForThread() is kept, up to this many, and given to
+  //! the next thread that needs one. This spares a process that starts and
+  //! stops threads at a high rate from mapping and unmapping a signal stack for
+  //! each. Signal stacks already kept beyond a reduced capacity are freed. The
+  //! default capacity is 16.
+  //!
+  //! \param[in] capacity The number of signal stacks to keep. `0` frees each
+  //!     signal stack when its thread exits.
+  static void SetSignalStackPoolCapacity(size_t capacity);
 #endif  // BUILDFLAG(IS_ANDROID) || BUILDFLAG(IS_LINUX) ||
         // BUILDFLAG(IS_CHROMEOS) || DOXYGEN
 
 #if BUILDFLAG(IS_ANDROID) || DOXYGEN
+  //! \brief Starts the handler ahead of time, parked until it’s needed, rather
+  //!     than at crash time.
+  //!
+  //! StartJavaHandlerAtCrash() and StartHandlerWithLinkerAtCrash() normally
+  //! launch the handler once a crash occurs, leaving the crashing process to
+  //! wait while `app_process` or the linker bootstraps it. With this enabled,
+  //! those methods instead start the handler right away with
+  //! `--park-until-request`, connected to this process over a socket. The
+  //! parked handler waits for this process’ first request before opening the
+  //! database or starting any threads, and exits along with this process if
+  //! none comes. If the parked handler can’t be reached at crash time, a
+  //! handler is launched at crash time as it would have been without this.
+  //!
+  //! This method must be called prior to StartJavaHandlerAtCrash() or
+  //! StartHandlerWithLinkerAtCrash(). EnableCrashSignalRegion() has no effect
+  //! with a parked handler, because registering the region would wake it.
+  void EnablePrewarmedHandler();
+
   //! \brief Installs a signal handler to execute `/system/bin/app_process` and
   //!     load a Java class in response to a crash.
   //!
@@ -458,6 +555,28 @@ class CrashpadClient {
   //!     CaptureContext() or similar.
   static void DumpWithoutCrash(NativeCPUContext* context);
 
+  //! \brief Requests that the handler capture a dump of a forked copy of this
+  //!     process, without crashing and without stopping this process for the
+  //!     duration of the dump.
+  //!
+  //! This process is `fork()`ed, and the child requests the dump as
+  //! DumpWithoutCrash() would and then exits. The child’s memory is a
+  //! copy-on-write snapshot of this process’ memory at the time of the fork,
+  //! so the calling thread is only paused for as long as the fork takes. The
+  //! child contains only the calling thread, so the dump doesn’t include the
+  //! other threads of this process, and it identifies the child’s process ID
+  //! rather than this process’.
+  //!
+  //! A handler must have already been installed before calling this method.
+  //!
+  //! \param[in] context A NativeCPUContext, generally captured by
+  //!     CaptureContext() or similar.
+  //! \return The process ID of the child on success, which the caller must
+  //!     reap with `waitpid()` or similar. The child exits with `EXIT_SUCCESS`
+  //!     once the handler has finished with it. On failure, `-1`, with a
+  //!     message logged.
+  static pid_t DumpWithoutCrashInForkedChild(NativeCPUContext* context);
+
   //! \brief Disables any installed crash handler, not including any
   //!     FirstChanceHandler and crashes the current process.
   //!
@@ -543,6 +662,24 @@ class CrashpadClient {
   static void ProcessIntermediateDumps(
       const std::map<std::string, std::string>& annotations = {});
 
+  //! \brief Requests that the handler convert all intermediate dumps into
+  //!     minidumps on a low-priority background thread, and trigger an upload
+  //!     if possible.
+  //!
+  //! A handler must have already been installed before calling this method.
+  //! Unlike ProcessIntermediateDumps(), this method does not block, and may be
+  //! called on the main UI thread during application launch. Only a quick
+  //! check for intermediate dumps is made on the calling thread. Dumps are then
+  //! converted one at a time after a short delay, while the application is
+  //! active, until a time budget is spent. Any dumps that remain are converted
+  //! by a later call to this method or to ProcessIntermediateDumps().
+  //!
+  //! \param[in] annotations Process annotations to set in each crash report.
+  //!     Useful when adding crash annotations detected on the next run after a
+  //!     crash but before upload.
+  static void ProcessIntermediateDumpsInBackground(
+      const std::map<std::string, std::string>& annotations = {});
+
   //! \brief Requests that the handler convert a single intermediate dump at \a
   //!     file generated by DumpWithoutCrashAndDeferProcessingAtPath into a
   //!     minidump and trigger an upload if possible.
@@ -735,6 +872,51 @@ class CrashpadClient {
   //!     `&quot;\\.\pipe\NAME&quot;`.
   std::wstring GetHandlerIPCPipe() const;
 
+  //! \brief Registers a child process with the Crashpad handler on its behalf,
+  //!     so that the child can use the handler without an IPC message
+  //!     exchange of its own.
+  //!
+  //! This method is only defined on Windows.
+  //!
+  //! This must only be called after a successful call to StartHandler(),
+  //! SetHandlerIPCPipe(), or SetHandlerFromChildClientData(), and only for a
+  //! child that this process created, which the handler verifies. The child
+  //! should be created with `CREATE_SUSPENDED` and resumed after this returns,
+  //! and must be of the same bitness as this process. Memory for the exception
+  //! information that the child gives the handler when it crashes is allocated
+  //! in the child, and the handler’s events are duplicated into the child.
+  //!
+  //! The child then calls SetHandlerFromChildClientData() with \a
+  //! child_client_data, which may be passed to it on the command line or in
+  //! its environment. Processes that start many children can register each of
+  //! them here, off of their startup path, instead of having each child call
+  //! SetHandlerIPCPipe().
+  //!
+  //! \param[in] child_process A handle to the child process, with
+  //!     `PROCESS_VM_OPERATION` access.
+  //! \param[out] child_client_data The data to pass to the child.
+  //!
+  //! \return `true` on success and `false` on failure with a message logged.
+  bool RegisterChildProcess(HANDLE child_process,
+                            std::string* child_client_data) const;
+
+  //! \brief Uses a registration made by a parent process with
+  //!     RegisterChildProcess(). Crashes will be serviced once this method
+  //!     returns.
+  //!
+  //! This method is only defined on Windows.
+  //!
+  //! Unlike SetHandlerIPCPipe(), this doesn’t communicate with the handler. It
+  //! sets the unhandled exception handler in the same way. Minidumps of this
+  //! process won’t include data about locks that the handler would otherwise
+  //! find from a registered `CRITICAL_SECTION`.
+  //!
+  //! \param[in] child_client_data The data that RegisterChildProcess() returned
+  //!     to the parent.
+  //!
+  //! \return `true` on success and `false` on failure with a message logged.
+  bool SetHandlerFromChildClientData(const std::string& child_client_data);
+
   //! \brief When `asynchronous_start` is used with StartHandler(), this method
   //!     can be used to block until the handler launch has been completed to
   //!     retrieve status information.
@@ -842,6 +1024,11 @@ class CrashpadClient {
   ScopedKernelHANDLE handler_start_thread_;
 #elif BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
   bool crash_loop_detection_ = false;
+  bool use_crash_signal_region_ = false;
+  bool launch_at_crash_fallback_ = false;
+#if BUILDFLAG(IS_ANDROID)
+  bool prewarmed_handler_ = false;
+#endif  // BUILDFLAG(IS_ANDROID)
   UUID run_uuid_;
   std::set<int> unhandled_signals_;
 #endif  // BUILDFLAG(IS_APPLE)
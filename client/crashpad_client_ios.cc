@@ -123,6 +123,11 @@ class CrashHandler : public Thread,
     in_process_handler_.ProcessIntermediateDumps(annotations);
   }
 
+  void ProcessIntermediateDumpsInBackground(
+      const std::map<std::string, std::string>& annotations) {
+    in_process_handler_.ProcessIntermediateDumpsInBackground(annotations);
+  }
+
   void ProcessIntermediateDump(
       const base::FilePath& file,
       const std::map<std::string, std::string>& annotations) {
@@ -429,6 +434,14 @@ void CrashpadClient::ProcessIntermediateDumps(
   crash_handler->ProcessIntermediateDumps(annotations);
 }
 
+// static
+void CrashpadClient::ProcessIntermediateDumpsInBackground(
+    const std::map<std::string, std::string>& annotations) {
+  CrashHandler* crash_handler = CrashHandler::Get();
+  DCHECK(crash_handler);
+  crash_handler->ProcessIntermediateDumpsInBackground(annotations);
+}
+
 // static
 void CrashpadClient::ProcessIntermediateDump(
     const base::FilePath& file,
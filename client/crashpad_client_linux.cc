@@ -29,6 +29,7 @@
 #include <unistd.h>
 
 #include <atomic>
+#include <mutex>
 
 #include "base/logging.h"
 #include "base/strings/stringprintf.h"
@@ -132,6 +133,32 @@ std::vector<std::string> BuildArgsToLaunchWithLinker(
 
 #endif  // BUILDFLAG(IS_ANDROID)
 
+// Launches a handler with argv and envp (or this process’ environment if envp
+// is nullptr), and waits for it to exit. This is safe to call from a signal
+// handler, provided argv and envp were prepared in advance.
+void LaunchHandlerAndWait(const std::vector<const char*>& argv,
+                          const std::vector<const char*>* envp) {
+  ScopedPrSetPtracer set_ptracer(sys_getpid(), /* may_log= */ false);
+
+  pid_t pid = fork();
+  if (pid < 0) {
+    return;
+  }
+  if (pid == 0) {
+    if (envp) {
+      execve(argv[0],
+             const_cast<char* const*>(argv.data()),
+             const_cast<char* const*>(envp->data()));
+    } else {
+      execv(argv[0], const_cast<char* const*>(argv.data()));
+    }
+    _exit(EXIT_FAILURE);
+  }
+
+  int status;
+  waitpid(pid, &status, 0);
+}
+
 // A base class for Crashpad signal handler implementations.
 class SignalHandler {
  public:
@@ -165,6 +192,7 @@ class SignalHandler {
         FromPointerCast<decltype(exception_information_.context_address)>(
             context);
     exception_information_.thread_id = sys_gettid();
+    simulated_ = signo == Signals::kSimulatedSigno;
 
     ScopedPrSetDumpable set_dumpable(false);
     HandleCrashImpl();
@@ -189,6 +217,9 @@ class SignalHandler {
     return exception_information_;
   }
 
+  // Whether the crash being handled is simulated, as by DumpWithoutCrash().
+  bool IsSimulated() const { return simulated_; }
+
   virtual void HandleCrashImpl() = 0;
 
  private:
@@ -252,6 +283,7 @@ class SignalHandler {
 
   Signals::OldActions old_actions_ = {};
   ExceptionInformation exception_information_ = {};
+  bool simulated_ = false;
   CrashpadClient::FirstChanceHandler first_chance_handler_ = nullptr;
   int32_t dump_done_futex_ = kDumpNotDone;
 #if !defined(__cpp_lib_atomic_value_initialization) || \
@@ -295,25 +327,7 @@ class LaunchAtCrashHandler : public SignalHandler {
   }
 
   void HandleCrashImpl() override {
-    ScopedPrSetPtracer set_ptracer(sys_getpid(), /* may_log= */ false);
-
-    pid_t pid = fork();
-    if (pid < 0) {
-      return;
-    }
-    if (pid == 0) {
-      if (set_envp_) {
-        execve(argv_[0],
-               const_cast<char* const*>(argv_.data()),
-               const_cast<char* const*>(envp_.data()));
-      } else {
-        execv(argv_[0], const_cast<char* const*>(argv_.data()));
-      }
-      _exit(EXIT_FAILURE);
-    }
-
-    int status;
-    waitpid(pid, &status, 0);
+    LaunchHandlerAndWait(argv_, set_envp_ ? &envp_ : nullptr);
   }
 
  private:
@@ -348,6 +362,7 @@ class RequestCrashDumpHandler : public SignalHandler {
   // retrieving this information from the handler is not necessary.
   bool Initialize(ScopedFileHandle sock,
                   pid_t pid,
+                  bool use_crash_signal_region,
                   const std::set<int>* unhandled_signals) {
     ExceptionHandlerClient client(sock.get(), true);
     if (pid < 0) {
@@ -357,6 +372,13 @@ class RequestCrashDumpHandler : public SignalHandler {
       }
       pid = creds.pid;
     }
+    crash_signal_region_.Reset();
+    crash_signal_sock_.reset();
+    if (use_crash_signal_region &&
+        !client.RegisterCrashSignalRegion(&crash_signal_region_,
+                                          &crash_signal_sock_)) {
+      LOG(WARNING) << "requesting crash dumps on the handler socket";
+    }
     if (pid > 0) {
       pthread_atfork(nullptr, nullptr, SetPtracerAtFork);
       if (prctl(PR_SET_PTRACER, pid, 0, 0, 0) != 0) {
@@ -368,6 +390,27 @@ class RequestCrashDumpHandler : public SignalHandler {
     return Install(unhandled_signals);
   }
 
+  // Sets the arguments and environment (or this process’ environment if envp
+  // is nullptr) used to launch a handler at crash time if the handler can’t be
+  // reached, or disables the fallback if argv_in is empty.
+  void SetFallbackArgv(std::vector<std::string>* argv_in,
+                       const std::vector<std::string>* envp) {
+    fallback_argv_strings_.swap(*argv_in);
+    fallback_argv_.clear();
+    if (!fallback_argv_strings_.empty()) {
+      fallback_argv_strings_.push_back(FormatArgumentAddress(
+          "trace-parent-with-exception", &GetExceptionInfo()));
+      StringVectorToCStringVector(fallback_argv_strings_, &fallback_argv_);
+    }
+
+    fallback_envp_.clear();
+    set_fallback_envp_ = envp != nullptr;
+    if (set_fallback_envp_) {
+      fallback_envp_strings_ = *envp;
+      StringVectorToCStringVector(fallback_envp_strings_, &fallback_envp_);
+    }
+  }
+
   bool GetHandlerSocket(int* sock, pid_t* pid) {
     if (!sock_to_handler_.is_valid()) {
       return false;
@@ -395,9 +438,20 @@ class RequestCrashDumpHandler : public SignalHandler {
 #if BUILDFLAG(IS_CHROMEOS_ASH)
     info.crash_loop_before_time = crash_loop_before_time_;
 #endif
+    info.simulated = IsSimulated();
 
     ExceptionHandlerClient client(sock_to_handler_.get(), true);
-    client.RequestCrashDump(info);
+    if (crash_signal_region_.is_valid()) {
+      client.SetCrashSignalRegion(
+          crash_signal_region_
+              .addr_as<ExceptionHandlerProtocol::CrashSignalRegion*>(),
+          crash_signal_sock_.get());
+    }
+    int status = client.RequestCrashDump(info);
+    if (status != 0 && !fallback_argv_.empty() && HandlerUnreachable(status)) {
+      LaunchHandlerAndWait(fallback_argv_,
+                           set_fallback_envp_ ? &fallback_envp_ : nullptr);
+    }
   }
 
 #if BUILDFLAG(IS_CHROMEOS_ASH)
@@ -411,6 +465,22 @@ class RequestCrashDumpHandler : public SignalHandler {
 
   ~RequestCrashDumpHandler() = delete;
 
+  // Returns true if status, returned by RequestCrashDump(), means that the
+  // request never reached the handler. Other failures, such as timeouts, may
+  // leave the handler still writing a dump.
+  static bool HandlerUnreachable(int status) {
+    switch (status) {
+      case EBADF:
+      case ECONNREFUSED:
+      case ECONNRESET:
+      case ENOTCONN:
+      case EPIPE:
+        return true;
+      default:
+        return false;
+    }
+  }
+
   static void SetPtracerAtFork() {
     auto handler = RequestCrashDumpHandler::Get();
     if (handler->handler_pid_ > 0 &&
@@ -420,6 +490,13 @@ class RequestCrashDumpHandler : public SignalHandler {
   }
 
   ScopedFileHandle sock_to_handler_;
+  ScopedMmap crash_signal_region_;
+  ScopedFileHandle crash_signal_sock_;
+  std::vector<std::string> fallback_argv_strings_;
+  std::vector<const char*> fallback_argv_;
+  std::vector<std::string> fallback_envp_strings_;
+  std::vector<const char*> fallback_envp_;
+  bool set_fallback_envp_ = false;
   pid_t handler_pid_ = -1;
 
 #if BUILDFLAG(IS_CHROMEOS_ASH)
@@ -431,6 +508,124 @@ class RequestCrashDumpHandler : public SignalHandler {
 #endif
 };
 
+// The size of a signal stack allocated by InitializeSignalStackForThread().
+size_t SignalStackSize() {
+  const size_t page_size = getpagesize();
+#if defined(ADDRESS_SANITIZER)
+  return 2 * ((SIGSTKSZ + page_size - 1) & ~(page_size - 1));
+#else
+  return (SIGSTKSZ + page_size - 1) & ~(page_size - 1);
+#endif  // ADDRESS_SANITIZER
+}
+
+// The size of the mapping that holds a signal stack, with a guard page on
+// either side of the stack.
+size_t SignalStackAllocationSize() {
+  return SignalStackSize() + 2 * getpagesize();
+}
+
+// Keeps the signal stacks of threads that have exited, so that threads started
+// later can use them rather than mapping their own. Each is kept as its whole
+// mapping, and is linked to the next through the start of its stack.
+class SignalStackPool {
+ public:
+  static constexpr size_t kDefaultCapacity = 16;
+
+  SignalStackPool(const SignalStackPool&) = delete;
+  SignalStackPool& operator=(const SignalStackPool&) = delete;
+
+  static SignalStackPool* Get() {
+    static SignalStackPool* const pool = new SignalStackPool();
+    return pool;
+  }
+
+  // Returns a kept signal stack mapping, or nullptr if none are kept.
+  void* Take() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!head_) {
+      return nullptr;
+    }
+    void* const stack_mem = head_;
+    head_ = *NextLink(stack_mem);
+    --size_;
+    return stack_mem;
+  }
+
+  // Keeps stack_mem, returning `false` if the pool is already full.
+  bool Give(void* stack_mem) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (size_ >= capacity_) {
+      return false;
+    }
+    *NextLink(stack_mem) = head_;
+    head_ = stack_mem;
+    ++size_;
+    return true;
+  }
+
+  // Sets the number of signal stack mappings that may be kept, unmapping any
+  // that are already kept beyond it.
+  void SetCapacity(size_t capacity) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    capacity_ = capacity;
+    while (size_ > capacity_) {
+      void* const stack_mem = head_;
+      head_ = *NextLink(stack_mem);
+      --size_;
+      if (munmap(stack_mem, SignalStackAllocationSize()) != 0) {
+        PLOG(ERROR) << "munmap";
+      }
+    }
+  }
+
+ private:
+  SignalStackPool() = default;
+
+  static void** NextLink(void* stack_mem) {
+    return reinterpret_cast<void**>(static_cast<char*>(stack_mem) +
+                                    getpagesize());
+  }
+
+  std::mutex mutex_;
+  void* head_ = nullptr;
+  size_t size_ = 0;
+  size_t capacity_ = kDefaultCapacity;
+};
+
+#if BUILDFLAG(IS_ANDROID)
+// Starts a handler with argv, the arguments that would launch it at crash
+// time, parked until this process makes a request on the socket it’s given.
+// If the parked handler can’t be reached at crash time, one is launched with
+// argv as it would have been.
+bool StartPrewarmedHandler(std::vector<std::string>* argv,
+                           const std::vector<std::string>* env,
+                           const std::set<int>* unhandled_signals) {
+  ScopedFileHandle client_sock, handler_sock;
+  if (!UnixCredentialSocket::CreateCredentialSocketpair(&client_sock,
+                                                        &handler_sock)) {
+    return false;
+  }
+
+  std::vector<std::string> prewarmed_argv = *argv;
+  prewarmed_argv.push_back(
+      FormatArgumentInt("initial-client-fd", handler_sock.get()));
+  prewarmed_argv.push_back("--shared-client-connection");
+  prewarmed_argv.push_back("--park-until-request");
+  if (!SpawnSubprocess(
+          prewarmed_argv, env, handler_sock.get(), false, nullptr)) {
+    return false;
+  }
+  handler_sock.reset();
+
+  // The handler’s process ID isn’t known without asking it, which would wake
+  // it. The handler asks for ptrace permission while taking a dump instead.
+  auto signal_handler = RequestCrashDumpHandler::Get();
+  signal_handler->SetFallbackArgv(argv, env);
+  return signal_handler->Initialize(
+      std::move(client_sock), 0, false, unhandled_signals);
+}
+#endif  // BUILDFLAG(IS_ANDROID)
+
 }  // namespace
 
 CrashpadClient::CrashpadClient() {}
@@ -458,6 +653,11 @@ bool CrashpadClient::StartHandler(
   std::vector<std::string> argv = BuildHandlerArgvStrings(
       handler, database, metrics_dir, url, annotations, arguments, attachments);
 
+  std::vector<std::string> fallback_argv;
+  if (launch_at_crash_fallback_) {
+    fallback_argv = argv;
+  }
+
   argv.push_back(FormatArgumentInt("initial-client-fd", handler_sock.get()));
   argv.push_back("--shared-client-connection");
 
@@ -477,9 +677,16 @@ bool CrashpadClient::StartHandler(
     handler_pid = 0;
   }
 
+  if (crash_loop_detection_ && !fallback_argv.empty()) {
+    fallback_argv.push_back("--annotation=run-uuid=" + run_uuid_.ToString());
+  }
+
   auto signal_handler = RequestCrashDumpHandler::Get();
-  return signal_handler->Initialize(
-      std::move(client_sock), handler_pid, &unhandled_signals_);
+  signal_handler->SetFallbackArgv(&fallback_argv, nullptr);
+  return signal_handler->Initialize(std::move(client_sock),
+                                    handler_pid,
+                                    use_crash_signal_region_,
+                                    &unhandled_signals_);
 }
 
 #if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_ANDROID) || DOXYGEN
@@ -508,9 +715,61 @@ bool CrashpadClient::GetHandlerSocket(int* sock, pid_t* pid) {
   return signal_handler->GetHandlerSocket(sock, pid);
 }
 
+// static
+bool CrashpadClient::RequestStackSampling() {
+  int sock;
+  if (!GetHandlerSocket(&sock, nullptr)) {
+    LOG(ERROR) << "no handler";
+    return false;
+  }
+  return ExceptionHandlerClient(sock, true).RequestStackSampling();
+}
+
 bool CrashpadClient::SetHandlerSocket(ScopedFileHandle sock, pid_t pid) {
   auto signal_handler = RequestCrashDumpHandler::Get();
-  return signal_handler->Initialize(std::move(sock), pid, &unhandled_signals_);
+  return signal_handler->Initialize(
+      std::move(sock), pid, use_crash_signal_region_, &unhandled_signals_);
+}
+
+bool CrashpadClient::SetHandlerDaemon(
+    const std::string& socket_name,
+    const std::map<std::string, std::string>& annotations) {
+  ScopedFileHandle sock;
+  ucred handler_creds;
+  if (!UnixCredentialSocket::ConnectCredentialSocket(
+          socket_name.empty()
+              ? ExceptionHandlerProtocol::kDefaultDaemonSocketName
+              : socket_name,
+          &sock,
+          &handler_creds)) {
+    return false;
+  }
+
+  // The annotations are sent before anything else so that they apply to a
+  // CrashSignalRegion registered by Initialize().
+  ExceptionHandlerClient client(sock.get(), true);
+  if (!client.SetAnnotations(annotations)) {
+    return false;
+  }
+
+  pid_t handler_pid = handler_creds.pid;
+  if (!IsRegularFile(base::FilePath("/proc/sys/kernel/yama/ptrace_scope"))) {
+    handler_pid = 0;
+  }
+
+  auto signal_handler = RequestCrashDumpHandler::Get();
+  return signal_handler->Initialize(std::move(sock),
+                                    handler_pid,
+                                    use_crash_signal_region_,
+                                    &unhandled_signals_);
+}
+
+void CrashpadClient::EnableCrashSignalRegion() {
+  use_crash_signal_region_ = true;
+}
+
+void CrashpadClient::EnableLaunchAtCrashFallback() {
+  launch_at_crash_fallback_ = true;
 }
 
 // static
@@ -523,26 +782,13 @@ bool CrashpadClient::InitializeSignalStackForThread() {
 
   DCHECK_EQ(stack.ss_flags & SS_ONSTACK, 0);
 
-  const size_t page_size = getpagesize();
-#if defined(ADDRESS_SANITIZER)
-  const size_t kStackSize = 2 * ((SIGSTKSZ + page_size - 1) & ~(page_size - 1));
-#else
-  const size_t kStackSize = (SIGSTKSZ + page_size - 1) & ~(page_size - 1);
-#endif  // ADDRESS_SANITIZER
+  const size_t kStackSize = SignalStackSize();
   if (stack.ss_flags & SS_DISABLE || stack.ss_size < kStackSize) {
-    const size_t kGuardPageSize = page_size;
-    const size_t kStackAllocSize = kStackSize + 2 * kGuardPageSize;
+    const size_t kGuardPageSize = getpagesize();
+    const size_t kStackAllocSize = SignalStackAllocationSize();
 
     static void (*stack_destructor)(void*) = [](void* stack_mem) {
-      const size_t page_size = getpagesize();
-      const size_t kGuardPageSize = page_size;
-#if defined(ADDRESS_SANITIZER)
-      const size_t kStackSize =
-          2 * ((SIGSTKSZ + page_size - 1) & ~(page_size - 1));
-#else
-      const size_t kStackSize = (SIGSTKSZ + page_size - 1) & ~(page_size - 1);
-#endif  // ADDRESS_SANITIZER
-      const size_t kStackAllocSize = kStackSize + 2 * kGuardPageSize;
+      const size_t kGuardPageSize = getpagesize();
 
       stack_t stack;
       stack.ss_flags = SS_DISABLE;
@@ -553,7 +799,8 @@ bool CrashpadClient::InitializeSignalStackForThread() {
         PLOG_IF(ERROR, sigaltstack(&stack, nullptr) != 0) << "sigaltstack";
       }
 
-      if (munmap(stack_mem, kStackAllocSize) != 0) {
+      if (!SignalStackPool::Get()->Give(stack_mem) &&
+          munmap(stack_mem, SignalStackAllocationSize()) != 0) {
         PLOG(ERROR) << "munmap";
       }
     };
@@ -569,6 +816,13 @@ bool CrashpadClient::InitializeSignalStackForThread() {
     }
 
     auto old_stack = static_cast<char*>(pthread_getspecific(stack_key));
+    if (!old_stack) {
+      old_stack = static_cast<char*>(SignalStackPool::Get()->Take());
+      if (old_stack) {
+        errno = pthread_setspecific(stack_key, old_stack);
+        PCHECK(errno == 0) << "pthread_setspecific";
+      }
+    }
     if (old_stack) {
       stack.ss_sp = old_stack + kGuardPageSize;
     } else {
@@ -605,11 +859,20 @@ bool CrashpadClient::InitializeSignalStackForThread() {
   }
   return true;
 }
+
+// static
+void CrashpadClient::SetSignalStackPoolCapacity(size_t capacity) {
+  SignalStackPool::Get()->SetCapacity(capacity);
+}
 #endif  // BUILDFLAG(IS_ANDROID) || BUILDFLAG(IS_LINUX) ||
         // BUILDFLAG(IS_CHROMEOS)
 
 #if BUILDFLAG(IS_ANDROID)
 
+void CrashpadClient::EnablePrewarmedHandler() {
+  prewarmed_handler_ = true;
+}
+
 bool CrashpadClient::StartJavaHandlerAtCrash(
     const std::string& class_name,
     const std::vector<std::string>* env,
@@ -625,6 +888,9 @@ bool CrashpadClient::StartJavaHandlerAtCrash(
                                                       annotations,
                                                       arguments,
                                                       kInvalidFileHandle);
+  if (prewarmed_handler_) {
+    return StartPrewarmedHandler(&argv, env, &unhandled_signals_);
+  }
 
   auto signal_handler = LaunchAtCrashHandler::Get();
   return signal_handler->Initialize(&argv, env, &unhandled_signals_);
@@ -665,6 +931,10 @@ bool CrashpadClient::StartHandlerWithLinkerAtCrash(
                                   annotations,
                                   arguments,
                                   kInvalidFileHandle);
+  if (prewarmed_handler_) {
+    return StartPrewarmedHandler(&argv, env, &unhandled_signals_);
+  }
+
   auto signal_handler = LaunchAtCrashHandler::Get();
   return signal_handler->Initialize(&argv, env, &unhandled_signals_);
 }
@@ -758,6 +1028,31 @@ void CrashpadClient::DumpWithoutCrash(NativeCPUContext* context) {
       siginfo.si_signo, &siginfo, reinterpret_cast<void*>(context));
 }
 
+// static
+pid_t CrashpadClient::DumpWithoutCrashInForkedChild(NativeCPUContext* context) {
+  if (!SignalHandler::Get()) {
+    DLOG(ERROR) << "Crashpad isn't enabled";
+    return -1;
+  }
+
+  pid_t pid = fork();
+  if (pid < 0) {
+    PLOG(ERROR) << "fork";
+    return -1;
+  }
+  if (pid > 0) {
+    return pid;
+  }
+
+  // The child has a single thread, whose stack and context are those of the
+  // caller. Requesting the dump sets the handler as the child’s ptracer if
+  // necessary.
+  DumpWithoutCrash(context);
+
+  // In a forked child, exit() is unsafe. Use _exit() instead.
+  _exit(EXIT_SUCCESS);
+}
+
 // static
 void CrashpadClient::CrashWithoutDump(const std::string& message) {
   SignalHandler::Disable();
@@ -20,10 +20,12 @@
 #include <stdlib.h>
 #include <sys/syscall.h>
 #include <sys/types.h>
+#include <sys/wait.h>
 #include <unistd.h>
 
 #include "base/check_op.h"
 #include "base/notreached.h"
+#include "base/posix/eintr_wrapper.h"
 #include "build/build_config.h"
 #include "client/annotation.h"
 #include "client/annotation_list.h"
@@ -67,6 +69,7 @@ namespace {
 
 enum class CrashType : uint32_t {
   kSimulated,
+  kSimulatedInForkedChild,
   kBuiltinTrap,
   kInfiniteRecursion,
 };
@@ -78,11 +81,12 @@ struct StartHandlerForSelfTestOptions {
   bool client_uses_signals;
   bool gather_indirectly_referenced_memory;
   CrashType crash_type;
+  bool release_clients_before_writing;
 };
 
 class StartHandlerForSelfTest
     : public testing::TestWithParam<
-          std::tuple<bool, bool, bool, bool, bool, CrashType>> {
+          std::tuple<bool, bool, bool, bool, bool, CrashType, bool>> {
  public:
   StartHandlerForSelfTest() = default;
 
@@ -100,7 +104,8 @@ class StartHandlerForSelfTest
              options_.crash_non_main_thread,
              options_.client_uses_signals,
              options_.gather_indirectly_referenced_memory,
-             options_.crash_type) = GetParam();
+             options_.crash_type,
+             options_.release_clients_before_writing) = GetParam();
   }
 
   const StartHandlerForSelfTestOptions& Options() const { return options_; }
@@ -113,6 +118,7 @@ bool InstallHandler(CrashpadClient* client,
                     bool start_at_crash,
                     const base::FilePath& handler_path,
                     const base::FilePath& database_path,
+                    const std::vector<std::string>& arguments,
                     const std::vector<base::FilePath>& attachments) {
   return start_at_crash
              ? client->StartHandlerAtCrash(handler_path,
@@ -120,14 +126,14 @@ bool InstallHandler(CrashpadClient* client,
                                            base::FilePath(),
                                            "",
                                            std::map<std::string, std::string>(),
-                                           std::vector<std::string>(),
+                                           arguments,
                                            attachments)
              : client->StartHandler(handler_path,
                                     database_path,
                                     base::FilePath(),
                                     "",
                                     std::map<std::string, std::string>(),
-                                    std::vector<std::string>(),
+                                    arguments,
                                     false,
                                     false,
                                     attachments);
@@ -240,6 +246,18 @@ void DoCrash(const StartHandlerForSelfTestOptions& options,
       CRASHPAD_SIMULATE_CRASH();
       break;
 
+    case CrashType::kSimulatedInForkedChild: {
+      NativeCPUContext context;
+      CaptureContext(&context);
+      pid_t pid = CrashpadClient::DumpWithoutCrashInForkedChild(&context);
+      CHECK_GT(pid, 0);
+      int status;
+      CHECK_EQ(HANDLE_EINTR(waitpid(pid, &status, 0)), pid);
+      CHECK(WIFEXITED(status));
+      CHECK_EQ(WEXITSTATUS(status), EXIT_SUCCESS);
+      break;
+    }
+
     case CrashType::kBuiltinTrap:
       __builtin_trap();
 
@@ -363,11 +381,17 @@ CRASHPAD_CHILD_TEST_MAIN(StartHandlerForSelfTestChild) {
   const std::vector<base::FilePath> attachments = {
       base::FilePath(temp_dir).Append(kTestAttachmentName)};
 
+  std::vector<std::string> arguments;
+  if (options.release_clients_before_writing) {
+    arguments.push_back("--release-clients-before-writing");
+  }
+
   crashpad::CrashpadClient client;
   if (!InstallHandler(&client,
                       options.start_handler_at_crash,
                       handler_path,
                       base::FilePath(temp_dir),
+                      arguments,
                       attachments)) {
     return EXIT_FAILURE;
   }
@@ -401,6 +425,7 @@ class StartHandlerForSelfInChildTest : public MultiprocessExec {
     if (!options.set_first_chance_handler) {
       switch (options.crash_type) {
         case CrashType::kSimulated:
+        case CrashType::kSimulatedInForkedChild:
           // kTerminationNormal, EXIT_SUCCESS
           break;
         case CrashType::kBuiltinTrap:
@@ -441,13 +466,18 @@ class StartHandlerForSelfInChildTest : public MultiprocessExec {
     writer.Close();
 
     if (options_.client_uses_signals && !options_.set_first_chance_handler &&
-        options_.crash_type != CrashType::kSimulated) {
+        options_.crash_type != CrashType::kSimulated &&
+        options_.crash_type != CrashType::kSimulatedInForkedChild) {
       // Wait for child's client signal handler.
       char c;
       EXPECT_TRUE(LoggingReadFileExactly(ReadPipeHandle(), &c, sizeof(c)));
     }
 
-    // Wait for child to finish.
+    // Wait for child to finish. The handler inherits the child’s standard
+    // output, so this also waits for the handler to exit. With
+    // --release-clients-before-writing, the child may be resumed before its
+    // report is written, but the handler commits every report that it has
+    // queued before exiting.
     CheckedReadFileAtEOF(ReadPipeHandle());
 
     auto database = CrashReportDatabase::Initialize(temp_dir.path());
@@ -462,8 +492,10 @@ class StartHandlerForSelfInChildTest : public MultiprocessExec {
     ASSERT_EQ(database->GetPendingReports(&reports),
               CrashReportDatabase::kNoError);
 
-    bool report_expected = !options_.set_first_chance_handler ||
-                           options_.crash_type == CrashType::kSimulated;
+    bool report_expected =
+        !options_.set_first_chance_handler ||
+        options_.crash_type == CrashType::kSimulated ||
+        options_.crash_type == CrashType::kSimulatedInForkedChild;
     ASSERT_EQ(reports.size(), report_expected ? 1u : 0u);
 
     if (!report_expected) {
@@ -499,8 +531,26 @@ INSTANTIATE_TEST_SUITE_P(
                      testing::Bool(),
                      testing::Bool(),
                      testing::Values(CrashType::kSimulated,
+                                     CrashType::kSimulatedInForkedChild,
                                      CrashType::kBuiltinTrap,
-                                     CrashType::kInfiniteRecursion)));
+                                     CrashType::kInfiniteRecursion),
+                     testing::Values(false)));
+
+// Reports are written after the client is released, so they must still be
+// committed to the database by the time the handler exits.
+INSTANTIATE_TEST_SUITE_P(
+    StartHandlerForSelfReleaseClientsBeforeWritingTestSuite,
+    StartHandlerForSelfTest,
+    testing::Combine(testing::Bool(),
+                     testing::Values(false),
+                     testing::Bool(),
+                     testing::Values(false),
+                     testing::Values(false),
+                     testing::Values(CrashType::kSimulated,
+                                     CrashType::kSimulatedInForkedChild,
+                                     CrashType::kBuiltinTrap,
+                                     CrashType::kInfiniteRecursion),
+                     testing::Values(true)));
 
 // Test state for starting the handler for another process.
 class StartHandlerForClientTest {
@@ -685,6 +735,51 @@ TEST(CrashpadClient, SanitizedChild) {
   test.Run();
 }
 
+class SignalStackThread : public Thread {
+ public:
+  SignalStackThread() : Thread(), stack_() {}
+
+  SignalStackThread(const SignalStackThread&) = delete;
+  SignalStackThread& operator=(const SignalStackThread&) = delete;
+
+  ~SignalStackThread() override = default;
+
+  const stack_t& stack() const { return stack_; }
+
+ private:
+  void ThreadMain() override {
+    ASSERT_TRUE(CrashpadClient::InitializeSignalStackForThread());
+    ASSERT_EQ(sigaltstack(nullptr, &stack_), 0) << ErrnoMessage("sigaltstack");
+  }
+
+  stack_t stack_;
+};
+
+TEST(CrashpadClient, SignalStackPool) {
+  CrashpadClient::SetSignalStackPoolCapacity(1);
+
+  // The signal stack of a thread that has exited is given to the next thread.
+  SignalStackThread first;
+  first.Start();
+  first.Join();
+  EXPECT_EQ(first.stack().ss_flags & SS_DISABLE, 0);
+
+  SignalStackThread second;
+  second.Start();
+  second.Join();
+  EXPECT_EQ(second.stack().ss_sp, first.stack().ss_sp);
+  EXPECT_EQ(second.stack().ss_size, first.stack().ss_size);
+
+  // Without a pool, signal stacks are freed when their threads exit.
+  CrashpadClient::SetSignalStackPoolCapacity(0);
+  SignalStackThread third;
+  third.Start();
+  third.Join();
+  EXPECT_EQ(third.stack().ss_flags & SS_DISABLE, 0);
+
+  CrashpadClient::SetSignalStackPoolCapacity(16);
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace crashpad
@@ -35,6 +35,7 @@
 #include "util/misc/from_pointer_cast.h"
 #include "util/misc/random_string.h"
 #include "util/win/address_types.h"
+#include "util/win/child_client_data.h"
 #include "util/win/command_line.h"
 #include "util/win/context_wrappers.h"
 #include "util/win/critical_section_with_debug_info.h"
@@ -71,6 +72,15 @@ base::Lock* g_non_crash_dump_lock;
 // dump.
 ExceptionInformation g_non_crash_exception_information;
 
+// Where the two structures above are actually written. These point to them,
+// unless this process was registered by its parent with
+// CrashpadClient::RegisterChildProcess(), in which case they point to memory
+// that the parent allocated in this process and gave to the handler.
+ExceptionInformation* g_crash_exception_information_ptr =
+    &g_crash_exception_information;
+ExceptionInformation* g_non_crash_exception_information_ptr =
+    &g_non_crash_exception_information;
+
 // Context for the out-of-process exception handler module and holds non-crash
 // dump handles. Handles are never closed once created.
 WerRegistration g_wer_registration = {WerRegistration::kWerRegistrationVersion,
@@ -179,8 +189,8 @@ LONG WINAPI UnhandledExceptionHandler(EXCEPTION_POINTERS* exception_pointers) {
 
   // Otherwise, we're the first thread, so record the exception pointer and
   // signal the crash handler.
-  g_crash_exception_information.thread_id = GetCurrentThreadId();
-  g_crash_exception_information.exception_pointers =
+  g_crash_exception_information_ptr->thread_id = GetCurrentThreadId();
+  g_crash_exception_information_ptr->exception_pointers =
       FromPointerCast<WinVMAddress>(exception_pointers);
 
   // Now signal the crash server, which will take a dump and then terminate us
@@ -757,6 +767,93 @@ std::wstring CrashpadClient::GetHandlerIPCPipe() const {
   return ipc_pipe_;
 }
 
+bool CrashpadClient::RegisterChildProcess(
+    HANDLE child_process,
+    std::string* child_client_data) const {
+  DCHECK(!ipc_pipe_.empty());
+
+  // Both structures are allocated together, and are zeroed by the allocation.
+  void* exception_information =
+      VirtualAllocEx(child_process,
+                     nullptr,
+                     2 * sizeof(ExceptionInformation),
+                     MEM_COMMIT | MEM_RESERVE,
+                     PAGE_READWRITE);
+  if (!exception_information) {
+    PLOG(ERROR) << "VirtualAllocEx";
+    return false;
+  }
+  const WinVMAddress crash_exception_information =
+      FromPointerCast<WinVMAddress>(exception_information);
+  const WinVMAddress non_crash_exception_information =
+      crash_exception_information + sizeof(ExceptionInformation);
+
+  ClientToServerMessage message;
+  memset(&message, 0, sizeof(message));
+  message.type = ClientToServerMessage::kRegisterChild;
+  message.registration.version = RegistrationRequest::kMessageVersion;
+  message.registration.client_process_id = GetProcessId(child_process);
+  message.registration.crash_exception_information =
+      crash_exception_information;
+  message.registration.non_crash_exception_information =
+      non_crash_exception_information;
+  message.registration.critical_section_address = 0;
+
+  ServerToClientMessage response = {};
+  if (!SendToCrashHandlerServer(ipc_pipe_, message, &response)) {
+    if (!VirtualFreeEx(child_process, exception_information, 0, MEM_RELEASE)) {
+      PLOG(WARNING) << "VirtualFreeEx";
+    }
+    return false;
+  }
+
+  // The server returns the events already duplicated to be valid in the child.
+  ChildClientData data(
+      IntToHandle(response.registration.request_crash_dump_event),
+      IntToHandle(response.registration.request_non_crash_dump_event),
+      IntToHandle(response.registration.non_crash_dump_completed_event),
+      crash_exception_information,
+      non_crash_exception_information,
+      ipc_pipe_);
+  *child_client_data = data.StringRepresentation();
+  return true;
+}
+
+bool CrashpadClient::SetHandlerFromChildClientData(
+    const std::string& child_client_data) {
+  DCHECK(ipc_pipe_.empty());
+  DCHECK_EQ(g_signal_exception, INVALID_HANDLE_VALUE);
+  DCHECK_EQ(g_wer_registration.dump_without_crashing, INVALID_HANDLE_VALUE);
+  DCHECK_EQ(g_wer_registration.dump_completed, INVALID_HANDLE_VALUE);
+  DCHECK(!g_non_crash_dump_lock);
+
+  ChildClientData data;
+  if (!data.InitializeFromString(child_client_data)) {
+    return false;
+  }
+
+  ipc_pipe_ = data.ipc_pipe();
+
+  CommonInProcessInitialization();
+
+  g_crash_exception_information_ptr =
+      reinterpret_cast<ExceptionInformation*>(
+          static_cast<uintptr_t>(data.crash_exception_information()));
+  g_non_crash_exception_information_ptr =
+      reinterpret_cast<ExceptionInformation*>(
+          static_cast<uintptr_t>(data.non_crash_exception_information()));
+
+  SetHandlerStartupState(StartupState::kSucceeded);
+
+  RegisterHandlers();
+
+  g_signal_exception = data.request_crash_dump();
+  g_wer_registration.dump_without_crashing = data.request_non_crash_dump();
+  g_wer_registration.dump_completed = data.non_crash_dump_completed();
+
+  return true;
+}
+
 bool CrashpadClient::WaitForHandlerStart(unsigned int timeout_ms) {
   DCHECK(handler_start_thread_.is_valid());
   DWORD result = WaitForSingleObject(handler_start_thread_.get(), timeout_ms);
@@ -790,7 +887,7 @@ bool CrashpadClient::RegisterWerModule(const std::wstring& path) {
   // We cannot point (*context).exception_pointers to our pointers yet as it
   // might get used for other non-crash dumps.
   g_wer_registration.crashpad_exception_info =
-      &g_non_crash_exception_information;
+      g_non_crash_exception_information_ptr;
   // we can point these as we are the only users.
   g_wer_registration.pointers.ExceptionRecord = &g_wer_registration.exception;
   g_wer_registration.pointers.ContextRecord = &g_wer_registration.context;
@@ -832,8 +929,8 @@ void CrashpadClient::DumpWithoutCrashWithException(EXCEPTION_POINTERS* pointer)
   //exception_pointers.ContextRecord = const_cast<CONTEXT*>(&context);
 
   //In this case we don't want to mock fake EXCEPTION_POINTER.
-  g_non_crash_exception_information.thread_id = GetCurrentThreadId();
-  g_non_crash_exception_information.exception_pointers =
+  g_non_crash_exception_information_ptr->thread_id = GetCurrentThreadId();
+  g_non_crash_exception_information_ptr->exception_pointers =
       FromPointerCast<WinVMAddress>(&exception_pointers);
 
   // If the first chance handler exists and returns true (handled), we finish
@@ -890,9 +987,8 @@ void CrashpadClient::DumpWithoutCrash(const CONTEXT& context) {
   // https://msdn.microsoft.com/library/aa363082.aspx have some of the top
   // nibble set, so we make sure to pick a value that doesn't, so as to be
   // unlikely to conflict.
-  constexpr uint32_t kSimulatedExceptionCode = 0x517a7ed;
   EXCEPTION_RECORD record = {};
-  record.ExceptionCode = kSimulatedExceptionCode;
+  record.ExceptionCode = ExceptionCodes::kSimulatedExceptionCode;
   record.ExceptionAddress = ProgramCounterFromCONTEXT(&context);
 
   exception_pointers.ExceptionRecord = &record;
@@ -903,8 +999,8 @@ void CrashpadClient::DumpWithoutCrash(const CONTEXT& context) {
     return;
   }
 
-  g_non_crash_exception_information.thread_id = GetCurrentThreadId();
-  g_non_crash_exception_information.exception_pointers =
+  g_non_crash_exception_information_ptr->thread_id = GetCurrentThreadId();
+  g_non_crash_exception_information_ptr->exception_pointers =
       FromPointerCast<WinVMAddress>(&exception_pointers);
 
   g_wer_registration.in_dump_without_crashing = true;
@@ -121,7 +121,14 @@ CrashpadInfo::CrashpadInfo()
       extra_memory_ranges_(nullptr),
       simple_annotations_(nullptr),
       user_data_minidump_stream_head_(nullptr),
-      annotations_list_(nullptr) {}
+      annotations_list_(nullptr),
+      stack_capture_limit_(0),
+      stack_frame_window_size_(0),
+      thread_annotation_lists_head_(nullptr),
+      gather_thread_float_contexts_(TriState::kUnset),
+      padding_2_(),
+      padding_3_(0),
+      extra_memory_ranges_count_(SimpleAddressRangeBag::num_entries) {}
 
 void CrashpadInfo::AddUserDataMinidumpStream(uint32_t stream_type,
                                              const void* data,
@@ -135,4 +142,10 @@ void CrashpadInfo::AddUserDataMinidumpStream(uint32_t stream_type,
   user_data_minidump_stream_head_ = to_be_added;
 }
 
+void CrashpadInfo::AddThreadAnnotationList(
+    internal::ThreadAnnotationListEntry* entry) {
+  entry->next = FromPointerCast<uint64_t>(thread_annotation_lists_head_);
+  thread_annotation_lists_head_ = entry;
+}
+
 }  // namespace crashpad
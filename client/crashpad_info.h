@@ -21,6 +21,7 @@
 #include "client/annotation_list.h"
 #include "client/simple_address_range_bag.h"
 #include "client/simple_string_dictionary.h"
+#include "client/sorted_address_range_bag.h"
 #include "util/misc/tri_state.h"
 
 #if BUILDFLAG(IS_WIN)
@@ -54,6 +55,22 @@ struct UserDataMinidumpStreamListEntry {
   uint32_t stream_type;
 };
 
+//! \brief A linked list of per-thread annotation lists, with addresses stored
+//!     as uint64_t to simplify reading from the handler process.
+//!
+//! \sa AnnotationList::ForCurrentThread()
+struct ThreadAnnotationListEntry {
+  //! \brief The address of the next entry in the linked list.
+  uint64_t next;
+
+  //! \brief The ID of the thread that owns the list at \a annotations_list,
+  //!     or `0` if the entry is not in use by any thread.
+  uint64_t thread_id;
+
+  //! \brief The address of the thread’s AnnotationList.
+  uint64_t annotations_list;
+};
+
 }  // namespace internal
 
 //! \brief A structure that can be used by a Crashpad-enabled program to
@@ -87,6 +104,29 @@ struct CrashpadInfo {
   //!     valid while it is in effect for a CrashpadInfo object.
   void set_extra_memory_ranges(SimpleAddressRangeBag* address_range_bag) {
     extra_memory_ranges_ = address_range_bag;
+    extra_memory_ranges_count_ = SimpleAddressRangeBag::num_entries;
+  }
+
+  //! rief Sets the bag of extra memory ranges to be included in the snapshot.
+  //!
+  //! This is the same as the other overload of this method, but accepts a
+  //! TSortedAddressRangeBag, which is better suited to registering many ranges
+  //! that change often.
+  //!
+  //! Handlers that predate TSortedAddressRangeBag only read the first
+  //! SimpleAddressRangeBag::num_entries ranges from \a address_range_bag.
+  //!
+  //! TODO(scottmg) This is currently only supported on Windows.
+  //!
+  //! \param[in] address_range_bag A bag of address ranges. The CrashpadInfo
+  //!     object does not take ownership of the TSortedAddressRangeBag object.
+  //!     It is the caller’s responsibility to ensure that this pointer remains
+  //!     valid while it is in effect for a CrashpadInfo object.
+  template <size_t NumEntries>
+  void set_extra_memory_ranges(
+      TSortedAddressRangeBag<NumEntries>* address_range_bag) {
+    extra_memory_ranges_ = address_range_bag;
+    extra_memory_ranges_count_ = NumEntries;
   }
 
   //! \brief Sets the simple annotations dictionary.
@@ -143,6 +183,26 @@ struct CrashpadInfo {
   //! \sa AnnotationList::Register()
   AnnotationList* annotations_list() const { return annotations_list_; }
 
+  //! \brief Adds an entry to the list of per-thread annotation lists.
+  //!
+  //! This method does not need to be called by clients directly.
+  //! AnnotationList::ForCurrentThread() will do so, and will reuse entries once
+  //! the threads that used them have exited. Entries are never removed.
+  //!
+  //! \param[in] entry The entry to add. The CrashpadInfo object does not take
+  //!     ownership of it, and it must remain valid for the lifetime of the
+  //!     CrashpadInfo object.
+  //!
+  //! \sa thread_annotation_lists()
+  void AddThreadAnnotationList(internal::ThreadAnnotationListEntry* entry);
+
+  //! \return The first entry in the list of per-thread annotation lists.
+  //!
+  //! \sa AddThreadAnnotationList()
+  internal::ThreadAnnotationListEntry* thread_annotation_lists() const {
+    return thread_annotation_lists_head_;
+  }
+
   //! \brief Enables or disables Crashpad handler processing.
   //!
   //! When handling an exception, the Crashpad handler will scan all modules in
@@ -204,6 +264,59 @@ struct CrashpadInfo {
     indirectly_referenced_memory_cap_ = limit;
   }
 
+  //! \brief Limits how much of each thread’s stack is captured in the
+  //!     minidump.
+  //!
+  //! When handling an exception, the Crashpad handler will scan all modules in
+  //! a process. The first one that has a CrashpadInfo structure populated with
+  //! a nonzero \a limit will dictate how stacks are captured.
+  //!
+  //! A thread’s stack is normally captured from its stack pointer to the end of
+  //! its stack region. Threads with very deep or very large stacks can make a
+  //! minidump large and slow to write and upload. When a stack region is larger
+  //! than \a limit, only the \a limit bytes starting at the stack pointer are
+  //! captured. If \a frame_window_size is nonzero, the frame pointer chain is
+  //! then followed through the rest of the stack, and \a frame_window_size
+  //! bytes are captured starting at each frame record found, so that the
+  //! outermost frames can still be recovered. Threads whose stacks were
+  //! truncated are listed in a ::kMinidumpStreamTypeCrashpadStackTruncation
+  //! stream.
+  //!
+  //! This is currently only honored on Linux, ChromeOS, and Android.
+  //!
+  //! \param[in] limit The maximum number of bytes of each thread’s stack to
+  //!     capture, or `0` for no limit.
+  //! \param[in] frame_window_size The number of bytes to capture at each frame
+  //!     record beyond \a limit, or `0` to capture nothing beyond \a limit.
+  void set_stack_capture_limit(uint32_t limit, uint32_t frame_window_size) {
+    stack_capture_limit_ = limit;
+    stack_frame_window_size_ = frame_window_size;
+  }
+
+  //! \brief Enables or disables capturing the floating-point and vector
+  //!     registers of threads other than the one that crashed.
+  //!
+  //! When handling an exception, the Crashpad handler will scan all modules in
+  //! a process. The first one that has a CrashpadInfo structure populated with
+  //! a value other than TriState::kUnset for this field will dictate whether
+  //! these registers are captured.
+  //!
+  //! Most threads are usually blocked waiting for something, and their
+  //! floating-point and vector registers are rarely useful. When this is
+  //! TriState::kDisabled, only the general-purpose registers of those threads
+  //! are captured, and their floating-point and vector registers appear as
+  //! zero. The thread that raised the exception always has all of its
+  //! registers captured. If all modules with CrashpadInfo structures specify
+  //! TriState::kUnset, all registers of all threads are captured.
+  //!
+  //! This is currently only honored on Linux, ChromeOS, and Android.
+  //!
+  //! \param[in] gather_thread_float_contexts Whether to capture the
+  //!     floating-point and vector registers of all threads.
+  void set_gather_thread_float_contexts(TriState gather_thread_float_contexts) {
+    gather_thread_float_contexts_ = gather_thread_float_contexts;
+  }
+
   //! \brief Adds a custom stream to the minidump.
   //!
   //! The memory block referenced by \a data and \a size will added to the
@@ -258,10 +371,20 @@ struct CrashpadInfo {
   TriState system_crash_reporter_forwarding_;
   TriState gather_indirectly_referenced_memory_;
   uint8_t padding_1_;
-  SimpleAddressRangeBag* extra_memory_ranges_;  // weak
+  void* extra_memory_ranges_;  // weak
   SimpleStringDictionary* simple_annotations_;  // weak
   internal::UserDataMinidumpStreamListEntry* user_data_minidump_stream_head_;
   AnnotationList* annotations_list_;  // weak
+  uint32_t stack_capture_limit_;
+  uint32_t stack_frame_window_size_;
+  internal::ThreadAnnotationListEntry* thread_annotation_lists_head_;
+  TriState gather_thread_float_contexts_;
+  uint8_t padding_2_[3];
+
+  // padding_3_ ensures that size_ grows to include extra_memory_ranges_count_
+  // on 64-bit platforms, rather than placing it in trailing padding.
+  uint32_t padding_3_;
+  uint32_t extra_memory_ranges_count_;
 
   // It’s generally safe to add new fields without changing
   // kCrashpadInfoVersion, because readers should check size_ and ignore fields
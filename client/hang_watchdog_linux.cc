@@ -0,0 +1,170 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "client/hang_watchdog_linux.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdint.h>
+
+#include <limits>
+
+#include "base/logging.h"
+#include "client/crashpad_client.h"
+#include "third_party/lss/lss.h"
+#include "util/linux/exception_handler_client.h"
+#include "util/linux/exception_handler_protocol.h"
+#include "util/misc/clock.h"
+#include "util/numeric/in_range_cast.h"
+
+namespace crashpad {
+
+namespace {
+
+using HangWatchdogRegion = ExceptionHandlerProtocol::HangWatchdogRegion;
+using HangWatchdogThread = ExceptionHandlerProtocol::HangWatchdogThread;
+
+// Frees the calling thread’s entry in the HangWatchdogRegion when the thread
+// exits, so that a thread that has exited isn’t reported as hung.
+class WatchedThreadOwner {
+ public:
+  WatchedThreadOwner() : thread_(nullptr) {}
+
+  WatchedThreadOwner(const WatchedThreadOwner&) = delete;
+  WatchedThreadOwner& operator=(const WatchedThreadOwner&) = delete;
+
+  ~WatchedThreadOwner() { Free(); }
+
+  HangWatchdogThread* thread() const { return thread_; }
+
+  void Set(HangWatchdogThread* thread) { thread_ = thread; }
+
+  void Free() {
+    if (thread_) {
+      __atomic_store_n(
+          &thread_->state, HangWatchdogThread::kStateFree, __ATOMIC_RELEASE);
+      thread_ = nullptr;
+    }
+  }
+
+  // After a fork, the entry belongs to the parent.
+  void Forget() { thread_ = nullptr; }
+
+ private:
+  HangWatchdogThread* thread_;
+};
+
+thread_local WatchedThreadOwner watched_thread;
+
+}  // namespace
+
+HangWatchdog::HangWatchdog() : region_() {}
+
+// static
+HangWatchdog* HangWatchdog::Get() {
+  static HangWatchdog* instance = new HangWatchdog();
+  return instance;
+}
+
+bool HangWatchdog::Initialize() {
+  if (region_.is_valid()) {
+    return true;
+  }
+
+  int sock;
+  if (!CrashpadClient::GetHandlerSocket(&sock, nullptr)) {
+    LOG(ERROR) << "no handler";
+    return false;
+  }
+
+  ExceptionHandlerClient client(sock, true);
+  if (!client.RegisterHangWatchdogRegion(&region_)) {
+    return false;
+  }
+
+  static int atfork_result = pthread_atfork(nullptr, nullptr, AtForkChild);
+  if (atfork_result != 0) {
+    errno = atfork_result;
+    PLOG(WARNING) << "pthread_atfork";
+  }
+  return true;
+}
+
+bool HangWatchdog::WatchCurrentThread(double timeout) {
+  if (!region_.is_valid()) {
+    LOG(ERROR) << "not initialized";
+    return false;
+  }
+
+  const uint32_t timeout_ms = InRangeCast<uint32_t>(
+      timeout * 1E3, std::numeric_limits<uint32_t>::max());
+
+  if (HangWatchdogThread* thread = watched_thread.thread()) {
+    __atomic_store_n(&thread->timeout_ms, timeout_ms, __ATOMIC_RELAXED);
+    Heartbeat();
+    return true;
+  }
+
+  for (HangWatchdogThread& thread :
+       region_.addr_as<HangWatchdogRegion*>()->threads) {
+    int32_t state = HangWatchdogThread::kStateFree;
+    if (!__atomic_compare_exchange_n(&thread.state,
+                                     &state,
+                                     HangWatchdogThread::kStateClaimed,
+                                     false,
+                                     __ATOMIC_ACQUIRE,
+                                     __ATOMIC_RELAXED)) {
+      continue;
+    }
+
+    thread.thread_id = sys_gettid();
+    thread.timeout_ms = timeout_ms;
+    thread.blocking_thread_id = 0;
+    thread.heartbeat_ns = ClockMonotonicNanoseconds();
+    __atomic_store_n(
+        &thread.state, HangWatchdogThread::kStateWatched, __ATOMIC_RELEASE);
+    watched_thread.Set(&thread);
+    return true;
+  }
+
+  LOG(ERROR) << "too many watched threads";
+  return false;
+}
+
+void HangWatchdog::UnwatchCurrentThread() {
+  watched_thread.Free();
+}
+
+void HangWatchdog::Heartbeat() {
+  if (HangWatchdogThread* thread = watched_thread.thread()) {
+    __atomic_store_n(
+        &thread->heartbeat_ns, ClockMonotonicNanoseconds(), __ATOMIC_RELAXED);
+  }
+}
+
+void HangWatchdog::SetBlockingThread(pid_t thread_id) {
+  if (HangWatchdogThread* thread = watched_thread.thread()) {
+    __atomic_store_n(&thread->blocking_thread_id, thread_id, __ATOMIC_RELAXED);
+  }
+}
+
+// static
+void HangWatchdog::AtForkChild() {
+  // The region is shared with the parent, which registered it. The only thread
+  // in the child is the one that forked.
+  watched_thread.Forget();
+  Get()->region_.Reset();
+}
+
+}  // namespace crashpad
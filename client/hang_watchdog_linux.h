@@ -0,0 +1,99 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_CLIENT_HANG_WATCHDOG_LINUX_H_
+#define CRASHPAD_CLIENT_HANG_WATCHDOG_LINUX_H_
+
+#include <sys/types.h>
+
+#include "util/posix/scoped_mmap.h"
+
+namespace crashpad {
+
+//! \brief Lets the handler watch threads of this process for hangs.
+//!
+//! A watched thread calls Heartbeat() regularly, such as each time around its
+//! event loop. If a handler started with `--hang-poll-interval` finds that a
+//! watched thread has gone longer than its timeout without a heartbeat, it
+//! writes a reduced crash report for this process without an exception. The
+//! report has the contexts of every thread, but only the stacks of the hung
+//! thread and of the thread it is waiting for, if set with
+//! SetBlockingThread(), along with the modules and annotations. The IDs of the
+//! threads whose stacks were captured are in its `hang-thread-ids` annotation.
+//!
+//! Heartbeats are recorded in memory shared with the handler, so that a
+//! heartbeat is only a clock read and a store, without a system call or a
+//! message to the handler.
+class HangWatchdog {
+ public:
+  HangWatchdog(const HangWatchdog&) = delete;
+  HangWatchdog& operator=(const HangWatchdog&) = delete;
+
+  //! \brief Returns the process’ watchdog.
+  static HangWatchdog* Get();
+
+  //! \brief Registers the watchdog with the handler.
+  //!
+  //! This must be called after CrashpadClient::StartHandler(),
+  //! CrashpadClient::SetHandlerSocket(), or CrashpadClient::SetHandlerDaemon()
+  //! has connected this process to a handler, and before any thread is
+  //! watched. A child forked from this process must call it again to have its
+  //! own threads watched.
+  //!
+  //! \return `true` on success. Otherwise, `false` with a message logged.
+  bool Initialize();
+
+  //! \brief Starts watching the calling thread for hangs.
+  //!
+  //! The thread is considered hung once \a timeout seconds have passed since
+  //! this call or its last call to Heartbeat(). It stops being watched when it
+  //! calls UnwatchCurrentThread() or exits. Calling this again for a thread
+  //! that is already watched changes its timeout.
+  //!
+  //! \return `true` on success. Otherwise, `false` with a message logged, as
+  //!     when Initialize() hasn’t succeeded or too many threads are already
+  //!     being watched.
+  bool WatchCurrentThread(double timeout);
+
+  //! \brief Stops watching the calling thread for hangs.
+  void UnwatchCurrentThread();
+
+  //! \brief Records that the calling thread is making progress.
+  //!
+  //! This does nothing if the calling thread isn’t watched. It is
+  //! async-signal-safe.
+  void Heartbeat();
+
+  //! \brief Sets the thread that the calling thread is waiting for.
+  //!
+  //! If the calling thread is found to be hung, the stack of \a thread_id is
+  //! captured along with its own. A thread about to wait for a lock may set its
+  //! holder here, and set `0` once it has the lock.
+  //!
+  //! This does nothing if the calling thread isn’t watched. It is
+  //! async-signal-safe.
+  void SetBlockingThread(pid_t thread_id);
+
+ private:
+  HangWatchdog();
+  ~HangWatchdog() = delete;
+
+  static void AtForkChild();
+
+  ScopedMmap region_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_CLIENT_HANG_WATCHDOG_LINUX_H_
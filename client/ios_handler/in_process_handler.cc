@@ -18,10 +18,12 @@
 #include <sys/stat.h>
 
 #include <algorithm>
+#include <memory>
 
 #include "base/cxx17_backports.h"
 #include "base/logging.h"
 #include "client/ios_handler/in_process_intermediate_dump_handler.h"
+#include "client/ios_handler/module_info_cache.h"
 #include "client/prune_crash_reports.h"
 #include "client/settings.h"
 #include "minidump/minidump_file_writer.h"
@@ -50,6 +52,11 @@ constexpr char kLockedExtension[] = ".locked";
 // uuid in the intermediate dump file name.
 constexpr char kBundleSeperator[] = "@";
 
+// The size of the arena that memory is copied into while writing a report.
+// This is enough for the modules, annotations and most thread stacks of a
+// typical application. Anything that doesn’t fit is read with vm_read instead.
+constexpr size_t kVMReadArenaSize = 2 * 1024 * 1024;
+
 // Zero-ed codes used by kMachExceptionFromNSException and
 // kMachExceptionSimulated.
 constexpr mach_exception_data_type_t kEmulatedMachExceptionCodes[2] = {};
@@ -88,7 +95,8 @@ bool InProcessHandler::Initialize(
     // See https://crashpad.chromium.org/bug/23.
     CrashReportUploadThread::Options upload_thread_options;
     upload_thread_options.rate_limit = false;
-    upload_thread_options.upload_gzip = true;
+    upload_thread_options.upload_compression =
+        HTTPMultipartBuilder::Compression::kGzip;
     upload_thread_options.watch_pending_reports = true;
     upload_thread_options.identify_client_via_url = true;
 
@@ -104,6 +112,10 @@ bool InProcessHandler::Initialize(
   if (!CreateDirectory(base_dir_))
     return false;
 
+  // Do as much of the work of reporting a crash as possible ahead of time.
+  ScopedVMReadArena::Initialize(kVMReadArenaSize);
+  ModuleInfoCache::Start();
+
   bool is_app_extension = system_data_.IsExtension();
   prune_thread_.reset(new PruneIntermediateDumpsAndCrashReportsThread(
       database_.get(),
@@ -258,17 +270,48 @@ void InProcessHandler::ProcessIntermediateDumps(
     const std::map<std::string, std::string>& annotations) {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
 
+  // Dumps from the same session mostly have the same modules, which are then
+  // read once for the batch.
+  ModuleSnapshotCacheIOSIntermediateDump module_cache;
   for (auto& file : PendingFiles())
-    ProcessIntermediateDump(file, annotations);
+    ProcessIntermediateDump(file, annotations, &module_cache);
+}
+
+void InProcessHandler::ProcessIntermediateDumpsInBackground(
+    const std::map<std::string, std::string>& annotations) {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+
+  // Most launches have nothing to convert, so don’t start a thread for them.
+  if (!HasPendingFiles())
+    return;
+
+  base::AutoLock lock_owner(prune_and_upload_lock_);
+  if (process_thread_ && process_thread_->is_running())
+    process_thread_->Stop();
+  auto module_cache =
+      std::make_shared<ModuleSnapshotCacheIOSIntermediateDump>();
+  process_thread_.reset(new ProcessIntermediateDumpsThread(
+      [this]() { return PendingFiles(); },
+      [this, annotations, module_cache](const base::FilePath& file) {
+        ProcessIntermediateDump(file, annotations, module_cache.get());
+      }));
+
+  // As with the prune thread, don’t touch the shared intermediate dump
+  // directory while in the background. UpdatePruneAndUploadThreads() starts
+  // the thread once the application becomes active.
+  if (system_data_.IsExtension() || system_data_.IsApplicationActive())
+    process_thread_->Start();
 }
 
 void InProcessHandler::ProcessIntermediateDump(
     const base::FilePath& file,
-    const std::map<std::string, std::string>& annotations) {
+    const std::map<std::string, std::string>& annotations,
+    ModuleSnapshotCacheIOSIntermediateDump* module_cache) {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
 
   ProcessSnapshotIOSIntermediateDump process_snapshot;
-  if (process_snapshot.InitializeWithFilePath(file, annotations)) {
+  if (process_snapshot.InitializeWithFilePath(
+          file, annotations, module_cache)) {
     SaveSnapshot(process_snapshot);
   }
 }
@@ -309,12 +352,16 @@ void InProcessHandler::UpdatePruneAndUploadThreads(
   if (threads_should_run) {
     if (!prune_thread_->is_running())
       prune_thread_->Start();
+    if (process_thread_ && !process_thread_->is_running())
+      process_thread_->Start();
     if (upload_thread_enabled_ && !upload_thread_->is_running()) {
       upload_thread_->Start();
     }
   } else {
     if (prune_thread_->is_running())
       prune_thread_->Stop();
+    if (process_thread_ && process_thread_->is_running())
+      process_thread_->Stop();
     if (upload_thread_enabled_ && upload_thread_->is_running())
       upload_thread_->Stop();
   }
@@ -376,25 +423,13 @@ std::vector<base::FilePath> InProcessHandler::PendingFiles() {
   // intermediate dumps into never getting processed.
   std::vector<base::FilePath> other_files;
 
-  base::FilePath cached_writer_path(cached_writer_path_);
   while ((result = reader.NextFile(&file)) ==
          DirectoryReader::Result::kSuccess) {
-    // Don't try to process files marked as 'locked' from a different bundle id.
-    bool bundle_match =
-        file.value().compare(0,
-                             bundle_identifier_and_seperator_.size(),
-                             bundle_identifier_and_seperator_) == 0;
-    if (!bundle_match && file.FinalExtension() == kLockedExtension) {
+    bool bundle_match;
+    if (!IsPendingFile(file, &bundle_match))
       continue;
-    }
 
-    // Never process the current cached writer path.
     file = base_dir_.Append(file);
-    if (file == cached_writer_path)
-      continue;
-
-    // Otherwise, include any other unlocked, or locked files matching
-    // |bundle_identifier_and_seperator_|.
     if (bundle_match) {
       files.push_back(file);
       if (files.size() >= kMaxPendingFiles)
@@ -411,6 +446,35 @@ std::vector<base::FilePath> InProcessHandler::PendingFiles() {
   return files;
 }
 
+bool InProcessHandler::HasPendingFiles() {
+  DirectoryReader reader;
+  if (!reader.Open(base_dir_)) {
+    return false;
+  }
+  base::FilePath file;
+  bool bundle_match;
+  while (reader.NextFile(&file) == DirectoryReader::Result::kSuccess) {
+    if (IsPendingFile(file, &bundle_match))
+      return true;
+  }
+  return false;
+}
+
+bool InProcessHandler::IsPendingFile(const base::FilePath& file,
+                                     bool* bundle_match) {
+  // Don't try to process files marked as 'locked' from a different bundle id.
+  *bundle_match = file.value().compare(0,
+                                       bundle_identifier_and_seperator_.size(),
+                                       bundle_identifier_and_seperator_) == 0;
+  if (!*bundle_match && file.FinalExtension() == kLockedExtension) {
+    return false;
+  }
+
+  // Never process the current cached writer path. Otherwise, include any other
+  // unlocked, or locked files matching |bundle_identifier_and_seperator_|.
+  return base_dir_.Append(file).value() != cached_writer_path_;
+}
+
 IOSIntermediateDumpWriter* InProcessHandler::GetCachedWriter() {
   static_assert(
       std::atomic<uint64_t>::is_always_lock_free,
@@ -464,7 +528,8 @@ InProcessHandler::ScopedReport::ScopedReport(
     const std::map<std::string, std::string>& annotations,
     const uint64_t* frames,
     const size_t num_frames)
-    : writer_(writer),
+    : vm_read_arena_(),
+      writer_(writer),
       frames_(frames),
       num_frames_(num_frames),
       rootMap_(writer) {
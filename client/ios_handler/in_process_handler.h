@@ -23,12 +23,15 @@
 
 #include "base/files/file_path.h"
 #include "base/synchronization/lock.h"
+#include "client/ios_handler/process_intermediate_dumps_thread.h"
 #include "client/ios_handler/prune_intermediate_dumps_and_crash_reports_thread.h"
 #include "client/upload_behavior_ios.h"
 #include "handler/crash_report_upload_thread.h"
+#include "snapshot/ios/module_snapshot_cache_ios_intermediate_dump.h"
 #include "snapshot/ios/process_snapshot_ios_intermediate_dump.h"
 #include "util/ios/ios_intermediate_dump_writer.h"
 #include "util/ios/ios_system_data_collector.h"
+#include "util/ios/scoped_vm_read.h"
 #include "util/misc/capture_context.h"
 #include "util/misc/initialization_state_dcheck.h"
 
@@ -158,18 +161,37 @@ class InProcessHandler {
   //! \brief Requests that the handler convert all intermediate dumps into
   //!     minidumps and trigger an upload if possible.
   //!
+  //! The dumps are converted as a batch, in which modules that are the same
+  //! as in the dump converted before are read only once.
+  //!
   //! \param[in] annotations Process annotations to set in each crash report.
   void ProcessIntermediateDumps(
       const std::map<std::string, std::string>& annotations);
 
+  //! \brief Requests that the handler convert all intermediate dumps into
+  //!     minidumps on a low-priority background thread, one dump at a time.
+  //!
+  //! Only a quick check for pending intermediate dumps is made on the calling
+  //! thread. The conversion is paused while the application is inactive, and
+  //! is limited to a time budget, after which any remaining dumps are left for
+  //! a later call. As with ProcessIntermediateDumps(), modules are shared
+  //! among the dumps converted.
+  //!
+  //! \param[in] annotations Process annotations to set in each crash report.
+  void ProcessIntermediateDumpsInBackground(
+      const std::map<std::string, std::string>& annotations);
+
   //! \brief Requests that the handler convert a specific intermediate dump into
   //!     a minidump and trigger an upload if possible.
   //!
   //! \param[in] path Path to the specific intermediate dump.
   //! \param[in] annotations Process annotations to set in each crash report.
+  //! \param[in] module_cache If not `nullptr`, shares module snapshots with
+  //!     the other intermediate dumps converted with it.
   void ProcessIntermediateDump(
       const base::FilePath& path,
-      const std::map<std::string, std::string>& annotations = {});
+      const std::map<std::string, std::string>& annotations = {},
+      ModuleSnapshotCacheIOSIntermediateDump* module_cache = nullptr);
 
   //! \brief Requests that the handler begin in-process uploading of any
   //!     pending reports.
@@ -200,6 +222,9 @@ class InProcessHandler {
     ScopedReport& operator=(const ScopedReport&) = delete;
 
    private:
+    // Declared first so that it is available for the whole report, including
+    // the threads and modules written by the destructor.
+    ScopedVMReadArena vm_read_arena_;
     IOSIntermediateDumpWriter* writer_;
     const uint64_t* frames_;
     const size_t num_frames_;
@@ -245,6 +270,17 @@ class InProcessHandler {
   //!     with our bundle id get first priority to prevent spamming.
   std::vector<base::FilePath> PendingFiles();
 
+  //! \brief Returns `true` if PendingFiles() would return any files, stopping
+  //!     at the first one found.
+  bool HasPendingFiles();
+
+  //! \brief Returns `true` if \a file, in base_dir_, may be processed.
+  //!
+  //! \param[in] file The name of the file, relative to base_dir_.
+  //! \param[out] bundle_match Set to `true` if \a file was written by this
+  //!     client, `false` otherwise.
+  bool IsPendingFile(const base::FilePath& file, bool* bundle_match);
+
   //! \brief Lock access to the cached intermediate dump writer from
   //!     concurrent signal, Mach exception and uncaught NSExceptions so that
   //!     the first exception wins. If the same thread triggers another
@@ -265,7 +301,8 @@ class InProcessHandler {
   // in DumpExceptionFromMachException after aquiring the cached_writer_.
   void (*mach_exception_callback_for_testing_)() = nullptr;
 
-  // Used to synchronize access to UpdatePruneAndUploadThreads().
+  // Used to synchronize access to UpdatePruneAndUploadThreads() and
+  // process_thread_.
   base::Lock prune_and_upload_lock_;
   std::atomic_bool upload_thread_enabled_ = false;
   std::map<std::string, std::string> annotations_;
@@ -276,6 +313,7 @@ class InProcessHandler {
   std::atomic<uint64_t> exception_thread_id_ = 0;
   std::unique_ptr<CrashReportUploadThread> upload_thread_;
   std::unique_ptr<PruneIntermediateDumpsAndCrashReportsThread> prune_thread_;
+  std::unique_ptr<ProcessIntermediateDumpsThread> process_thread_;
   std::unique_ptr<CrashReportDatabase> database_;
   std::string bundle_identifier_and_seperator_;
   IOSSystemDataCollector system_data_;
@@ -24,6 +24,7 @@
 #include <iterator>
 
 #include "build/build_config.h"
+#include "client/ios_handler/module_info_cache.h"
 #include "snapshot/snapshot_constants.h"
 #include "util/ios/ios_intermediate_dump_writer.h"
 #include "util/ios/raw_logging.h"
@@ -470,10 +471,14 @@ void WriteCrashpadSimpleAnnotationsDictionary(IOSIntermediateDumpWriter* writer,
   SimpleStringDictionary::Entry* entries =
       reinterpret_cast<SimpleStringDictionary::Entry*>(
           simple_annotations.get());
-  for (size_t index = 0; index < count; index++) {
-    IOSIntermediateDumpWriter::ScopedArrayMap annotation_map(writer);
+  // Active entries may be anywhere in the dictionary’s storage.
+  for (size_t index = 0; index < SimpleStringDictionary::num_entries;
+       index++) {
     const auto& entry = entries[index];
     size_t key_length = strnlen(entry.key, sizeof(entry.key));
+    if (!key_length)
+      continue;
+    IOSIntermediateDumpWriter::ScopedArrayMap annotation_map(writer);
     WritePropertyBytes(writer,
                        IntermediateDumpKey::kAnnotationName,
                        reinterpret_cast<const void*>(entry.key),
@@ -911,6 +916,7 @@ void InProcessIntermediateDumpHandler::WriteModuleInfo(
 
   uint32_t image_count = image_infos->infoArrayCount;
   const dyld_image_info* image_array = image_infos->infoArray;
+  size_t cache_hint = 0;
   for (uint32_t image_index = 0; image_index < image_count; ++image_index) {
     IOSIntermediateDumpWriter::ScopedArrayMap modules(writer);
     ScopedVMRead<dyld_image_info> image;
@@ -927,7 +933,14 @@ void InProcessIntermediateDumpHandler::WriteModuleInfo(
     WriteProperty(writer, IntermediateDumpKey::kAddress, &address);
     WriteProperty(
         writer, IntermediateDumpKey::kTimestamp, &image->imageFileModDate);
-    WriteModuleInfoAtAddress(writer, address, false /*is_dyld=false*/);
+
+    // Most modules’ load commands were read when they were loaded.
+    ModuleInfoCache::ModuleInfo module_info;
+    if (ModuleInfoCache::Find(address, &cache_hint, &module_info)) {
+      WriteModuleLoadCommandInfo(writer, module_info);
+    } else {
+      WriteModuleInfoAtAddress(writer, address, false /*is_dyld=false*/);
+    }
   }
 
   {
@@ -1065,85 +1078,56 @@ void InProcessIntermediateDumpHandler::WriteModuleInfoAtAddress(
     return;
   }
 
-  // All the *_vm_read_ptr variables in the load_command loop below have been
-  // vm_read in `all_commands` above, and may be dereferenced without additional
-  // ScopedVMReads.
-  const load_command* command_vm_read_ptr =
-      reinterpret_cast<const load_command*>(all_commands.get());
-
-  // Make sure that the basic load command structure doesn’t overflow the
-  // space allotted for load commands, as well as iterating through ncmds.
-  vm_size_t slide = 0;
-  for (uint32_t cmd_index = 0, cumulative_cmd_size = 0;
-       cmd_index < header->ncmds && cumulative_cmd_size < header->sizeofcmds;
-       ++cmd_index) {
-    if (command_vm_read_ptr->cmd == LC_SEGMENT_64) {
-      const segment_command_64* segment_vm_read_ptr =
-          reinterpret_cast<const segment_command_64*>(command_vm_read_ptr);
-      if (strcmp(segment_vm_read_ptr->segname, SEG_TEXT) == 0) {
-        WriteProperty(
-            writer, IntermediateDumpKey::kSize, &segment_vm_read_ptr->vmsize);
-        slide = address - segment_vm_read_ptr->vmaddr;
-      } else if (strcmp(segment_vm_read_ptr->segname, SEG_DATA) == 0) {
-        WriteDataSegmentAnnotations(writer, segment_vm_read_ptr, slide);
-      }
-    } else if (command_vm_read_ptr->cmd == LC_ID_DYLIB) {
-      const dylib_command* dylib_vm_read_ptr =
-          reinterpret_cast<const dylib_command*>(command_vm_read_ptr);
-      WriteProperty(writer,
-                    IntermediateDumpKey::kDylibCurrentVersion,
-                    &dylib_vm_read_ptr->dylib.current_version);
-    } else if (command_vm_read_ptr->cmd == LC_SOURCE_VERSION) {
-      const source_version_command* source_version_vm_read_ptr =
-          reinterpret_cast<const source_version_command*>(command_vm_read_ptr);
-      WriteProperty(writer,
-                    IntermediateDumpKey::kSourceVersion,
-                    &source_version_vm_read_ptr->version);
-    } else if (command_vm_read_ptr->cmd == LC_UUID) {
-      const uuid_command* uuid_vm_read_ptr =
-          reinterpret_cast<const uuid_command*>(command_vm_read_ptr);
-      WriteProperty(
-          writer, IntermediateDumpKey::kUUID, &uuid_vm_read_ptr->uuid);
-    }
-
-    cumulative_cmd_size += command_vm_read_ptr->cmdsize;
-    command_vm_read_ptr = reinterpret_cast<const load_command*>(
-        reinterpret_cast<const uint8_t*>(command_vm_read_ptr) +
-        command_vm_read_ptr->cmdsize);
+  ModuleInfoCache::ModuleInfo module_info;
+  if (ModuleInfoCache::Parse(
+          header.get(),
+          reinterpret_cast<const load_command*>(all_commands.get()),
+          address,
+          &module_info)) {
+    WriteModuleLoadCommandInfo(writer, module_info);
   }
-
-  WriteProperty(writer, IntermediateDumpKey::kFileType, &header->filetype);
 }
 
-void InProcessIntermediateDumpHandler::WriteDataSegmentAnnotations(
+void InProcessIntermediateDumpHandler::WriteModuleLoadCommandInfo(
     IOSIntermediateDumpWriter* writer,
-    const segment_command_64* segment_vm_read_ptr,
-    vm_size_t slide) {
-  const section_64* section_vm_read_ptr = reinterpret_cast<const section_64*>(
-      reinterpret_cast<uint64_t>(segment_vm_read_ptr) +
-      sizeof(segment_command_64));
-  for (uint32_t sect_index = 0; sect_index <= segment_vm_read_ptr->nsects;
-       ++sect_index) {
-    if (strcmp(section_vm_read_ptr->sectname, "crashpad_info") == 0) {
-      ScopedVMRead<CrashpadInfo> crashpad_info;
-      if (crashpad_info.Read(section_vm_read_ptr->addr + slide) &&
-          crashpad_info->size() == sizeof(CrashpadInfo) &&
-          crashpad_info->signature() == CrashpadInfo::kSignature &&
-          crashpad_info->version() == 1) {
-        WriteCrashpadAnnotationsList(writer, crashpad_info.get());
-        WriteCrashpadSimpleAnnotationsDictionary(writer, crashpad_info.get());
-      }
-    } else if (strcmp(section_vm_read_ptr->sectname, "__crash_info") == 0) {
-      ScopedVMRead<crashreporter_annotations_t> crash_info;
-      if (!crash_info.Read(section_vm_read_ptr->addr + slide) ||
-          (crash_info->version != 4 && crash_info->version != 5)) {
-        continue;
-      }
+    const ModuleInfoCache::ModuleInfo& module_info) {
+  if (module_info.has_text_size) {
+    WriteProperty(writer, IntermediateDumpKey::kSize, &module_info.text_size);
+  }
+
+  if (module_info.crashpad_info_address) {
+    ScopedVMRead<CrashpadInfo> crashpad_info;
+    if (crashpad_info.Read(module_info.crashpad_info_address) &&
+        crashpad_info->size() == sizeof(CrashpadInfo) &&
+        crashpad_info->signature() == CrashpadInfo::kSignature &&
+        crashpad_info->version() == 1) {
+      WriteCrashpadAnnotationsList(writer, crashpad_info.get());
+      WriteCrashpadSimpleAnnotationsDictionary(writer, crashpad_info.get());
+    }
+  }
+
+  if (module_info.crash_info_address) {
+    ScopedVMRead<crashreporter_annotations_t> crash_info;
+    if (crash_info.Read(module_info.crash_info_address) &&
+        (crash_info->version == 4 || crash_info->version == 5)) {
       WriteAppleCrashReporterAnnotations(writer, crash_info.get());
     }
-    section_vm_read_ptr = reinterpret_cast<const section_64*>(
-        reinterpret_cast<uint64_t>(section_vm_read_ptr) + sizeof(section_64));
   }
+
+  if (module_info.has_dylib_current_version) {
+    WriteProperty(writer,
+                  IntermediateDumpKey::kDylibCurrentVersion,
+                  &module_info.dylib_current_version);
+  }
+  if (module_info.has_source_version) {
+    WriteProperty(writer,
+                  IntermediateDumpKey::kSourceVersion,
+                  &module_info.source_version);
+  }
+  if (module_info.has_uuid) {
+    WriteProperty(writer, IntermediateDumpKey::kUUID, &module_info.uuid);
+  }
+  WriteProperty(writer, IntermediateDumpKey::kFileType, &module_info.file_type);
 }
 
 void InProcessIntermediateDumpHandler::WriteCrashpadAnnotationsList(
@@ -1170,17 +1154,33 @@ void InProcessIntermediateDumpHandler::WriteCrashpadAnnotationsList(
        current->link_node() != annotation_list.get()->tail_pointer() &&
        index < kMaxNumberOfAnnotations;
        ++index) {
-    ScopedVMRead<Annotation> node;
-    if (!node.Read(current->link_node())) {
+    // Re-reading the same object keeps ScopedVMReadArena allocations in order.
+    if (!current.Read(current->link_node())) {
       CRASHPAD_RAW_LOG("Unable to read annotation");
       return;
     }
-    current.Read(current->link_node());
+    const Annotation* node = current.get();
+
+    const char* value = reinterpret_cast<const char*>(node->value());
+    Annotation::ValueSizeType value_size = node->size();
+    if (node->flags() & Annotation::kFlagVersioned) {
+      ScopedVMRead<VersionedAnnotationHeader> header;
+      if (!header.Read(value - sizeof(VersionedAnnotationHeader))) {
+        CRASHPAD_RAW_LOG("Unable to read annotation header");
+        continue;
+      }
+
+      uint32_t value_offset;
+      if (!header->GetValueLocation(node->size(), &value_offset, &value_size)) {
+        CRASHPAD_RAW_LOG("Invalid annotation header");
+      }
+      value += value_offset;
+    }
 
-    if (node->size() == 0)
+    if (value_size == 0)
       continue;
 
-    if (node->size() > Annotation::kValueMaxSize) {
+    if (value_size > Annotation::kValueMaxSize) {
       CRASHPAD_RAW_LOG("Incorrect annotation length");
       continue;
     }
@@ -1192,8 +1192,8 @@ void InProcessIntermediateDumpHandler::WriteCrashpadAnnotationsList(
                          reinterpret_cast<const char*>(node->name()));
     WritePropertyBytes(writer,
                        IntermediateDumpKey::kAnnotationValue,
-                       reinterpret_cast<const void*>(node->value()),
-                       node->size());
+                       reinterpret_cast<const void*>(value),
+                       value_size);
     Annotation::Type type = node->type();
     WritePropertyBytes(writer,
                        IntermediateDumpKey::kAnnotationType,
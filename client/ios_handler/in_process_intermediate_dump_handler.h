@@ -23,6 +23,7 @@
 #include <map>
 
 #include "client/crashpad_info.h"
+#include "client/ios_handler/module_info_cache.h"
 #include "util/ios/ios_intermediate_dump_writer.h"
 #include "util/ios/ios_system_data_collector.h"
 #include "util/mach/mach_extensions.h"
@@ -138,13 +139,12 @@ class InProcessIntermediateDumpHandler final {
                                        uint64_t address,
                                        bool is_dyld);
 
-  //! \brief Extract and write Apple crashreporter_annotations_t data and
-  //!     Crashpad annotations. Note that \a segment_vm_read_ptr has already
-  //!     been read via vm_read and may be dereferenced without a ScopedVMRead.
-  static void WriteDataSegmentAnnotations(
+  //! \brief Write the information from a module’s load commands, and the
+  //!     Apple crashreporter_annotations_t data and Crashpad annotations that
+  //!     they locate.
+  static void WriteModuleLoadCommandInfo(
       IOSIntermediateDumpWriter* writer,
-      const segment_command_64* segment_vm_read_ptr,
-      vm_size_t slide);
+      const ModuleInfoCache::ModuleInfo& module_info);
 
   //! \brief Write Crashpad annotations list.
   static void WriteCrashpadAnnotationsList(IOSIntermediateDumpWriter* writer,
@@ -0,0 +1,202 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "client/ios_handler/module_info_cache.h"
+
+#include <mach-o/dyld.h>
+#include <string.h>
+
+#include <algorithm>
+#include <atomic>
+
+namespace crashpad {
+namespace internal {
+
+namespace {
+
+// Modules loaded after this many have been cached are read during a crash, as
+// they would be without the cache.
+constexpr size_t kMaxCachedModules = 1024;
+
+struct CachedModule {
+  // The address of the module’s header, stored once info is complete, or 0 if
+  // the module isn’t loaded.
+  std::atomic<uint64_t> address;
+  ModuleInfoCache::ModuleInfo info;
+};
+
+CachedModule g_cached_modules[kMaxCachedModules];
+
+// The number of entries of g_cached_modules that have been claimed, which may
+// exceed kMaxCachedModules.
+std::atomic<size_t> g_cached_module_count;
+
+std::atomic<bool> g_started;
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free,
+              "std::atomic<uint64_t> may not be signal-safe");
+static_assert(std::atomic<size_t>::is_always_lock_free,
+              "std::atomic<size_t> may not be signal-safe");
+
+void AddImage(const mach_header* header, intptr_t slide) {
+  if (header->magic != MH_MAGIC_64) {
+    return;
+  }
+
+  const size_t index = g_cached_module_count.fetch_add(1);
+  if (index >= kMaxCachedModules) {
+    return;
+  }
+
+  // The module is loaded, so its header and load commands can be read
+  // directly.
+  const mach_header_64* header_64 =
+      reinterpret_cast<const mach_header_64*>(header);
+  CachedModule& cached_module = g_cached_modules[index];
+  const uint64_t address = reinterpret_cast<uint64_t>(header);
+  if (ModuleInfoCache::Parse(
+          header_64,
+          reinterpret_cast<const load_command*>(header_64 + 1),
+          address,
+          &cached_module.info)) {
+    cached_module.address.store(address, std::memory_order_release);
+  }
+}
+
+void RemoveImage(const mach_header* header, intptr_t slide) {
+  const uint64_t address = reinterpret_cast<uint64_t>(header);
+  const size_t count =
+      std::min(g_cached_module_count.load(), kMaxCachedModules);
+  for (size_t index = 0; index < count; ++index) {
+    uint64_t expected = address;
+    if (g_cached_modules[index].address.compare_exchange_strong(expected, 0)) {
+      return;
+    }
+  }
+}
+
+}  // namespace
+
+// static
+void ModuleInfoCache::Start() {
+  if (g_started.exchange(true)) {
+    return;
+  }
+
+  // Registering calls AddImage() for each module that is already loaded.
+  _dyld_register_func_for_add_image(AddImage);
+  _dyld_register_func_for_remove_image(RemoveImage);
+}
+
+// static
+bool ModuleInfoCache::Find(uint64_t address, size_t* hint, ModuleInfo* info) {
+  const size_t count =
+      std::min(g_cached_module_count.load(std::memory_order_acquire),
+               kMaxCachedModules);
+  for (size_t offset = 0; offset < count; ++offset) {
+    const size_t index = (*hint + offset) % count;
+    if (g_cached_modules[index].address.load(std::memory_order_acquire) ==
+        address) {
+      *info = g_cached_modules[index].info;
+      *hint = index + 1;
+      return true;
+    }
+  }
+  return false;
+}
+
+// static
+bool ModuleInfoCache::Parse(const mach_header_64* header,
+                            const load_command* commands,
+                            uint64_t address,
+                            ModuleInfo* info) {
+  if (header->magic != MH_MAGIC_64) {
+    return false;
+  }
+
+  memset(info, 0, sizeof(*info));
+  info->file_type = header->filetype;
+
+  // Make sure that each load command fits in the space allotted for load
+  // commands, as well as iterating through ncmds.
+  const uint8_t* commands_start = reinterpret_cast<const uint8_t*>(commands);
+  uint64_t slide = 0;
+  for (uint32_t cmd_index = 0, cumulative_cmd_size = 0;
+       cmd_index < header->ncmds &&
+       header->sizeofcmds - cumulative_cmd_size >= sizeof(load_command);
+       ++cmd_index) {
+    const load_command* command = reinterpret_cast<const load_command*>(
+        commands_start + cumulative_cmd_size);
+    if (command->cmdsize < sizeof(load_command) ||
+        command->cmdsize > header->sizeofcmds - cumulative_cmd_size) {
+      break;
+    }
+
+    if (command->cmd == LC_SEGMENT_64 &&
+        command->cmdsize >= sizeof(segment_command_64)) {
+      const segment_command_64* segment =
+          reinterpret_cast<const segment_command_64*>(command);
+      if (strncmp(segment->segname, SEG_TEXT, sizeof(segment->segname)) == 0) {
+        info->text_size = segment->vmsize;
+        info->has_text_size = true;
+        slide = address - segment->vmaddr;
+      } else if (strncmp(segment->segname,
+                         SEG_DATA,
+                         sizeof(segment->segname)) == 0) {
+        const uint32_t nsects = static_cast<uint32_t>(std::min<uint64_t>(
+            segment->nsects,
+            (command->cmdsize - sizeof(segment_command_64)) /
+                sizeof(section_64)));
+        const section_64* sections =
+            reinterpret_cast<const section_64*>(segment + 1);
+        for (uint32_t sect_index = 0; sect_index < nsects; ++sect_index) {
+          const section_64& section = sections[sect_index];
+          if (strncmp(section.sectname,
+                      "crashpad_info",
+                      sizeof(section.sectname)) == 0) {
+            info->crashpad_info_address = section.addr + slide;
+          } else if (strncmp(section.sectname,
+                             "__crash_info",
+                             sizeof(section.sectname)) == 0) {
+            info->crash_info_address = section.addr + slide;
+          }
+        }
+      }
+    } else if (command->cmd == LC_ID_DYLIB &&
+               command->cmdsize >= sizeof(dylib_command)) {
+      info->dylib_current_version =
+          reinterpret_cast<const dylib_command*>(command)
+              ->dylib.current_version;
+      info->has_dylib_current_version = true;
+    } else if (command->cmd == LC_SOURCE_VERSION &&
+               command->cmdsize >= sizeof(source_version_command)) {
+      info->source_version =
+          reinterpret_cast<const source_version_command*>(command)->version;
+      info->has_source_version = true;
+    } else if (command->cmd == LC_UUID &&
+               command->cmdsize >= sizeof(uuid_command)) {
+      memcpy(info->uuid,
+             reinterpret_cast<const uuid_command*>(command)->uuid,
+             sizeof(info->uuid));
+      info->has_uuid = true;
+    }
+
+    cumulative_cmd_size += command->cmdsize;
+  }
+
+  return true;
+}
+
+}  // namespace internal
+}  // namespace crashpad
@@ -0,0 +1,108 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_CLIENT_IOS_HANDLER_MODULE_INFO_CACHE_H_
+#define CRASHPAD_CLIENT_IOS_HANDLER_MODULE_INFO_CACHE_H_
+
+#include <mach-o/loader.h>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace crashpad {
+namespace internal {
+
+//! \brief A cache of the information in each loaded module’s load commands,
+//!     filled in as modules are loaded so that it doesn’t need to be read
+//!     during a crash.
+//!
+//! Only information that can’t change while a module is loaded is cached. The
+//! annotations themselves are not cached, only where to find them.
+//!
+//! Note: All methods are `RUNS-DURING-CRASH`, other than Start().
+class ModuleInfoCache final {
+ public:
+  //! \brief The information found in a module’s load commands.
+  struct ModuleInfo {
+    //! \brief The size of the `__TEXT` segment, if \a has_text_size.
+    uint64_t text_size;
+
+    //! \brief The `LC_SOURCE_VERSION` version, if \a has_source_version.
+    uint64_t source_version;
+
+    //! \brief The address of the `__DATA,crashpad_info` section, or `0`.
+    uint64_t crashpad_info_address;
+
+    //! \brief The address of the `__DATA,__crash_info` section, or `0`.
+    uint64_t crash_info_address;
+
+    //! \brief The `LC_UUID` UUID, if \a has_uuid.
+    uint8_t uuid[16];
+
+    //! \brief The `LC_ID_DYLIB` current version, if
+    //!     \a has_dylib_current_version.
+    uint32_t dylib_current_version;
+
+    //! \brief The Mach-O file type.
+    uint32_t file_type;
+
+    // Whether each of the optional fields above was found.
+    bool has_text_size;
+    bool has_source_version;
+    bool has_uuid;
+    bool has_dylib_current_version;
+  };
+
+  ModuleInfoCache() = delete;
+  ModuleInfoCache(const ModuleInfoCache&) = delete;
+  ModuleInfoCache& operator=(const ModuleInfoCache&) = delete;
+
+  //! \brief Caches the information of every loaded module, and of each module
+  //!     loaded later.
+  //!
+  //! Later calls have no effect.
+  static void Start();
+
+  //! \brief Finds the cached information for the module loaded at \a address.
+  //!
+  //! \param[in] address The address of the module’s Mach-O header.
+  //! \param[in,out] hint Where to start searching from. Modules are usually
+  //!     looked up in the order they were loaded, so passing the same
+  //!     variable, initialized to `0`, for each lookup makes most lookups
+  //!     immediate.
+  //! \param[out] info The cached information.
+  //!
+  //! \return `true` if the module was found.
+  static bool Find(uint64_t address, size_t* hint, ModuleInfo* info);
+
+  //! \brief Reads the information from a module’s header and load commands.
+  //!
+  //! \param[in] header The module’s Mach-O header, which must be safe to
+  //!     dereference.
+  //! \param[in] commands The `sizeofcmds` bytes of load commands following
+  //!     \a header, which must be safe to dereference.
+  //! \param[in] address The address the module is loaded at.
+  //! \param[out] info The information read.
+  //!
+  //! \return `true` on success, or `false` if \a header isn’t a 64-bit Mach-O
+  //!     header. Malformed load commands end the read early, without failing.
+  static bool Parse(const mach_header_64* header,
+                    const load_command* commands,
+                    uint64_t address,
+                    ModuleInfo* info);
+};
+
+}  // namespace internal
+}  // namespace crashpad
+
+#endif  // CRASHPAD_CLIENT_IOS_HANDLER_MODULE_INFO_CACHE_H_
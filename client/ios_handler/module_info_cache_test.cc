@@ -0,0 +1,152 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "client/ios_handler/module_info_cache.h"
+
+#include <mach-o/dyld.h>
+#include <string.h>
+
+#include "gtest/gtest.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+using internal::ModuleInfoCache;
+
+// A module with a __TEXT segment, a __DATA segment with a crashpad_info
+// section, and a UUID.
+struct TestModule {
+  mach_header_64 header;
+  segment_command_64 text;
+  segment_command_64 data;
+  section_64 data_sections[2];
+  uuid_command uuid;
+};
+
+void InitializeTestModule(TestModule* module) {
+  memset(module, 0, sizeof(*module));
+  module->header.magic = MH_MAGIC_64;
+  module->header.filetype = MH_DYLIB;
+  module->header.ncmds = 3;
+  module->header.sizeofcmds = sizeof(*module) - sizeof(module->header);
+
+  module->text.cmd = LC_SEGMENT_64;
+  module->text.cmdsize = sizeof(module->text);
+  strcpy(module->text.segname, SEG_TEXT);
+  module->text.vmaddr = 0x1000;
+  module->text.vmsize = 0x4000;
+
+  module->data.cmd = LC_SEGMENT_64;
+  module->data.cmdsize = sizeof(module->data) + sizeof(module->data_sections);
+  strcpy(module->data.segname, SEG_DATA);
+  module->data.nsects = 2;
+  strcpy(module->data_sections[0].sectname, "__data");
+  module->data_sections[0].addr = 0x5000;
+  strcpy(module->data_sections[1].sectname, "crashpad_info");
+  module->data_sections[1].addr = 0x6000;
+
+  module->uuid.cmd = LC_UUID;
+  module->uuid.cmdsize = sizeof(module->uuid);
+  memset(module->uuid.uuid, 0xab, sizeof(module->uuid.uuid));
+}
+
+TEST(ModuleInfoCache, Parse) {
+  TestModule module;
+  InitializeTestModule(&module);
+
+  constexpr uint64_t kAddress = 0x10001000;
+  ModuleInfoCache::ModuleInfo info;
+  ASSERT_TRUE(ModuleInfoCache::Parse(
+      &module.header,
+      reinterpret_cast<const load_command*>(&module.text),
+      kAddress,
+      &info));
+  EXPECT_EQ(info.file_type, static_cast<uint32_t>(MH_DYLIB));
+  EXPECT_TRUE(info.has_text_size);
+  EXPECT_EQ(info.text_size, 0x4000u);
+  EXPECT_EQ(info.crashpad_info_address, 0x10006000u);
+  EXPECT_EQ(info.crash_info_address, 0u);
+  ASSERT_TRUE(info.has_uuid);
+  EXPECT_EQ(memcmp(info.uuid, module.uuid.uuid, sizeof(info.uuid)), 0);
+  EXPECT_FALSE(info.has_source_version);
+  EXPECT_FALSE(info.has_dylib_current_version);
+}
+
+TEST(ModuleInfoCache, ParseMalformed) {
+  TestModule module;
+  InitializeTestModule(&module);
+
+  ModuleInfoCache::ModuleInfo info;
+  module.header.magic = MH_MAGIC;
+  EXPECT_FALSE(ModuleInfoCache::Parse(
+      &module.header,
+      reinterpret_cast<const load_command*>(&module.text),
+      0,
+      &info));
+  module.header.magic = MH_MAGIC_64;
+
+  // A load command that claims to extend past the end of the load commands
+  // ends the parse, but what was read before it is kept.
+  module.data.cmdsize = module.header.sizeofcmds;
+  ASSERT_TRUE(ModuleInfoCache::Parse(
+      &module.header,
+      reinterpret_cast<const load_command*>(&module.text),
+      0,
+      &info));
+  EXPECT_TRUE(info.has_text_size);
+  EXPECT_EQ(info.crashpad_info_address, 0u);
+  EXPECT_FALSE(info.has_uuid);
+
+  // A segment can’t claim more sections than fit in it.
+  InitializeTestModule(&module);
+  module.data.nsects = 100;
+  ASSERT_TRUE(ModuleInfoCache::Parse(
+      &module.header,
+      reinterpret_cast<const load_command*>(&module.text),
+      0,
+      &info));
+  EXPECT_NE(info.crashpad_info_address, 0u);
+  EXPECT_TRUE(info.has_uuid);
+}
+
+TEST(ModuleInfoCache, LoadedModules) {
+  ModuleInfoCache::Start();
+
+  size_t hint = 0;
+  for (uint32_t index = 0; index < _dyld_image_count(); ++index) {
+    const mach_header_64* header =
+        reinterpret_cast<const mach_header_64*>(_dyld_get_image_header(index));
+    const uint64_t address = reinterpret_cast<uint64_t>(header);
+    SCOPED_TRACE(_dyld_get_image_name(index));
+
+    ModuleInfoCache::ModuleInfo cached;
+    ASSERT_TRUE(ModuleInfoCache::Find(address, &hint, &cached));
+
+    ModuleInfoCache::ModuleInfo parsed;
+    ASSERT_TRUE(ModuleInfoCache::Parse(
+        header,
+        reinterpret_cast<const load_command*>(header + 1),
+        address,
+        &parsed));
+    EXPECT_EQ(memcmp(&cached, &parsed, sizeof(cached)), 0);
+  }
+
+  ModuleInfoCache::ModuleInfo info;
+  EXPECT_FALSE(ModuleInfoCache::Find(1, &hint, &info));
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
@@ -0,0 +1,125 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "client/ios_handler/process_intermediate_dumps_thread.h"
+
+#include <pthread.h>
+
+#include <utility>
+
+#include "base/check.h"
+#include "base/logging.h"
+#include "util/ios/scoped_background_task.h"
+#include "util/misc/clock.h"
+#include "util/misc/metrics.h"
+#include "util/synchronization/semaphore.h"
+#include "util/thread/thread.h"
+
+namespace crashpad {
+
+class ProcessIntermediateDumpsThread::BackgroundThread : public Thread {
+ public:
+  explicit BackgroundThread(ProcessIntermediateDumpsThread* owner)
+      : Thread(), stop_semaphore_(0), owner_(owner) {}
+
+  BackgroundThread(const BackgroundThread&) = delete;
+  BackgroundThread& operator=(const BackgroundThread&) = delete;
+
+  ~BackgroundThread() override {}
+
+  // Waits for seconds, returning true if Stop() was called before or during
+  // the wait.
+  bool WaitForStop(double seconds) {
+    return stop_semaphore_.TimedWait(seconds);
+  }
+
+  void Stop() {
+    stop_semaphore_.Signal();
+    Join();
+  }
+
+ private:
+  // Thread:
+  void ThreadMain() override { owner_->ProcessPendingFiles(this); }
+
+  // A new BackgroundThread is made for each Start(), so that a signal left
+  // over from a thread that had already exited can’t cut short the next one.
+  Semaphore stop_semaphore_;
+  ProcessIntermediateDumpsThread* owner_;  // weak
+};
+
+ProcessIntermediateDumpsThread::ProcessIntermediateDumpsThread(
+    PendingFilesCallback pending_files,
+    ProcessFileCallback process_file,
+    double initial_delay,
+    double slice_interval,
+    double time_budget)
+    : pending_files_(std::move(pending_files)),
+      process_file_(std::move(process_file)),
+      initial_delay_(initial_delay),
+      slice_interval_(slice_interval),
+      time_budget_nanoseconds_(static_cast<uint64_t>(time_budget * 1E9)),
+      spent_nanoseconds_(0),
+      thread_() {}
+
+ProcessIntermediateDumpsThread::~ProcessIntermediateDumpsThread() {
+  DCHECK(!thread_);
+}
+
+void ProcessIntermediateDumpsThread::Start() {
+  DCHECK(!thread_);
+  thread_ = std::make_unique<BackgroundThread>(this);
+  thread_->Start();
+}
+
+void ProcessIntermediateDumpsThread::Stop() {
+  DCHECK(thread_);
+  thread_->Stop();
+  thread_.reset();
+}
+
+void ProcessIntermediateDumpsThread::ProcessPendingFiles(
+    BackgroundThread* thread) {
+  // Conversion is never urgent, so don’t compete with the application for the
+  // CPU or for I/O.
+  int result = pthread_set_qos_class_self_np(QOS_CLASS_BACKGROUND, 0);
+  if (result != 0) {
+    LOG(WARNING) << "pthread_set_qos_class_self_np: " << result;
+  }
+
+  if (thread->WaitForStop(initial_delay_)) {
+    return;
+  }
+
+  const std::vector<base::FilePath> files = pending_files_();
+  for (size_t index = 0; index < files.size(); ++index) {
+    if (spent_nanoseconds_ >= time_budget_nanoseconds_) {
+      return;
+    }
+    if (index > 0 && thread->WaitForStop(slice_interval_)) {
+      return;
+    }
+
+    internal::ScopedBackgroundTask task("ProcessIntermediateDump");
+    const uint64_t start_nanoseconds = ClockMonotonicNanoseconds();
+    process_file_(files[index]);
+    const uint64_t nanoseconds =
+        ClockMonotonicNanoseconds() - start_nanoseconds;
+    spent_nanoseconds_ += nanoseconds;
+    Metrics::OperationDuration(
+        Metrics::TimedOperation::kIntermediateDumpConversion, nanoseconds);
+  }
+}
+
+}  // namespace crashpad
@@ -0,0 +1,130 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_CLIENT_IOS_HANDLER_PROCESS_INTERMEDIATE_DUMPS_THREAD_H_
+#define CRASHPAD_CLIENT_IOS_HANDLER_PROCESS_INTERMEDIATE_DUMPS_THREAD_H_
+
+#include <stdint.h>
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "base/files/file_path.h"
+#include "util/thread/stoppable.h"
+
+namespace crashpad {
+
+//! \brief A low-priority thread that converts intermediate dumps to minidumps
+//!     one at a time, off the application’s launch path.
+//!
+//! Upon calling Start(), the thread waits before converting the first dump, so
+//! as to not interfere with application startup, and then waits again between
+//! each conversion. Each conversion runs inside a background task so that it
+//! can complete if the application is moved to the background.
+//!
+//! The time spent converting dumps is limited by a budget shared by every run
+//! of the thread. Once the budget is spent, any remaining dumps are left for
+//! the next launch of the application. A single conversion is never
+//! interrupted, so the budget may be overrun by the last conversion.
+class ProcessIntermediateDumpsThread final : public Stoppable {
+ public:
+  //! \brief Returns the intermediate dumps waiting to be converted, in the
+  //!     order they should be converted.
+  using PendingFilesCallback = std::function<std::vector<base::FilePath>()>;
+
+  //! \brief Converts a single intermediate dump.
+  using ProcessFileCallback = std::function<void(const base::FilePath&)>;
+
+  //! \brief The default delay, in seconds, before the first conversion.
+  static constexpr double kDefaultInitialDelay = 3;
+
+  //! \brief The default delay, in seconds, between conversions.
+  static constexpr double kDefaultSliceInterval = 1;
+
+  //! \brief The default total time, in seconds, that may be spent converting.
+  static constexpr double kDefaultTimeBudget = 30;
+
+  //! \brief Constructs a new object.
+  //!
+  //! \param[in] pending_files Called on the thread each time it is started, to
+  //!     obtain the dumps to convert.
+  //! \param[in] process_file Called on the thread to convert each dump.
+  //! \param[in] initial_delay The delay, in seconds, before the first
+  //!     conversion.
+  //! \param[in] slice_interval The delay, in seconds, between conversions.
+  //! \param[in] time_budget The total time, in seconds, that may be spent
+  //!     converting dumps over the lifetime of this object.
+  ProcessIntermediateDumpsThread(PendingFilesCallback pending_files,
+                                 ProcessFileCallback process_file,
+                                 double initial_delay = kDefaultInitialDelay,
+                                 double slice_interval = kDefaultSliceInterval,
+                                 double time_budget = kDefaultTimeBudget);
+
+  ProcessIntermediateDumpsThread(const ProcessIntermediateDumpsThread&) =
+      delete;
+  ProcessIntermediateDumpsThread& operator=(
+      const ProcessIntermediateDumpsThread&) = delete;
+
+  ~ProcessIntermediateDumpsThread();
+
+  // Stoppable:
+
+  //! \brief Starts a dedicated conversion thread.
+  //!
+  //! The thread exits by itself once there are no more dumps to convert or the
+  //! time budget is spent, but Stop() must still be called.
+  //!
+  //! This method may only be be called on a newly-constructed object or after
+  //! a call to Stop().
+  void Start() override;
+
+  //! \brief Stops the conversion thread, waiting for any conversion in
+  //!     progress to complete.
+  //!
+  //! This method must only be called after Start(). If Start() has been called,
+  //! this method must be called before destroying an object of this class.
+  //!
+  //! This method may be called from any thread other than the conversion
+  //! thread. It is expected to only be called from the same thread that called
+  //! Start().
+  void Stop() override;
+
+  //! \return `true` if Start() has been called without a matching call to
+  //!     Stop(), `false` otherwise.
+  bool is_running() const { return thread_ != nullptr; }
+
+ private:
+  class BackgroundThread;
+
+  // Converts the pending dumps until stopped, until there are none left, or
+  // until the budget is spent. Called on the conversion thread.
+  void ProcessPendingFiles(BackgroundThread* thread);
+
+  PendingFilesCallback pending_files_;
+  ProcessFileCallback process_file_;
+  const double initial_delay_;
+  const double slice_interval_;
+  const uint64_t time_budget_nanoseconds_;
+
+  // Only accessed by the conversion thread, of which there is at most one at a
+  // time.
+  uint64_t spent_nanoseconds_;
+
+  std::unique_ptr<BackgroundThread> thread_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_CLIENT_IOS_HANDLER_PROCESS_INTERMEDIATE_DUMPS_THREAD_H_
@@ -0,0 +1,102 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "client/ios_handler/process_intermediate_dumps_thread.h"
+
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "util/synchronization/semaphore.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+std::vector<base::FilePath> TestFiles() {
+  return {base::FilePath("file0"),
+          base::FilePath("file1"),
+          base::FilePath("file2")};
+}
+
+TEST(ProcessIntermediateDumpsThread, ProcessesAllFiles) {
+  std::vector<base::FilePath> processed;
+  Semaphore processed_semaphore(0);
+  ProcessIntermediateDumpsThread thread(
+      &TestFiles,
+      [&processed, &processed_semaphore](const base::FilePath& file) {
+        processed.push_back(file);
+        processed_semaphore.Signal();
+      },
+      0,
+      0);
+  thread.Start();
+  EXPECT_TRUE(thread.is_running());
+  for (size_t index = 0; index < TestFiles().size(); ++index) {
+    processed_semaphore.Wait();
+  }
+  thread.Stop();
+  EXPECT_FALSE(thread.is_running());
+  EXPECT_EQ(processed, TestFiles());
+}
+
+TEST(ProcessIntermediateDumpsThread, StopDuringInitialDelay) {
+  int processed = 0;
+  ProcessIntermediateDumpsThread thread(
+      &TestFiles, [&processed](const base::FilePath&) { ++processed; }, 60);
+  thread.Start();
+  thread.Stop();
+  EXPECT_EQ(processed, 0);
+}
+
+TEST(ProcessIntermediateDumpsThread, StopBetweenSlices) {
+  int processed = 0;
+  Semaphore processed_semaphore(0);
+  ProcessIntermediateDumpsThread thread(
+      &TestFiles,
+      [&processed, &processed_semaphore](const base::FilePath&) {
+        ++processed;
+        processed_semaphore.Signal();
+      },
+      0,
+      60);
+  thread.Start();
+  processed_semaphore.Wait();
+  thread.Stop();
+  EXPECT_EQ(processed, 1);
+}
+
+TEST(ProcessIntermediateDumpsThread, TimeBudget) {
+  int processed = 0;
+  Semaphore processed_semaphore(0);
+  ProcessIntermediateDumpsThread thread(
+      &TestFiles,
+      [&processed, &processed_semaphore](const base::FilePath&) {
+        ++processed;
+        processed_semaphore.Signal();
+      },
+      0,
+      0,
+      0);
+
+  // A run exits without processing anything once the budget is spent. With no
+  // budget, nothing is ever processed.
+  thread.Start();
+  EXPECT_FALSE(processed_semaphore.TimedWait(0.1));
+  thread.Stop();
+  EXPECT_EQ(processed, 0);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
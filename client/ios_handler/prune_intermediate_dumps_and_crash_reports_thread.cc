@@ -14,7 +14,9 @@
 
 #include "client/ios_handler/prune_intermediate_dumps_and_crash_reports_thread.h"
 
+#include <algorithm>
 #include <utility>
+#include <vector>
 
 #include "client/prune_crash_reports.h"
 #include "util/file/directory_reader.h"
@@ -31,6 +33,14 @@ constexpr char kLockedExtension[] = ".locked";
 // Prune onces a day.
 constexpr time_t prune_interval = 60 * 60 * 24;
 
+// The time between the steps of a prune. Each step does a bounded amount of
+// i/o, so that a prune doesn’t compete with the application for the disk for
+// long at a time.
+constexpr double step_interval = 30;
+
+// The number of locked intermediate dumps examined in each step.
+constexpr size_t unlock_files_per_step = 16;
+
 // If the client finds a locked file matching it's own bundle id, unlock it
 // after 24 hours.
 constexpr time_t matching_bundle_locked_ttl = 60 * 60 * 24;
@@ -48,19 +58,14 @@ constexpr double app_delay = 60;
 constexpr double extension_delay = 5;
 
 
-//! \brief Unlocks old intermediate dumps.
-//!
-//! This function can unlock (remove the .locked extension) intermediate dumps
-//! that are either too old to be useful, or are likely leftover dumps from
-//! clean app exits.
+//! \brief Lists the locked intermediate dumps.
 //!
 //! \param[in] pending_path The path to any locked intermediate dump files.
-//! \param[in] bundle_identifier_and_seperator The identifier for this client,
-//!     used to determine when locked files are considered stale.
-void UnlockOldIntermediateDumps(base::FilePath pending_path,
-                                std::string bundle_identifier_and_seperator) {
+//! \param[out] files The names of the locked intermediate dump files.
+void ListLockedIntermediateDumps(const base::FilePath& pending_path,
+                                 std::vector<base::FilePath>* files) {
+  files->clear();
   DirectoryReader reader;
-  std::vector<base::FilePath> files;
   if (!reader.Open(pending_path)) {
     return;
   }
@@ -68,9 +73,35 @@ void UnlockOldIntermediateDumps(base::FilePath pending_path,
   DirectoryReader::Result result;
   while ((result = reader.NextFile(&file)) ==
          DirectoryReader::Result::kSuccess) {
-    if (file.FinalExtension() != kLockedExtension)
-      continue;
+    if (file.FinalExtension() == kLockedExtension)
+      files->push_back(file);
+  }
+}
 
+//! \brief Unlocks old intermediate dumps.
+//!
+//! This function can unlock (remove the .locked extension) intermediate dumps
+//! that are either too old to be useful, or are likely leftover dumps from
+//! clean app exits.
+//!
+//! \param[in] pending_path The path to any locked intermediate dump files.
+//! \param[in] bundle_identifier_and_seperator The identifier for this client,
+//!     used to determine when locked files are considered stale.
+//! \param[in] files The names of the locked intermediate dump files, as
+//!     obtained by ListLockedIntermediateDumps().
+//! \param[in,out] next_file The index in \a files of the first file to
+//!     examine, advanced past the files that are examined.
+//! \param[in] max_files The maximum number of files to examine.
+//! \return `true` if all of \a files have been examined.
+bool UnlockOldIntermediateDumps(
+    const base::FilePath& pending_path,
+    const std::string& bundle_identifier_and_seperator,
+    const std::vector<base::FilePath>& files,
+    size_t* next_file,
+    size_t max_files) {
+  const size_t end = std::min(files.size(), *next_file + max_files);
+  for (; *next_file < end; ++*next_file) {
+    const base::FilePath& file = files[*next_file];
     const base::FilePath file_path(pending_path.Append(file));
     timespec file_time;
     time_t now = time(nullptr);
@@ -88,6 +119,7 @@ void UnlockOldIntermediateDumps(base::FilePath pending_path,
       continue;
     }
   }
+  return *next_file == files.size();
 }
 
 }  // namespace
@@ -99,10 +131,14 @@ PruneIntermediateDumpsAndCrashReportsThread::
         base::FilePath pending_path,
         std::string bundle_identifier_and_seperator,
         bool is_extension)
-    : thread_(prune_interval, this),
+    : thread_(step_interval, this),
       condition_(std::move(condition)),
       pending_path_(pending_path),
       bundle_identifier_and_seperator_(bundle_identifier_and_seperator),
+      locked_intermediate_dumps_(),
+      next_locked_intermediate_dump_(0),
+      stage_(Stage::kIdle),
+      clean_old_intermediate_dumps_(false),
       initial_work_delay_(is_extension ? extension_delay : app_delay),
       last_start_time_(0),
       database_(database) {}
@@ -122,26 +158,52 @@ void PruneIntermediateDumpsAndCrashReportsThread::DoWork(
     const WorkerThread* thread) {
   // This thread may be stopped and started a number of times throughout the
   // lifetime of the process to prevent 0xdead10cc kills (see
-  // crbug.com/crashpad/400), but it should only run once per prune_interval
-  // after initial_work_delay_.
-  time_t now = time(nullptr);
-  if (now - last_start_time_ < prune_interval)
-    return;
-  last_start_time_ = now;
+  // crbug.com/crashpad/400), but it should only start a prune once per
+  // prune_interval after initial_work_delay_. A prune is carried out one step
+  // per step_interval, and a prune interrupted by Stop() resumes at its next
+  // step once the thread is started again.
+  if (stage_ == Stage::kIdle) {
+    time_t now = time(nullptr);
+    if (now - last_start_time_ < prune_interval)
+      return;
+    last_start_time_ = now;
+    stage_ = Stage::kCleanDatabase;
+  }
 
   internal::ScopedBackgroundTask scoper("PruneThread");
-  database_->CleanDatabase(60 * 60 * 24 * 3);
-
-  // Here and below, respect Stop() being called after each task.
-  if (!thread_.is_running())
-    return;
-  PruneCrashReportDatabase(database_, condition_.get());
-
-  if (!thread_.is_running())
-    return;
-  if (!clean_old_intermediate_dumps_) {
-    clean_old_intermediate_dumps_ = true;
-    UnlockOldIntermediateDumps(pending_path_, bundle_identifier_and_seperator_);
+  switch (stage_) {
+    case Stage::kIdle:
+      break;
+
+    case Stage::kCleanDatabase:
+      database_->CleanDatabase(60 * 60 * 24 * 3);
+      stage_ = Stage::kPruneCrashReports;
+      break;
+
+    case Stage::kPruneCrashReports:
+      PruneCrashReportDatabaseIncrementally(database_, condition_.get());
+      stage_ = clean_old_intermediate_dumps_
+                   ? Stage::kIdle
+                   : Stage::kListLockedIntermediateDumps;
+      break;
+
+    case Stage::kListLockedIntermediateDumps:
+      ListLockedIntermediateDumps(pending_path_, &locked_intermediate_dumps_);
+      next_locked_intermediate_dump_ = 0;
+      stage_ = Stage::kUnlockOldIntermediateDumps;
+      break;
+
+    case Stage::kUnlockOldIntermediateDumps:
+      if (UnlockOldIntermediateDumps(pending_path_,
+                                     bundle_identifier_and_seperator_,
+                                     locked_intermediate_dumps_,
+                                     &next_locked_intermediate_dump_,
+                                     unlock_files_per_step)) {
+        clean_old_intermediate_dumps_ = true;
+        locked_intermediate_dumps_.clear();
+        stage_ = Stage::kIdle;
+      }
+      break;
   }
 }
 
@@ -16,6 +16,8 @@
 #define CRASHPAD_HANDLER_PRUNE_CRASH_REPORTS_THREAD_H_
 
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "base/files/file_path.h"
 #include "util/thread/stoppable.h"
@@ -34,6 +36,11 @@ class PruneCondition;
 //! every 24 hours. Upon calling Start(), the thread waits 5 seconds before
 //! performing the initial prune operation.
 //!
+//! Each prune is carried out in steps, one every 30 seconds, so that no step
+//! keeps the disk busy for long. Cleaning the database, pruning crash reports,
+//! and listing locked intermediate dumps each take a step, and locked
+//! intermediate dumps are then examined a few at a time.
+//!
 //! Locked intermediate dump files are unlocked only once, not periodically.
 //! Locked dumps that match this bundle id can be unlocked if they are over a
 //! day old. Otherwise, unlock dumps that are over 60 days old.
@@ -88,6 +95,15 @@ class PruneIntermediateDumpsAndCrashReportsThread
   bool is_running() const { return thread_.is_running(); }
 
  private:
+  // The next step of a prune.
+  enum class Stage {
+    kIdle,
+    kCleanDatabase,
+    kPruneCrashReports,
+    kListLockedIntermediateDumps,
+    kUnlockOldIntermediateDumps,
+  };
+
   // WorkerThread::Delegate:
   void DoWork(const WorkerThread* thread) override;
 
@@ -95,6 +111,9 @@ class PruneIntermediateDumpsAndCrashReportsThread
   std::unique_ptr<PruneCondition> condition_;
   base::FilePath pending_path_;
   std::string bundle_identifier_and_seperator_;
+  std::vector<base::FilePath> locked_intermediate_dumps_;
+  size_t next_locked_intermediate_dump_;
+  Stage stage_;
   bool clean_old_intermediate_dumps_;
   double initial_work_delay_;
   time_t last_start_time_;
@@ -18,16 +18,20 @@
 #include <stdint.h>
 
 #include <algorithm>
+#include <set>
 #include <vector>
 
 #include "base/logging.h"
 #include "base/notreached.h"
 #include "build/build_config.h"
+#include "util/misc/metrics.h"
 
 namespace crashpad {
 
 size_t PruneCrashReportDatabase(CrashReportDatabase* database,
                               PruneCondition* condition) {
+  Metrics::ScopedOperationTimer prune_timer(Metrics::TimedOperation::kPrune);
+
   std::vector<CrashReportDatabase::Report> all_reports;
   CrashReportDatabase::OperationStatus status;
 
@@ -72,6 +76,70 @@ size_t PruneCrashReportDatabase(CrashReportDatabase* database,
   // orphaned crash report files on-disk. https://crashpad.chromium.org/bug/66
 }
 
+size_t PruneCrashReportDatabaseIncrementally(CrashReportDatabase* database,
+                                             PruneCondition* condition) {
+  if (!condition->SupportsIncrementalPruning()) {
+    return PruneCrashReportDatabase(database, condition);
+  }
+
+  Metrics::ScopedOperationTimer prune_timer(Metrics::TimedOperation::kPrune);
+
+  // Reports are fetched in batches, so that only the reports that are pruned
+  // and the first one that is kept need to be obtained. Reports that failed to
+  // be deleted remain among the oldest, so each batch is enlarged to skip past
+  // them.
+  constexpr size_t kBatchSize = 32;
+  std::set<UUID> failed;
+  uint64_t remaining_size = 0;
+  bool have_remaining_size = false;
+  size_t num_pruned = 0;
+  while (true) {
+    std::vector<CrashReportDatabase::Report> reports;
+    uint64_t total_size;
+    CrashReportDatabase::OperationStatus status = database->GetOldestReports(
+        failed.size() + kBatchSize, &reports, &total_size);
+    if (status != CrashReportDatabase::kNoError) {
+      LOG(ERROR) << "PruneCrashReportDatabaseIncrementally: Failed to get "
+                    "reports";
+      return num_pruned;
+    }
+
+    // The size is taken once, as PruneCrashReportDatabase() evaluates a single
+    // listing of the database. Reports that fail to be deleted still count
+    // only towards the size of the reports older than them.
+    if (!have_remaining_size) {
+      remaining_size = total_size;
+      have_remaining_size = true;
+    }
+
+    size_t evaluated = 0;
+    for (const auto& report : reports) {
+      if (failed.find(report.uuid) != failed.end()) {
+        continue;
+      }
+      ++evaluated;
+
+      if (!condition->ShouldPruneOldestReport(report, remaining_size)) {
+        return num_pruned;
+      }
+      remaining_size -= std::min(remaining_size, report.total_size);
+
+      status = database->DeleteReport(report.uuid);
+      if (status != CrashReportDatabase::kNoError) {
+        LOG(ERROR) << "Database Pruning: Failed to remove report "
+                   << report.uuid.ToString();
+        failed.insert(report.uuid);
+      } else {
+        num_pruned++;
+      }
+    }
+
+    if (evaluated == 0 || reports.size() < failed.size() + kBatchSize) {
+      return num_pruned;
+    }
+  }
+}
+
 // static
 std::unique_ptr<PruneCondition> PruneCondition::GetDefault() {
   // DatabaseSizePruneCondition must be the LHS so that it is always evaluated,
@@ -82,6 +150,17 @@ std::unique_ptr<PruneCondition> PruneCondition::GetDefault() {
       new AgePruneCondition(365));
 }
 
+bool PruneCondition::SupportsIncrementalPruning() const {
+  return false;
+}
+
+bool PruneCondition::ShouldPruneOldestReport(
+    const CrashReportDatabase::Report& report,
+    uint64_t remaining_size) {
+  NOTREACHED();
+  return false;
+}
+
 static const time_t kSecondsInDay = 60 * 60 * 24;
 
 AgePruneCondition::AgePruneCondition(int max_age_in_days)
@@ -96,6 +175,16 @@ bool AgePruneCondition::ShouldPruneReport(
   return report.creation_time < oldest_report_time_;
 }
 
+bool AgePruneCondition::SupportsIncrementalPruning() const {
+  return true;
+}
+
+bool AgePruneCondition::ShouldPruneOldestReport(
+    const CrashReportDatabase::Report& report,
+    uint64_t remaining_size) {
+  return ShouldPruneReport(report);
+}
+
 DatabaseSizePruneCondition::DatabaseSizePruneCondition(size_t max_size_in_kb)
     : max_size_in_kb_(max_size_in_kb), measured_size_in_kb_(0) {}
 
@@ -109,6 +198,17 @@ bool DatabaseSizePruneCondition::ShouldPruneReport(
   return measured_size_in_kb_ > max_size_in_kb_;
 }
 
+bool DatabaseSizePruneCondition::SupportsIncrementalPruning() const {
+  return true;
+}
+
+bool DatabaseSizePruneCondition::ShouldPruneOldestReport(
+    const CrashReportDatabase::Report& report,
+    uint64_t remaining_size) {
+  // Round up fractional KB to the next 1-KB boundary.
+  return (remaining_size + 1023) / 1024 > max_size_in_kb_;
+}
+
 BinaryPruneCondition::BinaryPruneCondition(
     Operator op, PruneCondition* lhs, PruneCondition* rhs)
     : op_(op), lhs_(lhs), rhs_(rhs) {}
@@ -128,4 +228,25 @@ bool BinaryPruneCondition::ShouldPruneReport(
   }
 }
 
+bool BinaryPruneCondition::SupportsIncrementalPruning() const {
+  return lhs_->SupportsIncrementalPruning() &&
+         rhs_->SupportsIncrementalPruning();
+}
+
+bool BinaryPruneCondition::ShouldPruneOldestReport(
+    const CrashReportDatabase::Report& report,
+    uint64_t remaining_size) {
+  switch (op_) {
+    case AND:
+      return lhs_->ShouldPruneOldestReport(report, remaining_size) &&
+             rhs_->ShouldPruneOldestReport(report, remaining_size);
+    case OR:
+      return lhs_->ShouldPruneOldestReport(report, remaining_size) ||
+             rhs_->ShouldPruneOldestReport(report, remaining_size);
+    default:
+      NOTREACHED();
+      return false;
+  }
+}
+
 }  // namespace crashpad
@@ -15,6 +15,7 @@
 #ifndef CRASHPAD_CLIENT_PRUNE_CRASH_REPORTS_H_
 #define CRASHPAD_CLIENT_PRUNE_CRASH_REPORTS_H_
 
+#include <stdint.h>
 #include <sys/types.h>
 #include <time.h>
 
@@ -41,6 +42,25 @@ class PruneCondition;
 size_t PruneCrashReportDatabase(CrashReportDatabase* database,
                                 PruneCondition* condition);
 
+//! \brief Deletes crash reports from \a database that match \a condition,
+//!     evaluating only the reports that are deleted and the oldest report that
+//!     is kept.
+//!
+//! Reports are obtained from CrashReportDatabase::GetOldestReports() and
+//! evaluated against PruneCondition::ShouldPruneOldestReport() in ascending
+//! order by CrashReportDatabase::Report::creation_time, stopping at the first
+//! report that is kept. This relies on \a condition being one that keeps every
+//! report newer than one that it keeps. If \a condition doesn’t support
+//! incremental pruning, this falls back to PruneCrashReportDatabase().
+//!
+//! \param[in] database The database from which crash reports will be deleted.
+//! \param[in] condition The condition against which reports in the database
+//!     will be evaluated.
+//!
+//! \return The number of deleted crash reports.
+size_t PruneCrashReportDatabaseIncrementally(CrashReportDatabase* database,
+                                             PruneCondition* condition);
+
 std::unique_ptr<PruneCondition> GetDefaultDatabasePruneCondition();
 
 //! \brief An abstract base class for evaluating crash reports for deletion.
@@ -69,6 +89,30 @@ class PruneCondition {
   //! \return `true` if the crash report should be deleted, `false` if it
   //!     should be kept.
   virtual bool ShouldPruneReport(const CrashReportDatabase::Report& report) = 0;
+
+  //! \brief Whether this condition can be evaluated with
+  //!     ShouldPruneOldestReport().
+  //!
+  //! A condition that supports this must keep every report that is newer than
+  //! a report it keeps, given the sizes passed to ShouldPruneOldestReport().
+  //! The default implementation returns `false`.
+  virtual bool SupportsIncrementalPruning() const;
+
+  //! \brief Evaluates the oldest report remaining in a database for deletion.
+  //!
+  //! This is used by PruneCrashReportDatabaseIncrementally(), which evaluates
+  //! reports in ascending order by CrashReportDatabase::Report::creation_time.
+  //! It must only be called if SupportsIncrementalPruning() returns `true`.
+  //!
+  //! \param[in] report The crash report to evaluate.
+  //! \param[in] remaining_size The sum of
+  //!     CrashReportDatabase::Report::total_size over \a report and all reports
+  //!     newer than it.
+  //!
+  //! \return `true` if the crash report should be deleted, `false` if it
+  //!     should be kept.
+  virtual bool ShouldPruneOldestReport(const CrashReportDatabase::Report& report,
+                                       uint64_t remaining_size);
 };
 
 //! \brief A PruneCondition that deletes reports older than the specified number
@@ -87,6 +131,9 @@ class AgePruneCondition final : public PruneCondition {
   ~AgePruneCondition();
 
   bool ShouldPruneReport(const CrashReportDatabase::Report& report) override;
+  bool SupportsIncrementalPruning() const override;
+  bool ShouldPruneOldestReport(const CrashReportDatabase::Report& report,
+                               uint64_t remaining_size) override;
 
  private:
   const time_t oldest_report_time_;
@@ -111,6 +158,14 @@ class DatabaseSizePruneCondition final : public PruneCondition {
   ~DatabaseSizePruneCondition();
 
   bool ShouldPruneReport(const CrashReportDatabase::Report& report) override;
+  bool SupportsIncrementalPruning() const override;
+
+  //! \brief Evaluates \a remaining_size against the size limit.
+  //!
+  //! Unlike ShouldPruneReport(), which rounds the size of each report up to a
+  //! whole kilobyte, this rounds only \a remaining_size.
+  bool ShouldPruneOldestReport(const CrashReportDatabase::Report& report,
+                               uint64_t remaining_size) override;
 
  private:
   const size_t max_size_in_kb_;
@@ -145,6 +200,11 @@ class BinaryPruneCondition final : public PruneCondition {
 
   bool ShouldPruneReport(const CrashReportDatabase::Report& report) override;
 
+  //! \return `true` if both \a lhs and \a rhs support incremental pruning.
+  bool SupportsIncrementalPruning() const override;
+  bool ShouldPruneOldestReport(const CrashReportDatabase::Report& report,
+                               uint64_t remaining_size) override;
+
  private:
   const Operator op_;
   std::unique_ptr<PruneCondition> lhs_;
@@ -258,6 +258,112 @@ TEST(PruneCrashReports, PruneOrder) {
   EXPECT_EQ(PruneCrashReportDatabase(&db, &delete_all), kNumReports);
 }
 
+TEST(PruneCrashReports, IncrementalConditions) {
+  CrashReportDatabase::Report report_80_days;
+  report_80_days.creation_time = NDaysAgo(80);
+  CrashReportDatabase::Report report_10_days;
+  report_10_days.creation_time = NDaysAgo(10);
+
+  AgePruneCondition age_condition(30);
+  EXPECT_TRUE(age_condition.SupportsIncrementalPruning());
+  EXPECT_TRUE(age_condition.ShouldPruneOldestReport(report_80_days, 0));
+  EXPECT_FALSE(age_condition.ShouldPruneOldestReport(report_10_days, 0));
+
+  // The remaining size is rounded up to a whole kilobyte, and compared to the
+  // limit without any state being kept between evaluations.
+  DatabaseSizePruneCondition size_condition(/*max_size_in_kb=*/2);
+  EXPECT_TRUE(size_condition.SupportsIncrementalPruning());
+  EXPECT_TRUE(size_condition.ShouldPruneOldestReport(report_10_days, 2049));
+  EXPECT_FALSE(size_condition.ShouldPruneOldestReport(report_10_days, 2048));
+  EXPECT_FALSE(size_condition.ShouldPruneOldestReport(report_10_days, 0));
+
+  StaticCondition static_condition(true);
+  EXPECT_FALSE(static_condition.SupportsIncrementalPruning());
+
+  BinaryPruneCondition incremental(BinaryPruneCondition::AND,
+                                   new AgePruneCondition(30),
+                                   new DatabaseSizePruneCondition(2));
+  EXPECT_TRUE(incremental.SupportsIncrementalPruning());
+  EXPECT_TRUE(incremental.ShouldPruneOldestReport(report_80_days, 4096));
+  EXPECT_FALSE(incremental.ShouldPruneOldestReport(report_80_days, 1024));
+  EXPECT_FALSE(incremental.ShouldPruneOldestReport(report_10_days, 4096));
+
+  BinaryPruneCondition not_incremental(BinaryPruneCondition::OR,
+                                       new AgePruneCondition(30),
+                                       new StaticCondition(false));
+  EXPECT_FALSE(not_incremental.SupportsIncrementalPruning());
+}
+
+TEST(PruneCrashReports, PruneIncrementally) {
+  using ::testing::_;
+  using ::testing::DoAll;
+  using ::testing::Return;
+  using ::testing::SetArgPointee;
+
+  // Report i is 1 kB and i * 10 days old.
+  const size_t kNumReports = 10;
+  std::vector<CrashReportDatabase::Report> reports;
+  for (size_t i = 0; i < kNumReports; ++i) {
+    CrashReportDatabase::Report temp;
+    temp.uuid.data_1 = static_cast<uint32_t>(i);
+    temp.creation_time = NDaysAgo(static_cast<int>(i) * 10);
+    temp.total_size = 1024;
+    reports.push_back(temp);
+  }
+  std::mt19937 urng(std::random_device{}());
+  std::shuffle(reports.begin(), reports.end(), urng);
+  std::vector<CrashReportDatabase::Report> pending_reports(reports.begin(),
+                                                           reports.begin() + 5);
+  std::vector<CrashReportDatabase::Report> completed_reports(
+      reports.begin() + 5, reports.end());
+
+  MockDatabase db;
+  EXPECT_CALL(db, GetPendingReports(_))
+      .WillOnce(DoAll(SetArgPointee<0>(pending_reports),
+                      Return(CrashReportDatabase::kNoError)));
+  EXPECT_CALL(db, GetCompletedReports(_))
+      .WillOnce(DoAll(SetArgPointee<0>(completed_reports),
+                      Return(CrashReportDatabase::kNoError)));
+
+  // Keeping the database to 5 kB prunes the 5 oldest reports, which include
+  // all of those older than 60 days. The evaluation stops at the first report
+  // kept, so no other reports are deleted.
+  for (size_t i = 5; i < kNumReports; ++i) {
+    EXPECT_CALL(db, DeleteReport(TestUUID(i)))
+        .WillOnce(Return(CrashReportDatabase::kNoError));
+  }
+
+  BinaryPruneCondition condition(BinaryPruneCondition::OR,
+                                 new DatabaseSizePruneCondition(5),
+                                 new AgePruneCondition(60));
+  EXPECT_EQ(PruneCrashReportDatabaseIncrementally(&db, &condition), 5u);
+}
+
+TEST(PruneCrashReports, PruneIncrementallyFallback) {
+  using ::testing::_;
+  using ::testing::DoAll;
+  using ::testing::Return;
+  using ::testing::SetArgPointee;
+
+  std::vector<CrashReportDatabase::Report> pending_reports(1);
+  pending_reports[0].uuid.data_1 = 1;
+
+  MockDatabase db;
+  EXPECT_CALL(db, GetPendingReports(_))
+      .WillOnce(DoAll(SetArgPointee<0>(pending_reports),
+                      Return(CrashReportDatabase::kNoError)));
+  EXPECT_CALL(db, GetCompletedReports(_))
+      .WillOnce(Return(CrashReportDatabase::kNoError));
+  EXPECT_CALL(db, DeleteReport(TestUUID(1u)))
+      .WillOnce(Return(CrashReportDatabase::kNoError));
+
+  // A condition that doesn’t support incremental pruning is evaluated against
+  // every report.
+  StaticCondition delete_all(true);
+  EXPECT_EQ(PruneCrashReportDatabaseIncrementally(&db, &delete_all), 1u);
+  EXPECT_TRUE(delete_all.did_execute());
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace crashpad
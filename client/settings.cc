@@ -137,7 +137,22 @@ struct Settings::Data {
   UUID client_id;
 };
 
-Settings::Settings() = default;
+namespace {
+
+// The settings file must have gone unmodified for at least this long before
+// its contents are cached. Some filesystems only record modification times to
+// the nearest two seconds, so a modification made sooner after the contents
+// were cached may leave the modification time unchanged.
+constexpr time_t kCacheableModificationAgeSeconds = 2;
+
+}  // namespace
+
+Settings::Settings()
+    : file_path_(),
+      cache_lock_(),
+      cached_settings_(),
+      cached_modification_time_(),
+      initialized_() {}
 
 Settings::~Settings() = default;
 
@@ -189,7 +204,11 @@ bool Settings::SetUploadsEnabled(bool enabled) {
   else
     settings.options &= ~Data::Options::kUploadsEnabled;
 
-  return WriteSettings(handle.get(), settings);
+  if (!WriteSettings(handle.get(), settings))
+    return false;
+
+  UpdateCachedSettings(settings);
+  return true;
 }
 
 bool Settings::GetLastUploadAttemptTime(time_t* time) {
@@ -214,7 +233,11 @@ bool Settings::SetLastUploadAttemptTime(time_t time) {
 
   settings.last_upload_attempt_time = InRangeCast<int64_t>(time, 0);
 
-  return WriteSettings(handle.get(), settings);
+  if (!WriteSettings(handle.get(), settings))
+    return false;
+
+  UpdateCachedSettings(settings);
+  return true;
 }
 
 // static
@@ -275,12 +298,17 @@ Settings::ScopedLockedFileHandle Settings::OpenForReadingAndWriting(
 }
 
 bool Settings::OpenAndReadSettings(Data* out_data) {
+  if (ReadCachedSettings(out_data))
+    return true;
+
   ScopedLockedFileHandle handle = OpenForReading();
   if (!handle.is_valid())
     return false;
 
-  if (ReadSettings(handle.get(), out_data, true))
+  if (ReadSettings(handle.get(), out_data, true)) {
+    UpdateCachedSettings(*out_data);
     return true;
+  }
 
   // The settings file is corrupt, so reinitialize it.
   handle.reset();
@@ -409,4 +437,37 @@ bool Settings::InitializeSettings(FileHandle handle) {
   return WriteSettings(handle, settings);
 }
 
+bool Settings::ReadCachedSettings(Data* out_data) {
+  base::AutoLock lock(cache_lock_);
+  if (!cached_settings_)
+    return false;
+
+  timespec mtime;
+  if (!FileModificationTime(file_path(), &mtime) ||
+      mtime.tv_sec != cached_modification_time_.tv_sec ||
+      mtime.tv_nsec != cached_modification_time_.tv_nsec) {
+    cached_settings_.reset();
+    return false;
+  }
+
+  *out_data = *cached_settings_;
+  return true;
+}
+
+void Settings::UpdateCachedSettings(const Data& data) {
+  base::AutoLock lock(cache_lock_);
+
+  timespec mtime;
+  if (!FileModificationTime(file_path(), &mtime) ||
+      time(nullptr) - mtime.tv_sec < kCacheableModificationAgeSeconds) {
+    cached_settings_.reset();
+    return;
+  }
+
+  if (!cached_settings_)
+    cached_settings_ = std::make_unique<Data>();
+  *cached_settings_ = data;
+  cached_modification_time_ = mtime;
+}
+
 }  // namespace crashpad
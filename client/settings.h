@@ -17,8 +17,11 @@
 
 #include <time.h>
 
+#include <memory>
+
 #include "base/files/file_path.h"
 #include "base/scoped_generic.h"
+#include "base/synchronization/lock.h"
 #include "build/build_config.h"
 #include "util/file/file_io.h"
 #include "util/misc/initialization_state.h"
@@ -52,6 +55,13 @@ constexpr double kUploadReportTimeoutSeconds = 60;
 //!
 //! This class must not be instantiated directly, but rather an instance of it
 //! should be retrieved via CrashReportDatabase::GetSettings().
+//!
+//! The settings are kept in a file that other processes may read and write at
+//! any time. The last settings read or written are cached, and are used
+//! instead of reading the file again for as long as the file’s modification
+//! time is unchanged. Settings are only cached once the file has gone
+//! unmodified for long enough that a later modification would be certain to
+//! change its modification time.
 class Settings {
  public:
   Settings();
@@ -250,10 +260,29 @@ class Settings {
   // |handle| must be the result of OpenForReadingAndWriting().
   bool InitializeSettings(FileHandle handle);
 
+  // Copies the cached settings to |out_data| and returns true if the settings
+  // file hasn’t been modified since they were cached. Otherwise, returns false
+  // without reading the file.
+  bool ReadCachedSettings(Data* out_data);
+
+  // Caches |data|, which must have just been read from or written to the
+  // settings file while holding a lock on it. If the file was modified too
+  // recently for another modification to be sure to change its modification
+  // time, the cache is cleared instead.
+  void UpdateCachedSettings(const Data& data);
+
   const base::FilePath& file_path() const { return file_path_; }
 
   base::FilePath file_path_;
 
+  // Guards cached_settings_ and cached_modification_time_.
+  base::Lock cache_lock_;
+
+  // The settings last read or written, if they may be cached, and the
+  // modification time of the settings file that they were found in.
+  std::unique_ptr<Data> cached_settings_;
+  timespec cached_modification_time_;
+
   InitializationState initialized_;
 };
 
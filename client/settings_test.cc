@@ -17,8 +17,10 @@
 #include "build/build_config.h"
 #include "gtest/gtest.h"
 #include "test/errors.h"
+#include "test/filesystem.h"
 #include "test/scoped_temp_dir.h"
 #include "util/file/file_io.h"
+#include "util/file/filesystem.h"
 
 namespace crashpad {
 namespace test {
@@ -37,6 +39,12 @@ class SettingsTest : public testing::Test {
 
   Settings* settings() { return &settings_; }
 
+  // Makes the settings file look old enough for its contents to be cached.
+  void BackdateFile() {
+    const timespec mtime = {time(nullptr) - 60, 0};
+    ASSERT_TRUE(SetFileModificationTime(settings_path(), mtime));
+  }
+
   void InitializeBadFile() {
     ScopedFileHandle handle(
         LoggingOpenFileForWrite(settings_path(),
@@ -115,6 +123,51 @@ TEST_F(SettingsTest, LastUploadAttemptTime) {
   EXPECT_EQ(actual, expected);
 }
 
+TEST_F(SettingsTest, CacheSeesOtherWriters) {
+  BackdateFile();
+
+  bool enabled = true;
+  EXPECT_TRUE(settings()->GetUploadsEnabled(&enabled));
+  EXPECT_FALSE(enabled);
+
+  Settings local_settings;
+  EXPECT_TRUE(local_settings.Initialize(settings_path()));
+  EXPECT_TRUE(local_settings.SetUploadsEnabled(true));
+
+  EXPECT_TRUE(settings()->GetUploadsEnabled(&enabled));
+  EXPECT_TRUE(enabled);
+
+  // The file was just written, so it isn’t cached, and the next write is seen
+  // too.
+  EXPECT_TRUE(local_settings.SetUploadsEnabled(false));
+  EXPECT_TRUE(settings()->GetUploadsEnabled(&enabled));
+  EXPECT_FALSE(enabled);
+}
+
+TEST_F(SettingsTest, CacheSkipsUnmodifiedFile) {
+  BackdateFile();
+
+  UUID client_id;
+  EXPECT_TRUE(settings()->GetClientID(&client_id));
+  timespec mtime;
+  ASSERT_TRUE(FileModificationTime(settings_path(), &mtime));
+
+  // Replace the file without changing its modification time. The cached
+  // settings are still used, rather than recovering the corrupt file.
+  InitializeBadFile();
+  ASSERT_TRUE(SetFileModificationTime(settings_path(), mtime));
+
+  UUID actual;
+  EXPECT_TRUE(settings()->GetClientID(&actual));
+  EXPECT_EQ(actual, client_id);
+
+  // Once the file’s modification time changes, it’s read again.
+  mtime.tv_sec += 1;
+  ASSERT_TRUE(SetFileModificationTime(settings_path(), mtime));
+  EXPECT_TRUE(settings()->GetClientID(&actual));
+  EXPECT_NE(actual, client_id);
+}
+
 // The following tests write a corrupt settings file and test the recovery
 // operation.
 
@@ -15,6 +15,7 @@
 #ifndef CRASHPAD_CLIENT_SIMPLE_STRING_DICTIONARY_H_
 #define CRASHPAD_CLIENT_SIMPLE_STRING_DICTIONARY_H_
 
+#include <stdint.h>
 #include <string.h>
 #include <sys/types.h>
 
@@ -39,6 +40,13 @@ namespace crashpad {
 //! glyphs, and include space for a trailing `NUL` byte. This gives space for
 //! `KeySize - 1` and `ValueSize - 1` characters in an entry. \a NumEntries is
 //! the total number of entries that will fit in the map.
+//!
+//! Entries are placed by hashing their keys, and found again by probing
+//! linearly from that position (open addressing), so that lookups don’t need
+//! to examine every entry. Readers of the map’s storage from another process
+//! need not be aware of this: active entries may be found anywhere in the
+//! storage, in no particular order, and any entry that is not active is
+//! identified by an empty key, as Entry::is_active() describes.
 template <size_t KeySize = 256, size_t ValueSize = 256, size_t NumEntries = 64>
 class TSimpleStringDictionary {
  public:
@@ -50,12 +58,23 @@ class TSimpleStringDictionary {
   static const size_t num_entries = NumEntries;
   //! \}
 
+  //! \brief The value of `Entry::key[1]` in an inactive entry whose key was
+  //!     removed, when lookups for other keys must continue past it.
+  //!
+  //! When a key is removed, its entry is marked with this value unless no
+  //! lookup reaching it could find a key beyond it. Inactive entries not
+  //! marked this way have a `NUL` byte at `Entry::key[1]`. This marker is only
+  //! significant to the map itself, and readers of the map’s storage may
+  //! ignore it.
+  static constexpr char kRemovedEntryMarker = '\x01';
+
   //! \brief A single entry in the map.
   struct Entry {
     //! \brief The entry’s key.
     //!
     //! This string is always `NUL`-terminated. If this is a 0-length
-    //! `NUL`-terminated string, the entry is inactive.
+    //! `NUL`-terminated string, the entry is inactive. In an inactive entry,
+    //! `key[1]` is either `NUL` or #kRemovedEntryMarker.
     char key[KeySize];
 
     //! \brief The entry’s value.
@@ -181,17 +200,17 @@ class TSimpleStringDictionary {
     // |value| must not contain embedded NULs.
     DCHECK_EQ(value.find('\0', 0), base::StringPiece::npos);
 
-    Entry* entry = GetEntryForKey(key);
-
-    // If it does not yet exist, attempt to insert it.
-    if (!entry) {
-      for (size_t i = 0; i < num_entries; ++i) {
-        if (!entries_[i].is_active()) {
-          entry = &entries_[i];
-          SetFromStringPiece(key, entry->key, key_size);
-          break;
-        }
-      }
+    size_t free_index;
+    size_t index = FindIndexForKey(key, &free_index);
+
+    // If it does not yet exist, attempt to insert it at the first inactive
+    // entry that lookups for it will reach.
+    Entry* entry = nullptr;
+    if (index != num_entries) {
+      entry = &entries_[index];
+    } else if (free_index != num_entries) {
+      entry = &entries_[free_index];
+      SetFromStringPiece(key, entry->key, key_size);
     }
 
     // If the map is out of space, |entry| will be nullptr.
@@ -227,10 +246,27 @@ class TSimpleStringDictionary {
       return;
     }
 
-    Entry* entry = GetEntryForKey(key);
-    if (entry) {
+    const size_t index = FindIndexForKey(key, nullptr);
+    if (index != num_entries) {
+      Entry* entry = &entries_[index];
       entry->key[0] = '\0';
       entry->value[0] = '\0';
+
+      // Lookups that reach this entry only need to continue past it if the
+      // next entry has also held a key. Otherwise, lookups can stop here, and
+      // also at any marked entries that lead up to this one.
+      const size_t next_index = (index + 1) % num_entries;
+      if (next_index != index && !IsNeverUsed(entries_[next_index])) {
+        entry->key[1] = kRemovedEntryMarker;
+      } else {
+        entry->key[1] = '\0';
+        for (size_t previous_index = (index + num_entries - 1) % num_entries;
+             previous_index != index &&
+             IsRemoved(entries_[previous_index]);
+             previous_index = (previous_index + num_entries - 1) % num_entries) {
+          entries_[previous_index].key[1] = '\0';
+        }
+      }
     }
 
     DCHECK_EQ(GetEntryForKey(key), implicit_cast<Entry*>(nullptr));
@@ -258,19 +294,68 @@ class TSimpleStringDictionary {
     return strncmp(key.data(), entry.key, key.size()) == 0;
   }
 
-  const Entry* GetConstEntryForKey(base::StringPiece key) const {
-    for (size_t i = 0; i < num_entries; ++i) {
-      if (EntryKeyEquals(key, entries_[i])) {
-        return &entries_[i];
+  static bool IsRemoved(const Entry& entry) {
+    return !entry.is_active() && entry.key[1] == kRemovedEntryMarker;
+  }
+
+  static bool IsNeverUsed(const Entry& entry) {
+    return !entry.is_active() && entry.key[1] != kRemovedEntryMarker;
+  }
+
+  // Returns the index of the entry at which lookups for |key| begin. This is
+  // the 32-bit FNV-1a hash of |key|, reduced to the range of indices.
+  static size_t HomeIndexForKey(base::StringPiece key) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < key.size(); ++i) {
+      hash ^= static_cast<uint8_t>(key[i]);
+      hash *= 16777619u;
+    }
+    return hash % num_entries;
+  }
+
+  // Returns the index of the entry for |key|, or num_entries if |key| is not
+  // in the map. In that case, if |free_index| is not nullptr, it is set to the
+  // index of the first inactive entry probed, where |key| can be inserted, or
+  // to num_entries if the map is full.
+  size_t FindIndexForKey(base::StringPiece key, size_t* free_index) const {
+    size_t first_free_index = num_entries;
+    size_t index = HomeIndexForKey(key);
+    for (size_t probe = 0; probe < num_entries; ++probe) {
+      const Entry& entry = entries_[index];
+      if (entry.is_active()) {
+        if (EntryKeyEquals(key, entry)) {
+          return index;
+        }
+      } else {
+        if (first_free_index == num_entries) {
+          first_free_index = index;
+        }
+
+        // No key was ever placed beyond an entry that has never held one.
+        if (IsNeverUsed(entry)) {
+          break;
+        }
       }
+      index = (index + 1) % num_entries;
+    }
+
+    if (free_index) {
+      *free_index = first_free_index;
     }
-    return nullptr;
+    return num_entries;
+  }
+
+  const Entry* GetConstEntryForKey(base::StringPiece key) const {
+    const size_t index = FindIndexForKey(key, nullptr);
+    return index != num_entries ? &entries_[index] : nullptr;
   }
 
   Entry* GetEntryForKey(base::StringPiece key) {
     return const_cast<Entry*>(GetConstEntryForKey(key));
   }
 
+  static_assert(KeySize >= 2, "KeySize must leave room for a key");
+
   Entry entries_[NumEntries];
 };
 
@@ -14,6 +14,11 @@
 
 #include "client/simple_string_dictionary.h"
 
+#include <string.h>
+
+#include <map>
+#include <string>
+
 #include "base/check_op.h"
 #include "gtest/gtest.h"
 #include "test/gtest_death.h"
@@ -254,6 +259,81 @@ TEST(SimpleStringDictionary, OutOfSpace) {
   EXPECT_FALSE(map.GetValueForKey("c"));
 }
 
+// Adding and removing many keys in a map too small for them to avoid each other
+// should keep every key findable, and leave the map’s storage readable by
+// walking it, as readers in other processes do.
+TEST(SimpleStringDictionary, AddRemoveMany) {
+  using TestMap = TSimpleStringDictionary<4, 4, 8>;
+  TestMap map;
+  std::map<std::string, std::string> expected;
+
+  for (unsigned int step = 0; step < 1000; ++step) {
+    SCOPED_TRACE(step);
+    const std::string key = std::to_string((step * 7919) % 23);
+    const std::string value = std::to_string(step % 1000);
+    if (step % 3 == 2 || expected.size() == TestMap::num_entries) {
+      map.RemoveKey(key.c_str());
+      expected.erase(key);
+    } else if (expected.size() < TestMap::num_entries ||
+               expected.count(key)) {
+      map.SetKeyValue(key.c_str(), value.c_str());
+      expected[key] = value;
+    }
+
+    ASSERT_EQ(map.GetCount(), expected.size());
+    for (unsigned int i = 0; i < 23; ++i) {
+      const std::string check_key = std::to_string(i);
+      const auto it = expected.find(check_key);
+      if (it == expected.end()) {
+        EXPECT_FALSE(map.GetValueForKey(check_key.c_str()));
+      } else {
+        EXPECT_STREQ(map.GetValueForKey(check_key.c_str()),
+                     it->second.c_str());
+      }
+    }
+
+    std::map<std::string, std::string> walked;
+    const TestMap::Entry* entries =
+        reinterpret_cast<const TestMap::Entry*>(&map);
+    for (size_t index = 0; index < TestMap::num_entries; ++index) {
+      const TestMap::Entry& entry = entries[index];
+      const size_t key_length = strnlen(entry.key, sizeof(entry.key));
+      if (key_length) {
+        walked[std::string(entry.key, key_length)] = std::string(
+            entry.value, strnlen(entry.value, sizeof(entry.value)));
+      } else {
+        // Entries marked as removed are never followed by one that has never
+        // held a key, as such a marker would serve no purpose.
+        const TestMap::Entry& next_entry =
+            entries[(index + 1) % TestMap::num_entries];
+        EXPECT_FALSE(entry.key[1] == TestMap::kRemovedEntryMarker &&
+                     !next_entry.is_active() &&
+                     next_entry.key[1] != TestMap::kRemovedEntryMarker);
+      }
+    }
+    EXPECT_EQ(walked, expected);
+  }
+}
+
+// Removing a key from a full map should make room for a new one.
+TEST(SimpleStringDictionary, FullMapReuse) {
+  TSimpleStringDictionary<3, 2, 2> map;
+  map.SetKeyValue("a", "1");
+  map.SetKeyValue("b", "2");
+  map.RemoveKey("a");
+  map.SetKeyValue("c", "3");
+  EXPECT_EQ(map.GetCount(), 2u);
+  EXPECT_FALSE(map.GetValueForKey("a"));
+  EXPECT_STREQ(map.GetValueForKey("b"), "2");
+  EXPECT_STREQ(map.GetValueForKey("c"), "3");
+
+  map.RemoveKey("b");
+  map.RemoveKey("c");
+  EXPECT_EQ(map.GetCount(), 0u);
+  map.SetKeyValue("d", "4");
+  EXPECT_STREQ(map.GetValueForKey("d"), "4");
+}
+
 #if DCHECK_IS_ON()
 
 TEST(SimpleStringDictionaryDeathTest, SetKeyValueWithNullKey) {
@@ -0,0 +1,205 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_CLIENT_SORTED_ADDRESS_RANGE_BAG_H_
+#define CRASHPAD_CLIENT_SORTED_ADDRESS_RANGE_BAG_H_
+
+#include <stdint.h>
+#include <string.h>
+
+#include <algorithm>
+#include <type_traits>
+
+#include "base/check_op.h"
+#include "base/logging.h"
+#include "base/numerics/safe_conversions.h"
+#include "client/simple_address_range_bag.h"
+#include "util/misc/from_pointer_cast.h"
+#include "util/numeric/checked_range.h"
+
+namespace crashpad {
+
+//! \brief A bag of address ranges kept in sorted order, using a fixed amount
+//!     of storage so that it does not perform any dynamic allocations for its
+//!     operations.
+//!
+//! This is an alternative to TSimpleAddressRangeBag for callers that register
+//! many ranges and insert and remove them frequently. Ranges are located by
+//! binary search, and the active entries are kept packed at the front of the
+//! storage, so that the count of active entries is always known and unused
+//! entries need not be visited. None of its methods allocate memory or take
+//! locks, so they may be called from signal handlers.
+//!
+//! The storage uses the same TSimpleAddressRangeBag::Entry layout, so that it
+//! can be read by the handler in the same way. A bag may be registered with
+//! CrashpadInfo::set_extra_memory_ranges().
+//!
+//! If a snapshot is taken while a range is being inserted or removed, the
+//! handler may see one of the other ranges twice or not at all.
+template <size_t NumEntries = 1024>
+class TSortedAddressRangeBag {
+ public:
+  //! Constant and publicly accessible version of the template parameter.
+  static const size_t num_entries = NumEntries;
+
+  //! \brief A single entry in the bag.
+  using Entry = SimpleAddressRangeBag::Entry;
+
+  //! \brief An iterator to traverse all of the active entries in a
+  //!     TSortedAddressRangeBag, in order of increasing base address.
+  class Iterator {
+   public:
+    explicit Iterator(const TSortedAddressRangeBag& bag)
+        : bag_(bag), current_(0) {}
+
+    Iterator(const Iterator&) = delete;
+    Iterator& operator=(const Iterator&) = delete;
+
+    //! \brief Returns the next entry in the bag, or `nullptr` if at the end of
+    //!     the collection.
+    const Entry* Next() {
+      if (current_ < bag_.count_) {
+        return &bag_.entries_[current_++];
+      }
+      return nullptr;
+    }
+
+   private:
+    const TSortedAddressRangeBag& bag_;
+    size_t current_;
+  };
+
+  TSortedAddressRangeBag() : entries_(), count_(0) {}
+
+  TSortedAddressRangeBag(const TSortedAddressRangeBag& other) {
+    *this = other;
+  }
+
+  TSortedAddressRangeBag& operator=(const TSortedAddressRangeBag& other) {
+    memcpy(entries_, other.entries_, sizeof(entries_));
+    count_ = other.count_;
+    return *this;
+  }
+
+  //! \brief Returns the number of active entries. The upper limit for this is
+  //!     \a NumEntries.
+  size_t GetCount() const { return count_; }
+
+  //! \brief Inserts the given range into the bag. Duplicates and overlapping
+  //!     ranges are supported and allowed, but not coalesced.
+  //!
+  //! \param[in] range The range to be inserted. The range must have either a
+  //!     non-zero base address or size.
+  //!
+  //! \return `true` if there was space to insert the range into the bag,
+  //!     otherwise `false` with an error logged.
+  bool Insert(CheckedRange<uint64_t> range) {
+    DCHECK(range.base() != 0 || range.size() != 0);
+
+    if (count_ == num_entries) {
+      LOG(ERROR) << "no space available to insert range";
+      return false;
+    }
+
+    Entry* const entry = Find(range);
+    memmove(entry + 1, entry, (&entries_[count_] - entry) * sizeof(*entry));
+    entry->base = range.base();
+    entry->size = range.size();
+    ++count_;
+    return true;
+  }
+
+  //! \brief Inserts the given range into the bag. Duplicates and overlapping
+  //!     ranges are supported and allowed, but not coalesced.
+  //!
+  //! \param[in] base The base of the range to be inserted. May not be null.
+  //! \param[in] size The size of the range to be inserted. May not be zero.
+  //!
+  //! \return `true` if there was space to insert the range into the bag,
+  //!     otherwise `false` with an error logged.
+  bool Insert(void* base, size_t size) {
+    DCHECK(base != nullptr);
+    DCHECK_NE(0u, size);
+    return Insert(CheckedRange<uint64_t>(FromPointerCast<uint64_t>(base),
+                                         base::checked_cast<uint64_t>(size)));
+  }
+
+  //! \brief Removes the given range from the bag.
+  //!
+  //! If the range was inserted more than once, one instance of it is removed.
+  //!
+  //! \param[in] range The range to be removed. The range must have either a
+  //!     non-zero base address or size.
+  //!
+  //! \return `true` if the range was found and removed, otherwise `false` with
+  //!     an error logged.
+  bool Remove(CheckedRange<uint64_t> range) {
+    DCHECK(range.base() != 0 || range.size() != 0);
+
+    Entry* const entry = Find(range);
+    if (entry == &entries_[count_] || entry->base != range.base() ||
+        entry->size != range.size()) {
+      LOG(ERROR) << "did not find range to remove";
+      return false;
+    }
+
+    --count_;
+    memmove(entry, entry + 1, (&entries_[count_] - entry) * sizeof(*entry));
+    entries_[count_].base = entries_[count_].size = 0;
+    return true;
+  }
+
+  //! \brief Removes the given range from the bag.
+  //!
+  //! \param[in] base The base of the range to be removed. May not be null.
+  //! \param[in] size The size of the range to be removed. May not be zero.
+  //!
+  //! \return `true` if the range was found and removed, otherwise `false` with
+  //!     an error logged.
+  bool Remove(void* base, size_t size) {
+    DCHECK(base != nullptr);
+    DCHECK_NE(0u, size);
+    return Remove(CheckedRange<uint64_t>(FromPointerCast<uint64_t>(base),
+                                         base::checked_cast<uint64_t>(size)));
+  }
+
+ private:
+  // Returns the first active entry that doesn’t sort before range, or the
+  // first inactive entry if there is none.
+  Entry* Find(const CheckedRange<uint64_t>& range) {
+    return std::lower_bound(
+        entries_,
+        &entries_[count_],
+        range,
+        [](const Entry& entry, const CheckedRange<uint64_t>& value) {
+          return entry.base < value.base() ||
+                 (entry.base == value.base() && entry.size < value.size());
+        });
+  }
+
+  // entries_ must remain the first member, because the handler reads it from
+  // the address of the bag.
+  Entry entries_[NumEntries];
+  size_t count_;
+};
+
+//! \brief A TSortedAddressRangeBag with default template parameters.
+using SortedAddressRangeBag = TSortedAddressRangeBag<1024>;
+
+static_assert(std::is_standard_layout<SortedAddressRangeBag>::value,
+              "SortedAddressRangeBag must be standard layout");
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_CLIENT_SORTED_ADDRESS_RANGE_BAG_H_
@@ -0,0 +1,127 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "client/sorted_address_range_bag.h"
+
+#include "gtest/gtest.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+TEST(SortedAddressRangeBag, Sorted) {
+  TSortedAddressRangeBag<10> bag;
+  EXPECT_TRUE(bag.Insert(CheckedRange<uint64_t>(0x3000, 30)));
+  EXPECT_TRUE(bag.Insert(reinterpret_cast<void*>(0x1000), 10));
+  EXPECT_TRUE(bag.Insert(CheckedRange<uint64_t>(0x2000, 20)));
+  EXPECT_TRUE(bag.Insert(CheckedRange<uint64_t>(0x1000, 5)));
+  EXPECT_EQ(bag.GetCount(), 4u);
+
+  TSortedAddressRangeBag<10>::Iterator iterator(bag);
+  const TSortedAddressRangeBag<10>::Entry* entry = iterator.Next();
+  ASSERT_TRUE(entry);
+  EXPECT_EQ(entry->base, 0x1000u);
+  EXPECT_EQ(entry->size, 5u);
+  entry = iterator.Next();
+  ASSERT_TRUE(entry);
+  EXPECT_EQ(entry->base, 0x1000u);
+  EXPECT_EQ(entry->size, 10u);
+  entry = iterator.Next();
+  ASSERT_TRUE(entry);
+  EXPECT_EQ(entry->base, 0x2000u);
+  entry = iterator.Next();
+  ASSERT_TRUE(entry);
+  EXPECT_EQ(entry->base, 0x3000u);
+  EXPECT_FALSE(iterator.Next());
+}
+
+TEST(SortedAddressRangeBag, InsertAndRemove) {
+  SortedAddressRangeBag bag;
+
+  // Duplicates are added too.
+  EXPECT_TRUE(bag.Insert(CheckedRange<uint64_t>(0x3000, 30)));
+  EXPECT_TRUE(bag.Insert(CheckedRange<uint64_t>(0x3000, 30)));
+  EXPECT_TRUE(bag.Insert(CheckedRange<uint64_t>(0x2000, 20)));
+  EXPECT_EQ(bag.GetCount(), 3u);
+
+  // Can be removed twice, but not a third time.
+  EXPECT_TRUE(bag.Remove(CheckedRange<uint64_t>(0x3000, 30)));
+  EXPECT_TRUE(bag.Remove(CheckedRange<uint64_t>(0x3000, 30)));
+  EXPECT_FALSE(bag.Remove(CheckedRange<uint64_t>(0x3000, 30)));
+  EXPECT_FALSE(bag.Remove(CheckedRange<uint64_t>(0x2000, 10)));
+  EXPECT_FALSE(bag.Remove(CheckedRange<uint64_t>(0x1000, 20)));
+  EXPECT_EQ(bag.GetCount(), 1u);
+
+  EXPECT_TRUE(bag.Remove(reinterpret_cast<void*>(0x2000), 20));
+  EXPECT_EQ(bag.GetCount(), 0u);
+  EXPECT_FALSE(SortedAddressRangeBag::Iterator(bag).Next());
+}
+
+TEST(SortedAddressRangeBag, Many) {
+  SortedAddressRangeBag bag;
+
+  // Insert in an order that isn’t sorted.
+  for (uint64_t index = 0; index < bag.num_entries; ++index) {
+    const uint64_t base = ((index * 7) % bag.num_entries + 1) * 0x1000;
+    EXPECT_TRUE(bag.Insert(CheckedRange<uint64_t>(base, 0x100)));
+  }
+  EXPECT_EQ(bag.GetCount(), bag.num_entries);
+  EXPECT_FALSE(bag.Insert(CheckedRange<uint64_t>(1, 2)));
+
+  SortedAddressRangeBag::Iterator iterator(bag);
+  for (uint64_t index = 0; index < bag.num_entries; ++index) {
+    const SortedAddressRangeBag::Entry* entry = iterator.Next();
+    ASSERT_TRUE(entry);
+    EXPECT_EQ(entry->base, (index + 1) * 0x1000);
+  }
+  EXPECT_FALSE(iterator.Next());
+
+  // Remove every other range. The remaining ones stay sorted and packed.
+  for (uint64_t index = 0; index < bag.num_entries; index += 2) {
+    EXPECT_TRUE(
+        bag.Remove(CheckedRange<uint64_t>((index + 1) * 0x1000, 0x100)));
+  }
+  EXPECT_EQ(bag.GetCount(), bag.num_entries / 2);
+
+  SortedAddressRangeBag::Iterator remaining(bag);
+  for (uint64_t index = 1; index < bag.num_entries; index += 2) {
+    const SortedAddressRangeBag::Entry* entry = remaining.Next();
+    ASSERT_TRUE(entry);
+    EXPECT_EQ(entry->base, (index + 1) * 0x1000);
+  }
+  EXPECT_FALSE(remaining.Next());
+}
+
+TEST(SortedAddressRangeBag, CopyAndAssign) {
+  TSortedAddressRangeBag<10> bag;
+  EXPECT_TRUE(bag.Insert(CheckedRange<uint64_t>(1, 2)));
+  EXPECT_TRUE(bag.Insert(CheckedRange<uint64_t>(5, 6)));
+
+  TSortedAddressRangeBag<10> bag_copy(bag);
+  EXPECT_EQ(bag_copy.GetCount(), 2u);
+  EXPECT_TRUE(bag_copy.Remove(CheckedRange<uint64_t>(1, 2)));
+  EXPECT_EQ(bag_copy.GetCount(), 1u);
+  EXPECT_EQ(bag.GetCount(), 2u);
+
+  TSortedAddressRangeBag<10> bag_assign;
+  bag_assign = bag;
+  EXPECT_EQ(bag_assign.GetCount(), 2u);
+  EXPECT_TRUE(bag_assign.Remove(CheckedRange<uint64_t>(5, 6)));
+  EXPECT_EQ(bag_assign.GetCount(), 1u);
+  EXPECT_EQ(bag.GetCount(), 2u);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
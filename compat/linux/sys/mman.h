@@ -37,4 +37,8 @@ int memfd_create(const char* name, unsigned int flags) __THROW;
 
 #endif  // __GLIBC__
 
+#if !defined(MFD_ALLOW_SEALING)
+#define MFD_ALLOW_SEALING 0x0002U
+#endif
+
 #endif  // CRASHPAD_COMPAT_LINUX_SYS_MMAN_H_
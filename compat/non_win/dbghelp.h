@@ -84,6 +84,23 @@ struct __attribute__((packed, aligned(4))) MINIDUMP_MEMORY_DESCRIPTOR {
   MINIDUMP_LOCATION_DESCRIPTOR Memory;
 };
 
+//! \brief A pointer to a snapshot of a region of memory contained within a
+//!     minidump file’s MINIDUMP_MEMORY64_LIST.
+//!
+//! The region’s data is not located by this structure. Instead, the data of all
+//! regions in a MINIDUMP_MEMORY64_LIST is stored contiguously, in order,
+//! beginning at MINIDUMP_MEMORY64_LIST::BaseRva.
+//!
+//! \sa MINIDUMP_MEMORY64_LIST
+struct __attribute__((packed, aligned(4))) MINIDUMP_MEMORY_DESCRIPTOR64 {
+  //! \brief The base address of the memory region in the address space of the
+  //!     process that the minidump file contains a snapshot of.
+  uint64_t StartOfMemoryRange;
+
+  //! \brief The size of the memory region, in bytes.
+  uint64_t DataSize;
+};
+
 //! \brief The top-level structure identifying a minidump file.
 //!
 //! This structure contains a pointer to the stream directory, a second-level
@@ -175,6 +192,9 @@ enum MINIDUMP_STREAM_TYPE {
   //! \brief The stream type for MINIDUMP_SYSTEM_INFO.
   SystemInfoStream = 7,
 
+  //! \brief The stream type for MINIDUMP_MEMORY64_LIST.
+  Memory64ListStream = 9,
+
   //! \brief The stream contains information about active `HANDLE`s.
   HandleDataStream = 12,
 
@@ -653,6 +673,26 @@ struct __attribute__((packed, aligned(4))) MINIDUMP_MEMORY_LIST {
   MINIDUMP_MEMORY_DESCRIPTOR MemoryRanges[0];
 };
 
+//! \brief Information about memory regions within the process, for minidump
+//!     files containing large amounts of memory.
+//!
+//! Minidump files identified as ::MiniDumpWithFullMemory in
+//! MINIDUMP_HEADER::Flags carry the process’ memory in this structure. Unlike
+//! MINIDUMP_MEMORY_LIST, the memory may lie beyond the range addressable by an
+//! ::RVA.
+struct __attribute__((packed, aligned(4))) MINIDUMP_MEMORY64_LIST {
+  //! \brief The number of memory regions present in the #MemoryRanges array.
+  uint64_t NumberOfMemoryRanges;
+
+  //! \brief The location of the first memory region’s data. The data of each
+  //!     subsequent region immediately follows that of the one before it.
+  RVA64 BaseRva;
+
+  //! \brief Structures identifying each memory region present in the minidump
+  //!     file.
+  MINIDUMP_MEMORY_DESCRIPTOR64 MemoryRanges[0];
+};
+
 //! \brief Contains the state of an individual system handle at the time the
 //!     snapshot was taken. This structure is Windows-specific.
 //!
@@ -1144,6 +1184,10 @@ enum MINIDUMP_TYPE {
   //!    the exception address or the instruction pointer.
   MiniDumpNormal = 0x00000000,
 
+  //! \brief A minidump with the contents of all of the process’ accessible
+  //!     memory, in a MINIDUMP_MEMORY64_LIST stream.
+  MiniDumpWithFullMemory = 0x00000002,
+
   //! \brief A minidump with extended contexts.
   //!
   //! Contains Normal plus a MISC_INFO_5 structure describing the contexts.
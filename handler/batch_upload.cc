@@ -0,0 +1,77 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "handler/batch_upload.h"
+
+#include "base/logging.h"
+#include "util/string/split_string.h"
+
+namespace crashpad {
+
+std::string BatchUploadKeyPrefix(const UUID& uuid) {
+  return uuid.ToString() + "/";
+}
+
+std::string BatchUploadReportsValue(const std::vector<UUID>& uuids) {
+  std::string value;
+  for (const UUID& uuid : uuids) {
+    if (!value.empty()) {
+      value.push_back(',');
+    }
+    value += uuid.ToString();
+  }
+  return value;
+}
+
+std::map<UUID, BatchUploadResult> ParseBatchUploadResponse(
+    const std::string& response_body) {
+  std::map<UUID, BatchUploadResult> results;
+  for (std::string line : SplitString(response_body, '\n')) {
+    if (!line.empty() && line.back() == '\r') {
+      line.pop_back();
+    }
+    if (line.empty()) {
+      continue;
+    }
+
+    std::string uuid_string;
+    std::string result_string;
+    UUID uuid;
+    if (!SplitStringFirst(line, ' ', &uuid_string, &result_string) ||
+        !uuid.InitializeFromString(uuid_string)) {
+      LOG(WARNING) << "invalid batch upload result " << line;
+      continue;
+    }
+
+    std::string status;
+    BatchUploadResult result;
+    if (!SplitStringFirst(result_string, ' ', &status, &result.id)) {
+      status = result_string;
+    }
+    if (status == "ok" && !result.id.empty()) {
+      result.status = BatchUploadResult::Status::kUploaded;
+    } else if (status == "retry") {
+      result.status = BatchUploadResult::Status::kRetry;
+    } else if (status == "reject") {
+      result.status = BatchUploadResult::Status::kRejected;
+    } else {
+      LOG(WARNING) << "invalid batch upload result " << line;
+      continue;
+    }
+    results[uuid] = result;
+  }
+  return results;
+}
+
+}  // namespace crashpad
@@ -0,0 +1,90 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_HANDLER_BATCH_UPLOAD_H_
+#define CRASHPAD_HANDLER_BATCH_UPLOAD_H_
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "util/misc/uuid.h"
+
+namespace crashpad {
+
+//! \file
+//!
+//! A batch upload sends several reports to the upload URL in a single
+//! multipart request. The form field named by kBatchUploadReportsKey lists the
+//! unique identifiers of the reports in the batch, separated by commas. Each
+//! report’s form data, attachments, and minidump are named as they would be in
+//! an upload of that report alone, prefixed by BatchUploadKeyPrefix().
+//!
+//! A server that accepts the request responds with a body of one line for each
+//! report that it considered, made of the report’s unique identifier and its
+//! result, separated by a space:
+//!  - `ok`, followed by a space and the identifier that the server assigned to
+//!    the report, if the report was uploaded.
+//!  - `retry`, if the report wasn’t uploaded but might be if sent again.
+//!  - `reject`, if the report wasn’t uploaded and should not be sent again.
+//!
+//! A report that the response doesn’t mention is treated as if its result was
+//! `retry`.
+
+//! \brief The form field listing the reports in a batch upload.
+constexpr char kBatchUploadReportsKey[] = "batch_reports";
+
+//! \brief Returns the prefix for the names of a report’s parts in a batch
+//!     upload.
+std::string BatchUploadKeyPrefix(const UUID& uuid);
+
+//! \brief Returns the value of the kBatchUploadReportsKey form field for a
+//!     batch of \a uuids.
+std::string BatchUploadReportsValue(const std::vector<UUID>& uuids);
+
+//! \brief The result of a single report in a batch upload.
+struct BatchUploadResult {
+  //! \brief The outcome of the report’s upload.
+  enum class Status {
+    //! \brief The report was uploaded.
+    kUploaded,
+
+    //! \brief The report wasn’t uploaded, but might be if sent again.
+    kRetry,
+
+    //! \brief The report wasn’t uploaded, and should not be sent again.
+    kRejected,
+  };
+
+  Status status;
+
+  //! \brief The identifier that the server assigned to the report, if
+  //!     #status is Status::kUploaded.
+  std::string id;
+};
+
+//! \brief Parses the response to a batch upload.
+//!
+//! Lines that can’t be parsed are skipped, with a message logged.
+//!
+//! \param[in] response_body The body of the server’s response.
+//!
+//! \return The results of the reports mentioned by the response, by their
+//!     unique identifiers.
+std::map<UUID, BatchUploadResult> ParseBatchUploadResponse(
+    const std::string& response_body);
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_HANDLER_BATCH_UPLOAD_H_
@@ -0,0 +1,88 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "handler/batch_upload.h"
+
+#include "gtest/gtest.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+TEST(BatchUpload, ReportsValue) {
+  UUID uuid_1;
+  ASSERT_TRUE(
+      uuid_1.InitializeFromString("00112233-4455-6677-8899-aabbccddeeff"));
+  UUID uuid_2;
+  ASSERT_TRUE(
+      uuid_2.InitializeFromString("ffeeddcc-bbaa-9988-7766-554433221100"));
+
+  EXPECT_EQ(BatchUploadReportsValue({}), "");
+  EXPECT_EQ(BatchUploadReportsValue({uuid_1}),
+            "00112233-4455-6677-8899-aabbccddeeff");
+  EXPECT_EQ(BatchUploadReportsValue({uuid_1, uuid_2}),
+            "00112233-4455-6677-8899-aabbccddeeff,"
+            "ffeeddcc-bbaa-9988-7766-554433221100");
+  EXPECT_EQ(BatchUploadKeyPrefix(uuid_2),
+            "ffeeddcc-bbaa-9988-7766-554433221100/");
+}
+
+TEST(BatchUpload, ParseResponse) {
+  UUID uuid_1;
+  ASSERT_TRUE(
+      uuid_1.InitializeFromString("00112233-4455-6677-8899-aabbccddeeff"));
+  UUID uuid_2;
+  ASSERT_TRUE(
+      uuid_2.InitializeFromString("ffeeddcc-bbaa-9988-7766-554433221100"));
+  UUID uuid_3;
+  ASSERT_TRUE(
+      uuid_3.InitializeFromString("01234567-89ab-cdef-0123-456789abcdef"));
+
+  std::map<UUID, BatchUploadResult> results = ParseBatchUploadResponse(
+      "00112233-4455-6677-8899-aabbccddeeff ok crash 1\r\n"
+      "ffeeddcc-bbaa-9988-7766-554433221100 retry\n"
+      "\n"
+      "01234567-89ab-cdef-0123-456789abcdef reject");
+  ASSERT_EQ(results.size(), 3u);
+  EXPECT_EQ(results[uuid_1].status, BatchUploadResult::Status::kUploaded);
+  EXPECT_EQ(results[uuid_1].id, "crash 1");
+  EXPECT_EQ(results[uuid_2].status, BatchUploadResult::Status::kRetry);
+  EXPECT_EQ(results[uuid_3].status, BatchUploadResult::Status::kRejected);
+}
+
+TEST(BatchUpload, ParseInvalidResponse) {
+  UUID uuid;
+  ASSERT_TRUE(
+      uuid.InitializeFromString("00112233-4455-6677-8899-aabbccddeeff"));
+
+  // Lines that can’t be parsed are skipped.
+  std::map<UUID, BatchUploadResult> results = ParseBatchUploadResponse(
+      "<html>Error</html>\n"
+      "00112233-4455-6677-8899-aabbccddeeff\n"
+      "00112233-4455-6677-8899-aabbccddeeff ok\n"
+      "00112233-4455-6677-8899-aabbccddeeff maybe\n"
+      "not-a-uuid ok 1\n");
+  EXPECT_TRUE(results.empty());
+
+  results = ParseBatchUploadResponse(
+      "garbage\n"
+      "00112233-4455-6677-8899-aabbccddeeff ok 1\n");
+  ASSERT_EQ(results.size(), 1u);
+  EXPECT_EQ(results[uuid].status, BatchUploadResult::Status::kUploaded);
+  EXPECT_EQ(results[uuid].id, "1");
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
@@ -15,11 +15,14 @@
 #include "handler/crash_report_upload_thread.h"
 
 #include <errno.h>
+#include <inttypes.h>
 #include <time.h>
 
 #include <algorithm>
 #include <map>
 #include <memory>
+#include <set>
+#include <utility>
 #include <vector>
 
 #include "base/logging.h"
@@ -28,17 +31,28 @@
 #include "base/strings/utf_string_conversions.h"
 #include "build/build_config.h"
 #include "client/settings.h"
+#include "handler/batch_upload.h"
 #include "handler/minidump_to_upload_parameters.h"
+#include "handler/report_upload_body.h"
+#include "snapshot/minidump/minidump_compression.h"
 #include "snapshot/minidump/process_snapshot_minidump.h"
-#include "snapshot/module_snapshot.h"
+#include "third_party/zlib/zlib_crashpad.h"
+#include "util/file/chunked_string_file.h"
 #include "util/file/file_reader.h"
+#include "util/file/string_file.h"
 #include "util/misc/metrics.h"
+#include "util/misc/trace_events.h"
 #include "util/misc/uuid.h"
 #include "util/net/http_body.h"
+#include "util/net/http_body_zstd.h"
+#include "util/net/http_headers.h"
 #include "util/net/http_multipart_builder.h"
+#include "util/net/http_resumable_upload.h"
 #include "util/net/http_transport.h"
 #include "util/net/url.h"
 #include "util/stdlib/map_insert.h"
+#include "util/string/split_string.h"
+#include "util/thread/thread.h"
 
 #if BUILDFLAG(IS_APPLE)
 #include "handler/mac/file_limit_annotation.h"
@@ -48,6 +62,11 @@
 #include "util/ios/scoped_background_task.h"
 #endif  // BUILDFLAG(IS_IOS)
 
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+#include "util/linux/directory_watcher.h"
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+
 namespace crashpad {
 
 namespace {
@@ -55,6 +74,14 @@ namespace {
 // The number of seconds to wait between checking for pending reports.
 const int kRetryWorkIntervalSeconds = 15 * 60;
 
+// The number of seconds to wait between checking for pending reports when the
+// database is also watched for them, and no failed upload is waiting to be
+// retried.
+const int kNotifiedRetryWorkIntervalSeconds = 60 * 60;
+
+// The maximum number of reports uploaded together in a single request.
+constexpr size_t kMaxBatchedReports = 32;
+
 #if BUILDFLAG(IS_IOS)
 // The number of times to attempt to upload a pending report, repeated on
 // failure. Attempts will happen once per launch, once per call to
@@ -84,8 +111,314 @@ class ScopedFunctionInvoker final {
   const std::function<void()>& function_;
 };
 
+// Returns whether the upload thread should watch the database for pending
+// reports.
+bool ShouldNotifyPendingReports(
+    CrashReportDatabase* database,
+    const CrashReportUploadThread::Options& options) {
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+  return options.watch_pending_reports && options.notify_pending_reports &&
+         !database->PendingReportsChangePath().empty();
+#else
+  return false;
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+}
+
+// Returns whether the value of an Accept-Encoding header field (RFC 9110
+// §12.5.3) permits the content coding |coding|, either by naming it or by a
+// wildcard, with a nonzero quality value. |coding| must be in lowercase.
+bool AcceptsContentCoding(const std::string& accept_encoding,
+                          const std::string& coding) {
+  static constexpr char kWhitespace[] = " \t";
+  bool wildcard_accepted = false;
+  for (const std::string& element : SplitString(accept_encoding, ',')) {
+    std::string name;
+    std::string parameters;
+    if (!SplitStringFirst(element, ';', &name, &parameters)) {
+      name = element;
+      parameters.clear();
+    }
+
+    const size_t name_begin = name.find_first_not_of(kWhitespace);
+    if (name_begin == std::string::npos) {
+      continue;
+    }
+    name = name.substr(name_begin,
+                       name.find_last_not_of(kWhitespace) - name_begin + 1);
+
+    // A quality value of 0 means “not acceptable”. Quality values have at most
+    // three digits after the decimal point, so any that contains no nonzero
+    // digit is 0.
+    bool accepted = true;
+    const size_t q = parameters.find("q=");
+    if (q != std::string::npos) {
+      const size_t qvalue_end = parameters.find_first_of(" \t;", q + 2);
+      const std::string qvalue = parameters.substr(
+          q + 2,
+          qvalue_end == std::string::npos ? std::string::npos
+                                          : qvalue_end - (q + 2));
+      accepted = qvalue.find_first_not_of("0.") != std::string::npos;
+    }
+
+    // Content codings are case-insensitive, and |coding| is in lowercase.
+    for (char& c : name) {
+      if (c >= 'A' && c <= 'Z') {
+        c += 'a' - 'A';
+      }
+    }
+
+    if (name == coding) {
+      return accepted;
+    }
+    if (name == "*") {
+      wildcard_accepted = accepted;
+    }
+  }
+  return wildcard_accepted;
+}
+
+// The form field naming the tier of an upload’s minidump, and the response
+// header field with which a server asks for the full minidump of a report whose
+// reduced minidump was uploaded.
+constexpr char kMinidumpTierKey[] = "minidump_tier";
+constexpr char kMinidumpTierHeader[] = "Crashpad-Minidump-Tier";
+
+// Returns whether the value of a Crashpad-Minidump-Tier header field asks for
+// the full minidump.
+bool RequestsFullMinidump(const std::string& tier) {
+  static constexpr char kWhitespace[] = " \t";
+  const size_t begin = tier.find_first_not_of(kWhitespace);
+  if (begin == std::string::npos) {
+    return false;
+  }
+  std::string name =
+      tier.substr(begin, tier.find_last_not_of(kWhitespace) - begin + 1);
+  for (char& c : name) {
+    if (c >= 'A' && c <= 'Z') {
+      c += 'a' - 'A';
+    }
+  }
+  return name == "full";
+}
+
+// The request header fields with which a pre-upload check identifies a report,
+// and the response header field with which a server that already has the
+// report says so, giving the response body of the upload that it has.
+constexpr char kReportIDHeader[] = "Crashpad-Report-ID";
+constexpr char kReportDigestHeader[] = "Crashpad-Report-Digest";
+constexpr char kReportPresentHeader[] = "Crashpad-Report-Present";
+
+// Computes the size and CRC-32 of the contents of |reader|, formatted as they
+// are for stored attachments. |reader| is left at its start.
+bool DigestReport(FileReaderInterface* reader, std::string* digest) {
+  if (!reader->SeekSet(0)) {
+    return false;
+  }
+
+  uLong crc = crc32(0, nullptr, 0);
+  uint64_t size = 0;
+  char buffer[4096];
+  FileOperationResult read_result;
+  while ((read_result = reader->Read(buffer, sizeof(buffer))) > 0) {
+    crc = crc32(crc,
+                reinterpret_cast<const Bytef*>(buffer),
+                static_cast<uInt>(read_result));
+    size += read_result;
+  }
+  if (read_result < 0 || !reader->SeekSet(0)) {
+    return false;
+  }
+
+  *digest = base::StringPrintf(
+      "%016" PRIx64 "-%08" PRIx32, size, static_cast<uint32_t>(crc));
+  return true;
+}
+
+// Counts the bytes read from another HTTPBodyStream.
+class CountingHTTPBodyStream final : public HTTPBodyStream {
+ public:
+  CountingHTTPBodyStream(std::unique_ptr<HTTPBodyStream> stream,
+                         uint64_t* count)
+      : stream_(std::move(stream)), count_(count) {}
+
+  CountingHTTPBodyStream(const CountingHTTPBodyStream&) = delete;
+  CountingHTTPBodyStream& operator=(const CountingHTTPBodyStream&) = delete;
+
+  ~CountingHTTPBodyStream() override {}
+
+  // HTTPBodyStream:
+  FileOperationResult GetBytesBuffer(uint8_t* buffer, size_t max_len) override {
+    const FileOperationResult result = stream_->GetBytesBuffer(buffer, max_len);
+    if (result > 0) {
+      *count_ += result;
+    }
+    return result;
+  }
+
+ private:
+  std::unique_ptr<HTTPBodyStream> stream_;
+  uint64_t* count_;  // weak
+};
+
 }  // namespace
 
+// Registers an upload in progress for the duration of its scope, so that
+// Stop() can cancel it.
+class CrashReportUploadThread::ScopedActiveUpload {
+ public:
+  // cancel is called, at most once and from any thread, to cancel the upload.
+  // If Stop() has already been called, it’s called before this returns.
+  ScopedActiveUpload(CrashReportUploadThread* upload_thread,
+                     std::function<void()> cancel)
+      : upload_thread_(upload_thread),
+        cancel_(std::move(cancel)),
+        canceled_(false) {
+    base::AutoLock lock(upload_thread_->active_uploads_lock_);
+    if (upload_thread_->stopping_) {
+      Cancel();
+    } else {
+      upload_thread_->active_uploads_.insert(this);
+    }
+  }
+
+  ScopedActiveUpload(const ScopedActiveUpload&) = delete;
+  ScopedActiveUpload& operator=(const ScopedActiveUpload&) = delete;
+
+  ~ScopedActiveUpload() {
+    base::AutoLock lock(upload_thread_->active_uploads_lock_);
+    upload_thread_->active_uploads_.erase(this);
+  }
+
+  // Cancels the upload. upload_thread_->active_uploads_lock_ must be held.
+  void Cancel() {
+    canceled_ = true;
+    cancel_();
+  }
+
+  // Whether the upload was canceled.
+  bool canceled() {
+    base::AutoLock lock(upload_thread_->active_uploads_lock_);
+    return canceled_;
+  }
+
+ private:
+  CrashReportUploadThread* upload_thread_;  // weak
+  std::function<void()> cancel_;
+  bool canceled_;
+};
+
+// Processes reports queued by CrashReportUploadThread::ProcessReports()
+// alongside the upload thread.
+class CrashReportUploadThread::UploadWorker : public Thread {
+ public:
+  explicit UploadWorker(CrashReportUploadThread* upload_thread)
+      : Thread(), upload_thread_(upload_thread) {}
+
+  UploadWorker(const UploadWorker&) = delete;
+  UploadWorker& operator=(const UploadWorker&) = delete;
+
+  ~UploadWorker() override {}
+
+ private:
+  // Thread:
+  void ThreadMain() override { upload_thread_->ProcessQueuedReports(); }
+
+  CrashReportUploadThread* upload_thread_;  // weak
+};
+
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+
+// Watches CrashReportDatabase::PendingReportsChangePath() and signals the
+// upload thread when reports not previously seen to be pending become pending.
+// Reports that remain pending, such as those whose uploads failed, don’t signal
+// the upload thread again.
+class CrashReportUploadThread::PendingReportWatcher : public Thread {
+ public:
+  explicit PendingReportWatcher(CrashReportUploadThread* upload_thread)
+      : Thread(),
+        watcher_(),
+        change_name_(),
+        pending_report_uuids_(),
+        upload_thread_(upload_thread) {}
+
+  PendingReportWatcher(const PendingReportWatcher&) = delete;
+  PendingReportWatcher& operator=(const PendingReportWatcher&) = delete;
+
+  ~PendingReportWatcher() override {}
+
+  // Starts watching the database. Reports that are pending when this is called
+  // are not signaled.
+  bool Initialize() {
+    const base::FilePath change_path =
+        upload_thread_->database_->PendingReportsChangePath();
+    if (!watcher_.Initialize(change_path.DirName())) {
+      return false;
+    }
+    change_name_ = change_path.BaseName();
+    FindNewPendingReports();
+    return true;
+  }
+
+  // Stops the thread started by Start() and waits for it to exit.
+  void Stop() {
+    watcher_.Stop();
+    Join();
+  }
+
+ private:
+  // Thread:
+  void ThreadMain() override {
+    std::vector<base::FilePath> names;
+    while (watcher_.WaitForChanges(&names)) {
+      // An empty name means that changes were lost, so the change file may
+      // have been among them.
+      if (std::any_of(names.begin(),
+                      names.end(),
+                      [this](const base::FilePath& name) {
+                        return name.empty() || name == change_name_;
+                      }) &&
+          FindNewPendingReports()) {
+        upload_thread_->thread_.DoWorkNow();
+      }
+    }
+  }
+
+  // Updates pending_report_uuids_, returning `true` if it gained any reports.
+  bool FindNewPendingReports() {
+    std::vector<CrashReportDatabase::Report> reports;
+    if (upload_thread_->database_->GetPendingReports(&reports) !=
+        CrashReportDatabase::kNoError) {
+      return false;
+    }
+
+    std::vector<UUID> uuids;
+    uuids.reserve(reports.size());
+    for (const CrashReportDatabase::Report& report : reports) {
+      uuids.push_back(report.uuid);
+    }
+    std::sort(uuids.begin(), uuids.end());
+
+    const bool found_new = !std::includes(pending_report_uuids_.begin(),
+                                          pending_report_uuids_.end(),
+                                          uuids.begin(),
+                                          uuids.end());
+    pending_report_uuids_.swap(uuids);
+    return found_new;
+  }
+
+  DirectoryWatcher watcher_;
+  base::FilePath change_name_;
+
+  // Sorted.
+  std::vector<UUID> pending_report_uuids_;
+
+  CrashReportUploadThread* upload_thread_;  // weak
+};
+
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+
 CrashReportUploadThread::CrashReportUploadThread(
     CrashReportDatabase* database,
     const std::string& url,
@@ -94,34 +427,150 @@ CrashReportUploadThread::CrashReportUploadThread(
     : options_(options),
       callback_(callback),
       url_(url),
+      notify_pending_reports_(ShouldNotifyPendingReports(database, options)),
+      pending_reports_watched_(false),
+      server_accepts_zstd_(false),
       // When watching for pending reports, check every 15 minutes, even in the
       // absence of a signal from the handler thread. This allows for failed
       // uploads to be retried periodically, and for pending reports written by
-      // other processes to be recognized.
+      // other processes to be recognized. When pending reports written by other
+      // processes are noticed as they are written, DoWork() checks every hour
+      // instead while there are no failed uploads to retry.
       thread_(options.watch_pending_reports ? kRetryWorkIntervalSeconds
                                             : WorkerThread::kIndefiniteWait,
               this),
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+      pending_report_watcher_(),
+      relay_(),
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+      precompressor_(),
+      delta_bases_(),
       known_pending_report_uuids_(),
+      memory_reports_lock_(),
+      memory_reports_(),
+      upload_queue_lock_(),
+      upload_queue_(nullptr),
+      upload_queue_next_(0),
+      rate_limit_lock_(),
+      active_uploads_lock_(),
+      active_uploads_(),
+      stopping_(false),
       database_(database) {
   DCHECK(!url_.empty());
+
+  thread_.SetScheduler(options_.work_scheduler);
+
+  if ((options_.precompress_reports || options_.resumable_uploads) &&
+      options_.upload_compression == HTTPMultipartBuilder::Compression::kGzip) {
+    precompressor_ = std::make_unique<ReportPrecompressor>(
+        database_, options_.upload_compression_level);
+  }
+  if (options_.delta_uploads && !options_.tiered_uploads) {
+    delta_bases_ = std::make_unique<DeltaUploadBases>(database_);
+  }
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+  if (!options_.upload_relay.empty()) {
+    relay_ = std::make_unique<ReportRelay>(
+        options_.upload_relay, internal::kUploadReportTimeoutSeconds);
+  }
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
 }
 
 CrashReportUploadThread::~CrashReportUploadThread() {
 }
 
 void CrashReportUploadThread::ReportPending(const UUID& report_uuid) {
-  known_pending_report_uuids_.PushBack(report_uuid);
+  known_pending_report_uuids_.Push(report_uuid);
   if (thread_.is_running())
     thread_.DoWorkNow();
 }
 
+void CrashReportUploadThread::UploadFromMemory(
+    std::unique_ptr<CrashReportDatabase::NewReport> new_report,
+    std::unique_ptr<ChunkedStringFile> minidump) {
+  {
+    base::AutoLock lock(memory_reports_lock_);
+    memory_reports_.push_back({std::move(new_report), std::move(minidump)});
+  }
+
+  // A report that reaches a stopped thread would otherwise wait for it to be
+  // started again, so it’s written to the database now. If the thread is
+  // stopped after this check, Stop() writes it.
+  if (thread_.is_running()) {
+    thread_.DoWorkNow();
+  } else {
+    SpillMemoryReports();
+  }
+}
+
 void CrashReportUploadThread::Start() {
-  thread_.Start(
-      options_.watch_pending_reports ? 0.0 : WorkerThread::kIndefiniteWait);
+  {
+    base::AutoLock lock(active_uploads_lock_);
+    stopping_ = false;
+  }
+
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+  // Reports already pending when the watcher is initialized are found by the
+  // first check made by thread_. Pending reports written by other processes
+  // are still found by the periodic checks if the watcher can’t be
+  // initialized.
+  if (notify_pending_reports_) {
+    DCHECK(!pending_report_watcher_);
+    pending_report_watcher_ = std::make_unique<PendingReportWatcher>(this);
+    if (!pending_report_watcher_->Initialize()) {
+      pending_report_watcher_.reset();
+    }
+  }
+  pending_reports_watched_ = pending_report_watcher_ != nullptr;
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+
+  // Until the first check, there may be failed uploads to retry.
+  if (options_.watch_pending_reports) {
+    thread_.SetWorkInterval(kRetryWorkIntervalSeconds);
+  }
+  thread_.Start(options_.watch_pending_reports ? options_.initial_work_delay
+                                              : WorkerThread::kIndefiniteWait);
+
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+  if (pending_report_watcher_) {
+    pending_report_watcher_->Start();
+  }
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+
+  if (precompressor_ && options_.precompress_reports) {
+    precompressor_->Start();
+  }
 }
 
 void CrashReportUploadThread::Stop() {
+  {
+    base::AutoLock lock(active_uploads_lock_);
+    stopping_ = true;
+    for (ScopedActiveUpload* active_upload : active_uploads_) {
+      active_upload->Cancel();
+    }
+  }
+
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+  // The watcher signals thread_, so it must stop first.
+  if (pending_report_watcher_) {
+    pending_report_watcher_->Stop();
+    pending_report_watcher_.reset();
+  }
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+
+  if (precompressor_ && options_.precompress_reports) {
+    precompressor_->Stop();
+  }
+
   thread_.Stop();
+
+  SpillMemoryReports();
 }
 
 void CrashReportUploadThread::ProcessPendingReports() {
@@ -133,21 +582,30 @@ void CrashReportUploadThread::ProcessPendingReports() {
   // uploads complete (regardless of whether or not that succeeded).
   ScopedFunctionInvoker scoped_function_invoker(callback_);
 
+  // Reports passed to UploadFromMemory() that aren’t uploaded directly become
+  // known pending reports, so they’re processed along with those below.
+  ProcessMemoryReports();
+
   std::vector<UUID> known_report_uuids = known_pending_report_uuids_.Drain();
+  std::vector<CrashReportDatabase::Report> known_reports;
+  std::set<UUID> seen_report_uuids;
   for (const UUID& report_uuid : known_report_uuids) {
+    // A report may have been reported pending more than once, such as by a
+    // dump worker and again after its upload was canceled.
+    if (!seen_report_uuids.insert(report_uuid).second) {
+      continue;
+    }
+
     CrashReportDatabase::Report report;
     if (database_->LookUpCrashReport(report_uuid, &report) !=
         CrashReportDatabase::kNoError) {
       continue;
     }
+    known_reports.push_back(report);
+  }
 
-    ProcessPendingReport(report);
-
-    // Respect Stop() being called after at least one attempt to process a
-    // report.
-    if (!thread_.is_running()) {
-      return;
-    }
+  if (!ProcessReports(known_reports)) {
+    return;
   }
 
   // Known pending reports are always processed (above). The rest of this
@@ -166,17 +624,188 @@ void CrashReportUploadThread::ProcessPendingReports() {
     return;
   }
 
-  for (const CrashReportDatabase::Report& report : reports) {
-    if (std::find(known_report_uuids.begin(),
-                  known_report_uuids.end(),
-                  report.uuid) != known_report_uuids.end()) {
-      // An attempt to process the report already occurred above. The report is
-      // still pending, so upload must have failed. Don’t retry it immediately,
-      // it can wait until at least the next pass through this method.
+  // An attempt to process any known report already occurred above. If it is
+  // still pending, upload must have failed. Don’t retry it immediately, it can
+  // wait until at least the next pass through this method.
+  reports.erase(
+      std::remove_if(reports.begin(),
+                     reports.end(),
+                     [&known_report_uuids](
+                         const CrashReportDatabase::Report& report) {
+                       return std::find(known_report_uuids.begin(),
+                                        known_report_uuids.end(),
+                                        report.uuid) !=
+                              known_report_uuids.end();
+                     }),
+      reports.end());
+
+  ProcessReports(reports);
+}
+
+void CrashReportUploadThread::ProcessMemoryReports() {
+  while (true) {
+    {
+      base::AutoLock lock(active_uploads_lock_);
+      if (stopping_) {
+        break;
+      }
+    }
+
+    MemoryReport report;
+    {
+      base::AutoLock lock(memory_reports_lock_);
+      if (memory_reports_.empty()) {
+        return;
+      }
+      report = std::move(memory_reports_.front());
+      memory_reports_.pop_front();
+    }
+
+    // Whether and when these allow a report to be uploaded is decided from its
+    // record in the database, so such a report is processed from there.
+    bool uploads_enabled;
+    if (options_.rate_limit || options_.upload_policy ||
+        options_.tiered_uploads || options_.resumable_uploads ||
+        !database_->GetSettings()->GetUploadsEnabled(&uploads_enabled) ||
+        !uploads_enabled) {
+      UUID uuid;
+      if (SpillMemoryReport(std::move(report), &uuid)) {
+        known_pending_report_uuids_.Push(uuid);
+      }
+      continue;
+    }
+
+    std::string response_body;
+    uint64_t bytes_sent = 0;
+    const UploadResult upload_result =
+        UploadMemoryReport(report.new_report->ReportID(),
+                           report.minidump.get(),
+                           &response_body,
+                           &bytes_sent);
+    if (upload_result == UploadResult::kSuccess) {
+      // The report prepared in the database is removed, unused.
+      Metrics::CrashReportSize(
+          static_cast<FileOffset>(report.minidump->size()));
+      Metrics::CrashUploadAttempted(true);
       continue;
     }
 
-    ProcessPendingReport(report);
+    // A report whose upload failed is kept in the database, to be retried by a
+    // later check for pending reports. One whose upload was canceled is
+    // processed as soon as the thread is started again.
+    if (upload_result != UploadResult::kCanceled) {
+      Metrics::CrashUploadAttempted(false);
+    }
+    UUID uuid;
+    if (SpillMemoryReport(std::move(report), &uuid) &&
+        upload_result == UploadResult::kCanceled) {
+      known_pending_report_uuids_.Push(uuid);
+    }
+  }
+
+  SpillMemoryReports();
+}
+
+bool CrashReportUploadThread::SpillMemoryReport(MemoryReport report,
+                                                UUID* uuid) {
+  if (!report.minidump->WriteTo(report.new_report->Writer())) {
+    LOG(ERROR) << "Write failed";
+    return false;
+  }
+  report.minidump.reset();
+
+  if (database_->FinishedWritingCrashReport(std::move(report.new_report),
+                                            uuid) !=
+      CrashReportDatabase::kNoError) {
+    LOG(ERROR) << "FinishedWritingCrashReport failed";
+    return false;
+  }
+  return true;
+}
+
+void CrashReportUploadThread::SpillMemoryReports() {
+  while (true) {
+    MemoryReport report;
+    {
+      base::AutoLock lock(memory_reports_lock_);
+      if (memory_reports_.empty()) {
+        return;
+      }
+      report = std::move(memory_reports_.front());
+      memory_reports_.pop_front();
+    }
+
+    UUID uuid;
+    if (SpillMemoryReport(std::move(report), &uuid)) {
+      known_pending_report_uuids_.Push(uuid);
+    }
+  }
+}
+
+bool CrashReportUploadThread::ProcessReports(
+    const std::vector<CrashReportDatabase::Report>& unordered_reports) {
+  std::vector<CrashReportDatabase::Report> reports(unordered_reports);
+  if (options_.upload_policy) {
+    options_.upload_policy->Prioritize(database_, &reports);
+  }
+
+  if (!ProcessBatchedReports(&reports)) {
+    return false;
+  }
+
+  if (options_.upload_concurrency <= 1 || reports.size() <= 1) {
+    for (const CrashReportDatabase::Report& report : reports) {
+      ProcessPendingReport(report);
+
+      // Respect Stop() being called after at least one attempt to process a
+      // report.
+      if (!thread_.is_running()) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  {
+    base::AutoLock lock(upload_queue_lock_);
+    DCHECK(!upload_queue_);
+    upload_queue_ = &reports;
+    upload_queue_next_ = 0;
+  }
+
+  const size_t worker_count =
+      std::min(static_cast<size_t>(options_.upload_concurrency),
+               reports.size()) -
+      1;
+  std::vector<std::unique_ptr<UploadWorker>> workers;
+  for (size_t index = 0; index < worker_count; ++index) {
+    workers.push_back(std::make_unique<UploadWorker>(this));
+    workers.back()->Start();
+  }
+
+  ProcessQueuedReports();
+
+  for (const auto& worker : workers) {
+    worker->Join();
+  }
+
+  base::AutoLock lock(upload_queue_lock_);
+  upload_queue_ = nullptr;
+  return thread_.is_running();
+}
+
+void CrashReportUploadThread::ProcessQueuedReports() {
+  while (true) {
+    const CrashReportDatabase::Report* report;
+    {
+      base::AutoLock lock(upload_queue_lock_);
+      if (!upload_queue_ || upload_queue_next_ >= upload_queue_->size()) {
+        return;
+      }
+      report = &(*upload_queue_)[upload_queue_next_++];
+    }
+
+    ProcessPendingReport(*report);
 
     // Respect Stop() being called after at least one attempt to process a
     // report.
@@ -186,6 +815,185 @@ void CrashReportUploadThread::ProcessPendingReports() {
   }
 }
 
+bool CrashReportUploadThread::ProcessBatchedReports(
+    std::vector<CrashReportDatabase::Report>* reports) {
+  // Whether and when these allow a report to be uploaded is decided for each
+  // report on its own, so reports subject to them aren’t batched.
+  bool uploads_enabled;
+  if (!options_.batch_upload_size || options_.rate_limit ||
+      options_.upload_policy || options_.tiered_uploads ||
+      options_.resumable_uploads || !options_.upload_relay.empty() ||
+      !database_->GetSettings()->GetUploadsEnabled(&uploads_enabled) ||
+      !uploads_enabled) {
+    return true;
+  }
+
+  std::vector<CrashReportDatabase::Report> unbatched_reports;
+  std::vector<std::vector<CrashReportDatabase::Report>> batches(1);
+  uint64_t batch_size = 0;
+  for (const CrashReportDatabase::Report& report : *reports) {
+    if (report.total_size > options_.batch_upload_size) {
+      unbatched_reports.push_back(report);
+      continue;
+    }
+    if (batch_size + report.total_size > options_.batch_upload_size ||
+        batches.back().size() == kMaxBatchedReports) {
+      batches.emplace_back();
+      batch_size = 0;
+    }
+    batches.back().push_back(report);
+    batch_size += report.total_size;
+  }
+
+  for (const std::vector<CrashReportDatabase::Report>& batch : batches) {
+    if (batch.size() == 1) {
+      // A report alone in its batch is uploaded as usual.
+      unbatched_reports.push_back(batch.front());
+    } else if (batch.size() > 1) {
+      UploadBatch(batch);
+
+      // Respect Stop() being called after at least one attempt to upload a
+      // batch.
+      if (!thread_.is_running()) {
+        return false;
+      }
+    }
+  }
+
+  reports->swap(unbatched_reports);
+  return true;
+}
+
+void CrashReportUploadThread::UploadBatch(
+    const std::vector<CrashReportDatabase::Report>& batch) {
+  {
+    // Don’t begin another upload once Stop() has been called.
+    base::AutoLock lock(active_uploads_lock_);
+    if (stopping_) {
+      return;
+    }
+  }
+
+  Metrics::ScopedOperationTimer upload_timer(Metrics::TimedOperation::kUpload);
+
+  // The reports obtained for uploading, and whether each was added to the
+  // batch. The files outlive the body stream given to the transport.
+  std::vector<const CrashReportDatabase::Report*> reports;
+  std::vector<std::unique_ptr<const CrashReportDatabase::UploadReport>>
+      upload_reports;
+  std::vector<std::unique_ptr<StringFile>> decompressed_files;
+  std::vector<bool> batched;
+  std::vector<UUID> batched_uuids;
+  HTTPMultipartBuilder http_multipart_builder;
+  ConfigureMultipartBuilder(&http_multipart_builder);
+
+  // Only the form data that all of the batched reports share is used in the
+  // URL.
+  std::map<std::string, std::string> common_parameters;
+  for (const CrashReportDatabase::Report& report : batch) {
+#if BUILDFLAG(IS_IOS)
+    if (ShouldRateLimitRetry(report)) {
+      continue;
+    }
+#endif  // BUILDFLAG(IS_IOS)
+
+    std::unique_ptr<const CrashReportDatabase::UploadReport> upload_report;
+    if (!GetReportForUploading(report, &upload_report)) {
+      continue;
+    }
+
+    auto decompressed_file = std::make_unique<StringFile>();
+    std::map<std::string, std::string> parameters;
+    const bool added =
+        AddReportToMultipartBuilder(report.uuid,
+                                    upload_report->Reader(),
+                                    nullptr,
+                                    upload_report->GetAttachments(),
+                                    BatchUploadKeyPrefix(report.uuid),
+                                    decompressed_file.get(),
+                                    &http_multipart_builder,
+                                    &parameters);
+    if (added) {
+      if (batched_uuids.empty()) {
+        common_parameters = parameters;
+      } else {
+        for (auto it = common_parameters.begin();
+             it != common_parameters.end();) {
+          const auto parameter = parameters.find(it->first);
+          if (parameter == parameters.end() ||
+              parameter->second != it->second) {
+            it = common_parameters.erase(it);
+          } else {
+            ++it;
+          }
+        }
+      }
+      batched_uuids.push_back(report.uuid);
+    }
+
+    reports.push_back(&report);
+    upload_reports.push_back(std::move(upload_report));
+    decompressed_files.push_back(std::move(decompressed_file));
+    batched.push_back(added);
+  }
+
+  UploadResult batch_result = UploadResult::kPermanentFailure;
+  std::map<UUID, BatchUploadResult> batch_results;
+  if (!batched_uuids.empty()) {
+    http_multipart_builder.SetFormData(kBatchUploadReportsKey,
+                                       BatchUploadReportsValue(batched_uuids));
+
+    std::map<std::string, std::string> encoded_parameters;
+    for (const auto& kv : common_parameters) {
+      encoded_parameters[URLEncode(kv.first)] = URLEncode(kv.second);
+    }
+
+    HTTPHeaders content_headers;
+    http_multipart_builder.PopulateContentHeaders(&content_headers);
+    std::string response_body;
+    uint64_t bytes_sent = 0;
+    batch_result = SendUpload(UploadURL(encoded_parameters),
+                              content_headers,
+                              http_multipart_builder.GetBodyStream(),
+                              &response_body,
+                              &bytes_sent,
+                              nullptr);
+    if (batch_result == UploadResult::kSuccess) {
+      batch_results = ParseBatchUploadResponse(response_body);
+    }
+  }
+
+  for (size_t index = 0; index < reports.size(); ++index) {
+    UploadResult upload_result = UploadResult::kPermanentFailure;
+    std::string id;
+    if (batched[index]) {
+      upload_result = batch_result;
+      if (batch_result == UploadResult::kSuccess) {
+        // A report that the server didn’t mention is treated as if it had
+        // asked for the report to be retried.
+        const auto it = batch_results.find(reports[index]->uuid);
+        if (it == batch_results.end()) {
+          upload_result = UploadResult::kRetry;
+        } else {
+          switch (it->second.status) {
+            case BatchUploadResult::Status::kUploaded:
+              id = it->second.id;
+              break;
+            case BatchUploadResult::Status::kRetry:
+              upload_result = UploadResult::kRetry;
+              break;
+            case BatchUploadResult::Status::kRejected:
+              upload_result = UploadResult::kPermanentFailure;
+              break;
+          }
+        }
+      }
+    }
+    RecordUploadResult(
+        *reports[index], std::move(upload_reports[index]), upload_result, id);
+  }
+}
+
 void CrashReportUploadThread::ProcessPendingReport(
     const CrashReportDatabase::Report& report) {
 #if BUILDFLAG(IS_APPLE)
@@ -205,27 +1013,118 @@ void CrashReportUploadThread::ProcessPendingReport(
     return;
   }
 
-  if (ShouldRateLimitUpload(report))
+  UploadPolicy* const upload_policy = report.upload_explicitly_requested
+                                          ? nullptr
+                                          : options_.upload_policy.get();
+  if (upload_policy && !upload_policy->BeginUpload(report)) {
+    // Leave the report pending, to be considered again by a later pass.
     return;
+  }
+
+  uint64_t bytes_sent = 0;
+  if (options_.rate_limit && !report.upload_explicitly_requested) {
+    // Rate-limited uploads are made one at a time, even when uploads are
+    // concurrent, so that each sees the upload attempt time recorded by the
+    // previous one.
+    base::AutoLock lock(rate_limit_lock_);
+    if (!ShouldRateLimitUpload(report)) {
+      UploadPendingReport(report, &bytes_sent);
+    }
+  } else {
+    UploadPendingReport(report, &bytes_sent);
+  }
+
+  if (upload_policy) {
+    upload_policy->EndUpload(report, bytes_sent);
+  }
+}
 
+void CrashReportUploadThread::UploadPendingReport(
+    const CrashReportDatabase::Report& report,
+    uint64_t* bytes_sent) {
 #if BUILDFLAG(IS_IOS)
   if (ShouldRateLimitRetry(report))
     return;
 #endif  // BUILDFLAG(IS_IOS)
 
+  {
+    // Don’t begin another upload once Stop() has been called.
+    base::AutoLock lock(active_uploads_lock_);
+    if (stopping_) {
+      return;
+    }
+  }
+
   std::unique_ptr<const CrashReportDatabase::UploadReport> upload_report;
+  if (!GetReportForUploading(report, &upload_report)) {
+    return;
+  }
+
+  std::string response_body;
+  UploadResult upload_result;
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+  if (relay_ &&
+      RelayReport(upload_report.get(), &upload_result, &response_body)) {
+    RecordUploadResult(
+        report, std::move(upload_report), upload_result, response_body);
+    return;
+  }
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+
+  if (options_.upload_precheck &&
+      ServerHasReport(upload_report.get(), &response_body)) {
+    // The server got the report from an earlier upload whose response was
+    // lost, or from another handler sharing the database.
+    upload_result = UploadResult::kSuccess;
+  } else if (options_.tiered_uploads) {
+    bool full_minidump_requested = false;
+    upload_result = UploadReport(upload_report.get(),
+                                 MinidumpTier::kReduced,
+                                 &response_body,
+                                 bytes_sent,
+                                 &full_minidump_requested);
+
+    // The server has the report once the reduced minidump is uploaded, so the
+    // report is complete even if the full minidump then fails to upload. The
+    // response to the reduced minidump, which identifies the report, is the
+    // one recorded.
+    if (upload_result == UploadResult::kSuccess && full_minidump_requested) {
+      std::string full_response_body;
+      if (UploadReport(upload_report.get(),
+                       MinidumpTier::kFull,
+                       &full_response_body,
+                       bytes_sent,
+                       nullptr) != UploadResult::kSuccess) {
+        LOG(WARNING) << "full minidump upload failed";
+      }
+    }
+  } else {
+    upload_result = UploadReport(upload_report.get(),
+                                 MinidumpTier::kFull,
+                                 &response_body,
+                                 bytes_sent,
+                                 nullptr);
+  }
+  RecordUploadResult(
+      report, std::move(upload_report), upload_result, response_body);
+}
+
+bool CrashReportUploadThread::GetReportForUploading(
+    const CrashReportDatabase::Report& report,
+    std::unique_ptr<const CrashReportDatabase::UploadReport>* upload_report) {
   CrashReportDatabase::OperationStatus status =
-      database_->GetReportForUploading(report.uuid, &upload_report);
+      database_->GetReportForUploading(report.uuid, upload_report);
   switch (status) {
     case CrashReportDatabase::kNoError:
-      break;
+      return true;
 
     case CrashReportDatabase::kBusyError:
     case CrashReportDatabase::kReportNotFound:
       // Someone else may have gotten to it first. If they’re working on it now,
       // this will be kBusyError. If they’ve already finished with it, it’ll be
       // kReportNotFound.
-      return;
+      return false;
 
     case CrashReportDatabase::kFileSystemError:
     case CrashReportDatabase::kDatabaseError:
@@ -233,24 +1132,30 @@ void CrashReportUploadThread::ProcessPendingReport(
       // to at least try to get the report out of the way.
       database_->SkipReportUpload(report.uuid,
                                   Metrics::CrashSkippedReason::kDatabaseError);
-      return;
+      return false;
 
     case CrashReportDatabase::kCannotRequestUpload:
       NOTREACHED();
-      return;
+      return false;
   }
+  return false;
+}
 
-  std::string response_body;
-  UploadResult upload_result =
-      UploadReport(upload_report.get(), &response_body);
+void CrashReportUploadThread::RecordUploadResult(
+    const CrashReportDatabase::Report& report,
+    std::unique_ptr<const CrashReportDatabase::UploadReport> upload_report,
+    UploadResult upload_result,
+    const std::string& response_body) {
   switch (upload_result) {
     case UploadResult::kSuccess:
       database_->RecordUploadComplete(std::move(upload_report), response_body);
+      RemovePrecompressedReport(report.uuid);
       break;
     case UploadResult::kPermanentFailure:
       upload_report.reset();
       database_->SkipReportUpload(
           report.uuid, Metrics::CrashSkippedReason::kPrepareForUploadFailed);
+      RemovePrecompressedReport(report.uuid);
       break;
     case UploadResult::kRetry:
 #if BUILDFLAG(IS_IOS)
@@ -258,9 +1163,11 @@ void CrashReportUploadThread::ProcessPendingReport(
         upload_report.reset();
         database_->SkipReportUpload(report.uuid,
                                     Metrics::CrashSkippedReason::kUploadFailed);
+        RemovePrecompressedReport(report.uuid);
       } else {
         Metrics::CrashUploadSkipped(
             Metrics::CrashSkippedReason::kUploadFailedButCanRetry);
+        base::AutoLock lock(retry_uuid_time_map_lock_);
         retry_uuid_time_map_[report.uuid] =
             time(nullptr) +
             (1 << upload_report->upload_attempts) * kRetryWorkIntervalSeconds;
@@ -273,74 +1180,211 @@ void CrashReportUploadThread::ProcessPendingReport(
       // too many times.
       database_->SkipReportUpload(report.uuid,
                                   Metrics::CrashSkippedReason::kUploadFailed);
+      RemovePrecompressedReport(report.uuid);
 #endif
       break;
+    case UploadResult::kCanceled:
+      // Leave the report pending. The attempt is still recorded.
+      upload_report.reset();
+      break;
   }
 }
 
 CrashReportUploadThread::UploadResult CrashReportUploadThread::UploadReport(
     const CrashReportDatabase::UploadReport* report,
-    std::string* response_body) {
-  std::map<std::string, std::string> parameters;
-
-  FileReader* reader = report->Reader();
-  FileOffset start_offset = reader->SeekGet();
-  if (start_offset < 0) {
-    return UploadResult::kPermanentFailure;
-  }
+    MinidumpTier tier,
+    std::string* response_body,
+    uint64_t* bytes_sent,
+    bool* full_minidump_requested) {
+  DCHECK(options_.tiered_uploads || tier == MinidumpTier::kFull);
+  TraceEvents::ScopedContext trace_context;
+  TraceEvents::SetReportID(report->uuid);
+  Metrics::ScopedOperationTimer upload_timer(Metrics::TimedOperation::kUpload);
 
-  // Ignore any errors that might occur when attempting to interpret the
-  // minidump file. This may result in its being uploaded with few or no
-  // parameters, but as long as there’s a dump file, the server can decide what
-  // to do with it.
-  ProcessSnapshotMinidump minidump_process_snapshot;
-  if (minidump_process_snapshot.Initialize(reader)) {
-    parameters =
-        BreakpadHTTPFormParametersFromMinidump(&minidump_process_snapshot);
+  if (full_minidump_requested) {
+    *full_minidump_requested = false;
   }
 
-  if (!reader->SeekSet(start_offset)) {
-    return UploadResult::kPermanentFailure;
-  }
+  // The form data, with both keys and values URL-encoded, for use in the URL.
+  std::map<std::string, std::string> encoded_parameters;
 
+  // An upload compressed ahead of time is sent as it is. These outlive the
+  // body stream given to http_transport, which may still be reading from them
+  // as it is destroyed.
+  ReportPrecompressor::Upload precompressed_upload;
+  StringFile decompressed_file;
+  StringFile reduced_file;
+  StringFile delta_file;
   HTTPMultipartBuilder http_multipart_builder;
-  http_multipart_builder.SetGzipEnabled(options_.upload_gzip);
+  DeltaUploadBases::Upload delta_upload;
+
+  // A resumable upload must send the same bytes on every attempt, so it is
+  // always sent from a precompressed upload. If the report can’t be
+  // precompressed, it is uploaded in the usual way. Precompressed uploads carry
+  // the full minidump.
+  bool reduced = tier == MinidumpTier::kReduced;
+  if (precompressor_ && options_.resumable_uploads && !reduced) {
+    precompressor_->Precompress(*report);
+  }
+  const bool precompressed =
+      precompressor_ && !reduced &&
+      ReportPrecompressor::Open(database_, report->uuid, &precompressed_upload);
 
-  static constexpr char kMinidumpKey[] = "upload_file_minidump";
+  HTTPHeaders content_headers;
+  std::unique_ptr<HTTPBodyStream> body_stream;
+  if (precompressed) {
+    content_headers[kContentType] = precompressed_upload.content_type;
+    content_headers[kContentEncoding] = "gzip";
+    body_stream = std::make_unique<FileReaderHTTPBodyStream>(
+        precompressed_upload.body.get());
+    encoded_parameters = std::move(precompressed_upload.encoded_parameters);
+  } else {
+    ConfigureMultipartBuilder(&http_multipart_builder);
 
-  for (const auto& kv : parameters) {
-    if (kv.first == kMinidumpKey) {
-      LOG(WARNING) << "reserved key " << kv.first << ", discarding value "
-                   << kv.second;
+    FileReaderInterface* reader = report->Reader();
+    std::map<std::string, FileReader*> attachments;
+    if (reduced) {
+      // A report whose minidump can’t be reduced still needs to be uploaded, so
+      // it’s uploaded in full.
+      if (WriteReducedMinidump(reader, &reduced_file) &&
+          reduced_file.SeekSet(0)) {
+        reader = &reduced_file;
+      } else {
+        LOG(WARNING) << "uploading full minidump, reduction failed";
+        reduced = false;
+        attachments = report->GetAttachments();
+      }
     } else {
-      http_multipart_builder.SetFormData(kv.first, kv.second);
+      attachments = report->GetAttachments();
+
+      // A report that can’t be uploaded as a delta is uploaded in full.
+      if (delta_bases_ &&
+          (!delta_bases_->WriteDeltaMinidump(
+               report->uuid, reader, &delta_file, &delta_upload) ||
+           !delta_file.SeekSet(0))) {
+        delta_upload.references.clear();
+      }
+    }
+
+    // The form data is obtained from the report’s minidump even when a delta
+    // minidump, which may leave out the modules that carry it, is uploaded.
+    std::map<std::string, std::string> parameters;
+    if (!AddReportToMultipartBuilder(report->uuid,
+                                     reader,
+                                     delta_upload.references.empty()
+                                         ? nullptr
+                                         : &delta_file,
+                                     attachments,
+                                     std::string(),
+                                     &decompressed_file,
+                                     &http_multipart_builder,
+                                     &parameters)) {
+      return UploadResult::kPermanentFailure;
     }
+    if (options_.tiered_uploads) {
+      http_multipart_builder.SetFormData(kMinidumpTierKey,
+                                         reduced ? "reduced" : "full");
+    }
+    if (!delta_upload.references.empty()) {
+      http_multipart_builder.SetFormData(
+          DeltaUploadBases::kReferencesKey,
+          DeltaUploadBases::FormatReferences(delta_upload.references));
+    }
+    for (const auto& kv : parameters) {
+      encoded_parameters[URLEncode(kv.first)] = URLEncode(kv.second);
+    }
+
+    http_multipart_builder.PopulateContentHeaders(&content_headers);
+    body_stream = http_multipart_builder.GetBodyStream();
+  }
+
+  const std::string url = UploadURL(encoded_parameters);
+  if (precompressed && options_.resumable_uploads) {
+    return UploadResumable(report->uuid,
+                           url,
+                           content_headers[kContentType],
+                           precompressed_upload.body.get(),
+                           response_body,
+                           bytes_sent);
   }
 
-  for (const auto& it : report->GetAttachments()) {
-    http_multipart_builder.SetFileAttachment(
-        it.first, it.first, it.second, "application/octet-stream");
+  const UploadResult upload_result =
+      SendUpload(url,
+                 content_headers,
+                 std::move(body_stream),
+                 response_body,
+                 bytes_sent,
+                 reduced ? full_minidump_requested : nullptr);
+  if (delta_bases_ && upload_result != UploadResult::kCanceled) {
+    delta_bases_->RecordUpload(delta_upload,
+                               upload_result == UploadResult::kSuccess);
   }
+  return upload_result;
+}
 
-  http_multipart_builder.SetFileAttachment(kMinidumpKey,
-                                           report->uuid.ToString() + ".dmp",
-                                           reader,
-                                           "application/octet-stream");
+CrashReportUploadThread::UploadResult
+CrashReportUploadThread::UploadMemoryReport(const UUID& uuid,
+                                            ChunkedStringFile* minidump,
+                                            std::string* response_body,
+                                            uint64_t* bytes_sent) {
+  TraceEvents::ScopedContext trace_context;
+  TraceEvents::SetReportID(uuid);
+  Metrics::ScopedOperationTimer upload_timer(Metrics::TimedOperation::kUpload);
 
-  std::unique_ptr<HTTPTransport> http_transport(HTTPTransport::Create());
-  if (!http_transport) {
+  // These outlive the body stream given to the transport.
+  StringFile decompressed_file;
+  HTTPMultipartBuilder http_multipart_builder;
+  ConfigureMultipartBuilder(&http_multipart_builder);
+
+  std::map<std::string, std::string> parameters;
+  if (!minidump->SeekSet(0) ||
+      !AddReportToMultipartBuilder(uuid,
+                                   minidump,
+                                   nullptr,
+                                   std::map<std::string, FileReader*>(),
+                                   std::string(),
+                                   &decompressed_file,
+                                   &http_multipart_builder,
+                                   &parameters)) {
     return UploadResult::kPermanentFailure;
   }
+  std::map<std::string, std::string> encoded_parameters;
+  for (const auto& kv : parameters) {
+    encoded_parameters[URLEncode(kv.first)] = URLEncode(kv.second);
+  }
 
   HTTPHeaders content_headers;
   http_multipart_builder.PopulateContentHeaders(&content_headers);
-  for (const auto& content_header : content_headers) {
-    http_transport->SetHeader(content_header.first, content_header.second);
+  return SendUpload(UploadURL(encoded_parameters),
+                    content_headers,
+                    http_multipart_builder.GetBodyStream(),
+                    response_body,
+                    bytes_sent,
+                    nullptr);
+}
+
+void CrashReportUploadThread::ConfigureMultipartBuilder(
+    HTTPMultipartBuilder* http_multipart_builder) {
+  // Zstandard compression is only used once the server has advertised that it
+  // accepts it. Until then, fall back to gzip at its default level, since the
+  // configured level may not be valid for gzip.
+  if (options_.upload_compression == HTTPMultipartBuilder::Compression::kZstd &&
+      !(ZstdHTTPBodyStream::IsSupported() && server_accepts_zstd_)) {
+    http_multipart_builder->SetCompression(
+        HTTPMultipartBuilder::Compression::kGzip);
+  } else {
+    http_multipart_builder->SetCompression(options_.upload_compression,
+                                           options_.upload_compression_level);
+    http_multipart_builder->SetZstdDictionary(
+        options_.upload_compression_dictionary.get());
   }
-  http_transport->SetBodyStream(http_multipart_builder.GetBodyStream());
-  // TODO(mark): The timeout should be configurable by the client.
-  http_transport->SetTimeout(internal::kUploadReportTimeoutSeconds);
+  http_multipart_builder->SetCompressionThreads(
+      options_.upload_compression_threads);
+  http_multipart_builder->SetPipelineEnabled(options_.upload_pipeline);
+}
 
+std::string CrashReportUploadThread::UploadURL(
+    const std::map<std::string, std::string>& encoded_parameters) {
   std::string url = url_;
   if (options_.identify_client_via_url) {
     // Add parameters to the URL which identify the client to the server.
@@ -354,27 +1398,232 @@ CrashReportUploadThread::UploadResult CrashReportUploadThread::UploadReport(
     };
 
     for (const auto& parameter_mapping : kURLParameterMappings) {
-      const auto it = parameters.find(parameter_mapping.key);
-      if (it != parameters.end()) {
+      // The keys are all unchanged by URL encoding.
+      const auto it = encoded_parameters.find(parameter_mapping.key);
+      if (it != encoded_parameters.end()) {
         url.append(
             base::StringPrintf("%c%s=%s",
                                url.find('?') == std::string::npos ? '?' : '&',
                                parameter_mapping.url_field_name,
-                               URLEncode(it->second).c_str()));
+                               it->second.c_str()));
       }
     }
   }
+  return url;
+}
+
+std::unique_ptr<HTTPTransport> CrashReportUploadThread::CreateTransport(
+    const std::string& url) {
+  std::unique_ptr<HTTPTransport> http_transport(HTTPTransport::Create());
+  if (!http_transport) {
+    return nullptr;
+  }
   http_transport->SetURL(url);
+  // TODO(mark): The timeout should be configurable by the client.
+  http_transport->SetTimeout(internal::kUploadReportTimeoutSeconds);
+  http_transport->SetKeepAliveTimeout(options_.upload_keep_alive_timeout);
+  http_transport->SetHTTP2(options_.upload_http2);
+  return http_transport;
+}
+
+CrashReportUploadThread::UploadResult CrashReportUploadThread::SendUpload(
+    const std::string& url,
+    const HTTPHeaders& content_headers,
+    std::unique_ptr<HTTPBodyStream> body_stream,
+    std::string* response_body,
+    uint64_t* bytes_sent,
+    bool* full_minidump_requested) {
+  std::unique_ptr<HTTPTransport> http_transport(CreateTransport(url));
+  if (!http_transport) {
+    return UploadResult::kPermanentFailure;
+  }
+
+  for (const auto& content_header : content_headers) {
+    http_transport->SetHeader(content_header.first, content_header.second);
+  }
+  http_transport->SetBodyStream(
+      std::make_unique<CountingHTTPBodyStream>(std::move(body_stream),
+                                               bytes_sent));
+
+  ScopedActiveUpload active_upload(
+      this, [&http_transport]() { http_transport->Cancel(); });
+  const bool success = http_transport->ExecuteSynchronously(response_body);
+  if (!success && active_upload.canceled()) {
+    return UploadResult::kCanceled;
+  }
+
+  // A server that doesn’t accept a request’s content coding may respond with
+  // an Accept-Encoding header field naming those that it does (RFC 7694 §3),
+  // so this is noticed even when the upload fails, and the upload is retried
+  // with a coding that the server accepts.
+  std::string accept_encoding;
+  if (options_.upload_compression == HTTPMultipartBuilder::Compression::kZstd &&
+      http_transport->GetResponseHeader("Accept-Encoding", &accept_encoding)) {
+    server_accepts_zstd_ = AcceptsContentCoding(accept_encoding, "zstd");
+  }
 
-  if (!http_transport->ExecuteSynchronously(response_body)) {
+  std::string requested_tier;
+  if (success && full_minidump_requested &&
+      http_transport->GetResponseHeader(kMinidumpTierHeader, &requested_tier)) {
+    *full_minidump_requested = RequestsFullMinidump(requested_tier);
+  }
+
+  return success ? UploadResult::kSuccess : UploadResult::kRetry;
+}
+
+bool CrashReportUploadThread::ServerHasReport(
+    const CrashReportDatabase::UploadReport* report,
+    std::string* response_body) {
+  std::string digest;
+  if (!DigestReport(report->Reader(), &digest)) {
+    return false;
+  }
+
+  std::unique_ptr<HTTPTransport> http_transport(CreateTransport(url_));
+  if (!http_transport) {
+    return false;
+  }
+  http_transport->SetMethod("HEAD");
+  http_transport->SetHeader(kReportIDHeader, report->uuid.ToString());
+  http_transport->SetHeader(kReportDigestHeader, digest);
+  http_transport->SetBodyStream(std::make_unique<StringHTTPBodyStream>(""));
+
+  // A server that doesn’t know about this check, or doesn’t have the report,
+  // responds without the header field, and the report is uploaded.
+  ScopedActiveUpload active_upload(
+      this, [&http_transport]() { http_transport->Cancel(); });
+  std::string unused_body;
+  return http_transport->ExecuteSynchronously(&unused_body) &&
+         http_transport->GetResponseHeader(kReportPresentHeader,
+                                           response_body);
+}
+
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+
+bool CrashReportUploadThread::RelayReport(
+    const CrashReportDatabase::UploadReport* report,
+    UploadResult* upload_result,
+    std::string* response_body) {
+  // A report whose minidump can’t be read is uploaded directly, which handles
+  // the failure as it would for any other upload.
+  FileReader* reader = report->Reader();
+  const bool compressed = IsCompressedMinidump(reader);
+  ProcessSnapshotMinidump minidump_process_snapshot;
+  if (!reader->SeekSet(0) || !minidump_process_snapshot.Initialize(reader)) {
+    return false;
+  }
+  const std::map<std::string, std::string> parameters =
+      BreakpadHTTPFormParametersFromMinidump(&minidump_process_snapshot);
+
+  std::map<std::string, std::string> encoded_parameters;
+  for (const auto& kv : parameters) {
+    encoded_parameters[URLEncode(kv.first)] = URLEncode(kv.second);
+  }
+
+  std::map<std::string, FileHandle> attachments;
+  for (const auto& attachment : report->GetAttachments()) {
+    attachments[attachment.first] = attachment.second->file_handle();
+  }
+
+  switch (relay_->Relay(report->uuid,
+                        UploadURL(encoded_parameters),
+                        reader->file_handle(),
+                        compressed,
+                        parameters,
+                        attachments,
+                        response_body)) {
+    case ReportRelay::Result::kAccepted:
+      *upload_result = UploadResult::kSuccess;
+      return true;
+    case ReportRelay::Result::kRejected:
+      LOG(WARNING) << "relay rejected report";
+      *upload_result = UploadResult::kPermanentFailure;
+      return true;
+    case ReportRelay::Result::kUnavailable:
+      return false;
+  }
+  return false;
+}
+
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+
+CrashReportUploadThread::UploadResult CrashReportUploadThread::UploadResumable(
+    const UUID& uuid,
+    const std::string& url,
+    const std::string& content_type,
+    FileReaderInterface* body,
+    std::string* response_body,
+    uint64_t* bytes_sent) {
+  const FileOffset body_start = body->SeekGet();
+  const FileOffset body_end = body->Seek(0, SEEK_END);
+  if (body_start < 0 || body_end < body_start ||
+      body->Seek(body_start, SEEK_SET) != body_start) {
     return UploadResult::kRetry;
   }
+  const FileOffset size = body_end - body_start;
 
-  return UploadResult::kSuccess;
+  HTTPResumableUpload upload;
+  upload.SetMetadata("filename", uuid.ToString());
+  upload.SetMetadata("filetype", content_type);
+  upload.SetMetadata("contentencoding", "gzip");
+  upload.SetTransportFactory(
+      [this](const std::string& url) { return CreateTransport(url); });
+  ScopedActiveUpload active_upload(this, [&upload]() { upload.Cancel(); });
+
+  // An upload that the server no longer knows is created again, once.
+  for (int attempt = 0; attempt < 2; ++attempt) {
+    std::string location;
+    if (!ReportPrecompressor::GetUploadLocation(database_, uuid, &location)) {
+      // The location is recorded before anything is sent, so that a later
+      // attempt can resume the upload even if this process doesn’t survive.
+      if (!upload.Create(url, size, &location) ||
+          !ReportPrecompressor::SetUploadLocation(database_, uuid, location)) {
+        return active_upload.canceled() ? UploadResult::kCanceled
+                                        : UploadResult::kRetry;
+      }
+    }
+
+    if (body->Seek(body_start, SEEK_SET) != body_start) {
+      return UploadResult::kRetry;
+    }
+    // The part of the body that the server already has isn’t sent again, but
+    // isn’t known here, so all of it is counted.
+    *bytes_sent += size;
+    switch (upload.Send(location, body, size, response_body)) {
+      case HTTPResumableUpload::Result::kSuccess:
+        return UploadResult::kSuccess;
+      case HTTPResumableUpload::Result::kRetry:
+        return active_upload.canceled() ? UploadResult::kCanceled
+                                        : UploadResult::kRetry;
+      case HTTPResumableUpload::Result::kUploadGone:
+        ReportPrecompressor::SetUploadLocation(database_, uuid, std::string());
+        break;
+    }
+  }
+  return UploadResult::kRetry;
+}
+
+void CrashReportUploadThread::RemovePrecompressedReport(const UUID& uuid) {
+  if (precompressor_) {
+    ReportPrecompressor::Remove(database_, uuid);
+  }
 }
 
 void CrashReportUploadThread::DoWork(const WorkerThread* thread) {
   ProcessPendingReports();
+
+  // The periodic checks are what retry failed uploads, so they’re only made
+  // less often while the database is watched and no report remains pending.
+  if (pending_reports_watched_) {
+    std::vector<CrashReportDatabase::Report> reports;
+    const bool retry_pending =
+        database_->GetPendingReports(&reports) !=
+            CrashReportDatabase::kNoError ||
+        !reports.empty();
+    thread_.SetWorkInterval(retry_pending ? kRetryWorkIntervalSeconds
+                                          : kNotifiedRetryWorkIntervalSeconds);
+  }
 }
 
 bool CrashReportUploadThread::ShouldRateLimitUpload(
@@ -416,6 +1665,7 @@ bool CrashReportUploadThread::ShouldRateLimitUpload(
 #if BUILDFLAG(IS_IOS)
 bool CrashReportUploadThread::ShouldRateLimitRetry(
     const CrashReportDatabase::Report& report) {
+  base::AutoLock lock(retry_uuid_time_map_lock_);
   if (retry_uuid_time_map_.find(report.uuid) != retry_uuid_time_map_.end()) {
     time_t now = time(nullptr);
     if (now < retry_uuid_time_map_[report.uuid]) {
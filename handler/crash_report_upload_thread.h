@@ -15,20 +15,43 @@
 #ifndef CRASHPAD_HANDLER_CRASH_REPORT_UPLOAD_THREAD_H_
 #define CRASHPAD_HANDLER_CRASH_REPORT_UPLOAD_THREAD_H_
 
+#include <atomic>
+#include <deque>
 #include <functional>
+#include <map>
 #include <memory>
+#include <set>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
+#include "base/synchronization/lock.h"
 #include "build/build_config.h"
 #include "client/crash_report_database.h"
+#include "handler/delta_upload_bases.h"
+#include "handler/report_precompressor.h"
+#include "handler/upload_policy.h"
+#include "util/file/chunked_string_file.h"
+#include "util/file/file_reader.h"
 #include "util/misc/uuid.h"
-#include "util/stdlib/thread_safe_vector.h"
+#include "util/net/http_body.h"
+#include "util/net/http_body_zstd.h"
+#include "util/net/http_headers.h"
+#include "util/net/http_multipart_builder.h"
+#include "util/stdlib/lock_free_queue.h"
 #include "util/thread/stoppable.h"
+#include "util/thread/work_scheduler.h"
 #include "util/thread/worker_thread.h"
 
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+#include "handler/linux/report_relay.h"
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+
 namespace crashpad {
 
+class HTTPTransport;
+
 //! \brief A thread that processes pending crash reports in a
 //!     CrashReportDatabase by uploading them or marking them as completed
 //!     without upload, as desired.
@@ -42,6 +65,10 @@ namespace crashpad {
 //! It also catches reports that are added without a ReportPending() signal
 //! being caught. This may happen if crash reports are added to the database by
 //! other processes.
+//!
+//! Where the database supports it, objects of this class can also watch the
+//! database for reports made pending by other processes, and process them as
+//! soon as they are noticed.
 class CrashReportUploadThread : public WorkerThread::Delegate,
                                 public Stoppable {
  public:
@@ -54,14 +81,145 @@ class CrashReportUploadThread : public WorkerThread::Delegate,
     //! Whether uploads should be throttled to a (currently hardcoded) rate.
     bool rate_limit;
 
-    //! Whether uploads should use `gzip` compression.
-    bool upload_gzip;
+    //! The compression to use for uploads. Zstandard compression is only used
+    //! once the server has advertised support for it with an
+    //! `Accept-Encoding` header field in a response, as described by RFC 7694,
+    //! and only if the build supports it. Until then, `gzip` compression is
+    //! used instead.
+    HTTPMultipartBuilder::Compression upload_compression =
+        HTTPMultipartBuilder::Compression::kGzip;
+
+    //! The compression level to use for uploads, or `0` for the default level
+    //! of #upload_compression. If `gzip` compression is used in place of
+    //! Zstandard compression, `gzip`’s default level is used.
+    int upload_compression_level = 0;
+
+    //! The number of threads on which each upload is compressed. This only
+    //! affects `gzip` compression. See
+    //! HTTPMultipartBuilder::SetCompressionThreads().
+    unsigned int upload_compression_threads = 1;
+
+    //! The dictionary used for Zstandard compression, or `nullptr` to compress
+    //! without one. Its ID is sent with each upload that uses it. This has no
+    //! effect while `gzip` compression is used in place of Zstandard
+    //! compression. See HTTPMultipartBuilder::SetZstdDictionary().
+    std::shared_ptr<const ZstdDictionary> upload_compression_dictionary;
 
     //! Whether to periodically check for new pending reports not already known
     //! to exist. When `false`, only an initial upload attempt will be made for
     //! reports known to exist by having been added by the ReportPending()
     //! method. No scans for new pending reports will be conducted.
     bool watch_pending_reports;
+
+    //! The maximum number of reports to upload at the same time. With a value
+    //! greater than 1, each batch of pending reports is shared among this
+    //! many threads. Uploads subject to rate limiting are still made one at a
+    //! time.
+    unsigned int upload_concurrency = 1;
+
+    //! The number of seconds for which a connection to the upload server is
+    //! kept open after an upload, so that it can be reused by the next one.
+    //! When `0`, a new connection is made for each upload.
+    double upload_keep_alive_timeout = 0;
+
+    //! Whether uploads may be made using HTTP/2, so that concurrent uploads
+    //! share a single connection. See HTTPTransport::SetHTTP2().
+    bool upload_http2 = false;
+
+    //! Whether to read, compress, and send each upload on separate threads. See
+    //! HTTPMultipartBuilder::SetPipelineEnabled().
+    bool upload_pipeline = false;
+
+    //! Whether to ask the server if it already has each report before
+    //! uploading it, as it may after an upload whose response was lost, or
+    //! when several handlers share a database. The check is a `HEAD` request
+    //! to the upload URL with `Crashpad-Report-ID` and `Crashpad-Report-Digest`
+    //! header fields, giving the report’s UUID and the size and CRC-32 of its
+    //! minidump. A server that has the report responds with a
+    //! `Crashpad-Report-Present` header field, whose value is taken as the
+    //! upload’s response body, and the report isn’t uploaded again. This isn’t
+    //! done for reports uploaded in batches or from memory.
+    bool upload_precheck = false;
+
+    //! Whether to watch for reports made pending by other processes, and
+    //! process them as soon as they are noticed. This is only used when
+    //! #watch_pending_reports is `true`. If the database can be watched, the
+    //! periodic checks for new pending reports are made less often, and
+    //! remain mostly to retry failed uploads. Watching is currently only
+    //! supported on Linux, ChromeOS, and Android.
+    bool notify_pending_reports = false;
+
+    //! The number of seconds to wait before the first check for pending
+    //! reports. This is only used when #watch_pending_reports is `true`. A
+    //! call to ReportPending() or a report noticed by
+    //! #notify_pending_reports ends the wait early.
+    double initial_work_delay = 0;
+
+    //! Whether to compress the uploads of pending reports ahead of time, on a
+    //! low-priority thread, so that uploads and their retries send bytes that
+    //! are already compressed. This is only used when #upload_compression is
+    //! `gzip`. See ReportPrecompressor.
+    bool precompress_reports = false;
+
+    //! Whether to upload reports with the tus resumable upload protocol, so
+    //! that a retried upload continues from where the server’s copy of the
+    //! last attempt ends rather than starting over. Uploads made this way are
+    //! always precompressed, and are sent in pieces to the URL that the server
+    //! creates for each report, instead of as a single request. This is only
+    //! used when #upload_compression is `gzip`. See HTTPResumableUpload.
+    bool resumable_uploads = false;
+
+    //! Whether to upload a reduced minidump first, derived from a report’s
+    //! minidump by WriteReducedMinidump(), in place of the full minidump and
+    //! without the report’s attachments. Such an upload carries the form field
+    //! `minidump_tier=reduced`. If the server’s response has a
+    //! `Crashpad-Minidump-Tier: full` header field, the full minidump follows
+    //! at once, with `minidump_tier=full`. Otherwise, the full minidump is only
+    //! kept in the database with the completed report. Reduced minidumps are
+    //! never precompressed or uploaded resumably.
+    bool tiered_uploads = false;
+
+    //! Whether to upload delta minidumps, which leave out the static streams
+    //! of a report that are identical to those most recently uploaded for the
+    //! same process. Such an upload carries the form field
+    //! DeltaUploadBases::kReferencesKey. Delta minidumps are not used for
+    //! uploads that are precompressed or for #tiered_uploads. See
+    //! DeltaUploadBases.
+    bool delta_uploads = false;
+
+    //! The policy that orders pending reports and decides when they may be
+    //! uploaded, or `nullptr` to upload them in the order found as soon as they
+    //! are found. Reports that the policy defers remain pending, and are
+    //! considered again by the next check for pending reports. This is
+    //! independent of #rate_limit.
+    std::shared_ptr<UploadPolicy> upload_policy;
+
+    //! The maximum size of the reports, including their attachments, uploaded
+    //! together in a single request, or `0` to upload each report in a
+    //! request of its own. Pending reports no larger than this are gathered
+    //! into batches of up to this size, each uploaded with the protocol
+    //! described in handler/batch_upload.h. Reports are only batched when
+    //! uploads are enabled in the database’s settings, and #rate_limit,
+    //! #upload_policy, #tiered_uploads, and #resumable_uploads are all unset.
+    //! Batches are uploaded one at a time, before other pending reports.
+    uint64_t batch_upload_size = 0;
+
+    //! The name of the socket, in the abstract socket namespace, of a crash
+    //! collection agent on the same host to hand pending reports to instead
+    //! of uploading them, or empty to upload them directly. The agent is sent
+    //! each report’s minidump and attachments by file descriptor, along with
+    //! its form data and upload URL, as described by ReportRelay, and is
+    //! responsible for uploading it. A report that the agent doesn’t take is
+    //! uploaded directly. Relayed reports aren’t batched, precompressed,
+    //! reduced, or uploaded as deltas, and reports uploaded from memory aren’t
+    //! relayed. Relaying is currently only supported on Linux, ChromeOS, and
+    //! Android.
+    std::string upload_relay;
+
+    //! The scheduler whose threads run the periodic checks for pending reports,
+    //! or `nullptr` to run them on a dedicated thread. If set, it must outlive
+    //! this object. See WorkerThread::SetScheduler().
+    WorkScheduler* work_scheduler = nullptr;
   };
 
   //! \brief Observation callback invoked each time the in-process handler
@@ -103,6 +261,31 @@ class CrashReportUploadThread : public WorkerThread::Delegate,
   //! This method may be called from any thread.
   void ReportPending(const UUID& report_uuid);
 
+  //! \brief Uploads a crash report whose minidump was written into memory
+  //!     instead of into the database.
+  //!
+  //! The report is uploaded by the upload thread as soon as possible, without
+  //! the minidump being written to or read from the database. If the upload
+  //! succeeds, \a new_report is discarded, and the report is not recorded in
+  //! the database. Otherwise, \a minidump is written to \a new_report, which
+  //! is then made pending in the database, so that the report is not lost.
+  //! The report is also made pending in the database, and processed as usual,
+  //! if anything would decide whether or when it may be uploaded: uploads
+  //! being disabled in the database’s settings, Options::rate_limit,
+  //! Options::upload_policy, Options::tiered_uploads, or
+  //! Options::resumable_uploads. Reports that are waiting to be uploaded when
+  //! Stop() is called are made pending in the database.
+  //!
+  //! \param[in] new_report The report prepared for the minidump in the
+  //!     database, which the minidump names as its report. Nothing need have
+  //!     been written to it.
+  //! \param[in] minidump The report’s minidump.
+  //!
+  //! This method may be called from any thread.
+  void UploadFromMemory(
+      std::unique_ptr<CrashReportDatabase::NewReport> new_report,
+      std::unique_ptr<ChunkedStringFile> minidump);
+
   // Stoppable:
 
   //! \brief Starts a dedicated upload thread, which executes ThreadMain().
@@ -113,7 +296,8 @@ class CrashReportUploadThread : public WorkerThread::Delegate,
 
   //! \brief Stops the upload thread.
   //!
-  //! The upload thread will terminate after completing whatever task it is
+  //! Uploads in progress are canceled, leaving their reports pending, and the
+  //! upload thread will terminate after completing whatever other task it is
   //! performing. If it is not performing any task, it will terminate
   //! immediately. This method blocks while waiting for the upload thread to
   //! terminate.
@@ -147,8 +331,37 @@ class CrashReportUploadThread : public WorkerThread::Delegate,
     //! may arrange to call UploadReport() for the report again in the future,
     //! after a suitable delay.
     kRetry,
+
+    //! \brief The crash report upload was interrupted by Stop().
+    //!
+    //! The report should remain pending, to be uploaded once the upload thread
+    //! is started again.
+    kCanceled,
   };
 
+  //! \brief The form in which UploadReport() uploads a report’s minidump.
+  enum class MinidumpTier {
+    //! \brief The minidump as it was written, with the report’s attachments.
+    kFull,
+
+    //! \brief The minidump reduced by WriteReducedMinidump(), without the
+    //!     report’s attachments.
+    kReduced,
+  };
+
+  //! \brief A report passed to UploadFromMemory().
+  struct MemoryReport {
+    std::unique_ptr<CrashReportDatabase::NewReport> new_report;
+    std::unique_ptr<ChunkedStringFile> minidump;
+  };
+
+  class ScopedActiveUpload;
+  class UploadWorker;
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+  class PendingReportWatcher;
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+
   //! \brief Calls ProcessPendingReport() on pending reports.
   //!
   //! Assuming Stop() has not been called, this will process reports that the
@@ -158,6 +371,50 @@ class CrashReportUploadThread : public WorkerThread::Delegate,
   //! well.
   void ProcessPendingReports();
 
+  //! \brief Processes the reports passed to UploadFromMemory(), uploading them
+  //!     or making them pending in the database.
+  void ProcessMemoryReports();
+
+  //! \brief Writes a report passed to UploadFromMemory() to the database,
+  //!     where it becomes pending.
+  //!
+  //! \return `true` on success, with \a uuid set to the report’s unique
+  //!     identifier. `false` on failure, with the report lost and a message
+  //!     logged.
+  bool SpillMemoryReport(MemoryReport report, UUID* uuid);
+
+  //! \brief Calls SpillMemoryReport() on each report passed to
+  //!     UploadFromMemory() and not yet processed, and adds them to the
+  //!     reports known to be pending.
+  void SpillMemoryReports();
+
+  //! \brief Calls ProcessPendingReport() on each of \a reports, in the order
+  //!     chosen by Options::upload_policy if there is one.
+  //!
+  //! If Options::upload_concurrency is greater than 1, up to that many reports
+  //! are processed at the same time, by this thread and by UploadWorker
+  //! threads that exit before this method returns.
+  //!
+  //! \return `false` if Stop() was called while processing \a reports, in
+  //!     which case some may not have been processed.
+  bool ProcessReports(const std::vector<CrashReportDatabase::Report>& reports);
+
+  //! \brief Uploads those of \a reports that Options::batch_upload_size allows
+  //!     to be batched, in batches, and removes them from \a reports.
+  //!
+  //! \return `false` if Stop() was called while uploading batches.
+  bool ProcessBatchedReports(std::vector<CrashReportDatabase::Report>* reports);
+
+  //! \brief Uploads a batch of pending reports from the database in a single
+  //!     request, and records the result for each in the database.
+  void UploadBatch(const std::vector<CrashReportDatabase::Report>& batch);
+
+  //! \brief Processes reports from the queue set up by ProcessReports() until
+  //!     the queue is empty or Stop() is called.
+  //!
+  //! This is called by the upload thread and by each UploadWorker.
+  void ProcessQueuedReports();
+
   //! \brief Processes a single pending report from the database.
   //!
   //! \param[in] report The crash report to process.
@@ -170,22 +427,168 @@ class CrashReportUploadThread : public WorkerThread::Delegate,
   //! remain in the “pending” state. If the upload fails and no more retries are
   //! desired, or report upload is disabled, it will be marked as “completed” in
   //! the database without ever having been uploaded.
+  //!
+  //! This method may be called on several threads at once.
   void ProcessPendingReport(const CrashReportDatabase::Report& report);
 
+  //! \brief Attempts to upload a report that ProcessPendingReport() has decided
+  //!     to upload, and records the result in the database.
+  //!
+  //! \param[in] report The crash report to upload.
+  //! \param[out] bytes_sent The number of bytes of the upload’s body sent.
+  void UploadPendingReport(const CrashReportDatabase::Report& report,
+                           uint64_t* bytes_sent);
+
+  //! \brief Gets a pending report from the database to upload it, dealing with
+  //!     the report if that fails.
+  //!
+  //! \return `true` on success, with \a upload_report set. `false` if the
+  //!     report can’t be uploaded now.
+  bool GetReportForUploading(
+      const CrashReportDatabase::Report& report,
+      std::unique_ptr<const CrashReportDatabase::UploadReport>* upload_report);
+
+  //! \brief Records the result of a pending report’s upload attempt in the
+  //!     database.
+  //!
+  //! \param[in] report The report whose upload was attempted.
+  //! \param[in] upload_report The report obtained by GetReportForUploading().
+  //! \param[in] upload_result The result of the upload attempt.
+  //! \param[in] response_body The server’s response, if the upload succeeded.
+  void RecordUploadResult(
+      const CrashReportDatabase::Report& report,
+      std::unique_ptr<const CrashReportDatabase::UploadReport> upload_report,
+      UploadResult upload_result,
+      const std::string& response_body);
+
+  //! \brief Uploads a report’s precompressed upload with the tus resumable
+  //!     upload protocol, resuming an upload made by an earlier attempt if
+  //!     possible.
+  //!
+  //! \param[in] uuid The report’s unique identifier.
+  //! \param[in] url The URL at which the server creates uploads.
+  //! \param[in] content_type The `Content-Type` of the body.
+  //! \param[in] body The body, read from its current position.
+  //! \param[out] response_body The server’s response on success.
+  //! \param[out] bytes_sent At most the number of bytes of the body sent.
+  //!
+  //! \return A member of UploadResult indicating the result of the upload
+  //!    attempt.
+  UploadResult UploadResumable(const UUID& uuid,
+                               const std::string& url,
+                               const std::string& content_type,
+                               FileReaderInterface* body,
+                               std::string* response_body,
+                               uint64_t* bytes_sent);
+
+  //! \brief Asks the server whether it already has a report, as described for
+  //!     Options::upload_precheck.
+  //!
+  //! \param[in] report The report to check for.
+  //! \param[out] response_body If the server has the report, set to the
+  //!     response body of the upload that gave it to the server.
+  //!
+  //! \return `true` if the server has the report. `false` if it doesn’t, or if
+  //!     that couldn’t be determined, in which case the report should be
+  //!     uploaded.
+  bool ServerHasReport(const CrashReportDatabase::UploadReport* report,
+                       std::string* response_body);
+
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+  //! \brief Hands a report to the agent named by Options::upload_relay.
+  //!
+  //! \param[in] report The report to relay.
+  //! \param[out] upload_result The result to record for the report, if it was
+  //!     relayed.
+  //! \param[out] response_body The report’s ID from the agent, if it was
+  //!     relayed.
+  //!
+  //! \return `true` if the agent took or rejected the report. `false` if it
+  //!     should be uploaded directly.
+  bool RelayReport(const CrashReportDatabase::UploadReport* report,
+                   UploadResult* upload_result,
+                   std::string* response_body);
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+
+  //! \brief Removes a report’s precompressed upload, if reports are
+  //!     precompressed. This is called once the report is no longer pending.
+  void RemovePrecompressedReport(const UUID& uuid);
+
   //! \brief Attempts to upload a crash report.
   //!
   //! \param[in] report The report to upload. The caller is responsible for
   //!     calling CrashReportDatabase::GetReportForUploading() before calling
   //!     this method, and for calling
   //!     CrashReportDatabase::RecordUploadComplete() after calling this method.
+  //! \param[in] tier The form in which to upload the report’s minidump. If
+  //!     Options::tiered_uploads is `false`, this must be MinidumpTier::kFull.
   //! \param[out] response_body If the upload attempt is successful, this will
   //!     be set to the response body sent by the server. Breakpad-type servers
   //!     provide the crash ID assigned by the server in the response body.
+  //! \param[out] bytes_sent The number of bytes of the upload’s body sent is
+  //!     added to this.
+  //! \param[out] full_minidump_requested If not `nullptr`, set to whether the
+  //!     server’s response asked for the full minidump.
   //!
   //! \return A member of UploadResult indicating the result of the upload
   //!    attempt.
   UploadResult UploadReport(const CrashReportDatabase::UploadReport* report,
-                            std::string* response_body);
+                            MinidumpTier tier,
+                            std::string* response_body,
+                            uint64_t* bytes_sent,
+                            bool* full_minidump_requested);
+
+  //! \brief Attempts to upload a report passed to UploadFromMemory().
+  //!
+  //! \param[in] uuid The report’s unique identifier.
+  //! \param[in] minidump The report’s minidump.
+  //! \param[out] response_body If the upload attempt is successful, this will
+  //!     be set to the response body sent by the server.
+  //! \param[out] bytes_sent The number of bytes of the upload’s body sent is
+  //!     added to this.
+  //!
+  //! \return A member of UploadResult indicating the result of the upload
+  //!    attempt.
+  UploadResult UploadMemoryReport(const UUID& uuid,
+                                  ChunkedStringFile* minidump,
+                                  std::string* response_body,
+                                  uint64_t* bytes_sent);
+
+  //! \brief Sets up \a http_multipart_builder to compress an upload as
+  //!     configured by Options.
+  void ConfigureMultipartBuilder(HTTPMultipartBuilder* http_multipart_builder);
+
+  //! \brief Returns the URL to upload a report to, given its URL-encoded form
+  //!     data.
+  std::string UploadURL(
+      const std::map<std::string, std::string>& encoded_parameters);
+
+  //! \brief Creates a transport for a request to \a url, configured as every
+  //!     request made to upload a report is.
+  //!
+  //! \return The transport, or `nullptr` if none could be created.
+  std::unique_ptr<HTTPTransport> CreateTransport(const std::string& url);
+
+  //! \brief Sends an upload with a single request.
+  //!
+  //! \param[in] url The URL to send the upload to.
+  //! \param[in] content_headers The upload’s `Content-` header fields.
+  //! \param[in] body_stream The upload’s body.
+  //! \param[out] response_body The server’s response on success.
+  //! \param[out] bytes_sent The number of bytes of the upload’s body sent is
+  //!     added to this.
+  //! \param[out] full_minidump_requested If not `nullptr`, set to whether the
+  //!     server’s response asked for the full minidump.
+  //!
+  //! \return A member of UploadResult indicating the result of the upload
+  //!    attempt.
+  UploadResult SendUpload(const std::string& url,
+                          const HTTPHeaders& content_headers,
+                          std::unique_ptr<HTTPBodyStream> body_stream,
+                          std::string* response_body,
+                          uint64_t* bytes_sent,
+                          bool* full_minidump_requested);
 
   // WorkerThread::Delegate:
   //! \brief Calls ProcessPendingReports() in response to ReportPending() having
@@ -226,11 +629,56 @@ class CrashReportUploadThread : public WorkerThread::Delegate,
   const Options options_;
   const ProcessPendingReportsObservationCallback callback_;
   const std::string url_;
+
+  // Whether Start() tries to watch the database for pending reports.
+  const bool notify_pending_reports_;
+
+  // Whether the database is being watched for pending reports, which allows
+  // DoWork() to check for them less often. This is set by Start() before
+  // thread_ is started.
+  bool pending_reports_watched_;
+
+  // Whether the server has advertised support for Zstandard-compressed
+  // uploads. Updated from each response that carries an Accept-Encoding header
+  // field.
+  std::atomic<bool> server_accepts_zstd_;
+
   WorkerThread thread_;
-  ThreadSafeVector<UUID> known_pending_report_uuids_;
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+  std::unique_ptr<PendingReportWatcher> pending_report_watcher_;
+  std::unique_ptr<ReportRelay> relay_;
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+  std::unique_ptr<ReportPrecompressor> precompressor_;
+  std::unique_ptr<DeltaUploadBases> delta_bases_;
+  LockFreeQueue<UUID> known_pending_report_uuids_;
+
+  // The reports passed to UploadFromMemory() and not yet processed, guarded by
+  // memory_reports_lock_.
+  base::Lock memory_reports_lock_;
+  std::deque<MemoryReport> memory_reports_;
+
+  // The reports being processed by ProcessReports() and the index of the next
+  // one to process, guarded by upload_queue_lock_.
+  base::Lock upload_queue_lock_;
+  const std::vector<CrashReportDatabase::Report>* upload_queue_;  // weak
+  size_t upload_queue_next_;
+
+  // Held while deciding whether to make, and then making, an upload that is
+  // subject to rate limiting, so that concurrent uploads observe each other’s
+  // upload attempt times.
+  base::Lock rate_limit_lock_;
+
+  // The uploads in progress, which Stop() cancels, and whether Stop() has been
+  // called since Start(), guarded by active_uploads_lock_.
+  base::Lock active_uploads_lock_;
+  std::set<ScopedActiveUpload*> active_uploads_;
+  bool stopping_;
+
 #if BUILDFLAG(IS_IOS)
-  // This is not thread-safe, and only used by the worker thread.
+  // Guarded by retry_uuid_time_map_lock_.
   std::map<UUID, time_t> retry_uuid_time_map_;
+  base::Lock retry_uuid_time_map_lock_;
 #endif
   CrashReportDatabase* database_;  // weak
 };
@@ -0,0 +1,290 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "handler/crash_report_upload_thread.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/files/file_path.h"
+#include "base/strings/stringprintf.h"
+#include "build/build_config.h"
+#include "client/settings.h"
+#include "gtest/gtest.h"
+#include "test/multiprocess_exec.h"
+#include "test/scoped_temp_dir.h"
+#include "test/test_paths.h"
+#include "util/file/file_io.h"
+#include "util/synchronization/semaphore.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+// The response that the server sends for each successful request.
+constexpr char kServerResponse[] = "0123456789abcdef";
+static_assert(sizeof(kServerResponse) - 1 == 16,
+              "http_transport_test_server expects a 16-byte response");
+
+// The longest time that a test waits for the upload thread.
+constexpr double kUploadTimeoutSeconds = 30;
+
+// Runs http_transport_test_server, which accepts requests and records them
+// until the test is done with it.
+class TestUploadServer final : public MultiprocessExec {
+ public:
+  // run is called with the server’s upload URL while the server is running.
+  // Each request is answered with response_code, and with kServerResponse if
+  // that is 200.
+  TestUploadServer(uint16_t response_code,
+                   std::function<void(const std::string&)> run)
+      : MultiprocessExec(),
+        run_(std::move(run)),
+        requests_(),
+        server_path_(TestPaths::Executable().DirName().Append(
+            FILE_PATH_LITERAL("http_transport_test_server")
+#if BUILDFLAG(IS_WIN)
+                FILE_PATH_LITERAL(".exe")
+#endif
+                )),
+        server_arguments_(),
+        response_code_(response_code) {
+    server_arguments_.push_back("--multiple");
+    SetChildCommand(server_path_, &server_arguments_);
+  }
+
+  TestUploadServer(const TestUploadServer&) = delete;
+  TestUploadServer& operator=(const TestUploadServer&) = delete;
+
+  ~TestUploadServer() {}
+
+  // Answers HEAD requests with response_code instead. Must be called before
+  // Run().
+  void SetHeadResponseCode(uint16_t response_code) {
+    server_arguments_.push_back(
+        base::StringPrintf("--head-response-code=%u", response_code));
+    SetChildCommand(server_path_, &server_arguments_);
+  }
+
+  // The requests that the server received, as the server wrote them.
+  const std::string& requests() const { return requests_; }
+
+ private:
+  void MultiprocessParent() override {
+    uint16_t port;
+    ASSERT_TRUE(LoggingReadFileExactly(ReadPipeHandle(), &port, sizeof(port)));
+    ASSERT_TRUE(LoggingWriteFile(
+        WritePipeHandle(), &response_code_, sizeof(response_code_)));
+    ASSERT_TRUE(LoggingWriteFile(
+        WritePipeHandle(), kServerResponse, strlen(kServerResponse)));
+
+    run_(base::StringPrintf("http://localhost:%d/upload", port));
+
+    // The server stops once its stdin is closed, and then writes the requests
+    // that it received.
+    CloseWritePipe();
+    char buf[4096];
+    FileOperationResult bytes_read;
+    while ((bytes_read = ReadFile(ReadPipeHandle(), buf, sizeof(buf))) != 0) {
+      ASSERT_GE(bytes_read, 0);
+      requests_.append(buf, bytes_read);
+    }
+  }
+
+  std::function<void(const std::string&)> run_;
+  std::string requests_;
+  base::FilePath server_path_;
+  std::vector<std::string> server_arguments_;
+  uint16_t response_code_;
+};
+
+// Returns the number of times that needle occurs in haystack.
+size_t CountOccurrences(const std::string& haystack,
+                        const std::string& needle) {
+  size_t count = 0;
+  for (size_t offset = haystack.find(needle); offset != std::string::npos;
+       offset = haystack.find(needle, offset + needle.size())) {
+    ++count;
+  }
+  return count;
+}
+
+// Returns the part of an upload request that names a report’s minidump.
+std::string MinidumpFilename(const UUID& uuid) {
+  return "filename=\"" + uuid.ToString() + ".dmp\"";
+}
+
+class CrashReportUploadThreadTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    database_ = CrashReportDatabase::Initialize(temp_dir_.path());
+    ASSERT_TRUE(database_);
+    ASSERT_TRUE(database_->GetSettings()->SetUploadsEnabled(true));
+  }
+
+  void CreateReport(const std::string& contents, UUID* uuid) {
+    std::unique_ptr<CrashReportDatabase::NewReport> new_report;
+    ASSERT_EQ(database_->PrepareNewCrashReport(&new_report),
+              CrashReportDatabase::kNoError);
+    ASSERT_TRUE(new_report->Writer()->Write(contents.data(), contents.size()));
+    ASSERT_EQ(
+        database_->FinishedWritingCrashReport(std::move(new_report), uuid),
+        CrashReportDatabase::kNoError);
+  }
+
+  // Options that upload each pending report as soon as the upload thread is
+  // started, without compression so that the uploads can be inspected.
+  static CrashReportUploadThread::Options DefaultOptions() {
+    CrashReportUploadThread::Options options;
+    options.identify_client_via_url = false;
+    options.rate_limit = false;
+    options.upload_compression = HTTPMultipartBuilder::Compression::kNone;
+    options.watch_pending_reports = true;
+    return options;
+  }
+
+  // Starts an upload thread, waits for it to process the pending reports once,
+  // and stops it.
+  void ProcessPendingReports(const std::string& url,
+                             const CrashReportUploadThread::Options& options) {
+    Semaphore processed(0);
+    CrashReportUploadThread upload_thread(
+        database_.get(), url, options, [&processed]() { processed.Signal(); });
+    upload_thread.Start();
+    EXPECT_TRUE(processed.TimedWait(kUploadTimeoutSeconds));
+    upload_thread.Stop();
+  }
+
+  CrashReportDatabase* database() { return database_.get(); }
+
+ private:
+  ScopedTempDir temp_dir_;
+  std::unique_ptr<CrashReportDatabase> database_;
+};
+
+TEST_F(CrashReportUploadThreadTest, ConcurrentUploads) {
+  constexpr size_t kReports = 12;
+  std::vector<UUID> uuids(kReports);
+  for (size_t index = 0; index < kReports; ++index) {
+    ASSERT_NO_FATAL_FAILURE(CreateReport(
+        base::StringPrintf("not a minidump %zu", index), &uuids[index]));
+  }
+
+  CrashReportUploadThread::Options options = DefaultOptions();
+  options.upload_concurrency = 4;
+  TestUploadServer server(
+      200, [this, &options](const std::string& url) {
+        ProcessPendingReports(url, options);
+      });
+  server.Run();
+
+  // Each report was uploaded exactly once.
+  for (const UUID& uuid : uuids) {
+    EXPECT_EQ(CountOccurrences(server.requests(), MinidumpFilename(uuid)), 1u)
+        << uuid.ToString();
+  }
+  EXPECT_EQ(CountOccurrences(server.requests(), "POST /upload"), kReports);
+
+  std::vector<CrashReportDatabase::Report> reports;
+  ASSERT_EQ(database()->GetPendingReports(&reports),
+            CrashReportDatabase::kNoError);
+  EXPECT_TRUE(reports.empty());
+
+  ASSERT_EQ(database()->GetCompletedReports(&reports),
+            CrashReportDatabase::kNoError);
+  ASSERT_EQ(reports.size(), kReports);
+  for (const CrashReportDatabase::Report& report : reports) {
+    EXPECT_TRUE(report.uploaded);
+    EXPECT_EQ(report.upload_attempts, 1);
+  }
+}
+
+// Uploads a report with Options::upload_precheck set, where the server answers
+// the check with head_response_code, and returns the server’s requests.
+class CrashReportUploadThreadPrecheckTest : public CrashReportUploadThreadTest {
+ protected:
+  void CheckAndUpload(uint16_t head_response_code,
+                      UUID* uuid,
+                      std::string* requests) {
+    ASSERT_NO_FATAL_FAILURE(CreateReport("not a minidump", uuid));
+
+    CrashReportUploadThread::Options options = DefaultOptions();
+    options.upload_precheck = true;
+    TestUploadServer server(200, [this, &options](const std::string& url) {
+      ProcessPendingReports(url, options);
+    });
+    server.SetHeadResponseCode(head_response_code);
+    server.Run();
+    *requests = server.requests();
+
+    // The check identifies the report whether or not the server has it.
+    EXPECT_EQ(CountOccurrences(*requests, "HEAD /upload"), 1u);
+    EXPECT_EQ(CountOccurrences(*requests,
+                               "Crashpad-Report-ID: " + uuid->ToString()),
+              1u);
+    EXPECT_EQ(CountOccurrences(*requests, "Crashpad-Report-Digest: "), 1u);
+
+    std::vector<CrashReportDatabase::Report> reports;
+    ASSERT_EQ(database()->GetCompletedReports(&reports),
+              CrashReportDatabase::kNoError);
+    ASSERT_EQ(reports.size(), 1u);
+    EXPECT_EQ(reports[0].uuid, *uuid);
+    EXPECT_TRUE(reports[0].uploaded);
+  }
+};
+
+TEST_F(CrashReportUploadThreadPrecheckTest, Found) {
+  UUID uuid;
+  std::string requests;
+  ASSERT_NO_FATAL_FAILURE(CheckAndUpload(200, &uuid, &requests));
+
+  // The server already has the report, so it isn’t uploaded again, and the
+  // server’s ID for it is taken from the check’s response.
+  EXPECT_EQ(CountOccurrences(requests, "POST /upload"), 0u);
+
+  std::vector<CrashReportDatabase::Report> reports;
+  ASSERT_EQ(database()->GetCompletedReports(&reports),
+            CrashReportDatabase::kNoError);
+  ASSERT_EQ(reports.size(), 1u);
+  EXPECT_EQ(reports[0].id, kServerResponse);
+}
+
+TEST_F(CrashReportUploadThreadPrecheckTest, NotFound) {
+  UUID uuid;
+  std::string requests;
+  ASSERT_NO_FATAL_FAILURE(CheckAndUpload(404, &uuid, &requests));
+
+  EXPECT_EQ(CountOccurrences(requests, "POST /upload"), 1u);
+  EXPECT_EQ(CountOccurrences(requests, MinidumpFilename(uuid)), 1u);
+}
+
+TEST_F(CrashReportUploadThreadPrecheckTest, Error) {
+  // A check that fails doesn’t prevent the report from being uploaded.
+  UUID uuid;
+  std::string requests;
+  ASSERT_NO_FATAL_FAILURE(CheckAndUpload(500, &uuid, &requests));
+
+  EXPECT_EQ(CountOccurrences(requests, "POST /upload"), 1u);
+  EXPECT_EQ(CountOccurrences(requests, MinidumpFilename(uuid)), 1u);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
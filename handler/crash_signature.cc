@@ -0,0 +1,282 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "handler/crash_signature.h"
+
+#include <inttypes.h>
+#include <string.h>
+
+#include <vector>
+
+#include "base/logging.h"
+#include "base/strings/stringprintf.h"
+#include "snapshot/cpu_context.h"
+#include "snapshot/exception_snapshot.h"
+#include "snapshot/memory_snapshot.h"
+#include "snapshot/module_snapshot.h"
+#include "snapshot/process_snapshot.h"
+#include "snapshot/thread_snapshot.h"
+#include "util/file/file_io.h"
+
+namespace crashpad {
+
+namespace {
+
+// The table is kept in a fixed-size file: a TableHeader followed by
+// kTableEntries TableEntry slots, rewritten in full each time it changes.
+
+constexpr uint32_t kTableMagic = 0x67697363;  // 'csig'
+constexpr uint32_t kTableVersion = 1;
+constexpr uint32_t kTableEntries = 64;
+
+struct TableHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t entries;
+  uint32_t reserved;
+};
+
+struct TableEntry {
+  // A hash of the signature, or 0 for an unused slot.
+  uint64_t signature_hash;
+  int64_t window_start;
+  int64_t last_seen;
+  uint32_t window_count;
+  uint32_t suppressed;
+};
+
+static_assert(sizeof(TableHeader) == 16, "TableHeader size");
+static_assert(sizeof(TableEntry) == 32, "TableEntry size");
+
+struct Table {
+  TableHeader header;
+  TableEntry entries[kTableEntries];
+};
+
+// 64-bit FNV-1a.
+uint64_t HashSignature(const std::string& signature) {
+  uint64_t hash = 0xcbf29ce484222325;
+  for (unsigned char c : signature) {
+    hash ^= c;
+    hash *= 0x100000001b3;
+  }
+  return hash ? hash : 1;
+}
+
+// Collects the values on a stack that point into one of a process’ modules.
+class StackScanner : public MemorySnapshot::Delegate {
+ public:
+  StackScanner(const std::vector<const ModuleSnapshot*>& modules,
+               bool is_64_bit,
+               size_t max_values)
+      : values_(),
+        modules_(modules),
+        max_values_(max_values),
+        is_64_bit_(is_64_bit) {}
+
+  StackScanner(const StackScanner&) = delete;
+  StackScanner& operator=(const StackScanner&) = delete;
+
+  ~StackScanner() override {}
+
+  const std::vector<uint64_t>& values() const { return values_; }
+
+  // MemorySnapshot::Delegate:
+  bool MemorySnapshotDelegateRead(void* data, size_t size) override {
+    return is_64_bit_ ? Scan<uint64_t>(data, size)
+                      : Scan<uint32_t>(data, size);
+  }
+
+ private:
+  template <typename Pointer>
+  bool Scan(void* data, size_t size) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    for (size_t offset = 0;
+         offset + sizeof(Pointer) <= size && values_.size() < max_values_;
+         offset += sizeof(Pointer)) {
+      Pointer value;
+      memcpy(&value, bytes + offset, sizeof(value));
+      for (const ModuleSnapshot* module : modules_) {
+        if (value >= module->Address() &&
+            value - module->Address() < module->Size()) {
+          values_.push_back(value);
+          break;
+        }
+      }
+    }
+    return true;
+  }
+
+  std::vector<uint64_t> values_;
+  const std::vector<const ModuleSnapshot*>& modules_;
+  const size_t max_values_;
+  const bool is_64_bit_;
+};
+
+// Describes an address by its module, offset in the module, and the module’s
+// build ID, or by nothing at all if it isn’t in a module.
+std::string DescribeAddress(const std::vector<const ModuleSnapshot*>& modules,
+                            uint64_t address) {
+  for (const ModuleSnapshot* module : modules) {
+    if (address >= module->Address() &&
+        address - module->Address() < module->Size()) {
+      std::string name = module->Name();
+      const size_t slash = name.find_last_of("/\\");
+      if (slash != std::string::npos) {
+        name.erase(0, slash + 1);
+      }
+
+      std::string description = base::StringPrintf(
+          "%s+0x%" PRIx64, name.c_str(), address - module->Address());
+      const std::vector<uint8_t> build_id = module->BuildID();
+      if (!build_id.empty()) {
+        description.push_back('/');
+        for (uint8_t byte : build_id) {
+          description += base::StringPrintf("%02x", byte);
+        }
+      }
+      return description;
+    }
+  }
+  return "?";
+}
+
+}  // namespace
+
+std::string CrashSignature(const ProcessSnapshot* snapshot,
+                           size_t frame_count) {
+  const ExceptionSnapshot* exception = snapshot->Exception();
+  if (!exception) {
+    return std::string();
+  }
+
+  const std::vector<const ModuleSnapshot*> modules = snapshot->Modules();
+  std::string signature = base::StringPrintf("%08x ", exception->Exception());
+  signature += DescribeAddress(modules, exception->ExceptionAddress());
+
+  const CPUContext* context = exception->Context();
+  StackScanner scanner(modules, context && context->Is64Bit(), frame_count);
+  for (const ThreadSnapshot* thread : snapshot->Threads()) {
+    if (thread->ThreadID() == exception->ThreadID()) {
+      const MemorySnapshot* stack = thread->Stack();
+      if (stack) {
+        stack->Read(&scanner);
+      }
+      break;
+    }
+  }
+  for (uint64_t value : scanner.values()) {
+    signature.push_back(' ');
+    signature += DescribeAddress(modules, value);
+  }
+
+  return signature;
+}
+
+CrashSignatureThrottle::CrashSignatureThrottle(const base::FilePath& database,
+                                               const Options& options)
+    : path_(database.Append(FILE_PATH_LITERAL("crash_signatures"))),
+      options_(options) {}
+
+CrashSignatureThrottle::~CrashSignatureThrottle() = default;
+
+bool CrashSignatureThrottle::ShouldKeep(const std::string& signature,
+                                        uint32_t* suppressed) {
+  *suppressed = 0;
+
+  ScopedFileHandle file(
+      LoggingOpenFileForReadAndWrite(path_,
+                                     FileWriteMode::kReuseOrCreate,
+                                     FilePermissions::kOwnerOnly));
+  if (!file.is_valid() ||
+      LoggingLockFile(file.get(),
+                      FileLocking::kExclusive,
+                      FileLockingBlocking::kBlocking) !=
+          FileLockingResult::kSuccess) {
+    return true;
+  }
+
+  // A table that’s missing, or that was written by another version, is
+  // started over.
+  Table table;
+  if (LoggingFileSizeByHandle(file.get()) !=
+          static_cast<FileOffset>(sizeof(table)) ||
+      !LoggingReadFileExactly(file.get(), &table, sizeof(table)) ||
+      table.header.magic != kTableMagic ||
+      table.header.version != kTableVersion ||
+      table.header.entries != kTableEntries) {
+    memset(&table, 0, sizeof(table));
+    table.header.magic = kTableMagic;
+    table.header.version = kTableVersion;
+    table.header.entries = kTableEntries;
+  }
+
+  const uint64_t hash = HashSignature(signature);
+  const time_t now = Now();
+  TableEntry* entry = nullptr;
+  TableEntry* least_recent = &table.entries[0];
+  for (TableEntry& candidate : table.entries) {
+    if (candidate.signature_hash == hash) {
+      entry = &candidate;
+      break;
+    }
+    // Unused slots were never seen, so they’re taken first.
+    if (candidate.last_seen < least_recent->last_seen) {
+      least_recent = &candidate;
+    }
+  }
+  if (!entry) {
+    entry = least_recent;
+    memset(entry, 0, sizeof(*entry));
+    entry->signature_hash = hash;
+    entry->window_start = now;
+  }
+
+  if (now < entry->window_start ||
+      now - entry->window_start >= options_.window) {
+    entry->window_start = now;
+    entry->window_count = 0;
+  }
+  entry->last_seen = now;
+  ++entry->window_count;
+
+  bool keep = entry->window_count <= options_.reports_per_window;
+  if (!keep && options_.sample_interval) {
+    keep = (entry->window_count - options_.reports_per_window) %
+               options_.sample_interval ==
+           0;
+  }
+  uint32_t entry_suppressed = entry->suppressed;
+  if (keep) {
+    entry->suppressed = 0;
+  } else {
+    ++entry->suppressed;
+  }
+
+  if (LoggingSeekFile(file.get(), 0, SEEK_SET) != 0 ||
+      !LoggingWriteFile(file.get(), &table, sizeof(table))) {
+    return true;
+  }
+
+  if (keep) {
+    *suppressed = entry_suppressed;
+  }
+  return keep;
+}
+
+time_t CrashSignatureThrottle::Now() {
+  return time(nullptr);
+}
+
+}  // namespace crashpad
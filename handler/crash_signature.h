@@ -0,0 +1,117 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_HANDLER_CRASH_SIGNATURE_H_
+#define CRASHPAD_HANDLER_CRASH_SIGNATURE_H_
+
+#include <stdint.h>
+#include <time.h>
+
+#include <string>
+
+#include "base/files/file_path.h"
+
+namespace crashpad {
+
+class ProcessSnapshot;
+
+//! \brief Computes a signature that identifies a crash, so that reports of the
+//!     same crash can be recognized before they are written.
+//!
+//! The signature is made of the exception code, and of the module, module
+//! offset, and module build ID of the exception address and of the first
+//! \a frame_count values on the crashing thread’s stack that point into a
+//! module. Module names are reduced to their base names and addresses to
+//! module offsets, so that the signature doesn’t vary with where a process or
+//! its modules were loaded. Stack values are found by scanning the stack
+//! rather than unwinding it, so they may include values that aren’t return
+//! addresses, but the same crash generally leaves the same values.
+//!
+//! \param[in] snapshot The snapshot of the crashed process.
+//! \param[in] frame_count The number of stack values to include.
+//!
+//! \return The signature, or an empty string if \a snapshot has no exception.
+std::string CrashSignature(const ProcessSnapshot* snapshot,
+                           size_t frame_count);
+
+//! \brief Decides whether a crash report should be kept, based on how many
+//!     reports of crashes with the same signature have been seen recently.
+//!
+//! During a crash loop, many reports of the same crash are written, and each
+//! of them would otherwise be uploaded. This keeps the first reports of each
+//! signature seen within a window of time, and then keeps only one in a number
+//! of the reports that follow, or none. The reports that aren’t kept are
+//! counted, and the count is given with the next report of the same signature
+//! that is kept.
+//!
+//! The counts are kept in a small table in a file next to the crash report
+//! database, so that they survive the handler being restarted, and are shared
+//! by handlers using the same database. When the table is full, the signature
+//! seen least recently is forgotten. If the table can’t be read or written,
+//! every report is kept.
+class CrashSignatureThrottle {
+ public:
+  //! \brief Options to be passed to the CrashSignatureThrottle constructor.
+  struct Options {
+    //! The number of seconds in each window.
+    time_t window = 60 * 60;
+
+    //! The number of reports of each signature kept in each window before
+    //! reports of that signature are downsampled.
+    uint32_t reports_per_window = 1;
+
+    //! Once #reports_per_window reports of a signature have been kept in a
+    //! window, one in this many of the reports that follow is kept. `0` keeps
+    //! none of them.
+    uint32_t sample_interval = 0;
+  };
+
+  //! \brief Constructs a new object.
+  //!
+  //! \param[in] database The path to the crash report database, in which the
+  //!     table is kept.
+  //! \param[in] options The throttle’s options.
+  CrashSignatureThrottle(const base::FilePath& database,
+                         const Options& options);
+
+  CrashSignatureThrottle(const CrashSignatureThrottle&) = delete;
+  CrashSignatureThrottle& operator=(const CrashSignatureThrottle&) = delete;
+
+  virtual ~CrashSignatureThrottle();
+
+  //! \brief Records a crash and decides whether its report should be kept.
+  //!
+  //! \param[in] signature The crash’s signature, as returned by
+  //!     CrashSignature().
+  //! \param[out] suppressed If the report should be kept, the number of
+  //!     reports of crashes with the same signature that weren’t kept since
+  //!     the last one that was.
+  //!
+  //! \return `true` if the report should be kept, `false` if it should be
+  //!     dropped.
+  bool ShouldKeep(const std::string& signature, uint32_t* suppressed);
+
+ protected:
+  //! \brief Returns the current time. This calls `time()`, and is overridden
+  //!     by tests.
+  virtual time_t Now();
+
+ private:
+  const base::FilePath path_;
+  const Options options_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_HANDLER_CRASH_SIGNATURE_H_
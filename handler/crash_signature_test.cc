@@ -0,0 +1,154 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "handler/crash_signature.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "snapshot/test/test_cpu_context.h"
+#include "snapshot/test/test_exception_snapshot.h"
+#include "snapshot/test/test_memory_snapshot.h"
+#include "snapshot/test/test_module_snapshot.h"
+#include "snapshot/test/test_process_snapshot.h"
+#include "snapshot/test/test_thread_snapshot.h"
+#include "test/scoped_temp_dir.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+constexpr uint64_t kThreadID = 5;
+
+std::unique_ptr<TestModuleSnapshot> MakeModule(
+    const std::string& name,
+    uint64_t address,
+    const std::vector<uint8_t>& build_id) {
+  auto module = std::make_unique<TestModuleSnapshot>();
+  module->SetName(name);
+  module->SetAddressAndSize(address, 0x1000);
+  module->SetBuildID(build_id);
+  return module;
+}
+
+TEST(CrashSignature, Signature) {
+  TestProcessSnapshot snapshot;
+  EXPECT_EQ(CrashSignature(&snapshot, 2), std::string());
+
+  snapshot.AddModule(MakeModule("/system/lib/liba.so", 0x10000, {0xab, 0xcd}));
+  snapshot.AddModule(MakeModule("libb.so", 0x1010101010101000, {}));
+
+  // Every pointer on the stack points into libb.so.
+  auto stack = std::make_unique<TestMemorySnapshot>();
+  stack->SetAddress(0x7000);
+  stack->SetSize(32);
+  stack->SetValue(0x10);
+  auto thread = std::make_unique<TestThreadSnapshot>();
+  thread->SetThreadID(kThreadID);
+  thread->SetStack(std::move(stack));
+  snapshot.AddThread(std::move(thread));
+
+  auto exception = std::make_unique<TestExceptionSnapshot>();
+  InitializeCPUContextX86_64(exception->MutableContext(), 0);
+  exception->SetThreadID(kThreadID);
+  exception->SetException(0xb);
+  exception->SetExceptionAddress(0x10020);
+  snapshot.SetException(std::move(exception));
+
+  EXPECT_EQ(CrashSignature(&snapshot, 0), "0000000b liba.so+0x20/abcd");
+  EXPECT_EQ(CrashSignature(&snapshot, 2),
+            "0000000b liba.so+0x20/abcd libb.so+0x10 libb.so+0x10");
+  EXPECT_EQ(CrashSignature(&snapshot, 8),
+            "0000000b liba.so+0x20/abcd libb.so+0x10 libb.so+0x10 "
+            "libb.so+0x10 libb.so+0x10");
+}
+
+class TestCrashSignatureThrottle : public CrashSignatureThrottle {
+ public:
+  TestCrashSignatureThrottle(const base::FilePath& database,
+                             const Options& options,
+                             time_t* now)
+      : CrashSignatureThrottle(database, options), now_(now) {}
+
+ protected:
+  time_t Now() override { return *now_; }
+
+ private:
+  time_t* now_;  // weak
+};
+
+TEST(CrashSignatureThrottle, KeepAndSample) {
+  ScopedTempDir temp_dir;
+  CrashSignatureThrottle::Options options;
+  options.window = 60 * 60;
+  options.reports_per_window = 2;
+  options.sample_interval = 3;
+  time_t now = 1000;
+  TestCrashSignatureThrottle throttle(temp_dir.path(), options, &now);
+
+  uint32_t suppressed;
+  EXPECT_TRUE(throttle.ShouldKeep("a", &suppressed));
+  EXPECT_EQ(suppressed, 0u);
+  EXPECT_TRUE(throttle.ShouldKeep("a", &suppressed));
+  EXPECT_EQ(suppressed, 0u);
+  EXPECT_FALSE(throttle.ShouldKeep("a", &suppressed));
+  EXPECT_FALSE(throttle.ShouldKeep("a", &suppressed));
+
+  // Other signatures are counted separately.
+  EXPECT_TRUE(throttle.ShouldKeep("b", &suppressed));
+  EXPECT_EQ(suppressed, 0u);
+
+  // One in three reports past the limit is kept, with the number dropped.
+  EXPECT_TRUE(throttle.ShouldKeep("a", &suppressed));
+  EXPECT_EQ(suppressed, 2u);
+  EXPECT_FALSE(throttle.ShouldKeep("a", &suppressed));
+
+  // The counts are kept in the database, so they survive a restart.
+  TestCrashSignatureThrottle restarted(temp_dir.path(), options, &now);
+  EXPECT_FALSE(restarted.ShouldKeep("a", &suppressed));
+
+  // A new window starts over, and its first report has the number dropped.
+  now += options.window;
+  EXPECT_TRUE(restarted.ShouldKeep("a", &suppressed));
+  EXPECT_EQ(suppressed, 2u);
+  EXPECT_TRUE(restarted.ShouldKeep("a", &suppressed));
+  EXPECT_EQ(suppressed, 0u);
+  EXPECT_FALSE(restarted.ShouldKeep("a", &suppressed));
+}
+
+TEST(CrashSignatureThrottle, DropAll) {
+  ScopedTempDir temp_dir;
+  CrashSignatureThrottle::Options options;
+  options.reports_per_window = 1;
+  options.sample_interval = 0;
+  time_t now = 1000;
+  TestCrashSignatureThrottle throttle(temp_dir.path(), options, &now);
+
+  uint32_t suppressed;
+  EXPECT_TRUE(throttle.ShouldKeep("a", &suppressed));
+  for (int index = 0; index < 10; ++index) {
+    EXPECT_FALSE(throttle.ShouldKeep("a", &suppressed));
+  }
+
+  now += options.window;
+  EXPECT_TRUE(throttle.ShouldKeep("a", &suppressed));
+  EXPECT_EQ(suppressed, 10u);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
@@ -0,0 +1,388 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "handler/delta_upload_bases.h"
+
+#include <inttypes.h>
+#include <string.h>
+
+#include <memory>
+#include <utility>
+
+#include "base/logging.h"
+#include "base/strings/stringprintf.h"
+#include "build/build_config.h"
+#include "minidump/minidump_file_writer.h"
+#include "minidump/minidump_memory_info_writer.h"
+#include "minidump/minidump_module_writer.h"
+#include "minidump/minidump_system_info_writer.h"
+#include "minidump/minidump_unloaded_module_writer.h"
+#include "snapshot/minidump/process_snapshot_minidump.h"
+#include "third_party/zlib/zlib_crashpad.h"
+#include "util/file/directory_reader.h"
+#include "util/file/file_io.h"
+#include "util/file/filesystem.h"
+#include "util/file/string_file.h"
+#include "util/stdlib/string_number_conversion.h"
+#include "util/string/split_string.h"
+
+#if BUILDFLAG(IS_WIN)
+#include "base/strings/utf_string_conversions.h"
+#endif
+
+namespace crashpad {
+
+namespace {
+
+constexpr base::FilePath::CharType kBasesDirectory[] =
+    FILE_PATH_LITERAL("delta_bases");
+constexpr base::FilePath::CharType kTemporaryExtension[] =
+    FILE_PATH_LITERAL(".tmp");
+
+// The file kept for each process is made of kMagic, followed by each of its
+// streams as a line giving the stream type, the UUID of the report that
+// carried it, and its size, all separated by spaces, followed by the stream.
+constexpr char kMagic[] = "CRASHPAD DELTA UPLOAD BASES 1\n";
+
+// The files of processes that haven’t uploaded a report for this long are
+// removed, no more than once in this time.
+constexpr time_t kStaleSeconds = 7 * 24 * 60 * 60;
+constexpr time_t kCleanIntervalSeconds = 24 * 60 * 60;
+
+constexpr MinidumpStreamType kStaticStreamTypes[] = {
+    kMinidumpStreamTypeSystemInfo,
+    kMinidumpStreamTypeModuleList,
+    kMinidumpStreamTypeUnloadedModuleList,
+    kMinidumpStreamTypeMemoryInfoList,
+};
+
+// Identifies the process that a report was made for, by its process ID and
+// start time. Returns an empty string for a minidump that doesn’t identify its
+// process.
+std::string ProcessKey(const ProcessSnapshot* process_snapshot) {
+  const uint64_t process_id =
+      static_cast<uint64_t>(process_snapshot->ProcessID());
+  timeval start_time;
+  process_snapshot->ProcessStartTime(&start_time);
+  if (process_id == 0 || start_time.tv_sec == 0) {
+    return std::string();
+  }
+  return base::StringPrintf("%" PRIu64 "-%" PRId64 "-%06d",
+                            process_id,
+                            static_cast<int64_t>(start_time.tv_sec),
+                            static_cast<int>(start_time.tv_usec));
+}
+
+// Writes each static stream in process_snapshot as a minidump containing only
+// that stream, so that identical streams are written identically wherever
+// they appear in the minidumps that they come from.
+void WriteStaticStreams(
+    const ProcessSnapshot* process_snapshot,
+    std::map<MinidumpStreamType, std::string>* streams) {
+  streams->clear();
+  for (MinidumpStreamType stream_type : kStaticStreamTypes) {
+    std::unique_ptr<internal::MinidumpStreamWriter> stream;
+    switch (stream_type) {
+      case kMinidumpStreamTypeSystemInfo: {
+        auto system_info = std::make_unique<MinidumpSystemInfoWriter>();
+        system_info->InitializeFromSnapshot(process_snapshot->System());
+        stream = std::move(system_info);
+        break;
+      }
+      case kMinidumpStreamTypeModuleList: {
+        auto module_list = std::make_unique<MinidumpModuleListWriter>();
+        module_list->InitializeFromSnapshot(process_snapshot->Modules());
+        stream = std::move(module_list);
+        break;
+      }
+      case kMinidumpStreamTypeUnloadedModuleList: {
+        const std::vector<UnloadedModuleSnapshot> unloaded_modules =
+            process_snapshot->UnloadedModules();
+        if (!unloaded_modules.empty()) {
+          auto unloaded_module_list =
+              std::make_unique<MinidumpUnloadedModuleListWriter>();
+          unloaded_module_list->InitializeFromSnapshot(unloaded_modules);
+          stream = std::move(unloaded_module_list);
+        }
+        break;
+      }
+      case kMinidumpStreamTypeMemoryInfoList: {
+        const std::vector<const MemoryMapRegionSnapshot*> memory_map =
+            process_snapshot->MemoryMap();
+        if (!memory_map.empty()) {
+          auto memory_info_list =
+              std::make_unique<MinidumpMemoryInfoListWriter>();
+          memory_info_list->InitializeFromSnapshot(memory_map);
+          stream = std::move(memory_info_list);
+        }
+        break;
+      }
+      default:
+        break;
+    }
+    if (!stream) {
+      continue;
+    }
+
+    MinidumpFileWriter minidump;
+    minidump.AddStream(std::move(stream));
+    StringFile file;
+    if (minidump.WriteEverything(&file)) {
+      (*streams)[stream_type] = file.string();
+    }
+  }
+}
+
+std::string Digest(const std::string& data) {
+  uLong crc = crc32(0, nullptr, 0);
+  crc = crc32(crc,
+              reinterpret_cast<const Bytef*>(data.data()),
+              static_cast<uInt>(data.size()));
+  return base::StringPrintf("%016" PRIx64 "-%08" PRIx32,
+                            static_cast<uint64_t>(data.size()),
+                            static_cast<uint32_t>(crc));
+}
+
+}  // namespace
+
+DeltaUploadBases::Upload::Upload()
+    : process_key(), uuid(), streams(), references() {}
+
+DeltaUploadBases::Upload::~Upload() = default;
+
+DeltaUploadBases::DeltaUploadBases(CrashReportDatabase* database)
+    : lock_(),
+      directory_(database->DatabasePath().Append(kBasesDirectory)),
+      last_clean_time_(0) {}
+
+DeltaUploadBases::~DeltaUploadBases() = default;
+
+bool DeltaUploadBases::WriteDeltaMinidump(const UUID& uuid,
+                                          FileReaderInterface* reader,
+                                          FileWriterInterface* writer,
+                                          Upload* upload) {
+  *upload = Upload();
+  upload->uuid = uuid;
+
+  const FileOffset start_offset = reader->SeekGet();
+  if (start_offset < 0) {
+    return false;
+  }
+
+  // The snapshot reads memory from reader as the delta minidump is written.
+  ProcessSnapshotMinidump minidump_process_snapshot;
+  bool written = false;
+  if (minidump_process_snapshot.Initialize(reader)) {
+    upload->process_key = ProcessKey(&minidump_process_snapshot);
+  }
+  if (!upload->process_key.empty()) {
+    WriteStaticStreams(&minidump_process_snapshot, &upload->streams);
+
+    std::map<MinidumpStreamType, Base> bases;
+    {
+      base::AutoLock lock(lock_);
+      ReadBases(upload->process_key, &bases);
+    }
+
+    MinidumpSnapshotFilter filter;
+    for (const auto& stream : upload->streams) {
+      const auto it = bases.find(stream.first);
+      if (it != bases.end() && it->second.data == stream.second) {
+        filter.omitted_streams.insert(stream.first);
+        upload->references.push_back(
+            {stream.first, it->second.uuid, Digest(stream.second)});
+      }
+    }
+
+    if (!upload->references.empty()) {
+      MinidumpFileWriter minidump;
+      minidump.InitializeFromSnapshot(&minidump_process_snapshot, filter);
+      written = minidump.WriteEverything(writer);
+    }
+  }
+
+  if (!reader->SeekSet(start_offset) || !written) {
+    upload->references.clear();
+    return false;
+  }
+  return true;
+}
+
+void DeltaUploadBases::RecordUpload(const Upload& upload, bool success) {
+  if (upload.process_key.empty()) {
+    return;
+  }
+
+  base::AutoLock lock(lock_);
+  const base::FilePath path = BasePath(upload.process_key);
+  if (!success) {
+    if (!upload.references.empty() && IsRegularFile(path)) {
+      LoggingRemoveFile(path);
+    }
+    return;
+  }
+
+  // The streams left out of the upload are still found in the reports that
+  // carried them, and the rest are found in this one.
+  std::map<MinidumpStreamType, Base> bases;
+  for (const auto& stream : upload.streams) {
+    Base& base = bases[stream.first];
+    base.uuid = upload.uuid;
+    base.data = stream.second;
+  }
+  for (const Reference& reference : upload.references) {
+    bases[reference.stream_type].uuid = reference.base_uuid;
+  }
+  WriteBases(upload.process_key, bases);
+
+  RemoveStaleBases();
+}
+
+// static
+std::string DeltaUploadBases::FormatReferences(
+    const std::vector<Reference>& references) {
+  std::string formatted;
+  for (const Reference& reference : references) {
+    if (!formatted.empty()) {
+      formatted.push_back(',');
+    }
+    formatted.append(base::StringPrintf("%u:%s:%s",
+                                        static_cast<unsigned int>(
+                                            reference.stream_type),
+                                        reference.base_uuid.ToString().c_str(),
+                                        reference.digest.c_str()));
+  }
+  return formatted;
+}
+
+base::FilePath DeltaUploadBases::BasePath(const std::string& process_key) {
+#if BUILDFLAG(IS_WIN)
+  return directory_.Append(base::UTF8ToWide(process_key));
+#else
+  return directory_.Append(process_key);
+#endif
+}
+
+bool DeltaUploadBases::ReadBases(const std::string& process_key,
+                                 std::map<MinidumpStreamType, Base>* bases) {
+  bases->clear();
+
+  const base::FilePath path = BasePath(process_key);
+  std::string contents;
+  if (!IsRegularFile(path) || !LoggingReadEntireFile(path, &contents)) {
+    return false;
+  }
+
+  const size_t magic_size = strlen(kMagic);
+  if (contents.compare(0, magic_size, kMagic) != 0) {
+    LOG(ERROR) << "unexpected delta upload bases format";
+    return false;
+  }
+
+  size_t offset = magic_size;
+  while (offset < contents.size()) {
+    const size_t line_end = contents.find('\n', offset);
+    if (line_end == std::string::npos) {
+      LOG(ERROR) << "unexpected delta upload bases format";
+      bases->clear();
+      return false;
+    }
+
+    const std::vector<std::string> fields =
+        SplitString(contents.substr(offset, line_end - offset), ' ');
+    unsigned int stream_type;
+    UUID uuid;
+    unsigned long long size;
+    if (fields.size() != 3 || !StringToNumber(fields[0], &stream_type) ||
+        !uuid.InitializeFromString(fields[1]) ||
+        !StringToNumber(fields[2], &size) ||
+        size > contents.size() - line_end - 1) {
+      LOG(ERROR) << "unexpected delta upload bases format";
+      bases->clear();
+      return false;
+    }
+
+    Base& base = (*bases)[static_cast<MinidumpStreamType>(stream_type)];
+    base.uuid = uuid;
+    base.data = contents.substr(line_end + 1, static_cast<size_t>(size));
+    offset = line_end + 1 + static_cast<size_t>(size);
+  }
+  return true;
+}
+
+bool DeltaUploadBases::WriteBases(
+    const std::string& process_key,
+    const std::map<MinidumpStreamType, Base>& bases) {
+  std::string contents(kMagic);
+  for (const auto& base : bases) {
+    contents.append(base::StringPrintf("%u %s %zu\n",
+                                       static_cast<unsigned int>(base.first),
+                                       base.second.uuid.ToString().c_str(),
+                                       base.second.data.size()));
+    contents.append(base.second.data);
+  }
+
+  if (!LoggingCreateDirectory(directory_, FilePermissions::kOwnerOnly, true)) {
+    return false;
+  }
+
+  // Renaming the finished file into place means that a partially-written one
+  // is never read.
+  const base::FilePath path = BasePath(process_key);
+  const base::FilePath temporary_path(path.value() + kTemporaryExtension);
+  {
+    FileWriter writer;
+    if (!writer.Open(temporary_path,
+                     FileWriteMode::kTruncateOrCreate,
+                     FilePermissions::kOwnerOnly)) {
+      return false;
+    }
+    if (!writer.Write(contents.data(), contents.size())) {
+      writer.Close();
+      LoggingRemoveFile(temporary_path);
+      return false;
+    }
+  }
+
+  if (!MoveFileOrDirectory(temporary_path, path)) {
+    LoggingRemoveFile(temporary_path);
+    return false;
+  }
+  return true;
+}
+
+void DeltaUploadBases::RemoveStaleBases() {
+  const time_t now = time(nullptr);
+  if (now - last_clean_time_ < kCleanIntervalSeconds) {
+    return;
+  }
+  last_clean_time_ = now;
+
+  DirectoryReader reader;
+  if (!reader.Open(directory_)) {
+    return;
+  }
+
+  base::FilePath filename;
+  while (reader.NextFile(&filename) == DirectoryReader::Result::kSuccess) {
+    const base::FilePath path = directory_.Append(filename);
+    timespec mtime;
+    if (FileModificationTime(path, &mtime) &&
+        now - mtime.tv_sec > kStaleSeconds) {
+      LoggingRemoveFile(path);
+    }
+  }
+}
+
+}  // namespace crashpad
@@ -0,0 +1,158 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_HANDLER_DELTA_UPLOAD_BASES_H_
+#define CRASHPAD_HANDLER_DELTA_UPLOAD_BASES_H_
+
+#include <time.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "base/files/file_path.h"
+#include "base/synchronization/lock.h"
+#include "client/crash_report_database.h"
+#include "minidump/minidump_extensions.h"
+#include "util/file/file_reader.h"
+#include "util/file/file_writer.h"
+#include "util/misc/uuid.h"
+
+namespace crashpad {
+
+//! \brief Keeps the static streams of the reports uploaded for each process,
+//!     so that later reports from the same process can be uploaded as delta
+//!     minidumps.
+//!
+//! The system information, module list, unloaded module list, and memory info
+//! list of a long-running process rarely change between the reports that it
+//! makes, such as periodic dumps taken without a crash. A delta minidump leaves
+//! out each of these streams that is identical to the one most recently
+//! uploaded for the same process, and the upload names the report that the
+//! server can take each stream left out from. Streams are compared by their
+//! contents as written by MinidumpFileWriter on their own, so that they match
+//! regardless of where they are placed in each minidump.
+//!
+//! The streams are kept in files in a directory alongside the database, one
+//! file for each process. Files for processes that haven’t uploaded a report
+//! in a week are removed.
+//!
+//! This class is thread-safe.
+class DeltaUploadBases {
+ public:
+  //! \brief A stream left out of a delta minidump.
+  struct Reference {
+    //! \brief The type of the stream.
+    MinidumpStreamType stream_type;
+
+    //! \brief The report whose upload carried the stream.
+    UUID base_uuid;
+
+    //! \brief The size and CRC-32 of the stream, written on its own, as
+    //!     16 and 8 hexadecimal digits joined by `-`.
+    std::string digest;
+  };
+
+  //! \brief A report’s upload, as prepared by WriteDeltaMinidump().
+  struct Upload {
+    Upload();
+    ~Upload();
+
+    //! \brief Identifies the process that made the report.
+    std::string process_key;
+
+    //! \brief The report’s unique identifier.
+    UUID uuid;
+
+    //! \brief The report’s static streams, each written on its own, by type.
+    std::map<MinidumpStreamType, std::string> streams;
+
+    //! \brief The streams left out of the upload. This is empty if the report
+    //!     is uploaded in full.
+    std::vector<Reference> references;
+  };
+
+  //! \brief The form data key whose value lists the streams left out of a delta
+  //!     minidump, in the format returned by FormatReferences().
+  static constexpr char kReferencesKey[] = "minidump_delta";
+
+  //! \param[in] database The database whose reports are uploaded.
+  explicit DeltaUploadBases(CrashReportDatabase* database);
+
+  DeltaUploadBases(const DeltaUploadBases&) = delete;
+  DeltaUploadBases& operator=(const DeltaUploadBases&) = delete;
+
+  ~DeltaUploadBases();
+
+  //! \brief Prepares the upload of a report’s minidump.
+  //!
+  //! \param[in] uuid The report’s unique identifier.
+  //! \param[in] reader The report’s minidump, which may have been written
+  //!     compressed. It is left at the position that it was found at.
+  //! \param[out] writer The writer to receive a delta minidump, which is not
+  //!     compressed.
+  //! \param[out] upload The report’s upload, to be given to RecordUpload() once
+  //!     it has been attempted.
+  //!
+  //! \return `true` if a delta minidump was written to \a writer, with the
+  //!     streams left out of it in Upload::references. `false` if the report
+  //!     should be uploaded in full, because no stream could be left out or on
+  //!     failure. \a upload is usable either way, unless Upload::process_key
+  //!     is empty.
+  bool WriteDeltaMinidump(const UUID& uuid,
+                          FileReaderInterface* reader,
+                          FileWriterInterface* writer,
+                          Upload* upload);
+
+  //! \brief Records the outcome of an upload prepared by WriteDeltaMinidump().
+  //!
+  //! After a successful upload, the streams that it carried become the ones
+  //! that later reports from the same process are compared with. After a
+  //! failed delta upload, the streams kept for the process are discarded, so
+  //! that the report is uploaded in full when it is retried, in case the server
+  //! couldn’t find the streams that it left out.
+  //!
+  //! \param[in] upload The upload.
+  //! \param[in] success Whether the upload succeeded.
+  void RecordUpload(const Upload& upload, bool success);
+
+  //! \brief Returns \a references in the format sent as the value of
+  //!     #kReferencesKey.
+  //!
+  //! Each reference is written as the stream type in decimal, the base
+  //! report’s UUID, and the digest, separated by `:`. References are separated
+  //! by `,`.
+  static std::string FormatReferences(const std::vector<Reference>& references);
+
+ private:
+  struct Base {
+    UUID uuid;
+    std::string data;
+  };
+
+  base::FilePath BasePath(const std::string& process_key);
+  bool ReadBases(const std::string& process_key,
+                 std::map<MinidumpStreamType, Base>* bases);
+  bool WriteBases(const std::string& process_key,
+                  const std::map<MinidumpStreamType, Base>& bases);
+  void RemoveStaleBases();
+
+  base::Lock lock_;
+  base::FilePath directory_;
+  time_t last_clean_time_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_HANDLER_DELTA_UPLOAD_BASES_H_
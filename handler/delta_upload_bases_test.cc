@@ -0,0 +1,145 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "handler/delta_upload_bases.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "minidump/minidump_file_writer.h"
+#include "snapshot/minidump/process_snapshot_minidump.h"
+#include "snapshot/test/test_module_snapshot.h"
+#include "snapshot/test/test_process_snapshot.h"
+#include "snapshot/test/test_system_snapshot.h"
+#include "test/scoped_temp_dir.h"
+#include "util/file/string_file.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+// Writes a minidump for a process with a single module to file.
+void WriteMinidump(const std::string& module_name, StringFile* file) {
+  UUID report_id;
+  ASSERT_TRUE(report_id.InitializeWithNew());
+
+  TestProcessSnapshot process_snapshot;
+  process_snapshot.SetReportID(report_id);
+  process_snapshot.SetProcessID(1234);
+  timeval start_time = {1700000000, 5};
+  process_snapshot.SetProcessStartTime(start_time);
+  process_snapshot.SetSystem(std::make_unique<TestSystemSnapshot>());
+
+  auto module = std::make_unique<TestModuleSnapshot>();
+  module->SetName(module_name);
+  module->SetAddressAndSize(0x10000, 0x1000);
+  process_snapshot.AddModule(std::move(module));
+
+  MinidumpFileWriter minidump;
+  minidump.InitializeFromSnapshot(&process_snapshot);
+  ASSERT_TRUE(minidump.WriteEverything(file));
+  ASSERT_TRUE(file->SeekSet(0));
+}
+
+class DeltaUploadBasesTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    database_ = CrashReportDatabase::Initialize(temp_dir_.path());
+    ASSERT_TRUE(database_);
+  }
+
+  CrashReportDatabase* database() { return database_.get(); }
+
+ private:
+  ScopedTempDir temp_dir_;
+  std::unique_ptr<CrashReportDatabase> database_;
+};
+
+TEST_F(DeltaUploadBasesTest, Delta) {
+  DeltaUploadBases bases(database());
+
+  UUID uuid_1;
+  ASSERT_TRUE(uuid_1.InitializeWithNew());
+  StringFile minidump_1;
+  ASSERT_NO_FATAL_FAILURE(WriteMinidump("/lib/liba.so", &minidump_1));
+
+  // With nothing uploaded yet, the first report is uploaded in full.
+  StringFile delta;
+  DeltaUploadBases::Upload upload;
+  EXPECT_FALSE(
+      bases.WriteDeltaMinidump(uuid_1, &minidump_1, &delta, &upload));
+  EXPECT_FALSE(upload.process_key.empty());
+  EXPECT_EQ(upload.uuid, uuid_1);
+  EXPECT_EQ(upload.streams.count(kMinidumpStreamTypeSystemInfo), 1u);
+  EXPECT_EQ(upload.streams.count(kMinidumpStreamTypeModuleList), 1u);
+  EXPECT_TRUE(upload.references.empty());
+  EXPECT_EQ(minidump_1.SeekGet(), 0);
+  bases.RecordUpload(upload, true);
+
+  // A second report with the same streams leaves them out.
+  UUID uuid_2;
+  ASSERT_TRUE(uuid_2.InitializeWithNew());
+  StringFile minidump_2;
+  ASSERT_NO_FATAL_FAILURE(WriteMinidump("/lib/liba.so", &minidump_2));
+  ASSERT_TRUE(bases.WriteDeltaMinidump(uuid_2, &minidump_2, &delta, &upload));
+  ASSERT_EQ(upload.references.size(), 2u);
+  for (const DeltaUploadBases::Reference& reference : upload.references) {
+    EXPECT_EQ(reference.base_uuid, uuid_1);
+    EXPECT_EQ(reference.digest.size(), 25u);
+  }
+  EXPECT_LT(delta.string().size(), minidump_2.string().size());
+
+  ASSERT_TRUE(delta.SeekSet(0));
+  ProcessSnapshotMinidump delta_snapshot;
+  ASSERT_TRUE(delta_snapshot.Initialize(&delta));
+  EXPECT_TRUE(delta_snapshot.Modules().empty());
+  bases.RecordUpload(upload, true);
+
+  // A report with a different module list only leaves out the system info,
+  // which is still found in the first report.
+  UUID uuid_3;
+  ASSERT_TRUE(uuid_3.InitializeWithNew());
+  StringFile minidump_3;
+  ASSERT_NO_FATAL_FAILURE(WriteMinidump("/lib/libb.so", &minidump_3));
+  delta.Reset();
+  ASSERT_TRUE(bases.WriteDeltaMinidump(uuid_3, &minidump_3, &delta, &upload));
+  ASSERT_EQ(upload.references.size(), 1u);
+  EXPECT_EQ(upload.references[0].stream_type, kMinidumpStreamTypeSystemInfo);
+  EXPECT_EQ(upload.references[0].base_uuid, uuid_1);
+
+  // After a failed delta upload, the report is uploaded in full.
+  bases.RecordUpload(upload, false);
+  delta.Reset();
+  EXPECT_FALSE(bases.WriteDeltaMinidump(uuid_3, &minidump_3, &delta, &upload));
+  EXPECT_TRUE(upload.references.empty());
+}
+
+TEST(DeltaUploadBases, FormatReferences) {
+  EXPECT_EQ(DeltaUploadBases::FormatReferences({}), "");
+
+  UUID uuid;
+  ASSERT_TRUE(
+      uuid.InitializeFromString("00112233-4455-6677-8899-aabbccddeeff"));
+  EXPECT_EQ(DeltaUploadBases::FormatReferences(
+                {{kMinidumpStreamTypeSystemInfo, uuid, "a-b"},
+                 {kMinidumpStreamTypeModuleList, uuid, "c-d"}}),
+            "7:00112233-4455-6677-8899-aabbccddeeff:a-b,"
+            "4:00112233-4455-6677-8899-aabbccddeeff:c-d");
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
@@ -22,6 +22,7 @@
 
 #include <algorithm>
 #include <atomic>
+#include <limits>
 #include <map>
 #include <memory>
 #include <string>
@@ -33,6 +34,7 @@
 #include "base/files/scoped_file.h"
 #include "base/logging.h"
 #include "base/metrics/persistent_histogram_allocator.h"
+#include "base/notreached.h"
 #include "base/scoped_generic.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/stringprintf.h"
@@ -45,26 +47,42 @@
 #include "client/simple_string_dictionary.h"
 #include "handler/crash_report_upload_thread.h"
 #include "handler/prune_crash_reports_thread.h"
+#include "handler/upload_policy.h"
 #include "tools/tool_support.h"
 #include "util/file/file_io.h"
 #include "util/misc/address_types.h"
+#include "util/misc/clock.h"
 #include "util/misc/metrics.h"
 #include "util/misc/paths.h"
+#include "util/misc/trace_events.h"
+#include "util/net/http_body_gzip.h"
+#include "util/net/http_body_zstd.h"
+#include "util/net/http_multipart_builder.h"
 #include "util/numeric/in_range_cast.h"
 #include "util/stdlib/map_insert.h"
 #include "util/stdlib/string_number_conversion.h"
 #include "util/string/split_string.h"
 #include "util/synchronization/semaphore.h"
+#include "util/thread/thread.h"
+#include "util/thread/work_scheduler.h"
 
 #if BUILDFLAG(IS_CHROMEOS_ASH) || BUILDFLAG(IS_CHROMEOS_LACROS)
 #include "handler/linux/cros_crash_report_exception_handler.h"
 #endif
 
 #if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+#include <poll.h>
 #include <unistd.h>
 
+#include "base/posix/eintr_wrapper.h"
+#include "handler/crash_signature.h"
 #include "handler/linux/crash_report_exception_handler.h"
 #include "handler/linux/exception_handler_server.h"
+#include "handler/linux/resource_usage_reporter.h"
+#include "handler/linux/scoped_dump_priority.h"
+#include "handler/linux/stack_sampler.h"
+#include "util/linux/exception_handler_protocol.h"
+#include "util/linux/socket.h"
 #include "util/posix/signals.h"
 #elif BUILDFLAG(IS_APPLE)
 #include <libgen.h>
@@ -113,13 +131,98 @@ void Usage(const base::FilePath& me) {
   // clang-format on
 #endif  // ATTACHMENTS_SUPPORTED
       // clang-format off
+"      --batch-uploads=BYTES   upload reports of up to BYTES together, with up\n"
+"                              to BYTES of reports in each request\n"
+  // clang-format on
+#if BUILDFLAG(IS_WIN) || BUILDFLAG(IS_APPLE)
+      // clang-format off
+"      --clone-non-fatal-dumps resume clients early for dumps without a\n"
+"                              crash, reading a clone of their memory\n"
+  // clang-format on
+#endif  // BUILDFLAG(IS_WIN) || BUILDFLAG(IS_APPLE)
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+      // clang-format off
+"      --capture-whole-allocations\n"
+"                              capture whole heap allocations referenced by\n"
+"                              threads, instead of a fixed amount around them\n"
+"      --checksum-minidumps    checksum minidumps written to the database\n"
+"      --collapse-identical-threads\n"
+"                              leave out the stacks of threads identical to\n"
+"                              another thread\n"
+"      --compress-minidumps    compress minidumps written to the database\n"
+"      --copy-attachments-after-release\n"
+"                              resume clients before copying attachments\n"
+  // clang-format on
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+      // clang-format off
+"      --daemon                accept clients on a well-known socket instead of\n"
+"                              serving a single client\n"
+"      --daemon-socket-name=NAME\n"
+"                              accept clients on NAME in the abstract socket\n"
+"                              namespace; implies --daemon\n"
+  // clang-format on
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+      // clang-format off
 "      --database=PATH         store the crash report database at PATH\n"
   // clang-format on
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+      // clang-format off
+"      --database-compact-metadata\n"
+"                              create the database with compact metadata\n"
+"      --database-group-commit=MILLISECONDS\n"
+"                              sync new reports, sharing syncs among reports\n"
+"                              finished within MILLISECONDS\n"
+"      --database-sharded-reports\n"
+"                              keep the database's reports in shards\n"
+  // clang-format on
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+#if defined(ATTACHMENTS_SUPPORTED)
+      // clang-format off
+"      --deduplicate-attachments\n"
+"                              store identical attachments once, shared among\n"
+"                              reports\n"
+  // clang-format on
+#endif  // ATTACHMENTS_SUPPORTED
+      // clang-format off
+"      --delta-uploads         leave streams unchanged since the last upload\n"
+"                              from the same process out of its next upload\n"
+  // clang-format on
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+      // clang-format off
+"      --dump-cpus=LIST        handle exceptions on the CPUs in LIST, such as\n"
+"                              0-3,8\n"
+"      --dump-nice=N           handle exceptions with nice value N\n"
+"      --duplicate-crash-limit=N\n"
+"                              write only N reports of each crash signature\n"
+"                              per hour\n"
+"      --duplicate-crash-sample=N\n"
+"                              past the limit, write one in N reports of each\n"
+"                              crash signature\n"
+"      --full-memory-dumps     write all of the client's writable memory into\n"
+"                              minidumps written to the database\n"
+"      --full-memory-max-mapping-size=BYTES\n"
+"                              leave mappings larger than BYTES out of\n"
+"                              full-memory minidumps\n"
+  // clang-format on
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
 #if BUILDFLAG(IS_APPLE)
       // clang-format off
 "      --handshake-fd=FD       establish communication with the client over FD\n"
   // clang-format on
 #endif  // BUILDFLAG(IS_APPLE)
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+      // clang-format off
+"      --hang-poll-interval=MILLISECONDS\n"
+"                              check clients' watched threads for hangs every\n"
+"                              MILLISECONDS\n"
+  // clang-format on
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
 #if BUILDFLAG(IS_WIN)
       // clang-format off
 "      --initial-client-data=HANDLE_request_crash_dump,\n"
@@ -139,24 +242,59 @@ void Usage(const base::FilePath& me) {
   // clang-format on
 #endif  // BUILDFLAG(IS_ANDROID) || BUILDFLAG(IS_LINUX) ||
         // BUILDFLAG(IS_CHROMEOS)
+      // clang-format off
+"      --lazy-startup          serve clients before starting --monitor-self and\n"
+"                              the first scan for pending reports\n"
+  // clang-format on
 #if BUILDFLAG(IS_APPLE)
       // clang-format off
 "      --mach-service=SERVICE  register SERVICE with the bootstrap server\n"
   // clang-format on
 #endif  // BUILDFLAG(IS_APPLE)
       // clang-format off
+"      --max-concurrent-dumps=N\n"
+"                              write up to N crash dumps at the same time\n"
+  // clang-format on
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+      // clang-format off
+"      --memory-info=mappings|merged\n"
+"                              describe the client's mappings in minidumps,\n"
+"                              merging adjacent similar ones if merged\n"
+  // clang-format on
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+      // clang-format off
 "      --metrics-dir=DIR       store metrics files in DIR (only in Chromium)\n"
+  // clang-format on
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+      // clang-format off
+"      --min-hang-dump-interval=SECONDS\n"
+"                              write at most one hang report every SECONDS\n"
+"      --module-snapshot-threads=N\n"
+"                              initialize module snapshots on N threads\n"
+  // clang-format on
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+      // clang-format off
 "      --monitor-self          run a second handler to catch crashes in the first\n"
 "      --monitor-self-annotation=KEY=VALUE\n"
 "                              set a module annotation in the handler\n"
 "      --monitor-self-argument=ARGUMENT\n"
 "                              provide additional arguments to the second handler\n"
+  // clang-format on
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+      // clang-format off
+"      --monitor-self-at-crash start the second handler only if the first crashes\n"
+  // clang-format on
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+      // clang-format off
 "      --no-identify-client-via-url\n"
 "                              when uploading crash report, don't add\n"
 "                              client-identifying arguments to URL\n"
 "      --no-periodic-tasks     don't scan for new reports or prune the database\n"
 "      --no-rate-limit         don't rate limit crash uploads\n"
-"      --no-upload-gzip        don't use gzip compression when uploading\n"
+"      --no-upload-gzip        same as --upload-compression=none\n"
   // clang-format on
 #if BUILDFLAG(IS_ANDROID)
       // clang-format off
@@ -164,17 +302,57 @@ void Usage(const base::FilePath& me) {
 "                              don't write minidump to database\n"
   // clang-format on
 #endif  // BUILDFLAG(IS_ANDROID)
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+      // clang-format off
+"      --park-until-request    wait for the first request from the client\n"
+"                              given by --initial-client-fd before starting\n"
+  // clang-format on
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+      // clang-format off
+"      --periodic-task-threads=N\n"
+"                              run report uploads and database pruning on N\n"
+"                              shared threads\n"
+  // clang-format on
 #if BUILDFLAG(IS_WIN)
       // clang-format off
+"      --pipe-instances=N      listen for clients on N pipe instances\n"
 "      --pipe-name=PIPE        communicate with the client over PIPE\n"
   // clang-format on
 #endif  // BUILDFLAG(IS_WIN)
+      // clang-format off
+"      --precompress-reports   compress the uploads of pending reports ahead of\n"
+"                              time, in the background\n"
+  // clang-format on
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+      // clang-format off
+"      --prepare-reports-ahead keep a new crash report prepared in the database\n"
+"      --release-clients-before-writing\n"
+"                              resume clients once their minidump is in memory\n"
+  // clang-format on
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
 #if BUILDFLAG(IS_APPLE)
       // clang-format off
 "      --reset-own-crash-exception-port-to-system-default\n"
 "                              reset the server's exception handler to default\n"
   // clang-format on
 #endif  // BUILDFLAG(IS_APPLE)
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+      // clang-format off
+"      --resource-usage-interval=SECONDS\n"
+"                              sample the handler's own resource usage every\n"
+"                              SECONDS\n"
+"      --resource-usage-socket=NAME\n"
+"                              send each resource usage sample to a collector\n"
+"                              listening on NAME\n"
+  // clang-format on
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+      // clang-format off
+"      --resumable-uploads     upload reports with the tus resumable upload\n"
+"                              protocol, resuming failed uploads\n"
+  // clang-format on
 #if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
       // clang-format off
 "      --sanitization-information=SANITIZATION_INFORMATION_ADDRESS\n"
@@ -182,12 +360,92 @@ void Usage(const base::FilePath& me) {
 "      --shared-client-connection the file descriptor provided by\n"
 "                              --initial-client-fd is shared among multiple\n"
 "                              clients\n"
+"      --simulated-dump-limit=N\n"
+"                              allow each client N dumps without crashing\n"
+"                              per minute\n"
+"      --stack-sample-history=SECONDS\n"
+"                              keep stack samples for SECONDS\n"
+"      --stack-sample-interval=MILLISECONDS\n"
+"                              sample the stacks of clients that ask for it\n"
+"                              every MILLISECONDS\n"
+  // clang-format on
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID) || \
+    BUILDFLAG(IS_APPLE)
+      // clang-format off
+"      --thread-snapshot-threads=N\n"
+"                              gather client thread information on N threads\n"
+  // clang-format on
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID) || BUILDFLAG(IS_APPLE)
+      // clang-format off
+"      --tiered-uploads        upload a reduced minidump first, and the full\n"
+"                              minidump only if the server asks for it\n"
+"      --trace-file=PATH       write trace events for the phases of handling\n"
+"                              exceptions and reports to PATH\n"
+  // clang-format on
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+      // clang-format off
 "      --trace-parent-with-exception=EXCEPTION_INFORMATION_ADDRESS\n"
 "                              request a dump for the handler's parent process\n"
   // clang-format on
 #endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
         // BUILDFLAG(IS_ANDROID)
       // clang-format off
+"      --trace-startup         log the duration of each phase of startup\n"
+  // clang-format on
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+      // clang-format off
+"      --unwind-stacks         unwind client thread stacks, capturing only\n"
+"                              their live parts and listing their frames\n"
+  // clang-format on
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+      // clang-format off
+"      --upload-budget=BYTES   upload about BYTES per hour at most, sending the\n"
+"                              first report of each crash and small reports\n"
+"                              first\n"
+"      --upload-compression=zstd|gzip|none\n"
+"                              compress uploads with this algorithm; zstd is\n"
+"                              used once the server advertises support for it\n"
+"      --upload-compression-dictionary=PATH\n"
+"                              compress zstd uploads with the dictionary in\n"
+"                              PATH\n"
+"      --upload-compression-level=LEVEL\n"
+"                              compress uploads at this level, or 0 for the\n"
+"                              algorithm's default\n"
+"      --upload-compression-threads=N\n"
+"                              compress each gzip upload on N threads\n"
+"      --upload-concurrency=N  upload up to N crash reports at the same time\n"
+  // clang-format on
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+      // clang-format off
+"      --upload-from-memory=BYTES\n"
+"                              upload minidumps of up to BYTES from memory,\n"
+"                              writing them to the database only on failure\n"
+  // clang-format on
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+      // clang-format off
+"      --upload-http2          allow uploads to use HTTP/2, sharing one\n"
+"                              connection between concurrent uploads\n"
+"      --upload-keep-alive=SECONDS\n"
+"                              keep the connection to the upload server open\n"
+"                              for up to SECONDS between uploads\n"
+"      --upload-pipeline       read, compress, and send each upload on separate\n"
+"                              threads\n"
+"      --upload-precheck       ask the server whether it already has each\n"
+"                              report before uploading it\n"
+  // clang-format on
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+      // clang-format off
+"      --upload-relay=NAME     hand reports to a local agent listening on\n"
+"                              NAME in the abstract socket namespace to upload\n"
+  // clang-format on
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+      // clang-format off
 "      --url=URL               send crash reports to this Breakpad server URL,\n"
 "                              only if uploads are enabled for the database\n"
   // clang-format on
@@ -196,6 +454,9 @@ void Usage(const base::FilePath& me) {
 "      --use-cros-crash-reporter\n"
 "                              pass crash reports to /sbin/crash_reporter\n"
 "                              instead of storing them in the database\n"
+"      --cros-crash-reporter-socket=PATH\n"
+"                              pass crash reports to a crash_reporter\n"
+"                              listening on the socket at PATH\n"
 "      --minidump-dir-for-tests=TEST_MINIDUMP_DIR\n"
 "                              causes /sbin/crash_reporter to leave dumps in\n"
 "                              this directory instead of the normal location\n"
@@ -205,9 +466,21 @@ void Usage(const base::FilePath& me) {
 "                              checks\n"
   // clang-format on
 #endif  // BUILDFLAG(IS_CHROMEOS_ASH) || BUILDFLAG(IS_CHROMEOS_LACROS)
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+      // clang-format off
+"      --user-stream-threads=N run user stream data sources on N threads\n"
+"      --user-stream-time-budget=MILLISECONDS\n"
+"                              cancel user stream data sources that run for\n"
+"                              longer than MILLISECONDS\n"
+  // clang-format on
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
 #if BUILDFLAG(IS_ANDROID)
       // clang-format off
 "      --write-minidump-to-log write minidump to log\n"
+"      --write-minidump-to-log-in-chunks\n"
+"                              write minidump to log in numbered, checksummed\n"
+"                              chunks\n"
   // clang-format on
 #endif  // BUILDFLAG(IS_ANDROID)
       // clang-format off
@@ -224,6 +497,8 @@ struct Options {
   std::string url;
   base::FilePath database;
   base::FilePath metrics_dir;
+  base::FilePath trace_file;
+  base::FilePath upload_compression_dictionary;
   std::vector<std::string> monitor_self_arguments;
 #if BUILDFLAG(IS_APPLE)
   std::string mach_service;
@@ -232,28 +507,99 @@ struct Options {
 #elif BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
   VMAddress exception_information_address;
   VMAddress sanitization_information_address;
+  std::string daemon_socket_name;
+  std::string upload_relay;
+  std::string resource_usage_socket;
   int initial_client_fd;
+  unsigned int module_snapshot_threads;
+  bool capture_whole_allocations;
+  bool checksum_minidumps;
+  bool collapse_identical_threads;
+  bool compress_minidumps;
+  bool copy_attachments_after_release;
+  bool database_compact_metadata;
+  int database_group_commit;
+  bool database_sharded_reports;
+  DumpPriority dump_priority;
+  unsigned int duplicate_crash_limit;
+  unsigned int duplicate_crash_sample;
+  bool full_memory_dumps;
+  unsigned long long full_memory_max_mapping_size;
+  bool memory_info;
+  bool merge_memory_info;
+  bool park_until_request;
+  bool prepare_reports_ahead;
+  bool release_clients_before_writing;
+  unsigned int resource_usage_interval;
   bool shared_client_connection;
+  unsigned int simulated_dump_limit;
+  unsigned int stack_sample_history;
+  unsigned int stack_sample_interval;
+  unsigned long long upload_from_memory;
 #if BUILDFLAG(IS_ANDROID)
   bool write_minidump_to_log;
+  bool write_minidump_to_log_in_chunks;
   bool write_minidump_to_database;
 #endif  // BUILDFLAG(IS_ANDROID)
 #elif BUILDFLAG(IS_WIN)
   std::string pipe_name;
   InitialClientData initial_client_data;
+  unsigned int pipe_instances;
 #endif  // BUILDFLAG(IS_APPLE)
+  unsigned int max_concurrent_dumps;
+  unsigned int periodic_task_threads;
+  unsigned long long batch_uploads;
+#if BUILDFLAG(IS_WIN) || BUILDFLAG(IS_APPLE)
+  bool clone_non_fatal_dumps;
+#endif  // BUILDFLAG(IS_WIN) || BUILDFLAG(IS_APPLE)
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID) || \
+    BUILDFLAG(IS_APPLE)
+  unsigned int thread_snapshot_threads;
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID) || BUILDFLAG(IS_APPLE)
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+  unsigned int user_stream_threads;
+  unsigned int user_stream_time_budget;
+  unsigned int hang_poll_interval;
+  unsigned int min_hang_dump_interval;
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+  bool delta_uploads;
   bool identify_client_via_url;
+  bool lazy_startup;
   bool monitor_self;
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+  bool monitor_self_at_crash;
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
   bool periodic_tasks;
+  bool precompress_reports;
   bool rate_limit;
-  bool upload_gzip;
+  bool resumable_uploads;
+  bool tiered_uploads;
+  bool trace_startup;
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+  bool unwind_stacks;
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+  unsigned long long upload_budget;
+  HTTPMultipartBuilder::Compression upload_compression;
+  int upload_compression_level;
+  unsigned int upload_compression_threads;
+  unsigned int upload_concurrency;
+  bool upload_http2;
+  unsigned int upload_keep_alive;
+  bool upload_pipeline;
+  bool upload_precheck;
 #if BUILDFLAG(IS_CHROMEOS_ASH) || BUILDFLAG(IS_CHROMEOS_LACROS)
   bool use_cros_crash_reporter = false;
+  base::FilePath cros_crash_reporter_socket;
   base::FilePath minidump_dir_for_tests;
   bool always_allow_feedback = false;
 #endif  // BUILDFLAG(IS_CHROMEOS_ASH) || BUILDFLAG(IS_CHROMEOS_LACROS)
 #if defined(ATTACHMENTS_SUPPORTED)
   std::vector<base::FilePath> attachments;
+  bool deduplicate_attachments;
 #endif  // ATTACHMENTS_SUPPORTED
 };
 
@@ -280,6 +626,40 @@ bool AddKeyValueToMap(std::map<std::string, std::string>* map,
   return true;
 }
 
+constexpr struct {
+  const char* name;
+  HTTPMultipartBuilder::Compression compression;
+} kUploadCompressionNames[] = {
+    {"none", HTTPMultipartBuilder::Compression::kNone},
+    {"gzip", HTTPMultipartBuilder::Compression::kGzip},
+    {"zstd", HTTPMultipartBuilder::Compression::kZstd},
+};
+
+// Converts the name of an upload compression algorithm, as it appears in
+// --upload-compression, to the corresponding HTTPMultipartBuilder::Compression.
+bool StringToUploadCompression(const std::string& string,
+                               HTTPMultipartBuilder::Compression* compression) {
+  for (const auto& compression_name : kUploadCompressionNames) {
+    if (string == compression_name.name) {
+      *compression = compression_name.compression;
+      return true;
+    }
+  }
+  return false;
+}
+
+// The inverse of StringToUploadCompression().
+const char* UploadCompressionToString(
+    HTTPMultipartBuilder::Compression compression) {
+  for (const auto& compression_name : kUploadCompressionNames) {
+    if (compression == compression_name.compression) {
+      return compression_name.name;
+    }
+  }
+  NOTREACHED();
+  return nullptr;
+}
+
 // Calls Metrics::HandlerLifetimeMilestone, but only on the first call. This is
 // to prevent multiple exit events from inadvertently being recorded, which
 // might happen if a crash occurs during destruction in what would otherwise be
@@ -305,6 +685,47 @@ int ExitFailure() {
   return EXIT_FAILURE;
 }
 
+// Measures the phases of the handler’s startup, each lasting from the end of
+// the previous one. With --trace-startup, the duration of each phase is logged.
+// The total is recorded with Metrics::OperationDuration() once the handler is
+// ready to serve clients.
+class StartupTrace {
+ public:
+  explicit StartupTrace(bool log_phases)
+      : start_ns_(ClockMonotonicNanoseconds()),
+        phase_start_ns_(start_ns_),
+        log_phases_(log_phases) {}
+
+  StartupTrace(const StartupTrace&) = delete;
+  StartupTrace& operator=(const StartupTrace&) = delete;
+
+  // Marks the end of the phase named |name|.
+  void EndPhase(const char* name) {
+    const uint64_t now_ns = ClockMonotonicNanoseconds();
+    if (log_phases_) {
+      LOG(INFO) << "startup: " << name << " took "
+                << (now_ns - phase_start_ns_) / 1000 << " us";
+    }
+    phase_start_ns_ = now_ns;
+  }
+
+  // Marks the end of startup, once the handler is ready to serve clients.
+  void Ready() {
+    const uint64_t duration_ns = ClockMonotonicNanoseconds() - start_ns_;
+    if (log_phases_) {
+      LOG(INFO) << "startup: ready after " << duration_ns / 1000 << " us";
+    }
+    Metrics::OperationDuration(Metrics::TimedOperation::kHandlerStartup,
+                               duration_ns);
+    TraceEvents::AddEvent("HandlerStartup", start_ns_, start_ns_ + duration_ns);
+  }
+
+ private:
+  const uint64_t start_ns_;
+  uint64_t phase_start_ns_;
+  const bool log_phases_;
+};
+
 class CallMetricsRecordNormalExit {
  public:
   CallMetricsRecordNormalExit() {}
@@ -486,8 +907,13 @@ void MonitorSelf(const Options& options) {
   if (!options.rate_limit) {
     extra_arguments.push_back("--no-rate-limit");
   }
-  if (!options.upload_gzip) {
-    extra_arguments.push_back("--no-upload-gzip");
+  extra_arguments.push_back(
+      base::StringPrintf("--upload-compression=%s",
+                         UploadCompressionToString(options.upload_compression)));
+  if (options.upload_compression_level != 0) {
+    extra_arguments.push_back(
+        base::StringPrintf("--upload-compression-level=%d",
+                           options.upload_compression_level));
   }
   for (const auto& iterator : options.monitor_self_annotations) {
     extra_arguments.push_back(
@@ -500,16 +926,26 @@ void MonitorSelf(const Options& options) {
   // instance of crashpad_handler to be writing metrics at a time, and it should
   // be the primary instance.
   CrashpadClient crashpad_client;
-#if BUILDFLAG(IS_ANDROID)
-  if (!crashpad_client.StartHandlerAtCrash(executable_path,
-                                           options.database,
-                                           base::FilePath(),
-                                           options.url,
-                                           options.annotations,
-                                           extra_arguments)) {
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+  // On Android, the second instance is always started at crash time, rather
+  // than keeping a second handler process running.
+  if (BUILDFLAG(IS_ANDROID) || options.monitor_self_at_crash) {
+    if (!crashpad_client.StartHandlerAtCrash(executable_path,
+                                             options.database,
+                                             base::FilePath(),
+                                             options.url,
+                                             options.annotations,
+                                             extra_arguments)) {
+      return;
+    }
+
+    // Make sure that appropriate metrics will be recorded on crash before
+    // this process is terminated.
+    ReinstallCrashHandler();
     return;
   }
-#else
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
   if (!crashpad_client.StartHandler(executable_path,
                                     options.database,
                                     base::FilePath(),
@@ -520,13 +956,28 @@ void MonitorSelf(const Options& options) {
                                     false)) {
     return;
   }
-#endif
 
   // Make sure that appropriate metrics will be recorded on crash before this
   // process is terminated.
   ReinstallCrashHandler();
 }
 
+// Runs MonitorSelf() for --lazy-startup, once the handler is serving clients.
+class MonitorSelfThread : public Thread {
+ public:
+  explicit MonitorSelfThread(const Options& options) : options_(options) {}
+
+  MonitorSelfThread(const MonitorSelfThread&) = delete;
+  MonitorSelfThread& operator=(const MonitorSelfThread&) = delete;
+
+  ~MonitorSelfThread() override = default;
+
+ private:
+  void ThreadMain() override { MonitorSelf(options_); }
+
+  const Options& options_;
+};
+
 class ScopedStoppable {
  public:
   ScopedStoppable() = default;
@@ -562,6 +1013,22 @@ void InitCrashpadLogging() {
   logging::InitLogging(settings);
 }
 
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+// Waits until the client on sock has sent a request, which is left unread.
+// Returns false if the client hangs up without sending one.
+bool WaitForClientRequest(int sock) {
+  pollfd poll_fd = {};
+  poll_fd.fd = sock;
+  poll_fd.events = POLLIN;
+  if (HANDLE_EINTR(poll(&poll_fd, 1, -1)) < 0) {
+    PLOG(ERROR) << "poll";
+    return false;
+  }
+  return (poll_fd.revents & POLLIN) != 0;
+}
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+
 }  // namespace
 
 int HandlerMain(int argc,
@@ -584,10 +1051,50 @@ int HandlerMain(int argc,
     BUILDFLAG(IS_ANDROID) || BUILDFLAG(IS_APPLE)
     kOptionAttachment,
 #endif  // BUILDFLAG(IS_WIN) || BUILDFLAG(IS_LINUX)
+    kOptionBatchUploads,
+#if BUILDFLAG(IS_WIN) || BUILDFLAG(IS_APPLE)
+    kOptionCloneNonFatalDumps,
+#endif  // BUILDFLAG(IS_WIN) || BUILDFLAG(IS_APPLE)
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+    kOptionCaptureWholeAllocations,
+    kOptionChecksumMinidumps,
+    kOptionCollapseIdenticalThreads,
+    kOptionCompressMinidumps,
+    kOptionCopyAttachmentsAfterRelease,
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+    kOptionDaemon,
+    kOptionDaemonSocketName,
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
     kOptionDatabase,
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+    kOptionDatabaseCompactMetadata,
+    kOptionDatabaseGroupCommit,
+    kOptionDatabaseShardedReports,
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+#if defined(ATTACHMENTS_SUPPORTED)
+    kOptionDeduplicateAttachments,
+#endif  // ATTACHMENTS_SUPPORTED
+    kOptionDeltaUploads,
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+    kOptionDumpCPUs,
+    kOptionDumpNice,
+    kOptionDuplicateCrashLimit,
+    kOptionDuplicateCrashSample,
+    kOptionFullMemoryDumps,
+    kOptionFullMemoryMaxMappingSize,
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
 #if BUILDFLAG(IS_APPLE)
     kOptionHandshakeFD,
 #endif  // BUILDFLAG(IS_APPLE)
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+    kOptionHangPollInterval,
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
 #if BUILDFLAG(IS_WIN)
     kOptionInitialClientData,
 #endif  // BUILDFLAG(IS_WIN)
@@ -595,13 +1102,28 @@ int HandlerMain(int argc,
     kOptionInitialClientFD,
 #endif  // BUILDFLAG(IS_ANDROID) || BUILDFLAG(IS_LINUX) ||
         // BUILDFLAG(IS_CHROMEOS)
+    kOptionLazyStartup,
 #if BUILDFLAG(IS_APPLE)
     kOptionMachService,
 #endif  // BUILDFLAG(IS_APPLE)
+    kOptionMaxConcurrentDumps,
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+    kOptionMemoryInfo,
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
     kOptionMetrics,
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+    kOptionMinHangDumpInterval,
+    kOptionModuleSnapshotThreads,
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
     kOptionMonitorSelf,
     kOptionMonitorSelfAnnotation,
     kOptionMonitorSelfArgument,
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+    kOptionMonitorSelfAtCrash,
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
     kOptionNoIdentifyClientViaUrl,
     kOptionNoPeriodicTasks,
     kOptionNoRateLimit,
@@ -609,25 +1131,86 @@ int HandlerMain(int argc,
 #if BUILDFLAG(IS_ANDROID)
     kOptionNoWriteMinidumpToDatabase,
 #endif  // BUILDFLAG(IS_ANDROID)
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+    kOptionParkUntilRequest,
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+    kOptionPeriodicTaskThreads,
 #if BUILDFLAG(IS_WIN)
+    kOptionPipeInstances,
     kOptionPipeName,
 #endif  // BUILDFLAG(IS_WIN)
+    kOptionPrecompressReports,
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+    kOptionPrepareReportsAhead,
+    kOptionReleaseClientsBeforeWriting,
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
 #if BUILDFLAG(IS_APPLE)
     kOptionResetOwnCrashExceptionPortToSystemDefault,
 #endif  // BUILDFLAG(IS_APPLE)
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+    kOptionResourceUsageInterval,
+    kOptionResourceUsageSocket,
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+    kOptionResumableUploads,
 #if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
     kOptionSanitizationInformation,
     kOptionSharedClientConnection,
+    kOptionSimulatedDumpLimit,
+    kOptionStackSampleHistory,
+    kOptionStackSampleInterval,
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID) || \
+    BUILDFLAG(IS_APPLE)
+    kOptionThreadSnapshotThreads,
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID) || BUILDFLAG(IS_APPLE)
+    kOptionTieredUploads,
+    kOptionTraceFile,
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
     kOptionTraceParentWithException,
 #endif
+    kOptionTraceStartup,
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+    kOptionUnwindStacks,
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+    kOptionUploadBudget,
+    kOptionUploadCompression,
+    kOptionUploadCompressionDictionary,
+    kOptionUploadCompressionLevel,
+    kOptionUploadCompressionThreads,
+    kOptionUploadConcurrency,
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+    kOptionUploadFromMemory,
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+    kOptionUploadHTTP2,
+    kOptionUploadKeepAlive,
+    kOptionUploadPipeline,
+    kOptionUploadPrecheck,
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+    kOptionUploadRelay,
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
     kOptionURL,
 #if BUILDFLAG(IS_CHROMEOS_ASH) || BUILDFLAG(IS_CHROMEOS_LACROS)
     kOptionUseCrosCrashReporter,
+    kOptionCrosCrashReporterSocket,
     kOptionMinidumpDirForTests,
     kOptionAlwaysAllowFeedback,
 #endif  // BUILDFLAG(IS_CHROMEOS_ASH) || BUILDFLAG(IS_CHROMEOS_LACROS)
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+    kOptionUserStreamThreads,
+    kOptionUserStreamTimeBudget,
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
 #if BUILDFLAG(IS_ANDROID)
     kOptionWriteMinidumpToLog,
+    kOptionWriteMinidumpToLogInChunks,
 #endif  // BUILDFLAG(IS_ANDROID)
 
     // Standard options.
@@ -640,39 +1223,142 @@ int HandlerMain(int argc,
 #if defined(ATTACHMENTS_SUPPORTED)
     {"attachment", required_argument, nullptr, kOptionAttachment},
 #endif  // ATTACHMENTS_SUPPORTED
-    {"database", required_argument, nullptr, kOptionDatabase},
-#if BUILDFLAG(IS_APPLE)
-    {"handshake-fd", required_argument, nullptr, kOptionHandshakeFD},
-#endif  // BUILDFLAG(IS_APPLE)
-#if BUILDFLAG(IS_WIN)
-    {"initial-client-data",
-     required_argument,
+    {"batch-uploads", required_argument, nullptr, kOptionBatchUploads},
+#if BUILDFLAG(IS_WIN) || BUILDFLAG(IS_APPLE)
+    {"clone-non-fatal-dumps",
+     no_argument,
      nullptr,
-     kOptionInitialClientData},
-#endif  // BUILDFLAG(IS_APPLE)
-#if BUILDFLAG(IS_ANDROID) || BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS)
-    {"initial-client-fd", required_argument, nullptr, kOptionInitialClientFD},
-#endif  // BUILDFLAG(IS_ANDROID) || BUILDFLAG(IS_LINUX) ||
-        // BUILDFLAG(IS_CHROMEOS)
-#if BUILDFLAG(IS_APPLE)
-    {"mach-service", required_argument, nullptr, kOptionMachService},
-#endif  // BUILDFLAG(IS_APPLE)
-    {"metrics-dir", required_argument, nullptr, kOptionMetrics},
-    {"monitor-self", no_argument, nullptr, kOptionMonitorSelf},
-    {"monitor-self-annotation",
-     required_argument,
+     kOptionCloneNonFatalDumps},
+#endif  // BUILDFLAG(IS_WIN) || BUILDFLAG(IS_APPLE)
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+    {"capture-whole-allocations",
+     no_argument,
      nullptr,
-     kOptionMonitorSelfAnnotation},
-    {"monitor-self-argument",
-     required_argument,
+     kOptionCaptureWholeAllocations},
+    {"checksum-minidumps", no_argument, nullptr, kOptionChecksumMinidumps},
+    {"collapse-identical-threads",
+     no_argument,
      nullptr,
-     kOptionMonitorSelfArgument},
-    {"no-identify-client-via-url",
+     kOptionCollapseIdenticalThreads},
+    {"compress-minidumps", no_argument, nullptr, kOptionCompressMinidumps},
+    {"copy-attachments-after-release",
      no_argument,
      nullptr,
-     kOptionNoIdentifyClientViaUrl},
-    {"no-periodic-tasks", no_argument, nullptr, kOptionNoPeriodicTasks},
-    {"no-rate-limit", no_argument, nullptr, kOptionNoRateLimit},
+     kOptionCopyAttachmentsAfterRelease},
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+    {"daemon", no_argument, nullptr, kOptionDaemon},
+    {"daemon-socket-name",
+     required_argument,
+     nullptr,
+     kOptionDaemonSocketName},
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+    {"database", required_argument, nullptr, kOptionDatabase},
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+    {"database-compact-metadata",
+     no_argument,
+     nullptr,
+     kOptionDatabaseCompactMetadata},
+    {"database-group-commit",
+     required_argument,
+     nullptr,
+     kOptionDatabaseGroupCommit},
+    {"database-sharded-reports",
+     no_argument,
+     nullptr,
+     kOptionDatabaseShardedReports},
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+#if defined(ATTACHMENTS_SUPPORTED)
+    {"deduplicate-attachments",
+     no_argument,
+     nullptr,
+     kOptionDeduplicateAttachments},
+#endif  // ATTACHMENTS_SUPPORTED
+    {"delta-uploads", no_argument, nullptr, kOptionDeltaUploads},
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+    {"dump-cpus", required_argument, nullptr, kOptionDumpCPUs},
+    {"dump-nice", required_argument, nullptr, kOptionDumpNice},
+    {"duplicate-crash-limit",
+     required_argument,
+     nullptr,
+     kOptionDuplicateCrashLimit},
+    {"duplicate-crash-sample",
+     required_argument,
+     nullptr,
+     kOptionDuplicateCrashSample},
+    {"full-memory-dumps", no_argument, nullptr, kOptionFullMemoryDumps},
+    {"full-memory-max-mapping-size",
+     required_argument,
+     nullptr,
+     kOptionFullMemoryMaxMappingSize},
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+#if BUILDFLAG(IS_APPLE)
+    {"handshake-fd", required_argument, nullptr, kOptionHandshakeFD},
+#endif  // BUILDFLAG(IS_APPLE)
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+    {"hang-poll-interval",
+     required_argument,
+     nullptr,
+     kOptionHangPollInterval},
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+#if BUILDFLAG(IS_WIN)
+    {"initial-client-data",
+     required_argument,
+     nullptr,
+     kOptionInitialClientData},
+#endif  // BUILDFLAG(IS_APPLE)
+#if BUILDFLAG(IS_ANDROID) || BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS)
+    {"initial-client-fd", required_argument, nullptr, kOptionInitialClientFD},
+#endif  // BUILDFLAG(IS_ANDROID) || BUILDFLAG(IS_LINUX) ||
+        // BUILDFLAG(IS_CHROMEOS)
+    {"lazy-startup", no_argument, nullptr, kOptionLazyStartup},
+#if BUILDFLAG(IS_APPLE)
+    {"mach-service", required_argument, nullptr, kOptionMachService},
+#endif  // BUILDFLAG(IS_APPLE)
+    {"max-concurrent-dumps",
+     required_argument,
+     nullptr,
+     kOptionMaxConcurrentDumps},
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+    {"memory-info", required_argument, nullptr, kOptionMemoryInfo},
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+    {"metrics-dir", required_argument, nullptr, kOptionMetrics},
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+    {"min-hang-dump-interval",
+     required_argument,
+     nullptr,
+     kOptionMinHangDumpInterval},
+    {"module-snapshot-threads",
+     required_argument,
+     nullptr,
+     kOptionModuleSnapshotThreads},
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+    {"monitor-self", no_argument, nullptr, kOptionMonitorSelf},
+    {"monitor-self-annotation",
+     required_argument,
+     nullptr,
+     kOptionMonitorSelfAnnotation},
+    {"monitor-self-argument",
+     required_argument,
+     nullptr,
+     kOptionMonitorSelfArgument},
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+    {"monitor-self-at-crash", no_argument, nullptr, kOptionMonitorSelfAtCrash},
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+    {"no-identify-client-via-url",
+     no_argument,
+     nullptr,
+     kOptionNoIdentifyClientViaUrl},
+    {"no-periodic-tasks", no_argument, nullptr, kOptionNoPeriodicTasks},
+    {"no-rate-limit", no_argument, nullptr, kOptionNoRateLimit},
     {"no-upload-gzip", no_argument, nullptr, kOptionNoUploadGzip},
 #if BUILDFLAG(IS_ANDROID)
     {"no-write-minidump-to-database",
@@ -680,15 +1366,45 @@ int HandlerMain(int argc,
      nullptr,
      kOptionNoWriteMinidumpToDatabase},
 #endif  // BUILDFLAG(IS_ANDROID)
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+    {"park-until-request", no_argument, nullptr, kOptionParkUntilRequest},
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+    {"periodic-task-threads",
+     required_argument,
+     nullptr,
+     kOptionPeriodicTaskThreads},
 #if BUILDFLAG(IS_WIN)
+    {"pipe-instances", required_argument, nullptr, kOptionPipeInstances},
     {"pipe-name", required_argument, nullptr, kOptionPipeName},
 #endif  // BUILDFLAG(IS_WIN)
+    {"precompress-reports", no_argument, nullptr, kOptionPrecompressReports},
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+    {"prepare-reports-ahead", no_argument, nullptr, kOptionPrepareReportsAhead},
+    {"release-clients-before-writing",
+     no_argument,
+     nullptr,
+     kOptionReleaseClientsBeforeWriting},
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
 #if BUILDFLAG(IS_APPLE)
     {"reset-own-crash-exception-port-to-system-default",
      no_argument,
      nullptr,
      kOptionResetOwnCrashExceptionPortToSystemDefault},
 #endif  // BUILDFLAG(IS_APPLE)
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+    {"resource-usage-interval",
+     required_argument,
+     nullptr,
+     kOptionResourceUsageInterval},
+    {"resource-usage-socket",
+     required_argument,
+     nullptr,
+     kOptionResourceUsageSocket},
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+    {"resumable-uploads", no_argument, nullptr, kOptionResumableUploads},
 #if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
     {"sanitization-information",
      required_argument,
@@ -698,10 +1414,76 @@ int HandlerMain(int argc,
      no_argument,
      nullptr,
      kOptionSharedClientConnection},
+    {"simulated-dump-limit",
+     required_argument,
+     nullptr,
+     kOptionSimulatedDumpLimit},
+    {"stack-sample-history",
+     required_argument,
+     nullptr,
+     kOptionStackSampleHistory},
+    {"stack-sample-interval",
+     required_argument,
+     nullptr,
+     kOptionStackSampleInterval},
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID) || \
+    BUILDFLAG(IS_APPLE)
+    {"thread-snapshot-threads",
+     required_argument,
+     nullptr,
+     kOptionThreadSnapshotThreads},
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID) || BUILDFLAG(IS_APPLE)
+    {"tiered-uploads", no_argument, nullptr, kOptionTieredUploads},
+    {"trace-file", required_argument, nullptr, kOptionTraceFile},
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
     {"trace-parent-with-exception",
      required_argument,
      nullptr,
      kOptionTraceParentWithException},
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+    {"trace-startup", no_argument, nullptr, kOptionTraceStartup},
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+    {"unwind-stacks", no_argument, nullptr, kOptionUnwindStacks},
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+    {"upload-budget", required_argument, nullptr, kOptionUploadBudget},
+    {"upload-compression",
+     required_argument,
+     nullptr,
+     kOptionUploadCompression},
+    {"upload-compression-dictionary",
+     required_argument,
+     nullptr,
+     kOptionUploadCompressionDictionary},
+    {"upload-compression-level",
+     required_argument,
+     nullptr,
+     kOptionUploadCompressionLevel},
+    {"upload-compression-threads",
+     required_argument,
+     nullptr,
+     kOptionUploadCompressionThreads},
+    {"upload-concurrency",
+     required_argument,
+     nullptr,
+     kOptionUploadConcurrency},
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+    {"upload-from-memory",
+     required_argument,
+     nullptr,
+     kOptionUploadFromMemory},
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+    {"upload-http2", no_argument, nullptr, kOptionUploadHTTP2},
+    {"upload-keep-alive", required_argument, nullptr, kOptionUploadKeepAlive},
+    {"upload-pipeline", no_argument, nullptr, kOptionUploadPipeline},
+    {"upload-precheck", no_argument, nullptr, kOptionUploadPrecheck},
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+    {"upload-relay", required_argument, nullptr, kOptionUploadRelay},
 #endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
         // BUILDFLAG(IS_ANDROID)
     {"url", required_argument, nullptr, kOptionURL},
@@ -710,14 +1492,33 @@ int HandlerMain(int argc,
      no_argument,
      nullptr,
      kOptionUseCrosCrashReporter},
+    {"cros-crash-reporter-socket",
+     required_argument,
+     nullptr,
+     kOptionCrosCrashReporterSocket},
     {"minidump-dir-for-tests",
      required_argument,
      nullptr,
      kOptionMinidumpDirForTests},
     {"always-allow-feedback", no_argument, nullptr, kOptionAlwaysAllowFeedback},
 #endif  // BUILDFLAG(IS_CHROMEOS_ASH) || BUILDFLAG(IS_CHROMEOS_LACROS)
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+    {"user-stream-threads",
+     required_argument,
+     nullptr,
+     kOptionUserStreamThreads},
+    {"user-stream-time-budget",
+     required_argument,
+     nullptr,
+     kOptionUserStreamTimeBudget},
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
 #if BUILDFLAG(IS_ANDROID)
     {"write-minidump-to-log", no_argument, nullptr, kOptionWriteMinidumpToLog},
+    {"write-minidump-to-log-in-chunks",
+     no_argument,
+     nullptr,
+     kOptionWriteMinidumpToLogInChunks},
 #endif  // BUILDFLAG(IS_ANDROID)
     {"help", no_argument, nullptr, kOptionHelp},
     {"version", no_argument, nullptr, kOptionVersion},
@@ -729,12 +1530,36 @@ int HandlerMain(int argc,
   options.handshake_fd = -1;
 #endif
   options.identify_client_via_url = true;
+  options.max_concurrent_dumps = 1;
+  options.batch_uploads = 0;
 #if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+  options.database_group_commit = -1;
   options.initial_client_fd = kInvalidFileHandle;
+  options.min_hang_dump_interval = 60;
+  options.module_snapshot_threads = 1;
+  options.stack_sample_history = 10;
+  options.user_stream_threads = 1;
 #endif
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID) || \
+    BUILDFLAG(IS_APPLE)
+  options.thread_snapshot_threads = 1;
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID) || BUILDFLAG(IS_APPLE)
   options.periodic_tasks = true;
+  options.precompress_reports = false;
   options.rate_limit = true;
-  options.upload_gzip = true;
+  options.resumable_uploads = false;
+  options.tiered_uploads = false;
+  options.trace_startup = false;
+  options.upload_budget = 0;
+  options.upload_compression = HTTPMultipartBuilder::Compression::kGzip;
+  options.upload_compression_level = 0;
+  options.upload_compression_threads = 1;
+  options.upload_concurrency = 1;
+  options.upload_http2 = false;
+  options.upload_keep_alive = 0;
+  options.upload_pipeline = false;
+  options.upload_precheck = false;
 #if BUILDFLAG(IS_ANDROID)
   options.write_minidump_to_database = true;
 #endif
@@ -755,11 +1580,144 @@ int HandlerMain(int argc,
         break;
       }
 #endif  // ATTACHMENTS_SUPPORTED
+      case kOptionBatchUploads: {
+        if (!StringToNumber(optarg, &options.batch_uploads) ||
+            options.batch_uploads < 1) {
+          ToolSupport::UsageHint(
+              me, "--batch-uploads requires a positive number of bytes");
+          return ExitFailure();
+        }
+        break;
+      }
+#if BUILDFLAG(IS_WIN) || BUILDFLAG(IS_APPLE)
+      case kOptionCloneNonFatalDumps: {
+        options.clone_non_fatal_dumps = true;
+        break;
+      }
+#endif  // BUILDFLAG(IS_WIN) || BUILDFLAG(IS_APPLE)
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+      case kOptionCaptureWholeAllocations: {
+        options.capture_whole_allocations = true;
+        break;
+      }
+      case kOptionChecksumMinidumps: {
+        options.checksum_minidumps = true;
+        break;
+      }
+      case kOptionCollapseIdenticalThreads: {
+        options.collapse_identical_threads = true;
+        break;
+      }
+      case kOptionCompressMinidumps: {
+        options.compress_minidumps = true;
+        break;
+      }
+      case kOptionCopyAttachmentsAfterRelease: {
+        options.copy_attachments_after_release = true;
+        break;
+      }
+      case kOptionDaemon: {
+        if (options.daemon_socket_name.empty()) {
+          options.daemon_socket_name =
+              ExceptionHandlerProtocol::kDefaultDaemonSocketName;
+        }
+        break;
+      }
+      case kOptionDaemonSocketName: {
+        options.daemon_socket_name = optarg;
+        if (options.daemon_socket_name.empty()) {
+          ToolSupport::UsageHint(me, "--daemon-socket-name requires a name");
+          return ExitFailure();
+        }
+        break;
+      }
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
       case kOptionDatabase: {
         options.database = base::FilePath(
             ToolSupport::CommandLineArgumentToFilePathStringType(optarg));
         break;
       }
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+      case kOptionDatabaseCompactMetadata: {
+        options.database_compact_metadata = true;
+        break;
+      }
+      case kOptionDatabaseGroupCommit: {
+        if (!StringToNumber(optarg, &options.database_group_commit) ||
+            options.database_group_commit < 0) {
+          ToolSupport::UsageHint(
+              me, "--database-group-commit requires a number of milliseconds");
+          return ExitFailure();
+        }
+        break;
+      }
+      case kOptionDatabaseShardedReports: {
+        options.database_sharded_reports = true;
+        break;
+      }
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+#if defined(ATTACHMENTS_SUPPORTED)
+      case kOptionDeduplicateAttachments: {
+        options.deduplicate_attachments = true;
+        break;
+      }
+#endif  // ATTACHMENTS_SUPPORTED
+      case kOptionDeltaUploads: {
+        options.delta_uploads = true;
+        break;
+      }
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+      case kOptionDumpCPUs: {
+        if (!ParseCPUList(optarg, &options.dump_priority.cpus)) {
+          ToolSupport::UsageHint(me, "--dump-cpus requires a list of CPUs");
+          return ExitFailure();
+        }
+        break;
+      }
+      case kOptionDumpNice: {
+        if (!StringToNumber(optarg, &options.dump_priority.nice) ||
+            options.dump_priority.nice < -20 ||
+            options.dump_priority.nice > 19) {
+          ToolSupport::UsageHint(
+              me, "--dump-nice requires a number from -20 to 19");
+          return ExitFailure();
+        }
+        options.dump_priority.raise_priority = true;
+        break;
+      }
+      case kOptionDuplicateCrashLimit: {
+        if (!StringToNumber(optarg, &options.duplicate_crash_limit) ||
+            options.duplicate_crash_limit < 1) {
+          ToolSupport::UsageHint(
+              me, "--duplicate-crash-limit requires a positive number");
+          return ExitFailure();
+        }
+        break;
+      }
+      case kOptionDuplicateCrashSample: {
+        if (!StringToNumber(optarg, &options.duplicate_crash_sample)) {
+          ToolSupport::UsageHint(me,
+                                 "--duplicate-crash-sample requires a number");
+          return ExitFailure();
+        }
+        break;
+      }
+      case kOptionFullMemoryDumps: {
+        options.full_memory_dumps = true;
+        break;
+      }
+      case kOptionFullMemoryMaxMappingSize: {
+        if (!StringToNumber(optarg, &options.full_memory_max_mapping_size)) {
+          ToolSupport::UsageHint(
+              me, "--full-memory-max-mapping-size requires a number of bytes");
+          return ExitFailure();
+        }
+        break;
+      }
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
 #if BUILDFLAG(IS_APPLE)
       case kOptionHandshakeFD: {
         if (!StringToNumber(optarg, &options.handshake_fd) ||
@@ -795,11 +1753,71 @@ int HandlerMain(int argc,
       }
 #endif  // BUILDFLAG(IS_ANDROID) || BUILDFLAG(IS_LINUX) ||
         // BUILDFLAG(IS_CHROMEOS)
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+      case kOptionHangPollInterval: {
+        if (!StringToNumber(optarg, &options.hang_poll_interval)) {
+          ToolSupport::UsageHint(me, "--hang-poll-interval requires a number");
+          return ExitFailure();
+        }
+        break;
+      }
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+      case kOptionLazyStartup: {
+        options.lazy_startup = true;
+        break;
+      }
+      case kOptionMaxConcurrentDumps: {
+        if (!StringToNumber(optarg, &options.max_concurrent_dumps) ||
+            options.max_concurrent_dumps < 1) {
+          ToolSupport::UsageHint(
+              me, "--max-concurrent-dumps requires a positive number");
+          return ExitFailure();
+        }
+        break;
+      }
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+      case kOptionMemoryInfo: {
+        if (strcmp(optarg, "mappings") == 0) {
+          options.memory_info = true;
+          options.merge_memory_info = false;
+        } else if (strcmp(optarg, "merged") == 0) {
+          options.memory_info = true;
+          options.merge_memory_info = true;
+        } else {
+          ToolSupport::UsageHint(
+              me, "--memory-info requires mappings or merged");
+          return ExitFailure();
+        }
+        break;
+      }
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
       case kOptionMetrics: {
         options.metrics_dir = base::FilePath(
             ToolSupport::CommandLineArgumentToFilePathStringType(optarg));
         break;
       }
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+      case kOptionMinHangDumpInterval: {
+        if (!StringToNumber(optarg, &options.min_hang_dump_interval)) {
+          ToolSupport::UsageHint(me,
+                                 "--min-hang-dump-interval requires a number");
+          return ExitFailure();
+        }
+        break;
+      }
+      case kOptionModuleSnapshotThreads: {
+        if (!StringToNumber(optarg, &options.module_snapshot_threads) ||
+            options.module_snapshot_threads < 1) {
+          ToolSupport::UsageHint(
+              me, "--module-snapshot-threads requires a positive number");
+          return ExitFailure();
+        }
+        break;
+      }
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
       case kOptionMonitorSelf: {
         options.monitor_self = true;
         break;
@@ -816,6 +1834,13 @@ int HandlerMain(int argc,
         options.monitor_self_arguments.push_back(optarg);
         break;
       }
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+      case kOptionMonitorSelfAtCrash: {
+        options.monitor_self_at_crash = true;
+        break;
+      }
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
       case kOptionNoIdentifyClientViaUrl: {
         options.identify_client_via_url = false;
         break;
@@ -829,7 +1854,7 @@ int HandlerMain(int argc,
         break;
       }
       case kOptionNoUploadGzip: {
-        options.upload_gzip = false;
+        options.upload_compression = HTTPMultipartBuilder::Compression::kNone;
         break;
       }
 #if BUILDFLAG(IS_ANDROID)
@@ -838,18 +1863,77 @@ int HandlerMain(int argc,
         break;
       }
 #endif  // BUILDFLAG(IS_ANDROID)
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+      case kOptionParkUntilRequest: {
+        options.park_until_request = true;
+        break;
+      }
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+      case kOptionPeriodicTaskThreads: {
+        if (!StringToNumber(optarg, &options.periodic_task_threads)) {
+          ToolSupport::UsageHint(
+              me, "--periodic-task-threads requires a number");
+          return ExitFailure();
+        }
+        break;
+      }
 #if BUILDFLAG(IS_WIN)
+      case kOptionPipeInstances: {
+        if (!StringToNumber(optarg, &options.pipe_instances) ||
+            options.pipe_instances < 1 ||
+            options.pipe_instances > PIPE_UNLIMITED_INSTANCES) {
+          ToolSupport::UsageHint(
+              me, "--pipe-instances requires a number from 1 to 255");
+          return ExitFailure();
+        }
+        break;
+      }
       case kOptionPipeName: {
         options.pipe_name = optarg;
         break;
       }
 #endif  // BUILDFLAG(IS_WIN)
+      case kOptionPrecompressReports: {
+        options.precompress_reports = true;
+        break;
+      }
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+      case kOptionPrepareReportsAhead: {
+        options.prepare_reports_ahead = true;
+        break;
+      }
+      case kOptionReleaseClientsBeforeWriting: {
+        options.release_clients_before_writing = true;
+        break;
+      }
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
 #if BUILDFLAG(IS_APPLE)
       case kOptionResetOwnCrashExceptionPortToSystemDefault: {
         options.reset_own_crash_exception_port_to_system_default = true;
         break;
       }
 #endif  // BUILDFLAG(IS_APPLE)
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+      case kOptionResourceUsageInterval: {
+        if (!StringToNumber(optarg, &options.resource_usage_interval)) {
+          ToolSupport::UsageHint(
+              me, "--resource-usage-interval requires a number");
+          return ExitFailure();
+        }
+        break;
+      }
+      case kOptionResourceUsageSocket: {
+        options.resource_usage_socket = optarg;
+        break;
+      }
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+      case kOptionResumableUploads: {
+        options.resumable_uploads = true;
+        break;
+      }
 #if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
       case kOptionSanitizationInformation: {
         if (!StringToNumber(optarg,
@@ -864,6 +1948,56 @@ int HandlerMain(int argc,
         options.shared_client_connection = true;
         break;
       }
+      case kOptionSimulatedDumpLimit: {
+        if (!StringToNumber(optarg, &options.simulated_dump_limit)) {
+          ToolSupport::UsageHint(me,
+                                 "--simulated-dump-limit requires a number");
+          return ExitFailure();
+        }
+        break;
+      }
+      case kOptionStackSampleHistory: {
+        if (!StringToNumber(optarg, &options.stack_sample_history) ||
+            options.stack_sample_history < 1) {
+          ToolSupport::UsageHint(
+              me, "--stack-sample-history requires a positive number");
+          return ExitFailure();
+        }
+        break;
+      }
+      case kOptionStackSampleInterval: {
+        if (!StringToNumber(optarg, &options.stack_sample_interval)) {
+          ToolSupport::UsageHint(me,
+                                 "--stack-sample-interval requires a number");
+          return ExitFailure();
+        }
+        break;
+      }
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID) || \
+    BUILDFLAG(IS_APPLE)
+      case kOptionThreadSnapshotThreads: {
+        if (!StringToNumber(optarg, &options.thread_snapshot_threads) ||
+            options.thread_snapshot_threads < 1) {
+          ToolSupport::UsageHint(
+              me, "--thread-snapshot-threads requires a positive number");
+          return ExitFailure();
+        }
+        break;
+      }
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID) || BUILDFLAG(IS_APPLE)
+      case kOptionTieredUploads: {
+        options.tiered_uploads = true;
+        break;
+      }
+      case kOptionTraceFile: {
+        options.trace_file = base::FilePath(
+            ToolSupport::CommandLineArgumentToFilePathStringType(optarg));
+        break;
+      }
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
       case kOptionTraceParentWithException: {
         if (!StringToNumber(optarg, &options.exception_information_address)) {
           ToolSupport::UsageHint(
@@ -872,6 +2006,105 @@ int HandlerMain(int argc,
         }
         break;
       }
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+      case kOptionTraceStartup: {
+        options.trace_startup = true;
+        break;
+      }
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+      case kOptionUnwindStacks: {
+        options.unwind_stacks = true;
+        break;
+      }
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+      case kOptionUploadBudget: {
+        if (!StringToNumber(optarg, &options.upload_budget) ||
+            options.upload_budget < 1) {
+          ToolSupport::UsageHint(
+              me, "--upload-budget requires a positive number of bytes");
+          return ExitFailure();
+        }
+        break;
+      }
+      case kOptionUploadCompression: {
+        if (!StringToUploadCompression(optarg, &options.upload_compression)) {
+          ToolSupport::UsageHint(
+              me, "--upload-compression requires zstd, gzip, or none");
+          return ExitFailure();
+        }
+        break;
+      }
+      case kOptionUploadCompressionDictionary: {
+        options.upload_compression_dictionary = base::FilePath(
+            ToolSupport::CommandLineArgumentToFilePathStringType(optarg));
+        break;
+      }
+      case kOptionUploadCompressionLevel: {
+        if (!StringToNumber(optarg, &options.upload_compression_level) ||
+            options.upload_compression_level < 0) {
+          ToolSupport::UsageHint(
+              me, "--upload-compression-level requires a nonnegative number");
+          return ExitFailure();
+        }
+        break;
+      }
+      case kOptionUploadCompressionThreads: {
+        if (!StringToNumber(optarg, &options.upload_compression_threads) ||
+            options.upload_compression_threads < 1) {
+          ToolSupport::UsageHint(
+              me, "--upload-compression-threads requires a positive number");
+          return ExitFailure();
+        }
+        break;
+      }
+      case kOptionUploadConcurrency: {
+        if (!StringToNumber(optarg, &options.upload_concurrency) ||
+            options.upload_concurrency < 1) {
+          ToolSupport::UsageHint(
+              me, "--upload-concurrency requires a positive number");
+          return ExitFailure();
+        }
+        break;
+      }
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+      case kOptionUploadFromMemory: {
+        if (!StringToNumber(optarg, &options.upload_from_memory) ||
+            options.upload_from_memory < 1) {
+          ToolSupport::UsageHint(
+              me, "--upload-from-memory requires a positive number of bytes");
+          return ExitFailure();
+        }
+        break;
+      }
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+      case kOptionUploadHTTP2: {
+        options.upload_http2 = true;
+        break;
+      }
+      case kOptionUploadKeepAlive: {
+        if (!StringToNumber(optarg, &options.upload_keep_alive)) {
+          ToolSupport::UsageHint(
+              me, "--upload-keep-alive requires a number of seconds");
+          return ExitFailure();
+        }
+        break;
+      }
+      case kOptionUploadPipeline: {
+        options.upload_pipeline = true;
+        break;
+      }
+      case kOptionUploadPrecheck: {
+        options.upload_precheck = true;
+        break;
+      }
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+      case kOptionUploadRelay: {
+        options.upload_relay = optarg;
+        break;
+      }
 #endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
         // BUILDFLAG(IS_ANDROID)
       case kOptionURL: {
@@ -883,6 +2116,11 @@ int HandlerMain(int argc,
         options.use_cros_crash_reporter = true;
         break;
       }
+      case kOptionCrosCrashReporterSocket: {
+        options.cros_crash_reporter_socket = base::FilePath(
+            ToolSupport::CommandLineArgumentToFilePathStringType(optarg));
+        break;
+      }
       case kOptionMinidumpDirForTests: {
         options.minidump_dir_for_tests = base::FilePath(
             ToolSupport::CommandLineArgumentToFilePathStringType(optarg));
@@ -893,11 +2131,36 @@ int HandlerMain(int argc,
         break;
       }
 #endif  // BUILDFLAG(IS_CHROMEOS_ASH) || BUILDFLAG(IS_CHROMEOS_LACROS)
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+      case kOptionUserStreamThreads: {
+        if (!StringToNumber(optarg, &options.user_stream_threads) ||
+            options.user_stream_threads < 1) {
+          ToolSupport::UsageHint(
+              me, "--user-stream-threads requires a positive number");
+          return ExitFailure();
+        }
+        break;
+      }
+      case kOptionUserStreamTimeBudget: {
+        if (!StringToNumber(optarg, &options.user_stream_time_budget)) {
+          ToolSupport::UsageHint(me,
+                                 "--user-stream-time-budget requires a number");
+          return ExitFailure();
+        }
+        break;
+      }
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
 #if BUILDFLAG(IS_ANDROID)
       case kOptionWriteMinidumpToLog: {
         options.write_minidump_to_log = true;
         break;
       }
+      case kOptionWriteMinidumpToLogInChunks: {
+        options.write_minidump_to_log = true;
+        options.write_minidump_to_log_in_chunks = true;
+        break;
+      }
 #endif  // BUILDFLAG(IS_ANDROID)
       case kOptionHelp: {
         Usage(me);
@@ -941,9 +2204,19 @@ int HandlerMain(int argc,
   }
 #elif BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
   if (!options.exception_information_address &&
-      options.initial_client_fd == kInvalidFileHandle) {
-    ToolSupport::UsageHint(
-        me, "--trace-parent-with-exception or --initial-client-fd is required");
+      options.initial_client_fd == kInvalidFileHandle &&
+      options.daemon_socket_name.empty()) {
+    ToolSupport::UsageHint(me,
+                           "--trace-parent-with-exception, --initial-client-fd, "
+                           "or --daemon is required");
+    return ExitFailure();
+  }
+  if (!options.daemon_socket_name.empty() &&
+      (options.initial_client_fd != kInvalidFileHandle ||
+       options.exception_information_address)) {
+    ToolSupport::UsageHint(me,
+                           "--daemon is incompatible with --initial-client-fd "
+                           "and --trace-parent-with-exception");
     return ExitFailure();
   }
   if (options.sanitization_information_address &&
@@ -959,6 +2232,18 @@ int HandlerMain(int argc,
         me, "--shared-client-connection requires --initial-client-fd");
     return ExitFailure();
   }
+  if (options.park_until_request &&
+      options.initial_client_fd == kInvalidFileHandle) {
+    ToolSupport::UsageHint(me,
+                           "--park-until-request requires --initial-client-fd");
+    return ExitFailure();
+  }
+  if (!options.resource_usage_socket.empty() &&
+      !options.resource_usage_interval) {
+    ToolSupport::UsageHint(
+        me, "--resource-usage-socket requires --resource-usage-interval");
+    return ExitFailure();
+  }
 #if BUILDFLAG(IS_ANDROID)
   if (!options.write_minidump_to_log && !options.write_minidump_to_database) {
     ToolSupport::UsageHint(me,
@@ -974,6 +2259,27 @@ int HandlerMain(int argc,
     return ExitFailure();
   }
 
+  if ((options.upload_compression == HTTPMultipartBuilder::Compression::kGzip &&
+       options.upload_compression_level > GzipHTTPBodyStream::kMaximumLevel) ||
+      (options.upload_compression == HTTPMultipartBuilder::Compression::kZstd &&
+       options.upload_compression_level > ZstdHTTPBodyStream::kMaximumLevel)) {
+    ToolSupport::UsageHint(
+        me, "--upload-compression-level is too high for --upload-compression");
+    return ExitFailure();
+  }
+  if (options.upload_compression == HTTPMultipartBuilder::Compression::kZstd &&
+      !ZstdHTTPBodyStream::IsSupported()) {
+    LOG(WARNING) << "--upload-compression=zstd is not supported by this build, "
+                    "using gzip";
+  }
+  if (!options.upload_compression_dictionary.empty() &&
+      options.upload_compression != HTTPMultipartBuilder::Compression::kZstd) {
+    ToolSupport::UsageHint(me,
+                           "--upload-compression-dictionary requires "
+                           "--upload-compression=zstd");
+    return ExitFailure();
+  }
+
   if (argc) {
     ToolSupport::UsageHint(me, nullptr);
     return ExitFailure();
@@ -985,8 +2291,27 @@ int HandlerMain(int argc,
   }
 #endif  // BUILDFLAG(IS_APPLE)
 
-  if (options.monitor_self) {
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+  // A parked handler puts off opening the database and starting its threads
+  // until its client needs it, and exits if the client goes away first.
+  if (options.park_until_request &&
+      !WaitForClientRequest(options.initial_client_fd)) {
+    return EXIT_SUCCESS;
+  }
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+
+  // Tracing is diagnostic, so the handler runs without it if the file can’t be
+  // opened.
+  if (!options.trace_file.empty()) {
+    TraceEvents::StartWritingToFile(options.trace_file);
+  }
+
+  StartupTrace startup_trace(options.trace_startup);
+
+  if (options.monitor_self && !options.lazy_startup) {
     MonitorSelf(options);
+    startup_trace.EndPhase("monitor-self");
   }
 
   if (!options.monitor_self_annotations.empty()) {
@@ -1009,12 +2334,47 @@ int HandlerMain(int argc,
     }
   }
 
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+  std::unique_ptr<CrashReportDatabase> database;
+  if (options.database_sharded_reports) {
+    database = CrashReportDatabase::InitializeWithShardedReports(
+        options.database, options.database_compact_metadata);
+  } else if (options.database_compact_metadata) {
+    database =
+        CrashReportDatabase::InitializeWithCompactMetadata(options.database);
+  } else {
+    database = CrashReportDatabase::Initialize(options.database);
+  }
+#else
   std::unique_ptr<CrashReportDatabase> database(
       CrashReportDatabase::Initialize(options.database));
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
   if (!database) {
     return ExitFailure();
   }
 
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+  if (options.database_group_commit >= 0) {
+    database->EnableGroupCommit(options.database_group_commit / 1000.0);
+  }
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+#if defined(ATTACHMENTS_SUPPORTED)
+  if (options.deduplicate_attachments) {
+    database->EnableAttachmentDeduplication();
+  }
+#endif  // ATTACHMENTS_SUPPORTED
+  startup_trace.EndPhase("database");
+
+  // The scheduler is declared before the threads that use it, so that it’s
+  // stopped after them.
+  ScopedStoppable work_scheduler;
+  if (options.periodic_task_threads) {
+    work_scheduler.Reset(new WorkScheduler(options.periodic_task_threads));
+    work_scheduler.Get()->Start();
+  }
+
   ScopedStoppable upload_thread;
   if (!options.url.empty()) {
     // TODO(scottmg): options.rate_limit should be removed when we have a
@@ -1024,8 +2384,51 @@ int HandlerMain(int argc,
     upload_thread_options.identify_client_via_url =
         options.identify_client_via_url;
     upload_thread_options.rate_limit = options.rate_limit;
-    upload_thread_options.upload_gzip = options.upload_gzip;
+    upload_thread_options.upload_compression = options.upload_compression;
+    upload_thread_options.upload_compression_level =
+        options.upload_compression_level;
+    upload_thread_options.upload_compression_threads =
+        options.upload_compression_threads;
+    if (!options.upload_compression_dictionary.empty() &&
+        ZstdHTTPBodyStream::IsSupported()) {
+      auto dictionary = std::make_shared<ZstdDictionary>();
+      if (!dictionary->Initialize(options.upload_compression_dictionary)) {
+        return ExitFailure();
+      }
+      upload_thread_options.upload_compression_dictionary =
+          std::move(dictionary);
+    }
     upload_thread_options.watch_pending_reports = options.periodic_tasks;
+    upload_thread_options.notify_pending_reports = true;
+    upload_thread_options.upload_concurrency = options.upload_concurrency;
+    upload_thread_options.upload_keep_alive_timeout =
+        options.upload_keep_alive;
+    upload_thread_options.upload_http2 = options.upload_http2;
+    upload_thread_options.upload_pipeline = options.upload_pipeline;
+    upload_thread_options.upload_precheck = options.upload_precheck;
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+    upload_thread_options.upload_relay = options.upload_relay;
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+    upload_thread_options.precompress_reports = options.precompress_reports;
+    upload_thread_options.resumable_uploads = options.resumable_uploads;
+    upload_thread_options.tiered_uploads = options.tiered_uploads;
+    upload_thread_options.delta_uploads = options.delta_uploads;
+    upload_thread_options.batch_upload_size = options.batch_uploads;
+    upload_thread_options.work_scheduler =
+        static_cast<WorkScheduler*>(work_scheduler.Get());
+    if (options.lazy_startup) {
+      // Put off the first scan of the database, and the uploads it finds,
+      // until the client has had some time to finish its own startup. Reports
+      // made pending by the handler’s clients are still uploaded at once.
+      upload_thread_options.initial_work_delay = 60;
+    }
+    if (options.upload_budget) {
+      BudgetUploadPolicy::Options policy_options;
+      policy_options.bytes_per_hour = options.upload_budget;
+      upload_thread_options.upload_policy =
+          std::make_shared<BudgetUploadPolicy>(policy_options, nullptr);
+    }
 
     upload_thread.Reset(new CrashReportUploadThread(
         database.get(),
@@ -1033,9 +2436,30 @@ int HandlerMain(int argc,
         upload_thread_options,
         CrashReportUploadThread::ProcessPendingReportsObservationCallback()));
     upload_thread.Get()->Start();
+    startup_trace.EndPhase("upload-thread");
   }
 
 #if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+  // The sampler is declared before the exception handler so that it’s stopped
+  // after the exception handler is destroyed.
+  ScopedStoppable stack_sampler;
+  if (options.stack_sample_interval) {
+    stack_sampler.Reset(
+        new StackSampler(options.stack_sample_interval / 1000.0,
+                         options.stack_sample_history,
+                         StackSampler::kDefaultStackSize));
+    stack_sampler.Get()->Start();
+  }
+
+  std::unique_ptr<CrashSignatureThrottle> crash_signature_throttle;
+  if (options.duplicate_crash_limit) {
+    CrashSignatureThrottle::Options throttle_options;
+    throttle_options.reports_per_window = options.duplicate_crash_limit;
+    throttle_options.sample_interval = options.duplicate_crash_sample;
+    crash_signature_throttle = std::make_unique<CrashSignatureThrottle>(
+        options.database, throttle_options);
+  }
+
   std::unique_ptr<ExceptionHandlerServer::Delegate> exception_handler;
 #else
   std::unique_ptr<CrashReportExceptionHandler> exception_handler;
@@ -1052,13 +2476,25 @@ int HandlerMain(int argc,
       cros_handler->SetDumpDir(options.minidump_dir_for_tests);
     }
 
+    if (!options.cros_crash_reporter_socket.empty()) {
+      cros_handler->SetCrashReporterSocket(options.cros_crash_reporter_socket);
+    }
+
     if (options.always_allow_feedback) {
       cros_handler->SetAlwaysAllowFeedback();
     }
+    cros_handler->SetCaptureWholeAllocations(
+        options.capture_whole_allocations);
+    cros_handler->SetModuleSnapshotThreads(options.module_snapshot_threads);
+    cros_handler->SetThreadSnapshotThreads(options.thread_snapshot_threads);
+    cros_handler->SetUnwindStacks(options.unwind_stacks);
+    cros_handler->SetUserStreamDataSourceThreads(options.user_stream_threads);
+    cros_handler->SetUserStreamDataSourceTimeBudget(
+        options.user_stream_time_budget / 1000.0);
 
     exception_handler = std::move(cros_handler);
   } else {
-    exception_handler = std::make_unique<CrashReportExceptionHandler>(
+    auto crash_report_handler = std::make_unique<CrashReportExceptionHandler>(
         database.get(),
         static_cast<CrashReportUploadThread*>(upload_thread.Get()),
         &options.annotations,
@@ -1066,6 +2502,39 @@ int HandlerMain(int argc,
         true,
         false,
         user_stream_sources);
+    crash_report_handler->SetCaptureWholeAllocations(
+        options.capture_whole_allocations);
+    crash_report_handler->SetChecksumMinidumps(options.checksum_minidumps);
+    crash_report_handler->SetCollapseIdenticalThreads(
+        options.collapse_identical_threads);
+    crash_report_handler->SetCompressMinidumps(options.compress_minidumps);
+    crash_report_handler->SetCopyAttachmentsAfterRelease(
+        options.copy_attachments_after_release);
+    crash_report_handler->SetCrashSignatureThrottle(
+        crash_signature_throttle.get());
+    crash_report_handler->SetDumpPriority(options.dump_priority);
+    crash_report_handler->SetFullMemoryDumps(
+        options.full_memory_dumps, options.full_memory_max_mapping_size);
+    crash_report_handler->SetMemoryInfo(options.memory_info,
+                                        options.merge_memory_info);
+    crash_report_handler->SetModuleSnapshotThreads(
+        options.module_snapshot_threads);
+    crash_report_handler->SetPrepareReportsAhead(options.prepare_reports_ahead);
+    crash_report_handler->SetReleaseClientsBeforeWriting(
+        options.release_clients_before_writing);
+    crash_report_handler->SetStackSampler(
+        static_cast<StackSampler*>(stack_sampler.Get()));
+    crash_report_handler->SetThreadSnapshotThreads(
+        options.thread_snapshot_threads);
+    crash_report_handler->SetUnwindStacks(options.unwind_stacks);
+    crash_report_handler->SetUploadFromMemoryLimit(
+        InRangeCast<size_t>(options.upload_from_memory,
+                            std::numeric_limits<size_t>::max()));
+    crash_report_handler->SetUserStreamDataSourceThreads(
+        options.user_stream_threads);
+    crash_report_handler->SetUserStreamDataSourceTimeBudget(
+        options.user_stream_time_budget / 1000.0);
+    exception_handler = std::move(crash_report_handler);
   }
 #else
   exception_handler = std::make_unique<CrashReportExceptionHandler>(
@@ -1084,7 +2553,62 @@ int HandlerMain(int argc,
       false,
 #endif  // BUILDFLAG(IS_LINUX)
       user_stream_sources);
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+  static_cast<CrashReportExceptionHandler*>(exception_handler.get())
+      ->SetCaptureWholeAllocations(options.capture_whole_allocations);
+  static_cast<CrashReportExceptionHandler*>(exception_handler.get())
+      ->SetChecksumMinidumps(options.checksum_minidumps);
+  static_cast<CrashReportExceptionHandler*>(exception_handler.get())
+      ->SetCollapseIdenticalThreads(options.collapse_identical_threads);
+  static_cast<CrashReportExceptionHandler*>(exception_handler.get())
+      ->SetCompressMinidumps(options.compress_minidumps);
+  static_cast<CrashReportExceptionHandler*>(exception_handler.get())
+      ->SetCopyAttachmentsAfterRelease(options.copy_attachments_after_release);
+  static_cast<CrashReportExceptionHandler*>(exception_handler.get())
+      ->SetCrashSignatureThrottle(crash_signature_throttle.get());
+  static_cast<CrashReportExceptionHandler*>(exception_handler.get())
+      ->SetDumpPriority(options.dump_priority);
+  static_cast<CrashReportExceptionHandler*>(exception_handler.get())
+      ->SetFullMemoryDumps(options.full_memory_dumps,
+                           options.full_memory_max_mapping_size);
+  static_cast<CrashReportExceptionHandler*>(exception_handler.get())
+      ->SetMemoryInfo(options.memory_info, options.merge_memory_info);
+  static_cast<CrashReportExceptionHandler*>(exception_handler.get())
+      ->SetModuleSnapshotThreads(options.module_snapshot_threads);
+  static_cast<CrashReportExceptionHandler*>(exception_handler.get())
+      ->SetPrepareReportsAhead(options.prepare_reports_ahead);
+  static_cast<CrashReportExceptionHandler*>(exception_handler.get())
+      ->SetReleaseClientsBeforeWriting(options.release_clients_before_writing);
+  static_cast<CrashReportExceptionHandler*>(exception_handler.get())
+      ->SetStackSampler(static_cast<StackSampler*>(stack_sampler.Get()));
+  static_cast<CrashReportExceptionHandler*>(exception_handler.get())
+      ->SetThreadSnapshotThreads(options.thread_snapshot_threads);
+  static_cast<CrashReportExceptionHandler*>(exception_handler.get())
+      ->SetUnwindStacks(options.unwind_stacks);
+  static_cast<CrashReportExceptionHandler*>(exception_handler.get())
+      ->SetUploadFromMemoryLimit(InRangeCast<size_t>(
+          options.upload_from_memory, std::numeric_limits<size_t>::max()));
+  static_cast<CrashReportExceptionHandler*>(exception_handler.get())
+      ->SetUserStreamDataSourceThreads(options.user_stream_threads);
+  static_cast<CrashReportExceptionHandler*>(exception_handler.get())
+      ->SetUserStreamDataSourceTimeBudget(options.user_stream_time_budget /
+                                          1000.0);
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+#if BUILDFLAG(IS_ANDROID)
+  static_cast<CrashReportExceptionHandler*>(exception_handler.get())
+      ->SetWriteMinidumpToLogInChunks(options.write_minidump_to_log_in_chunks);
+#endif  // BUILDFLAG(IS_ANDROID)
+#if BUILDFLAG(IS_WIN)
+  static_cast<CrashReportExceptionHandler*>(exception_handler.get())
+      ->SetCloneNonFatalDumps(options.clone_non_fatal_dumps);
+#endif  // BUILDFLAG(IS_WIN)
+#if BUILDFLAG(IS_APPLE)
+  exception_handler->SetCloneNonFatalDumps(options.clone_non_fatal_dumps);
+  exception_handler->SetThreadSnapshotThreads(options.thread_snapshot_threads);
+#endif  // BUILDFLAG(IS_APPLE)
 #endif  // BUILDFLAG(IS_CHROMEOS_ASH) || BUILDFLAG(IS_CHROMEOS_LACROS)
+  startup_trace.EndPhase("exception-handler");
 
 #if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
   if (options.exception_information_address) {
@@ -1101,9 +2625,13 @@ int HandlerMain(int argc,
 
   ScopedStoppable prune_thread;
   if (options.periodic_tasks) {
-    prune_thread.Reset(new PruneCrashReportThread(
-        database.get(), PruneCondition::GetDefault()));
+    auto prune_crash_report_thread = std::make_unique<PruneCrashReportThread>(
+        database.get(), PruneCondition::GetDefault());
+    prune_crash_report_thread->SetWorkScheduler(
+        static_cast<WorkScheduler*>(work_scheduler.Get()));
+    prune_thread.Reset(prune_crash_report_thread.release());
     prune_thread.Get()->Start();
+    startup_trace.EndPhase("prune-thread");
   }
 
 #if BUILDFLAG(IS_APPLE)
@@ -1129,6 +2657,7 @@ int HandlerMain(int argc,
 
   ExceptionHandlerServer exception_handler_server(
       std::move(receive_right), !options.mach_service.empty());
+  exception_handler_server.SetMaxConcurrentDumps(options.max_concurrent_dumps);
   base::AutoReset<ExceptionHandlerServer*> reset_g_exception_handler_server(
       &g_exception_handler_server, &exception_handler_server);
 
@@ -1159,9 +2688,16 @@ int HandlerMain(int argc,
   if (!options.pipe_name.empty()) {
     exception_handler_server.SetPipeName(base::UTF8ToWide(options.pipe_name));
   }
+  exception_handler_server.SetPipeInstances(options.pipe_instances);
+  exception_handler_server.SetMaxConcurrentDumps(options.max_concurrent_dumps);
 #elif BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
   ExceptionHandlerServer exception_handler_server;
+  exception_handler_server.SetMaxConcurrentDumps(options.max_concurrent_dumps);
+  exception_handler_server.SetHangDetection(
+      options.hang_poll_interval / 1000.0, options.min_hang_dump_interval);
+  exception_handler_server.SetSimulatedDumpLimit(options.simulated_dump_limit);
 #endif  // BUILDFLAG(IS_APPLE)
+  startup_trace.EndPhase("server");
 
   base::GlobalHistogramAllocator* histogram_allocator = nullptr;
   if (!options.metrics_dir.empty()) {
@@ -1175,6 +2711,21 @@ int HandlerMain(int argc,
   }
 
   Metrics::HandlerLifetimeMilestone(Metrics::LifetimeMilestone::kStarted);
+  startup_trace.EndPhase("metrics");
+
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+  ScopedStoppable resource_usage_reporter;
+  if (options.resource_usage_interval) {
+    auto reporter = std::make_unique<ResourceUsageReporter>(
+        options.resource_usage_interval,
+        database.get(),
+        &exception_handler_server);
+    reporter->SetSocketName(options.resource_usage_socket);
+    resource_usage_reporter.Reset(reporter.release());
+    resource_usage_reporter.Get()->Start();
+  }
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
 
 #if BUILDFLAG(IS_WIN)
   if (options.initial_client_data.IsValid()) {
@@ -1182,16 +2733,38 @@ int HandlerMain(int argc,
         options.initial_client_data, exception_handler.get());
   }
 #elif BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
-  if (options.initial_client_fd == kInvalidFileHandle ||
-      !exception_handler_server.InitializeWithClient(
-          ScopedFileHandle(options.initial_client_fd),
-          options.shared_client_connection)) {
+  if (!options.daemon_socket_name.empty()) {
+    // Creating the socket fails if another handler is already listening on
+    // the name, in which case this one exits and clients keep using that one.
+    ScopedFileHandle listen_sock;
+    if (!UnixCredentialSocket::CreateCredentialListeningSocket(
+            options.daemon_socket_name, &listen_sock) ||
+        !exception_handler_server.InitializeWithListeningSocket(
+            std::move(listen_sock))) {
+      return ExitFailure();
+    }
+  } else if (options.initial_client_fd == kInvalidFileHandle ||
+             !exception_handler_server.InitializeWithClient(
+                 ScopedFileHandle(options.initial_client_fd),
+                 options.shared_client_connection)) {
     return ExitFailure();
   }
 #endif  // BUILDFLAG(IS_WIN)
+  startup_trace.EndPhase("client");
+  startup_trace.Ready();
+
+  std::unique_ptr<MonitorSelfThread> monitor_self_thread;
+  if (options.monitor_self && options.lazy_startup) {
+    monitor_self_thread = std::make_unique<MonitorSelfThread>(options);
+    monitor_self_thread->Start();
+  }
 
   exception_handler_server.Run(exception_handler.get());
 
+  if (monitor_self_thread) {
+    monitor_self_thread->Join();
+  }
+
   return EXIT_SUCCESS;
 }
 
@@ -29,14 +29,32 @@ bool CaptureSnapshot(
     const std::map<std::string, std::string>& process_annotations,
     uid_t client_uid,
     VMAddress requesting_thread_stack_address,
+    unsigned int module_snapshot_threads,
+    unsigned int thread_snapshot_threads,
+    ModuleReaderCache* module_reader_cache,
+    ElfImageInfoCache* image_info_cache,
+    SystemInfoCache* system_info_cache,
+    bool unwind_stacks,
+    bool capture_whole_allocations,
     pid_t* requesting_thread_id,
     std::unique_ptr<ProcessSnapshotLinux>* snapshot,
     std::unique_ptr<ProcessSnapshotSanitized>* sanitized_snapshot) {
   std::unique_ptr<ProcessSnapshotLinux> process_snapshot(
       new ProcessSnapshotLinux());
-  if (!process_snapshot->Initialize(connection)) {
-    Metrics::ExceptionCaptureResult(Metrics::CaptureResult::kSnapshotFailed);
-    return false;
+  {
+    Metrics::ScopedOperationTimer snapshot_timer(
+        Metrics::TimedOperation::kSnapshot);
+    if (!process_snapshot->Initialize(connection,
+                                      module_snapshot_threads,
+                                      thread_snapshot_threads,
+                                      module_reader_cache,
+                                      image_info_cache,
+                                      system_info_cache,
+                                      unwind_stacks,
+                                      capture_whole_allocations)) {
+      Metrics::ExceptionCaptureResult(Metrics::CaptureResult::kSnapshotFailed);
+      return false;
+    }
   }
 
   pid_t local_requesting_thread_id = -1;
@@ -49,14 +67,16 @@ bool CaptureSnapshot(
     *requesting_thread_id = local_requesting_thread_id;
   }
 
-  if (!process_snapshot->InitializeException(info.exception_information_address,
-                                             local_requesting_thread_id)) {
-    Metrics::ExceptionCaptureResult(
-        Metrics::CaptureResult::kExceptionInitializationFailed);
-    return false;
-  }
+  if (info.exception_information_address) {
+    if (!process_snapshot->InitializeException(
+            info.exception_information_address, local_requesting_thread_id)) {
+      Metrics::ExceptionCaptureResult(
+          Metrics::CaptureResult::kExceptionInitializationFailed);
+      return false;
+    }
 
-  Metrics::ExceptionCode(process_snapshot->Exception()->Exception());
+    Metrics::ExceptionCode(process_snapshot->Exception()->Exception());
+  }
 
   CrashpadInfoClientOptions client_options;
   process_snapshot->GetCrashpadOptions(&client_options);
@@ -69,6 +89,9 @@ bool CaptureSnapshot(
   }
 
   if (info.sanitization_information_address) {
+    Metrics::ScopedOperationTimer sanitize_timer(
+        Metrics::TimedOperation::kSanitize);
+
     SanitizationInformation sanitization_info;
     ProcessMemoryRange range;
     if (!range.Initialize(connection->Memory(), connection->Is64Bit()) ||
@@ -32,7 +32,9 @@ namespace crashpad {
 //! \brief Captures a snapshot of a client over \a connection.
 //!
 //! \param[in] connection A PtraceConnection to the client to snapshot.
-//! \param[in] info Information about the client configuring the snapshot.
+//! \param[in] info Information about the client configuring the snapshot. If
+//!     it has no exception information address, the snapshot has no
+//!     exception, as for a snapshot of a hung client.
 //! \param[in] process_annotations A map of annotations to insert as
 //!     process-level annotations into the snapshot.
 //! \param[in] client_uid The client's user ID.
@@ -41,6 +43,22 @@ namespace crashpad {
 //!     address, the exception will be assigned to the thread whose stack
 //!     address range contains this address. If 0, \a requesting_thread_id will
 //!     be -1.
+//! \param[in] module_snapshot_threads The number of threads used to initialize
+//!     module snapshots. See ProcessSnapshotLinux::Initialize().
+//! \param[in] thread_snapshot_threads The number of threads used to gather
+//!     information about the client’s threads. See
+//!     ProcessSnapshotLinux::Initialize().
+//! \param[in] module_reader_cache A cache of what earlier snapshots of the
+//!     client read of its modules. Optional.
+//! \param[in] image_info_cache A cache of what is known about ELF images by
+//!     build ID, shared by all clients. Optional.
+//! \param[in] system_info_cache A cache of what is known about the system,
+//!     shared by all clients. Optional.
+//! \param[in] unwind_stacks Whether to unwind the stacks of the client’s
+//!     threads. See ProcessSnapshotLinux::Initialize().
+//! \param[in] capture_whole_allocations Whether indirectly referenced memory
+//!     is captured as whole heap allocations. See
+//!     ProcessSnapshotLinux::Initialize().
 //! \param[out] requesting_thread_id The thread ID of the thread corresponding
 //!     to \a requesting_thread_stack_address. Set to -1 if the thread ID could
 //!     not be determined. Optional.
@@ -58,6 +76,13 @@ bool CaptureSnapshot(
     const std::map<std::string, std::string>& process_annotations,
     uid_t client_uid,
     VMAddress requesting_thread_stack_address,
+    unsigned int module_snapshot_threads,
+    unsigned int thread_snapshot_threads,
+    ModuleReaderCache* module_reader_cache,
+    ElfImageInfoCache* image_info_cache,
+    SystemInfoCache* system_info_cache,
+    bool unwind_stacks,
+    bool capture_whole_allocations,
     pid_t* requesting_thread_id,
     std::unique_ptr<ProcessSnapshotLinux>* process_snapshot,
     std::unique_ptr<ProcessSnapshotSanitized>* sanitized_snapshot);
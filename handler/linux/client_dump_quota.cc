@@ -0,0 +1,70 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "handler/linux/client_dump_quota.h"
+
+#include <algorithm>
+#include <iterator>
+
+#include "base/check_op.h"
+
+namespace crashpad {
+
+namespace {
+
+constexpr uint64_t kNanosecondsPerMinute = 60ull * 1000000000;
+
+// The number of buckets above which full buckets are forgotten. A full bucket
+// is the same as no bucket, so this only bounds the memory used for clients
+// that have exited.
+constexpr size_t kMaxBuckets = 256;
+
+}  // namespace
+
+ClientDumpQuota::ClientDumpQuota(unsigned int dumps_per_minute)
+    : buckets_(), capacity_(dumps_per_minute) {
+  DCHECK_GT(dumps_per_minute, 0u);
+}
+
+ClientDumpQuota::~ClientDumpQuota() = default;
+
+bool ClientDumpQuota::TakeDump(pid_t client, uint64_t now_ns) {
+  if (buckets_.size() >= kMaxBuckets) {
+    for (auto it = buckets_.begin(); it != buckets_.end();) {
+      it = Refill(&it->second, now_ns) ? buckets_.erase(it) : std::next(it);
+    }
+  }
+
+  auto inserted = buckets_.insert({client, Bucket{capacity_, now_ns}});
+  Bucket& bucket = inserted.first->second;
+  Refill(&bucket, now_ns);
+  if (bucket.dumps < 1) {
+    return false;
+  }
+  bucket.dumps -= 1;
+  return true;
+}
+
+bool ClientDumpQuota::Refill(Bucket* bucket, uint64_t now_ns) const {
+  if (now_ns > bucket->refilled_ns) {
+    bucket->dumps =
+        std::min(capacity_,
+                 bucket->dumps + capacity_ * (now_ns - bucket->refilled_ns) /
+                                     kNanosecondsPerMinute);
+    bucket->refilled_ns = now_ns;
+  }
+  return bucket->dumps >= capacity_;
+}
+
+}  // namespace crashpad
@@ -0,0 +1,69 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_HANDLER_LINUX_CLIENT_DUMP_QUOTA_H_
+#define CRASHPAD_HANDLER_LINUX_CLIENT_DUMP_QUOTA_H_
+
+#include <stdint.h>
+#include <sys/types.h>
+
+#include <map>
+
+namespace crashpad {
+
+//! \brief Limits how often each client may have dumps taken, with a token
+//!     bucket for each client.
+//!
+//! Each client’s bucket holds up to a number of dumps, starts out full, and is
+//! refilled continuously at that number of dumps per minute. A dump is allowed
+//! while the client’s bucket holds at least one.
+//!
+//! This class is not thread-safe.
+class ClientDumpQuota {
+ public:
+  //! \param[in] dumps_per_minute The number of dumps each client may have
+  //!     taken per minute, and at once after not having any taken. Must be
+  //!     greater than `0`.
+  explicit ClientDumpQuota(unsigned int dumps_per_minute);
+
+  ClientDumpQuota(const ClientDumpQuota&) = delete;
+  ClientDumpQuota& operator=(const ClientDumpQuota&) = delete;
+
+  ~ClientDumpQuota();
+
+  //! \brief Takes a dump from a client’s bucket.
+  //!
+  //! \param[in] client The client’s process ID.
+  //! \param[in] now_ns The current time, from ClockMonotonicNanoseconds().
+  //!
+  //! \return `true` if the dump is allowed. `false` if the client has used
+  //!     its quota, in which case nothing is taken.
+  bool TakeDump(pid_t client, uint64_t now_ns);
+
+ private:
+  struct Bucket {
+    double dumps;
+    uint64_t refilled_ns;
+  };
+
+  // Refills bucket up to now_ns, returning whether it’s full.
+  bool Refill(Bucket* bucket, uint64_t now_ns) const;
+
+  std::map<pid_t, Bucket> buckets_;
+  const double capacity_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_HANDLER_LINUX_CLIENT_DUMP_QUOTA_H_
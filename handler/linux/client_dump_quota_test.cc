@@ -0,0 +1,65 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "handler/linux/client_dump_quota.h"
+
+#include "gtest/gtest.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+constexpr uint64_t kMinuteNs = 60000000000;
+
+TEST(ClientDumpQuota, Burst) {
+  ClientDumpQuota quota(3);
+  uint64_t now_ns = kMinuteNs;
+  EXPECT_TRUE(quota.TakeDump(1, now_ns));
+  EXPECT_TRUE(quota.TakeDump(1, now_ns));
+  EXPECT_TRUE(quota.TakeDump(1, now_ns));
+  EXPECT_FALSE(quota.TakeDump(1, now_ns));
+  EXPECT_FALSE(quota.TakeDump(1, now_ns + 1));
+}
+
+TEST(ClientDumpQuota, Refill) {
+  ClientDumpQuota quota(2);
+  uint64_t now_ns = kMinuteNs;
+  EXPECT_TRUE(quota.TakeDump(1, now_ns));
+  EXPECT_TRUE(quota.TakeDump(1, now_ns));
+  EXPECT_FALSE(quota.TakeDump(1, now_ns));
+
+  // One dump is refilled every 30 seconds.
+  now_ns += kMinuteNs / 2;
+  EXPECT_TRUE(quota.TakeDump(1, now_ns));
+  EXPECT_FALSE(quota.TakeDump(1, now_ns));
+
+  // The bucket doesn’t hold more than its capacity after a long wait.
+  now_ns += 10 * kMinuteNs;
+  EXPECT_TRUE(quota.TakeDump(1, now_ns));
+  EXPECT_TRUE(quota.TakeDump(1, now_ns));
+  EXPECT_FALSE(quota.TakeDump(1, now_ns));
+}
+
+TEST(ClientDumpQuota, IndependentClients) {
+  ClientDumpQuota quota(1);
+  uint64_t now_ns = kMinuteNs;
+  EXPECT_TRUE(quota.TakeDump(1, now_ns));
+  EXPECT_FALSE(quota.TakeDump(1, now_ns));
+  EXPECT_TRUE(quota.TakeDump(2, now_ns));
+  EXPECT_FALSE(quota.TakeDump(2, now_ns));
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
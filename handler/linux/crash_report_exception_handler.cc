@@ -14,28 +14,44 @@
 
 #include "handler/linux/crash_report_exception_handler.h"
 
+#include <time.h>
+
+#include <deque>
 #include <memory>
 #include <utility>
 
+#include "base/check.h"
 #include "base/logging.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/synchronization/lock.h"
 #include "build/build_config.h"
 #include "client/settings.h"
+#include "handler/crash_signature.h"
 #include "handler/linux/capture_snapshot.h"
+#include "handler/linux/stack_sampler.h"
 #include "minidump/minidump_file_writer.h"
+#include "minidump/minidump_memory_info_writer.h"
+#include "minidump/minidump_user_extension_stream_data_source.h"
 #include "snapshot/linux/process_snapshot_linux.h"
 #include "snapshot/sanitized/process_snapshot_sanitized.h"
 #include "util/backtrace/crash_loop_detection.h"
-#include "util/file/file_helper.h"
+#include "util/file/async_file_writer.h"
+#include "util/file/chunked_string_file.h"
+#include "util/file/file_io.h"
 #include "util/file/file_reader.h"
 #include "util/file/output_stream_file_writer.h"
+#include "util/file/string_file.h"
 #include "util/linux/direct_ptrace_connection.h"
 #include "util/linux/ptrace_client.h"
 #include "util/misc/implicit_cast.h"
 #include "util/misc/metrics.h"
+#include "util/misc/trace_events.h"
 #include "util/misc/uuid.h"
 #include "util/stream/base94_output_stream.h"
 #include "util/stream/log_output_stream.h"
 #include "util/stream/zlib_output_stream.h"
+#include "util/synchronization/semaphore.h"
+#include "util/thread/thread.h"
 
 #if BUILDFLAG(IS_ANDROID)
 #include <android/log.h>
@@ -44,9 +60,33 @@
 namespace crashpad {
 namespace {
 
+// The number of clients whose modules are kept between dumps. Clients that are
+// dumped repeatedly, such as with DumpWithoutCrash(), skip parsing modules
+// they’ve already been dumped with.
+constexpr size_t kModuleReaderCacheProcesses = 16;
+
+// The memory used to remember ELF images by build ID across all clients, which
+// is enough for thousands of images.
+constexpr size_t kImageInfoCacheBytes = 256 * 1024;
+
+// The number of seconds for which what’s known about the system is kept between
+// dumps. Little of it changes while the handler runs, but CPUs may come online
+// or go offline.
+constexpr double kSystemInfoCacheMaxAge = 60;
+
+// The number of seconds after which an unused spare report is replaced. This is
+// much less than the age at which PruneCrashReportThread has
+// CrashReportDatabase::CleanDatabase() remove new reports.
+constexpr time_t kSpareReportLifetime = 60 * 60;
+
+// The number of stack values in each crash’s signature. A few values near the
+// top of the stack are enough to tell crashes in the same function apart by
+// their callers.
+constexpr size_t kCrashSignatureFrames = 4;
+
 class Logger final : public LogOutputStream::Delegate {
  public:
-  Logger() = default;
+  explicit Logger(LogOutputStream::Mode mode) : mode_(mode) {}
 
   Logger(const Logger&) = delete;
   Logger& operator=(const Logger&) = delete;
@@ -61,15 +101,19 @@ class Logger final : public LogOutputStream::Delegate {
 
   size_t OutputCap() override {
     // Most minidumps are expected to be compressed and encoded into less than
-    // 128k.
-    return 128 * 1024;
+    // 128k. Chunks can be reassembled even if some are lost, so they’re used
+    // for minidumps of several megabytes.
+    return mode_ == LogOutputStream::Mode::kChunks ? 16 * 1024 * 1024
+                                                   : 128 * 1024;
   }
 
   size_t LineWidth() override {
     // From Android NDK r20 <android/log.h>, log message text may be truncated
     // to less than an implementation-specific limit (1023 bytes), for sake of
-    // safe and being easy to read in logcat, choose 512.
-    return 512;
+    // safe and being easy to read in logcat, choose 512. Chunks aren’t meant
+    // to be read in logcat and fill most of a log entry, whose payload is
+    // limited to 4068 bytes including the tag and priority.
+    return mode_ == LogOutputStream::Mode::kChunks ? 4000 : 512;
   }
 #else
   // TODO(jperaza): Log to an appropriate location on Linux.
@@ -77,14 +121,25 @@ class Logger final : public LogOutputStream::Delegate {
   size_t OutputCap() override { return 0; }
   size_t LineWidth() override { return 0; }
 #endif
+
+ private:
+  [[maybe_unused]] LogOutputStream::Mode mode_;
 };
 
-bool WriteMinidumpLogFromFile(FileReaderInterface* file_reader) {
-  ZlibOutputStream stream(
-      ZlibOutputStream::Mode::kCompress,
+// The log carries a zlib-compressed, base94-encoded minidump. A minidump that
+// was already written compressed is only encoded.
+bool WriteMinidumpLogFromFile(FileReaderInterface* file_reader,
+                              bool compressed,
+                              LogOutputStream::Mode log_mode) {
+  std::unique_ptr<OutputStreamInterface> stream =
       std::make_unique<Base94OutputStream>(
           Base94OutputStream::Mode::kEncode,
-          std::make_unique<LogOutputStream>(std::make_unique<Logger>())));
+          std::make_unique<LogOutputStream>(std::make_unique<Logger>(log_mode),
+                                            log_mode));
+  if (!compressed) {
+    stream = std::make_unique<ZlibOutputStream>(
+        ZlibOutputStream::Mode::kCompress, std::move(stream));
+  }
   FileOperationResult read_result;
   do {
     uint8_t buffer[4096];
@@ -92,14 +147,267 @@ bool WriteMinidumpLogFromFile(FileReaderInterface* file_reader) {
     if (read_result < 0)
       return false;
 
-    if (read_result > 0 && (!stream.Write(buffer, read_result)))
+    if (read_result > 0 && (!stream->Write(buffer, read_result)))
       return false;
   } while (read_result > 0);
-  return stream.Flush();
+  return stream->Flush();
 }
 
+// Writes into memory until a size limit would be passed, and then moves what was
+// written to a file and writes everything else there.
+class SpillingFileWriter final : public FileWriterInterface {
+ public:
+  SpillingFileWriter(size_t memory_limit, FileWriterInterface* file_writer)
+      : memory_(std::make_unique<ChunkedStringFile>()),
+        file_writer_(file_writer),
+        memory_limit_(memory_limit) {}
+
+  SpillingFileWriter(const SpillingFileWriter&) = delete;
+  SpillingFileWriter& operator=(const SpillingFileWriter&) = delete;
+
+  ~SpillingFileWriter() override {}
+
+  //! \brief Returns what was written, or `nullptr` if it was written to the
+  //!     file.
+  std::unique_ptr<ChunkedStringFile> TakeMemory() { return std::move(memory_); }
+
+  // FileWriterInterface:
+  bool Write(const void* data, size_t size) override {
+    if (!MakeRoom(size)) {
+      return false;
+    }
+    return memory_ ? memory_->Write(data, size)
+                   : file_writer_->Write(data, size);
+  }
+
+  bool WriteIoVec(std::vector<WritableIoVec>* iovecs) override {
+    size_t size = 0;
+    for (const WritableIoVec& iov : *iovecs) {
+      size += iov.iov_len;
+    }
+    if (!MakeRoom(size)) {
+      return false;
+    }
+    return memory_ ? memory_->WriteIoVec(iovecs)
+                   : file_writer_->WriteIoVec(iovecs);
+  }
+
+  // FileSeekerInterface:
+  FileOffset Seek(FileOffset offset, int whence) override {
+    return memory_ ? memory_->Seek(offset, whence)
+                   : file_writer_->Seek(offset, whence);
+  }
+
+ private:
+  // Spills to the file if writing size bytes into memory would pass the limit.
+  bool MakeRoom(size_t size) {
+    if (!memory_) {
+      return true;
+    }
+    const FileOffset position = memory_->SeekGet();
+    if (position < 0) {
+      return false;
+    }
+    if (static_cast<size_t>(position) <= memory_limit_ &&
+        size <= memory_limit_ - static_cast<size_t>(position)) {
+      return true;
+    }
+
+    std::unique_ptr<ChunkedStringFile> memory = std::move(memory_);
+    return memory->WriteTo(file_writer_) && file_writer_->SeekSet(position);
+  }
+
+  std::unique_ptr<ChunkedStringFile> memory_;
+  FileWriterInterface* file_writer_;  // weak
+  const size_t memory_limit_;
+};
+
 }  // namespace
 
+// Writes minidumps that were captured into memory to the database, copies
+// attachments, and completes reports, in the order in which they were added.
+class CrashReportExceptionHandler::DeferredReportWriter final : public Thread {
+ public:
+  explicit DeferredReportWriter(CrashReportExceptionHandler* handler)
+      : Thread(),
+        reports_(),
+        lock_(),
+        semaphore_(0),
+        handler_(handler),
+        stopping_(false) {}
+
+  DeferredReportWriter(const DeferredReportWriter&) = delete;
+  DeferredReportWriter& operator=(const DeferredReportWriter&) = delete;
+
+  ~DeferredReportWriter() override {}
+
+  //! \brief Adds a report to be completed.
+  //!
+  //! \a minidump is the minidump to write to \a new_report, or `nullptr` if
+  //! it’s already been written there.
+  void AddReport(std::unique_ptr<CrashReportDatabase::NewReport> new_report,
+                 std::unique_ptr<StringFile> minidump,
+                 bool write_minidump_to_log) {
+    {
+      base::AutoLock lock(lock_);
+      DCHECK(!stopping_);
+      reports_.push_back(
+          {std::move(new_report), std::move(minidump), write_minidump_to_log});
+    }
+    semaphore_.Signal();
+  }
+
+  //! \brief Writes all reports that have been added and then stops the
+  //!     thread.
+  void Stop() {
+    {
+      base::AutoLock lock(lock_);
+      stopping_ = true;
+    }
+    semaphore_.Signal();
+    Join();
+  }
+
+ private:
+  struct DeferredReport {
+    std::unique_ptr<CrashReportDatabase::NewReport> new_report;
+    std::unique_ptr<StringFile> minidump;
+    bool write_minidump_to_log;
+  };
+
+  // Thread:
+  void ThreadMain() override {
+    while (true) {
+      semaphore_.Wait();
+
+      DeferredReport report;
+      {
+        base::AutoLock lock(lock_);
+        if (reports_.empty()) {
+          DCHECK(stopping_);
+          return;
+        }
+        report = std::move(reports_.front());
+        reports_.pop_front();
+      }
+
+      TraceEvents::ScopedContext trace_context;
+      TraceEvents::SetReportID(report.new_report->ReportID());
+
+      if (report.minidump) {
+        const std::string& minidump = report.minidump->string();
+        if (!report.new_report->Writer()->Write(minidump.data(),
+                                                minidump.size())) {
+          LOG(ERROR) << "Write failed";
+          Metrics::ExceptionCaptureResult(
+              Metrics::CaptureResult::kMinidumpWriteFailed);
+          continue;
+        }
+        report.minidump.reset();
+      }
+
+      handler_->FinishWritingReport(
+          std::move(report.new_report), report.write_minidump_to_log, nullptr);
+    }
+  }
+
+  std::deque<DeferredReport> reports_;
+  base::Lock lock_;
+  Semaphore semaphore_;
+  CrashReportExceptionHandler* handler_;  // weak
+  bool stopping_;
+};
+
+// Keeps a new report prepared in the database, so that an exception doesn’t
+// have to wait for one to be created.
+class CrashReportExceptionHandler::SpareReportPreparer final : public Thread {
+ public:
+  explicit SpareReportPreparer(CrashReportDatabase* database)
+      : Thread(),
+        spare_report_(),
+        spare_report_time_(0),
+        lock_(),
+        semaphore_(0),
+        database_(database),
+        stopping_(false) {}
+
+  SpareReportPreparer(const SpareReportPreparer&) = delete;
+  SpareReportPreparer& operator=(const SpareReportPreparer&) = delete;
+
+  ~SpareReportPreparer() override {}
+
+  //! \brief Returns the spare report, or `nullptr` if none is ready, and
+  //!     begins preparing its replacement.
+  std::unique_ptr<CrashReportDatabase::NewReport> TakeSpareReport() {
+    std::unique_ptr<CrashReportDatabase::NewReport> spare_report;
+    {
+      base::AutoLock lock(lock_);
+      if (SpareReportIsFresh()) {
+        spare_report = std::move(spare_report_);
+      }
+    }
+    semaphore_.Signal();
+    return spare_report;
+  }
+
+  //! \brief Stops the thread, and removes the spare report.
+  void Stop() {
+    {
+      base::AutoLock lock(lock_);
+      stopping_ = true;
+    }
+    semaphore_.Signal();
+    Join();
+    spare_report_.reset();
+  }
+
+ private:
+  // Thread:
+  void ThreadMain() override {
+    while (true) {
+      bool needs_spare_report;
+      {
+        base::AutoLock lock(lock_);
+        if (stopping_) {
+          return;
+        }
+        needs_spare_report = !SpareReportIsFresh();
+      }
+
+      // The report is prepared without holding lock_, so that exceptions
+      // aren’t kept waiting for it.
+      if (needs_spare_report) {
+        std::unique_ptr<CrashReportDatabase::NewReport> spare_report;
+        if (database_->PrepareNewCrashReport(&spare_report) ==
+            CrashReportDatabase::kNoError) {
+          base::AutoLock lock(lock_);
+          spare_report_ = std::move(spare_report);
+          spare_report_time_ = time(nullptr);
+        } else {
+          LOG(ERROR) << "PrepareNewCrashReport failed";
+        }
+      }
+
+      semaphore_.TimedWait(kSpareReportLifetime);
+    }
+  }
+
+  // Returns true if there’s a spare report that isn’t due to be replaced. lock_
+  // must be held.
+  bool SpareReportIsFresh() {
+    lock_.AssertAcquired();
+    return spare_report_ &&
+           time(nullptr) - spare_report_time_ < kSpareReportLifetime;
+  }
+
+  std::unique_ptr<CrashReportDatabase::NewReport> spare_report_;
+  time_t spare_report_time_;
+  base::Lock lock_;
+  Semaphore semaphore_;
+  CrashReportDatabase* database_;  // weak
+  bool stopping_;
+};
+
 CrashReportExceptionHandler::CrashReportExceptionHandler(
     CrashReportDatabase* database,
     CrashReportUploadThread* upload_thread,
@@ -114,11 +422,86 @@ CrashReportExceptionHandler::CrashReportExceptionHandler(
       attachments_(attachments),
       write_minidump_to_database_(write_minidump_to_database),
       write_minidump_to_log_(write_minidump_to_log),
-      user_stream_data_sources_(user_stream_data_sources) {
+      collapse_identical_threads_(false),
+      checksum_minidumps_(false),
+      compress_minidumps_(false),
+      dump_priority_(),
+      log_mode_(LogOutputStream::Mode::kLines),
+      full_memory_dumps_(false),
+      full_memory_max_mapping_size_(0),
+      memory_info_(false),
+      merge_memory_info_(false),
+      module_snapshot_threads_(1),
+      thread_snapshot_threads_(1),
+      unwind_stacks_(false),
+      capture_whole_allocations_(false),
+      release_clients_before_writing_(false),
+      copy_attachments_after_release_(false),
+      user_stream_threads_(1),
+      user_stream_time_budget_(0),
+      upload_from_memory_limit_(0),
+      user_stream_data_sources_(user_stream_data_sources),
+      module_reader_cache_(kModuleReaderCacheProcesses),
+      image_info_cache_(kImageInfoCacheBytes),
+      system_info_cache_(kSystemInfoCacheMaxAge),
+      stack_sampler_(nullptr),
+      crash_signature_throttle_(nullptr),
+      deferred_report_writer_(),
+      spare_report_preparer_() {
   DCHECK(write_minidump_to_database_ | write_minidump_to_log_);
 }
 
-CrashReportExceptionHandler::~CrashReportExceptionHandler() = default;
+CrashReportExceptionHandler::~CrashReportExceptionHandler() {
+  if (deferred_report_writer_) {
+    deferred_report_writer_->Stop();
+  }
+  if (spare_report_preparer_) {
+    spare_report_preparer_->Stop();
+  }
+}
+
+void CrashReportExceptionHandler::SetReleaseClientsBeforeWriting(
+    bool release_clients_before_writing) {
+  release_clients_before_writing_ = release_clients_before_writing;
+  UpdateDeferredReportWriter();
+}
+
+void CrashReportExceptionHandler::SetCopyAttachmentsAfterRelease(
+    bool copy_attachments_after_release) {
+  copy_attachments_after_release_ = copy_attachments_after_release;
+  UpdateDeferredReportWriter();
+}
+
+void CrashReportExceptionHandler::SetPrepareReportsAhead(
+    bool prepare_reports_ahead) {
+  if (prepare_reports_ahead == !!spare_report_preparer_) {
+    return;
+  }
+
+  if (prepare_reports_ahead) {
+    spare_report_preparer_ = std::make_unique<SpareReportPreparer>(database_);
+    spare_report_preparer_->Start();
+  } else {
+    spare_report_preparer_->Stop();
+    spare_report_preparer_.reset();
+  }
+}
+
+void CrashReportExceptionHandler::UpdateDeferredReportWriter() {
+  const bool deferred =
+      release_clients_before_writing_ || copy_attachments_after_release_;
+  if (deferred == !!deferred_report_writer_) {
+    return;
+  }
+
+  if (deferred) {
+    deferred_report_writer_ = std::make_unique<DeferredReportWriter>(this);
+    deferred_report_writer_->Start();
+  } else {
+    deferred_report_writer_->Stop();
+    deferred_report_writer_.reset();
+  }
+}
 
 bool CrashReportExceptionHandler::HandleException(
     pid_t client_process_id,
@@ -126,12 +509,19 @@ bool CrashReportExceptionHandler::HandleException(
     const ExceptionHandlerProtocol::ClientInformation& info,
     VMAddress requesting_thread_stack_address,
     pid_t* requesting_thread_id,
-    UUID* local_report_id) {
+    UUID* local_report_id,
+    const std::map<std::string, std::string>* client_annotations) {
   Metrics::ExceptionEncountered();
 
   {
-    auto it = process_annotations_->find("run-uuid");
-    if (it != process_annotations_->cend()) {
+    // A client of a handler started with --daemon passes its run UUID in its
+    // own annotations.
+    const std::map<std::string, std::string>* annotations =
+        client_annotations && client_annotations->count("run-uuid")
+            ? client_annotations
+            : process_annotations_;
+    auto it = annotations->find("run-uuid");
+    if (it != annotations->cend()) {
       namespace cld = backtrace::crash_loop_detection;
       UUID uuid;
       uuid.InitializeFromString(it->second);
@@ -142,8 +532,16 @@ bool CrashReportExceptionHandler::HandleException(
     }
   }
 
+  ScopedDumpPriority scoped_priority(dump_priority_);
+  StackSampler::ScopedPause pause_sampling(stack_sampler_, client_process_id);
   DirectPtraceConnection connection;
-  if (!connection.Initialize(client_process_id)) {
+  bool attached;
+  {
+    Metrics::ScopedOperationTimer suspend_timer(
+        Metrics::TimedOperation::kSuspend);
+    attached = connection.Initialize(client_process_id);
+  }
+  if (!attached) {
     Metrics::ExceptionCaptureResult(
         Metrics::CaptureResult::kDirectPtraceFailed);
     return false;
@@ -154,7 +552,8 @@ bool CrashReportExceptionHandler::HandleException(
                                        client_uid,
                                        requesting_thread_stack_address,
                                        requesting_thread_id,
-                                       local_report_id);
+                                       local_report_id,
+                                       client_annotations);
 }
 
 bool CrashReportExceptionHandler::HandleExceptionWithBroker(
@@ -162,18 +561,139 @@ bool CrashReportExceptionHandler::HandleExceptionWithBroker(
     uid_t client_uid,
     const ExceptionHandlerProtocol::ClientInformation& info,
     int broker_sock,
-    UUID* local_report_id) {
+    UUID* local_report_id,
+    const std::map<std::string, std::string>* client_annotations) {
   Metrics::ExceptionEncountered();
 
+  ScopedDumpPriority scoped_priority(dump_priority_);
+  StackSampler::ScopedPause pause_sampling(stack_sampler_, client_process_id);
   PtraceClient client;
-  if (!client.Initialize(broker_sock, client_process_id)) {
+  bool attached;
+  {
+    Metrics::ScopedOperationTimer suspend_timer(
+        Metrics::TimedOperation::kSuspend);
+    attached = client.Initialize(broker_sock, client_process_id);
+  }
+  if (!attached) {
     Metrics::ExceptionCaptureResult(
         Metrics::CaptureResult::kBrokeredPtraceFailed);
     return false;
   }
 
-  return HandleExceptionWithConnection(
-      &client, info, client_uid, 0, nullptr, local_report_id);
+  return HandleExceptionWithConnection(&client,
+                                       info,
+                                       client_uid,
+                                       0,
+                                       nullptr,
+                                       local_report_id,
+                                       client_annotations);
+}
+
+bool CrashReportExceptionHandler::HandleHang(
+    pid_t client_process_id,
+    uid_t client_uid,
+    const std::vector<pid_t>& hung_thread_ids,
+    const std::map<std::string, std::string>* client_annotations) {
+  std::map<std::string, std::string> annotations;
+  if (client_annotations) {
+    annotations = *client_annotations;
+  }
+  annotations.insert(process_annotations_->begin(),
+                     process_annotations_->end());
+  std::string hang_thread_ids;
+  MinidumpSnapshotFilter filter = MinidumpSnapshotFilter::Reduced();
+  filter.collapse_identical_threads = collapse_identical_threads_;
+  for (pid_t thread_id : hung_thread_ids) {
+    if (!hang_thread_ids.empty()) {
+      hang_thread_ids.push_back(',');
+    }
+    hang_thread_ids += base::NumberToString(thread_id);
+    filter.memory_thread_ids.insert(thread_id);
+  }
+  annotations["hang-thread-ids"] = hang_thread_ids;
+
+  // The report is prepared before the client is stopped, and the minidump is
+  // written into memory while it is, so that the client is paused no longer
+  // than needed.
+  std::unique_ptr<CrashReportDatabase::NewReport> new_report;
+  if (write_minidump_to_database_ &&
+      PrepareNewCrashReport(&new_report) != CrashReportDatabase::kNoError) {
+    LOG(ERROR) << "PrepareNewCrashReport failed";
+    return false;
+  }
+  if (new_report) {
+    TraceEvents::SetReportID(new_report->ReportID());
+  }
+
+  StringFile minidump_file;
+  {
+    ScopedDumpPriority scoped_priority(dump_priority_);
+    StackSampler::ScopedPause pause_sampling(stack_sampler_,
+                                             client_process_id);
+    DirectPtraceConnection connection;
+    if (!connection.Initialize(client_process_id)) {
+      return false;
+    }
+
+    // The client didn’t ask for this dump, so there’s no exception or
+    // sanitization information.
+    std::unique_ptr<ProcessSnapshotLinux> process_snapshot;
+    std::unique_ptr<ProcessSnapshotSanitized> sanitized_snapshot;
+    if (!CaptureSnapshot(&connection,
+                         ExceptionHandlerProtocol::ClientInformation(),
+                         annotations,
+                         client_uid,
+                         0,
+                         module_snapshot_threads_,
+                         thread_snapshot_threads_,
+                         &module_reader_cache_,
+                         &image_info_cache_,
+                         &system_info_cache_,
+                         unwind_stacks_,
+                         capture_whole_allocations_,
+                         nullptr,
+                         &process_snapshot,
+                         &sanitized_snapshot)) {
+      return false;
+    }
+
+    UUID client_id;
+    Settings* const settings = database_->GetSettings();
+    if (settings && settings->GetClientID(&client_id)) {
+      process_snapshot->SetClientID(client_id);
+    }
+
+    if (!new_report) {
+      return WriteMinidumpToLog(process_snapshot.get(), nullptr);
+    }
+    process_snapshot->SetReportID(new_report->ReportID());
+
+    MinidumpFileWriter minidump;
+    minidump.InitializeFromSnapshot(process_snapshot.get(), filter);
+    AddMemoryInfo(process_snapshot.get(), &minidump);
+    AddStackSamples(process_snapshot.get(), &minidump);
+    if (!WriteMinidump(&minidump, &minidump_file)) {
+      return false;
+    }
+  }
+
+  const std::string& minidump = minidump_file.string();
+  if (!new_report->Writer()->Write(minidump.data(), minidump.size())) {
+    LOG(ERROR) << "Write failed";
+    return false;
+  }
+  return FinishWritingReport(
+      std::move(new_report), write_minidump_to_log_, nullptr);
+}
+
+bool CrashReportExceptionHandler::HandleStackSamplingRequest(
+    pid_t client_process_id,
+    uid_t client_uid) {
+  if (!stack_sampler_) {
+    LOG(WARNING) << "stack sampling not enabled";
+    return false;
+  }
+  return stack_sampler_->AddProcess(client_process_id);
 }
 
 bool CrashReportExceptionHandler::HandleExceptionWithConnection(
@@ -182,20 +702,56 @@ bool CrashReportExceptionHandler::HandleExceptionWithConnection(
     uid_t client_uid,
     VMAddress requesting_thread_stack_address,
     pid_t* requesting_thread_id,
-    UUID* local_report_id) {
+    UUID* local_report_id,
+    const std::map<std::string, std::string>* client_annotations) {
+  // Annotations set by the client take precedence over the handler's own.
+  std::map<std::string, std::string> merged_annotations;
+  const std::map<std::string, std::string>* process_annotations =
+      process_annotations_;
+  if (client_annotations && !client_annotations->empty()) {
+    merged_annotations = *client_annotations;
+    merged_annotations.insert(process_annotations_->begin(),
+                              process_annotations_->end());
+    process_annotations = &merged_annotations;
+  }
+
   std::unique_ptr<ProcessSnapshotLinux> process_snapshot;
   std::unique_ptr<ProcessSnapshotSanitized> sanitized_snapshot;
   if (!CaptureSnapshot(connection,
                        info,
-                       *process_annotations_,
+                       *process_annotations,
                        client_uid,
                        requesting_thread_stack_address,
+                       module_snapshot_threads_,
+                       thread_snapshot_threads_,
+                       &module_reader_cache_,
+                       &image_info_cache_,
+                       &system_info_cache_,
+                       unwind_stacks_,
+                       capture_whole_allocations_,
                        requesting_thread_id,
                        &process_snapshot,
                        &sanitized_snapshot)) {
     return false;
   }
 
+  if (crash_signature_throttle_ && !local_report_id) {
+    const std::string signature =
+        CrashSignature(process_snapshot.get(), kCrashSignatureFrames);
+    uint32_t suppressed = 0;
+    if (!signature.empty() &&
+        !crash_signature_throttle_->ShouldKeep(signature, &suppressed)) {
+      LOG(INFO) << "skipping report of duplicate crash " << signature;
+      Metrics::ExceptionCaptureResult(
+          Metrics::CaptureResult::kSkippedDueToDuplicateSignature);
+      return true;
+    }
+    if (suppressed) {
+      process_snapshot->AddAnnotation("crashpad_suppressed_duplicates",
+                                      base::NumberToString(suppressed));
+    }
+  }
+
   UUID client_id;
   Settings* const settings = database_->GetSettings();
   if (settings && settings->GetClientID(&client_id)) {
@@ -218,7 +774,7 @@ bool CrashReportExceptionHandler::WriteMinidumpToDatabase(
     UUID* local_report_id) {
   std::unique_ptr<CrashReportDatabase::NewReport> new_report;
   CrashReportDatabase::OperationStatus database_status =
-      database_->PrepareNewCrashReport(&new_report);
+      PrepareNewCrashReport(&new_report);
   if (database_status != CrashReportDatabase::kNoError) {
     LOG(ERROR) << "PrepareNewCrashReport failed";
     Metrics::ExceptionCaptureResult(
@@ -227,54 +783,164 @@ bool CrashReportExceptionHandler::WriteMinidumpToDatabase(
   }
 
   process_snapshot->SetReportID(new_report->ReportID());
+  TraceEvents::SetReportID(new_report->ReportID());
 
   ProcessSnapshot* snapshot =
       sanitized_snapshot ? implicit_cast<ProcessSnapshot*>(sanitized_snapshot)
                          : implicit_cast<ProcessSnapshot*>(process_snapshot);
 
+  MinidumpSnapshotFilter filter;
+  filter.collapse_identical_threads = collapse_identical_threads_;
   MinidumpFileWriter minidump;
-  minidump.InitializeFromSnapshot(snapshot);
-  AddUserExtensionStreams(user_stream_data_sources_, snapshot, &minidump);
+  minidump.InitializeFromSnapshot(snapshot, filter);
+  if (!sanitized_snapshot) {
+    AddMemoryInfo(process_snapshot, &minidump);
+  }
+  AddStackSamples(snapshot, &minidump);
+  AddUserExtensionStreams(user_stream_data_sources_,
+                          snapshot,
+                          &minidump,
+                          user_stream_threads_,
+                          user_stream_time_budget_);
+
+  // Full memory is added last, because its data must follow every other
+  // stream’s.
+  const bool full_memory = full_memory_dumps_ && !sanitized_snapshot;
+  if (full_memory) {
+    minidump.AddFullMemory(
+        process_snapshot->FullMemory(full_memory_max_mapping_size_));
+  }
+
+  // A minidump that’s uploaded from memory is only written to the report
+  // prepared for it if it grows too large or its upload isn’t made.
+  if (upload_from_memory_limit_ && upload_thread_ && !local_report_id &&
+      !write_minidump_to_log && attachments_->empty()) {
+    SpillingFileWriter writer(upload_from_memory_limit_, new_report->Writer());
+    if (!WriteMinidump(&minidump, &writer)) {
+      return false;
+    }
+    std::unique_ptr<ChunkedStringFile> minidump_file = writer.TakeMemory();
+    if (minidump_file) {
+      upload_thread_->UploadFromMemory(std::move(new_report),
+                                       std::move(minidump_file));
+      Metrics::ExceptionCaptureResult(Metrics::CaptureResult::kSuccess);
+      return true;
+    }
+    return FinishWritingReport(
+        std::move(new_report), write_minidump_to_log, local_report_id);
+  }
+
+  // Writing the minidump into memory reads everything that’s needed from the
+  // client, so the rest of the report can be completed after it’s released.
+  // Full memory is too large to hold in memory, so it’s written in place.
+  if (release_clients_before_writing_ && !local_report_id && !full_memory) {
+    auto minidump_file = std::make_unique<StringFile>();
+    if (!WriteMinidump(&minidump, minidump_file.get())) {
+      return false;
+    }
+    deferred_report_writer_->AddReport(
+        std::move(new_report), std::move(minidump_file), write_minidump_to_log);
+    return true;
+  }
+
+  // Full memory is read from the client while it’s written, so writing it on
+  // another thread lets the disk keep up with reading.
+  if (full_memory) {
+    AsyncFileWriter writer(new_report->Writer());
+    const bool wrote = WriteMinidump(&minidump, &writer);
+    if (!writer.Flush()) {
+      LOG(ERROR) << "AsyncFileWriter::Flush failed";
+      return false;
+    }
+    if (!wrote) {
+      return false;
+    }
+  } else if (!WriteMinidump(&minidump, new_report->Writer())) {
+    return false;
+  }
 
-  if (!minidump.WriteEverything(new_report->Writer())) {
-    LOG(ERROR) << "WriteEverything failed";
+  // The attachments aren’t read from the client, so they can be copied after
+  // it’s released. The report isn’t completed until they have been.
+  if (copy_attachments_after_release_ && !local_report_id &&
+      !attachments_->empty()) {
+    deferred_report_writer_->AddReport(
+        std::move(new_report), nullptr, write_minidump_to_log);
+    return true;
+  }
+
+  return FinishWritingReport(
+      std::move(new_report), write_minidump_to_log, local_report_id);
+}
+
+CrashReportDatabase::OperationStatus
+CrashReportExceptionHandler::PrepareNewCrashReport(
+    std::unique_ptr<CrashReportDatabase::NewReport>* new_report) {
+  if (spare_report_preparer_) {
+    *new_report = spare_report_preparer_->TakeSpareReport();
+    if (*new_report) {
+      return CrashReportDatabase::kNoError;
+    }
+  }
+  return database_->PrepareNewCrashReport(new_report);
+}
+
+bool CrashReportExceptionHandler::WriteMinidump(
+    MinidumpFileWriter* minidump,
+    FileWriterInterface* file_writer) {
+  minidump->SetWriteChecksum(checksum_minidumps_);
+  const bool wrote = compress_minidumps_
+                         ? minidump->WriteCompressedMinidump(file_writer)
+                         : minidump->WriteEverything(file_writer);
+  if (!wrote) {
+    LOG(ERROR) << (compress_minidumps_ ? "WriteCompressedMinidump failed"
+                                       : "WriteEverything failed");
     Metrics::ExceptionCaptureResult(
         Metrics::CaptureResult::kMinidumpWriteFailed);
-    return false;
   }
+  return wrote;
+}
 
+bool CrashReportExceptionHandler::FinishWritingReport(
+    std::unique_ptr<CrashReportDatabase::NewReport> new_report,
+    bool write_minidump_to_log,
+    UUID* local_report_id) {
   bool write_minidump_to_log_succeed = false;
   if (write_minidump_to_log) {
     if (auto* file_reader = new_report->Reader()) {
-      if (WriteMinidumpLogFromFile(file_reader))
+      if (WriteMinidumpLogFromFile(file_reader, compress_minidumps_, log_mode_))
         write_minidump_to_log_succeed = true;
       else
         LOG(ERROR) << "WriteMinidumpLogFromFile failed";
     }
   }
 
-  for (const auto& attachment : (*attachments_)) {
-    FileReader file_reader;
-    if (!file_reader.Open(attachment)) {
-      LOG(ERROR) << "attachment " << attachment.value().c_str()
-                 << " couldn't be opened, skipping";
-      continue;
-    }
-
-    base::FilePath filename = attachment.BaseName();
-    FileWriter* file_writer = new_report->AddAttachment(filename.value());
-    if (file_writer == nullptr) {
-      LOG(ERROR) << "attachment " << filename.value().c_str()
-                 << " couldn't be created, skipping";
-      continue;
+  if (!attachments_->empty()) {
+    TraceEvents::ScopedEvent attachments_event("CopyAttachments");
+    for (const auto& attachment : (*attachments_)) {
+      ScopedFileHandle attachment_file(LoggingOpenFileForRead(attachment));
+      if (!attachment_file.is_valid()) {
+        LOG(ERROR) << "attachment " << attachment.value().c_str()
+                   << " couldn't be opened, skipping";
+        continue;
+      }
+
+      base::FilePath filename = attachment.BaseName();
+      if (!new_report->AddAttachmentFromFile(filename.value(),
+                                             attachment_file.get())) {
+        LOG(ERROR) << "attachment " << filename.value().c_str()
+                   << " couldn't be created, skipping";
+        continue;
+      }
     }
-
-    CopyFileContent(&file_reader, file_writer);
   }
 
   UUID uuid;
-  database_status =
-      database_->FinishedWritingCrashReport(std::move(new_report), &uuid);
+  CrashReportDatabase::OperationStatus database_status;
+  {
+    TraceEvents::ScopedEvent commit_event("DatabaseCommit");
+    database_status =
+        database_->FinishedWritingCrashReport(std::move(new_report), &uuid);
+  }
   if (database_status != CrashReportDatabase::kNoError) {
     LOG(ERROR) << "FinishedWritingCrashReport failed";
     Metrics::ExceptionCaptureResult(
@@ -301,15 +967,26 @@ bool CrashReportExceptionHandler::WriteMinidumpToLog(
   ProcessSnapshot* snapshot =
       sanitized_snapshot ? implicit_cast<ProcessSnapshot*>(sanitized_snapshot)
                          : implicit_cast<ProcessSnapshot*>(process_snapshot);
+  MinidumpSnapshotFilter filter;
+  filter.collapse_identical_threads = collapse_identical_threads_;
   MinidumpFileWriter minidump;
-  minidump.InitializeFromSnapshot(snapshot);
-  AddUserExtensionStreams(user_stream_data_sources_, snapshot, &minidump);
+  minidump.InitializeFromSnapshot(snapshot, filter);
+  if (!sanitized_snapshot) {
+    AddMemoryInfo(process_snapshot, &minidump);
+  }
+  AddStackSamples(snapshot, &minidump);
+  AddUserExtensionStreams(user_stream_data_sources_,
+                          snapshot,
+                          &minidump,
+                          user_stream_threads_,
+                          user_stream_time_budget_);
 
   OutputStreamFileWriter writer(std::make_unique<ZlibOutputStream>(
       ZlibOutputStream::Mode::kCompress,
       std::make_unique<Base94OutputStream>(
           Base94OutputStream::Mode::kEncode,
-          std::make_unique<LogOutputStream>(std::make_unique<Logger>()))));
+          std::make_unique<LogOutputStream>(std::make_unique<Logger>(log_mode_),
+                                            log_mode_))));
   if (!minidump.WriteMinidump(&writer, false /* allow_seek */)) {
     LOG(ERROR) << "WriteMinidump failed";
     return false;
@@ -317,4 +994,29 @@ bool CrashReportExceptionHandler::WriteMinidumpToLog(
   return writer.Flush();
 }
 
+void CrashReportExceptionHandler::AddStackSamples(
+    const ProcessSnapshot* snapshot,
+    MinidumpFileWriter* minidump) {
+  if (!stack_sampler_) {
+    return;
+  }
+  std::unique_ptr<MinidumpUserExtensionStreamDataSource> stack_samples =
+      stack_sampler_->CreateStreamDataSource(snapshot->ProcessID());
+  if (stack_samples) {
+    minidump->AddUserExtensionStream(std::move(stack_samples));
+  }
+}
+
+void CrashReportExceptionHandler::AddMemoryInfo(
+    ProcessSnapshotLinux* process_snapshot,
+    MinidumpFileWriter* minidump) {
+  if (!memory_info_) {
+    return;
+  }
+  auto memory_info_list = std::make_unique<MinidumpMemoryInfoListWriter>();
+  memory_info_list->InitializeFromMemoryInfo(process_snapshot->MemoryInfo(),
+                                             merge_memory_info_);
+  minidump->AddStream(std::move(memory_info_list));
+}
+
 }  // namespace crashpad
@@ -15,22 +15,35 @@
 #ifndef CRASHPAD_HANDLER_LINUX_CRASH_REPORT_EXCEPTION_HANDLER_H_
 #define CRASHPAD_HANDLER_LINUX_CRASH_REPORT_EXCEPTION_HANDLER_H_
 
+#include <stdint.h>
+
 #include <map>
+#include <memory>
 #include <string>
 
 #include "client/crash_report_database.h"
 #include "handler/crash_report_upload_thread.h"
 #include "handler/linux/exception_handler_server.h"
+#include "handler/linux/scoped_dump_priority.h"
 #include "handler/user_stream_data_source.h"
+#include "snapshot/elf/elf_image_info_cache.h"
+#include "snapshot/linux/module_reader_cache.h"
+#include "snapshot/linux/system_info_cache.h"
 #include "util/linux/exception_handler_protocol.h"
 #include "util/linux/ptrace_connection.h"
 #include "util/misc/address_types.h"
 #include "util/misc/uuid.h"
+#include "util/stream/log_output_stream.h"
 
 namespace crashpad {
 
+class CrashSignatureThrottle;
+class FileWriterInterface;
+class MinidumpFileWriter;
+class ProcessSnapshot;
 class ProcessSnapshotLinux;
 class ProcessSnapshotSanitized;
+class StackSampler;
 
 //! \brief An exception handler that writes crash reports for exceptions
 //!     to a CrashReportDatabase.
@@ -77,6 +90,273 @@ class CrashReportExceptionHandler : public ExceptionHandlerServer::Delegate {
 
   ~CrashReportExceptionHandler() override;
 
+  //! \brief Sets whether the stacks of threads identical to an earlier
+  //!     thread are left out of minidumps.
+  //!
+  //! See MinidumpSnapshotFilter::collapse_identical_threads. The default is
+  //! `false`.
+  //!
+  //! This must be called before the handler begins handling exceptions.
+  void SetCollapseIdenticalThreads(bool collapse_identical_threads) {
+    collapse_identical_threads_ = collapse_identical_threads;
+  }
+
+  //! \brief Sets whether minidumps written to the database carry a checksum.
+  //!
+  //! The checksum is written by MinidumpFileWriter::SetWriteChecksum(), and a
+  //! report that doesn’t match it is not uploaded. It isn’t written for
+  //! compressed or full-memory minidumps. The default is `false`.
+  //!
+  //! This must be called before the handler begins handling exceptions.
+  void SetChecksumMinidumps(bool checksum_minidumps) {
+    checksum_minidumps_ = checksum_minidumps;
+  }
+
+  //! \brief Sets whether minidumps written to the database are compressed.
+  //!
+  //! Compressed minidumps are written by
+  //! MinidumpFileWriter::WriteCompressedMinidump(). They are decompressed
+  //! before being uploaded. The default is `false`.
+  //!
+  //! This must be called before the handler begins handling exceptions.
+  void SetCompressMinidumps(bool compress_minidumps) {
+    compress_minidumps_ = compress_minidumps;
+  }
+
+  //! \brief Sets the scheduling that a thread runs with while it handles an
+  //!     exception or a hang.
+  //!
+  //! The thread returns to its own scheduling once it has handled the request.
+  //! Reports are uploaded with the handler’s own scheduling. See
+  //! ScopedDumpPriority. The default is to run with the handler’s scheduling.
+  //!
+  //! This must be called before the handler begins handling exceptions.
+  void SetDumpPriority(const DumpPriority& dump_priority) {
+    dump_priority_ = dump_priority;
+  }
+
+  //! \brief Sets whether minidumps written to the log are written in chunks.
+  //!
+  //! Chunks are larger than lines and carry sequence numbers and checksums, so
+  //! that a minidump can be reassembled from the log and lost chunks can be
+  //! identified. See LogOutputStream::Mode::kChunks. The default is `false`.
+  //!
+  //! This must be called before the handler begins handling exceptions.
+  void SetWriteMinidumpToLogInChunks(bool chunks) {
+    log_mode_ = chunks ? LogOutputStream::Mode::kChunks
+                       : LogOutputStream::Mode::kLines;
+  }
+
+  //! \brief Sets whether minidumps written to the database carry the client’s
+  //!     entire memory.
+  //!
+  //! When this is enabled, the memory chosen by
+  //! ProcessSnapshotLinux::FullMemory() is added to each minidump with
+  //! MinidumpFileWriter::AddFullMemory(). It is read from the client as the
+  //! minidump is written, so a client isn’t released before its minidump has
+  //! been written, regardless of SetReleaseClientsBeforeWriting(). Sanitized
+  //! minidumps and minidumps written to the log don’t carry full memory. The
+  //! default is `false`.
+  //!
+  //! This must be called before the handler begins handling exceptions.
+  //!
+  //! \param[in] full_memory_dumps Whether to write full-memory minidumps.
+  //! \param[in] max_mapping_size Mappings larger than this are left out of
+  //!     full-memory minidumps. `0` leaves out no mappings by size.
+  void SetFullMemoryDumps(bool full_memory_dumps, uint64_t max_mapping_size) {
+    full_memory_dumps_ = full_memory_dumps;
+    full_memory_max_mapping_size_ = max_mapping_size;
+  }
+
+  //! \brief Sets whether minidumps describe each of the client’s mappings in a
+  //!     memory info list.
+  //!
+  //! The list is built by ProcessSnapshotLinux::MemoryInfo(). Sanitized
+  //! minidumps don’t carry it. The default is `false`.
+  //!
+  //! This must be called before the handler begins handling exceptions.
+  //!
+  //! \param[in] memory_info Whether to write a memory info list.
+  //! \param[in] merge_adjacent Whether to merge adjacent mappings with the
+  //!     same protection and type into one entry, which keeps the list small
+  //!     for clients with very many mappings.
+  void SetMemoryInfo(bool memory_info, bool merge_adjacent) {
+    memory_info_ = memory_info;
+    merge_memory_info_ = merge_adjacent;
+  }
+
+  //! \brief Sets the number of threads used to initialize module snapshots.
+  //!
+  //! See ProcessSnapshotLinux::Initialize(). The default is `1`.
+  //!
+  //! This must be called before the handler begins handling exceptions.
+  void SetModuleSnapshotThreads(unsigned int module_snapshot_threads) {
+    module_snapshot_threads_ = module_snapshot_threads;
+  }
+
+  //! \brief Sets the number of threads used to gather information about a
+  //!     client’s threads.
+  //!
+  //! See ProcessSnapshotLinux::Initialize(). The default is `1`.
+  //!
+  //! This must be called before the handler begins handling exceptions.
+  void SetThreadSnapshotThreads(unsigned int thread_snapshot_threads) {
+    thread_snapshot_threads_ = thread_snapshot_threads;
+  }
+
+  //! \brief Sets whether the stacks of a client’s threads are unwound when it
+  //!     is snapshotted.
+  //!
+  //! See ProcessSnapshotLinux::Initialize(). The default is `false`.
+  //!
+  //! This must be called before the handler begins handling exceptions.
+  void SetUnwindStacks(bool unwind_stacks) { unwind_stacks_ = unwind_stacks; }
+
+  //! \brief Sets whether indirectly referenced memory is captured as whole
+  //!     heap allocations when a client is snapshotted.
+  //!
+  //! See ProcessSnapshotLinux::Initialize(). The default is `false`.
+  //!
+  //! This must be called before the handler begins handling exceptions.
+  void SetCaptureWholeAllocations(bool capture_whole_allocations) {
+    capture_whole_allocations_ = capture_whole_allocations;
+  }
+
+  //! \brief Sets the number of threads that user stream data sources are run
+  //!     on at once.
+  //!
+  //! See AddUserExtensionStreams(). The default is `1`.
+  //!
+  //! This must be called before the handler begins handling exceptions.
+  void SetUserStreamDataSourceThreads(unsigned int user_stream_threads) {
+    user_stream_threads_ = user_stream_threads;
+  }
+
+  //! \brief Sets the time in seconds that each user stream data source may
+  //!     run for before it is canceled.
+  //!
+  //! See AddUserExtensionStreams(). The default is `0`, which lets data
+  //! sources run for as long as they take.
+  //!
+  //! This must be called before the handler begins handling exceptions.
+  void SetUserStreamDataSourceTimeBudget(double user_stream_time_budget) {
+    user_stream_time_budget_ = user_stream_time_budget;
+  }
+
+  //! \brief Sets whether clients are released before their crash reports are
+  //!     written to the database.
+  //!
+  //! By default, a client remains stopped until its crash report has been
+  //! written and committed to the database. When this is enabled, the minidump
+  //! is written into memory while the client is stopped, which reads
+  //! everything needed from the client, and the client is released as soon as
+  //! that is done. Writing the minidump to the database, copying attachments,
+  //! and completing the report are then done on a background thread. Reports
+  //! whose UUID is requested by the caller of HandleException() or
+  //! HandleExceptionWithBroker() are always written before returning.
+  //!
+  //! This only affects reports written to the database. The default is
+  //! `false`.
+  //!
+  //! This must be called before the handler begins handling exceptions.
+  void SetReleaseClientsBeforeWriting(bool release_clients_before_writing);
+
+  //! \brief Sets whether attachments are copied into crash reports after
+  //!     clients are released.
+  //!
+  //! By default, attachments are copied into a crash report while the client
+  //! remains stopped. When this is enabled, the minidump is still written
+  //! while the client is stopped, but the client is released before the
+  //! attachments are copied. Copying attachments and completing the report are
+  //! then done on a background thread, so a report only becomes complete once
+  //! its attachments are in it. Attachments copied this way may contain what
+  //! was written to them after the client was released. Reports whose UUID is
+  //! requested by the caller of HandleException() or
+  //! HandleExceptionWithBroker() are always completed before returning.
+  //!
+  //! Whether or not this is enabled, attachments on a filesystem that supports
+  //! it are cloned into reports instead of being copied. See
+  //! CloneFileContent().
+  //!
+  //! This only affects reports written to the database. The default is
+  //! `false`.
+  //!
+  //! This must be called before the handler begins handling exceptions.
+  void SetCopyAttachmentsAfterRelease(bool copy_attachments_after_release);
+
+  //! \brief Sets whether a new crash report is prepared in the database ahead
+  //!     of each exception.
+  //!
+  //! By default, a new report is prepared with
+  //! CrashReportDatabase::PrepareNewCrashReport() while the client is stopped.
+  //! When this is enabled, a spare report is kept prepared on a background
+  //! thread, and each exception takes it, so that creating the report’s file
+  //! isn’t on the path of handling the exception. A replacement is then
+  //! prepared in the background. A spare report that has gone unused for an
+  //! hour is replaced, so that it’s never old enough to be removed by
+  //! CrashReportDatabase::CleanDatabase(). If no spare report is ready, one is
+  //! prepared while the client is stopped, as usual.
+  //!
+  //! This only affects reports written to the database. The default is
+  //! `false`.
+  //!
+  //! This must be called before the handler begins handling exceptions.
+  void SetPrepareReportsAhead(bool prepare_reports_ahead);
+
+  //! \brief Sets the size up to which minidumps are uploaded directly from
+  //!     memory.
+  //!
+  //! By default, each minidump is written to the database, from which the
+  //! upload thread reads it to upload it. When this is nonzero, a minidump is
+  //! written into memory instead, as long as it fits within \a limit bytes,
+  //! and is passed to CrashReportUploadThread::UploadFromMemory(). It is only
+  //! written to the database if its upload isn’t made or fails. A minidump
+  //! that passes the limit is moved to the database as soon as it does, and
+  //! its report is completed as usual.
+  //!
+  //! This only affects reports without attachments that aren’t written to the
+  //! log, whose UUID isn’t requested by the caller of HandleException() or
+  //! HandleExceptionWithBroker(), and only when there is an upload thread. The
+  //! default is `0`.
+  //!
+  //! This must be called before the handler begins handling exceptions.
+  void SetUploadFromMemoryLimit(size_t limit) {
+    upload_from_memory_limit_ = limit;
+  }
+
+  //! \brief Sets the sampler that clients asking for stack sampling are added
+  //!     to.
+  //!
+  //! The samples kept for a client are added to its crash and hang reports,
+  //! and the client isn’t sampled while it is being dumped. By default, there
+  //! is no sampler, and requests for stack sampling are refused.
+  //!
+  //! This must be called before the handler begins handling exceptions.
+  //!
+  //! \param[in] stack_sampler The sampler. Weak.
+  void SetStackSampler(StackSampler* stack_sampler) {
+    stack_sampler_ = stack_sampler;
+  }
+
+  //! \brief Sets the throttle that decides whether to write reports of
+  //!     crashes whose signature has been seen recently.
+  //!
+  //! The signature of each crash is computed by CrashSignature() after the
+  //! client is snapshotted, and a report that the throttle doesn’t keep isn’t
+  //! written. The next report of the same signature that is written has a
+  //! `"crashpad_suppressed_duplicates"` process annotation giving the number of
+  //! reports that weren’t. The annotation isn’t added to sanitized reports.
+  //! Reports without an exception, and reports whose ID is requested by the
+  //! client, are always written. By default, there is no throttle, and every
+  //! report is written.
+  //!
+  //! This must be called before the handler begins handling exceptions.
+  //!
+  //! \param[in] throttle The throttle. Weak.
+  void SetCrashSignatureThrottle(CrashSignatureThrottle* throttle) {
+    crash_signature_throttle_ = throttle;
+  }
+
   // ExceptionHandlerServer::Delegate:
 
   bool HandleException(pid_t client_process_id,
@@ -84,30 +364,70 @@ class CrashReportExceptionHandler : public ExceptionHandlerServer::Delegate {
                        const ExceptionHandlerProtocol::ClientInformation& info,
                        VMAddress requesting_thread_stack_address = 0,
                        pid_t* requesting_thread_id = nullptr,
-                       UUID* local_report_id = nullptr) override;
+                       UUID* local_report_id = nullptr,
+                       const std::map<std::string, std::string>*
+                           client_annotations = nullptr) override;
 
   bool HandleExceptionWithBroker(
       pid_t client_process_id,
       uid_t client_uid,
       const ExceptionHandlerProtocol::ClientInformation& info,
       int broker_sock,
-      UUID* local_report_id = nullptr) override;
+      UUID* local_report_id = nullptr,
+      const std::map<std::string, std::string>* client_annotations =
+          nullptr) override;
+
+  //! \brief Writes a reduced report of a hung client.
+  //!
+  //! The report holds what MinidumpSnapshotFilter::Reduced() selects, plus the
+  //! stacks of \a hung_thread_ids, and the `"hang-thread-ids"` annotation
+  //! listing them. It has no exception stream. The client is only stopped
+  //! while the report is written into memory, and it is completed in the
+  //! database after the client has been released.
+  bool HandleHang(pid_t client_process_id,
+                  uid_t client_uid,
+                  const std::vector<pid_t>& hung_thread_ids,
+                  const std::map<std::string, std::string>* client_annotations =
+                      nullptr) override;
+
+  bool HandleStackSamplingRequest(pid_t client_process_id,
+                                  uid_t client_uid) override;
 
  private:
+  class DeferredReportWriter;
+  class SpareReportPreparer;
+
   bool HandleExceptionWithConnection(
       PtraceConnection* connection,
       const ExceptionHandlerProtocol::ClientInformation& info,
       uid_t client_uid,
       VMAddress requesting_thread_stack_address,
       pid_t* requesting_thread_id,
-      UUID* local_report_id = nullptr);
+      UUID* local_report_id,
+      const std::map<std::string, std::string>* client_annotations);
+
+  // Starts or stops deferred_report_writer_ according to whether any work is
+  // deferred until after clients are released.
+  void UpdateDeferredReportWriter();
 
   bool WriteMinidumpToDatabase(ProcessSnapshotLinux* process_snapshot,
                                ProcessSnapshotSanitized* sanitized_snapshot,
                                bool write_minidump_to_log,
                                UUID* local_report_id);
+  CrashReportDatabase::OperationStatus PrepareNewCrashReport(
+      std::unique_ptr<CrashReportDatabase::NewReport>* new_report);
+  bool WriteMinidump(MinidumpFileWriter* minidump,
+                     FileWriterInterface* file_writer);
+  bool FinishWritingReport(
+      std::unique_ptr<CrashReportDatabase::NewReport> new_report,
+      bool write_minidump_to_log,
+      UUID* local_report_id);
   bool WriteMinidumpToLog(ProcessSnapshotLinux* process_snapshot,
                           ProcessSnapshotSanitized* sanitized_snapshot);
+  void AddStackSamples(const ProcessSnapshot* snapshot,
+                       MinidumpFileWriter* minidump);
+  void AddMemoryInfo(ProcessSnapshotLinux* process_snapshot,
+                     MinidumpFileWriter* minidump);
 
   CrashReportDatabase* database_;  // weak
   CrashReportUploadThread* upload_thread_;  // weak
@@ -115,7 +435,32 @@ class CrashReportExceptionHandler : public ExceptionHandlerServer::Delegate {
   const std::vector<base::FilePath>* attachments_;  // weak
   bool write_minidump_to_database_;
   bool write_minidump_to_log_;
+  bool collapse_identical_threads_;
+  bool checksum_minidumps_;
+  bool compress_minidumps_;
+  DumpPriority dump_priority_;
+  LogOutputStream::Mode log_mode_;
+  bool full_memory_dumps_;
+  uint64_t full_memory_max_mapping_size_;
+  bool memory_info_;
+  bool merge_memory_info_;
+  unsigned int module_snapshot_threads_;
+  unsigned int thread_snapshot_threads_;
+  bool unwind_stacks_;
+  bool capture_whole_allocations_;
+  bool release_clients_before_writing_;
+  bool copy_attachments_after_release_;
+  unsigned int user_stream_threads_;
+  double user_stream_time_budget_;
+  size_t upload_from_memory_limit_;
   const UserStreamDataSources* user_stream_data_sources_;  // weak
+  ModuleReaderCache module_reader_cache_;
+  ElfImageInfoCache image_info_cache_;
+  SystemInfoCache system_info_cache_;
+  StackSampler* stack_sampler_;  // weak
+  CrashSignatureThrottle* crash_signature_throttle_;  // weak
+  std::unique_ptr<DeferredReportWriter> deferred_report_writer_;
+  std::unique_ptr<SpareReportPreparer> spare_report_preparer_;
 };
 
 }  // namespace crashpad
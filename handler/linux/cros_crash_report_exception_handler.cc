@@ -14,9 +14,15 @@
 
 #include "handler/linux/cros_crash_report_exception_handler.h"
 
+#include <fcntl.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
 #include <vector>
 
 #include "base/logging.h"
+#include "base/posix/eintr_wrapper.h"
 #include "client/settings.h"
 #include "handler/linux/capture_snapshot.h"
 #include "handler/minidump_to_upload_parameters.h"
@@ -27,6 +33,7 @@
 #include "util/file/file_writer.h"
 #include "util/linux/direct_ptrace_connection.h"
 #include "util/linux/ptrace_client.h"
+#include "util/linux/socket.h"
 #include "util/misc/metrics.h"
 #include "util/misc/uuid.h"
 #include "util/posix/spawn_subprocess.h"
@@ -125,6 +132,43 @@ bool WriteAnnotationsAndMinidump(
   return true;
 }
 
+// Seals the memfd holding a report, so that it can’t change once it has been
+// handed to crash_reporter.
+bool SealMemfd(int memfd) {
+  if (HANDLE_EINTR(fcntl(memfd,
+                         F_ADD_SEALS,
+                         F_SEAL_SEAL | F_SEAL_SHRINK | F_SEAL_GROW |
+                             F_SEAL_WRITE)) != 0) {
+    PLOG(ERROR) << "fcntl F_ADD_SEALS";
+    return false;
+  }
+  return true;
+}
+
+// Connects a SOCK_SEQPACKET socket to the AF_UNIX socket at path.
+ScopedFileHandle ConnectSeqpacketSocket(const base::FilePath& path) {
+  sockaddr_un address = {};
+  address.sun_family = AF_UNIX;
+  if (path.value().size() >= sizeof(address.sun_path)) {
+    LOG(ERROR) << "socket path too long " << path.value();
+    return ScopedFileHandle();
+  }
+  memcpy(address.sun_path, path.value().c_str(), path.value().size() + 1);
+
+  ScopedFileHandle sock(socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0));
+  if (!sock.is_valid()) {
+    PLOG(ERROR) << "socket";
+    return ScopedFileHandle();
+  }
+  if (HANDLE_EINTR(connect(sock.get(),
+                           reinterpret_cast<sockaddr*>(&address),
+                           sizeof(address))) != 0) {
+    PLOG(ERROR) << "connect " << path.value();
+    return ScopedFileHandle();
+  }
+  return sock;
+}
+
 }  // namespace
 
 CrosCrashReportExceptionHandler::CrosCrashReportExceptionHandler(
@@ -134,7 +178,13 @@ CrosCrashReportExceptionHandler::CrosCrashReportExceptionHandler(
     : database_(database),
       process_annotations_(process_annotations),
       user_stream_data_sources_(user_stream_data_sources),
-      always_allow_feedback_(false) {}
+      always_allow_feedback_(false),
+      module_snapshot_threads_(1),
+      thread_snapshot_threads_(1),
+      unwind_stacks_(false),
+      capture_whole_allocations_(false),
+      user_stream_threads_(1),
+      user_stream_time_budget_(0) {}
 
 CrosCrashReportExceptionHandler::~CrosCrashReportExceptionHandler() = default;
 
@@ -144,7 +194,8 @@ bool CrosCrashReportExceptionHandler::HandleException(
     const ExceptionHandlerProtocol::ClientInformation& info,
     VMAddress requesting_thread_stack_address,
     pid_t* requesting_thread_id,
-    UUID* local_report_id) {
+    UUID* local_report_id,
+    const std::map<std::string, std::string>* client_annotations) {
   Metrics::ExceptionEncountered();
 
   DirectPtraceConnection connection;
@@ -159,7 +210,8 @@ bool CrosCrashReportExceptionHandler::HandleException(
                                        client_uid,
                                        requesting_thread_stack_address,
                                        requesting_thread_id,
-                                       local_report_id);
+                                       local_report_id,
+                                       client_annotations);
 }
 
 bool CrosCrashReportExceptionHandler::HandleExceptionWithBroker(
@@ -167,7 +219,8 @@ bool CrosCrashReportExceptionHandler::HandleExceptionWithBroker(
     uid_t client_uid,
     const ExceptionHandlerProtocol::ClientInformation& info,
     int broker_sock,
-    UUID* local_report_id) {
+    UUID* local_report_id,
+    const std::map<std::string, std::string>* client_annotations) {
   Metrics::ExceptionEncountered();
 
   PtraceClient client;
@@ -177,8 +230,13 @@ bool CrosCrashReportExceptionHandler::HandleExceptionWithBroker(
     return false;
   }
 
-  return HandleExceptionWithConnection(
-      &client, info, client_uid, 0, nullptr, local_report_id);
+  return HandleExceptionWithConnection(&client,
+                                       info,
+                                       client_uid,
+                                       0,
+                                       nullptr,
+                                       local_report_id,
+                                       client_annotations);
 }
 
 bool CrosCrashReportExceptionHandler::HandleExceptionWithConnection(
@@ -187,14 +245,33 @@ bool CrosCrashReportExceptionHandler::HandleExceptionWithConnection(
     uid_t client_uid,
     VMAddress requesting_thread_stack_address,
     pid_t* requesting_thread_id,
-    UUID* local_report_id) {
+    UUID* local_report_id,
+    const std::map<std::string, std::string>* client_annotations) {
+  // Annotations set by the client take precedence over the handler's own.
+  std::map<std::string, std::string> merged_annotations;
+  const std::map<std::string, std::string>* process_annotations =
+      process_annotations_;
+  if (client_annotations && !client_annotations->empty()) {
+    merged_annotations = *client_annotations;
+    merged_annotations.insert(process_annotations_->begin(),
+                              process_annotations_->end());
+    process_annotations = &merged_annotations;
+  }
+
   std::unique_ptr<ProcessSnapshotLinux> process_snapshot;
   std::unique_ptr<ProcessSnapshotSanitized> sanitized_snapshot;
   if (!CaptureSnapshot(connection,
                        info,
-                       *process_annotations_,
+                       *process_annotations,
                        client_uid,
                        requesting_thread_stack_address,
+                       module_snapshot_threads_,
+                       thread_snapshot_threads_,
+                       nullptr,
+                       nullptr,
+                       nullptr,
+                       unwind_stacks_,
+                       capture_whole_allocations_,
                        requesting_thread_id,
                        &process_snapshot,
                        &sanitized_snapshot)) {
@@ -222,7 +299,11 @@ bool CrosCrashReportExceptionHandler::HandleExceptionWithConnection(
 
   MinidumpFileWriter minidump;
   minidump.InitializeFromSnapshot(snapshot);
-  AddUserExtensionStreams(user_stream_data_sources_, snapshot, &minidump);
+  AddUserExtensionStreams(user_stream_data_sources_,
+                          snapshot,
+                          &minidump,
+                          user_stream_threads_,
+                          user_stream_time_budget_);
 
   FileWriter file_writer;
   if (!file_writer.OpenMemfd(base::FilePath("minidump"))) {
@@ -244,36 +325,43 @@ bool CrosCrashReportExceptionHandler::HandleExceptionWithConnection(
 
   // CrOS uses crash_reporter instead of Crashpad to report crashes.
   // crash_reporter needs to know the pid and uid of the crashing process.
-  std::vector<std::string> argv({"/sbin/crash_reporter"});
-
-  argv.push_back("--chrome_memfd=" + std::to_string(file_writer.fd()));
+  std::vector<std::string> arguments;
 
   const pid_t pid = process_snapshot->ProcessID();
-  argv.push_back("--pid=" + std::to_string(pid));
-  argv.push_back("--uid=" + std::to_string(client_uid));
+  arguments.push_back("--pid=" + std::to_string(pid));
+  arguments.push_back("--uid=" + std::to_string(client_uid));
 
   std::string process_name = GetProcessNameFromPid(pid);
-  argv.push_back("--exe=" + (process_name.empty() ? "chrome" : process_name));
+  arguments.push_back("--exe=" +
+                      (process_name.empty() ? "chrome" : process_name));
 
   if (info.crash_loop_before_time != 0) {
-    argv.push_back("--crash_loop_before=" +
-                   std::to_string(info.crash_loop_before_time));
+    arguments.push_back("--crash_loop_before=" +
+                        std::to_string(info.crash_loop_before_time));
   }
   if (!dump_dir_.empty()) {
-    argv.push_back("--chrome_dump_dir=" + dump_dir_.value());
+    arguments.push_back("--chrome_dump_dir=" + dump_dir_.value());
   }
   if (always_allow_feedback_) {
-    argv.push_back("--always_allow_feedback");
+    arguments.push_back("--always_allow_feedback");
   }
 
-  if (!SpawnSubprocess(argv,
-                       nullptr /* envp */,
-                       file_writer.fd() /* preserve_fd */,
-                       false /* use_path */,
-                       nullptr /* child_function */)) {
-    Metrics::ExceptionCaptureResult(
-        Metrics::CaptureResult::kFinishedWritingCrashReportFailed);
-    return false;
+  if (crash_reporter_socket_path_.empty() ||
+      !SendToCrashReporter(file_writer.fd(), arguments)) {
+    std::vector<std::string> argv(
+        {"/sbin/crash_reporter",
+         "--chrome_memfd=" + std::to_string(file_writer.fd())});
+    argv.insert(argv.end(), arguments.begin(), arguments.end());
+
+    if (!SpawnSubprocess(argv,
+                         nullptr /* envp */,
+                         file_writer.fd() /* preserve_fd */,
+                         false /* use_path */,
+                         nullptr /* child_function */)) {
+      Metrics::ExceptionCaptureResult(
+          Metrics::CaptureResult::kFinishedWritingCrashReportFailed);
+      return false;
+    }
   }
 
   if (local_report_id != nullptr) {
@@ -285,4 +373,44 @@ bool CrosCrashReportExceptionHandler::HandleExceptionWithConnection(
   return true;
 }
 
+bool CrosCrashReportExceptionHandler::SendToCrashReporter(
+    int memfd,
+    const std::vector<std::string>& arguments) {
+  if (!SealMemfd(memfd)) {
+    return false;
+  }
+
+  std::string message;
+  for (const std::string& argument : arguments) {
+    message.append(argument);
+    message.push_back('\0');
+  }
+
+  base::AutoLock lock(crash_reporter_socket_lock_);
+  if (crash_reporter_socket_.is_valid() &&
+      UnixCredentialSocket::SendMsg(crash_reporter_socket_.get(),
+                                    message.data(),
+                                    message.size(),
+                                    &memfd,
+                                    1) == 0) {
+    return true;
+  }
+
+  // Either no connection has been made yet, or crash_reporter has closed the
+  // one kept from an earlier report.
+  crash_reporter_socket_ = ConnectSeqpacketSocket(crash_reporter_socket_path_);
+  if (!crash_reporter_socket_.is_valid()) {
+    return false;
+  }
+  const int result = UnixCredentialSocket::SendMsg(
+      crash_reporter_socket_.get(), message.data(), message.size(), &memfd, 1);
+  if (result != 0) {
+    LOG(ERROR) << "couldn't send report to "
+               << crash_reporter_socket_path_.value();
+    crash_reporter_socket_.reset();
+    return false;
+  }
+  return true;
+}
+
 }  // namespace crashpad
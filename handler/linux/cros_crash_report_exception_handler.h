@@ -17,10 +17,14 @@
 
 #include <map>
 #include <string>
+#include <vector>
 
+#include "base/files/file_path.h"
+#include "base/synchronization/lock.h"
 #include "client/crash_report_database.h"
 #include "handler/linux/exception_handler_server.h"
 #include "handler/user_stream_data_source.h"
+#include "util/file/file_io.h"
 #include "util/linux/exception_handler_protocol.h"
 #include "util/linux/ptrace_connection.h"
 #include "util/misc/address_types.h"
@@ -71,17 +75,54 @@ class CrosCrashReportExceptionHandler
                        const ExceptionHandlerProtocol::ClientInformation& info,
                        VMAddress requesting_thread_stack_address = 0,
                        pid_t* requesting_thread_id = nullptr,
-                       UUID* local_report_id = nullptr) override;
+                       UUID* local_report_id = nullptr,
+                       const std::map<std::string, std::string>*
+                           client_annotations = nullptr) override;
 
   bool HandleExceptionWithBroker(
       pid_t client_process_id,
       uid_t client_uid,
       const ExceptionHandlerProtocol::ClientInformation& info,
       int broker_sock,
-      UUID* local_report_id = nullptr) override;
+      UUID* local_report_id = nullptr,
+      const std::map<std::string, std::string>* client_annotations =
+          nullptr) override;
 
   void SetDumpDir(const base::FilePath& dump_dir) { dump_dir_ = dump_dir; }
+
+  //! \brief Passes reports to a crash_reporter listening on the `AF_UNIX`
+  //!     socket at \a path, rather than spawning `/sbin/crash_reporter` for
+  //!     each report.
+  //!
+  //! The connection is kept between reports, and reopened if crash_reporter
+  //! has closed it. Each report is sent as a single message on a
+  //! `SOCK_SEQPACKET` connection. The message holds the arguments that
+  //! `/sbin/crash_reporter` would have been spawned with, other than
+  //! `--chrome_memfd`, each terminated by a NUL byte. The report’s memfd is
+  //! attached to it with `SCM_RIGHTS`, sealed so that it can no longer
+  //! change. A report that can’t be sent this way is passed to a spawned
+  //! `/sbin/crash_reporter` instead.
+  void SetCrashReporterSocket(const base::FilePath& path) {
+    crash_reporter_socket_path_ = path;
+  }
+
   void SetAlwaysAllowFeedback() { always_allow_feedback_ = true; }
+  void SetModuleSnapshotThreads(unsigned int module_snapshot_threads) {
+    module_snapshot_threads_ = module_snapshot_threads;
+  }
+  void SetThreadSnapshotThreads(unsigned int thread_snapshot_threads) {
+    thread_snapshot_threads_ = thread_snapshot_threads;
+  }
+  void SetUnwindStacks(bool unwind_stacks) { unwind_stacks_ = unwind_stacks; }
+  void SetCaptureWholeAllocations(bool capture_whole_allocations) {
+    capture_whole_allocations_ = capture_whole_allocations;
+  }
+  void SetUserStreamDataSourceThreads(unsigned int user_stream_threads) {
+    user_stream_threads_ = user_stream_threads;
+  }
+  void SetUserStreamDataSourceTimeBudget(double user_stream_time_budget) {
+    user_stream_time_budget_ = user_stream_time_budget;
+  }
  private:
   bool HandleExceptionWithConnection(
       PtraceConnection* connection,
@@ -89,13 +130,28 @@ class CrosCrashReportExceptionHandler
       uid_t client_uid,
       VMAddress requesting_thread_stack_address,
       pid_t* requesting_thread_id,
-      UUID* local_report_id = nullptr);
+      UUID* local_report_id,
+      const std::map<std::string, std::string>* client_annotations);
+
+  // Seals memfd and sends it with arguments to the crash_reporter listening
+  // on crash_reporter_socket_path_, connecting to it first if necessary.
+  bool SendToCrashReporter(int memfd,
+                           const std::vector<std::string>& arguments);
 
   CrashReportDatabase* database_;  // weak
   const std::map<std::string, std::string>* process_annotations_;  // weak
   const UserStreamDataSources* user_stream_data_sources_;  // weak
   base::FilePath dump_dir_;
+  base::FilePath crash_reporter_socket_path_;
+  ScopedFileHandle crash_reporter_socket_;
+  base::Lock crash_reporter_socket_lock_;
   bool always_allow_feedback_;
+  unsigned int module_snapshot_threads_;
+  unsigned int thread_snapshot_threads_;
+  bool unwind_stacks_;
+  bool capture_whole_allocations_;
+  unsigned int user_stream_threads_;
+  double user_stream_time_budget_;
 };
 
 }  // namespace crashpad
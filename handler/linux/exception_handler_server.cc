@@ -15,14 +15,25 @@
 #include "handler/linux/exception_handler_server.h"
 
 #include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
 #include <linux/capability.h>
+#include <linux/futex.h>
+#include <signal.h>
 #include <sys/epoll.h>
 #include <sys/eventfd.h>
+#include <sys/mman.h>
 #include <sys/socket.h>
+#include <sys/stat.h>
 #include <sys/syscall.h>
+#include <sys/timerfd.h>
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <iterator>
+#include <map>
+#include <string>
 #include <utility>
 
 #include "base/compiler_specific.h"
@@ -35,9 +46,30 @@
 #include "util/linux/proc_task_reader.h"
 #include "util/linux/socket.h"
 #include "util/misc/as_underlying_type.h"
+#include "util/misc/clock.h"
+#include "util/misc/metrics.h"
+#include "util/misc/time.h"
+#include "util/misc/trace_events.h"
+#include "util/thread/thread.h"
 
 namespace crashpad {
 
+bool ExceptionHandlerServer::Delegate::HandleHang(
+    pid_t client_process_id,
+    uid_t client_uid,
+    const std::vector<pid_t>& hung_thread_ids,
+    const std::map<std::string, std::string>* client_annotations) {
+  LOG(WARNING) << "hang in process " << client_process_id << " not handled";
+  return false;
+}
+
+bool ExceptionHandlerServer::Delegate::HandleStackSamplingRequest(
+    pid_t client_process_id,
+    uid_t client_uid) {
+  LOG(WARNING) << "stack sampling not supported";
+  return false;
+}
+
 namespace {
 
 // Log an error for a socket after an EPOLLERR.
@@ -144,6 +176,112 @@ void SendSIGCONT(pid_t pid, pid_t tid) {
   }
 }
 
+// Lets a client waiting on a CrashSignalSlot continue.
+void CompleteCrashSignal(ExceptionHandlerProtocol::CrashSignalSlot* slot) {
+  using CrashSignalSlot = ExceptionHandlerProtocol::CrashSignalSlot;
+
+  // The client may only reuse a slot once it is done, so nothing else can have
+  // changed a slot that this server is dumping, unless the client is
+  // misbehaving.
+  int32_t state = CrashSignalSlot::kStateDumping;
+  if (!__atomic_compare_exchange_n(&slot->state,
+                                   &state,
+                                   CrashSignalSlot::kStateDone,
+                                   false,
+                                   __ATOMIC_RELEASE,
+                                   __ATOMIC_RELAXED)) {
+    LOG(ERROR) << "unexpected crash signal state " << state;
+    return;
+  }
+  if (syscall(
+          SYS_futex, &slot->state, FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0) <
+      0) {
+    PLOG(ERROR) << "futex";
+  }
+}
+
+// Lets a client on a shared connection continue once its request has been
+// handled.
+void ResumeSharedClient(pid_t pid,
+                        pid_t tid,
+                        ExceptionHandlerProtocol::CrashSignalSlot* slot) {
+  if (slot) {
+    CompleteCrashSignal(slot);
+    return;
+  }
+  SendSIGCONT(pid, tid);
+}
+
+bool EnablePassCred(int sock) {
+  // The handler may not have permission to set SO_PASSCRED on the socket, but
+  // it doesn't need to if the client has already set it.
+  // https://bugs.chromium.org/p/crashpad/issues/detail?id=252
+  int optval;
+  socklen_t optlen = sizeof(optval);
+  if (getsockopt(sock, SOL_SOCKET, SO_PASSCRED, &optval, &optlen) != 0) {
+    PLOG(ERROR) << "getsockopt";
+    return false;
+  }
+  if (!optval) {
+    optval = 1;
+    optlen = sizeof(optval);
+    if (setsockopt(sock, SOL_SOCKET, SO_PASSCRED, &optval, optlen) != 0) {
+      PLOG(ERROR) << "setsockopt";
+      return false;
+    }
+  }
+  return true;
+}
+
+// Returns whether a shared memory object sent by a client can be mapped to
+// access size bytes. The object must be sealed so that it can’t be shrunk,
+// because a client could otherwise truncate it while it is mapped, making the
+// handler’s accesses to the mapping fault. Its size is checked after the seal,
+// so that it can’t change after the check.
+bool IsValidSharedRegion(int memfd, size_t size) {
+  const int seals = HANDLE_EINTR(fcntl(memfd, F_GET_SEALS));
+  if (seals < 0) {
+    PLOG(ERROR) << "fcntl F_GET_SEALS";
+    return false;
+  }
+  if (!(seals & F_SEAL_SHRINK)) {
+    LOG(ERROR) << "shared region not sealed";
+    return false;
+  }
+
+  struct stat st;
+  if (fstat(memfd, &st) != 0) {
+    PLOG(ERROR) << "fstat";
+    return false;
+  }
+  if (!S_ISREG(st.st_mode) || st.st_size < static_cast<off_t>(size)) {
+    LOG(ERROR) << "invalid shared region";
+    return false;
+  }
+  return true;
+}
+
+// Parses annotations serialized as for
+// ExceptionHandlerProtocol::ClientToServerMessage::kTypeSetAnnotations.
+bool ParseClientAnnotations(const std::string& serialized,
+                            std::map<std::string, std::string>* annotations) {
+  size_t offset = 0;
+  while (offset < serialized.size()) {
+    size_t key_end = serialized.find('\0', offset);
+    size_t value_end = key_end == std::string::npos
+                           ? std::string::npos
+                           : serialized.find('\0', key_end + 1);
+    if (value_end == std::string::npos || key_end == offset) {
+      LOG(ERROR) << "invalid annotations";
+      return false;
+    }
+    (*annotations)[serialized.substr(offset, key_end - offset)] =
+        serialized.substr(key_end + 1, value_end - key_end - 1);
+    offset = value_end + 1;
+  }
+  return true;
+}
+
 bool SendCredentials(int client_sock) {
   ExceptionHandlerProtocol::ServerToClientMessage message = {};
   message.type =
@@ -154,10 +292,18 @@ bool SendCredentials(int client_sock) {
 
 class PtraceStrategyDeciderImpl : public PtraceStrategyDecider {
  public:
-  PtraceStrategyDeciderImpl() : PtraceStrategyDecider() {}
+  PtraceStrategyDeciderImpl()
+      : PtraceStrategyDecider(),
+        ptracer_clients_(),
+        lock_(),
+        system_state_time_ns_(0),
+        ptrace_scope_(PtraceScope::kUnknown),
+        have_cap_sys_ptrace_(false),
+        have_system_state_(false) {}
   ~PtraceStrategyDeciderImpl() = default;
 
   Strategy ChooseStrategy(int sock,
+                          int connection,
                           bool multiple_clients,
                           const ucred& client_credentials) override {
     if (client_credentials.pid <= 0) {
@@ -165,9 +311,13 @@ class PtraceStrategyDeciderImpl : public PtraceStrategyDecider {
       return Strategy::kNoPtrace;
     }
 
-    switch (GetPtraceScope()) {
+    PtraceScope ptrace_scope;
+    bool have_cap_sys_ptrace;
+    GetSystemState(&ptrace_scope, &have_cap_sys_ptrace);
+
+    switch (ptrace_scope) {
       case PtraceScope::kClassic:
-        if (getuid() == client_credentials.uid || HaveCapSysPtrace()) {
+        if (getuid() == client_credentials.uid || have_cap_sys_ptrace) {
           return Strategy::kDirectPtrace;
         }
         return multiple_clients ? Strategy::kNoPtrace : TryForkingBroker(sock);
@@ -176,6 +326,14 @@ class PtraceStrategyDeciderImpl : public PtraceStrategyDecider {
         if (multiple_clients) {
           return Strategy::kDirectPtrace;
         }
+
+        // A client that has already made the handler its ptracer remains so
+        // for as long as it lives, which is at least as long as its
+        // connection.
+        if (IsPtracerClient(connection, client_credentials.pid)) {
+          return Strategy::kDirectPtrace;
+        }
+
         if (!SendMessageToClient(sock,
                                  ExceptionHandlerProtocol::
                                      ServerToClientMessage::kTypeSetPtracer)) {
@@ -192,10 +350,11 @@ class PtraceStrategyDeciderImpl : public PtraceStrategyDecider {
           PLOG(ERROR) << "Handler Client SetPtracer";
           return TryForkingBroker(sock);
         }
+        AddPtracerClient(connection, client_credentials.pid);
         return Strategy::kDirectPtrace;
 
       case PtraceScope::kAdminOnly:
-        if (HaveCapSysPtrace()) {
+        if (have_cap_sys_ptrace) {
           return Strategy::kDirectPtrace;
         }
         [[fallthrough]];
@@ -212,7 +371,46 @@ class PtraceStrategyDeciderImpl : public PtraceStrategyDecider {
     return Strategy::kError;
   }
 
+  void ClientDisconnected(int connection) override {
+    base::AutoLock lock(lock_);
+    ptracer_clients_.erase(connection);
+  }
+
  private:
+  // The number of seconds for which the ptrace scope and the handler’s
+  // capabilities are kept before they are checked again, so that changes to
+  // them are eventually picked up.
+  static constexpr uint64_t kSystemStateMaxAgeSeconds = 60;
+
+  void GetSystemState(PtraceScope* ptrace_scope, bool* have_cap_sys_ptrace) {
+    base::AutoLock lock(lock_);
+    const uint64_t now_ns = ClockMonotonicNanoseconds();
+    if (!have_system_state_ ||
+        now_ns - system_state_time_ns_ >=
+            kSystemStateMaxAgeSeconds * kNanosecondsPerSecond) {
+      ptrace_scope_ = GetPtraceScope();
+      have_cap_sys_ptrace_ = HaveCapSysPtrace();
+
+      // An unknown scope is the result of an error, which is retried next
+      // time rather than being remembered.
+      have_system_state_ = ptrace_scope_ != PtraceScope::kUnknown;
+      system_state_time_ns_ = now_ns;
+    }
+    *ptrace_scope = ptrace_scope_;
+    *have_cap_sys_ptrace = have_cap_sys_ptrace_;
+  }
+
+  bool IsPtracerClient(int connection, pid_t pid) {
+    base::AutoLock lock(lock_);
+    const auto it = ptracer_clients_.find(connection);
+    return it != ptracer_clients_.end() && it->second == pid;
+  }
+
+  void AddPtracerClient(int connection, pid_t pid) {
+    base::AutoLock lock(lock_);
+    ptracer_clients_[connection] = pid;
+  }
+
   static Strategy TryForkingBroker(int client_sock) {
     if (!SendMessageToClient(
             client_sock,
@@ -232,29 +430,134 @@ class PtraceStrategyDeciderImpl : public PtraceStrategyDecider {
     }
     return Strategy::kUseBroker;
   }
+
+  // The process on each connection that has made the handler its ptracer.
+  std::map<int, pid_t> ptracer_clients_;
+  base::Lock lock_;
+  uint64_t system_state_time_ns_;
+  PtraceScope ptrace_scope_;
+  bool have_cap_sys_ptrace_;
+  bool have_system_state_;
 };
 
 }  // namespace
 
+// Takes crash dump requests queued by the thread running
+// ExceptionHandlerServer::Run() and processes them until the server stops.
+class ExceptionHandlerServer::DumpWorker : public Thread {
+ public:
+  explicit DumpWorker(ExceptionHandlerServer* server)
+      : Thread(), server_(server) {}
+
+  DumpWorker(const DumpWorker&) = delete;
+  DumpWorker& operator=(const DumpWorker&) = delete;
+
+  ~DumpWorker() override {}
+
+ private:
+  // Thread:
+  void ThreadMain() override {
+    DumpRequest request;
+    while (server_->DequeueCrashDumpRequest(&request)) {
+      server_->ProcessCrashDumpRequest(request);
+      request.sock.reset();
+      request.crash_signal_region.reset();
+      request.annotations.reset();
+      request.hung_thread_ids.clear();
+    }
+  }
+
+  ExceptionHandlerServer* server_;  // weak
+};
+
 ExceptionHandlerServer::ExceptionHandlerServer()
     : clients_(),
       shutdown_event_(),
+      dump_complete_event_(),
       strategy_decider_(new PtraceStrategyDeciderImpl()),
+      simulated_dump_quota_(),
+      dump_workers_(),
+      pending_dumps_(),
+      completed_dumps_(),
+      dump_lock_(),
+      pending_dumps_semaphore_(0),
       delegate_(nullptr),
       pollfd_(),
+      max_concurrent_dumps_(1),
+      hang_poll_interval_ns_(0),
+      min_hang_dump_interval_ns_(0),
+      last_hang_dump_ns_(0),
       keep_running_(true) {}
 
-ExceptionHandlerServer::~ExceptionHandlerServer() = default;
+ExceptionHandlerServer::~ExceptionHandlerServer() {
+  DCHECK(dump_workers_.empty());
+}
 
 void ExceptionHandlerServer::SetPtraceStrategyDecider(
     std::unique_ptr<PtraceStrategyDecider> decider) {
   strategy_decider_ = std::move(decider);
 }
 
+void ExceptionHandlerServer::SetMaxConcurrentDumps(
+    size_t max_concurrent_dumps) {
+  DCHECK(dump_workers_.empty());
+  max_concurrent_dumps_ = max_concurrent_dumps;
+}
+
+void ExceptionHandlerServer::SetHangDetection(double poll_interval,
+                                              double min_dump_interval) {
+  DCHECK(!hang_poll_event_);
+  hang_poll_interval_ns_ =
+      poll_interval > 0 ? static_cast<uint64_t>(poll_interval * 1E9) : 0;
+  min_hang_dump_interval_ns_ =
+      min_dump_interval > 0 ? static_cast<uint64_t>(min_dump_interval * 1E9)
+                            : 0;
+}
+
+void ExceptionHandlerServer::SetSimulatedDumpLimit(
+    unsigned int dumps_per_minute) {
+  if (dumps_per_minute) {
+    simulated_dump_quota_ = std::make_unique<ClientDumpQuota>(dumps_per_minute);
+  } else {
+    simulated_dump_quota_.reset();
+  }
+}
+
 bool ExceptionHandlerServer::InitializeWithClient(ScopedFileHandle sock,
                                                   bool multiple_clients) {
   INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
 
+  if (!InitializePolling() ||
+      !InstallClientSocket(std::move(sock),
+                           multiple_clients ? Event::Type::kSharedSocketMessage
+                                            : Event::Type::kClientMessage)) {
+    return false;
+  }
+
+  INITIALIZATION_STATE_SET_VALID(initialized_);
+  return true;
+}
+
+bool ExceptionHandlerServer::InitializeWithListeningSocket(
+    ScopedFileHandle listen_sock) {
+  INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
+
+  if (!InitializePolling()) {
+    return false;
+  }
+
+  auto event = std::make_unique<Event>();
+  event->type = Event::Type::kListen;
+  event->fd.reset(listen_sock.release());
+  if (!InstallEvent(std::move(event))) {
+    return false;
+  }
+
+  INITIALIZATION_STATE_SET_VALID(initialized_);
+  return true;
+}
+
+bool ExceptionHandlerServer::InitializePolling() {
   pollfd_.reset(epoll_create1(EPOLL_CLOEXEC));
   if (!pollfd_.is_valid()) {
     PLOG(ERROR) << "epoll_create1";
@@ -280,13 +583,6 @@ bool ExceptionHandlerServer::InitializeWithClient(ScopedFileHandle sock,
     return false;
   }
 
-  if (!InstallClientSocket(std::move(sock),
-                           multiple_clients ? Event::Type::kSharedSocketMessage
-                                            : Event::Type::kClientMessage)) {
-    return false;
-  }
-
-  INITIALIZATION_STATE_SET_VALID(initialized_);
   return true;
 }
 
@@ -294,12 +590,20 @@ void ExceptionHandlerServer::Run(Delegate* delegate) {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
   delegate_ = delegate;
 
+  if (hang_poll_interval_ns_ > 0 && !StartHangPolling()) {
+    return;
+  }
+
+  if (max_concurrent_dumps_ > 1 && !StartDumpWorkers()) {
+    return;
+  }
+
   while (keep_running_ && clients_.size() > 0) {
     epoll_event poll_event;
     int res = HANDLE_EINTR(epoll_wait(pollfd_.get(), &poll_event, 1, -1));
     if (res < 0) {
       PLOG(ERROR) << "epoll_wait";
-      return;
+      break;
     }
     DCHECK_EQ(res, 1);
 
@@ -309,10 +613,16 @@ void ExceptionHandlerServer::Run(Delegate* delegate) {
         LogSocketError(eventp->fd.get());
       }
       keep_running_ = false;
+    } else if (eventp->type == Event::Type::kDumpComplete) {
+      HandleDumpCompletions();
+    } else if (eventp->type == Event::Type::kHangPoll) {
+      PollHangWatchdogs();
     } else {
       HandleEvent(eventp, poll_event.events);
     }
   }
+
+  StopDumpWorkers();
 }
 
 void ExceptionHandlerServer::Stop() {
@@ -323,6 +633,11 @@ void ExceptionHandlerServer::Stop() {
   }
 }
 
+size_t ExceptionHandlerServer::PendingDumpCount() {
+  base::AutoLock lock(dump_lock_);
+  return pending_dumps_.size();
+}
+
 void ExceptionHandlerServer::HandleEvent(Event* event, uint32_t event_type) {
   DCHECK_NE(AsUnderlyingType(event->type),
             AsUnderlyingType(Event::Type::kShutdown));
@@ -334,7 +649,14 @@ void ExceptionHandlerServer::HandleEvent(Event* event, uint32_t event_type) {
   }
 
   if (event_type & EPOLLIN) {
-    if (!ReceiveClientMessage(event)) {
+    if (event->type == Event::Type::kListen) {
+      AcceptClient(event);
+      return;
+    }
+    bool received = event->type == Event::Type::kCrashSignal
+                        ? ReceiveCrashSignal(event)
+                        : ReceiveClientMessage(event);
+    if (!received) {
       UninstallClientSocket(event);
     }
     return;
@@ -349,32 +671,235 @@ void ExceptionHandlerServer::HandleEvent(Event* event, uint32_t event_type) {
   return;
 }
 
-bool ExceptionHandlerServer::InstallClientSocket(ScopedFileHandle socket,
-                                                 Event::Type type) {
-  // The handler may not have permission to set SO_PASSCRED on the socket, but
-  // it doesn't need to if the client has already set it.
-  // https://bugs.chromium.org/p/crashpad/issues/detail?id=252
-  int optval;
-  socklen_t optlen = sizeof(optval);
-  if (getsockopt(socket.get(), SOL_SOCKET, SO_PASSCRED, &optval, &optlen) !=
-      0) {
-    PLOG(ERROR) << "getsockopt";
+bool ExceptionHandlerServer::StartDumpWorkers() {
+  DCHECK(dump_workers_.empty());
+
+  dump_complete_event_ = std::make_unique<Event>();
+  dump_complete_event_->type = Event::Type::kDumpComplete;
+  dump_complete_event_->fd.reset(eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK));
+  if (!dump_complete_event_->fd.is_valid()) {
+    PLOG(ERROR) << "eventfd";
     return false;
   }
-  if (!optval) {
-    optval = 1;
-    optlen = sizeof(optval);
-    if (setsockopt(socket.get(), SOL_SOCKET, SO_PASSCRED, &optval, optlen) !=
+
+  epoll_event poll_event;
+  poll_event.events = EPOLLIN;
+  poll_event.data.ptr = dump_complete_event_.get();
+  if (epoll_ctl(pollfd_.get(),
+                EPOLL_CTL_ADD,
+                dump_complete_event_->fd.get(),
+                &poll_event) != 0) {
+    PLOG(ERROR) << "epoll_ctl";
+    return false;
+  }
+
+  for (size_t index = 0; index < max_concurrent_dumps_; ++index) {
+    dump_workers_.push_back(std::make_unique<DumpWorker>(this));
+    dump_workers_.back()->Start();
+  }
+  return true;
+}
+
+void ExceptionHandlerServer::StopDumpWorkers() {
+  // Each worker returns once it finds the queue empty after a wakeup. Waking
+  // every worker once more than the number of queued requests lets them
+  // finish all requests that have already been received before exiting.
+  for (size_t index = 0; index < dump_workers_.size(); ++index) {
+    pending_dumps_semaphore_.Signal();
+  }
+  for (auto& worker : dump_workers_) {
+    worker->Join();
+  }
+  dump_workers_.clear();
+}
+
+bool ExceptionHandlerServer::EnqueueCrashDumpRequest(
+    Event* event,
+    const ucred& creds,
+    const ExceptionHandlerProtocol::ClientInformation& client_info,
+    VMAddress requesting_thread_stack_address,
+    ExceptionHandlerProtocol::CrashSignalSlot* crash_signal_slot) {
+  DumpRequest request;
+  request.creds = creds;
+  request.client_info = client_info;
+  request.requesting_thread_stack_address = requesting_thread_stack_address;
+  request.crash_signal_region = event->crash_signal_region;
+  request.crash_signal_slot = crash_signal_slot;
+  request.annotations = event->annotations;
+  request.multiple_clients = event->type != Event::Type::kClientMessage;
+  request.crash = !client_info.simulated;
+
+  request.sock.reset(HANDLE_EINTR(fcntl(event->fd.get(), F_DUPFD_CLOEXEC, 0)));
+  if (!request.sock.is_valid()) {
+    PLOG(ERROR) << "fcntl";
+    return false;
+  }
+  request.connection = event->fd.get();
+
+  if (request.multiple_clients) {
+    request.event = nullptr;
+  } else {
+    // A private socket is only used by one client, which waits for the dump
+    // to complete. Stop polling it so that the dump worker has exclusive use
+    // of it until the request completes.
+    if (epoll_ctl(pollfd_.get(), EPOLL_CTL_DEL, event->fd.get(), nullptr) !=
         0) {
-      PLOG(ERROR) << "setsockopt";
+      PLOG(ERROR) << "epoll_ctl";
       return false;
     }
+    request.event = event;
+  }
+
+  QueueDumpRequest(std::move(request));
+  return true;
+}
+
+bool ExceptionHandlerServer::EnqueueHangDumpRequest(
+    Event* event,
+    const ucred& creds,
+    const std::vector<pid_t>& hung_thread_ids) {
+  DumpRequest request;
+  request.creds = creds;
+  request.client_info = {};
+  request.requesting_thread_stack_address = 0;
+  request.crash_signal_slot = nullptr;
+  request.annotations = event->annotations;
+  request.hung_thread_ids = hung_thread_ids;
+  request.multiple_clients = true;
+  request.event = nullptr;
+  request.crash = false;
+
+  // The client isn't waiting on its socket, so nothing is sent on it, but the
+  // strategy decider is still given one.
+  request.sock.reset(HANDLE_EINTR(fcntl(event->fd.get(), F_DUPFD_CLOEXEC, 0)));
+  if (!request.sock.is_valid()) {
+    PLOG(ERROR) << "fcntl";
+    return false;
+  }
+  request.connection = event->fd.get();
+
+  QueueDumpRequest(std::move(request));
+  return true;
+}
+
+void ExceptionHandlerServer::QueueDumpRequest(DumpRequest request) {
+  {
+    base::AutoLock lock(dump_lock_);
+
+    // A dump of a crash is queued ahead of simulated and hang dumps, so that a
+    // client requesting many of those can’t delay the dumps of other clients’
+    // crashes. Otherwise, requests are handled in the order they’re received.
+    auto position = pending_dumps_.end();
+    if (request.crash) {
+      position = std::find_if(
+          pending_dumps_.begin(),
+          pending_dumps_.end(),
+          [](const DumpRequest& pending) { return !pending.crash; });
+    }
+    pending_dumps_.insert(position, std::move(request));
+  }
+  pending_dumps_semaphore_.Signal();
+}
+
+bool ExceptionHandlerServer::DequeueCrashDumpRequest(DumpRequest* request) {
+  pending_dumps_semaphore_.Wait();
+
+  base::AutoLock lock(dump_lock_);
+  if (pending_dumps_.empty()) {
+    return false;
+  }
+  *request = std::move(pending_dumps_.front());
+  pending_dumps_.pop_front();
+  return true;
+}
+
+void ExceptionHandlerServer::ProcessCrashDumpRequest(
+    const DumpRequest& request) {
+  if (!request.hung_thread_ids.empty()) {
+    DCHECK(!request.event);
+    HandleHangDumpRequest(request.creds,
+                          request.sock.get(),
+                          request.connection,
+                          request.hung_thread_ids,
+                          request.annotations.get());
+    return;
+  }
+
+  bool success = HandleCrashDumpRequest(request.creds,
+                                        request.client_info,
+                                        request.requesting_thread_stack_address,
+                                        request.sock.get(),
+                                        request.connection,
+                                        request.multiple_clients,
+                                        request.crash_signal_slot,
+                                        request.annotations.get());
+
+  // A failed request on a shared socket connection is not reported back, so
+  // that one misbehaving client does not disconnect every other client sharing
+  // the connection.
+  if (!request.event) {
+    return;
+  }
+
+  {
+    base::AutoLock lock(dump_lock_);
+    completed_dumps_.push_back({request.event, success});
+  }
+
+  uint64_t value = 1;
+  LoggingWriteFile(dump_complete_event_->fd.get(), &value, sizeof(value));
+}
+
+void ExceptionHandlerServer::HandleDumpCompletions() {
+  uint64_t value;
+  ssize_t rv = HANDLE_EINTR(
+      read(dump_complete_event_->fd.get(), &value, sizeof(value)));
+  if (rv < 0 && errno != EAGAIN) {
+    PLOG(ERROR) << "read";
+  }
+
+  std::vector<DumpCompletion> completions;
+  {
+    base::AutoLock lock(dump_lock_);
+    std::swap(completions, completed_dumps_);
+  }
+
+  for (const DumpCompletion& completion : completions) {
+    Event* event = completion.event;
+    if (completion.success) {
+      epoll_event poll_event;
+      poll_event.events = EPOLLIN | EPOLLRDHUP;
+      poll_event.data.ptr = event;
+      if (epoll_ctl(
+              pollfd_.get(), EPOLL_CTL_ADD, event->fd.get(), &poll_event) ==
+          0) {
+        continue;
+      }
+      PLOG(ERROR) << "epoll_ctl";
+    }
+
+    // The socket was removed from the poll set when the request was queued,
+    // so it only needs to be removed from clients_.
+    strategy_decider_->ClientDisconnected(event->fd.get());
+    if (clients_.erase(event->fd.get()) != 1) {
+      LOG(ERROR) << "event not found";
+    }
+  }
+}
+
+bool ExceptionHandlerServer::InstallClientSocket(ScopedFileHandle socket,
+                                                 Event::Type type) {
+  if (!EnablePassCred(socket.get())) {
+    return false;
   }
 
   auto event = std::make_unique<Event>();
   event->type = type;
   event->fd.reset(socket.release());
+  return InstallEvent(std::move(event));
+}
 
+bool ExceptionHandlerServer::InstallEvent(std::unique_ptr<Event> event) {
   Event* eventp = event.get();
 
   if (!clients_.insert(std::make_pair(event->fd.get(), std::move(event)))
@@ -403,6 +928,8 @@ bool ExceptionHandlerServer::UninstallClientSocket(Event* event) {
     return false;
   }
 
+  strategy_decider_->ClientDisconnected(event->fd.get());
+
   if (clients_.erase(event->fd.get()) != 1) {
     LOG(ERROR) << "event not found";
     return false;
@@ -411,11 +938,45 @@ bool ExceptionHandlerServer::UninstallClientSocket(Event* event) {
   return true;
 }
 
+void ExceptionHandlerServer::AcceptClient(Event* event) {
+  // A failure to accept one client only affects that client, so the listening
+  // socket isn't uninstalled.
+  ScopedFileHandle sock(HANDLE_EINTR(
+      accept4(event->fd.get(), nullptr, nullptr, SOCK_CLOEXEC)));
+  if (!sock.is_valid()) {
+    PLOG(ERROR) << "accept4";
+    return;
+  }
+
+  ucred creds;
+  socklen_t creds_len = sizeof(creds);
+  if (getsockopt(sock.get(), SOL_SOCKET, SO_PEERCRED, &creds, &creds_len) !=
+      0) {
+    PLOG(ERROR) << "getsockopt";
+    return;
+  }
+  if (creds.pid <= 0) {
+    LOG(ERROR) << "invalid peer credentials";
+    return;
+  }
+
+  if (!EnablePassCred(sock.get())) {
+    return;
+  }
+
+  auto client_event = std::make_unique<Event>();
+  client_event->type = Event::Type::kSharedSocketMessage;
+  client_event->fd.reset(sock.release());
+  client_event->creds = creds;
+  InstallEvent(std::move(client_event));
+}
+
 bool ExceptionHandlerServer::ReceiveClientMessage(Event* event) {
   ExceptionHandlerProtocol::ClientToServerMessage message;
   ucred creds;
+  std::vector<ScopedFileHandle> fds;
   if (!UnixCredentialSocket::RecvMsg(
-          event->fd.get(), &message, sizeof(message), &creds)) {
+          event->fd.get(), &message, sizeof(message), &creds, &fds)) {
     return false;
   }
 
@@ -424,12 +985,54 @@ bool ExceptionHandlerServer::ReceiveClientMessage(Event* event) {
       return SendCredentials(event->fd.get());
 
     case ExceptionHandlerProtocol::ClientToServerMessage::kTypeCrashDumpRequest:
+      if (!AdmitCrashDumpRequest(
+              creds,
+              message.client_info,
+              event->fd.get(),
+              event->type == Event::Type::kSharedSocketMessage,
+              nullptr)) {
+        return true;
+      }
+      if (!dump_workers_.empty()) {
+        return EnqueueCrashDumpRequest(event,
+                                       creds,
+                                       message.client_info,
+                                       message.requesting_thread_stack_address,
+                                       nullptr);
+      }
       return HandleCrashDumpRequest(
           creds,
           message.client_info,
           message.requesting_thread_stack_address,
           event->fd.get(),
-          event->type == Event::Type::kSharedSocketMessage);
+          event->fd.get(),
+          event->type == Event::Type::kSharedSocketMessage,
+          nullptr,
+          event->annotations.get());
+
+    case ExceptionHandlerProtocol::ClientToServerMessage::
+        kTypeRegisterCrashSignal:
+      // A failed registration only affects the registering client, which
+      // keeps using this socket, so the socket isn't uninstalled.
+      RegisterCrashSignal(event, creds, &fds);
+      return true;
+
+    case ExceptionHandlerProtocol::ClientToServerMessage::kTypeSetAnnotations:
+      // As above.
+      SetClientAnnotations(event, creds, &fds);
+      return true;
+
+    case ExceptionHandlerProtocol::ClientToServerMessage::
+        kTypeRegisterHangWatchdog:
+      // As above.
+      RegisterHangWatchdog(event, creds, &fds);
+      return true;
+
+    case ExceptionHandlerProtocol::ClientToServerMessage::
+        kTypeRequestStackSampling:
+      // As above.
+      RequestStackSampling(creds, event->fd.get());
+      return true;
   }
 
   DCHECK(false);
@@ -437,27 +1040,451 @@ bool ExceptionHandlerServer::ReceiveClientMessage(Event* event) {
   return false;
 }
 
+void ExceptionHandlerServer::RegisterCrashSignal(
+    Event* event,
+    const ucred& creds,
+    std::vector<ScopedFileHandle>* fds) {
+  using CrashSignalRegion = ExceptionHandlerProtocol::CrashSignalRegion;
+
+  if (fds->size() != 2) {
+    LOG(ERROR) << "unexpected fd count " << fds->size();
+    return;
+  }
+  ScopedFileHandle memfd(std::move((*fds)[0]));
+  ScopedFileHandle wake_sock(std::move((*fds)[1]));
+
+  auto region = std::make_shared<ScopedMmap>();
+  bool registered = false;
+  if (IsValidSharedRegion(memfd.get(), sizeof(CrashSignalRegion)) &&
+      region->ResetMmap(nullptr,
+                        sizeof(CrashSignalRegion),
+                        PROT_READ | PROT_WRITE,
+                        MAP_SHARED,
+                        memfd.get(),
+                        0)) {
+    auto signal_region = region->addr_as<CrashSignalRegion*>();
+    if (signal_region->version != CrashSignalRegion::kVersion) {
+      LOG(ERROR) << "unsupported crash signal region version "
+                 << signal_region->version;
+    } else if (creds.pid <= 0 || signal_region->pid != creds.pid) {
+      LOG(ERROR) << "crash signal region pid mismatch";
+    } else {
+      registered = true;
+    }
+  }
+
+  // Reply before installing the socket so that the reply can't be interleaved
+  // with a crash dump request.
+  ExceptionHandlerProtocol::ServerToClientMessage response = {};
+  response.type = registered ? ExceptionHandlerProtocol::ServerToClientMessage::
+                                   kTypeCrashSignalRegistered
+                             : ExceptionHandlerProtocol::ServerToClientMessage::
+                                   kTypeCrashSignalRejected;
+  if (!LoggingWriteFile(wake_sock.get(), &response, sizeof(response)) ||
+      !registered) {
+    return;
+  }
+
+  auto signal_event = std::make_unique<Event>();
+  signal_event->type = Event::Type::kCrashSignal;
+  signal_event->fd.reset(wake_sock.release());
+  signal_event->crash_signal_region = std::move(region);
+  signal_event->creds = creds;
+  signal_event->annotations = event->annotations;
+  InstallEvent(std::move(signal_event));
+}
+
+void ExceptionHandlerServer::SetClientAnnotations(
+    Event* event,
+    const ucred& creds,
+    std::vector<ScopedFileHandle>* fds) {
+  if (fds->size() != 1) {
+    LOG(ERROR) << "unexpected fd count " << fds->size();
+    return;
+  }
+  ScopedFileHandle memfd(std::move((*fds)[0]));
+
+  // Annotations apply to every client using a connection. On a connection
+  // accepted from a listening socket, only the process that connected may set
+  // them, and not a child forked from it. Other shared connections have no
+  // single owner.
+  if (event->type == Event::Type::kSharedSocketMessage &&
+      (event->creds.pid <= 0 || creds.pid != event->creds.pid)) {
+    LOG(ERROR) << "annotations not permitted on this connection";
+    return;
+  }
+
+  struct stat st;
+  if (fstat(memfd.get(), &st) != 0) {
+    PLOG(ERROR) << "fstat";
+    return;
+  }
+  if (!S_ISREG(st.st_mode) || st.st_size < 0 ||
+      static_cast<uint64_t>(st.st_size) >
+          ExceptionHandlerProtocol::kMaxClientAnnotationsSize) {
+    LOG(ERROR) << "invalid annotations size";
+    return;
+  }
+
+  std::string serialized(static_cast<size_t>(st.st_size), '\0');
+  if (!serialized.empty() &&
+      HANDLE_EINTR(pread(memfd.get(), &serialized[0], serialized.size(), 0)) !=
+          static_cast<ssize_t>(serialized.size())) {
+    PLOG(ERROR) << "pread";
+    return;
+  }
+
+  auto annotations = std::make_shared<std::map<std::string, std::string>>();
+  if (!ParseClientAnnotations(serialized, annotations.get())) {
+    return;
+  }
+  event->annotations = std::move(annotations);
+}
+
+void ExceptionHandlerServer::RegisterHangWatchdog(
+    Event* event,
+    const ucred& creds,
+    std::vector<ScopedFileHandle>* fds) {
+  using HangWatchdogRegion = ExceptionHandlerProtocol::HangWatchdogRegion;
+
+  if (fds->size() != 1) {
+    LOG(ERROR) << "unexpected fd count " << fds->size();
+    return;
+  }
+  ScopedFileHandle memfd(std::move((*fds)[0]));
+
+  if (!hang_poll_event_) {
+    LOG(WARNING) << "hang detection not enabled";
+    return;
+  }
+
+  if (!IsValidSharedRegion(memfd.get(), sizeof(HangWatchdogRegion))) {
+    return;
+  }
+
+  // The handler only reads the region, so that a misbehaving handler can't
+  // disturb the client.
+  auto watchdog = std::make_unique<HangWatchdog>();
+  if (!watchdog->region.ResetMmap(nullptr,
+                                  sizeof(HangWatchdogRegion),
+                                  PROT_READ,
+                                  MAP_SHARED,
+                                  memfd.get(),
+                                  0)) {
+    return;
+  }
+
+  auto region = watchdog->region.addr_as<const HangWatchdogRegion*>();
+  if (region->version != HangWatchdogRegion::kVersion) {
+    LOG(ERROR) << "unsupported hang watchdog region version "
+               << region->version;
+    return;
+  }
+  if (creds.pid <= 0 || region->pid != creds.pid) {
+    LOG(ERROR) << "hang watchdog region pid mismatch";
+    return;
+  }
+
+  watchdog->creds = creds;
+  for (uint64_t& heartbeat : watchdog->reported_heartbeats) {
+    heartbeat = 0;
+  }
+
+  // A process that registers again, such as after a fork() reused a process
+  // ID, replaces its earlier region.
+  event->hang_watchdogs[creds.pid] = std::move(watchdog);
+}
+
+void ExceptionHandlerServer::RequestStackSampling(const ucred& creds,
+                                                  int client_sock) {
+  // Samples are taken while the client runs, without its cooperation, so the
+  // strategies that need it aren’t available.
+  if (strategy_decider_->ChooseStrategy(
+          client_sock, client_sock, true, creds) !=
+      PtraceStrategyDecider::Strategy::kDirectPtrace) {
+    LOG(WARNING) << "stack sampling requires direct ptrace";
+    return;
+  }
+  delegate_->HandleStackSamplingRequest(creds.pid, creds.uid);
+}
+
+bool ExceptionHandlerServer::StartHangPolling() {
+  hang_poll_event_ = std::make_unique<Event>();
+  hang_poll_event_->type = Event::Type::kHangPoll;
+  hang_poll_event_->fd.reset(
+      timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC | TFD_NONBLOCK));
+  if (!hang_poll_event_->fd.is_valid()) {
+    PLOG(ERROR) << "timerfd_create";
+    hang_poll_event_.reset();
+    return false;
+  }
+
+  itimerspec interval;
+  interval.it_interval.tv_sec = hang_poll_interval_ns_ / 1000000000;
+  interval.it_interval.tv_nsec = hang_poll_interval_ns_ % 1000000000;
+  interval.it_value = interval.it_interval;
+  if (timerfd_settime(hang_poll_event_->fd.get(), 0, &interval, nullptr) !=
+      0) {
+    PLOG(ERROR) << "timerfd_settime";
+    hang_poll_event_.reset();
+    return false;
+  }
+
+  epoll_event poll_event;
+  poll_event.events = EPOLLIN;
+  poll_event.data.ptr = hang_poll_event_.get();
+  if (epoll_ctl(pollfd_.get(),
+                EPOLL_CTL_ADD,
+                hang_poll_event_->fd.get(),
+                &poll_event) != 0) {
+    PLOG(ERROR) << "epoll_ctl";
+    hang_poll_event_.reset();
+    return false;
+  }
+
+  return true;
+}
+
+void ExceptionHandlerServer::PollHangWatchdogs() {
+  uint64_t expirations;
+  ssize_t rv = HANDLE_EINTR(
+      read(hang_poll_event_->fd.get(), &expirations, sizeof(expirations)));
+  if (rv < 0 && errno != EAGAIN) {
+    PLOG(ERROR) << "read";
+  }
+
+  const uint64_t now_ns = ClockMonotonicNanoseconds();
+  if (last_hang_dump_ns_ != 0 &&
+      now_ns - last_hang_dump_ns_ < min_hang_dump_interval_ns_) {
+    return;
+  }
+
+  for (auto& client : clients_) {
+    Event* event = client.second.get();
+    for (auto iterator = event->hang_watchdogs.begin();
+         iterator != event->hang_watchdogs.end();) {
+      HangWatchdog* watchdog = iterator->second.get();
+
+      // Clients don’t unregister, so stop watching those that have exited.
+      if (kill(watchdog->creds.pid, 0) != 0 && errno == ESRCH) {
+        iterator = event->hang_watchdogs.erase(iterator);
+        continue;
+      }
+      ++iterator;
+
+      if (CheckHangWatchdog(event, watchdog, now_ns)) {
+        // Rate-limited, so at most one hang is dumped per poll.
+        last_hang_dump_ns_ = now_ns;
+        return;
+      }
+    }
+  }
+}
+
+bool ExceptionHandlerServer::CheckHangWatchdog(Event* event,
+                                               HangWatchdog* watchdog,
+                                               uint64_t now_ns) {
+  using HangWatchdogThread = ExceptionHandlerProtocol::HangWatchdogThread;
+
+  auto region = watchdog->region.addr_as<
+      const ExceptionHandlerProtocol::HangWatchdogRegion*>();
+  for (size_t index = 0; index < std::size(region->threads); ++index) {
+    const HangWatchdogThread& thread = region->threads[index];
+    if (__atomic_load_n(&thread.state, __ATOMIC_ACQUIRE) !=
+        HangWatchdogThread::kStateWatched) {
+      continue;
+    }
+
+    // The client may change an entry at any time, so each field is read once
+    // and the values aren’t trusted beyond choosing which threads to note in
+    // the report.
+    const uint64_t heartbeat_ns =
+        __atomic_load_n(&thread.heartbeat_ns, __ATOMIC_RELAXED);
+    const uint64_t timeout_ns =
+        static_cast<uint64_t>(
+            __atomic_load_n(&thread.timeout_ms, __ATOMIC_RELAXED)) *
+        1000000;
+    if (now_ns < heartbeat_ns || now_ns - heartbeat_ns < timeout_ns ||
+        watchdog->reported_heartbeats[index] == heartbeat_ns) {
+      continue;
+    }
+
+    const pid_t thread_id =
+        __atomic_load_n(&thread.thread_id, __ATOMIC_RELAXED);
+    const pid_t blocking_thread_id =
+        __atomic_load_n(&thread.blocking_thread_id, __ATOMIC_RELAXED);
+    if (thread_id <= 0) {
+      continue;
+    }
+    watchdog->reported_heartbeats[index] = heartbeat_ns;
+
+    std::vector<pid_t> hung_thread_ids(1, thread_id);
+    if (blocking_thread_id > 0 && blocking_thread_id != thread_id) {
+      hung_thread_ids.push_back(blocking_thread_id);
+    }
+
+    if (!dump_workers_.empty()) {
+      EnqueueHangDumpRequest(event, watchdog->creds, hung_thread_ids);
+    } else {
+      HandleHangDumpRequest(watchdog->creds,
+                            event->fd.get(),
+                            event->fd.get(),
+                            hung_thread_ids,
+                            event->annotations.get());
+    }
+    return true;
+  }
+  return false;
+}
+
+bool ExceptionHandlerServer::HandleHangDumpRequest(
+    const ucred& creds,
+    int client_sock,
+    int connection,
+    const std::vector<pid_t>& hung_thread_ids,
+    const std::map<std::string, std::string>* client_annotations) {
+  TraceEvents::ScopedContext trace_context(creds.pid);
+  TraceEvents::ScopedEvent request_event("HangDumpRequest");
+
+  // The client hasn’t asked for a dump and isn’t waiting for a reply, so the
+  // strategies that need its cooperation aren’t available.
+  PtraceStrategyDecider::Strategy strategy;
+  {
+    TraceEvents::ScopedEvent accept_event("Accept");
+    strategy = strategy_decider_->ChooseStrategy(
+        client_sock, connection, true, creds);
+  }
+  if (strategy != PtraceStrategyDecider::Strategy::kDirectPtrace) {
+    LOG(WARNING) << "hang dump requires direct ptrace";
+    return false;
+  }
+  return delegate_->HandleHang(
+      creds.pid, creds.uid, hung_thread_ids, client_annotations);
+}
+
+bool ExceptionHandlerServer::ReceiveCrashSignal(Event* event) {
+  using CrashSignalSlot = ExceptionHandlerProtocol::CrashSignalSlot;
+
+  // Each request writes one byte, but the slots are checked for all pending
+  // requests at once.
+  char wakes[ExceptionHandlerProtocol::CrashSignalRegion::kSlotCount];
+  ssize_t rv =
+      HANDLE_EINTR(recv(event->fd.get(), wakes, sizeof(wakes), MSG_DONTWAIT));
+  if (rv == 0) {
+    return false;
+  }
+  if (rv < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
+    PLOG(ERROR) << "recv";
+    return false;
+  }
+
+  auto signal_region =
+      event->crash_signal_region
+          ->addr_as<ExceptionHandlerProtocol::CrashSignalRegion*>();
+  for (CrashSignalSlot& slot : signal_region->slots) {
+    int32_t state = CrashSignalSlot::kStateRequested;
+    if (!__atomic_compare_exchange_n(&slot.state,
+                                     &state,
+                                     CrashSignalSlot::kStateDumping,
+                                     false,
+                                     __ATOMIC_ACQUIRE,
+                                     __ATOMIC_RELAXED)) {
+      continue;
+    }
+
+    // The client doesn't touch a slot while it is being dumped, unless it is
+    // misbehaving, but copy the request so that it can't change while in use.
+    const ExceptionHandlerProtocol::ClientInformation client_info =
+        slot.client_info;
+    const VMAddress requesting_thread_stack_address =
+        slot.requesting_thread_stack_address;
+
+    if (!AdmitCrashDumpRequest(
+            event->creds, client_info, event->fd.get(), true, &slot)) {
+      continue;
+    }
+    if (!dump_workers_.empty()) {
+      if (!EnqueueCrashDumpRequest(event,
+                                   event->creds,
+                                   client_info,
+                                   requesting_thread_stack_address,
+                                   &slot)) {
+        CompleteCrashSignal(&slot);
+      }
+      continue;
+    }
+    HandleCrashDumpRequest(event->creds,
+                           client_info,
+                           requesting_thread_stack_address,
+                           event->fd.get(),
+                           event->fd.get(),
+                           true,
+                           &slot,
+                           event->annotations.get());
+  }
+  return true;
+}
+
+bool ExceptionHandlerServer::AdmitCrashDumpRequest(
+    const ucred& creds,
+    const ExceptionHandlerProtocol::ClientInformation& client_info,
+    int client_sock,
+    bool multiple_clients,
+    ExceptionHandlerProtocol::CrashSignalSlot* crash_signal_slot) {
+  if (!client_info.simulated || !simulated_dump_quota_ ||
+      simulated_dump_quota_->TakeDump(creds.pid,
+                                      ClockMonotonicNanoseconds())) {
+    return true;
+  }
+
+  // The request is declined as a dump that couldn’t be taken would be. This
+  // isn’t logged, so that a client over its limit doesn’t flood the log.
+  Metrics::ExceptionCaptureResult(
+      Metrics::CaptureResult::kSkippedDueToClientQuota);
+  if (multiple_clients) {
+    ResumeSharedClient(creds.pid, -1, crash_signal_slot);
+  } else {
+    SendMessageToClient(
+        client_sock,
+        ExceptionHandlerProtocol::ServerToClientMessage::kTypeCrashDumpFailed);
+  }
+  return false;
+}
+
 bool ExceptionHandlerServer::HandleCrashDumpRequest(
     const ucred& creds,
     const ExceptionHandlerProtocol::ClientInformation& client_info,
     VMAddress requesting_thread_stack_address,
     int client_sock,
-    bool multiple_clients) {
+    int connection,
+    bool multiple_clients,
+    ExceptionHandlerProtocol::CrashSignalSlot* crash_signal_slot,
+    const std::map<std::string, std::string>* client_annotations) {
   pid_t client_process_id = creds.pid;
   pid_t requesting_thread_id = -1;
   uid_t client_uid = creds.uid;
 
-  switch (
-      strategy_decider_->ChooseStrategy(client_sock, multiple_clients, creds)) {
+  TraceEvents::ScopedContext trace_context(client_process_id);
+  TraceEvents::ScopedEvent request_event("CrashDumpRequest");
+
+  PtraceStrategyDecider::Strategy strategy;
+  {
+    TraceEvents::ScopedEvent accept_event("Accept");
+    strategy = strategy_decider_->ChooseStrategy(
+        client_sock, connection, multiple_clients, creds);
+  }
+  switch (strategy) {
     case PtraceStrategyDecider::Strategy::kError:
       if (multiple_clients) {
-        SendSIGCONT(client_process_id, requesting_thread_id);
+        ResumeSharedClient(
+            client_process_id, requesting_thread_id, crash_signal_slot);
       }
       return false;
 
     case PtraceStrategyDecider::Strategy::kNoPtrace:
       if (multiple_clients) {
-        SendSIGCONT(client_process_id, requesting_thread_id);
+        ResumeSharedClient(
+            client_process_id, requesting_thread_id, crash_signal_slot);
         return true;
       }
       return SendMessageToClient(
@@ -470,9 +1497,12 @@ bool ExceptionHandlerServer::HandleCrashDumpRequest(
                                  client_uid,
                                  client_info,
                                  requesting_thread_stack_address,
-                                 &requesting_thread_id);
+                                 &requesting_thread_id,
+                                 nullptr,
+                                 client_annotations);
       if (multiple_clients) {
-        SendSIGCONT(client_process_id, requesting_thread_id);
+        ResumeSharedClient(
+            client_process_id, requesting_thread_id, crash_signal_slot);
         return true;
       }
       break;
@@ -480,8 +1510,12 @@ bool ExceptionHandlerServer::HandleCrashDumpRequest(
 
     case PtraceStrategyDecider::Strategy::kUseBroker:
       DCHECK(!multiple_clients);
-      delegate_->HandleExceptionWithBroker(
-          client_process_id, client_uid, client_info, client_sock);
+      delegate_->HandleExceptionWithBroker(client_process_id,
+                                           client_uid,
+                                           client_info,
+                                           client_sock,
+                                           nullptr,
+                                           client_annotations);
       break;
   }
 
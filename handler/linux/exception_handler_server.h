@@ -19,14 +19,22 @@
 #include <sys/socket.h>
 
 #include <atomic>
+#include <deque>
+#include <map>
 #include <memory>
+#include <string>
 #include <unordered_map>
+#include <vector>
 
+#include "base/synchronization/lock.h"
+#include "handler/linux/client_dump_quota.h"
 #include "util/file/file_io.h"
 #include "util/linux/exception_handler_protocol.h"
 #include "util/misc/address_types.h"
 #include "util/misc/initialization_state_dcheck.h"
 #include "util/misc/uuid.h"
+#include "util/posix/scoped_mmap.h"
+#include "util/synchronization/semaphore.h"
 
 namespace crashpad {
 
@@ -54,14 +62,27 @@ class PtraceStrategyDecider {
   //! \brief Chooses an appropriate `ptrace` strategy.
   //!
   //! \param[in] sock A socket conncted to a ExceptionHandlerClient.
+  //! \param[in] connection The socket that the server polls for the
+  //!     connection that the request arrived on, which identifies the
+  //!     connection until it is passed to ClientDisconnected(). \a sock may be
+  //!     a duplicate of it, and only \a sock may be used for I/O.
   //! \param[in] multiple_clients `true` if the socket is connected to multiple
   //!     clients. The broker is not supported in this configuration.
   //! \param[in] client_credentials The credentials for the connected client.
   //! \return the chosen #Strategy.
   virtual Strategy ChooseStrategy(int sock,
+                                  int connection,
                                   bool multiple_clients,
                                   const ucred& client_credentials) = 0;
 
+  //! \brief Called when a connection previously passed to ChooseStrategy() is
+  //!     closed, so that anything remembered about its client can be
+  //!     forgotten.
+  //!
+  //! \param[in] connection The connection, which may be reused for another
+  //!     connection once this method returns.
+  virtual void ClientDisconnected(int connection) {}
+
  protected:
   PtraceStrategyDecider() = default;
 };
@@ -70,6 +91,12 @@ class PtraceStrategyDecider {
 //!     process.
 class ExceptionHandlerServer {
  public:
+  //! \brief The interface to which ExceptionHandlerServer forwards dump
+  //!     requests.
+  //!
+  //! If SetMaxConcurrentDumps() has been called with a value greater than 1,
+  //! the methods of this interface may be called concurrently from multiple
+  //! dump worker threads, and implementations must be thread-safe.
   class Delegate {
    public:
     //! \brief Called on receipt of a crash dump request from a client.
@@ -85,6 +112,10 @@ class ExceptionHandlerServer {
     //!     ID could not be determined. Optional.
     //! \param[out] local_report_id The unique identifier for the report created
     //!     in the local report database. Optional.
+    //! \param[in] client_annotations Annotations set by the client with
+    //!     ExceptionHandlerProtocol::ClientToServerMessage::kTypeSetAnnotations,
+    //!     which take precedence over the handler's own process annotations.
+    //!     Optional.
     //! \return `true` on success. `false` on failure with a message logged.
     virtual bool HandleException(
         pid_t client_process_id,
@@ -92,7 +123,9 @@ class ExceptionHandlerServer {
         const ExceptionHandlerProtocol::ClientInformation& info,
         VMAddress requesting_thread_stack_address = 0,
         pid_t* requesting_thread_id = nullptr,
-        UUID* local_report_id = nullptr) = 0;
+        UUID* local_report_id = nullptr,
+        const std::map<std::string, std::string>* client_annotations =
+            nullptr) = 0;
 
     //! \brief Called on the receipt of a crash dump request from a client for a
     //!     crash that should be mediated by a PtraceBroker.
@@ -103,13 +136,50 @@ class ExceptionHandlerServer {
     //! \param[in] broker_sock A socket connected to the PtraceBroker.
     //! \param[out] local_report_id The unique identifier for the report created
     //!     in the local report database. Optional.
+    //! \param[in] client_annotations Annotations set by the client, as for
+    //!     HandleException(). Optional.
     //! \return `true` on success. `false` on failure with a message logged.
     virtual bool HandleExceptionWithBroker(
         pid_t client_process_id,
         uid_t client_uid,
         const ExceptionHandlerProtocol::ClientInformation& info,
         int broker_sock,
-        UUID* local_report_id = nullptr) = 0;
+        UUID* local_report_id = nullptr,
+        const std::map<std::string, std::string>* client_annotations =
+            nullptr) = 0;
+
+    //! \brief Called when a thread of a client watched for hangs has gone
+    //!     longer than its timeout without a heartbeat.
+    //!
+    //! Only called for clients that the handler may `ptrace` directly. The
+    //! default implementation logs a message and returns `false`.
+    //!
+    //! \param[in] client_process_id The process ID of the hung client.
+    //! \param[in] client_uid The user ID of the hung client.
+    //! \param[in] hung_thread_ids The thread ID of the hung thread, followed
+    //!     by that of the thread it was waiting for, if it set one.
+    //! \param[in] client_annotations Annotations set by the client, as for
+    //!     HandleException(). Optional.
+    //! \return `true` on success. `false` on failure with a message logged.
+    virtual bool HandleHang(
+        pid_t client_process_id,
+        uid_t client_uid,
+        const std::vector<pid_t>& hung_thread_ids,
+        const std::map<std::string, std::string>* client_annotations =
+            nullptr);
+
+    //! \brief Called when a client asks for the stacks of its threads to be
+    //!     sampled.
+    //!
+    //! Only called for clients that the handler may `ptrace` directly. The
+    //! default implementation logs a message and returns `false`.
+    //!
+    //! \param[in] client_process_id The process ID of the client.
+    //! \param[in] client_uid The user ID of the client.
+    //! \return `true` if the client will be sampled. `false` otherwise, with a
+    //!     message logged.
+    virtual bool HandleStackSamplingRequest(pid_t client_process_id,
+                                            uid_t client_uid);
 
     virtual ~Delegate() {}
   };
@@ -127,6 +197,60 @@ class ExceptionHandlerServer {
   //! used.
   void SetPtraceStrategyDecider(std::unique_ptr<PtraceStrategyDecider> decider);
 
+  //! \brief Sets the maximum number of crash dumps that may be in progress at
+  //!     once.
+  //!
+  //! By default, crash dump requests are handled one at a time on the thread
+  //! that calls Run(). When \a max_concurrent_dumps is greater than 1, Run()
+  //! starts that many dump worker threads and hands crash dump requests to
+  //! them, so that a slow dump of one client does not delay dumps of other
+  //! clients. Requests received while all workers are busy are queued.
+  //!
+  //! This method must be called before Run().
+  //!
+  //! \param[in] max_concurrent_dumps The number of dump worker threads to use.
+  //!     Values of 0 and 1 both handle dumps on the Run() thread.
+  void SetMaxConcurrentDumps(size_t max_concurrent_dumps);
+
+  //! \brief Watches the threads of clients that register a
+  //!     ExceptionHandlerProtocol::HangWatchdogRegion for hangs.
+  //!
+  //! Registered regions are polled every \a poll_interval seconds, which only
+  //! reads memory shared with the clients. When a watched thread has gone
+  //! longer than its timeout without a heartbeat, Delegate::HandleHang() is
+  //! called for its client, at most once for each time the thread stops making
+  //! progress. Hang dumps of all clients are rate-limited to one every \a
+  //! min_dump_interval seconds. By default, clients aren’t watched for hangs.
+  //!
+  //! This method must be called before Run().
+  //!
+  //! \param[in] poll_interval The number of seconds between polls, or `0` to
+  //!     not watch for hangs.
+  //! \param[in] min_dump_interval The least number of seconds between hang
+  //!     dumps.
+  void SetHangDetection(double poll_interval, double min_dump_interval);
+
+  //! \brief Limits how often each client may request dumps without having
+  //!     crashed.
+  //!
+  //! Requests marked ExceptionHandlerProtocol::ClientInformation::simulated,
+  //! such as those made by CrashpadClient::DumpWithoutCrash(), are allowed up
+  //! to \a dumps_per_minute times a minute for each client process, with a
+  //! ClientDumpQuota. A request over the limit is declined without a dump
+  //! being taken, and the client continues as if the handler had failed to
+  //! take it. Dumps of crashes are never limited. By default, simulated dumps
+  //! aren’t limited.
+  //!
+  //! Independent of this limit, when dump worker threads are in use, queued
+  //! requests for dumps of crashes are handled before queued requests for
+  //! simulated and hang dumps.
+  //!
+  //! This method must be called before Run().
+  //!
+  //! \param[in] dumps_per_minute The number of simulated dumps each client
+  //!     may request per minute, or `0` for no limit.
+  void SetSimulatedDumpLimit(unsigned int dumps_per_minute);
+
   //! \brief Initializes this object.
   //!
   //! This method must be successfully called before Run().
@@ -138,11 +262,30 @@ class ExceptionHandlerServer {
   //! \return `true` on success. `false` on failure with a message logged.
   bool InitializeWithClient(ScopedFileHandle sock, bool multiple_clients);
 
+  //! \brief Initializes this object to accept clients as they connect.
+  //!
+  //! Each accepted connection is handled as one shared by multiple clients,
+  //! so that children forked from a connecting process may use it too. The
+  //! credentials of the connecting process are taken from `SO_PEERCRED`, and
+  //! only that process may set annotations for the connection with
+  //! ExceptionHandlerProtocol::ClientToServerMessage::kTypeSetAnnotations.
+  //!
+  //! Either this method or InitializeWithClient() must be successfully called
+  //! before Run(). Run() keeps running after all clients have disconnected,
+  //! until Stop() is called.
+  //!
+  //! \param[in] listen_sock A listening socket, such as one created by
+  //!     UnixCredentialSocket::CreateCredentialListeningSocket().
+  //! \return `true` on success. `false` on failure with a message logged.
+  bool InitializeWithListeningSocket(ScopedFileHandle listen_sock);
+
   //! \brief Runs the exception-handling server.
   //!
   //! This method must only be called once on an ExceptionHandlerServer object.
   //! This method returns when there are no more client connections or Stop()
-  //! has been called.
+  //! has been called. If dump worker threads are in use, crash dump requests
+  //! that have already been received are completed before this method
+  //! returns.
   //!
   //! \param[in] delegate An object to send exceptions to.
   void Run(Delegate* delegate);
@@ -155,7 +298,24 @@ class ExceptionHandlerServer {
   //! returned, or to call Stop() after it has already been called.
   void Stop();
 
+  //! \brief Returns the number of dump requests that have been received but
+  //!     not yet taken by a dump worker thread.
+  //!
+  //! This method may be called from any thread.
+  size_t PendingDumpCount();
+
  private:
+  // A client’s registered HangWatchdogRegion.
+  struct HangWatchdog {
+    ScopedMmap region;
+    ucred creds;
+
+    // For each thread in the region, the heartbeat at which it was last found
+    // hung, so that each hang is only dumped once.
+    uint64_t reported_heartbeats
+        [ExceptionHandlerProtocol::HangWatchdogRegion::kThreadCount];
+  };
+
   struct Event {
     enum class Type {
       // Used by Stop() to shutdown the server.
@@ -165,29 +325,168 @@ class ExceptionHandlerServer {
       kClientMessage,
 
       // A message from a client on a shared socket connection.
-      kSharedSocketMessage
+      kSharedSocketMessage,
+
+      // Signaled by a dump worker when a crash dump request has completed.
+      kDumpComplete,
+
+      // A wakeup from a client that has requested a crash dump through its
+      // CrashSignalRegion.
+      kCrashSignal,
+
+      // A new connection on a listening socket.
+      kListen,
+
+      // The timer at which registered HangWatchdogRegions are polled.
+      kHangPoll
     };
 
     Type type;
     ScopedFileHandle fd;
+
+    // For kCrashSignal, the client's mapped CrashSignalRegion, shared with any
+    // queued DumpRequests made through it, and the client's credentials when
+    // the region was registered.
+    std::shared_ptr<ScopedMmap> crash_signal_region;
+
+    // For kCrashSignal, as above. For a connection accepted on a listening
+    // socket, the credentials of the connecting process. Otherwise, zeroed.
+    ucred creds;
+
+    // Annotations set by the client, shared with any queued DumpRequests.
+    // A kCrashSignal event takes these from its connection when registered.
+    std::shared_ptr<const std::map<std::string, std::string>> annotations;
+
+    // HangWatchdogRegions registered on this connection, by the process ID of
+    // the client that registered each.
+    std::map<pid_t, std::unique_ptr<HangWatchdog>> hang_watchdogs;
+  };
+
+  // A crash dump request waiting for or being processed by a dump worker.
+  struct DumpRequest {
+    ucred creds;
+    ExceptionHandlerProtocol::ClientInformation client_info;
+    VMAddress requesting_thread_stack_address;
+
+    // A duplicate of the client's socket, so that the request remains valid
+    // even if the client's Event is uninstalled while the request is queued.
+    ScopedFileHandle sock;
+
+    // The client's socket itself, which identifies its connection to the
+    // PtraceStrategyDecider. This is not used for I/O.
+    int connection;
+
+    // The client's Event, which is removed from the poll set until the
+    // request completes. nullptr for requests on a shared socket connection,
+    // which keeps being polled while requests from it are processed.
+    Event* event;
+
+    // For requests made through a CrashSignalRegion, the region and the slot
+    // to complete when the request is done. The region stays mapped until the
+    // request completes.
+    std::shared_ptr<ScopedMmap> crash_signal_region;
+    ExceptionHandlerProtocol::CrashSignalSlot* crash_signal_slot;
+
+    std::shared_ptr<const std::map<std::string, std::string>> annotations;
+
+    // For a hang dump, the threads to pass to Delegate::HandleHang().
+    // Otherwise, empty.
+    std::vector<pid_t> hung_thread_ids;
+
+    bool multiple_clients;
+
+    // Whether this is a dump of a crash, rather than a simulated or hang dump.
+    // Dumps of crashes are queued ahead of other dumps.
+    bool crash;
+  };
+
+  // The result of a DumpRequest on a private client socket, returned to the
+  // thread running Run() so that the client socket can be re-armed or
+  // uninstalled.
+  struct DumpCompletion {
+    Event* event;
+    bool success;
   };
 
+  class DumpWorker;
+
+  bool InitializePolling();
+  bool StartDumpWorkers();
+  void StopDumpWorkers();
+  bool EnqueueCrashDumpRequest(
+      Event* event,
+      const ucred& creds,
+      const ExceptionHandlerProtocol::ClientInformation& client_info,
+      VMAddress requesting_thread_stack_address,
+      ExceptionHandlerProtocol::CrashSignalSlot* crash_signal_slot);
+  bool EnqueueHangDumpRequest(Event* event,
+                              const ucred& creds,
+                              const std::vector<pid_t>& hung_thread_ids);
+  void QueueDumpRequest(DumpRequest request);
+  bool DequeueCrashDumpRequest(DumpRequest* request);
+  void ProcessCrashDumpRequest(const DumpRequest& request);
+  void HandleDumpCompletions();
   void HandleEvent(Event* event, uint32_t event_type);
   bool InstallClientSocket(ScopedFileHandle socket, Event::Type type);
+  bool InstallEvent(std::unique_ptr<Event> event);
   bool UninstallClientSocket(Event* event);
+  void AcceptClient(Event* event);
   bool ReceiveClientMessage(Event* event);
+  void RegisterCrashSignal(Event* event,
+                           const ucred& creds,
+                           std::vector<ScopedFileHandle>* fds);
+  void SetClientAnnotations(Event* event,
+                            const ucred& creds,
+                            std::vector<ScopedFileHandle>* fds);
+  void RegisterHangWatchdog(Event* event,
+                            const ucred& creds,
+                            std::vector<ScopedFileHandle>* fds);
+  bool StartHangPolling();
+  void RequestStackSampling(const ucred& creds, int client_sock);
+  void PollHangWatchdogs();
+  bool CheckHangWatchdog(Event* event,
+                         HangWatchdog* watchdog,
+                         uint64_t now_ns);
+  bool HandleHangDumpRequest(
+      const ucred& creds,
+      int client_sock,
+      int connection,
+      const std::vector<pid_t>& hung_thread_ids,
+      const std::map<std::string, std::string>* client_annotations);
+  bool ReceiveCrashSignal(Event* event);
+  bool AdmitCrashDumpRequest(
+      const ucred& creds,
+      const ExceptionHandlerProtocol::ClientInformation& client_info,
+      int client_sock,
+      bool multiple_clients,
+      ExceptionHandlerProtocol::CrashSignalSlot* crash_signal_slot);
   bool HandleCrashDumpRequest(
       const ucred& creds,
       const ExceptionHandlerProtocol::ClientInformation& client_info,
       VMAddress requesting_thread_stack_address,
       int client_sock,
-      bool multiple_clients);
+      int connection,
+      bool multiple_clients,
+      ExceptionHandlerProtocol::CrashSignalSlot* crash_signal_slot,
+      const std::map<std::string, std::string>* client_annotations);
 
   std::unordered_map<int, std::unique_ptr<Event>> clients_;
   std::unique_ptr<Event> shutdown_event_;
+  std::unique_ptr<Event> dump_complete_event_;
+  std::unique_ptr<Event> hang_poll_event_;
   std::unique_ptr<PtraceStrategyDecider> strategy_decider_;
+  std::unique_ptr<ClientDumpQuota> simulated_dump_quota_;
+  std::vector<std::unique_ptr<DumpWorker>> dump_workers_;
+  std::deque<DumpRequest> pending_dumps_;
+  std::vector<DumpCompletion> completed_dumps_;
+  base::Lock dump_lock_;
+  Semaphore pending_dumps_semaphore_;
   Delegate* delegate_;
   ScopedFileHandle pollfd_;
+  size_t max_concurrent_dumps_;
+  uint64_t hang_poll_interval_ns_;
+  uint64_t min_hang_dump_interval_ns_;
+  uint64_t last_hang_dump_ns_;
   std::atomic<bool> keep_running_;
   InitializationStateDcheck initialized_;
 };
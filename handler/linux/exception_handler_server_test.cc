@@ -14,9 +14,21 @@
 
 #include "handler/linux/exception_handler_server.h"
 
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/posix/eintr_wrapper.h"
+#include "base/strings/stringprintf.h"
+#include "base/synchronization/lock.h"
 #include "build/build_config.h"
 #include "gtest/gtest.h"
 #include "snapshot/linux/process_snapshot_linux.h"
@@ -26,7 +38,10 @@
 #include "util/linux/exception_handler_client.h"
 #include "util/linux/ptrace_client.h"
 #include "util/linux/scoped_pr_set_ptracer.h"
+#include "util/linux/socket.h"
+#include "util/misc/clock.h"
 #include "util/misc/uuid.h"
+#include "util/posix/scoped_mmap.h"
 #include "util/synchronization/semaphore.h"
 #include "util/thread/thread.h"
 
@@ -93,7 +108,12 @@ class ScopedStopServerAndJoinThread {
 class TestDelegate : public ExceptionHandlerServer::Delegate {
  public:
   TestDelegate()
-      : Delegate(), last_exception_address_(0), last_client_(-1), sem_(0) {}
+      : Delegate(),
+        last_exception_address_(0),
+        last_client_(-1),
+        sem_(0),
+        last_hung_client_(-1),
+        hang_sem_(0) {}
 
   TestDelegate(const TestDelegate&) = delete;
   TestDelegate& operator=(const TestDelegate&) = delete;
@@ -117,13 +137,18 @@ class TestDelegate : public ExceptionHandlerServer::Delegate {
                        const ExceptionHandlerProtocol::ClientInformation& info,
                        VMAddress requesting_thread_stack_address,
                        pid_t* requesting_thread_id = nullptr,
-                       UUID* local_report_id = nullptr) override {
+                       UUID* local_report_id = nullptr,
+                       const std::map<std::string, std::string>*
+                           client_annotations = nullptr) override {
     DirectPtraceConnection connection;
     bool connected = connection.Initialize(client_process_id);
     EXPECT_TRUE(connected);
 
     last_exception_address_ = info.exception_information_address;
     last_client_ = client_process_id;
+    last_annotations_ = client_annotations
+                            ? *client_annotations
+                            : std::map<std::string, std::string>();
     sem_.Signal();
     if (!connected) {
       return false;
@@ -150,21 +175,58 @@ class TestDelegate : public ExceptionHandlerServer::Delegate {
       uid_t client_uid,
       const ExceptionHandlerProtocol::ClientInformation& info,
       int broker_sock,
-      UUID* local_report_id = nullptr) override {
+      UUID* local_report_id = nullptr,
+      const std::map<std::string, std::string>* client_annotations =
+          nullptr) override {
     PtraceClient client;
     bool connected = client.Initialize(broker_sock, client_process_id);
     EXPECT_TRUE(connected);
 
     last_exception_address_ = info.exception_information_address,
     last_client_ = client_process_id;
+    last_annotations_ = client_annotations
+                            ? *client_annotations
+                            : std::map<std::string, std::string>();
     sem_.Signal();
     return connected;
   }
 
+  bool WaitForHang(double timeout_seconds,
+                   pid_t* last_client,
+                   std::vector<pid_t>* last_thread_ids) {
+    if (hang_sem_.TimedWait(timeout_seconds)) {
+      *last_client = last_hung_client_;
+      *last_thread_ids = last_hung_thread_ids_;
+      return true;
+    }
+
+    return false;
+  }
+
+  bool HandleHang(pid_t client_process_id,
+                  uid_t client_uid,
+                  const std::vector<pid_t>& hung_thread_ids,
+                  const std::map<std::string, std::string>* client_annotations =
+                      nullptr) override {
+    last_hung_client_ = client_process_id;
+    last_hung_thread_ids_ = hung_thread_ids;
+    hang_sem_.Signal();
+    return true;
+  }
+
+  // Valid after WaitForException() returns true.
+  const std::map<std::string, std::string>& last_annotations() const {
+    return last_annotations_;
+  }
+
  private:
+  std::map<std::string, std::string> last_annotations_;
   VMAddress last_exception_address_;
   pid_t last_client_;
   Semaphore sem_;
+  std::vector<pid_t> last_hung_thread_ids_;
+  pid_t last_hung_client_;
+  Semaphore hang_sem_;
 };
 
 class MockPtraceStrategyDecider : public PtraceStrategyDecider {
@@ -179,6 +241,7 @@ class MockPtraceStrategyDecider : public PtraceStrategyDecider {
   ~MockPtraceStrategyDecider() {}
 
   Strategy ChooseStrategy(int sock,
+                          int connection,
                           bool multiple_clients,
                           const ucred& client_credentials) override {
     if (strategy_ == Strategy::kUseBroker) {
@@ -208,6 +271,51 @@ class MockPtraceStrategyDecider : public PtraceStrategyDecider {
   Strategy strategy_;
 };
 
+// Chooses direct ptrace, and records the connections that it is given.
+class RecordingPtraceStrategyDecider : public PtraceStrategyDecider {
+ public:
+  RecordingPtraceStrategyDecider()
+      : PtraceStrategyDecider(), lock_(), chosen_(), disconnected_() {}
+
+  RecordingPtraceStrategyDecider(const RecordingPtraceStrategyDecider&) =
+      delete;
+  RecordingPtraceStrategyDecider& operator=(
+      const RecordingPtraceStrategyDecider&) = delete;
+
+  ~RecordingPtraceStrategyDecider() {}
+
+  Strategy ChooseStrategy(int sock,
+                          int connection,
+                          bool multiple_clients,
+                          const ucred& client_credentials) override {
+    base::AutoLock lock(lock_);
+    chosen_.push_back(connection);
+    return Strategy::kDirectPtrace;
+  }
+
+  void ClientDisconnected(int connection) override {
+    base::AutoLock lock(lock_);
+    disconnected_.push_back(connection);
+  }
+
+  // The connections passed to ChooseStrategy().
+  std::vector<int> chosen() {
+    base::AutoLock lock(lock_);
+    return chosen_;
+  }
+
+  // The connections passed to ClientDisconnected().
+  std::vector<int> disconnected() {
+    base::AutoLock lock(lock_);
+    return disconnected_;
+  }
+
+ private:
+  base::Lock lock_;
+  std::vector<int> chosen_;
+  std::vector<int> disconnected_;
+};
+
 class ExceptionHandlerServerTest : public testing::TestWithParam<bool> {
  public:
   ExceptionHandlerServerTest()
@@ -235,8 +343,13 @@ class ExceptionHandlerServerTest : public testing::TestWithParam<bool> {
 
   class CrashDumpTest : public Multiprocess {
    public:
-    CrashDumpTest(ExceptionHandlerServerTest* server_test, bool succeeds)
-        : Multiprocess(), server_test_(server_test), succeeds_(succeeds) {}
+    CrashDumpTest(ExceptionHandlerServerTest* server_test,
+                  bool succeeds,
+                  bool use_crash_signal_region = false)
+        : Multiprocess(),
+          server_test_(server_test),
+          succeeds_(succeeds),
+          use_crash_signal_region_(use_crash_signal_region) {}
 
     CrashDumpTest(const CrashDumpTest&) = delete;
     CrashDumpTest& operator=(const CrashDumpTest&) = delete;
@@ -274,12 +387,89 @@ class ExceptionHandlerServerTest : public testing::TestWithParam<bool> {
 
       ExceptionHandlerClient client(server_test_->SockToHandler(),
                                     server_test_->use_multi_client_socket_);
-      ASSERT_EQ(client.RequestCrashDump(info), 0);
+      if (!use_crash_signal_region_) {
+        ASSERT_EQ(client.RequestCrashDump(info), 0);
+        return;
+      }
+
+      ScopedMmap region;
+      ScopedFileHandle wake_sock;
+      ASSERT_TRUE(client.RegisterCrashSignalRegion(&region, &wake_sock));
+
+      // Without a socket, the request can only be made through the region.
+      ExceptionHandlerClient region_client(
+          -1, server_test_->use_multi_client_socket_);
+      region_client.SetCrashSignalRegion(
+          region.addr_as<ExceptionHandlerProtocol::CrashSignalRegion*>(),
+          wake_sock.get());
+      ASSERT_EQ(region_client.RequestCrashDump(info), 0);
     }
 
    private:
     ExceptionHandlerServerTest* server_test_;
     bool succeeds_;
+    bool use_crash_signal_region_;
+  };
+
+  class HangTest : public Multiprocess {
+   public:
+    explicit HangTest(ExceptionHandlerServerTest* server_test)
+        : Multiprocess(), server_test_(server_test) {}
+
+    HangTest(const HangTest&) = delete;
+    HangTest& operator=(const HangTest&) = delete;
+
+    ~HangTest() = default;
+
+    void MultiprocessParent() override {
+      pid_t thread_ids[2];
+      ASSERT_TRUE(LoggingReadFileExactly(
+          ReadPipeHandle(), thread_ids, sizeof(thread_ids)));
+
+      pid_t last_client;
+      std::vector<pid_t> last_thread_ids;
+      ASSERT_TRUE(server_test_->Delegate()->WaitForHang(
+          5.0, &last_client, &last_thread_ids));
+      EXPECT_EQ(last_client, ChildPID());
+      ASSERT_EQ(last_thread_ids.size(), 2u);
+      EXPECT_EQ(last_thread_ids[0], thread_ids[0]);
+      EXPECT_EQ(last_thread_ids[1], thread_ids[1]);
+
+      // Each hang is only reported once.
+      EXPECT_FALSE(server_test_->Delegate()->WaitForHang(
+          0.1, &last_client, &last_thread_ids));
+    }
+
+    void MultiprocessChild() override {
+      using HangWatchdogThread = ExceptionHandlerProtocol::HangWatchdogThread;
+
+      ASSERT_EQ(close(server_test_->sock_to_client_), 0);
+
+      ExceptionHandlerClient client(server_test_->SockToHandler(),
+                                    server_test_->use_multi_client_socket_);
+      ScopedMmap region;
+      ASSERT_TRUE(client.RegisterHangWatchdogRegion(&region));
+
+      // This thread is watched and stops making progress, waiting for a
+      // thread that doesn’t need to exist for the hang to be reported.
+      pid_t thread_ids[2] = {static_cast<pid_t>(syscall(SYS_gettid)), 1};
+      HangWatchdogThread& thread =
+          region.addr_as<ExceptionHandlerProtocol::HangWatchdogRegion*>()
+              ->threads[0];
+      thread.thread_id = thread_ids[0];
+      thread.timeout_ms = 1;
+      thread.blocking_thread_id = thread_ids[1];
+      thread.heartbeat_ns = ClockMonotonicNanoseconds();
+      __atomic_store_n(
+          &thread.state, HangWatchdogThread::kStateWatched, __ATOMIC_RELEASE);
+
+      ASSERT_TRUE(
+          LoggingWriteFile(WritePipeHandle(), thread_ids, sizeof(thread_ids)));
+      CheckedReadFileAtEOF(ReadPipeHandle());
+    }
+
+   private:
+    ExceptionHandlerServerTest* server_test_;
   };
 
   void ExpectCrashDumpUsingStrategy(PtraceStrategyDecider::Strategy strategy,
@@ -373,11 +563,213 @@ TEST_P(ExceptionHandlerServerTest, RequestCrashDumpError) {
   ExpectCrashDumpUsingStrategy(PtraceStrategyDecider::Strategy::kError, false);
 }
 
+TEST_P(ExceptionHandlerServerTest, RequestCrashDumpWithDumpWorkers) {
+  Server()->SetMaxConcurrentDumps(2);
+
+  ScopedStopServerAndJoinThread stop_server(Server(), ServerThread());
+  ServerThread()->Start();
+
+  // Make more than one request on the same connection to check that the
+  // connection is serviced again after each dump completes.
+  for (int request = 0; request < 3; ++request) {
+    SCOPED_TRACE(request);
+    CrashDumpTest test(this, true);
+    test.Run();
+  }
+}
+
+TEST_P(ExceptionHandlerServerTest, StrategyConnectionWithDumpWorkers) {
+  auto decider = std::make_unique<RecordingPtraceStrategyDecider>();
+  RecordingPtraceStrategyDecider* const decider_ptr = decider.get();
+  Server()->SetPtraceStrategyDecider(std::move(decider));
+  Server()->SetMaxConcurrentDumps(2);
+
+  ServerThread()->Start();
+
+  for (int request = 0; request < 3; ++request) {
+    SCOPED_TRACE(request);
+    CrashDumpTest test(this, true);
+    test.Run();
+  }
+
+  // The server stops once its only client disconnects.
+  Hangup();
+  ASSERT_TRUE(ServerThread()->JoinWithTimeout(5.0));
+
+  // Each request on the connection is identified to the decider by the same
+  // connection, although a dump worker handles it through a duplicate of the
+  // socket, and that is the connection reported as disconnected, so that
+  // anything the decider remembers about the client is forgotten.
+  const std::vector<int> chosen = decider_ptr->chosen();
+  ASSERT_EQ(chosen.size(), 3u);
+  EXPECT_EQ(chosen[1], chosen[0]);
+  EXPECT_EQ(chosen[2], chosen[0]);
+  EXPECT_EQ(decider_ptr->disconnected(), std::vector<int>(1, chosen[0]));
+}
+
+TEST_P(ExceptionHandlerServerTest, RequestCrashDumpThroughCrashSignalRegion) {
+  ScopedStopServerAndJoinThread stop_server(Server(), ServerThread());
+  ServerThread()->Start();
+
+  CrashDumpTest test(this, true, true);
+  test.Run();
+}
+
+TEST_P(ExceptionHandlerServerTest, UnsealedCrashSignalRegionRejected) {
+  using CrashSignalRegion = ExceptionHandlerProtocol::CrashSignalRegion;
+
+  ScopedStopServerAndJoinThread stop_server(Server(), ServerThread());
+  ServerThread()->Start();
+
+  // The region is valid, except that it could be shrunk while the handler has
+  // it mapped.
+  ScopedFileHandle memfd(
+      HANDLE_EINTR(memfd_create("crashpad_test", MFD_CLOEXEC)));
+  ASSERT_TRUE(memfd.is_valid()) << ErrnoMessage("memfd_create");
+  ASSERT_EQ(HANDLE_EINTR(ftruncate(memfd.get(), sizeof(CrashSignalRegion))), 0)
+      << ErrnoMessage("ftruncate");
+  ScopedMmap region;
+  ASSERT_TRUE(region.ResetMmap(nullptr,
+                               sizeof(CrashSignalRegion),
+                               PROT_READ | PROT_WRITE,
+                               MAP_SHARED,
+                               memfd.get(),
+                               0));
+  region.addr_as<CrashSignalRegion*>()->version = CrashSignalRegion::kVersion;
+  region.addr_as<CrashSignalRegion*>()->pid = getpid();
+
+  int socks[2];
+  ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, socks), 0)
+      << ErrnoMessage("socketpair");
+  ScopedFileHandle local_sock(socks[0]);
+  ScopedFileHandle handler_sock(socks[1]);
+
+  ExceptionHandlerProtocol::ClientToServerMessage message = {};
+  message.type =
+      ExceptionHandlerProtocol::ClientToServerMessage::kTypeRegisterCrashSignal;
+  const int fds[] = {memfd.get(), handler_sock.get()};
+  ASSERT_EQ(UnixCredentialSocket::SendMsg(
+                SockToHandler(), &message, sizeof(message), fds, 2),
+            0);
+  handler_sock.reset();
+
+  ExceptionHandlerProtocol::ServerToClientMessage response;
+  ASSERT_TRUE(
+      LoggingReadFileExactly(local_sock.get(), &response, sizeof(response)));
+  EXPECT_EQ(response.type,
+            ExceptionHandlerProtocol::ServerToClientMessage::
+                kTypeCrashSignalRejected);
+}
+
+TEST_P(ExceptionHandlerServerTest,
+       RequestCrashDumpThroughCrashSignalRegionWithDumpWorkers) {
+  Server()->SetMaxConcurrentDumps(2);
+
+  ScopedStopServerAndJoinThread stop_server(Server(), ServerThread());
+  ServerThread()->Start();
+
+  CrashDumpTest test(this, true, true);
+  test.Run();
+}
+
+TEST_P(ExceptionHandlerServerTest, StopWithDumpWorkers) {
+  Server()->SetMaxConcurrentDumps(4);
+  ServerThread()->Start();
+  Server()->Stop();
+  ASSERT_TRUE(ServerThread()->JoinWithTimeout(5.0));
+}
+
+TEST_P(ExceptionHandlerServerTest, HangDetection) {
+  Server()->SetPtraceStrategyDecider(std::make_unique<MockPtraceStrategyDecider>(
+      PtraceStrategyDecider::Strategy::kDirectPtrace));
+  Server()->SetHangDetection(0.01, 0);
+
+  ScopedStopServerAndJoinThread stop_server(Server(), ServerThread());
+  ServerThread()->Start();
+
+  HangTest test(this);
+  test.Run();
+}
+
 INSTANTIATE_TEST_SUITE_P(ExceptionHandlerServerTestSuite,
                          ExceptionHandlerServerTest,
                          testing::Bool()
 );
 
+class DaemonCrashDumpTest : public Multiprocess {
+ public:
+  DaemonCrashDumpTest(TestDelegate* delegate, const std::string& socket_name)
+      : Multiprocess(), delegate_(delegate), socket_name_(socket_name) {}
+
+  DaemonCrashDumpTest(const DaemonCrashDumpTest&) = delete;
+  DaemonCrashDumpTest& operator=(const DaemonCrashDumpTest&) = delete;
+
+  ~DaemonCrashDumpTest() = default;
+
+ private:
+  void MultiprocessParent() override {
+    ExceptionHandlerProtocol::ClientInformation info;
+    ASSERT_TRUE(LoggingReadFileExactly(ReadPipeHandle(), &info, sizeof(info)));
+
+    VMAddress last_address;
+    pid_t last_client;
+    ASSERT_TRUE(delegate_->WaitForException(5.0, &last_client, &last_address));
+    EXPECT_EQ(last_address, info.exception_information_address);
+    EXPECT_EQ(last_client, ChildPID());
+    EXPECT_EQ(delegate_->last_annotations(), Annotations());
+  }
+
+  void MultiprocessChild() override {
+    ExceptionHandlerProtocol::ClientInformation info;
+    info.exception_information_address = 42;
+    ASSERT_TRUE(LoggingWriteFile(WritePipeHandle(), &info, sizeof(info)));
+
+    ScopedFileHandle sock;
+    ucred handler_creds;
+    ASSERT_TRUE(UnixCredentialSocket::ConnectCredentialSocket(
+        socket_name_, &sock, &handler_creds));
+    EXPECT_EQ(handler_creds.pid, getppid());
+
+    ScopedPrSetPtracer set_ptracer(handler_creds.pid, /* may_log= */ true);
+
+    // Children forked from a client share its connection to the daemon.
+    ExceptionHandlerClient client(sock.get(), true);
+    ASSERT_TRUE(client.SetAnnotations(Annotations()));
+    ASSERT_EQ(client.RequestCrashDump(info), 0);
+  }
+
+  std::map<std::string, std::string> Annotations() const {
+    return {{"prod", "daemon_test"}, {"empty", ""}};
+  }
+
+  TestDelegate* delegate_;
+  std::string socket_name_;
+};
+
+TEST(ExceptionHandlerServerDaemon, RequestCrashDumpWithAnnotations) {
+  const std::string socket_name =
+      base::StringPrintf("crashpad_daemon_test_%d", getpid());
+  ScopedFileHandle listen_sock;
+  ASSERT_TRUE(UnixCredentialSocket::CreateCredentialListeningSocket(
+      socket_name, &listen_sock));
+
+  ExceptionHandlerServer server;
+  ASSERT_TRUE(server.InitializeWithListeningSocket(std::move(listen_sock)));
+
+  TestDelegate delegate;
+  RunServerThread server_thread(&server, &delegate);
+  ScopedStopServerAndJoinThread stop_server(&server, &server_thread);
+  server_thread.Start();
+
+  // Each client has its own connection, so the server keeps running for the
+  // next one after a client disconnects.
+  for (int client = 0; client < 2; ++client) {
+    SCOPED_TRACE(client);
+    DaemonCrashDumpTest test(&delegate, socket_name);
+    test.Run();
+  }
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace crashpad
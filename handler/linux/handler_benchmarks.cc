@@ -0,0 +1,665 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Measures the end-to-end latency of producing a crash report on Linux.
+//
+// Each iteration forks a client process with a configurable number of
+// threads, loaded modules, and heap allocations, connects it to an
+// ExceptionHandlerServer running in this process with a real
+// CrashReportExceptionHandler, and has the client request a dump, either with
+// CRASHPAD_SIMULATE_CRASH() or by crashing. Both the direct ptrace strategy and
+// the PtraceBroker strategy are measured.
+//
+// For each combination, the following are reported as percentiles over all
+// iterations:
+//  - Client stopped: from the dump request until the client resumes, for a
+//    simulated crash, or until it has terminated, for a real crash.
+//  - Report on disk: from the dump request until the crash report has been
+//    written to the database.
+//  - Handler CPU: CPU time consumed by this process while handling the
+//    request. This doesn’t include time spent in a PtraceBroker, which runs in
+//    a process forked from the client.
+
+#include <dlfcn.h>
+#include <getopt.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/files/file_path.h"
+#include "base/logging.h"
+#include "base/posix/eintr_wrapper.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/stringprintf.h"
+#include "client/crash_report_database.h"
+#include "client/crashpad_client.h"
+#include "client/simulate_crash.h"
+#include "handler/linux/crash_report_exception_handler.h"
+#include "handler/linux/exception_handler_server.h"
+#include "test/scoped_temp_dir.h"
+#include "test/test_paths.h"
+#include "util/file/file_io.h"
+#include "util/linux/exception_handler_protocol.h"
+#include "util/synchronization/semaphore.h"
+#include "util/thread/thread.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+struct Options {
+  size_t threads;
+  size_t modules;
+  size_t heap_size;
+  size_t iterations;
+  size_t module_snapshot_threads;
+  size_t thread_snapshot_threads;
+  base::FilePath module;
+};
+
+void Usage(const std::string& me) {
+  // clang-format off
+  fprintf(stderr,
+"Usage: %s [OPTION]...\n"
+"Benchmark producing crash reports from a client process.\n"
+"\n"
+"      --heap-size=N           bytes of client heap, in 1 MiB blocks\n"
+"                              (default 64 MiB)\n"
+"      --iterations=N          repetitions of each benchmark (default 20)\n"
+"      --module=PATH           the loadable module to load copies of (default\n"
+"                              crashpad_snapshot_test_module.so)\n"
+"      --module-snapshot-threads=N\n"
+"                              threads used to read module snapshots\n"
+"                              (default 1)\n"
+"      --modules=N             copies of the module loaded by the client\n"
+"                              (default 100)\n"
+"      --thread-snapshot-threads=N\n"
+"                              threads used to gather client thread\n"
+"                              information (default 1)\n"
+"      --threads=N             threads started by the client (default 32)\n"
+"      --help                  display this help and exit\n",
+          me.c_str());
+  // clang-format on
+}
+
+uint64_t MonotonicNanoseconds() {
+  timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return static_cast<uint64_t>(now.tv_sec) * 1000000000 + now.tv_nsec;
+}
+
+uint64_t ProcessCPUNanoseconds() {
+  timespec now;
+  clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &now);
+  return static_cast<uint64_t>(now.tv_sec) * 1000000000 + now.tv_nsec;
+}
+
+// Forces the use of a particular ptrace strategy. When the broker is
+// requested, asks the client to fork one.
+class ForcedPtraceStrategyDecider : public PtraceStrategyDecider {
+ public:
+  explicit ForcedPtraceStrategyDecider(Strategy strategy)
+      : PtraceStrategyDecider(), strategy_(strategy) {}
+
+  ForcedPtraceStrategyDecider(const ForcedPtraceStrategyDecider&) = delete;
+  ForcedPtraceStrategyDecider& operator=(const ForcedPtraceStrategyDecider&) =
+      delete;
+
+  ~ForcedPtraceStrategyDecider() override {}
+
+  // PtraceStrategyDecider:
+  Strategy ChooseStrategy(int sock,
+                          int connection,
+                          bool multiple_clients,
+                          const ucred& client_credentials) override {
+    if (strategy_ != Strategy::kUseBroker) {
+      return strategy_;
+    }
+
+    ExceptionHandlerProtocol::ServerToClientMessage message = {};
+    message.type =
+        ExceptionHandlerProtocol::ServerToClientMessage::kTypeForkBroker;
+
+    ExceptionHandlerProtocol::Errno status;
+    if (!LoggingWriteFile(sock, &message, sizeof(message)) ||
+        !LoggingReadFileExactly(sock, &status, sizeof(status))) {
+      return Strategy::kError;
+    }
+
+    if (status != 0) {
+      errno = status;
+      PLOG(ERROR) << "ForkBroker";
+      return Strategy::kError;
+    }
+    return strategy_;
+  }
+
+ private:
+  Strategy strategy_;
+};
+
+// Passes requests to a CrashReportExceptionHandler, recording when each
+// finishes and the CPU time it took.
+class TimingDelegate : public ExceptionHandlerServer::Delegate {
+ public:
+  explicit TimingDelegate(ExceptionHandlerServer::Delegate* delegate)
+      : Delegate(),
+        delegate_(delegate),
+        reported_ns_(0),
+        cpu_ns_(0),
+        succeeded_(false) {}
+
+  TimingDelegate(const TimingDelegate&) = delete;
+  TimingDelegate& operator=(const TimingDelegate&) = delete;
+
+  ~TimingDelegate() override {}
+
+  uint64_t reported_ns() const { return reported_ns_; }
+  uint64_t cpu_ns() const { return cpu_ns_; }
+  bool succeeded() const { return succeeded_; }
+
+  // ExceptionHandlerServer::Delegate:
+  bool HandleException(pid_t client_process_id,
+                       uid_t client_uid,
+                       const ExceptionHandlerProtocol::ClientInformation& info,
+                       VMAddress requesting_thread_stack_address,
+                       pid_t* requesting_thread_id,
+                       UUID* local_report_id,
+                       const std::map<std::string, std::string>*
+                           client_annotations) override {
+    const uint64_t cpu_start = ProcessCPUNanoseconds();
+    bool rv = delegate_->HandleException(client_process_id,
+                                         client_uid,
+                                         info,
+                                         requesting_thread_stack_address,
+                                         requesting_thread_id,
+                                         local_report_id,
+                                         client_annotations);
+    Record(rv, cpu_start);
+    return rv;
+  }
+
+  bool HandleExceptionWithBroker(
+      pid_t client_process_id,
+      uid_t client_uid,
+      const ExceptionHandlerProtocol::ClientInformation& info,
+      int broker_sock,
+      UUID* local_report_id,
+      const std::map<std::string, std::string>* client_annotations) override {
+    const uint64_t cpu_start = ProcessCPUNanoseconds();
+    bool rv = delegate_->HandleExceptionWithBroker(client_process_id,
+                                                   client_uid,
+                                                   info,
+                                                   broker_sock,
+                                                   local_report_id,
+                                                   client_annotations);
+    Record(rv, cpu_start);
+    return rv;
+  }
+
+ private:
+  void Record(bool succeeded, uint64_t cpu_start) {
+    reported_ns_ = MonotonicNanoseconds();
+    cpu_ns_ = ProcessCPUNanoseconds() - cpu_start;
+    succeeded_ = succeeded;
+  }
+
+  ExceptionHandlerServer::Delegate* delegate_;  // weak
+  uint64_t reported_ns_;
+  uint64_t cpu_ns_;
+  bool succeeded_;
+};
+
+// Runs the ExceptionHandlerServer on a background thread.
+class RunServerThread : public Thread {
+ public:
+  RunServerThread(ExceptionHandlerServer* server,
+                  ExceptionHandlerServer::Delegate* delegate)
+      : server_(server), delegate_(delegate) {}
+
+  RunServerThread(const RunServerThread&) = delete;
+  RunServerThread& operator=(const RunServerThread&) = delete;
+
+  ~RunServerThread() override {}
+
+ private:
+  // Thread:
+  void ThreadMain() override { server_->Run(delegate_); }
+
+  ExceptionHandlerServer* server_;
+  ExceptionHandlerServer::Delegate* delegate_;
+};
+
+// A client thread that waits until the client exits.
+class IdleThread : public Thread {
+ public:
+  IdleThread(Semaphore* started, Semaphore* exit)
+      : started_(started), exit_(exit) {}
+
+  IdleThread(const IdleThread&) = delete;
+  IdleThread& operator=(const IdleThread&) = delete;
+
+  ~IdleThread() override {}
+
+ private:
+  // Thread:
+  void ThreadMain() override {
+    started_->Signal();
+    exit_->Wait();
+  }
+
+  Semaphore* started_;  // weak
+  Semaphore* exit_;  // weak
+};
+
+// Sets up the client’s threads, modules, and heap, requests a dump, and writes
+// the time of the request to write_fd. For a simulated crash, also writes the
+// time that the client resumed and exits. Otherwise, crashes.
+[[noreturn]] void RunClient(const Options& options,
+                            const std::vector<base::FilePath>& modules,
+                            bool crash,
+                            ScopedFileHandle sock,
+                            FileHandle write_fd) {
+  Semaphore started(0);
+  Semaphore exit(0);
+  std::vector<std::unique_ptr<IdleThread>> threads;
+  for (size_t index = 0; index < options.threads; ++index) {
+    threads.push_back(std::make_unique<IdleThread>(&started, &exit));
+    threads.back()->Start();
+  }
+  for (size_t index = 0; index < options.threads; ++index) {
+    started.Wait();
+  }
+
+  for (const base::FilePath& module : modules) {
+    if (!dlopen(module.value().c_str(), RTLD_NOW | RTLD_LOCAL)) {
+      LOG(ERROR) << "dlopen " << module.value() << ": " << dlerror();
+      _exit(EXIT_FAILURE);
+    }
+  }
+
+  // Allocations of this size are satisfied by separate mappings, so the heap
+  // adds to the number of mappings the handler reads as well as to the size of
+  // the process.
+  constexpr size_t kHeapAllocationSize = 1024 * 1024;
+  std::vector<std::unique_ptr<char[]>> heap;
+  for (size_t allocated = 0; allocated < options.heap_size;
+       allocated += kHeapAllocationSize) {
+    heap.push_back(std::make_unique<char[]>(kHeapAllocationSize));
+    memset(heap.back().get(), 'h', kHeapAllocationSize);
+  }
+
+  CrashpadClient client;
+  if (!client.SetHandlerSocket(std::move(sock), getppid())) {
+    _exit(EXIT_FAILURE);
+  }
+
+  const uint64_t requested_ns = MonotonicNanoseconds();
+  if (!LoggingWriteFile(write_fd, &requested_ns, sizeof(requested_ns))) {
+    _exit(EXIT_FAILURE);
+  }
+
+  if (crash) {
+    __builtin_trap();
+  }
+
+  CRASHPAD_SIMULATE_CRASH();
+  const uint64_t resumed_ns = MonotonicNanoseconds();
+  if (!LoggingWriteFile(write_fd, &resumed_ns, sizeof(resumed_ns))) {
+    _exit(EXIT_FAILURE);
+  }
+
+  // In a forked child, exit() is unsafe. Use _exit() instead.
+  _exit(EXIT_SUCCESS);
+}
+
+struct Iteration {
+  double stopped_ms;
+  double reported_ms;
+  double cpu_ms;
+};
+
+// Runs a client to completion and measures how long its dump took.
+bool RunIteration(const Options& options,
+                  const std::vector<base::FilePath>& modules,
+                  bool crash,
+                  PtraceStrategyDecider::Strategy strategy,
+                  CrashReportExceptionHandler* exception_handler,
+                  Iteration* iteration) {
+  int socks[2];
+  if (socketpair(AF_UNIX, SOCK_STREAM, 0, socks) != 0) {
+    PLOG(ERROR) << "socketpair";
+    return false;
+  }
+  ScopedFileHandle server_sock(socks[0]);
+  ScopedFileHandle client_sock(socks[1]);
+
+  int pipe_fds[2];
+  if (pipe(pipe_fds) != 0) {
+    PLOG(ERROR) << "pipe";
+    return false;
+  }
+  ScopedFileHandle read_pipe(pipe_fds[0]);
+  ScopedFileHandle write_pipe(pipe_fds[1]);
+
+  pid_t pid = fork();
+  if (pid < 0) {
+    PLOG(ERROR) << "fork";
+    return false;
+  }
+  if (pid == 0) {
+    server_sock.reset();
+    read_pipe.reset();
+    RunClient(
+        options, modules, crash, std::move(client_sock), write_pipe.get());
+  }
+  client_sock.reset();
+  write_pipe.reset();
+
+  ExceptionHandlerServer server;
+  TimingDelegate delegate(exception_handler);
+  RunServerThread server_thread(&server, &delegate);
+  const bool server_started =
+      server.InitializeWithClient(std::move(server_sock), false);
+  if (server_started) {
+    server.SetPtraceStrategyDecider(
+        std::make_unique<ForcedPtraceStrategyDecider>(strategy));
+    server_thread.Start();
+  }
+
+  uint64_t requested_ns = 0;
+  uint64_t resumed_ns = 0;
+  bool rv = server_started &&
+            LoggingReadFileExactly(
+                read_pipe.get(), &requested_ns, sizeof(requested_ns)) &&
+            (crash || LoggingReadFileExactly(
+                          read_pipe.get(), &resumed_ns, sizeof(resumed_ns)));
+
+  int status;
+  if (HANDLE_EINTR(waitpid(pid, &status, 0)) != pid) {
+    PLOG(ERROR) << "waitpid";
+    rv = false;
+  }
+  if (crash) {
+    resumed_ns = MonotonicNanoseconds();
+  }
+
+  const bool expected_termination =
+      crash ? WIFSIGNALED(status) &&
+                  (WTERMSIG(status) == SIGTRAP || WTERMSIG(status) == SIGILL)
+            : WIFEXITED(status) && WEXITSTATUS(status) == EXIT_SUCCESS;
+  if (!expected_termination) {
+    LOG(ERROR) << "unexpected client termination, status " << status;
+    rv = false;
+  }
+
+  if (server_started) {
+    server.Stop();
+    server_thread.Join();
+  }
+
+  if (!rv || !delegate.succeeded()) {
+    return false;
+  }
+
+  iteration->stopped_ms = (resumed_ns - requested_ns) / 1e6;
+  iteration->reported_ms = (delegate.reported_ns() - requested_ns) / 1e6;
+  iteration->cpu_ms = delegate.cpu_ns() / 1e6;
+  return true;
+}
+
+double Percentile(const std::vector<double>& sorted, double percentile) {
+  const size_t rank = static_cast<size_t>(percentile * sorted.size() / 100);
+  return sorted[std::min(rank, sorted.size() - 1)];
+}
+
+void PrintHeader() {
+  printf("%-36s %10s %10s %10s %10s\n", "Benchmark", "p50", "p90", "p99",
+         "Max");
+}
+
+void PrintPercentiles(const std::string& name, std::vector<double> values) {
+  std::sort(values.begin(), values.end());
+  printf("%-36s %7.3f ms %7.3f ms %7.3f ms %7.3f ms\n",
+         name.c_str(),
+         Percentile(values, 50),
+         Percentile(values, 90),
+         Percentile(values, 99),
+         values.back());
+}
+
+int HandlerBenchmarksMain(int argc, char* argv[]) {
+  const std::string me = base::FilePath(argv[0]).BaseName().value();
+
+  enum OptionFlags {
+    // Long options without short equivalents.
+    kOptionLastChar = 255,
+    kOptionHeapSize,
+    kOptionIterations,
+    kOptionModule,
+    kOptionModuleSnapshotThreads,
+    kOptionModules,
+    kOptionThreadSnapshotThreads,
+    kOptionThreads,
+
+    // Standard options.
+    kOptionHelp = -2,
+  };
+
+  Options options = {};
+  options.threads = 32;
+  options.modules = 100;
+  options.heap_size = 64 * 1024 * 1024;
+  options.iterations = 20;
+  options.module_snapshot_threads = 1;
+  options.thread_snapshot_threads = 1;
+
+  static constexpr option long_options[] = {
+      {"heap-size", required_argument, nullptr, kOptionHeapSize},
+      {"iterations", required_argument, nullptr, kOptionIterations},
+      {"module", required_argument, nullptr, kOptionModule},
+      {"module-snapshot-threads",
+       required_argument,
+       nullptr,
+       kOptionModuleSnapshotThreads},
+      {"modules", required_argument, nullptr, kOptionModules},
+      {"thread-snapshot-threads",
+       required_argument,
+       nullptr,
+       kOptionThreadSnapshotThreads},
+      {"threads", required_argument, nullptr, kOptionThreads},
+      {"help", no_argument, nullptr, kOptionHelp},
+      {nullptr, 0, nullptr, 0},
+  };
+
+  int opt;
+  while ((opt = getopt_long(argc, argv, "", long_options, nullptr)) != -1) {
+    size_t* size_option = nullptr;
+    switch (opt) {
+      case kOptionHeapSize:
+        size_option = &options.heap_size;
+        break;
+      case kOptionIterations:
+        size_option = &options.iterations;
+        break;
+      case kOptionModule:
+        options.module = base::FilePath(optarg);
+        break;
+      case kOptionModuleSnapshotThreads:
+        size_option = &options.module_snapshot_threads;
+        break;
+      case kOptionModules:
+        size_option = &options.modules;
+        break;
+      case kOptionThreadSnapshotThreads:
+        size_option = &options.thread_snapshot_threads;
+        break;
+      case kOptionThreads:
+        size_option = &options.threads;
+        break;
+      case kOptionHelp:
+        Usage(me);
+        return EXIT_SUCCESS;
+      default:
+        fprintf(stderr, "Try '%s --help' for more information.\n", me.c_str());
+        return EXIT_FAILURE;
+    }
+
+    if (size_option && !base::StringToSizeT(optarg, size_option)) {
+      fprintf(stderr, "%s: invalid number: %s\n", me.c_str(), optarg);
+      return EXIT_FAILURE;
+    }
+  }
+
+  if (optind != argc || options.iterations == 0) {
+    fprintf(stderr, "Try '%s --help' for more information.\n", me.c_str());
+    return EXIT_FAILURE;
+  }
+
+  if (options.module.empty()) {
+    options.module =
+        TestPaths::BuildArtifact(FILE_PATH_LITERAL("snapshot"),
+                                 FILE_PATH_LITERAL("module"),
+                                 TestPaths::FileType::kLoadableModule);
+  }
+
+  // The dynamic loader only loads a file once, so load distinct copies of the
+  // module.
+  ScopedTempDir temp_dir;
+  std::vector<base::FilePath> modules;
+  if (options.modules > 0) {
+    std::string module_contents;
+    if (!LoggingReadEntireFile(options.module, &module_contents)) {
+      return EXIT_FAILURE;
+    }
+    for (size_t index = 0; index < options.modules; ++index) {
+      modules.push_back(temp_dir.path().Append(
+          base::StringPrintf("libbenchmark_%zu.so", index)));
+      ScopedFileHandle module_file(LoggingOpenFileForWrite(
+          modules.back(),
+          FileWriteMode::kCreateOrFail,
+          FilePermissions::kOwnerOnly));
+      if (!module_file.is_valid() ||
+          !LoggingWriteFile(module_file.get(),
+                            module_contents.data(),
+                            module_contents.size())) {
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  std::unique_ptr<CrashReportDatabase> database =
+      CrashReportDatabase::Initialize(
+          temp_dir.path().Append(FILE_PATH_LITERAL("database")));
+  if (!database) {
+    return EXIT_FAILURE;
+  }
+
+  const std::map<std::string, std::string> process_annotations;
+  const std::vector<base::FilePath> attachments;
+  CrashReportExceptionHandler exception_handler(database.get(),
+                                                nullptr,
+                                                &process_annotations,
+                                                &attachments,
+                                                true,
+                                                false,
+                                                nullptr);
+  exception_handler.SetModuleSnapshotThreads(
+      static_cast<unsigned int>(options.module_snapshot_threads));
+  exception_handler.SetThreadSnapshotThreads(
+      static_cast<unsigned int>(options.thread_snapshot_threads));
+
+  printf("threads=%zu modules=%zu heap_size=%zu module_snapshot_threads=%zu "
+         "thread_snapshot_threads=%zu iterations=%zu\n\n",
+         options.threads,
+         options.modules,
+         options.heap_size,
+         options.module_snapshot_threads,
+         options.thread_snapshot_threads,
+         options.iterations);
+  PrintHeader();
+
+  static constexpr struct {
+    const char* name;
+    bool crash;
+  } kModes[] = {
+      {"DumpWithoutCrash", false},
+      {"Crash", true},
+  };
+
+  static constexpr struct {
+    const char* name;
+    PtraceStrategyDecider::Strategy strategy;
+  } kStrategies[] = {
+      {"Direct", PtraceStrategyDecider::Strategy::kDirectPtrace},
+      {"Broker", PtraceStrategyDecider::Strategy::kUseBroker},
+  };
+
+  for (const auto& mode : kModes) {
+    for (const auto& strategy : kStrategies) {
+      std::vector<double> stopped_ms;
+      std::vector<double> reported_ms;
+      std::vector<double> cpu_ms;
+      for (size_t index = 0; index < options.iterations; ++index) {
+        Iteration iteration;
+        if (!RunIteration(options,
+                          modules,
+                          mode.crash,
+                          strategy.strategy,
+                          &exception_handler,
+                          &iteration)) {
+          fprintf(stderr,
+                  "%s: %s/%s failed\n",
+                  me.c_str(),
+                  mode.name,
+                  strategy.name);
+          return EXIT_FAILURE;
+        }
+        stopped_ms.push_back(iteration.stopped_ms);
+        reported_ms.push_back(iteration.reported_ms);
+        cpu_ms.push_back(iteration.cpu_ms);
+      }
+
+      const std::string name =
+          base::StringPrintf("%s/%s", mode.name, strategy.name);
+      PrintPercentiles(name + "/ClientStopped", stopped_ms);
+      PrintPercentiles(name + "/ReportOnDisk", reported_ms);
+      PrintPercentiles(name + "/HandlerCPU", cpu_ms);
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
+
+int main(int argc, char* argv[]) {
+  return crashpad::test::HandlerBenchmarksMain(argc, argv);
+}
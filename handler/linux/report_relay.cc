@@ -0,0 +1,125 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "handler/linux/report_relay.h"
+
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+
+#include <cmath>
+#include <vector>
+
+#include "base/logging.h"
+#include "util/linux/socket.h"
+
+namespace crashpad {
+
+namespace {
+
+void AppendString(const std::string& string, std::string* message) {
+  message->append(string);
+  message->push_back('\0');
+}
+
+}  // namespace
+
+ReportRelay::ReportRelay(const std::string& socket_name, double timeout)
+    : socket_name_(socket_name), timeout_(timeout) {}
+
+ReportRelay::~ReportRelay() = default;
+
+ReportRelay::Result ReportRelay::Relay(
+    const UUID& uuid,
+    const std::string& url,
+    FileHandle minidump,
+    bool compressed,
+    const std::map<std::string, std::string>& parameters,
+    const std::map<std::string, FileHandle>& attachments,
+    std::string* report_id) {
+  if (attachments.size() >= UnixCredentialSocket::kMaxSendRecvMsgFDs) {
+    LOG(WARNING) << "too many attachments to relay";
+    return Result::kUnavailable;
+  }
+
+  Request request = {};
+  request.version = kVersion;
+  request.flags = compressed ? kFlagCompressedMinidump : 0;
+  request.uuid = uuid;
+  request.parameter_count = static_cast<uint32_t>(parameters.size());
+  request.attachment_count = static_cast<uint32_t>(attachments.size());
+
+  std::string message(reinterpret_cast<const char*>(&request),
+                      sizeof(request));
+  AppendString(url, &message);
+  for (const auto& parameter : parameters) {
+    AppendString(parameter.first, &message);
+    AppendString(parameter.second, &message);
+  }
+
+  std::vector<int> fds(1, minidump);
+  for (const auto& attachment : attachments) {
+    AppendString(attachment.first, &message);
+    fds.push_back(attachment.second);
+  }
+
+  ScopedFileHandle sock;
+  if (!UnixCredentialSocket::ConnectCredentialSocket(socket_name_, &sock)) {
+    return Result::kUnavailable;
+  }
+
+  timeval receive_timeout;
+  receive_timeout.tv_sec = static_cast<time_t>(timeout_);
+  receive_timeout.tv_usec =
+      static_cast<suseconds_t>((timeout_ - std::floor(timeout_)) * 1E6);
+  if (setsockopt(sock.get(),
+                 SOL_SOCKET,
+                 SO_RCVTIMEO,
+                 &receive_timeout,
+                 sizeof(receive_timeout)) != 0) {
+    PLOG(ERROR) << "setsockopt";
+    return Result::kUnavailable;
+  }
+
+  if (UnixCredentialSocket::SendMsg(sock.get(),
+                                    message.data(),
+                                    message.size(),
+                                    fds.data(),
+                                    fds.size()) != 0) {
+    return Result::kUnavailable;
+  }
+
+  Response response;
+  ucred creds;
+  if (!UnixCredentialSocket::RecvMsg(
+          sock.get(), &response, sizeof(response), &creds)) {
+    LOG(ERROR) << "no response from relay";
+    return Result::kUnavailable;
+  }
+
+  switch (response.status) {
+    case kStatusAccepted:
+      report_id->assign(
+          response.report_id,
+          strnlen(response.report_id, sizeof(response.report_id)));
+      return Result::kAccepted;
+    case kStatusRejected:
+      return Result::kRejected;
+    default:
+      LOG(WARNING) << "relay declined report, status " << response.status;
+      return Result::kUnavailable;
+  }
+}
+
+}  // namespace crashpad
@@ -0,0 +1,157 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_HANDLER_LINUX_REPORT_RELAY_H_
+#define CRASHPAD_HANDLER_LINUX_REPORT_RELAY_H_
+
+#include <stdint.h>
+
+#include <map>
+#include <string>
+
+#include "util/file/file_io.h"
+#include "util/misc/uuid.h"
+
+namespace crashpad {
+
+//! \brief Hands crash reports to a crash collection agent on the same host,
+//!     which uploads them in place of the handler.
+//!
+//! The agent listens on an `AF_UNIX` `SOCK_SEQPACKET` socket in the abstract
+//! namespace, as created by
+//! UnixCredentialSocket::CreateCredentialListeningSocket(). Each report is
+//! relayed on a connection of its own, as a single #Request message, to
+//! which the agent replies with a single #Response message.
+//!
+//! The report’s minidump and attachments aren’t copied into the request.
+//! Their file descriptors are passed with `SCM_RIGHTS` instead. These share
+//! their file offsets with the handler’s, so the agent must read them with
+//! `pread()` or duplicate them by reopening them through `/proc/self/fd`.
+//! They remain readable after the handler removes the report from its
+//! database.
+class ReportRelay {
+ public:
+#pragma pack(push, 1)
+
+  //! \brief The fixed part of a relay request.
+  //!
+  //! This is followed in the same message by NUL-terminated strings: the URL
+  //! that the report would have been uploaded to, the key and value of each
+  //! of #parameter_count form fields, and the name of each of
+  //! #attachment_count attachments. The message carries the minidump’s file
+  //! descriptor, followed by those of the attachments in the same order as
+  //! their names.
+  struct Request {
+    //! \brief The version of this structure, #kVersion.
+    uint32_t version;
+
+    //! \brief A combination of `kFlag*` values.
+    uint32_t flags;
+
+    //! \brief The report’s UUID.
+    UUID uuid;
+
+    //! \brief The number of form fields that follow.
+    uint32_t parameter_count;
+
+    //! \brief The number of attachments that follow.
+    uint32_t attachment_count;
+  };
+
+  //! \brief The agent’s reply to a #Request.
+  struct Response {
+    //! \brief A #Status value. The handler treats other values, such as one
+    //!     sent by an agent too busy to take the report, as it does an
+    //!     unreachable agent.
+    uint32_t status;
+
+    //! \brief The report’s ID, NUL-terminated unless it fills this field, if
+    //!     #status is #kStatusAccepted. This is recorded as the ID that the
+    //!     server assigned to the report, so it may be left empty if the
+    //!     agent doesn’t know it yet.
+    char report_id[60];
+  };
+
+#pragma pack(pop)
+
+  //! \brief The current version of #Request.
+  static constexpr uint32_t kVersion = 1;
+
+  //! \brief Set in Request::flags if the minidump was written compressed, as
+  //!     by MinidumpFileWriter::WriteCompressedMinidump().
+  static constexpr uint32_t kFlagCompressedMinidump = 1 << 0;
+
+  //! \brief Values of Response::status.
+  enum Status : uint32_t {
+    //! \brief The agent has taken the report and will upload it.
+    kStatusAccepted = 0,
+
+    //! \brief The agent won’t take the report, and it shouldn’t be uploaded.
+    kStatusRejected = 1,
+  };
+
+  //! \brief The outcome of Relay().
+  enum class Result {
+    //! \brief The agent has taken the report.
+    kAccepted,
+
+    //! \brief The agent won’t take the report, and it shouldn’t be uploaded.
+    kRejected,
+
+    //! \brief The report couldn’t be relayed. It should be uploaded directly
+    //!     instead.
+    kUnavailable,
+  };
+
+  //! \param[in] socket_name The agent’s socket’s name in the abstract socket
+  //!     namespace, without the leading NUL byte.
+  //! \param[in] timeout The number of seconds to wait for the agent’s reply.
+  ReportRelay(const std::string& socket_name, double timeout);
+
+  ReportRelay(const ReportRelay&) = delete;
+  ReportRelay& operator=(const ReportRelay&) = delete;
+
+  ~ReportRelay();
+
+  //! \brief Relays a report to the agent.
+  //!
+  //! \param[in] uuid The report’s UUID.
+  //! \param[in] url The URL that the report would have been uploaded to.
+  //! \param[in] minidump The report’s minidump.
+  //! \param[in] compressed Whether \a minidump was written compressed.
+  //! \param[in] parameters The form fields that would have been uploaded with
+  //!     the report.
+  //! \param[in] attachments The report’s attachments, by name. At most
+  //!     UnixCredentialSocket::kMaxSendRecvMsgFDs minus one attachments can
+  //!     be relayed.
+  //! \param[out] report_id The report’s ID, from Response::report_id, if
+  //!     Result::kAccepted is returned.
+  //!
+  //! \return A Result. A message is logged for Result::kUnavailable.
+  Result Relay(const UUID& uuid,
+               const std::string& url,
+               FileHandle minidump,
+               bool compressed,
+               const std::map<std::string, std::string>& parameters,
+               const std::map<std::string, FileHandle>& attachments,
+               std::string* report_id);
+
+ private:
+  const std::string socket_name_;
+  const double timeout_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_HANDLER_LINUX_REPORT_RELAY_H_
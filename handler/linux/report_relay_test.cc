@@ -0,0 +1,231 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "handler/linux/report_relay.h"
+
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "base/posix/eintr_wrapper.h"
+#include "base/strings/stringprintf.h"
+#include "gtest/gtest.h"
+#include "test/scoped_temp_dir.h"
+#include "util/file/file_io.h"
+#include "util/linux/socket.h"
+#include "util/thread/thread.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+// Accepts a single connection on a listening socket, receives a relay request,
+// and replies with a given status.
+class FakeAgent : public Thread {
+ public:
+  FakeAgent(int listen_sock, uint32_t status, const std::string& report_id)
+      : Thread(),
+        message_(),
+        fds_(),
+        listen_sock_(listen_sock),
+        status_(status),
+        report_id_(report_id) {}
+
+  FakeAgent(const FakeAgent&) = delete;
+  FakeAgent& operator=(const FakeAgent&) = delete;
+
+  ~FakeAgent() override {}
+
+  const std::string& message() const { return message_; }
+  const std::vector<ScopedFileHandle>& fds() const { return fds_; }
+
+ private:
+  // Thread:
+  void ThreadMain() override {
+    ScopedFileHandle sock(
+        HANDLE_EINTR(accept4(listen_sock_, nullptr, nullptr, SOCK_CLOEXEC)));
+    ASSERT_TRUE(sock.is_valid());
+
+    const ssize_t size = HANDLE_EINTR(
+        recv(sock.get(), nullptr, 0, MSG_PEEK | MSG_TRUNC));
+    ASSERT_GT(size, 0);
+    message_.resize(size);
+    ucred creds;
+    ASSERT_TRUE(UnixCredentialSocket::RecvMsg(
+        sock.get(), &message_[0], message_.size(), &creds, &fds_));
+    EXPECT_EQ(creds.pid, getpid());
+
+    ReportRelay::Response response = {};
+    response.status = status_;
+    strncpy(response.report_id,
+            report_id_.c_str(),
+            sizeof(response.report_id));
+    ASSERT_EQ(UnixCredentialSocket::SendMsg(
+                  sock.get(), &response, sizeof(response)),
+              0);
+  }
+
+  std::string message_;
+  std::vector<ScopedFileHandle> fds_;
+  int listen_sock_;
+  uint32_t status_;
+  std::string report_id_;
+};
+
+std::string SocketName() {
+  return base::StringPrintf("crashpad_report_relay_test_%d", getpid());
+}
+
+std::string ReadAt(FileHandle file, size_t size) {
+  std::string contents(size, '\0');
+  EXPECT_EQ(HANDLE_EINTR(pread(file, &contents[0], size, 0)),
+            static_cast<ssize_t>(size));
+  return contents;
+}
+
+TEST(ReportRelay, Accepted) {
+  ScopedTempDir temp_dir;
+  static constexpr char kMinidump[] = "minidump";
+  static constexpr char kAttachment[] = "attachment";
+  ScopedFileHandle minidump(LoggingOpenFileForReadAndWrite(
+      temp_dir.path().Append(FILE_PATH_LITERAL("minidump")),
+      FileWriteMode::kCreateOrFail,
+      FilePermissions::kOwnerOnly));
+  ASSERT_TRUE(minidump.is_valid());
+  ASSERT_TRUE(LoggingWriteFile(minidump.get(), kMinidump, strlen(kMinidump)));
+  ScopedFileHandle attachment(LoggingOpenFileForReadAndWrite(
+      temp_dir.path().Append(FILE_PATH_LITERAL("attachment")),
+      FileWriteMode::kCreateOrFail,
+      FilePermissions::kOwnerOnly));
+  ASSERT_TRUE(attachment.is_valid());
+  ASSERT_TRUE(
+      LoggingWriteFile(attachment.get(), kAttachment, strlen(kAttachment)));
+
+  ScopedFileHandle listen_sock;
+  ASSERT_TRUE(UnixCredentialSocket::CreateCredentialListeningSocket(
+      SocketName(), &listen_sock));
+  FakeAgent agent(listen_sock.get(), ReportRelay::kStatusAccepted, "abc123");
+  agent.Start();
+
+  UUID uuid;
+  uuid.InitializeWithNew();
+  std::map<std::string, std::string> parameters;
+  parameters["prod"] = "product";
+  parameters["ver"] = "1.0";
+  std::map<std::string, FileHandle> attachments;
+  attachments["log"] = attachment.get();
+
+  ReportRelay relay(SocketName(), 10);
+  std::string report_id;
+  EXPECT_EQ(relay.Relay(uuid,
+                        "https://example.com/upload",
+                        minidump.get(),
+                        true,
+                        parameters,
+                        attachments,
+                        &report_id),
+            ReportRelay::Result::kAccepted);
+  agent.Join();
+  EXPECT_EQ(report_id, "abc123");
+
+  const std::string& message = agent.message();
+  ASSERT_GE(message.size(), sizeof(ReportRelay::Request));
+  ReportRelay::Request request;
+  memcpy(&request, message.data(), sizeof(request));
+  EXPECT_EQ(request.version, ReportRelay::kVersion);
+  EXPECT_EQ(request.flags, ReportRelay::kFlagCompressedMinidump);
+  EXPECT_EQ(request.uuid, uuid);
+  EXPECT_EQ(request.parameter_count, 2u);
+  EXPECT_EQ(request.attachment_count, 1u);
+
+  static constexpr char kStrings[] =
+      "https://example.com/upload\0prod\0product\0ver\0001.0\0log";
+  EXPECT_EQ(message.substr(sizeof(request)),
+            std::string(kStrings, sizeof(kStrings)));
+
+  // The files are passed, not their contents.
+  ASSERT_EQ(agent.fds().size(), 2u);
+  EXPECT_EQ(ReadAt(agent.fds()[0].get(), strlen(kMinidump)), kMinidump);
+  EXPECT_EQ(ReadAt(agent.fds()[1].get(), strlen(kAttachment)), kAttachment);
+}
+
+TEST(ReportRelay, Declined) {
+  ScopedTempDir temp_dir;
+  ScopedFileHandle minidump(LoggingOpenFileForReadAndWrite(
+      temp_dir.path().Append(FILE_PATH_LITERAL("minidump")),
+      FileWriteMode::kCreateOrFail,
+      FilePermissions::kOwnerOnly));
+  ASSERT_TRUE(minidump.is_valid());
+
+  ScopedFileHandle listen_sock;
+  ASSERT_TRUE(UnixCredentialSocket::CreateCredentialListeningSocket(
+      SocketName(), &listen_sock));
+
+  static constexpr struct {
+    uint32_t status;
+    ReportRelay::Result result;
+  } kTestData[] = {
+      {ReportRelay::kStatusRejected, ReportRelay::Result::kRejected},
+      {2, ReportRelay::Result::kUnavailable},
+  };
+  for (const auto& test_data : kTestData) {
+    SCOPED_TRACE(test_data.status);
+    FakeAgent agent(listen_sock.get(), test_data.status, std::string());
+    agent.Start();
+
+    UUID uuid;
+    uuid.InitializeWithNew();
+    ReportRelay relay(SocketName(), 10);
+    std::string report_id;
+    EXPECT_EQ(relay.Relay(uuid,
+                          "https://example.com/upload",
+                          minidump.get(),
+                          false,
+                          std::map<std::string, std::string>(),
+                          std::map<std::string, FileHandle>(),
+                          &report_id),
+              test_data.result);
+    agent.Join();
+  }
+}
+
+TEST(ReportRelay, NoAgent) {
+  ScopedTempDir temp_dir;
+  ScopedFileHandle minidump(LoggingOpenFileForReadAndWrite(
+      temp_dir.path().Append(FILE_PATH_LITERAL("minidump")),
+      FileWriteMode::kCreateOrFail,
+      FilePermissions::kOwnerOnly));
+  ASSERT_TRUE(minidump.is_valid());
+
+  UUID uuid;
+  uuid.InitializeWithNew();
+  ReportRelay relay(SocketName(), 10);
+  std::string report_id;
+  EXPECT_EQ(relay.Relay(uuid,
+                        "https://example.com/upload",
+                        minidump.get(),
+                        false,
+                        std::map<std::string, std::string>(),
+                        std::map<std::string, FileHandle>(),
+                        &report_id),
+            ReportRelay::Result::kUnavailable);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
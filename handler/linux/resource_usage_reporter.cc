@@ -0,0 +1,223 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "handler/linux/resource_usage_reporter.h"
+
+#include <inttypes.h>
+#include <sys/socket.h>
+
+#include <iterator>
+#include <vector>
+
+#include "base/files/file_path.h"
+#include "base/logging.h"
+#include "base/numerics/safe_conversions.h"
+#include "base/posix/eintr_wrapper.h"
+#include "base/strings/stringprintf.h"
+#include "client/crash_report_database.h"
+#include "handler/linux/exception_handler_server.h"
+#include "util/file/directory_reader.h"
+#include "util/file/file_io.h"
+#include "util/linux/socket.h"
+#include "util/misc/lexing.h"
+#include "util/string/split_string.h"
+
+namespace crashpad {
+
+namespace {
+
+// Reads a value like “  1234 kB” from a line of /proc/<pid>/status.
+bool AdvancePastKilobytes(const char** input, uint64_t* bytes) {
+  while (**input == ' ' || **input == '\t') {
+    ++*input;
+  }
+  uint64_t kilobytes;
+  if (!AdvancePastNumber(input, &kilobytes) ||
+      !AdvancePastPrefix(input, " kB")) {
+    return false;
+  }
+  *bytes = kilobytes * 1024;
+  return true;
+}
+
+bool CountOpenFiles(uint32_t* count) {
+  DirectoryReader reader;
+  if (!reader.Open(base::FilePath("/proc/self/fd"))) {
+    return false;
+  }
+
+  // The reader’s own descriptor is one of the entries, and isn’t counted.
+  uint32_t entries = 0;
+  base::FilePath filename;
+  DirectoryReader::Result result;
+  while ((result = reader.NextFile(&filename)) ==
+         DirectoryReader::Result::kSuccess) {
+    ++entries;
+  }
+  if (result == DirectoryReader::Result::kError) {
+    return false;
+  }
+  *count = entries > 0 ? entries - 1 : 0;
+  return true;
+}
+
+}  // namespace
+
+ResourceUsageReporter::Sample::Sample()
+    : resident_bytes(0),
+      peak_resident_bytes(0),
+      thread_count(0),
+      open_file_count(0),
+      pending_dump_count(0),
+      pending_report_count(0),
+      upload_backlog_bytes(0),
+      operation_nanoseconds() {}
+
+ResourceUsageReporter::ResourceUsageReporter(double interval,
+                                             CrashReportDatabase* database,
+                                             ExceptionHandlerServer* server)
+    : thread_(interval, this),
+      socket_name_(),
+      database_(database),
+      server_(server) {}
+
+ResourceUsageReporter::~ResourceUsageReporter() = default;
+
+void ResourceUsageReporter::SetSocketName(const std::string& socket_name) {
+  socket_name_ = socket_name;
+}
+
+ResourceUsageReporter::Sample ResourceUsageReporter::TakeSample() {
+  Sample sample;
+
+  std::string status;
+  if (LoggingReadEntireFile(base::FilePath("/proc/self/status"), &status)) {
+    ParseProcStatus(status, &sample);
+  }
+  CountOpenFiles(&sample.open_file_count);
+
+  if (server_) {
+    sample.pending_dump_count =
+        base::saturated_cast<uint32_t>(server_->PendingDumpCount());
+  }
+
+  if (database_) {
+    std::vector<CrashReportDatabase::Report> reports;
+    if (database_->GetPendingReports(&reports) ==
+        CrashReportDatabase::kNoError) {
+      sample.pending_report_count =
+          base::saturated_cast<uint32_t>(reports.size());
+      for (const CrashReportDatabase::Report& report : reports) {
+        sample.upload_backlog_bytes += report.total_size;
+      }
+    }
+  }
+
+  for (size_t index = 0; index < std::size(sample.operation_nanoseconds);
+       ++index) {
+    sample.operation_nanoseconds[index] = Metrics::TotalOperationDuration(
+        static_cast<Metrics::TimedOperation>(index));
+  }
+
+  return sample;
+}
+
+// static
+bool ResourceUsageReporter::ParseProcStatus(const std::string& contents,
+                                            Sample* sample) {
+  bool have_resident = false;
+  bool have_peak_resident = false;
+  bool have_threads = false;
+  for (const std::string& line : SplitString(contents, '\n')) {
+    const char* line_c = line.c_str();
+    if (AdvancePastPrefix(&line_c, "VmRSS:")) {
+      have_resident = AdvancePastKilobytes(&line_c, &sample->resident_bytes);
+    } else if (AdvancePastPrefix(&line_c, "VmHWM:")) {
+      have_peak_resident =
+          AdvancePastKilobytes(&line_c, &sample->peak_resident_bytes);
+    } else if (AdvancePastPrefix(&line_c, "Threads:\t")) {
+      have_threads = AdvancePastNumber(&line_c, &sample->thread_count);
+    }
+  }
+
+  if (!have_resident || !have_peak_resident || !have_threads) {
+    LOG(ERROR) << "format error";
+    return false;
+  }
+  return true;
+}
+
+// static
+std::string ResourceUsageReporter::FormatSample(const Sample& sample) {
+  std::string text = base::StringPrintf(
+      "resident_bytes %" PRIu64 "\n"
+      "peak_resident_bytes %" PRIu64 "\n"
+      "thread_count %u\n"
+      "open_file_count %u\n"
+      "pending_dump_count %u\n"
+      "pending_report_count %u\n"
+      "upload_backlog_bytes %" PRIu64 "\n",
+      sample.resident_bytes,
+      sample.peak_resident_bytes,
+      sample.thread_count,
+      sample.open_file_count,
+      sample.pending_dump_count,
+      sample.pending_report_count,
+      sample.upload_backlog_bytes);
+  for (size_t index = 0; index < std::size(sample.operation_nanoseconds);
+       ++index) {
+    text.append(base::StringPrintf(
+        "operation_nanoseconds.%s %" PRIu64 "\n",
+        Metrics::TimedOperationName(
+            static_cast<Metrics::TimedOperation>(index)),
+        sample.operation_nanoseconds[index]));
+  }
+  return text;
+}
+
+void ResourceUsageReporter::Start() {
+  thread_.Start(0);
+}
+
+void ResourceUsageReporter::Stop() {
+  thread_.Stop();
+}
+
+void ResourceUsageReporter::DoWork(const WorkerThread* thread) {
+  const Sample sample = TakeSample();
+  Metrics::HandlerResourceUsage(sample.resident_bytes,
+                                sample.peak_resident_bytes,
+                                sample.thread_count,
+                                sample.open_file_count,
+                                sample.pending_dump_count,
+                                sample.upload_backlog_bytes);
+  if (!socket_name_.empty()) {
+    SendSample(sample);
+  }
+}
+
+void ResourceUsageReporter::SendSample(const Sample& sample) {
+  ScopedFileHandle sock;
+  if (!UnixCredentialSocket::ConnectCredentialSocket(socket_name_, &sock)) {
+    return;
+  }
+
+  const std::string text = FormatSample(sample);
+  if (HANDLE_EINTR(send(sock.get(), text.data(), text.size(), MSG_NOSIGNAL)) <
+      0) {
+    PLOG(ERROR) << "send";
+  }
+}
+
+}  // namespace crashpad
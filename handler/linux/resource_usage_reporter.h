@@ -0,0 +1,151 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_HANDLER_LINUX_RESOURCE_USAGE_REPORTER_H_
+#define CRASHPAD_HANDLER_LINUX_RESOURCE_USAGE_REPORTER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+
+#include "util/misc/metrics.h"
+#include "util/thread/stoppable.h"
+#include "util/thread/worker_thread.h"
+
+namespace crashpad {
+
+class CrashReportDatabase;
+class ExceptionHandlerServer;
+
+//! \brief A thread that periodically samples the handler’s own resource usage.
+//!
+//! Each sample is recorded with Metrics::HandlerResourceUsage(), which keeps it
+//! in the `--metrics-dir` store when there is one. If a socket name is set with
+//! SetSocketName(), each sample is also sent, formatted by FormatSample(), to
+//! a collector listening on that name, so that the handler can be observed
+//! without a metrics pipeline.
+class ResourceUsageReporter : public WorkerThread::Delegate, public Stoppable {
+ public:
+  //! \brief A sample of the handler’s resource usage.
+  struct Sample {
+    Sample();
+
+    //! \brief The resident set size, in bytes.
+    uint64_t resident_bytes;
+
+    //! \brief The peak resident set size, in bytes.
+    uint64_t peak_resident_bytes;
+
+    //! \brief The number of threads.
+    uint32_t thread_count;
+
+    //! \brief The number of open file descriptors.
+    uint32_t open_file_count;
+
+    //! \brief The number of dump requests waiting to be handled.
+    uint32_t pending_dump_count;
+
+    //! \brief The number of reports waiting to be uploaded.
+    uint32_t pending_report_count;
+
+    //! \brief The total size of the reports waiting to be uploaded, in bytes.
+    uint64_t upload_backlog_bytes;
+
+    //! \brief The total time spent in each Metrics::TimedOperation since the
+    //!     handler started, in nanoseconds.
+    uint64_t operation_nanoseconds[static_cast<size_t>(
+        Metrics::TimedOperation::kMaxValue)];
+  };
+
+  //! \param[in] interval The number of seconds between samples.
+  //! \param[in] database The database whose pending reports make up the upload
+  //!     backlog.
+  //! \param[in] server The server whose queued dump requests are counted.
+  //!     This object must be stopped before \a server is destroyed.
+  ResourceUsageReporter(double interval,
+                        CrashReportDatabase* database,
+                        ExceptionHandlerServer* server);
+
+  ResourceUsageReporter(const ResourceUsageReporter&) = delete;
+  ResourceUsageReporter& operator=(const ResourceUsageReporter&) = delete;
+
+  ~ResourceUsageReporter();
+
+  //! \brief Sends each sample to a collector.
+  //!
+  //! The collector listens on an `AF_UNIX` `SOCK_SEQPACKET` socket in the
+  //! abstract namespace, as created by
+  //! UnixCredentialSocket::CreateCredentialListeningSocket(). Each sample is
+  //! sent on a connection of its own, as a single message. Samples taken while
+  //! no collector is listening are only recorded in metrics.
+  //!
+  //! This method may only be called before Start().
+  //!
+  //! \param[in] socket_name The collector’s socket’s name, without the leading
+  //!     NUL byte.
+  void SetSocketName(const std::string& socket_name);
+
+  //! \brief Samples the handler’s resource usage.
+  //!
+  //! This is done periodically once the thread has been started, but may also
+  //! be called directly.
+  Sample TakeSample();
+
+  //! \brief Reads the resident set sizes and thread count of the current
+  //!     process from the contents of its `/proc/<pid>/status` file.
+  //!
+  //! \param[in] contents The contents of the file.
+  //! \param[out] sample The sample to fill in.
+  //! \return `true` on success. `false` on failure with a message logged.
+  static bool ParseProcStatus(const std::string& contents, Sample* sample);
+
+  //! \brief Formats a sample as text.
+  //!
+  //! Each value is on a line of its own, as its name and value separated by a
+  //! space. Values are integers. Sizes are in bytes, and the time spent in
+  //! each Metrics::TimedOperation, named by Metrics::TimedOperationName(), is
+  //! in nanoseconds.
+  static std::string FormatSample(const Sample& sample);
+
+  // Stoppable:
+
+  //! \brief Starts a dedicated sampling thread, which takes its first sample
+  //!     immediately.
+  //!
+  //! This method may only be be called on a newly-constructed object or after
+  //! a call to Stop().
+  void Start() override;
+
+  //! \brief Stops the sampling thread.
+  //!
+  //! This method must only be called after Start(). If Start() has been called,
+  //! this method must be called before destroying an object of this class.
+  void Stop() override;
+
+ private:
+  // WorkerThread::Delegate:
+  void DoWork(const WorkerThread* thread) override;
+
+  void SendSample(const Sample& sample);
+
+  WorkerThread thread_;
+  std::string socket_name_;
+  CrashReportDatabase* database_;  // weak
+  ExceptionHandlerServer* server_;  // weak
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_HANDLER_LINUX_RESOURCE_USAGE_REPORTER_H_
@@ -0,0 +1,120 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "handler/linux/resource_usage_reporter.h"
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <string>
+
+#include "base/posix/eintr_wrapper.h"
+#include "base/strings/stringprintf.h"
+#include "gtest/gtest.h"
+#include "util/file/file_io.h"
+#include "util/linux/socket.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+TEST(ResourceUsageReporter, ParseProcStatus) {
+  static constexpr char kStatus[] =
+      "Name:\tcrashpad_handler\n"
+      "VmPeak:\t   20480 kB\n"
+      "VmHWM:\t    6144 kB\n"
+      "VmRSS:\t    4096 kB\n"
+      "Threads:\t7\n";
+  ResourceUsageReporter::Sample sample;
+  ASSERT_TRUE(ResourceUsageReporter::ParseProcStatus(kStatus, &sample));
+  EXPECT_EQ(sample.resident_bytes, 4096u * 1024);
+  EXPECT_EQ(sample.peak_resident_bytes, 6144u * 1024);
+  EXPECT_EQ(sample.thread_count, 7u);
+
+  EXPECT_FALSE(ResourceUsageReporter::ParseProcStatus(
+      "VmHWM:\t 1 kB\nVmRSS:\t 1 kB\n", &sample));
+  EXPECT_FALSE(ResourceUsageReporter::ParseProcStatus(
+      "VmHWM:\t 1 kB\nVmRSS:\t 1 MB\nThreads:\t1\n", &sample));
+}
+
+TEST(ResourceUsageReporter, TakeSample) {
+  ResourceUsageReporter reporter(60, nullptr, nullptr);
+  Metrics::OperationDuration(Metrics::TimedOperation::kPrune, 1000);
+
+  ResourceUsageReporter::Sample sample = reporter.TakeSample();
+  EXPECT_GT(sample.resident_bytes, 0u);
+  EXPECT_GE(sample.peak_resident_bytes, sample.resident_bytes);
+  EXPECT_GE(sample.thread_count, 1u);
+  EXPECT_GE(sample.open_file_count, 3u);
+  EXPECT_EQ(sample.pending_dump_count, 0u);
+  EXPECT_EQ(sample.pending_report_count, 0u);
+  EXPECT_EQ(sample.upload_backlog_bytes, 0u);
+  EXPECT_GE(sample.operation_nanoseconds[static_cast<size_t>(
+                Metrics::TimedOperation::kPrune)],
+            1000u);
+
+  // An open file is counted.
+  int fds[2];
+  ASSERT_EQ(pipe(fds), 0);
+  ScopedFileHandle read_pipe(fds[0]);
+  ScopedFileHandle write_pipe(fds[1]);
+  EXPECT_EQ(reporter.TakeSample().open_file_count,
+            sample.open_file_count + 2);
+}
+
+TEST(ResourceUsageReporter, FormatSample) {
+  ResourceUsageReporter::Sample sample;
+  sample.resident_bytes = 4096;
+  sample.thread_count = 3;
+  sample.upload_backlog_bytes = 1234;
+  sample.operation_nanoseconds[static_cast<size_t>(
+      Metrics::TimedOperation::kUpload)] = 5678;
+
+  const std::string text = ResourceUsageReporter::FormatSample(sample);
+  EXPECT_EQ(text.substr(0, 20), "resident_bytes 4096\n");
+  EXPECT_NE(text.find("\nthread_count 3\n"), std::string::npos);
+  EXPECT_NE(text.find("\nupload_backlog_bytes 1234\n"), std::string::npos);
+  EXPECT_NE(text.find("\noperation_nanoseconds.Upload 5678\n"),
+            std::string::npos);
+  EXPECT_EQ(text.back(), '\n');
+}
+
+TEST(ResourceUsageReporter, SendSample) {
+  const std::string socket_name = base::StringPrintf(
+      "crashpad_resource_usage_reporter_test_%d", getpid());
+  ScopedFileHandle listen_sock;
+  ASSERT_TRUE(UnixCredentialSocket::CreateCredentialListeningSocket(
+      socket_name, &listen_sock));
+
+  ResourceUsageReporter reporter(60, nullptr, nullptr);
+  reporter.SetSocketName(socket_name);
+  reporter.Start();
+
+  ScopedFileHandle sock(
+      HANDLE_EINTR(accept4(listen_sock.get(), nullptr, nullptr, SOCK_CLOEXEC)));
+  ASSERT_TRUE(sock.is_valid());
+  char buffer[4096];
+  const ssize_t size =
+      HANDLE_EINTR(recv(sock.get(), buffer, sizeof(buffer), 0));
+  reporter.Stop();
+
+  ASSERT_GT(size, 0);
+  const std::string text(buffer, size);
+  EXPECT_EQ(text.compare(0, 15, "resident_bytes "), 0);
+  EXPECT_NE(text.find("\nopen_file_count "), std::string::npos);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
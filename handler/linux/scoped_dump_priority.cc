@@ -0,0 +1,107 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "handler/linux/scoped_dump_priority.h"
+
+#include <errno.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+
+#include "base/logging.h"
+#include "util/stdlib/string_number_conversion.h"
+#include "util/string/split_string.h"
+
+namespace crashpad {
+
+bool ParseCPUList(const std::string& list, std::vector<int>* cpus) {
+  std::vector<int> local_cpus;
+  for (const std::string& range : SplitString(list, ',')) {
+    std::string first_string, last_string;
+    if (!SplitStringFirst(range, '-', &first_string, &last_string)) {
+      first_string = last_string = range;
+    }
+    int first, last;
+    if (!StringToNumber(first_string, &first) ||
+        !StringToNumber(last_string, &last) || first < 0 || last < first ||
+        last >= CPU_SETSIZE) {
+      return false;
+    }
+    for (int cpu = first; cpu <= last; ++cpu) {
+      local_cpus.push_back(cpu);
+    }
+  }
+  if (local_cpus.empty()) {
+    return false;
+  }
+
+  std::sort(local_cpus.begin(), local_cpus.end());
+  local_cpus.erase(std::unique(local_cpus.begin(), local_cpus.end()),
+                   local_cpus.end());
+  cpus->swap(local_cpus);
+  return true;
+}
+
+ScopedDumpPriority::ScopedDumpPriority(const DumpPriority& priority)
+    : saved_cpus_(),
+      thread_id_(static_cast<pid_t>(syscall(SYS_gettid))),
+      saved_nice_(0),
+      restore_nice_(false),
+      restore_cpus_(false) {
+  if (priority.raise_priority) {
+    // On Linux, the nice value is a property of each thread. -1 is a valid nice
+    // value, so errors are told apart by errno.
+    errno = 0;
+    saved_nice_ = getpriority(PRIO_PROCESS, thread_id_);
+    if (saved_nice_ == -1 && errno != 0) {
+      PLOG(WARNING) << "getpriority";
+    } else if (priority.nice < saved_nice_) {
+      if (setpriority(PRIO_PROCESS, thread_id_, priority.nice) != 0) {
+        PLOG(WARNING) << "setpriority";
+      } else {
+        restore_nice_ = true;
+      }
+    }
+  }
+
+  if (!priority.cpus.empty()) {
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    for (int cpu : priority.cpus) {
+      CPU_SET(cpu, &cpus);
+    }
+    if (sched_getaffinity(0, sizeof(saved_cpus_), &saved_cpus_) != 0) {
+      PLOG(WARNING) << "sched_getaffinity";
+    } else if (sched_setaffinity(0, sizeof(cpus), &cpus) != 0) {
+      PLOG(WARNING) << "sched_setaffinity";
+    } else {
+      restore_cpus_ = true;
+    }
+  }
+}
+
+ScopedDumpPriority::~ScopedDumpPriority() {
+  if (restore_cpus_ &&
+      sched_setaffinity(0, sizeof(saved_cpus_), &saved_cpus_) != 0) {
+    PLOG(WARNING) << "sched_setaffinity";
+  }
+  if (restore_nice_ &&
+      setpriority(PRIO_PROCESS, thread_id_, saved_nice_) != 0) {
+    PLOG(WARNING) << "setpriority";
+  }
+}
+
+}  // namespace crashpad
@@ -0,0 +1,78 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_HANDLER_LINUX_SCOPED_DUMP_PRIORITY_H_
+#define CRASHPAD_HANDLER_LINUX_SCOPED_DUMP_PRIORITY_H_
+
+#include <sched.h>
+#include <sys/types.h>
+
+#include <string>
+#include <vector>
+
+namespace crashpad {
+
+//! \brief The scheduling that a thread handling an exception runs with.
+struct DumpPriority {
+  //! \brief Whether #nice is applied.
+  bool raise_priority = false;
+
+  //! \brief The nice value to run with, from `-20` to `19`. This is only
+  //!     applied if it is lower than the thread’s own, which requires
+  //!     `CAP_SYS_NICE` or a suitable `RLIMIT_NICE` for values below `0`.
+  int nice = 0;
+
+  //! \brief The CPUs to run on, or empty to run on any that the thread
+  //!     could already run on.
+  std::vector<int> cpus;
+};
+
+//! \brief Parses a list of CPUs in the format used by `/sys/devices/system/cpu`
+//!     and `taskset --cpu-list`, such as `0-3,8`.
+//!
+//! \param[in] list The list to parse.
+//! \param[out] cpus The CPUs in \a list, in ascending order.
+//!
+//! \return `true` on success. `false` if \a list is empty or malformed, or
+//!     names a CPU that can’t be represented in a `cpu_set_t`.
+bool ParseCPUList(const std::string& list, std::vector<int>* cpus);
+
+//! \brief Runs the calling thread with a DumpPriority for as long as an object
+//!     of this class is in scope, and restores its scheduling afterwards.
+//!
+//! Threads started by the calling thread while this is in scope, such as those
+//! that read a process’ modules, inherit its nice value and CPUs. Failure to
+//! change the thread’s scheduling is logged, and the thread continues as it
+//! was.
+class ScopedDumpPriority {
+ public:
+  //! \param[in] priority The scheduling to run with.
+  explicit ScopedDumpPriority(const DumpPriority& priority);
+
+  ScopedDumpPriority(const ScopedDumpPriority&) = delete;
+  ScopedDumpPriority& operator=(const ScopedDumpPriority&) = delete;
+
+  ~ScopedDumpPriority();
+
+ private:
+  cpu_set_t saved_cpus_;
+  pid_t thread_id_;
+  int saved_nice_;
+  bool restore_nice_;
+  bool restore_cpus_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_HANDLER_LINUX_SCOPED_DUMP_PRIORITY_H_
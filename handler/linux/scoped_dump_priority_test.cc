@@ -0,0 +1,110 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "handler/linux/scoped_dump_priority.h"
+
+#include <errno.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "test/errors.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+TEST(ScopedDumpPriority, ParseCPUList) {
+  std::vector<int> cpus;
+  ASSERT_TRUE(ParseCPUList("3", &cpus));
+  EXPECT_EQ(cpus, std::vector<int>({3}));
+
+  ASSERT_TRUE(ParseCPUList("8,0-2,1", &cpus));
+  EXPECT_EQ(cpus, std::vector<int>({0, 1, 2, 8}));
+
+  EXPECT_FALSE(ParseCPUList("", &cpus));
+  EXPECT_FALSE(ParseCPUList("1,", &cpus));
+  EXPECT_FALSE(ParseCPUList("2-1", &cpus));
+  EXPECT_FALSE(ParseCPUList("-1", &cpus));
+  EXPECT_FALSE(ParseCPUList("0-", &cpus));
+  EXPECT_FALSE(ParseCPUList("a", &cpus));
+  EXPECT_FALSE(ParseCPUList(std::to_string(CPU_SETSIZE), &cpus));
+
+  // Failures leave the output alone.
+  EXPECT_EQ(cpus, std::vector<int>({0, 1, 2, 8}));
+}
+
+TEST(ScopedDumpPriority, CPUs) {
+  cpu_set_t original;
+  ASSERT_EQ(sched_getaffinity(0, sizeof(original), &original), 0)
+      << ErrnoMessage("sched_getaffinity");
+
+  int last_cpu = -1;
+  for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+    if (CPU_ISSET(cpu, &original)) {
+      last_cpu = cpu;
+    }
+  }
+  ASSERT_GE(last_cpu, 0);
+
+  DumpPriority priority;
+  priority.cpus.push_back(last_cpu);
+  {
+    ScopedDumpPriority scoped_priority(priority);
+
+    cpu_set_t cpus;
+    ASSERT_EQ(sched_getaffinity(0, sizeof(cpus), &cpus), 0)
+        << ErrnoMessage("sched_getaffinity");
+    EXPECT_EQ(CPU_COUNT(&cpus), 1);
+    EXPECT_TRUE(CPU_ISSET(last_cpu, &cpus));
+  }
+
+  cpu_set_t restored;
+  ASSERT_EQ(sched_getaffinity(0, sizeof(restored), &restored), 0)
+      << ErrnoMessage("sched_getaffinity");
+  EXPECT_TRUE(CPU_EQUAL(&restored, &original));
+}
+
+TEST(ScopedDumpPriority, Nice) {
+  const pid_t tid = static_cast<pid_t>(syscall(SYS_gettid));
+  errno = 0;
+  const int original = getpriority(PRIO_PROCESS, tid);
+  ASSERT_FALSE(original == -1 && errno != 0) << ErrnoMessage("getpriority");
+
+  // A higher nice value than the thread’s own is never applied.
+  DumpPriority priority;
+  priority.raise_priority = true;
+  priority.nice = original + 1;
+  {
+    ScopedDumpPriority scoped_priority(priority);
+    EXPECT_EQ(getpriority(PRIO_PROCESS, tid), original);
+  }
+
+  // A lower one may not be permitted, in which case the thread runs as it was.
+  priority.nice = original - 1;
+  {
+    ScopedDumpPriority scoped_priority(priority);
+    const int nice = getpriority(PRIO_PROCESS, tid);
+    EXPECT_TRUE(nice == original || nice == original - 1) << nice;
+  }
+  EXPECT_EQ(getpriority(PRIO_PROCESS, tid), original);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
@@ -0,0 +1,322 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "handler/linux/stack_sampler.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include "base/logging.h"
+#include "base/posix/eintr_wrapper.h"
+#include "base/strings/stringprintf.h"
+#include "build/build_config.h"
+#include "minidump/minidump_extensions.h"
+#include "minidump/minidump_user_extension_stream_data_source.h"
+#include "util/file/file_io.h"
+#include "util/linux/proc_task_reader.h"
+#include "util/linux/ptracer.h"
+#include "util/linux/scoped_ptrace_attach.h"
+#include "util/linux/thread_info.h"
+#include "util/misc/clock.h"
+
+namespace crashpad {
+
+namespace {
+
+// Bounds the memory used for samples. At most this many processes are sampled,
+// and at most this many samples are kept for each.
+constexpr size_t kMaxProcesses = 64;
+constexpr size_t kMaxSamplesPerProcess = 4096;
+
+void GetFrameRegisters(const ThreadContext& context,
+                       bool is_64_bit,
+                       uint64_t* instruction_pointer,
+                       uint64_t* stack_pointer,
+                       uint64_t* frame_pointer) {
+#if defined(ARCH_CPU_X86_FAMILY)
+  if (is_64_bit) {
+    *instruction_pointer = context.t64.rip;
+    *stack_pointer = context.t64.rsp;
+    *frame_pointer = context.t64.rbp;
+  } else {
+    *instruction_pointer = context.t32.eip;
+    *stack_pointer = context.t32.esp;
+    *frame_pointer = context.t32.ebp;
+  }
+#elif defined(ARCH_CPU_ARM_FAMILY)
+  if (is_64_bit) {
+    *instruction_pointer = context.t64.pc;
+    *stack_pointer = context.t64.sp;
+    *frame_pointer = context.t64.regs[29];
+  } else {
+    *instruction_pointer = context.t32.pc;
+    *stack_pointer = context.t32.sp;
+    *frame_pointer = context.t32.fp;
+  }
+#elif defined(ARCH_CPU_MIPS_FAMILY)
+  if (is_64_bit) {
+    *instruction_pointer = context.t64.cp0_epc;
+    *stack_pointer = context.t64.regs[29];
+    *frame_pointer = context.t64.regs[30];
+  } else {
+    *instruction_pointer = context.t32.cp0_epc;
+    *stack_pointer = context.t32.regs[29];
+    *frame_pointer = context.t32.regs[30];
+  }
+#else
+#error Port.
+#endif  // ARCH_CPU_X86_FAMILY
+}
+
+class StackSamplesStreamDataSource final
+    : public MinidumpUserExtensionStreamDataSource {
+ public:
+  explicit StackSamplesStreamDataSource(std::string data)
+      : MinidumpUserExtensionStreamDataSource(
+            kMinidumpStreamTypeCrashpadStackSamples),
+        data_(std::move(data)) {}
+
+  StackSamplesStreamDataSource(const StackSamplesStreamDataSource&) = delete;
+  StackSamplesStreamDataSource& operator=(const StackSamplesStreamDataSource&) =
+      delete;
+
+  ~StackSamplesStreamDataSource() override {}
+
+  // MinidumpUserExtensionStreamDataSource:
+  size_t StreamDataSize() override { return data_.size(); }
+
+  bool ReadStreamData(Delegate* delegate) override {
+    return delegate->ExtensionStreamDataSourceRead(data_.data(), data_.size());
+  }
+
+ private:
+  std::string data_;
+};
+
+}  // namespace
+
+StackSampler::ScopedPause::ScopedPause(StackSampler* sampler, pid_t pid)
+    : sampler_(sampler), pid_(pid) {
+  if (!sampler_) {
+    return;
+  }
+
+  // Taking sample_lock_ waits for a sample in progress to finish.
+  base::AutoLock sample_lock(sampler_->sample_lock_);
+  base::AutoLock lock(sampler_->lock_);
+  sampler_->paused_.insert(pid_);
+}
+
+StackSampler::ScopedPause::~ScopedPause() {
+  if (!sampler_) {
+    return;
+  }
+
+  base::AutoLock lock(sampler_->lock_);
+  sampler_->paused_.erase(sampler_->paused_.find(pid_));
+}
+
+StackSampler::StackSampler(double interval, double history, size_t stack_size)
+    : thread_(interval, this),
+      sample_lock_(),
+      lock_(),
+      processes_(),
+      paused_(),
+      history_ns_(static_cast<uint64_t>(history * 1E9)),
+      stack_size_(stack_size) {}
+
+StackSampler::~StackSampler() = default;
+
+bool StackSampler::AddProcess(pid_t pid) {
+  base::AutoLock lock(lock_);
+  if (processes_.find(pid) == processes_.end() &&
+      processes_.size() >= kMaxProcesses) {
+    LOG(ERROR) << "too many sampled processes";
+    return false;
+  }
+  processes_[pid];
+  return true;
+}
+
+void StackSampler::SampleProcesses() {
+  std::vector<pid_t> pids;
+  {
+    base::AutoLock lock(lock_);
+    for (const auto& process : processes_) {
+      pids.push_back(process.first);
+    }
+  }
+
+  for (pid_t pid : pids) {
+    base::AutoLock sample_lock(sample_lock_);
+    {
+      base::AutoLock lock(lock_);
+      if (paused_.find(pid) != paused_.end()) {
+        continue;
+      }
+    }
+
+    // Processes aren’t removed when they exit, so stop sampling those that
+    // have, or that can’t be sampled.
+    std::deque<Sample> samples;
+    const bool sampled = (kill(pid, 0) == 0 || errno != ESRCH) &&
+                         SampleProcess(pid, &samples);
+
+    base::AutoLock lock(lock_);
+    auto process = processes_.find(pid);
+    if (process == processes_.end()) {
+      continue;
+    }
+    if (!sampled) {
+      processes_.erase(process);
+      continue;
+    }
+    std::move(
+        samples.begin(), samples.end(), std::back_inserter(process->second));
+    DiscardOldSamples(&process->second, ClockMonotonicNanoseconds());
+  }
+}
+
+std::unique_ptr<MinidumpUserExtensionStreamDataSource>
+StackSampler::CreateStreamDataSource(pid_t pid) {
+  base::AutoLock lock(lock_);
+  auto process = processes_.find(pid);
+  if (process == processes_.end()) {
+    return nullptr;
+  }
+
+  const uint64_t now_ns = ClockMonotonicNanoseconds();
+  DiscardOldSamples(&process->second, now_ns);
+  const std::deque<Sample>& samples = process->second;
+  if (samples.empty()) {
+    return nullptr;
+  }
+
+  MinidumpStackSampleList header = {};
+  header.SizeOfHeader = sizeof(header);
+  header.SizeOfEntry = sizeof(MinidumpStackSample);
+  header.NumberOfEntries = static_cast<uint32_t>(samples.size());
+
+  std::string data(reinterpret_cast<const char*>(&header), sizeof(header));
+  size_t stack_offset =
+      sizeof(header) + samples.size() * sizeof(MinidumpStackSample);
+  for (const Sample& sample : samples) {
+    MinidumpStackSample entry = {};
+    entry.ThreadId = sample.thread_id;
+    entry.Age = now_ns - sample.time_ns;
+    entry.InstructionPointer = sample.instruction_pointer;
+    entry.StackPointer = sample.stack_pointer;
+    entry.FramePointer = sample.frame_pointer;
+    entry.StackOffset = static_cast<uint32_t>(stack_offset);
+    entry.StackSize = static_cast<uint32_t>(sample.stack.size());
+    data.append(reinterpret_cast<const char*>(&entry), sizeof(entry));
+    stack_offset += sample.stack.size();
+  }
+  for (const Sample& sample : samples) {
+    data.append(sample.stack);
+  }
+
+  return std::make_unique<StackSamplesStreamDataSource>(std::move(data));
+}
+
+void StackSampler::Start() {
+  thread_.Start(0);
+}
+
+void StackSampler::Stop() {
+  thread_.Stop();
+}
+
+void StackSampler::DoWork(const WorkerThread* thread) {
+  SampleProcesses();
+}
+
+bool StackSampler::SampleProcess(pid_t pid, std::deque<Sample>* samples) {
+  std::vector<pid_t> thread_ids;
+  if (!ReadThreadIDs(pid, &thread_ids)) {
+    return false;
+  }
+
+  ScopedFileHandle mem_fd(HANDLE_EINTR(
+      open(base::StringPrintf("/proc/%d/mem", pid).c_str(),
+           O_RDONLY | O_CLOEXEC)));
+  if (!mem_fd.is_valid()) {
+    PLOG(ERROR) << "open";
+    return false;
+  }
+
+  Ptracer ptracer(/* can_log= */ false);
+  bool ptracer_initialized = false;
+  std::vector<char> stack(stack_size_);
+  for (pid_t thread_id : thread_ids) {
+    // Threads may exit while the process is being sampled, so failures to
+    // sample a thread are expected, and aren’t logged.
+    if (!PtraceAttach(thread_id, /* can_log= */ false)) {
+      continue;
+    }
+
+    // Only the registers and the top of the stack are read while the thread is
+    // stopped.
+    ThreadInfo info;
+    if (!ptracer_initialized) {
+      ptracer_initialized = ptracer.Initialize(thread_id);
+    }
+    const bool got_info =
+        ptracer_initialized && ptracer.GetThreadInfo(thread_id, &info);
+    Sample sample;
+    ssize_t stack_read = 0;
+    if (got_info) {
+      GetFrameRegisters(info.thread_context,
+                        ptracer.Is64Bit(),
+                        &sample.instruction_pointer,
+                        &sample.stack_pointer,
+                        &sample.frame_pointer);
+      if (!stack.empty()) {
+        stack_read = HANDLE_EINTR(pread64(
+            mem_fd.get(), stack.data(), stack.size(), sample.stack_pointer));
+      }
+    }
+    PtraceDetach(thread_id, /* can_log= */ false);
+
+    if (!got_info) {
+      continue;
+    }
+    sample.time_ns = ClockMonotonicNanoseconds();
+    sample.thread_id = thread_id;
+    if (stack_read > 0) {
+      sample.stack.assign(stack.data(), stack_read);
+    }
+    samples->push_back(std::move(sample));
+  }
+  return true;
+}
+
+void StackSampler::DiscardOldSamples(std::deque<Sample>* samples,
+                                     uint64_t now_ns) {
+  lock_.AssertAcquired();
+  while (!samples->empty() &&
+         (samples->size() > kMaxSamplesPerProcess ||
+          now_ns - samples->front().time_ns > history_ns_)) {
+    samples->pop_front();
+  }
+}
+
+}  // namespace crashpad
@@ -0,0 +1,141 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_HANDLER_LINUX_STACK_SAMPLER_H_
+#define CRASHPAD_HANDLER_LINUX_STACK_SAMPLER_H_
+
+#include <stdint.h>
+#include <sys/types.h>
+
+#include <deque>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+
+#include "base/synchronization/lock.h"
+#include "util/thread/stoppable.h"
+#include "util/thread/worker_thread.h"
+
+namespace crashpad {
+
+class MinidumpUserExtensionStreamDataSource;
+
+//! \brief Periodically samples the registers and the top of the stack of every
+//!     thread of registered processes, so that what a process was doing just
+//!     before it crashed or hung can be added to its report.
+//!
+//! Each thread is stopped with `ptrace` only for as long as it takes to read
+//! its registers and a bounded window of its stack. Samples older than the
+//! history kept are discarded, and processes are forgotten once they exit.
+//!
+//! Sampling must be paused with ScopedPause while a process is being dumped,
+//! because a thread can only be attached by one tracer at a time.
+//!
+//! This class is thread-safe.
+class StackSampler final : public WorkerThread::Delegate, public Stoppable {
+ public:
+  //! \brief Keeps a process from being sampled while this object exists.
+  //!
+  //! Construction waits for a sample of the process in progress to finish.
+  class ScopedPause {
+   public:
+    //! \param[in] sampler The sampler to pause. May be `nullptr`, in which case
+    //!     this object does nothing.
+    //! \param[in] pid The process not to sample.
+    ScopedPause(StackSampler* sampler, pid_t pid);
+
+    ScopedPause(const ScopedPause&) = delete;
+    ScopedPause& operator=(const ScopedPause&) = delete;
+
+    ~ScopedPause();
+
+   private:
+    StackSampler* sampler_;  // weak
+    pid_t pid_;
+  };
+
+  //! \brief The default number of bytes of each thread’s stack to capture.
+  static constexpr size_t kDefaultStackSize = 1024;
+
+  //! \param[in] interval The number of seconds between samples of each
+  //!     process.
+  //! \param[in] history The number of seconds for which samples are kept.
+  //! \param[in] stack_size The most bytes of each thread’s stack to capture,
+  //!     starting at its stack pointer.
+  StackSampler(double interval, double history, size_t stack_size);
+
+  StackSampler(const StackSampler&) = delete;
+  StackSampler& operator=(const StackSampler&) = delete;
+
+  ~StackSampler() override;
+
+  //! \brief Begins sampling the threads of the process \a pid.
+  //!
+  //! \return `true` on success. `false` on failure with a message logged.
+  bool AddProcess(pid_t pid);
+
+  //! \brief Samples every registered process that isn’t paused.
+  //!
+  //! This is called on the sampler’s thread every interval once started.
+  void SampleProcesses();
+
+  //! \brief Returns a data source for a ::kMinidumpStreamTypeCrashpadStackSamples
+  //!     stream of the samples kept for \a pid, or `nullptr` if there are none.
+  std::unique_ptr<MinidumpUserExtensionStreamDataSource> CreateStreamDataSource(
+      pid_t pid);
+
+  // Stoppable:
+
+  //! \brief Starts sampling on a background thread.
+  void Start() override;
+
+  //! \brief Stops sampling, waiting for a sample in progress to finish.
+  void Stop() override;
+
+ private:
+  struct Sample {
+    uint64_t time_ns;
+    uint64_t instruction_pointer;
+    uint64_t stack_pointer;
+    uint64_t frame_pointer;
+    std::string stack;
+    pid_t thread_id;
+  };
+
+  // WorkerThread::Delegate:
+  void DoWork(const WorkerThread* thread) override;
+
+  bool SampleProcess(pid_t pid, std::deque<Sample>* samples);
+
+  // lock_ must be held.
+  void DiscardOldSamples(std::deque<Sample>* samples, uint64_t now_ns);
+
+  WorkerThread thread_;
+
+  // Held while a process is being sampled, and acquired before lock_.
+  base::Lock sample_lock_;
+
+  // Protects processes_ and paused_.
+  base::Lock lock_;
+  std::map<pid_t, std::deque<Sample>> processes_;
+  std::multiset<pid_t> paused_;
+
+  const uint64_t history_ns_;
+  const size_t stack_size_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_HANDLER_LINUX_STACK_SAMPLER_H_
@@ -0,0 +1,143 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "handler/linux/stack_sampler.h"
+
+#include <string.h>
+#include <unistd.h>
+
+#include <memory>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "minidump/minidump_extensions.h"
+#include "minidump/minidump_user_extension_stream_data_source.h"
+#include "test/multiprocess.h"
+#include "util/file/file_io.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+class StreamDataReader
+    : public MinidumpUserExtensionStreamDataSource::Delegate {
+ public:
+  StreamDataReader() : data_() {}
+
+  StreamDataReader(const StreamDataReader&) = delete;
+  StreamDataReader& operator=(const StreamDataReader&) = delete;
+
+  ~StreamDataReader() {}
+
+  bool ExtensionStreamDataSourceRead(const void* data, size_t size) override {
+    data_.append(static_cast<const char*>(data), size);
+    return true;
+  }
+
+  const std::string& data() const { return data_; }
+
+ private:
+  std::string data_;
+};
+
+class SampleChildTest : public Multiprocess {
+ public:
+  SampleChildTest() : Multiprocess() {}
+
+  SampleChildTest(const SampleChildTest&) = delete;
+  SampleChildTest& operator=(const SampleChildTest&) = delete;
+
+  ~SampleChildTest() {}
+
+ private:
+  void MultiprocessParent() override {
+    constexpr size_t kStackSize = 256;
+    StackSampler sampler(1, 60, kStackSize);
+    ASSERT_TRUE(sampler.AddProcess(ChildPID()));
+
+    // A paused process isn’t sampled.
+    {
+      StackSampler::ScopedPause pause(&sampler, ChildPID());
+      sampler.SampleProcesses();
+      EXPECT_FALSE(sampler.CreateStreamDataSource(ChildPID()));
+    }
+
+    sampler.SampleProcesses();
+    sampler.SampleProcesses();
+    std::unique_ptr<MinidumpUserExtensionStreamDataSource> data_source =
+        sampler.CreateStreamDataSource(ChildPID());
+    ASSERT_TRUE(data_source);
+    EXPECT_EQ(data_source->stream_type(),
+              kMinidumpStreamTypeCrashpadStackSamples);
+
+    StreamDataReader reader;
+    ASSERT_TRUE(data_source->ReadStreamData(&reader));
+    const std::string& data = reader.data();
+    ASSERT_EQ(data.size(), data_source->StreamDataSize());
+
+    MinidumpStackSampleList list;
+    ASSERT_GE(data.size(), sizeof(list));
+    memcpy(&list, data.data(), sizeof(list));
+    EXPECT_EQ(list.SizeOfHeader, sizeof(MinidumpStackSampleList));
+    EXPECT_EQ(list.SizeOfEntry, sizeof(MinidumpStackSample));
+
+    // The child has one thread, sampled twice.
+    ASSERT_EQ(list.NumberOfEntries, 2u);
+    ASSERT_GE(data.size(), sizeof(list) + 2 * sizeof(MinidumpStackSample));
+    uint64_t last_age = static_cast<uint64_t>(-1);
+    for (size_t index = 0; index < list.NumberOfEntries; ++index) {
+      SCOPED_TRACE(index);
+      MinidumpStackSample sample;
+      memcpy(&sample,
+             data.data() + sizeof(list) + index * sizeof(sample),
+             sizeof(sample));
+      EXPECT_EQ(sample.ThreadId, static_cast<uint32_t>(ChildPID()));
+      EXPECT_NE(sample.InstructionPointer, 0u);
+      EXPECT_NE(sample.StackPointer, 0u);
+      EXPECT_GT(sample.StackSize, 0u);
+      EXPECT_LE(sample.StackSize, kStackSize);
+      EXPECT_LE(sample.StackOffset + sample.StackSize, data.size());
+
+      // Samples are ordered oldest first.
+      EXPECT_LE(sample.Age, last_age);
+      last_age = sample.Age;
+    }
+
+    // Let the child exit.
+    CloseWritePipe();
+    CheckedReadFileAtEOF(ReadPipeHandle());
+  }
+
+  void MultiprocessChild() override {
+    CheckedReadFileAtEOF(ReadPipeHandle());
+    CloseWritePipe();
+  }
+};
+
+TEST(StackSampler, SampleChild) {
+  SampleChildTest test;
+  test.Run();
+}
+
+TEST(StackSampler, NoSamples) {
+  StackSampler sampler(1, 60, 256);
+  EXPECT_FALSE(sampler.CreateStreamDataSource(getpid()));
+
+  sampler.Start();
+  sampler.Stop();
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
@@ -27,7 +27,7 @@
 #include "minidump/minidump_user_extension_stream_data_source.h"
 #include "snapshot/crashpad_info_client_options.h"
 #include "snapshot/mac/process_snapshot_mac.h"
-#include "util/file/file_helper.h"
+#include "util/file/file_io.h"
 #include "util/file/file_writer.h"
 #include "util/mach/bootstrap.h"
 #include "util/mach/exc_client_variants.h"
@@ -38,11 +38,21 @@
 #include "util/mach/scoped_task_suspend.h"
 #include "util/mach/symbolic_constants_mach.h"
 #include "util/misc/metrics.h"
+#include "util/misc/trace_events.h"
 #include "util/misc/tri_state.h"
 #include "util/misc/uuid.h"
 
 namespace crashpad {
 
+namespace {
+
+// The memory used to keep the headers of images in the dyld shared cache
+// across all clients, which is enough for the images that most processes load
+// from it.
+constexpr size_t kImageHeaderCacheBytes = 4 * 1024 * 1024;
+
+}  // namespace
+
 CrashReportExceptionHandler::CrashReportExceptionHandler(
     CrashReportDatabase* database,
     CrashReportUploadThread* upload_thread,
@@ -53,7 +63,10 @@ CrashReportExceptionHandler::CrashReportExceptionHandler(
       upload_thread_(upload_thread),
       process_annotations_(process_annotations),
       attachments_(attachments),
-      user_stream_data_sources_(user_stream_data_sources) {}
+      user_stream_data_sources_(user_stream_data_sources),
+      thread_snapshot_threads_(1),
+      clone_non_fatal_dumps_(false),
+      image_header_cache_(kImageHeaderCacheBytes) {}
 
 CrashReportExceptionHandler::~CrashReportExceptionHandler() {
 }
@@ -106,7 +119,8 @@ kern_return_t CrashReportExceptionHandler::CatchMachException(
   ScopedTaskSuspend suspend(task);
 
   ProcessSnapshotMac process_snapshot;
-  if (!process_snapshot.Initialize(task)) {
+  if (!process_snapshot.Initialize(
+          task, thread_snapshot_threads_, &image_header_cache_)) {
     Metrics::ExceptionCaptureResult(Metrics::CaptureResult::kSnapshotFailed);
     return KERN_FAILURE;
   }
@@ -119,6 +133,7 @@ kern_return_t CrashReportExceptionHandler::CatchMachException(
   // kernel to be suspicious, and exceptions other than kMachExceptionSimulated
   // from the process itself to be suspicious.
   const pid_t pid = process_snapshot.ProcessID();
+  TraceEvents::ScopedContext trace_context(pid);
   pid_t audit_pid = AuditPIDFromMachMessageTrailer(trailer);
   if (audit_pid != -1 && audit_pid != 0) {
     if (audit_pid != pid) {
@@ -165,40 +180,52 @@ kern_return_t CrashReportExceptionHandler::CatchMachException(
     }
 
     process_snapshot.SetReportID(new_report->ReportID());
+    TraceEvents::SetReportID(new_report->ReportID());
 
     MinidumpFileWriter minidump;
     minidump.InitializeFromSnapshot(&process_snapshot);
     AddUserExtensionStreams(
         user_stream_data_sources_, &process_snapshot, &minidump);
 
+    // Everything but the contents of memory has been read. A client that’s
+    // only simulating a crash can be resumed once that memory is preserved.
+    if (clone_non_fatal_dumps_ && exception == kMachExceptionSimulated) {
+      process_snapshot.PreserveMemory();
+      suspend.Resume();
+    }
+
     if (!minidump.WriteEverything(new_report->Writer())) {
       Metrics::ExceptionCaptureResult(
           Metrics::CaptureResult::kMinidumpWriteFailed);
       return KERN_FAILURE;
     }
 
-    for (const auto& attachment : (*attachments_)) {
-      FileReader file_reader;
-      if (!file_reader.Open(attachment)) {
-        LOG(ERROR) << "attachment " << attachment.value().c_str()
-                  << " couldn't be opened, skipping";
-        continue;
-      }
+    if (!attachments_->empty()) {
+      TraceEvents::ScopedEvent attachments_event("CopyAttachments");
+      for (const auto& attachment : (*attachments_)) {
+        ScopedFileHandle attachment_file(LoggingOpenFileForRead(attachment));
+        if (!attachment_file.is_valid()) {
+          LOG(ERROR) << "attachment " << attachment.value().c_str()
+                     << " couldn't be opened, skipping";
+          continue;
+        }
 
-      base::FilePath filename = attachment.BaseName();
-      FileWriter* file_writer = new_report->AddAttachment(filename.value());
-      if (file_writer == nullptr) {
-        LOG(ERROR) << "attachment " << filename.value().c_str()
-                  << " couldn't be created, skipping";
-        continue;
+        base::FilePath filename = attachment.BaseName();
+        if (!new_report->AddAttachmentFromFile(filename.value(),
+                                               attachment_file.get())) {
+          LOG(ERROR) << "attachment " << filename.value().c_str()
+                     << " couldn't be created, skipping";
+          continue;
+        }
       }
-
-      CopyFileContent(&file_reader, file_writer);
     }
 
     UUID uuid;
-    database_status =
-        database_->FinishedWritingCrashReport(std::move(new_report), &uuid);
+    {
+      TraceEvents::ScopedEvent commit_event("DatabaseCommit");
+      database_status =
+          database_->FinishedWritingCrashReport(std::move(new_report), &uuid);
+    }
     if (database_status != CrashReportDatabase::kNoError) {
       Metrics::ExceptionCaptureResult(
           Metrics::CaptureResult::kFinishedWritingCrashReportFailed);
@@ -23,6 +23,7 @@
 #include "client/crash_report_database.h"
 #include "handler/crash_report_upload_thread.h"
 #include "handler/user_stream_data_source.h"
+#include "snapshot/mac/mach_o_image_header_cache.h"
 #include "util/mach/exc_server_variants.h"
 
 namespace crashpad {
@@ -67,6 +68,29 @@ class CrashReportExceptionHandler final
 
   ~CrashReportExceptionHandler();
 
+  //! \brief Sets the number of threads used to gather information about a
+  //!     client’s threads.
+  //!
+  //! See ProcessSnapshotMac::Initialize(). The default is `1`.
+  //!
+  //! This must be called before the handler begins handling exceptions.
+  void SetThreadSnapshotThreads(unsigned int thread_snapshot_threads) {
+    thread_snapshot_threads_ = thread_snapshot_threads;
+  }
+
+  //! \brief Sets whether clients that simulate crashes are resumed before
+  //!     their minidumps are written.
+  //!
+  //! When enabled, once a client that raised #kMachExceptionSimulated has been
+  //! snapshotted, the memory that the minidump will contain is preserved with
+  //! ProcessSnapshotMac::PreserveMemory() and the client is resumed. Clients
+  //! with other exceptions stay suspended until their reports are written.
+  //!
+  //! This must be called before the handler begins handling exceptions.
+  void SetCloneNonFatalDumps(bool clone_non_fatal_dumps) {
+    clone_non_fatal_dumps_ = clone_non_fatal_dumps;
+  }
+
   // UniversalMachExcServer::Interface:
 
   //! \brief Processes an exception message by writing a crash report to this
@@ -93,6 +117,9 @@ class CrashReportExceptionHandler final
   const std::map<std::string, std::string>* process_annotations_;  // weak
   const std::vector<base::FilePath>* attachments_;  // weak
   const UserStreamDataSources* user_stream_data_sources_;  // weak
+  unsigned int thread_snapshot_threads_;
+  bool clone_non_fatal_dumps_;
+  MachOImageHeaderCache image_header_cache_;
 };
 
 }  // namespace crashpad
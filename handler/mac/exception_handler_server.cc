@@ -14,26 +14,63 @@
 
 #include "handler/mac/exception_handler_server.h"
 
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <memory>
 #include <utility>
+#include <vector>
 
 #include "base/logging.h"
 #include "base/mac/mach_logging.h"
+#include "base/synchronization/lock.h"
 #include "util/mach/composite_mach_message_server.h"
 #include "util/mach/mach_extensions.h"
 #include "util/mach/mach_message.h"
 #include "util/mach/mach_message_server.h"
 #include "util/mach/notify_server.h"
+#include "util/thread/thread.h"
 
 namespace crashpad {
 
 namespace {
 
+// Sends a synthesized no-senders notification to notify_port, which causes a
+// thread receiving messages for ExceptionHandlerServerRun to stop running.
+void SendNoSendersNotification(mach_port_t notify_port) {
+  // mach_no_senders_notification_t defines the receive side of this structure,
+  // with a trailer element that’s undesirable for the send side.
+  struct {
+    mach_msg_header_t header;
+    NDR_record_t ndr;
+    mach_msg_type_number_t mscount;
+  } no_senders_notification = {};
+  no_senders_notification.header.msgh_bits =
+      MACH_MSGH_BITS(MACH_MSG_TYPE_MAKE_SEND_ONCE, 0);
+  no_senders_notification.header.msgh_size = sizeof(no_senders_notification);
+  no_senders_notification.header.msgh_remote_port = notify_port;
+  no_senders_notification.header.msgh_local_port = MACH_PORT_NULL;
+  no_senders_notification.header.msgh_id = MACH_NOTIFY_NO_SENDERS;
+  no_senders_notification.ndr = NDR_record;
+  no_senders_notification.mscount = 0;
+
+  kern_return_t kr = mach_msg(&no_senders_notification.header,
+                              MACH_SEND_MSG,
+                              sizeof(no_senders_notification),
+                              0,
+                              MACH_PORT_NULL,
+                              MACH_MSG_TIMEOUT_NONE,
+                              MACH_PORT_NULL);
+  MACH_CHECK(kr == KERN_SUCCESS, kr) << "mach_msg";
+}
+
 class ExceptionHandlerServerRun : public UniversalMachExcServer::Interface,
                                   public NotifyServer::DefaultInterface {
  public:
   ExceptionHandlerServerRun(
       mach_port_t exception_port,
       mach_port_t notify_port,
+      size_t max_concurrent_dumps,
       bool launchd,
       UniversalMachExcServer::Interface* exception_interface)
       : UniversalMachExcServer::Interface(),
@@ -41,9 +78,14 @@ class ExceptionHandlerServerRun : public UniversalMachExcServer::Interface,
         mach_exc_server_(this),
         notify_server_(this),
         composite_mach_message_server_(),
+        server_port_set_(),
+        clients_lock_(),
+        clients_(),
         exception_interface_(exception_interface),
         exception_port_(exception_port),
         notify_port_(notify_port),
+        receive_threads_(std::max(max_concurrent_dumps, size_t{1})),
+        receiving_threads_(0),
         running_(true),
         launchd_(launchd) {
     composite_mach_message_server_.AddHandler(&mach_exc_server_);
@@ -84,39 +126,32 @@ class ExceptionHandlerServerRun : public UniversalMachExcServer::Interface,
     // from ever existing. Using distinct receive rights also allows the handler
     // methods to ensure that the messages they process were sent by a holder of
     // the proper send right.
-    base::mac::ScopedMachPortSet server_port_set(
-        NewMachPort(MACH_PORT_RIGHT_PORT_SET));
-    CHECK(server_port_set.is_valid());
+    server_port_set_.reset(NewMachPort(MACH_PORT_RIGHT_PORT_SET));
+    CHECK(server_port_set_.is_valid());
 
     kr = mach_port_insert_member(
-        mach_task_self(), exception_port_, server_port_set.get());
+        mach_task_self(), exception_port_, server_port_set_.get());
     MACH_CHECK(kr == KERN_SUCCESS, kr) << "mach_port_insert_member";
 
     kr = mach_port_insert_member(
-        mach_task_self(), notify_port_, server_port_set.get());
+        mach_task_self(), notify_port_, server_port_set_.get());
     MACH_CHECK(kr == KERN_SUCCESS, kr) << "mach_port_insert_member";
 
-    // Run the server in kOneShot mode so that running_ can be reevaluated after
-    // each message. Receipt of a valid no-senders notification causes it to be
-    // set to false.
-    while (running_) {
-      // This will result in a call to CatchMachException() or
-      // DoMachNotifyNoSenders() as appropriate.
-      mach_msg_return_t mr =
-          MachMessageServer::Run(&composite_mach_message_server_,
-                                 server_port_set.get(),
-                                 kMachMessageReceiveAuditTrailer,
-                                 MachMessageServer::kOneShot,
-                                 MachMessageServer::kReceiveLargeIgnore,
-                                 kMachMessageTimeoutWaitIndefinitely);
+    // Every thread receives from the same port set, so the kernel hands each
+    // message to whichever thread is waiting for one. Messages that arrive
+    // while every thread is busy stay queued on their receive right, up to its
+    // queue limit, after which senders wait.
+    receiving_threads_ = receive_threads_;
+    std::vector<std::unique_ptr<ReceiveThread>> threads;
+    for (size_t index = 1; index < receive_threads_; ++index) {
+      threads.push_back(std::make_unique<ReceiveThread>(this));
+      threads.back()->Start();
+    }
 
-      // MACH_SEND_INVALID_DEST occurs when attempting to reply to a dead name.
-      // This can happen if a mach_exc or exc client disappears before a reply
-      // can be sent to it. That’s unusal for kernel-generated requests, but can
-      // easily happen if a task sends its own exception request (as
-      // SimulateCrash() does) and dies before the reply is sent.
-      MACH_CHECK(mr == MACH_MSG_SUCCESS || mr == MACH_SEND_INVALID_DEST, mr)
-          << "MachMessageServer::Run";
+    ReceiveMessages();
+
+    for (auto& thread : threads) {
+      thread->Join();
     }
   }
 
@@ -141,20 +176,29 @@ class ExceptionHandlerServerRun : public UniversalMachExcServer::Interface,
       return KERN_FAILURE;
     }
 
-    return exception_interface_->CatchMachException(behavior,
-                                                    exception_port,
-                                                    thread,
-                                                    task,
-                                                    exception,
-                                                    code,
-                                                    code_count,
-                                                    flavor,
-                                                    old_state,
-                                                    old_state_count,
-                                                    new_state,
-                                                    new_state_count,
-                                                    trailer,
-                                                    destroy_complex_request);
+    ClientDispatch* dispatch =
+        receive_threads_ > 1 ? BeginClientDispatch(task) : nullptr;
+
+    kern_return_t kr =
+        exception_interface_->CatchMachException(behavior,
+                                                 exception_port,
+                                                 thread,
+                                                 task,
+                                                 exception,
+                                                 code,
+                                                 code_count,
+                                                 flavor,
+                                                 old_state,
+                                                 old_state_count,
+                                                 new_state,
+                                                 new_state_count,
+                                                 trailer,
+                                                 destroy_complex_request);
+
+    if (dispatch) {
+      EndClientDispatch(task, dispatch);
+    }
+    return kr;
   }
 
   // NotifyServer::DefaultInterface:
@@ -179,13 +223,117 @@ class ExceptionHandlerServerRun : public UniversalMachExcServer::Interface,
   }
 
  private:
+  // Runs ReceiveMessages() on a thread in addition to the one calling Run().
+  class ReceiveThread : public Thread {
+   public:
+    explicit ReceiveThread(ExceptionHandlerServerRun* run)
+        : Thread(), run_(run) {}
+
+    ReceiveThread(const ReceiveThread&) = delete;
+    ReceiveThread& operator=(const ReceiveThread&) = delete;
+
+    ~ReceiveThread() override {}
+
+   private:
+    // Thread:
+    void ThreadMain() override { run_->ReceiveMessages(); }
+
+    ExceptionHandlerServerRun* run_;  // weak
+  };
+
+  // Serializes the exceptions of one task.
+  struct ClientDispatch {
+    ClientDispatch() : lock(), users(0) {}
+
+    // Held while one of the task’s exceptions is being handled.
+    base::Lock lock;
+
+    // The number of threads handling or waiting to handle one of the task’s
+    // exceptions. Guarded by clients_lock_.
+    size_t users;
+  };
+
+  // Receives and handles messages on the calling thread until running_ is
+  // cleared.
+  void ReceiveMessages() {
+    // Run the server in kOneShot mode so that running_ can be reevaluated after
+    // each message. Receipt of a valid no-senders notification causes it to be
+    // set to false.
+    while (running_) {
+      // This will result in a call to CatchMachException() or
+      // DoMachNotifyNoSenders() as appropriate.
+      mach_msg_return_t mr =
+          MachMessageServer::Run(&composite_mach_message_server_,
+                                 server_port_set_.get(),
+                                 kMachMessageReceiveAuditTrailer,
+                                 MachMessageServer::kOneShot,
+                                 MachMessageServer::kReceiveLargeIgnore,
+                                 kMachMessageTimeoutWaitIndefinitely);
+
+      // MACH_SEND_INVALID_DEST occurs when attempting to reply to a dead name.
+      // This can happen if a mach_exc or exc client disappears before a reply
+      // can be sent to it. That’s unusal for kernel-generated requests, but can
+      // easily happen if a task sends its own exception request (as
+      // SimulateCrash() does) and dies before the reply is sent.
+      MACH_CHECK(mr == MACH_MSG_SUCCESS || mr == MACH_SEND_INVALID_DEST, mr)
+          << "MachMessageServer::Run";
+    }
+
+    // Only the thread that received the no-senders notification saw it. Each
+    // thread that stops wakes one that may still be waiting for a message, so
+    // that all of them stop.
+    if (--receiving_threads_ > 0) {
+      SendNoSendersNotification(notify_port_);
+    }
+  }
+
+  // Waits until no other thread is handling an exception for task, and returns
+  // the ClientDispatch to pass to EndClientDispatch() once this thread is done
+  // handling its exception.
+  ClientDispatch* BeginClientDispatch(task_t task) {
+    ClientDispatch* dispatch;
+    {
+      base::AutoLock lock(clients_lock_);
+      std::unique_ptr<ClientDispatch>& client = clients_[task];
+      if (!client) {
+        client = std::make_unique<ClientDispatch>();
+      }
+      ++client->users;
+      dispatch = client.get();
+    }
+
+    dispatch->lock.Acquire();
+    return dispatch;
+  }
+
+  void EndClientDispatch(task_t task, ClientDispatch* dispatch) {
+    dispatch->lock.Release();
+
+    base::AutoLock lock(clients_lock_);
+    if (--dispatch->users == 0) {
+      clients_.erase(task);
+    }
+  }
+
   UniversalMachExcServer mach_exc_server_;
   NotifyServer notify_server_;
   CompositeMachMessageServer composite_mach_message_server_;
+  base::mac::ScopedMachPortSet server_port_set_;
+
+  // Guards clients_ and each ClientDispatch::users.
+  base::Lock clients_lock_;
+
+  // Tasks with exceptions being handled, by task port name. A task’s port has
+  // the same name in this task for as long as a right to it is held, and one is
+  // held by each of its exception messages that is being handled.
+  std::map<task_t, std::unique_ptr<ClientDispatch>> clients_;
+
   UniversalMachExcServer::Interface* exception_interface_;  // weak
   mach_port_t exception_port_;  // weak
   mach_port_t notify_port_;  // weak
-  bool running_;
+  const size_t receive_threads_;
+  std::atomic<size_t> receiving_threads_;
+  std::atomic<bool> running_;
   bool launchd_;
 };
 
@@ -196,6 +344,7 @@ ExceptionHandlerServer::ExceptionHandlerServer(
     bool launchd)
     : receive_port_(std::move(receive_port)),
       notify_port_(NewMachPort(MACH_PORT_RIGHT_RECEIVE)),
+      max_concurrent_dumps_(1),
       launchd_(launchd) {
   CHECK(receive_port_.is_valid());
   CHECK(notify_port_.is_valid());
@@ -204,41 +353,25 @@ ExceptionHandlerServer::ExceptionHandlerServer(
 ExceptionHandlerServer::~ExceptionHandlerServer() {
 }
 
+void ExceptionHandlerServer::SetMaxConcurrentDumps(
+    size_t max_concurrent_dumps) {
+  max_concurrent_dumps_ = max_concurrent_dumps;
+}
+
 void ExceptionHandlerServer::Run(
     UniversalMachExcServer::Interface* exception_interface) {
-  ExceptionHandlerServerRun run(
-      receive_port_.get(), notify_port_.get(), launchd_, exception_interface);
+  ExceptionHandlerServerRun run(receive_port_.get(),
+                                notify_port_.get(),
+                                max_concurrent_dumps_,
+                                launchd_,
+                                exception_interface);
   run.Run();
 }
 
 void ExceptionHandlerServer::Stop() {
   // Cause the exception handler server to stop running by sending it a
   // synthesized no-senders notification.
-  //
-  // mach_no_senders_notification_t defines the receive side of this structure,
-  // with a trailer element that’s undesirable for the send side.
-  struct {
-    mach_msg_header_t header;
-    NDR_record_t ndr;
-    mach_msg_type_number_t mscount;
-  } no_senders_notification = {};
-  no_senders_notification.header.msgh_bits =
-      MACH_MSGH_BITS(MACH_MSG_TYPE_MAKE_SEND_ONCE, 0);
-  no_senders_notification.header.msgh_size = sizeof(no_senders_notification);
-  no_senders_notification.header.msgh_remote_port = notify_port_.get();
-  no_senders_notification.header.msgh_local_port = MACH_PORT_NULL;
-  no_senders_notification.header.msgh_id = MACH_NOTIFY_NO_SENDERS;
-  no_senders_notification.ndr = NDR_record;
-  no_senders_notification.mscount = 0;
-
-  kern_return_t kr = mach_msg(&no_senders_notification.header,
-                              MACH_SEND_MSG,
-                              sizeof(no_senders_notification),
-                              0,
-                              MACH_PORT_NULL,
-                              MACH_MSG_TIMEOUT_NONE,
-                              MACH_PORT_NULL);
-  MACH_CHECK(kr == KERN_SUCCESS, kr) << "mach_msg";
+  SendNoSendersNotification(notify_port_.get());
 }
 
 }  // namespace crashpad
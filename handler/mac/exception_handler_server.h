@@ -16,6 +16,7 @@
 #define CRASHPAD_HANDLER_MAC_EXCEPTION_HANDLER_SERVER_H_
 
 #include <mach/mach.h>
+#include <stddef.h>
 
 #include "base/mac/scoped_mach_port.h"
 #include "util/mach/exc_server_variants.h"
@@ -42,6 +43,24 @@ class ExceptionHandlerServer {
 
   ~ExceptionHandlerServer();
 
+  //! \brief Sets the maximum number of exception messages that may be handled
+  //!     at once.
+  //!
+  //! By default, exception messages are received and handled one at a time on
+  //! the thread that calls Run(). When \a max_concurrent_dumps is greater than
+  //! 1, Run() starts additional threads so that \a max_concurrent_dumps
+  //! threads receive messages from the receive port, and a slow capture of one
+  //! client doesn’t delay exceptions in other clients. Exception messages for a task
+  //! that is already being handled wait for that to finish, so that each
+  //! client’s exceptions are still handled one at a time and in order.
+  //!
+  //! This method must be called before Run().
+  //!
+  //! \param[in] max_concurrent_dumps The number of threads to receive and
+  //!     handle exception messages on. Values of 0 and 1 both handle them on
+  //!     the Run() thread only.
+  void SetMaxConcurrentDumps(size_t max_concurrent_dumps);
+
   //! \brief Runs the exception-handling server.
   //!
   //! \param[in] exception_interface An object to send exception messages to.
@@ -54,7 +73,10 @@ class ExceptionHandlerServer {
   //! queued by `mach_msg()` to be sent to a client) prior to calling this
   //! method, or it will detect that it is sender-less and return immediately.
   //!
-  //! All exception messages will be passed to \a exception_interface.
+  //! All exception messages will be passed to \a exception_interface. If
+  //! SetMaxConcurrentDumps() was called with a value greater than 1, this may
+  //! happen on several threads at once, which \a exception_interface must
+  //! support.
   //!
   //! This method must only be called once on an ExceptionHandlerServer object.
   //!
@@ -75,6 +97,7 @@ class ExceptionHandlerServer {
  private:
   base::mac::ScopedMachReceiveRight receive_port_;
   base::mac::ScopedMachReceiveRight notify_port_;
+  size_t max_concurrent_dumps_;
   bool launchd_;
 };
 
@@ -29,6 +29,10 @@ PruneCrashReportThread::PruneCrashReportThread(
 
 PruneCrashReportThread::~PruneCrashReportThread() {}
 
+void PruneCrashReportThread::SetWorkScheduler(WorkScheduler* scheduler) {
+  thread_.SetScheduler(scheduler);
+}
+
 void PruneCrashReportThread::Start() {
   thread_.Start(60 * 10);
 }
@@ -39,7 +43,7 @@ void PruneCrashReportThread::Stop() {
 
 void PruneCrashReportThread::DoWork(const WorkerThread* thread) {
   database_->CleanDatabase(60 * 60 * 24 * 3);
-  PruneCrashReportDatabase(database_, condition_.get());
+  PruneCrashReportDatabaseIncrementally(database_, condition_.get());
 }
 
 }  // namespace crashpad
@@ -24,6 +24,7 @@ namespace crashpad {
 
 class CrashReportDatabase;
 class PruneCondition;
+class WorkScheduler;
 
 //! \brief A thread that periodically prunes crash reports from the database
 //!     using the specified condition.
@@ -46,6 +47,16 @@ class PruneCrashReportThread : public WorkerThread::Delegate, public Stoppable {
 
   ~PruneCrashReportThread();
 
+  //! \brief Runs the pruning work on the threads of \a scheduler instead of a
+  //!     dedicated thread.
+  //!
+  //! This method may only be called before Start(). \a scheduler must outlive
+  //! this object.
+  //!
+  //! \param[in] scheduler The scheduler to use, or `nullptr` to use a
+  //!     dedicated thread.
+  void SetWorkScheduler(WorkScheduler* scheduler);
+
   // Stoppable:
 
   //! \brief Starts a dedicated pruning thread.
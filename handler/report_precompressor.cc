@@ -0,0 +1,380 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "handler/report_precompressor.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include <algorithm>
+#include <utility>
+
+#include "base/logging.h"
+#include "base/strings/stringprintf.h"
+#include "build/build_config.h"
+#include "handler/report_upload_body.h"
+#include "util/file/directory_reader.h"
+#include "util/file/file_io.h"
+#include "util/file/file_writer.h"
+#include "util/file/filesystem.h"
+#include "util/file/string_file.h"
+#include "util/net/http_body.h"
+#include "util/net/http_headers.h"
+#include "util/net/http_multipart_builder.h"
+#include "util/net/url.h"
+#include "util/string/split_string.h"
+
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#elif BUILDFLAG(IS_APPLE)
+#include <sys/resource.h>
+#elif BUILDFLAG(IS_WIN)
+#include <windows.h>
+#endif
+
+namespace crashpad {
+
+namespace {
+
+constexpr base::FilePath::CharType kPrecompressedDirectory[] =
+    FILE_PATH_LITERAL("precompressed");
+constexpr base::FilePath::CharType kPrecompressedExtension[] =
+    FILE_PATH_LITERAL(".gz");
+constexpr base::FilePath::CharType kTemporaryExtension[] =
+    FILE_PATH_LITERAL(".tmp");
+constexpr base::FilePath::CharType kLocationExtension[] =
+    FILE_PATH_LITERAL(".location");
+
+// A precompressed upload is kept in a file made of:
+//  - kMagic;
+//  - the size of the header that follows, as 8 hexadecimal digits and a
+//    newline;
+//  - the header: the Content-Type, then a URL-encoded key=value line for each
+//    form parameter, each line ending in a newline;
+//  - the gzip-compressed body.
+constexpr char kMagic[] = "CRASHPAD PRECOMPRESSED REPORT 1\n";
+constexpr size_t kHeaderSizeSize = 9;
+
+base::FilePath PrecompressedDirectory(CrashReportDatabase* database) {
+  return database->DatabasePath().Append(kPrecompressedDirectory);
+}
+
+base::FilePath PrecompressedPath(CrashReportDatabase* database,
+                                 const UUID& uuid) {
+#if BUILDFLAG(IS_WIN)
+  const std::wstring uuid_string = uuid.ToWString();
+#else
+  const std::string uuid_string = uuid.ToString();
+#endif
+  return PrecompressedDirectory(database).Append(uuid_string +
+                                                 kPrecompressedExtension);
+}
+
+base::FilePath LocationPath(CrashReportDatabase* database, const UUID& uuid) {
+  return base::FilePath(PrecompressedPath(database, uuid).value() +
+                        kLocationExtension);
+}
+
+// Lowers the priority of the calling thread, so that compression only uses
+// time that nothing else wants.
+void LowerThreadPriority() {
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+  // On Linux, the nice value is a property of each thread.
+  if (setpriority(PRIO_PROCESS, syscall(SYS_gettid), 19) != 0) {
+    PLOG(WARNING) << "setpriority";
+  }
+#elif BUILDFLAG(IS_APPLE)
+  if (setpriority(PRIO_DARWIN_THREAD, 0, PRIO_DARWIN_BG) != 0) {
+    PLOG(WARNING) << "setpriority";
+  }
+#elif BUILDFLAG(IS_WIN)
+  if (!SetThreadPriority(GetCurrentThread(), THREAD_MODE_BACKGROUND_BEGIN)) {
+    PLOG(WARNING) << "SetThreadPriority";
+  }
+#endif
+}
+
+}  // namespace
+
+ReportPrecompressor::ReportPrecompressor(CrashReportDatabase* database,
+                                         int compression_level)
+    : thread_(15 * 60, this),
+      lock_(),
+      database_(database),
+      compression_level_(compression_level),
+      priority_lowered_(false) {}
+
+ReportPrecompressor::~ReportPrecompressor() {}
+
+bool ReportPrecompressor::Precompress(
+    const CrashReportDatabase::Report& report) {
+  base::AutoLock lock(lock_);
+
+  const base::FilePath path = PrecompressedPath(database_, report.uuid);
+  if (IsRegularFile(path)) {
+    return true;
+  }
+
+  // A location recorded for an earlier compression of this report refers to
+  // different bytes.
+  SetUploadLocation(database_, report.uuid, std::string());
+
+  std::unique_ptr<const CrashReportDatabase::UploadReport> upload_report =
+      database_->OpenReportForReading(report);
+  if (!upload_report) {
+    return false;
+  }
+
+  HTTPMultipartBuilder http_multipart_builder;
+  http_multipart_builder.SetCompression(
+      HTTPMultipartBuilder::Compression::kGzip, compression_level_);
+
+  StringFile decompressed_file;
+  std::map<std::string, std::string> parameters;
+  if (!AddReportToMultipartBuilder(report.uuid,
+                                   upload_report->Reader(),
+                                   nullptr,
+                                   upload_report->GetAttachments(),
+                                   std::string(),
+                                   &decompressed_file,
+                                   &http_multipart_builder,
+                                   &parameters)) {
+    LOG(ERROR) << "can't precompress report " << report.uuid.ToString();
+    return false;
+  }
+
+  HTTPHeaders content_headers;
+  http_multipart_builder.PopulateContentHeaders(&content_headers);
+  std::string header = content_headers[kContentType] + "\n";
+  for (const auto& kv : parameters) {
+    header.append(URLEncode(kv.first) + "=" + URLEncode(kv.second) + "\n");
+  }
+
+  const base::FilePath directory = PrecompressedDirectory(database_);
+  if (!LoggingCreateDirectory(directory, FilePermissions::kOwnerOnly, true)) {
+    return false;
+  }
+
+  const base::FilePath temporary_path(path.value() + kTemporaryExtension);
+  {
+    FileWriter writer;
+    if (!writer.Open(temporary_path,
+                     FileWriteMode::kTruncateOrCreate,
+                     FilePermissions::kOwnerOnly)) {
+      return false;
+    }
+
+    const std::string header_size =
+        base::StringPrintf("%08zx\n", header.size());
+    if (!writer.Write(kMagic, strlen(kMagic)) ||
+        !writer.Write(header_size.data(), header_size.size()) ||
+        !writer.Write(header.data(), header.size())) {
+      writer.Close();
+      LoggingRemoveFile(temporary_path);
+      return false;
+    }
+
+    std::unique_ptr<HTTPBodyStream> body_stream =
+        http_multipart_builder.GetBodyStream();
+    uint8_t buffer[64 * 1024];
+    FileOperationResult bytes_read;
+    while ((bytes_read = body_stream->GetBytesBuffer(buffer, sizeof(buffer))) >
+           0) {
+      if (!writer.Write(buffer, bytes_read)) {
+        bytes_read = -1;
+        break;
+      }
+    }
+
+    writer.Close();
+    if (bytes_read < 0) {
+      LoggingRemoveFile(temporary_path);
+      return false;
+    }
+  }
+
+  // Renaming the finished file into place means that an upload never sees a
+  // partially-written one.
+  if (!MoveFileOrDirectory(temporary_path, path)) {
+    LoggingRemoveFile(temporary_path);
+    return false;
+  }
+  return true;
+}
+
+// static
+bool ReportPrecompressor::Open(CrashReportDatabase* database,
+                               const UUID& uuid,
+                               Upload* upload) {
+  const base::FilePath path = PrecompressedPath(database, uuid);
+  if (!IsRegularFile(path)) {
+    return false;
+  }
+
+  auto reader = std::make_unique<FileReader>();
+  if (!reader->Open(path)) {
+    return false;
+  }
+
+  char prefix[sizeof(kMagic) - 1 + kHeaderSizeSize];
+  if (!reader->ReadExactly(prefix, sizeof(prefix)) ||
+      memcmp(prefix, kMagic, sizeof(kMagic) - 1) != 0 ||
+      prefix[sizeof(prefix) - 1] != '\n') {
+    LOG(ERROR) << "unexpected precompressed report format";
+    return false;
+  }
+
+  const std::string header_size_string(prefix + sizeof(kMagic) - 1,
+                                       kHeaderSizeSize - 1);
+  unsigned int header_size;
+  if (header_size_string.find_first_not_of("0123456789abcdef") !=
+          std::string::npos ||
+      sscanf(header_size_string.c_str(), "%x", &header_size) != 1) {
+    LOG(ERROR) << "unexpected precompressed report format";
+    return false;
+  }
+
+  std::string header(header_size, '\0');
+  if (!reader->ReadExactly(&header[0], header.size())) {
+    return false;
+  }
+
+  std::vector<std::string> lines = SplitString(header, '\n');
+  // The header ends in a newline, leaving an empty last element.
+  if (lines.size() < 2 || !lines.back().empty() || lines.front().empty()) {
+    LOG(ERROR) << "unexpected precompressed report format";
+    return false;
+  }
+  lines.pop_back();
+
+  upload->content_type = lines.front();
+  upload->encoded_parameters.clear();
+  for (size_t index = 1; index < lines.size(); ++index) {
+    std::string key;
+    std::string value;
+    if (!SplitStringFirst(lines[index], '=', &key, &value)) {
+      LOG(ERROR) << "unexpected precompressed report format";
+      return false;
+    }
+    upload->encoded_parameters[key] = value;
+  }
+
+  upload->body = std::move(reader);
+  return true;
+}
+
+// static
+bool ReportPrecompressor::GetUploadLocation(CrashReportDatabase* database,
+                                            const UUID& uuid,
+                                            std::string* location) {
+  const base::FilePath path = LocationPath(database, uuid);
+  if (!IsRegularFile(path)) {
+    return false;
+  }
+
+  ScopedFileHandle handle(LoggingOpenFileForRead(path));
+  return handle.is_valid() && LoggingReadToEOF(handle.get(), location) &&
+         !location->empty();
+}
+
+// static
+bool ReportPrecompressor::SetUploadLocation(CrashReportDatabase* database,
+                                            const UUID& uuid,
+                                            const std::string& location) {
+  const base::FilePath path = LocationPath(database, uuid);
+  if (location.empty()) {
+    return !IsRegularFile(path) || LoggingRemoveFile(path);
+  }
+
+  FileWriter writer;
+  return writer.Open(path,
+                     FileWriteMode::kTruncateOrCreate,
+                     FilePermissions::kOwnerOnly) &&
+         writer.Write(location.data(), location.size());
+}
+
+// static
+void ReportPrecompressor::Remove(CrashReportDatabase* database,
+                                 const UUID& uuid) {
+  SetUploadLocation(database, uuid, std::string());
+  const base::FilePath path = PrecompressedPath(database, uuid);
+  if (IsRegularFile(path)) {
+    LoggingRemoveFile(path);
+  }
+}
+
+void ReportPrecompressor::Start() {
+  thread_.Start(60);
+}
+
+void ReportPrecompressor::Stop() {
+  thread_.Stop();
+}
+
+void ReportPrecompressor::DoWork(const WorkerThread* thread) {
+  if (!priority_lowered_) {
+    LowerThreadPriority();
+    priority_lowered_ = true;
+  }
+
+  std::vector<CrashReportDatabase::Report> reports;
+  if (database_->GetPendingReports(&reports) != CrashReportDatabase::kNoError) {
+    return;
+  }
+
+  RemoveStale(reports);
+
+  for (const CrashReportDatabase::Report& report : reports) {
+    // Respect Stop() being called after at least one report is compressed.
+    if (!thread_.is_running()) {
+      return;
+    }
+    Precompress(report);
+  }
+}
+
+void ReportPrecompressor::RemoveStale(
+    const std::vector<CrashReportDatabase::Report>& reports) {
+  const base::FilePath directory = PrecompressedDirectory(database_);
+  if (!IsDirectory(directory, false)) {
+    return;
+  }
+
+  DirectoryReader reader;
+  if (!reader.Open(directory)) {
+    return;
+  }
+
+  base::FilePath filename;
+  DirectoryReader::Result result;
+  while ((result = reader.NextFile(&filename)) ==
+         DirectoryReader::Result::kSuccess) {
+    // All of the files kept for a report are named for the report’s UUID.
+    const base::FilePath::StringType& name = filename.value();
+    UUID uuid;
+    if (uuid.InitializeFromString(name.substr(0, name.find('.'))) &&
+        std::any_of(reports.begin(),
+                    reports.end(),
+                    [&uuid](const CrashReportDatabase::Report& report) {
+                      return report.uuid == uuid;
+                    })) {
+      continue;
+    }
+    LoggingRemoveFile(directory.Append(filename));
+  }
+}
+
+}  // namespace crashpad
@@ -0,0 +1,171 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_HANDLER_REPORT_PRECOMPRESSOR_H_
+#define CRASHPAD_HANDLER_REPORT_PRECOMPRESSOR_H_
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/files/file_path.h"
+#include "base/synchronization/lock.h"
+#include "client/crash_report_database.h"
+#include "util/file/file_reader.h"
+#include "util/misc/uuid.h"
+#include "util/thread/stoppable.h"
+#include "util/thread/worker_thread.h"
+
+namespace crashpad {
+
+//! \brief A thread that compresses the uploads of pending crash reports ahead
+//!     of time.
+//!
+//! The `gzip`-compressed multipart body of each pending report’s upload is
+//! written to a file kept alongside the database, together with what else is
+//! needed to send it. CrashReportUploadThread then sends these bytes as they
+//! are, so that neither the first upload attempt nor any retries wait on
+//! compression, and retries don’t compress the same report again.
+//!
+//! The thread runs at a low priority where the operating system allows it.
+//! It first runs 1 minute after Start(), leaving reports that are uploaded as
+//! soon as they are written to be compressed as they are uploaded, and then
+//! every 15 minutes. Each run also removes the files kept for reports that are
+//! no longer pending.
+class ReportPrecompressor : public WorkerThread::Delegate, public Stoppable {
+ public:
+  //! \brief A report’s precompressed upload, as opened by Open().
+  struct Upload {
+    //! \brief The `Content-Type` of the upload.
+    std::string content_type;
+
+    //! \brief The form data of the upload, with both keys and values
+    //!     URL-encoded.
+    std::map<std::string, std::string> encoded_parameters;
+
+    //! \brief Reads the `gzip`-compressed body of the upload from its
+    //!     current position.
+    std::unique_ptr<FileReader> body;
+  };
+
+  //! \brief Constructs a new object.
+  //!
+  //! \param[in] database The database containing the reports to compress.
+  //! \param[in] compression_level The `gzip` compression level to use, as
+  //!     accepted by GzipHTTPBodyStream.
+  ReportPrecompressor(CrashReportDatabase* database, int compression_level);
+
+  ReportPrecompressor(const ReportPrecompressor&) = delete;
+  ReportPrecompressor& operator=(const ReportPrecompressor&) = delete;
+
+  ~ReportPrecompressor();
+
+  //! \brief Compresses a report’s upload now, on the calling thread.
+  //!
+  //! This may be called on any thread, including while the compression thread
+  //! is running. Nothing is done if the report has already been compressed.
+  //! Compressing a report discards its upload location.
+  //!
+  //! \param[in] report The pending report to compress.
+  //!
+  //! \return `true` on success. `false` on failure, with a message logged.
+  bool Precompress(const CrashReportDatabase::Report& report);
+
+  //! \brief Opens a report’s precompressed upload.
+  //!
+  //! \param[in] database The database containing the report.
+  //! \param[in] uuid The report’s unique identifier.
+  //! \param[out] upload The report’s upload.
+  //!
+  //! \return `true` on success. `false` if the report has not been compressed,
+  //!     or if what was kept for it is not usable.
+  static bool Open(CrashReportDatabase* database,
+                   const UUID& uuid,
+                   Upload* upload);
+
+  //! \brief Obtains the location at which a report’s precompressed upload was
+  //!     created on a server by HTTPResumableUpload::Create().
+  //!
+  //! \param[in] database The database containing the report.
+  //! \param[in] uuid The report’s unique identifier.
+  //! \param[out] location The location.
+  //!
+  //! \return `true` on success. `false` if no location has been recorded.
+  static bool GetUploadLocation(CrashReportDatabase* database,
+                                const UUID& uuid,
+                                std::string* location);
+
+  //! \brief Records the location at which a report’s precompressed upload was
+  //!     created on a server, so that later attempts may resume it.
+  //!
+  //! The location is kept with the precompressed upload, because an upload
+  //! can only be resumed with the same bytes.
+  //!
+  //! \param[in] database The database containing the report.
+  //! \param[in] uuid The report’s unique identifier.
+  //! \param[in] location The location, or an empty string to discard the
+  //!     location previously recorded.
+  //!
+  //! \return `true` on success. `false` on failure, with a message logged.
+  static bool SetUploadLocation(CrashReportDatabase* database,
+                                const UUID& uuid,
+                                const std::string& location);
+
+  //! \brief Removes what was kept for a report, if anything.
+  //!
+  //! This should be called once a report is no longer pending.
+  //!
+  //! \param[in] database The database containing the report.
+  //! \param[in] uuid The report’s unique identifier.
+  static void Remove(CrashReportDatabase* database, const UUID& uuid);
+
+  // Stoppable:
+
+  //! \brief Starts a dedicated compression thread.
+  //!
+  //! This method may only be be called on a newly-constructed object or after
+  //! a call to Stop().
+  void Start() override;
+
+  //! \brief Stops the compression thread.
+  //!
+  //! This method must only be called after Start(). If Start() has been called,
+  //! this method must be called before destroying an object of this class.
+  //!
+  //! This method may be called from any thread other than the compression
+  //! thread.
+  void Stop() override;
+
+ private:
+  // WorkerThread::Delegate:
+  void DoWork(const WorkerThread* thread) override;
+
+  // Removes the files that aren’t kept for any of reports, which are the
+  // pending reports.
+  void RemoveStale(const std::vector<CrashReportDatabase::Report>& reports);
+
+  WorkerThread thread_;
+
+  // Held while compressing, so that a report is compressed by only one thread.
+  base::Lock lock_;
+
+  CrashReportDatabase* database_;  // weak
+  const int compression_level_;
+  bool priority_lowered_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_HANDLER_REPORT_PRECOMPRESSOR_H_
@@ -0,0 +1,157 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "handler/report_precompressor.h"
+
+#include <memory>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "test/scoped_temp_dir.h"
+#include "third_party/zlib/zlib_crashpad.h"
+#include "util/misc/zlib.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+// Decompresses the rest of a gzip stream read from reader.
+bool Gunzip(FileReaderInterface* reader, std::string* output) {
+  std::string compressed;
+  char buffer[4096];
+  FileOperationResult bytes_read;
+  while ((bytes_read = reader->Read(buffer, sizeof(buffer))) > 0) {
+    compressed.append(buffer, bytes_read);
+  }
+  if (bytes_read < 0) {
+    return false;
+  }
+
+  z_stream zlib = {};
+  if (inflateInit2(&zlib, ZlibWindowBitsWithGzipWrapper(0)) != Z_OK) {
+    return false;
+  }
+  zlib.next_in = reinterpret_cast<Bytef*>(&compressed[0]);
+  zlib.avail_in = static_cast<uInt>(compressed.size());
+
+  output->clear();
+  int zr;
+  do {
+    zlib.next_out = reinterpret_cast<Bytef*>(buffer);
+    zlib.avail_out = sizeof(buffer);
+    zr = inflate(&zlib, Z_NO_FLUSH);
+    output->append(buffer, sizeof(buffer) - zlib.avail_out);
+  } while (zr == Z_OK);
+  inflateEnd(&zlib);
+  return zr == Z_STREAM_END;
+}
+
+class ReportPrecompressorTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    database_ = CrashReportDatabase::Initialize(temp_dir_.path());
+    ASSERT_TRUE(database_);
+  }
+
+  void CreateReport(const std::string& contents,
+                    CrashReportDatabase::Report* report) {
+    std::unique_ptr<CrashReportDatabase::NewReport> new_report;
+    ASSERT_EQ(database_->PrepareNewCrashReport(&new_report),
+              CrashReportDatabase::kNoError);
+    ASSERT_TRUE(new_report->Writer()->Write(contents.data(), contents.size()));
+
+    UUID uuid;
+    ASSERT_EQ(
+        database_->FinishedWritingCrashReport(std::move(new_report), &uuid),
+        CrashReportDatabase::kNoError);
+    ASSERT_EQ(database_->LookUpCrashReport(uuid, report),
+              CrashReportDatabase::kNoError);
+  }
+
+  CrashReportDatabase* database() { return database_.get(); }
+
+ private:
+  ScopedTempDir temp_dir_;
+  std::unique_ptr<CrashReportDatabase> database_;
+};
+
+TEST_F(ReportPrecompressorTest, PrecompressOpenRemove) {
+  // Not a minidump, so the upload has no form parameters, but it is still
+  // uploaded.
+  static constexpr char kContents[] = "not a minidump";
+  CrashReportDatabase::Report report;
+  ASSERT_NO_FATAL_FAILURE(CreateReport(kContents, &report));
+
+  ReportPrecompressor::Upload upload;
+  EXPECT_FALSE(ReportPrecompressor::Open(database(), report.uuid, &upload));
+
+  ReportPrecompressor precompressor(database(), 0);
+  ASSERT_TRUE(precompressor.Precompress(report));
+
+  ASSERT_TRUE(ReportPrecompressor::Open(database(), report.uuid, &upload));
+  EXPECT_EQ(upload.content_type.find("multipart/form-data; boundary="), 0u);
+  EXPECT_TRUE(upload.encoded_parameters.empty());
+
+  std::string body;
+  ASSERT_TRUE(Gunzip(upload.body.get(), &body));
+  EXPECT_NE(body.find("name=\"upload_file_minidump\"; filename=\"" +
+                      report.uuid.ToString() + ".dmp\""),
+            std::string::npos);
+  EXPECT_NE(body.find(kContents), std::string::npos);
+
+  // The report is still pending, so it can be opened again.
+  upload.body.reset();
+  ASSERT_TRUE(ReportPrecompressor::Open(database(), report.uuid, &upload));
+  upload.body.reset();
+
+  ReportPrecompressor::Remove(database(), report.uuid);
+  EXPECT_FALSE(ReportPrecompressor::Open(database(), report.uuid, &upload));
+
+  // Removing it again does nothing.
+  ReportPrecompressor::Remove(database(), report.uuid);
+}
+
+TEST_F(ReportPrecompressorTest, UploadLocation) {
+  CrashReportDatabase::Report report;
+  ASSERT_NO_FATAL_FAILURE(CreateReport("not a minidump", &report));
+
+  ReportPrecompressor precompressor(database(), 0);
+  ASSERT_TRUE(precompressor.Precompress(report));
+  CrashReportDatabase* const db = database();
+  const UUID& uuid = report.uuid;
+
+  std::string location;
+  EXPECT_FALSE(ReportPrecompressor::GetUploadLocation(db, uuid, &location));
+
+  static constexpr char kLocation[] = "https://example.com/files/1";
+  ASSERT_TRUE(ReportPrecompressor::SetUploadLocation(db, uuid, kLocation));
+  ASSERT_TRUE(ReportPrecompressor::GetUploadLocation(db, uuid, &location));
+  EXPECT_EQ(location, kLocation);
+
+  // Compressing a report that is already compressed keeps its location.
+  ASSERT_TRUE(precompressor.Precompress(report));
+  EXPECT_TRUE(ReportPrecompressor::GetUploadLocation(db, uuid, &location));
+
+  ASSERT_TRUE(ReportPrecompressor::SetUploadLocation(db, uuid, ""));
+  EXPECT_FALSE(ReportPrecompressor::GetUploadLocation(db, uuid, &location));
+
+  // Removing the precompressed upload removes its location too.
+  ASSERT_TRUE(ReportPrecompressor::SetUploadLocation(db, uuid, kLocation));
+  ReportPrecompressor::Remove(db, uuid);
+  EXPECT_FALSE(ReportPrecompressor::GetUploadLocation(db, uuid, &location));
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
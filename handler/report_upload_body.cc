@@ -0,0 +1,117 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "handler/report_upload_body.h"
+
+#include "base/logging.h"
+#include "handler/minidump_to_upload_parameters.h"
+#include "minidump/minidump_file_writer.h"
+#include "snapshot/minidump/minidump_checksum.h"
+#include "snapshot/minidump/minidump_compression.h"
+#include "snapshot/minidump/process_snapshot_minidump.h"
+
+namespace crashpad {
+
+bool AddReportToMultipartBuilder(
+    const UUID& uuid,
+    FileReaderInterface* reader,
+    FileReaderInterface* upload_minidump,
+    const std::map<std::string, FileReader*>& attachments,
+    const std::string& key_prefix,
+    StringFile* decompressed_file,
+    HTTPMultipartBuilder* builder,
+    std::map<std::string, std::string>* parameters) {
+  parameters->clear();
+
+  FileOffset start_offset = reader->SeekGet();
+  if (start_offset < 0) {
+    return false;
+  }
+
+  // Servers expect a plain minidump, so a report written compressed by the
+  // handler is decompressed for upload.
+  if (IsCompressedMinidump(reader)) {
+    if (!DecompressMinidump(reader, decompressed_file) ||
+        !decompressed_file->SeekSet(0)) {
+      return false;
+    }
+    reader = decompressed_file;
+    start_offset = 0;
+  }
+
+  // Ignore any errors that might occur when attempting to interpret the
+  // minidump file. This may result in its being uploaded with few or no
+  // parameters, but as long as there’s a dump file, the server can decide what
+  // to do with it. The exception is a minidump that doesn’t match its
+  // checksum, which was corrupted after it was written, and isn’t uploaded.
+  ProcessSnapshotMinidump minidump_process_snapshot;
+  if (minidump_process_snapshot.Initialize(reader)) {
+    *parameters =
+        BreakpadHTTPFormParametersFromMinidump(&minidump_process_snapshot);
+  } else if (reader->SeekSet(start_offset) &&
+             CheckMinidumpChecksum(reader) ==
+                 MinidumpChecksumResult::kMismatch) {
+    return false;
+  }
+
+  if (!reader->SeekSet(start_offset)) {
+    return false;
+  }
+
+  static constexpr char kMinidumpKey[] = "upload_file_minidump";
+
+  for (const auto& kv : *parameters) {
+    if (kv.first == kMinidumpKey) {
+      LOG(WARNING) << "reserved key " << kv.first << ", discarding value "
+                   << kv.second;
+    } else {
+      builder->SetFormData(key_prefix + kv.first, kv.second);
+    }
+  }
+
+  for (const auto& it : attachments) {
+    builder->SetFileAttachment(key_prefix + it.first,
+                               it.first,
+                               it.second,
+                               "application/octet-stream");
+  }
+
+  builder->SetFileAttachment(key_prefix + kMinidumpKey,
+                             uuid.ToString() + ".dmp",
+                             upload_minidump ? upload_minidump : reader,
+                             "application/octet-stream");
+  return true;
+}
+
+bool WriteReducedMinidump(FileReaderInterface* reader,
+                          FileWriterInterface* writer) {
+  const FileOffset start_offset = reader->SeekGet();
+  if (start_offset < 0) {
+    return false;
+  }
+
+  // The snapshot reads memory from reader as the reduced minidump is written.
+  ProcessSnapshotMinidump minidump_process_snapshot;
+  bool written = minidump_process_snapshot.Initialize(reader);
+  if (written) {
+    MinidumpFileWriter minidump;
+    minidump.InitializeFromSnapshot(&minidump_process_snapshot,
+                                    MinidumpSnapshotFilter::Reduced());
+    written = minidump.WriteEverything(writer);
+  }
+
+  return reader->SeekSet(start_offset) && written;
+}
+
+}  // namespace crashpad
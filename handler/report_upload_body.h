@@ -0,0 +1,85 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_HANDLER_REPORT_UPLOAD_BODY_H_
+#define CRASHPAD_HANDLER_REPORT_UPLOAD_BODY_H_
+
+#include <map>
+#include <string>
+
+#include "util/file/file_reader.h"
+#include "util/file/file_writer.h"
+#include "util/file/string_file.h"
+#include "util/misc/uuid.h"
+#include "util/net/http_multipart_builder.h"
+
+namespace crashpad {
+
+//! \brief Adds a crash report’s form data, attachments, and minidump to an
+//!     HTTPMultipartBuilder, making the body of its upload.
+//!
+//! The form data is obtained from the minidump by
+//! BreakpadHTTPFormParametersFromMinidump(). Errors interpreting the minidump
+//! are ignored, so that it is still uploaded, with few or no parameters.
+//!
+//! \param[in] uuid The report’s unique identifier, which names the minidump.
+//! \param[in] reader The report’s minidump. A minidump that was written
+//!     compressed is decompressed into \a decompressed_file, because servers
+//!     expect a plain minidump.
+//! \param[in] upload_minidump A plain minidump derived from \a reader to
+//!     upload in its place, such as a delta minidump written by
+//!     DeltaUploadBases, or `nullptr` to upload \a reader. The form data is
+//!     still obtained from \a reader.
+//! \param[in] attachments The report’s attachments, by name.
+//! \param[in] key_prefix A prefix for the name of each form field, attachment,
+//!     and the minidump, so that several reports can be added to \a builder.
+//!     This is empty for an upload of a single report.
+//! \param[out] decompressed_file Storage for a decompressed minidump, which
+//!     must outlive the body stream obtained from \a builder.
+//! \param[out] builder The builder to add the report to.
+//! \param[out] parameters The form data obtained from the minidump.
+//!
+//! \return `true` on success. `false` if the report can’t be read, which
+//!     retrying is not expected to fix.
+bool AddReportToMultipartBuilder(
+    const UUID& uuid,
+    FileReaderInterface* reader,
+    FileReaderInterface* upload_minidump,
+    const std::map<std::string, FileReader*>& attachments,
+    const std::string& key_prefix,
+    StringFile* decompressed_file,
+    HTTPMultipartBuilder* builder,
+    std::map<std::string, std::string>* parameters);
+
+//! \brief Writes a reduced minidump derived from a report’s minidump.
+//!
+//! The reduced minidump is written by MinidumpFileWriter, with
+//! MinidumpSnapshotFilter::Reduced(), from a ProcessSnapshotMinidump of
+//! \a reader. It keeps what a first look at a crash needs, the exception, the
+//! stack of the thread that raised it, the modules, and annotations, in a small
+//! fraction of the size of the full minidump.
+//!
+//! \param[in] reader The report’s minidump, which may have been written
+//!     compressed. It is left at the position that it was found at.
+//! \param[out] writer The writer to receive the reduced minidump, which is not
+//!     compressed.
+//!
+//! \return `true` on success. `false` on failure, with an appropriate message
+//!     logged.
+bool WriteReducedMinidump(FileReaderInterface* reader,
+                          FileWriterInterface* writer);
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_HANDLER_REPORT_UPLOAD_BODY_H_
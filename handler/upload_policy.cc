@@ -0,0 +1,277 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "handler/upload_policy.h"
+
+#include <inttypes.h>
+
+#include <algorithm>
+#include <tuple>
+
+#include "base/strings/stringprintf.h"
+#include "snapshot/exception_snapshot.h"
+#include "snapshot/minidump/minidump_compression.h"
+#include "snapshot/minidump/process_snapshot_minidump.h"
+#include "snapshot/module_snapshot.h"
+#include "util/file/string_file.h"
+#include "util/misc/clock.h"
+
+namespace crashpad {
+
+namespace {
+
+constexpr uint64_t kNanosecondsPerHour = 60ull * 60 * 1000000000;
+
+// Keeps the signatures remembered from growing without bound. Forgetting them
+// only affects the order of later uploads.
+constexpr size_t kMaxSignatures = 1024;
+
+}  // namespace
+
+BudgetUploadPolicy::BudgetUploadPolicy(
+    const Options& options,
+    std::unique_ptr<DeviceState> device_state)
+    : options_(options),
+      device_state_(std::move(device_state)),
+      lock_(),
+      unmetered_bucket_(),
+      metered_bucket_(),
+      charges_(),
+      signatures_(),
+      uploaded_signatures_() {
+  unmetered_bucket_.bytes_per_hour = options_.bytes_per_hour;
+  metered_bucket_.bytes_per_hour = options_.metered_bytes_per_hour
+                                       ? options_.metered_bytes_per_hour
+                                       : options_.bytes_per_hour;
+
+  // Each budget starts out full, so a backlog can start being uploaded at
+  // once.
+  for (Bucket* bucket : {&unmetered_bucket_, &metered_bucket_}) {
+    bucket->tokens = static_cast<double>(bucket->bytes_per_hour);
+    bucket->refilled_nanoseconds = 0;
+  }
+}
+
+BudgetUploadPolicy::~BudgetUploadPolicy() = default;
+
+// static
+std::string BudgetUploadPolicy::MinidumpSignature(
+    FileReaderInterface* reader) {
+  StringFile decompressed_file;
+  if (IsCompressedMinidump(reader)) {
+    if (!DecompressMinidump(reader, &decompressed_file) ||
+        !decompressed_file.SeekSet(0)) {
+      return std::string();
+    }
+    reader = &decompressed_file;
+  }
+
+  ProcessSnapshotMinidump process_snapshot;
+  if (!process_snapshot.Initialize(reader)) {
+    return std::string();
+  }
+
+  const ExceptionSnapshot* exception = process_snapshot.Exception();
+  if (!exception) {
+    return std::string();
+  }
+
+  const uint64_t address = exception->ExceptionAddress();
+  for (const ModuleSnapshot* module : process_snapshot.Modules()) {
+    if (address >= module->Address() &&
+        address - module->Address() < module->Size()) {
+      std::string name = module->Name();
+      const size_t slash = name.find_last_of("/\\");
+      if (slash != std::string::npos) {
+        name.erase(0, slash + 1);
+      }
+      return base::StringPrintf("%08x %s+0x%" PRIx64,
+                                exception->Exception(),
+                                name.c_str(),
+                                address - module->Address());
+    }
+  }
+
+  return base::StringPrintf(
+      "%08x 0x%" PRIx64, exception->Exception(), address);
+}
+
+void BudgetUploadPolicy::Prioritize(
+    CrashReportDatabase* database,
+    std::vector<CrashReportDatabase::Report>* reports) {
+  if (reports->size() <= 1) {
+    return;
+  }
+
+  std::vector<std::string> signatures;
+  signatures.reserve(reports->size());
+  for (const CrashReportDatabase::Report& report : *reports) {
+    signatures.push_back(CachedSignature(database, report));
+  }
+
+  // The oldest report of each signature not already uploaded, by signature.
+  std::map<std::string, size_t> firsts;
+  {
+    base::AutoLock lock(lock_);
+    for (size_t index = 0; index < reports->size(); ++index) {
+      const std::string& signature = signatures[index];
+      if (signature.empty() || uploaded_signatures_.count(signature)) {
+        continue;
+      }
+      auto inserted = firsts.insert(std::make_pair(signature, index));
+      if (!inserted.second && (*reports)[index].creation_time <
+                                  (*reports)[inserted.first->second]
+                                      .creation_time) {
+        inserted.first->second = index;
+      }
+    }
+  }
+
+  std::vector<bool> first(reports->size(), false);
+  for (const auto& signature_and_index : firsts) {
+    first[signature_and_index.second] = true;
+  }
+
+  std::vector<size_t> order(reports->size());
+  for (size_t index = 0; index < order.size(); ++index) {
+    order[index] = index;
+  }
+  std::stable_sort(
+      order.begin(), order.end(), [reports, &first](size_t lhs, size_t rhs) {
+        const CrashReportDatabase::Report& left = (*reports)[lhs];
+        const CrashReportDatabase::Report& right = (*reports)[rhs];
+        return std::make_tuple(!left.upload_explicitly_requested,
+                               !first[lhs],
+                               left.total_size,
+                               left.creation_time) <
+               std::make_tuple(!right.upload_explicitly_requested,
+                               !first[rhs],
+                               right.total_size,
+                               right.creation_time);
+      });
+
+  std::vector<CrashReportDatabase::Report> ordered;
+  ordered.reserve(reports->size());
+  for (size_t index : order) {
+    ordered.push_back(std::move((*reports)[index]));
+  }
+  reports->swap(ordered);
+}
+
+bool BudgetUploadPolicy::BeginUpload(
+    const CrashReportDatabase::Report& report) {
+  bool metered = false;
+  if (device_state_) {
+    if (options_.defer_on_low_battery && device_state_->IsBatteryLow()) {
+      return false;
+    }
+    metered = device_state_->IsNetworkMetered();
+  }
+
+  base::AutoLock lock(lock_);
+  Bucket* const bucket = metered ? &metered_bucket_ : &unmetered_bucket_;
+  double charge = 0;
+  if (bucket->bytes_per_hour) {
+    Refill(bucket, NowNanoseconds());
+    charge = static_cast<double>(report.total_size);
+    if (bucket->tokens < charge &&
+        bucket->tokens < static_cast<double>(bucket->bytes_per_hour)) {
+      return false;
+    }
+    bucket->tokens -= charge;
+  }
+  charges_[report.uuid] = std::make_pair(bucket, charge);
+
+  auto signature = signatures_.find(report.uuid);
+  if (signature != signatures_.end() && !signature->second.empty()) {
+    if (uploaded_signatures_.size() >= kMaxSignatures) {
+      uploaded_signatures_.clear();
+    }
+    uploaded_signatures_.insert(signature->second);
+  }
+  return true;
+}
+
+void BudgetUploadPolicy::EndUpload(const CrashReportDatabase::Report& report,
+                                   uint64_t bytes_sent) {
+  base::AutoLock lock(lock_);
+  signatures_.erase(report.uuid);
+
+  auto charge = charges_.find(report.uuid);
+  if (charge == charges_.end()) {
+    return;
+  }
+  Bucket* const bucket = charge->second.first;
+  if (bucket->bytes_per_hour) {
+    // Replace the estimate taken by BeginUpload() with what was sent, keeping
+    // the budget to an hour’s worth.
+    const double refund =
+        charge->second.second - static_cast<double>(bytes_sent);
+    bucket->tokens = std::min(bucket->tokens + refund,
+                              static_cast<double>(bucket->bytes_per_hour));
+  }
+  charges_.erase(charge);
+}
+
+std::string BudgetUploadPolicy::Signature(
+    CrashReportDatabase* database,
+    const CrashReportDatabase::Report& report) {
+  std::unique_ptr<const CrashReportDatabase::UploadReport> upload_report =
+      database->OpenReportForReading(report);
+  if (!upload_report) {
+    return std::string();
+  }
+  return MinidumpSignature(upload_report->Reader());
+}
+
+uint64_t BudgetUploadPolicy::NowNanoseconds() {
+  return ClockMonotonicNanoseconds();
+}
+
+void BudgetUploadPolicy::Refill(Bucket* bucket, uint64_t now_nanoseconds) {
+  if (now_nanoseconds > bucket->refilled_nanoseconds) {
+    const double hours =
+        static_cast<double>(now_nanoseconds - bucket->refilled_nanoseconds) /
+        kNanosecondsPerHour;
+    bucket->tokens =
+        std::min(bucket->tokens + hours * bucket->bytes_per_hour,
+                 static_cast<double>(bucket->bytes_per_hour));
+  }
+  bucket->refilled_nanoseconds = now_nanoseconds;
+}
+
+std::string BudgetUploadPolicy::CachedSignature(
+    CrashReportDatabase* database,
+    const CrashReportDatabase::Report& report) {
+  {
+    base::AutoLock lock(lock_);
+    auto it = signatures_.find(report.uuid);
+    if (it != signatures_.end()) {
+      return it->second;
+    }
+  }
+
+  // Reading the minidump may take a while, so it’s done without holding
+  // lock_.
+  std::string signature = Signature(database, report);
+
+  base::AutoLock lock(lock_);
+  if (signatures_.size() >= kMaxSignatures) {
+    signatures_.clear();
+  }
+  signatures_[report.uuid] = signature;
+  return signature;
+}
+
+}  // namespace crashpad
@@ -0,0 +1,199 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_HANDLER_UPLOAD_POLICY_H_
+#define CRASHPAD_HANDLER_UPLOAD_POLICY_H_
+
+#include <stdint.h>
+
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "base/synchronization/lock.h"
+#include "client/crash_report_database.h"
+#include "util/file/file_reader.h"
+#include "util/misc/uuid.h"
+
+namespace crashpad {
+
+//! \brief Decides the order in which CrashReportUploadThread uploads pending
+//!     reports, and when it may upload them.
+//!
+//! Reports that a policy does not allow to be uploaded yet remain pending, and
+//! are considered again by a later pass through the database. Reports whose
+//! upload was explicitly requested are always uploaded, without consulting
+//! BeginUpload().
+//!
+//! The methods of a policy may be called on several threads at once.
+class UploadPolicy {
+ public:
+  virtual ~UploadPolicy() {}
+
+  //! \brief Orders \a reports so that the first of them is uploaded first.
+  //!
+  //! \param[in] database The database containing the reports.
+  //! \param[in,out] reports The reports to order.
+  virtual void Prioritize(
+      CrashReportDatabase* database,
+      std::vector<CrashReportDatabase::Report>* reports) = 0;
+
+  //! \brief Decides whether a report may be uploaded now.
+  //!
+  //! Each call that returns `true` must be followed by a call to EndUpload()
+  //! for the same report, once its upload attempt has been made or abandoned.
+  //!
+  //! \param[in] report The report to upload.
+  //!
+  //! \return `true` if the report may be uploaded now. `false` if it should
+  //!     remain pending for now.
+  virtual bool BeginUpload(const CrashReportDatabase::Report& report) = 0;
+
+  //! \brief Records the end of an upload attempt allowed by BeginUpload().
+  //!
+  //! \param[in] report The report whose upload was attempted.
+  //! \param[in] bytes_sent The number of bytes of the upload’s body sent,
+  //!     which is `0` if no attempt was made.
+  virtual void EndUpload(const CrashReportDatabase::Report& report,
+                         uint64_t bytes_sent) = 0;
+};
+
+//! \brief An UploadPolicy that uploads the first report of each crash
+//!     signature and small reports first, and limits the bytes uploaded with
+//!     a token bucket.
+//!
+//! A report’s signature is made of the exception code and the module and
+//! offset of the exception address, read from its minidump. Pending reports
+//! are uploaded in this order:
+//!  - those whose upload was explicitly requested;
+//!  - the oldest report of each signature not already uploaded;
+//!  - the rest, smallest first.
+//!
+//! Before each upload, the report’s size on disk is taken from a budget that
+//! is refilled continuously at a configured number of bytes per hour, and
+//! holds up to an hour’s worth. Once the upload ends, the bytes actually sent,
+//! which are generally fewer because uploads are compressed, are what is
+//! charged. A report is uploaded when the budget covers it, or when the budget
+//! is full, so that a report larger than the budget is still uploaded. Metered
+//! networks can have a smaller budget of their own, and uploads can be
+//! deferred while the battery is low, as reported by an optional DeviceState.
+class BudgetUploadPolicy : public UploadPolicy {
+ public:
+  //! \brief Reports the state of the device that affects uploads.
+  //!
+  //! The methods of this class may be called on several threads at once.
+  class DeviceState {
+   public:
+    virtual ~DeviceState() {}
+
+    //! \return `true` if the network that uploads would use is metered, such
+    //!     as a cellular network.
+    virtual bool IsNetworkMetered() = 0;
+
+    //! \return `true` if the device is running on a battery that is low.
+    virtual bool IsBatteryLow() = 0;
+  };
+
+  //! \brief Options to be passed to the BudgetUploadPolicy constructor.
+  struct Options {
+    //! The number of bytes that may be uploaded per hour, or `0` for no
+    //! limit.
+    uint64_t bytes_per_hour = 0;
+
+    //! The number of bytes that may be uploaded per hour while the network is
+    //! metered, or `0` to use #bytes_per_hour. This has a budget separate from
+    //! #bytes_per_hour.
+    uint64_t metered_bytes_per_hour = 0;
+
+    //! Whether to defer uploads while the battery is low.
+    bool defer_on_low_battery = true;
+  };
+
+  //! \brief Constructs a new object.
+  //!
+  //! \param[in] options The policy’s options.
+  //! \param[in] device_state Reports the state of the device, or `nullptr` to
+  //!     treat the network as unmetered and the battery as not low.
+  BudgetUploadPolicy(const Options& options,
+                     std::unique_ptr<DeviceState> device_state);
+
+  BudgetUploadPolicy(const BudgetUploadPolicy&) = delete;
+  BudgetUploadPolicy& operator=(const BudgetUploadPolicy&) = delete;
+
+  ~BudgetUploadPolicy() override;
+
+  //! \brief Obtains the signature of the crash in a minidump.
+  //!
+  //! \param[in] reader The minidump, read from its current position. It may
+  //!     be compressed.
+  //!
+  //! \return The signature, or an empty string if the minidump can’t be read
+  //!     or has no exception.
+  static std::string MinidumpSignature(FileReaderInterface* reader);
+
+  // UploadPolicy:
+  void Prioritize(CrashReportDatabase* database,
+                  std::vector<CrashReportDatabase::Report>* reports) override;
+  bool BeginUpload(const CrashReportDatabase::Report& report) override;
+  void EndUpload(const CrashReportDatabase::Report& report,
+                 uint64_t bytes_sent) override;
+
+ protected:
+  //! \brief Obtains a report’s signature. This calls MinidumpSignature(), and
+  //!     is overridden by tests.
+  virtual std::string Signature(CrashReportDatabase* database,
+                                const CrashReportDatabase::Report& report);
+
+  //! \brief Returns the current time, in nanoseconds from an arbitrary start.
+  //!     This calls ClockMonotonicNanoseconds(), and is overridden by tests.
+  virtual uint64_t NowNanoseconds();
+
+ private:
+  struct Bucket {
+    uint64_t bytes_per_hour;
+    double tokens;
+    uint64_t refilled_nanoseconds;
+  };
+
+  // Refills bucket up to the current time. lock_ must be held.
+  void Refill(Bucket* bucket, uint64_t now_nanoseconds);
+
+  // Returns the signature of the report identified by uuid, reading it with
+  // Signature() the first time. lock_ must not be held.
+  std::string CachedSignature(CrashReportDatabase* database,
+                              const CrashReportDatabase::Report& report);
+
+  const Options options_;
+  const std::unique_ptr<DeviceState> device_state_;
+
+  // Guards everything below.
+  base::Lock lock_;
+  Bucket unmetered_bucket_;
+  Bucket metered_bucket_;
+
+  // The charge taken by BeginUpload() for each upload in progress, and the
+  // bucket it was taken from.
+  std::map<UUID, std::pair<Bucket*, double>> charges_;
+
+  // The signature of each report, by UUID, and the signatures of reports
+  // already uploaded.
+  std::map<UUID, std::string> signatures_;
+  std::set<std::string> uploaded_signatures_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_HANDLER_UPLOAD_POLICY_H_
@@ -0,0 +1,201 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "handler/upload_policy.h"
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "util/file/string_file.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+constexpr uint64_t kNanosecondsPerMinute = 60ull * 1000000000;
+
+class TestDeviceState : public BudgetUploadPolicy::DeviceState {
+ public:
+  TestDeviceState(bool* metered, bool* battery_low)
+      : metered_(metered), battery_low_(battery_low) {}
+
+  // BudgetUploadPolicy::DeviceState:
+  bool IsNetworkMetered() override { return *metered_; }
+  bool IsBatteryLow() override { return *battery_low_; }
+
+ private:
+  bool* metered_;  // weak
+  bool* battery_low_;  // weak
+};
+
+class TestUploadPolicy : public BudgetUploadPolicy {
+ public:
+  TestUploadPolicy(const Options& options,
+                   std::unique_ptr<DeviceState> device_state)
+      : BudgetUploadPolicy(options, std::move(device_state)),
+        signatures_(),
+        now_nanoseconds_(kNanosecondsPerMinute) {}
+
+  void SetSignature(const UUID& uuid, const std::string& signature) {
+    signatures_[uuid] = signature;
+  }
+
+  void AdvanceMinutes(uint64_t minutes) {
+    now_nanoseconds_ += minutes * kNanosecondsPerMinute;
+  }
+
+ protected:
+  // BudgetUploadPolicy:
+  std::string Signature(CrashReportDatabase* database,
+                        const CrashReportDatabase::Report& report) override {
+    return signatures_[report.uuid];
+  }
+
+  uint64_t NowNanoseconds() override { return now_nanoseconds_; }
+
+ private:
+  std::map<UUID, std::string> signatures_;
+  uint64_t now_nanoseconds_;
+};
+
+CrashReportDatabase::Report MakeReport(uint8_t id,
+                                       uint64_t total_size,
+                                       time_t creation_time) {
+  CrashReportDatabase::Report report;
+  uint8_t bytes[16] = {};
+  bytes[0] = id;
+  report.uuid.InitializeFromBytes(bytes);
+  report.total_size = total_size;
+  report.creation_time = creation_time;
+  return report;
+}
+
+std::vector<uint8_t> Order(
+    const std::vector<CrashReportDatabase::Report>& reports) {
+  std::vector<uint8_t> order;
+  for (const CrashReportDatabase::Report& report : reports) {
+    order.push_back(report.uuid.data_1 >> 24);
+  }
+  return order;
+}
+
+TEST(BudgetUploadPolicy, Prioritize) {
+  TestUploadPolicy policy(BudgetUploadPolicy::Options(), nullptr);
+
+  std::vector<CrashReportDatabase::Report> reports;
+  reports.push_back(MakeReport(1, 5000, 10));
+  reports.push_back(MakeReport(2, 1000, 20));
+  reports.push_back(MakeReport(3, 3000, 5));
+  reports.push_back(MakeReport(4, 2000, 30));
+  reports.push_back(MakeReport(5, 9000, 40));
+  reports.push_back(MakeReport(6, 4000, 50));
+  reports[4].upload_explicitly_requested = true;
+
+  policy.SetSignature(reports[0].uuid, "a");
+  policy.SetSignature(reports[1].uuid, "a");
+  policy.SetSignature(reports[2].uuid, "b");
+  policy.SetSignature(reports[3].uuid, "b");
+  policy.SetSignature(reports[4].uuid, "c");
+
+  // The explicitly requested report, then the oldest of each signature,
+  // smallest first, then the rest, smallest first. Report 6 has no known
+  // signature.
+  policy.Prioritize(nullptr, &reports);
+  EXPECT_EQ(Order(reports), (std::vector<uint8_t>{5, 3, 1, 2, 4, 6}));
+
+  // Once a report of a signature has been uploaded, others of the same
+  // signature are no longer first.
+  ASSERT_TRUE(policy.BeginUpload(reports[1]));
+  policy.EndUpload(reports[1], 100);
+  reports.erase(reports.begin() + 1);
+  policy.Prioritize(nullptr, &reports);
+  EXPECT_EQ(Order(reports), (std::vector<uint8_t>{5, 1, 2, 4, 6}));
+}
+
+TEST(BudgetUploadPolicy, Budget) {
+  BudgetUploadPolicy::Options options;
+  options.bytes_per_hour = 6000;
+  TestUploadPolicy policy(options, nullptr);
+
+  // The budget starts out full.
+  CrashReportDatabase::Report report_1 = MakeReport(1, 4000, 0);
+  ASSERT_TRUE(policy.BeginUpload(report_1));
+
+  // Until the first upload ends, its size on disk is charged.
+  CrashReportDatabase::Report report_2 = MakeReport(2, 3000, 0);
+  EXPECT_FALSE(policy.BeginUpload(report_2));
+
+  // Then only what it sent is.
+  policy.EndUpload(report_1, 1000);
+  ASSERT_TRUE(policy.BeginUpload(report_2));
+  policy.EndUpload(report_2, 3000);
+
+  // 2000 bytes remain, and 100 bytes are added each minute.
+  CrashReportDatabase::Report report_3 = MakeReport(3, 2500, 0);
+  EXPECT_FALSE(policy.BeginUpload(report_3));
+  policy.AdvanceMinutes(4);
+  EXPECT_FALSE(policy.BeginUpload(report_3));
+  policy.AdvanceMinutes(1);
+  ASSERT_TRUE(policy.BeginUpload(report_3));
+  policy.EndUpload(report_3, 2500);
+
+  // A report larger than the budget is uploaded once the budget is full, and
+  // the budget never holds more than an hour’s worth.
+  CrashReportDatabase::Report report_4 = MakeReport(4, 10000, 0);
+  policy.AdvanceMinutes(59);
+  EXPECT_FALSE(policy.BeginUpload(report_4));
+  policy.AdvanceMinutes(600);
+  ASSERT_TRUE(policy.BeginUpload(report_4));
+  policy.EndUpload(report_4, 10000);
+  EXPECT_FALSE(policy.BeginUpload(MakeReport(5, 1, 0)));
+}
+
+TEST(BudgetUploadPolicy, DeviceState) {
+  bool metered = false;
+  bool battery_low = false;
+  BudgetUploadPolicy::Options options;
+  options.bytes_per_hour = 6000;
+  options.metered_bytes_per_hour = 1000;
+  TestUploadPolicy policy(
+      options, std::make_unique<TestDeviceState>(&metered, &battery_low));
+
+  CrashReportDatabase::Report report_1 = MakeReport(1, 2000, 0);
+  CrashReportDatabase::Report report_2 = MakeReport(2, 500, 0);
+
+  battery_low = true;
+  EXPECT_FALSE(policy.BeginUpload(report_2));
+  battery_low = false;
+
+  // The metered budget is separate from the unmetered one.
+  metered = true;
+  ASSERT_TRUE(policy.BeginUpload(report_2));
+  policy.EndUpload(report_2, 500);
+  EXPECT_FALSE(policy.BeginUpload(report_1));
+  metered = false;
+  ASSERT_TRUE(policy.BeginUpload(report_1));
+  policy.EndUpload(report_1, 2000);
+}
+
+TEST(BudgetUploadPolicy, MinidumpSignatureUnreadable) {
+  StringFile file;
+  file.SetString("not a minidump");
+  EXPECT_EQ(BudgetUploadPolicy::MinidumpSignature(&file), "");
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
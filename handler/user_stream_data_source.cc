@@ -14,19 +14,199 @@
 
 #include "handler/user_stream_data_source.h"
 
+#include <stddef.h>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <utility>
+
 #include "base/logging.h"
 #include "minidump/minidump_file_writer.h"
 #include "minidump/minidump_user_extension_stream_data_source.h"
 #include "snapshot/process_snapshot.h"
+#include "util/thread/thread.h"
 
 namespace crashpad {
 
+namespace {
+
+// Runs data sources on worker threads, claiming them one at a time until none
+// remain, and cancels each one that runs past its time budget.
+class UserStreamDataSourceRunner {
+ public:
+  UserStreamDataSourceRunner(const UserStreamDataSources* sources,
+                             ProcessSnapshot* process_snapshot,
+                             double time_budget)
+      : runs_(sources->size()),
+        mutex_(),
+        condition_(),
+        sources_(sources),
+        process_snapshot_(process_snapshot),
+        time_budget_(std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<double>(time_budget))),
+        next_index_(0),
+        finished_(0) {}
+
+  UserStreamDataSourceRunner(const UserStreamDataSourceRunner&) = delete;
+  UserStreamDataSourceRunner& operator=(const UserStreamDataSourceRunner&) =
+      delete;
+
+  // Runs sources until none remain to be started. This is called on each
+  // worker thread.
+  void RunSources() {
+    while (true) {
+      size_t index;
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (next_index_ == runs_.size()) {
+          return;
+        }
+        index = next_index_++;
+        runs_[index].deadline = Clock::now() + time_budget_;
+        runs_[index].running = true;
+      }
+      condition_.notify_all();
+
+      Run& run = runs_[index];
+      std::unique_ptr<MinidumpUserExtensionStreamDataSource> data_source =
+          (*sources_)[index]->ProduceStreamDataCancelable(process_snapshot_,
+                                                          run.canceled);
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!run.canceled) {
+          run.data_source = std::move(data_source);
+        }
+        run.running = false;
+        ++finished_;
+      }
+      condition_.notify_all();
+    }
+  }
+
+  // Returns once every source has returned, canceling those that run past
+  // their time budget.
+  void WaitForSources() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (finished_ < runs_.size()) {
+      if (time_budget_ <= Clock::duration::zero()) {
+        condition_.wait(lock);
+        continue;
+      }
+
+      Run* next_to_cancel = nullptr;
+      for (Run& run : runs_) {
+        if (run.running && !run.canceled &&
+            (!next_to_cancel || run.deadline < next_to_cancel->deadline)) {
+          next_to_cancel = &run;
+        }
+      }
+
+      if (!next_to_cancel) {
+        condition_.wait(lock);
+      } else if (Clock::now() >= next_to_cancel->deadline) {
+        next_to_cancel->canceled = true;
+        LOG(WARNING) << "user stream data source "
+                     << next_to_cancel - runs_.data()
+                     << " ran out of time, canceling";
+      } else {
+        condition_.wait_until(lock, next_to_cancel->deadline);
+      }
+    }
+  }
+
+  // Adds the streams produced by sources that finished in time, in the order
+  // of the sources. This must only be called after WaitForSources().
+  void AddStreams(MinidumpFileWriter* minidump_file_writer) {
+    for (Run& run : runs_) {
+      if (run.data_source && !minidump_file_writer->AddUserExtensionStream(
+                                 std::move(run.data_source))) {
+        LOG(ERROR) << "AddUserExtensionStream failed";
+      }
+    }
+  }
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  struct Run {
+    Run() : data_source(), deadline(), canceled(false), running(false) {}
+
+    std::unique_ptr<MinidumpUserExtensionStreamDataSource> data_source;
+    Clock::time_point deadline;
+    std::atomic<bool> canceled;
+    bool running;
+  };
+
+  std::vector<Run> runs_;
+
+  // Guards next_index_, finished_, and each of runs_ other than its canceled
+  // member.
+  std::mutex mutex_;
+  std::condition_variable condition_;
+
+  const UserStreamDataSources* sources_;  // weak
+  ProcessSnapshot* process_snapshot_;  // weak
+  const Clock::duration time_budget_;
+  size_t next_index_;
+  size_t finished_;
+};
+
+class UserStreamDataSourceThread : public Thread {
+ public:
+  explicit UserStreamDataSourceThread(UserStreamDataSourceRunner* runner)
+      : runner_(runner) {}
+
+  UserStreamDataSourceThread(const UserStreamDataSourceThread&) = delete;
+  UserStreamDataSourceThread& operator=(const UserStreamDataSourceThread&) =
+      delete;
+
+  ~UserStreamDataSourceThread() override {}
+
+ private:
+  // Thread:
+  void ThreadMain() override { runner_->RunSources(); }
+
+  UserStreamDataSourceRunner* runner_;
+};
+
+}  // namespace
+
+std::unique_ptr<MinidumpUserExtensionStreamDataSource>
+UserStreamDataSource::ProduceStreamDataCancelable(
+    ProcessSnapshot* process_snapshot,
+    const std::atomic<bool>& canceled) {
+  return ProduceStreamData(process_snapshot);
+}
+
 void AddUserExtensionStreams(
     const UserStreamDataSources* user_stream_data_sources,
     ProcessSnapshot* process_snapshot,
-    MinidumpFileWriter* minidump_file_writer) {
+    MinidumpFileWriter* minidump_file_writer,
+    unsigned int threads,
+    double time_budget) {
   if (!user_stream_data_sources)
     return;
+
+  if (threads > 1 || time_budget > 0) {
+    UserStreamDataSourceRunner runner(
+        user_stream_data_sources, process_snapshot, time_budget);
+    std::vector<std::unique_ptr<UserStreamDataSourceThread>> worker_threads(
+        std::min(static_cast<size_t>(std::max(threads, 1u)),
+                 user_stream_data_sources->size()));
+    for (auto& thread : worker_threads) {
+      thread = std::make_unique<UserStreamDataSourceThread>(&runner);
+      thread->Start();
+    }
+    runner.WaitForSources();
+    for (auto& thread : worker_threads) {
+      thread->Join();
+    }
+    runner.AddStreams(minidump_file_writer);
+    return;
+  }
+
   for (const auto& source : *user_stream_data_sources) {
     std::unique_ptr<MinidumpUserExtensionStreamDataSource> data_source(
         source->ProduceStreamData(process_snapshot));
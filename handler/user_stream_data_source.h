@@ -15,6 +15,7 @@
 #ifndef CRASHPAD_HANDLER_USER_STREAM_DATA_SOURCE_H_
 #define CRASHPAD_HANDLER_USER_STREAM_DATA_SOURCE_H_
 
+#include <atomic>
 #include <memory>
 #include <vector>
 
@@ -43,6 +44,33 @@ class UserStreamDataSource {
   //!      `nullptr` on failure or to opt out of adding a stream.
   virtual std::unique_ptr<MinidumpUserExtensionStreamDataSource>
   ProduceStreamData(ProcessSnapshot* process_snapshot) = 0;
+
+  //! \brief Produce the contents for an extension stream for a crashed
+  //!     program, stopping early if canceled.
+  //!
+  //! This is called instead of ProduceStreamData() when data sources are run
+  //! on worker threads by AddUserExtensionStreams(). Once \a canceled becomes
+  //! `true`, the data source has used up its time budget and anything it
+  //! returns is discarded, so an implementation that may run for a long time,
+  //! such as by walking all of \a process_snapshot, should check it
+  //! periodically and return `nullptr` promptly once it is set.
+  //!
+  //! Data sources run on worker threads may use \a process_snapshot at the
+  //! same time as each other, and must only use it in ways that are safe to
+  //! do so, such as by calling its `const` methods.
+  //!
+  //! The default implementation calls ProduceStreamData() without checking
+  //! \a canceled.
+  //!
+  //! \param[in] process_snapshot An initialized snapshot for the crashed
+  //!     process.
+  //! \param[in] canceled Becomes `true` once the data source should stop.
+  //!
+  //! \return A new data source for the stream to add to the minidump or
+  //!      `nullptr` on failure or to opt out of adding a stream.
+  virtual std::unique_ptr<MinidumpUserExtensionStreamDataSource>
+  ProduceStreamDataCancelable(ProcessSnapshot* process_snapshot,
+                              const std::atomic<bool>& canceled);
 };
 
 using UserStreamDataSources =
@@ -51,17 +79,33 @@ using UserStreamDataSources =
 //! \brief Adds user extension streams to a minidump.
 //!
 //! Dispatches to each source in \a user_stream_data_sources and adds returned
-//! extension streams to \a minidump_file_writer.
+//! extension streams to \a minidump_file_writer, in the order of the sources.
+//!
+//! By default, the sources are run one after another on the calling thread.
+//! When \a threads is greater than `1` or \a time_budget is positive, they are
+//! instead run on up to \a threads worker threads with
+//! UserStreamDataSource::ProduceStreamDataCancelable(), so that the time taken
+//! is about that of the slowest source rather than the sum of all of them. A
+//! source that is still running \a time_budget seconds after it started is
+//! canceled, and its stream is left out of the minidump. This function returns
+//! once every source has returned.
 //!
 //! \param[in] user_stream_data_sources A pointer to the data sources, or
 //!     `nullptr`.
 //! \param[in] process_snapshot An initialized snapshot to the crashing process.
 //! \param[in] minidump_file_writer Any extension streams will be added to this
 //!     minidump.
+//! \param[in] threads The number of worker threads that may run sources at
+//!     once.
+//! \param[in] time_budget The time in seconds that each source may run for
+//!     before it is canceled, or `0` to let sources run for as long as they
+//!     take.
 void AddUserExtensionStreams(
     const UserStreamDataSources* user_stream_data_sources,
     ProcessSnapshot* process_snapshot,
-    MinidumpFileWriter* minidump_file_writer);
+    MinidumpFileWriter* minidump_file_writer,
+    unsigned int threads = 1,
+    double time_budget = 0);
 
 }  // namespace crashpad
 
@@ -0,0 +1,183 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "handler/user_stream_data_source.h"
+
+#include <stdint.h>
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "minidump/minidump_file_writer.h"
+#include "minidump/test/minidump_file_writer_test_util.h"
+#include "minidump/test/minidump_user_extension_stream_util.h"
+#include "snapshot/test/test_process_snapshot.h"
+#include "util/file/string_file.h"
+#include "util/misc/clock.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+constexpr uint64_t kMillisecond = 1000000;
+
+// Produces a stream of its type once every one of a group of sources has
+// started, or, if the group never gathers, after about five seconds.
+class GatheringDataSource : public UserStreamDataSource {
+ public:
+  GatheringDataSource(uint32_t stream_type,
+                      std::atomic<int>* started,
+                      int group_size)
+      : stream_type_(stream_type),
+        started_(started),
+        group_size_(group_size),
+        gathered_(false) {}
+
+  GatheringDataSource(const GatheringDataSource&) = delete;
+  GatheringDataSource& operator=(const GatheringDataSource&) = delete;
+
+  std::unique_ptr<MinidumpUserExtensionStreamDataSource> ProduceStreamData(
+      ProcessSnapshot* process_snapshot) override {
+    ++*started_;
+    for (int attempt = 0; attempt < 5000; ++attempt) {
+      if (*started_ >= group_size_) {
+        gathered_ = true;
+        break;
+      }
+      SleepNanoseconds(kMillisecond);
+    }
+    return std::make_unique<BufferExtensionStreamDataSource>(
+        stream_type_, &stream_type_, sizeof(stream_type_));
+  }
+
+  bool gathered() const { return gathered_; }
+
+ private:
+  uint32_t stream_type_;
+  std::atomic<int>* started_;
+  int group_size_;
+  bool gathered_;
+};
+
+// Runs until it’s canceled, or for about five seconds.
+class SlowDataSource : public UserStreamDataSource {
+ public:
+  explicit SlowDataSource(uint32_t stream_type)
+      : stream_type_(stream_type), canceled_(false) {}
+
+  SlowDataSource(const SlowDataSource&) = delete;
+  SlowDataSource& operator=(const SlowDataSource&) = delete;
+
+  std::unique_ptr<MinidumpUserExtensionStreamDataSource> ProduceStreamData(
+      ProcessSnapshot* process_snapshot) override {
+    ADD_FAILURE() << "not run cancelably";
+    return nullptr;
+  }
+
+  std::unique_ptr<MinidumpUserExtensionStreamDataSource>
+  ProduceStreamDataCancelable(ProcessSnapshot* process_snapshot,
+                              const std::atomic<bool>& canceled) override {
+    for (int attempt = 0; attempt < 5000 && !canceled; ++attempt) {
+      SleepNanoseconds(kMillisecond);
+    }
+    canceled_ = canceled;
+    return std::make_unique<BufferExtensionStreamDataSource>(
+        stream_type_, &stream_type_, sizeof(stream_type_));
+  }
+
+  bool canceled() const { return canceled_; }
+
+ private:
+  uint32_t stream_type_;
+  bool canceled_;
+};
+
+// Returns the types of the streams in minidump_file, in order.
+std::vector<uint32_t> StreamTypes(MinidumpFileWriter* minidump_file) {
+  StringFile string_file;
+  EXPECT_TRUE(minidump_file->WriteEverything(&string_file));
+
+  const MINIDUMP_DIRECTORY* directory;
+  const MINIDUMP_HEADER* header =
+      MinidumpHeaderAtStart(string_file.string(), &directory);
+  std::vector<uint32_t> stream_types;
+  if (header && directory) {
+    for (uint32_t index = 0; index < header->NumberOfStreams; ++index) {
+      stream_types.push_back(directory[index].StreamType);
+    }
+  }
+  return stream_types;
+}
+
+TEST(UserStreamDataSource, Sequential) {
+  std::atomic<int> started(0);
+  UserStreamDataSources sources;
+  sources.push_back(std::make_unique<GatheringDataSource>(0x4d, &started, 1));
+  sources.push_back(std::make_unique<GatheringDataSource>(0x4e, &started, 1));
+
+  TestProcessSnapshot process_snapshot;
+  MinidumpFileWriter minidump_file;
+  AddUserExtensionStreams(&sources, &process_snapshot, &minidump_file);
+
+  EXPECT_EQ(StreamTypes(&minidump_file), (std::vector<uint32_t>{0x4d, 0x4e}));
+}
+
+TEST(UserStreamDataSource, Concurrent) {
+  // Each source waits for all of them to start, so they only gather if they
+  // run at the same time.
+  std::atomic<int> started(0);
+  UserStreamDataSources sources;
+  for (uint32_t stream_type = 0x4d; stream_type < 0x50; ++stream_type) {
+    sources.push_back(
+        std::make_unique<GatheringDataSource>(stream_type, &started, 3));
+  }
+
+  TestProcessSnapshot process_snapshot;
+  MinidumpFileWriter minidump_file;
+  AddUserExtensionStreams(&sources, &process_snapshot, &minidump_file, 3);
+
+  for (const auto& source : sources) {
+    EXPECT_TRUE(static_cast<GatheringDataSource*>(source.get())->gathered());
+  }
+
+  // The streams are in the order of their sources, whichever finished first.
+  EXPECT_EQ(StreamTypes(&minidump_file),
+            (std::vector<uint32_t>{0x4d, 0x4e, 0x4f}));
+}
+
+TEST(UserStreamDataSource, TimeBudget) {
+  std::atomic<int> started(0);
+  UserStreamDataSources sources;
+  sources.push_back(std::make_unique<SlowDataSource>(0x4d));
+  sources.push_back(std::make_unique<GatheringDataSource>(0x4e, &started, 1));
+  sources.push_back(std::make_unique<SlowDataSource>(0x4f));
+
+  TestProcessSnapshot process_snapshot;
+  MinidumpFileWriter minidump_file;
+  AddUserExtensionStreams(
+      &sources, &process_snapshot, &minidump_file, 2, 0.05);
+
+  EXPECT_TRUE(static_cast<SlowDataSource*>(sources[0].get())->canceled());
+  EXPECT_TRUE(static_cast<SlowDataSource*>(sources[2].get())->canceled());
+
+  // Only the source that finished within its budget adds its stream.
+  EXPECT_EQ(StreamTypes(&minidump_file), (std::vector<uint32_t>{0x4e}));
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
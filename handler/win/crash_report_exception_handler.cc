@@ -24,9 +24,12 @@
 #include "minidump/minidump_file_writer.h"
 #include "minidump/minidump_user_extension_stream_data_source.h"
 #include "snapshot/win/process_snapshot_win.h"
-#include "util/file/file_helper.h"
+#include "util/file/file_io.h"
 #include "util/file/file_writer.h"
 #include "util/misc/metrics.h"
+#include "util/misc/trace_events.h"
+#include "util/win/exception_codes.h"
+#include "util/win/process_va_clone.h"
 #include "util/win/registration_protocol_win.h"
 #include "util/win/scoped_process_suspend.h"
 #include "util/win/termination_codes.h"
@@ -43,7 +46,8 @@ CrashReportExceptionHandler::CrashReportExceptionHandler(
       upload_thread_(upload_thread),
       process_annotations_(process_annotations),
       attachments_(attachments),
-      user_stream_data_sources_(user_stream_data_sources) {}
+      user_stream_data_sources_(user_stream_data_sources),
+      clone_non_fatal_dumps_(false) {}
 
 CrashReportExceptionHandler::~CrashReportExceptionHandler() {}
 
@@ -54,6 +58,7 @@ unsigned int CrashReportExceptionHandler::ExceptionHandlerServerException(
     WinVMAddress exception_information_address,
     WinVMAddress debug_critical_section_address) {
   Metrics::ExceptionEncountered();
+  TraceEvents::ScopedContext trace_context(GetProcessId(process));
 
   ScopedProcessSuspend suspend(process);
 
@@ -77,6 +82,16 @@ unsigned int CrashReportExceptionHandler::ExceptionHandlerServerException(
 
   Metrics::ExceptionCode(termination_code);
 
+  // Everything but memory contents has been read, so a client that isn’t
+  // crashing can be resumed once there’s a clone of its memory to read.
+  ProcessVaClone va_clone;
+  if (clone_non_fatal_dumps_ &&
+      termination_code == ExceptionCodes::kSimulatedExceptionCode &&
+      va_clone.Initialize(process)) {
+    process_snapshot.ReadMemoryFrom(va_clone.handle());
+    suspend.Resume();
+  }
+
   CrashpadInfoClientOptions client_options;
   process_snapshot.GetCrashpadOptions(&client_options);
   if (client_options.crashpad_handler_behavior != TriState::kDisabled) {
@@ -99,6 +114,7 @@ unsigned int CrashReportExceptionHandler::ExceptionHandlerServerException(
     }
 
     process_snapshot.SetReportID(new_report->ReportID());
+    TraceEvents::SetReportID(new_report->ReportID());
 
     MinidumpFileWriter minidump;
     minidump.InitializeFromSnapshot(&process_snapshot);
@@ -112,29 +128,32 @@ unsigned int CrashReportExceptionHandler::ExceptionHandlerServerException(
       return termination_code;
     }
 
-    for (const auto& attachment : (*attachments_)) {
-      FileReader file_reader;
-      if (!file_reader.Open(attachment)) {
-        LOG(ERROR) << "attachment " << attachment.value().c_str()
-                   << " couldn't be opened, skipping";
-        continue;
-      }
-
-      base::FilePath filename = attachment.BaseName();
-      FileWriter* file_writer =
-          new_report->AddAttachment(base::WideToUTF8(filename.value()));
-      if (file_writer == nullptr) {
-        LOG(ERROR) << "attachment " << filename.value().c_str()
-                   << " couldn't be created, skipping";
-        continue;
+    if (!attachments_->empty()) {
+      TraceEvents::ScopedEvent attachments_event("CopyAttachments");
+      for (const auto& attachment : (*attachments_)) {
+        ScopedFileHandle attachment_file(LoggingOpenFileForRead(attachment));
+        if (!attachment_file.is_valid()) {
+          LOG(ERROR) << "attachment " << attachment.value().c_str()
+                     << " couldn't be opened, skipping";
+          continue;
+        }
+
+        base::FilePath filename = attachment.BaseName();
+        if (!new_report->AddAttachmentFromFile(
+                base::WideToUTF8(filename.value()), attachment_file.get())) {
+          LOG(ERROR) << "attachment " << filename.value().c_str()
+                     << " couldn't be created, skipping";
+          continue;
+        }
       }
-
-      CopyFileContent(&file_reader, file_writer);
     }
 
     UUID uuid;
-    database_status =
-        database_->FinishedWritingCrashReport(std::move(new_report), &uuid);
+    {
+      TraceEvents::ScopedEvent commit_event("DatabaseCommit");
+      database_status =
+          database_->FinishedWritingCrashReport(std::move(new_report), &uuid);
+    }
     if (database_status != CrashReportDatabase::kNoError) {
       LOG(ERROR) << "FinishedWritingCrashReport failed";
       Metrics::ExceptionCaptureResult(
@@ -68,6 +68,18 @@ class CrashReportExceptionHandler final
 
   ~CrashReportExceptionHandler();
 
+  //! \brief Sets whether clients that request dumps without crashing are
+  //!     resumed before their minidumps are written.
+  //!
+  //! When enabled, once a client that requested a dump without crashing has
+  //! been snapshotted, its address space is cloned with ProcessVaClone and the
+  //! client is resumed. The minidump’s memory is then read from the clone.
+  //! Crashing clients stay suspended until their reports are written. If the
+  //! clone can’t be made, the client stays suspended too.
+  void SetCloneNonFatalDumps(bool clone_non_fatal_dumps) {
+    clone_non_fatal_dumps_ = clone_non_fatal_dumps;
+  }
+
   // ExceptionHandlerServer::Delegate:
 
   //! \brief Processes an exception message by writing a crash report to this
@@ -84,6 +96,7 @@ class CrashReportExceptionHandler final
   const std::map<std::string, std::string>* process_annotations_;  // weak
   const std::vector<base::FilePath>* attachments_;  // weak
   const UserStreamDataSources* user_stream_data_sources_;  // weak
+  bool clone_non_fatal_dumps_;
 };
 
 }  // namespace crashpad
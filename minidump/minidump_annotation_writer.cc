@@ -14,6 +14,7 @@
 
 #include "minidump/minidump_annotation_writer.h"
 
+#include <algorithm>
 #include <memory>
 
 #include "base/logging.h"
@@ -160,4 +161,70 @@ bool MinidumpAnnotationListWriter::WriteObject(
   return file_writer->WriteIoVec(&iov);
 }
 
+MinidumpAnnotationThreadListWriter::MinidumpAnnotationThreadListWriter()
+    : minidump_list_(new MinidumpAnnotationThreadList()), thread_ids_() {}
+
+MinidumpAnnotationThreadListWriter::~MinidumpAnnotationThreadListWriter() =
+    default;
+
+void MinidumpAnnotationThreadListWriter::InitializeFromList(
+    const std::vector<AnnotationSnapshot>& list) {
+  DCHECK_EQ(state(), kStateMutable);
+  for (const auto& annotation : list) {
+    AddThreadID(annotation.thread_id);
+  }
+}
+
+void MinidumpAnnotationThreadListWriter::AddThreadID(uint64_t thread_id) {
+  DCHECK_EQ(state(), kStateMutable);
+
+  thread_ids_.push_back(thread_id);
+}
+
+bool MinidumpAnnotationThreadListWriter::IsUseful() const {
+  return std::any_of(thread_ids_.begin(),
+                     thread_ids_.end(),
+                     [](uint64_t thread_id) { return thread_id != 0; });
+}
+
+bool MinidumpAnnotationThreadListWriter::Freeze() {
+  DCHECK_EQ(state(), kStateMutable);
+
+  if (!MinidumpWritable::Freeze()) {
+    return false;
+  }
+
+  if (!AssignIfInRange(&minidump_list_->count, thread_ids_.size())) {
+    LOG(ERROR) << "annotation thread list size " << thread_ids_.size()
+               << " is out of range";
+    return false;
+  }
+
+  return true;
+}
+
+size_t MinidumpAnnotationThreadListWriter::SizeOfObject() {
+  DCHECK_GE(state(), kStateFrozen);
+
+  return sizeof(*minidump_list_) + sizeof(uint64_t) * thread_ids_.size();
+}
+
+bool MinidumpAnnotationThreadListWriter::WriteObject(
+    FileWriterInterface* file_writer) {
+  DCHECK_EQ(state(), kStateWritable);
+
+  WritableIoVec iov;
+  iov.iov_base = minidump_list_.get();
+  iov.iov_len = sizeof(*minidump_list_);
+  std::vector<WritableIoVec> iovecs(1, iov);
+
+  if (!thread_ids_.empty()) {
+    iov.iov_base = thread_ids_.data();
+    iov.iov_len = sizeof(uint64_t) * thread_ids_.size();
+    iovecs.push_back(iov);
+  }
+
+  return file_writer->WriteIoVec(&iovecs);
+}
+
 }  // namespace crashpad
@@ -109,6 +109,51 @@ class MinidumpAnnotationListWriter final : public internal::MinidumpWritable {
   std::vector<std::unique_ptr<MinidumpAnnotationWriter>> objects_;
 };
 
+//! \brief The writer for a MinidumpAnnotationThreadList object in a minidump
+//!     file, identifying the threads that own the annotations written by a
+//!     MinidumpAnnotationListWriter.
+class MinidumpAnnotationThreadListWriter final
+    : public internal::MinidumpWritable {
+ public:
+  MinidumpAnnotationThreadListWriter();
+
+  MinidumpAnnotationThreadListWriter(
+      const MinidumpAnnotationThreadListWriter&) = delete;
+  MinidumpAnnotationThreadListWriter& operator=(
+      const MinidumpAnnotationThreadListWriter&) = delete;
+
+  ~MinidumpAnnotationThreadListWriter();
+
+  //! \brief Initializes the writer with the AnnotationSnapshot::thread_id of
+  //!     each object in \a list, in the same order as
+  //!     MinidumpAnnotationListWriter::InitializeFromList().
+  void InitializeFromList(const std::vector<AnnotationSnapshot>& list);
+
+  //! \brief Adds the ID of the thread that owns the next annotation object, or
+  //!     `0` if it is not owned by a thread.
+  void AddThreadID(uint64_t thread_id);
+
+  //! \brief Determines whether the object is useful.
+  //!
+  //! A useful object is one that carries data that makes a meaningful
+  //! contribution to a minidump file. An object carrying at least one nonzero
+  //! thread ID would be considered useful.
+  //!
+  //! \return `true` if the object is useful, `false` otherwise.
+  bool IsUseful() const;
+
+ protected:
+  // MinidumpWritable:
+
+  bool Freeze() override;
+  size_t SizeOfObject() override;
+  bool WriteObject(FileWriterInterface* file_writer) override;
+
+ private:
+  std::unique_ptr<MinidumpAnnotationThreadList> minidump_list_;
+  std::vector<uint64_t> thread_ids_;
+};
+
 }  // namespace crashpad
 
 #endif  // CRASHPAD_MINIDUMP_MINIDUMP_ANNOTATION_WRITER_H_
@@ -187,6 +187,36 @@ TEST(MinidumpAnnotationWriter, DuplicateNames) {
       kValue2);
 }
 
+TEST(MinidumpAnnotationThreadListWriter, ThreadIDs) {
+  StringFile string_file;
+
+  MinidumpAnnotationThreadListWriter thread_list_writer;
+  EXPECT_FALSE(thread_list_writer.IsUseful());
+
+  std::vector<AnnotationSnapshot> annotations(3);
+  annotations[1].thread_id = 0x123456789;
+  thread_list_writer.InitializeFromList(annotations);
+  EXPECT_TRUE(thread_list_writer.IsUseful());
+
+  EXPECT_TRUE(thread_list_writer.WriteEverything(&string_file));
+
+  ASSERT_EQ(string_file.string().size(),
+            sizeof(MinidumpAnnotationThreadList) + 3 * sizeof(uint64_t));
+
+  MINIDUMP_LOCATION_DESCRIPTOR location_descriptor;
+  location_descriptor.DataSize =
+      static_cast<uint32_t>(string_file.string().size());
+  location_descriptor.Rva = 0;
+  auto* list =
+      MinidumpWritableAtLocationDescriptor<MinidumpAnnotationThreadList>(
+          string_file.string(), location_descriptor);
+  ASSERT_TRUE(list);
+  EXPECT_EQ(list->count, 3u);
+  EXPECT_EQ(list->thread_ids[0], 0u);
+  EXPECT_EQ(list->thread_ids[1], 0x123456789u);
+  EXPECT_EQ(list->thread_ids[2], 0u);
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace crashpad
@@ -0,0 +1,412 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Measures how long it takes to build and write a minidump file from a
+// synthetic process snapshot of configurable size.
+//
+// Each iteration constructs a fresh MinidumpFileWriter, times
+// InitializeFromSnapshot(), and then times WriteEverything() into a StringFile
+// and into a real file. Results are reported per benchmark as the mean and
+// minimum wall time over all iterations.
+
+#include <getopt.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/time.h>
+
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/files/file_path.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/stringprintf.h"
+#include "build/build_config.h"
+#include "minidump/minidump_file_writer.h"
+#include "snapshot/annotation_snapshot.h"
+#include "snapshot/test/test_cpu_context.h"
+#include "snapshot/test/test_exception_snapshot.h"
+#include "snapshot/test/test_memory_snapshot.h"
+#include "snapshot/test/test_module_snapshot.h"
+#include "snapshot/test/test_process_snapshot.h"
+#include "snapshot/test/test_system_snapshot.h"
+#include "snapshot/test/test_thread_snapshot.h"
+#include "test/scoped_temp_dir.h"
+#include "util/file/file_writer.h"
+#include "util/file/string_file.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+// crashpad::Annotation::Type::kString, without depending on the client library.
+constexpr uint16_t kAnnotationTypeString = 1;
+
+struct Options {
+  size_t threads;
+  size_t modules;
+  size_t annotations;
+  size_t memory_regions;
+  size_t memory_region_size;
+  size_t stack_size;
+  size_t iterations;
+  base::FilePath file;
+};
+
+void Usage(const std::string& me) {
+  // clang-format off
+  fprintf(stderr,
+"Usage: %s [OPTION]...\n"
+"Benchmark writing a minidump file from a synthetic process snapshot.\n"
+"\n"
+"      --annotations=N         annotations per module, of each kind (default 16)\n"
+"      --file=PATH             write the file benchmark to PATH instead of a\n"
+"                              temporary file\n"
+"      --iterations=N          repetitions of each benchmark (default 20)\n"
+"      --memory-region-size=N  bytes in each extra memory region (default 4096)\n"
+"      --memory-regions=N      extra memory regions (default 256)\n"
+"      --modules=N             modules (default 200)\n"
+"      --stack-size=N          bytes of stack per thread (default 16384)\n"
+"      --threads=N             threads (default 64)\n"
+"      --help                  display this help and exit\n",
+          me.c_str());
+  // clang-format on
+}
+
+std::unique_ptr<TestProcessSnapshot> CreateProcessSnapshot(
+    const Options& options) {
+  auto process_snapshot = std::make_unique<TestProcessSnapshot>();
+
+  timeval snapshot_time;
+  gettimeofday(&snapshot_time, nullptr);
+  process_snapshot->SetSnapshotTime(snapshot_time);
+
+  auto system_snapshot = std::make_unique<TestSystemSnapshot>();
+  system_snapshot->SetCPUArchitecture(kCPUArchitectureX86_64);
+  system_snapshot->SetOperatingSystem(SystemSnapshot::kOperatingSystemLinux);
+  process_snapshot->SetSystem(std::move(system_snapshot));
+
+  // Lay out memory so that no two regions overlap and none are merged.
+  uint64_t address = 0x7f0000000000;
+  auto next_address = [&address](size_t size) {
+    const uint64_t result = address;
+    address += size + 0x1000;
+    return result;
+  };
+
+  for (size_t index = 0; index < options.threads; ++index) {
+    auto thread_snapshot = std::make_unique<TestThreadSnapshot>();
+    InitializeCPUContextX86_64(thread_snapshot->MutableContext(),
+                               static_cast<uint32_t>(index));
+    thread_snapshot->SetThreadID(1000 + index);
+    thread_snapshot->SetThreadName(base::StringPrintf("thread %zu", index));
+
+    auto stack = std::make_unique<TestMemorySnapshot>();
+    stack->SetAddress(next_address(options.stack_size));
+    stack->SetSize(options.stack_size);
+    stack->SetValue('s');
+    thread_snapshot->SetStack(std::move(stack));
+
+    process_snapshot->AddThread(std::move(thread_snapshot));
+  }
+
+  if (options.threads > 0) {
+    auto exception_snapshot = std::make_unique<TestExceptionSnapshot>();
+    InitializeCPUContextX86_64(exception_snapshot->MutableContext(), 0);
+    exception_snapshot->SetThreadID(1000);
+    exception_snapshot->SetException(11);
+    process_snapshot->SetException(std::move(exception_snapshot));
+  }
+
+  for (size_t index = 0; index < options.modules; ++index) {
+    auto module_snapshot = std::make_unique<TestModuleSnapshot>();
+    module_snapshot->SetName(
+        base::StringPrintf("/usr/lib/libbenchmark_%zu.so", index));
+    module_snapshot->SetAddressAndSize(next_address(0x100000), 0x100000);
+    module_snapshot->SetModuleType(ModuleSnapshot::kModuleTypeSharedLibrary);
+    module_snapshot->SetBuildID(std::vector<uint8_t>(20, index & 0xff));
+    module_snapshot->SetDebugFileName(
+        base::StringPrintf("libbenchmark_%zu.so.debug", index));
+
+    std::vector<std::string> annotations_vector;
+    std::map<std::string, std::string> annotations_simple_map;
+    std::vector<AnnotationSnapshot> annotation_objects;
+    for (size_t annotation = 0; annotation < options.annotations;
+         ++annotation) {
+      const std::string name = base::StringPrintf("key_%zu", annotation);
+      const std::string value = base::StringPrintf(
+          "value %zu for module %zu", annotation, index);
+      annotations_vector.push_back(value);
+      annotations_simple_map[name] = value;
+      annotation_objects.emplace_back(
+          name,
+          kAnnotationTypeString,
+          std::vector<uint8_t>(value.begin(), value.end()));
+    }
+    module_snapshot->SetAnnotationsVector(annotations_vector);
+    module_snapshot->SetAnnotationsSimpleMap(annotations_simple_map);
+    module_snapshot->SetAnnotationObjects(annotation_objects);
+
+    process_snapshot->AddModule(std::move(module_snapshot));
+  }
+
+  for (size_t index = 0; index < options.memory_regions; ++index) {
+    auto memory = std::make_unique<TestMemorySnapshot>();
+    memory->SetAddress(next_address(options.memory_region_size));
+    memory->SetSize(options.memory_region_size);
+    memory->SetValue('m');
+    process_snapshot->AddExtraMemory(std::move(memory));
+  }
+
+  return process_snapshot;
+}
+
+class Benchmark {
+ public:
+  explicit Benchmark(const std::string& name)
+      : name_(name), seconds_(), bytes_(0) {}
+
+  Benchmark(const Benchmark&) = delete;
+  Benchmark& operator=(const Benchmark&) = delete;
+
+  ~Benchmark() {}
+
+  void AddIteration(std::chrono::steady_clock::duration elapsed) {
+    seconds_.push_back(std::chrono::duration<double>(elapsed).count());
+  }
+
+  void SetBytes(uint64_t bytes) { bytes_ = bytes; }
+
+  static void PrintHeader() {
+    printf("%-32s %12s %12s %10s %14s\n",
+           "Benchmark",
+           "Mean",
+           "Min",
+           "Iterations",
+           "Throughput");
+  }
+
+  void Print() const {
+    if (seconds_.empty()) {
+      return;
+    }
+
+    double total = 0;
+    for (double seconds : seconds_) {
+      total += seconds;
+    }
+    const double mean = total / seconds_.size();
+    const double min = *std::min_element(seconds_.begin(), seconds_.end());
+
+    std::string throughput;
+    if (bytes_ && mean > 0) {
+      throughput = base::StringPrintf("%.1f MB/s", bytes_ / mean / 1e6);
+    }
+
+    printf("%-32s %9.3f ms %9.3f ms %10zu %14s\n",
+           name_.c_str(),
+           mean * 1e3,
+           min * 1e3,
+           seconds_.size(),
+           throughput.c_str());
+  }
+
+ private:
+  std::string name_;
+  std::vector<double> seconds_;
+  uint64_t bytes_;
+};
+
+// Runs InitializeFromSnapshot() on a new MinidumpFileWriter, and then
+// WriteEverything() to file_writer, recording the time taken by each. If
+// initialize is nullptr, the time taken by InitializeFromSnapshot() is not
+// recorded.
+bool InitializeAndWrite(const ProcessSnapshot* process_snapshot,
+                        FileWriterInterface* file_writer,
+                        Benchmark* initialize,
+                        Benchmark* write) {
+  MinidumpFileWriter minidump;
+
+  auto start = std::chrono::steady_clock::now();
+  minidump.InitializeFromSnapshot(process_snapshot);
+  auto initialized = std::chrono::steady_clock::now();
+  if (!minidump.WriteEverything(file_writer)) {
+    return false;
+  }
+  auto written = std::chrono::steady_clock::now();
+
+  if (initialize) {
+    initialize->AddIteration(initialized - start);
+  }
+  write->AddIteration(written - initialized);
+  return true;
+}
+
+int MinidumpBenchmarksMain(int argc, char* argv[]) {
+  const std::string me = base::FilePath(argv[0]).BaseName().value();
+
+  enum OptionFlags {
+    // Long options without short equivalents.
+    kOptionLastChar = 255,
+    kOptionAnnotations,
+    kOptionFile,
+    kOptionIterations,
+    kOptionMemoryRegionSize,
+    kOptionMemoryRegions,
+    kOptionModules,
+    kOptionStackSize,
+    kOptionThreads,
+
+    // Standard options.
+    kOptionHelp = -2,
+  };
+
+  Options options = {};
+  options.threads = 64;
+  options.modules = 200;
+  options.annotations = 16;
+  options.memory_regions = 256;
+  options.memory_region_size = 4096;
+  options.stack_size = 16384;
+  options.iterations = 20;
+
+  static constexpr option long_options[] = {
+      {"annotations", required_argument, nullptr, kOptionAnnotations},
+      {"file", required_argument, nullptr, kOptionFile},
+      {"iterations", required_argument, nullptr, kOptionIterations},
+      {"memory-region-size",
+       required_argument,
+       nullptr,
+       kOptionMemoryRegionSize},
+      {"memory-regions", required_argument, nullptr, kOptionMemoryRegions},
+      {"modules", required_argument, nullptr, kOptionModules},
+      {"stack-size", required_argument, nullptr, kOptionStackSize},
+      {"threads", required_argument, nullptr, kOptionThreads},
+      {"help", no_argument, nullptr, kOptionHelp},
+      {nullptr, 0, nullptr, 0},
+  };
+
+  int opt;
+  while ((opt = getopt_long(argc, argv, "", long_options, nullptr)) != -1) {
+    size_t* size_option = nullptr;
+    switch (opt) {
+      case kOptionAnnotations:
+        size_option = &options.annotations;
+        break;
+      case kOptionFile:
+        options.file = base::FilePath(optarg);
+        break;
+      case kOptionIterations:
+        size_option = &options.iterations;
+        break;
+      case kOptionMemoryRegionSize:
+        size_option = &options.memory_region_size;
+        break;
+      case kOptionMemoryRegions:
+        size_option = &options.memory_regions;
+        break;
+      case kOptionModules:
+        size_option = &options.modules;
+        break;
+      case kOptionStackSize:
+        size_option = &options.stack_size;
+        break;
+      case kOptionThreads:
+        size_option = &options.threads;
+        break;
+      case kOptionHelp:
+        Usage(me);
+        return EXIT_SUCCESS;
+      default:
+        fprintf(stderr, "Try '%s --help' for more information.\n", me.c_str());
+        return EXIT_FAILURE;
+    }
+
+    if (size_option && !base::StringToSizeT(optarg, size_option)) {
+      fprintf(stderr, "%s: invalid number: %s\n", me.c_str(), optarg);
+      return EXIT_FAILURE;
+    }
+  }
+
+  if (optind != argc) {
+    fprintf(stderr, "Try '%s --help' for more information.\n", me.c_str());
+    return EXIT_FAILURE;
+  }
+
+  std::unique_ptr<ScopedTempDir> temp_dir;
+  if (options.file.empty()) {
+    temp_dir = std::make_unique<ScopedTempDir>();
+    options.file = temp_dir->path().Append(FILE_PATH_LITERAL("benchmark.dmp"));
+  }
+
+  const std::unique_ptr<TestProcessSnapshot> process_snapshot =
+      CreateProcessSnapshot(options);
+
+  Benchmark initialize("InitializeFromSnapshot");
+  Benchmark write_string_file("WriteEverything/StringFile");
+  Benchmark write_file("WriteEverything/File");
+
+  for (size_t iteration = 0; iteration < options.iterations; ++iteration) {
+    StringFile string_file;
+    if (!InitializeAndWrite(process_snapshot.get(),
+                            &string_file,
+                            &initialize,
+                            &write_string_file)) {
+      fprintf(stderr, "%s: WriteEverything failed\n", me.c_str());
+      return EXIT_FAILURE;
+    }
+    write_string_file.SetBytes(string_file.string().size());
+
+    FileWriter file_writer;
+    if (!file_writer.Open(options.file,
+                          FileWriteMode::kTruncateOrCreate,
+                          FilePermissions::kOwnerOnly)) {
+      return EXIT_FAILURE;
+    }
+    if (!InitializeAndWrite(
+            process_snapshot.get(), &file_writer, nullptr, &write_file)) {
+      fprintf(stderr, "%s: WriteEverything failed\n", me.c_str());
+      return EXIT_FAILURE;
+    }
+    write_file.SetBytes(string_file.string().size());
+  }
+
+  printf("threads=%zu modules=%zu annotations=%zu memory_regions=%zu "
+         "memory_region_size=%zu stack_size=%zu\n\n",
+         options.threads,
+         options.modules,
+         options.annotations,
+         options.memory_regions,
+         options.memory_region_size,
+         options.stack_size);
+  Benchmark::PrintHeader();
+  initialize.Print();
+  write_string_file.Print();
+  write_file.Print();
+
+  return EXIT_SUCCESS;
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
+
+int main(int argc, char* argv[]) {
+  return crashpad::test::MinidumpBenchmarksMain(argc, argv);
+}
@@ -48,6 +48,16 @@ static_assert(sizeof(MinidumpContextAMD64) == sizeof(CONTEXT), "CONTEXT size");
 #endif  // ARCH_CPU_X86_FAMILY
 #endif  // BUILDFLAG(IS_WIN)
 
+// Creates a Writer and initializes it from context_snapshot. The concrete
+// writer type is known here, so InitializeFromSnapshot() is bound statically.
+template <typename Writer>
+std::unique_ptr<MinidumpContextWriter> CreateContextWriter(
+    const typename Writer::SnapshotType* context_snapshot) {
+  std::unique_ptr<Writer> context(new Writer());
+  context->InitializeFromSnapshot(context_snapshot);
+  return context;
+}
+
 }  // namespace
 
 MinidumpContextWriter::~MinidumpContextWriter() {
@@ -56,60 +66,36 @@ MinidumpContextWriter::~MinidumpContextWriter() {
 // static
 std::unique_ptr<MinidumpContextWriter>
 MinidumpContextWriter::CreateFromSnapshot(const CPUContext* context_snapshot) {
-  std::unique_ptr<MinidumpContextWriter> context;
-
   switch (context_snapshot->architecture) {
-    case kCPUArchitectureX86: {
-      MinidumpContextX86Writer* context_x86 = new MinidumpContextX86Writer();
-      context.reset(context_x86);
-      context_x86->InitializeFromSnapshot(context_snapshot->x86);
-      break;
-    }
+    case kCPUArchitectureX86:
+      return CreateContextWriter<MinidumpContextX86Writer>(
+          context_snapshot->x86);
 
-    case kCPUArchitectureX86_64: {
-      MinidumpContextAMD64Writer* context_amd64 =
-          new MinidumpContextAMD64Writer();
-      context.reset(context_amd64);
-      context_amd64->InitializeFromSnapshot(context_snapshot->x86_64);
-      break;
-    }
+    case kCPUArchitectureX86_64:
+      return CreateContextWriter<MinidumpContextAMD64Writer>(
+          context_snapshot->x86_64);
 
-    case kCPUArchitectureARM: {
-      context = std::make_unique<MinidumpContextARMWriter>();
-      reinterpret_cast<MinidumpContextARMWriter*>(context.get())
-          ->InitializeFromSnapshot(context_snapshot->arm);
-      break;
-    }
+    case kCPUArchitectureARM:
+      return CreateContextWriter<MinidumpContextARMWriter>(
+          context_snapshot->arm);
 
-    case kCPUArchitectureARM64: {
-      context = std::make_unique<MinidumpContextARM64Writer>();
-      reinterpret_cast<MinidumpContextARM64Writer*>(context.get())
-          ->InitializeFromSnapshot(context_snapshot->arm64);
-      break;
-    }
+    case kCPUArchitectureARM64:
+      return CreateContextWriter<MinidumpContextARM64Writer>(
+          context_snapshot->arm64);
 
-    case kCPUArchitectureMIPSEL: {
-      context = std::make_unique<MinidumpContextMIPSWriter>();
-      reinterpret_cast<MinidumpContextMIPSWriter*>(context.get())
-          ->InitializeFromSnapshot(context_snapshot->mipsel);
-      break;
-    }
+    case kCPUArchitectureMIPSEL:
+      return CreateContextWriter<MinidumpContextMIPSWriter>(
+          context_snapshot->mipsel);
 
-    case kCPUArchitectureMIPS64EL: {
-      context = std::make_unique<MinidumpContextMIPS64Writer>();
-      reinterpret_cast<MinidumpContextMIPS64Writer*>(context.get())
-          ->InitializeFromSnapshot(context_snapshot->mips64);
-      break;
-    }
+    case kCPUArchitectureMIPS64EL:
+      return CreateContextWriter<MinidumpContextMIPS64Writer>(
+          context_snapshot->mips64);
 
-    default: {
+    default:
       LOG(ERROR) << "unknown context architecture "
                  << context_snapshot->architecture;
-      break;
-    }
+      return nullptr;
   }
-
-  return context;
 }
 
 size_t MinidumpContextWriter::SizeOfObject() {
@@ -123,65 +109,254 @@ size_t MinidumpContextWriter::FreezeAndGetSizeOfObject() {
   return SizeOfObject();
 }
 
-MinidumpContextX86Writer::MinidumpContextX86Writer()
+namespace internal {
+
+template <typename Traits>
+MinidumpFixedContextWriter<Traits>::MinidumpFixedContextWriter()
     : MinidumpContextWriter(), context_() {
-  context_.context_flags = kMinidumpContextX86;
+  context_.context_flags = Traits::kContextFlags;
 }
 
-MinidumpContextX86Writer::~MinidumpContextX86Writer() {
+template <typename Traits>
+MinidumpFixedContextWriter<Traits>::~MinidumpFixedContextWriter() {
 }
 
-void MinidumpContextX86Writer::InitializeFromSnapshot(
-    const CPUContextX86* context_snapshot) {
+template <typename Traits>
+void MinidumpFixedContextWriter<Traits>::InitializeFromSnapshot(
+    const SnapshotType* context_snapshot) {
   DCHECK_EQ(state(), kStateMutable);
-  DCHECK_EQ(context_.context_flags, kMinidumpContextX86);
+  DCHECK_EQ(context_.context_flags, Traits::kContextFlags);
+
+  Traits::Convert(context_snapshot, &context_);
+}
+
+template <typename Traits>
+bool MinidumpFixedContextWriter<Traits>::WriteObject(
+    FileWriterInterface* file_writer) {
+  DCHECK_EQ(state(), kStateWritable);
+
+  return file_writer->Write(&context_, sizeof(context_));
+}
 
-  context_.context_flags = kMinidumpContextX86All;
+template <typename Traits>
+size_t MinidumpFixedContextWriter<Traits>::ContextSize() const {
+  DCHECK_GE(state(), kStateFrozen);
+
+  return sizeof(context_);
+}
 
-  context_.dr0 = context_snapshot->dr0;
-  context_.dr1 = context_snapshot->dr1;
-  context_.dr2 = context_snapshot->dr2;
-  context_.dr3 = context_snapshot->dr3;
-  context_.dr6 = context_snapshot->dr6;
-  context_.dr7 = context_snapshot->dr7;
+// Explicit template instantiation of the forms of MinidumpFixedContextWriter<>
+// used as base classes.
+template class MinidumpFixedContextWriter<MinidumpContextX86WriterTraits>;
+template class MinidumpFixedContextWriter<MinidumpContextAMD64WriterTraits>;
+template class MinidumpFixedContextWriter<MinidumpContextARMWriterTraits>;
+template class MinidumpFixedContextWriter<MinidumpContextARM64WriterTraits>;
+template class MinidumpFixedContextWriter<MinidumpContextMIPSWriterTraits>;
+template class MinidumpFixedContextWriter<MinidumpContextMIPS64WriterTraits>;
 
-  // The contents of context_.fsave effectively alias everything in
-  // context_.fxsave that’s related to x87 FPU state. context_.fsave doesn’t
+// static
+void MinidumpContextX86WriterTraits::Convert(
+    const CPUContextX86* context_snapshot,
+    MinidumpContextX86* context) {
+  context->context_flags = kMinidumpContextX86All;
+
+  context->dr0 = context_snapshot->dr0;
+  context->dr1 = context_snapshot->dr1;
+  context->dr2 = context_snapshot->dr2;
+  context->dr3 = context_snapshot->dr3;
+  context->dr6 = context_snapshot->dr6;
+  context->dr7 = context_snapshot->dr7;
+
+  // The contents of context->fsave effectively alias everything in
+  // context->fxsave that’s related to x87 FPU state. context->fsave doesn’t
   // carry state specific to SSE (or later), such as mxcsr and the xmm
   // registers.
-  CPUContextX86::FxsaveToFsave(context_snapshot->fxsave, &context_.fsave);
-
-  context_.gs = context_snapshot->gs;
-  context_.fs = context_snapshot->fs;
-  context_.es = context_snapshot->es;
-  context_.ds = context_snapshot->ds;
-  context_.edi = context_snapshot->edi;
-  context_.esi = context_snapshot->esi;
-  context_.ebx = context_snapshot->ebx;
-  context_.edx = context_snapshot->edx;
-  context_.ecx = context_snapshot->ecx;
-  context_.eax = context_snapshot->eax;
-  context_.ebp = context_snapshot->ebp;
-  context_.eip = context_snapshot->eip;
-  context_.cs = context_snapshot->cs;
-  context_.eflags = context_snapshot->eflags;
-  context_.esp = context_snapshot->esp;
-  context_.ss = context_snapshot->ss;
+  CPUContextX86::FxsaveToFsave(context_snapshot->fxsave, &context->fsave);
+
+  context->gs = context_snapshot->gs;
+  context->fs = context_snapshot->fs;
+  context->es = context_snapshot->es;
+  context->ds = context_snapshot->ds;
+  context->edi = context_snapshot->edi;
+  context->esi = context_snapshot->esi;
+  context->ebx = context_snapshot->ebx;
+  context->edx = context_snapshot->edx;
+  context->ecx = context_snapshot->ecx;
+  context->eax = context_snapshot->eax;
+  context->ebp = context_snapshot->ebp;
+  context->eip = context_snapshot->eip;
+  context->cs = context_snapshot->cs;
+  context->eflags = context_snapshot->eflags;
+  context->esp = context_snapshot->esp;
+  context->ss = context_snapshot->ss;
 
   // This is effectively a memcpy() of a big structure.
-  context_.fxsave = context_snapshot->fxsave;
+  context->fxsave = context_snapshot->fxsave;
 }
 
-bool MinidumpContextX86Writer::WriteObject(FileWriterInterface* file_writer) {
-  DCHECK_EQ(state(), kStateWritable);
+// static
+void MinidumpContextAMD64WriterTraits::Convert(
+    const CPUContextX86_64* context_snapshot,
+    MinidumpContextAMD64* context) {
+  if (context_snapshot->xstate.enabled_features != 0) {
+    // Extended context.
+    context->context_flags =
+        kMinidumpContextAMD64All | kMinidumpContextAMD64Xstate;
+  } else {
+    // Fixed size context - no xsave components.
+    context->context_flags = kMinidumpContextAMD64All;
+  }
 
-  return file_writer->Write(&context_, sizeof(context_));
+  context->mx_csr = context_snapshot->fxsave.mxcsr;
+  context->cs = context_snapshot->cs;
+  context->fs = context_snapshot->fs;
+  context->gs = context_snapshot->gs;
+  // The top 32 bits of rflags are reserved/unused.
+  context->eflags = static_cast<uint32_t>(context_snapshot->rflags);
+  context->dr0 = context_snapshot->dr0;
+  context->dr1 = context_snapshot->dr1;
+  context->dr2 = context_snapshot->dr2;
+  context->dr3 = context_snapshot->dr3;
+  context->dr6 = context_snapshot->dr6;
+  context->dr7 = context_snapshot->dr7;
+  context->rax = context_snapshot->rax;
+  context->rcx = context_snapshot->rcx;
+  context->rdx = context_snapshot->rdx;
+  context->rbx = context_snapshot->rbx;
+  context->rsp = context_snapshot->rsp;
+  context->rbp = context_snapshot->rbp;
+  context->rsi = context_snapshot->rsi;
+  context->rdi = context_snapshot->rdi;
+  context->r8 = context_snapshot->r8;
+  context->r9 = context_snapshot->r9;
+  context->r10 = context_snapshot->r10;
+  context->r11 = context_snapshot->r11;
+  context->r12 = context_snapshot->r12;
+  context->r13 = context_snapshot->r13;
+  context->r14 = context_snapshot->r14;
+  context->r15 = context_snapshot->r15;
+  context->rip = context_snapshot->rip;
+
+  // This is effectively a memcpy() of a big structure.
+  context->fxsave = context_snapshot->fxsave;
 }
 
-size_t MinidumpContextX86Writer::ContextSize() const {
-  DCHECK_GE(state(), kStateFrozen);
+// static
+void MinidumpContextARMWriterTraits::Convert(
+    const CPUContextARM* context_snapshot,
+    MinidumpContextARM* context) {
+  context->context_flags = kMinidumpContextARMAll;
 
-  return sizeof(context_);
+  static_assert(sizeof(context->regs) == sizeof(context_snapshot->regs),
+                "GPRS size mismatch");
+  memcpy(context->regs, context_snapshot->regs, sizeof(context->regs));
+  context->fp = context_snapshot->fp;
+  context->ip = context_snapshot->ip;
+  context->sp = context_snapshot->sp;
+  context->lr = context_snapshot->lr;
+  context->pc = context_snapshot->pc;
+  context->cpsr = context_snapshot->cpsr;
+
+  context->fpscr = context_snapshot->vfp_regs.fpscr;
+  static_assert(sizeof(context->vfp) == sizeof(context_snapshot->vfp_regs.vfp),
+                "VFP size mismatch");
+  memcpy(context->vfp, context_snapshot->vfp_regs.vfp, sizeof(context->vfp));
+
+  memset(context->extra, 0, sizeof(context->extra));
+}
+
+// static
+void MinidumpContextARM64WriterTraits::Convert(
+    const CPUContextARM64* context_snapshot,
+    MinidumpContextARM64* context) {
+  context->context_flags = kMinidumpContextARM64Full;
+
+  static_assert(
+      sizeof(context->regs) == sizeof(context_snapshot->regs) -
+                                   2 * sizeof(context_snapshot->regs[0]),
+      "GPRs size mismatch");
+  memcpy(context->regs, context_snapshot->regs, sizeof(context->regs));
+  context->fp = context_snapshot->regs[29];
+  context->lr = context_snapshot->regs[30];
+  context->sp = context_snapshot->sp;
+  context->pc = context_snapshot->pc;
+  context->cpsr = context_snapshot->spsr;
+
+  static_assert(sizeof(context->fpsimd) == sizeof(context_snapshot->fpsimd),
+                "FPSIMD size mismatch");
+  memcpy(context->fpsimd, context_snapshot->fpsimd, sizeof(context->fpsimd));
+  context->fpcr = context_snapshot->fpcr;
+  context->fpsr = context_snapshot->fpsr;
+
+  memset(context->bcr, 0, sizeof(context->bcr));
+  memset(context->bvr, 0, sizeof(context->bvr));
+  memset(context->wcr, 0, sizeof(context->wcr));
+  memset(context->wvr, 0, sizeof(context->wvr));
+}
+
+// static
+void MinidumpContextMIPSWriterTraits::Convert(
+    const CPUContextMIPS* context_snapshot,
+    MinidumpContextMIPS* context) {
+  context->context_flags = kMinidumpContextMIPSAll;
+
+  static_assert(sizeof(context->regs) == sizeof(context_snapshot->regs),
+                "GPRs size mismatch");
+  memcpy(context->regs, context_snapshot->regs, sizeof(context->regs));
+  context->mdhi = context_snapshot->mdhi;
+  context->mdlo = context_snapshot->mdlo;
+  context->epc = context_snapshot->cp0_epc;
+  context->badvaddr = context_snapshot->cp0_badvaddr;
+  context->status = context_snapshot->cp0_status;
+  context->cause = context_snapshot->cp0_cause;
+
+  static_assert(sizeof(context->fpregs) == sizeof(context_snapshot->fpregs),
+                "FPRs size mismatch");
+  memcpy(&context->fpregs, &context_snapshot->fpregs, sizeof(context->fpregs));
+  context->fpcsr = context_snapshot->fpcsr;
+  context->fir = context_snapshot->fir;
+
+  for (size_t index = 0; index < 3; ++index) {
+    context->hi[index] = context_snapshot->hi[index];
+    context->lo[index] = context_snapshot->lo[index];
+  }
+  context->dsp_control = context_snapshot->dsp_control;
+}
+
+// static
+void MinidumpContextMIPS64WriterTraits::Convert(
+    const CPUContextMIPS64* context_snapshot,
+    MinidumpContextMIPS64* context) {
+  context->context_flags = kMinidumpContextMIPS64All;
+
+  static_assert(sizeof(context->regs) == sizeof(context_snapshot->regs),
+                "GPRs size mismatch");
+  memcpy(context->regs, context_snapshot->regs, sizeof(context->regs));
+  context->mdhi = context_snapshot->mdhi;
+  context->mdlo = context_snapshot->mdlo;
+  context->epc = context_snapshot->cp0_epc;
+  context->badvaddr = context_snapshot->cp0_badvaddr;
+  context->status = context_snapshot->cp0_status;
+  context->cause = context_snapshot->cp0_cause;
+
+  static_assert(sizeof(context->fpregs) == sizeof(context_snapshot->fpregs),
+                "FPRs size mismatch");
+  memcpy(context->fpregs.dregs,
+         context_snapshot->fpregs.dregs,
+         sizeof(context->fpregs.dregs));
+  context->fpcsr = context_snapshot->fpcsr;
+  context->fir = context_snapshot->fir;
+
+  for (size_t index = 0; index < 3; ++index) {
+    context->hi[index] = context_snapshot->hi[index];
+    context->lo[index] = context_snapshot->lo[index];
+  }
+  context->dsp_control = context_snapshot->dsp_control;
+}
+
+}  // namespace internal
+
+MinidumpContextX86Writer::~MinidumpContextX86Writer() {
 }
 
 static_assert(alignof(MinidumpContextAMD64) >= 16,
@@ -191,9 +366,7 @@ static_assert(alignof(MinidumpContextAMD64Writer) >=
               "MinidumpContextAMD64Writer alignment");
 
 MinidumpContextAMD64Writer::MinidumpContextAMD64Writer()
-    : MinidumpContextWriter(), context_() {
-  context_.context_flags = kMinidumpContextAMD64;
-}
+    : MinidumpFixedContextWriter(), xsave_entries_() {}
 
 MinidumpContextAMD64Writer::~MinidumpContextAMD64Writer() {
 }
@@ -214,50 +387,7 @@ void MinidumpContextAMD64Writer::operator delete(void* pointer) {
 
 void MinidumpContextAMD64Writer::InitializeFromSnapshot(
     const CPUContextX86_64* context_snapshot) {
-  DCHECK_EQ(state(), kStateMutable);
-  DCHECK_EQ(context_.context_flags, kMinidumpContextAMD64);
-
-  if (context_snapshot->xstate.enabled_features != 0) {
-    // Extended context.
-    context_.context_flags =
-        kMinidumpContextAMD64All | kMinidumpContextAMD64Xstate;
-  } else {
-    // Fixed size context - no xsave components.
-    context_.context_flags = kMinidumpContextAMD64All;
-  }
-
-  context_.mx_csr = context_snapshot->fxsave.mxcsr;
-  context_.cs = context_snapshot->cs;
-  context_.fs = context_snapshot->fs;
-  context_.gs = context_snapshot->gs;
-  // The top 32 bits of rflags are reserved/unused.
-  context_.eflags = static_cast<uint32_t>(context_snapshot->rflags);
-  context_.dr0 = context_snapshot->dr0;
-  context_.dr1 = context_snapshot->dr1;
-  context_.dr2 = context_snapshot->dr2;
-  context_.dr3 = context_snapshot->dr3;
-  context_.dr6 = context_snapshot->dr6;
-  context_.dr7 = context_snapshot->dr7;
-  context_.rax = context_snapshot->rax;
-  context_.rcx = context_snapshot->rcx;
-  context_.rdx = context_snapshot->rdx;
-  context_.rbx = context_snapshot->rbx;
-  context_.rsp = context_snapshot->rsp;
-  context_.rbp = context_snapshot->rbp;
-  context_.rsi = context_snapshot->rsi;
-  context_.rdi = context_snapshot->rdi;
-  context_.r8 = context_snapshot->r8;
-  context_.r9 = context_snapshot->r9;
-  context_.r10 = context_snapshot->r10;
-  context_.r11 = context_snapshot->r11;
-  context_.r12 = context_snapshot->r12;
-  context_.r13 = context_snapshot->r13;
-  context_.r14 = context_snapshot->r14;
-  context_.r15 = context_snapshot->r15;
-  context_.rip = context_snapshot->rip;
-
-  // This is effectively a memcpy() of a big structure.
-  context_.fxsave = context_snapshot->fxsave;
+  MinidumpFixedContextWriter::InitializeFromSnapshot(context_snapshot);
 
   // If XSave features are being recorded store in xsave_entries in xcomp_bv
   // order. We will not see features we do not support as we provide flags
@@ -278,63 +408,69 @@ size_t MinidumpContextAMD64Writer::Alignment() {
 
 bool MinidumpContextAMD64Writer::WriteObject(FileWriterInterface* file_writer) {
   DCHECK_EQ(state(), kStateWritable);
+
+  // Without extended state, the CONTEXT is all there is, and it can be written
+  // directly.
+  if (xsave_entries_.empty()) {
+    return MinidumpFixedContextWriter::WriteObject(file_writer);
+  }
+
+  const MinidumpContextAMD64& context = fixed_context();
+
   // Note: all sizes here come from our constants, not from untrustworthy data.
   std::vector<unsigned char> data(ContextSize());
   unsigned char* const buf = data.data();
 
   // CONTEXT always comes first.
-  DCHECK_LE(sizeof(context_), data.size());
-  memcpy(buf, &context_, sizeof(context_));
-
-  if (xsave_entries_.size() > 0) {
-    MinidumpContextExHeader context_ex = {{0, 0}, {0, 0}, {0, 0}};
-    MinidumpXSaveAreaHeader xsave_header = {0, 0, {}};
-
-    // CONTEXT_EX goes directly after the CONTEXT. |offset| is relative to
-    // &CONTEXT_EX.
-    context_ex.all.offset = -static_cast<int32_t>(sizeof(context_));
-    context_ex.all.size = static_cast<uint32_t>(ContextSize());
-    context_ex.legacy.offset = context_ex.all.offset;
-    context_ex.legacy.size = sizeof(context_);
-    // Then... there is a gap.
-    //
-    // In the compacted format the XSave area header goes just before
-    // the first xsave entry.  It has a total size given by the header
-    // + (padded) sizes of all the entries.
-    context_ex.xstate.offset = static_cast<int32_t>(
-        kMinidumpAMD64XSaveOffset - sizeof(MinidumpXSaveAreaHeader) -
-        sizeof(context_));
-    context_ex.xstate.size =
-        static_cast<uint32_t>(sizeof(MinidumpXSaveAreaHeader) + ContextSize() -
-                              kMinidumpAMD64XSaveOffset);
-
-    // Store CONTEXT_EX now it is complete.
-    DCHECK_LE(sizeof(context_) + sizeof(context_ex), data.size());
-    memcpy(&buf[sizeof(context_)], &context_ex, sizeof(context_ex));
-
-    // Calculate flags for xsave header & write entries (they will be
-    // *after* the xsave header).
-    size_t cursor = kMinidumpAMD64XSaveOffset;
-    for (auto const& entry : xsave_entries_) {
-      xsave_header.mask |= 1ull << entry->XCompBVBit();
-      DCHECK_LE(cursor + entry->Size(), data.size());
-      entry->Copy(&buf[cursor]);
-      cursor += entry->Size();
-    }
-
-    xsave_header.compaction_mask =
-        xsave_header.mask | XSTATE_COMPACTION_ENABLE_MASK;
-
-    // Store xsave header at its calculated offset. It is before the entries
-    // above, but we need to add the |mask| bits before writing it.
-    DCHECK_LE(
-        context_ex.xstate.offset + sizeof(context_) + sizeof(xsave_header),
-        data.size());
-    memcpy(&buf[context_ex.xstate.offset + sizeof(context_)],
-           &xsave_header,
-           sizeof(xsave_header));
+  DCHECK_LE(sizeof(context), data.size());
+  memcpy(buf, &context, sizeof(context));
+
+  MinidumpContextExHeader context_ex = {{0, 0}, {0, 0}, {0, 0}};
+  MinidumpXSaveAreaHeader xsave_header = {0, 0, {}};
+
+  // CONTEXT_EX goes directly after the CONTEXT. |offset| is relative to
+  // &CONTEXT_EX.
+  context_ex.all.offset = -static_cast<int32_t>(sizeof(context));
+  context_ex.all.size = static_cast<uint32_t>(ContextSize());
+  context_ex.legacy.offset = context_ex.all.offset;
+  context_ex.legacy.size = sizeof(context);
+  // Then... there is a gap.
+  //
+  // In the compacted format the XSave area header goes just before
+  // the first xsave entry.  It has a total size given by the header
+  // + (padded) sizes of all the entries.
+  context_ex.xstate.offset = static_cast<int32_t>(
+      kMinidumpAMD64XSaveOffset - sizeof(MinidumpXSaveAreaHeader) -
+      sizeof(context));
+  context_ex.xstate.size =
+      static_cast<uint32_t>(sizeof(MinidumpXSaveAreaHeader) + ContextSize() -
+                            kMinidumpAMD64XSaveOffset);
+
+  // Store CONTEXT_EX now it is complete.
+  DCHECK_LE(sizeof(context) + sizeof(context_ex), data.size());
+  memcpy(&buf[sizeof(context)], &context_ex, sizeof(context_ex));
+
+  // Calculate flags for xsave header & write entries (they will be
+  // *after* the xsave header).
+  size_t cursor = kMinidumpAMD64XSaveOffset;
+  for (auto const& entry : xsave_entries_) {
+    xsave_header.mask |= 1ull << entry->XCompBVBit();
+    DCHECK_LE(cursor + entry->Size(), data.size());
+    entry->Copy(&buf[cursor]);
+    cursor += entry->Size();
   }
 
+  xsave_header.compaction_mask =
+      xsave_header.mask | XSTATE_COMPACTION_ENABLE_MASK;
+
+  // Store xsave header at its calculated offset. It is before the entries
+  // above, but we need to add the |mask| bits before writing it.
+  DCHECK_LE(context_ex.xstate.offset + sizeof(context) + sizeof(xsave_header),
+            data.size());
+  memcpy(&buf[context_ex.xstate.offset + sizeof(context)],
+         &xsave_header,
+         sizeof(xsave_header));
+
   if (!file_writer->Write(data.data(), data.size()))
     return false;
 
@@ -344,9 +480,9 @@ bool MinidumpContextAMD64Writer::WriteObject(FileWriterInterface* file_writer) {
 size_t MinidumpContextAMD64Writer::ContextSize() const {
   DCHECK_GE(state(), kStateFrozen);
   if (xsave_entries_.size() == 0) {
-    return sizeof(context_);
+    return MinidumpFixedContextWriter::ContextSize();
   } else {
-    DCHECK_EQ(context_.context_flags,
+    DCHECK_EQ(fixed_context().context_flags,
               kMinidumpContextAMD64All | kMinidumpContextAMD64Xstate);
     DCHECK(xsave_entries_.size() != 0);
     size_t size = kMinidumpAMD64XSaveOffset;
@@ -370,190 +506,12 @@ bool MinidumpXSaveAMD64CetU::Copy(void* dst) const {
   return true;
 }
 
-MinidumpContextARMWriter::MinidumpContextARMWriter()
-    : MinidumpContextWriter(), context_() {
-  context_.context_flags = kMinidumpContextARM;
-}
-
 MinidumpContextARMWriter::~MinidumpContextARMWriter() = default;
 
-void MinidumpContextARMWriter::InitializeFromSnapshot(
-    const CPUContextARM* context_snapshot) {
-  DCHECK_EQ(state(), kStateMutable);
-  DCHECK_EQ(context_.context_flags, kMinidumpContextARM);
-
-  context_.context_flags = kMinidumpContextARMAll;
-
-  static_assert(sizeof(context_.regs) == sizeof(context_snapshot->regs),
-                "GPRS size mismatch");
-  memcpy(context_.regs, context_snapshot->regs, sizeof(context_.regs));
-  context_.fp = context_snapshot->fp;
-  context_.ip = context_snapshot->ip;
-  context_.sp = context_snapshot->sp;
-  context_.lr = context_snapshot->lr;
-  context_.pc = context_snapshot->pc;
-  context_.cpsr = context_snapshot->cpsr;
-
-  context_.fpscr = context_snapshot->vfp_regs.fpscr;
-  static_assert(sizeof(context_.vfp) == sizeof(context_snapshot->vfp_regs.vfp),
-                "VFP size mismatch");
-  memcpy(context_.vfp, context_snapshot->vfp_regs.vfp, sizeof(context_.vfp));
-
-  memset(context_.extra, 0, sizeof(context_.extra));
-}
-
-bool MinidumpContextARMWriter::WriteObject(FileWriterInterface* file_writer) {
-  DCHECK_EQ(state(), kStateWritable);
-  return file_writer->Write(&context_, sizeof(context_));
-}
-
-size_t MinidumpContextARMWriter::ContextSize() const {
-  DCHECK_GE(state(), kStateFrozen);
-  return sizeof(context_);
-}
-
-MinidumpContextARM64Writer::MinidumpContextARM64Writer()
-    : MinidumpContextWriter(), context_() {
-  context_.context_flags = kMinidumpContextARM64;
-}
-
 MinidumpContextARM64Writer::~MinidumpContextARM64Writer() = default;
 
-void MinidumpContextARM64Writer::InitializeFromSnapshot(
-    const CPUContextARM64* context_snapshot) {
-  DCHECK_EQ(state(), kStateMutable);
-  DCHECK_EQ(context_.context_flags, kMinidumpContextARM64);
-
-  context_.context_flags = kMinidumpContextARM64Full;
-
-  static_assert(
-      sizeof(context_.regs) == sizeof(context_snapshot->regs) -
-                                   2 * sizeof(context_snapshot->regs[0]),
-      "GPRs size mismatch");
-  memcpy(context_.regs, context_snapshot->regs, sizeof(context_.regs));
-  context_.fp = context_snapshot->regs[29];
-  context_.lr = context_snapshot->regs[30];
-  context_.sp = context_snapshot->sp;
-  context_.pc = context_snapshot->pc;
-  context_.cpsr = context_snapshot->spsr;
-
-  static_assert(sizeof(context_.fpsimd) == sizeof(context_snapshot->fpsimd),
-                "FPSIMD size mismatch");
-  memcpy(context_.fpsimd, context_snapshot->fpsimd, sizeof(context_.fpsimd));
-  context_.fpcr = context_snapshot->fpcr;
-  context_.fpsr = context_snapshot->fpsr;
-
-  memset(context_.bcr, 0, sizeof(context_.bcr));
-  memset(context_.bvr, 0, sizeof(context_.bvr));
-  memset(context_.wcr, 0, sizeof(context_.wcr));
-  memset(context_.wvr, 0, sizeof(context_.wvr));
-}
-
-bool MinidumpContextARM64Writer::WriteObject(FileWriterInterface* file_writer) {
-  DCHECK_EQ(state(), kStateWritable);
-  return file_writer->Write(&context_, sizeof(context_));
-}
-
-size_t MinidumpContextARM64Writer::ContextSize() const {
-  DCHECK_GE(state(), kStateFrozen);
-  return sizeof(context_);
-}
-
-MinidumpContextMIPSWriter::MinidumpContextMIPSWriter()
-    : MinidumpContextWriter(), context_() {
-  context_.context_flags = kMinidumpContextMIPS;
-}
-
 MinidumpContextMIPSWriter::~MinidumpContextMIPSWriter() = default;
 
-void MinidumpContextMIPSWriter::InitializeFromSnapshot(
-    const CPUContextMIPS* context_snapshot) {
-  DCHECK_EQ(state(), kStateMutable);
-  DCHECK_EQ(context_.context_flags, kMinidumpContextMIPS);
-
-  context_.context_flags = kMinidumpContextMIPSAll;
-
-  static_assert(sizeof(context_.regs) == sizeof(context_snapshot->regs),
-                "GPRs size mismatch");
-  memcpy(context_.regs, context_snapshot->regs, sizeof(context_.regs));
-  context_.mdhi = context_snapshot->mdhi;
-  context_.mdlo = context_snapshot->mdlo;
-  context_.epc = context_snapshot->cp0_epc;
-  context_.badvaddr = context_snapshot->cp0_badvaddr;
-  context_.status = context_snapshot->cp0_status;
-  context_.cause = context_snapshot->cp0_cause;
-
-  static_assert(sizeof(context_.fpregs) == sizeof(context_snapshot->fpregs),
-                "FPRs size mismatch");
-  memcpy(&context_.fpregs, &context_snapshot->fpregs, sizeof(context_.fpregs));
-  context_.fpcsr = context_snapshot->fpcsr;
-  context_.fir = context_snapshot->fir;
-
-  for (size_t index = 0; index < 3; ++index) {
-    context_.hi[index] = context_snapshot->hi[index];
-    context_.lo[index] = context_snapshot->lo[index];
-  }
-  context_.dsp_control = context_snapshot->dsp_control;
-}
-
-bool MinidumpContextMIPSWriter::WriteObject(FileWriterInterface* file_writer) {
-  DCHECK_EQ(state(), kStateWritable);
-  return file_writer->Write(&context_, sizeof(context_));
-}
-
-size_t MinidumpContextMIPSWriter::ContextSize() const {
-  DCHECK_GE(state(), kStateFrozen);
-  return sizeof(context_);
-}
-
-MinidumpContextMIPS64Writer::MinidumpContextMIPS64Writer()
-    : MinidumpContextWriter(), context_() {
-  context_.context_flags = kMinidumpContextMIPS64;
-}
-
 MinidumpContextMIPS64Writer::~MinidumpContextMIPS64Writer() = default;
 
-void MinidumpContextMIPS64Writer::InitializeFromSnapshot(
-    const CPUContextMIPS64* context_snapshot) {
-  DCHECK_EQ(state(), kStateMutable);
-  DCHECK_EQ(context_.context_flags, kMinidumpContextMIPS64);
-
-  context_.context_flags = kMinidumpContextMIPS64All;
-
-  static_assert(sizeof(context_.regs) == sizeof(context_snapshot->regs),
-                "GPRs size mismatch");
-  memcpy(context_.regs, context_snapshot->regs, sizeof(context_.regs));
-  context_.mdhi = context_snapshot->mdhi;
-  context_.mdlo = context_snapshot->mdlo;
-  context_.epc = context_snapshot->cp0_epc;
-  context_.badvaddr = context_snapshot->cp0_badvaddr;
-  context_.status = context_snapshot->cp0_status;
-  context_.cause = context_snapshot->cp0_cause;
-
-  static_assert(sizeof(context_.fpregs) == sizeof(context_snapshot->fpregs),
-                "FPRs size mismatch");
-  memcpy(context_.fpregs.dregs,
-         context_snapshot->fpregs.dregs,
-         sizeof(context_.fpregs.dregs));
-  context_.fpcsr = context_snapshot->fpcsr;
-  context_.fir = context_snapshot->fir;
-
-  for (size_t index = 0; index < 3; ++index) {
-    context_.hi[index] = context_snapshot->hi[index];
-    context_.lo[index] = context_snapshot->lo[index];
-  }
-  context_.dsp_control = context_snapshot->dsp_control;
-}
-
-bool MinidumpContextMIPS64Writer::WriteObject(
-    FileWriterInterface* file_writer) {
-  DCHECK_EQ(state(), kStateWritable);
-  return file_writer->Write(&context_, sizeof(context_));
-}
-
-size_t MinidumpContextMIPS64Writer::ContextSize() const {
-  DCHECK_GE(state(), kStateFrozen);
-  return sizeof(context_);
-}
-
 }  // namespace crashpad
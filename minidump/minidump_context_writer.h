@@ -15,9 +15,11 @@
 #ifndef CRASHPAD_MINIDUMP_MINIDUMP_CONTEXT_WRITER_H_
 #define CRASHPAD_MINIDUMP_MINIDUMP_CONTEXT_WRITER_H_
 
+#include <stdint.h>
 #include <sys/types.h>
 
 #include <memory>
+#include <vector>
 
 #include "minidump/minidump_context.h"
 #include "minidump/minidump_writable.h"
@@ -25,6 +27,10 @@
 namespace crashpad {
 
 struct CPUContext;
+struct CPUContextARM;
+struct CPUContextARM64;
+struct CPUContextMIPS;
+struct CPUContextMIPS64;
 struct CPUContextX86;
 struct CPUContextX86_64;
 class MinidumpMiscInfoWriter;
@@ -70,24 +76,92 @@ class MinidumpContextWriter : public internal::MinidumpWritable {
   size_t SizeOfObject() final;
 };
 
-//! \brief The writer for a MinidumpContextX86 structure in a minidump file.
-class MinidumpContextX86Writer final : public MinidumpContextWriter {
+namespace internal {
+
+//! \cond
+
+struct MinidumpContextX86WriterTraits {
+  using ContextType = MinidumpContextX86;
+  using SnapshotType = CPUContextX86;
+  static constexpr uint32_t kContextFlags = kMinidumpContextX86;
+  static void Convert(const SnapshotType* context_snapshot,
+                      ContextType* context);
+};
+
+struct MinidumpContextAMD64WriterTraits {
+  using ContextType = MinidumpContextAMD64;
+  using SnapshotType = CPUContextX86_64;
+  static constexpr uint32_t kContextFlags = kMinidumpContextAMD64;
+  static void Convert(const SnapshotType* context_snapshot,
+                      ContextType* context);
+};
+
+struct MinidumpContextARMWriterTraits {
+  using ContextType = MinidumpContextARM;
+  using SnapshotType = CPUContextARM;
+  static constexpr uint32_t kContextFlags = kMinidumpContextARM;
+  static void Convert(const SnapshotType* context_snapshot,
+                      ContextType* context);
+};
+
+struct MinidumpContextARM64WriterTraits {
+  using ContextType = MinidumpContextARM64;
+  using SnapshotType = CPUContextARM64;
+  static constexpr uint32_t kContextFlags = kMinidumpContextARM64;
+  static void Convert(const SnapshotType* context_snapshot,
+                      ContextType* context);
+};
+
+struct MinidumpContextMIPSWriterTraits {
+  using ContextType = MinidumpContextMIPS;
+  using SnapshotType = CPUContextMIPS;
+  static constexpr uint32_t kContextFlags = kMinidumpContextMIPS;
+  static void Convert(const SnapshotType* context_snapshot,
+                      ContextType* context);
+};
+
+struct MinidumpContextMIPS64WriterTraits {
+  using ContextType = MinidumpContextMIPS64;
+  using SnapshotType = CPUContextMIPS64;
+  static constexpr uint32_t kContextFlags = kMinidumpContextMIPS64;
+  static void Convert(const SnapshotType* context_snapshot,
+                      ContextType* context);
+};
+
+//! \endcond
+
+//! \brief Writes a fixed-layout CPU context structure to a minidump file in
+//!     accordance with the architecture’s characteristics.
+//!
+//! \a Traits supplies the minidump context structure (`ContextType`), the
+//! snapshot context it is converted from (`SnapshotType`), the architecture
+//! flag that identifies it (`kContextFlags`), and the conversion itself
+//! (`Convert()`). Everything else is shared, so the structure is written with
+//! a single write of its in-memory representation.
+//!
+//! MinidumpFixedContextWriter objects should not be instantiated directly. To
+//! write CPU contexts to minidump files, use MinidumpContextWriter subclasses
+//! such as MinidumpContextX86Writer and MinidumpContextAMD64Writer instead.
+template <typename Traits>
+class MinidumpFixedContextWriter : public MinidumpContextWriter {
  public:
-  MinidumpContextX86Writer();
+  using ContextType = typename Traits::ContextType;
+  using SnapshotType = typename Traits::SnapshotType;
 
-  MinidumpContextX86Writer(const MinidumpContextX86Writer&) = delete;
-  MinidumpContextX86Writer& operator=(const MinidumpContextX86Writer&) = delete;
+  MinidumpFixedContextWriter(const MinidumpFixedContextWriter&) = delete;
+  MinidumpFixedContextWriter& operator=(const MinidumpFixedContextWriter&) =
+      delete;
 
-  ~MinidumpContextX86Writer() override;
+  ~MinidumpFixedContextWriter() override;
 
-  //! \brief Initializes the MinidumpContextX86 based on \a context_snapshot.
+  //! \brief Initializes the context structure based on \a context_snapshot.
   //!
   //! \param[in] context_snapshot The context snapshot to use as source data.
   //!
   //! \note Valid in #kStateMutable. No mutation of context() may be done before
   //!     calling this method, and it is not normally necessary to alter
   //!     context() after calling this method.
-  void InitializeFromSnapshot(const CPUContextX86* context_snapshot);
+  void InitializeFromSnapshot(const SnapshotType* context_snapshot);
 
   //! \brief Returns a pointer to the context structure that this object will
   //!     write.
@@ -99,9 +173,14 @@ class MinidumpContextX86Writer final : public MinidumpContextWriter {
   //!     to populate the context structure correctly. The context structure
   //!     must only be modified while this object is in the #kStateMutable
   //!     state.
-  MinidumpContextX86* context() { return &context_; }
+  ContextType* context() { return &context_; }
 
  protected:
+  MinidumpFixedContextWriter();
+
+  //! \brief Returns the context structure that this object will write.
+  const ContextType& fixed_context() const { return context_; }
+
   // MinidumpWritable:
   bool WriteObject(FileWriterInterface* file_writer) override;
 
@@ -109,7 +188,22 @@ class MinidumpContextX86Writer final : public MinidumpContextWriter {
   size_t ContextSize() const override;
 
  private:
-  MinidumpContextX86 context_;
+  ContextType context_;
+};
+
+}  // namespace internal
+
+//! \brief The writer for a MinidumpContextX86 structure in a minidump file.
+class MinidumpContextX86Writer final
+    : public internal::MinidumpFixedContextWriter<
+          internal::MinidumpContextX86WriterTraits> {
+ public:
+  MinidumpContextX86Writer() : MinidumpFixedContextWriter() {}
+
+  MinidumpContextX86Writer(const MinidumpContextX86Writer&) = delete;
+  MinidumpContextX86Writer& operator=(const MinidumpContextX86Writer&) = delete;
+
+  ~MinidumpContextX86Writer() override;
 };
 
 //! \brief Wraps an xsave feature that knows where and how big it is.
@@ -143,7 +237,12 @@ class MinidumpXSaveAMD64CetU final : public MinidumpXSaveFeatureAMD64 {
 };
 
 //! \brief The writer for a MinidumpContextAMD64 structure in a minidump file.
-class MinidumpContextAMD64Writer final : public MinidumpContextWriter {
+//!
+//! In addition to the fixed-layout context structure, this writes any
+//! supported extended (xsave) state following a `CONTEXT_EX` header.
+class MinidumpContextAMD64Writer final
+    : public internal::MinidumpFixedContextWriter<
+          internal::MinidumpContextAMD64WriterTraits> {
  public:
   MinidumpContextAMD64Writer();
 
@@ -163,7 +262,8 @@ class MinidumpContextAMD64Writer final : public MinidumpContextWriter {
   static void* operator new[](size_t size) = delete;
   static void operator delete[](void* ptr) = delete;
 
-  //! \brief Initializes the MinidumpContextAMD64 based on \a context_snapshot.
+  //! \brief Initializes the MinidumpContextAMD64 and any extended state based
+  //!     on \a context_snapshot.
   //!
   //! \param[in] context_snapshot The context snapshot to use as source data.
   //!
@@ -172,18 +272,6 @@ class MinidumpContextAMD64Writer final : public MinidumpContextWriter {
   //!     context() after calling this method.
   void InitializeFromSnapshot(const CPUContextX86_64* context_snapshot);
 
-  //! \brief Returns a pointer to the context structure that this object will
-  //!     write.
-  //!
-  //! \attention This returns a non-`const` pointer to this object’s private
-  //!     data so that a caller can populate the context structure directly.
-  //!     This is done because providing setter interfaces to each field in the
-  //!     context structure would be unwieldy and cumbersome. Care must be taken
-  //!     to populate the context structure correctly. The context structure
-  //!     must only be modified while this object is in the #kStateMutable
-  //!     state.
-  MinidumpContextAMD64* context() { return &context_; }
-
  protected:
   // MinidumpWritable:
   size_t Alignment() override;
@@ -193,180 +281,63 @@ class MinidumpContextAMD64Writer final : public MinidumpContextWriter {
   size_t ContextSize() const override;
 
  private:
-  MinidumpContextAMD64 context_;
   // These should be in order of XCompBVBit().
   std::vector<std::unique_ptr<MinidumpXSaveFeatureAMD64>> xsave_entries_;
 };
 
 //! \brief The writer for a MinidumpContextARM structure in a minidump file.
-class MinidumpContextARMWriter final : public MinidumpContextWriter {
+class MinidumpContextARMWriter final
+    : public internal::MinidumpFixedContextWriter<
+          internal::MinidumpContextARMWriterTraits> {
  public:
-  MinidumpContextARMWriter();
+  MinidumpContextARMWriter() : MinidumpFixedContextWriter() {}
 
   MinidumpContextARMWriter(const MinidumpContextARMWriter&) = delete;
   MinidumpContextARMWriter& operator=(const MinidumpContextARMWriter&) = delete;
 
   ~MinidumpContextARMWriter() override;
-
-  //! \brief Initializes the MinidumpContextARM based on \a context_snapshot.
-  //!
-  //! \param[in] context_snapshot The context snapshot to use as source data.
-  //!
-  //! \note Valid in #kStateMutable. No mutation of context() may be done before
-  //!     calling this method, and it is not normally necessary to alter
-  //!     context() after calling this method.
-  void InitializeFromSnapshot(const CPUContextARM* context_snapshot);
-
-  //! \brief Returns a pointer to the context structure that this object will
-  //!     write.
-  //!
-  //! \attention This returns a non-`const` pointer to this object’s private
-  //!     data so that a caller can populate the context structure directly.
-  //!     This is done because providing setter interfaces to each field in the
-  //!     context structure would be unwieldy and cumbersome. Care must be taken
-  //!     to populate the context structure correctly. The context structure
-  //!     must only be modified while this object is in the #kStateMutable
-  //!     state.
-  MinidumpContextARM* context() { return &context_; }
-
- protected:
-  // MinidumpWritable:
-  bool WriteObject(FileWriterInterface* file_writer) override;
-
-  // MinidumpContextWriter:
-  size_t ContextSize() const override;
-
- private:
-  MinidumpContextARM context_;
 };
 
 //! \brief The writer for a MinidumpContextARM64 structure in a minidump file.
-class MinidumpContextARM64Writer final : public MinidumpContextWriter {
+class MinidumpContextARM64Writer final
+    : public internal::MinidumpFixedContextWriter<
+          internal::MinidumpContextARM64WriterTraits> {
  public:
-  MinidumpContextARM64Writer();
+  MinidumpContextARM64Writer() : MinidumpFixedContextWriter() {}
 
   MinidumpContextARM64Writer(const MinidumpContextARM64Writer&) = delete;
   MinidumpContextARM64Writer& operator=(const MinidumpContextARM64Writer&) =
       delete;
 
   ~MinidumpContextARM64Writer() override;
-
-  //! \brief Initializes the MinidumpContextARM64 based on \a context_snapshot.
-  //!
-  //! \param[in] context_snapshot The context snapshot to use as source data.
-  //!
-  //! \note Valid in #kStateMutable. No mutation of context() may be done before
-  //!     calling this method, and it is not normally necessary to alter
-  //!     context() after calling this method.
-  void InitializeFromSnapshot(const CPUContextARM64* context_snapshot);
-
-  //! \brief Returns a pointer to the context structure that this object will
-  //!     write.
-  //!
-  //! \attention This returns a non-`const` pointer to this object’s private
-  //!     data so that a caller can populate the context structure directly.
-  //!     This is done because providing setter interfaces to each field in the
-  //!     context structure would be unwieldy and cumbersome. Care must be taken
-  //!     to populate the context structure correctly. The context structure
-  //!     must only be modified while this object is in the #kStateMutable
-  //!     state.
-  MinidumpContextARM64* context() { return &context_; }
-
- protected:
-  // MinidumpWritable:
-  bool WriteObject(FileWriterInterface* file_writer) override;
-
-  // MinidumpContextWriter:
-  size_t ContextSize() const override;
-
- private:
-  MinidumpContextARM64 context_;
 };
 
 //! \brief The writer for a MinidumpContextMIPS structure in a minidump file.
-class MinidumpContextMIPSWriter final : public MinidumpContextWriter {
+class MinidumpContextMIPSWriter final
+    : public internal::MinidumpFixedContextWriter<
+          internal::MinidumpContextMIPSWriterTraits> {
  public:
-  MinidumpContextMIPSWriter();
+  MinidumpContextMIPSWriter() : MinidumpFixedContextWriter() {}
 
   MinidumpContextMIPSWriter(const MinidumpContextMIPSWriter&) = delete;
   MinidumpContextMIPSWriter& operator=(const MinidumpContextMIPSWriter&) =
       delete;
 
   ~MinidumpContextMIPSWriter() override;
-
-  //! \brief Initializes the MinidumpContextMIPS based on \a context_snapshot.
-  //!
-  //! \param[in] context_snapshot The context snapshot to use as source data.
-  //!
-  //! \note Valid in #kStateMutable. No mutation of context() may be done before
-  //!     calling this method, and it is not normally necessary to alter
-  //!     context() after calling this method.
-  void InitializeFromSnapshot(const CPUContextMIPS* context_snapshot);
-
-  //! \brief Returns a pointer to the context structure that this object will
-  //!     write.
-  //!
-  //! \attention This returns a non-`const` pointer to this object’s private
-  //!     data so that a caller can populate the context structure directly.
-  //!     This is done because providing setter interfaces to each field in the
-  //!     context structure would be unwieldy and cumbersome. Care must be taken
-  //!     to populate the context structure correctly. The context structure
-  //!     must only be modified while this object is in the #kStateMutable
-  //!     state.
-  MinidumpContextMIPS* context() { return &context_; }
-
- protected:
-  // MinidumpWritable:
-  bool WriteObject(FileWriterInterface* file_writer) override;
-
-  // MinidumpContextWriter:
-  size_t ContextSize() const override;
-
- private:
-  MinidumpContextMIPS context_;
 };
 
 //! \brief The writer for a MinidumpContextMIPS64 structure in a minidump file.
-class MinidumpContextMIPS64Writer final : public MinidumpContextWriter {
+class MinidumpContextMIPS64Writer final
+    : public internal::MinidumpFixedContextWriter<
+          internal::MinidumpContextMIPS64WriterTraits> {
  public:
-  MinidumpContextMIPS64Writer();
+  MinidumpContextMIPS64Writer() : MinidumpFixedContextWriter() {}
 
   MinidumpContextMIPS64Writer(const MinidumpContextMIPS64Writer&) = delete;
   MinidumpContextMIPS64Writer& operator=(const MinidumpContextMIPS64Writer&) =
       delete;
 
   ~MinidumpContextMIPS64Writer() override;
-
-  //! \brief Initializes the MinidumpContextMIPS based on \a context_snapshot.
-  //!
-  //! \param[in] context_snapshot The context snapshot to use as source data.
-  //!
-  //! \note Valid in #kStateMutable. No mutation of context() may be done before
-  //!     calling this method, and it is not normally necessary to alter
-  //!     context() after calling this method.
-  void InitializeFromSnapshot(const CPUContextMIPS64* context_snapshot);
-
-  //! \brief Returns a pointer to the context structure that this object will
-  //!     write.
-  //!
-  //! \attention This returns a non-`const` pointer to this object’s private
-  //!     data so that a caller can populate the context structure directly.
-  //!     This is done because providing setter interfaces to each field in the
-  //!     context structure would be unwieldy and cumbersome. Care must be taken
-  //!     to populate the context structure correctly. The context structure
-  //!     must only be modified while this object is in the #kStateMutable
-  //!     state.
-  MinidumpContextMIPS64* context() { return &context_; }
-
- protected:
-  // MinidumpWritable:
-  bool WriteObject(FileWriterInterface* file_writer) override;
-
-  // MinidumpContextWriter:
-  size_t ContextSize() const override;
-
- private:
-  MinidumpContextMIPS64 context_;
 };
 
 }  // namespace crashpad
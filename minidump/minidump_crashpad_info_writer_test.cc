@@ -209,7 +209,8 @@ TEST(MinidumpCrashpadInfoWriter, CrashpadModuleList) {
           string_file.string(), module_list->modules[0].location);
   ASSERT_TRUE(module);
 
-  EXPECT_EQ(module->version, MinidumpModuleCrashpadInfo::kVersion);
+  EXPECT_EQ(module->version,
+            MinidumpModuleCrashpadInfo::kVersionWithoutAnnotationObjectThreads);
   EXPECT_EQ(module->list_annotations.DataSize, 0u);
   EXPECT_EQ(module->list_annotations.Rva, 0u);
   EXPECT_EQ(module->simple_annotations.DataSize, 0u);
@@ -294,7 +295,8 @@ TEST(MinidumpCrashpadInfoWriter, InitializeFromSnapshot) {
           string_file.string(), module_list->modules[0].location);
   ASSERT_TRUE(module);
 
-  EXPECT_EQ(module->version, MinidumpModuleCrashpadInfo::kVersion);
+  EXPECT_EQ(module->version,
+            MinidumpModuleCrashpadInfo::kVersionWithoutAnnotationObjectThreads);
 
   const MinidumpRVAList* list_annotations =
       MinidumpWritableAtLocationDescriptor<MinidumpRVAList>(
@@ -17,6 +17,8 @@
 namespace crashpad {
 
 constexpr uint32_t MinidumpModuleCrashpadInfo::kVersion;
+constexpr uint32_t
+    MinidumpModuleCrashpadInfo::kVersionWithoutAnnotationObjectThreads;
 constexpr uint32_t MinidumpCrashpadInfo::kVersion;
 
 }  // namespace crashpad
@@ -72,6 +72,11 @@ enum MinidumpStreamType : uint32_t {
   //! \sa SystemInfoStream
   kMinidumpStreamTypeSystemInfo = SystemInfoStream,
 
+  //! \brief The stream type for MINIDUMP_MEMORY64_LIST.
+  //!
+  //! \sa Memory64ListStream
+  kMinidumpStreamTypeMemory64List = Memory64ListStream,
+
   //! \brief The stream type for MINIDUMP_HANDLE_DATA_STREAM.
   //!
   //! \sa HandleDataStream
@@ -108,6 +113,29 @@ enum MinidumpStreamType : uint32_t {
   //! \brief The stream type for MinidumpCrashpadInfo.
   kMinidumpStreamTypeCrashpadInfo = 0x43500001,
 
+  //! \brief The stream type for MinidumpStackTruncationList.
+  kMinidumpStreamTypeCrashpadStackTruncation = 0x43500002,
+
+  //! \brief The stream type for log messages produced while a minidump was
+  //!     written.
+  //!
+  //! The stream’s data is UTF-8 text, with each message ending in a newline.
+  //!
+  //! \sa MinidumpLogMessagesStreamDataSource
+  kMinidumpStreamTypeCrashpadLogMessages = 0x43500003,
+
+  //! \brief The stream type for MinidumpStackSampleList.
+  kMinidumpStreamTypeCrashpadStackSamples = 0x43500004,
+
+  //! \brief The stream type for MinidumpUnwoundStackList.
+  kMinidumpStreamTypeCrashpadUnwoundStacks = 0x43500005,
+
+  //! \brief The stream type for MinidumpIdenticalThreadList.
+  kMinidumpStreamTypeCrashpadIdenticalThreads = 0x43500006,
+
+  //! \brief The stream type for MinidumpChecksum.
+  kMinidumpStreamTypeCrashpadChecksum = 0x43500007,
+
   //! \brief The last reserved crashpad stream.
   kMinidumpStreamTypeCrashpadLastReservedStream = 0x4350ffff,
 };
@@ -324,6 +352,21 @@ struct ALIGNAS(4) PACKED MinidumpAnnotationList {
   MinidumpAnnotation objects[0];
 };
 
+//! \brief The threads that own annotation objects in a MinidumpAnnotationList.
+struct ALIGNAS(4) PACKED MinidumpAnnotationThreadList {
+  //! \brief The number of thread IDs present, equal to the number of annotation
+  //!     objects in the corresponding MinidumpAnnotationList.
+  uint32_t count;
+
+  //! \brief For each annotation object at the same index in the corresponding
+  //!     MinidumpAnnotationList, the ID of the thread whose per-thread list
+  //!     held it, or `0` if it was not held by a per-thread list.
+  //!
+  //! Thread IDs are as reported by ThreadSnapshot::ThreadID(), and correspond
+  //! to MINIDUMP_THREAD::ThreadId unless they had to be remapped to fit.
+  uint64_t thread_ids[0];
+};
+
 //! \brief Additional Crashpad-specific information about a module carried
 //!     within a minidump file.
 //!
@@ -343,7 +386,12 @@ struct ALIGNAS(4) PACKED MinidumpModuleCrashpadInfo {
   //! \brief The structure’s currently-defined version number.
   //!
   //! \sa version
-  static constexpr uint32_t kVersion = 1;
+  static constexpr uint32_t kVersion = 2;
+
+  //! \brief The version number written when #annotation_object_threads is not
+  //!     needed, so that readers that only accept this version can still read
+  //!     the structure.
+  static constexpr uint32_t kVersionWithoutAnnotationObjectThreads = 1;
 
   //! \brief The structure’s version number.
   //!
@@ -384,6 +432,13 @@ struct ALIGNAS(4) PACKED MinidumpModuleCrashpadInfo {
   //!
   //! This field may be present when #version is at least `1`.
   MINIDUMP_LOCATION_DESCRIPTOR annotation_objects;
+
+  //! \brief A MinidumpAnnotationThreadList object identifying the threads that
+  //!     own the annotation objects in #annotation_objects.
+  //!
+  //! This field is present when any annotation object was held by a
+  //! per-thread list, and may be present when #version is at least `2`.
+  MINIDUMP_LOCATION_DESCRIPTOR annotation_object_threads;
 };
 
 //! \brief A link between a MINIDUMP_MODULE structure and additional
@@ -501,6 +556,209 @@ struct ALIGNAS(4) PACKED MinidumpCrashpadInfo {
   MINIDUMP_LOCATION_DESCRIPTOR module_list;
 };
 
+//! \brief Describes a thread whose stack was only partially captured.
+//!
+//! The captured part of the stack is the one described by
+//! MINIDUMP_THREAD::Stack for the thread, and begins at the same address as the
+//! thread’s whole stack region.
+struct ALIGNAS(4) PACKED MinidumpStackTruncation {
+  //! \brief The thread’s ID, matching MINIDUMP_THREAD::ThreadId.
+  uint32_t ThreadId;
+
+  //! \brief The base address of the thread’s stack region.
+  uint64_t StartOfStack;
+
+  //! \brief The number of bytes of the stack region, starting at
+  //!     #StartOfStack, that were captured.
+  uint64_t CapturedSize;
+
+  //! \brief The size of the thread’s whole stack region.
+  uint64_t StackSize;
+};
+
+//! \brief A list of threads whose stacks were only partially captured.
+//!
+//! Threads whose stacks were captured in full don’t appear in this list. Parts
+//! of the stack beyond MinidumpStackTruncation::CapturedSize, such as frame
+//! records found by following the frame pointer chain, may still appear in the
+//! minidump’s memory list.
+struct ALIGNAS(4) PACKED MinidumpStackTruncationList {
+  //! \brief The size of this structure, not including #Entries.
+  uint32_t SizeOfHeader;
+
+  //! \brief The size of each element of #Entries.
+  uint32_t SizeOfEntry;
+
+  //! \brief The number of elements of #Entries.
+  uint32_t NumberOfEntries;
+
+  //! \brief The threads whose stacks were only partially captured.
+  MinidumpStackTruncation Entries[0];
+};
+
+//! \brief The registers and top of the stack of a thread, sampled some time
+//!     before a minidump was written.
+struct ALIGNAS(4) PACKED MinidumpStackSample {
+  //! \brief The thread’s ID.
+  uint32_t ThreadId;
+
+  //! \brief The number of nanoseconds before the minidump was written at which
+  //!     the sample was taken.
+  uint64_t Age;
+
+  //! \brief The thread’s instruction pointer.
+  uint64_t InstructionPointer;
+
+  //! \brief The thread’s stack pointer.
+  uint64_t StackPointer;
+
+  //! \brief The thread’s frame pointer.
+  uint64_t FramePointer;
+
+  //! \brief The offset from the start of the stream of the captured stack,
+  //!     which begins at #StackPointer.
+  uint32_t StackOffset;
+
+  //! \brief The number of bytes of stack captured at #StackOffset.
+  uint32_t StackSize;
+};
+
+//! \brief Samples of a process’ threads taken periodically before a minidump
+//!     was written, oldest first.
+//!
+//! The captured stacks follow #Entries in the stream.
+struct ALIGNAS(4) PACKED MinidumpStackSampleList {
+  //! \brief The size of this structure, not including #Entries.
+  uint32_t SizeOfHeader;
+
+  //! \brief The size of each element of #Entries.
+  uint32_t SizeOfEntry;
+
+  //! \brief The number of elements of #Entries.
+  uint32_t NumberOfEntries;
+
+  //! \brief The samples.
+  MinidumpStackSample Entries[0];
+};
+
+//! \brief A frame found by unwinding a thread’s stack, located within the
+//!     minidump’s modules.
+struct ALIGNAS(4) PACKED MinidumpUnwoundFrame {
+  //! \brief The index in the minidump’s module list of the module containing
+  //!     the frame’s instruction pointer, or `0xffffffff` if no module
+  //!     contains it.
+  uint32_t ModuleIndex;
+
+  //! \brief The frame’s instruction pointer, as an offset from the base
+  //!     address of the module at #ModuleIndex, or as an absolute address if
+  //!     no module contains it.
+  //!
+  //! In frames other than a thread’s innermost one, this is normally a return
+  //! address.
+  uint64_t Offset;
+};
+
+//! \brief The frames found by unwinding a thread’s stack.
+struct ALIGNAS(4) PACKED MinidumpUnwoundStack {
+  //! \brief The thread’s ID, matching MINIDUMP_THREAD::ThreadId.
+  uint32_t ThreadId;
+
+  //! \brief The index of the thread’s innermost frame among the
+  //!     MinidumpUnwoundFrame structures that follow the
+  //!     MinidumpUnwoundStackList.
+  uint32_t FirstFrame;
+
+  //! \brief The number of the thread’s frames, innermost first.
+  uint32_t FrameCount;
+};
+
+//! \brief The stacks of a process’ threads, unwound when the minidump was
+//!     written.
+//!
+//! Threads whose stacks weren’t unwound don’t appear in this list. The
+//! MinidumpUnwoundFrame structures for all of the threads follow #Entries in
+//! the stream.
+struct ALIGNAS(4) PACKED MinidumpUnwoundStackList {
+  //! \brief The size of this structure, not including #Entries.
+  uint32_t SizeOfHeader;
+
+  //! \brief The size of each element of #Entries.
+  uint32_t SizeOfEntry;
+
+  //! \brief The number of elements of #Entries.
+  uint32_t NumberOfEntries;
+
+  //! \brief The size of each MinidumpUnwoundFrame following #Entries.
+  uint32_t SizeOfFrame;
+
+  //! \brief The number of MinidumpUnwoundFrame structures following #Entries.
+  uint32_t NumberOfFrames;
+
+  //! \brief The threads whose stacks were unwound.
+  MinidumpUnwoundStack Entries[0];
+};
+
+//! \brief A thread written without its stack because its stack was identical
+//!     to that of another thread.
+//!
+//! The thread’s MINIDUMP_THREAD::Context is written as usual, but its
+//! MINIDUMP_THREAD::Stack is empty. The stack of the thread named by
+//! #RepresentativeThreadId can be used in its place.
+struct ALIGNAS(4) PACKED MinidumpIdenticalThread {
+  //! \brief The thread’s ID, matching MINIDUMP_THREAD::ThreadId.
+  uint32_t ThreadId;
+
+  //! \brief The ID of the thread whose stack was written, matching
+  //!     MINIDUMP_THREAD::ThreadId.
+  uint32_t RepresentativeThreadId;
+};
+
+//! \brief A list of threads whose stacks were left out because they were
+//!     identical to the stack of another thread.
+//!
+//! Threads are considered identical when they have the same instruction
+//! pointer and their captured stacks have the same contents, with values that
+//! point into each thread’s own stack compared as offsets from the start of the
+//! stack. This is typical of idle threads in a thread pool, all waiting in the
+//! same place.
+struct ALIGNAS(4) PACKED MinidumpIdenticalThreadList {
+  //! \brief The size of this structure, not including #Entries.
+  uint32_t SizeOfHeader;
+
+  //! \brief The size of each element of #Entries.
+  uint32_t SizeOfEntry;
+
+  //! \brief The number of elements of #Entries.
+  uint32_t NumberOfEntries;
+
+  //! \brief The threads whose stacks were left out.
+  MinidumpIdenticalThread Entries[0];
+};
+
+//! \brief A checksum of a minidump’s contents, used to detect minidumps that
+//!     were corrupted or truncated after they were written.
+//!
+//! This is the data of the last stream in the minidump’s directory, and is
+//! written after everything else in the minidump. #Crc32 covers everything
+//! between the end of the MINIDUMP_HEADER and the start of this structure,
+//! which includes the stream directory.
+struct ALIGNAS(4) PACKED MinidumpChecksum {
+  //! \brief The structure’s currently-defined version number.
+  //!
+  //! \sa Version
+  static constexpr uint32_t kVersion = 1;
+
+  //! \brief The structure’s version number.
+  //!
+  //! A value of `0` means that the checksum couldn’t be computed, and #Crc32
+  //! should be ignored.
+  uint32_t Version;
+
+  //! \brief The CRC-32 of the minidump’s contents, as computed by zlib’s
+  //!     `crc32()`.
+  uint32_t Crc32;
+};
+
 #if defined(COMPILER_MSVC)
 #pragma pack(pop)
 #pragma warning(pop)  // C4200
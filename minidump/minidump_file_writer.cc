@@ -14,21 +14,30 @@
 
 #include "minidump/minidump_file_writer.h"
 
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <memory>
 #include <utility>
+#include <vector>
 
 #include "base/logging.h"
 #include "minidump/minidump_crashpad_info_writer.h"
 #include "minidump/minidump_exception_writer.h"
 #include "minidump/minidump_handle_writer.h"
+#include "minidump/minidump_identical_thread_writer.h"
+#include "minidump/minidump_memory64_list_writer.h"
 #include "minidump/minidump_memory_info_writer.h"
 #include "minidump/minidump_memory_writer.h"
 #include "minidump/minidump_misc_info_writer.h"
 #include "minidump/minidump_module_writer.h"
+#include "minidump/minidump_stack_truncation_writer.h"
 #include "minidump/minidump_system_info_writer.h"
 #include "minidump/minidump_thread_id_map.h"
 #include "minidump/minidump_thread_name_list_writer.h"
 #include "minidump/minidump_thread_writer.h"
 #include "minidump/minidump_unloaded_module_writer.h"
+#include "minidump/minidump_unwound_stack_writer.h"
 #include "minidump/minidump_user_extension_stream_data_source.h"
 #include "minidump/minidump_user_stream_writer.h"
 #include "minidump/minidump_writer_util.h"
@@ -36,13 +45,171 @@
 #include "snapshot/module_snapshot.h"
 #include "snapshot/process_snapshot.h"
 #include "snapshot/thread_snapshot.h"
+#include "third_party/zlib/zlib_crashpad.h"
 #include "util/file/file_writer.h"
+#include "util/file/output_stream_file_writer.h"
+#include "util/misc/metrics.h"
 #include "util/numeric/safe_assignment.h"
+#include "util/stream/file_writer_output_stream.h"
+#include "util/stream/zlib_output_stream.h"
 
 namespace crashpad {
 
+namespace {
+
+// The data of a kMinidumpStreamTypeCrashpadChecksum stream. It’s written with
+// a Version of 0, and rewritten once the checksum is known.
+class MinidumpChecksumWriter final : public internal::MinidumpStreamWriter {
+ public:
+  MinidumpChecksumWriter() : internal::MinidumpStreamWriter(), checksum_() {}
+
+  MinidumpChecksumWriter(const MinidumpChecksumWriter&) = delete;
+  MinidumpChecksumWriter& operator=(const MinidumpChecksumWriter&) = delete;
+
+  ~MinidumpChecksumWriter() override {}
+
+  // MinidumpStreamWriter:
+  MinidumpStreamType StreamType() const override {
+    return kMinidumpStreamTypeCrashpadChecksum;
+  }
+
+ protected:
+  // MinidumpWritable:
+
+  // This is written last, immediately after whatever precedes it, so that the
+  // checksum’s extent ends where this begins.
+  size_t Alignment() override { return 1; }
+  Phase WritePhase() override { return kPhaseLast; }
+
+  size_t SizeOfObject() override { return sizeof(checksum_); }
+
+  bool WriteObject(FileWriterInterface* file_writer) override {
+    return file_writer->Write(&checksum_, sizeof(checksum_));
+  }
+
+ private:
+  MinidumpChecksum checksum_;
+};
+
+// Passes writes through to another FileWriterInterface, computing the CRC-32
+// of the data written from an offset onward. The last |held_back_size| bytes
+// written aren’t included, so that the data of a MinidumpChecksumWriter
+// written last is left out.
+class ChecksumFileWriter final : public FileWriterInterface {
+ public:
+  ChecksumFileWriter(FileWriterInterface* file_writer,
+                     FileOffset checksum_start,
+                     size_t held_back_size)
+      : held_back_(),
+        file_writer_(file_writer),
+        position_(0),
+        checksum_start_(checksum_start),
+        checksum_size_(0),
+        held_back_size_(held_back_size),
+        crc_(crc32(0, nullptr, 0)),
+        sequential_(true) {}
+
+  ChecksumFileWriter(const ChecksumFileWriter&) = delete;
+  ChecksumFileWriter& operator=(const ChecksumFileWriter&) = delete;
+
+  ~ChecksumFileWriter() override {}
+
+  // Returns the CRC-32 of the data written from |checksum_start| to the start
+  // of the held-back data, and sets |size| to its size. Returns false if the
+  // data wasn’t written sequentially, so that the checksum is unknown.
+  bool Checksum(uint32_t* crc, uint64_t* size) const {
+    if (!sequential_) {
+      return false;
+    }
+    *crc = static_cast<uint32_t>(crc_);
+    *size = checksum_size_;
+    return true;
+  }
+
+  // FileWriterInterface:
+  bool Write(const void* data, size_t size) override {
+    if (!file_writer_->Write(data, size)) {
+      return false;
+    }
+    Update(static_cast<const uint8_t*>(data), size);
+    return true;
+  }
+
+  bool WriteIoVec(std::vector<WritableIoVec>* iovecs) override {
+    // The underlying writer may modify |iovecs|.
+    const std::vector<WritableIoVec> written(*iovecs);
+    if (!file_writer_->WriteIoVec(iovecs)) {
+      return false;
+    }
+    for (const WritableIoVec& iov : written) {
+      Update(static_cast<const uint8_t*>(iov.iov_base), iov.iov_len);
+    }
+    return true;
+  }
+
+  bool ReserveSpace(FileOffset size) override {
+    return file_writer_->ReserveSpace(size);
+  }
+
+  // FileSeekerInterface:
+  FileOffset Seek(FileOffset offset, int whence) override {
+    if (offset != 0 || whence != SEEK_CUR) {
+      sequential_ = false;
+    }
+    return file_writer_->Seek(offset, whence);
+  }
+
+ private:
+  void Checksum(const uint8_t* data, size_t size) {
+    crc_ = crc32(crc_, data, static_cast<uInt>(size));
+    checksum_size_ += size;
+  }
+
+  void Update(const uint8_t* data, size_t size) {
+    if (position_ < checksum_start_) {
+      const size_t skip = static_cast<size_t>(
+          std::min(static_cast<FileOffset>(size), checksum_start_ - position_));
+      data += skip;
+      size -= skip;
+      position_ += skip;
+    }
+    position_ += size;
+
+    if (size >= held_back_size_) {
+      Checksum(held_back_.data(), held_back_.size());
+      Checksum(data, size - held_back_size_);
+      held_back_.assign(data + size - held_back_size_, data + size);
+    } else {
+      held_back_.insert(held_back_.end(), data, data + size);
+      if (held_back_.size() > held_back_size_) {
+        const size_t excess = held_back_.size() - held_back_size_;
+        Checksum(held_back_.data(), excess);
+        held_back_.erase(held_back_.begin(), held_back_.begin() + excess);
+      }
+    }
+  }
+
+  std::vector<uint8_t> held_back_;
+  FileWriterInterface* file_writer_;  // weak
+  FileOffset position_;
+  const FileOffset checksum_start_;
+  uint64_t checksum_size_;
+  const size_t held_back_size_;
+  uLong crc_;
+  bool sequential_;
+};
+
+}  // namespace
+
 MinidumpFileWriter::MinidumpFileWriter()
-    : MinidumpWritable(), header_(), streams_(), stream_types_() {
+    : MinidumpWritable(),
+      header_(),
+      arena_(),
+      streams_(),
+      stream_types_(),
+      streaming_user_streams_(),
+      full_memory_(false),
+      write_checksum_(false) {
   // Don’t set the signature field right away. Leave it set to 0, so that a
   // partially-written minidump file isn’t confused for a complete and valid
   // one. The header will be rewritten in WriteToFile().
@@ -51,19 +218,37 @@ MinidumpFileWriter::MinidumpFileWriter()
   header_.Version = MINIDUMP_VERSION;
   header_.CheckSum = 0;
   header_.Flags = MiniDumpNormal;
+
+  // Strings such as module and thread names and annotation keys repeat
+  // throughout a minidump file. Write each only once.
+  SetShareIdenticalObjects(true);
 }
 
 MinidumpFileWriter::~MinidumpFileWriter() {
 }
 
+// static
+MinidumpSnapshotFilter MinidumpSnapshotFilter::Reduced() {
+  MinidumpSnapshotFilter filter;
+  filter.other_thread_memory = false;
+  filter.extra_memory = false;
+  filter.memory_map = false;
+  filter.handles = false;
+  filter.user_streams = false;
+  return filter;
+}
+
 void MinidumpFileWriter::InitializeFromSnapshot(
-    const ProcessSnapshot* process_snapshot) {
+    const ProcessSnapshot* process_snapshot,
+    const MinidumpSnapshotFilter& filter) {
   DCHECK_EQ(state(), kStateMutable);
   DCHECK_EQ(header_.Signature, 0u);
   DCHECK_EQ(header_.TimeDateStamp, 0u);
   DCHECK_EQ(static_cast<MINIDUMP_TYPE>(header_.Flags), MiniDumpNormal);
   DCHECK(streams_.empty());
 
+  internal::MinidumpWritableArena::Scope arena_scope(&arena_);
+
   // This time is truncated to an integer number of seconds, not rounded, for
   // compatibility with the truncation of process_snapshot->ProcessStartTime()
   // done by MinidumpMiscInfoWriter::InitializeFromSnapshot(). Handling both
@@ -73,11 +258,18 @@ void MinidumpFileWriter::InitializeFromSnapshot(
   process_snapshot->SnapshotTime(&snapshot_time);
   SetTimestamp(snapshot_time.tv_sec);
 
-  const SystemSnapshot* system_snapshot = process_snapshot->System();
-  auto system_info = std::make_unique<MinidumpSystemInfoWriter>();
-  system_info->InitializeFromSnapshot(system_snapshot);
-  bool add_stream_result = AddStream(std::move(system_info));
-  DCHECK(add_stream_result);
+  const auto omitted = [&filter](MinidumpStreamType stream_type) {
+    return filter.omitted_streams.count(stream_type) != 0;
+  };
+
+  bool add_stream_result;
+  if (!omitted(kMinidumpStreamTypeSystemInfo)) {
+    const SystemSnapshot* system_snapshot = process_snapshot->System();
+    auto system_info = std::make_unique<MinidumpSystemInfoWriter>();
+    system_info->InitializeFromSnapshot(system_snapshot);
+    add_stream_result = AddStream(std::move(system_info));
+    DCHECK(add_stream_result);
+  }
 
   auto misc_info = std::make_unique<MinidumpMiscInfoWriter>();
   misc_info->InitializeFromSnapshot(process_snapshot);
@@ -87,17 +279,78 @@ void MinidumpFileWriter::InitializeFromSnapshot(
   add_stream_result = AddStream(std::move(misc_info));
   DCHECK(add_stream_result);
 
+  const ExceptionSnapshot* exception_snapshot = process_snapshot->Exception();
+
+  // Without the memory of the other threads, only the thread that raised the
+  // exception and those selected by the filter have their stacks and extra
+  // memory written.
+  std::set<uint64_t> memory_thread_ids(filter.memory_thread_ids);
+  const bool filter_thread_memory =
+      !filter.other_thread_memory &&
+      (exception_snapshot || !memory_thread_ids.empty());
+  if (filter_thread_memory && exception_snapshot) {
+    memory_thread_ids.insert(exception_snapshot->ThreadID());
+  }
+
+  // These are used by several streams, so they’re only obtained once.
+  const std::vector<const ThreadSnapshot*> threads =
+      process_snapshot->Threads();
+  const std::vector<const ModuleSnapshot*> modules =
+      process_snapshot->Modules();
+
+  // Of the threads whose memory would be written, those whose stacks are
+  // identical to an earlier one’s are left out. The thread that raised the
+  // exception is kept whole.
+  std::map<uint64_t, uint64_t> identical_threads;
+  if (filter.collapse_identical_threads) {
+    std::vector<const ThreadSnapshot*> collapsible_threads;
+    for (const ThreadSnapshot* thread_snapshot : threads) {
+      const uint64_t thread_id = thread_snapshot->ThreadID();
+      if ((exception_snapshot &&
+           thread_id == exception_snapshot->ThreadID()) ||
+          (filter_thread_memory && !memory_thread_ids.count(thread_id))) {
+        continue;
+      }
+      collapsible_threads.push_back(thread_snapshot);
+    }
+    MinidumpIdenticalThreadListWriter::FindIdenticalThreads(
+        collapsible_threads, &identical_threads);
+  }
+  const bool collapse_thread_memory = !identical_threads.empty();
+  if (collapse_thread_memory) {
+    if (!filter_thread_memory) {
+      for (const ThreadSnapshot* thread_snapshot : threads) {
+        memory_thread_ids.insert(thread_snapshot->ThreadID());
+      }
+    }
+    for (const auto& identical_thread_ids : identical_threads) {
+      memory_thread_ids.erase(identical_thread_ids.first);
+    }
+  }
+
   auto memory_list = std::make_unique<MinidumpMemoryListWriter>();
   auto thread_list = std::make_unique<MinidumpThreadListWriter>();
   thread_list->SetMemoryListWriter(memory_list.get());
   MinidumpThreadIDMap thread_id_map;
-  thread_list->InitializeFromSnapshot(process_snapshot->Threads(),
-                                      &thread_id_map);
+  thread_list->InitializeFromSnapshot(
+      threads,
+      &thread_id_map,
+      filter_thread_memory || collapse_thread_memory ? &memory_thread_ids
+                                                     : nullptr);
   add_stream_result = AddStream(std::move(thread_list));
   DCHECK(add_stream_result);
 
+  if (collapse_thread_memory) {
+    auto identical_thread_list =
+        std::make_unique<MinidumpIdenticalThreadListWriter>();
+    identical_thread_list->InitializeFromIdenticalThreads(identical_threads,
+                                                          thread_id_map);
+    add_stream_result = AddStream(std::move(identical_thread_list));
+    DCHECK(add_stream_result);
+  }
+
   bool has_thread_name = false;
-  for (const ThreadSnapshot* thread_snapshot : process_snapshot->Threads()) {
+  for (const ThreadSnapshot* thread_snapshot : threads) {
     if (!thread_snapshot->ThreadName().empty()) {
       has_thread_name = true;
       break;
@@ -105,13 +358,26 @@ void MinidumpFileWriter::InitializeFromSnapshot(
   }
   if (has_thread_name) {
     auto thread_name_list = std::make_unique<MinidumpThreadNameListWriter>();
-    thread_name_list->InitializeFromSnapshot(process_snapshot->Threads(),
-                                             thread_id_map);
+    thread_name_list->InitializeFromSnapshot(threads, thread_id_map);
     add_stream_result = AddStream(std::move(thread_name_list));
     DCHECK(add_stream_result);
   }
 
-  const ExceptionSnapshot* exception_snapshot = process_snapshot->Exception();
+  auto stack_truncation_list =
+      std::make_unique<MinidumpStackTruncationListWriter>();
+  stack_truncation_list->InitializeFromSnapshot(threads, thread_id_map);
+  if (stack_truncation_list->IsUseful()) {
+    add_stream_result = AddStream(std::move(stack_truncation_list));
+    DCHECK(add_stream_result);
+  }
+
+  auto unwound_stack_list = std::make_unique<MinidumpUnwoundStackListWriter>();
+  unwound_stack_list->InitializeFromSnapshot(threads, modules, thread_id_map);
+  if (unwound_stack_list->IsUseful()) {
+    add_stream_result = AddStream(std::move(unwound_stack_list));
+    DCHECK(add_stream_result);
+  }
+
   if (exception_snapshot) {
     auto exception = std::make_unique<MinidumpExceptionWriter>();
     exception->InitializeFromSnapshot(exception_snapshot, thread_id_map);
@@ -119,13 +385,16 @@ void MinidumpFileWriter::InitializeFromSnapshot(
     DCHECK(add_stream_result);
   }
 
-  auto module_list = std::make_unique<MinidumpModuleListWriter>();
-  module_list->InitializeFromSnapshot(process_snapshot->Modules());
-  add_stream_result = AddStream(std::move(module_list));
-  DCHECK(add_stream_result);
+  if (!omitted(kMinidumpStreamTypeModuleList)) {
+    auto module_list = std::make_unique<MinidumpModuleListWriter>();
+    module_list->InitializeFromSnapshot(modules);
+    add_stream_result = AddStream(std::move(module_list));
+    DCHECK(add_stream_result);
+  }
 
   auto unloaded_modules = process_snapshot->UnloadedModules();
-  if (!unloaded_modules.empty()) {
+  if (!unloaded_modules.empty() &&
+      !omitted(kMinidumpStreamTypeUnloadedModuleList)) {
     auto unloaded_module_list =
         std::make_unique<MinidumpUnloadedModuleListWriter>();
     unloaded_module_list->InitializeFromSnapshot(unloaded_modules);
@@ -145,7 +414,8 @@ void MinidumpFileWriter::InitializeFromSnapshot(
 
   std::vector<const MemoryMapRegionSnapshot*> memory_map_snapshot =
       process_snapshot->MemoryMap();
-  if (!memory_map_snapshot.empty()) {
+  if (filter.memory_map && !memory_map_snapshot.empty() &&
+      !omitted(kMinidumpStreamTypeMemoryInfoList)) {
     auto memory_info_list = std::make_unique<MinidumpMemoryInfoListWriter>();
     memory_info_list->InitializeFromSnapshot(memory_map_snapshot);
     add_stream_result = AddStream(std::move(memory_info_list));
@@ -153,16 +423,18 @@ void MinidumpFileWriter::InitializeFromSnapshot(
   }
 
   std::vector<HandleSnapshot> handles_snapshot = process_snapshot->Handles();
-  if (!handles_snapshot.empty()) {
+  if (filter.handles && !handles_snapshot.empty()) {
     auto handle_data_writer = std::make_unique<MinidumpHandleDataWriter>();
     handle_data_writer->InitializeFromSnapshot(handles_snapshot);
     add_stream_result = AddStream(std::move(handle_data_writer));
     DCHECK(add_stream_result);
   }
 
-  memory_list->AddFromSnapshot(process_snapshot->ExtraMemory());
-  if (exception_snapshot) {
-    memory_list->AddFromSnapshot(exception_snapshot->ExtraMemory());
+  if (filter.extra_memory) {
+    memory_list->AddFromSnapshot(process_snapshot->ExtraMemory());
+    if (exception_snapshot) {
+      memory_list->AddFromSnapshot(exception_snapshot->ExtraMemory());
+    }
   }
 
   // These user streams must be added last. Otherwise, a user stream with the
@@ -171,16 +443,18 @@ void MinidumpFileWriter::InitializeFromSnapshot(
   // later-discovered ones. The well-known memory list stream is added after
   // these user streams, but only with a check here to avoid adding a user
   // stream that would preempt the memory list stream.
-  for (const auto& module : process_snapshot->Modules()) {
-    for (const UserMinidumpStream* stream : module->CustomMinidumpStreams()) {
-      if (stream->stream_type() == kMinidumpStreamTypeMemoryList) {
-        LOG(WARNING) << "discarding duplicate stream of type "
-                     << stream->stream_type();
-        continue;
+  if (filter.user_streams) {
+    for (const ModuleSnapshot* module : modules) {
+      for (const UserMinidumpStream* stream : module->CustomMinidumpStreams()) {
+        if (stream->stream_type() == kMinidumpStreamTypeMemoryList) {
+          LOG(WARNING) << "discarding duplicate stream of type "
+                       << stream->stream_type();
+          continue;
+        }
+        auto user_stream = std::make_unique<MinidumpUserStreamWriter>();
+        user_stream->InitializeFromSnapshot(stream);
+        AddStream(std::move(user_stream));
       }
-      auto user_stream = std::make_unique<MinidumpUserStreamWriter>();
-      user_stream->InitializeFromSnapshot(stream);
-      AddStream(std::move(user_stream));
     }
   }
 
@@ -203,6 +477,7 @@ void MinidumpFileWriter::SetTimestamp(time_t timestamp) {
 bool MinidumpFileWriter::AddStream(
     std::unique_ptr<internal::MinidumpStreamWriter> stream) {
   DCHECK_EQ(state(), kStateMutable);
+  DCHECK(!full_memory_) << "streams must be added before full memory";
 
   MinidumpStreamType stream_type = stream->StreamType();
 
@@ -227,7 +502,30 @@ bool MinidumpFileWriter::AddUserExtensionStream(
   user_stream->InitializeFromUserExtensionStream(
       std::move(user_extension_stream_data));
 
-  return AddStream(std::move(user_stream));
+  MinidumpUserStreamWriter* const weak_user_stream = user_stream.get();
+  if (!AddStream(std::move(user_stream))) {
+    return false;
+  }
+
+  if (weak_user_stream->IsStreaming()) {
+    streaming_user_streams_.push_back(weak_user_stream);
+  }
+  return true;
+}
+
+bool MinidumpFileWriter::AddFullMemory(
+    const std::vector<const MemorySnapshot*>& memory_snapshots) {
+  DCHECK_EQ(state(), kStateMutable);
+
+  auto memory64_list = std::make_unique<MinidumpMemory64ListWriter>();
+  memory64_list->AddFromSnapshot(memory_snapshots);
+  if (!AddStream(std::move(memory64_list))) {
+    return false;
+  }
+
+  full_memory_ = true;
+  header_.Flags |= MiniDumpWithFullMemory;
+  return true;
 }
 
 bool MinidumpFileWriter::WriteEverything(FileWriterInterface* file_writer) {
@@ -238,6 +536,9 @@ bool MinidumpFileWriter::WriteMinidump(FileWriterInterface* file_writer,
                                        bool allow_seek) {
   DCHECK_EQ(state(), kStateMutable);
 
+  Metrics::ScopedOperationTimer write_timer(
+      Metrics::TimedOperation::kMinidumpWrite);
+
   FileOffset start_offset = -1;
   if (allow_seek) {
     start_offset = file_writer->Seek(0, SEEK_CUR);
@@ -248,7 +549,35 @@ bool MinidumpFileWriter::WriteMinidump(FileWriterInterface* file_writer,
     header_.Signature = MINIDUMP_SIGNATURE;
   }
 
-  if (!MinidumpWritable::WriteEverything(file_writer)) {
+  // Without seeking, the stream directory can’t be rewritten with the sizes of
+  // streaming streams, so they must be known before it is written. With full
+  // memory, they’d otherwise follow the memory, where RVAs might not reach.
+  if (!allow_seek || full_memory_) {
+    for (MinidumpUserStreamWriter* user_stream : streaming_user_streams_) {
+      if (!user_stream->ReadStreamingContents()) {
+        LOG(ERROR) << "ReadStreamingContents failed";
+        return false;
+      }
+    }
+  }
+
+  // The checksum covers everything after the header. The directory is left
+  // out as it’s written, because it may be rewritten, and is included once
+  // everything has been written.
+  const bool write_checksum = write_checksum_ && allow_seek && !full_memory_;
+  std::unique_ptr<ChecksumFileWriter> checksum_file_writer;
+  if (write_checksum) {
+    if (!AddStream(std::make_unique<MinidumpChecksumWriter>())) {
+      return false;
+    }
+    checksum_file_writer = std::make_unique<ChecksumFileWriter>(
+        file_writer,
+        sizeof(header_) + streams_.size() * sizeof(MINIDUMP_DIRECTORY),
+        sizeof(MinidumpChecksum));
+  }
+
+  if (!MinidumpWritable::WriteEverything(
+          checksum_file_writer ? checksum_file_writer.get() : file_writer)) {
     return false;
   }
 
@@ -260,16 +589,47 @@ bool MinidumpFileWriter::WriteMinidump(FileWriterInterface* file_writer,
     return false;
   }
 
+  // If the checksum can’t be computed, the MinidumpChecksum is left with a
+  // Version of 0.
+  uint32_t body_crc;
+  uint64_t body_size;
+  if (write_checksum &&
+      checksum_file_writer->Checksum(&body_crc, &body_size) &&
+      body_size <= static_cast<uint64_t>(std::numeric_limits<z_off_t>::max())) {
+    uLong crc = crc32(0, nullptr, 0);
+    for (const auto& stream : streams_) {
+      crc = crc32(crc,
+                  reinterpret_cast<const Bytef*>(stream->DirectoryListEntry()),
+                  sizeof(MINIDUMP_DIRECTORY));
+    }
+    MinidumpChecksum checksum;
+    checksum.Version = MinidumpChecksum::kVersion;
+    checksum.Crc32 = static_cast<uint32_t>(
+        crc32_combine(crc, body_crc, static_cast<z_off_t>(body_size)));
+
+    const RVA checksum_rva =
+        streams_.back()->DirectoryListEntry()->Location.Rva;
+    DCHECK_EQ(start_offset + checksum_rva + sizeof(checksum),
+              static_cast<uint64_t>(end_offset));
+    if (file_writer->Seek(start_offset + checksum_rva, SEEK_SET) < 0 ||
+        !file_writer->Write(&checksum, sizeof(checksum))) {
+      return false;
+    }
+  }
+
   // Now that the entire minidump file has been completely written, go back to
   // the beginning and rewrite the header with the correct signature to identify
-  // it as a valid minidump file.
+  // it as a valid minidump file. The directory only needs to be rewritten if
+  // streams written last have filled in their locations since it was written.
   header_.Signature = MINIDUMP_SIGNATURE;
 
   if (file_writer->Seek(start_offset, SEEK_SET) < 0) {
     return false;
   }
 
-  if (!file_writer->Write(&header_, sizeof(header_))) {
+  if (streaming_user_streams_.empty() && !write_checksum
+          ? !file_writer->Write(&header_, sizeof(header_))
+          : !WriteHeaderAndDirectory(file_writer)) {
     return false;
   }
 
@@ -278,6 +638,17 @@ bool MinidumpFileWriter::WriteMinidump(FileWriterInterface* file_writer,
   return file_writer->Seek(end_offset, SEEK_SET) >= 0;
 }
 
+bool MinidumpFileWriter::WriteCompressedMinidump(
+    FileWriterInterface* file_writer) {
+  OutputStreamFileWriter compressed_writer(std::make_unique<ZlibOutputStream>(
+      ZlibOutputStream::Mode::kCompress,
+      std::make_unique<FileWriterOutputStream>(file_writer)));
+  const bool wrote = WriteMinidump(&compressed_writer, false /* allow_seek */);
+
+  // Always flush, to finish the compressed stream even if writing failed.
+  return compressed_writer.Flush() && wrote;
+}
+
 bool MinidumpFileWriter::Freeze() {
   DCHECK_EQ(state(), kStateMutable);
 
@@ -331,6 +702,12 @@ bool MinidumpFileWriter::WillWriteAtOffsetImpl(FileOffset offset) {
 
 bool MinidumpFileWriter::WriteObject(FileWriterInterface* file_writer) {
   DCHECK_EQ(state(), kStateWritable);
+
+  return WriteHeaderAndDirectory(file_writer);
+}
+
+bool MinidumpFileWriter::WriteHeaderAndDirectory(
+    FileWriterInterface* file_writer) {
   DCHECK_EQ(streams_.size(), stream_types_.size());
 
   WritableIoVec iov;
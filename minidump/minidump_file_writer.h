@@ -26,12 +26,80 @@
 #include "minidump/minidump_extensions.h"
 #include "minidump/minidump_stream_writer.h"
 #include "minidump/minidump_writable.h"
+#include "minidump/minidump_writable_arena.h"
 #include "util/file/file_io.h"
 
 namespace crashpad {
 
+class MemorySnapshot;
 class ProcessSnapshot;
 class MinidumpUserExtensionStreamDataSource;
+class MinidumpUserStreamWriter;
+
+//! \brief Selects the parts of a ProcessSnapshot that
+//!     MinidumpFileWriter::InitializeFromSnapshot() writes.
+//!
+//! By default, everything is written. Reduced() selects a much smaller
+//! minidump, which is still enough for a first look at a crash.
+struct MinidumpSnapshotFilter {
+  //! \brief Returns a filter that writes the exception, the stack of the
+  //!     thread that raised it, the contexts of every thread, the modules, and
+  //!     annotations, leaving out other memory, the memory map, handles, and
+  //!     user streams.
+  static MinidumpSnapshotFilter Reduced();
+
+  //! \brief Whether to write the stacks and extra memory of the threads other
+  //!     than the one that raised the exception. Every thread’s memory is
+  //!     written when there is no exception and #memory_thread_ids is empty.
+  bool other_thread_memory = true;
+
+  //! \brief The IDs of threads whose stacks and extra memory are written even
+  //!     when #other_thread_memory is `false`.
+  //!
+  //! This lets a snapshot without an exception, such as one taken of a hung
+  //! process, be reduced to the memory of the threads of interest.
+  std::set<uint64_t> memory_thread_ids;
+
+  //! \brief Whether to leave out the stacks and extra memory of threads whose
+  //!     stacks are identical to that of an earlier thread.
+  //!
+  //! The threads whose stacks are left out are listed, along with the thread
+  //! whose stack was written in their place, in a
+  //! kMinidumpStreamTypeCrashpadIdenticalThreads stream. This shrinks
+  //! minidumps of processes with many idle threads waiting in the same place.
+  //! The thread that raised the exception is always written in full.
+  //!
+  //! \sa MinidumpIdenticalThreadListWriter::FindIdenticalThreads()
+  bool collapse_identical_threads = false;
+
+  //! \brief Whether to write the extra memory of the process and its
+  //!     exception, as returned by ProcessSnapshot::ExtraMemory() and
+  //!     ExceptionSnapshot::ExtraMemory(). The extra memory of threads is
+  //!     written along with their stacks.
+  bool extra_memory = true;
+
+  //! \brief Whether to write the process’ memory map as a
+  //!     kMinidumpStreamTypeMemoryInfoList stream.
+  bool memory_map = true;
+
+  //! \brief Whether to write the process’ handles as a
+  //!     kMinidumpStreamTypeHandleData stream.
+  bool handles = true;
+
+  //! \brief Whether to write the user streams of the process’ modules, as
+  //!     returned by ModuleSnapshot::CustomMinidumpStreams().
+  bool user_streams = true;
+
+  //! \brief The types of streams to leave out, which the reader of the
+  //!     minidump is expected to have from elsewhere.
+  //!
+  //! Only kMinidumpStreamTypeSystemInfo, kMinidumpStreamTypeModuleList,
+  //! kMinidumpStreamTypeUnloadedModuleList, and
+  //! kMinidumpStreamTypeMemoryInfoList may be left out this way. These describe
+  //! the process and system rather than its state at the time of the snapshot,
+  //! and are often identical in successive snapshots of the same process.
+  std::set<MinidumpStreamType> omitted_streams;
+};
 
 //! \brief The root-level object in a minidump file.
 //!
@@ -71,18 +139,39 @@ class MinidumpFileWriter final : public internal::MinidumpWritable {
   //!  - User streams (if present)
   //!  - kMinidumpStreamTypeMemoryList
   //!
+  //! The objects that this method creates are allocated from an arena owned by
+  //! this object and released together when it is destroyed.
+  //!
   //! \param[in] process_snapshot The process snapshot to use as source data.
+  //! \param[in] filter The parts of \a process_snapshot to write. Streams that
+  //!     \a filter leaves out are not added.
   //!
   //! \note Valid in #kStateMutable. No mutator methods may be called before
   //!     this method, and it is not normally necessary to call any mutator
   //!     methods after this method.
-  void InitializeFromSnapshot(const ProcessSnapshot* process_snapshot);
+  void InitializeFromSnapshot(
+      const ProcessSnapshot* process_snapshot,
+      const MinidumpSnapshotFilter& filter = MinidumpSnapshotFilter());
 
   //! \brief Sets MINIDUMP_HEADER::Timestamp.
   //!
   //! \note Valid in #kStateMutable.
   void SetTimestamp(time_t timestamp);
 
+  //! \brief Sets whether the minidump file carries a checksum of its contents.
+  //!
+  //! If enabled, WriteEverything() adds a kMinidumpStreamTypeCrashpadChecksum
+  //! stream after all others, holding a MinidumpChecksum. The checksum is
+  //! computed from the data as it is written, without reading anything back.
+  //! Minidump files written without seeking, such as by
+  //! WriteCompressedMinidump(), and full-memory minidump files don’t carry a
+  //! checksum. The default is `false`.
+  //!
+  //! \note Valid in #kStateMutable.
+  void SetWriteChecksum(bool write_checksum) {
+    write_checksum_ = write_checksum;
+  }
+
   //! \brief Adds a stream to the minidump file and arranges for a
   //!     MINIDUMP_DIRECTORY entry to point to it.
   //!
@@ -115,7 +204,9 @@ class MinidumpFileWriter final : public internal::MinidumpWritable {
   //!
   //! \param[in] user_extension_stream_data The stream data to add to the
   //!    minidump file. Note that the buffer this object points to must be valid
-  //!    through WriteEverything().
+  //!    through WriteEverything(). If this is a streaming data source, its data
+  //!    is written after all other streams. See
+  //!    MinidumpUserExtensionStreamDataSource::IsStreaming().
   //!
   //! \note Valid in #kStateMutable.
   //!
@@ -126,6 +217,26 @@ class MinidumpFileWriter final : public internal::MinidumpWritable {
       std::unique_ptr<MinidumpUserExtensionStreamDataSource>
           user_extension_stream_data);
 
+  //! \brief Adds a kMinidumpStreamTypeMemory64List stream carrying the data of
+  //!     \a memory_snapshots, making this a full-memory minidump file.
+  //!
+  //! The data is written after that of every other stream, and may extend the
+  //! minidump file beyond the range addressable by an ::RVA. For this reason,
+  //! this must be the last stream added, and streaming user extension streams
+  //! are read before anything is written, as they are by WriteMinidump()
+  //! without seeking. MINIDUMP_HEADER::Flags is marked with
+  //! ::MiniDumpWithFullMemory.
+  //!
+  //! \param[in] memory_snapshots The memory to write. These snapshots must
+  //!     outlive this object. See MinidumpMemory64ListWriter::AddFromSnapshot().
+  //!
+  //! \note Valid in #kStateMutable.
+  //!
+  //! \return `true` on success. `false` on failure, as occurs when full memory
+  //!     has already been added, with a message logged.
+  bool AddFullMemory(
+      const std::vector<const MemorySnapshot*>& memory_snapshots);
+
   // MinidumpWritable:
 
   //! \copydoc internal::MinidumpWritable::WriteEverything()
@@ -134,14 +245,18 @@ class MinidumpFileWriter final : public internal::MinidumpWritable {
   //! MINIDUMP_HEADER::Signature. After all child objects have been written, it
   //! rewinds to the beginning of the file and writes the correct value for this
   //! field. This prevents incompletely-written minidump files from being
-  //! mistaken for valid ones.
+  //! mistaken for valid ones. The stream directory is written again at the same
+  //! time, with the locations of streams from streaming data sources, which
+  //! are only known once they have been written. The checksum enabled by
+  //! SetWriteChecksum() is written at the same time.
   bool WriteEverything(FileWriterInterface* file_writer) override;
 
   //! \brief Writes this object to a minidump file.
   //!
   //! Same as \a WriteEverything, but give the option to disable the seek. It
   //! is typically used to write to stream backed \a FileWriterInterface which
-  //! doesn't support seek.
+  //! doesn't support seek. Without seeking, the data of streaming user
+  //! extension streams is read into memory before anything is written.
   //!
   //! \param[in] file_writer The file writer to receive the minidump file’s
   //!     content.
@@ -152,6 +267,22 @@ class MinidumpFileWriter final : public internal::MinidumpWritable {
   //!     logged.
   bool WriteMinidump(FileWriterInterface* file_writer, bool allow_seek);
 
+  //! \brief Writes this object to a zlib-compressed minidump file.
+  //!
+  //! The minidump file’s content is compressed as a single zlib stream as it is
+  //! written, without seeking, so the file never holds an uncompressed copy of
+  //! the minidump. Because the header is written with its final signature
+  //! up front, the file’s content must be discarded if this method fails.
+  //!
+  //! ProcessSnapshotMinidump is able to read files written by this method.
+  //!
+  //! \param[in] file_writer The file writer to receive the compressed minidump
+  //!     file’s content.
+  //!
+  //! \return `true` on success. `false` on failure, with an appropriate message
+  //!     logged.
+  bool WriteCompressedMinidump(FileWriterInterface* file_writer);
+
  protected:
   // MinidumpWritable:
   bool Freeze() override;
@@ -161,11 +292,31 @@ class MinidumpFileWriter final : public internal::MinidumpWritable {
   bool WriteObject(FileWriterInterface* file_writer) override;
 
  private:
+  // Writes header_ followed by the stream directory.
+  bool WriteHeaderAndDirectory(FileWriterInterface* file_writer);
+
   MINIDUMP_HEADER header_;
+
+  // Holds the objects created by InitializeFromSnapshot(). This must be
+  // declared before any member that may own those objects so that it is
+  // destroyed after them.
+  internal::MinidumpWritableArena arena_;
+
   std::vector<std::unique_ptr<internal::MinidumpStreamWriter>> streams_;
 
   // Protects against multiple streams with the same ID being added.
   std::set<MinidumpStreamType> stream_types_;
+
+  // The user extension streams in streams_ whose data sources are streaming.
+  std::vector<MinidumpUserStreamWriter*> streaming_user_streams_;  // weak
+
+  // Whether AddFullMemory() has added a kMinidumpStreamTypeMemory64List
+  // stream.
+  bool full_memory_;
+
+  // Whether WriteEverything() adds a kMinidumpStreamTypeCrashpadChecksum
+  // stream.
+  bool write_checksum_;
 };
 
 }  // namespace crashpad
@@ -14,6 +14,7 @@
 
 #include "minidump/minidump_file_writer.h"
 
+#include <stddef.h>
 #include <stdint.h>
 #include <string.h>
 
@@ -23,13 +24,18 @@
 
 #include "build/build_config.h"
 #include "gtest/gtest.h"
+#include "minidump/minidump_extensions.h"
 #include "minidump/minidump_stream_writer.h"
 #include "minidump/minidump_user_extension_stream_data_source.h"
 #include "minidump/test/minidump_file_writer_test_util.h"
 #include "minidump/test/minidump_user_extension_stream_util.h"
 #include "minidump/test/minidump_writable_test_util.h"
+#include "snapshot/minidump/minidump_checksum.h"
+#include "snapshot/minidump/minidump_compression.h"
+#include "snapshot/minidump/process_snapshot_minidump.h"
 #include "snapshot/test/test_cpu_context.h"
 #include "snapshot/test/test_exception_snapshot.h"
+#include "snapshot/test/test_memory_map_region_snapshot.h"
 #include "snapshot/test/test_memory_snapshot.h"
 #include "snapshot/test/test_module_snapshot.h"
 #include "snapshot/test/test_process_snapshot.h"
@@ -554,6 +560,205 @@ TEST(MinidumpFileWriter, InitializeFromSnapshot_CrashpadInfo) {
                   string_file.string(), directory[6].Location));
 }
 
+std::unique_ptr<TestMemorySnapshot> MemoryAt(uint64_t address) {
+  auto memory = std::make_unique<TestMemorySnapshot>();
+  memory->SetAddress(address);
+  memory->SetSize(0x100);
+  memory->SetValue('m');
+  return memory;
+}
+
+// Checks a minidump written with MinidumpSnapshotFilter::Reduced() from the
+// process snapshot built by InitializeFromSnapshot_Reduced, in which thread 2
+// raised the exception.
+void VerifyReducedMinidump(const std::string& file_contents) {
+  const MINIDUMP_DIRECTORY* directory;
+  const MINIDUMP_HEADER* header =
+      MinidumpHeaderAtStart(file_contents, &directory);
+  ASSERT_TRUE(header);
+  ASSERT_EQ(header->NumberOfStreams, 7u);
+  ASSERT_TRUE(directory);
+
+  EXPECT_EQ(directory[0].StreamType, kMinidumpStreamTypeSystemInfo);
+  EXPECT_EQ(directory[1].StreamType, kMinidumpStreamTypeMiscInfo);
+  EXPECT_EQ(directory[2].StreamType, kMinidumpStreamTypeThreadList);
+  EXPECT_EQ(directory[3].StreamType, kMinidumpStreamTypeException);
+  EXPECT_EQ(directory[4].StreamType, kMinidumpStreamTypeModuleList);
+  EXPECT_EQ(directory[5].StreamType, kMinidumpStreamTypeCrashpadInfo);
+  EXPECT_EQ(directory[6].StreamType, kMinidumpStreamTypeMemoryList);
+
+  // Both threads are present, but only the one that raised the exception has
+  // its stack.
+  const MINIDUMP_THREAD_LIST* thread_list =
+      MinidumpWritableAtLocationDescriptor<MINIDUMP_THREAD_LIST>(
+          file_contents, directory[2].Location);
+  ASSERT_TRUE(thread_list);
+  ASSERT_EQ(thread_list->NumberOfThreads, 2u);
+  EXPECT_EQ(thread_list->Threads[0].ThreadId, 1u);
+  EXPECT_EQ(thread_list->Threads[0].Stack.Memory.DataSize, 0u);
+  EXPECT_EQ(thread_list->Threads[1].ThreadId, 2u);
+  EXPECT_EQ(thread_list->Threads[1].Stack.StartOfMemoryRange, 0x2000u);
+  EXPECT_EQ(thread_list->Threads[1].Stack.Memory.DataSize, 0x100u);
+
+  const MINIDUMP_MEMORY_LIST* memory_list =
+      MinidumpWritableAtLocationDescriptor<MINIDUMP_MEMORY_LIST>(
+          file_contents, directory[6].Location);
+  ASSERT_TRUE(memory_list);
+  ASSERT_EQ(memory_list->NumberOfMemoryRanges, 1u);
+  EXPECT_EQ(memory_list->MemoryRanges[0].StartOfMemoryRange, 0x2000u);
+}
+
+TEST(MinidumpFileWriter, InitializeFromSnapshot_Reduced) {
+  constexpr uint32_t kSnapshotTime = 0x4976043c;
+  constexpr timeval kSnapshotTimeval = {static_cast<time_t>(kSnapshotTime), 0};
+
+  TestProcessSnapshot process_snapshot;
+  process_snapshot.SetSnapshotTime(kSnapshotTimeval);
+
+  // The report ID makes the MinidumpCrashpadInfo stream useful, so that it is
+  // written along with the module.
+  UUID report_id;
+  ASSERT_TRUE(
+      report_id.InitializeFromString("00112233-4455-6677-8899-aabbccddeeff"));
+  process_snapshot.SetReportID(report_id);
+
+  auto system_snapshot = std::make_unique<TestSystemSnapshot>();
+  system_snapshot->SetCPUArchitecture(kCPUArchitectureX86_64);
+  system_snapshot->SetOperatingSystem(SystemSnapshot::kOperatingSystemLinux);
+  system_snapshot->SetNXEnabled(true);
+  system_snapshot->SetTimeZone(SystemSnapshot::kObservingStandardTime,
+                               -5 * 60 * 60,
+                               -4 * 60 * 60,
+                               "EST",
+                               "EDT");
+  process_snapshot.SetSystem(std::move(system_snapshot));
+
+  auto thread_snapshot = std::make_unique<TestThreadSnapshot>();
+  InitializeCPUContextX86_64(thread_snapshot->MutableContext(), 5);
+  thread_snapshot->SetThreadID(1);
+  thread_snapshot->SetStack(MemoryAt(0x1000));
+  thread_snapshot->AddExtraMemory(MemoryAt(0x3000));
+  process_snapshot.AddThread(std::move(thread_snapshot));
+
+  thread_snapshot = std::make_unique<TestThreadSnapshot>();
+  InitializeCPUContextX86_64(thread_snapshot->MutableContext(), 7);
+  thread_snapshot->SetThreadID(2);
+  thread_snapshot->SetStack(MemoryAt(0x2000));
+  process_snapshot.AddThread(std::move(thread_snapshot));
+
+  auto exception_snapshot = std::make_unique<TestExceptionSnapshot>();
+  InitializeCPUContextX86_64(exception_snapshot->MutableContext(), 11);
+  exception_snapshot->SetThreadID(2);
+  exception_snapshot->AddExtraMemory(MemoryAt(0x4000));
+  process_snapshot.SetException(std::move(exception_snapshot));
+
+  process_snapshot.AddModule(std::make_unique<TestModuleSnapshot>());
+  process_snapshot.AddExtraMemory(MemoryAt(0x5000));
+
+  auto memory_map_region = std::make_unique<TestMemoryMapRegionSnapshot>();
+  MINIDUMP_MEMORY_INFO memory_info = {};
+  memory_info.BaseAddress = 0x1000;
+  memory_info.RegionSize = 0x5000;
+  memory_map_region->SetMindumpMemoryInfo(memory_info);
+  process_snapshot.AddMemoryMapRegion(std::move(memory_map_region));
+
+  HandleSnapshot handle_snapshot;
+  handle_snapshot.handle = 3;
+  process_snapshot.AddHandle(handle_snapshot);
+
+  MinidumpFileWriter reduced_writer;
+  reduced_writer.InitializeFromSnapshot(&process_snapshot,
+                                        MinidumpSnapshotFilter::Reduced());
+  StringFile reduced_file;
+  ASSERT_TRUE(reduced_writer.WriteEverything(&reduced_file));
+  ASSERT_NO_FATAL_FAILURE(VerifyReducedMinidump(reduced_file.string()));
+
+  // The same reduced minidump can be derived from the full one.
+  MinidumpFileWriter full_writer;
+  full_writer.InitializeFromSnapshot(&process_snapshot);
+  StringFile full_file;
+  ASSERT_TRUE(full_writer.WriteEverything(&full_file));
+
+  ProcessSnapshotMinidump minidump_snapshot;
+  ASSERT_TRUE(full_file.SeekSet(0));
+  ASSERT_TRUE(minidump_snapshot.Initialize(&full_file));
+
+  const SystemSnapshot* system = minidump_snapshot.System();
+  EXPECT_TRUE(system->NXEnabled());
+  SystemSnapshot::DaylightSavingTimeStatus dst_status;
+  int standard_offset_seconds;
+  int daylight_offset_seconds;
+  std::string standard_name;
+  std::string daylight_name;
+  system->TimeZone(&dst_status,
+                   &standard_offset_seconds,
+                   &daylight_offset_seconds,
+                   &standard_name,
+                   &daylight_name);
+  EXPECT_EQ(dst_status, SystemSnapshot::kObservingStandardTime);
+  EXPECT_EQ(standard_offset_seconds, -5 * 60 * 60);
+  EXPECT_EQ(daylight_offset_seconds, -4 * 60 * 60);
+  EXPECT_EQ(standard_name, "EST");
+  EXPECT_EQ(daylight_name, "EDT");
+
+  MinidumpFileWriter derived_writer;
+  derived_writer.InitializeFromSnapshot(&minidump_snapshot,
+                                        MinidumpSnapshotFilter::Reduced());
+  StringFile derived_file;
+  ASSERT_TRUE(derived_writer.WriteEverything(&derived_file));
+  ASSERT_NO_FATAL_FAILURE(VerifyReducedMinidump(derived_file.string()));
+  EXPECT_LT(derived_file.string().size(), full_file.string().size());
+}
+
+TEST(MinidumpFileWriter, InitializeFromSnapshot_MemoryThreadIDs) {
+  TestProcessSnapshot process_snapshot;
+
+  auto system_snapshot = std::make_unique<TestSystemSnapshot>();
+  system_snapshot->SetCPUArchitecture(kCPUArchitectureX86_64);
+  system_snapshot->SetOperatingSystem(SystemSnapshot::kOperatingSystemLinux);
+  process_snapshot.SetSystem(std::move(system_snapshot));
+
+  for (uint64_t thread_id = 1; thread_id <= 3; ++thread_id) {
+    auto thread_snapshot = std::make_unique<TestThreadSnapshot>();
+    InitializeCPUContextX86_64(thread_snapshot->MutableContext(),
+                               static_cast<uint32_t>(thread_id));
+    thread_snapshot->SetThreadID(thread_id);
+    thread_snapshot->SetStack(MemoryAt(thread_id * 0x1000));
+    process_snapshot.AddThread(std::move(thread_snapshot));
+  }
+
+  // Without an exception, only the selected threads have their stacks written.
+  MinidumpSnapshotFilter filter = MinidumpSnapshotFilter::Reduced();
+  filter.memory_thread_ids = {1, 3};
+
+  MinidumpFileWriter minidump_file;
+  minidump_file.InitializeFromSnapshot(&process_snapshot, filter);
+  StringFile string_file;
+  ASSERT_TRUE(minidump_file.WriteEverything(&string_file));
+
+  const MINIDUMP_DIRECTORY* directory;
+  const MINIDUMP_HEADER* header =
+      MinidumpHeaderAtStart(string_file.string(), &directory);
+  ASSERT_TRUE(header);
+  ASSERT_TRUE(directory);
+
+  const MINIDUMP_THREAD_LIST* thread_list = nullptr;
+  for (size_t index = 0; index < header->NumberOfStreams; ++index) {
+    EXPECT_NE(directory[index].StreamType, kMinidumpStreamTypeException);
+    if (directory[index].StreamType == kMinidumpStreamTypeThreadList) {
+      thread_list = MinidumpWritableAtLocationDescriptor<MINIDUMP_THREAD_LIST>(
+          string_file.string(), directory[index].Location);
+    }
+  }
+  ASSERT_TRUE(thread_list);
+  ASSERT_EQ(thread_list->NumberOfThreads, 3u);
+  EXPECT_EQ(thread_list->Threads[0].Stack.StartOfMemoryRange, 0x1000u);
+  EXPECT_EQ(thread_list->Threads[0].Stack.Memory.DataSize, 0x100u);
+  EXPECT_EQ(thread_list->Threads[1].Stack.Memory.DataSize, 0u);
+  EXPECT_EQ(thread_list->Threads[2].Stack.StartOfMemoryRange, 0x3000u);
+  EXPECT_EQ(thread_list->Threads[2].Stack.Memory.DataSize, 0x100u);
+}
+
 TEST(MinidumpFileWriter, SameStreamType) {
   MinidumpFileWriter minidump_file;
 
@@ -645,6 +850,144 @@ TEST(MinidumpFileWriter, WriteMinidumpDisallowSeek) {
   EXPECT_EQ(memcmp(stream_data, expected_stream.c_str(), kStreamSize), 0);
 }
 
+TEST(MinidumpFileWriter, WriteCompressedMinidump) {
+  MinidumpFileWriter minidump_file;
+  constexpr time_t kTimestamp = 0x155d2fb8;
+  minidump_file.SetTimestamp(kTimestamp);
+
+  constexpr size_t kStreamSize = 5;
+  constexpr MinidumpStreamType kStreamType =
+      static_cast<MinidumpStreamType>(0x4d);
+  constexpr uint8_t kStreamValue = 0x5a;
+  auto stream =
+      std::make_unique<TestStream>(kStreamType, kStreamSize, kStreamValue);
+  ASSERT_TRUE(minidump_file.AddStream(std::move(stream)));
+
+  StringFile compressed_file;
+  ASSERT_TRUE(minidump_file.WriteCompressedMinidump(&compressed_file));
+  ASSERT_TRUE(compressed_file.SeekSet(0));
+  EXPECT_TRUE(IsCompressedMinidump(&compressed_file));
+  EXPECT_EQ(compressed_file.SeekGet(), 0);
+
+  StringFile string_file;
+  ASSERT_TRUE(DecompressMinidump(&compressed_file, &string_file));
+  EXPECT_FALSE(IsCompressedMinidump(&string_file));
+
+  constexpr size_t kDirectoryOffset = sizeof(MINIDUMP_HEADER);
+  constexpr size_t kStreamOffset =
+      kDirectoryOffset + sizeof(MINIDUMP_DIRECTORY);
+  constexpr size_t kFileSize = kStreamOffset + kStreamSize;
+
+  ASSERT_EQ(string_file.string().size(), kFileSize);
+
+  const MINIDUMP_DIRECTORY* directory;
+  const MINIDUMP_HEADER* header =
+      MinidumpHeaderAtStart(string_file.string(), &directory);
+  ASSERT_NO_FATAL_FAILURE(VerifyMinidumpHeader(header, 1, kTimestamp));
+  ASSERT_TRUE(directory);
+
+  EXPECT_EQ(directory[0].StreamType, kStreamType);
+  EXPECT_EQ(directory[0].Location.DataSize, kStreamSize);
+  EXPECT_EQ(directory[0].Location.Rva, kStreamOffset);
+
+  const uint8_t* stream_data = MinidumpWritableAtLocationDescriptor<uint8_t>(
+      string_file.string(), directory[0].Location);
+  ASSERT_TRUE(stream_data);
+
+  std::string expected_stream(kStreamSize, kStreamValue);
+  EXPECT_EQ(memcmp(stream_data, expected_stream.c_str(), kStreamSize), 0);
+
+  // ProcessSnapshotMinidump reads the compressed form directly.
+  ASSERT_TRUE(compressed_file.SeekSet(0));
+  ProcessSnapshotMinidump process_snapshot;
+  ASSERT_TRUE(process_snapshot.Initialize(&compressed_file));
+
+  timeval snapshot_time;
+  process_snapshot.SnapshotTime(&snapshot_time);
+  EXPECT_EQ(snapshot_time.tv_sec, kTimestamp);
+}
+
+TEST(MinidumpFileWriter, WriteChecksum) {
+  MinidumpFileWriter minidump_file;
+  constexpr time_t kTimestamp = 0x155d2fb8;
+  minidump_file.SetTimestamp(kTimestamp);
+  minidump_file.SetWriteChecksum(true);
+
+  constexpr size_t kStreamSize = 5;
+  constexpr MinidumpStreamType kStreamType =
+      static_cast<MinidumpStreamType>(0x4d);
+  constexpr uint8_t kStreamValue = 0x5a;
+  auto stream =
+      std::make_unique<TestStream>(kStreamType, kStreamSize, kStreamValue);
+  ASSERT_TRUE(minidump_file.AddStream(std::move(stream)));
+
+  StringFile string_file;
+  ASSERT_TRUE(minidump_file.WriteEverything(&string_file));
+
+  const MINIDUMP_DIRECTORY* directory;
+  const MINIDUMP_HEADER* header =
+      MinidumpHeaderAtStart(string_file.string(), &directory);
+  ASSERT_NO_FATAL_FAILURE(VerifyMinidumpHeader(header, 2, kTimestamp));
+  ASSERT_TRUE(directory);
+
+  // The checksum is the last stream, at the end of the file.
+  EXPECT_EQ(directory[0].StreamType, kStreamType);
+  EXPECT_EQ(directory[1].StreamType, kMinidumpStreamTypeCrashpadChecksum);
+  EXPECT_EQ(directory[1].Location.DataSize, sizeof(MinidumpChecksum));
+  EXPECT_EQ(directory[1].Location.Rva + directory[1].Location.DataSize,
+            string_file.string().size());
+
+  const MinidumpChecksum* checksum =
+      MinidumpWritableAtLocationDescriptor<MinidumpChecksum>(
+          string_file.string(), directory[1].Location);
+  ASSERT_TRUE(checksum);
+  EXPECT_EQ(checksum->Version, MinidumpChecksum::kVersion);
+
+  ASSERT_TRUE(string_file.SeekSet(0));
+  EXPECT_EQ(CheckMinidumpChecksum(&string_file),
+            MinidumpChecksumResult::kMatch);
+
+  ASSERT_TRUE(string_file.SeekSet(0));
+  ProcessSnapshotMinidump process_snapshot;
+  EXPECT_TRUE(process_snapshot.Initialize(&string_file));
+
+  // A change to a stream or to the directory is detected.
+  const std::string contents = string_file.string();
+  const size_t corrupt_offsets[] = {
+      directory[0].Location.Rva,
+      sizeof(MINIDUMP_HEADER) + offsetof(MINIDUMP_DIRECTORY, Location),
+  };
+  for (size_t offset : corrupt_offsets) {
+    SCOPED_TRACE(offset);
+    std::string corrupt_contents = contents;
+    corrupt_contents[offset] ^= 1;
+    StringFile corrupt_file;
+    corrupt_file.SetString(corrupt_contents);
+    EXPECT_EQ(CheckMinidumpChecksum(&corrupt_file),
+              MinidumpChecksumResult::kMismatch);
+
+    ASSERT_TRUE(corrupt_file.SeekSet(0));
+    ProcessSnapshotMinidump corrupt_process_snapshot;
+    EXPECT_FALSE(corrupt_process_snapshot.Initialize(&corrupt_file));
+  }
+
+  // So is truncation.
+  StringFile truncated_file;
+  truncated_file.SetString(contents.substr(0, contents.size() - 1));
+  EXPECT_EQ(CheckMinidumpChecksum(&truncated_file),
+            MinidumpChecksumResult::kMismatch);
+
+  // A minidump written without a checksum has none to check.
+  MinidumpFileWriter unchecked_minidump_file;
+  ASSERT_TRUE(unchecked_minidump_file.AddStream(
+      std::make_unique<TestStream>(kStreamType, kStreamSize, kStreamValue)));
+  StringFile unchecked_file;
+  ASSERT_TRUE(unchecked_minidump_file.WriteEverything(&unchecked_file));
+  ASSERT_TRUE(unchecked_file.SeekSet(0));
+  EXPECT_EQ(CheckMinidumpChecksum(&unchecked_file),
+            MinidumpChecksumResult::kNone);
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace crashpad
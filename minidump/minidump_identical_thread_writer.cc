@@ -0,0 +1,263 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "minidump/minidump_identical_thread_writer.h"
+
+#include <string.h>
+
+#include <tuple>
+#include <utility>
+
+#include "base/check_op.h"
+#include "base/logging.h"
+#include "snapshot/cpu_context.h"
+#include "snapshot/memory_snapshot.h"
+#include "snapshot/thread_snapshot.h"
+#include "util/file/file_writer.h"
+#include "util/numeric/safe_assignment.h"
+
+namespace crashpad {
+
+namespace {
+
+// Threads with equal fingerprints are considered identical.
+struct ThreadFingerprint {
+  uint64_t instruction_pointer;
+  uint64_t stack_pointer_offset;
+  uint64_t stack_size;
+  uint64_t stack_hash;
+
+  bool operator<(const ThreadFingerprint& other) const {
+    return std::tie(instruction_pointer,
+                    stack_pointer_offset,
+                    stack_size,
+                    stack_hash) < std::tie(other.instruction_pointer,
+                                           other.stack_pointer_offset,
+                                           other.stack_size,
+                                           other.stack_hash);
+  }
+};
+
+uint64_t MixHash(uint64_t hash, uint64_t value) {
+  hash = (hash ^ value) * 0x9e3779b97f4a7c15;
+  return hash ^ (hash >> 32);
+}
+
+// Hashes a stack a Word at a time. Words that point into the stack, or into as
+// much again past its end, where pthreads keeps the thread’s own thread-local
+// storage, are hashed as offsets from the start of the stack, so that the same
+// frames on two threads’ stacks hash alike. The words are spread across
+// independent lanes rather than hashed in a single chain, which lets the
+// compiler vectorize the loop.
+template <typename Word>
+uint64_t HashStack(const uint8_t* data, size_t size, uint64_t address) {
+  constexpr size_t kLanes = 4;
+  uint64_t lanes[kLanes] = {1, 2, 3, 4};
+  const uint64_t normalize_size = static_cast<uint64_t>(size) * 2;
+  const size_t word_count = size / sizeof(Word);
+
+  size_t index = 0;
+  for (; index + kLanes <= word_count; index += kLanes) {
+    for (size_t lane = 0; lane < kLanes; ++lane) {
+      Word word;
+      memcpy(&word, data + (index + lane) * sizeof(Word), sizeof(word));
+      uint64_t value = word;
+      if (value - address < normalize_size) {
+        value -= address;
+      }
+      lanes[lane] = MixHash(lanes[lane], value);
+    }
+  }
+
+  uint64_t hash = size;
+  for (uint64_t lane_hash : lanes) {
+    hash = MixHash(hash, lane_hash);
+  }
+  for (; index < word_count; ++index) {
+    Word word;
+    memcpy(&word, data + index * sizeof(Word), sizeof(word));
+    uint64_t value = word;
+    if (value - address < normalize_size) {
+      value -= address;
+    }
+    hash = MixHash(hash, value);
+  }
+  for (size_t offset = word_count * sizeof(Word); offset < size; ++offset) {
+    hash = MixHash(hash, data[offset]);
+  }
+  return hash;
+}
+
+class StackHasher final : public MemorySnapshot::Delegate {
+ public:
+  StackHasher(uint64_t address, bool is_64_bit)
+      : address_(address), hash_(0), is_64_bit_(is_64_bit) {}
+
+  StackHasher(const StackHasher&) = delete;
+  StackHasher& operator=(const StackHasher&) = delete;
+
+  ~StackHasher() {}
+
+  uint64_t hash() const { return hash_; }
+
+  // MemorySnapshot::Delegate:
+  bool MemorySnapshotDelegateRead(void* data, size_t size) override {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    hash_ = is_64_bit_ ? HashStack<uint64_t>(bytes, size, address_)
+                       : HashStack<uint32_t>(bytes, size, address_);
+    return true;
+  }
+
+ private:
+  uint64_t address_;
+  uint64_t hash_;
+  bool is_64_bit_;
+};
+
+}  // namespace
+
+MinidumpIdenticalThreadListWriter::MinidumpIdenticalThreadListWriter()
+    : MinidumpStreamWriter(), identical_thread_list_base_(), items_() {}
+
+MinidumpIdenticalThreadListWriter::~MinidumpIdenticalThreadListWriter() {}
+
+// static
+void MinidumpIdenticalThreadListWriter::FindIdenticalThreads(
+    const std::vector<const ThreadSnapshot*>& thread_snapshots,
+    std::map<uint64_t, uint64_t>* identical_threads) {
+  DCHECK(identical_threads->empty());
+
+  std::map<ThreadFingerprint, uint64_t> representative_thread_ids;
+  for (const ThreadSnapshot* thread_snapshot : thread_snapshots) {
+    const CPUContext* context = thread_snapshot->Context();
+    const MemorySnapshot* stack = thread_snapshot->Stack();
+    if (!context || !stack || !stack->Size()) {
+      continue;
+    }
+
+    switch (context->architecture) {
+      case kCPUArchitectureX86:
+      case kCPUArchitectureX86_64:
+      case kCPUArchitectureARM:
+      case kCPUArchitectureARM64:
+        break;
+      default:
+        continue;
+    }
+
+    StackHasher stack_hasher(stack->Address(), context->Is64Bit());
+    if (!stack->Read(&stack_hasher)) {
+      continue;
+    }
+
+    ThreadFingerprint fingerprint;
+    fingerprint.instruction_pointer = context->InstructionPointer();
+    fingerprint.stack_pointer_offset =
+        context->StackPointer() - stack->Address();
+    fingerprint.stack_size = stack->Size();
+    fingerprint.stack_hash = stack_hasher.hash();
+
+    const auto result = representative_thread_ids.insert(
+        std::make_pair(fingerprint, thread_snapshot->ThreadID()));
+    if (!result.second) {
+      identical_threads->insert(
+          std::make_pair(thread_snapshot->ThreadID(), result.first->second));
+    }
+  }
+}
+
+void MinidumpIdenticalThreadListWriter::InitializeFromIdenticalThreads(
+    const std::map<uint64_t, uint64_t>& identical_threads,
+    const MinidumpThreadIDMap& thread_id_map) {
+  DCHECK_EQ(state(), kStateMutable);
+  DCHECK(items_.empty());
+
+  for (const auto& identical_thread_ids : identical_threads) {
+    const auto it = thread_id_map.find(identical_thread_ids.first);
+    const auto representative_it =
+        thread_id_map.find(identical_thread_ids.second);
+    DCHECK(it != thread_id_map.end());
+    DCHECK(representative_it != thread_id_map.end());
+
+    MinidumpIdenticalThread identical_thread = {};
+    identical_thread.ThreadId = it->second;
+    identical_thread.RepresentativeThreadId = representative_it->second;
+    AddIdenticalThread(identical_thread);
+  }
+}
+
+void MinidumpIdenticalThreadListWriter::AddIdenticalThread(
+    const MinidumpIdenticalThread& identical_thread) {
+  DCHECK_EQ(state(), kStateMutable);
+
+  items_.push_back(identical_thread);
+}
+
+bool MinidumpIdenticalThreadListWriter::Freeze() {
+  DCHECK_EQ(state(), kStateMutable);
+
+  if (!MinidumpStreamWriter::Freeze()) {
+    return false;
+  }
+
+  identical_thread_list_base_.SizeOfHeader =
+      sizeof(MinidumpIdenticalThreadList);
+  identical_thread_list_base_.SizeOfEntry = sizeof(MinidumpIdenticalThread);
+  if (!AssignIfInRange(&identical_thread_list_base_.NumberOfEntries,
+                       items_.size())) {
+    LOG(ERROR) << "identical thread count " << items_.size()
+               << " out of range";
+    return false;
+  }
+
+  return true;
+}
+
+size_t MinidumpIdenticalThreadListWriter::SizeOfObject() {
+  DCHECK_GE(state(), kStateFrozen);
+
+  return sizeof(identical_thread_list_base_) +
+         items_.size() * sizeof(MinidumpIdenticalThread);
+}
+
+std::vector<internal::MinidumpWritable*>
+MinidumpIdenticalThreadListWriter::Children() {
+  DCHECK_GE(state(), kStateFrozen);
+
+  return std::vector<internal::MinidumpWritable*>();
+}
+
+bool MinidumpIdenticalThreadListWriter::WriteObject(
+    FileWriterInterface* file_writer) {
+  DCHECK_EQ(state(), kStateWritable);
+
+  WritableIoVec iov;
+  iov.iov_base = &identical_thread_list_base_;
+  iov.iov_len = sizeof(identical_thread_list_base_);
+  std::vector<WritableIoVec> iovecs(1, iov);
+
+  if (!items_.empty()) {
+    iov.iov_base = &items_[0];
+    iov.iov_len = items_.size() * sizeof(items_[0]);
+    iovecs.push_back(iov);
+  }
+
+  return file_writer->WriteIoVec(&iovecs);
+}
+
+MinidumpStreamType MinidumpIdenticalThreadListWriter::StreamType() const {
+  return kMinidumpStreamTypeCrashpadIdenticalThreads;
+}
+
+}  // namespace crashpad
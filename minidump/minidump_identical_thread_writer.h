@@ -0,0 +1,108 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_MINIDUMP_MINIDUMP_IDENTICAL_THREAD_WRITER_H_
+#define CRASHPAD_MINIDUMP_MINIDUMP_IDENTICAL_THREAD_WRITER_H_
+
+#include <stdint.h>
+#include <sys/types.h>
+
+#include <map>
+#include <vector>
+
+#include "minidump/minidump_extensions.h"
+#include "minidump/minidump_stream_writer.h"
+#include "minidump/minidump_thread_id_map.h"
+#include "minidump/minidump_writable.h"
+
+namespace crashpad {
+
+class ThreadSnapshot;
+
+//! \brief The writer for a MinidumpIdenticalThreadList stream in a minidump
+//!     file, containing a list of MinidumpIdenticalThread objects.
+class MinidumpIdenticalThreadListWriter final
+    : public internal::MinidumpStreamWriter {
+ public:
+  MinidumpIdenticalThreadListWriter();
+
+  MinidumpIdenticalThreadListWriter(const MinidumpIdenticalThreadListWriter&) =
+      delete;
+  MinidumpIdenticalThreadListWriter& operator=(
+      const MinidumpIdenticalThreadListWriter&) = delete;
+
+  ~MinidumpIdenticalThreadListWriter() override;
+
+  //! \brief Finds the threads in \a thread_snapshots whose stacks are
+  //!     identical to the stack of an earlier thread.
+  //!
+  //! Each thread is fingerprinted by its instruction pointer, its stack
+  //! pointer’s offset into its stack, and a hash of its stack’s contents in
+  //! which values that point into the stack, or into the thread-local storage
+  //! that pthreads keeps just past it, are replaced by their offsets from the
+  //! start of the stack. Threads without a stack, or whose stack can’t be read,
+  //! are never considered identical to another.
+  //!
+  //! \param[in] thread_snapshots The thread snapshots to examine.
+  //! \param[out] identical_threads A map from the ThreadSnapshot::ThreadID() of
+  //!     each thread whose stack is identical to that of an earlier thread to
+  //!     the ID of the first thread with that stack. This map must be empty
+  //!     when this method is called.
+  static void FindIdenticalThreads(
+      const std::vector<const ThreadSnapshot*>& thread_snapshots,
+      std::map<uint64_t, uint64_t>* identical_threads);
+
+  //! \brief Adds a MinidumpIdenticalThread for each thread in \a
+  //!     identical_threads.
+  //!
+  //! \param[in] identical_threads A map built by FindIdenticalThreads().
+  //! \param[in] thread_id_map A MinidumpThreadIDMap previously built by
+  //!     MinidumpThreadListWriter::InitializeFromSnapshot().
+  //!
+  //! \note Valid in #kStateMutable.
+  void InitializeFromIdenticalThreads(
+      const std::map<uint64_t, uint64_t>& identical_threads,
+      const MinidumpThreadIDMap& thread_id_map);
+
+  //! \brief Adds \a identical_thread to the MinidumpIdenticalThreadList.
+  //!
+  //! \note Valid in #kStateMutable.
+  void AddIdenticalThread(const MinidumpIdenticalThread& identical_thread);
+
+  //! \brief Determines whether the object is useful.
+  //!
+  //! A useful object is one that lists at least one thread. Because this
+  //! stream is an extension, it need not be written when it is not useful.
+  //!
+  //! \return `true` if the object is useful, `false` otherwise.
+  bool IsUseful() const { return !items_.empty(); }
+
+ protected:
+  // MinidumpWritable:
+  bool Freeze() override;
+  size_t SizeOfObject() override;
+  std::vector<internal::MinidumpWritable*> Children() override;
+  bool WriteObject(FileWriterInterface* file_writer) override;
+
+  // MinidumpStreamWriter:
+  MinidumpStreamType StreamType() const override;
+
+ private:
+  MinidumpIdenticalThreadList identical_thread_list_base_;
+  std::vector<MinidumpIdenticalThread> items_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_MINIDUMP_MINIDUMP_IDENTICAL_THREAD_WRITER_H_
@@ -0,0 +1,196 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "minidump/minidump_identical_thread_writer.h"
+
+#include <string.h>
+
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "minidump/minidump_file_writer.h"
+#include "minidump/test/minidump_file_writer_test_util.h"
+#include "minidump/test/minidump_writable_test_util.h"
+#include "snapshot/test/test_cpu_context.h"
+#include "snapshot/test/test_memory_snapshot.h"
+#include "snapshot/test/test_thread_snapshot.h"
+#include "util/file/string_file.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+// The identical thread list is expected to be the only stream.
+void GetIdenticalThreadListStream(
+    const std::string& file_contents,
+    const MinidumpIdenticalThreadList** identical_thread_list) {
+  constexpr size_t kDirectoryOffset = sizeof(MINIDUMP_HEADER);
+  constexpr size_t kIdenticalThreadListStreamOffset =
+      kDirectoryOffset + sizeof(MINIDUMP_DIRECTORY);
+
+  const MINIDUMP_DIRECTORY* directory;
+  const MINIDUMP_HEADER* header =
+      MinidumpHeaderAtStart(file_contents, &directory);
+  ASSERT_NO_FATAL_FAILURE(VerifyMinidumpHeader(header, 1, 0));
+  ASSERT_TRUE(directory);
+
+  constexpr size_t kDirectoryIndex = 0;
+
+  ASSERT_EQ(directory[kDirectoryIndex].StreamType,
+            kMinidumpStreamTypeCrashpadIdenticalThreads);
+  EXPECT_EQ(directory[kDirectoryIndex].Location.Rva,
+            kIdenticalThreadListStreamOffset);
+
+  *identical_thread_list =
+      MinidumpWritableAtLocationDescriptor<MinidumpIdenticalThreadList>(
+          file_contents, directory[kDirectoryIndex].Location);
+  ASSERT_TRUE(*identical_thread_list);
+}
+
+std::unique_ptr<TestThreadSnapshot> MakeThreadSnapshot(uint64_t thread_id,
+                                                       uint32_t context_seed,
+                                                       uint64_t stack_address,
+                                                       size_t stack_size,
+                                                       char stack_value) {
+  auto thread_snapshot = std::make_unique<TestThreadSnapshot>();
+  thread_snapshot->SetThreadID(thread_id);
+  InitializeCPUContextX86_64(thread_snapshot->MutableContext(), context_seed);
+  auto stack = std::make_unique<TestMemorySnapshot>();
+  stack->SetAddress(stack_address);
+  stack->SetSize(stack_size);
+  stack->SetValue(stack_value);
+  thread_snapshot->SetStack(std::move(stack));
+  return thread_snapshot;
+}
+
+TEST(MinidumpIdenticalThreadWriter, Empty) {
+  MinidumpFileWriter minidump_file_writer;
+  auto identical_thread_list_writer =
+      std::make_unique<MinidumpIdenticalThreadListWriter>();
+  EXPECT_FALSE(identical_thread_list_writer->IsUseful());
+  ASSERT_TRUE(
+      minidump_file_writer.AddStream(std::move(identical_thread_list_writer)));
+
+  StringFile string_file;
+  ASSERT_TRUE(minidump_file_writer.WriteEverything(&string_file));
+
+  ASSERT_EQ(string_file.string().size(),
+            sizeof(MINIDUMP_HEADER) + sizeof(MINIDUMP_DIRECTORY) +
+                sizeof(MinidumpIdenticalThreadList));
+
+  const MinidumpIdenticalThreadList* identical_thread_list = nullptr;
+  ASSERT_NO_FATAL_FAILURE(GetIdenticalThreadListStream(
+      string_file.string(), &identical_thread_list));
+
+  EXPECT_EQ(identical_thread_list->SizeOfHeader,
+            sizeof(MinidumpIdenticalThreadList));
+  EXPECT_EQ(identical_thread_list->SizeOfEntry,
+            sizeof(MinidumpIdenticalThread));
+  EXPECT_EQ(identical_thread_list->NumberOfEntries, 0u);
+}
+
+TEST(MinidumpIdenticalThreadWriter, FindIdenticalThreads) {
+  constexpr uint64_t kThreadID0 = 0x1111111111111111;
+  constexpr uint64_t kThreadID1 = 0x2222222222222222;
+  constexpr uint64_t kThreadID2 = 0x3333333333333333;
+  constexpr uint64_t kThreadID3 = 0x4444444444444444;
+  constexpr uint64_t kThreadID4 = 0x5555555555555555;
+  constexpr uint64_t kThreadID5 = 0x6666666666666666;
+  constexpr size_t kStackSize = 0x1000;
+
+  // The third and sixth threads are identical to the first. The second has
+  // different stack contents, the fourth is somewhere else, and the fifth has
+  // a stack that can’t be read.
+  std::vector<std::unique_ptr<TestThreadSnapshot>> thread_snapshots_owner;
+  thread_snapshots_owner.push_back(
+      MakeThreadSnapshot(kThreadID0, 1, 0x7fff00000000, kStackSize, 'a'));
+  thread_snapshots_owner.push_back(
+      MakeThreadSnapshot(kThreadID1, 1, 0x7fff00010000, kStackSize, 'b'));
+  thread_snapshots_owner.push_back(
+      MakeThreadSnapshot(kThreadID2, 1, 0x7fff00020000, kStackSize, 'a'));
+  thread_snapshots_owner.push_back(
+      MakeThreadSnapshot(kThreadID3, 2, 0x7fff00030000, kStackSize, 'a'));
+  thread_snapshots_owner.push_back(
+      MakeThreadSnapshot(kThreadID4, 1, 0x7fff00040000, kStackSize, 'a'));
+  auto unreadable_stack = std::make_unique<TestMemorySnapshot>();
+  unreadable_stack->SetAddress(0x7fff00040000);
+  unreadable_stack->SetSize(kStackSize);
+  unreadable_stack->SetShouldFailRead(true);
+  thread_snapshots_owner.back()->SetStack(std::move(unreadable_stack));
+  thread_snapshots_owner.push_back(
+      MakeThreadSnapshot(kThreadID5, 1, 0x7fff00050000, kStackSize, 'a'));
+  std::vector<const ThreadSnapshot*> thread_snapshots;
+  for (const auto& thread_snapshot : thread_snapshots_owner) {
+    thread_snapshots.push_back(thread_snapshot.get());
+  }
+
+  std::map<uint64_t, uint64_t> identical_threads;
+  MinidumpIdenticalThreadListWriter::FindIdenticalThreads(thread_snapshots,
+                                                          &identical_threads);
+  const std::map<uint64_t, uint64_t> expected_identical_threads = {
+      {kThreadID2, kThreadID0},
+      {kThreadID5, kThreadID0},
+  };
+  EXPECT_EQ(identical_threads, expected_identical_threads);
+
+  MinidumpThreadIDMap thread_id_map;
+  thread_id_map[kThreadID0] = 0;
+  thread_id_map[kThreadID1] = 1;
+  thread_id_map[kThreadID2] = 2;
+  thread_id_map[kThreadID3] = 3;
+  thread_id_map[kThreadID4] = 4;
+  thread_id_map[kThreadID5] = 5;
+
+  MinidumpFileWriter minidump_file_writer;
+  auto identical_thread_list_writer =
+      std::make_unique<MinidumpIdenticalThreadListWriter>();
+  identical_thread_list_writer->InitializeFromIdenticalThreads(
+      identical_threads, thread_id_map);
+  EXPECT_TRUE(identical_thread_list_writer->IsUseful());
+  ASSERT_TRUE(
+      minidump_file_writer.AddStream(std::move(identical_thread_list_writer)));
+
+  StringFile string_file;
+  ASSERT_TRUE(minidump_file_writer.WriteEverything(&string_file));
+
+  ASSERT_EQ(string_file.string().size(),
+            sizeof(MINIDUMP_HEADER) + sizeof(MINIDUMP_DIRECTORY) +
+                sizeof(MinidumpIdenticalThreadList) +
+                2 * sizeof(MinidumpIdenticalThread));
+
+  const MinidumpIdenticalThreadList* identical_thread_list = nullptr;
+  ASSERT_NO_FATAL_FAILURE(GetIdenticalThreadListStream(
+      string_file.string(), &identical_thread_list));
+  ASSERT_EQ(identical_thread_list->NumberOfEntries, 2u);
+
+  MinidumpIdenticalThread identical_thread;
+  memcpy(&identical_thread,
+         &identical_thread_list->Entries[0],
+         sizeof(identical_thread));
+  EXPECT_EQ(identical_thread.ThreadId, 2u);
+  EXPECT_EQ(identical_thread.RepresentativeThreadId, 0u);
+  memcpy(&identical_thread,
+         &identical_thread_list->Entries[1],
+         sizeof(identical_thread));
+  EXPECT_EQ(identical_thread.ThreadId, 5u);
+  EXPECT_EQ(identical_thread.RepresentativeThreadId, 0u);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
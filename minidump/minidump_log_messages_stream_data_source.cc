@@ -0,0 +1,40 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "minidump/minidump_log_messages_stream_data_source.h"
+
+#include "minidump/minidump_extensions.h"
+#include "util/thread/thread_log_messages.h"
+
+namespace crashpad {
+
+MinidumpLogMessagesStreamDataSource::MinidumpLogMessagesStreamDataSource(
+    const ThreadLogMessages& thread_log_messages)
+    : MinidumpUserExtensionStreamDataSource(
+          kMinidumpStreamTypeCrashpadLogMessages),
+      log_text_(thread_log_messages.LogText()) {}
+
+MinidumpLogMessagesStreamDataSource::~MinidumpLogMessagesStreamDataSource() =
+    default;
+
+size_t MinidumpLogMessagesStreamDataSource::StreamDataSize() {
+  return log_text_.size();
+}
+
+bool MinidumpLogMessagesStreamDataSource::ReadStreamData(Delegate* delegate) {
+  return delegate->ExtensionStreamDataSourceRead(
+      log_text_.empty() ? nullptr : log_text_.data(), log_text_.size());
+}
+
+}  // namespace crashpad
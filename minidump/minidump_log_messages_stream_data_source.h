@@ -0,0 +1,61 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_MINIDUMP_MINIDUMP_LOG_MESSAGES_STREAM_DATA_SOURCE_H_
+#define CRASHPAD_MINIDUMP_MINIDUMP_LOG_MESSAGES_STREAM_DATA_SOURCE_H_
+
+#include <sys/types.h>
+
+#include <string>
+
+#include "minidump/minidump_user_extension_stream_data_source.h"
+
+namespace crashpad {
+
+class ThreadLogMessages;
+
+//! \brief A user extension stream data source that carries the log messages
+//!     captured by a ThreadLogMessages object.
+//!
+//! The stream has type ::kMinidumpStreamTypeCrashpadLogMessages. Add it to a
+//! minidump with MinidumpFileWriter::AddUserExtensionStream().
+class MinidumpLogMessagesStreamDataSource final
+    : public MinidumpUserExtensionStreamDataSource {
+ public:
+  //! \brief Takes a copy of the messages captured so far by \a
+  //!     thread_log_messages.
+  //!
+  //! This must be called on the thread that \a thread_log_messages was created
+  //! on. Messages logged after this is called aren’t included in the stream.
+  explicit MinidumpLogMessagesStreamDataSource(
+      const ThreadLogMessages& thread_log_messages);
+
+  MinidumpLogMessagesStreamDataSource(
+      const MinidumpLogMessagesStreamDataSource&) = delete;
+  MinidumpLogMessagesStreamDataSource& operator=(
+      const MinidumpLogMessagesStreamDataSource&) = delete;
+
+  ~MinidumpLogMessagesStreamDataSource() override;
+
+  // MinidumpUserExtensionStreamDataSource:
+  size_t StreamDataSize() override;
+  bool ReadStreamData(Delegate* delegate) override;
+
+ private:
+  std::string log_text_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_MINIDUMP_MINIDUMP_LOG_MESSAGES_STREAM_DATA_SOURCE_H_
@@ -0,0 +1,78 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "minidump/minidump_log_messages_stream_data_source.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "base/logging.h"
+#include "gtest/gtest.h"
+#include "minidump/minidump_extensions.h"
+#include "minidump/minidump_file_writer.h"
+#include "minidump/test/minidump_file_writer_test_util.h"
+#include "minidump/test/minidump_writable_test_util.h"
+#include "util/file/string_file.h"
+#include "util/thread/thread_log_messages.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+TEST(MinidumpLogMessagesStreamDataSource, LogMessages) {
+  // Logging must be enabled at least at this level for this test to work.
+  ASSERT_TRUE(LOG_IS_ON(WARNING));
+
+  MinidumpFileWriter minidump_file;
+  constexpr time_t kTimestamp = 0x155d2fb8;
+  minidump_file.SetTimestamp(kTimestamp);
+
+  std::string expected_log_text;
+  {
+    ThreadLogMessages thread_log_messages;
+    LOG(WARNING) << "first message";
+    LOG(WARNING) << "second message";
+    expected_log_text = thread_log_messages.LogText();
+
+    ASSERT_TRUE(minidump_file.AddUserExtensionStream(
+        std::make_unique<MinidumpLogMessagesStreamDataSource>(
+            thread_log_messages)));
+  }
+  ASSERT_FALSE(expected_log_text.empty());
+  EXPECT_NE(expected_log_text.find("first message\n"), std::string::npos);
+  EXPECT_NE(expected_log_text.find("second message\n"), std::string::npos);
+
+  StringFile string_file;
+  ASSERT_TRUE(minidump_file.WriteEverything(&string_file));
+
+  const MINIDUMP_DIRECTORY* directory;
+  const MINIDUMP_HEADER* header =
+      MinidumpHeaderAtStart(string_file.string(), &directory);
+  ASSERT_NO_FATAL_FAILURE(VerifyMinidumpHeader(header, 1, kTimestamp));
+  ASSERT_TRUE(directory);
+
+  EXPECT_EQ(directory[0].StreamType, kMinidumpStreamTypeCrashpadLogMessages);
+  ASSERT_EQ(directory[0].Location.DataSize, expected_log_text.size());
+
+  const char* stream_data = MinidumpWritableAtLocationDescriptor<char>(
+      string_file.string(), directory[0].Location);
+  ASSERT_TRUE(stream_data);
+  EXPECT_EQ(std::string(stream_data, directory[0].Location.DataSize),
+            expected_log_text);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
@@ -0,0 +1,229 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "minidump/minidump_memory64_list_writer.h"
+
+#include <utility>
+#include <vector>
+
+#include "base/check_op.h"
+#include "base/logging.h"
+#include "minidump/minidump_memory_writer.h"
+#include "snapshot/memory_snapshot.h"
+#include "util/file/file_writer.h"
+
+namespace crashpad {
+
+namespace {
+
+// Memory that can’t be read is written as this value, as it is by
+// SnapshotMinidumpMemoryWriter.
+constexpr uint8_t kUnreadableFill = 0xfe;
+
+// Writes the data of a memory snapshot that doesn’t support
+// MemorySnapshot::ReadRange() as it is read.
+class WritingDelegate final : public MemorySnapshot::Delegate {
+ public:
+  explicit WritingDelegate(FileWriterInterface* file_writer)
+      : file_writer_(file_writer), write_failed_(false) {}
+
+  WritingDelegate(const WritingDelegate&) = delete;
+  WritingDelegate& operator=(const WritingDelegate&) = delete;
+
+  ~WritingDelegate() override {}
+
+  bool write_failed() const { return write_failed_; }
+
+  // MemorySnapshot::Delegate:
+  bool MemorySnapshotDelegateRead(void* data, size_t size) override {
+    write_failed_ = !file_writer_->Write(data, size);
+    return !write_failed_;
+  }
+
+ private:
+  FileWriterInterface* file_writer_;  // weak
+  bool write_failed_;
+};
+
+}  // namespace
+
+// The data of every memory region in the list, written one region after
+// another with no padding between them.
+class MinidumpMemory64ListWriter::DataWriter final
+    : public internal::MinidumpWritable {
+ public:
+  DataWriter() : MinidumpWritable(), memory_snapshots_(), size_(0) {}
+
+  DataWriter(const DataWriter&) = delete;
+  DataWriter& operator=(const DataWriter&) = delete;
+
+  ~DataWriter() override {}
+
+  void AddSnapshot(const MemorySnapshot* memory_snapshot) {
+    DCHECK_EQ(state(), kStateMutable);
+    memory_snapshots_.push_back(memory_snapshot);
+  }
+
+ protected:
+  // MinidumpWritable:
+
+  bool Freeze() override {
+    DCHECK_EQ(state(), kStateMutable);
+
+    if (!MinidumpWritable::Freeze()) {
+      return false;
+    }
+
+    size_ = 0;
+    for (const MemorySnapshot* memory_snapshot : memory_snapshots_) {
+      const size_t size = size_ + memory_snapshot->Size();
+      if (size < size_) {
+        LOG(ERROR) << "memory size out of range";
+        return false;
+      }
+      size_ = size;
+    }
+
+    return true;
+  }
+
+  size_t SizeOfObject() override {
+    DCHECK_GE(state(), kStateFrozen);
+    return size_;
+  }
+
+  size_t Alignment() override {
+    DCHECK_GE(state(), kStateFrozen);
+
+    // As for SnapshotMinidumpMemoryWriter.
+    return 16;
+  }
+
+  Phase WritePhase() override { return kPhaseLate; }
+
+  bool WriteObject(FileWriterInterface* file_writer) override {
+    DCHECK_EQ(state(), kStateWritable);
+
+    for (const MemorySnapshot* memory_snapshot : memory_snapshots_) {
+      if (memory_snapshot->SupportsReadRange()) {
+        if (!internal::WriteMemorySnapshotStreamed(memory_snapshot,
+                                                   file_writer)) {
+          return false;
+        }
+        continue;
+      }
+
+      WritingDelegate delegate(file_writer);
+      if (!memory_snapshot->Read(&delegate)) {
+        if (delegate.write_failed()) {
+          return false;
+        }
+
+        // Keep the data of later regions where the descriptors say it is.
+        std::vector<uint8_t> filler(memory_snapshot->Size(), kUnreadableFill);
+        if (!file_writer->Write(filler.data(), filler.size())) {
+          return false;
+        }
+      }
+    }
+
+    return true;
+  }
+
+ private:
+  std::vector<const MemorySnapshot*> memory_snapshots_;  // weak
+  size_t size_;
+};
+
+MinidumpMemory64ListWriter::MinidumpMemory64ListWriter()
+    : MinidumpStreamWriter(),
+      memory64_list_base_(),
+      memory_descriptors_(),
+      base_rva_(0),
+      data_writer_(std::make_unique<DataWriter>()) {}
+
+MinidumpMemory64ListWriter::~MinidumpMemory64ListWriter() {}
+
+void MinidumpMemory64ListWriter::AddFromSnapshot(
+    const std::vector<const MemorySnapshot*>& memory_snapshots) {
+  DCHECK_EQ(state(), kStateMutable);
+
+  for (const MemorySnapshot* memory_snapshot : memory_snapshots) {
+    if (memory_snapshot->Size() == 0) {
+      continue;
+    }
+
+    MINIDUMP_MEMORY_DESCRIPTOR64 memory_descriptor;
+    memory_descriptor.StartOfMemoryRange = memory_snapshot->Address();
+    memory_descriptor.DataSize = memory_snapshot->Size();
+    memory_descriptors_.push_back(memory_descriptor);
+    data_writer_->AddSnapshot(memory_snapshot);
+  }
+}
+
+bool MinidumpMemory64ListWriter::Freeze() {
+  DCHECK_EQ(state(), kStateMutable);
+
+  if (!MinidumpStreamWriter::Freeze()) {
+    return false;
+  }
+
+  memory64_list_base_.NumberOfMemoryRanges = memory_descriptors_.size();
+
+  // BaseRva can’t be registered directly, because it’s a member of a packed
+  // structure. It’s copied into place once known in WriteObject().
+  data_writer_->RegisterRVA(&base_rva_);
+
+  return true;
+}
+
+size_t MinidumpMemory64ListWriter::SizeOfObject() {
+  DCHECK_GE(state(), kStateFrozen);
+
+  return sizeof(memory64_list_base_) +
+         memory_descriptors_.size() * sizeof(memory_descriptors_[0]);
+}
+
+std::vector<internal::MinidumpWritable*>
+MinidumpMemory64ListWriter::Children() {
+  DCHECK_GE(state(), kStateFrozen);
+
+  return std::vector<MinidumpWritable*>(1, data_writer_.get());
+}
+
+bool MinidumpMemory64ListWriter::WriteObject(
+    FileWriterInterface* file_writer) {
+  DCHECK_EQ(state(), kStateWritable);
+
+  memory64_list_base_.BaseRva = base_rva_;
+
+  WritableIoVec iov;
+  iov.iov_base = &memory64_list_base_;
+  iov.iov_len = sizeof(memory64_list_base_);
+  std::vector<WritableIoVec> iovecs(1, iov);
+
+  if (!memory_descriptors_.empty()) {
+    iov.iov_base = &memory_descriptors_[0];
+    iov.iov_len = memory_descriptors_.size() * sizeof(memory_descriptors_[0]);
+    iovecs.push_back(iov);
+  }
+
+  return file_writer->WriteIoVec(&iovecs);
+}
+
+MinidumpStreamType MinidumpMemory64ListWriter::StreamType() const {
+  return kMinidumpStreamTypeMemory64List;
+}
+
+}  // namespace crashpad
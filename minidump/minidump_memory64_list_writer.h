@@ -0,0 +1,93 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_MINIDUMP_MINIDUMP_MEMORY64_LIST_WRITER_H_
+#define CRASHPAD_MINIDUMP_MINIDUMP_MEMORY64_LIST_WRITER_H_
+
+#include <windows.h>
+#include <dbghelp.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+#include <memory>
+#include <vector>
+
+#include "minidump/minidump_stream_writer.h"
+#include "minidump/minidump_writable.h"
+
+namespace crashpad {
+
+class MemorySnapshot;
+
+//! \brief The writer for a MINIDUMP_MEMORY64_LIST stream in a minidump file,
+//!     containing a list of MINIDUMP_MEMORY_DESCRIPTOR64 objects.
+//!
+//! This stream is used for full-memory minidump files, whose memory may be too
+//! large to be addressed by the ::RVA fields of a MINIDUMP_MEMORY_LIST. The
+//! data of every region is written contiguously, following everything else in
+//! the minidump file other than objects written in
+//! internal::MinidumpWritable::kPhaseLast. This stream must be the last stream
+//! added to its MinidumpFileWriter, so that its data follows that of every
+//! other stream.
+//!
+//! Each region’s data is read from its MemorySnapshot as it is written, through
+//! a buffer of bounded size where the snapshot supports
+//! MemorySnapshot::ReadRange(), so that the memory needed to write the stream
+//! doesn’t depend on the amount of memory being written.
+class MinidumpMemory64ListWriter final
+    : public internal::MinidumpStreamWriter {
+ public:
+  MinidumpMemory64ListWriter();
+
+  MinidumpMemory64ListWriter(const MinidumpMemory64ListWriter&) = delete;
+  MinidumpMemory64ListWriter& operator=(const MinidumpMemory64ListWriter&) =
+      delete;
+
+  ~MinidumpMemory64ListWriter() override;
+
+  //! \brief Adds a MINIDUMP_MEMORY_DESCRIPTOR64 for each memory snapshot in
+  //!     \a memory_snapshots to the MINIDUMP_MEMORY64_LIST.
+  //!
+  //! Empty snapshots are skipped. The snapshots are written in the order that
+  //! they are given, and are not coalesced. Ownership of the snapshots is not
+  //! taken, and they must outlive this object.
+  //!
+  //! \param[in] memory_snapshots The memory snapshots to use as source data.
+  //!
+  //! \note Valid in #kStateMutable.
+  void AddFromSnapshot(
+      const std::vector<const MemorySnapshot*>& memory_snapshots);
+
+ protected:
+  // MinidumpWritable:
+  bool Freeze() override;
+  size_t SizeOfObject() override;
+  std::vector<MinidumpWritable*> Children() override;
+  bool WriteObject(FileWriterInterface* file_writer) override;
+
+  // MinidumpStreamWriter:
+  MinidumpStreamType StreamType() const override;
+
+ private:
+  class DataWriter;
+
+  MINIDUMP_MEMORY64_LIST memory64_list_base_;
+  std::vector<MINIDUMP_MEMORY_DESCRIPTOR64> memory_descriptors_;
+  RVA64 base_rva_;
+  std::unique_ptr<DataWriter> data_writer_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_MINIDUMP_MINIDUMP_MEMORY64_LIST_WRITER_H_
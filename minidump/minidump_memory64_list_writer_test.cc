@@ -0,0 +1,147 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "minidump/minidump_memory64_list_writer.h"
+
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "minidump/minidump_extensions.h"
+#include "minidump/minidump_file_writer.h"
+#include "minidump/minidump_stream_writer.h"
+#include "minidump/test/minidump_file_writer_test_util.h"
+#include "snapshot/test/test_memory_snapshot.h"
+#include "util/file/string_file.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+constexpr MinidumpStreamType kBogusStreamType =
+    static_cast<MinidumpStreamType>(1234);
+
+class TestStream final : public internal::MinidumpStreamWriter {
+ public:
+  TestStream() : internal::MinidumpStreamWriter() {}
+
+  TestStream(const TestStream&) = delete;
+  TestStream& operator=(const TestStream&) = delete;
+
+  ~TestStream() override {}
+
+ protected:
+  // MinidumpStreamWriter:
+  size_t SizeOfObject() override { return 0; }
+  bool WriteObject(FileWriterInterface* file_writer) override { return true; }
+  MinidumpStreamType StreamType() const override { return kBogusStreamType; }
+};
+
+// Finds the MINIDUMP_MEMORY64_LIST in file_contents, which must be the last of
+// expected_streams streams.
+void GetMemory64ListStream(const std::string& file_contents,
+                           uint32_t expected_streams,
+                           const MINIDUMP_HEADER** header,
+                           const MINIDUMP_MEMORY64_LIST** memory64_list) {
+  const MINIDUMP_DIRECTORY* directory;
+  *header = MinidumpHeaderAtStart(file_contents, &directory);
+  ASSERT_TRUE(*header);
+  ASSERT_EQ((*header)->NumberOfStreams, expected_streams);
+  ASSERT_TRUE(directory);
+
+  const MINIDUMP_DIRECTORY& memory64_list_directory =
+      directory[expected_streams - 1];
+  ASSERT_EQ(memory64_list_directory.StreamType,
+            kMinidumpStreamTypeMemory64List);
+  ASSERT_GE(memory64_list_directory.Location.DataSize,
+            sizeof(MINIDUMP_MEMORY64_LIST));
+  ASSERT_LE(memory64_list_directory.Location.Rva +
+                memory64_list_directory.Location.DataSize,
+            file_contents.size());
+
+  *memory64_list = reinterpret_cast<const MINIDUMP_MEMORY64_LIST*>(
+      &file_contents[memory64_list_directory.Location.Rva]);
+  ASSERT_EQ(memory64_list_directory.Location.DataSize,
+            sizeof(MINIDUMP_MEMORY64_LIST) +
+                (*memory64_list)->NumberOfMemoryRanges *
+                    sizeof(MINIDUMP_MEMORY_DESCRIPTOR64));
+}
+
+TEST(MinidumpMemory64ListWriter, Empty) {
+  MinidumpFileWriter minidump_file_writer;
+  ASSERT_TRUE(minidump_file_writer.AddFullMemory({}));
+
+  StringFile string_file;
+  ASSERT_TRUE(minidump_file_writer.WriteEverything(&string_file));
+
+  const MINIDUMP_HEADER* header;
+  const MINIDUMP_MEMORY64_LIST* memory64_list;
+  ASSERT_NO_FATAL_FAILURE(GetMemory64ListStream(
+      string_file.string(), 1, &header, &memory64_list));
+
+  EXPECT_EQ(header->Flags & MiniDumpWithFullMemory,
+            static_cast<uint64_t>(MiniDumpWithFullMemory));
+  EXPECT_EQ(memory64_list->NumberOfMemoryRanges, 0u);
+}
+
+TEST(MinidumpMemory64ListWriter, Regions) {
+  MinidumpFileWriter minidump_file_writer;
+  ASSERT_TRUE(minidump_file_writer.AddStream(std::make_unique<TestStream>()));
+
+  constexpr uint64_t kAddresses[] = {0x1000, 0x2000, 0x7fff0000};
+  constexpr size_t kSizes[] = {0x10, 0, 0x1001};
+  constexpr char kValues[] = {'a', 'b', 'c'};
+  TestMemorySnapshot memory_snapshots[3];
+  std::vector<const MemorySnapshot*> memory;
+  for (size_t index = 0; index < std::size(memory_snapshots); ++index) {
+    memory_snapshots[index].SetAddress(kAddresses[index]);
+    memory_snapshots[index].SetSize(kSizes[index]);
+    memory_snapshots[index].SetValue(kValues[index]);
+    memory.push_back(&memory_snapshots[index]);
+  }
+  ASSERT_TRUE(minidump_file_writer.AddFullMemory(memory));
+
+  StringFile string_file;
+  ASSERT_TRUE(minidump_file_writer.WriteEverything(&string_file));
+  const std::string& file_contents = string_file.string();
+
+  const MINIDUMP_HEADER* header;
+  const MINIDUMP_MEMORY64_LIST* memory64_list;
+  ASSERT_NO_FATAL_FAILURE(
+      GetMemory64ListStream(file_contents, 2, &header, &memory64_list));
+
+  EXPECT_EQ(header->Flags & MiniDumpWithFullMemory,
+            static_cast<uint64_t>(MiniDumpWithFullMemory));
+
+  // The empty region is skipped.
+  ASSERT_EQ(memory64_list->NumberOfMemoryRanges, 2u);
+  EXPECT_EQ(memory64_list->MemoryRanges[0].StartOfMemoryRange, kAddresses[0]);
+  EXPECT_EQ(memory64_list->MemoryRanges[0].DataSize, kSizes[0]);
+  EXPECT_EQ(memory64_list->MemoryRanges[1].StartOfMemoryRange, kAddresses[2]);
+  EXPECT_EQ(memory64_list->MemoryRanges[1].DataSize, kSizes[2]);
+
+  // The data is contiguous, and is the last thing in the file.
+  const uint64_t base_rva = memory64_list->BaseRva;
+  EXPECT_EQ(base_rva + kSizes[0] + kSizes[2], file_contents.size());
+  EXPECT_EQ(file_contents.substr(base_rva, kSizes[0]),
+            std::string(kSizes[0], kValues[0]));
+  EXPECT_EQ(file_contents.substr(base_rva + kSizes[0], kSizes[2]),
+            std::string(kSizes[2], kValues[2]));
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
@@ -14,6 +14,8 @@
 
 #include "minidump/minidump_memory_info_writer.h"
 
+#include <utility>
+
 #include "base/check_op.h"
 #include "snapshot/memory_map_region_snapshot.h"
 #include "util/file/file_writer.h"
@@ -36,6 +38,34 @@ void MinidumpMemoryInfoListWriter::InitializeFromSnapshot(
     items_.push_back(region->AsMinidumpMemoryInfo());
 }
 
+void MinidumpMemoryInfoListWriter::InitializeFromMemoryInfo(
+    std::vector<MINIDUMP_MEMORY_INFO> memory_info,
+    bool merge_adjacent_regions) {
+  DCHECK_EQ(state(), kStateMutable);
+
+  DCHECK(items_.empty());
+  items_ = std::move(memory_info);
+  if (!merge_adjacent_regions || items_.empty()) {
+    return;
+  }
+
+  size_t merged_count = 1;
+  for (size_t index = 1; index < items_.size(); ++index) {
+    MINIDUMP_MEMORY_INFO& previous = items_[merged_count - 1];
+    const MINIDUMP_MEMORY_INFO& region = items_[index];
+    if (region.BaseAddress == previous.BaseAddress + previous.RegionSize &&
+        region.State == previous.State &&
+        region.Protect == previous.Protect &&
+        region.AllocationProtect == previous.AllocationProtect &&
+        region.Type == previous.Type) {
+      previous.RegionSize += region.RegionSize;
+    } else {
+      items_[merged_count++] = region;
+    }
+  }
+  items_.resize(merged_count);
+}
+
 bool MinidumpMemoryInfoListWriter::Freeze() {
   DCHECK_EQ(state(), kStateMutable);
 
@@ -69,9 +99,9 @@ bool MinidumpMemoryInfoListWriter::WriteObject(
   iov.iov_len = sizeof(memory_info_list_base_);
   std::vector<WritableIoVec> iovecs(1, iov);
 
-  for (const auto& minidump_memory_info : items_) {
-    iov.iov_base = &minidump_memory_info;
-    iov.iov_len = sizeof(minidump_memory_info);
+  if (!items_.empty()) {
+    iov.iov_base = &items_[0];
+    iov.iov_len = items_.size() * sizeof(items_[0]);
     iovecs.push_back(iov);
   }
 
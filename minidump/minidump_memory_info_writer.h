@@ -54,6 +54,20 @@ class MinidumpMemoryInfoListWriter final
   void InitializeFromSnapshot(
       const std::vector<const MemoryMapRegionSnapshot*>& memory_map);
 
+  //! \brief Initializes a MINIDUMP_MEMORY_INFO_LIST from \a memory_info
+  //!     directly, for producers that describe a large number of regions
+  //!     without a MemoryMapRegionSnapshot for each.
+  //!
+  //! \param[in] memory_info The regions, sorted by address.
+  //! \param[in] merge_adjacent_regions Whether to merge each region into the
+  //!     one before it when it begins where that one ends and has the same
+  //!     state, protection, and type. A merged region keeps the
+  //!     MINIDUMP_MEMORY_INFO::AllocationBase of the first region in it.
+  //!
+  //! \note Valid in #kStateMutable.
+  void InitializeFromMemoryInfo(std::vector<MINIDUMP_MEMORY_INFO> memory_info,
+                                bool merge_adjacent_regions);
+
  protected:
   // MinidumpWritable:
   bool Freeze() override;
@@ -17,6 +17,7 @@
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "gtest/gtest.h"
 #include "minidump/minidump_file_writer.h"
@@ -136,6 +137,63 @@ TEST(MinidumpMemoryInfoWriter, OneRegion) {
   EXPECT_EQ(memory_info.Type, mmi.Type);
 }
 
+TEST(MinidumpMemoryInfoWriter, MergeAdjacentRegions) {
+  MINIDUMP_MEMORY_INFO base = {};
+  base.State = MEM_COMMIT;
+  base.Protect = base.AllocationProtect = PAGE_READWRITE;
+  base.Type = MEM_PRIVATE;
+
+  // The first two regions merge. The third has a different protection, the
+  // fourth doesn’t begin where the third ends, and the fifth merges into it.
+  std::vector<MINIDUMP_MEMORY_INFO> memory_info(5, base);
+  const uint64_t kBaseAddresses[] = {
+      0x10000, 0x12000, 0x13000, 0x20000, 0x21000};
+  const uint64_t kSizes[] = {0x2000, 0x1000, 0x1000, 0x1000, 0x3000};
+  for (size_t index = 0; index < memory_info.size(); ++index) {
+    memory_info[index].BaseAddress = kBaseAddresses[index];
+    memory_info[index].AllocationBase = kBaseAddresses[index];
+    memory_info[index].RegionSize = kSizes[index];
+  }
+  memory_info[2].Protect = memory_info[2].AllocationProtect = PAGE_READONLY;
+
+  MinidumpFileWriter minidump_file_writer;
+  auto memory_info_list_writer =
+      std::make_unique<MinidumpMemoryInfoListWriter>();
+  memory_info_list_writer->InitializeFromMemoryInfo(memory_info, true);
+  ASSERT_TRUE(
+      minidump_file_writer.AddStream(std::move(memory_info_list_writer)));
+
+  StringFile string_file;
+  ASSERT_TRUE(minidump_file_writer.WriteEverything(&string_file));
+
+  ASSERT_EQ(string_file.string().size(),
+            sizeof(MINIDUMP_HEADER) + sizeof(MINIDUMP_DIRECTORY) +
+                sizeof(MINIDUMP_MEMORY_INFO_LIST) +
+                3 * sizeof(MINIDUMP_MEMORY_INFO));
+
+  const MINIDUMP_MEMORY_INFO_LIST* memory_info_list = nullptr;
+  ASSERT_NO_FATAL_FAILURE(
+      GetMemoryInfoListStream(string_file.string(), &memory_info_list));
+
+  uint64_t number_of_entries;
+  memcpy(&number_of_entries,
+         &memory_info_list->NumberOfEntries,
+         sizeof(number_of_entries));
+  ASSERT_EQ(number_of_entries, 3u);
+
+  MINIDUMP_MEMORY_INFO merged[3];
+  memcpy(merged, &memory_info_list[1], sizeof(merged));
+  EXPECT_EQ(merged[0].BaseAddress, 0x10000u);
+  EXPECT_EQ(merged[0].AllocationBase, 0x10000u);
+  EXPECT_EQ(merged[0].RegionSize, 0x3000u);
+  EXPECT_EQ(merged[0].Protect, static_cast<uint32_t>(PAGE_READWRITE));
+  EXPECT_EQ(merged[1].BaseAddress, 0x13000u);
+  EXPECT_EQ(merged[1].RegionSize, 0x1000u);
+  EXPECT_EQ(merged[1].Protect, static_cast<uint32_t>(PAGE_READONLY));
+  EXPECT_EQ(merged[2].BaseAddress, 0x20000u);
+  EXPECT_EQ(merged[2].RegionSize, 0x4000u);
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace crashpad
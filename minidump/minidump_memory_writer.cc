@@ -14,17 +14,168 @@
 
 #include "minidump/minidump_memory_writer.h"
 
+#include <string.h>
+
 #include <algorithm>
 #include <iterator>
+#include <memory>
 #include <utility>
 
 #include "base/auto_reset.h"
 #include "base/logging.h"
+#include "base/notreached.h"
 #include "util/file/file_writer.h"
 #include "util/numeric/safe_assignment.h"
 
 namespace crashpad {
 
+namespace {
+
+// Memory snapshots that support MemorySnapshot::ReadRange() are copied to the
+// file through a buffer of this size, so that the memory needed to write a
+// region doesn’t depend on the region’s size.
+constexpr size_t kStreamingBufferSize = 64 * 1024;
+
+// Memory that can’t be read is written as this value.
+constexpr uint8_t kUnreadableFill = 0xfe;
+
+// Returns a buffer of kStreamingBufferSize bytes. The same buffer is used for
+// every region streamed on the calling thread, so that writing a minidump
+// doesn’t allocate a new buffer for each region.
+uint8_t* StreamingBuffer() {
+  static thread_local std::unique_ptr<uint8_t[]> buffer;
+  if (!buffer) {
+    buffer.reset(new uint8_t[kStreamingBufferSize]);
+  }
+  return buffer.get();
+}
+
+// A MemorySnapshot of part of another MemorySnapshot. This is used for the
+// parts of an owned memory range that remain after removing those covered by
+// non-owned memory ranges.
+class MemorySnapshotSlice final : public MemorySnapshot {
+ public:
+  MemorySnapshotSlice(const MemorySnapshot* snapshot,
+                      size_t offset,
+                      size_t size)
+      : MemorySnapshot(), snapshot_(snapshot), offset_(offset), size_(size) {
+    DCHECK_LE(offset_, snapshot_->Size());
+    DCHECK_LE(size_, snapshot_->Size() - offset_);
+  }
+
+  MemorySnapshotSlice(const MemorySnapshotSlice&) = delete;
+  MemorySnapshotSlice& operator=(const MemorySnapshotSlice&) = delete;
+
+  ~MemorySnapshotSlice() override {}
+
+  // MemorySnapshot:
+
+  uint64_t Address() const override { return snapshot_->Address() + offset_; }
+
+  size_t Size() const override { return size_; }
+
+  bool Read(Delegate* delegate) const override {
+    if (snapshot_->SupportsReadRange()) {
+      std::unique_ptr<uint8_t[]> buffer(new uint8_t[size_]);
+      if (!snapshot_->ReadRange(offset_, size_, buffer.get())) {
+        return false;
+      }
+      return delegate->MemorySnapshotDelegateRead(buffer.get(), size_);
+    }
+
+    SliceDelegate slice_delegate(this, delegate);
+    return snapshot_->Read(&slice_delegate);
+  }
+
+  bool SupportsReadRange() const override {
+    return snapshot_->SupportsReadRange();
+  }
+
+  bool ReadRange(size_t offset, size_t size, void* buffer) const override {
+    DCHECK_LE(offset, size_);
+    DCHECK_LE(size, size_ - offset);
+    return snapshot_->ReadRange(offset_ + offset, size, buffer);
+  }
+
+  const MemorySnapshot* MergeWithOtherSnapshot(
+      const MemorySnapshot* other) const override {
+    // Slices are only created after owned memory has been coalesced.
+    NOTREACHED();
+    return nullptr;
+  }
+
+ private:
+  // Passes the slice’s part of the underlying snapshot’s data to delegate_.
+  class SliceDelegate final : public MemorySnapshot::Delegate {
+   public:
+    SliceDelegate(const MemorySnapshotSlice* slice, Delegate* delegate)
+        : slice_(slice), delegate_(delegate) {}
+
+    SliceDelegate(const SliceDelegate&) = delete;
+    SliceDelegate& operator=(const SliceDelegate&) = delete;
+
+    ~SliceDelegate() override {}
+
+    // MemorySnapshot::Delegate:
+    bool MemorySnapshotDelegateRead(void* data, size_t size) override {
+      DCHECK_EQ(size, slice_->snapshot_->Size());
+      return delegate_->MemorySnapshotDelegateRead(
+          static_cast<uint8_t*>(data) + slice_->offset_, slice_->size_);
+    }
+
+   private:
+    const MemorySnapshotSlice* slice_;
+    Delegate* delegate_;
+  };
+
+  const MemorySnapshot* snapshot_;  // weak
+  size_t offset_;
+  size_t size_;
+};
+
+}  // namespace
+
+namespace internal {
+
+bool WriteMemorySnapshotStreamed(const MemorySnapshot* memory_snapshot,
+                                 FileWriterInterface* file_writer) {
+  DCHECK(memory_snapshot->SupportsReadRange());
+
+  const uint64_t address = memory_snapshot->Address();
+  const size_t size = memory_snapshot->Size();
+  if (size == 0) {
+    return true;
+  }
+
+  uint8_t* const buffer = StreamingBuffer();
+  size_t offset = 0;
+  while (offset < size) {
+    // End each chunk at an address aligned to the buffer size, so that every
+    // chunk after the first begins on a pointer-aligned boundary.
+    const size_t chunk_size =
+        std::min(size - offset,
+                 kStreamingBufferSize -
+                     static_cast<size_t>((address + offset) %
+                                         kStreamingBufferSize));
+
+    if (!memory_snapshot->ReadRange(offset, chunk_size, buffer)) {
+      // As in SnapshotMinidumpMemoryWriter::WriteObject(), memory that can no
+      // longer be read is replaced with filler. Only this chunk is affected,
+      // and later chunks may still be readable.
+      memset(buffer, kUnreadableFill, chunk_size);
+    }
+
+    if (!file_writer->Write(buffer, chunk_size)) {
+      return false;
+    }
+    offset += chunk_size;
+  }
+
+  return true;
+}
+
+}  // namespace internal
+
 SnapshotMinidumpMemoryWriter::SnapshotMinidumpMemoryWriter(
     const MemorySnapshot* memory_snapshot)
     : internal::MinidumpWritable(),
@@ -48,6 +199,11 @@ bool SnapshotMinidumpMemoryWriter::WriteObject(
   DCHECK_EQ(state(), kStateWritable);
   DCHECK(!file_writer_);
 
+  if (memory_snapshot_->SupportsReadRange()) {
+    return internal::WriteMemorySnapshotStreamed(memory_snapshot_,
+                                                 file_writer);
+  }
+
   base::AutoReset<FileWriterInterface*> file_writer_reset(&file_writer_,
                                                           file_writer);
 
@@ -58,7 +214,7 @@ bool SnapshotMinidumpMemoryWriter::WriteObject(
     // would be nice to instead not include this memory, but at this point in
     // the writing process, it would be difficult to amend the minidump's
     // structure. See https://crashpad.chromium.org/234 for background.
-    std::vector<uint8_t> empty(memory_snapshot_->Size(), 0xfe);
+    std::vector<uint8_t> empty(memory_snapshot_->Size(), kUnreadableFill);
     MemorySnapshotDelegateRead(empty.data(), empty.size());
   }
 
@@ -172,8 +328,6 @@ void MinidumpMemoryListWriter::AddNonOwnedMemory(
 }
 
 void MinidumpMemoryListWriter::CoalesceOwnedMemory() {
-  DropRangesThatOverlapNonOwned();
-
   if (children_.empty())
     return;
 
@@ -217,6 +371,8 @@ void MinidumpMemoryListWriter::CoalesceOwnedMemory() {
     }
   }
   std::swap(children_, all_merged);
+
+  RemoveRangesCoveredByNonOwned();
 }
 
 bool MinidumpMemoryListWriter::Freeze() {
@@ -289,23 +445,82 @@ MinidumpStreamType MinidumpMemoryListWriter::StreamType() const {
   return kMinidumpStreamTypeMemoryList;
 }
 
-void MinidumpMemoryListWriter::DropRangesThatOverlapNonOwned() {
-  std::vector<std::unique_ptr<SnapshotMinidumpMemoryWriter>> non_overlapping;
-  non_overlapping.reserve(children_.size());
-  for (auto& child_ptr : children_) {
-    bool overlaps = false;
-    for (const auto* non_owned : non_owned_memory_writers_) {
-      if (DetermineMergedRange(child_ptr->UnderlyingSnapshot(),
-                               non_owned->UnderlyingSnapshot(),
-                               nullptr)) {
-        overlaps = true;
-        break;
+void MinidumpMemoryListWriter::RemoveRangesCoveredByNonOwned() {
+  // Collect the non-owned ranges as a sorted list of disjoint [begin, end)
+  // intervals.
+  std::vector<std::pair<uint64_t, uint64_t>> covered;
+  covered.reserve(non_owned_memory_writers_.size());
+  for (const SnapshotMinidumpMemoryWriter* non_owned :
+       non_owned_memory_writers_) {
+    const MemorySnapshot* snapshot = non_owned->UnderlyingSnapshot();
+    const uint64_t begin = snapshot->Address();
+    const uint64_t end = begin + snapshot->Size();
+    if (end > begin) {
+      covered.emplace_back(begin, end);
+    }
+  }
+  if (covered.empty()) {
+    return;
+  }
+  std::sort(covered.begin(), covered.end());
+  size_t covered_count = 1;
+  for (size_t index = 1; index < covered.size(); ++index) {
+    std::pair<uint64_t, uint64_t>& last = covered[covered_count - 1];
+    if (covered[index].first <= last.second) {
+      last.second = std::max(last.second, covered[index].second);
+    } else {
+      covered[covered_count++] = covered[index];
+    }
+  }
+  covered.resize(covered_count);
+
+  // children_ is sorted and disjoint, so both lists can be swept together.
+  // Each owned range is replaced by the parts of it that lie outside of every
+  // non-owned range, so that no byte is written to the minidump twice.
+  std::vector<std::unique_ptr<SnapshotMinidumpMemoryWriter>> remaining;
+  remaining.reserve(children_.size());
+  size_t first_covered = 0;
+  for (auto& child : children_) {
+    const MemorySnapshot* snapshot = child->UnderlyingSnapshot();
+    const uint64_t begin = snapshot->Address();
+    const uint64_t end = begin + snapshot->Size();
+
+    while (first_covered < covered.size() &&
+           covered[first_covered].second <= begin) {
+      ++first_covered;
+    }
+
+    std::vector<std::pair<uint64_t, uint64_t>> pieces;
+    uint64_t cursor = begin;
+    for (size_t index = first_covered;
+         index < covered.size() && covered[index].first < end;
+         ++index) {
+      if (covered[index].first > cursor) {
+        pieces.emplace_back(cursor, covered[index].first);
       }
+      cursor = std::max(cursor, covered[index].second);
+    }
+    if (cursor < end) {
+      pieces.emplace_back(cursor, end);
+    }
+
+    if (pieces.size() == 1 && pieces[0].first == begin &&
+        pieces[0].second == end) {
+      remaining.push_back(std::move(child));
+      continue;
+    }
+
+    for (const auto& piece : pieces) {
+      auto slice = std::make_unique<MemorySnapshotSlice>(
+          snapshot,
+          static_cast<size_t>(piece.first - begin),
+          static_cast<size_t>(piece.second - piece.first));
+      remaining.push_back(
+          std::make_unique<SnapshotMinidumpMemoryWriter>(slice.get()));
+      snapshots_created_during_merge_.push_back(std::move(slice));
     }
-    if (!overlaps)
-      non_overlapping.push_back(std::move(child_ptr));
   }
-  std::swap(children_, non_overlapping);
+  std::swap(children_, remaining);
 }
 
 }  // namespace crashpad
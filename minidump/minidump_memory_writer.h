@@ -30,6 +30,25 @@
 
 namespace crashpad {
 
+namespace internal {
+
+//! \brief Writes the data of \a memory_snapshot to \a file_writer in pieces,
+//!     through a buffer of bounded size, using MemorySnapshot::ReadRange().
+//!
+//! The buffer is shared by every region written on the calling thread. Pieces
+//! of the region that can’t be read are written as filler.
+//!
+//! \param[in] memory_snapshot The memory snapshot to write. It must support
+//!     MemorySnapshot::ReadRange().
+//! \param[in] file_writer The file writer to receive the data.
+//!
+//! \return `true` on success. `false` if the data could not be written, with
+//!     an appropriate message logged.
+bool WriteMemorySnapshotStreamed(const MemorySnapshot* memory_snapshot,
+                                 FileWriterInterface* file_writer);
+
+}  // namespace internal
+
 //! \brief The base class for writers of memory ranges pointed to by
 //!     MINIDUMP_MEMORY_DESCRIPTOR objects in a minidump file.
 class SnapshotMinidumpMemoryWriter : public internal::MinidumpWritable,
@@ -179,9 +198,9 @@ class MinidumpMemoryListWriter final : public internal::MinidumpStreamWriter {
   //! This is expected to be called once just before writing, generally from
   //! Freeze().
   //!
-  //! This function has the side-effect of merging owned ranges, dropping any
-  //! owned ranges that overlap with non-owned ranges, removing empty ranges,
-  //! and sorting all ranges by address.
+  //! This function has the side-effect of merging owned ranges, removing the
+  //! parts of owned ranges that are covered by non-owned ranges, removing
+  //! empty ranges, and sorting all ranges by address.
   //!
   //! Per its name, this coalesces owned memory, however, this is not a complete
   //! solution for ensuring that no overlapping memory ranges are emitted in the
@@ -194,8 +213,9 @@ class MinidumpMemoryListWriter final : public internal::MinidumpStreamWriter {
   void CoalesceOwnedMemory();
 
  private:
-  //! \brief Drops children_ ranges that overlap non_owned_memory_writers_.
-  void DropRangesThatOverlapNonOwned();
+  //! \brief Replaces each of the sorted, disjoint children_ ranges with the
+  //!     parts of it not covered by any of non_owned_memory_writers_.
+  void RemoveRangesCoveredByNonOwned();
 
   std::vector<SnapshotMinidumpMemoryWriter*> non_owned_memory_writers_;  // weak
   std::vector<std::unique_ptr<SnapshotMinidumpMemoryWriter>> children_;
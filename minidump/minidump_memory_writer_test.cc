@@ -230,6 +230,74 @@ TEST(MinidumpMemoryWriter, RegionReadFails) {
       true);
 }
 
+TEST(MinidumpMemoryWriter, StreamedRegions) {
+  MinidumpFileWriter minidump_file_writer;
+  auto memory_list_writer = std::make_unique<MinidumpMemoryListWriter>();
+
+  // These regions are larger than the buffer used to stream them and don’t
+  // start on an aligned address, so they are written in several pieces.
+  constexpr uint64_t kBaseAddress0 = 0x10000008;
+  constexpr size_t kSize0 = 0x30000;
+  constexpr uint8_t kValue0 = 's';
+  constexpr uint64_t kBaseAddress1 = 0x20000000;
+  constexpr size_t kSize1 = 0x24000;
+  constexpr uint8_t kValue1 = 't';
+
+  auto memory_writer_0 = std::make_unique<TestMinidumpMemoryWriter>(
+      kBaseAddress0, kSize0, kValue0);
+  memory_writer_0->SetSupportsReadRange(true);
+  memory_list_writer->AddMemory(std::move(memory_writer_0));
+
+  auto memory_writer_1 = std::make_unique<TestMinidumpMemoryWriter>(
+      kBaseAddress1, kSize1, kValue1);
+  memory_writer_1->SetSupportsReadRange(true);
+  memory_writer_1->SetShouldFailRead(true);
+  memory_list_writer->AddMemory(std::move(memory_writer_1));
+
+  ASSERT_TRUE(minidump_file_writer.AddStream(std::move(memory_list_writer)));
+
+  StringFile string_file;
+  ASSERT_TRUE(minidump_file_writer.WriteEverything(&string_file));
+
+  const MINIDUMP_MEMORY_LIST* memory_list = nullptr;
+  ASSERT_NO_FATAL_FAILURE(
+      GetMemoryListStream(string_file.string(), &memory_list, 1));
+
+  EXPECT_EQ(memory_list->NumberOfMemoryRanges, 2u);
+
+  MINIDUMP_MEMORY_DESCRIPTOR expected;
+
+  {
+    SCOPED_TRACE("region 0");
+
+    expected.StartOfMemoryRange = kBaseAddress0;
+    expected.Memory.DataSize = kSize0;
+    expected.Memory.Rva =
+        sizeof(MINIDUMP_HEADER) + sizeof(MINIDUMP_DIRECTORY) +
+        sizeof(MINIDUMP_MEMORY_LIST) +
+        memory_list->NumberOfMemoryRanges * sizeof(MINIDUMP_MEMORY_DESCRIPTOR);
+    ExpectMinidumpMemoryDescriptorAndContents(&expected,
+                                              &memory_list->MemoryRanges[0],
+                                              string_file.string(),
+                                              kValue0,
+                                              false);
+  }
+
+  {
+    SCOPED_TRACE("region 1");
+
+    expected.StartOfMemoryRange = kBaseAddress1;
+    expected.Memory.DataSize = kSize1;
+    expected.Memory.Rva = memory_list->MemoryRanges[0].Memory.Rva +
+                          memory_list->MemoryRanges[0].Memory.DataSize;
+    ExpectMinidumpMemoryDescriptorAndContents(&expected,
+                                              &memory_list->MemoryRanges[1],
+                                              string_file.string(),
+                                              0xfe,
+                                              true);
+  }
+}
+
 class TestMemoryStream final : public internal::MinidumpStreamWriter {
  public:
   TestMemoryStream(uint64_t base_address, size_t size, uint8_t value)
@@ -340,6 +408,99 @@ TEST(MinidumpMemoryWriter, ExtraMemory) {
   }
 }
 
+// Adds owned_ranges with AddFromSnapshot() alongside a non-owned range
+// [kStackBase, kStackBase + kStackSize), as for a thread’s stack, and tests
+// that the memory list holds the non-owned range followed by expected_ranges,
+// which are the parts of owned_ranges outside of the non-owned range.
+void RemoveCoveredTest(
+    const std::vector<std::pair<uint64_t, size_t>>& owned_ranges,
+    const std::vector<std::pair<uint64_t, size_t>>& expected_ranges,
+    bool supports_read_range) {
+  constexpr uint64_t kStackBase = 0x1000;
+  constexpr size_t kStackSize = 0x400;
+  constexpr uint8_t kStackValue = 's';
+  constexpr uint8_t kOwnedValue = 'o';
+
+  MinidumpFileWriter minidump_file_writer;
+  auto test_memory_stream =
+      std::make_unique<TestMemoryStream>(kStackBase, kStackSize, kStackValue);
+  auto memory_list_writer = std::make_unique<MinidumpMemoryListWriter>();
+  memory_list_writer->AddNonOwnedMemory(test_memory_stream->memory());
+  ASSERT_TRUE(minidump_file_writer.AddStream(std::move(test_memory_stream)));
+
+  std::vector<std::unique_ptr<TestMemorySnapshot>> memory_snapshots_owner;
+  std::vector<const MemorySnapshot*> memory_snapshots;
+  for (const auto& range : owned_ranges) {
+    memory_snapshots_owner.push_back(std::make_unique<TestMemorySnapshot>());
+    TestMemorySnapshot* memory_snapshot = memory_snapshots_owner.back().get();
+    memory_snapshot->SetAddress(range.first);
+    memory_snapshot->SetSize(range.second);
+    memory_snapshot->SetValue(kOwnedValue);
+    memory_snapshot->SetSupportsReadRange(supports_read_range);
+    memory_snapshots.push_back(memory_snapshot);
+  }
+  memory_list_writer->AddFromSnapshot(memory_snapshots);
+  ASSERT_TRUE(minidump_file_writer.AddStream(std::move(memory_list_writer)));
+
+  StringFile string_file;
+  ASSERT_TRUE(minidump_file_writer.WriteEverything(&string_file));
+
+  const MINIDUMP_MEMORY_LIST* memory_list = nullptr;
+  ASSERT_NO_FATAL_FAILURE(
+      GetMemoryListStream(string_file.string(), &memory_list, 2));
+  ASSERT_EQ(memory_list->NumberOfMemoryRanges, 1 + expected_ranges.size());
+
+  MINIDUMP_MEMORY_DESCRIPTOR expected = {};
+  expected.StartOfMemoryRange = kStackBase;
+  expected.Memory.DataSize = kStackSize;
+  ExpectMinidumpMemoryDescriptorAndContents(&expected,
+                                            &memory_list->MemoryRanges[0],
+                                            string_file.string(),
+                                            kStackValue,
+                                            false);
+
+  for (size_t index = 0; index < expected_ranges.size(); ++index) {
+    SCOPED_TRACE(base::StringPrintf("index %" PRIuS, index));
+    expected.StartOfMemoryRange = expected_ranges[index].first;
+    expected.Memory.DataSize =
+        static_cast<uint32_t>(expected_ranges[index].second);
+    ExpectMinidumpMemoryDescriptorAndContents(
+        &expected,
+        &memory_list->MemoryRanges[1 + index],
+        string_file.string(),
+        kOwnedValue,
+        false);
+  }
+}
+
+TEST(MinidumpMemoryWriter, RemoveCoveredByNonOwned) {
+  for (bool supports_read_range : {false, true}) {
+    SCOPED_TRACE(supports_read_range ? "ReadRange" : "Read");
+
+    // Ranges straddling either end of the non-owned range are trimmed, ranges
+    // within it are removed, and ranges apart from it are kept whole.
+    RemoveCoveredTest({{0x0e00, 0x300},
+                       {0x1100, 0x100},
+                       {0x1300, 0x300},
+                       {0x2000, 0x100}},
+                      {{0x0e00, 0x200}, {0x1400, 0x200}, {0x2000, 0x100}},
+                      supports_read_range);
+
+    // A range enclosing the non-owned range keeps the parts on either side.
+    RemoveCoveredTest({{0x0f00, 0x600}},
+                      {{0x0f00, 0x100}, {0x1400, 0x100}},
+                      supports_read_range);
+
+    // Ranges abutting the non-owned range are kept whole.
+    RemoveCoveredTest({{0x0f00, 0x100}, {0x1400, 0x100}},
+                      {{0x0f00, 0x100}, {0x1400, 0x100}},
+                      supports_read_range);
+
+    // A range equal to the non-owned range is removed.
+    RemoveCoveredTest({{0x1000, 0x400}}, {}, supports_read_range);
+  }
+}
+
 TEST(MinidumpMemoryWriter, AddFromSnapshot) {
   MINIDUMP_MEMORY_DESCRIPTOR expect_memory_descriptors[3] = {};
   uint8_t values[std::size(expect_memory_descriptors)] = {};
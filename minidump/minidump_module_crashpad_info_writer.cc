@@ -30,8 +30,10 @@ MinidumpModuleCrashpadInfoWriter::MinidumpModuleCrashpadInfoWriter()
       module_(),
       list_annotations_(),
       simple_annotations_(),
-      annotation_objects_() {
-  module_.version = MinidumpModuleCrashpadInfo::kVersion;
+      annotation_objects_(),
+      annotation_object_threads_() {
+  module_.version =
+      MinidumpModuleCrashpadInfo::kVersionWithoutAnnotationObjectThreads;
 }
 
 MinidumpModuleCrashpadInfoWriter::~MinidumpModuleCrashpadInfoWriter() {
@@ -57,10 +59,19 @@ void MinidumpModuleCrashpadInfoWriter::InitializeFromSnapshot(
     SetSimpleAnnotations(std::move(simple_annotations));
   }
 
+  const std::vector<AnnotationSnapshot> annotation_snapshots =
+      module_snapshot->AnnotationObjects();
   auto annotation_objects = std::make_unique<MinidumpAnnotationListWriter>();
-  annotation_objects->InitializeFromList(module_snapshot->AnnotationObjects());
+  annotation_objects->InitializeFromList(annotation_snapshots);
   if (annotation_objects->IsUseful()) {
     SetAnnotationObjects(std::move(annotation_objects));
+
+    auto annotation_object_threads =
+        std::make_unique<MinidumpAnnotationThreadListWriter>();
+    annotation_object_threads->InitializeFromList(annotation_snapshots);
+    if (annotation_object_threads->IsUseful()) {
+      SetAnnotationObjectThreads(std::move(annotation_object_threads));
+    }
   }
 }
 
@@ -85,6 +96,14 @@ void MinidumpModuleCrashpadInfoWriter::SetAnnotationObjects(
   annotation_objects_ = std::move(annotation_objects);
 }
 
+void MinidumpModuleCrashpadInfoWriter::SetAnnotationObjectThreads(
+    std::unique_ptr<MinidumpAnnotationThreadListWriter>
+        annotation_object_threads) {
+  DCHECK_EQ(state(), kStateMutable);
+
+  annotation_object_threads_ = std::move(annotation_object_threads);
+}
+
 bool MinidumpModuleCrashpadInfoWriter::IsUseful() const {
   return list_annotations_ || simple_annotations_ || annotation_objects_;
 }
@@ -110,6 +129,12 @@ bool MinidumpModuleCrashpadInfoWriter::Freeze() {
         &module_.annotation_objects);
   }
 
+  if (annotation_object_threads_) {
+    annotation_object_threads_->RegisterLocationDescriptor(
+        &module_.annotation_object_threads);
+    module_.version = MinidumpModuleCrashpadInfo::kVersion;
+  }
+
   return true;
 }
 
@@ -133,6 +158,9 @@ MinidumpModuleCrashpadInfoWriter::Children() {
   if (annotation_objects_) {
     children.push_back(annotation_objects_.get());
   }
+  if (annotation_object_threads_) {
+    children.push_back(annotation_object_threads_.get());
+  }
 
   return children;
 }
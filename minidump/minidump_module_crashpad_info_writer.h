@@ -28,6 +28,7 @@
 namespace crashpad {
 
 class MinidumpAnnotationListWriter;
+class MinidumpAnnotationThreadListWriter;
 class MinidumpSimpleStringDictionaryWriter;
 class ModuleSnapshot;
 
@@ -91,6 +92,21 @@ class MinidumpModuleCrashpadInfoWriter final
   void SetAnnotationObjects(
       std::unique_ptr<MinidumpAnnotationListWriter> annotation_objects);
 
+  //! \brief Arranges for MinidumpModuleCrashpadInfo::annotation_object_threads
+  //!     to point to the MinidumpAnnotationThreadListWriter object to be
+  //!     written by \a annotation_object_threads.
+  //!
+  //! This object takes ownership of \a annotation_object_threads and becomes
+  //! its parent in the overall tree of internal::MinidumpWritable objects. When
+  //! set, MinidumpModuleCrashpadInfo::version is written as
+  //! MinidumpModuleCrashpadInfo::kVersion. Otherwise, it is written as
+  //! MinidumpModuleCrashpadInfo::kVersionWithoutAnnotationObjectThreads.
+  //!
+  //! \note Valid in #kStateMutable.
+  void SetAnnotationObjectThreads(
+      std::unique_ptr<MinidumpAnnotationThreadListWriter>
+          annotation_object_threads);
+
   //! \brief Determines whether the object is useful.
   //!
   //! A useful object is one that carries data that makes a meaningful
@@ -112,6 +128,8 @@ class MinidumpModuleCrashpadInfoWriter final
   std::unique_ptr<MinidumpUTF8StringListWriter> list_annotations_;
   std::unique_ptr<MinidumpSimpleStringDictionaryWriter> simple_annotations_;
   std::unique_ptr<MinidumpAnnotationListWriter> annotation_objects_;
+  std::unique_ptr<MinidumpAnnotationThreadListWriter>
+      annotation_object_threads_;
 };
 
 //! \brief The writer for a MinidumpModuleCrashpadInfoList object in a minidump
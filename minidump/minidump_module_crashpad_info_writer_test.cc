@@ -101,7 +101,8 @@ TEST(MinidumpModuleCrashpadInfoWriter, EmptyModule) {
           string_file.string(), module_list->modules[0].location);
   ASSERT_TRUE(module);
 
-  EXPECT_EQ(module->version, MinidumpModuleCrashpadInfo::kVersion);
+  EXPECT_EQ(module->version,
+            MinidumpModuleCrashpadInfo::kVersionWithoutAnnotationObjectThreads);
   EXPECT_EQ(module->list_annotations.DataSize, 0u);
   EXPECT_EQ(module->list_annotations.Rva, 0u);
   EXPECT_EQ(module->simple_annotations.DataSize, 0u);
@@ -172,7 +173,8 @@ TEST(MinidumpModuleCrashpadInfoWriter, FullModule) {
           string_file.string(), module_list->modules[0].location);
   ASSERT_TRUE(module);
 
-  EXPECT_EQ(module->version, MinidumpModuleCrashpadInfo::kVersion);
+  EXPECT_EQ(module->version,
+            MinidumpModuleCrashpadInfo::kVersionWithoutAnnotationObjectThreads);
   EXPECT_NE(module->list_annotations.DataSize, 0u);
   EXPECT_NE(module->list_annotations.Rva, 0u);
   EXPECT_NE(module->simple_annotations.DataSize, 0u);
@@ -306,7 +308,8 @@ TEST(MinidumpModuleCrashpadInfoWriter, ThreeModules) {
           string_file.string(), module_list->modules[0].location);
   ASSERT_TRUE(module_0);
 
-  EXPECT_EQ(module_0->version, MinidumpModuleCrashpadInfo::kVersion);
+  EXPECT_EQ(module_0->version,
+            MinidumpModuleCrashpadInfo::kVersionWithoutAnnotationObjectThreads);
 
   const MinidumpRVAList* list_annotations_0 =
       MinidumpWritableAtLocationDescriptor<MinidumpRVAList>(
@@ -348,7 +351,8 @@ TEST(MinidumpModuleCrashpadInfoWriter, ThreeModules) {
           string_file.string(), module_list->modules[1].location);
   ASSERT_TRUE(module_1);
 
-  EXPECT_EQ(module_1->version, MinidumpModuleCrashpadInfo::kVersion);
+  EXPECT_EQ(module_1->version,
+            MinidumpModuleCrashpadInfo::kVersionWithoutAnnotationObjectThreads);
 
   const MinidumpRVAList* list_annotations_1 =
       MinidumpWritableAtLocationDescriptor<MinidumpRVAList>(
@@ -372,7 +376,8 @@ TEST(MinidumpModuleCrashpadInfoWriter, ThreeModules) {
           string_file.string(), module_list->modules[2].location);
   ASSERT_TRUE(module_2);
 
-  EXPECT_EQ(module_2->version, MinidumpModuleCrashpadInfo::kVersion);
+  EXPECT_EQ(module_2->version,
+            MinidumpModuleCrashpadInfo::kVersionWithoutAnnotationObjectThreads);
 
   const MinidumpRVAList* list_annotations_2 =
       MinidumpWritableAtLocationDescriptor<MinidumpRVAList>(
@@ -484,7 +489,8 @@ TEST(MinidumpModuleCrashpadInfoWriter, InitializeFromSnapshot) {
           string_file.string(), module_list->modules[0].location);
   ASSERT_TRUE(module_0);
 
-  EXPECT_EQ(module_0->version, MinidumpModuleCrashpadInfo::kVersion);
+  EXPECT_EQ(module_0->version,
+            MinidumpModuleCrashpadInfo::kVersionWithoutAnnotationObjectThreads);
 
   const MinidumpRVAList* list_annotations_0 =
       MinidumpWritableAtLocationDescriptor<MinidumpRVAList>(
@@ -519,7 +525,8 @@ TEST(MinidumpModuleCrashpadInfoWriter, InitializeFromSnapshot) {
           string_file.string(), module_list->modules[1].location);
   ASSERT_TRUE(module_2);
 
-  EXPECT_EQ(module_2->version, MinidumpModuleCrashpadInfo::kVersion);
+  EXPECT_EQ(module_2->version,
+            MinidumpModuleCrashpadInfo::kVersionWithoutAnnotationObjectThreads);
 
   const MinidumpRVAList* list_annotations_2 =
       MinidumpWritableAtLocationDescriptor<MinidumpRVAList>(
@@ -548,7 +555,8 @@ TEST(MinidumpModuleCrashpadInfoWriter, InitializeFromSnapshot) {
           string_file.string(), module_list->modules[2].location);
   ASSERT_TRUE(module_3);
 
-  EXPECT_EQ(module_3->version, MinidumpModuleCrashpadInfo::kVersion);
+  EXPECT_EQ(module_3->version,
+            MinidumpModuleCrashpadInfo::kVersionWithoutAnnotationObjectThreads);
 
   const MinidumpRVAList* list_annotations_3 =
       MinidumpWritableAtLocationDescriptor<MinidumpRVAList>(
@@ -577,7 +585,8 @@ TEST(MinidumpModuleCrashpadInfoWriter, InitializeFromSnapshot) {
           string_file.string(), module_list->modules[3].location);
   ASSERT_TRUE(module_4);
 
-  EXPECT_EQ(module_4->version, MinidumpModuleCrashpadInfo::kVersion);
+  EXPECT_EQ(module_4->version,
+            MinidumpModuleCrashpadInfo::kVersionWithoutAnnotationObjectThreads);
 
   EXPECT_FALSE(MinidumpWritableAtLocationDescriptor<MinidumpRVAList>(
       string_file.string(), module_4->list_annotations));
@@ -600,6 +609,56 @@ TEST(MinidumpModuleCrashpadInfoWriter, InitializeFromSnapshot) {
   EXPECT_EQ(MinidumpByteArrayAtRVA(string_file.string(),
                                    annotation_list_4->objects[0].value),
             annotation.value);
+  EXPECT_FALSE(
+      MinidumpWritableAtLocationDescriptor<MinidumpAnnotationThreadList>(
+          string_file.string(), module_4->annotation_object_threads));
+}
+
+TEST(MinidumpModuleCrashpadInfoWriter, ThreadAnnotationObjects) {
+  constexpr uint64_t kThreadID = 0xFEEDFACE12;
+  AnnotationSnapshot thread_annotation("thread", 1, {'v'});
+  thread_annotation.thread_id = kThreadID;
+  const AnnotationSnapshot process_annotation("process", 1, {'w'});
+
+  TestModuleSnapshot module_snapshot;
+  module_snapshot.SetAnnotationObjects(
+      {process_annotation, thread_annotation});
+
+  auto module_writer = std::make_unique<MinidumpModuleCrashpadInfoWriter>();
+  module_writer->InitializeFromSnapshot(&module_snapshot);
+  EXPECT_TRUE(module_writer->IsUseful());
+
+  auto module_list_writer =
+      std::make_unique<MinidumpModuleCrashpadInfoListWriter>();
+  module_list_writer->AddModule(std::move(module_writer), 0);
+
+  StringFile string_file;
+  ASSERT_TRUE(module_list_writer->WriteEverything(&string_file));
+
+  const MinidumpModuleCrashpadInfoList* module_list =
+      MinidumpModuleCrashpadInfoListAtStart(string_file.string(), 1);
+  ASSERT_TRUE(module_list);
+
+  const MinidumpModuleCrashpadInfo* module =
+      MinidumpWritableAtLocationDescriptor<MinidumpModuleCrashpadInfo>(
+          string_file.string(), module_list->modules[0].location);
+  ASSERT_TRUE(module);
+
+  EXPECT_EQ(module->version, MinidumpModuleCrashpadInfo::kVersion);
+
+  auto* annotation_list =
+      MinidumpWritableAtLocationDescriptor<MinidumpAnnotationList>(
+          string_file.string(), module->annotation_objects);
+  ASSERT_TRUE(annotation_list);
+  ASSERT_EQ(annotation_list->count, 2u);
+
+  auto* thread_list =
+      MinidumpWritableAtLocationDescriptor<MinidumpAnnotationThreadList>(
+          string_file.string(), module->annotation_object_threads);
+  ASSERT_TRUE(thread_list);
+  ASSERT_EQ(thread_list->count, 2u);
+  EXPECT_EQ(thread_list->thread_ids[0], 0u);
+  EXPECT_EQ(thread_list->thread_ids[1], kThreadID);
 }
 
 }  // namespace
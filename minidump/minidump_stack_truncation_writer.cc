@@ -0,0 +1,119 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "minidump/minidump_stack_truncation_writer.h"
+
+#include "base/check_op.h"
+#include "base/logging.h"
+#include "snapshot/memory_snapshot.h"
+#include "snapshot/thread_snapshot.h"
+#include "util/file/file_writer.h"
+#include "util/numeric/safe_assignment.h"
+
+namespace crashpad {
+
+MinidumpStackTruncationListWriter::MinidumpStackTruncationListWriter()
+    : MinidumpStreamWriter(), stack_truncation_list_base_(), items_() {}
+
+MinidumpStackTruncationListWriter::~MinidumpStackTruncationListWriter() {}
+
+void MinidumpStackTruncationListWriter::InitializeFromSnapshot(
+    const std::vector<const ThreadSnapshot*>& thread_snapshots,
+    const MinidumpThreadIDMap& thread_id_map) {
+  DCHECK_EQ(state(), kStateMutable);
+  DCHECK(items_.empty());
+
+  for (const ThreadSnapshot* thread_snapshot : thread_snapshots) {
+    const uint64_t uncaptured_size = thread_snapshot->UncapturedStackSize();
+    const MemorySnapshot* stack = thread_snapshot->Stack();
+    if (!uncaptured_size || !stack) {
+      continue;
+    }
+
+    const auto it = thread_id_map.find(thread_snapshot->ThreadID());
+    DCHECK(it != thread_id_map.end());
+
+    MinidumpStackTruncation stack_truncation = {};
+    stack_truncation.ThreadId = it->second;
+    stack_truncation.StartOfStack = stack->Address();
+    stack_truncation.CapturedSize = stack->Size();
+    stack_truncation.StackSize = stack->Size() + uncaptured_size;
+    AddStackTruncation(stack_truncation);
+  }
+}
+
+void MinidumpStackTruncationListWriter::AddStackTruncation(
+    const MinidumpStackTruncation& stack_truncation) {
+  DCHECK_EQ(state(), kStateMutable);
+
+  items_.push_back(stack_truncation);
+}
+
+bool MinidumpStackTruncationListWriter::Freeze() {
+  DCHECK_EQ(state(), kStateMutable);
+
+  if (!MinidumpStreamWriter::Freeze()) {
+    return false;
+  }
+
+  stack_truncation_list_base_.SizeOfHeader =
+      sizeof(MinidumpStackTruncationList);
+  stack_truncation_list_base_.SizeOfEntry = sizeof(MinidumpStackTruncation);
+  if (!AssignIfInRange(&stack_truncation_list_base_.NumberOfEntries,
+                       items_.size())) {
+    LOG(ERROR) << "stack truncation count " << items_.size()
+               << " out of range";
+    return false;
+  }
+
+  return true;
+}
+
+size_t MinidumpStackTruncationListWriter::SizeOfObject() {
+  DCHECK_GE(state(), kStateFrozen);
+
+  return sizeof(stack_truncation_list_base_) +
+         items_.size() * sizeof(MinidumpStackTruncation);
+}
+
+std::vector<internal::MinidumpWritable*>
+MinidumpStackTruncationListWriter::Children() {
+  DCHECK_GE(state(), kStateFrozen);
+
+  return std::vector<internal::MinidumpWritable*>();
+}
+
+bool MinidumpStackTruncationListWriter::WriteObject(
+    FileWriterInterface* file_writer) {
+  DCHECK_EQ(state(), kStateWritable);
+
+  WritableIoVec iov;
+  iov.iov_base = &stack_truncation_list_base_;
+  iov.iov_len = sizeof(stack_truncation_list_base_);
+  std::vector<WritableIoVec> iovecs(1, iov);
+
+  if (!items_.empty()) {
+    iov.iov_base = &items_[0];
+    iov.iov_len = items_.size() * sizeof(items_[0]);
+    iovecs.push_back(iov);
+  }
+
+  return file_writer->WriteIoVec(&iovecs);
+}
+
+MinidumpStreamType MinidumpStackTruncationListWriter::StreamType() const {
+  return kMinidumpStreamTypeCrashpadStackTruncation;
+}
+
+}  // namespace crashpad
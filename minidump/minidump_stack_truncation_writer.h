@@ -0,0 +1,88 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_MINIDUMP_MINIDUMP_STACK_TRUNCATION_WRITER_H_
+#define CRASHPAD_MINIDUMP_MINIDUMP_STACK_TRUNCATION_WRITER_H_
+
+#include <stdint.h>
+#include <sys/types.h>
+
+#include <vector>
+
+#include "minidump/minidump_extensions.h"
+#include "minidump/minidump_stream_writer.h"
+#include "minidump/minidump_thread_id_map.h"
+#include "minidump/minidump_writable.h"
+
+namespace crashpad {
+
+class ThreadSnapshot;
+
+//! \brief The writer for a MinidumpStackTruncationList stream in a minidump
+//!     file, containing a list of MinidumpStackTruncation objects.
+class MinidumpStackTruncationListWriter final
+    : public internal::MinidumpStreamWriter {
+ public:
+  MinidumpStackTruncationListWriter();
+
+  MinidumpStackTruncationListWriter(const MinidumpStackTruncationListWriter&) =
+      delete;
+  MinidumpStackTruncationListWriter& operator=(
+      const MinidumpStackTruncationListWriter&) = delete;
+
+  ~MinidumpStackTruncationListWriter() override;
+
+  //! \brief Adds a MinidumpStackTruncation for each thread in \a
+  //!     thread_snapshots whose stack was only partially captured.
+  //!
+  //! \param[in] thread_snapshots The thread snapshots to use as source data.
+  //! \param[in] thread_id_map A MinidumpThreadIDMap previously built by
+  //!     MinidumpThreadListWriter::InitializeFromSnapshot().
+  //!
+  //! \note Valid in #kStateMutable.
+  void InitializeFromSnapshot(
+      const std::vector<const ThreadSnapshot*>& thread_snapshots,
+      const MinidumpThreadIDMap& thread_id_map);
+
+  //! \brief Adds \a stack_truncation to the MinidumpStackTruncationList.
+  //!
+  //! \note Valid in #kStateMutable.
+  void AddStackTruncation(const MinidumpStackTruncation& stack_truncation);
+
+  //! \brief Determines whether the object is useful.
+  //!
+  //! A useful object is one that lists at least one thread. Because this
+  //! stream is an extension, it need not be written when it is not useful.
+  //!
+  //! \return `true` if the object is useful, `false` otherwise.
+  bool IsUseful() const { return !items_.empty(); }
+
+ protected:
+  // MinidumpWritable:
+  bool Freeze() override;
+  size_t SizeOfObject() override;
+  std::vector<internal::MinidumpWritable*> Children() override;
+  bool WriteObject(FileWriterInterface* file_writer) override;
+
+  // MinidumpStreamWriter:
+  MinidumpStreamType StreamType() const override;
+
+ private:
+  MinidumpStackTruncationList stack_truncation_list_base_;
+  std::vector<MinidumpStackTruncation> items_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_MINIDUMP_MINIDUMP_STACK_TRUNCATION_WRITER_H_
@@ -0,0 +1,164 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "minidump/minidump_stack_truncation_writer.h"
+
+#include <string.h>
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "minidump/minidump_file_writer.h"
+#include "minidump/test/minidump_file_writer_test_util.h"
+#include "minidump/test/minidump_writable_test_util.h"
+#include "snapshot/test/test_memory_snapshot.h"
+#include "snapshot/test/test_thread_snapshot.h"
+#include "util/file/string_file.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+// The stack truncation list is expected to be the only stream.
+void GetStackTruncationListStream(
+    const std::string& file_contents,
+    const MinidumpStackTruncationList** stack_truncation_list) {
+  constexpr size_t kDirectoryOffset = sizeof(MINIDUMP_HEADER);
+  constexpr size_t kStackTruncationListStreamOffset =
+      kDirectoryOffset + sizeof(MINIDUMP_DIRECTORY);
+
+  const MINIDUMP_DIRECTORY* directory;
+  const MINIDUMP_HEADER* header =
+      MinidumpHeaderAtStart(file_contents, &directory);
+  ASSERT_NO_FATAL_FAILURE(VerifyMinidumpHeader(header, 1, 0));
+  ASSERT_TRUE(directory);
+
+  constexpr size_t kDirectoryIndex = 0;
+
+  ASSERT_EQ(directory[kDirectoryIndex].StreamType,
+            kMinidumpStreamTypeCrashpadStackTruncation);
+  EXPECT_EQ(directory[kDirectoryIndex].Location.Rva,
+            kStackTruncationListStreamOffset);
+
+  *stack_truncation_list =
+      MinidumpWritableAtLocationDescriptor<MinidumpStackTruncationList>(
+          file_contents, directory[kDirectoryIndex].Location);
+  ASSERT_TRUE(*stack_truncation_list);
+}
+
+std::unique_ptr<TestThreadSnapshot> MakeThreadSnapshot(
+    uint64_t thread_id,
+    uint64_t stack_address,
+    size_t stack_size,
+    uint64_t uncaptured_stack_size) {
+  auto thread_snapshot = std::make_unique<TestThreadSnapshot>();
+  thread_snapshot->SetThreadID(thread_id);
+  auto stack = std::make_unique<TestMemorySnapshot>();
+  stack->SetAddress(stack_address);
+  stack->SetSize(stack_size);
+  thread_snapshot->SetStack(std::move(stack));
+  thread_snapshot->SetUncapturedStackSize(uncaptured_stack_size);
+  return thread_snapshot;
+}
+
+TEST(MinidumpStackTruncationWriter, Empty) {
+  MinidumpFileWriter minidump_file_writer;
+  auto stack_truncation_list_writer =
+      std::make_unique<MinidumpStackTruncationListWriter>();
+  EXPECT_FALSE(stack_truncation_list_writer->IsUseful());
+  ASSERT_TRUE(
+      minidump_file_writer.AddStream(std::move(stack_truncation_list_writer)));
+
+  StringFile string_file;
+  ASSERT_TRUE(minidump_file_writer.WriteEverything(&string_file));
+
+  ASSERT_EQ(string_file.string().size(),
+            sizeof(MINIDUMP_HEADER) + sizeof(MINIDUMP_DIRECTORY) +
+                sizeof(MinidumpStackTruncationList));
+
+  const MinidumpStackTruncationList* stack_truncation_list = nullptr;
+  ASSERT_NO_FATAL_FAILURE(GetStackTruncationListStream(
+      string_file.string(), &stack_truncation_list));
+
+  EXPECT_EQ(stack_truncation_list->SizeOfHeader,
+            sizeof(MinidumpStackTruncationList));
+  EXPECT_EQ(stack_truncation_list->SizeOfEntry,
+            sizeof(MinidumpStackTruncation));
+  EXPECT_EQ(stack_truncation_list->NumberOfEntries, 0u);
+}
+
+TEST(MinidumpStackTruncationWriter, InitializeFromSnapshot) {
+  constexpr uint64_t kThreadID0 = 0x1111111111111111;
+  constexpr uint64_t kThreadID1 = 0x2222222222222222;
+  constexpr uint64_t kThreadID2 = 0x3333333333333333;
+  constexpr uint64_t kStackAddress1 = 0x7fff00010000;
+  constexpr size_t kStackSize1 = 0x4000;
+  constexpr uint64_t kUncapturedStackSize1 = 0x7fc000;
+
+  // Only the second thread’s stack was truncated.
+  std::vector<std::unique_ptr<TestThreadSnapshot>> thread_snapshots_owner;
+  thread_snapshots_owner.push_back(
+      MakeThreadSnapshot(kThreadID0, 0x7fff00000000, 0x1000, 0));
+  thread_snapshots_owner.push_back(MakeThreadSnapshot(
+      kThreadID1, kStackAddress1, kStackSize1, kUncapturedStackSize1));
+  thread_snapshots_owner.push_back(
+      MakeThreadSnapshot(kThreadID2, 0x7fff00020000, 0x2000, 0));
+  std::vector<const ThreadSnapshot*> thread_snapshots;
+  for (const auto& thread_snapshot : thread_snapshots_owner) {
+    thread_snapshots.push_back(thread_snapshot.get());
+  }
+
+  MinidumpThreadIDMap thread_id_map;
+  thread_id_map[kThreadID0] = 0;
+  thread_id_map[kThreadID1] = 1;
+  thread_id_map[kThreadID2] = 2;
+
+  MinidumpFileWriter minidump_file_writer;
+  auto stack_truncation_list_writer =
+      std::make_unique<MinidumpStackTruncationListWriter>();
+  stack_truncation_list_writer->InitializeFromSnapshot(thread_snapshots,
+                                                       thread_id_map);
+  EXPECT_TRUE(stack_truncation_list_writer->IsUseful());
+  ASSERT_TRUE(
+      minidump_file_writer.AddStream(std::move(stack_truncation_list_writer)));
+
+  StringFile string_file;
+  ASSERT_TRUE(minidump_file_writer.WriteEverything(&string_file));
+
+  ASSERT_EQ(string_file.string().size(),
+            sizeof(MINIDUMP_HEADER) + sizeof(MINIDUMP_DIRECTORY) +
+                sizeof(MinidumpStackTruncationList) +
+                sizeof(MinidumpStackTruncation));
+
+  const MinidumpStackTruncationList* stack_truncation_list = nullptr;
+  ASSERT_NO_FATAL_FAILURE(GetStackTruncationListStream(
+      string_file.string(), &stack_truncation_list));
+  ASSERT_EQ(stack_truncation_list->NumberOfEntries, 1u);
+
+  MinidumpStackTruncation stack_truncation;
+  memcpy(&stack_truncation,
+         &stack_truncation_list->Entries[0],
+         sizeof(stack_truncation));
+  EXPECT_EQ(stack_truncation.ThreadId, 1u);
+  EXPECT_EQ(stack_truncation.StartOfStack, kStackAddress1);
+  EXPECT_EQ(stack_truncation.CapturedSize, kStackSize1);
+  EXPECT_EQ(stack_truncation.StackSize, kStackSize1 + kUncapturedStackSize1);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
@@ -23,7 +23,7 @@ MinidumpStreamWriter::~MinidumpStreamWriter() {
 }
 
 const MINIDUMP_DIRECTORY* MinidumpStreamWriter::DirectoryListEntry() const {
-  DCHECK_EQ(state(), kStateWritable);
+  DCHECK_GE(state(), kStateFrozen);
 
   return &directory_list_entry_;
 }
@@ -47,7 +47,9 @@ class MinidumpStreamWriter : public MinidumpWritable {
   //! This method is provided for MinidumpFileWriter, which calls it in order to
   //! obtain the directory entry for a stream.
   //!
-  //! \note Valid only in #kStateWritable.
+  //! \note Valid in #kStateFrozen and later. A stream written in #kPhaseLast
+  //!     is still frozen when the directory is first written, and its entry’s
+  //!     location isn’t known until it becomes writable.
   const MINIDUMP_DIRECTORY* DirectoryListEntry() const;
 
  protected:
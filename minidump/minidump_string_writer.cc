@@ -58,6 +58,18 @@ size_t MinidumpStringWriter<Traits>::SizeOfObject() {
   return sizeof(*string_base_) + (string_.size() + 1) * sizeof(string_[0]);
 }
 
+template <typename Traits>
+bool MinidumpStringWriter<Traits>::SharingKey(std::string* key) {
+  DCHECK_GE(state(), kStateFrozen);
+
+  // The key is everything that WriteObject() writes.
+  key->assign(reinterpret_cast<const char*>(string_base_.get()),
+              sizeof(*string_base_));
+  key->append(reinterpret_cast<const char*>(string_.c_str()),
+              (string_.size() + 1) * sizeof(string_[0]));
+  return true;
+}
+
 template <typename Traits>
 bool MinidumpStringWriter<Traits>::WriteObject(
     FileWriterInterface* file_writer) {
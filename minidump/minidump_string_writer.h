@@ -66,6 +66,7 @@ class MinidumpStringWriter : public MinidumpWritable {
 
   bool Freeze() override;
   size_t SizeOfObject() override;
+  bool SharingKey(std::string* key) override;
   bool WriteObject(FileWriterInterface* file_writer) override;
 
   //! \brief Sets the string to be written.
@@ -14,9 +14,8 @@
 
 #include "minidump/minidump_thread_id_map.h"
 
+#include <algorithm>
 #include <limits>
-#include <set>
-#include <utility>
 
 #include "base/check_op.h"
 #include "base/numerics/safe_conversions.h"
@@ -24,44 +23,111 @@
 
 namespace crashpad {
 
+namespace {
+
+bool EntryLess(const MinidumpThreadIDMap::value_type& entry,
+               uint64_t thread_id) {
+  return entry.first < thread_id;
+}
+
+}  // namespace
+
+MinidumpThreadIDMap::MinidumpThreadIDMap() : entries_() {}
+
+MinidumpThreadIDMap::~MinidumpThreadIDMap() = default;
+
+MinidumpThreadIDMap::iterator MinidumpThreadIDMap::find(uint64_t thread_id) {
+  auto it =
+      std::lower_bound(entries_.begin(), entries_.end(), thread_id, EntryLess);
+  return it != entries_.end() && it->first == thread_id ? it : entries_.end();
+}
+
+MinidumpThreadIDMap::const_iterator MinidumpThreadIDMap::find(
+    uint64_t thread_id) const {
+  auto it =
+      std::lower_bound(entries_.begin(), entries_.end(), thread_id, EntryLess);
+  return it != entries_.end() && it->first == thread_id ? it : entries_.end();
+}
+
+uint32_t& MinidumpThreadIDMap::operator[](uint64_t thread_id) {
+  auto it =
+      std::lower_bound(entries_.begin(), entries_.end(), thread_id, EntryLess);
+  if (it == entries_.end() || it->first != thread_id) {
+    it = entries_.insert(it, value_type(thread_id, 0));
+  }
+  return it->second;
+}
+
 void BuildMinidumpThreadIDMap(
     const std::vector<const ThreadSnapshot*>& thread_snapshots,
     MinidumpThreadIDMap* thread_id_map) {
   DCHECK(thread_id_map->empty());
 
+  // Collect each 64-bit thread ID along with the index at which it first
+  // appears, then sort by thread ID, keeping only the first appearance of each.
+  // Thread lists are usually already in order, which makes the sort cheap.
+  std::vector<MinidumpThreadIDMap::value_type>& entries =
+      thread_id_map->entries_;
+  entries.reserve(thread_snapshots.size());
+  for (size_t index = 0; index < thread_snapshots.size(); ++index) {
+    entries.emplace_back(thread_snapshots[index]->ThreadID(),
+                         base::checked_cast<uint32_t>(index));
+  }
+  std::stable_sort(entries.begin(),
+                   entries.end(),
+                   [](const MinidumpThreadIDMap::value_type& a,
+                      const MinidumpThreadIDMap::value_type& b) {
+                     return a.first < b.first;
+                   });
+  entries.erase(std::unique(entries.begin(),
+                            entries.end(),
+                            [](const MinidumpThreadIDMap::value_type& a,
+                               const MinidumpThreadIDMap::value_type& b) {
+                              return a.first == b.first;
+                            }),
+                entries.end());
+
   // First, try truncating each 64-bit thread ID to 32 bits. If that’s possible
   // for each unique 64-bit thread ID, then this will be used as the mapping.
   // This preserves as much of the original thread ID as possible when feasible.
+  // When every thread ID already fits in 32 bits, the sorted unique 64-bit
+  // thread IDs can’t collide, so the check can be skipped.
   bool collision = false;
-  std::set<uint32_t> thread_ids_32;
-  for (const ThreadSnapshot* thread_snapshot : thread_snapshots) {
-    uint64_t thread_id_64 = thread_snapshot->ThreadID();
-    if (thread_id_map->find(thread_id_64) == thread_id_map->end()) {
-      uint32_t thread_id_32 = static_cast<uint32_t>(thread_id_64);
-      if (!thread_ids_32.insert(thread_id_32).second) {
-        collision = true;
-        break;
-      }
-      thread_id_map->insert(std::make_pair(thread_id_64, thread_id_32));
+  if (!entries.empty() &&
+      entries.back().first > std::numeric_limits<uint32_t>::max()) {
+    std::vector<uint32_t> thread_ids_32;
+    thread_ids_32.reserve(entries.size());
+    for (const auto& entry : entries) {
+      thread_ids_32.push_back(static_cast<uint32_t>(entry.first));
     }
+    std::sort(thread_ids_32.begin(), thread_ids_32.end());
+    collision = std::adjacent_find(thread_ids_32.begin(),
+                                   thread_ids_32.end()) != thread_ids_32.end();
   }
 
-  if (collision) {
-    // Since there was a collision, go back and assign each unique 64-bit thread
-    // ID its own sequential 32-bit equivalent. The 32-bit thread IDs will not
-    // bear any resemblance to the original 64-bit thread IDs.
-    thread_id_map->clear();
-    for (const ThreadSnapshot* thread_snapshot : thread_snapshots) {
-      uint64_t thread_id_64 = thread_snapshot->ThreadID();
-      if (thread_id_map->find(thread_id_64) == thread_id_map->end()) {
-        uint32_t thread_id_32 =
-            base::checked_cast<uint32_t>(thread_id_map->size());
-        thread_id_map->insert(std::make_pair(thread_id_64, thread_id_32));
-      }
+  if (!collision) {
+    for (auto& entry : entries) {
+      entry.second = static_cast<uint32_t>(entry.first);
     }
+    return;
+  }
 
-    DCHECK_LE(thread_id_map->size(), std::numeric_limits<uint32_t>::max());
+  // Since there was a collision, go back and assign each unique 64-bit thread
+  // ID its own sequential 32-bit equivalent, in the order that the threads
+  // first appear. The 32-bit thread IDs will not bear any resemblance to the
+  // original 64-bit thread IDs.
+  std::vector<size_t> order(entries.size());
+  for (size_t index = 0; index < order.size(); ++index) {
+    order[index] = index;
   }
+  std::sort(order.begin(), order.end(), [&entries](size_t a, size_t b) {
+    return entries[a].second < entries[b].second;
+  });
+  for (size_t rank = 0; rank < order.size(); ++rank) {
+    entries[order[rank]].second = base::checked_cast<uint32_t>(rank);
+  }
+
+  DCHECK_LE(thread_id_map->size(), std::numeric_limits<uint32_t>::max());
 }
 
 }  // namespace crashpad
@@ -15,9 +15,10 @@
 #ifndef CRASHPAD_MINIDUMP_MINIDUMP_THREAD_ID_MAP_H_
 #define CRASHPAD_MINIDUMP_MINIDUMP_THREAD_ID_MAP_H_
 
+#include <stddef.h>
 #include <stdint.h>
 
-#include <map>
+#include <utility>
 #include <vector>
 
 namespace crashpad {
@@ -32,7 +33,53 @@ class ThreadSnapshot;
 //!
 //! A ThreadIDMap ensures that there are no collisions among the set of 32-bit
 //! minidump thread IDs.
-using MinidumpThreadIDMap = std::map<uint64_t, uint32_t>;
+//!
+//! The map is stored as a vector of pairs sorted by snapshot thread ID, so that
+//! building it for a process with many threads needs a single allocation and
+//! lookups are binary searches over contiguous memory. It provides the subset
+//! of the `std::map<>` interface that minidump writers use.
+class MinidumpThreadIDMap {
+ public:
+  using value_type = std::pair<uint64_t, uint32_t>;
+  using iterator = std::vector<value_type>::iterator;
+  using const_iterator = std::vector<value_type>::const_iterator;
+
+  MinidumpThreadIDMap();
+
+  MinidumpThreadIDMap(const MinidumpThreadIDMap&) = delete;
+  MinidumpThreadIDMap& operator=(const MinidumpThreadIDMap&) = delete;
+
+  ~MinidumpThreadIDMap();
+
+  iterator begin() { return entries_.begin(); }
+  const_iterator begin() const { return entries_.begin(); }
+  iterator end() { return entries_.end(); }
+  const_iterator end() const { return entries_.end(); }
+
+  size_t size() const { return entries_.size(); }
+  bool empty() const { return entries_.empty(); }
+  void clear() { entries_.clear(); }
+
+  //! \brief Returns an iterator to the entry for \a thread_id, or end() if
+  //!     there is no such entry.
+  iterator find(uint64_t thread_id);
+  const_iterator find(uint64_t thread_id) const;
+
+  //! \brief Returns a reference to the minidump thread ID for \a thread_id,
+  //!     inserting a new entry with value `0` if there is none.
+  //!
+  //! Each insertion is linear in the size of the map.
+  //! BuildMinidumpThreadIDMap() should be used to build maps for more than a
+  //! few threads.
+  uint32_t& operator[](uint64_t thread_id);
+
+ private:
+  friend void BuildMinidumpThreadIDMap(
+      const std::vector<const ThreadSnapshot*>& thread_snapshots,
+      MinidumpThreadIDMap* thread_id_map);
+
+  std::vector<value_type> entries_;  // sorted by first
+};
 
 //! \brief Builds a MinidumpThreadIDMap for a group of ThreadSnapshot objects.
 //!
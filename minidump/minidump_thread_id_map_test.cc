@@ -188,6 +188,51 @@ TEST_F(MinidumpThreadIDMapTest, AllDuplicates) {
   EXPECT_PRED3(MapHasKeyValue, &thread_id_map, 6, 6);
 }
 
+TEST_F(MinidumpThreadIDMapTest, UnsortedCollision) {
+  SetThreadID(0, 0x0000000000000030);
+  SetThreadID(1, 0x0000000100000010);
+  SetThreadID(2, 0x0000000000000010);
+  SetThreadID(3, 0x0000000000000030);
+  SetThreadID(4, 0x0000000000000020);
+
+  MinidumpThreadIDMap thread_id_map;
+  BuildMinidumpThreadIDMap(thread_snapshots(), &thread_id_map);
+
+  EXPECT_EQ(thread_id_map.size(), 4u);
+  EXPECT_PRED3(MapHasKeyValue, &thread_id_map, 0x0000000000000030, 0);
+  EXPECT_PRED3(MapHasKeyValue, &thread_id_map, 0x0000000100000010, 1);
+  EXPECT_PRED3(MapHasKeyValue, &thread_id_map, 0x0000000000000010, 2);
+  EXPECT_PRED3(MapHasKeyValue, &thread_id_map, 0x0000000000000020, 3);
+}
+
+TEST(MinidumpThreadIDMap, Subscript) {
+  MinidumpThreadIDMap thread_id_map;
+  thread_id_map[30] = 3;
+  thread_id_map[10] = 1;
+  thread_id_map[20] = 2;
+  thread_id_map[10] = 4;
+
+  EXPECT_EQ(thread_id_map.size(), 3u);
+  EXPECT_EQ(thread_id_map.find(15), thread_id_map.end());
+  EXPECT_EQ(thread_id_map.find(40), thread_id_map.end());
+
+  uint64_t last_key = 0;
+  for (const auto& entry : thread_id_map) {
+    EXPECT_GT(entry.first, last_key);
+    last_key = entry.first;
+  }
+
+  auto it = thread_id_map.find(10);
+  ASSERT_NE(it, thread_id_map.end());
+  EXPECT_EQ(it->second, 4u);
+  it = thread_id_map.find(30);
+  ASSERT_NE(it, thread_id_map.end());
+  EXPECT_EQ(it->second, 3u);
+
+  thread_id_map.clear();
+  EXPECT_TRUE(thread_id_map.empty());
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace crashpad
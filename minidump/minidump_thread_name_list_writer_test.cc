@@ -312,6 +312,12 @@ TEST(MinidumpThreadNameListWriter, TwoThreads_SameNames) {
                                            &thread_name_list->ThreadNames[1],
                                            string_file.string(),
                                            kThreadName));
+
+  // The name is only written once, and both threads refer to it.
+  const RVA64 first_name_rva = thread_name_list->ThreadNames[0].RvaOfThreadName;
+  const RVA64 second_name_rva =
+      thread_name_list->ThreadNames[1].RvaOfThreadName;
+  EXPECT_EQ(second_name_rva, first_name_rva);
 }
 
 }  // namespace
@@ -35,7 +35,8 @@ MinidumpThreadWriter::~MinidumpThreadWriter() {
 
 void MinidumpThreadWriter::InitializeFromSnapshot(
     const ThreadSnapshot* thread_snapshot,
-    const MinidumpThreadIDMap* thread_id_map) {
+    const MinidumpThreadIDMap* thread_id_map,
+    bool include_stack) {
   DCHECK_EQ(state(), kStateMutable);
   DCHECK(!stack_);
   DCHECK(!context_);
@@ -48,7 +49,8 @@ void MinidumpThreadWriter::InitializeFromSnapshot(
   SetPriority(thread_snapshot->Priority());
   SetTEB(thread_snapshot->ThreadSpecificDataAddress());
 
-  const MemorySnapshot* stack_snapshot = thread_snapshot->Stack();
+  const MemorySnapshot* stack_snapshot =
+      include_stack ? thread_snapshot->Stack() : nullptr;
   if (stack_snapshot && stack_snapshot->Size() > 0) {
     std::unique_ptr<SnapshotMinidumpMemoryWriter> stack(
         new SnapshotMinidumpMemoryWriter(stack_snapshot));
@@ -140,22 +142,33 @@ MinidumpThreadListWriter::~MinidumpThreadListWriter() {
 
 void MinidumpThreadListWriter::InitializeFromSnapshot(
     const std::vector<const ThreadSnapshot*>& thread_snapshots,
-    MinidumpThreadIDMap* thread_id_map) {
+    MinidumpThreadIDMap* thread_id_map,
+    const std::set<uint64_t>* memory_thread_ids) {
   DCHECK_EQ(state(), kStateMutable);
   DCHECK(threads_.empty());
 
   BuildMinidumpThreadIDMap(thread_snapshots, thread_id_map);
 
+  auto include_memory = [memory_thread_ids](const ThreadSnapshot* thread) {
+    return !memory_thread_ids ||
+           memory_thread_ids->find(thread->ThreadID()) !=
+               memory_thread_ids->end();
+  };
+
   for (const ThreadSnapshot* thread_snapshot : thread_snapshots) {
     auto thread = std::make_unique<MinidumpThreadWriter>();
-    thread->InitializeFromSnapshot(thread_snapshot, thread_id_map);
+    thread->InitializeFromSnapshot(
+        thread_snapshot, thread_id_map, include_memory(thread_snapshot));
     AddThread(std::move(thread));
   }
 
   // Do this in a separate loop to keep the thread stacks earlier in the dump,
   // and together.
-  for (const ThreadSnapshot* thread_snapshot : thread_snapshots)
-    memory_list_writer_->AddFromSnapshot(thread_snapshot->ExtraMemory());
+  for (const ThreadSnapshot* thread_snapshot : thread_snapshots) {
+    if (include_memory(thread_snapshot)) {
+      memory_list_writer_->AddFromSnapshot(thread_snapshot->ExtraMemory());
+    }
+  }
 }
 
 void MinidumpThreadListWriter::SetMemoryListWriter(
@@ -21,6 +21,7 @@
 #include <sys/types.h>
 
 #include <memory>
+#include <set>
 #include <vector>
 
 #include "minidump/minidump_stream_writer.h"
@@ -54,12 +55,15 @@ class MinidumpThreadWriter final : public internal::MinidumpWritable {
   //! \param[in] thread_snapshot The thread snapshot to use as source data.
   //! \param[in] thread_id_map A MinidumpThreadIDMap to be consulted to
   //!     determine the 32-bit minidump thread ID to use for \a thread_snapshot.
+  //! \param[in] include_stack Whether to write the thread’s stack memory. When
+  //!     `false`, only the thread’s context is written.
   //!
   //! \note Valid in #kStateMutable. No mutator methods may be called before
   //!     this method, and it is not normally necessary to call any mutator
   //!     methods after this method.
   void InitializeFromSnapshot(const ThreadSnapshot* thread_snapshot,
-                              const MinidumpThreadIDMap* thread_id_map);
+                              const MinidumpThreadIDMap* thread_id_map,
+                              bool include_stack = true);
 
   //! \brief Returns a MINIDUMP_THREAD referencing this object’s data.
   //!
@@ -153,13 +157,18 @@ class MinidumpThreadListWriter final : public internal::MinidumpStreamWriter {
   //! \param[in] thread_snapshots The thread snapshots to use as source data.
   //! \param[out] thread_id_map A MinidumpThreadIDMap to be built by this
   //!     method. This map must be empty when this method is called.
+  //! \param[in] memory_thread_ids If not `nullptr`, the IDs of the only
+  //!     threads, as returned by ThreadSnapshot::ThreadID(), whose stacks and
+  //!     extra memory are written. The other threads are written with only
+  //!     their contexts. If `nullptr`, the memory of every thread is written.
   //!
   //! \note Valid in #kStateMutable. AddThread() may not be called before this
   //!     method, and it is not normally necessary to call AddThread() after
   //!     this method.
   void InitializeFromSnapshot(
       const std::vector<const ThreadSnapshot*>& thread_snapshots,
-      MinidumpThreadIDMap* thread_id_map);
+      MinidumpThreadIDMap* thread_id_map,
+      const std::set<uint64_t>* memory_thread_ids = nullptr);
 
   //! \brief Sets the MinidumpMemoryListWriter that each thread’s stack memory
   //!     region should be added to as extra memory.
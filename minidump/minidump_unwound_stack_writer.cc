@@ -0,0 +1,158 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "minidump/minidump_unwound_stack_writer.h"
+
+#include "base/check_op.h"
+#include "base/logging.h"
+#include "snapshot/module_snapshot.h"
+#include "snapshot/thread_snapshot.h"
+#include "util/file/file_writer.h"
+#include "util/numeric/safe_assignment.h"
+
+namespace crashpad {
+
+namespace {
+
+constexpr uint32_t kNoModule = 0xffffffff;
+
+}  // namespace
+
+MinidumpUnwoundStackListWriter::MinidumpUnwoundStackListWriter()
+    : MinidumpStreamWriter(),
+      unwound_stack_list_base_(),
+      stacks_(),
+      frames_() {}
+
+MinidumpUnwoundStackListWriter::~MinidumpUnwoundStackListWriter() {}
+
+void MinidumpUnwoundStackListWriter::InitializeFromSnapshot(
+    const std::vector<const ThreadSnapshot*>& thread_snapshots,
+    const std::vector<const ModuleSnapshot*>& module_snapshots,
+    const MinidumpThreadIDMap& thread_id_map) {
+  DCHECK_EQ(state(), kStateMutable);
+  DCHECK(stacks_.empty());
+
+  std::vector<MinidumpUnwoundFrame> frames;
+  for (const ThreadSnapshot* thread_snapshot : thread_snapshots) {
+    const std::vector<uint64_t> instruction_pointers =
+        thread_snapshot->UnwoundFrames();
+    if (instruction_pointers.empty()) {
+      continue;
+    }
+
+    const auto it = thread_id_map.find(thread_snapshot->ThreadID());
+    DCHECK(it != thread_id_map.end());
+
+    frames.clear();
+    for (uint64_t instruction_pointer : instruction_pointers) {
+      MinidumpUnwoundFrame frame = {};
+      frame.ModuleIndex = kNoModule;
+      frame.Offset = instruction_pointer;
+      for (size_t index = 0; index < module_snapshots.size(); ++index) {
+        const ModuleSnapshot* module = module_snapshots[index];
+        if (instruction_pointer >= module->Address() &&
+            instruction_pointer - module->Address() < module->Size()) {
+          frame.ModuleIndex = static_cast<uint32_t>(index);
+          frame.Offset = instruction_pointer - module->Address();
+          break;
+        }
+      }
+      frames.push_back(frame);
+    }
+    AddUnwoundStack(it->second, frames);
+  }
+}
+
+void MinidumpUnwoundStackListWriter::AddUnwoundStack(
+    uint32_t thread_id,
+    const std::vector<MinidumpUnwoundFrame>& frames) {
+  DCHECK_EQ(state(), kStateMutable);
+
+  MinidumpUnwoundStack stack = {};
+  stack.ThreadId = thread_id;
+  stack.FirstFrame = static_cast<uint32_t>(frames_.size());
+  stack.FrameCount = static_cast<uint32_t>(frames.size());
+  stacks_.push_back(stack);
+  frames_.insert(frames_.end(), frames.begin(), frames.end());
+}
+
+bool MinidumpUnwoundStackListWriter::Freeze() {
+  DCHECK_EQ(state(), kStateMutable);
+
+  if (!MinidumpStreamWriter::Freeze()) {
+    return false;
+  }
+
+  unwound_stack_list_base_.SizeOfHeader = sizeof(MinidumpUnwoundStackList);
+  unwound_stack_list_base_.SizeOfEntry = sizeof(MinidumpUnwoundStack);
+  unwound_stack_list_base_.SizeOfFrame = sizeof(MinidumpUnwoundFrame);
+  if (!AssignIfInRange(&unwound_stack_list_base_.NumberOfEntries,
+                       stacks_.size())) {
+    LOG(ERROR) << "unwound stack count " << stacks_.size() << " out of range";
+    return false;
+  }
+  if (!AssignIfInRange(&unwound_stack_list_base_.NumberOfFrames,
+                       frames_.size())) {
+    LOG(ERROR) << "unwound frame count " << frames_.size() << " out of range";
+    return false;
+  }
+
+  return true;
+}
+
+size_t MinidumpUnwoundStackListWriter::SizeOfObject() {
+  DCHECK_GE(state(), kStateFrozen);
+
+  return sizeof(unwound_stack_list_base_) +
+         stacks_.size() * sizeof(MinidumpUnwoundStack) +
+         frames_.size() * sizeof(MinidumpUnwoundFrame);
+}
+
+std::vector<internal::MinidumpWritable*>
+MinidumpUnwoundStackListWriter::Children() {
+  DCHECK_GE(state(), kStateFrozen);
+
+  return std::vector<internal::MinidumpWritable*>();
+}
+
+bool MinidumpUnwoundStackListWriter::WriteObject(
+    FileWriterInterface* file_writer) {
+  DCHECK_EQ(state(), kStateWritable);
+
+  WritableIoVec iov;
+  iov.iov_base = &unwound_stack_list_base_;
+  iov.iov_len = sizeof(unwound_stack_list_base_);
+  std::vector<WritableIoVec> iovecs(1, iov);
+
+  if (!stacks_.empty()) {
+    iov.iov_base = &stacks_[0];
+    iov.iov_len = stacks_.size() * sizeof(stacks_[0]);
+    iovecs.push_back(iov);
+  }
+
+  if (!frames_.empty()) {
+    iov.iov_base = &frames_[0];
+    iov.iov_len = frames_.size() * sizeof(frames_[0]);
+    iovecs.push_back(iov);
+  }
+
+  return file_writer->WriteIoVec(&iovecs);
+}
+
+MinidumpStreamType MinidumpUnwoundStackListWriter::StreamType() const {
+  return kMinidumpStreamTypeCrashpadUnwoundStacks;
+}
+
+}  // namespace crashpad
@@ -0,0 +1,96 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_MINIDUMP_MINIDUMP_UNWOUND_STACK_WRITER_H_
+#define CRASHPAD_MINIDUMP_MINIDUMP_UNWOUND_STACK_WRITER_H_
+
+#include <stdint.h>
+#include <sys/types.h>
+
+#include <vector>
+
+#include "minidump/minidump_extensions.h"
+#include "minidump/minidump_stream_writer.h"
+#include "minidump/minidump_thread_id_map.h"
+#include "minidump/minidump_writable.h"
+
+namespace crashpad {
+
+class ModuleSnapshot;
+class ThreadSnapshot;
+
+//! \brief The writer for a MinidumpUnwoundStackList stream in a minidump file,
+//!     containing a MinidumpUnwoundStack and its MinidumpUnwoundFrame objects
+//!     for each thread whose stack was unwound.
+class MinidumpUnwoundStackListWriter final
+    : public internal::MinidumpStreamWriter {
+ public:
+  MinidumpUnwoundStackListWriter();
+
+  MinidumpUnwoundStackListWriter(const MinidumpUnwoundStackListWriter&) =
+      delete;
+  MinidumpUnwoundStackListWriter& operator=(
+      const MinidumpUnwoundStackListWriter&) = delete;
+
+  ~MinidumpUnwoundStackListWriter() override;
+
+  //! \brief Adds a MinidumpUnwoundStack for each thread in \a thread_snapshots
+  //!     with unwound frames, locating each frame within \a module_snapshots.
+  //!
+  //! \param[in] thread_snapshots The thread snapshots to use as source data.
+  //! \param[in] module_snapshots The module snapshots written to the
+  //!     minidump’s module list, in the same order.
+  //! \param[in] thread_id_map A MinidumpThreadIDMap previously built by
+  //!     MinidumpThreadListWriter::InitializeFromSnapshot().
+  //!
+  //! \note Valid in #kStateMutable.
+  void InitializeFromSnapshot(
+      const std::vector<const ThreadSnapshot*>& thread_snapshots,
+      const std::vector<const ModuleSnapshot*>& module_snapshots,
+      const MinidumpThreadIDMap& thread_id_map);
+
+  //! \brief Adds the frames of the thread with ID \a thread_id to the
+  //!     MinidumpUnwoundStackList, innermost first.
+  //!
+  //! \note Valid in #kStateMutable.
+  void AddUnwoundStack(uint32_t thread_id,
+                       const std::vector<MinidumpUnwoundFrame>& frames);
+
+  //! \brief Determines whether the object is useful.
+  //!
+  //! A useful object is one that lists at least one thread. Because this
+  //! stream is an extension, it need not be written when it is not useful.
+  //!
+  //! \return `true` if the object is useful, `false` otherwise.
+  bool IsUseful() const { return !stacks_.empty(); }
+
+ protected:
+  // MinidumpWritable:
+  bool Freeze() override;
+  size_t SizeOfObject() override;
+  std::vector<internal::MinidumpWritable*> Children() override;
+  bool WriteObject(FileWriterInterface* file_writer) override;
+
+  // MinidumpStreamWriter:
+  MinidumpStreamType StreamType() const override;
+
+ private:
+  MinidumpUnwoundStackList unwound_stack_list_base_;
+  std::vector<MinidumpUnwoundStack> stacks_;
+  std::vector<MinidumpUnwoundFrame> frames_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_MINIDUMP_MINIDUMP_UNWOUND_STACK_WRITER_H_
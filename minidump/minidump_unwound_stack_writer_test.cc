@@ -0,0 +1,177 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "minidump/minidump_unwound_stack_writer.h"
+
+#include <string.h>
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "minidump/minidump_file_writer.h"
+#include "minidump/test/minidump_file_writer_test_util.h"
+#include "minidump/test/minidump_writable_test_util.h"
+#include "snapshot/test/test_module_snapshot.h"
+#include "snapshot/test/test_thread_snapshot.h"
+#include "util/file/string_file.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+// The unwound stack list is expected to be the only stream.
+void GetUnwoundStackListStream(
+    const std::string& file_contents,
+    const MinidumpUnwoundStackList** unwound_stack_list) {
+  constexpr size_t kDirectoryOffset = sizeof(MINIDUMP_HEADER);
+  constexpr size_t kUnwoundStackListStreamOffset =
+      kDirectoryOffset + sizeof(MINIDUMP_DIRECTORY);
+
+  const MINIDUMP_DIRECTORY* directory;
+  const MINIDUMP_HEADER* header =
+      MinidumpHeaderAtStart(file_contents, &directory);
+  ASSERT_NO_FATAL_FAILURE(VerifyMinidumpHeader(header, 1, 0));
+  ASSERT_TRUE(directory);
+
+  constexpr size_t kDirectoryIndex = 0;
+
+  ASSERT_EQ(directory[kDirectoryIndex].StreamType,
+            kMinidumpStreamTypeCrashpadUnwoundStacks);
+  EXPECT_EQ(directory[kDirectoryIndex].Location.Rva,
+            kUnwoundStackListStreamOffset);
+
+  *unwound_stack_list =
+      MinidumpWritableAtLocationDescriptor<MinidumpUnwoundStackList>(
+          file_contents, directory[kDirectoryIndex].Location);
+  ASSERT_TRUE(*unwound_stack_list);
+}
+
+TEST(MinidumpUnwoundStackWriter, Empty) {
+  MinidumpFileWriter minidump_file_writer;
+  auto unwound_stack_list_writer =
+      std::make_unique<MinidumpUnwoundStackListWriter>();
+  EXPECT_FALSE(unwound_stack_list_writer->IsUseful());
+  ASSERT_TRUE(
+      minidump_file_writer.AddStream(std::move(unwound_stack_list_writer)));
+
+  StringFile string_file;
+  ASSERT_TRUE(minidump_file_writer.WriteEverything(&string_file));
+
+  ASSERT_EQ(string_file.string().size(),
+            sizeof(MINIDUMP_HEADER) + sizeof(MINIDUMP_DIRECTORY) +
+                sizeof(MinidumpUnwoundStackList));
+
+  const MinidumpUnwoundStackList* unwound_stack_list = nullptr;
+  ASSERT_NO_FATAL_FAILURE(
+      GetUnwoundStackListStream(string_file.string(), &unwound_stack_list));
+
+  EXPECT_EQ(unwound_stack_list->SizeOfHeader,
+            sizeof(MinidumpUnwoundStackList));
+  EXPECT_EQ(unwound_stack_list->SizeOfEntry, sizeof(MinidumpUnwoundStack));
+  EXPECT_EQ(unwound_stack_list->NumberOfEntries, 0u);
+  EXPECT_EQ(unwound_stack_list->SizeOfFrame, sizeof(MinidumpUnwoundFrame));
+  EXPECT_EQ(unwound_stack_list->NumberOfFrames, 0u);
+}
+
+TEST(MinidumpUnwoundStackWriter, InitializeFromSnapshot) {
+  constexpr uint64_t kThreadID0 = 0x1111111111111111;
+  constexpr uint64_t kThreadID1 = 0x2222222222222222;
+  constexpr uint64_t kThreadID2 = 0x3333333333333333;
+  constexpr uint64_t kModuleAddress0 = 0x7f0000000000;
+  constexpr uint64_t kModuleAddress1 = 0x7f0000100000;
+  constexpr uint64_t kModuleSize = 0x10000;
+  constexpr uint64_t kUnknownAddress = 0x7f0000200000;
+
+  std::vector<std::unique_ptr<TestModuleSnapshot>> module_snapshots_owner;
+  for (uint64_t address : {kModuleAddress0, kModuleAddress1}) {
+    auto module_snapshot = std::make_unique<TestModuleSnapshot>();
+    module_snapshot->SetAddressAndSize(address, kModuleSize);
+    module_snapshots_owner.push_back(std::move(module_snapshot));
+  }
+  std::vector<const ModuleSnapshot*> module_snapshots;
+  for (const auto& module_snapshot : module_snapshots_owner) {
+    module_snapshots.push_back(module_snapshot.get());
+  }
+
+  // The second thread’s stack wasn’t unwound.
+  std::vector<std::unique_ptr<TestThreadSnapshot>> thread_snapshots_owner;
+  for (uint64_t thread_id : {kThreadID0, kThreadID1, kThreadID2}) {
+    auto thread_snapshot = std::make_unique<TestThreadSnapshot>();
+    thread_snapshot->SetThreadID(thread_id);
+    thread_snapshots_owner.push_back(std::move(thread_snapshot));
+  }
+  thread_snapshots_owner[0]->SetUnwoundFrames(
+      {kModuleAddress1 + 0x10, kModuleAddress0 + 0x20, kUnknownAddress});
+  thread_snapshots_owner[2]->SetUnwoundFrames({kModuleAddress0 + 0x30});
+  std::vector<const ThreadSnapshot*> thread_snapshots;
+  for (const auto& thread_snapshot : thread_snapshots_owner) {
+    thread_snapshots.push_back(thread_snapshot.get());
+  }
+
+  MinidumpThreadIDMap thread_id_map;
+  thread_id_map[kThreadID0] = 0;
+  thread_id_map[kThreadID1] = 1;
+  thread_id_map[kThreadID2] = 2;
+
+  MinidumpFileWriter minidump_file_writer;
+  auto unwound_stack_list_writer =
+      std::make_unique<MinidumpUnwoundStackListWriter>();
+  unwound_stack_list_writer->InitializeFromSnapshot(
+      thread_snapshots, module_snapshots, thread_id_map);
+  EXPECT_TRUE(unwound_stack_list_writer->IsUseful());
+  ASSERT_TRUE(
+      minidump_file_writer.AddStream(std::move(unwound_stack_list_writer)));
+
+  StringFile string_file;
+  ASSERT_TRUE(minidump_file_writer.WriteEverything(&string_file));
+
+  ASSERT_EQ(string_file.string().size(),
+            sizeof(MINIDUMP_HEADER) + sizeof(MINIDUMP_DIRECTORY) +
+                sizeof(MinidumpUnwoundStackList) +
+                2 * sizeof(MinidumpUnwoundStack) +
+                4 * sizeof(MinidumpUnwoundFrame));
+
+  const MinidumpUnwoundStackList* unwound_stack_list = nullptr;
+  ASSERT_NO_FATAL_FAILURE(
+      GetUnwoundStackListStream(string_file.string(), &unwound_stack_list));
+  ASSERT_EQ(unwound_stack_list->NumberOfEntries, 2u);
+  ASSERT_EQ(unwound_stack_list->NumberOfFrames, 4u);
+
+  MinidumpUnwoundStack stacks[2];
+  memcpy(stacks, &unwound_stack_list->Entries[0], sizeof(stacks));
+  EXPECT_EQ(stacks[0].ThreadId, 0u);
+  EXPECT_EQ(stacks[0].FirstFrame, 0u);
+  EXPECT_EQ(stacks[0].FrameCount, 3u);
+  EXPECT_EQ(stacks[1].ThreadId, 2u);
+  EXPECT_EQ(stacks[1].FirstFrame, 3u);
+  EXPECT_EQ(stacks[1].FrameCount, 1u);
+
+  MinidumpUnwoundFrame frames[4];
+  memcpy(frames, &unwound_stack_list->Entries[2], sizeof(frames));
+  EXPECT_EQ(frames[0].ModuleIndex, 1u);
+  EXPECT_EQ(frames[0].Offset, 0x10u);
+  EXPECT_EQ(frames[1].ModuleIndex, 0u);
+  EXPECT_EQ(frames[1].Offset, 0x20u);
+  EXPECT_EQ(frames[2].ModuleIndex, 0xffffffffu);
+  EXPECT_EQ(frames[2].Offset, kUnknownAddress);
+  EXPECT_EQ(frames[3].ModuleIndex, 0u);
+  EXPECT_EQ(frames[3].Offset, 0x30u);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
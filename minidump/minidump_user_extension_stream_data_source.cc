@@ -23,4 +23,8 @@ MinidumpUserExtensionStreamDataSource::MinidumpUserExtensionStreamDataSource(
 MinidumpUserExtensionStreamDataSource::
     ~MinidumpUserExtensionStreamDataSource() {}
 
+bool MinidumpUserExtensionStreamDataSource::IsStreaming() {
+  return false;
+}
+
 }  // namespace crashpad
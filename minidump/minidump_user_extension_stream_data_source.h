@@ -64,8 +64,24 @@ class MinidumpUserExtensionStreamDataSource {
   MinidumpStreamType stream_type() const { return stream_type_; }
 
   //! \brief The size of this data stream.
+  //!
+  //! This isn’t called for a streaming data source. See IsStreaming().
   virtual size_t StreamDataSize() = 0;
 
+  //! \brief Whether the size of this data stream is only known once its data
+  //!     has been read.
+  //!
+  //! A streaming data source may produce its data as it goes along, passing
+  //! any amount of it to the delegate, without computing all of it first to
+  //! know its size. StreamDataSize() isn’t called for it, and may return `0`.
+  //! When the minidump is written to a file that can be seeked in, its data
+  //! is written straight into the file, after all other data, and the
+  //! stream’s directory entry is updated with its size once it has been read.
+  //! Otherwise, its data is read into memory before the minidump is written.
+  //!
+  //! The default implementation returns `false`.
+  virtual bool IsStreaming();
+
   //! \brief Calls Delegate::UserStreamDataSourceRead(), providing it with
   //!     the stream data.
   //!
@@ -24,6 +24,8 @@ class MinidumpUserStreamWriter::ContentsWriter {
   virtual ~ContentsWriter() {}
   virtual bool WriteContents(FileWriterInterface* writer) = 0;
   virtual size_t GetSize() const = 0;
+  virtual bool IsStreaming() const { return false; }
+  virtual bool ReadStreamingContents() { return true; }
 };
 
 class MinidumpUserStreamWriter::SnapshotContentsWriter final
@@ -63,7 +65,12 @@ class MinidumpUserStreamWriter::ExtensionStreamContentsWriter final
  public:
   explicit ExtensionStreamContentsWriter(
       std::unique_ptr<MinidumpUserExtensionStreamDataSource> data_source)
-      : data_source_(std::move(data_source)), writer_(nullptr) {}
+      : data_source_(std::move(data_source)),
+        contents_(),
+        writer_(nullptr),
+        size_written_(0),
+        streaming_(data_source_->IsStreaming()),
+        read_(false) {}
 
   ExtensionStreamContentsWriter(const ExtensionStreamContentsWriter&) = delete;
   ExtensionStreamContentsWriter& operator=(
@@ -72,19 +79,57 @@ class MinidumpUserStreamWriter::ExtensionStreamContentsWriter final
   bool WriteContents(FileWriterInterface* writer) override {
     DCHECK(!writer_);
 
+    if (read_) {
+      return writer->Write(contents_.data(), contents_.size());
+    }
+
     writer_ = writer;
     return data_source_->ReadStreamData(this);
   }
 
-  size_t GetSize() const override { return data_source_->StreamDataSize(); }
+  size_t GetSize() const override {
+    if (read_) {
+      return contents_.size();
+    }
+    return streaming_ ? size_written_ : data_source_->StreamDataSize();
+  }
+
+  bool IsStreaming() const override { return streaming_ && !read_; }
+
+  bool ReadStreamingContents() override {
+    if (!IsStreaming()) {
+      return true;
+    }
+
+    if (!data_source_->ReadStreamData(this)) {
+      contents_.clear();
+      return false;
+    }
+    read_ = true;
+    return true;
+  }
 
   bool ExtensionStreamDataSourceRead(const void* data, size_t size) override {
+    if (!writer_) {
+      const uint8_t* bytes = static_cast<const uint8_t*>(data);
+      contents_.insert(contents_.end(), bytes, bytes + size);
+      return true;
+    }
+
+    size_written_ += size;
     return writer_->Write(data, size);
   }
 
  private:
   std::unique_ptr<MinidumpUserExtensionStreamDataSource> data_source_;
+
+  // The contents of a streaming data source read by ReadStreamingContents().
+  std::vector<uint8_t> contents_;
+
   FileWriterInterface* writer_;
+  size_t size_written_;
+  const bool streaming_;
+  bool read_;
 };
 
 MinidumpUserStreamWriter::MinidumpUserStreamWriter() : stream_type_() {}
@@ -111,6 +156,16 @@ void MinidumpUserStreamWriter::InitializeFromUserExtensionStream(
       std::make_unique<ExtensionStreamContentsWriter>(std::move(data_source));
 }
 
+bool MinidumpUserStreamWriter::IsStreaming() const {
+  return contents_writer_->IsStreaming();
+}
+
+bool MinidumpUserStreamWriter::ReadStreamingContents() {
+  DCHECK_EQ(state(), kStateMutable);
+
+  return contents_writer_->ReadStreamingContents();
+}
+
 bool MinidumpUserStreamWriter::Freeze() {
   DCHECK_EQ(state(), kStateMutable);
   DCHECK_NE(stream_type_, 0u);
@@ -129,6 +184,10 @@ MinidumpUserStreamWriter::Children() {
   return std::vector<internal::MinidumpWritable*>();
 }
 
+internal::MinidumpWritable::Phase MinidumpUserStreamWriter::WritePhase() {
+  return IsStreaming() ? kPhaseLast : kPhaseEarly;
+}
+
 bool MinidumpUserStreamWriter::WriteObject(FileWriterInterface* file_writer) {
   DCHECK_EQ(state(), kStateWritable);
 
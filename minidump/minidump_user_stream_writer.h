@@ -55,11 +55,30 @@ class MinidumpUserStreamWriter final : public internal::MinidumpStreamWriter {
   void InitializeFromUserExtensionStream(
       std::unique_ptr<MinidumpUserExtensionStreamDataSource> data_source);
 
+  //! \brief Whether the stream’s contents come from a streaming data source
+  //!     that hasn’t been read by ReadStreamingContents().
+  //!
+  //! Such a stream is written in #kPhaseLast. See
+  //! MinidumpUserExtensionStreamDataSource::IsStreaming().
+  bool IsStreaming() const;
+
+  //! \brief Reads the contents of a streaming stream into memory, so that its
+  //!     size is known before it is written, as for a file that can’t be
+  //!     seeked in.
+  //!
+  //! This does nothing if the stream isn’t streaming.
+  //!
+  //! \return `true` on success. `false` if the data source fails.
+  //!
+  //! \note Valid in #kStateMutable.
+  bool ReadStreamingContents();
+
  protected:
   // MinidumpWritable:
   bool Freeze() override;
   size_t SizeOfObject() override;
   std::vector<internal::MinidumpWritable*> Children() override;
+  Phase WritePhase() override;
   bool WriteObject(FileWriterInterface* file_writer) override;
 
   // MinidumpStreamWriter:
@@ -55,6 +55,48 @@ void GetUserStream(const std::string& file_contents,
 constexpr MinidumpStreamType kTestStreamId =
     static_cast<MinidumpStreamType>(0x123456);
 
+// Produces its data in chunks, without knowing its size in advance.
+class StreamingExtensionStreamDataSource final
+    : public MinidumpUserExtensionStreamDataSource {
+ public:
+  StreamingExtensionStreamDataSource(uint32_t stream_type,
+                                     size_t chunks,
+                                     size_t chunk_size,
+                                     char value)
+      : MinidumpUserExtensionStreamDataSource(stream_type),
+        chunks_(chunks),
+        chunk_size_(chunk_size),
+        value_(value) {}
+
+  StreamingExtensionStreamDataSource(
+      const StreamingExtensionStreamDataSource&) = delete;
+  StreamingExtensionStreamDataSource& operator=(
+      const StreamingExtensionStreamDataSource&) = delete;
+
+  size_t StreamDataSize() override {
+    ADD_FAILURE() << "size requested from a streaming data source";
+    return 0;
+  }
+
+  bool ReadStreamData(Delegate* delegate) override {
+    const std::string chunk(chunk_size_, value_);
+    for (size_t index = 0; index < chunks_; ++index) {
+      if (!delegate->ExtensionStreamDataSourceRead(chunk.data(),
+                                                   chunk.size())) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  bool IsStreaming() override { return true; }
+
+ private:
+  size_t chunks_;
+  size_t chunk_size_;
+  char value_;
+};
+
 TEST(MinidumpUserStreamWriter, InitializeFromSnapshotNoData) {
   MinidumpFileWriter minidump_file_writer;
   auto user_stream_writer = std::make_unique<MinidumpUserStreamWriter>();
@@ -144,6 +186,88 @@ TEST(MinidumpUserStreamWriter, InitializeFromBufferOneStream) {
   EXPECT_EQ(stream_data, std::string(kStreamSize, 'c'));
 }
 
+TEST(MinidumpUserStreamWriter, StreamingWrittenLast) {
+  constexpr MinidumpStreamType kStreamingStreamId0 =
+      static_cast<MinidumpStreamType>(0x123457);
+  constexpr MinidumpStreamType kStreamingStreamId1 =
+      static_cast<MinidumpStreamType>(0x123458);
+  constexpr size_t kChunkSize = 1000;
+  constexpr size_t kBufferSize = 16;
+
+  MinidumpFileWriter minidump_file_writer;
+  ASSERT_TRUE(minidump_file_writer.AddUserExtensionStream(
+      std::make_unique<StreamingExtensionStreamDataSource>(
+          kStreamingStreamId0, 3, kChunkSize, 'a')));
+  std::vector<uint8_t> data(kBufferSize, 'b');
+  ASSERT_TRUE(minidump_file_writer.AddUserExtensionStream(
+      std::make_unique<test::BufferExtensionStreamDataSource>(
+          kTestStreamId, &data[0], data.size())));
+  ASSERT_TRUE(minidump_file_writer.AddUserExtensionStream(
+      std::make_unique<StreamingExtensionStreamDataSource>(
+          kStreamingStreamId1, 2, kChunkSize + 1, 'c')));
+
+  StringFile string_file;
+  ASSERT_TRUE(minidump_file_writer.WriteEverything(&string_file));
+
+  constexpr size_t kBufferOffset =
+      sizeof(MINIDUMP_HEADER) + 3 * sizeof(MINIDUMP_DIRECTORY);
+  constexpr size_t kStreamingOffset0 = kBufferOffset + kBufferSize;
+  constexpr size_t kStreamingOffset1 = kStreamingOffset0 + 3 * kChunkSize;
+  ASSERT_EQ(string_file.string().size(),
+            kStreamingOffset1 + 2 * (kChunkSize + 1));
+
+  const MINIDUMP_DIRECTORY* directory;
+  const MINIDUMP_HEADER* header =
+      MinidumpHeaderAtStart(string_file.string(), &directory);
+  ASSERT_NO_FATAL_FAILURE(VerifyMinidumpHeader(header, 3, 0));
+  ASSERT_TRUE(directory);
+
+  // The directory keeps the order in which the streams were added, but the
+  // streaming streams’ data follows everything else.
+  EXPECT_EQ(directory[0].StreamType, kStreamingStreamId0);
+  EXPECT_EQ(directory[0].Location.Rva, kStreamingOffset0);
+  EXPECT_EQ(directory[0].Location.DataSize, 3 * kChunkSize);
+  EXPECT_EQ(directory[1].StreamType, kTestStreamId);
+  EXPECT_EQ(directory[1].Location.Rva, kBufferOffset);
+  EXPECT_EQ(directory[1].Location.DataSize, kBufferSize);
+  EXPECT_EQ(directory[2].StreamType, kStreamingStreamId1);
+  EXPECT_EQ(directory[2].Location.Rva, kStreamingOffset1);
+  EXPECT_EQ(directory[2].Location.DataSize, 2 * (kChunkSize + 1));
+
+  EXPECT_EQ(string_file.string().substr(kBufferOffset, kBufferSize),
+            std::string(kBufferSize, 'b'));
+  EXPECT_EQ(string_file.string().substr(kStreamingOffset0, 3 * kChunkSize),
+            std::string(3 * kChunkSize, 'a'));
+  EXPECT_EQ(string_file.string().substr(kStreamingOffset1),
+            std::string(2 * (kChunkSize + 1), 'c'));
+}
+
+TEST(MinidumpUserStreamWriter, StreamingWithoutSeeking) {
+  constexpr size_t kChunkSize = 100;
+
+  MinidumpFileWriter minidump_file_writer;
+  ASSERT_TRUE(minidump_file_writer.AddUserExtensionStream(
+      std::make_unique<StreamingExtensionStreamDataSource>(
+          kTestStreamId, 4, kChunkSize, 'd')));
+
+  // Without seeking, the stream is read into memory and written in order.
+  StringFile string_file;
+  ASSERT_TRUE(minidump_file_writer.WriteMinidump(&string_file, false));
+
+  ASSERT_EQ(string_file.string().size(),
+            sizeof(MINIDUMP_HEADER) + sizeof(MINIDUMP_DIRECTORY) +
+                4 * kChunkSize);
+
+  MINIDUMP_LOCATION_DESCRIPTOR user_stream_location = {};
+  ASSERT_NO_FATAL_FAILURE(GetUserStream(string_file.string(),
+                                        &user_stream_location,
+                                        kTestStreamId,
+                                        4 * kChunkSize));
+  const std::string stream_data = string_file.string().substr(
+      user_stream_location.Rva, user_stream_location.DataSize);
+  EXPECT_EQ(stream_data, std::string(4 * kChunkSize, 'd'));
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace crashpad
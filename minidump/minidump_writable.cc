@@ -14,11 +14,19 @@
 
 #include "minidump/minidump_writable.h"
 
+#include <stddef.h>
 #include <stdint.h>
 
+#include <algorithm>
 #include <iterator>
+#include <new>
+#include <string>
+#include <unordered_map>
+#include <utility>
 
 #include "base/logging.h"
+#include "minidump/minidump_writable_arena.h"
+#include "util/file/buffered_file_writer.h"
 #include "util/file/file_writer.h"
 #include "util/numeric/safe_assignment.h"
 
@@ -26,6 +34,12 @@ namespace {
 
 constexpr size_t kMaximumAlignment = 16;
 
+// Precedes every MinidumpWritable object in memory, recording where its storage
+// came from so that operator delete can return it to the right place.
+struct alignas(max_align_t) AllocationHeader {
+  crashpad::internal::MinidumpWritableArena* arena;  // weak
+};
+
 }  // namespace
 
 namespace crashpad {
@@ -34,6 +48,31 @@ namespace internal {
 MinidumpWritable::~MinidumpWritable() {
 }
 
+// static
+void* MinidumpWritable::operator new(size_t size) {
+  MinidumpWritableArena* arena = MinidumpWritableArena::Current();
+  const size_t allocation_size = sizeof(AllocationHeader) + size;
+  void* storage = arena ? arena->Allocate(allocation_size)
+                        : ::operator new(allocation_size);
+  AllocationHeader* header = new (storage) AllocationHeader();
+  header->arena = arena;
+  return header + 1;
+}
+
+// static
+void MinidumpWritable::operator delete(void* pointer) {
+  if (!pointer) {
+    return;
+  }
+
+  AllocationHeader* header = static_cast<AllocationHeader*>(pointer) - 1;
+  if (header->arena) {
+    header->arena->Release(header);
+  } else {
+    ::operator delete(header);
+  }
+}
+
 bool MinidumpWritable::WriteEverything(FileWriterInterface* file_writer) {
   DCHECK_EQ(state_, kStateMutable);
 
@@ -43,25 +82,107 @@ bool MinidumpWritable::WriteEverything(FileWriterInterface* file_writer) {
 
   DCHECK_EQ(state_, kStateFrozen);
 
+  // Flatten the tree in a single traversal. Within each phase, objects are laid
+  // out in preorder, so a stable sort by phase yields the order in which
+  // they’ll appear in the file.
+  std::vector<LayoutEntry> layout;
+  std::vector<MinidumpWritable*> pending(1, this);
+  while (!pending.empty()) {
+    MinidumpWritable* writable = pending.back();
+    pending.pop_back();
+    layout.push_back({writable, writable->WritePhase()});
+
+    std::vector<MinidumpWritable*> children = writable->Children();
+    pending.insert(pending.end(), children.rbegin(), children.rend());
+  }
+
+  std::stable_sort(layout.begin(),
+                   layout.end(),
+                   [](const LayoutEntry& lhs, const LayoutEntry& rhs) {
+                     return lhs.phase < rhs.phase;
+                   });
+
+  // Objects in kPhaseLast are laid out as they’re written, because the size
+  // of each is needed to know where the next one starts.
+  const auto last_phase = std::find_if(
+      layout.begin(), layout.end(), [](const LayoutEntry& entry) {
+        return entry.phase == kPhaseLast;
+      });
+
+  // When sharing is enabled, an object identical to one already laid out
+  // shares that object’s location instead of being written again.
+  std::unordered_map<std::string, FileOffset> shared_offsets;
+
   FileOffset offset = 0;
-  std::vector<MinidumpWritable*> write_sequence;
-  size_t size = WillWriteAtOffset(kPhaseEarly, &offset, &write_sequence);
-  if (size == kInvalidSize) {
-    return false;
+  for (auto entry = layout.begin(); entry != last_phase; ++entry) {
+    MinidumpWritable* writable = entry->writable;
+    std::string key;
+    if (!share_identical_objects_ || !writable->SharingKey(&key)) {
+      if (!writable->WillWriteAtOffset(&offset)) {
+        return false;
+      }
+      continue;
+    }
+
+    auto shared_offset = shared_offsets.find(key);
+    if (shared_offset != shared_offsets.end() &&
+        shared_offset->second % writable->Alignment() == 0) {
+      if (!writable->WillShareOffset(shared_offset->second)) {
+        return false;
+      }
+      continue;
+    }
+
+    if (!writable->WillWriteAtOffset(&offset)) {
+      return false;
+    }
+    if (shared_offset == shared_offsets.end()) {
+      shared_offsets.emplace(std::move(key),
+                             offset - writable->SizeOfObject());
+    }
   }
 
-  offset += size;
-  if (WillWriteAtOffset(kPhaseLate, &offset, &write_sequence) == kInvalidSize) {
+  DCHECK_EQ(state_, kStateWritable);
+  DCHECK_EQ(layout.front().writable, this);
+
+  // Everything but kPhaseLast objects has been laid out, so the size of most
+  // of the file is known before writing it.
+  if (!file_writer->ReserveSpace(offset)) {
     return false;
   }
 
-  DCHECK_EQ(state_, kStateWritable);
-  DCHECK_EQ(write_sequence.front(), this);
+  BufferedFileWriter buffered_file_writer(file_writer);
+  for (auto entry = layout.begin(); entry != last_phase; ++entry) {
+    if (!entry->writable->WritePaddingAndObject(&buffered_file_writer)) {
+      return false;
+    }
+  }
 
-  for (MinidumpWritable* writable : write_sequence) {
-    if (!writable->WritePaddingAndObject(file_writer)) {
+  for (auto entry = last_phase; entry != layout.end(); ++entry) {
+    MinidumpWritable* writable = entry->writable;
+    if (!writable->WillWriteAtOffset(&offset)) {
       return false;
     }
+    DCHECK_EQ(writable->leading_pad_bytes_, 0u);
+
+    if (!writable->WritePaddingAndObject(&buffered_file_writer)) {
+      return false;
+    }
+
+    const size_t size = writable->SizeOfObject();
+    if (!writable->UpdateLocationDescriptorSizes(size)) {
+      return false;
+    }
+
+    auto end_offset = offset + size;
+    if (!AssignIfInRange(&offset, end_offset)) {
+      LOG(ERROR) << "offset " << end_offset << " out of range";
+      return false;
+    }
+  }
+
+  if (!buffered_file_writer.Flush()) {
+    return false;
   }
 
   DCHECK_EQ(state_, kStateWritten);
@@ -101,7 +222,9 @@ MinidumpWritable::MinidumpWritable()
       registered_location_descriptors_(),
       registered_location_descriptor64s_(),
       leading_pad_bytes_(0),
-      state_(kStateMutable) {}
+      state_(kStateMutable),
+      share_identical_objects_(false),
+      shared_(false) {}
 
 bool MinidumpWritable::Freeze() {
   DCHECK_EQ(state_, kStateMutable);
@@ -133,163 +256,190 @@ MinidumpWritable::Phase MinidumpWritable::WritePhase() {
   return kPhaseEarly;
 }
 
-size_t MinidumpWritable::WillWriteAtOffset(
-    Phase phase,
-    FileOffset* offset,
-    std::vector<MinidumpWritable*>* write_sequence) {
+bool MinidumpWritable::WillWriteAtOffset(FileOffset* offset) {
+  DCHECK_EQ(state_, kStateFrozen);
+
   FileOffset local_offset = *offset;
   CHECK_GE(local_offset, 0);
 
-  size_t leading_pad_bytes_this_phase;
-  size_t size;
-  if (phase == WritePhase()) {
-    DCHECK_EQ(state_, kStateFrozen);
-
-    // Add this object to the sequence of MinidumpWritable objects to be
-    // written.
-    write_sequence->push_back(this);
-
-    size = SizeOfObject();
-
-    if (size > 0) {
-      // Honor this object’s request to be aligned to a specific byte boundary.
-      // Once the alignment is corrected, this object knows exactly what file
-      // offset it will be written at.
-      size_t alignment = Alignment();
-      CHECK_LE(alignment, kMaximumAlignment);
-
-      leading_pad_bytes_this_phase =
-          (alignment - (local_offset % alignment)) % alignment;
-      local_offset += leading_pad_bytes_this_phase;
-      *offset = local_offset;
-    } else {
-      // If the object is size 0, alignment is of no concern.
-      leading_pad_bytes_this_phase = 0;
+  size_t size = SizeOfObject();
+
+  if (size > 0) {
+    // Honor this object’s request to be aligned to a specific byte boundary.
+    // Once the alignment is corrected, this object knows exactly what file
+    // offset it will be written at.
+    size_t alignment = Alignment();
+    CHECK_LE(alignment, kMaximumAlignment);
+
+    leading_pad_bytes_ = (alignment - (local_offset % alignment)) % alignment;
+    local_offset += leading_pad_bytes_;
+  } else {
+    // If the object is size 0, alignment is of no concern.
+    leading_pad_bytes_ = 0;
+  }
+
+  // Now that the file offset that this object will be written at is known,
+  // let the subclass implementation know in case it’s interested.
+  if (!WillWriteAtOffsetImpl(local_offset)) {
+    return false;
+  }
+
+  if (!UpdateRegisteredPointers(local_offset, size)) {
+    return false;
+  }
+
+  // This object is now considered writable. However, if it contains RVA/RVA64
+  // or MINIDUMP_LOCATION_DESCRIPTOR/MINIDUMP_LOCATION_DESCRIPTOR64 fields,
+  // they may not be fully updated yet, because it’s the repsonsibility of
+  // these fields’ pointees to update them. Once WillWriteAtOffset has run on
+  // every object in a tree, and the entire tree has moved into kStateWritable,
+  // all RVA/RVA64 and
+  // MINIDUMP_LOCATION_DESCRIPTOR/MINIDUMP_LOCATION_DESCRIPTOR64 fields within
+  // that tree will be populated.
+  state_ = kStateWritable;
+
+  // Use “auto” here because it’s impossible to know whether size_t (size) or
+  // FileOffset (local_offset) is the wider type, and thus what type the result
+  // of adding these two variables will have.
+  auto end_offset = local_offset + size;
+  if (!AssignIfInRange(offset, end_offset)) {
+    LOG(ERROR) << "offset " << end_offset << " out of range";
+    return false;
+  }
+
+  return true;
+}
+
+bool MinidumpWritable::WillShareOffset(FileOffset offset) {
+  DCHECK_EQ(state_, kStateFrozen);
+
+  // This object won’t be written. Everything that points to it points to the
+  // identical object already laid out at offset instead.
+  shared_ = true;
+  leading_pad_bytes_ = 0;
+  if (!UpdateRegisteredPointers(offset, SizeOfObject())) {
+    return false;
+  }
+
+  state_ = kStateWritable;
+  return true;
+}
+
+bool MinidumpWritable::UpdateRegisteredPointers(FileOffset offset,
+                                                size_t size) {
+  // Populate the 32-bit RVA fields in other objects that have registered to
+  // point to this one. Typically, a parent object will have registered to
+  // point to its children, but this can also occur where no parent-child
+  // relationship exists.
+  if (!registered_rvas_.empty() ||
+      !registered_location_descriptors_.empty()) {
+    RVA local_rva;
+    if (!AssignIfInRange(&local_rva, offset)) {
+      LOG(ERROR) << "offset " << offset << " out of range";
+      return false;
     }
-    leading_pad_bytes_ = leading_pad_bytes_this_phase;
 
-    // Now that the file offset that this object will be written at is known,
-    // let the subclass implementation know in case it’s interested.
-    if (!WillWriteAtOffsetImpl(local_offset)) {
-      return kInvalidSize;
+    for (RVA* rva : registered_rvas_) {
+      *rva = local_rva;
     }
 
-    // Populate the 32-bit RVA fields in other objects that have registered to
-    // point to this one. Typically, a parent object will have registered to
-    // point to its children, but this can also occur where no parent-child
-    // relationship exists.
-    if (!registered_rvas_.empty() ||
-        !registered_location_descriptors_.empty()) {
-      RVA local_rva;
-      if (!AssignIfInRange(&local_rva, local_offset)) {
-        LOG(ERROR) << "offset " << local_offset << " out of range";
-        return kInvalidSize;
+    if (!registered_location_descriptors_.empty()) {
+      decltype(registered_location_descriptors_[0]->DataSize) local_size;
+      if (!AssignIfInRange(&local_size, size)) {
+        LOG(ERROR) << "size " << size << " out of range";
+        return false;
       }
 
-      for (RVA* rva : registered_rvas_) {
-        *rva = local_rva;
+      for (MINIDUMP_LOCATION_DESCRIPTOR* location_descriptor :
+               registered_location_descriptors_) {
+        location_descriptor->DataSize = local_size;
+        location_descriptor->Rva = local_rva;
       }
+    }
+  }
 
-      if (!registered_location_descriptors_.empty()) {
-        decltype(registered_location_descriptors_[0]->DataSize) local_size;
-        if (!AssignIfInRange(&local_size, size)) {
-          LOG(ERROR) << "size " << size << " out of range";
-          return kInvalidSize;
-        }
-
-        for (MINIDUMP_LOCATION_DESCRIPTOR* location_descriptor :
-                 registered_location_descriptors_) {
-          location_descriptor->DataSize = local_size;
-          location_descriptor->Rva = local_rva;
-        }
-      }
+  // Populate the 64-bit RVA fields in other objects that have registered to
+  // point to this one. Typically, a parent object will have registered to
+  // point to its children, but this can also occur where no parent-child
+  // relationship exists.
+  if (!registered_rva64s_.empty() ||
+      !registered_location_descriptor64s_.empty()) {
+    RVA64 local_rva64;
+    if (!AssignIfInRange(&local_rva64, offset)) {
+      LOG(ERROR) << "offset " << offset << " out of range";
+      return false;
     }
 
-    // Populate the 64-bit RVA fields in other objects that have registered to
-    // point to this one. Typically, a parent object will have registered to
-    // point to its children, but this can also occur where no parent-child
-    // relationship exists.
-    if (!registered_rva64s_.empty() ||
-        !registered_location_descriptor64s_.empty()) {
-      RVA64 local_rva64;
-      if (!AssignIfInRange(&local_rva64, local_offset)) {
-        LOG(ERROR) << "offset " << local_offset << " out of range";
-        return kInvalidSize;
-      }
+    for (RVA64* rva64 : registered_rva64s_) {
+      *rva64 = local_rva64;
+    }
 
-      for (RVA64* rva64 : registered_rva64s_) {
-        *rva64 = local_rva64;
+    if (!registered_location_descriptor64s_.empty()) {
+      decltype(registered_location_descriptor64s_[0]->DataSize) local_size;
+      if (!AssignIfInRange(&local_size, size)) {
+        LOG(ERROR) << "size " << size << " out of range";
+        return false;
       }
 
-      if (!registered_location_descriptor64s_.empty()) {
-        decltype(registered_location_descriptor64s_[0]->DataSize) local_size;
-        if (!AssignIfInRange(&local_size, size)) {
-          LOG(ERROR) << "size " << size << " out of range";
-          return kInvalidSize;
-        }
-
-        for (MINIDUMP_LOCATION_DESCRIPTOR64* location_descriptor :
-             registered_location_descriptor64s_) {
-          location_descriptor->DataSize = local_size;
-          location_descriptor->Rva = local_rva64;
-        }
+      for (MINIDUMP_LOCATION_DESCRIPTOR64* location_descriptor :
+           registered_location_descriptor64s_) {
+        location_descriptor->DataSize = local_size;
+        location_descriptor->Rva = local_rva64;
       }
     }
+  }
 
-    // This object is now considered writable. However, if it contains RVA/RVA64
-    // or MINIDUMP_LOCATION_DESCRIPTOR/MINIDUMP_LOCATION_DESCRIPTOR64 fields,
-    // they may not be fully updated yet, because it’s the repsonsibility of
-    // these fields’ pointees to update them. Once WillWriteAtOffset has
-    // completed running for both phases on an entire tree, and the entire tree
-    // has moved into kStateFrozen, all RVA/RVA64 and
-    // MINIDUMP_LOCATION_DESCRIPTOR/MINIDUMP_LOCATION_DESCRIPTOR64 fields within
-    // that tree will be populated.
-    state_ = kStateWritable;
-  } else {
-    if (phase == kPhaseEarly) {
-      DCHECK_EQ(state_, kStateFrozen);
-    } else {
-      DCHECK_EQ(state_, kStateWritable);
+  return true;
+}
+
+bool MinidumpWritable::SharingKey(std::string* key) {
+  return false;
+}
+
+bool MinidumpWritable::WillWriteAtOffsetImpl(FileOffset offset) {
+  return true;
+}
+
+bool MinidumpWritable::UpdateLocationDescriptorSizes(size_t size) {
+  DCHECK_EQ(state_, kStateWritten);
+
+  if (!registered_location_descriptors_.empty()) {
+    decltype(registered_location_descriptors_[0]->DataSize) local_size;
+    if (!AssignIfInRange(&local_size, size)) {
+      LOG(ERROR) << "size " << size << " out of range";
+      return false;
     }
 
-    size = 0;
-    leading_pad_bytes_this_phase = 0;
+    for (MINIDUMP_LOCATION_DESCRIPTOR* location_descriptor :
+         registered_location_descriptors_) {
+      location_descriptor->DataSize = local_size;
+    }
   }
 
-  // Loop over children regardless of whether this object itself will write
-  // during this phase. An object’s children are not required to be written
-  // during the same phase as their parent.
-  std::vector<MinidumpWritable*> children = Children();
-  for (MinidumpWritable* child : children) {
-    // Use “auto” here because it’s impossible to know whether size_t (size) or
-    // FileOffset (local_offset) is the wider type, and thus what type the
-    // result of adding these two variables will have.
-    auto unaligned_child_offset = local_offset + size;
-    FileOffset child_offset;
-    if (!AssignIfInRange(&child_offset, unaligned_child_offset)) {
-      LOG(ERROR) << "offset " << unaligned_child_offset << " out of range";
-      return kInvalidSize;
+  if (!registered_location_descriptor64s_.empty()) {
+    decltype(registered_location_descriptor64s_[0]->DataSize) local_size;
+    if (!AssignIfInRange(&local_size, size)) {
+      LOG(ERROR) << "size " << size << " out of range";
+      return false;
     }
 
-    size_t child_size =
-        child->WillWriteAtOffset(phase, &child_offset, write_sequence);
-    if (child_size == kInvalidSize) {
-      return kInvalidSize;
+    for (MINIDUMP_LOCATION_DESCRIPTOR64* location_descriptor :
+         registered_location_descriptor64s_) {
+      location_descriptor->DataSize = local_size;
     }
-
-    size += child_size;
   }
 
-  return leading_pad_bytes_this_phase + size;
-}
-
-bool MinidumpWritable::WillWriteAtOffsetImpl(FileOffset offset) {
   return true;
 }
 
 bool MinidumpWritable::WritePaddingAndObject(FileWriterInterface* file_writer) {
   DCHECK_EQ(state_, kStateWritable);
 
+  if (shared_) {
+    state_ = kStateWritten;
+    return true;
+  }
+
   // The number of elements in kZeroes must be at least one less than the
   // maximum Alignment() ever encountered.
   static constexpr uint8_t kZeroes[kMaximumAlignment - 1] = {};
@@ -19,7 +19,7 @@
 #include <dbghelp.h>
 #include <sys/types.h>
 
-#include <limits>
+#include <string>
 #include <vector>
 
 #include "util/file/file_io.h"
@@ -39,6 +39,13 @@ class MinidumpWritable {
 
   virtual ~MinidumpWritable();
 
+  //! \brief Allocates storage for a MinidumpWritable object.
+  //!
+  //! If a MinidumpWritableArena::Scope is active on the calling thread, the
+  //! storage is taken from its arena. Otherwise, it comes from the heap.
+  static void* operator new(size_t size);
+  static void operator delete(void* pointer);
+
   //! \brief Writes an object and all of its children to a minidump file.
   //!
   //! Use this on the root object of a tree of MinidumpWritable objects,
@@ -136,17 +143,40 @@ class MinidumpWritable {
     //! other data, memory snapshots are large and do not usually need to be
     //! consulted in their entirety in order to process a minidump file.
     kPhaseLate,
-  };
 
-  //! \brief A size value used to signal failure by methods that return
-  //!     `size_t`.
-  static constexpr size_t kInvalidSize = std::numeric_limits<size_t>::max();
+    //! \brief Objects whose size is only known once they’ve been written.
+    //!
+    //! These objects are written after all others, one after another. Each is
+    //! placed at the file offset where the object before it ended. Its
+    //! SizeOfObject() must return `0` until it has been written, and the
+    //! number of bytes it wrote afterwards. It gets no alignment padding,
+    //! because its offset isn’t known in advance. Its registered RVAs and
+    //! location descriptors are filled in as it is written, after the objects
+    //! containing them have already been written. Whoever owns those objects
+    //! must write them again to update them, as MinidumpFileWriter does with
+    //! its stream directory.
+    kPhaseLast,
+  };
 
   MinidumpWritable();
 
   //! \brief The state of the object.
   State state() const { return state_; }
 
+  //! \brief Enables sharing of identical objects when WriteEverything() is
+  //!     called on this object.
+  //!
+  //! When enabled, an object in the tree whose SharingKey() matches that of an
+  //! object already laid out is not written. RVAs and location descriptors
+  //! registered with it point to the earlier object instead. This is off by
+  //! default, and is normally only enabled on the root of an entire minidump
+  //! file.
+  //!
+  //! \note Valid in #kStateMutable or #kStateFrozen.
+  void SetShareIdenticalObjects(bool share) {
+    share_identical_objects_ = share;
+  }
+
   //! \brief Transitions the object from #kStateMutable to #kStateFrozen.
   //!
   //! The default implementation marks the object as frozen and recursively
@@ -190,6 +220,22 @@ class MinidumpWritable {
   //! \note Valid in any state.
   virtual Phase WritePhase();
 
+  //! \brief Identifies the content of an object that may be shared with other
+  //!     objects having identical content.
+  //!
+  //! The default implementation returns `false`. Subclasses whose objects have
+  //! no children, don’t handle RVAs themselves in WillWriteAtOffsetImpl(), and
+  //! are frequently duplicated may override this method. Objects that return
+  //! the same \a key must write exactly the same bytes in WriteObject().
+  //!
+  //! \param[out] key A key identifying the object’s content.
+  //!
+  //! \return `true` if the object may be shared, with \a key set. `false`
+  //!     otherwise.
+  //!
+  //! \note Valid in #kStateFrozen or any subsequent state.
+  virtual bool SharingKey(std::string* key);
+
   //! \brief Prepares the object to be written at a known file offset,
   //!     transitioning it from #kStateFrozen to #kStateWritable.
   //!
@@ -197,30 +243,26 @@ class MinidumpWritable {
   //! object, which may be increased from \a offset to meet alignment
   //! requirements. It calls WillWriteAtOffsetImpl() for the benefit of
   //! subclasses. It populates all RVAs and location descriptors registered with
-  //! it via RegisterRVA() and RegisterLocationDescriptor(). It also recurses
-  //! into all known children.
+  //! it via RegisterRVA() and RegisterLocationDescriptor().
   //!
-  //! \param[in] phase The phase during which the object will be written. If
-  //!     this does not match Phase(), processing is suppressed, although
-  //!     recursive processing will still occur on all children. This addresses
-  //!     the case where parents and children do not write in the same phase.
-  //! \param[in] offset The file offset at which the object will be written. The
-  //!     offset may need to be adjusted for alignment.
-  //! \param[out] write_sequence This object will append itself to this list,
-  //!     such that on return from a recursive tree of WillWriteAtOffset()
-  //!     calls, elements of the vector will be organized in the sequence that
-  //!     the objects will be written to the minidump file.
+  //! WriteEverything() calls this method on each object in the tree in the
+  //! order that the objects will be written: those in #kPhaseEarly followed by
+  //! those in #kPhaseLate, each in preorder. Children are not visited here.
+  //! Objects in #kPhaseLast are only laid out as they are about to be written,
+  //! after all other objects have been written.
   //!
-  //! \return The file size consumed by this object and all children, including
-  //!     any padding inserted to meet alignment requirements. On failure,
-  //!     #kInvalidSize, with an appropriate message logged.
+  //! \param[in,out] offset On entry, the file offset following the previously
+  //!     laid-out object. The object may be placed after this to meet
+  //!     alignment requirements. On successful return, the file offset
+  //!     following this object.
+  //!
+  //! \return `true` on success. `false` on failure, with an appropriate message
+  //!     logged.
   //!
   //! \note This method cannot be overridden. Subclasses that need to perform
   //!     processing when an object transitions to #kStateWritable should
   //!     implement WillWriteAtOffsetImpl(), which is called by this method.
-  size_t WillWriteAtOffset(Phase phase,
-                           FileOffset* offset,
-                           std::vector<MinidumpWritable*>* write_sequence);
+  bool WillWriteAtOffset(FileOffset* offset);
 
   //! \brief Called once an object’s writable file offset is determined, as it
   //!     transitions into #kStateWritable.
@@ -268,6 +310,25 @@ class MinidumpWritable {
   virtual bool WriteObject(FileWriterInterface* file_writer) = 0;
 
  private:
+  // An object in the flattened tree built by WriteEverything().
+  struct LayoutEntry {
+    MinidumpWritable* writable;
+    Phase phase;
+  };
+
+  // Transitions the object from #kStateFrozen to #kStateWritable without
+  // giving it space of its own, pointing everything registered with it at an
+  // identical object at offset. The object will not be written.
+  bool WillShareOffset(FileOffset offset);
+
+  // Populates all RVAs and location descriptors registered with this object
+  // to refer to size bytes at offset.
+  bool UpdateRegisteredPointers(FileOffset offset, size_t size);
+
+  // Sets DataSize in registered location descriptors to size, once an object
+  // in #kPhaseLast has been written.
+  bool UpdateLocationDescriptorSizes(size_t size);
+
   std::vector<RVA*> registered_rvas_;  // weak
 
   std::vector<RVA64*> registered_rva64s_;  // weak
@@ -281,6 +342,8 @@ class MinidumpWritable {
 
   size_t leading_pad_bytes_;
   State state_;
+  bool share_identical_objects_;
+  bool shared_;
 };
 
 }  // namespace internal
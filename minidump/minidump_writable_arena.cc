@@ -0,0 +1,102 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "minidump/minidump_writable_arena.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "base/check_op.h"
+
+namespace crashpad {
+namespace internal {
+
+namespace {
+
+constexpr size_t kAlignment = alignof(max_align_t);
+
+// Most writables are well under 1 kB, so a block holds a few hundred of them.
+constexpr size_t kBlockSize = 64 * 1024;
+
+// Allocations at least this large get a block of their own, so that they don’t
+// waste the unused tail of the current block.
+constexpr size_t kLargeAllocationSize = kBlockSize / 4;
+
+thread_local MinidumpWritableArena* g_current_arena;
+
+}  // namespace
+
+MinidumpWritableArena::Scope::Scope(MinidumpWritableArena* arena)
+    : previous_(g_current_arena) {
+  g_current_arena = arena;
+}
+
+MinidumpWritableArena::Scope::~Scope() {
+  g_current_arena = previous_;
+}
+
+MinidumpWritableArena::MinidumpWritableArena()
+    : blocks_(), next_(nullptr), remaining_(0), live_allocations_(0) {}
+
+MinidumpWritableArena::~MinidumpWritableArena() {
+  DCHECK_EQ(live_allocations_, 0u);
+  DCHECK_NE(g_current_arena, this);
+}
+
+// static
+MinidumpWritableArena* MinidumpWritableArena::Current() {
+  return g_current_arena;
+}
+
+void* MinidumpWritableArena::Allocate(size_t size) {
+  size = (size + kAlignment - 1) & ~(kAlignment - 1);
+  ++live_allocations_;
+
+  if (size >= kLargeAllocationSize) {
+    blocks_.push_back({std::unique_ptr<char[]>(new char[size]), size});
+    return blocks_.back().data.get();
+  }
+
+  if (size > remaining_) {
+    blocks_.push_back(
+        {std::unique_ptr<char[]>(new char[kBlockSize]), kBlockSize});
+    next_ = blocks_.back().data.get();
+    remaining_ = kBlockSize;
+  }
+
+  void* allocation = next_;
+  next_ += size;
+  remaining_ -= size;
+  return allocation;
+}
+
+void MinidumpWritableArena::Release(void* pointer) {
+  DCHECK(Contains(pointer));
+  DCHECK_GT(live_allocations_, 0u);
+  --live_allocations_;
+}
+
+bool MinidumpWritableArena::Contains(const void* pointer) const {
+  const uintptr_t address = reinterpret_cast<uintptr_t>(pointer);
+  for (const Block& block : blocks_) {
+    const uintptr_t base = reinterpret_cast<uintptr_t>(block.data.get());
+    if (address >= base && address - base < block.size) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace internal
+}  // namespace crashpad
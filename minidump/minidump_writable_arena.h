@@ -0,0 +1,101 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_MINIDUMP_MINIDUMP_WRITABLE_ARENA_H_
+#define CRASHPAD_MINIDUMP_MINIDUMP_WRITABLE_ARENA_H_
+
+#include <stddef.h>
+
+#include <memory>
+#include <vector>
+
+namespace crashpad {
+namespace internal {
+
+//! \brief A monotonic allocator for the objects in a tree of MinidumpWritable
+//!     objects.
+//!
+//! While a MinidumpWritableArena::Scope is active on a thread, MinidumpWritable
+//! objects created on that thread are carved out of the scoped arena instead of
+//! being individually allocated from the heap. Deleting such an object runs its
+//! destructor but does not return its storage, which is released all at once
+//! when the arena is destroyed. This keeps the many small objects that make up
+//! a minidump file’s writable tree from fragmenting the heap of a long-lived
+//! process.
+//!
+//! Every object allocated from an arena must be destroyed before the arena
+//! itself. This object is not thread-safe.
+class MinidumpWritableArena {
+ public:
+  //! \brief Makes an arena the current arena for the calling thread for the
+  //!     lifetime of this object.
+  //!
+  //! Scopes may nest. The previously-current arena, if any, is restored when
+  //! this object is destroyed.
+  class Scope {
+   public:
+    //! \param[in] arena The arena to make current. This may be `nullptr` to
+    //!     temporarily allocate from the heap.
+    explicit Scope(MinidumpWritableArena* arena);
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+    ~Scope();
+
+   private:
+    MinidumpWritableArena* previous_;  // weak
+  };
+
+  MinidumpWritableArena();
+
+  MinidumpWritableArena(const MinidumpWritableArena&) = delete;
+  MinidumpWritableArena& operator=(const MinidumpWritableArena&) = delete;
+
+  ~MinidumpWritableArena();
+
+  //! \brief Returns the arena made current on the calling thread by the
+  //!     innermost active Scope, or `nullptr` if there is none.
+  static MinidumpWritableArena* Current();
+
+  //! \brief Allocates \a size bytes aligned suitably for any fundamental type.
+  //!
+  //! The returned storage remains valid until this object is destroyed.
+  void* Allocate(size_t size);
+
+  //! \brief Records that storage obtained from Allocate() is no longer in use.
+  //!
+  //! The storage is not reused. This only allows the destructor to verify that
+  //! no object outlives the arena.
+  void Release(void* pointer);
+
+  //! \brief Returns `true` if \a pointer was obtained from Allocate().
+  bool Contains(const void* pointer) const;
+
+ private:
+  struct Block {
+    std::unique_ptr<char[]> data;
+    size_t size;
+  };
+
+  std::vector<Block> blocks_;
+  char* next_;
+  size_t remaining_;
+  size_t live_allocations_;
+};
+
+}  // namespace internal
+}  // namespace crashpad
+
+#endif  // CRASHPAD_MINIDUMP_MINIDUMP_WRITABLE_ARENA_H_
@@ -0,0 +1,129 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "minidump/minidump_writable_arena.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+
+#include "gtest/gtest.h"
+#include "minidump/minidump_writable.h"
+#include "util/file/file_writer.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+using internal::MinidumpWritableArena;
+
+class TestWritable final : public internal::MinidumpWritable {
+ public:
+  explicit TestWritable(bool* destroyed) : destroyed_(destroyed) {}
+
+  TestWritable(const TestWritable&) = delete;
+  TestWritable& operator=(const TestWritable&) = delete;
+
+  ~TestWritable() override { *destroyed_ = true; }
+
+ protected:
+  size_t SizeOfObject() override { return 0; }
+  bool WriteObject(FileWriterInterface* file_writer) override { return true; }
+
+ private:
+  bool* destroyed_;
+};
+
+TEST(MinidumpWritableArena, Allocate) {
+  MinidumpWritableArena arena;
+  EXPECT_FALSE(arena.Contains(&arena));
+
+  void* small = arena.Allocate(1);
+  void* other_small = arena.Allocate(3);
+  void* large = arena.Allocate(1024 * 1024);
+  void* after_large = arena.Allocate(8);
+
+  for (void* allocation : {small, other_small, large, after_large}) {
+    EXPECT_TRUE(arena.Contains(allocation));
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(allocation) % alignof(max_align_t),
+              0u);
+  }
+
+  // Small allocations are packed together, and a large allocation doesn’t
+  // interrupt that.
+  EXPECT_EQ(static_cast<char*>(other_small) - static_cast<char*>(small),
+            static_cast<ptrdiff_t>(alignof(max_align_t)));
+  EXPECT_EQ(static_cast<char*>(after_large) - static_cast<char*>(other_small),
+            static_cast<ptrdiff_t>(alignof(max_align_t)));
+
+  for (void* allocation : {small, other_small, large, after_large}) {
+    arena.Release(allocation);
+  }
+}
+
+TEST(MinidumpWritableArena, Scope) {
+  EXPECT_EQ(MinidumpWritableArena::Current(), nullptr);
+
+  MinidumpWritableArena outer;
+  MinidumpWritableArena inner;
+  {
+    MinidumpWritableArena::Scope outer_scope(&outer);
+    EXPECT_EQ(MinidumpWritableArena::Current(), &outer);
+    {
+      MinidumpWritableArena::Scope inner_scope(&inner);
+      EXPECT_EQ(MinidumpWritableArena::Current(), &inner);
+      {
+        MinidumpWritableArena::Scope heap_scope(nullptr);
+        EXPECT_EQ(MinidumpWritableArena::Current(), nullptr);
+      }
+      EXPECT_EQ(MinidumpWritableArena::Current(), &inner);
+    }
+    EXPECT_EQ(MinidumpWritableArena::Current(), &outer);
+  }
+
+  EXPECT_EQ(MinidumpWritableArena::Current(), nullptr);
+}
+
+TEST(MinidumpWritableArena, Writable) {
+  MinidumpWritableArena arena;
+
+  bool heap_destroyed = false;
+  auto heap_writable = std::make_unique<TestWritable>(&heap_destroyed);
+  EXPECT_FALSE(arena.Contains(heap_writable.get()));
+
+  bool arena_destroyed = false;
+  std::unique_ptr<TestWritable> arena_writable;
+  {
+    MinidumpWritableArena::Scope scope(&arena);
+    arena_writable = std::make_unique<TestWritable>(&arena_destroyed);
+  }
+  EXPECT_TRUE(arena.Contains(arena_writable.get()));
+
+  // Objects allocated from an arena are still destroyed individually, and
+  // objects allocated from the heap are returned to it regardless of which
+  // arena is current.
+  arena_writable.reset();
+  EXPECT_TRUE(arena_destroyed);
+
+  {
+    MinidumpWritableArena::Scope scope(&arena);
+    heap_writable.reset();
+  }
+  EXPECT_TRUE(heap_destroyed);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
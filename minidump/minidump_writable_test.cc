@@ -14,6 +14,7 @@
 
 #include "minidump/minidump_writable.h"
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -485,6 +486,72 @@ TEST(MinidumpWritable, MinidumpWritable) {
   }
 }
 
+class WriteCountingStringFile final : public StringFile {
+ public:
+  WriteCountingStringFile()
+      : StringFile(), write_count_(0), in_write_iovec_(false) {}
+
+  WriteCountingStringFile(const WriteCountingStringFile&) = delete;
+  WriteCountingStringFile& operator=(const WriteCountingStringFile&) = delete;
+
+  ~WriteCountingStringFile() override {}
+
+  size_t write_count() const { return write_count_; }
+
+  // StringFile:
+  bool Write(const void* data, size_t size) override {
+    // StringFile::WriteIoVec() is implemented in terms of Write().
+    if (!in_write_iovec_) {
+      ++write_count_;
+    }
+    return StringFile::Write(data, size);
+  }
+
+  bool WriteIoVec(std::vector<WritableIoVec>* iovecs) override {
+    ++write_count_;
+
+    in_write_iovec_ = true;
+    bool rv = StringFile::WriteIoVec(iovecs);
+    in_write_iovec_ = false;
+    return rv;
+  }
+
+ private:
+  size_t write_count_;
+  bool in_write_iovec_;
+};
+
+TEST(MinidumpWritable, CoalescedWrites) {
+  // Small objects and the padding between them reach the file in a single
+  // write.
+  WriteCountingStringFile string_file;
+  TestStringMinidumpWritable parent;
+  parent.SetData("p");
+  std::vector<std::unique_ptr<TestStringMinidumpWritable>> children;
+  std::string expected("p");
+  for (char c = 'a'; c <= 'z'; ++c) {
+    children.push_back(std::make_unique<TestStringMinidumpWritable>());
+    children.back()->SetData(std::string(1, c));
+    parent.AddChild(children.back().get());
+    expected.append(3, '\0');
+    expected.push_back(c);
+  }
+
+  TestStringMinidumpWritable large;
+  large.SetData(std::string(1024 * 1024, 'L'));
+  parent.AddChild(&large);
+  expected.append(3, '\0');
+  expected.append(1024 * 1024, 'L');
+
+  EXPECT_TRUE(parent.WriteEverything(&string_file));
+  EXPECT_EQ(string_file.string(), expected);
+
+  // An object too large for the buffer is written along with the buffered data
+  // that precedes it.
+  EXPECT_EQ(string_file.write_count(), 1u);
+  parent.Verify();
+}
+
 template <typename RVAType>
 class TTestRVAMinidumpWritable final : public BaseTestMinidumpWritable {
  public:
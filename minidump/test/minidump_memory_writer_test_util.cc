@@ -35,6 +35,10 @@ void TestMinidumpMemoryWriter::SetShouldFailRead(bool should_fail) {
   test_snapshot_.SetShouldFailRead(should_fail);
 }
 
+void TestMinidumpMemoryWriter::SetSupportsReadRange(bool supports_read_range) {
+  test_snapshot_.SetSupportsReadRange(supports_read_range);
+}
+
 void ExpectMinidumpMemoryDescriptor(
     const MINIDUMP_MEMORY_DESCRIPTOR* expected,
     const MINIDUMP_MEMORY_DESCRIPTOR* observed) {
@@ -44,6 +44,7 @@ class TestMinidumpMemoryWriter final : public SnapshotMinidumpMemoryWriter {
   ~TestMinidumpMemoryWriter();
 
   void SetShouldFailRead(bool should_fail);
+  void SetSupportsReadRange(bool supports_read_range);
 
  private:
   TestMemorySnapshot test_snapshot_;
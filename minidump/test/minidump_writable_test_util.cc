@@ -240,6 +240,22 @@ struct MinidumpMemoryInfoListTraits {
   }
 };
 
+struct MinidumpStackTruncationListTraits {
+  using ListType = MinidumpStackTruncationList;
+  enum : size_t { kElementSize = sizeof(MinidumpStackTruncation) };
+  static size_t ElementCount(const ListType* list) {
+    return list->NumberOfEntries;
+  }
+};
+
+struct MinidumpIdenticalThreadListTraits {
+  using ListType = MinidumpIdenticalThreadList;
+  enum : size_t { kElementSize = sizeof(MinidumpIdenticalThread) };
+  static size_t ElementCount(const ListType* list) {
+    return list->NumberOfEntries;
+  }
+};
+
 struct MinidumpModuleCrashpadInfoListTraits {
   using ListType = MinidumpModuleCrashpadInfoList;
   enum : size_t { kElementSize = sizeof(MinidumpModuleCrashpadInfoLink) };
@@ -258,6 +274,12 @@ struct MinidumpAnnotationListObjectsTraits {
   static size_t ElementCount(const ListType* list) { return list->count; }
 };
 
+struct MinidumpAnnotationThreadListThreadIDsTraits {
+  using ListType = MinidumpAnnotationThreadList;
+  enum : size_t { kElementSize = sizeof(uint64_t) };
+  static size_t ElementCount(const ListType* list) { return list->count; }
+};
+
 template <typename T>
 const typename T::ListType* MinidumpListAtLocationDescriptor(
     const std::string& file_contents,
@@ -344,6 +366,24 @@ MinidumpWritableAtLocationDescriptor<MINIDUMP_MEMORY_INFO_LIST>(
       file_contents, location);
 }
 
+template <>
+const MinidumpStackTruncationList*
+MinidumpWritableAtLocationDescriptor<MinidumpStackTruncationList>(
+    const std::string& file_contents,
+    const MINIDUMP_LOCATION_DESCRIPTOR& location) {
+  return MinidumpListAtLocationDescriptor<MinidumpStackTruncationListTraits>(
+      file_contents, location);
+}
+
+template <>
+const MinidumpIdenticalThreadList*
+MinidumpWritableAtLocationDescriptor<MinidumpIdenticalThreadList>(
+    const std::string& file_contents,
+    const MINIDUMP_LOCATION_DESCRIPTOR& location) {
+  return MinidumpListAtLocationDescriptor<MinidumpIdenticalThreadListTraits>(
+      file_contents, location);
+}
+
 template <>
 const MinidumpModuleCrashpadInfoList*
 MinidumpWritableAtLocationDescriptor<MinidumpModuleCrashpadInfoList>(
@@ -371,6 +411,15 @@ MinidumpWritableAtLocationDescriptor<MinidumpAnnotationList>(
       file_contents, location);
 }
 
+template <>
+const MinidumpAnnotationThreadList*
+MinidumpWritableAtLocationDescriptor<MinidumpAnnotationThreadList>(
+    const std::string& file_contents,
+    const MINIDUMP_LOCATION_DESCRIPTOR& location) {
+  return MinidumpListAtLocationDescriptor<
+      MinidumpAnnotationThreadListThreadIDsTraits>(file_contents, location);
+}
+
 namespace {
 
 template <typename T>
@@ -104,10 +104,13 @@ MINIDUMP_ALLOW_OVERSIZED_DATA(MINIDUMP_THREAD_LIST);
 MINIDUMP_ALLOW_OVERSIZED_DATA(MINIDUMP_THREAD_NAME_LIST);
 MINIDUMP_ALLOW_OVERSIZED_DATA(MINIDUMP_HANDLE_DATA_STREAM);
 MINIDUMP_ALLOW_OVERSIZED_DATA(MINIDUMP_MEMORY_INFO_LIST);
+MINIDUMP_ALLOW_OVERSIZED_DATA(MinidumpStackTruncationList);
+MINIDUMP_ALLOW_OVERSIZED_DATA(MinidumpIdenticalThreadList);
 MINIDUMP_ALLOW_OVERSIZED_DATA(MinidumpModuleCrashpadInfoList);
 MINIDUMP_ALLOW_OVERSIZED_DATA(MinidumpRVAList);
 MINIDUMP_ALLOW_OVERSIZED_DATA(MinidumpSimpleStringDictionary);
 MINIDUMP_ALLOW_OVERSIZED_DATA(MinidumpAnnotationList);
+MINIDUMP_ALLOW_OVERSIZED_DATA(MinidumpAnnotationThreadList);
 
 // These types have final fields carrying variable-sized data (typically string
 // data).
@@ -171,10 +174,12 @@ const T* TMinidumpWritableAtLocationDescriptor(
 //!    ensures that the structure’s magic number and version fields are correct.
 //!  - With a MINIDUMP_MEMORY_LIST, MINIDUMP_THREAD_LIST,
 //!    MINIDUMP_THREAD_NAME_LIST, MINIDUMP_MODULE_LIST,
-//!    MINIDUMP_MEMORY_INFO_LIST, MinidumpSimpleStringDictionary, or
-//!    MinidumpAnnotationList template parameter, template specializations
-//!    ensure that the size given by \a location matches the size expected of a
-//!    stream containing the number of elements it claims to have.
+//!    MINIDUMP_MEMORY_INFO_LIST, MinidumpStackTruncationList,
+//!    MinidumpIdenticalThreadList, MinidumpSimpleStringDictionary,
+//!    MinidumpAnnotationList, or MinidumpAnnotationThreadList template
+//!    parameter, template specializations ensure that the size given by
+//!    \a location matches the size expected of a stream containing the number
+//!    of elements it claims to have.
 //!  - With an IMAGE_DEBUG_MISC, CodeViewRecordPDB20, or CodeViewRecordPDB70
 //!    template parameter, template specializations ensure that the structure
 //!    has the expected format including any magic number and the `NUL`-
@@ -257,6 +262,18 @@ MinidumpWritableAtLocationDescriptor<MINIDUMP_MEMORY_INFO_LIST>(
     const std::string& file_contents,
     const MINIDUMP_LOCATION_DESCRIPTOR& location);
 
+template <>
+const MinidumpStackTruncationList*
+MinidumpWritableAtLocationDescriptor<MinidumpStackTruncationList>(
+    const std::string& file_contents,
+    const MINIDUMP_LOCATION_DESCRIPTOR& location);
+
+template <>
+const MinidumpIdenticalThreadList*
+MinidumpWritableAtLocationDescriptor<MinidumpIdenticalThreadList>(
+    const std::string& file_contents,
+    const MINIDUMP_LOCATION_DESCRIPTOR& location);
+
 template <>
 const CodeViewRecordPDB20*
 MinidumpWritableAtLocationDescriptor<CodeViewRecordPDB20>(
@@ -293,6 +310,12 @@ MinidumpWritableAtLocationDescriptor<MinidumpAnnotationList>(
     const std::string& file_contents,
     const MINIDUMP_LOCATION_DESCRIPTOR& location);
 
+template <>
+const MinidumpAnnotationThreadList*
+MinidumpWritableAtLocationDescriptor<MinidumpAnnotationThreadList>(
+    const std::string& file_contents,
+    const MINIDUMP_LOCATION_DESCRIPTOR& location);
+
 //! \brief Returns a typed minidump object located within a minidump file’s
 //!     contents, where the offset of the object is known.
 //!
@@ -16,17 +16,19 @@
 
 namespace crashpad {
 
-AnnotationSnapshot::AnnotationSnapshot() : name(), type(0), value() {}
+AnnotationSnapshot::AnnotationSnapshot()
+    : name(), type(0), value(), thread_id(0) {}
 
 AnnotationSnapshot::AnnotationSnapshot(const std::string& name,
                                        uint16_t type,
                                        const std::vector<uint8_t>& value)
-    : name(name), type(type), value(value) {}
+    : name(name), type(type), value(value), thread_id(0) {}
 
 AnnotationSnapshot::~AnnotationSnapshot() = default;
 
 bool AnnotationSnapshot::operator==(const AnnotationSnapshot& other) const {
-  return name == other.name && type == other.type && value == other.value;
+  return name == other.name && type == other.type && value == other.value &&
+         thread_id == other.thread_id;
 }
 
 }  // namespace crashpad
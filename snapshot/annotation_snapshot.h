@@ -47,6 +47,11 @@ struct AnnotationSnapshot {
   //!     empty annotations are skipped. The representation of the data should
   //!     be interpreted as \a #type.
   std::vector<uint8_t> value;
+
+  //! \brief The ID of the thread whose AnnotationList held the annotation, as
+  //!     ThreadSnapshot::ThreadID() would report it, or `0` if the annotation
+  //!     was not held by a per-thread list.
+  uint64_t thread_id;
 };
 
 }  // namespace crashpad
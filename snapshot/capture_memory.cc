@@ -15,55 +15,356 @@
 #include "snapshot/capture_memory.h"
 
 #include <stdint.h>
-#include <windows.h>
-
-// dbghelp must be after windows.h.
-#include <dbghelp.h>
 
+#include <algorithm>
 #include <iterator>
 #include <limits>
 #include <memory>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 
+#include "base/check_op.h"
 #include "base/logging.h"
+#include "build/build_config.h"
 #include "snapshot/memory_snapshot.h"
 
+#if defined(ARCH_CPU_X86_FAMILY)
+#include <emmintrin.h>
+#elif defined(ARCH_CPU_ARM64)
+#include <arm_neon.h>
+#endif
+
 namespace crashpad {
 namespace internal {
 
 namespace {
 
+// MaybeCaptureMemoryAround() captures the kCaptureSize bytes starting
+// kCaptureBefore bytes before an address.
+constexpr uint64_t kCaptureBefore = 128;
+constexpr uint64_t kCaptureSize = 512;
+static_assert(kCaptureBefore <= kCaptureSize / 2, "negative offset too large");
+
+// Values this close to 0 or to the top of the address space aren't treated as
+// pointers.
+constexpr uint64_t kNonAddressOffset = 0x10000;
+
+uint64_t MaxAddress(const CaptureMemory::Delegate* delegate) {
+  return delegate->Is64Bit() ? std::numeric_limits<uint64_t>::max()
+                             : std::numeric_limits<uint32_t>::max();
+}
+
 void MaybeCaptureMemoryAround(CaptureMemory::Delegate* delegate,
                               uint64_t address) {
-  constexpr uint64_t non_address_offset = 0x10000;
-  if (address < non_address_offset)
+  if (address < kNonAddressOffset)
     return;
 
-  const uint64_t max_address = delegate->Is64Bit() ?
-      std::numeric_limits<uint64_t>::max() :
-      std::numeric_limits<uint32_t>::max();
-  if (address > max_address - non_address_offset)
+  if (address > MaxAddress(delegate) - kNonAddressOffset)
     return;
 
-  constexpr uint64_t kRegisterByteOffset = 128;
-  const uint64_t target = address - kRegisterByteOffset;
-  constexpr uint64_t size = 512;
-  static_assert(kRegisterByteOffset <= size / 2,
-                "negative offset too large");
-  auto ranges =
-      delegate->GetReadableRanges(CheckedRange<uint64_t>(target, size));
+  CheckedRange<uint64_t> capture(address - kCaptureBefore, kCaptureSize);
+
+  // Within a known allocation, capture as much of it as would otherwise be
+  // captured around the address, but nothing beyond it.
+  CheckedRange<uint64_t> allocation(0, 0);
+  if (delegate->GetAllocationBounds(address, &allocation) &&
+      allocation.IsValid() && allocation.ContainsValue(address)) {
+    if (allocation.size() <= kCaptureSize) {
+      capture = allocation;
+    } else {
+      const uint64_t base = std::max(
+          allocation.base(),
+          std::min(capture.base(), allocation.end() - kCaptureSize));
+      capture = CheckedRange<uint64_t>(base, kCaptureSize);
+    }
+  }
+
+  auto ranges = delegate->GetReadableRanges(capture);
   for (const auto& range : ranges) {
     delegate->AddNewMemorySnapshot(range);
   }
 }
 
+// The number of values examined at a time by InSpanMask().
+constexpr size_t kBatchSize = 64;
+
+size_t CountTrailingZeros(uint64_t value) {
+  DCHECK_NE(value, 0u);
+  size_t zeros = 0;
+  while (!(value & 1)) {
+    value >>= 1;
+    ++zeros;
+  }
+  return zeros;
+}
+
+// Returns a mask with bit index set for each value in values[0, count), with
+// count at most kBatchSize, for which value - low <= span, computed modulo 2^N
+// where N is the width of T. This is the case when value is in [low, low +
+// span].
+template <class T>
+uint64_t InSpanMaskScalar(const T* values, size_t count, T low, T span) {
+  uint64_t mask = 0;
+  for (size_t index = 0; index < count; ++index) {
+    mask |= static_cast<uint64_t>(static_cast<T>(values[index] - low) <= span)
+            << index;
+  }
+  return mask;
+}
+
+#if defined(ARCH_CPU_X86_FAMILY)
+
+// SSE2 has no unsigned comparisons, so the sign bits of both operands are
+// flipped to compare them as signed values instead. It has no 64-bit
+// comparisons either, so those are made from 32-bit comparisons of each half.
+
+uint64_t InSpanMask(const uint32_t* values,
+                    size_t count,
+                    uint64_t low,
+                    uint64_t span) {
+  DCHECK_LE(low + span, std::numeric_limits<uint32_t>::max());
+  const __m128i sign = _mm_set1_epi32(static_cast<int>(0x80000000));
+  const __m128i low_v = _mm_set1_epi32(static_cast<int>(low));
+  const __m128i span_v =
+      _mm_xor_si128(_mm_set1_epi32(static_cast<int>(span)), sign);
+  uint64_t mask = 0;
+  size_t index = 0;
+  for (; index + 4 <= count; index += 4) {
+    const __m128i value =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + index));
+    const __m128i offset = _mm_xor_si128(_mm_sub_epi32(value, low_v), sign);
+    const __m128i above = _mm_cmpgt_epi32(offset, span_v);
+    const uint64_t above_mask = _mm_movemask_ps(_mm_castsi128_ps(above));
+    mask |= (~above_mask & 0xf) << index;
+  }
+  if (index < count) {
+    mask |= InSpanMaskScalar(values + index,
+                             count - index,
+                             static_cast<uint32_t>(low),
+                             static_cast<uint32_t>(span))
+            << index;
+  }
+  return mask;
+}
+
+uint64_t InSpanMask(const uint64_t* values,
+                    size_t count,
+                    uint64_t low,
+                    uint64_t span) {
+  const __m128i sign = _mm_set1_epi32(static_cast<int>(0x80000000));
+  const __m128i low_v = _mm_set1_epi64x(low);
+  const __m128i span_v = _mm_xor_si128(_mm_set1_epi64x(span), sign);
+  uint64_t mask = 0;
+  size_t index = 0;
+  for (; index + 2 <= count; index += 2) {
+    const __m128i value =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + index));
+    const __m128i offset = _mm_xor_si128(_mm_sub_epi64(value, low_v), sign);
+    const __m128i greater = _mm_cmpgt_epi32(offset, span_v);
+    const __m128i equal = _mm_cmpeq_epi32(offset, span_v);
+
+    // A 64-bit value is greater if its high half is, or if its high half is
+    // equal and its low half is greater.
+    const __m128i above = _mm_or_si128(
+        _mm_shuffle_epi32(greater, _MM_SHUFFLE(3, 3, 1, 1)),
+        _mm_and_si128(_mm_shuffle_epi32(equal, _MM_SHUFFLE(3, 3, 1, 1)),
+                      _mm_shuffle_epi32(greater, _MM_SHUFFLE(2, 2, 0, 0))));
+    const uint64_t above_mask = _mm_movemask_pd(_mm_castsi128_pd(above));
+    mask |= (~above_mask & 0x3) << index;
+  }
+  if (index < count) {
+    mask |= InSpanMaskScalar(values + index, count - index, low, span)
+            << index;
+  }
+  return mask;
+}
+
+#elif defined(ARCH_CPU_ARM64)
+
+uint64_t InSpanMask(const uint32_t* values,
+                    size_t count,
+                    uint64_t low,
+                    uint64_t span) {
+  DCHECK_LE(low + span, std::numeric_limits<uint32_t>::max());
+  const uint32x4_t low_v = vdupq_n_u32(static_cast<uint32_t>(low));
+  const uint32x4_t span_v = vdupq_n_u32(static_cast<uint32_t>(span));
+  static constexpr uint32_t kLaneBits[] = {1, 2, 4, 8};
+  const uint32x4_t lane_bits = vld1q_u32(kLaneBits);
+  uint64_t mask = 0;
+  size_t index = 0;
+  for (; index + 4 <= count; index += 4) {
+    const uint32x4_t offset = vsubq_u32(vld1q_u32(values + index), low_v);
+    const uint32x4_t in_span = vcleq_u32(offset, span_v);
+    mask |= static_cast<uint64_t>(vaddvq_u32(vandq_u32(in_span, lane_bits)))
+            << index;
+  }
+  if (index < count) {
+    mask |= InSpanMaskScalar(values + index,
+                             count - index,
+                             static_cast<uint32_t>(low),
+                             static_cast<uint32_t>(span))
+            << index;
+  }
+  return mask;
+}
+
+uint64_t InSpanMask(const uint64_t* values,
+                    size_t count,
+                    uint64_t low,
+                    uint64_t span) {
+  const uint64x2_t low_v = vdupq_n_u64(low);
+  const uint64x2_t span_v = vdupq_n_u64(span);
+  static constexpr uint64_t kLaneBits[] = {1, 2};
+  const uint64x2_t lane_bits = vld1q_u64(kLaneBits);
+  uint64_t mask = 0;
+  size_t index = 0;
+  for (; index + 2 <= count; index += 2) {
+    const uint64x2_t offset = vsubq_u64(vld1q_u64(values + index), low_v);
+    const uint64x2_t in_span = vcleq_u64(offset, span_v);
+    mask |= vaddvq_u64(vandq_u64(in_span, lane_bits)) << index;
+  }
+  if (index < count) {
+    mask |= InSpanMaskScalar(values + index, count - index, low, span)
+            << index;
+  }
+  return mask;
+}
+
+#else
+
+template <class T>
+uint64_t InSpanMask(const T* values,
+                    size_t count,
+                    uint64_t low,
+                    uint64_t span) {
+  return InSpanMaskScalar(
+      values, count, static_cast<T>(low), static_cast<T>(span));
+}
+
+#endif
+
+// Finds the values that MaybeCaptureMemoryAround() would capture any memory
+// around, without asking the delegate about each one. A value qualifies if the
+// memory that would be captured around it overlaps a readable range of the
+// target process.
+class PointerFilter {
+ public:
+  explicit PointerFilter(const CaptureMemory::Delegate* delegate)
+      : lows_(), highs_() {
+    const uint64_t max_address = MaxAddress(delegate);
+    const uint64_t min_value = kNonAddressOffset;
+    const uint64_t max_value = max_address - kNonAddressOffset;
+
+    std::vector<CheckedRange<uint64_t>> readable =
+        delegate->GetReadableRanges(CheckedRange<uint64_t>(0, max_address));
+    std::sort(readable.begin(),
+              readable.end(),
+              [](const CheckedRange<uint64_t>& a,
+                 const CheckedRange<uint64_t>& b) {
+                return a.base() < b.base();
+              });
+
+    for (const CheckedRange<uint64_t>& range : readable) {
+      if (range.size() == 0) {
+        continue;
+      }
+
+      // The memory captured around value, [value - kCaptureBefore,
+      // value - kCaptureBefore + kCaptureSize), overlaps range when value is
+      // in [low, high].
+      constexpr uint64_t kCaptureAfter = kCaptureSize - kCaptureBefore;
+      uint64_t low = range.base() >= kCaptureAfter - 1
+                         ? range.base() - (kCaptureAfter - 1)
+                         : 0;
+      uint64_t high = range.end() - 1 <= max_address - kCaptureBefore
+                          ? range.end() - 1 + kCaptureBefore
+                          : max_address;
+      low = std::max(low, min_value);
+      high = std::min(high, max_value);
+      if (low > high) {
+        continue;
+      }
+
+      if (!lows_.empty() && low <= highs_.back() + 1) {
+        highs_.back() = std::max(highs_.back(), high);
+      } else {
+        lows_.push_back(low);
+        highs_.push_back(high);
+      }
+    }
+  }
+
+  PointerFilter(const PointerFilter&) = delete;
+  PointerFilter& operator=(const PointerFilter&) = delete;
+
+  ~PointerFilter() = default;
+
+  // Appends the indices of the values in values[0, count) that qualify to
+  // candidates, in order.
+  template <class T>
+  void Filter(const T* values,
+              size_t count,
+              std::vector<size_t>* candidates) const {
+    if (lows_.empty()) {
+      return;
+    }
+
+    // Most values fall outside of the span from the lowest to the highest
+    // qualifying value, such as small integers, flags, and the bit patterns of
+    // non-pointer data. These are rejected a batch at a time, leaving only the
+    // rest to be looked up among the qualifying intervals.
+    const uint64_t low = lows_.front();
+    const uint64_t span = highs_.back() - low;
+    for (size_t batch = 0; batch < count; batch += kBatchSize) {
+      const size_t batch_count = std::min(kBatchSize, count - batch);
+      const T* const batch_values = values + batch;
+      for (uint64_t in_span = InSpanMask(batch_values, batch_count, low, span);
+           in_span;
+           in_span &= in_span - 1) {
+        const size_t index = batch + CountTrailingZeros(in_span);
+        if (Qualifies(values[index])) {
+          candidates->push_back(index);
+        }
+      }
+    }
+  }
+
+ private:
+  bool Qualifies(uint64_t value) const {
+    // The last interval starting at or below value is the only one that could
+    // contain it.
+    auto upper = std::upper_bound(lows_.begin(), lows_.end(), value);
+    if (upper == lows_.begin()) {
+      return false;
+    }
+    return value <= highs_[(upper - lows_.begin()) - 1];
+  }
+
+  // The sorted, disjoint, inclusive intervals of qualifying values.
+  std::vector<uint64_t> lows_;
+  std::vector<uint64_t> highs_;
+};
+
 template <class T>
-void CaptureAtPointersInRange(uint8_t* buffer,
+void CaptureAtPointersInRange(uint64_t address,
+                              uint8_t* buffer,
                               uint64_t buffer_size,
                               CaptureMemory::Delegate* delegate) {
-  for (uint64_t address_offset = 0; address_offset < buffer_size;
-       address_offset += sizeof(T)) {
-    uint64_t target_address = *reinterpret_cast<T*>(&buffer[address_offset]);
-    MaybeCaptureMemoryAround(delegate, target_address);
+  const T* const values = reinterpret_cast<const T*>(buffer);
+  std::vector<size_t> candidates;
+  PointerFilter(delegate).Filter(
+      values, buffer_size / sizeof(T), &candidates);
+
+  // A value repeated in the range would capture the same memory again. The
+  // remaining values are captured in the order they appear in the range, so
+  // that those nearest the start are favored when the budget runs out.
+  std::unordered_set<uint64_t> captured;
+  for (size_t index : candidates) {
+    if (captured.insert(values[index]).second) {
+      delegate->SetReferenceAddress(address + index * sizeof(T));
+      MaybeCaptureMemoryAround(delegate, values[index]);
+    }
   }
 }
 
@@ -142,9 +443,11 @@ void CaptureMemory::PointedToByMemoryRange(const MemorySnapshot& memory,
   }
 
   if (delegate->Is64Bit())
-    CaptureAtPointersInRange<uint64_t>(buffer.get(), memory.Size(), delegate);
+    CaptureAtPointersInRange<uint64_t>(
+        memory.Address(), buffer.get(), memory.Size(), delegate);
   else
-    CaptureAtPointersInRange<uint32_t>(buffer.get(), memory.Size(), delegate);
+    CaptureAtPointersInRange<uint32_t>(
+        memory.Address(), buffer.get(), memory.Size(), delegate);
 }
 
 }  // namespace internal
@@ -62,6 +62,32 @@ class CaptureMemory {
     //!     process to the result.
     virtual void AddNewMemorySnapshot(
         const CheckedRange<uint64_t, uint64_t>& range) = 0;
+
+    //! \brief Called by PointedToByMemoryRange() before the memory around each
+    //!     value is captured, with the address in the target process that the
+    //!     value was read from.
+    //!
+    //! Calls to AddNewMemorySnapshot() that follow, until the next call to this
+    //! method, are for memory around that value. PointedToByContext() doesn’t
+    //! call this method.
+    virtual void SetReferenceAddress(uint64_t address) {}
+
+    //! \brief Finds the heap allocation containing \a address, if the delegate
+    //!     knows how to find it.
+    //!
+    //! When this returns `true`, the memory captured around \a address is
+    //! limited to \a bounds: the whole allocation is captured if it’s no larger
+    //! than what would otherwise be captured, and no memory outside of it is.
+    //! The default implementation returns `false`, so that a fixed amount of
+    //! memory around \a address is captured.
+    //!
+    //! \param[in] address A pointer-like value.
+    //! \param[out] bounds The allocation containing \a address.
+    //! \return `true` if \a bounds was set.
+    virtual bool GetAllocationBounds(uint64_t address,
+                                     CheckedRange<uint64_t>* bounds) const {
+      return false;
+    }
   };
 
   CaptureMemory() = delete;
@@ -83,6 +109,12 @@ class CaptureMemory {
   //! process,
   //!     captures a small amount of memory near the pointed to location.
   //!
+  //! The values in the range are first compared, several at a time, against
+  //! the readable ranges of the whole address space, as found by a single
+  //! call to Delegate::GetReadableRanges(). Only distinct values from which
+  //! some readable memory would be captured are then passed to the delegate,
+  //! in the order they appear in the range.
+  //!
   //! \param[in] memory An existing MemorySnapshot of the range to search. The
   //!     base address and size must be pointer-aligned and an integral number
   //!     of
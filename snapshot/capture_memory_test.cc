@@ -0,0 +1,263 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "snapshot/capture_memory.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "snapshot/test/test_memory_snapshot.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+// A 64-bit target process whose memory is readable in the ranges given to
+// AddReadableRange() and whose memory to search is given to SetMemory().
+class TestDelegate : public internal::CaptureMemory::Delegate {
+ public:
+  explicit TestDelegate(bool is_64_bit)
+      : memory_address_(0),
+        memory_(),
+        readable_(),
+        allocations_(),
+        captured_(),
+        is_64_bit_(is_64_bit) {}
+
+  TestDelegate(const TestDelegate&) = delete;
+  TestDelegate& operator=(const TestDelegate&) = delete;
+
+  ~TestDelegate() override {}
+
+  void SetMemory(uint64_t address, const void* memory, size_t size) {
+    memory_address_ = address;
+    memory_.assign(reinterpret_cast<const uint8_t*>(memory),
+                   reinterpret_cast<const uint8_t*>(memory) + size);
+  }
+
+  void AddReadableRange(uint64_t base, uint64_t size) {
+    readable_.emplace_back(base, size);
+  }
+
+  void AddAllocation(uint64_t base, uint64_t size) {
+    allocations_.emplace_back(base, size);
+  }
+
+  const std::vector<CheckedRange<uint64_t>>& captured() const {
+    return captured_;
+  }
+
+  // internal::CaptureMemory::Delegate:
+  bool Is64Bit() const override { return is_64_bit_; }
+
+  bool ReadMemory(uint64_t at, uint64_t num_bytes, void* into) const override {
+    EXPECT_EQ(at, memory_address_);
+    EXPECT_EQ(num_bytes, memory_.size());
+    memcpy(into, memory_.data(), num_bytes);
+    return true;
+  }
+
+  std::vector<CheckedRange<uint64_t>> GetReadableRanges(
+      const CheckedRange<uint64_t, uint64_t>& range) const override {
+    std::vector<CheckedRange<uint64_t>> ranges;
+    for (const CheckedRange<uint64_t>& readable : readable_) {
+      const uint64_t base = std::max(range.base(), readable.base());
+      const uint64_t end = std::min(range.end(), readable.end());
+      if (base < end) {
+        ranges.emplace_back(base, end - base);
+      }
+    }
+    return ranges;
+  }
+
+  void AddNewMemorySnapshot(
+      const CheckedRange<uint64_t, uint64_t>& range) override {
+    captured_.push_back(range);
+  }
+
+  bool GetAllocationBounds(uint64_t address,
+                           CheckedRange<uint64_t>* bounds) const override {
+    for (const CheckedRange<uint64_t>& allocation : allocations_) {
+      if (allocation.ContainsValue(address)) {
+        *bounds = allocation;
+        return true;
+      }
+    }
+    return false;
+  }
+
+ private:
+  uint64_t memory_address_;
+  std::vector<uint8_t> memory_;
+  std::vector<CheckedRange<uint64_t>> readable_;
+  std::vector<CheckedRange<uint64_t>> allocations_;
+  std::vector<CheckedRange<uint64_t>> captured_;
+  bool is_64_bit_;
+};
+
+std::vector<std::pair<uint64_t, uint64_t>> RangePairs(
+    const std::vector<CheckedRange<uint64_t>>& ranges) {
+  std::vector<std::pair<uint64_t, uint64_t>> pairs;
+  for (const CheckedRange<uint64_t>& range : ranges) {
+    pairs.emplace_back(range.base(), range.size());
+  }
+  return pairs;
+}
+
+template <class T>
+void PointedToByMemoryRange(TestDelegate* delegate,
+                            const std::vector<T>& memory) {
+  constexpr uint64_t kMemoryAddress = 0x7fff0000;
+  delegate->SetMemory(
+      kMemoryAddress, memory.data(), memory.size() * sizeof(memory[0]));
+
+  TestMemorySnapshot snapshot;
+  snapshot.SetAddress(kMemoryAddress);
+  snapshot.SetSize(memory.size() * sizeof(memory[0]));
+  internal::CaptureMemory::PointedToByMemoryRange(snapshot, delegate);
+}
+
+TEST(CaptureMemory, PointedToByMemoryRange) {
+  TestDelegate delegate(true);
+  delegate.AddReadableRange(0x100000, 0x1000);
+  delegate.AddReadableRange(0x200000, 0x1000);
+
+  PointedToByMemoryRange<uint64_t>(&delegate,
+                                   {
+                                       // Not pointers.
+                                       0,
+                                       1,
+                                       0x1000,
+                                       0xffffffffffffffff,
+                                       // Into the first readable range.
+                                       0x100800,
+                                       // Just near enough to the first
+                                       // readable range, before and after it.
+                                       0x100000 - 383,
+                                       0x101000 + 127,
+                                       // Just too far from the first readable
+                                       // range.
+                                       0x100000 - 384,
+                                       0x101000 + 128,
+                                       // Repeated.
+                                       0x100800,
+                                       // Into the second readable range.
+                                       0x200010,
+                                       // Between the readable ranges.
+                                       0x180000,
+                                   });
+
+  const std::vector<std::pair<uint64_t, uint64_t>> expected = {
+      {0x100800 - 128, 512},
+      {0x100000, 1},
+      {0x101000 - 1, 1},
+      {0x200000, 0x10 + 384},
+  };
+  EXPECT_EQ(RangePairs(delegate.captured()), expected);
+}
+
+TEST(CaptureMemory, PointedToByMemoryRangeWithAllocations) {
+  TestDelegate delegate(true);
+  delegate.AddReadableRange(0x100000, 0x10000);
+  delegate.AddAllocation(0x101000, 0x40);
+  delegate.AddAllocation(0x102000, 0x1000);
+
+  PointedToByMemoryRange<uint64_t>(&delegate,
+                                   {
+                                       // A small allocation, captured whole.
+                                       0x101000,
+                                       0x101020,
+                                       // Into a large allocation, near its
+                                       // start, middle, and end.
+                                       0x102010,
+                                       0x102800,
+                                       0x102ff0,
+                                       // Not in an allocation.
+                                       0x104000,
+                                   });
+
+  const std::vector<std::pair<uint64_t, uint64_t>> expected = {
+      {0x101000, 0x40},
+      {0x101000, 0x40},
+      {0x102000, 512},
+      {0x102800 - 128, 512},
+      {0x103000 - 512, 512},
+      {0x104000 - 128, 512},
+  };
+  EXPECT_EQ(RangePairs(delegate.captured()), expected);
+}
+
+// Checks that the memory captured around the values in a range is the same
+// as when each distinct value is captured around separately, in order.
+template <class T>
+void ExpectMatchesEveryValue(bool is_64_bit, uint64_t high_base) {
+  const uint64_t kReadableRanges[][2] = {
+      {0x10000, 0x3000},
+      {0x13000, 0x1000},
+      {0x20000, 0x200},
+      {high_base, 0x1000},
+  };
+
+  // Values that are near the readable ranges, far from them, or neither.
+  std::vector<T> memory;
+  uint64_t state = 1;
+  for (size_t index = 0; index < 4099; ++index) {
+    state = state * 6364136223846793005 + 1442695040888963407;
+    const uint64_t choice = (state >> 32) % 5;
+    memory.push_back(static_cast<T>(
+        choice < std::size(kReadableRanges)
+            ? kReadableRanges[choice][0] - 0x800 + (state >> 48) % 0x5000
+            : state));
+  }
+
+  TestDelegate delegate(is_64_bit);
+  TestDelegate expected_delegate(is_64_bit);
+  for (const auto& range : kReadableRanges) {
+    delegate.AddReadableRange(range[0], range[1]);
+    expected_delegate.AddReadableRange(range[0], range[1]);
+  }
+
+  PointedToByMemoryRange(&delegate, memory);
+
+  std::vector<T> seen;
+  for (T value : memory) {
+    if (std::find(seen.begin(), seen.end(), value) != seen.end()) {
+      continue;
+    }
+    seen.push_back(value);
+    PointedToByMemoryRange(&expected_delegate, std::vector<T>(1, value));
+  }
+
+  EXPECT_FALSE(delegate.captured().empty());
+  EXPECT_EQ(RangePairs(delegate.captured()),
+            RangePairs(expected_delegate.captured()));
+}
+
+TEST(CaptureMemory, PointedToByMemoryRangeMatchesEveryValue) {
+  ExpectMatchesEveryValue<uint64_t>(true, 0x7ffffffff000);
+}
+
+TEST(CaptureMemory, PointedToByMemoryRangeMatchesEveryValue32) {
+  ExpectMatchesEveryValue<uint32_t>(false, 0xfffe0000);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
@@ -39,7 +39,10 @@ CrashpadInfoClientOptions::CrashpadInfoClientOptions()
     : crashpad_handler_behavior(TriState::kUnset),
       system_crash_reporter_forwarding(TriState::kUnset),
       gather_indirectly_referenced_memory(TriState::kUnset),
-      indirectly_referenced_memory_cap(0) {
+      indirectly_referenced_memory_cap(0),
+      stack_capture_limit(0),
+      stack_frame_window_size(0),
+      gather_thread_float_contexts(TriState::kUnset) {
 }
 
 }  // namespace crashpad
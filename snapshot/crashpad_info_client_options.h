@@ -65,6 +65,15 @@ struct CrashpadInfoClientOptions {
 
   //! \sa CrashpadInfo::set_gather_indirectly_referenced_memory()
   uint32_t indirectly_referenced_memory_cap;
+
+  //! \sa CrashpadInfo::set_stack_capture_limit()
+  uint32_t stack_capture_limit;
+
+  //! \sa CrashpadInfo::set_stack_capture_limit()
+  uint32_t stack_frame_window_size;
+
+  //! \sa CrashpadInfo::set_gather_thread_float_contexts()
+  TriState gather_thread_float_contexts;
 };
 
 }  // namespace crashpad
@@ -53,6 +53,13 @@ struct TestCrashpadInfo {
 #if !defined(CRASHPAD_INFO_SIZE_TEST_MODULE_SMALL)
   void* user_data_minidump_stream_head_;
   void* annotations_list_;
+  uint32_t stack_capture_limit_;
+  uint32_t stack_frame_window_size_;
+  void* thread_annotation_lists_head_;
+  uint8_t gather_thread_float_contexts_;
+  uint8_t padding_2_[3];
+  uint32_t padding_3_;
+  uint32_t extra_memory_ranges_count_;
 #endif  // CRASHPAD_INFO_SIZE_TEST_MODULE_SMALL
 #if defined(CRASHPAD_INFO_SIZE_TEST_MODULE_LARGE)
   uint8_t trailer_[64 * 1024];
@@ -95,6 +102,13 @@ TestCrashpadInfo g_test_crashpad_info = {'CPad',
 #if !defined(CRASHPAD_INFO_SIZE_TEST_MODULE_SMALL)
                                          nullptr,
                                          nullptr,
+                                         0,
+                                         0,
+                                         nullptr,
+                                         0,
+                                         {},
+                                         0,
+                                         0,
 #endif  // CRASHPAD_INFO_SIZE_TEST_MODULE_SMALL
 #if defined(CRASHPAD_INFO_SIZE_TEST_MODULE_LARGE)
                                          {}
@@ -96,6 +96,7 @@ class CrashpadInfoReader::InfoContainerSpecific : public InfoContainer {
     UnsetIfNotValidTriState(&info.crashpad_handler_behavior);
     UnsetIfNotValidTriState(&info.system_crash_reporter_forwarding);
     UnsetIfNotValidTriState(&info.gather_indirectly_referenced_memory);
+    UnsetIfNotValidTriState(&info.gather_thread_float_contexts);
 
     return true;
   }
@@ -114,6 +115,13 @@ class CrashpadInfoReader::InfoContainerSpecific : public InfoContainer {
     typename Traits::Address simple_annotations;
     typename Traits::Address user_data_minidump_stream_head;
     typename Traits::Address annotations_list;
+    uint32_t stack_capture_limit;
+    uint32_t stack_frame_window_size;
+    typename Traits::Address thread_annotation_lists;
+    TriState gather_thread_float_contexts;
+    uint8_t padding_2[3];
+    uint32_t padding_3;
+    uint32_t extra_memory_ranges_count;
   } info;
 
 #if defined(ARCH_CPU_64_BITS)
@@ -183,6 +191,13 @@ DEFINE_GETTER(uint32_t,
 
 DEFINE_GETTER(VMAddress, ExtraMemoryRanges, extra_memory_ranges)
 
+uint32_t CrashpadInfoReader::ExtraMemoryRangesCount() {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  // Clients that predate this field always used a SimpleAddressRangeBag.
+  const uint32_t count = GET_MEMBER(extra_memory_ranges_count);
+  return count ? count : SimpleAddressRangeBag::num_entries;
+}
+
 DEFINE_GETTER(VMAddress, SimpleAnnotations, simple_annotations)
 
 DEFINE_GETTER(VMAddress, AnnotationsList, annotations_list)
@@ -191,6 +206,16 @@ DEFINE_GETTER(VMAddress,
               UserDataMinidumpStreamHead,
               user_data_minidump_stream_head)
 
+DEFINE_GETTER(uint32_t, StackCaptureLimit, stack_capture_limit)
+
+DEFINE_GETTER(uint32_t, StackFrameWindowSize, stack_frame_window_size)
+
+DEFINE_GETTER(VMAddress, ThreadAnnotationLists, thread_annotation_lists)
+
+DEFINE_GETTER(TriState,
+              GatherThreadFloatContexts,
+              gather_thread_float_contexts)
+
 #undef DEFINE_GETTER
 #undef GET_MEMBER
 
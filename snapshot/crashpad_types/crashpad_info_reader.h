@@ -55,9 +55,14 @@ class CrashpadInfoReader {
   TriState GatherIndirectlyReferencedMemory();
   uint32_t IndirectlyReferencedMemoryCap();
   VMAddress ExtraMemoryRanges();
+  uint32_t ExtraMemoryRangesCount();
   VMAddress SimpleAnnotations();
   VMAddress AnnotationsList();
   VMAddress UserDataMinidumpStreamHead();
+  uint32_t StackCaptureLimit();
+  uint32_t StackFrameWindowSize();
+  VMAddress ThreadAnnotationLists();
+  TriState GatherThreadFloatContexts();
   //! \}
 
  private:
@@ -41,9 +41,13 @@ namespace {
 constexpr TriState kCrashpadHandlerBehavior = TriState::kEnabled;
 constexpr TriState kSystemCrashReporterForwarding = TriState::kDisabled;
 constexpr TriState kGatherIndirectlyReferencedMemory = TriState::kUnset;
+constexpr TriState kGatherThreadFloatContexts = TriState::kDisabled;
 
 constexpr uint32_t kIndirectlyReferencedMemoryCap = 42;
 
+constexpr uint32_t kStackCaptureLimit = 64 * 1024;
+constexpr uint32_t kStackFrameWindowSize = 256;
+
 class ScopedUnsetCrashpadInfo {
  public:
   explicit ScopedUnsetCrashpadInfo(CrashpadInfo* crashpad_info)
@@ -57,6 +61,8 @@ class ScopedUnsetCrashpadInfo {
     crashpad_info_->set_system_crash_reporter_forwarding(TriState::kUnset);
     crashpad_info_->set_gather_indirectly_referenced_memory(TriState::kUnset,
                                                             0);
+    crashpad_info_->set_stack_capture_limit(0, 0);
+    crashpad_info_->set_gather_thread_float_contexts(TriState::kUnset);
     crashpad_info_->set_extra_memory_ranges(nullptr);
     crashpad_info_->set_simple_annotations(nullptr);
     crashpad_info_->set_annotations_list(nullptr);
@@ -79,6 +85,11 @@ class CrashpadInfoTestDataSetup {
     info->set_system_crash_reporter_forwarding(kSystemCrashReporterForwarding);
     info->set_gather_indirectly_referenced_memory(
         kGatherIndirectlyReferencedMemory, kIndirectlyReferencedMemoryCap);
+    info->set_stack_capture_limit(kStackCaptureLimit, kStackFrameWindowSize);
+    info->set_gather_thread_float_contexts(kGatherThreadFloatContexts);
+
+    // Registers this thread’s annotation list, which is never unregistered.
+    AnnotationList::ForCurrentThread();
   }
 
   CrashpadInfoTestDataSetup(const CrashpadInfoTestDataSetup&) = delete;
@@ -130,9 +141,15 @@ void ExpectCrashpadInfo(ProcessType process,
             kGatherIndirectlyReferencedMemory);
   EXPECT_EQ(reader.IndirectlyReferencedMemoryCap(),
             kIndirectlyReferencedMemoryCap);
+  EXPECT_EQ(reader.StackCaptureLimit(), kStackCaptureLimit);
+  EXPECT_EQ(reader.StackFrameWindowSize(), kStackFrameWindowSize);
+  EXPECT_EQ(reader.GatherThreadFloatContexts(), kGatherThreadFloatContexts);
   EXPECT_EQ(reader.ExtraMemoryRanges(), extra_memory_address);
+  EXPECT_EQ(reader.ExtraMemoryRangesCount(),
+            SimpleAddressRangeBag::num_entries);
   EXPECT_EQ(reader.SimpleAnnotations(), simple_annotations_address);
   EXPECT_EQ(reader.AnnotationsList(), annotations_list_address);
+  EXPECT_NE(reader.ThreadAnnotationLists(), 0u);
 }
 
 TEST(CrashpadInfoReader, ReadFromSelf) {
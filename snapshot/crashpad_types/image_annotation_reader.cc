@@ -14,6 +14,7 @@
 
 #include "snapshot/crashpad_types/image_annotation_reader.h"
 
+#include <stddef.h>
 #include <string.h>
 #include <sys/types.h>
 
@@ -21,9 +22,11 @@
 #include <utility>
 
 #include "base/logging.h"
+#include "base/memory/page_size.h"
 #include "build/build_config.h"
 #include "client/annotation.h"
 #include "client/annotation_list.h"
+#include "client/crashpad_info.h"
 #include "client/simple_string_dictionary.h"
 #include "snapshot/snapshot_constants.h"
 #include "util/linux/traits.h"
@@ -39,6 +42,7 @@ struct Annotation {
   typename Traits::Address value;
   uint32_t size;
   uint16_t type;
+  uint16_t flags;
 };
 
 template <class Traits>
@@ -74,12 +78,44 @@ ImageAnnotationReader::~ImageAnnotationReader() = default;
 bool ImageAnnotationReader::SimpleMap(
     VMAddress address,
     std::map<std::string, std::string>* annotations) const {
-  std::vector<SimpleStringDictionary::Entry> simple_annotations(
-      SimpleStringDictionary::num_entries);
+  using Entry = SimpleStringDictionary::Entry;
+  constexpr size_t kNumEntries = SimpleStringDictionary::num_entries;
 
-  if (!memory_->Read(address,
-                     simple_annotations.size() * sizeof(simple_annotations[0]),
-                     &simple_annotations[0])) {
+  // Typically only a few of the entries are active, so rather than reading the
+  // whole dictionary, the first byte of each key is read to find the active
+  // entries, and then only those are read.
+  char key_starts[kNumEntries];
+  std::vector<ProcessMemory::BatchRead> reads(kNumEntries);
+  for (size_t index = 0; index < kNumEntries; ++index) {
+    ProcessMemory::BatchRead& read = reads[index];
+    read.address = address + index * sizeof(Entry) + offsetof(Entry, key);
+    read.size = sizeof(key_starts[index]);
+    read.buffer = &key_starts[index];
+    read.succeeded = false;
+  }
+  if (!memory_->ReadBatch(&reads)) {
+    return false;
+  }
+
+  reads.clear();
+  for (size_t index = 0; index < kNumEntries; ++index) {
+    if (key_starts[index] != '\0') {
+      ProcessMemory::BatchRead read;
+      read.address = address + index * sizeof(Entry);
+      read.size = sizeof(Entry);
+      read.buffer = nullptr;
+      read.succeeded = false;
+      reads.push_back(read);
+    }
+  }
+  if (reads.empty()) {
+    return true;
+  }
+  std::vector<Entry> simple_annotations(reads.size());
+  for (size_t index = 0; index < reads.size(); ++index) {
+    reads[index].buffer = &simple_annotations[index];
+  }
+  if (!memory_->ReadBatch(&reads)) {
     return false;
   }
 
@@ -104,6 +140,40 @@ bool ImageAnnotationReader::AnnotationsList(
              : ReadAnnotationList<Traits32>(address, annotations);
 }
 
+bool ImageAnnotationReader::ThreadAnnotationsLists(
+    VMAddress address,
+    std::vector<AnnotationSnapshot>* annotations) const {
+  size_t index = 0;
+  for (VMAddress current = address;
+       current && index < kMaxNumberOfThreadAnnotationLists;
+       ++index) {
+    internal::ThreadAnnotationListEntry entry;
+    if (!memory_->Read(current, sizeof(entry), &entry)) {
+      LOG(ERROR) << "could not read thread annotation list entry at index "
+                 << index;
+      return false;
+    }
+    current = entry.next;
+
+    // Entries not in use by a thread have empty lists.
+    if (entry.thread_id == 0 || entry.annotations_list == 0) {
+      continue;
+    }
+
+    const size_t first_annotation = annotations->size();
+    if (!AnnotationsList(entry.annotations_list, annotations)) {
+      return false;
+    }
+    for (size_t annotation_index = first_annotation;
+         annotation_index < annotations->size();
+         ++annotation_index) {
+      (*annotations)[annotation_index].thread_id = entry.thread_id;
+    }
+  }
+
+  return true;
+}
+
 template <class Traits>
 bool ImageAnnotationReader::ReadAnnotationList(
     VMAddress address,
@@ -114,6 +184,11 @@ bool ImageAnnotationReader::ReadAnnotationList(
     return false;
   }
 
+  // Each annotation’s location is read from the one before it, so the nodes
+  // are read one at a time. Everything else is then read in two batches: the
+  // names and versioned annotation headers, and then the values, whose
+  // locations may depend on the headers.
+  std::vector<process_types::Annotation<Traits>> nodes;
   process_types::Annotation<Traits> current = annotation_list.head;
   for (size_t index = 0; current.link_node != annotation_list.tail_pointer &&
                          index < kMaxNumberOfAnnotations;
@@ -122,29 +197,117 @@ bool ImageAnnotationReader::ReadAnnotationList(
       LOG(ERROR) << "could not read annotation at index " << index;
       return false;
     }
+    nodes.push_back(current);
+  }
+
+  struct PendingAnnotation {
+    char name[Annotation::kNameMaxLength + 1];
+    VersionedAnnotationHeader header;
+    VMAddress value_address;
+    size_t value_size;
+    ProcessMemory::BatchRead* name_read;
+    ProcessMemory::BatchRead* header_read;
+  };
+  std::vector<PendingAnnotation> pending(nodes.size());
+
+  // A name is read up to its maximum length or the end of its page, whichever
+  // comes first, so that a short name near the end of a mapping can still be
+  // read. A name that isn’t terminated within that is read again on its own.
+  const size_t page_size = base::GetPageSize();
+  std::vector<ProcessMemory::BatchRead> reads;
+  reads.reserve(nodes.size() * 2);
+  for (size_t index = 0; index < nodes.size(); ++index) {
+    const process_types::Annotation<Traits>& node = nodes[index];
+    const size_t name_size =
+        std::min(sizeof(pending[index].name),
+                 page_size - static_cast<size_t>(node.name % page_size));
+    reads.push_back({node.name, name_size, pending[index].name, false});
+    if (node.flags & Annotation::kFlagVersioned) {
+      reads.push_back({node.value - sizeof(VersionedAnnotationHeader),
+                       sizeof(VersionedAnnotationHeader),
+                       &pending[index].header,
+                       false});
+    }
+  }
+  memory_->ReadBatch(&reads);
+
+  for (size_t index = 0, read_index = 0; index < nodes.size(); ++index) {
+    const process_types::Annotation<Traits>& node = nodes[index];
+    pending[index].name_read = &reads[read_index++];
+    pending[index].header_read = node.flags & Annotation::kFlagVersioned
+                                     ? &reads[read_index++]
+                                     : nullptr;
+  }
+
+  std::vector<ProcessMemory::BatchRead> value_reads;
+  std::vector<AnnotationSnapshot> snapshots;
+  std::vector<size_t> snapshot_indices;
+  value_reads.reserve(nodes.size());
+  snapshots.reserve(nodes.size());
+  for (size_t index = 0; index < nodes.size(); ++index) {
+    const process_types::Annotation<Traits>& node = nodes[index];
+    PendingAnnotation& annotation = pending[index];
 
-    if (current.size == 0) {
+    annotation.value_address = node.value;
+    annotation.value_size = node.size;
+    if (annotation.header_read) {
+      if (!annotation.header_read->succeeded) {
+        LOG(WARNING) << "could not read annotation header at index " << index;
+        continue;
+      }
+
+      uint32_t value_offset;
+      uint32_t value_size;
+      if (!annotation.header.GetValueLocation(
+              node.size, &value_offset, &value_size)) {
+        LOG(WARNING) << "invalid annotation header at index " << index;
+      }
+      annotation.value_address += value_offset;
+      annotation.value_size = value_size;
+    }
+
+    if (annotation.value_size == 0) {
       continue;
     }
 
     AnnotationSnapshot snapshot;
-    snapshot.type = current.type;
+    snapshot.type = node.type;
 
-    if (!memory_->ReadCStringSizeLimited(
-            current.name, Annotation::kNameMaxLength, &snapshot.name)) {
+    const ProcessMemory::BatchRead& name_read = *annotation.name_read;
+    const void* name_end =
+        name_read.succeeded ? memchr(annotation.name, '\0', name_read.size)
+                            : nullptr;
+    if (name_end) {
+      snapshot.name.assign(
+          annotation.name,
+          static_cast<const char*>(name_end) - annotation.name);
+    } else if (!memory_->ReadCStringSizeLimited(
+                   node.name, Annotation::kNameMaxLength, &snapshot.name)) {
       LOG(WARNING) << "could not read annotation name at index " << index;
       continue;
     }
 
-    size_t value_length =
-        std::min(static_cast<size_t>(current.size), Annotation::kValueMaxSize);
-    snapshot.value.resize(value_length);
-    if (!memory_->Read(current.value, value_length, snapshot.value.data())) {
-      LOG(WARNING) << "could not read annotation value at index " << index;
+    snapshot.value.resize(
+        std::min(annotation.value_size, Annotation::kValueMaxSize));
+    snapshots.push_back(std::move(snapshot));
+    snapshot_indices.push_back(index);
+  }
+
+  for (size_t index = 0; index < snapshots.size(); ++index) {
+    value_reads.push_back({pending[snapshot_indices[index]].value_address,
+                           snapshots[index].value.size(),
+                           snapshots[index].value.data(),
+                           false});
+  }
+  memory_->ReadBatch(&value_reads);
+
+  for (size_t index = 0; index < snapshots.size(); ++index) {
+    if (!value_reads[index].succeeded) {
+      LOG(WARNING) << "could not read annotation value at index "
+                   << snapshot_indices[index];
       continue;
     }
-
-    annotations->push_back(std::move(snapshot));
+    annotations->push_back(std::move(snapshots[index]));
   }
 
   return true;
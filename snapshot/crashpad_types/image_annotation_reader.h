@@ -63,6 +63,18 @@ class ImageAnnotationReader {
   bool AnnotationsList(VMAddress,
                        std::vector<AnnotationSnapshot>* annotations) const;
 
+  //! \brief Reads the module's per-thread annotation lists, tagging each
+  //!     annotation read with the ID of the thread that owns its list.
+  //!
+  //! \param[in] address The address in the target process' address space of
+  //!     the first internal::ThreadAnnotationListEntry.
+  //! \param[out] annotations The annotations read are appended to this vector,
+  //!     valid if this method returns `true`.
+  //! \return `true` on success. `false` on failure with a message logged.
+  bool ThreadAnnotationsLists(
+      VMAddress address,
+      std::vector<AnnotationSnapshot>* annotations) const;
+
  private:
   template <class Traits>
   bool ReadAnnotationList(VMAddress address,
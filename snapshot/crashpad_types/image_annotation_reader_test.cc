@@ -20,9 +20,11 @@
 
 #include <algorithm>
 
+#include "base/strings/stringprintf.h"
 #include "build/build_config.h"
 #include "client/annotation.h"
 #include "client/annotation_list.h"
+#include "client/crashpad_info.h"
 #include "client/simple_string_dictionary.h"
 #include "gtest/gtest.h"
 #include "test/multiprocess_exec.h"
@@ -69,7 +71,9 @@ void BuildTestStructures(
     SimpleStringDictionary* into_map,
     AnnotationList* into_annotation_list) {
   into_map->SetKeyValue("key", "value");
+  into_map->SetKeyValue("removed", "removed value");
   into_map->SetKeyValue("key2", "value2");
+  into_map->RemoveKey("removed");
 
   static constexpr char kAnnotationName[] = "test annotation";
   static constexpr char kAnnotationValue[] = "test annotation value";
@@ -141,6 +145,183 @@ TEST(ImageAnnotationReader, ReadFromSelf) {
                     FromPointerCast<VMAddress>(&annotations));
 }
 
+TEST(ImageAnnotationReader, VersionedAnnotation) {
+  VersionedStringAnnotation<16> annotation("versioned annotation");
+  AnnotationList annotations;
+  annotations.Add(&annotation);
+  annotation.Set("consistent");
+
+#if defined(ARCH_CPU_64_BITS)
+  constexpr bool am_64_bit = true;
+#else
+  constexpr bool am_64_bit = false;
+#endif
+
+#if BUILDFLAG(IS_ANDROID) || BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS)
+  FakePtraceConnection connection;
+  ASSERT_TRUE(connection.Initialize(GetSelfProcess()));
+  ProcessMemoryLinux memory(&connection);
+#else
+  ProcessMemoryNative memory;
+  ASSERT_TRUE(memory.Initialize(GetSelfProcess()));
+#endif
+
+  ProcessMemoryRange range;
+  ASSERT_TRUE(range.Initialize(&memory, am_64_bit));
+  ImageAnnotationReader reader(&range);
+
+  std::vector<AnnotationSnapshot> annotation_list;
+  ASSERT_TRUE(reader.AnnotationsList(FromPointerCast<VMAddress>(&annotations),
+                                     &annotation_list));
+  ASSERT_EQ(annotation_list.size(), 1u);
+  EXPECT_EQ(annotation_list[0].name, "versioned annotation");
+  EXPECT_EQ(std::string(annotation_list[0].value.begin(),
+                        annotation_list[0].value.end()),
+            "consistent");
+
+  // Simulate a crash partway through writing the primary copy of a new value,
+  // after the backup copy was written.
+  char* primary = reinterpret_cast<char*>(
+      const_cast<void*>(static_cast<Annotation&>(annotation).value()));
+  VersionedAnnotationHeader* header =
+      reinterpret_cast<VersionedAnnotationHeader*>(
+          primary - sizeof(VersionedAnnotationHeader));
+  static constexpr char kNewValue[] = "new value";
+  memcpy(primary + header->capacity, kNewValue, strlen(kNewValue));
+  header->backup_size = strlen(kNewValue);
+  ++header->sequence;
+  memcpy(primary, "XXXX", 4);
+
+  annotation_list.clear();
+  ASSERT_TRUE(reader.AnnotationsList(FromPointerCast<VMAddress>(&annotations),
+                                     &annotation_list));
+  ASSERT_EQ(annotation_list.size(), 1u);
+  EXPECT_EQ(std::string(annotation_list[0].value.begin(),
+                        annotation_list[0].value.end()),
+            kNewValue);
+
+  ++header->sequence;
+  annotation.Clear();
+}
+
+TEST(ImageAnnotationReader, VersionedAnnotationInvalidHeader) {
+  VersionedStringAnnotation<16> annotation("versioned annotation");
+  AnnotationList annotations;
+  annotations.Add(&annotation);
+  annotation.Set("primary");
+
+#if defined(ARCH_CPU_64_BITS)
+  constexpr bool am_64_bit = true;
+#else
+  constexpr bool am_64_bit = false;
+#endif
+
+#if BUILDFLAG(IS_ANDROID) || BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS)
+  FakePtraceConnection connection;
+  ASSERT_TRUE(connection.Initialize(GetSelfProcess()));
+  ProcessMemoryLinux memory(&connection);
+#else
+  ProcessMemoryNative memory;
+  ASSERT_TRUE(memory.Initialize(GetSelfProcess()));
+#endif
+
+  ProcessMemoryRange range;
+  ASSERT_TRUE(range.Initialize(&memory, am_64_bit));
+  ImageAnnotationReader reader(&range);
+
+  char* primary = reinterpret_cast<char*>(
+      const_cast<void*>(static_cast<Annotation&>(annotation).value()));
+  VersionedAnnotationHeader* header =
+      reinterpret_cast<VersionedAnnotationHeader*>(
+          primary - sizeof(VersionedAnnotationHeader));
+  const VersionedAnnotationHeader valid_header = *header;
+
+  // Each header claims that the primary copy is being written, but can’t
+  // describe the backup copy, so the primary copy is used.
+  struct {
+    uint32_t backup_size;
+    uint32_t capacity;
+  } const kInvalidHeaders[] = {
+      // The capacity exceeds the largest possible value.
+      {4, Annotation::kValueMaxSize + 1},
+      {4, 0xffffffff},
+      // The backup copy is larger than the capacity.
+      {17, 16},
+      {0xffffffff, 16},
+      // The primary copy is larger than the capacity.
+      {4, 4},
+  };
+  for (const auto& invalid_header : kInvalidHeaders) {
+    SCOPED_TRACE(base::StringPrintf("backup_size %u, capacity %u",
+                                    invalid_header.backup_size,
+                                    invalid_header.capacity));
+    header->sequence = valid_header.sequence + 1;
+    header->backup_size = invalid_header.backup_size;
+    header->capacity = invalid_header.capacity;
+
+    std::vector<AnnotationSnapshot> annotation_list;
+    ASSERT_TRUE(reader.AnnotationsList(
+        FromPointerCast<VMAddress>(&annotations), &annotation_list));
+    ASSERT_EQ(annotation_list.size(), 1u);
+    EXPECT_EQ(std::string(annotation_list[0].value.begin(),
+                          annotation_list[0].value.end()),
+              "primary");
+  }
+
+  *header = valid_header;
+  annotation.Clear();
+}
+
+TEST(ImageAnnotationReader, ThreadAnnotationLists) {
+  AnnotationList thread_annotations;
+  StringAnnotation<16> annotation("thread annotation");
+  thread_annotations.Add(&annotation);
+  annotation.Set("thread value");
+
+  AnnotationList unused_thread_annotations;
+  StringAnnotation<16> unused_annotation("unused annotation");
+  unused_thread_annotations.Add(&unused_annotation);
+  unused_annotation.Set("unused value");
+
+  constexpr uint64_t kThreadID = 0x1234;
+  crashpad::internal::ThreadAnnotationListEntry unused_entry = {};
+  unused_entry.annotations_list =
+      FromPointerCast<uint64_t>(&unused_thread_annotations);
+  crashpad::internal::ThreadAnnotationListEntry entry = {};
+  entry.next = FromPointerCast<uint64_t>(&unused_entry);
+  entry.thread_id = kThreadID;
+  entry.annotations_list = FromPointerCast<uint64_t>(&thread_annotations);
+
+#if defined(ARCH_CPU_64_BITS)
+  constexpr bool am_64_bit = true;
+#else
+  constexpr bool am_64_bit = false;
+#endif
+
+#if BUILDFLAG(IS_ANDROID) || BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS)
+  FakePtraceConnection connection;
+  ASSERT_TRUE(connection.Initialize(GetSelfProcess()));
+  ProcessMemoryLinux memory(&connection);
+#else
+  ProcessMemoryNative memory;
+  ASSERT_TRUE(memory.Initialize(GetSelfProcess()));
+#endif
+
+  ProcessMemoryRange range;
+  ASSERT_TRUE(range.Initialize(&memory, am_64_bit));
+  ImageAnnotationReader reader(&range);
+
+  std::vector<AnnotationSnapshot> annotation_list;
+  ASSERT_TRUE(reader.ThreadAnnotationsLists(FromPointerCast<VMAddress>(&entry),
+                                            &annotation_list));
+  ASSERT_EQ(annotation_list.size(), 1u);
+  EXPECT_EQ(annotation_list[0].name, "thread annotation");
+  EXPECT_EQ(std::string(annotation_list[0].value.begin(),
+                        annotation_list[0].value.end()),
+            "thread value");
+  EXPECT_EQ(annotation_list[0].thread_id, kThreadID);
+}
+
 CRASHPAD_CHILD_TEST_MAIN(ReadAnnotationsFromChildTestMain) {
   SimpleStringDictionary map;
   std::vector<std::unique_ptr<Annotation>> storage;
@@ -0,0 +1,1005 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "snapshot/elf/elf_cfi_reader.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <limits>
+#include <string>
+
+#include "base/logging.h"
+#include "base/numerics/safe_math.h"
+#include "snapshot/elf/elf_image_reader.h"
+
+namespace crashpad {
+
+namespace {
+
+// Pointer encodings used in .eh_frame and .eh_frame_hdr, as described by the
+// Linux Standard Base Core Specification. The low four bits give the format of
+// a value, and the next three give what it is relative to.
+constexpr uint8_t kEncodingOmit = 0xff;
+constexpr uint8_t kEncodingFormatMask = 0x0f;
+constexpr uint8_t kEncodingAbsolutePointer = 0x00;
+constexpr uint8_t kEncodingULEB128 = 0x01;
+constexpr uint8_t kEncodingUData2 = 0x02;
+constexpr uint8_t kEncodingUData4 = 0x03;
+constexpr uint8_t kEncodingUData8 = 0x04;
+constexpr uint8_t kEncodingSLEB128 = 0x09;
+constexpr uint8_t kEncodingSData2 = 0x0a;
+constexpr uint8_t kEncodingSData4 = 0x0b;
+constexpr uint8_t kEncodingSData8 = 0x0c;
+constexpr uint8_t kEncodingApplicationMask = 0x70;
+constexpr uint8_t kEncodingPCRelative = 0x10;
+constexpr uint8_t kEncodingDataRelative = 0x30;
+constexpr uint8_t kEncodingIndirect = 0x80;
+
+// Call frame instructions, from DWARF 5 §6.4.2 and the GNU extensions. The
+// first three carry an operand in their low six bits.
+enum CFAOpcode : uint8_t {
+  kCFAAdvanceLoc = 0x40,
+  kCFAOffset = 0x80,
+  kCFARestore = 0xc0,
+  kCFANop = 0x00,
+  kCFASetLoc = 0x01,
+  kCFAAdvanceLoc1 = 0x02,
+  kCFAAdvanceLoc2 = 0x03,
+  kCFAAdvanceLoc4 = 0x04,
+  kCFAOffsetExtended = 0x05,
+  kCFARestoreExtended = 0x06,
+  kCFAUndefined = 0x07,
+  kCFASameValue = 0x08,
+  kCFARegister = 0x09,
+  kCFARememberState = 0x0a,
+  kCFARestoreState = 0x0b,
+  kCFADefCFA = 0x0c,
+  kCFADefCFARegister = 0x0d,
+  kCFADefCFAOffset = 0x0e,
+  kCFADefCFAExpression = 0x0f,
+  kCFAExpression = 0x10,
+  kCFAOffsetExtendedSF = 0x11,
+  kCFADefCFASF = 0x12,
+  kCFADefCFAOffsetSF = 0x13,
+  kCFAValOffset = 0x14,
+  kCFAValOffsetSF = 0x15,
+  kCFAValExpression = 0x16,
+  kCFAGNUWindowSave = 0x2d,  // DW_CFA_AARCH64_negate_ra_state on ARM64.
+  kCFAGNUArgsSize = 0x2e,
+  kCFAGNUNegativeOffsetExtended = 0x2f,
+};
+
+// Entries larger than this are assumed to be corrupt.
+constexpr uint64_t kMaxEntrySize = 64 * 1024;
+
+// The most register rule sets that may be saved by DW_CFA_remember_state at
+// once.
+constexpr size_t kMaxRememberedStates = 16;
+
+using FrameRules = ElfCFIReader::FrameRules;
+using RuleType = ElfCFIReader::RegisterRule::Type;
+
+// Reads values from data copied out of the target process.
+class DataReader {
+ public:
+  DataReader() : data_(nullptr), size_(0), offset_(0), address_(0) {}
+
+  DataReader(const uint8_t* data, size_t size, VMAddress address)
+      : data_(data), size_(size), offset_(0), address_(address) {}
+
+  // The address in the target process of the next value to be read.
+  VMAddress Address() const { return address_ + offset_; }
+
+  bool AtEnd() const { return offset_ == size_; }
+
+  bool Skip(uint64_t size) {
+    if (size > size_ - offset_) {
+      return false;
+    }
+    offset_ += size;
+    return true;
+  }
+
+  template <typename T>
+  bool Read(T* value) {
+    if (sizeof(*value) > size_ - offset_) {
+      return false;
+    }
+    memcpy(value, data_ + offset_, sizeof(*value));
+    offset_ += sizeof(*value);
+    return true;
+  }
+
+  bool ReadULEB128(uint64_t* value) {
+    uint64_t result = 0;
+    unsigned int shift = 0;
+    uint8_t byte;
+    do {
+      if (!Read(&byte)) {
+        return false;
+      }
+      if (shift < 64) {
+        result |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      }
+      shift += 7;
+    } while (byte & 0x80);
+    *value = result;
+    return true;
+  }
+
+  bool ReadSLEB128(int64_t* value) {
+    uint64_t result = 0;
+    unsigned int shift = 0;
+    uint8_t byte;
+    do {
+      if (!Read(&byte)) {
+        return false;
+      }
+      if (shift < 64) {
+        result |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      }
+      shift += 7;
+    } while (byte & 0x80);
+    if (shift < 64 && (byte & 0x40)) {
+      result |= ~uint64_t{0} << shift;
+    }
+    *value = static_cast<int64_t>(result);
+    return true;
+  }
+
+  // Reads a value in the format given by the low bits of encoding, without
+  // applying what it’s relative to.
+  bool ReadEncodedValue(uint8_t encoding, bool is_64_bit, uint64_t* value) {
+    switch (encoding & kEncodingFormatMask) {
+      case kEncodingAbsolutePointer:
+        if (is_64_bit) {
+          return Read(value);
+        } else {
+          uint32_t value32;
+          if (!Read(&value32)) {
+            return false;
+          }
+          *value = value32;
+          return true;
+        }
+      case kEncodingULEB128:
+        return ReadULEB128(value);
+      case kEncodingUData2:
+        return ReadAndExtend<uint16_t>(value);
+      case kEncodingUData4:
+        return ReadAndExtend<uint32_t>(value);
+      case kEncodingUData8:
+        return Read(value);
+      case kEncodingSLEB128: {
+        int64_t signed_value;
+        if (!ReadSLEB128(&signed_value)) {
+          return false;
+        }
+        *value = static_cast<uint64_t>(signed_value);
+        return true;
+      }
+      case kEncodingSData2:
+        return ReadAndExtend<int16_t>(value);
+      case kEncodingSData4:
+        return ReadAndExtend<int32_t>(value);
+      case kEncodingSData8:
+        return ReadAndExtend<int64_t>(value);
+      default:
+        return false;
+    }
+  }
+
+  // Reads a pointer given by encoding. data_base is the address that values
+  // relative to data are relative to, or 0 if there is none.
+  bool ReadEncodedPointer(uint8_t encoding,
+                          bool is_64_bit,
+                          VMAddress data_base,
+                          VMAddress* pointer) {
+    const VMAddress value_address = Address();
+    uint64_t value;
+    if ((encoding & kEncodingIndirect) ||
+        !ReadEncodedValue(encoding, is_64_bit, &value)) {
+      return false;
+    }
+    switch (encoding & kEncodingApplicationMask) {
+      case 0:
+        break;
+      case kEncodingPCRelative:
+        value += value_address;
+        break;
+      case kEncodingDataRelative:
+        if (!data_base) {
+          return false;
+        }
+        value += data_base;
+        break;
+      default:
+        return false;
+    }
+    *pointer = is_64_bit ? value : static_cast<uint32_t>(value);
+    return true;
+  }
+
+  // Sets block to read the next size bytes, and skips them.
+  bool ReadBlock(uint64_t size, DataReader* block) {
+    if (size > size_ - offset_) {
+      return false;
+    }
+    *block = DataReader(data_ + offset_, size, Address());
+    offset_ += size;
+    return true;
+  }
+
+ private:
+  template <typename T>
+  bool ReadAndExtend(uint64_t* value) {
+    T value_read;
+    if (!Read(&value_read)) {
+      return false;
+    }
+    *value = static_cast<uint64_t>(value_read);
+    return true;
+  }
+
+  const uint8_t* data_;
+  size_t size_;
+  size_t offset_;
+  VMAddress address_;
+};
+
+// Returns the size of a value in an .eh_frame_hdr search table, or 0 if the
+// table’s encoding isn’t supported.
+size_t TableValueSize(uint8_t encoding) {
+  switch (encoding & kEncodingApplicationMask) {
+    case 0:
+    case kEncodingDataRelative:
+      break;
+    default:
+      return 0;
+  }
+  switch (encoding & ~kEncodingApplicationMask) {
+    case kEncodingUData4:
+    case kEncodingSData4:
+      return sizeof(uint32_t);
+    case kEncodingUData8:
+    case kEncodingSData8:
+      return sizeof(uint64_t);
+    default:
+      return 0;
+  }
+}
+
+struct CommonInformationEntry {
+  DataReader instructions;
+  uint64_t code_alignment_factor;
+  int64_t data_alignment_factor;
+  uint32_t return_address_register;
+  uint8_t fde_pointer_encoding;
+  bool has_augmentation_data;
+  bool signal_frame;
+};
+
+bool ParseCommonInformationEntry(const std::vector<uint8_t>& contents,
+                                 VMAddress contents_address,
+                                 bool is_64_bit,
+                                 CommonInformationEntry* cie) {
+  DataReader reader(contents.data(), contents.size(), contents_address);
+  uint32_t id;
+  uint8_t version;
+  if (!reader.Read(&id) || id != 0 || !reader.Read(&version)) {
+    LOG(ERROR) << "invalid common information entry";
+    return false;
+  }
+  if (version != 1 && version != 3 && version != 4) {
+    LOG(ERROR) << "unsupported common information entry version "
+               << static_cast<int>(version);
+    return false;
+  }
+
+  std::string augmentation;
+  while (true) {
+    char c;
+    if (!reader.Read(&c)) {
+      LOG(ERROR) << "invalid common information entry";
+      return false;
+    }
+    if (c == '\0') {
+      break;
+    }
+    augmentation.push_back(c);
+  }
+
+  uint8_t address_size;
+  uint8_t segment_selector_size;
+  uint64_t return_address_register;
+  if ((version == 4 &&
+       (!reader.Read(&address_size) || !reader.Read(&segment_selector_size))) ||
+      !reader.ReadULEB128(&cie->code_alignment_factor) ||
+      !reader.ReadSLEB128(&cie->data_alignment_factor)) {
+    LOG(ERROR) << "invalid common information entry";
+    return false;
+  }
+  if (version == 1) {
+    uint8_t return_address_register8;
+    if (!reader.Read(&return_address_register8)) {
+      LOG(ERROR) << "invalid common information entry";
+      return false;
+    }
+    return_address_register = return_address_register8;
+  } else if (!reader.ReadULEB128(&return_address_register)) {
+    LOG(ERROR) << "invalid common information entry";
+    return false;
+  }
+  if (return_address_register >= ElfCFIReader::kMaxRegisters) {
+    LOG(ERROR) << "unsupported return address register "
+               << return_address_register;
+    return false;
+  }
+  cie->return_address_register =
+      static_cast<uint32_t>(return_address_register);
+
+  cie->fde_pointer_encoding = kEncodingAbsolutePointer;
+  cie->has_augmentation_data = false;
+  cie->signal_frame = false;
+  if (!augmentation.empty()) {
+    // Without augmentation data, whose size is given first, the fields that
+    // other augmentations add to the entries can’t be skipped.
+    if (augmentation[0] != 'z') {
+      LOG(ERROR) << "unsupported augmentation " << augmentation;
+      return false;
+    }
+    cie->has_augmentation_data = true;
+
+    uint64_t augmentation_size;
+    DataReader augmentation_data;
+    if (!reader.ReadULEB128(&augmentation_size) ||
+        !reader.ReadBlock(augmentation_size, &augmentation_data)) {
+      LOG(ERROR) << "invalid common information entry";
+      return false;
+    }
+
+    // The data following an unknown augmentation can’t be interpreted, but
+    // what has been read already remains valid.
+    bool known_augmentation = true;
+    for (size_t index = 1; known_augmentation && index < augmentation.size();
+         ++index) {
+      switch (augmentation[index]) {
+        case 'L': {
+          uint8_t lsda_encoding;
+          if (!augmentation_data.Read(&lsda_encoding)) {
+            LOG(ERROR) << "invalid common information entry";
+            return false;
+          }
+          break;
+        }
+        case 'P': {
+          uint8_t personality_encoding;
+          uint64_t personality;
+          if (!augmentation_data.Read(&personality_encoding) ||
+              !augmentation_data.ReadEncodedValue(
+                  personality_encoding, is_64_bit, &personality)) {
+            LOG(ERROR) << "invalid common information entry";
+            return false;
+          }
+          break;
+        }
+        case 'R':
+          if (!augmentation_data.Read(&cie->fde_pointer_encoding)) {
+            LOG(ERROR) << "invalid common information entry";
+            return false;
+          }
+          break;
+        case 'S':
+          cie->signal_frame = true;
+          break;
+        case 'B':
+        case 'G':
+          // ARM64 pointer authentication with the B key, and memory tagging.
+          break;
+        default:
+          known_augmentation = false;
+          break;
+      }
+    }
+  }
+
+  cie->instructions = reader;
+  return true;
+}
+
+// Computes value times factor as a signed offset.
+bool ScaleOffset(int64_t value, int64_t factor, int64_t* offset) {
+  return base::CheckMul(value, factor).AssignIfValid(offset);
+}
+
+bool ScaleOffset(uint64_t value, int64_t factor, int64_t* offset) {
+  return (base::CheckedNumeric<int64_t>(value) * factor).AssignIfValid(offset);
+}
+
+// Advances location by delta units of factor bytes, returning false without
+// changing it if that would move it past target_address.
+bool AdvanceLocation(uint64_t delta,
+                     uint64_t factor,
+                     VMAddress target_address,
+                     VMAddress* location) {
+  uint64_t advance;
+  if (!base::CheckMul(delta, factor).AssignIfValid(&advance) ||
+      advance > target_address - *location) {
+    return false;
+  }
+  *location += advance;
+  return true;
+}
+
+void SetRule(FrameRules* rules,
+             uint64_t register_number,
+             RuleType type,
+             int64_t offset) {
+  if (register_number < ElfCFIReader::kMaxRegisters) {
+    rules->registers[register_number].type = type;
+    rules->registers[register_number].offset = offset;
+  }
+}
+
+void SetCFARegister(FrameRules* rules, uint64_t register_number) {
+  rules->cfa_register = static_cast<uint32_t>(
+      std::min<uint64_t>(register_number, ElfCFIReader::kMaxRegisters));
+}
+
+// Executes the call frame instructions read by reader, which apply from
+// location, updating rules up to and including the row for target_address.
+// initial_rules holds the rules set by the common information entry’s initial
+// instructions, or is nullptr while they are being executed.
+bool ExecuteInstructions(DataReader reader,
+                         const CommonInformationEntry& cie,
+                         bool is_64_bit,
+                         VMAddress location,
+                         VMAddress target_address,
+                         const FrameRules* initial_rules,
+                         FrameRules* rules) {
+  std::vector<FrameRules> remembered_states;
+  while (!reader.AtEnd()) {
+    uint8_t opcode;
+    if (!reader.Read(&opcode)) {
+      return false;
+    }
+
+    const uint8_t operand = opcode & 0x3f;
+    switch (opcode & 0xc0) {
+      case kCFAAdvanceLoc:
+        if (!AdvanceLocation(operand,
+                             cie.code_alignment_factor,
+                             target_address,
+                             &location)) {
+          return true;
+        }
+        continue;
+
+      case kCFAOffset: {
+        uint64_t value;
+        int64_t offset;
+        if (!reader.ReadULEB128(&value) ||
+            !ScaleOffset(value, cie.data_alignment_factor, &offset)) {
+          return false;
+        }
+        SetRule(rules, operand, RuleType::kOffset, offset);
+        continue;
+      }
+
+      case kCFARestore:
+        if (operand < ElfCFIReader::kMaxRegisters && initial_rules) {
+          rules->registers[operand] = initial_rules->registers[operand];
+        }
+        continue;
+    }
+
+    uint64_t register_number;
+    switch (opcode) {
+      case kCFANop:
+        break;
+
+      case kCFASetLoc: {
+        VMAddress new_location;
+        if (!reader.ReadEncodedPointer(
+                cie.fde_pointer_encoding, is_64_bit, 0, &new_location) ||
+            new_location < location) {
+          return false;
+        }
+        if (new_location > target_address) {
+          return true;
+        }
+        location = new_location;
+        break;
+      }
+
+      case kCFAAdvanceLoc1: {
+        uint8_t delta;
+        if (!reader.Read(&delta)) {
+          return false;
+        }
+        if (!AdvanceLocation(
+                delta, cie.code_alignment_factor, target_address, &location)) {
+          return true;
+        }
+        break;
+      }
+
+      case kCFAAdvanceLoc2: {
+        uint16_t delta;
+        if (!reader.Read(&delta)) {
+          return false;
+        }
+        if (!AdvanceLocation(
+                delta, cie.code_alignment_factor, target_address, &location)) {
+          return true;
+        }
+        break;
+      }
+
+      case kCFAAdvanceLoc4: {
+        uint32_t delta;
+        if (!reader.Read(&delta)) {
+          return false;
+        }
+        if (!AdvanceLocation(
+                delta, cie.code_alignment_factor, target_address, &location)) {
+          return true;
+        }
+        break;
+      }
+
+      case kCFAOffsetExtended:
+      case kCFAValOffset: {
+        uint64_t value;
+        int64_t offset;
+        if (!reader.ReadULEB128(&register_number) ||
+            !reader.ReadULEB128(&value) ||
+            !ScaleOffset(value, cie.data_alignment_factor, &offset)) {
+          return false;
+        }
+        SetRule(rules,
+                register_number,
+                opcode == kCFAValOffset ? RuleType::kValOffset
+                                        : RuleType::kOffset,
+                offset);
+        break;
+      }
+
+      case kCFAOffsetExtendedSF:
+      case kCFAValOffsetSF: {
+        int64_t value;
+        int64_t offset;
+        if (!reader.ReadULEB128(&register_number) ||
+            !reader.ReadSLEB128(&value) ||
+            !ScaleOffset(value, cie.data_alignment_factor, &offset)) {
+          return false;
+        }
+        SetRule(rules,
+                register_number,
+                opcode == kCFAValOffsetSF ? RuleType::kValOffset
+                                          : RuleType::kOffset,
+                offset);
+        break;
+      }
+
+      case kCFAGNUNegativeOffsetExtended: {
+        uint64_t value;
+        int64_t offset;
+        if (!reader.ReadULEB128(&register_number) ||
+            !reader.ReadULEB128(&value) ||
+            !ScaleOffset(value, cie.data_alignment_factor, &offset) ||
+            offset == std::numeric_limits<int64_t>::min()) {
+          return false;
+        }
+        SetRule(rules, register_number, RuleType::kOffset, -offset);
+        break;
+      }
+
+      case kCFARestoreExtended:
+        if (!reader.ReadULEB128(&register_number)) {
+          return false;
+        }
+        if (register_number < ElfCFIReader::kMaxRegisters && initial_rules) {
+          rules->registers[register_number] =
+              initial_rules->registers[register_number];
+        }
+        break;
+
+      case kCFAUndefined:
+      case kCFASameValue:
+        if (!reader.ReadULEB128(&register_number)) {
+          return false;
+        }
+        SetRule(rules,
+                register_number,
+                opcode == kCFAUndefined ? RuleType::kUndefined
+                                        : RuleType::kSameValue,
+                0);
+        break;
+
+      case kCFARegister: {
+        uint64_t source_register;
+        if (!reader.ReadULEB128(&register_number) ||
+            !reader.ReadULEB128(&source_register)) {
+          return false;
+        }
+        if (source_register < ElfCFIReader::kMaxRegisters) {
+          SetRule(rules,
+                  register_number,
+                  RuleType::kRegister,
+                  static_cast<int64_t>(source_register));
+        } else {
+          SetRule(rules, register_number, RuleType::kUndefined, 0);
+        }
+        break;
+      }
+
+      case kCFARememberState:
+        if (remembered_states.size() == kMaxRememberedStates) {
+          return false;
+        }
+        remembered_states.push_back(*rules);
+        break;
+
+      case kCFARestoreState:
+        if (remembered_states.empty()) {
+          return false;
+        }
+        *rules = remembered_states.back();
+        remembered_states.pop_back();
+        break;
+
+      case kCFADefCFA: {
+        uint64_t offset;
+        if (!reader.ReadULEB128(&register_number) ||
+            !reader.ReadULEB128(&offset) ||
+            !base::IsValueInRangeForNumericType<int64_t>(offset)) {
+          return false;
+        }
+        SetCFARegister(rules, register_number);
+        rules->cfa_offset = static_cast<int64_t>(offset);
+        break;
+      }
+
+      case kCFADefCFASF: {
+        int64_t value;
+        if (!reader.ReadULEB128(&register_number) ||
+            !reader.ReadSLEB128(&value) ||
+            !ScaleOffset(
+                value, cie.data_alignment_factor, &rules->cfa_offset)) {
+          return false;
+        }
+        SetCFARegister(rules, register_number);
+        break;
+      }
+
+      case kCFADefCFARegister:
+        if (!reader.ReadULEB128(&register_number)) {
+          return false;
+        }
+        SetCFARegister(rules, register_number);
+        break;
+
+      case kCFADefCFAOffset: {
+        uint64_t offset;
+        if (!reader.ReadULEB128(&offset) ||
+            !base::IsValueInRangeForNumericType<int64_t>(offset)) {
+          return false;
+        }
+        rules->cfa_offset = static_cast<int64_t>(offset);
+        break;
+      }
+
+      case kCFADefCFAOffsetSF: {
+        int64_t value;
+        if (!reader.ReadSLEB128(&value) ||
+            !ScaleOffset(
+                value, cie.data_alignment_factor, &rules->cfa_offset)) {
+          return false;
+        }
+        break;
+      }
+
+      case kCFADefCFAExpression: {
+        // The CFA can’t be computed without evaluating the expression.
+        uint64_t size;
+        if (!reader.ReadULEB128(&size) || !reader.Skip(size)) {
+          return false;
+        }
+        rules->cfa_register = ElfCFIReader::kMaxRegisters;
+        break;
+      }
+
+      case kCFAExpression:
+      case kCFAValExpression: {
+        uint64_t size;
+        if (!reader.ReadULEB128(&register_number) ||
+            !reader.ReadULEB128(&size) || !reader.Skip(size)) {
+          return false;
+        }
+        SetRule(rules, register_number, RuleType::kExpression, 0);
+        break;
+      }
+
+      case kCFAGNUWindowSave:
+        rules->return_address_signed = !rules->return_address_signed;
+        break;
+
+      case kCFAGNUArgsSize: {
+        uint64_t size;
+        if (!reader.ReadULEB128(&size)) {
+          return false;
+        }
+        break;
+      }
+
+      default:
+        LOG(ERROR) << "unsupported call frame instruction "
+                   << static_cast<int>(opcode);
+        return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+ElfCFIReader::ElfCFIReader()
+    : memory_(),
+      eh_frame_hdr_address_(0),
+      table_address_(0),
+      table_entry_count_(0),
+      table_encoding_(kEncodingOmit),
+      initialized_() {}
+
+ElfCFIReader::~ElfCFIReader() {}
+
+bool ElfCFIReader::Initialize(ElfImageReader* elf_reader) {
+  INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
+
+  VMSize eh_frame_hdr_size;
+  if (!elf_reader->GetEhFrameHeaderAddress(&eh_frame_hdr_address_,
+                                           &eh_frame_hdr_size) ||
+      !memory_.Initialize(*elf_reader->Memory())) {
+    return false;
+  }
+  const bool is_64_bit = memory_.Is64Bit();
+
+  // The header begins with a version and the encodings of the pointer to
+  // .eh_frame, the number of entries in the search table, and the table’s
+  // entries. The pointer and the number of entries follow.
+  uint8_t header[4 + 2 * sizeof(uint64_t)];
+  const VMSize header_size =
+      std::min(eh_frame_hdr_size, static_cast<VMSize>(sizeof(header)));
+  if (header_size < 4 ||
+      !memory_.Read(eh_frame_hdr_address_, header_size, header)) {
+    LOG(ERROR) << "invalid .eh_frame_hdr";
+    return false;
+  }
+  if (header[0] != 1) {
+    LOG(ERROR) << "unexpected .eh_frame_hdr version "
+               << static_cast<int>(header[0]);
+    return false;
+  }
+  const uint8_t eh_frame_pointer_encoding = header[1];
+  const uint8_t table_entry_count_encoding = header[2];
+  table_encoding_ = header[3];
+
+  DataReader reader(header + 4, header_size - 4, eh_frame_hdr_address_ + 4);
+  uint64_t eh_frame_pointer;
+  if ((eh_frame_pointer_encoding != kEncodingOmit &&
+       !reader.ReadEncodedValue(
+           eh_frame_pointer_encoding, is_64_bit, &eh_frame_pointer)) ||
+      table_entry_count_encoding == kEncodingOmit ||
+      !reader.ReadEncodedValue(
+          table_entry_count_encoding, is_64_bit, &table_entry_count_)) {
+    LOG(ERROR) << "no .eh_frame_hdr search table";
+    return false;
+  }
+
+  const size_t value_size = TableValueSize(table_encoding_);
+  if (!value_size) {
+    LOG(ERROR) << "unsupported .eh_frame_hdr table encoding "
+               << static_cast<int>(table_encoding_);
+    return false;
+  }
+
+  table_address_ = reader.Address();
+  const VMSize table_size_available =
+      eh_frame_hdr_size - (table_address_ - eh_frame_hdr_address_);
+  if (table_entry_count_ > table_size_available / (2 * value_size)) {
+    LOG(ERROR) << ".eh_frame_hdr search table too large";
+    return false;
+  }
+
+  INITIALIZATION_STATE_SET_VALID(initialized_);
+  return true;
+}
+
+bool ElfCFIReader::GetFrameRules(VMAddress address, FrameRules* rules) const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  const bool is_64_bit = memory_.Is64Bit();
+
+  VMAddress fde_address;
+  if (!FindFrameDescriptionEntry(address, &fde_address)) {
+    return false;
+  }
+
+  std::vector<uint8_t> fde_contents;
+  VMAddress fde_contents_address;
+  if (!ReadEntry(fde_address, &fde_contents, &fde_contents_address)) {
+    return false;
+  }
+  DataReader fde_reader(
+      fde_contents.data(), fde_contents.size(), fde_contents_address);
+
+  // The entry’s CIE pointer is the offset back to its common information entry
+  // from the pointer itself.
+  uint32_t cie_pointer;
+  if (!fde_reader.Read(&cie_pointer) || cie_pointer == 0 ||
+      cie_pointer > fde_contents_address) {
+    LOG(ERROR) << "invalid frame description entry";
+    return false;
+  }
+
+  std::vector<uint8_t> cie_contents;
+  VMAddress cie_contents_address;
+  CommonInformationEntry cie;
+  if (!ReadEntry(fde_contents_address - cie_pointer,
+                 &cie_contents,
+                 &cie_contents_address) ||
+      !ParseCommonInformationEntry(
+          cie_contents, cie_contents_address, is_64_bit, &cie)) {
+    return false;
+  }
+
+  VMAddress initial_location;
+  uint64_t address_range;
+  if (!fde_reader.ReadEncodedPointer(
+          cie.fde_pointer_encoding, is_64_bit, 0, &initial_location) ||
+      !fde_reader.ReadEncodedValue(
+          cie.fde_pointer_encoding, is_64_bit, &address_range)) {
+    LOG(ERROR) << "invalid frame description entry";
+    return false;
+  }
+  if (address < initial_location ||
+      address - initial_location >= address_range) {
+    return false;
+  }
+
+  if (cie.has_augmentation_data) {
+    uint64_t augmentation_size;
+    if (!fde_reader.ReadULEB128(&augmentation_size) ||
+        !fde_reader.Skip(augmentation_size)) {
+      LOG(ERROR) << "invalid frame description entry";
+      return false;
+    }
+  }
+
+  FrameRules frame_rules;
+  frame_rules.cfa_register = kMaxRegisters;
+  frame_rules.cfa_offset = 0;
+  frame_rules.return_address_register = cie.return_address_register;
+  frame_rules.signal_frame = cie.signal_frame;
+  frame_rules.return_address_signed = false;
+  for (RegisterRule& rule : frame_rules.registers) {
+    rule.type = RuleType::kSameValue;
+    rule.offset = 0;
+  }
+
+  if (!ExecuteInstructions(cie.instructions,
+                           cie,
+                           is_64_bit,
+                           initial_location,
+                           address,
+                           nullptr,
+                           &frame_rules)) {
+    LOG(ERROR) << "invalid common information entry instructions";
+    return false;
+  }
+  const FrameRules initial_rules = frame_rules;
+  if (!ExecuteInstructions(fde_reader,
+                           cie,
+                           is_64_bit,
+                           initial_location,
+                           address,
+                           &initial_rules,
+                           &frame_rules)) {
+    LOG(ERROR) << "invalid frame description entry instructions";
+    return false;
+  }
+
+  if (frame_rules.cfa_register >= kMaxRegisters) {
+    return false;
+  }
+  *rules = frame_rules;
+  return true;
+}
+
+bool ElfCFIReader::FindFrameDescriptionEntry(VMAddress address,
+                                             VMAddress* fde_address) const {
+  if (!table_entry_count_) {
+    return false;
+  }
+  const size_t value_size = TableValueSize(table_encoding_);
+  const VMSize entry_size = 2 * value_size;
+
+  // The table is sorted by initial location. Find the last entry whose initial
+  // location isn’t beyond address.
+  uint64_t low = 0;
+  uint64_t high = table_entry_count_;
+  while (high - low > 1) {
+    const uint64_t middle = low + (high - low) / 2;
+    VMAddress initial_location;
+    if (!ReadTableValue(table_address_ + middle * entry_size,
+                        &initial_location)) {
+      return false;
+    }
+    if (initial_location <= address) {
+      low = middle;
+    } else {
+      high = middle;
+    }
+  }
+
+  VMAddress initial_location;
+  if (!ReadTableValue(table_address_ + low * entry_size, &initial_location) ||
+      initial_location > address) {
+    return false;
+  }
+  return ReadTableValue(table_address_ + low * entry_size + value_size,
+                        fde_address);
+}
+
+bool ElfCFIReader::ReadEntry(VMAddress address,
+                             std::vector<uint8_t>* contents,
+                             VMAddress* contents_address) const {
+  uint32_t length32;
+  if (!memory_.Read(address, sizeof(length32), &length32)) {
+    return false;
+  }
+  VMAddress contents_start = address + sizeof(length32);
+  uint64_t length = length32;
+  if (length32 == 0xffffffff) {
+    if (!memory_.Read(contents_start, sizeof(length), &length)) {
+      return false;
+    }
+    contents_start += sizeof(length);
+  }
+  if (length == 0 || length > kMaxEntrySize) {
+    LOG(ERROR) << "unexpected call frame information entry size " << length;
+    return false;
+  }
+
+  contents->resize(length);
+  if (!memory_.Read(contents_start, length, contents->data())) {
+    return false;
+  }
+  *contents_address = contents_start;
+  return true;
+}
+
+bool ElfCFIReader::ReadTableValue(VMAddress address, VMAddress* value) const {
+  const size_t value_size = TableValueSize(table_encoding_);
+  uint8_t data[sizeof(uint64_t)];
+  if (!memory_.Read(address, value_size, data)) {
+    return false;
+  }
+  DataReader reader(data, value_size, address);
+  return reader.ReadEncodedPointer(
+      table_encoding_, memory_.Is64Bit(), eh_frame_hdr_address_, value);
+}
+
+}  // namespace crashpad
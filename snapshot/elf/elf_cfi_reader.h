@@ -0,0 +1,158 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_SNAPSHOT_ELF_ELF_CFI_READER_H_
+#define CRASHPAD_SNAPSHOT_ELF_ELF_CFI_READER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "util/misc/address_types.h"
+#include "util/misc/initialization_state_dcheck.h"
+#include "util/process/process_memory_range.h"
+
+namespace crashpad {
+
+class ElfImageReader;
+
+//! \brief A reader for the call frame information in the `.eh_frame` section
+//!     of an ELF image mapped into another process.
+//!
+//! Frame description entries are found by searching the table in the image’s
+//! `.eh_frame_hdr` section, so images without one can’t be read. Rules given
+//! by DWARF expressions aren’t evaluated.
+class ElfCFIReader {
+ public:
+  //! \brief The number of DWARF registers whose rules are tracked.
+  //!
+  //! This covers the general-purpose registers, stack pointer, and return
+  //! address register of each supported architecture. Rules for registers
+  //! numbered higher than this are ignored.
+  static constexpr size_t kMaxRegisters = 33;
+
+  //! \brief A rule for recovering a register’s value in the caller’s frame.
+  struct RegisterRule {
+    enum class Type : uint8_t {
+      //! \brief The register’s value can’t be recovered.
+      kUndefined = 0,
+
+      //! \brief The register’s value is unchanged from the callee’s frame.
+      kSameValue,
+
+      //! \brief The register’s value was saved at #offset bytes from the CFA.
+      kOffset,
+
+      //! \brief The register’s value is the CFA plus #offset bytes.
+      kValOffset,
+
+      //! \brief The register’s value is in the callee’s register numbered
+      //!     #offset.
+      kRegister,
+
+      //! \brief The register’s value is given by a DWARF expression, which
+      //!     isn’t evaluated.
+      kExpression,
+    };
+
+    //! \brief How the register’s value is recovered.
+    Type type;
+
+    //! \brief The offset or register number used by #type.
+    int64_t offset;
+  };
+
+  //! \brief The rules for unwinding a frame at one of its instructions.
+  struct FrameRules {
+    //! \brief The register whose value, plus #cfa_offset, is the frame’s
+    //!     canonical frame address (CFA).
+    uint32_t cfa_register;
+
+    //! \brief The offset added to #cfa_register to compute the CFA.
+    int64_t cfa_offset;
+
+    //! \brief The register that holds the return address, whose rule gives
+    //!     the caller’s instruction pointer.
+    uint32_t return_address_register;
+
+    //! \brief Whether the frame is a signal frame, whose instruction pointer is
+    //!     that of the interrupted instruction rather than a return address.
+    bool signal_frame;
+
+    //! \brief Whether the return address is signed with a pointer
+    //!     authentication code, on ARM64.
+    bool return_address_signed;
+
+    //! \brief The rules for the registers numbered below #kMaxRegisters.
+    RegisterRule registers[kMaxRegisters];
+  };
+
+  ElfCFIReader();
+
+  ElfCFIReader(const ElfCFIReader&) = delete;
+  ElfCFIReader& operator=(const ElfCFIReader&) = delete;
+
+  ~ElfCFIReader();
+
+  //! \brief Initializes the reader.
+  //!
+  //! This method must be called once on an object and must be successfully
+  //! called before any other method in this class may be called.
+  //!
+  //! \param[in] elf_reader The reader for the image whose call frame
+  //!     information is to be read. It must outlive this object.
+  //! \return `true` on success. `false` if the image has no `.eh_frame_hdr`
+  //!     section, or with a message logged if the section couldn’t be read.
+  bool Initialize(ElfImageReader* elf_reader);
+
+  //! \brief Determines the rules for unwinding the frame of the function
+  //!     containing an instruction.
+  //!
+  //! \param[in] address The address of the instruction. For a frame that made
+  //!     a call, this should be one less than the return address, so that it
+  //!     falls within the call instruction.
+  //! \param[out] rules The rules in effect at \a address, valid if this method
+  //!     returns `true`.
+  //! \return `true` on success. `false` if there is no call frame information
+  //!     for \a address or its CFA is given by a DWARF expression, or with a
+  //!     message logged if the information couldn’t be read.
+  bool GetFrameRules(VMAddress address, FrameRules* rules) const;
+
+ private:
+  // Finds the address of the frame description entry that may cover address
+  // in the .eh_frame_hdr search table.
+  bool FindFrameDescriptionEntry(VMAddress address,
+                                 VMAddress* fde_address) const;
+
+  // Reads the entry at address, placing its contents after the length field in
+  // contents and their address in contents_address.
+  bool ReadEntry(VMAddress address,
+                 std::vector<uint8_t>* contents,
+                 VMAddress* contents_address) const;
+
+  // Reads a search table entry’s initial location or entry address.
+  bool ReadTableValue(VMAddress address, VMAddress* value) const;
+
+  ProcessMemoryRange memory_;
+  VMAddress eh_frame_hdr_address_;
+  VMAddress table_address_;
+  uint64_t table_entry_count_;
+  uint8_t table_encoding_;
+  InitializationStateDcheck initialized_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_SNAPSHOT_ELF_ELF_CFI_READER_H_
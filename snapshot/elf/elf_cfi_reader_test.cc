@@ -0,0 +1,96 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "snapshot/elf/elf_cfi_reader.h"
+
+#include <dlfcn.h>
+
+#include "build/build_config.h"
+#include "gtest/gtest.h"
+#include "snapshot/elf/elf_image_reader.h"
+#include "test/process_type.h"
+#include "util/misc/from_pointer_cast.h"
+#include "util/process/process_memory_native.h"
+#include "util/process/process_memory_range.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+__attribute__((noinline)) int ElfCFIReaderTestFunction(int value) {
+  return value * 3 + 1;
+}
+
+TEST(ElfCFIReader, FunctionEntry) {
+  // Keep the function from being folded into its callers.
+  int (*volatile function)(int) = ElfCFIReaderTestFunction;
+  EXPECT_EQ(function(1), 4);
+
+  Dl_info info;
+  ASSERT_NE(dladdr(reinterpret_cast<void*>(function), &info), 0) << dlerror();
+
+#if defined(ARCH_CPU_64_BITS)
+  constexpr bool am_64_bit = true;
+#else
+  constexpr bool am_64_bit = false;
+#endif  // ARCH_CPU_64_BITS
+
+  ProcessMemoryNative memory;
+  ASSERT_TRUE(memory.Initialize(GetSelfProcess()));
+  ProcessMemoryRange range;
+  ASSERT_TRUE(range.Initialize(&memory, am_64_bit));
+
+  ElfImageReader image_reader;
+  ASSERT_TRUE(image_reader.Initialize(
+      range, FromPointerCast<VMAddress>(info.dli_fbase)));
+
+  ElfCFIReader cfi_reader;
+  ASSERT_TRUE(cfi_reader.Initialize(&image_reader));
+
+  ElfCFIReader::FrameRules rules;
+  ASSERT_TRUE(
+      cfi_reader.GetFrameRules(FromPointerCast<VMAddress>(function), &rules));
+  EXPECT_FALSE(rules.signal_frame);
+
+  // At a function’s first instruction, nothing has been pushed onto the stack
+  // since the call, so the canonical frame address is the stack pointer plus
+  // whatever the call itself pushed.
+#if defined(ARCH_CPU_X86_64)
+  EXPECT_EQ(rules.cfa_register, 7u);
+  EXPECT_EQ(rules.cfa_offset, 8);
+  EXPECT_EQ(rules.return_address_register, 16u);
+  EXPECT_EQ(rules.registers[16].type,
+            ElfCFIReader::RegisterRule::Type::kOffset);
+  EXPECT_EQ(rules.registers[16].offset, -8);
+#elif defined(ARCH_CPU_X86)
+  EXPECT_EQ(rules.cfa_register, 4u);
+  EXPECT_EQ(rules.cfa_offset, 4);
+  EXPECT_EQ(rules.return_address_register, 8u);
+  EXPECT_EQ(rules.registers[8].type, ElfCFIReader::RegisterRule::Type::kOffset);
+  EXPECT_EQ(rules.registers[8].offset, -4);
+#elif defined(ARCH_CPU_ARM64)
+  EXPECT_EQ(rules.cfa_register, 31u);
+  EXPECT_EQ(rules.cfa_offset, 0);
+  EXPECT_EQ(rules.return_address_register, 30u);
+  EXPECT_EQ(rules.registers[30].type,
+            ElfCFIReader::RegisterRule::Type::kSameValue);
+#endif  // ARCH_CPU_X86_64
+
+  // The ELF header isn’t code, so no frame description entry covers it.
+  EXPECT_FALSE(cfi_reader.GetFrameRules(image_reader.Address(), &rules));
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
@@ -77,4 +77,8 @@ bool ElfDynamicArrayReader::Initialize(const ProcessMemoryRange& memory,
                           : Read<Elf32_Dyn>(memory, address, size, &values_);
 }
 
+void ElfDynamicArrayReader::Initialize(const ElfDynamicArrayReader& other) {
+  values_ = other.values_;
+}
+
 }  // namespace crashpad
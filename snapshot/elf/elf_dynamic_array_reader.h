@@ -49,6 +49,14 @@ class ElfDynamicArrayReader {
                   VMAddress address,
                   VMSize size);
 
+  //! \brief Initializes the reader with the values read by another reader.
+  //!
+  //! This method must be called once on an object and may be called instead of
+  //! the other Initialize().
+  //!
+  //! \param[in] other A reader that was successfully initialized.
+  void Initialize(const ElfDynamicArrayReader& other);
+
   //! \brief Retrieve a value from the array.
   //!
   //! \param[in] tag Specifies which value should be retrieved. The possible
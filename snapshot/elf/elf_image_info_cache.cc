@@ -0,0 +1,79 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "snapshot/elf/elf_image_info_cache.h"
+
+#include <utility>
+
+#include "base/check.h"
+
+namespace crashpad {
+
+ElfImageInfoCache::ElfImageInfoCache(size_t max_bytes)
+    : entries_(), index_(), lock_(), max_bytes_(max_bytes), bytes_(0) {}
+
+ElfImageInfoCache::~ElfImageInfoCache() = default;
+
+bool ElfImageInfoCache::Find(const std::vector<uint8_t>& build_id,
+                             ImageInfo* info) {
+  DCHECK(!build_id.empty());
+
+  base::AutoLock lock(lock_);
+  auto iterator = index_.find(build_id);
+  if (iterator == index_.end()) {
+    return false;
+  }
+
+  entries_.splice(entries_.begin(), entries_, iterator->second);
+  *info = iterator->second->info;
+  return true;
+}
+
+void ElfImageInfoCache::Insert(const std::vector<uint8_t>& build_id,
+                               const ImageInfo& info) {
+  DCHECK(!build_id.empty());
+
+  const size_t entry_size = EntrySize(build_id);
+  if (entry_size > max_bytes_) {
+    return;
+  }
+
+  base::AutoLock lock(lock_);
+  auto iterator = index_.find(build_id);
+  if (iterator != index_.end()) {
+    iterator->second->info = info;
+    entries_.splice(entries_.begin(), entries_, iterator->second);
+    return;
+  }
+
+  while (bytes_ + entry_size > max_bytes_) {
+    const Entry& oldest = entries_.back();
+    bytes_ -= EntrySize(oldest.build_id);
+    index_.erase(oldest.build_id);
+    entries_.pop_back();
+  }
+
+  entries_.push_front(Entry{build_id, info});
+  index_[build_id] = entries_.begin();
+  bytes_ += entry_size;
+}
+
+// static
+size_t ElfImageInfoCache::EntrySize(const std::vector<uint8_t>& build_id) {
+  // The build ID is stored in both the entry and the index.
+  return sizeof(Entry) + sizeof(EntryList::iterator) +
+         sizeof(std::vector<uint8_t>) + 2 * build_id.size();
+}
+
+}  // namespace crashpad
@@ -0,0 +1,94 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_SNAPSHOT_ELF_ELF_IMAGE_INFO_CACHE_H_
+#define CRASHPAD_SNAPSHOT_ELF_ELF_IMAGE_INFO_CACHE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <list>
+#include <map>
+#include <vector>
+
+#include "base/synchronization/lock.h"
+#include "util/misc/address_types.h"
+
+namespace crashpad {
+
+//! \brief Keeps what ModuleSnapshotElf reads about an ELF image that doesn’t
+//!     depend on where or in which process the image is loaded, keyed by the
+//!     image’s build ID.
+//!
+//! Processes that load the same image can share what one of them read about
+//! it. The least recently used images are dropped once the cache reaches its
+//! memory cap.
+//!
+//! This class is thread-safe.
+class ElfImageInfoCache {
+ public:
+  //! \brief What is known about an image.
+  struct ImageInfo {
+    //! \brief The address of the image’s CrashpadInfo before the load bias is
+    //!     applied, if \a has_crashpad_info.
+    VMAddress crashpad_info_address;
+
+    //! \brief Whether the image has a note locating its CrashpadInfo.
+    bool has_crashpad_info;
+  };
+
+  //! \param[in] max_bytes About how much memory the cache may use.
+  explicit ElfImageInfoCache(size_t max_bytes);
+
+  ElfImageInfoCache(const ElfImageInfoCache&) = delete;
+  ElfImageInfoCache& operator=(const ElfImageInfoCache&) = delete;
+
+  ~ElfImageInfoCache();
+
+  //! \brief Finds what is known about an image.
+  //!
+  //! \param[in] build_id The image’s build ID, which must not be empty.
+  //! \param[out] info What is known about the image.
+  //! \return `true` if the image was found.
+  bool Find(const std::vector<uint8_t>& build_id, ImageInfo* info);
+
+  //! \brief Records what is known about an image, replacing anything recorded
+  //!     before.
+  //!
+  //! \param[in] build_id The image’s build ID, which must not be empty.
+  //! \param[in] info What is known about the image.
+  void Insert(const std::vector<uint8_t>& build_id, const ImageInfo& info);
+
+ private:
+  struct Entry {
+    std::vector<uint8_t> build_id;
+    ImageInfo info;
+  };
+
+  using EntryList = std::list<Entry>;
+
+  // The approximate memory used by an entry for build_id.
+  static size_t EntrySize(const std::vector<uint8_t>& build_id);
+
+  // Ordered from most to least recently used.
+  EntryList entries_;
+  std::map<std::vector<uint8_t>, EntryList::iterator> index_;
+  base::Lock lock_;
+  const size_t max_bytes_;
+  size_t bytes_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_SNAPSHOT_ELF_ELF_IMAGE_INFO_CACHE_H_
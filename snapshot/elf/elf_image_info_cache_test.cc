@@ -0,0 +1,85 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "snapshot/elf/elf_image_info_cache.h"
+
+#include "gtest/gtest.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+std::vector<uint8_t> BuildID(uint8_t value) {
+  return std::vector<uint8_t>(20, value);
+}
+
+ElfImageInfoCache::ImageInfo ImageInfo(VMAddress crashpad_info_address) {
+  ElfImageInfoCache::ImageInfo info;
+  info.crashpad_info_address = crashpad_info_address;
+  info.has_crashpad_info = crashpad_info_address != 0;
+  return info;
+}
+
+TEST(ElfImageInfoCache, FindAndInsert) {
+  ElfImageInfoCache cache(4096);
+  ElfImageInfoCache::ImageInfo info;
+  EXPECT_FALSE(cache.Find(BuildID(1), &info));
+
+  cache.Insert(BuildID(1), ImageInfo(0x1000));
+  cache.Insert(BuildID(2), ImageInfo(0));
+  ASSERT_TRUE(cache.Find(BuildID(1), &info));
+  EXPECT_TRUE(info.has_crashpad_info);
+  EXPECT_EQ(info.crashpad_info_address, 0x1000u);
+  ASSERT_TRUE(cache.Find(BuildID(2), &info));
+  EXPECT_FALSE(info.has_crashpad_info);
+
+  // A build ID that is a prefix of another is a different image.
+  EXPECT_FALSE(cache.Find(std::vector<uint8_t>(19, 1), &info));
+
+  cache.Insert(BuildID(1), ImageInfo(0x2000));
+  ASSERT_TRUE(cache.Find(BuildID(1), &info));
+  EXPECT_EQ(info.crashpad_info_address, 0x2000u);
+}
+
+TEST(ElfImageInfoCache, MemoryCap) {
+  ElfImageInfoCache cache(1024);
+  for (uint8_t id = 1; id <= 100; ++id) {
+    cache.Insert(BuildID(id), ImageInfo(id));
+  }
+
+  // Only the most recently inserted images fit.
+  ElfImageInfoCache::ImageInfo info;
+  EXPECT_FALSE(cache.Find(BuildID(1), &info));
+  ASSERT_TRUE(cache.Find(BuildID(100), &info));
+  uint8_t oldest = 100;
+  while (cache.Find(BuildID(oldest - 1), &info)) {
+    --oldest;
+  }
+  ASSERT_LT(oldest, 100);
+
+  // Each image was found after the one before it, so the least recently used
+  // image is the most recently inserted one.
+  cache.Insert(BuildID(101), ImageInfo(101));
+  EXPECT_FALSE(cache.Find(BuildID(100), &info));
+  EXPECT_TRUE(cache.Find(BuildID(oldest), &info));
+  EXPECT_TRUE(cache.Find(BuildID(101), &info));
+
+  ElfImageInfoCache disabled_cache(0);
+  disabled_cache.Insert(BuildID(1), ImageInfo(0x1000));
+  EXPECT_FALSE(disabled_cache.Find(BuildID(1), &info));
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
@@ -18,6 +18,7 @@
 
 #include <algorithm>
 #include <limits>
+#include <memory>
 #include <utility>
 #include <vector>
 
@@ -28,6 +29,28 @@
 
 namespace crashpad {
 
+namespace {
+
+struct ElfClass32 {
+  using Ehdr = Elf32_Ehdr;
+  using Phdr = Elf32_Phdr;
+  static constexpr uint8_t kClass = ELFCLASS32;
+};
+
+struct ElfClass64 {
+  using Ehdr = Elf64_Ehdr;
+  using Phdr = Elf64_Phdr;
+  static constexpr uint8_t kClass = ELFCLASS64;
+};
+
+// Note headers are made of 32-bit words in both ELF classes.
+static_assert(sizeof(Elf32_Nhdr) == sizeof(Elf64_Nhdr) &&
+                  sizeof(Elf32_Nhdr::n_namesz) == sizeof(Elf64_Nhdr::n_namesz),
+              "note header size mismatch");
+using Nhdr = Elf32_Nhdr;
+
+}  // namespace
+
 class ElfImageReader::ProgramHeaderTable {
  public:
   virtual ~ProgramHeaderTable() {}
@@ -35,6 +58,8 @@ class ElfImageReader::ProgramHeaderTable {
   virtual bool VerifyLoadSegments(bool verbose) const = 0;
   virtual size_t Size() const = 0;
   virtual bool GetDynamicSegment(VMAddress* address, VMSize* size) const = 0;
+  virtual bool GetEhFrameHeaderSegment(VMAddress* address,
+                                       VMSize* size) const = 0;
   virtual bool GetPreferredElfHeaderAddress(VMAddress* address,
                                             bool verbose) const = 0;
   virtual bool GetPreferredLoadedMemoryRange(VMAddress* address,
@@ -48,6 +73,14 @@ class ElfImageReader::ProgramHeaderTable {
                               VMAddress* address,
                               VMSize* size) const = 0;
 
+  // Appends the file-backed parts of the PT_LOAD segments that are neither
+  // writable nor overlap PT_GNU_RELRO, with unbiased addresses.
+  virtual void GetReadOnlyFileSegments(
+      std::vector<FileSegment>* segments) const = 0;
+
+  // Returns a copy of this table.
+  virtual std::unique_ptr<ProgramHeaderTable> Clone() const = 0;
+
  protected:
   ProgramHeaderTable() {}
 };
@@ -160,6 +193,18 @@ class ElfImageReader::ProgramHeaderTableSpecific
     return true;
   }
 
+  bool GetEhFrameHeaderSegment(VMAddress* address,
+                               VMSize* size) const override {
+    INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+    const PhdrType* phdr;
+    if (!GetProgramHeader(PT_GNU_EH_FRAME, &phdr)) {
+      return false;
+    }
+    *address = phdr->p_vaddr;
+    *size = phdr->p_memsz;
+    return true;
+  }
+
   bool GetProgramHeader(uint32_t type, const PhdrType** header_out) const {
     INITIALIZATION_STATE_DCHECK_VALID(initialized_);
     for (const auto& header : table_) {
@@ -186,6 +231,39 @@ class ElfImageReader::ProgramHeaderTableSpecific
     return false;
   }
 
+  void GetReadOnlyFileSegments(
+      std::vector<FileSegment>* segments) const override {
+    INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+    const PhdrType* relro;
+    if (!GetProgramHeader(PT_GNU_RELRO, &relro)) {
+      relro = nullptr;
+    }
+    for (const auto& header : table_) {
+      if (header.p_type != PT_LOAD || (header.p_flags & PF_W) ||
+          header.p_filesz == 0) {
+        continue;
+      }
+      if (relro && relro->p_vaddr < header.p_vaddr + header.p_filesz &&
+          header.p_vaddr < relro->p_vaddr + relro->p_memsz) {
+        continue;
+      }
+      FileSegment segment;
+      segment.address = header.p_vaddr;
+      segment.size = header.p_filesz;
+      segment.file_offset = header.p_offset;
+      segments->push_back(segment);
+    }
+  }
+
+  std::unique_ptr<ProgramHeaderTable> Clone() const override {
+    INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+    auto clone = std::make_unique<ProgramHeaderTableSpecific<PhdrType>>();
+    INITIALIZATION_STATE_SET_INITIALIZING(clone->initialized_);
+    clone->table_ = table_;
+    INITIALIZATION_STATE_SET_VALID(clone->initialized_);
+    return clone;
+  }
+
  private:
   std::vector<PhdrType> table_;
   InitializationStateDcheck initialized_;
@@ -221,9 +299,7 @@ ElfImageReader::NoteReader::Result ElfImageReader::NoteReader::NextNote(
     }
 
     retry_ = false;
-    result = range_->Is64Bit()
-                 ? ReadNote<Elf64_Nhdr>(name, type, desc, desc_address)
-                 : ReadNote<Elf32_Nhdr>(name, type, desc, desc_address);
+    result = ReadNote(name, type, desc, desc_address);
   } while (retry_);
 
   if (result == Result::kSuccess) {
@@ -265,17 +341,16 @@ ElfImageReader::NoteReader::NoteReader(const ElfImageReader* elf_reader,
   DCHECK_LT(max_note_size, kMaxMaxNoteSize);
 }
 
-template <typename NhdrType>
 ElfImageReader::NoteReader::Result ElfImageReader::NoteReader::ReadNote(
     std::string* name,
     NoteType* type,
     std::string* desc,
     VMAddress* desc_address) {
-  static_assert(sizeof(*type) >= sizeof(NhdrType::n_namesz),
+  static_assert(sizeof(*type) >= sizeof(Nhdr::n_namesz),
                 "Note field size mismatch");
   DCHECK_LT(current_address_, segment_end_address_);
 
-  NhdrType note_info;
+  Nhdr note_info;
   if (!segment_range_->Read(current_address_, sizeof(note_info), &note_info)) {
     return Result::kError;
   }
@@ -375,8 +450,9 @@ ElfImageReader::NoteReader::Result ElfImageReader::NoteReader::ReadNote(
 }
 
 ElfImageReader::ElfImageReader()
-    : header_64_(),
-      ehdr_address_(0),
+    : ehdr_address_(0),
+      phdr_address_(0),
+      file_type_(0),
       load_bias_(0),
       memory_(),
       program_headers_(),
@@ -408,8 +484,9 @@ bool ElfImageReader::Initialize(const ProcessMemoryRange& memory,
     return false;
   }
 
-  if (!(memory_.Is64Bit() && e_ident[EI_CLASS] == ELFCLASS64) &&
-      !(!memory_.Is64Bit() && e_ident[EI_CLASS] == ELFCLASS32)) {
+  const uint8_t expected_class =
+      memory_.Is64Bit() ? ElfClass64::kClass : ElfClass32::kClass;
+  if (e_ident[EI_CLASS] != expected_class) {
     LOG_IF(ERROR, verbose) << "unexpected bitness";
     return false;
   }
@@ -429,48 +506,59 @@ bool ElfImageReader::Initialize(const ProcessMemoryRange& memory,
     return false;
   }
 
-  if (!(memory_.Is64Bit()
-            ? memory_.Read(ehdr_address_, sizeof(header_64_), &header_64_)
-            : memory_.Read(ehdr_address_, sizeof(header_32_), &header_32_))) {
+  if (!(memory_.Is64Bit() ? InitializeSpecific<ElfClass64>(verbose)
+                          : InitializeSpecific<ElfClass32>(verbose))) {
     return false;
   }
 
-#define VERIFY_HEADER(header)                                  \
-  do {                                                         \
-    if (header.e_type != ET_EXEC && header.e_type != ET_DYN) { \
-      LOG_IF(ERROR, verbose) << "unexpected image type";       \
-      return false;                                            \
-    }                                                          \
-    if (header.e_version != EV_CURRENT) {                      \
-      LOG_IF(ERROR, verbose) << "unexpected version";          \
-      return false;                                            \
-    }                                                          \
-    if (header.e_ehsize != sizeof(header)) {                   \
-      LOG_IF(ERROR, verbose) << "unexpected header size";      \
-      return false;                                            \
-    }                                                          \
-  } while (false);
+  INITIALIZATION_STATE_SET_VALID(initialized_);
+  return true;
+}
+
+template <typename Traits>
+bool ElfImageReader::InitializeSpecific(bool verbose) {
+  typename Traits::Ehdr header;
+  if (!memory_.Read(ehdr_address_, sizeof(header), &header)) {
+    return false;
+  }
 
-  if (memory_.Is64Bit()) {
-    VERIFY_HEADER(header_64_);
-  } else {
-    VERIFY_HEADER(header_32_);
+  if (header.e_type != ET_EXEC && header.e_type != ET_DYN) {
+    LOG_IF(ERROR, verbose) << "unexpected image type";
+    return false;
+  }
+  if (header.e_version != EV_CURRENT) {
+    LOG_IF(ERROR, verbose) << "unexpected version";
+    return false;
+  }
+  if (header.e_ehsize != sizeof(header)) {
+    LOG_IF(ERROR, verbose) << "unexpected header size";
+    return false;
+  }
+  if (header.e_phentsize != sizeof(typename Traits::Phdr)) {
+    LOG_IF(ERROR, verbose) << "unexpected phdr size";
+    return false;
   }
+  file_type_ = header.e_type;
+  phdr_address_ = ehdr_address_ + header.e_phoff;
 
-  if (!InitializeProgramHeaders(verbose)) {
+  auto program_headers = std::make_unique<
+      ProgramHeaderTableSpecific<typename Traits::Phdr>>();
+  if (!program_headers->Initialize(
+          memory_, phdr_address_, header.e_phnum, verbose)) {
     return false;
   }
+  program_headers_ = std::move(program_headers);
 
   VMAddress preferred_ehdr_address;
-  if (!program_headers_.get()->GetPreferredElfHeaderAddress(
-          &preferred_ehdr_address, verbose)) {
+  if (!program_headers_->GetPreferredElfHeaderAddress(&preferred_ehdr_address,
+                                                      verbose)) {
     return false;
   }
   load_bias_ = ehdr_address_ - preferred_ehdr_address;
 
   VMAddress base_address;
   VMSize loaded_size;
-  if (!program_headers_.get()->GetPreferredLoadedMemoryRange(
+  if (!program_headers_->GetPreferredLoadedMemoryRange(
           &base_address, &loaded_size, verbose)) {
     return false;
   }
@@ -480,35 +568,58 @@ bool ElfImageReader::Initialize(const ProcessMemoryRange& memory,
     return false;
   }
 
-  VMSize ehdr_size;
-  VMAddress phdr_address;
-  if (memory_.Is64Bit()) {
-    ehdr_size = sizeof(header_64_);
-    phdr_address = ehdr_address_ + header_64_.e_phoff;
-  } else {
-    ehdr_size = sizeof(header_32_);
-    phdr_address = ehdr_address_ + header_32_.e_phoff;
-  }
-
-  CheckedVMAddressRange range(memory_.Is64Bit(), base_address, loaded_size);
+  constexpr bool is_64_bit = Traits::kClass == ELFCLASS64;
+  CheckedVMAddressRange range(is_64_bit, base_address, loaded_size);
   if (!range.ContainsRange(
-          CheckedVMAddressRange(memory_.Is64Bit(), ehdr_address_, ehdr_size))) {
+          CheckedVMAddressRange(is_64_bit, ehdr_address_, sizeof(header)))) {
     LOG_IF(ERROR, verbose) << "ehdr out of range";
     return false;
   }
   if (!range.ContainsRange(CheckedVMAddressRange(
-          memory.Is64Bit(), phdr_address, program_headers_->Size()))) {
+          is_64_bit, phdr_address_, program_headers_->Size()))) {
     LOG_IF(ERROR, verbose) << "phdrs out of range";
     return false;
   }
 
+  return true;
+}
+
+bool ElfImageReader::Initialize(const ElfImageReader& other,
+                                const ProcessMemoryRange& memory) {
+  INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
+  INITIALIZATION_STATE_DCHECK_VALID(other.initialized_);
+  if (memory.Is64Bit() != other.memory_.Is64Bit()) {
+    LOG(ERROR) << "unexpected bitness";
+    return false;
+  }
+
+  if (!memory_.Initialize(memory) ||
+      !memory_.RestrictRange(other.memory_.Base(), other.memory_.Size())) {
+    return false;
+  }
+
+  ehdr_address_ = other.ehdr_address_;
+  phdr_address_ = other.phdr_address_;
+  file_type_ = other.file_type_;
+  load_bias_ = other.load_bias_;
+  program_headers_ = other.program_headers_->Clone();
+
+  // The dynamic symbol table reader refers to this object’s memory, so only
+  // the dynamic array is copied. The symbol table is set up again when it’s
+  // needed, from the copied dynamic array.
+  if (other.dynamic_array_initialized_.is_valid()) {
+    dynamic_array_.reset(new ElfDynamicArrayReader());
+    dynamic_array_->Initialize(*other.dynamic_array_);
+    dynamic_array_initialized_.set_valid();
+  }
+
   INITIALIZATION_STATE_SET_VALID(initialized_);
   return true;
 }
 
 uint16_t ElfImageReader::FileType() const {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
-  return memory_.Is64Bit() ? header_64_.e_type : header_32_.e_type;
+  return file_type_;
 }
 
 bool ElfImageReader::SoName(std::string* name) {
@@ -630,33 +741,43 @@ bool ElfImageReader::GetDynamicArrayAddress(VMAddress* address) {
   return true;
 }
 
+bool ElfImageReader::GetEhFrameHeaderAddress(VMAddress* address,
+                                             VMSize* size) {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  VMAddress eh_frame_hdr_address;
+  VMSize eh_frame_hdr_size;
+  if (!program_headers_.get()->GetEhFrameHeaderSegment(&eh_frame_hdr_address,
+                                                       &eh_frame_hdr_size)) {
+    return false;
+  }
+  *address = eh_frame_hdr_address + GetLoadBias();
+  *size = eh_frame_hdr_size;
+  return true;
+}
+
 VMAddress ElfImageReader::GetProgramHeaderTableAddress() {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
-  return ehdr_address_ +
-         (memory_.Is64Bit() ? header_64_.e_phoff : header_32_.e_phoff);
+  return phdr_address_;
 }
 
-bool ElfImageReader::InitializeProgramHeaders(bool verbose) {
-#define INITIALIZE_PROGRAM_HEADERS(PhdrType, header)         \
-  do {                                                       \
-    if (header.e_phentsize != sizeof(PhdrType)) {            \
-      LOG_IF(ERROR, verbose) << "unexpected phdr size";      \
-      return false;                                          \
-    }                                                        \
-    auto phdrs = new ProgramHeaderTableSpecific<PhdrType>(); \
-    program_headers_.reset(phdrs);                           \
-    if (!phdrs->Initialize(memory_,                          \
-                           ehdr_address_ + header.e_phoff,   \
-                           header.e_phnum,                   \
-                           verbose)) {                       \
-      return false;                                          \
-    }                                                        \
-  } while (false);
-
-  if (memory_.Is64Bit()) {
-    INITIALIZE_PROGRAM_HEADERS(Elf64_Phdr, header_64_);
-  } else {
-    INITIALIZE_PROGRAM_HEADERS(Elf32_Phdr, header_32_);
+bool ElfImageReader::GetReadOnlyFileSegments(
+    std::vector<FileSegment>* segments) {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  segments->clear();
+  if (!InitializeDynamicArray()) {
+    return false;
+  }
+
+  uint64_t value;
+  if (dynamic_array_->GetValue(DT_TEXTREL, false, &value) ||
+      (dynamic_array_->GetValue(DT_FLAGS, false, &value) &&
+       (value & DF_TEXTREL))) {
+    return false;
+  }
+
+  program_headers_->GetReadOnlyFileSegments(segments);
+  for (FileSegment& segment : *segments) {
+    segment.address += GetLoadBias();
   }
   return true;
 }
@@ -697,14 +818,26 @@ bool ElfImageReader::InitializeDynamicSymbolTable() {
   }
   symbol_table_initialized_.set_invalid();
 
-  if (!InitializeDynamicArray()) {
+  symbol_table_ = CreateDynamicSymbolTableReader(true, true);
+  if (!symbol_table_) {
     return false;
   }
+  symbol_table_initialized_.set_valid();
+  return true;
+}
+
+std::unique_ptr<ElfSymbolTableReader>
+ElfImageReader::CreateDynamicSymbolTableReader(bool use_gnu_hash,
+                                               bool use_hash) {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  if (!InitializeDynamicArray()) {
+    return nullptr;
+  }
 
   VMAddress symbol_table_address;
   if (!GetAddressFromDynamicArray(DT_SYMTAB, true, &symbol_table_address)) {
     LOG(ERROR) << "no symbol table";
-    return false;
+    return nullptr;
   }
 
   // Try both DT_HASH and DT_GNU_HASH. They're completely different, but both
@@ -718,13 +851,28 @@ bool ElfImageReader::InitializeDynamicSymbolTable() {
   if (!GetNumberOfSymbolEntriesFromDtHash(&number_of_symbol_table_entries) &&
       !GetNumberOfSymbolEntriesFromDtGnuHash(&number_of_symbol_table_entries)) {
     LOG(ERROR) << "could not retrieve number of symbol table entries";
-    return false;
+    return nullptr;
   }
 
-  symbol_table_.reset(new ElfSymbolTableReader(
-      &memory_, this, symbol_table_address, number_of_symbol_table_entries));
-  symbol_table_initialized_.set_valid();
-  return true;
+  // Either hash table, if present, is used to look up symbols without scanning
+  // the symbol table.
+  VMAddress gnu_hash_address;
+  if (!use_gnu_hash ||
+      !GetAddressFromDynamicArray(DT_GNU_HASH, false, &gnu_hash_address)) {
+    gnu_hash_address = 0;
+  }
+  VMAddress hash_address;
+  if (!use_hash ||
+      !GetAddressFromDynamicArray(DT_HASH, false, &hash_address)) {
+    hash_address = 0;
+  }
+
+  return std::make_unique<ElfSymbolTableReader>(&memory_,
+                                                this,
+                                                symbol_table_address,
+                                                number_of_symbol_table_entries,
+                                                gnu_hash_address,
+                                                hash_address);
 }
 
 bool ElfImageReader::GetAddressFromDynamicArray(uint64_t tag,
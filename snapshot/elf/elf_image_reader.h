@@ -21,6 +21,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "snapshot/elf/elf_dynamic_array_reader.h"
 #include "snapshot/elf/elf_symbol_table_reader.h"
@@ -94,7 +95,6 @@ class ElfImageReader {
     // Reads the next note at the current segment address. Sets retry_ to true
     // and returns kError if use_filter_ is true and the note's name and type do
     // not match name_filter_ and type_filter_.
-    template <typename T>
     Result ReadNote(std::string* name,
                     NoteType* type,
                     std::string* desc,
@@ -115,6 +115,20 @@ class ElfImageReader {
     bool retry_;
   };
 
+  //! \brief A part of a loaded segment whose contents are those of the
+  //!     image’s file.
+  struct FileSegment {
+    //! \brief The address of the segment in the remote process.
+    VMAddress address;
+
+    //! \brief The number of bytes of the segment, starting at #address, that
+    //!     were mapped from the file.
+    VMSize size;
+
+    //! \brief The offset in the image’s file of the byte at #address.
+    VMOffset file_offset;
+  };
+
   ElfImageReader();
 
   ElfImageReader(const ElfImageReader&) = delete;
@@ -138,6 +152,20 @@ class ElfImageReader {
                   VMAddress address,
                   bool verbose = true);
 
+  //! \brief Initializes the reader from what another reader has already read
+  //!     of the same image, without reading the image again.
+  //!
+  //! This method must be called once on an object and must be successfully
+  //! called before any other method in this class may be called.
+  //!
+  //! \param[in] other A reader for the image that was successfully initialized.
+  //!     Only the state \a other has already read is used, so its memory reader
+  //!     need not be valid any longer.
+  //! \param[in] memory A memory reader for the remote process, which must have
+  //!     the same bitness as the one \a other was initialized with.
+  bool Initialize(const ElfImageReader& other,
+                  const ProcessMemoryRange& memory);
+
   //! \brief Returns the base address of the image's memory range.
   //!
   //! This may differ from the address passed to Initialize() if the ELF header
@@ -204,9 +232,34 @@ class ElfImageReader {
   //! \return `true` on success. Otherwise `false` with a message logged.
   bool GetDynamicArrayAddress(VMAddress* address);
 
+  //! \brief Determine the address and size of the `PT_GNU_EH_FRAME` segment,
+  //!     which holds the image’s `.eh_frame_hdr` section.
+  //!
+  //! \param[out] address The address of the segment, valid if this method
+  //!     returns `true`.
+  //! \param[out] size The size of the segment, valid if this method returns
+  //!     `true`.
+  //! \return `true` on success. `false` if the image has no such segment.
+  bool GetEhFrameHeaderAddress(VMAddress* address, VMSize* size);
+
   //! \brief Return the address of the program header table.
   VMAddress GetProgramHeaderTableAddress();
 
+  //! \brief Determines which parts of the image can’t have been modified since
+  //!     they were mapped from the image’s file.
+  //!
+  //! These are the file-backed parts of the `PT_LOAD` segments that are not
+  //! writable and don’t overlap the `PT_GNU_RELRO` region, which the dynamic
+  //! loader relocates before making it read-only. Images with text
+  //! relocations, which the loader applies by temporarily making segments
+  //! writable, have no such parts.
+  //!
+  //! \param[out] segments The parts of the image’s segments that hold what is
+  //!     in its file.
+  //! \return `true` on success. `false` if the image’s dynamic array couldn’t
+  //!     be read or the image has text relocations.
+  bool GetReadOnlyFileSegments(std::vector<FileSegment>* segments);
+
   //! \brief Return a NoteReader for this image, which scans all PT_NOTE
   //!     segments in the image.
   //!
@@ -267,20 +320,36 @@ class ElfImageReader {
   bool GetNumberOfSymbolEntriesFromDtGnuHash(
       VMSize* number_of_symbol_table_entries);
 
+  //! \brief Creates a reader for the dynamic symbol table that looks symbols
+  //!     up using only the selected hash tables.
+  //!
+  //! \note Exposed for testing, not normally otherwise useful.
+  //!
+  //! \param[in] use_gnu_hash Whether to use the `DT_GNU_HASH` table, if
+  //!     present.
+  //! \param[in] use_hash Whether to use the `DT_HASH` table, if present.
+  //! \return The reader, which scans the symbol table if it uses neither hash
+  //!     table. `nullptr` on failure, with a message logged.
+  std::unique_ptr<ElfSymbolTableReader> CreateDynamicSymbolTableReader(
+      bool use_gnu_hash,
+      bool use_hash);
+
  private:
   template <typename PhdrType>
   class ProgramHeaderTableSpecific;
 
-  bool InitializeProgramHeaders(bool verbose);
+  // Reads and verifies the ELF header and program header table, with the ELF
+  // class selected once by Traits.
+  template <typename Traits>
+  bool InitializeSpecific(bool verbose);
+
   bool InitializeDynamicArray();
   bool InitializeDynamicSymbolTable();
   bool GetAddressFromDynamicArray(uint64_t tag, bool log, VMAddress* address);
 
-  union {
-    Elf32_Ehdr header_32_;
-    Elf64_Ehdr header_64_;
-  };
   VMAddress ehdr_address_;
+  VMAddress phdr_address_;
+  uint16_t file_type_;
   VMOffset load_bias_;
   ProcessMemoryRange memory_;
   std::unique_ptr<ProgramHeaderTable> program_headers_;
@@ -18,6 +18,10 @@
 #include <link.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <string>
+#include <vector>
+
 #include "build/build_config.h"
 #include "gtest/gtest.h"
 #include "test/multiprocess_exec.h"
@@ -300,6 +304,172 @@ TEST(ElfImageReader, OneModuleChild) {
   test.Run();
 }
 
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+TEST(ElfImageReader, ReadOnlyFileSegments) {
+#if defined(ARCH_CPU_64_BITS)
+  constexpr bool am_64_bit = true;
+#else
+  constexpr bool am_64_bit = false;
+#endif  // ARCH_CPU_64_BITS
+
+  FakePtraceConnection connection;
+  ASSERT_TRUE(connection.Initialize(GetSelfProcess()));
+  ProcessMemoryLinux memory(&connection);
+  VMAddress elf_address;
+  ASSERT_NO_FATAL_FAILURE(
+      LocateExecutable(&connection, &memory, &elf_address));
+
+  ProcessMemoryRange range;
+  ASSERT_TRUE(range.Initialize(&memory, am_64_bit));
+
+  ElfImageReader reader;
+  ASSERT_TRUE(reader.Initialize(range, elf_address));
+
+  std::vector<ElfImageReader::FileSegment> segments;
+  ASSERT_TRUE(reader.GetReadOnlyFileSegments(&segments));
+  ASSERT_FALSE(segments.empty());
+
+  // What is in memory at each segment matches what is in the file.
+  ScopedFileHandle handle(
+      LoggingOpenFileForRead(base::FilePath("/proc/self/exe")));
+  ASSERT_TRUE(handle.is_valid());
+  for (const ElfImageReader::FileSegment& segment : segments) {
+    SCOPED_TRACE(segment.address);
+    const size_t size =
+        static_cast<size_t>(std::min(segment.size, VMSize{4096}));
+    std::string from_memory(size, '\0');
+    ASSERT_TRUE(memory.Read(segment.address, size, &from_memory[0]));
+    std::string from_file(size, '\0');
+    ASSERT_EQ(
+        LoggingSeekFile(handle.get(), segment.file_offset, SEEK_SET),
+        segment.file_offset);
+    ASSERT_TRUE(LoggingReadFileExactly(handle.get(), &from_file[0], size));
+    EXPECT_EQ(from_memory, from_file);
+  }
+}
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+
+#if !defined(ARCH_CPU_MIPS_FAMILY)
+
+// Returns the path with which to dlopen()
+// crashpad_snapshot_test_both_dt_hash_styles.
+base::FilePath BothDtHashStylesModulePath() {
+  base::FilePath module_path =
+      TestPaths::BuildArtifact(FILE_PATH_LITERAL("snapshot"),
+                               FILE_PATH_LITERAL("both_dt_hash_styles"),
+                               TestPaths::FileType::kLoadableModule);
+#if BUILDFLAG(IS_FUCHSIA)
+  // TODO(scottmg): Remove this when upstream Fuchsia bug ZX-1619 is resolved.
+  // See also explanation in build/run_tests.py for Fuchsia .so files.
+  module_path = module_path.BaseName();
+#endif  // BUILDFLAG(IS_FUCHSIA)
+  return module_path;
+}
+
+void ExpectSameSymbol(const ElfSymbolTableReader::SymbolInformation& actual,
+                      const ElfSymbolTableReader::SymbolInformation& expected) {
+  EXPECT_EQ(actual.address, expected.address);
+  EXPECT_EQ(actual.size, expected.size);
+  EXPECT_EQ(actual.shndx, expected.shndx);
+  EXPECT_EQ(actual.binding, expected.binding);
+  EXPECT_EQ(actual.type, expected.type);
+  EXPECT_EQ(actual.visibility, expected.visibility);
+}
+
+// Looking symbols up through either hash table finds what scanning the symbol
+// table finds, and doesn’t find what scanning doesn’t.
+TEST(ElfImageReader, HashTableLookupsMatchScan) {
+  const base::FilePath module_path = BothDtHashStylesModulePath();
+  ScopedModuleHandle module(
+      dlopen(module_path.value().c_str(), RTLD_LAZY | RTLD_LOCAL));
+  ASSERT_TRUE(module.valid()) << "dlopen " << module_path.value() << ": "
+                              << dlerror();
+
+#if defined(ARCH_CPU_64_BITS)
+  constexpr bool am_64_bit = true;
+#else
+  constexpr bool am_64_bit = false;
+#endif  // ARCH_CPU_64_BITS
+
+#if BUILDFLAG(IS_ANDROID) || BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS)
+  FakePtraceConnection connection;
+  ASSERT_TRUE(connection.Initialize(GetSelfProcess()));
+  ProcessMemoryLinux memory(&connection);
+#else
+  ProcessMemoryNative memory;
+  ASSERT_TRUE(memory.Initialize(GetSelfProcess()));
+#endif
+  ProcessMemoryRange range;
+  ASSERT_TRUE(range.Initialize(&memory, am_64_bit));
+
+  struct link_map* lm = reinterpret_cast<struct link_map*>(module.get());
+
+  ElfImageReader reader;
+  ASSERT_TRUE(reader.Initialize(range, lm->l_addr));
+
+  // Both tables are present, so neither lookup below falls back to a scan for
+  // want of its table.
+  VMSize number_of_symbol_table_entries;
+  ASSERT_TRUE(reader.GetNumberOfSymbolEntriesFromDtHash(
+      &number_of_symbol_table_entries));
+  ASSERT_TRUE(reader.GetNumberOfSymbolEntriesFromDtGnuHash(
+      &number_of_symbol_table_entries));
+
+  std::unique_ptr<ElfSymbolTableReader> gnu_hash_reader =
+      reader.CreateDynamicSymbolTableReader(true, false);
+  ASSERT_TRUE(gnu_hash_reader);
+  std::unique_ptr<ElfSymbolTableReader> hash_reader =
+      reader.CreateDynamicSymbolTableReader(false, true);
+  ASSERT_TRUE(hash_reader);
+  std::unique_ptr<ElfSymbolTableReader> scan_reader =
+      reader.CreateDynamicSymbolTableReader(false, false);
+  ASSERT_TRUE(scan_reader);
+
+  // These are exported by hash_types_test.cc.
+  static constexpr const char* kSymbols[] = {
+      "HashTypesTestVariable",
+      "HashTypesTestFunction1",
+      "HashTypesTestFunction2",
+      "HashTypesTestFunction3",
+      "HashTypesTestFunction4",
+      "HashTypesTestFunction5",
+      "HashTypesTestFunction6",
+      "HashTypesTestFunction7",
+  };
+  for (const char* symbol : kSymbols) {
+    SCOPED_TRACE(symbol);
+
+    ElfSymbolTableReader::SymbolInformation expected;
+    ASSERT_TRUE(scan_reader->GetSymbol(symbol, &expected));
+    EXPECT_EQ(expected.address + reader.GetLoadBias(),
+              FromPointerCast<VMAddress>(dlsym(module.get(), symbol)));
+
+    ElfSymbolTableReader::SymbolInformation info;
+    ASSERT_TRUE(gnu_hash_reader->GetSymbol(symbol, &info));
+    ExpectSameSymbol(info, expected);
+
+    ASSERT_TRUE(hash_reader->GetSymbol(symbol, &info));
+    ExpectSameSymbol(info, expected);
+  }
+
+  static constexpr const char* kMissingSymbols[] = {
+      "notasymbol",
+      "HashTypesTestFunction8",
+      "hashtypestestfunction1",
+  };
+  for (const char* symbol : kMissingSymbols) {
+    SCOPED_TRACE(symbol);
+
+    ElfSymbolTableReader::SymbolInformation info;
+    EXPECT_FALSE(scan_reader->GetSymbol(symbol, &info));
+    EXPECT_FALSE(gnu_hash_reader->GetSymbol(symbol, &info));
+    EXPECT_FALSE(hash_reader->GetSymbol(symbol, &info));
+  }
+}
+
+#endif  // !defined(ARCH_CPU_MIPS_FAMILY)
+
 #if BUILDFLAG(IS_FUCHSIA)
 
 // crashpad_snapshot_test_both_dt_hash_styles is specially built and forced to
@@ -318,13 +488,7 @@ TEST(ElfImageReader, OneModuleChild) {
 // TODO(scottmg): Separately, the location of the ELF on Android needs some
 // work, and then the test could also be enabled there.
 TEST(ElfImageReader, DtHashAndDtGnuHashMatch) {
-  base::FilePath module_path =
-      TestPaths::BuildArtifact(FILE_PATH_LITERAL("snapshot"),
-                               FILE_PATH_LITERAL("both_dt_hash_styles"),
-                               TestPaths::FileType::kLoadableModule);
-  // TODO(scottmg): Remove this when upstream Fuchsia bug ZX-1619 is resolved.
-  // See also explanation in build/run_tests.py for Fuchsia .so files.
-  module_path = module_path.BaseName();
+  const base::FilePath module_path = BothDtHashStylesModulePath();
   ScopedModuleHandle module(
       dlopen(module_path.value().c_str(), RTLD_LAZY | RTLD_LOCAL));
   ASSERT_TRUE(module.valid()) << "dlopen " << module_path.value() << ": "
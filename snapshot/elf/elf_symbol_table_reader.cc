@@ -16,6 +16,7 @@
 
 #include <elf.h>
 
+#include "base/logging.h"
 #include "snapshot/elf/elf_image_reader.h"
 
 namespace crashpad {
@@ -46,23 +47,246 @@ uint8_t GetVisibility(const Elf64_Sym& sym) {
   return ELF64_ST_VISIBILITY(sym.st_other);
 }
 
+template <typename SymEnt>
+void SetSymbolInformation(const SymEnt& entry,
+                          ElfSymbolTableReader::SymbolInformation* info) {
+  info->address = entry.st_value;
+  info->size = entry.st_size;
+  info->shndx = entry.st_shndx;
+  info->binding = GetBinding(entry);
+  info->type = GetType(entry);
+  info->visibility = GetVisibility(entry);
+}
+
+// The hash function used by DT_GNU_HASH.
+uint32_t GnuHash(const std::string& name) {
+  uint32_t hash = 5381;
+  for (unsigned char c : name) {
+    hash = hash * 33 + c;
+  }
+  return hash;
+}
+
+// The hash function used by DT_HASH, from the System V ABI.
+uint32_t ElfHash(const std::string& name) {
+  uint32_t hash = 0;
+  for (unsigned char c : name) {
+    hash = (hash << 4) + c;
+    const uint32_t high = hash & 0xf0000000;
+    if (high) {
+      hash ^= high >> 24;
+    }
+    hash &= ~high;
+  }
+  return hash;
+}
+
 }  // namespace
 
 ElfSymbolTableReader::ElfSymbolTableReader(const ProcessMemoryRange* memory,
                                            ElfImageReader* elf_reader,
                                            VMAddress address,
-                                           VMSize num_entries)
+                                           VMSize num_entries,
+                                           VMAddress gnu_hash_address,
+                                           VMAddress hash_address)
     : memory_(memory),
       elf_reader_(elf_reader),
       base_address_(address),
-      num_entries_(num_entries) {}
+      num_entries_(num_entries),
+      gnu_hash_address_(gnu_hash_address),
+      hash_address_(hash_address) {}
 
 ElfSymbolTableReader::~ElfSymbolTableReader() {}
 
 bool ElfSymbolTableReader::GetSymbol(const std::string& name,
                                      SymbolInformation* info) {
-  return memory_->Is64Bit() ? ScanSymbolTable<Elf64_Sym>(name, info)
-                            : ScanSymbolTable<Elf32_Sym>(name, info);
+  return memory_->Is64Bit() ? GetSymbolImpl<Elf64_Sym>(name, info)
+                            : GetSymbolImpl<Elf32_Sym>(name, info);
+}
+
+template <typename SymEnt>
+bool ElfSymbolTableReader::GetSymbolImpl(const std::string& name,
+                                         SymbolInformation* info) {
+  LookupResult result;
+  if (gnu_hash_address_ &&
+      (result = LookUpInGnuHash<SymEnt>(name, info)) != LookupResult::kError) {
+    return result == LookupResult::kFound;
+  }
+  if (hash_address_ &&
+      (result = LookUpInHash<SymEnt>(name, info)) != LookupResult::kError) {
+    return result == LookupResult::kFound;
+  }
+  return ScanSymbolTable<SymEnt>(name, info);
+}
+
+// See https://flapenguin.me/2017/05/10/elf-lookup-dt-gnu-hash/ and
+// https://sourceware.org/ml/binutils/2006-10/msg00377.html.
+template <typename SymEnt>
+ElfSymbolTableReader::LookupResult ElfSymbolTableReader::LookUpInGnuHash(
+    const std::string& name,
+    SymbolInformation* info) {
+  struct {
+    uint32_t nbuckets;
+    uint32_t symoffset;
+    uint32_t bloom_size;
+    uint32_t bloom_shift;
+  } header;
+  if (!memory_->Read(gnu_hash_address_, sizeof(header), &header)) {
+    LOG(ERROR) << "failed to read DT_GNU_HASH header";
+    return LookupResult::kError;
+  }
+
+  // Bloom filter words are the size of an address in the image.
+  using BloomWord = decltype(SymEnt::st_value);
+  constexpr uint32_t kBloomWordBits = sizeof(BloomWord) * 8;
+  if (header.nbuckets == 0 || header.bloom_size == 0 ||
+      (header.bloom_size & (header.bloom_size - 1)) != 0 ||
+      header.bloom_shift >= 32) {
+    LOG(ERROR) << "invalid DT_GNU_HASH header";
+    return LookupResult::kError;
+  }
+
+  const uint32_t hash = GnuHash(name);
+
+  // The bloom filter rules out most symbols that aren't present without
+  // having to read any chains.
+  const VMAddress bloom_address = gnu_hash_address_ + sizeof(header);
+  BloomWord bloom_word;
+  if (!memory_->Read(
+          bloom_address + sizeof(BloomWord) *
+                              ((hash / kBloomWordBits) &
+                               (header.bloom_size - 1)),
+          sizeof(bloom_word),
+          &bloom_word)) {
+    LOG(ERROR) << "read bloom filter";
+    return LookupResult::kError;
+  }
+  const BloomWord bloom_mask =
+      (BloomWord{1} << (hash % kBloomWordBits)) |
+      (BloomWord{1} << ((hash >> header.bloom_shift) % kBloomWordBits));
+  if ((bloom_word & bloom_mask) != bloom_mask) {
+    return LookupResult::kNotFound;
+  }
+
+  const VMAddress buckets_address =
+      bloom_address + sizeof(BloomWord) * header.bloom_size;
+  uint32_t symbol_index;
+  if (!memory_->Read(buckets_address + sizeof(symbol_index) *
+                                           (hash % header.nbuckets),
+                     sizeof(symbol_index),
+                     &symbol_index)) {
+    LOG(ERROR) << "read bucket";
+    return LookupResult::kError;
+  }
+  if (symbol_index < header.symoffset) {
+    return LookupResult::kNotFound;
+  }
+
+  // Each chain entry holds the hash of the corresponding symbol, with the low
+  // bit replaced by a flag marking the end of the chain.
+  const VMAddress chains_address =
+      buckets_address + sizeof(uint32_t) * header.nbuckets;
+  for (; symbol_index < num_entries_; ++symbol_index) {
+    uint32_t chain_entry;
+    if (!memory_->Read(chains_address + sizeof(chain_entry) *
+                                            (symbol_index - header.symoffset),
+                       sizeof(chain_entry),
+                       &chain_entry)) {
+      LOG(ERROR) << "read chain entry";
+      return LookupResult::kError;
+    }
+
+    if ((chain_entry | 1) == (hash | 1)) {
+      LookupResult result = CheckSymbol<SymEnt>(symbol_index, name, info);
+      if (result != LookupResult::kNotFound) {
+        return result;
+      }
+    }
+
+    if (chain_entry & 1) {
+      return LookupResult::kNotFound;
+    }
+  }
+
+  LOG(ERROR) << "unterminated DT_GNU_HASH chain";
+  return LookupResult::kError;
+}
+
+template <typename SymEnt>
+ElfSymbolTableReader::LookupResult ElfSymbolTableReader::LookUpInHash(
+    const std::string& name,
+    SymbolInformation* info) {
+  struct {
+    uint32_t nbucket;
+    uint32_t nchain;
+  } header;
+  if (!memory_->Read(hash_address_, sizeof(header), &header)) {
+    LOG(ERROR) << "failed to read DT_HASH header";
+    return LookupResult::kError;
+  }
+  if (header.nbucket == 0) {
+    LOG(ERROR) << "invalid DT_HASH header";
+    return LookupResult::kError;
+  }
+
+  const uint32_t hash = ElfHash(name);
+
+  const VMAddress buckets_address = hash_address_ + sizeof(header);
+  const VMAddress chains_address =
+      buckets_address + sizeof(uint32_t) * header.nbucket;
+  uint32_t symbol_index;
+  if (!memory_->Read(buckets_address + sizeof(symbol_index) *
+                                           (hash % header.nbucket),
+                     sizeof(symbol_index),
+                     &symbol_index)) {
+    LOG(ERROR) << "read bucket";
+    return LookupResult::kError;
+  }
+
+  // A well-formed chain visits each symbol at most once, so a chain longer
+  // than the table must contain a cycle.
+  for (uint32_t steps = 0; symbol_index != STN_UNDEF; ++steps) {
+    if (symbol_index >= header.nchain || steps >= header.nchain) {
+      LOG(ERROR) << "invalid DT_HASH chain";
+      return LookupResult::kError;
+    }
+
+    LookupResult result = CheckSymbol<SymEnt>(symbol_index, name, info);
+    if (result != LookupResult::kNotFound) {
+      return result;
+    }
+
+    if (!memory_->Read(chains_address + sizeof(symbol_index) * symbol_index,
+                       sizeof(symbol_index),
+                       &symbol_index)) {
+      LOG(ERROR) << "read chain entry";
+      return LookupResult::kError;
+    }
+  }
+
+  return LookupResult::kNotFound;
+}
+
+template <typename SymEnt>
+ElfSymbolTableReader::LookupResult ElfSymbolTableReader::CheckSymbol(
+    uint32_t index,
+    const std::string& name,
+    SymbolInformation* info) {
+  SymEnt entry;
+  if (!memory_->Read(
+          base_address_ + sizeof(entry) * index, sizeof(entry), &entry)) {
+    LOG(ERROR) << "read symbol";
+    return LookupResult::kError;
+  }
+
+  std::string string;
+  if (!elf_reader_->ReadDynamicStringTableAtOffset(entry.st_name, &string) ||
+      string != name) {
+    return LookupResult::kNotFound;
+  }
+
+  SetSymbolInformation(entry, info);
+  return LookupResult::kFound;
 }
 
 template <typename SymEnt>
@@ -75,12 +299,7 @@ bool ElfSymbolTableReader::ScanSymbolTable(const std::string& name,
   while (i < num_entries_ && memory_->Read(address, sizeof(entry), &entry)) {
     if (elf_reader_->ReadDynamicStringTableAtOffset(entry.st_name, &string) &&
         string == name) {
-      info_out->address = entry.st_value;
-      info_out->size = entry.st_size;
-      info_out->shndx = entry.st_shndx;
-      info_out->binding = GetBinding(entry);
-      info_out->type = GetType(entry);
-      info_out->visibility = GetVisibility(entry);
+      SetSymbolInformation(entry, info_out);
       return true;
     }
     // TODO(scottmg): This should respect DT_SYMENT if present.
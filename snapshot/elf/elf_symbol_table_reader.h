@@ -56,12 +56,23 @@ class ElfSymbolTableReader {
     uint8_t visibility;
   };
 
-  // TODO(jperaza): Support using .hash and .gnu.hash sections to improve symbol
-  // lookup.
+  //! \brief Constructs a reader for a symbol table.
+  //!
+  //! \param[in] memory The memory of the process containing the symbol table.
+  //! \param[in] elf_reader The reader for the image containing the symbol
+  //!     table, used to read symbol names from its dynamic string table.
+  //! \param[in] address The address of the symbol table.
+  //! \param[in] num_entries The number of entries in the symbol table.
+  //! \param[in] gnu_hash_address The address of the image's `DT_GNU_HASH`
+  //!     table, or `0` if it does not have one.
+  //! \param[in] hash_address The address of the image's `DT_HASH` table, or
+  //!     `0` if it does not have one.
   ElfSymbolTableReader(const ProcessMemoryRange* memory,
                        ElfImageReader* elf_reader,
                        VMAddress address,
-                       VMSize num_entries);
+                       VMSize num_entries,
+                       VMAddress gnu_hash_address,
+                       VMAddress hash_address);
 
   ElfSymbolTableReader(const ElfSymbolTableReader&) = delete;
   ElfSymbolTableReader& operator=(const ElfSymbolTableReader&) = delete;
@@ -70,19 +81,51 @@ class ElfSymbolTableReader {
 
   //! \brief Lookup information about a symbol.
   //!
+  //! The symbol is looked up using the image's `DT_GNU_HASH` or `DT_HASH`
+  //! table, as the dynamic linker does. The symbol table is only scanned if
+  //! neither table is present or could be read.
+  //!
   //! \param[in] name The name of the symbol to search for.
   //! \param[out] info The symbol information, if found.
   //! \return `true` if the symbol is found.
   bool GetSymbol(const std::string& name, SymbolInformation* info);
 
  private:
+  enum class LookupResult {
+    kFound,
+    kNotFound,
+    kError,
+  };
+
+  template <typename SymEnt>
+  bool GetSymbolImpl(const std::string& name, SymbolInformation* info);
+
+  template <typename SymEnt>
+  LookupResult LookUpInGnuHash(const std::string& name,
+                               SymbolInformation* info);
+
+  template <typename SymEnt>
+  LookupResult LookUpInHash(const std::string& name, SymbolInformation* info);
+
   template <typename SymEnt>
   bool ScanSymbolTable(const std::string& name, SymbolInformation* info);
 
+  //! \brief Reads the symbol at \a index and, if it is named \a name, fills in
+  //!     \a info from it.
+  //!
+  //! \return `kFound` if the symbol is named \a name, `kNotFound` if it is
+  //!     not, or `kError` if it could not be read.
+  template <typename SymEnt>
+  LookupResult CheckSymbol(uint32_t index,
+                           const std::string& name,
+                           SymbolInformation* info);
+
   const ProcessMemoryRange* const memory_;  // weak
   ElfImageReader* const elf_reader_;  // weak
   const VMAddress base_address_;
   const VMSize num_entries_;
+  const VMAddress gnu_hash_address_;
+  const VMAddress hash_address_;
 };
 
 }  // namespace crashpad
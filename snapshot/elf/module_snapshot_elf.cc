@@ -30,14 +30,20 @@ ModuleSnapshotElf::ModuleSnapshotElf(const std::string& name,
                                      ElfImageReader* elf_reader,
                                      ModuleSnapshot::ModuleType type,
                                      ProcessMemoryRange* process_memory_range,
-                                     const ProcessMemory* process_memory)
+                                     const ProcessMemory* process_memory,
+                                     ElfImageInfoCache* image_info_cache)
     : ModuleSnapshot(),
       name_(name),
       elf_reader_(elf_reader),
       process_memory_range_(process_memory_range),
       process_memory_(process_memory),
+      image_info_cache_(image_info_cache),
       crashpad_info_(),
+      build_id_(),
       type_(type),
+      annotations_simple_map_(),
+      annotation_objects_(),
+      annotations_cached_(false),
       initialized_(),
       streams_() {}
 
@@ -51,6 +57,49 @@ bool ModuleSnapshotElf::Initialize() {
     return false;
   }
 
+  // The build ID is returned by both BuildID() and UUIDAndAge(), so read it
+  // once.
+  std::unique_ptr<ElfImageReader::NoteReader> build_id_notes =
+      elf_reader_->NotesWithNameAndType(ELF_NOTE_GNU, NT_GNU_BUILD_ID, 64);
+  std::string build_id;
+  VMAddress build_id_address;
+  if (build_id_notes->NextNote(nullptr, nullptr, &build_id, &build_id_address) ==
+      ElfImageReader::NoteReader::Result::kSuccess) {
+    build_id_.assign(build_id.begin(), build_id.end());
+  }
+
+  // Where an image’s CrashpadInfo is doesn’t depend on the process it’s loaded
+  // in, apart from the load bias, so images that have been seen before don’t
+  // need their notes searched again.
+  ElfImageInfoCache::ImageInfo image_info;
+  const bool use_cache = image_info_cache_ && !build_id_.empty();
+  if (!use_cache || !image_info_cache_->Find(build_id_, &image_info)) {
+    ReadImageInfo(&image_info);
+    if (use_cache) {
+      image_info_cache_->Insert(build_id_, image_info);
+    }
+  }
+
+  if (image_info.has_crashpad_info) {
+    const VMAddress info_address =
+        image_info.crashpad_info_address + elf_reader_->GetLoadBias();
+    ProcessMemoryRange range;
+    if (range.Initialize(*elf_reader_->Memory())) {
+      auto info = std::make_unique<CrashpadInfoReader>();
+      if (info->Initialize(&range, info_address)) {
+        crashpad_info_ = std::move(info);
+      }
+    }
+  }
+
+  INITIALIZATION_STATE_SET_VALID(initialized_);
+  return true;
+}
+
+void ModuleSnapshotElf::ReadImageInfo(ElfImageInfoCache::ImageInfo* info) {
+  info->crashpad_info_address = 0;
+  info->has_crashpad_info = false;
+
   // The data payload is only sizeof(VMAddress) in the note, but add a bit to
   // account for the name, header, and padding.
   constexpr ssize_t kMaxNoteSize = 256;
@@ -59,7 +108,6 @@ bool ModuleSnapshotElf::Initialize() {
                                         CRASHPAD_ELF_NOTE_TYPE_CRASHPAD_INFO,
                                         kMaxNoteSize);
   std::string desc;
-  VMAddress info_address;
   VMAddress desc_address;
   if (notes->NextNote(nullptr, nullptr, &desc, &desc_address) ==
       ElfImageReader::NoteReader::Result::kSuccess) {
@@ -70,19 +118,10 @@ bool ModuleSnapshotElf::Initialize() {
       int32_t offset32 = *reinterpret_cast<int32_t*>(&desc[0]);
       offset = offset32;
     }
-    info_address = desc_address + offset;
-
-    ProcessMemoryRange range;
-    if (range.Initialize(*elf_reader_->Memory())) {
-      auto info = std::make_unique<CrashpadInfoReader>();
-      if (info->Initialize(&range, info_address)) {
-        crashpad_info_ = std::move(info);
-      }
-    }
+    info->crashpad_info_address =
+        desc_address + offset - elf_reader_->GetLoadBias();
+    info->has_crashpad_info = true;
   }
-
-  INITIALIZATION_STATE_SET_VALID(initialized_);
-  return true;
 }
 
 bool ModuleSnapshotElf::GetCrashpadOptions(CrashpadInfoClientOptions* options) {
@@ -100,6 +139,10 @@ bool ModuleSnapshotElf::GetCrashpadOptions(CrashpadInfoClientOptions* options) {
       crashpad_info_->GatherIndirectlyReferencedMemory();
   options->indirectly_referenced_memory_cap =
       crashpad_info_->IndirectlyReferencedMemoryCap();
+  options->stack_capture_limit = crashpad_info_->StackCaptureLimit();
+  options->stack_frame_window_size = crashpad_info_->StackFrameWindowSize();
+  options->gather_thread_float_contexts =
+      crashpad_info_->GatherThreadFloatContexts();
   return true;
 }
 
@@ -174,17 +217,7 @@ std::string ModuleSnapshotElf::DebugFileName() const {
 
 std::vector<uint8_t> ModuleSnapshotElf::BuildID() const {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
-
-  std::unique_ptr<ElfImageReader::NoteReader> notes =
-      elf_reader_->NotesWithNameAndType(ELF_NOTE_GNU, NT_GNU_BUILD_ID, 64);
-  std::string desc;
-  VMAddress desc_addr;
-  notes->NextNote(nullptr, nullptr, &desc, &desc_addr);
-
-  std::vector<uint8_t> build_id;
-  build_id.reserve(desc.size());
-  std::copy(desc.begin(), desc.end(), std::back_inserter(build_id));
-  return build_id;
+  return build_id_;
 }
 
 std::vector<std::string> ModuleSnapshotElf::AnnotationsVector() const {
@@ -192,25 +225,47 @@ std::vector<std::string> ModuleSnapshotElf::AnnotationsVector() const {
   return std::vector<std::string>();
 }
 
+void ModuleSnapshotElf::CacheAnnotations() {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  ReadAnnotations();
+}
+
+void ModuleSnapshotElf::ReadAnnotations() const {
+  if (annotations_cached_) {
+    return;
+  }
+  annotations_cached_ = true;
+
+  if (!crashpad_info_) {
+    return;
+  }
+
+  ImageAnnotationReader reader(process_memory_range_);
+  if (crashpad_info_->SimpleAnnotations()) {
+    reader.SimpleMap(crashpad_info_->SimpleAnnotations(),
+                     &annotations_simple_map_);
+  }
+  if (crashpad_info_->AnnotationsList()) {
+    reader.AnnotationsList(crashpad_info_->AnnotationsList(),
+                           &annotation_objects_);
+  }
+  if (crashpad_info_->ThreadAnnotationLists()) {
+    reader.ThreadAnnotationsLists(crashpad_info_->ThreadAnnotationLists(),
+                                  &annotation_objects_);
+  }
+}
+
 std::map<std::string, std::string> ModuleSnapshotElf::AnnotationsSimpleMap()
     const {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
-  std::map<std::string, std::string> annotations;
-  if (crashpad_info_ && crashpad_info_->SimpleAnnotations()) {
-    ImageAnnotationReader reader(process_memory_range_);
-    reader.SimpleMap(crashpad_info_->SimpleAnnotations(), &annotations);
-  }
-  return annotations;
+  ReadAnnotations();
+  return annotations_simple_map_;
 }
 
 std::vector<AnnotationSnapshot> ModuleSnapshotElf::AnnotationObjects() const {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
-  std::vector<AnnotationSnapshot> annotations;
-  if (crashpad_info_ && crashpad_info_->AnnotationsList()) {
-    ImageAnnotationReader reader(process_memory_range_);
-    reader.AnnotationsList(crashpad_info_->AnnotationsList(), &annotations);
-  }
-  return annotations;
+  ReadAnnotations();
+  return annotation_objects_;
 }
 
 std::set<CheckedRange<uint64_t>> ModuleSnapshotElf::ExtraMemoryRanges() const {
@@ -25,6 +25,7 @@
 #include "client/crashpad_info.h"
 #include "snapshot/crashpad_info_client_options.h"
 #include "snapshot/crashpad_types/crashpad_info_reader.h"
+#include "snapshot/elf/elf_image_info_cache.h"
 #include "snapshot/elf/elf_image_reader.h"
 #include "snapshot/module_snapshot.h"
 #include "util/misc/initialization_state_dcheck.h"
@@ -44,11 +45,14 @@ class ModuleSnapshotElf final : public ModuleSnapshot {
   //!     to the target process.
   //! \param[in] process_memory A memory reader for the target process which can
   //!     be used to initialize a MemorySnapshot.
+  //! \param[in] image_info_cache A cache of what is known about images by
+  //!     build ID, shared with snapshots of other processes. Optional.
   ModuleSnapshotElf(const std::string& name,
                     ElfImageReader* elf_reader,
                     ModuleSnapshot::ModuleType type,
                     ProcessMemoryRange* process_memory_range,
-                    const ProcessMemory* process_memory);
+                    const ProcessMemory* process_memory,
+                    ElfImageInfoCache* image_info_cache = nullptr);
 
   ModuleSnapshotElf(const ModuleSnapshotElf&) = delete;
   ModuleSnapshotElf& operator=(const ModuleSnapshotElf&) = delete;
@@ -67,6 +71,14 @@ class ModuleSnapshotElf final : public ModuleSnapshot {
   //! \return `true` if there were options returned. Otherwise `false`.
   bool GetCrashpadOptions(CrashpadInfoClientOptions* options);
 
+  //! \brief Reads the module’s annotations from the target process now.
+  //!
+  //! The annotations are otherwise read the first time AnnotationsSimpleMap()
+  //! or AnnotationObjects() is called. Either way, they are read only once, and
+  //! later calls return what was read. Calling this allows the annotations of
+  //! several modules to be read in parallel as part of initialization.
+  void CacheAnnotations();
+
   // ModuleSnapshot:
 
   std::string Name() const override;
@@ -92,12 +104,24 @@ class ModuleSnapshotElf final : public ModuleSnapshot {
   std::vector<const UserMinidumpStream*> CustomMinidumpStreams() const override;
 
  private:
+  // Searches the module’s notes for what image_info_cache_ caches.
+  void ReadImageInfo(ElfImageInfoCache::ImageInfo* info);
+
+  // Reads the annotations into annotations_simple_map_ and annotation_objects_
+  // if they haven’t been read yet.
+  void ReadAnnotations() const;
+
   std::string name_;
   ElfImageReader* elf_reader_;
   ProcessMemoryRange* process_memory_range_;
   const ProcessMemory* process_memory_;
+  ElfImageInfoCache* image_info_cache_;  // weak
   std::unique_ptr<CrashpadInfoReader> crashpad_info_;
+  std::vector<uint8_t> build_id_;
   ModuleType type_;
+  mutable std::map<std::string, std::string> annotations_simple_map_;
+  mutable std::vector<AnnotationSnapshot> annotation_objects_;
+  mutable bool annotations_cached_;
   InitializationStateDcheck initialized_;
   // Too const-y: https://crashpad.chromium.org/bug/9.
   mutable std::vector<std::unique_ptr<const UserMinidumpStream>> streams_;
@@ -14,13 +14,15 @@
 
 #include "snapshot/fuchsia/process_reader_fuchsia.h"
 
-#include <lib/zx/thread.h>
 #include <link.h>
 #include <zircon/syscalls.h>
 
+#include <algorithm>
+
 #include "base/fuchsia/fuchsia_logging.h"
 #include "base/logging.h"
 #include "util/fuchsia/koid_utilities.h"
+#include "util/thread/thread.h"
 
 namespace crashpad {
 
@@ -101,6 +103,33 @@ void GetStackRegions(
 
 }  // namespace
 
+// Gathers the details of threads in ProcessReaderFuchsia::threads_. Several of
+// these may run at once, alongside the thread that called Threads().
+class ProcessReaderFuchsia::ThreadInitializerThread : public crashpad::Thread {
+ public:
+  ThreadInitializerThread(ProcessReaderFuchsia* reader,
+                          const std::vector<zx::thread>* thread_handles,
+                          std::atomic<size_t>* next_index)
+      : reader_(reader),
+        thread_handles_(thread_handles),
+        next_index_(next_index) {}
+
+  ThreadInitializerThread(const ThreadInitializerThread&) = delete;
+  ThreadInitializerThread& operator=(const ThreadInitializerThread&) = delete;
+
+  ~ThreadInitializerThread() override {}
+
+ private:
+  // Thread:
+  void ThreadMain() override {
+    reader_->InitializeThreadDetails(*thread_handles_, next_index_);
+  }
+
+  ProcessReaderFuchsia* reader_;  // weak
+  const std::vector<zx::thread>* thread_handles_;  // weak
+  std::atomic<size_t>* next_index_;
+};
+
 ProcessReaderFuchsia::Module::Module() = default;
 
 ProcessReaderFuchsia::Module::~Module() = default;
@@ -113,14 +142,22 @@ ProcessReaderFuchsia::ProcessReaderFuchsia() = default;
 
 ProcessReaderFuchsia::~ProcessReaderFuchsia() = default;
 
-bool ProcessReaderFuchsia::Initialize(const zx::process& process) {
+bool ProcessReaderFuchsia::Initialize(
+    const zx::process& process,
+    unsigned int thread_initialization_threads) {
   INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
 
   process_ = zx::unowned_process(process);
+  thread_initialization_threads_ = std::max(1u, thread_initialization_threads);
 
   process_memory_.reset(new ProcessMemoryFuchsia());
   process_memory_->Initialize(*process_);
 
+  // Each zx_process_read_memory() is a separate syscall, and walking the
+  // link_map list and module headers makes many small reads close together, so
+  // they are served from pages read from the process a page at a time.
+  memory_.Initialize(process_memory_.get());
+
   INITIALIZATION_STATE_SET_VALID(initialized_);
   return true;
 }
@@ -181,7 +218,7 @@ void ProcessReaderFuchsia::InitializeModules() {
 
   constexpr auto k_r_debug_map_offset = offsetof(r_debug, r_map);
   uintptr_t map;
-  if (!process_memory_->Read(
+  if (!memory_.Read(
           debug_address + k_r_debug_map_offset, sizeof(map), &map)) {
     LOG(ERROR) << "read link_map";
     return;
@@ -197,7 +234,7 @@ void ProcessReaderFuchsia::InitializeModules() {
 
     constexpr auto k_link_map_addr_offset = offsetof(link_map, l_addr);
     zx_vaddr_t base;
-    if (!process_memory_->Read(
+    if (!memory_.Read(
             map + k_link_map_addr_offset, sizeof(base), &base)) {
       LOG(ERROR) << "Read base";
       // Could theoretically continue here, but realistically if any part of
@@ -207,7 +244,7 @@ void ProcessReaderFuchsia::InitializeModules() {
 
     constexpr auto k_link_map_next_offset = offsetof(link_map, l_next);
     zx_vaddr_t next;
-    if (!process_memory_->Read(
+    if (!memory_.Read(
             map + k_link_map_next_offset, sizeof(next), &next)) {
       LOG(ERROR) << "Read next";
       break;
@@ -215,7 +252,7 @@ void ProcessReaderFuchsia::InitializeModules() {
 
     constexpr auto k_link_map_name_offset = offsetof(link_map, l_name);
     zx_vaddr_t name_address;
-    if (!process_memory_->Read(map + k_link_map_name_offset,
+    if (!memory_.Read(map + k_link_map_name_offset,
                                sizeof(name_address),
                                &name_address)) {
       LOG(ERROR) << "Read name address";
@@ -223,7 +260,7 @@ void ProcessReaderFuchsia::InitializeModules() {
     }
 
     std::string dsoname;
-    if (!process_memory_->ReadCString(name_address, &dsoname)) {
+    if (!memory_.ReadCString(name_address, &dsoname)) {
       // In this case, it could be reasonable to continue on to the next module
       // as this data isn't strictly in the link_map.
       LOG(ERROR) << "ReadCString name";
@@ -279,7 +316,7 @@ void ProcessReaderFuchsia::InitializeModules() {
     std::unique_ptr<ProcessMemoryRange> process_memory_range(
         new ProcessMemoryRange());
     // TODO(scottmg): Could this be limited range?
-    if (process_memory_range->Initialize(process_memory_.get(), true)) {
+    if (process_memory_range->Initialize(&memory_, true)) {
       process_memory_ranges_.push_back(std::move(process_memory_range));
 
       if (reader->Initialize(*process_memory_ranges_.back(), base)) {
@@ -305,59 +342,91 @@ void ProcessReaderFuchsia::InitializeThreads() {
       GetHandlesForThreadKoids(*process_, thread_koids);
   DCHECK_EQ(thread_koids.size(), thread_handles.size());
 
+  threads_.resize(thread_handles.size());
   for (size_t i = 0; i < thread_handles.size(); ++i) {
-    Thread thread;
-    thread.id = thread_koids[i];
+    threads_[i].id = thread_koids[i];
+  }
 
-    if (thread_handles[i].is_valid()) {
+  // The memory map is shared by every thread’s stack region lookup, so it is
+  // initialized before any of them run.
+  MemoryMap();
+
+  // Each thread’s details are gathered by exactly one thread, which writes only
+  // to that thread’s element of threads_. The calling thread does its share of
+  // the work too.
+  std::atomic<size_t> next_index(0);
+  const size_t worker_count =
+      std::max(size_t{1},
+               std::min(size_t{thread_initialization_threads_},
+                        thread_handles.size())) -
+      1;
+  std::vector<std::unique_ptr<ThreadInitializerThread>> workers;
+  workers.reserve(worker_count);
+  for (size_t index = 0; index < worker_count; ++index) {
+    workers.push_back(std::make_unique<ThreadInitializerThread>(
+        this, &thread_handles, &next_index));
+    workers.back()->Start();
+  }
+  InitializeThreadDetails(thread_handles, &next_index);
+  for (const auto& worker : workers) {
+    worker->Join();
+  }
+}
+
+void ProcessReaderFuchsia::InitializeThreadDetails(
+    const std::vector<zx::thread>& thread_handles,
+    std::atomic<size_t>* next_index) {
+  for (size_t index = (*next_index)++; index < thread_handles.size();
+       index = (*next_index)++) {
+    const zx::thread& thread_handle = thread_handles[index];
+    Thread* thread = &threads_[index];
+
+    if (thread_handle.is_valid()) {
       char name[ZX_MAX_NAME_LEN] = {0};
       zx_status_t status =
-          thread_handles[i].get_property(ZX_PROP_NAME, &name, sizeof(name));
+          thread_handle.get_property(ZX_PROP_NAME, &name, sizeof(name));
       if (status != ZX_OK) {
         ZX_LOG(WARNING, status) << "zx_object_get_property ZX_PROP_NAME";
       } else {
-        thread.name.assign(name);
+        thread->name.assign(name);
       }
 
       zx_info_thread_t thread_info;
-      status = thread_handles[i].get_info(
+      status = thread_handle.get_info(
           ZX_INFO_THREAD, &thread_info, sizeof(thread_info), nullptr, nullptr);
       if (status != ZX_OK) {
         ZX_LOG(WARNING, status) << "zx_object_get_info ZX_INFO_THREAD";
       } else {
-        thread.state = thread_info.state;
+        thread->state = thread_info.state;
       }
 
       zx_thread_state_general_regs_t general_regs;
-      status = thread_handles[i].read_state(
+      status = thread_handle.read_state(
           ZX_THREAD_STATE_GENERAL_REGS, &general_regs, sizeof(general_regs));
       if (status != ZX_OK) {
         ZX_LOG(WARNING, status)
             << "zx_thread_read_state(ZX_THREAD_STATE_GENERAL_REGS)";
       } else {
-        thread.general_registers = general_regs;
+        thread->general_registers = general_regs;
 
-        const MemoryMapFuchsia* memory_map = MemoryMap();
-        if (memory_map) {
+        if (memory_map_) {
           // Attempt to retrive stack regions if a memory map was retrieved. In
           // particular, this may be null when operating on the current process
           // where the memory map will not be able to be retrieved.
-          GetStackRegions(general_regs, *memory_map, &thread.stack_regions);
+          GetStackRegions(general_regs, *memory_map_, &thread->stack_regions);
         }
       }
 
       zx_thread_state_vector_regs_t vector_regs;
-      status = thread_handles[i].read_state(
+      status = thread_handle.read_state(
           ZX_THREAD_STATE_VECTOR_REGS, &vector_regs, sizeof(vector_regs));
       if (status != ZX_OK) {
         ZX_LOG(WARNING, status)
             << "zx_thread_read_state(ZX_THREAD_STATE_VECTOR_REGS)";
       } else {
-        thread.vector_registers = vector_regs;
+        thread->vector_registers = vector_regs;
       }
     }
-
-    threads_.push_back(thread);
   }
 }
 
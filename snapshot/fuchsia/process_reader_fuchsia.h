@@ -16,8 +16,10 @@
 #define CRASHPAD_SNAPSHOT_FUCHSIA_PROCESS_READER_H_
 
 #include <lib/zx/process.h>
+#include <lib/zx/thread.h>
 #include <zircon/syscalls/debug.h>
 
+#include <atomic>
 #include <memory>
 #include <vector>
 
@@ -27,6 +29,7 @@
 #include "snapshot/module_snapshot.h"
 #include "util/misc/initialization_state_dcheck.h"
 #include "util/numeric/checked_range.h"
+#include "util/process/caching_process_memory.h"
 #include "util/process/process_memory_fuchsia.h"
 #include "util/process/process_memory_range.h"
 
@@ -98,11 +101,16 @@ class ProcessReaderFuchsia {
   //!
   //! \param[in] process A process handle with permissions to read properties
   //!     and memory from the target process.
+  //! \param[in] thread_initialization_threads The number of threads that may
+  //!     gather the names, states, registers, and stack regions of the
+  //!     process’ threads at the same time. The order of Threads() is the same
+  //!     regardless.
   //!
   //! \return `true` on success, indicating that this object will respond
   //!     validly to further method calls. `false` on failure. On failure, no
   //!     further method calls should be made.
-  bool Initialize(const zx::process& process);
+  bool Initialize(const zx::process& process,
+                  unsigned int thread_initialization_threads = 1);
 
   //! \return The modules loaded in the process. The first element (at index
   //!     `0`) corresponds to the main executable.
@@ -112,7 +120,11 @@ class ProcessReaderFuchsia {
   const std::vector<Thread>& Threads();
 
   //! \brief Return a memory reader for the target process.
-  const ProcessMemory* Memory() const { return process_memory_.get(); }
+  //!
+  //! Small reads are satisfied from a cache of pages read from the target
+  //! process, so this must only be used while the target process is
+  //! suspended.
+  const ProcessMemory* Memory() const { return &memory_; }
 
   //! \brief Return a memory map for the target process.
   const MemoryMapFuchsia* MemoryMap();
@@ -126,6 +138,14 @@ class ProcessReaderFuchsia {
   //! Threads().
   void InitializeThreads();
 
+  class ThreadInitializerThread;
+
+  //! Gathers the details of the threads in \a threads_ whose handles are in
+  //! \a thread_handles, taking each index to work on from \a next_index,
+  //! until there are none left. This may run on several threads at once.
+  void InitializeThreadDetails(const std::vector<zx::thread>& thread_handles,
+                               std::atomic<size_t>* next_index);
+
   //! Performs lazy initialization of the \a memory_map_ on behalf of
   //! MemoryMap().
   void InitializeMemoryMap();
@@ -135,8 +155,10 @@ class ProcessReaderFuchsia {
   std::vector<std::unique_ptr<ElfImageReader>> module_readers_;
   std::vector<std::unique_ptr<ProcessMemoryRange>> process_memory_ranges_;
   std::unique_ptr<ProcessMemoryFuchsia> process_memory_;
+  CachingProcessMemory memory_;
   std::unique_ptr<MemoryMapFuchsia> memory_map_;
   zx::unowned_process process_;
+  unsigned int thread_initialization_threads_ = 1;
   bool initialized_modules_ = false;
   bool initialized_threads_ = false;
   bool initialized_memory_map_ = false;
@@ -21,13 +21,20 @@
 #include <zircon/types.h>
 
 #include <iterator>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
 
 #include "base/strings/stringprintf.h"
 #include "gtest/gtest.h"
 #include "test/multiprocess_exec.h"
 #include "test/scoped_set_thread_name.h"
 #include "test/test_paths.h"
+#include "util/fuchsia/koid_utilities.h"
 #include "util/fuchsia/scoped_task_suspend.h"
+#include "util/synchronization/semaphore.h"
+#include "util/thread/thread.h"
 
 namespace crashpad {
 namespace test {
@@ -82,6 +89,82 @@ TEST(ProcessReaderFuchsia, SelfBasic) {
   EXPECT_EQ(threads[0].name, "SelfBasic");
 }
 
+// Names itself and waits until released.
+class NamedWaitingThread : public Thread {
+ public:
+  NamedWaitingThread(const std::string& name,
+                     Semaphore* ready,
+                     Semaphore* release)
+      : name_(name), ready_(ready), release_(release) {}
+
+  NamedWaitingThread(const NamedWaitingThread&) = delete;
+  NamedWaitingThread& operator=(const NamedWaitingThread&) = delete;
+
+  ~NamedWaitingThread() override {}
+
+ private:
+  // Thread:
+  void ThreadMain() override {
+    const ScopedSetThreadName scoped_set_thread_name(name_);
+    ready_->Signal();
+    release_->Wait();
+  }
+
+  std::string name_;
+  Semaphore* ready_;  // weak
+  Semaphore* release_;  // weak
+};
+
+TEST(ProcessReaderFuchsia, SelfThreadsInitializedConcurrently) {
+  const ScopedSetThreadName scoped_set_thread_name("SelfConcurrently");
+
+  constexpr size_t kThreadCount = 16;
+  Semaphore ready(0);
+  Semaphore release(0);
+  std::vector<std::unique_ptr<NamedWaitingThread>> threads_to_read;
+  for (size_t index = 0; index < kThreadCount; ++index) {
+    threads_to_read.push_back(std::make_unique<NamedWaitingThread>(
+        base::StringPrintf("SelfConcurrently-%zu", index), &ready, &release));
+    threads_to_read.back()->Start();
+  }
+  for (size_t index = 0; index < kThreadCount; ++index) {
+    ready.Wait();
+  }
+
+  // The waiting threads are released at the end of the test, so nothing below
+  // returns early.
+  ProcessReaderFuchsia process_reader;
+  EXPECT_TRUE(process_reader.Initialize(*zx::process::self(), 4));
+
+  // Threads() gathers the thread list before starting any threads of its own.
+  std::vector<zx_koid_t> thread_koids =
+      GetChildKoids(*zx::process::self(), ZX_INFO_PROCESS_THREADS);
+
+  // The threads are in the same order as when they are gathered one at a time,
+  // and each has its own name.
+  const auto& threads = process_reader.Threads();
+  EXPECT_EQ(threads.size(), thread_koids.size());
+  std::set<std::string> names;
+  for (size_t index = 0; index < threads.size(); ++index) {
+    if (index < thread_koids.size()) {
+      EXPECT_EQ(threads[index].id, thread_koids[index]);
+    }
+    names.insert(threads[index].name);
+  }
+  EXPECT_EQ(names.count("SelfConcurrently"), 1u);
+  for (size_t index = 0; index < kThreadCount; ++index) {
+    EXPECT_EQ(names.count(base::StringPrintf("SelfConcurrently-%zu", index)),
+              1u);
+  }
+
+  for (size_t index = 0; index < kThreadCount; ++index) {
+    release.Signal();
+  }
+  for (const auto& thread : threads_to_read) {
+    thread->Join();
+  }
+}
+
 constexpr char kTestMemory[] = "Read me from another process";
 
 CRASHPAD_CHILD_TEST_MAIN(ProcessReaderBasicChildTestMain) {
@@ -53,10 +53,14 @@ class ProcessSnapshotFuchsia : public ProcessSnapshot {
   //! \brief Initializes the object.
   //!
   //! \param[in] process The process handle to create a snapshot from.
+  //! \param[in] thread_snapshot_threads The number of threads that may gather
+  //!     information about the process’ threads at the same time. See
+  //!     ProcessReaderFuchsia::Initialize().
   //!
   //! \return `true` if the snapshot could be created, `false` otherwise with
   //!     an appropriate message logged.
-  bool Initialize(const zx::process& process);
+  bool Initialize(const zx::process& process,
+                  unsigned int thread_snapshot_threads = 1);
 
   //! \brief Initializes the object's exception.
   //!
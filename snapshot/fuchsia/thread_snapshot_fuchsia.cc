@@ -109,5 +109,13 @@ std::vector<const MemorySnapshot*> ThreadSnapshotFuchsia::ExtraMemory() const {
   return std::vector<const MemorySnapshot*>();
 }
 
+uint64_t ThreadSnapshotFuchsia::UncapturedStackSize() const {
+  return 0;
+}
+
+std::vector<uint64_t> ThreadSnapshotFuchsia::UnwoundFrames() const {
+  return std::vector<uint64_t>();
+}
+
 }  // namespace internal
 }  // namespace crashpad
@@ -12,6 +12,19 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+// These give the module’s DT_HASH and DT_GNU_HASH tables chains to look
+// symbols up in. ElfImageReader.HashTableLookupsMatchScan looks them up.
+extern "C" {
+__attribute__((visibility("default"))) int HashTypesTestVariable = 1;
+__attribute__((visibility("default"))) void HashTypesTestFunction1() {}
+__attribute__((visibility("default"))) void HashTypesTestFunction2() {}
+__attribute__((visibility("default"))) void HashTypesTestFunction3() {}
+__attribute__((visibility("default"))) void HashTypesTestFunction4() {}
+__attribute__((visibility("default"))) void HashTypesTestFunction5() {}
+__attribute__((visibility("default"))) void HashTypesTestFunction6() {}
+__attribute__((visibility("default"))) void HashTypesTestFunction7() {}
+}  // extern "C"
+
 int main() {
   return 0;
 }
@@ -14,6 +14,10 @@
 
 #include "snapshot/ios/exception_snapshot_ios_intermediate_dump.h"
 
+#include <string.h>
+
+#include <vector>
+
 #include "base/logging.h"
 #include "base/mac/mach_logging.h"
 #include "snapshot/cpu_context.h"
@@ -172,21 +176,21 @@ bool ExceptionSnapshotIOSIntermediateDump::InitializeFromMachException(
   const IOSIntermediateDumpData* code_dump =
       GetDataFromMap(exception_data, Key::kCodes);
   if (code_dump) {
-    const std::vector<uint8_t>& bytes = code_dump->bytes();
-    const mach_exception_data_type_t* code =
-        reinterpret_cast<const mach_exception_data_type_t*>(bytes.data());
-    if (bytes.size() == 0 || !code) {
+    // The data isn't necessarily aligned, so copy it out.
+    std::vector<mach_exception_data_type_t> code(
+        code_dump->size() / sizeof(mach_exception_data_type_t));
+    if (code.empty()) {
       LOG(ERROR) << "Invalid mach exception code.";
     } else {
+      memcpy(code.data(),
+             code_dump->data(),
+             code.size() * sizeof(mach_exception_data_type_t));
       // TODO: rationalize with the macOS implementation.
-      mach_msg_type_number_t code_count =
-          bytes.size() / sizeof(mach_exception_data_type_t);
-      for (mach_msg_type_number_t code_index = 0; code_index < code_count;
-           ++code_index) {
-        codes_.push_back(code[code_index]);
+      for (mach_exception_data_type_t code_value : code) {
+        codes_.push_back(code_value);
       }
       exception_info_ = code[0];
-      exception_address_ = code[1];
+      exception_address_ = code.size() > 1 ? code[1] : 0;
     }
   }
 
@@ -306,7 +310,8 @@ void ExceptionSnapshotIOSIntermediateDump::LoadContextFromThread(
     const IOSIntermediateDumpData* state_dump =
         GetDataFromMap(exception_data, Key::kState);
     if (state_dump) {
-      std::vector<uint8_t> bytes = state_dump->bytes();
+      std::vector<uint8_t> bytes(state_dump->data(),
+                                 state_dump->data() + state_dump->size());
       size_t actual_length = bytes.size();
       size_t expected_length = ThreadStateLengthForFlavor(flavor);
       if (actual_length < expected_length) {
@@ -378,13 +383,16 @@ void ExceptionSnapshotIOSIntermediateDump::
     LoadContextFromUncaughtNSExceptionFrames(
         const IOSIntermediateDumpData* frames_dump,
         const IOSIntermediateDumpMap* other_thread) {
-  const std::vector<uint8_t>& bytes = frames_dump->bytes();
-  const uint64_t* frames = reinterpret_cast<const uint64_t*>(bytes.data());
-  size_t num_frames = bytes.size() / sizeof(uint64_t);
+  size_t num_frames = frames_dump->size() / sizeof(uint64_t);
   if (num_frames < 2) {
     return;
   }
 
+  // Only the first two frames are used. The data isn't necessarily aligned, so
+  // copy them out.
+  uint64_t frames[2];
+  memcpy(frames, frames_dump->data(), sizeof(frames));
+
 #if defined(ARCH_CPU_X86_64)
   context_x86_64_.rip = frames[0];  // instruction pointer
   context_x86_64_.rsp = frames[1];
@@ -14,6 +14,11 @@
 
 #include "snapshot/ios/memory_snapshot_ios_intermediate_dump.h"
 
+#include <string.h>
+
+#include <algorithm>
+#include <memory>
+
 namespace crashpad {
 namespace internal {
 
@@ -22,7 +27,10 @@ void MemorySnapshotIOSIntermediateDump::Initialize(vm_address_t address,
                                                    vm_size_t size) {
   INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
   address_ = address;
-  data_ = data;
+  segments_.clear();
+  if (size > 0) {
+    segments_.push_back({data, size});
+  }
   size_ = base::checked_cast<size_t>(size);
   INITIALIZATION_STATE_SET_VALID(initialized_);
 }
@@ -44,8 +52,21 @@ bool MemorySnapshotIOSIntermediateDump::Read(Delegate* delegate) const {
     return delegate->MemorySnapshotDelegateRead(nullptr, size_);
   }
 
-  return delegate->MemorySnapshotDelegateRead(reinterpret_cast<void*>(data_),
-                                              size_);
+  if (segments_.size() == 1) {
+    return delegate->MemorySnapshotDelegateRead(
+        reinterpret_cast<void*>(segments_[0].data), size_);
+  }
+
+  std::unique_ptr<uint8_t[]> buffer(new uint8_t[size_]);
+  size_t buffer_offset = 0;
+  for (const Segment& segment : segments_) {
+    memcpy(buffer.get() + buffer_offset,
+           reinterpret_cast<const void*>(segment.data),
+           segment.size);
+    buffer_offset += segment.size;
+  }
+  DCHECK_EQ(buffer_offset, size_);
+  return delegate->MemorySnapshotDelegateRead(buffer.get(), size_);
 }
 
 const MemorySnapshot* MemorySnapshotIOSIntermediateDump::MergeWithOtherSnapshot(
@@ -64,23 +85,27 @@ const MemorySnapshot* MemorySnapshotIOSIntermediateDump::MergeWithOtherSnapshot(
     return nullptr;
 
   auto result = std::make_unique<MemorySnapshotIOSIntermediateDump>();
-  result->Initialize(merged.base(), data_, merged.size());
+  result->Initialize(merged.base(), 0, 0);
+  result->size_ = merged.size();
   if (size_ == merged.size()) {
+    result->segments_ = segments_;
     return result.release();
   }
 
-  const uint8_t* data = reinterpret_cast<const uint8_t*>(data_);
-  const uint8_t* other_data =
-      reinterpret_cast<const uint8_t*>(other_snapshot->data_);
-  vm_size_t overlap = merged.size() - other_snapshot->size_;
-  result->merged_data_.reserve(merged.size());
-  result->merged_data_.insert(result->merged_data_.end(), data, data + overlap);
-  result->merged_data_.insert(result->merged_data_.end(),
-                              other_data,
-                              other_data + other_snapshot->size_);
-  result->data_ =
-      reinterpret_cast<const vm_address_t>(result->merged_data_.data());
-  DCHECK_EQ(result->merged_data_.size(), merged.size());
+  // Take this snapshot’s contents up to where other’s begin, and all of
+  // other’s contents after that.
+  vm_size_t remaining = other_snapshot->address_ - address_;
+  for (const Segment& segment : segments_) {
+    if (remaining == 0) {
+      break;
+    }
+    const vm_size_t size = std::min(segment.size, remaining);
+    result->segments_.push_back({segment.data, size});
+    remaining -= size;
+  }
+  result->segments_.insert(result->segments_.end(),
+                           other_snapshot->segments_.begin(),
+                           other_snapshot->segments_.end());
   return result.release();
 }
 
@@ -39,6 +39,8 @@ class MemorySnapshotIOSIntermediateDump final : public MemorySnapshot {
   //! \brief Initializes the object.
   //!
   //! \param[in] address The base address of the memory region to snapshot.
+  //! \param[in] data The location of the memory region’s contents within the
+  //!     intermediate dump, which must outlive this object.
   //! \param[in] size The size of the memory region to snapshot.
   void Initialize(vm_address_t address, vm_address_t data, vm_size_t size);
 
@@ -55,14 +57,16 @@ class MemorySnapshotIOSIntermediateDump final : public MemorySnapshot {
       const T* self,
       const MemorySnapshot* other);
 
-  vm_address_t address_;
-  vm_address_t data_;
-
-  // Because the iOS snapshot memory region is owned by the intermediate dump,
-  // it's necessary to copy the merged data into a vector owned by the memory
-  // snapshot itself.
-  std::vector<uint8_t> merged_data_;
+  // A run of the snapshot’s contents stored contiguously in the intermediate
+  // dump. Merged snapshots consist of several of these, one following the
+  // other, which are only copied together when the snapshot is read.
+  struct Segment {
+    vm_address_t data;
+    vm_size_t size;
+  };
 
+  vm_address_t address_;
+  std::vector<Segment> segments_;
   vm_size_t size_;
   InitializationStateDcheck initialized_;
 };
@@ -0,0 +1,71 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "snapshot/ios/module_snapshot_cache_ios_intermediate_dump.h"
+
+#include <utility>
+
+namespace crashpad {
+namespace internal {
+
+ModuleSnapshotCacheIOSIntermediateDump::ModuleSnapshotCacheIOSIntermediateDump()
+    : current_modules_(), previous_modules_() {}
+
+ModuleSnapshotCacheIOSIntermediateDump::
+    ~ModuleSnapshotCacheIOSIntermediateDump() = default;
+
+std::shared_ptr<const ModuleSnapshotIOSIntermediateDump>
+ModuleSnapshotCacheIOSIntermediateDump::GetModule(
+    const IOSIntermediateDumpMap* image_data) {
+  // A map whose end wasn’t reached may not have all of its data, so it isn’t
+  // shared.
+  if (!image_data->serialized_data() || image_data->serialized_size() == 0) {
+    auto module = std::make_shared<ModuleSnapshotIOSIntermediateDump>();
+    if (!module->Initialize(image_data)) {
+      return nullptr;
+    }
+    return module;
+  }
+
+  std::string key(reinterpret_cast<const char*>(image_data->serialized_data()),
+                  image_data->serialized_size());
+  const auto current_it = current_modules_.find(key);
+  if (current_it != current_modules_.end()) {
+    return current_it->second;
+  }
+
+  std::shared_ptr<const ModuleSnapshotIOSIntermediateDump> shared_module;
+  const auto previous_it = previous_modules_.find(key);
+  if (previous_it != previous_modules_.end()) {
+    shared_module = std::move(previous_it->second);
+    previous_modules_.erase(previous_it);
+  } else {
+    auto module = std::make_shared<ModuleSnapshotIOSIntermediateDump>();
+    if (!module->Initialize(image_data)) {
+      return nullptr;
+    }
+    shared_module = std::move(module);
+  }
+
+  current_modules_.emplace(std::move(key), shared_module);
+  return shared_module;
+}
+
+void ModuleSnapshotCacheIOSIntermediateDump::FinishDump() {
+  previous_modules_ = std::move(current_modules_);
+  current_modules_.clear();
+}
+
+}  // namespace internal
+}  // namespace crashpad
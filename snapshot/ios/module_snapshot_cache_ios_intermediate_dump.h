@@ -0,0 +1,75 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_SNAPSHOT_IOS_MODULE_SNAPSHOT_CACHE_IOS_INTERMEDIATE_DUMP_H_
+#define CRASHPAD_SNAPSHOT_IOS_MODULE_SNAPSHOT_CACHE_IOS_INTERMEDIATE_DUMP_H_
+
+#include <map>
+#include <memory>
+#include <string>
+
+#include "snapshot/ios/module_snapshot_ios_intermediate_dump.h"
+#include "util/ios/ios_intermediate_dump_map.h"
+
+namespace crashpad {
+namespace internal {
+
+//! \brief Shares module snapshots among intermediate dumps read one after
+//!     another.
+//!
+//! An application that defers processing of its dumps builds up many
+//! intermediate dumps, and those from one session mostly have the same module
+//! list. Given to ProcessSnapshotIOSIntermediateDump for each of them, this
+//! keeps the module snapshots of the dump read before, so that a module whose
+//! intermediate dump data is identical is shared instead of being read again.
+//! A module whose annotations have changed since is read again.
+//!
+//! This class is not thread-safe.
+class ModuleSnapshotCacheIOSIntermediateDump {
+ public:
+  ModuleSnapshotCacheIOSIntermediateDump();
+
+  ModuleSnapshotCacheIOSIntermediateDump(
+      const ModuleSnapshotCacheIOSIntermediateDump&) = delete;
+  ModuleSnapshotCacheIOSIntermediateDump& operator=(
+      const ModuleSnapshotCacheIOSIntermediateDump&) = delete;
+
+  ~ModuleSnapshotCacheIOSIntermediateDump();
+
+  //! \brief Returns a snapshot of the module in \a image_data, sharing one
+  //!     from this or the previous dump if its data is identical.
+  //!
+  //! \return The module snapshot, or `nullptr` if it couldn’t be initialized.
+  std::shared_ptr<const ModuleSnapshotIOSIntermediateDump> GetModule(
+      const IOSIntermediateDumpMap* image_data);
+
+  //! \brief Marks the end of a dump, so that only its modules are kept for
+  //!     the next one.
+  void FinishDump();
+
+ private:
+  using ModuleMap = std::map<
+      std::string,
+      std::shared_ptr<const ModuleSnapshotIOSIntermediateDump>>;
+
+  // The modules of the current and previous dumps, keyed by their serialized
+  // intermediate dump data.
+  ModuleMap current_modules_;
+  ModuleMap previous_modules_;
+};
+
+}  // namespace internal
+}  // namespace crashpad
+
+#endif  // CRASHPAD_SNAPSHOT_IOS_MODULE_SNAPSHOT_CACHE_IOS_INTERMEDIATE_DUMP_H_
@@ -38,17 +38,19 @@ using Key = internal::IntermediateDumpKey;
 
 bool ProcessSnapshotIOSIntermediateDump::InitializeWithFilePath(
     const base::FilePath& dump_path,
-    const std::map<std::string, std::string>& annotations) {
+    const std::map<std::string, std::string>& annotations,
+    ModuleSnapshotCacheIOSIntermediateDump* module_cache) {
   IOSIntermediateDumpFilePath dump_interface;
   if (!dump_interface.Initialize(dump_path))
     return false;
 
-  return InitializeWithFileInterface(dump_interface, annotations);
+  return InitializeWithFileInterface(dump_interface, annotations, module_cache);
 }
 
 bool ProcessSnapshotIOSIntermediateDump::InitializeWithFileInterface(
     const IOSIntermediateDumpInterface& dump_interface,
-    const std::map<std::string, std::string>& annotations) {
+    const std::map<std::string, std::string>& annotations,
+    ModuleSnapshotCacheIOSIntermediateDump* module_cache) {
   INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
 
   annotations_simple_map_ = annotations;
@@ -139,13 +141,24 @@ bool ProcessSnapshotIOSIntermediateDump::InitializeWithFileInterface(
       GetListFromMap(root_map, Key::kModules);
   if (module_list) {
     for (const auto& value : *module_list) {
-      auto module =
-          std::make_unique<internal::ModuleSnapshotIOSIntermediateDump>();
-      if (module->Initialize(value.get())) {
+      std::shared_ptr<const ModuleSnapshotIOSIntermediateDump> module;
+      if (module_cache) {
+        module = module_cache->GetModule(value.get());
+      } else {
+        auto new_module =
+            std::make_shared<internal::ModuleSnapshotIOSIntermediateDump>();
+        if (new_module->Initialize(value.get())) {
+          module = std::move(new_module);
+        }
+      }
+      if (module) {
         modules_.push_back(std::move(module));
       }
     }
   }
+  if (module_cache) {
+    module_cache->FinishDump();
+  }
 
   // Exceptions
   const IOSIntermediateDumpMap* signal_exception =
@@ -17,10 +17,12 @@
 
 #include <sys/sysctl.h>
 
+#include <memory>
 #include <vector>
 
 #include "base/files/file_path.h"
 #include "snapshot/ios/exception_snapshot_ios_intermediate_dump.h"
+#include "snapshot/ios/module_snapshot_cache_ios_intermediate_dump.h"
 #include "snapshot/ios/module_snapshot_ios_intermediate_dump.h"
 #include "snapshot/ios/process_snapshot_ios_intermediate_dump.h"
 #include "snapshot/ios/system_snapshot_ios_intermediate_dump.h"
@@ -48,24 +50,30 @@ class ProcessSnapshotIOSIntermediateDump final : public ProcessSnapshot {
   //!
   //! \param[in] dump_path The intermediate dump to read.
   //! \param[in] annotations Process annotations to set in each crash report.
+  //! \param[in] module_cache If not `nullptr`, shares module snapshots with
+  //!     the other intermediate dumps read with it.
   //!
   //! \return `true` if the snapshot could be created, `false` otherwise with
   //!     an appropriate message logged.
   bool InitializeWithFilePath(
       const base::FilePath& dump_path,
-      const std::map<std::string, std::string>& annotations);
+      const std::map<std::string, std::string>& annotations,
+      ModuleSnapshotCacheIOSIntermediateDump* module_cache = nullptr);
 
   //! \brief Initializes the object.
   //!
   //! \param[in] dump_interface An interface corresponding to an intermediate
   //!     dump file.
   //! \param[in] annotations Process annotations to set in each crash report.
+  //! \param[in] module_cache If not `nullptr`, shares module snapshots with
+  //!     the other intermediate dumps read with it.
   //!
   //! \return `true` if the snapshot could be created, `false` otherwise with
   //!     an appropriate message logged.
   bool InitializeWithFileInterface(
       const IOSIntermediateDumpInterface& dump_interface,
-      const std::map<std::string, std::string>& annotations);
+      const std::map<std::string, std::string>& annotations,
+      ModuleSnapshotCacheIOSIntermediateDump* module_cache = nullptr);
 
   //! On iOS, the client ID is under the control of the snapshot producer,
   //! which may call this method to set the client ID. If this is not done,
@@ -114,7 +122,8 @@ class ProcessSnapshotIOSIntermediateDump final : public ProcessSnapshot {
   internal::SystemSnapshotIOSIntermediateDump system_;
   std::vector<std::unique_ptr<internal::ThreadSnapshotIOSIntermediateDump>>
       threads_;
-  std::vector<std::unique_ptr<internal::ModuleSnapshotIOSIntermediateDump>>
+  // Shared with other snapshots by a ModuleSnapshotCacheIOSIntermediateDump.
+  std::vector<std::shared_ptr<const ModuleSnapshotIOSIntermediateDump>>
       modules_;
   std::unique_ptr<internal::ExceptionSnapshotIOSIntermediateDump> exception_;
   UUID report_id_;
@@ -16,6 +16,8 @@
 
 #include <mach-o/loader.h>
 
+#include <vector>
+
 #include "base/cxx17_backports.h"
 #include "base/files/scoped_file.h"
 #include "base/posix/eintr_wrapper.h"
@@ -23,6 +25,7 @@
 #include "client/annotation.h"
 #include "gtest/gtest.h"
 #include "minidump/minidump_file_writer.h"
+#include "snapshot/ios/module_snapshot_cache_ios_intermediate_dump.h"
 #include "test/errors.h"
 #include "test/scoped_temp_dir.h"
 #include "test/test_paths.h"
@@ -37,6 +40,7 @@ namespace {
 
 using Key = internal::IntermediateDumpKey;
 using internal::IOSIntermediateDumpWriter;
+using internal::ModuleSnapshotCacheIOSIntermediateDump;
 using internal::ProcessSnapshotIOSIntermediateDump;
 
 class ReadToString : public crashpad::MemorySnapshot::Delegate {
@@ -737,6 +741,55 @@ TEST_F(ProcessSnapshotIOSIntermediateDumpTest, FullReport) {
                  /*expect_long_annotations=*/false);
 }
 
+TEST_F(ProcessSnapshotIOSIntermediateDumpTest, SharedModules) {
+  auto write_dump = [this](bool has_module_path, bool use_long_annotations) {
+    {
+      IOSIntermediateDumpWriter::ScopedRootMap rootMap(writer());
+      uint8_t version = 1;
+      EXPECT_TRUE(writer()->AddProperty(Key::kVersion, &version));
+      WriteSystemInfo(writer());
+      WriteProcessInfo(writer());
+      WriteThreads(writer());
+      WriteModules(writer(), has_module_path, use_long_annotations);
+      WriteMachException(writer());
+    }
+    CloseWriter();
+  };
+
+  ModuleSnapshotCacheIOSIntermediateDump module_cache;
+  write_dump(/*has_module_path=*/true, /*use_long_annotations=*/false);
+  ProcessSnapshotIOSIntermediateDump process_snapshot;
+  ASSERT_TRUE(process_snapshot.InitializeWithFilePath(
+      path(), annotations(), &module_cache));
+  std::vector<const ModuleSnapshot*> modules = process_snapshot.Modules();
+  ASSERT_EQ(modules.size(), 2u);
+
+  // A dump with the same modules shares them.
+  ASSERT_TRUE(writer()->Open(path()));
+  write_dump(/*has_module_path=*/true, /*use_long_annotations=*/false);
+  ProcessSnapshotIOSIntermediateDump process_snapshot_2;
+  ASSERT_TRUE(process_snapshot_2.InitializeWithFilePath(
+      path(), annotations(), &module_cache));
+  EXPECT_EQ(process_snapshot_2.Modules(), modules);
+  EXPECT_TRUE(DumpSnapshot(process_snapshot_2));
+  ExpectSnapshot(process_snapshot_2,
+                 /*expect_module_path=*/true,
+                 /*expect_long_annotations=*/false);
+
+  // Modules whose data has changed are read again.
+  ASSERT_TRUE(writer()->Open(path()));
+  write_dump(/*has_module_path=*/false, /*use_long_annotations=*/true);
+  ProcessSnapshotIOSIntermediateDump process_snapshot_3;
+  ASSERT_TRUE(process_snapshot_3.InitializeWithFilePath(
+      path(), annotations(), &module_cache));
+  std::vector<const ModuleSnapshot*> modules_3 = process_snapshot_3.Modules();
+  ASSERT_EQ(modules_3.size(), 2u);
+  EXPECT_NE(modules_3[0], modules[0]);
+  ExpectSnapshot(process_snapshot_3,
+                 /*expect_module_path=*/false,
+                 /*expect_long_annotations=*/true);
+}
+
 TEST_F(ProcessSnapshotIOSIntermediateDumpTest, FuzzTestCases) {
   base::FilePath fuzz_path = TestPaths::TestDataRoot().Append(FILE_PATH_LITERAL(
       "snapshot/ios/testdata/crash-1fa088dda0adb41459d063078a0f384a0bb8eefa"));
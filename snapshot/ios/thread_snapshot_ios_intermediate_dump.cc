@@ -130,18 +130,22 @@ bool ThreadSnapshotIOSIntermediateDump::Initialize(
     GetDataValueFromMap(
         thread_data, Key::kStackRegionAddress, &stack_region_address);
 
-    const std::vector<uint8_t>& bytes = thread_stack_data_dump->bytes();
     const vm_address_t stack_region_data =
-        reinterpret_cast<const vm_address_t>(bytes.data());
-    vm_size_t stack_region_size = bytes.size();
+        reinterpret_cast<const vm_address_t>(thread_stack_data_dump->data());
+    vm_size_t stack_region_size = thread_stack_data_dump->size();
     stack_.Initialize(
         stack_region_address, stack_region_data, stack_region_size);
   } else if (nsexception_frames) {
-    const std::vector<uint8_t>& bytes = nsexception_frames->bytes();
-    const uint64_t* frames = reinterpret_cast<const uint64_t*>(bytes.data());
-    size_t frame_count = bytes.size() / sizeof(uint64_t);
+    // The data isn't necessarily aligned, so copy it out.
+    std::vector<uint64_t> frames(nsexception_frames->size() /
+                                 sizeof(uint64_t));
+    if (!frames.empty()) {
+      memcpy(frames.data(),
+             nsexception_frames->data(),
+             frames.size() * sizeof(uint64_t));
+    }
     exception_stack_memory_ =
-        GenerateStackMemoryFromFrames(frames, frame_count);
+        GenerateStackMemoryFromFrames(frames.data(), frames.size());
     vm_address_t stack_memory_addr =
         !exception_stack_memory_.empty()
             ? reinterpret_cast<vm_address_t>(&exception_stack_memory_[0])
@@ -186,13 +190,12 @@ bool ThreadSnapshotIOSIntermediateDump::Initialize(
         continue;
       if (GetDataValueFromMap(
               region.get(), Key::kThreadContextMemoryRegionAddress, &address)) {
-        const std::vector<uint8_t>& bytes = region_data->bytes();
-        vm_size_t data_size = bytes.size();
+        vm_size_t data_size = region_data->size();
         if (data_size == 0)
           continue;
 
         const vm_address_t data =
-            reinterpret_cast<const vm_address_t>(bytes.data());
+            reinterpret_cast<const vm_address_t>(region_data->data());
 
         auto memory =
             std::make_unique<internal::MemorySnapshotIOSIntermediateDump>();
@@ -249,5 +252,13 @@ ThreadSnapshotIOSIntermediateDump::ExtraMemory() const {
   return extra_memory;
 }
 
+uint64_t ThreadSnapshotIOSIntermediateDump::UncapturedStackSize() const {
+  return 0;
+}
+
+std::vector<uint64_t> ThreadSnapshotIOSIntermediateDump::UnwoundFrames() const {
+  return std::vector<uint64_t>();
+}
+
 }  // namespace internal
 }  // namespace crashpad
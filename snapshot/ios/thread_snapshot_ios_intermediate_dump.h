@@ -56,6 +56,8 @@ class ThreadSnapshotIOSIntermediateDump final : public ThreadSnapshot {
   int Priority() const override;
   uint64_t ThreadSpecificDataAddress() const override;
   std::vector<const MemorySnapshot*> ExtraMemory() const override;
+  uint64_t UncapturedStackSize() const override;
+  std::vector<uint64_t> UnwoundFrames() const override;
 
  private:
 #if defined(ARCH_CPU_X86_64)
@@ -0,0 +1,110 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "snapshot/linux/allocation_bounds_reader.h"
+
+#include <vector>
+
+namespace crashpad {
+namespace internal {
+
+namespace {
+
+// The flags kept in the low bits of a chunk’s size field.
+constexpr uint64_t kPrevInUse = 0x1;
+constexpr uint64_t kIsMmapped = 0x2;
+constexpr uint64_t kNonMainArena = 0x4;
+constexpr uint64_t kSizeFlags = kPrevInUse | kIsMmapped | kNonMainArena;
+
+// Chunks larger than this are treated as not being chunks. glibc serves
+// allocations this large with mmap() by default, and those aren’t recognized.
+constexpr uint64_t kMaxChunkSize = 32 * 1024 * 1024;
+
+// Reads a T at address. The address may not be near a chunk at all, so failing
+// to read it isn’t an error. A batch is used because, unlike
+// ProcessMemory::Read(), it doesn’t log failures.
+template <typename T>
+bool ReadValue(const ProcessMemory* memory, uint64_t address, uint64_t* value) {
+  T local_value;
+  std::vector<ProcessMemory::BatchRead> reads(1);
+  reads[0].address = address;
+  reads[0].size = sizeof(local_value);
+  reads[0].buffer = &local_value;
+  reads[0].succeeded = false;
+  if (!memory->ReadBatch(&reads)) {
+    return false;
+  }
+  *value = local_value;
+  return true;
+}
+
+}  // namespace
+
+GlibcMallocBoundsReader::GlibcMallocBoundsReader(const ProcessMemory* memory,
+                                                 bool is_64_bit)
+    : memory_(memory), is_64_bit_(is_64_bit) {}
+
+GlibcMallocBoundsReader::~GlibcMallocBoundsReader() = default;
+
+bool GlibcMallocBoundsReader::GetAllocationBounds(
+    uint64_t address,
+    CheckedRange<uint64_t>* bounds) {
+  // A chunk starts with the size of the previous chunk, used only while that
+  // chunk is free, and then its own size and flags. The allocation follows,
+  // and extends into the previous-size field of the next chunk, which isn’t
+  // used while this chunk is in use. Chunk sizes are multiples of twice the
+  // size field’s size, and allocations are at least that aligned.
+  const uint64_t size_size = is_64_bit_ ? 8 : 4;
+  const uint64_t chunk_alignment = size_size * 2;
+  const uint64_t min_chunk_size = size_size * 4;
+  if (address % chunk_alignment != 0 || address < chunk_alignment) {
+    return false;
+  }
+  const uint64_t chunk = address - chunk_alignment;
+
+  uint64_t size_field;
+  if (!ReadSizeField(chunk + size_size, &size_field) ||
+      (size_field & kIsMmapped)) {
+    return false;
+  }
+  const uint64_t chunk_size = size_field & ~kSizeFlags;
+  if (chunk_size < min_chunk_size || chunk_size > kMaxChunkSize ||
+      chunk_size % chunk_alignment != 0) {
+    return false;
+  }
+
+  // The next chunk records whether this one is in use. The last chunk of an
+  // arena is never free, so a following chunk is always present.
+  const uint64_t next_chunk = chunk + chunk_size;
+  uint64_t next_size_field;
+  if (next_chunk < chunk ||
+      !ReadSizeField(next_chunk + size_size, &next_size_field) ||
+      !(next_size_field & kPrevInUse) ||
+      (next_size_field & ~kSizeFlags) < min_chunk_size ||
+      (next_size_field & ~kSizeFlags) % chunk_alignment != 0) {
+    return false;
+  }
+
+  *bounds = CheckedRange<uint64_t>(address, chunk_size - size_size);
+  return true;
+}
+
+bool GlibcMallocBoundsReader::ReadSizeField(uint64_t address,
+                                            uint64_t* size) const {
+  return is_64_bit_ ? ReadValue<uint64_t>(memory_, address, size)
+                    : ReadValue<uint32_t>(memory_, address, size);
+}
+
+}  // namespace internal
+}  // namespace crashpad
@@ -0,0 +1,84 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_SNAPSHOT_LINUX_ALLOCATION_BOUNDS_READER_H_
+#define CRASHPAD_SNAPSHOT_LINUX_ALLOCATION_BOUNDS_READER_H_
+
+#include <stdint.h>
+
+#include "util/numeric/checked_range.h"
+#include "util/process/process_memory.h"
+
+namespace crashpad {
+namespace internal {
+
+//! \brief Finds the bounds of heap allocations in a target process by reading
+//!     its allocator’s metadata.
+//!
+//! These are used by CaptureMemoryDelegateLinux to capture whole allocations
+//! referenced by a thread, rather than a fixed amount of memory around each
+//! reference. Each implementation understands one allocator. An implementation
+//! must validate what it reads, since the allocator may not be in use, and must
+//! return `false` whenever it isn’t sure.
+class AllocationBoundsReader {
+ public:
+  virtual ~AllocationBoundsReader() = default;
+
+  //! \brief Finds the allocation containing \a address.
+  //!
+  //! \param[in] address A pointer-like value.
+  //! \param[out] bounds The usable memory of the allocation containing
+  //!     \a address.
+  //! \return `true` if \a bounds was set, or `false` if \a address isn’t known
+  //!     to be in an allocation. No message is logged.
+  virtual bool GetAllocationBounds(uint64_t address,
+                                   CheckedRange<uint64_t>* bounds) = 0;
+
+ protected:
+  AllocationBoundsReader() = default;
+};
+
+//! \brief An AllocationBoundsReader for glibc’s `malloc()`.
+//!
+//! Only pointers to the start of an allocation are recognized, as returned by
+//! `malloc()`. The size of the allocation is read from the chunk header before
+//! it, and confirmed by the header of the chunk that follows, which must
+//! record the allocation as in use. Chunks allocated with `mmap()` aren’t
+//! recognized.
+class GlibcMallocBoundsReader final : public AllocationBoundsReader {
+ public:
+  //! \param[in] memory The memory of the target process.
+  //! \param[in] is_64_bit `true` if the target process is 64-bit.
+  GlibcMallocBoundsReader(const ProcessMemory* memory, bool is_64_bit);
+
+  GlibcMallocBoundsReader(const GlibcMallocBoundsReader&) = delete;
+  GlibcMallocBoundsReader& operator=(const GlibcMallocBoundsReader&) = delete;
+
+  ~GlibcMallocBoundsReader() override;
+
+  // AllocationBoundsReader:
+  bool GetAllocationBounds(uint64_t address,
+                           CheckedRange<uint64_t>* bounds) override;
+
+ private:
+  bool ReadSizeField(uint64_t address, uint64_t* size) const;
+
+  const ProcessMemory* memory_;  // weak
+  bool is_64_bit_;
+};
+
+}  // namespace internal
+}  // namespace crashpad
+
+#endif  // CRASHPAD_SNAPSHOT_LINUX_ALLOCATION_BOUNDS_READER_H_
@@ -0,0 +1,64 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "snapshot/linux/allocation_bounds_reader.h"
+
+#include <malloc.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "gtest/gtest.h"
+#include "test/linux/fake_ptrace_connection.h"
+#include "util/misc/address_sanitizer.h"
+#include "util/misc/from_pointer_cast.h"
+#include "util/misc/memory_sanitizer.h"
+#include "util/process/process_memory_linux.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+// Sanitizers replace glibc’s malloc().
+#if defined(__GLIBC__) && !defined(ADDRESS_SANITIZER) && \
+    !defined(MEMORY_SANITIZER)
+
+TEST(GlibcMallocBoundsReader, Self) {
+  FakePtraceConnection connection;
+  ASSERT_TRUE(connection.Initialize(getpid()));
+  ProcessMemoryLinux memory(&connection);
+  internal::GlibcMallocBoundsReader reader(&memory, connection.Is64Bit());
+
+  for (size_t size : {1, 24, 100, 1000, 10000}) {
+    SCOPED_TRACE(size);
+    void* allocation = malloc(size);
+    ASSERT_TRUE(allocation);
+    const uint64_t address = FromPointerCast<uint64_t>(allocation);
+
+    CheckedRange<uint64_t> bounds(0, 0);
+    EXPECT_TRUE(reader.GetAllocationBounds(address, &bounds));
+    EXPECT_EQ(bounds.base(), address);
+    EXPECT_EQ(bounds.size(), malloc_usable_size(allocation));
+
+    // Only the start of an allocation is recognized.
+    EXPECT_FALSE(reader.GetAllocationBounds(address + 1, &bounds));
+
+    free(allocation);
+  }
+}
+
+#endif  // __GLIBC__ && !ADDRESS_SANITIZER && !MEMORY_SANITIZER
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
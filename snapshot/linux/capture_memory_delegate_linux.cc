@@ -14,10 +14,7 @@
 
 #include "snapshot/linux/capture_memory_delegate_linux.h"
 
-#include <utility>
-
 #include "base/numerics/safe_conversions.h"
-#include "snapshot/memory_snapshot_generic.h"
 
 namespace crashpad {
 namespace internal {
@@ -25,13 +22,16 @@ namespace internal {
 CaptureMemoryDelegateLinux::CaptureMemoryDelegateLinux(
     ProcessReaderLinux* process_reader,
     const ProcessReaderLinux::Thread* thread_opt,
+    pid_t thread_id,
     std::vector<std::unique_ptr<MemorySnapshotGeneric>>* snapshots,
-    uint32_t* budget_remaining)
+    CaptureMemoryPlanLinux* plan)
     : stack_(thread_opt ? thread_opt->stack_region_address : 0,
              thread_opt ? thread_opt->stack_region_size : 0),
       process_reader_(process_reader),
       snapshots_(snapshots),
-      budget_remaining_(budget_remaining) {}
+      plan_(plan),
+      reference_address_(0),
+      thread_id_(thread_id) {}
 
 bool CaptureMemoryDelegateLinux::Is64Bit() const {
   return process_reader_->Is64Bit();
@@ -57,18 +57,36 @@ void CaptureMemoryDelegateLinux::AddNewMemorySnapshot(
     return;
   if (range.size() == 0)
     return;
-  if (!budget_remaining_ || *budget_remaining_ == 0)
+
+  if (reference_address_ == 0) {
+    plan_->AddCandidate(range,
+                        thread_id_,
+                        CaptureMemoryPlanLinux::Reference::kRegister,
+                        0,
+                        snapshots_);
     return;
-  snapshots_->push_back(std::make_unique<internal::MemorySnapshotGeneric>());
-  internal::MemorySnapshotGeneric* snapshot = snapshots_->back().get();
-  snapshot->Initialize(process_reader_->Memory(), range.base(), range.size());
-  if (!base::IsValueInRangeForNumericType<int64_t>(range.size())) {
-    *budget_remaining_ = 0;
-  } else {
-    int64_t temp = *budget_remaining_;
-    temp -= range.size();
-    *budget_remaining_ = base::saturated_cast<uint32_t>(temp);
   }
+
+  // The stack grows down from its end, so the distance from the start of the
+  // captured stack is the distance from the top.
+  plan_->AddCandidate(range,
+                      thread_id_,
+                      CaptureMemoryPlanLinux::Reference::kStack,
+                      reference_address_ >= stack_.base()
+                          ? reference_address_ - stack_.base()
+                          : 0,
+                      snapshots_);
+}
+
+void CaptureMemoryDelegateLinux::SetReferenceAddress(uint64_t address) {
+  reference_address_ = address;
+}
+
+bool CaptureMemoryDelegateLinux::GetAllocationBounds(
+    uint64_t address,
+    CheckedRange<uint64_t>* bounds) const {
+  AllocationBoundsReader* reader = plan_->allocation_bounds_reader();
+  return reader && reader->GetAllocationBounds(address, bounds);
 }
 
 }  // namespace internal
@@ -18,36 +18,40 @@
 #include "snapshot/capture_memory.h"
 
 #include <stdint.h>
+#include <sys/types.h>
 
 #include <memory>
 #include <vector>
 
+#include "snapshot/linux/capture_memory_plan_linux.h"
 #include "snapshot/linux/process_reader_linux.h"
+#include "snapshot/memory_snapshot_generic.h"
 #include "util/numeric/checked_range.h"
 
 namespace crashpad {
 namespace internal {
 
-class MemorySnapshotGeneric;
-
 class CaptureMemoryDelegateLinux : public CaptureMemory::Delegate {
  public:
   //! \brief A MemoryCaptureDelegate for Linux.
   //!
+  //! Memory isn’t captured right away. Instead, each range is added to \a plan
+  //! as a candidate, to be captured to \a snapshots if it is chosen.
+  //!
   //! \param[in] process_reader A ProcessReaderLinux for the target process.
   //! \param[in] thread_opt The thread being inspected. Memory ranges
   //!     overlapping this thread's stack will be ignored on the assumption
   //!     that they're already captured elsewhere. May be nullptr.
+  //! \param[in] thread_id The ID of the thread being inspected.
   //! \param[in] snapshots A vector of MemorySnapshotGeneric to which the
   //!     captured memory will be added.
-  //! \param[in] budget_remaining If non-null, a pointer to the remaining number
-  //!     of bytes to capture. If this is `0`, no further memory will be
-  //!     captured.
+  //! \param[in] plan The plan that chooses which ranges to capture.
   CaptureMemoryDelegateLinux(
       ProcessReaderLinux* process_reader,
       const ProcessReaderLinux::Thread* thread_opt,
+      pid_t thread_id,
       std::vector<std::unique_ptr<MemorySnapshotGeneric>>* snapshots,
-      uint32_t* budget_remaining);
+      CaptureMemoryPlanLinux* plan);
 
   // MemoryCaptureDelegate:
   bool Is64Bit() const override;
@@ -56,12 +60,20 @@ class CaptureMemoryDelegateLinux : public CaptureMemory::Delegate {
       const CheckedRange<uint64_t, uint64_t>& range) const override;
   void AddNewMemorySnapshot(
       const CheckedRange<uint64_t, uint64_t>& range) override;
+  void SetReferenceAddress(uint64_t address) override;
+  bool GetAllocationBounds(uint64_t address,
+                           CheckedRange<uint64_t>* bounds) const override;
 
  private:
   CheckedRange<uint64_t, uint64_t> stack_;
   ProcessReaderLinux* process_reader_;  // weak
   std::vector<std::unique_ptr<MemorySnapshotGeneric>>* snapshots_;  // weak
-  uint32_t* budget_remaining_;
+  CaptureMemoryPlanLinux* plan_;  // weak
+
+  // The address the value being captured around was read from, or 0 for a
+  // value in a register.
+  uint64_t reference_address_;
+  pid_t thread_id_;
 };
 
 }  // namespace internal
@@ -0,0 +1,149 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "snapshot/linux/capture_memory_plan_linux.h"
+
+#include <algorithm>
+#include <numeric>
+#include <set>
+#include <tuple>
+#include <utility>
+
+#include "base/check_op.h"
+
+namespace crashpad {
+namespace internal {
+
+CaptureMemoryPlanLinux::CaptureMemoryPlanLinux(
+    ProcessReaderLinux* process_reader)
+    : candidates_(),
+      snapshots_base_sizes_(),
+      process_reader_(process_reader),
+      allocation_bounds_reader_(nullptr),
+      crashing_thread_id_(-1) {}
+
+CaptureMemoryPlanLinux::~CaptureMemoryPlanLinux() = default;
+
+void CaptureMemoryPlanLinux::AddCandidate(
+    const CheckedRange<uint64_t, uint64_t>& range,
+    pid_t thread_id,
+    Reference reference,
+    uint64_t stack_offset,
+    std::vector<std::unique_ptr<MemorySnapshotGeneric>>* snapshots) {
+  snapshots_base_sizes_.emplace(snapshots, snapshots->size());
+  Candidate candidate = {range,
+                         thread_id,
+                         reference,
+                         reference == Reference::kStack ? stack_offset : 0,
+                         snapshots};
+  candidates_.push_back(candidate);
+}
+
+void CaptureMemoryPlanLinux::RemoveThread(pid_t thread_id) {
+  auto removed = std::stable_partition(
+      candidates_.begin(),
+      candidates_.end(),
+      [thread_id](const Candidate& candidate) {
+        return candidate.thread_id != thread_id;
+      });
+
+  std::set<std::vector<std::unique_ptr<MemorySnapshotGeneric>>*> forgotten;
+  for (auto candidate = removed; candidate != candidates_.end(); ++candidate) {
+    forgotten.insert(candidate->snapshots);
+  }
+  candidates_.erase(removed, candidates_.end());
+
+  for (const Candidate& candidate : candidates_) {
+    forgotten.erase(candidate.snapshots);
+  }
+  for (auto* snapshots : forgotten) {
+    auto base_size = snapshots_base_sizes_.find(snapshots);
+    DiscardCaptured(base_size->first, base_size->second);
+    snapshots_base_sizes_.erase(base_size);
+  }
+}
+
+std::vector<CheckedRange<uint64_t, uint64_t>> CaptureMemoryPlanLinux::Select(
+    uint32_t budget) const {
+  std::vector<CheckedRange<uint64_t, uint64_t>> ranges;
+  for (size_t index : SelectIndices(budget)) {
+    ranges.push_back(candidates_[index].range);
+  }
+  return ranges;
+}
+
+void CaptureMemoryPlanLinux::Capture(uint32_t budget) {
+  DCHECK(process_reader_);
+
+  for (const auto& [snapshots, base_size] : snapshots_base_sizes_) {
+    DiscardCaptured(snapshots, base_size);
+  }
+
+  for (size_t index : SelectIndices(budget)) {
+    const Candidate& candidate = candidates_[index];
+    candidate.snapshots->push_back(std::make_unique<MemorySnapshotGeneric>());
+    candidate.snapshots->back()->InitializeWithBatch(
+        process_reader_->MemoryBatch(),
+        candidate.range.base(),
+        candidate.range.size());
+  }
+}
+
+std::vector<size_t> CaptureMemoryPlanLinux::SelectIndices(
+    uint32_t budget) const {
+  auto rank = [this](const Candidate& candidate) {
+    return std::make_tuple(candidate.thread_id != crashing_thread_id_,
+                           candidate.reference,
+                           candidate.stack_offset);
+  };
+
+  std::vector<size_t> order(candidates_.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+    return rank(candidates_[a]) < rank(candidates_[b]);
+  });
+
+  // Smaller candidates ranked below one that doesn’t fit may still fit, so
+  // every candidate is considered until the budget is spent.
+  std::vector<size_t> selected;
+  std::set<std::pair<uint64_t, uint64_t>> selected_ranges;
+  uint64_t remaining = budget;
+  for (size_t index : order) {
+    if (remaining == 0) {
+      break;
+    }
+    const CheckedRange<uint64_t, uint64_t>& range = candidates_[index].range;
+    if (range.size() > remaining ||
+        !selected_ranges.emplace(range.base(), range.size()).second) {
+      continue;
+    }
+    remaining -= range.size();
+    selected.push_back(index);
+  }
+  return selected;
+}
+
+// static
+void CaptureMemoryPlanLinux::DiscardCaptured(
+    std::vector<std::unique_ptr<MemorySnapshotGeneric>>* snapshots,
+    size_t base_size) {
+  DCHECK_GE(snapshots->size(), base_size);
+  for (size_t index = base_size; index < snapshots->size(); ++index) {
+    (*snapshots)[index]->DiscardBatchRegion();
+  }
+  snapshots->resize(base_size);
+}
+
+}  // namespace internal
+}  // namespace crashpad
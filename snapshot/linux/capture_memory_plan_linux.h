@@ -0,0 +1,162 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_SNAPSHOT_LINUX_CAPTURE_MEMORY_PLAN_LINUX_H_
+#define CRASHPAD_SNAPSHOT_LINUX_CAPTURE_MEMORY_PLAN_LINUX_H_
+
+#include <stdint.h>
+#include <sys/types.h>
+
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "snapshot/linux/allocation_bounds_reader.h"
+#include "snapshot/linux/process_reader_linux.h"
+#include "snapshot/memory_snapshot_generic.h"
+#include "util/numeric/checked_range.h"
+
+namespace crashpad {
+namespace internal {
+
+//! \brief Chooses which of the memory regions referenced by the threads of a
+//!     process to capture, within a byte budget shared by all of them.
+//!
+//! Each thread’s snapshot adds the regions around the pointer-like values in
+//! its context and on its stack as candidates, without capturing anything.
+//! Capture() then ranks the candidates of every thread together and captures
+//! the best of them that fit the budget. Regions referenced by the crashing
+//! thread come first, then those referenced from registers before those
+//! referenced from stacks, and then those referenced from nearest the top of
+//! a stack. Earlier candidates come first among those that rank equally.
+//!
+//! This way, the budget isn’t spent on whichever threads happen to be
+//! snapshotted first, and the crashing thread’s context is captured even when
+//! its snapshot is made last.
+class CaptureMemoryPlanLinux {
+ public:
+  //! \brief Where the value that referenced a candidate region was found.
+  enum class Reference {
+    //! \brief The value was in a register of the thread’s context.
+    kRegister,
+
+    //! \brief The value was on the thread’s stack.
+    kStack,
+  };
+
+  //! \param[in] process_reader A ProcessReaderLinux for the target process,
+  //!     whose MemorySnapshotBatch captured regions are read with. May be
+  //!     `nullptr` if Capture() won’t be called.
+  explicit CaptureMemoryPlanLinux(ProcessReaderLinux* process_reader);
+
+  CaptureMemoryPlanLinux(const CaptureMemoryPlanLinux&) = delete;
+  CaptureMemoryPlanLinux& operator=(const CaptureMemoryPlanLinux&) = delete;
+
+  ~CaptureMemoryPlanLinux();
+
+  //! \brief Sets the thread whose candidates are captured before all others,
+  //!     or `-1` for none, which is the default.
+  void SetCrashingThreadID(pid_t thread_id) { crashing_thread_id_ = thread_id; }
+
+  //! \brief Sets the reader used to find the heap allocations that candidate
+  //!     regions are sized to, or `nullptr` for none, which is the default.
+  //!
+  //! See CaptureMemory::Delegate::GetAllocationBounds().
+  void SetAllocationBoundsReader(AllocationBoundsReader* reader) {
+    allocation_bounds_reader_ = reader;
+  }
+
+  //! \brief Returns the reader set by SetAllocationBoundsReader().
+  AllocationBoundsReader* allocation_bounds_reader() const {
+    return allocation_bounds_reader_;
+  }
+
+  //! \brief Adds a candidate region.
+  //!
+  //! \param[in] range The region to capture.
+  //! \param[in] thread_id The thread that referenced the region.
+  //! \param[in] reference Where the thread referenced the region.
+  //! \param[in] stack_offset For Reference::kStack, the distance in bytes
+  //!     from the start of the thread’s stack to where the region was
+  //!     referenced. Ignored otherwise.
+  //! \param[in] snapshots The vector that a snapshot of the region is added
+  //!     to if it is captured. Snapshots added by Capture() are removed from
+  //!     it when Capture() is called again, so it must not otherwise change
+  //!     size after candidates are added for it. See RemoveThread().
+  void AddCandidate(
+      const CheckedRange<uint64_t, uint64_t>& range,
+      pid_t thread_id,
+      Reference reference,
+      uint64_t stack_offset,
+      std::vector<std::unique_ptr<MemorySnapshotGeneric>>* snapshots);
+
+  //! \brief Removes the candidates added for a thread, along with the
+  //!     snapshots that Capture() added for them, and forgets about the vectors
+  //!     they would be captured to.
+  //!
+  //! This must be called before a vector passed to AddCandidate() for the
+  //! thread is destroyed, unless Capture() won’t be called again.
+  void RemoveThread(pid_t thread_id);
+
+  //! \brief Chooses the candidates to capture.
+  //!
+  //! \param[in] budget The maximum number of bytes to capture across all
+  //!     candidates.
+  //!
+  //! \return The ranges of the chosen candidates, in order of rank. A range
+  //!     added for more than one candidate is only chosen once.
+  std::vector<CheckedRange<uint64_t, uint64_t>> Select(uint32_t budget) const;
+
+  //! \brief Captures the candidates chosen by Select(), replacing the
+  //!     snapshots captured by any earlier call.
+  //!
+  //! \param[in] budget The maximum number of bytes to capture across all
+  //!     candidates.
+  void Capture(uint32_t budget);
+
+ private:
+  struct Candidate {
+    CheckedRange<uint64_t, uint64_t> range;
+    pid_t thread_id;
+    Reference reference;
+    uint64_t stack_offset;
+    std::vector<std::unique_ptr<MemorySnapshotGeneric>>* snapshots;  // weak
+  };
+
+  // Removes the snapshots after the first base_size of snapshots, dropping
+  // their regions from their batch.
+  static void DiscardCaptured(
+      std::vector<std::unique_ptr<MemorySnapshotGeneric>>* snapshots,
+      size_t base_size);
+
+  // Returns the indices of the candidates that Select() would choose.
+  std::vector<size_t> SelectIndices(uint32_t budget) const;
+
+  // Candidates in the order they were added.
+  std::vector<Candidate> candidates_;
+
+  // The vectors that candidates are captured to, each with its size before
+  // anything was captured to it.
+  std::map<std::vector<std::unique_ptr<MemorySnapshotGeneric>>*, size_t>
+      snapshots_base_sizes_;
+
+  ProcessReaderLinux* process_reader_;  // weak
+  AllocationBoundsReader* allocation_bounds_reader_;  // weak
+  pid_t crashing_thread_id_;
+};
+
+}  // namespace internal
+}  // namespace crashpad
+
+#endif  // CRASHPAD_SNAPSHOT_LINUX_CAPTURE_MEMORY_PLAN_LINUX_H_
@@ -0,0 +1,123 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "snapshot/linux/capture_memory_plan_linux.h"
+
+#include "gtest/gtest.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+using internal::CaptureMemoryPlanLinux;
+using internal::MemorySnapshotGeneric;
+using Reference = CaptureMemoryPlanLinux::Reference;
+using Range = CheckedRange<uint64_t, uint64_t>;
+
+std::vector<std::pair<uint64_t, uint64_t>> RangePairs(
+    const std::vector<Range>& ranges) {
+  std::vector<std::pair<uint64_t, uint64_t>> pairs;
+  for (const Range& range : ranges) {
+    pairs.emplace_back(range.base(), range.size());
+  }
+  return pairs;
+}
+
+TEST(CaptureMemoryPlanLinux, Ranking) {
+  std::vector<std::unique_ptr<MemorySnapshotGeneric>> snapshots;
+  CaptureMemoryPlanLinux plan(nullptr);
+  plan.AddCandidate(Range(0x1000, 0x10), 1, Reference::kStack, 8, &snapshots);
+  plan.AddCandidate(
+      Range(0x2000, 0x10), 1, Reference::kRegister, 0, &snapshots);
+  plan.AddCandidate(Range(0x3000, 0x10), 2, Reference::kStack, 16, &snapshots);
+  plan.AddCandidate(Range(0x4000, 0x10), 2, Reference::kStack, 0, &snapshots);
+  plan.AddCandidate(
+      Range(0x5000, 0x10), 2, Reference::kRegister, 0, &snapshots);
+  plan.AddCandidate(
+      Range(0x6000, 0x10), 1, Reference::kRegister, 0, &snapshots);
+
+  // Without a crashing thread, all threads rank equally.
+  const std::vector<std::pair<uint64_t, uint64_t>> expect_no_crash = {
+      {0x2000, 0x10},
+      {0x5000, 0x10},
+      {0x6000, 0x10},
+      {0x4000, 0x10},
+      {0x1000, 0x10},
+      {0x3000, 0x10},
+  };
+  EXPECT_EQ(RangePairs(plan.Select(0x1000)), expect_no_crash);
+
+  plan.SetCrashingThreadID(2);
+  const std::vector<std::pair<uint64_t, uint64_t>> expect_crash = {
+      {0x5000, 0x10},
+      {0x4000, 0x10},
+      {0x3000, 0x10},
+      {0x2000, 0x10},
+      {0x6000, 0x10},
+      {0x1000, 0x10},
+  };
+  EXPECT_EQ(RangePairs(plan.Select(0x1000)), expect_crash);
+}
+
+TEST(CaptureMemoryPlanLinux, Budget) {
+  std::vector<std::unique_ptr<MemorySnapshotGeneric>> snapshots;
+  CaptureMemoryPlanLinux plan(nullptr);
+  plan.AddCandidate(
+      Range(0x1000, 0x100), 1, Reference::kRegister, 0, &snapshots);
+  plan.AddCandidate(
+      Range(0x2000, 0x200), 1, Reference::kRegister, 0, &snapshots);
+  plan.AddCandidate(Range(0x1000, 0x100), 2, Reference::kStack, 0, &snapshots);
+  plan.AddCandidate(Range(0x3000, 0x80), 2, Reference::kStack, 8, &snapshots);
+
+  EXPECT_TRUE(plan.Select(0).empty());
+
+  // The second candidate doesn’t fit after the first, but the last does. The
+  // third duplicates the first and isn’t counted again.
+  const std::vector<std::pair<uint64_t, uint64_t>> expect = {
+      {0x1000, 0x100},
+      {0x3000, 0x80},
+  };
+  EXPECT_EQ(RangePairs(plan.Select(0x200)), expect);
+
+  const std::vector<std::pair<uint64_t, uint64_t>> expect_all = {
+      {0x1000, 0x100},
+      {0x2000, 0x200},
+      {0x3000, 0x80},
+  };
+  EXPECT_EQ(RangePairs(plan.Select(0x380)), expect_all);
+}
+
+TEST(CaptureMemoryPlanLinux, RemoveThread) {
+  std::vector<std::unique_ptr<MemorySnapshotGeneric>> snapshots_1;
+  std::vector<std::unique_ptr<MemorySnapshotGeneric>> snapshots_2;
+  CaptureMemoryPlanLinux plan(nullptr);
+  plan.AddCandidate(
+      Range(0x1000, 0x10), 1, Reference::kRegister, 0, &snapshots_1);
+  plan.AddCandidate(
+      Range(0x2000, 0x10), 2, Reference::kRegister, 0, &snapshots_2);
+  plan.AddCandidate(Range(0x3000, 0x10), 1, Reference::kStack, 0, &snapshots_1);
+
+  plan.RemoveThread(1);
+  const std::vector<std::pair<uint64_t, uint64_t>> expect = {
+      {0x2000, 0x10},
+  };
+  EXPECT_EQ(RangePairs(plan.Select(0x1000)), expect);
+
+  plan.RemoveThread(2);
+  EXPECT_TRUE(plan.Select(0x1000).empty());
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
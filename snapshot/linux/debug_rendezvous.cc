@@ -14,10 +14,14 @@
 
 #include "snapshot/linux/debug_rendezvous.h"
 
+#include <link.h>
 #include <stdint.h>
+#include <string.h>
 
+#include <algorithm>
 #include <set>
 
+#include "base/check_op.h"
 #include "base/logging.h"
 #include "build/build_config.h"
 
@@ -57,35 +61,95 @@ struct LinkEntrySpecific {
   typename Traits::Address l_prev;
 };
 
+constexpr VMSize kMaxNameSize = 4096;
+
+// The number of bytes of each name read in the first pass over the names. This
+// is enough for most names.
+constexpr size_t kNamePrefixSize = 256;
+
+// Reads the link entry at *address, leaving its name to be read by
+// ReadLinkEntryNames().
 template <typename Traits>
 bool ReadLinkEntry(const ProcessMemoryRange& memory,
                    LinuxVMAddress* address,
-                   DebugRendezvous::LinkEntry* entry_out) {
+                   DebugRendezvous::LinkEntry* entry_out,
+                   LinuxVMAddress* name_address) {
   LinkEntrySpecific<Traits> entry;
   if (!memory.Read(*address, sizeof(entry), &entry)) {
     return false;
   }
 
-  std::string name;
-  if (!memory.ReadCStringSizeLimited(entry.l_name, 4096, &name)) {
-    name.clear();
-  }
-
   entry_out->load_bias = entry.l_addr;
   entry_out->dynamic_array = entry.l_ld;
-  entry_out->name.swap(name);
+  *name_address = entry.l_name;
 
   *address = entry.l_next;
   return true;
 }
 
+// Reads the names of entries. Following each link entry requires the one before
+// it, but the names don’t depend on each other, so a prefix of every name is
+// read in a single batch. Only names that don’t fit in their prefix are read
+// again individually. Names that can’t be read are left empty.
+void ReadLinkEntryNames(const ProcessMemoryRange& memory,
+                        const std::vector<DebugRendezvous::LinkEntry*>& entries,
+                        const std::vector<LinuxVMAddress>& name_addresses) {
+  DCHECK_EQ(entries.size(), name_addresses.size());
+
+  std::vector<char> buffer(entries.size() * kNamePrefixSize);
+  std::vector<ProcessMemory::BatchRead> reads;
+  std::vector<size_t> read_indices;
+  for (size_t index = 0; index < entries.size(); ++index) {
+    const LinuxVMAddress address = name_addresses[index];
+    if (!address) {
+      continue;
+    }
+
+    // Don’t let the prefix cross into the next page, which might not be
+    // mapped. Names ending near the end of a page are then read again.
+    constexpr LinuxVMAddress kPageMask = 4096 - 1;
+    const size_t size = static_cast<size_t>(std::min(
+        static_cast<LinuxVMAddress>(kNamePrefixSize),
+        (address | kPageMask) - address + 1));
+
+    ProcessMemory::BatchRead read;
+    read.address = address;
+    read.size = size;
+    read.buffer = &buffer[index * kNamePrefixSize];
+    read.succeeded = false;
+    reads.push_back(read);
+    read_indices.push_back(index);
+  }
+  if (!reads.empty()) {
+    memory.ReadBatch(&reads);
+  }
+
+  for (size_t read_index = 0; read_index < reads.size(); ++read_index) {
+    const ProcessMemory::BatchRead& read = reads[read_index];
+    DebugRendezvous::LinkEntry* entry = entries[read_indices[read_index]];
+    if (read.succeeded) {
+      const char* prefix = static_cast<const char*>(read.buffer);
+      const void* nul = memchr(prefix, '\0', read.size);
+      if (nul) {
+        entry->name.assign(prefix, static_cast<const char*>(nul) - prefix);
+        continue;
+      }
+    }
+
+    if (!memory.ReadCStringSizeLimited(
+            read.address, kMaxNameSize, &entry->name)) {
+      entry->name.clear();
+    }
+  }
+}
+
 }  // namespace
 
 DebugRendezvous::LinkEntry::LinkEntry()
     : name(), load_bias(0), dynamic_array(0) {}
 
 DebugRendezvous::DebugRendezvous()
-    : modules_(), executable_(), initialized_() {}
+    : modules_(), executable_(), consistent_(false), initialized_() {}
 
 DebugRendezvous::~DebugRendezvous() {}
 
@@ -111,6 +175,11 @@ const std::vector<DebugRendezvous::LinkEntry>& DebugRendezvous::Modules()
   return modules_;
 }
 
+bool DebugRendezvous::IsConsistent() const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  return consistent_;
+}
+
 template <typename Traits>
 bool DebugRendezvous::InitializeSpecific(const ProcessMemoryRange& memory,
                                          LinuxVMAddress address) {
@@ -122,9 +191,12 @@ bool DebugRendezvous::InitializeSpecific(const ProcessMemoryRange& memory,
     LOG(ERROR) << "unexpected version " << debug.r_version;
     return false;
   }
+  consistent_ = debug.r_state == r_debug::RT_CONSISTENT;
 
+  std::vector<LinuxVMAddress> name_addresses(1);
   LinuxVMAddress link_entry_address = debug.r_map;
-  if (!ReadLinkEntry<Traits>(memory, &link_entry_address, &executable_)) {
+  if (!ReadLinkEntry<Traits>(
+          memory, &link_entry_address, &executable_, &name_addresses[0])) {
     return false;
   }
 
@@ -136,11 +208,22 @@ bool DebugRendezvous::InitializeSpecific(const ProcessMemoryRange& memory,
     }
 
     LinkEntry entry;
-    if (!ReadLinkEntry<Traits>(memory, &link_entry_address, &entry)) {
+    LinuxVMAddress name_address;
+    if (!ReadLinkEntry<Traits>(
+            memory, &link_entry_address, &entry, &name_address)) {
       return false;
     }
     modules_.push_back(entry);
+    name_addresses.push_back(name_address);
+  }
+
+  std::vector<LinkEntry*> entries;
+  entries.reserve(modules_.size() + 1);
+  entries.push_back(&executable_);
+  for (LinkEntry& module : modules_) {
+    entries.push_back(&module);
   }
+  ReadLinkEntryNames(memory, entries, name_addresses);
 
 #if BUILDFLAG(IS_ANDROID)
   // Android P (API 28) mistakenly places the vdso in the first entry in the
@@ -74,6 +74,13 @@ class DebugRendezvous {
   //! for the VDSO and loader.
   const std::vector<LinkEntry>& Modules() const;
 
+  //! \brief Returns `true` if the `r_state` member of the `r_debug` struct is
+  //!     `RT_CONSISTENT`.
+  //!
+  //! This is `false` while the dynamic linker is adding or removing an object,
+  //! in which case the link map may be changing.
+  bool IsConsistent() const;
+
  private:
   template <typename Traits>
   bool InitializeSpecific(const ProcessMemoryRange& memory,
@@ -81,6 +88,7 @@ class DebugRendezvous {
 
   std::vector<LinkEntry> modules_;
   LinkEntry executable_;
+  bool consistent_;
   InitializationStateDcheck initialized_;
 };
 
@@ -103,6 +103,9 @@ void TestAgainstTarget(PtraceConnection* connection) {
   DebugRendezvous debug;
   ASSERT_TRUE(debug.Initialize(range, debug_address));
 
+  // Nothing is being loaded or unloaded while the test runs.
+  EXPECT_TRUE(debug.IsConsistent());
+
 #if BUILDFLAG(IS_ANDROID)
   const int android_runtime_api = android_get_device_api_level();
   ASSERT_GE(android_runtime_api, 1);
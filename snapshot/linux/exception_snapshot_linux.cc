@@ -332,7 +332,7 @@ bool ExceptionSnapshotLinux::Initialize(
     LinuxVMAddress siginfo_address,
     LinuxVMAddress context_address,
     pid_t thread_id,
-    uint32_t* gather_indirectly_referenced_memory_cap) {
+    CaptureMemoryPlanLinux* capture_memory_plan) {
   INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
 
   thread_id_ = thread_id;
@@ -361,12 +361,14 @@ bool ExceptionSnapshotLinux::Initialize(
     }
   }
 
-  CaptureMemoryDelegateLinux capture_memory_delegate(
-      process_reader,
-      thread,
-      &extra_memory_,
-      gather_indirectly_referenced_memory_cap);
-  CaptureMemory::PointedToByContext(context_, &capture_memory_delegate);
+  if (capture_memory_plan) {
+    CaptureMemoryDelegateLinux capture_memory_delegate(process_reader,
+                                                       thread,
+                                                       thread_id,
+                                                       &extra_memory_,
+                                                       capture_memory_plan);
+    CaptureMemory::PointedToByContext(context_, &capture_memory_delegate);
+  }
 
   INITIALIZATION_STATE_SET_VALID(initialized_);
   return true;
@@ -23,6 +23,7 @@
 #include "build/build_config.h"
 #include "snapshot/cpu_context.h"
 #include "snapshot/exception_snapshot.h"
+#include "snapshot/linux/capture_memory_plan_linux.h"
 #include "snapshot/linux/process_reader_linux.h"
 #include "snapshot/memory_snapshot.h"
 #include "snapshot/memory_snapshot_generic.h"
@@ -53,6 +54,9 @@ class ExceptionSnapshotLinux final : public ExceptionSnapshot {
   //! \param[in] context_address The address in the target process' address
   //!     space of the ucontext_t passed to the signal handler.
   //! \param[in] thread_id The thread ID of the thread that received the signal.
+  //! \param[in] capture_memory_plan The plan to add the memory pointed to by
+  //!     the exception context’s registers to, or `nullptr` if no such memory
+  //!     should be captured.
   //!
   //! \return `true` if the snapshot could be created, `false` otherwise with
   //!     an appropriate message logged.
@@ -60,7 +64,7 @@ class ExceptionSnapshotLinux final : public ExceptionSnapshot {
                   LinuxVMAddress siginfo_address,
                   LinuxVMAddress context_address,
                   pid_t thread_id,
-                  uint32_t* gather_indirectly_referenced_memory_cap);
+                  CaptureMemoryPlanLinux* capture_memory_plan);
 
   // ExceptionSnapshot:
 
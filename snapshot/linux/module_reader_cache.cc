@@ -0,0 +1,82 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "snapshot/linux/module_reader_cache.h"
+
+#include <utility>
+
+namespace crashpad {
+
+namespace {
+
+bool SameProcess(pid_t pid,
+                 const timeval& start_time,
+                 pid_t other_pid,
+                 const timeval& other_start_time) {
+  return pid == other_pid && start_time.tv_sec == other_start_time.tv_sec &&
+         start_time.tv_usec == other_start_time.tv_usec;
+}
+
+}  // namespace
+
+ModuleReaderCache::Module::Module()
+    : load_address(0), device(0), inode(0), soname(), elf_reader() {}
+
+ModuleReaderCache::Module::Module(Module&& other) = default;
+
+ModuleReaderCache::Module& ModuleReaderCache::Module::operator=(
+    Module&& other) = default;
+
+ModuleReaderCache::Module::~Module() = default;
+
+ModuleReaderCache::ModuleReaderCache(size_t max_processes)
+    : processes_(), lock_(), max_processes_(max_processes) {}
+
+ModuleReaderCache::~ModuleReaderCache() = default;
+
+ModuleReaderCache::Modules ModuleReaderCache::Take(pid_t pid,
+                                                   const timeval& start_time) {
+  base::AutoLock lock(lock_);
+  for (auto iterator = processes_.begin(); iterator != processes_.end();
+       ++iterator) {
+    if (SameProcess(pid, start_time, iterator->pid, iterator->start_time)) {
+      Modules modules = std::move(iterator->modules);
+      processes_.erase(iterator);
+      return modules;
+    }
+  }
+  return Modules();
+}
+
+void ModuleReaderCache::Store(pid_t pid,
+                              const timeval& start_time,
+                              Modules modules) {
+  if (max_processes_ == 0) {
+    return;
+  }
+
+  base::AutoLock lock(lock_);
+
+  // A process ID belongs to at most one process at a time, so anything kept
+  // for this process, or for an earlier process with the same ID, is replaced.
+  processes_.remove_if(
+      [pid](const Process& process) { return process.pid == pid; });
+
+  processes_.push_front(Process{pid, start_time, std::move(modules)});
+  if (processes_.size() > max_processes_) {
+    processes_.pop_back();
+  }
+}
+
+}  // namespace crashpad
@@ -0,0 +1,116 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_SNAPSHOT_LINUX_MODULE_READER_CACHE_H_
+#define CRASHPAD_SNAPSHOT_LINUX_MODULE_READER_CACHE_H_
+
+#include <sys/time.h>
+#include <sys/types.h>
+
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+
+#include "base/synchronization/lock.h"
+#include "snapshot/elf/elf_image_reader.h"
+#include "util/linux/address_types.h"
+
+namespace crashpad {
+
+//! \brief Keeps what ProcessReaderLinux has read of each module of a process
+//!     between snapshots of that process, so that later snapshots can skip
+//!     finding and parsing each module again.
+//!
+//! Processes are identified by their process ID and start time, so a reused
+//! process ID doesn’t pick up another process’ modules. Only a limited number
+//! of processes are kept, with the least recently stored ones dropped first.
+//!
+//! This class is thread-safe.
+class ModuleReaderCache {
+ public:
+  //! \brief A module found by an earlier snapshot.
+  struct Module {
+    Module();
+    Module(Module&& other);
+    Module& operator=(Module&& other);
+    ~Module();
+
+    //! \brief The address of the module’s ELF header.
+    LinuxVMAddress load_address;
+
+    //! \brief The device of the file mapped at \a load_address.
+    dev_t device;
+
+    //! \brief The inode of the file mapped at \a load_address.
+    ino_t inode;
+
+    //! \brief The module’s `DT_SONAME`, or an empty string if it has none.
+    std::string soname;
+
+    //! \brief A reader for the module, to initialize new readers from with
+    //!     ElfImageReader::Initialize(const ElfImageReader&, const
+    //!     ProcessMemoryRange&).
+    //!
+    //! The memory reader this was initialized with may no longer be valid, so
+    //! it must not be used for anything else.
+    std::unique_ptr<ElfImageReader> elf_reader;
+  };
+
+  //! \brief A process’ modules, keyed by the address that identifies each
+  //!     module: its program header table for the main executable, or its
+  //!     dynamic array for modules in the dynamic linker’s link map.
+  using Modules = std::map<LinuxVMAddress, Module>;
+
+  //! \param[in] max_processes The number of processes to keep modules for.
+  explicit ModuleReaderCache(size_t max_processes);
+
+  ModuleReaderCache(const ModuleReaderCache&) = delete;
+  ModuleReaderCache& operator=(const ModuleReaderCache&) = delete;
+
+  ~ModuleReaderCache();
+
+  //! \brief Removes the modules kept for a process and returns them.
+  //!
+  //! While a snapshot has taken a process’ modules, other snapshots of the same
+  //! process find none, and parse the modules themselves.
+  //!
+  //! \param[in] pid The process ID.
+  //! \param[in] start_time The process’ start time.
+  //! \return The modules, or an empty map if there are none.
+  Modules Take(pid_t pid, const timeval& start_time);
+
+  //! \brief Keeps a process’ modules, replacing any that were kept before.
+  //!
+  //! \param[in] pid The process ID.
+  //! \param[in] start_time The process’ start time.
+  //! \param[in] modules The modules.
+  void Store(pid_t pid, const timeval& start_time, Modules modules);
+
+ private:
+  struct Process {
+    pid_t pid;
+    timeval start_time;
+    Modules modules;
+  };
+
+  // Ordered from most to least recently stored.
+  std::list<Process> processes_;
+  base::Lock lock_;
+  const size_t max_processes_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_SNAPSHOT_LINUX_MODULE_READER_CACHE_H_
@@ -0,0 +1,95 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "snapshot/linux/module_reader_cache.h"
+
+#include <utility>
+
+#include "gtest/gtest.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+ModuleReaderCache::Modules TestModules(LinuxVMAddress load_address) {
+  ModuleReaderCache::Modules modules;
+  ModuleReaderCache::Module module;
+  module.load_address = load_address;
+  module.soname = "libtest.so";
+  modules[load_address + 0x100] = std::move(module);
+  return modules;
+}
+
+timeval StartTime(time_t seconds) {
+  timeval start_time;
+  start_time.tv_sec = seconds;
+  start_time.tv_usec = 0;
+  return start_time;
+}
+
+TEST(ModuleReaderCache, TakeAndStore) {
+  ModuleReaderCache cache(2);
+  EXPECT_TRUE(cache.Take(1, StartTime(1)).empty());
+
+  cache.Store(1, StartTime(1), TestModules(0x1000));
+
+  // A process with the same ID that started at a different time is another
+  // process.
+  EXPECT_TRUE(cache.Take(1, StartTime(2)).empty());
+
+  ModuleReaderCache::Modules modules = cache.Take(1, StartTime(1));
+  ASSERT_EQ(modules.size(), 1u);
+  EXPECT_EQ(modules.begin()->first, 0x1100u);
+  EXPECT_EQ(modules.begin()->second.load_address, 0x1000u);
+  EXPECT_EQ(modules.begin()->second.soname, "libtest.so");
+
+  // Taking the modules removes them.
+  EXPECT_TRUE(cache.Take(1, StartTime(1)).empty());
+}
+
+TEST(ModuleReaderCache, Replace) {
+  ModuleReaderCache cache(2);
+  cache.Store(1, StartTime(1), TestModules(0x1000));
+  cache.Store(1, StartTime(1), TestModules(0x2000));
+
+  ModuleReaderCache::Modules modules = cache.Take(1, StartTime(1));
+  ASSERT_EQ(modules.size(), 1u);
+  EXPECT_EQ(modules.begin()->second.load_address, 0x2000u);
+
+  // Storing for a process drops what was kept for an earlier process with the
+  // same ID.
+  cache.Store(1, StartTime(1), TestModules(0x1000));
+  cache.Store(1, StartTime(2), TestModules(0x2000));
+  EXPECT_TRUE(cache.Take(1, StartTime(1)).empty());
+  EXPECT_EQ(cache.Take(1, StartTime(2)).size(), 1u);
+}
+
+TEST(ModuleReaderCache, Eviction) {
+  ModuleReaderCache cache(2);
+  cache.Store(1, StartTime(1), TestModules(0x1000));
+  cache.Store(2, StartTime(1), TestModules(0x1000));
+  cache.Store(3, StartTime(1), TestModules(0x1000));
+
+  EXPECT_TRUE(cache.Take(1, StartTime(1)).empty());
+  EXPECT_EQ(cache.Take(2, StartTime(1)).size(), 1u);
+  EXPECT_EQ(cache.Take(3, StartTime(1)).size(), 1u);
+
+  ModuleReaderCache disabled_cache(0);
+  disabled_cache.Store(1, StartTime(1), TestModules(0x1000));
+  EXPECT_TRUE(disabled_cache.Take(1, StartTime(1)).empty());
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
@@ -19,16 +19,18 @@
 #include <sched.h>
 #include <string.h>
 #include <sys/resource.h>
+#include <sys/syscall.h>
 #include <unistd.h>
 
 #include <algorithm>
+#include <atomic>
 
 #include "base/logging.h"
-#include "base/strings/stringprintf.h"
 #include "build/build_config.h"
 #include "snapshot/linux/debug_rendezvous.h"
 #include "util/linux/auxiliary_vector.h"
 #include "util/linux/proc_stat_reader.h"
+#include "util/thread/thread.h"
 
 #if BUILDFLAG(IS_ANDROID)
 #include <android/api-level.h>
@@ -47,6 +49,54 @@ bool ShouldMergeStackMappings(const MemoryMap::Mapping& stack_mapping,
           stack_mapping.name.empty() || adj_mapping.name.empty());
 }
 
+#if defined(SYS_sched_getattr)
+// The first version of struct sched_attr, from the kernel’s
+// include/uapi/linux/sched/types.h. It isn’t in the C library’s headers.
+struct SchedAttr {
+  uint32_t size;
+  uint32_t sched_policy;
+  uint64_t sched_flags;
+  int32_t sched_nice;
+  uint32_t sched_priority;
+  uint64_t sched_runtime;
+  uint64_t sched_deadline;
+  uint64_t sched_period;
+};
+static_assert(sizeof(SchedAttr) == 48, "SchedAttr size");
+
+// From the kernel’s include/uapi/linux/sched.h.
+constexpr uint64_t kSchedFlagResetOnFork = 0x01;
+constexpr int kSchedResetOnFork = 0x40000000;
+#endif  // SYS_sched_getattr
+
+// Gets a thread’s scheduling policy, static priority, and nice value with
+// sched_getattr(), available since Linux 3.14, in one system call instead of
+// three. Returns false if it’s not available.
+bool GetSchedAttr(pid_t tid,
+                  int* sched_policy,
+                  int* static_priority,
+                  int* nice_value) {
+#if defined(SYS_sched_getattr)
+  SchedAttr attr = {};
+  if (syscall(SYS_sched_getattr, tid, &attr, sizeof(attr), 0) != 0) {
+    if (errno != ENOSYS) {
+      PLOG(WARNING) << "sched_getattr";
+    }
+    return false;
+  }
+  *sched_policy = attr.sched_policy;
+  if (attr.sched_flags & kSchedFlagResetOnFork) {
+    // sched_getscheduler() reports this flag as part of the policy.
+    *sched_policy |= kSchedResetOnFork;
+  }
+  *static_priority = attr.sched_priority;
+  *nice_value = attr.sched_nice;
+  return true;
+#else
+  return false;
+#endif  // SYS_sched_getattr
+}
+
 }  // namespace
 
 ProcessReaderLinux::Thread::Thread()
@@ -56,25 +106,29 @@ ProcessReaderLinux::Thread::Thread()
       name(),
       tid(-1),
       static_priority(-1),
-      nice_value(-1) {}
+      nice_value(-1),
+      have_priorities(false),
+      have_float_context(false) {}
 
 ProcessReaderLinux::Thread::~Thread() {}
 
-bool ProcessReaderLinux::Thread::InitializePtrace(
-    PtraceConnection* connection) {
-  if (!connection->GetThreadInfo(tid, &thread_info)) {
-    return false;
-  }
+bool ProcessReaderLinux::Thread::InitializePtrace(PtraceConnection* connection,
+                                                  bool float_context) {
+  have_float_context = float_context;
+  return float_context
+             ? connection->GetThreadInfo(tid, &thread_info)
+             : connection->GetThreadInfoWithoutFloatContext(tid, &thread_info);
+}
 
+void ProcessReaderLinux::Thread::InitializeNameAndPriorities(
+    PtraceConnection* connection) {
   // From man proc(5):
   //
   // /proc/[pid]/comm (since Linux 2.6.33)
   //
   // Different threads in the same process may have different comm values,
   // accessible via /proc/[pid]/task/[tid]/comm.
-  const std::string path = base::StringPrintf(
-      "/proc/%d/task/%d/comm", connection->GetProcessID(), tid);
-  if (connection->ReadFileContents(base::FilePath(path), &name)) {
+  if (connection->ReadThreadFileContents(tid, "comm", &name)) {
     if (!name.empty() && name.back() == '\n') {
       // Remove the final newline character.
       name.pop_back();
@@ -87,20 +141,22 @@ bool ProcessReaderLinux::Thread::InitializePtrace(
   // be collected directly.
   have_priorities = false;
 
-  // TODO(jperaza): Starting with Linux 3.14, scheduling policy, static
-  // priority, and nice value can be collected all in one call with
-  // sched_getattr().
+  if (GetSchedAttr(tid, &sched_policy, &static_priority, &nice_value)) {
+    have_priorities = true;
+    return;
+  }
+
   int res = sched_getscheduler(tid);
   if (res < 0) {
     PLOG(WARNING) << "sched_getscheduler";
-    return true;
+    return;
   }
   sched_policy = res;
 
   sched_param param;
   if (sched_getparam(tid, &param) != 0) {
     PLOG(WARNING) << "sched_getparam";
-    return true;
+    return;
   }
   static_priority = param.sched_priority;
 
@@ -108,12 +164,11 @@ bool ProcessReaderLinux::Thread::InitializePtrace(
   res = getpriority(PRIO_PROCESS, tid);
   if (res == -1 && errno) {
     PLOG(WARNING) << "getpriority";
-    return true;
+    return;
   }
   nice_value = res;
 
   have_priorities = true;
-  return true;
 }
 
 void ProcessReaderLinux::Thread::InitializeStack(ProcessReaderLinux* reader) {
@@ -145,7 +200,7 @@ void ProcessReaderLinux::Thread::InitializeStackFromSP(
     return;
   }
   LinuxVMAddress stack_region_start =
-      reader->Memory()->PointerToAddress(stack_pointer);
+      reader->PointerToAddress(stack_pointer);
 
   // We've hit what looks like a guard page; skip to the end and check for a
   // mapped stack region.
@@ -197,7 +252,7 @@ void ProcessReaderLinux::Thread::InitializeStackFromSP(
   // at the high-address end of the stack so we can try using that to shrink
   // the stack region.
   stack_region_size = stack_end - stack_region_address;
-  VMAddress tls_address = reader->Memory()->PointerToAddress(
+  VMAddress tls_address = reader->PointerToAddress(
       thread_info.thread_specific_data_address);
   if (tid != reader->ProcessID() && tls_address > stack_region_address &&
       tls_address < stack_end) {
@@ -205,6 +260,28 @@ void ProcessReaderLinux::Thread::InitializeStackFromSP(
   }
 }
 
+// Gathers the details of threads in ProcessReaderLinux::threads_ that don’t
+// require ptrace. Several of these may run at once, alongside the thread that
+// made the ptrace requests.
+class ProcessReaderLinux::ThreadInitializerThread : public crashpad::Thread {
+ public:
+  ThreadInitializerThread(ProcessReaderLinux* reader,
+                          std::atomic<size_t>* next_index)
+      : reader_(reader), next_index_(next_index) {}
+
+  ThreadInitializerThread(const ThreadInitializerThread&) = delete;
+  ThreadInitializerThread& operator=(const ThreadInitializerThread&) = delete;
+
+  ~ThreadInitializerThread() override {}
+
+ private:
+  // Thread:
+  void ThreadMain() override { reader_->InitializeThreadDetails(next_index_); }
+
+  ProcessReaderLinux* reader_;  // weak
+  std::atomic<size_t>* next_index_;
+};
+
 ProcessReaderLinux::Module::Module()
     : name(), elf_reader(nullptr), type(ModuleSnapshot::kModuleTypeUnknown) {}
 
@@ -212,11 +289,17 @@ ProcessReaderLinux::Module::~Module() = default;
 
 ProcessReaderLinux::ProcessReaderLinux()
     : connection_(),
+      module_cache_(),
       process_info_(),
       memory_map_(),
       threads_(),
       modules_(),
       elf_readers_(),
+      memory_(),
+      module_memory_(),
+      memory_batch_(),
+      thread_initialization_threads_(1),
+      gather_thread_float_contexts_(true),
       is_64_bit_(false),
       initialized_threads_(false),
       initialized_modules_(false),
@@ -224,10 +307,15 @@ ProcessReaderLinux::ProcessReaderLinux()
 
 ProcessReaderLinux::~ProcessReaderLinux() {}
 
-bool ProcessReaderLinux::Initialize(PtraceConnection* connection) {
+bool ProcessReaderLinux::Initialize(
+    PtraceConnection* connection,
+    unsigned int thread_initialization_threads,
+    ModuleReaderCache* module_cache) {
   INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
   DCHECK(connection);
   connection_ = connection;
+  module_cache_ = module_cache;
+  thread_initialization_threads_ = std::max(1u, thread_initialization_threads);
 
   if (!process_info_.InitializeWithPtrace(connection_)) {
     return false;
@@ -238,6 +326,9 @@ bool ProcessReaderLinux::Initialize(PtraceConnection* connection) {
   }
 
   is_64_bit_ = process_info_.Is64Bit();
+  memory_.Initialize(connection_->Memory());
+  module_memory_.Initialize(&memory_);
+  memory_batch_ = std::make_unique<internal::MemorySnapshotBatch>(Memory());
 
   INITIALIZATION_STATE_SET_VALID(initialized_);
   return true;
@@ -292,6 +383,17 @@ const std::vector<ProcessReaderLinux::Thread>& ProcessReaderLinux::Threads() {
   return threads_;
 }
 
+bool ProcessReaderLinux::ReadThreadFloatContext(Thread* thread) {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  ThreadInfo thread_info;
+  if (!connection_->GetThreadInfo(thread->tid, &thread_info)) {
+    return false;
+  }
+  thread->thread_info.float_context = thread_info.float_context;
+  thread->have_float_context = true;
+  return true;
+}
+
 const std::vector<ProcessReaderLinux::Module>& ProcessReaderLinux::Modules() {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
   if (!initialized_modules_) {
@@ -389,34 +491,71 @@ void ProcessReaderLinux::InitializeThreads() {
     return;
   }
 
+  // ptrace requests can only be made from the thread that attached to the
+  // target, so every thread is attached and has its registers fetched here
+  // before anything else is gathered. The rest doesn’t require ptrace and is
+  // gathered afterwards, possibly on several threads.
   Thread main_thread;
   main_thread.tid = pid;
-  if (main_thread.InitializePtrace(connection_)) {
-    main_thread.InitializeStack(this);
+  if (main_thread.InitializePtrace(connection_,
+                                   gather_thread_float_contexts_)) {
     threads_.push_back(main_thread);
   } else {
     LOG(WARNING) << "Couldn't initialize main thread.";
   }
 
-  bool main_thread_found = false;
   std::vector<pid_t> thread_ids;
   bool result = connection_->Threads(&thread_ids);
   DCHECK(result);
-  for (pid_t tid : thread_ids) {
-    if (tid == pid) {
-      DCHECK(!main_thread_found);
-      main_thread_found = true;
-      continue;
-    }
+  auto main_thread_id = std::find(thread_ids.begin(), thread_ids.end(), pid);
+  DCHECK(main_thread_id != thread_ids.end());
+  if (main_thread_id != thread_ids.end()) {
+    thread_ids.erase(main_thread_id);
+  }
 
+  // All of the other threads are stopped together, before any of their
+  // registers are fetched.
+  std::vector<bool> attached;
+  connection_->AttachThreads(thread_ids, &attached);
+  for (size_t index = 0; index < thread_ids.size(); ++index) {
     Thread thread;
-    thread.tid = tid;
-    if (connection_->Attach(tid) && thread.InitializePtrace(connection_)) {
-      thread.InitializeStack(this);
+    thread.tid = thread_ids[index];
+    if (attached[index] &&
+        thread.InitializePtrace(connection_, gather_thread_float_contexts_)) {
       threads_.push_back(thread);
     }
   }
-  DCHECK(main_thread_found);
+
+  // Each thread’s details are gathered by exactly one thread, which writes only
+  // to that thread’s element of threads_. The calling thread does its share of
+  // the work too.
+  std::atomic<size_t> next_index(0);
+  const size_t worker_count =
+      std::max(size_t{1},
+               std::min(size_t{thread_initialization_threads_},
+                        threads_.size())) -
+      1;
+  std::vector<std::unique_ptr<ThreadInitializerThread>> workers;
+  workers.reserve(worker_count);
+  for (size_t index = 0; index < worker_count; ++index) {
+    workers.push_back(
+        std::make_unique<ThreadInitializerThread>(this, &next_index));
+    workers.back()->Start();
+  }
+  InitializeThreadDetails(&next_index);
+  for (const auto& worker : workers) {
+    worker->Join();
+  }
+}
+
+void ProcessReaderLinux::InitializeThreadDetails(
+    std::atomic<size_t>* next_index) {
+  for (size_t index = (*next_index)++; index < threads_.size();
+       index = (*next_index)++) {
+    Thread& thread = threads_[index];
+    thread.InitializeNameAndPriorities(connection_);
+    thread.InitializeStack(this);
+  }
 }
 
 void ProcessReaderLinux::InitializeModules() {
@@ -434,18 +573,27 @@ void ProcessReaderLinux::InitializeModules() {
   }
 
   ProcessMemoryRange range;
-  if (!range.Initialize(Memory(), is_64_bit_)) {
+  if (!range.Initialize(&module_memory_, is_64_bit_)) {
     return;
   }
 
+  ModuleReaderCache::Modules cached_modules;
+  ModuleReaderCache::Modules found_modules;
+  timeval start_time;
+  const bool use_cache = module_cache_ && StartTime(&start_time);
+  if (use_cache) {
+    cached_modules = module_cache_->Take(ProcessID(), start_time);
+  }
+
   // The strategy used for identifying loaded modules depends on ELF files
   // conventionally loading their header and program headers into memory.
   // Locating the correct module could fail if the headers aren't mapped, are
   // mapped at an unexpected location, or if there are other mappings
   // constructed to look like the ELF module being searched for.
   const MemoryMap::Mapping* exe_mapping = nullptr;
-  std::unique_ptr<ElfImageReader> exe_reader;
-  {
+  std::unique_ptr<ElfImageReader> exe_reader = ReuseCachedModule(
+      phdrs, range, &cached_modules, &found_modules, &exe_mapping, nullptr);
+  if (!exe_reader) {
     const MemoryMap::Mapping* phdr_mapping = memory_map_.FindMapping(phdrs);
     if (!phdr_mapping) {
       return;
@@ -471,7 +619,14 @@ void ProcessReaderLinux::InitializeModules() {
                  << phdr_mapping->range.Base();
       return;
     }
+    CacheModule(phdrs,
+                *exe_reader,
+                *exe_mapping,
+                std::string(),
+                range,
+                &found_modules);
   }
+  AddModuleFileRanges(exe_reader.get());
 
   LinuxVMAddress debug_address;
   if (!exe_reader->GetDebugAddress(&debug_address)) {
@@ -483,6 +638,14 @@ void ProcessReaderLinux::InitializeModules() {
     return;
   }
 
+  // While the dynamic linker is adding or removing a module, what was cached
+  // about the others can’t be relied on, and what is found now shouldn’t be
+  // cached.
+  const bool consistent = debug.IsConsistent();
+  if (!consistent) {
+    cached_modules.clear();
+  }
+
   Module exe = {};
   exe.name = !debug.Executable()->name.empty() ? debug.Executable()->name
                                                : exe_mapping->name;
@@ -497,8 +660,15 @@ void ProcessReaderLinux::InitializeModules() {
 
   for (const DebugRendezvous::LinkEntry& entry : debug.Modules()) {
     const MemoryMap::Mapping* module_mapping = nullptr;
-    std::unique_ptr<ElfImageReader> elf_reader;
-    {
+    std::string soname;
+    std::unique_ptr<ElfImageReader> elf_reader =
+        ReuseCachedModule(entry.dynamic_array,
+                          range,
+                          &cached_modules,
+                          &found_modules,
+                          &module_mapping,
+                          &soname);
+    if (!elf_reader) {
       const MemoryMap::Mapping* dyn_mapping =
           memory_map_.FindMapping(entry.dynamic_array);
       if (!dyn_mapping) {
@@ -541,11 +711,21 @@ void ProcessReaderLinux::InitializeModules() {
                    << dyn_mapping->range.Base();
         continue;
       }
+
+      if (!elf_reader->SoName(&soname)) {
+        soname.clear();
+      }
+      CacheModule(entry.dynamic_array,
+                  *elf_reader,
+                  *module_mapping,
+                  soname,
+                  range,
+                  &found_modules);
     }
+    AddModuleFileRanges(elf_reader.get());
 
     Module module = {};
-    std::string soname;
-    if (elf_reader->SoName(&soname) && !soname.empty()) {
+    if (!soname.empty()) {
       module.name = soname;
     } else {
       module.name = !entry.name.empty() ? entry.name : module_mapping->name;
@@ -557,6 +737,100 @@ void ProcessReaderLinux::InitializeModules() {
     modules_.push_back(module);
     elf_readers_.push_back(std::move(elf_reader));
   }
+
+  // Modules that weren’t found this time were unloaded, and are dropped.
+  if (use_cache && consistent) {
+    module_cache_->Store(ProcessID(), start_time, std::move(found_modules));
+  }
+}
+
+std::unique_ptr<ElfImageReader> ProcessReaderLinux::ReuseCachedModule(
+    LinuxVMAddress key,
+    const ProcessMemoryRange& range,
+    ModuleReaderCache::Modules* cached_modules,
+    ModuleReaderCache::Modules* found_modules,
+    const MemoryMap::Mapping** mapping,
+    std::string* soname) {
+  auto iterator = cached_modules->find(key);
+  if (iterator == cached_modules->end()) {
+    return nullptr;
+  }
+  ModuleReaderCache::Module cached_module = std::move(iterator->second);
+  cached_modules->erase(iterator);
+
+  // The module is only reused if the same file is still mapped at the same
+  // address. A rebuilt or replaced file has a different inode.
+  const MemoryMap::Mapping* cached_mapping =
+      memory_map_.FindMapping(cached_module.load_address);
+  if (!cached_mapping ||
+      cached_mapping->range.Base() != cached_module.load_address ||
+      cached_mapping->device != cached_module.device ||
+      cached_mapping->inode != cached_module.inode) {
+    return nullptr;
+  }
+
+  auto elf_reader = std::make_unique<ElfImageReader>();
+  if (!elf_reader->Initialize(*cached_module.elf_reader, range)) {
+    return nullptr;
+  }
+
+  *mapping = cached_mapping;
+  if (soname) {
+    *soname = cached_module.soname;
+  }
+  (*found_modules)[key] = std::move(cached_module);
+  return elf_reader;
+}
+
+void ProcessReaderLinux::AddModuleFileRanges(ElfImageReader* elf_reader) {
+  std::vector<ElfImageReader::FileSegment> segments;
+  if (!elf_reader->GetReadOnlyFileSegments(&segments)) {
+    return;
+  }
+
+  // A segment is only read from the file if all of it is in a single private,
+  // read-only mapping of the file, at the offset its program header gives.
+  for (const ElfImageReader::FileSegment& segment : segments) {
+    const MemoryMap::Mapping* mapping =
+        memory_map_.FindMapping(segment.address);
+    if (!mapping || !mapping->readable || mapping->writable ||
+        mapping->shareable || mapping->name.empty() ||
+        mapping->name[0] != '/' ||
+        segment.size > mapping->range.End() - segment.address ||
+        static_cast<VMOffset>(mapping->offset + segment.address -
+                              mapping->range.Base()) != segment.file_offset) {
+      continue;
+    }
+    module_memory_.AddFileRange(segment.address,
+                                segment.size,
+                                base::FilePath(mapping->name),
+                                segment.file_offset,
+                                mapping->device,
+                                mapping->inode);
+  }
+}
+
+void ProcessReaderLinux::CacheModule(
+    LinuxVMAddress key,
+    const ElfImageReader& elf_reader,
+    const MemoryMap::Mapping& mapping,
+    const std::string& soname,
+    const ProcessMemoryRange& range,
+    ModuleReaderCache::Modules* found_modules) {
+  if (!module_cache_) {
+    return;
+  }
+
+  ModuleReaderCache::Module module;
+  module.elf_reader = std::make_unique<ElfImageReader>();
+  if (!module.elf_reader->Initialize(elf_reader, range)) {
+    return;
+  }
+  module.load_address = mapping.range.Base();
+  module.device = mapping.device;
+  module.inode = mapping.inode;
+  module.soname = soname;
+  (*found_modules)[key] = std::move(module);
 }
 
 }  // namespace crashpad
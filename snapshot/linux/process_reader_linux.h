@@ -18,11 +18,14 @@
 #include <sys/time.h>
 #include <sys/types.h>
 
+#include <atomic>
 #include <memory>
 #include <string>
 #include <vector>
 
 #include "snapshot/elf/elf_image_reader.h"
+#include "snapshot/linux/module_reader_cache.h"
+#include "snapshot/memory_snapshot_batch.h"
 #include "snapshot/module_snapshot.h"
 #include "util/linux/address_types.h"
 #include "util/linux/memory_map.h"
@@ -30,7 +33,10 @@
 #include "util/linux/thread_info.h"
 #include "util/misc/initialization_state_dcheck.h"
 #include "util/posix/process_info.h"
+#include "util/process/caching_process_memory.h"
+#include "util/process/file_backed_process_memory.h"
 #include "util/process/process_memory.h"
+#include "util/process/process_memory_range.h"
 
 namespace crashpad {
 
@@ -70,10 +76,15 @@ class ProcessReaderLinux {
     //!     all valid.
     bool have_priorities;
 
+    //! \brief `true` if `thread_info.float_context` was collected. If `false`,
+    //!     it is zeroed.
+    bool have_float_context;
+
    private:
     friend class ProcessReaderLinux;
 
-    bool InitializePtrace(PtraceConnection* connection);
+    bool InitializePtrace(PtraceConnection* connection, bool float_context);
+    void InitializeNameAndPriorities(PtraceConnection* connection);
     void InitializeStack(ProcessReaderLinux* reader);
   };
 
@@ -111,8 +122,40 @@ class ProcessReaderLinux {
   //! this class and may only be called once.
   //!
   //! \param[in] connection A PtraceConnection to the target process.
+  //! \param[in] thread_initialization_threads The number of threads, including
+  //!     the calling thread, used to gather the information about each of the
+  //!     target process’ threads that doesn’t require `ptrace`: its name,
+  //!     scheduling priorities, and stack region. `ptrace` requests are always
+  //!     made from the calling thread, which must be the thread that attached
+  //!     to the target process.
+  //! \param[in] module_cache A cache of what earlier snapshots of the target
+  //!     process read of its modules, used and updated by Modules(). Optional.
   //! \return `true` on success. `false` on failure with a message logged.
-  bool Initialize(PtraceConnection* connection);
+  bool Initialize(PtraceConnection* connection,
+                  unsigned int thread_initialization_threads = 1,
+                  ModuleReaderCache* module_cache = nullptr);
+
+  //! \brief Sets whether Threads() collects the floating-point context of
+  //!     each thread.
+  //!
+  //! By default, floating-point contexts are collected. This method must be
+  //! called before the first call to Threads() to have any effect.
+  //!
+  //! \sa CrashpadInfo::set_gather_thread_float_contexts()
+  void SetGatherThreadFloatContexts(bool gather_thread_float_contexts) {
+    gather_thread_float_contexts_ = gather_thread_float_contexts;
+  }
+
+  //! \brief Collects the floating-point context of a thread that Threads()
+  //!     returned without one.
+  //!
+  //! This must be called on the thread that called Initialize().
+  //!
+  //! \param[in,out] thread The thread, a copy of an element of Threads().
+  //! \return `true` on success, with `thread->thread_info.float_context` and
+  //!     `thread->have_float_context` set. `false` on failure with a message
+  //!     logged.
+  bool ReadThreadFloatContext(Thread* thread);
 
   //! \brief Return `true` if the target task is a 64-bit process.
   bool Is64Bit() const { return is_64_bit_; }
@@ -124,11 +167,24 @@ class ProcessReaderLinux {
   pid_t ParentProcessID() const { return process_info_.ParentProcessID(); }
 
   //! \brief Return a memory reader for the target process.
-  const ProcessMemoryLinux* Memory() const { return connection_->Memory(); }
+  //!
+  //! Reads through this object are cached for the lifetime of this object, so
+  //! the target process must remain suspended while it is in use.
+  const ProcessMemory* Memory() const { return &memory_; }
+
+  //! \brief Converts a pointer value in the target process to an address that
+  //!     may be read from, removing any tag bits.
+  VMAddress PointerToAddress(VMAddress pointer) const {
+    return connection_->Memory()->PointerToAddress(pointer);
+  }
 
   //! \brief Return a memory map of the target process.
   MemoryMap* GetMemoryMap() { return &memory_map_; }
 
+  //! \brief Return a batch for small memory regions captured from the target
+  //!     process, which are read together when a minidump is written.
+  internal::MemorySnapshotBatch* MemoryBatch() { return memory_batch_.get(); }
+
   //! \brief Determines the target process’ start time.
   //!
   //! \param[out] start_time The time that the process started.
@@ -162,19 +218,46 @@ class ProcessReaderLinux {
   const std::string& AbortMessage();
 
  private:
+  class ThreadInitializerThread;
+
   void InitializeThreads();
+  void InitializeThreadDetails(std::atomic<size_t>* next_index);
   void InitializeModules();
+  std::unique_ptr<ElfImageReader> ReuseCachedModule(
+      LinuxVMAddress key,
+      const ProcessMemoryRange& range,
+      ModuleReaderCache::Modules* cached_modules,
+      ModuleReaderCache::Modules* found_modules,
+      const MemoryMap::Mapping** mapping,
+      std::string* soname);
+  void CacheModule(LinuxVMAddress key,
+                   const ElfImageReader& elf_reader,
+                   const MemoryMap::Mapping& mapping,
+                   const std::string& soname,
+                   const ProcessMemoryRange& range,
+                   ModuleReaderCache::Modules* found_modules);
+  void AddModuleFileRanges(ElfImageReader* elf_reader);
   void InitializeAbortMessage();
   template <bool Is64Bit>
   void ReadAbortMessage(const MemoryMap::Mapping* mapping);
 
   PtraceConnection* connection_;  // weak
+  ModuleReaderCache* module_cache_;  // weak
   ProcessInfo process_info_;
   MemoryMap memory_map_;
   std::vector<Thread> threads_;
   std::vector<Module> modules_;
   std::string abort_message_;
   std::vector<std::unique_ptr<ElfImageReader>> elf_readers_;
+  CachingProcessMemory memory_;
+
+  // The memory that modules are read from, which reads their read-only
+  // segments from their files.
+  FileBackedProcessMemory module_memory_;
+
+  std::unique_ptr<internal::MemorySnapshotBatch> memory_batch_;
+  unsigned int thread_initialization_threads_;
+  bool gather_thread_float_contexts_;
   bool is_64_bit_;
   bool initialized_threads_;
   bool initialized_modules_;
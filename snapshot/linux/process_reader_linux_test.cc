@@ -328,8 +328,13 @@ void ExpectThreads(const ThreadMap& thread_map,
 
 class ChildThreadTest : public Multiprocess {
  public:
-  ChildThreadTest(size_t stack_size = 0)
-      : Multiprocess(), stack_size_(stack_size) {}
+  ChildThreadTest(size_t stack_size = 0,
+                  unsigned int thread_initialization_threads = 1,
+                  bool gather_thread_float_contexts = true)
+      : Multiprocess(),
+        stack_size_(stack_size),
+        thread_initialization_threads_(thread_initialization_threads),
+        gather_thread_float_contexts_(gather_thread_float_contexts) {}
 
   ChildThreadTest(const ChildThreadTest&) = delete;
   ChildThreadTest& operator=(const ChildThreadTest&) = delete;
@@ -363,10 +368,22 @@ class ChildThreadTest : public Multiprocess {
     ASSERT_TRUE(connection.Initialize(ChildPID()));
 
     ProcessReaderLinux process_reader;
-    ASSERT_TRUE(process_reader.Initialize(&connection));
+    ASSERT_TRUE(
+        process_reader.Initialize(&connection, thread_initialization_threads_));
+    process_reader.SetGatherThreadFloatContexts(gather_thread_float_contexts_);
     const std::vector<ProcessReaderLinux::Thread>& threads =
         process_reader.Threads();
     ExpectThreads(thread_map, thread_name_map, threads, &connection);
+
+    for (const auto& thread : threads) {
+      EXPECT_EQ(thread.have_float_context, gather_thread_float_contexts_);
+    }
+    if (!gather_thread_float_contexts_) {
+      ASSERT_FALSE(threads.empty());
+      ProcessReaderLinux::Thread thread = threads[0];
+      ASSERT_TRUE(process_reader.ReadThreadFloatContext(&thread));
+      EXPECT_TRUE(thread.have_float_context);
+    }
   }
 
   void MultiprocessChild() override {
@@ -431,6 +448,8 @@ class ChildThreadTest : public Multiprocess {
 
   static constexpr size_t kThreadCount = 3;
   const size_t stack_size_;
+  const unsigned int thread_initialization_threads_;
+  const bool gather_thread_float_contexts_;
 };
 
 TEST(ProcessReaderLinux, ChildWithThreads) {
@@ -443,6 +462,16 @@ TEST(ProcessReaderLinux, ChildThreadsWithSmallUserStacks) {
   test.Run();
 }
 
+TEST(ProcessReaderLinux, ChildWithThreadsInitializedConcurrently) {
+  ChildThreadTest test(0, 3);
+  test.Run();
+}
+
+TEST(ProcessReaderLinux, ChildWithThreadsWithoutFloatContexts) {
+  ChildThreadTest test(0, 1, false);
+  test.Run();
+}
+
 // Tests a thread with a stack that spans multiple mappings.
 class ChildWithSplitStackTest : public Multiprocess {
  public:
@@ -639,6 +668,57 @@ TEST(ProcessReaderLinux, SelfModules) {
 #endif  // !ADDRESS_SANITIZER && !MEMORY_SANITIZER
 }
 
+TEST(ProcessReaderLinux, SelfModulesCached) {
+  ModuleReaderCache module_cache(1);
+
+  FakePtraceConnection connection;
+  connection.Initialize(getpid());
+
+  ProcessReaderLinux process_reader;
+  ASSERT_TRUE(process_reader.Initialize(&connection, 1, &module_cache));
+  const std::vector<ProcessReaderLinux::Module>& modules =
+      process_reader.Modules();
+  ExpectModulesFromSelf(modules);
+
+  // A second snapshot of the same process finds the same modules from the
+  // cache.
+  FakePtraceConnection cached_connection;
+  cached_connection.Initialize(getpid());
+
+  ProcessReaderLinux cached_process_reader;
+  ASSERT_TRUE(cached_process_reader.Initialize(
+      &cached_connection, 1, &module_cache));
+  const std::vector<ProcessReaderLinux::Module>& cached_modules =
+      cached_process_reader.Modules();
+  ExpectModulesFromSelf(cached_modules);
+
+  ASSERT_EQ(cached_modules.size(), modules.size());
+  for (size_t index = 0; index < modules.size(); ++index) {
+    SCOPED_TRACE(modules[index].name);
+    EXPECT_EQ(cached_modules[index].name, modules[index].name);
+    EXPECT_EQ(cached_modules[index].type, modules[index].type);
+    ASSERT_TRUE(modules[index].elf_reader);
+    ASSERT_TRUE(cached_modules[index].elf_reader);
+    EXPECT_NE(cached_modules[index].elf_reader, modules[index].elf_reader);
+    EXPECT_EQ(cached_modules[index].elf_reader->Address(),
+              modules[index].elf_reader->Address());
+    EXPECT_EQ(cached_modules[index].elf_reader->Size(),
+              modules[index].elf_reader->Size());
+    EXPECT_EQ(cached_modules[index].elf_reader->GetLoadBias(),
+              modules[index].elf_reader->GetLoadBias());
+
+    std::string soname;
+    std::string cached_soname;
+    EXPECT_EQ(cached_modules[index].elf_reader->SoName(&cached_soname),
+              modules[index].elf_reader->SoName(&soname));
+    EXPECT_EQ(cached_soname, soname);
+  }
+
+  timeval start_time;
+  ASSERT_TRUE(cached_process_reader.StartTime(&start_time));
+  EXPECT_EQ(module_cache.Take(getpid(), start_time).size(), modules.size());
+}
+
 class ChildModuleTest : public Multiprocess {
  public:
   ChildModuleTest() : Multiprocess(), module_soname_("test_module_soname") {}
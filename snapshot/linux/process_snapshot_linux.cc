@@ -14,19 +14,109 @@
 
 #include "snapshot/linux/process_snapshot_linux.h"
 
+#include <algorithm>
+#include <atomic>
 #include <utility>
 
 #include "base/logging.h"
 #include "build/build_config.h"
 #include "util/linux/exception_information.h"
+#include "util/misc/trace_events.h"
+#include "util/thread/thread.h"
 
 namespace crashpad {
 
+namespace {
+
+// Maps a mapping’s permissions to a MINIDUMP_MEMORY_INFO protection. Linux
+// can’t make memory writable without also making it readable, so write-only
+// mappings are described as readable too.
+uint32_t MappingToProtectFlags(const MemoryMap::Mapping& mapping) {
+  static constexpr uint32_t kMapping[] = {
+      /* --- */ PAGE_NOACCESS,
+      /* --r */ PAGE_READONLY,
+      /* -w- */ PAGE_READWRITE,
+      /* -wr */ PAGE_READWRITE,
+      /* x-- */ PAGE_EXECUTE,
+      /* x-r */ PAGE_EXECUTE_READ,
+      /* xw- */ PAGE_EXECUTE_READWRITE,
+      /* xwr */ PAGE_EXECUTE_READWRITE,
+  };
+
+  const size_t index = (mapping.readable ? 1 : 0) |
+                       (mapping.writable ? 2 : 0) |
+                       (mapping.executable ? 4 : 0);
+  return kMapping[index];
+}
+
+// Initializes the modules in a shared list, claiming them one at a time until
+// none remain. Several of these may run at once, each on its own thread.
+class ModuleInitializer {
+ public:
+  ModuleInitializer(
+      const std::vector<std::unique_ptr<internal::ModuleSnapshotElf>>* modules,
+      std::vector<uint8_t>* initialized,
+      std::atomic<size_t>* next_index,
+      bool cache_annotations)
+      : modules_(modules),
+        initialized_(initialized),
+        next_index_(next_index),
+        cache_annotations_(cache_annotations) {}
+
+  ModuleInitializer(const ModuleInitializer&) = delete;
+  ModuleInitializer& operator=(const ModuleInitializer&) = delete;
+
+  void Run() {
+    for (size_t index = (*next_index_)++; index < modules_->size();
+         index = (*next_index_)++) {
+      internal::ModuleSnapshotElf* module = (*modules_)[index].get();
+      if (module->Initialize()) {
+        if (cache_annotations_) {
+          module->CacheAnnotations();
+        }
+        (*initialized_)[index] = true;
+      }
+    }
+  }
+
+ private:
+  const std::vector<std::unique_ptr<internal::ModuleSnapshotElf>>* modules_;
+  std::vector<uint8_t>* initialized_;
+  std::atomic<size_t>* next_index_;
+  bool cache_annotations_;
+};
+
+class ModuleInitializerThread : public Thread {
+ public:
+  explicit ModuleInitializerThread(ModuleInitializer* initializer)
+      : initializer_(initializer) {}
+
+  ModuleInitializerThread(const ModuleInitializerThread&) = delete;
+  ModuleInitializerThread& operator=(const ModuleInitializerThread&) = delete;
+
+  ~ModuleInitializerThread() override {}
+
+ private:
+  // Thread:
+  void ThreadMain() override { initializer_->Run(); }
+
+  ModuleInitializer* initializer_;
+};
+
+}  // namespace
+
 ProcessSnapshotLinux::ProcessSnapshotLinux() = default;
 
 ProcessSnapshotLinux::~ProcessSnapshotLinux() = default;
 
-bool ProcessSnapshotLinux::Initialize(PtraceConnection* connection) {
+bool ProcessSnapshotLinux::Initialize(PtraceConnection* connection,
+                                      unsigned int module_snapshot_threads,
+                                      unsigned int thread_snapshot_threads,
+                                      ModuleReaderCache* module_reader_cache,
+                                      ElfImageInfoCache* image_info_cache,
+                                      SystemInfoCache* system_info_cache,
+                                      bool unwind_stacks,
+                                      bool capture_whole_allocations) {
   INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
 
   if (gettimeofday(&snapshot_time_, nullptr) != 0) {
@@ -34,18 +124,43 @@ bool ProcessSnapshotLinux::Initialize(PtraceConnection* connection) {
     return false;
   }
 
-  if (!process_reader_.Initialize(connection) ||
+  if (!connection->Memory()->SupportsConcurrentReads()) {
+    module_snapshot_threads = 1;
+    thread_snapshot_threads = 1;
+  }
+
+  if (!process_reader_.Initialize(
+          connection, thread_snapshot_threads, module_reader_cache) ||
       !memory_range_.Initialize(process_reader_.Memory(),
                                 process_reader_.Is64Bit())) {
     return false;
   }
 
+  if (unwind_stacks) {
+    stack_unwinder_ =
+        std::make_unique<internal::StackUnwinderLinux>(&process_reader_);
+  }
+
+  if (capture_whole_allocations) {
+    allocation_bounds_reader_ =
+        std::make_unique<internal::GlibcMallocBoundsReader>(
+            process_reader_.Memory(), process_reader_.Is64Bit());
+  }
+
   client_id_.InitializeToZero();
-  system_.Initialize(&process_reader_, &snapshot_time_);
+  system_.Initialize(&process_reader_, &snapshot_time_, system_info_cache);
 
-  InitializeModules();
+  {
+    TraceEvents::ScopedEvent modules_event("CaptureModules");
+    InitializeModules(module_snapshot_threads, image_info_cache);
+  }
   GetCrashpadOptionsInternal((&options_));
-  InitializeThreads();
+  process_reader_.SetGatherThreadFloatContexts(
+      options_.gather_thread_float_contexts != TriState::kDisabled);
+  {
+    TraceEvents::ScopedEvent threads_event("CaptureThreads");
+    InitializeThreads();
+  }
   InitializeAnnotations();
 
   INITIALIZATION_STATE_SET_VALID(initialized_);
@@ -83,17 +198,22 @@ bool ProcessSnapshotLinux::InitializeException(
     info.thread_id = exception_thread_id;
   }
 
-  uint32_t* budget_remaining_pointer =
-      options_.gather_indirectly_referenced_memory == TriState::kEnabled
-          ? &options_.indirectly_referenced_memory_cap
-          : nullptr;
+  // The crashing thread’s indirectly referenced memory is found again from the
+  // exception context and its stack, and captured ahead of other threads’.
+  if (capture_memory_plan_) {
+    capture_memory_plan_->RemoveThread(info.thread_id);
+    capture_memory_plan_->SetCrashingThreadID(info.thread_id);
+  }
 
   exception_.reset(new internal::ExceptionSnapshotLinux());
   if (!exception_->Initialize(&process_reader_,
                               info.siginfo_address,
                               info.context_address,
                               info.thread_id,
-                              budget_remaining_pointer)) {
+                              capture_memory_plan_.get())) {
+    if (capture_memory_plan_) {
+      capture_memory_plan_->RemoveThread(info.thread_id);
+    }
     exception_.reset();
     return false;
   }
@@ -106,10 +226,21 @@ bool ProcessSnapshotLinux::InitializeException(
       ProcessReaderLinux::Thread thread = reader_thread;
       thread.InitializeStackFromSP(&process_reader_,
                                    exception_->Context()->StackPointer());
+      if (!thread.have_float_context) {
+        process_reader_.ReadThreadFloatContext(&thread);
+      }
 
       auto exc_thread_snapshot =
           std::make_unique<internal::ThreadSnapshotLinux>();
-      if (!exc_thread_snapshot->Initialize(&process_reader_, thread, nullptr)) {
+      if (!exc_thread_snapshot->Initialize(&process_reader_,
+                                           thread,
+                                           capture_memory_plan_.get(),
+                                           options_.stack_capture_limit,
+                                           options_.stack_frame_window_size,
+                                           stack_unwinder_.get())) {
+        if (capture_memory_plan_) {
+          capture_memory_plan_->RemoveThread(info.thread_id);
+        }
         return false;
       }
 
@@ -117,10 +248,17 @@ bool ProcessSnapshotLinux::InitializeException(
         if (thread_snapshot->ThreadID() ==
             static_cast<uint64_t>(info.thread_id)) {
           thread_snapshot.reset(exc_thread_snapshot.release());
+          if (capture_memory_plan_) {
+            capture_memory_plan_->Capture(
+                options_.indirectly_referenced_memory_cap);
+          }
           return true;
         }
       }
 
+      if (capture_memory_plan_) {
+        capture_memory_plan_->RemoveThread(info.thread_id);
+      }
       LOG(ERROR) << "thread not found " << info.thread_id;
       return false;
     }
@@ -160,12 +298,23 @@ void ProcessSnapshotLinux::GetCrashpadOptionsInternal(
       local_options.indirectly_referenced_memory_cap =
           module_options.indirectly_referenced_memory_cap;
     }
+    if (local_options.stack_capture_limit == 0) {
+      local_options.stack_capture_limit = module_options.stack_capture_limit;
+      local_options.stack_frame_window_size =
+          module_options.stack_frame_window_size;
+    }
+    if (local_options.gather_thread_float_contexts == TriState::kUnset) {
+      local_options.gather_thread_float_contexts =
+          module_options.gather_thread_float_contexts;
+    }
 
     // If non-default values have been found for all options, the loop can end
     // early.
     if (local_options.crashpad_handler_behavior != TriState::kUnset &&
         local_options.system_crash_reporter_forwarding != TriState::kUnset &&
-        local_options.gather_indirectly_referenced_memory != TriState::kUnset) {
+        local_options.gather_indirectly_referenced_memory != TriState::kUnset &&
+        local_options.stack_capture_limit != 0 &&
+        local_options.gather_thread_float_contexts != TriState::kUnset) {
       break;
     }
   }
@@ -223,6 +372,7 @@ const SystemSnapshot* ProcessSnapshotLinux::System() const {
 std::vector<const ThreadSnapshot*> ProcessSnapshotLinux::Threads() const {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
   std::vector<const ThreadSnapshot*> threads;
+  threads.reserve(threads_.size());
   for (const auto& thread : threads_) {
     threads.push_back(thread.get());
   }
@@ -232,6 +382,7 @@ std::vector<const ThreadSnapshot*> ProcessSnapshotLinux::Threads() const {
 std::vector<const ModuleSnapshot*> ProcessSnapshotLinux::Modules() const {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
   std::vector<const ModuleSnapshot*> modules;
+  modules.reserve(modules_.size());
   for (const auto& module : modules_) {
     modules.push_back(module.get());
   }
@@ -267,6 +418,41 @@ std::vector<const MemorySnapshot*> ProcessSnapshotLinux::ExtraMemory() const {
   return std::vector<const MemorySnapshot*>();
 }
 
+std::vector<const MemorySnapshot*> ProcessSnapshotLinux::FullMemory(
+    VMSize max_mapping_size) {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+
+  full_memory_.clear();
+  std::vector<const MemorySnapshot*> full_memory;
+  for (const auto& range :
+       process_reader_.GetMemoryMap()->GetFullMemoryRanges(max_mapping_size)) {
+    auto memory = std::make_unique<internal::MemorySnapshotGeneric>();
+    memory->Initialize(process_reader_.Memory(), range.base(), range.size());
+    full_memory.push_back(memory.get());
+    full_memory_.push_back(std::move(memory));
+  }
+  return full_memory;
+}
+
+std::vector<MINIDUMP_MEMORY_INFO> ProcessSnapshotLinux::MemoryInfo() {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+
+  const std::vector<MemoryMap::Mapping>& mappings =
+      process_reader_.GetMemoryMap()->Mappings();
+  std::vector<MINIDUMP_MEMORY_INFO> memory_info(mappings.size());
+  for (size_t index = 0; index < mappings.size(); ++index) {
+    const MemoryMap::Mapping& mapping = mappings[index];
+    MINIDUMP_MEMORY_INFO& info = memory_info[index];
+    info.BaseAddress = mapping.range.Base();
+    info.AllocationBase = mapping.range.Base();
+    info.RegionSize = mapping.range.Size();
+    info.State = MEM_COMMIT;
+    info.Protect = info.AllocationProtect = MappingToProtectFlags(mapping);
+    info.Type = mapping.inode ? MEM_MAPPED : MEM_PRIVATE;
+  }
+  return memory_info;
+}
+
 const ProcessMemory* ProcessSnapshotLinux::Memory() const {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
   return process_reader_.Memory();
@@ -275,33 +461,76 @@ const ProcessMemory* ProcessSnapshotLinux::Memory() const {
 void ProcessSnapshotLinux::InitializeThreads() {
   const std::vector<ProcessReaderLinux::Thread>& process_reader_threads =
       process_reader_.Threads();
-  uint32_t* budget_remaining_pointer =
-      options_.gather_indirectly_referenced_memory == TriState::kEnabled
-          ? &options_.indirectly_referenced_memory_cap
-          : nullptr;
+  if (options_.gather_indirectly_referenced_memory == TriState::kEnabled) {
+    capture_memory_plan_ =
+        std::make_unique<internal::CaptureMemoryPlanLinux>(&process_reader_);
+    capture_memory_plan_->SetAllocationBoundsReader(
+        allocation_bounds_reader_.get());
+  }
 
   for (const ProcessReaderLinux::Thread& process_reader_thread :
        process_reader_threads) {
     auto thread = std::make_unique<internal::ThreadSnapshotLinux>();
     if (thread->Initialize(&process_reader_,
                            process_reader_thread,
-                           budget_remaining_pointer)) {
+                           capture_memory_plan_.get(),
+                           options_.stack_capture_limit,
+                           options_.stack_frame_window_size,
+                           stack_unwinder_.get())) {
       threads_.push_back(std::move(thread));
     }
   }
+
+  // Every thread’s candidates are known, so the budget can be spent on the
+  // best of them. InitializeException() captures again once it knows which
+  // thread crashed.
+  if (capture_memory_plan_) {
+    capture_memory_plan_->Capture(options_.indirectly_referenced_memory_cap);
+  }
 }
 
-void ProcessSnapshotLinux::InitializeModules() {
-  for (const ProcessReaderLinux::Module& reader_module :
-       process_reader_.Modules()) {
-    auto module =
+void ProcessSnapshotLinux::InitializeModules(
+    unsigned int thread_count,
+    ElfImageInfoCache* image_info_cache) {
+  const std::vector<ProcessReaderLinux::Module>& reader_modules =
+      process_reader_.Modules();
+
+  std::vector<std::unique_ptr<internal::ModuleSnapshotElf>> modules;
+  modules.reserve(reader_modules.size());
+  for (const ProcessReaderLinux::Module& reader_module : reader_modules) {
+    modules.push_back(
         std::make_unique<internal::ModuleSnapshotElf>(reader_module.name,
                                                       reader_module.elf_reader,
                                                       reader_module.type,
                                                       &memory_range_,
-                                                      process_reader_.Memory());
-    if (module->Initialize()) {
-      modules_.push_back(std::move(module));
+                                                      process_reader_.Memory(),
+                                                      image_info_cache));
+  }
+
+  // Each module is initialized by exactly one thread, which records the result
+  // in its own element of initialized. The calling thread does its share of
+  // the work too.
+  std::vector<uint8_t> initialized(modules.size(), false);
+  std::atomic<size_t> next_index(0);
+  const size_t worker_count =
+      std::max(size_t{1}, std::min(size_t{thread_count}, modules.size())) - 1;
+  ModuleInitializer initializer(
+      &modules, &initialized, &next_index, worker_count > 0);
+
+  std::vector<std::unique_ptr<ModuleInitializerThread>> workers;
+  workers.reserve(worker_count);
+  for (size_t index = 0; index < worker_count; ++index) {
+    workers.push_back(std::make_unique<ModuleInitializerThread>(&initializer));
+    workers.back()->Start();
+  }
+  initializer.Run();
+  for (const auto& worker : workers) {
+    worker->Join();
+  }
+
+  for (size_t index = 0; index < modules.size(); ++index) {
+    if (initialized[index]) {
+      modules_.push_back(std::move(modules[index]));
     }
   }
 }
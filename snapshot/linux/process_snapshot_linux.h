@@ -24,12 +24,19 @@
 #include <vector>
 
 #include "snapshot/crashpad_info_client_options.h"
+#include "snapshot/elf/elf_image_info_cache.h"
 #include "snapshot/elf/module_snapshot_elf.h"
+#include "snapshot/linux/allocation_bounds_reader.h"
+#include "snapshot/linux/capture_memory_plan_linux.h"
 #include "snapshot/linux/exception_snapshot_linux.h"
+#include "snapshot/linux/module_reader_cache.h"
 #include "snapshot/linux/process_reader_linux.h"
+#include "snapshot/linux/stack_unwinder_linux.h"
+#include "snapshot/linux/system_info_cache.h"
 #include "snapshot/linux/system_snapshot_linux.h"
 #include "snapshot/linux/thread_snapshot_linux.h"
 #include "snapshot/memory_map_region_snapshot.h"
+#include "snapshot/memory_snapshot_generic.h"
 #include "snapshot/module_snapshot.h"
 #include "snapshot/process_snapshot.h"
 #include "snapshot/system_snapshot.h"
@@ -57,10 +64,45 @@ class ProcessSnapshotLinux final : public ProcessSnapshot {
   //! \brief Initializes the object.
   //!
   //! \param[in] connection A connection to the process to snapshot.
+  //! \param[in] module_snapshot_threads The number of threads, including the
+  //!     calling thread, used to initialize module snapshots and read their
+  //!     annotations. Modules are initialized on the calling thread alone
+  //!     unless this is greater than 1 and \a connection permits concurrent
+  //!     memory reads. The order of modules is the same regardless.
+  //! \param[in] thread_snapshot_threads The number of threads, including the
+  //!     calling thread, used to gather the names, scheduling priorities, and
+  //!     stack regions of the process’ threads once all of them have been
+  //!     attached to and their registers read. The same restriction as for
+  //!     \a module_snapshot_threads applies, and the order of threads is the
+  //!     same regardless.
+  //! \param[in] module_reader_cache A cache of what earlier snapshots of the
+  //!     same process read of its modules, used and updated by this snapshot.
+  //!     Optional.
+  //! \param[in] image_info_cache A cache of what is known about ELF images by
+  //!     build ID, shared with snapshots of other processes. Optional.
+  //! \param[in] system_info_cache A cache of what is known about the system,
+  //!     shared with snapshots of other processes. Optional.
+  //! \param[in] unwind_stacks Whether to unwind the stacks of the process’
+  //!     threads using their modules’ call frame information. The frames found
+  //!     are returned by ThreadSnapshot::UnwoundFrames(), and a stack that is
+  //!     unwound to its outermost frame is captured only up to that frame, plus
+  //!     a small margin.
+  //! \param[in] capture_whole_allocations Whether indirectly referenced memory
+  //!     that is a `malloc()` allocation is captured as the whole allocation,
+  //!     found from the allocator’s chunk headers, instead of a fixed amount
+  //!     around the reference. Only glibc’s allocator is understood. This has
+  //!     no effect unless the process requests indirectly referenced memory.
   //!
   //! \return `true` if the snapshot could be created, `false` otherwise with
   //!     an appropriate message logged.
-  bool Initialize(PtraceConnection* connection);
+  bool Initialize(PtraceConnection* connection,
+                  unsigned int module_snapshot_threads = 1,
+                  unsigned int thread_snapshot_threads = 1,
+                  ModuleReaderCache* module_reader_cache = nullptr,
+                  ElfImageInfoCache* image_info_cache = nullptr,
+                  SystemInfoCache* system_info_cache = nullptr,
+                  bool unwind_stacks = false,
+                  bool capture_whole_allocations = false);
 
   //! \brief Finds the thread whose stack contains \a stack_address.
   //!
@@ -113,6 +155,31 @@ class ProcessSnapshotLinux final : public ProcessSnapshot {
   //!     the process.
   void GetCrashpadOptions(CrashpadInfoClientOptions* options);
 
+  //! \brief Returns snapshots of the process’ memory for a full-memory
+  //!     minidump.
+  //!
+  //! The ranges are chosen by MemoryMap::GetFullMemoryRanges(). The memory is
+  //! read from the process as it is written, so the process must remain
+  //! stopped until then.
+  //!
+  //! \param[in] max_mapping_size Mappings larger than this are left out. `0`
+  //!     leaves out no mappings by size.
+  //!
+  //! \return The memory snapshots, which are owned by this object and remain
+  //!     valid until this method is called again or this object is destroyed.
+  std::vector<const MemorySnapshot*> FullMemory(VMSize max_mapping_size);
+
+  //! \brief Returns a description of each of the process’ mappings for a
+  //!     minidump’s memory info list.
+  //!
+  //! This is built directly from the process’ memory map, without a
+  //! MemoryMapRegionSnapshot for each mapping, so that processes with very
+  //! many mappings can be described cheaply. File-backed mappings have type
+  //! `MEM_MAPPED` and anonymous ones `MEM_PRIVATE`.
+  //!
+  //! \return The descriptions, sorted by address.
+  std::vector<MINIDUMP_MEMORY_INFO> MemoryInfo();
+
   // ProcessSnapshot:
 
   crashpad::ProcessID ProcessID() const override;
@@ -136,7 +203,8 @@ class ProcessSnapshotLinux final : public ProcessSnapshot {
 
  private:
   void InitializeThreads();
-  void InitializeModules();
+  void InitializeModules(unsigned int thread_count,
+                         ElfImageInfoCache* image_info_cache);
   void InitializeAnnotations();
 
   // Initializes options_ on behalf of Initialize().
@@ -149,8 +217,21 @@ class ProcessSnapshotLinux final : public ProcessSnapshot {
   std::vector<std::unique_ptr<internal::ThreadSnapshotLinux>> threads_;
   std::vector<std::unique_ptr<internal::ModuleSnapshotElf>> modules_;
   std::unique_ptr<internal::ExceptionSnapshotLinux> exception_;
+  std::vector<std::unique_ptr<internal::MemorySnapshotGeneric>> full_memory_;
+
+  // Chooses the indirectly referenced memory captured for threads_ and
+  // exception_, if it is to be captured at all.
+  std::unique_ptr<internal::CaptureMemoryPlanLinux> capture_memory_plan_;
   internal::SystemSnapshotLinux system_;
   ProcessReaderLinux process_reader_;
+
+  // Unwinds the stacks of threads_ and the exception thread, if they are to be
+  // unwound at all.
+  std::unique_ptr<internal::StackUnwinderLinux> stack_unwinder_;
+
+  // Finds the allocations that capture_memory_plan_ sizes its candidates to, if
+  // whole allocations are to be captured.
+  std::unique_ptr<internal::AllocationBoundsReader> allocation_bounds_reader_;
   ProcessMemoryRange memory_range_;
   CrashpadInfoClientOptions options_;
   InitializationStateDcheck initialized_;
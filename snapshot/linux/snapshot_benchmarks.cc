@@ -0,0 +1,655 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Measures the stages of capturing a snapshot of a process on Linux.
+//
+// A child process is forked with a configurable number of threads, loaded
+// modules, annotations, and memory mappings. The modules are generated by
+// LoadTestModule(). Each iteration connects to the child, either directly with
+// ptrace or through a PtraceBroker running on a thread in this process, and
+// times each of these stages on its own:
+//  - Attach: initializing the PtraceConnection.
+//  - MemoryMap: reading and parsing the child’s mappings.
+//  - ProcessReader: ProcessReaderLinux::Initialize(), which includes reading
+//    the mappings.
+//  - Threads: the thread pass of ProcessReaderLinux, attaching to and reading
+//    each thread.
+//  - Modules: the module pass of ProcessReaderLinux, finding each module and
+//    initializing its ElfImageReader.
+//  - ElfImageReader: initializing a new ElfImageReader for each module found
+//    by the module pass, without the cost of finding the modules.
+//  - ProcessSnapshot: ProcessSnapshotLinux::Initialize() on a new connection,
+//    which does all of the above and reads everything else, including the
+//    annotations.
+//
+// Percentiles over all iterations are reported for each stage.
+//
+// With --record, a ProcessSnapshotLinux of the child is also recorded to a
+// trace by a RecordingPtraceConnection. With --replay, no child is forked, and
+// each iteration instead loads a trace into a ReplayPtraceConnection and times
+// ProcessSnapshotLinux::Initialize() on it, so that a capture recorded from a
+// large process elsewhere can be measured repeatably without the process.
+
+#include <getopt.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/files/file_path.h"
+#include "base/logging.h"
+#include "base/posix/eintr_wrapper.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/stringprintf.h"
+#include "build/build_config.h"
+#include "client/annotation.h"
+#include "client/annotation_list.h"
+#include "snapshot/elf/elf_image_reader.h"
+#include "snapshot/linux/process_reader_linux.h"
+#include "snapshot/linux/process_snapshot_linux.h"
+#include "snapshot/linux/test_modules.h"
+#include "test/scoped_module_handle.h"
+#include "util/file/file_io.h"
+#include "util/file/file_reader.h"
+#include "util/file/file_writer.h"
+#include "util/linux/direct_ptrace_connection.h"
+#include "util/linux/memory_map.h"
+#include "util/linux/ptrace_broker.h"
+#include "util/linux/ptrace_client.h"
+#include "util/linux/ptrace_connection_trace.h"
+#include "util/process/process_memory_range.h"
+#include "util/synchronization/semaphore.h"
+#include "util/thread/thread.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+struct Options {
+  size_t threads;
+  size_t modules;
+  size_t annotations;
+  size_t mappings;
+  size_t iterations;
+  std::string record;
+  std::string replay;
+};
+
+void Usage(const std::string& me) {
+  // clang-format off
+  fprintf(stderr,
+"Usage: %s [OPTION]...\n"
+"Benchmark the stages of capturing a snapshot of a process.\n"
+"\n"
+"      --annotations=N  annotations set by the child (default 100)\n"
+"      --iterations=N   repetitions of each benchmark (default 20)\n"
+"      --mappings=N     extra mappings made by the child (default 1000)\n"
+"      --modules=N      modules loaded by the child (default 100)\n"
+"      --record=FILE    record a snapshot of the child to FILE\n"
+"      --replay=FILE    time snapshots replayed from FILE instead of a child\n"
+"      --threads=N      threads started by the child (default 32)\n"
+"      --help           display this help and exit\n",
+          me.c_str());
+  // clang-format on
+}
+
+uint64_t MonotonicNanoseconds() {
+  timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return static_cast<uint64_t>(now.tv_sec) * 1000000000 + now.tv_nsec;
+}
+
+// A child thread that waits until the child exits.
+class IdleThread : public Thread {
+ public:
+  IdleThread(Semaphore* started, Semaphore* exit)
+      : started_(started), exit_(exit) {}
+
+  IdleThread(const IdleThread&) = delete;
+  IdleThread& operator=(const IdleThread&) = delete;
+
+  ~IdleThread() override {}
+
+ private:
+  // Thread:
+  void ThreadMain() override {
+    started_->Signal();
+    exit_->Wait();
+  }
+
+  Semaphore* started_;  // weak
+  Semaphore* exit_;  // weak
+};
+
+// Sets up the child’s threads, modules, annotations, and mappings, writes a
+// byte to write_fd, and waits for read_fd to be closed before exiting.
+[[noreturn]] void RunChild(const Options& options,
+                           FileHandle read_fd,
+                           FileHandle write_fd) {
+  Semaphore started(0);
+  Semaphore exit(0);
+  std::vector<std::unique_ptr<IdleThread>> threads;
+  for (size_t index = 0; index < options.threads; ++index) {
+    threads.push_back(std::make_unique<IdleThread>(&started, &exit));
+    threads.back()->Start();
+  }
+  for (size_t index = 0; index < options.threads; ++index) {
+    started.Wait();
+  }
+
+  const pid_t pid = getpid();
+  std::vector<ScopedModuleHandle> modules;
+  for (size_t index = 0; index < options.modules; ++index) {
+    modules.push_back(LoadTestModule(
+        base::StringPrintf("libbenchmark_%d_%zu.so", pid, index),
+        base::StringPrintf("libbenchmark_%zu.so", index)));
+    if (!modules.back().valid()) {
+      _exit(EXIT_FAILURE);
+    }
+  }
+
+  AnnotationList::Register();
+  std::vector<std::string> annotation_names;
+  annotation_names.reserve(options.annotations);
+  std::vector<std::unique_ptr<StringAnnotation<64>>> annotations;
+  for (size_t index = 0; index < options.annotations; ++index) {
+    annotation_names.push_back(base::StringPrintf("annotation_%zu", index));
+    annotations.push_back(std::make_unique<StringAnnotation<64>>(
+        annotation_names.back().c_str()));
+    annotations.back()->Set(annotation_names.back());
+  }
+
+  // Alternating protections keep the kernel from merging the pages into a
+  // single mapping.
+  const size_t page_size = getpagesize();
+  if (options.mappings > 0) {
+    const size_t size = options.mappings * page_size;
+    char* pages = static_cast<char*>(mmap(nullptr,
+                                          size,
+                                          PROT_READ | PROT_WRITE,
+                                          MAP_PRIVATE | MAP_ANONYMOUS,
+                                          -1,
+                                          0));
+    if (pages == MAP_FAILED) {
+      PLOG(ERROR) << "mmap";
+      _exit(EXIT_FAILURE);
+    }
+    for (size_t index = 1; index < options.mappings; index += 2) {
+      if (mprotect(pages + index * page_size, page_size, PROT_READ) != 0) {
+        PLOG(ERROR) << "mprotect";
+        _exit(EXIT_FAILURE);
+      }
+    }
+  }
+
+  char c = 0;
+  if (!LoggingWriteFile(write_fd, &c, sizeof(c))) {
+    _exit(EXIT_FAILURE);
+  }
+  CheckedReadFileAtEOF(read_fd);
+
+  // In a forked child, exit() is unsafe. Use _exit() instead.
+  _exit(EXIT_SUCCESS);
+}
+
+// Runs a PtraceBroker on a thread in this process.
+class RunBrokerThread : public Thread {
+ public:
+  explicit RunBrokerThread(PtraceBroker* broker)
+      : Thread(), broker_(broker) {}
+
+  RunBrokerThread(const RunBrokerThread&) = delete;
+  RunBrokerThread& operator=(const RunBrokerThread&) = delete;
+
+  ~RunBrokerThread() override {}
+
+ private:
+  // Thread:
+  void ThreadMain() override { broker_->Run(); }
+
+  PtraceBroker* broker_;  // weak
+};
+
+// A connection to the child, either direct or through a PtraceBroker.
+class BenchmarkConnection {
+ public:
+  BenchmarkConnection() = default;
+
+  BenchmarkConnection(const BenchmarkConnection&) = delete;
+  BenchmarkConnection& operator=(const BenchmarkConnection&) = delete;
+
+  ~BenchmarkConnection() {
+    // Destroying the client asks the broker to exit.
+    client_.reset();
+    if (broker_thread_) {
+      broker_thread_->Join();
+    }
+  }
+
+  bool Initialize(pid_t pid, bool use_broker) {
+    if (!use_broker) {
+      auto direct = std::make_unique<DirectPtraceConnection>();
+      if (!direct->Initialize(pid)) {
+        return false;
+      }
+      connection_ = std::move(direct);
+      return true;
+    }
+
+    int socks[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, socks) != 0) {
+      PLOG(ERROR) << "socketpair";
+      return false;
+    }
+    broker_sock_.reset(socks[0]);
+    client_sock_.reset(socks[1]);
+
+#if defined(ARCH_CPU_64_BITS)
+    constexpr bool am_64_bit = true;
+#else
+    constexpr bool am_64_bit = false;
+#endif  // ARCH_CPU_64_BITS
+
+    broker_ =
+        std::make_unique<PtraceBroker>(broker_sock_.get(), pid, am_64_bit);
+    broker_thread_ = std::make_unique<RunBrokerThread>(broker_.get());
+    broker_thread_->Start();
+
+    auto client = std::make_unique<PtraceClient>();
+    PtraceClient* client_ptr = client.get();
+    client_ = std::move(client);
+    return client_ptr->Initialize(client_sock_.get(), pid);
+  }
+
+  PtraceConnection* Get() {
+    return connection_ ? connection_.get() : client_.get();
+  }
+
+ private:
+  std::unique_ptr<PtraceConnection> connection_;
+  ScopedFileHandle broker_sock_;
+  ScopedFileHandle client_sock_;
+  std::unique_ptr<PtraceBroker> broker_;
+  std::unique_ptr<RunBrokerThread> broker_thread_;
+  std::unique_ptr<PtraceClient> client_;
+};
+
+using StageTimes = std::map<std::string, std::vector<double>>;
+
+// Times |function| as |stage|, returning its result.
+template <typename Function>
+bool Measure(StageTimes* times, const char* stage, Function function) {
+  const uint64_t start_ns = MonotonicNanoseconds();
+  const bool rv = function();
+  (*times)[stage].push_back((MonotonicNanoseconds() - start_ns) / 1e6);
+  return rv;
+}
+
+// Measures each stage once for the child at |pid|.
+bool RunIteration(const Options& options,
+                  pid_t pid,
+                  bool use_broker,
+                  StageTimes* times) {
+  {
+    BenchmarkConnection connection;
+    if (!Measure(times, "Attach", [&connection, pid, use_broker]() {
+          return connection.Initialize(pid, use_broker);
+        })) {
+      return false;
+    }
+
+    MemoryMap memory_map;
+    if (!Measure(times, "MemoryMap", [&connection, &memory_map]() {
+          return memory_map.Initialize(connection.Get());
+        })) {
+      return false;
+    }
+
+    ProcessReaderLinux reader;
+    if (!Measure(times, "ProcessReader", [&connection, &reader]() {
+          return reader.Initialize(connection.Get());
+        })) {
+      return false;
+    }
+
+    size_t thread_count = 0;
+    Measure(times, "Threads", [&reader, &thread_count]() {
+      thread_count = reader.Threads().size();
+      return true;
+    });
+    if (thread_count < options.threads + 1) {
+      LOG(ERROR) << "found " << thread_count << " threads";
+      return false;
+    }
+
+    size_t module_count = 0;
+    Measure(times, "Modules", [&reader, &module_count]() {
+      module_count = reader.Modules().size();
+      return true;
+    });
+    if (module_count < options.modules) {
+      LOG(ERROR) << "found " << module_count << " modules";
+      return false;
+    }
+
+    ProcessMemoryRange range;
+    if (!range.Initialize(connection.Get()->Memory(),
+                          connection.Get()->Is64Bit())) {
+      return false;
+    }
+    Measure(times, "ElfImageReader", [&reader, &range]() {
+      for (const ProcessReaderLinux::Module& module : reader.Modules()) {
+        if (module.elf_reader) {
+          ElfImageReader elf_reader;
+          elf_reader.Initialize(range, module.elf_reader->Address(), false);
+        }
+      }
+      return true;
+    });
+  }
+
+  BenchmarkConnection connection;
+  if (!connection.Initialize(pid, use_broker)) {
+    return false;
+  }
+  ProcessSnapshotLinux snapshot;
+  return Measure(times, "ProcessSnapshot", [&connection, &snapshot]() {
+    return snapshot.Initialize(connection.Get());
+  });
+}
+
+// Records a snapshot of the child at |pid| to |path|.
+bool RecordTrace(pid_t pid, const std::string& path) {
+  DirectPtraceConnection connection;
+  if (!connection.Initialize(pid)) {
+    return false;
+  }
+
+  FileWriter writer;
+  if (!writer.Open(base::FilePath(path),
+                   FileWriteMode::kTruncateOrCreate,
+                   FilePermissions::kOwnerOnly)) {
+    return false;
+  }
+
+  RecordingPtraceConnection recorder;
+  if (!recorder.Initialize(&connection, &writer)) {
+    return false;
+  }
+  ProcessSnapshotLinux snapshot;
+  return snapshot.Initialize(&recorder);
+}
+
+// Measures loading the trace at |path| and replaying a snapshot from it once.
+bool RunReplayIteration(const std::string& path, StageTimes* times) {
+  FileReader reader;
+  if (!reader.Open(base::FilePath(path))) {
+    return false;
+  }
+
+  ReplayPtraceConnection connection;
+  if (!Measure(times, "Load", [&connection, &reader]() {
+        return connection.Initialize(&reader);
+      })) {
+    return false;
+  }
+
+  ProcessSnapshotLinux snapshot;
+  return Measure(times, "ProcessSnapshot", [&connection, &snapshot]() {
+    return snapshot.Initialize(&connection);
+  });
+}
+
+double Percentile(const std::vector<double>& sorted, double percentile) {
+  const size_t rank = static_cast<size_t>(percentile * sorted.size() / 100);
+  return sorted[std::min(rank, sorted.size() - 1)];
+}
+
+void PrintHeader() {
+  printf("%-36s %10s %10s %10s %10s\n", "Benchmark", "p50", "p90", "p99",
+         "Max");
+}
+
+void PrintPercentiles(const std::string& name, std::vector<double> values) {
+  std::sort(values.begin(), values.end());
+  printf("%-36s %7.3f ms %7.3f ms %7.3f ms %7.3f ms\n",
+         name.c_str(),
+         Percentile(values, 50),
+         Percentile(values, 90),
+         Percentile(values, 99),
+         values.back());
+}
+
+int SnapshotBenchmarksMain(int argc, char* argv[]) {
+  const std::string me = base::FilePath(argv[0]).BaseName().value();
+
+  enum OptionFlags {
+    // Long options without short equivalents.
+    kOptionLastChar = 255,
+    kOptionAnnotations,
+    kOptionIterations,
+    kOptionMappings,
+    kOptionModules,
+    kOptionRecord,
+    kOptionReplay,
+    kOptionThreads,
+
+    // Standard options.
+    kOptionHelp = -2,
+  };
+
+  Options options = {};
+  options.threads = 32;
+  options.modules = 100;
+  options.annotations = 100;
+  options.mappings = 1000;
+  options.iterations = 20;
+
+  static constexpr option long_options[] = {
+      {"annotations", required_argument, nullptr, kOptionAnnotations},
+      {"iterations", required_argument, nullptr, kOptionIterations},
+      {"mappings", required_argument, nullptr, kOptionMappings},
+      {"modules", required_argument, nullptr, kOptionModules},
+      {"record", required_argument, nullptr, kOptionRecord},
+      {"replay", required_argument, nullptr, kOptionReplay},
+      {"threads", required_argument, nullptr, kOptionThreads},
+      {"help", no_argument, nullptr, kOptionHelp},
+      {nullptr, 0, nullptr, 0},
+  };
+
+  int opt;
+  while ((opt = getopt_long(argc, argv, "", long_options, nullptr)) != -1) {
+    size_t* size_option = nullptr;
+    switch (opt) {
+      case kOptionAnnotations:
+        size_option = &options.annotations;
+        break;
+      case kOptionIterations:
+        size_option = &options.iterations;
+        break;
+      case kOptionMappings:
+        size_option = &options.mappings;
+        break;
+      case kOptionModules:
+        size_option = &options.modules;
+        break;
+      case kOptionRecord:
+        options.record = optarg;
+        break;
+      case kOptionReplay:
+        options.replay = optarg;
+        break;
+      case kOptionThreads:
+        size_option = &options.threads;
+        break;
+      case kOptionHelp:
+        Usage(me);
+        return EXIT_SUCCESS;
+      default:
+        fprintf(stderr, "Try '%s --help' for more information.\n", me.c_str());
+        return EXIT_FAILURE;
+    }
+
+    if (size_option && !base::StringToSizeT(optarg, size_option)) {
+      fprintf(stderr, "%s: invalid number: %s\n", me.c_str(), optarg);
+      return EXIT_FAILURE;
+    }
+  }
+
+  if (optind != argc || options.iterations == 0 ||
+      (!options.record.empty() && !options.replay.empty())) {
+    fprintf(stderr, "Try '%s --help' for more information.\n", me.c_str());
+    return EXIT_FAILURE;
+  }
+
+  if (!options.replay.empty()) {
+    StageTimes times;
+    for (size_t index = 0; index < options.iterations; ++index) {
+      if (!RunReplayIteration(options.replay, &times)) {
+        fprintf(stderr, "%s: Replay failed\n", me.c_str());
+        return EXIT_FAILURE;
+      }
+    }
+
+    printf("replay=%s iterations=%zu\n\n",
+           options.replay.c_str(),
+           options.iterations);
+    PrintHeader();
+    for (const char* stage : {"Load", "ProcessSnapshot"}) {
+      PrintPercentiles(base::StringPrintf("Replay/%s", stage), times[stage]);
+    }
+    return EXIT_SUCCESS;
+  }
+
+  int to_child[2];
+  int from_child[2];
+  if (pipe(to_child) != 0 || pipe(from_child) != 0) {
+    PLOG(ERROR) << "pipe";
+    return EXIT_FAILURE;
+  }
+  ScopedFileHandle to_child_read(to_child[0]);
+  ScopedFileHandle to_child_write(to_child[1]);
+  ScopedFileHandle from_child_read(from_child[0]);
+  ScopedFileHandle from_child_write(from_child[1]);
+
+  pid_t pid = fork();
+  if (pid < 0) {
+    PLOG(ERROR) << "fork";
+    return EXIT_FAILURE;
+  }
+  if (pid == 0) {
+    to_child_write.reset();
+    from_child_read.reset();
+    RunChild(options, to_child_read.get(), from_child_write.get());
+  }
+  to_child_read.reset();
+  from_child_write.reset();
+
+  int status = EXIT_SUCCESS;
+  char c;
+  if (!LoggingReadFileExactly(from_child_read.get(), &c, sizeof(c))) {
+    status = EXIT_FAILURE;
+  }
+
+  if (status == EXIT_SUCCESS) {
+    printf("threads=%zu modules=%zu annotations=%zu mappings=%zu "
+           "iterations=%zu\n\n",
+           options.threads,
+           options.modules,
+           options.annotations,
+           options.mappings,
+           options.iterations);
+    PrintHeader();
+  }
+
+  static constexpr struct {
+    const char* name;
+    bool use_broker;
+  } kConnections[] = {
+      {"Direct", false},
+      {"Broker", true},
+  };
+
+  static constexpr const char* kStages[] = {
+      "Attach",
+      "MemoryMap",
+      "ProcessReader",
+      "Threads",
+      "Modules",
+      "ElfImageReader",
+      "ProcessSnapshot",
+  };
+
+  for (const auto& connection : kConnections) {
+    if (status != EXIT_SUCCESS) {
+      break;
+    }
+
+    StageTimes times;
+    for (size_t index = 0; index < options.iterations; ++index) {
+      if (!RunIteration(options, pid, connection.use_broker, &times)) {
+        fprintf(stderr, "%s: %s failed\n", me.c_str(), connection.name);
+        status = EXIT_FAILURE;
+        break;
+      }
+    }
+    if (status != EXIT_SUCCESS) {
+      break;
+    }
+
+    for (const char* stage : kStages) {
+      PrintPercentiles(base::StringPrintf("%s/%s", connection.name, stage),
+                       times[stage]);
+    }
+  }
+
+  if (status == EXIT_SUCCESS && !options.record.empty() &&
+      !RecordTrace(pid, options.record)) {
+    fprintf(stderr, "%s: Record failed\n", me.c_str());
+    status = EXIT_FAILURE;
+  }
+
+  to_child_write.reset();
+  int child_status;
+  if (HANDLE_EINTR(waitpid(pid, &child_status, 0)) != pid) {
+    PLOG(ERROR) << "waitpid";
+    status = EXIT_FAILURE;
+  } else if (!WIFEXITED(child_status) ||
+             WEXITSTATUS(child_status) != EXIT_SUCCESS) {
+    LOG(ERROR) << "unexpected child termination, status " << child_status;
+    status = EXIT_FAILURE;
+  }
+
+  return status;
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
+
+int main(int argc, char* argv[]) {
+  return crashpad::test::SnapshotBenchmarksMain(argc, argv);
+}
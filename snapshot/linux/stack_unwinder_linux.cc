@@ -0,0 +1,300 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "snapshot/linux/stack_unwinder_linux.h"
+
+#include <algorithm>
+#include <iterator>
+
+#include "base/logging.h"
+
+namespace crashpad {
+namespace internal {
+
+namespace {
+
+// The maximum number of frames to unwind, guarding against cycles that the
+// stack pointer checks don’t catch.
+constexpr size_t kMaxFrames = 256;
+
+// The registers that unwinding tracks, numbered by their DWARF register
+// numbers.
+struct Registers {
+  uint64_t values[ElfCFIReader::kMaxRegisters];
+  bool valid[ElfCFIReader::kMaxRegisters];
+};
+
+// Describes how a CPU architecture’s registers map to DWARF register numbers.
+struct RegisterLayout {
+  uint32_t stack_pointer;
+  bool is_64_bit;
+};
+
+bool InitializeRegisters(const CPUContext& context,
+                         Registers* registers,
+                         RegisterLayout* layout) {
+  std::fill(std::begin(registers->valid), std::end(registers->valid), false);
+  auto set = [registers](uint32_t reg, uint64_t value) {
+    registers->values[reg] = value;
+    registers->valid[reg] = true;
+  };
+
+  switch (context.architecture) {
+    case kCPUArchitectureX86_64: {
+      const CPUContextX86_64* x86_64 = context.x86_64;
+      const uint64_t values[] = {x86_64->rax,
+                                 x86_64->rdx,
+                                 x86_64->rcx,
+                                 x86_64->rbx,
+                                 x86_64->rsi,
+                                 x86_64->rdi,
+                                 x86_64->rbp,
+                                 x86_64->rsp,
+                                 x86_64->r8,
+                                 x86_64->r9,
+                                 x86_64->r10,
+                                 x86_64->r11,
+                                 x86_64->r12,
+                                 x86_64->r13,
+                                 x86_64->r14,
+                                 x86_64->r15,
+                                 x86_64->rip};
+      for (size_t reg = 0; reg < std::size(values); ++reg) {
+        set(reg, values[reg]);
+      }
+      layout->stack_pointer = 7;
+      layout->is_64_bit = true;
+      return true;
+    }
+
+    case kCPUArchitectureX86: {
+      const CPUContextX86* x86 = context.x86;
+      const uint32_t values[] = {x86->eax,
+                                 x86->ecx,
+                                 x86->edx,
+                                 x86->ebx,
+                                 x86->esp,
+                                 x86->ebp,
+                                 x86->esi,
+                                 x86->edi,
+                                 x86->eip};
+      for (size_t reg = 0; reg < std::size(values); ++reg) {
+        set(reg, values[reg]);
+      }
+      layout->stack_pointer = 4;
+      layout->is_64_bit = false;
+      return true;
+    }
+
+    case kCPUArchitectureARM64: {
+      const CPUContextARM64* arm64 = context.arm64;
+      for (size_t reg = 0; reg < std::size(arm64->regs); ++reg) {
+        set(reg, arm64->regs[reg]);
+      }
+      set(31, arm64->sp);
+      layout->stack_pointer = 31;
+      layout->is_64_bit = true;
+      return true;
+    }
+
+    default:
+      return false;
+  }
+}
+
+}  // namespace
+
+StackUnwinderLinux::StackUnwinderLinux(ProcessReaderLinux* process_reader)
+    : modules_(),
+      process_reader_(process_reader),
+      modules_initialized_(false) {}
+
+StackUnwinderLinux::~StackUnwinderLinux() = default;
+
+bool StackUnwinderLinux::Unwind(const CPUContext& context,
+                                LinuxVMAddress stack_start,
+                                LinuxVMAddress stack_end,
+                                std::vector<Frame>* frames,
+                                LinuxVMAddress* live_stack_end) {
+  frames->clear();
+
+  Registers registers;
+  RegisterLayout layout;
+  if (!InitializeRegisters(context, &registers, &layout)) {
+    return false;
+  }
+  const uint64_t pointer_mask =
+      layout.is_64_bit ? ~uint64_t{0} : uint64_t{0xffffffff};
+  const ProcessMemory* memory = process_reader_->Memory();
+
+  LinuxVMAddress pc = context.InstructionPointer();
+  LinuxVMAddress sp = context.StackPointer();
+  bool use_pc_for_lookup = true;
+  while (frames->size() < kMaxFrames) {
+    frames->push_back({pc, sp});
+
+    // A return address points just beyond the call, which may be in a
+    // different function than the call itself when the call is the last
+    // instruction in the function. Frames interrupted by a signal have no
+    // call, and are looked up at their own address.
+    const LinuxVMAddress lookup = use_pc_for_lookup ? pc : pc - 1;
+    const ElfCFIReader* cfi_reader = CFIReaderForAddress(lookup);
+    ElfCFIReader::FrameRules rules;
+    if (!cfi_reader || !cfi_reader->GetFrameRules(lookup, &rules)) {
+      return false;
+    }
+
+    if (rules.cfa_register >= ElfCFIReader::kMaxRegisters ||
+        !registers.valid[rules.cfa_register]) {
+      return false;
+    }
+    const LinuxVMAddress cfa =
+        (registers.values[rules.cfa_register] + rules.cfa_offset) &
+        pointer_mask;
+    if (cfa < sp || cfa < stack_start || cfa > stack_end) {
+      return false;
+    }
+
+    if (rules.return_address_register >= ElfCFIReader::kMaxRegisters) {
+      return false;
+    }
+    if (rules.registers[rules.return_address_register].type ==
+        ElfCFIReader::RegisterRule::Type::kUndefined) {
+      *live_stack_end = cfa;
+      return true;
+    }
+
+    Registers caller_registers = {};
+    for (uint32_t reg = 0; reg < ElfCFIReader::kMaxRegisters; ++reg) {
+      const ElfCFIReader::RegisterRule& rule = rules.registers[reg];
+      switch (rule.type) {
+        case ElfCFIReader::RegisterRule::Type::kSameValue:
+          caller_registers.values[reg] = registers.values[reg];
+          caller_registers.valid[reg] = registers.valid[reg];
+          break;
+
+        case ElfCFIReader::RegisterRule::Type::kOffset: {
+          uint64_t value = 0;
+          if (memory->Read((cfa + rule.offset) & pointer_mask,
+                           layout.is_64_bit ? 8 : 4,
+                           &value)) {
+            caller_registers.values[reg] = value;
+            caller_registers.valid[reg] = true;
+          }
+          break;
+        }
+
+        case ElfCFIReader::RegisterRule::Type::kValOffset:
+          caller_registers.values[reg] = (cfa + rule.offset) & pointer_mask;
+          caller_registers.valid[reg] = true;
+          break;
+
+        case ElfCFIReader::RegisterRule::Type::kRegister:
+          if (rule.offset >= 0 &&
+              rule.offset < static_cast<int64_t>(ElfCFIReader::kMaxRegisters)) {
+            caller_registers.values[reg] = registers.values[rule.offset];
+            caller_registers.valid[reg] = registers.valid[rule.offset];
+          }
+          break;
+
+        case ElfCFIReader::RegisterRule::Type::kUndefined:
+        case ElfCFIReader::RegisterRule::Type::kExpression:
+          break;
+      }
+    }
+
+    // By convention, the caller’s stack pointer is the canonical frame
+    // address.
+    caller_registers.values[layout.stack_pointer] = cfa;
+    caller_registers.valid[layout.stack_pointer] = true;
+
+    if (!caller_registers.valid[rules.return_address_register]) {
+      return false;
+    }
+    LinuxVMAddress return_address = process_reader_->PointerToAddress(
+        caller_registers.values[rules.return_address_register]);
+    if (rules.return_address_signed) {
+      // Strip the pointer authentication code, which occupies the bits above
+      // the virtual address.
+      return_address &= (uint64_t{1} << 48) - 1;
+    }
+    if (return_address == 0) {
+      *live_stack_end = cfa;
+      return true;
+    }
+
+    if (cfa == sp && return_address == pc) {
+      LOG(WARNING) << "unwinding made no progress";
+      return false;
+    }
+
+    pc = return_address;
+    sp = cfa;
+    use_pc_for_lookup = rules.signal_frame;
+    registers = caller_registers;
+  }
+
+  LOG(WARNING) << "too many frames";
+  return false;
+}
+
+const ElfCFIReader* StackUnwinderLinux::CFIReaderForAddress(
+    LinuxVMAddress address) {
+  if (!modules_initialized_) {
+    for (const ProcessReaderLinux::Module& module :
+         process_reader_->Modules()) {
+      if (!module.elf_reader) {
+        continue;
+      }
+      Module& entry = modules_.emplace_back();
+      entry.address = module.elf_reader->Address();
+      entry.size = module.elf_reader->Size();
+      entry.elf_reader = module.elf_reader;
+      entry.cfi_reader_initialized = false;
+    }
+    std::sort(modules_.begin(),
+              modules_.end(),
+              [](const Module& lhs, const Module& rhs) {
+                return lhs.address < rhs.address;
+              });
+    modules_initialized_ = true;
+  }
+
+  auto it = std::upper_bound(
+      modules_.begin(),
+      modules_.end(),
+      address,
+      [](LinuxVMAddress address, const Module& module) {
+        return address < module.address;
+      });
+  if (it == modules_.begin()) {
+    return nullptr;
+  }
+  Module& module = *--it;
+  if (address - module.address >= module.size) {
+    return nullptr;
+  }
+
+  if (!module.cfi_reader_initialized) {
+    module.cfi_reader_initialized = true;
+    auto cfi_reader = std::make_unique<ElfCFIReader>();
+    if (cfi_reader->Initialize(module.elf_reader)) {
+      module.cfi_reader = std::move(cfi_reader);
+    }
+  }
+  return module.cfi_reader.get();
+}
+
+}  // namespace internal
+}  // namespace crashpad
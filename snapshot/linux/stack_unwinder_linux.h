@@ -0,0 +1,98 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_SNAPSHOT_LINUX_STACK_UNWINDER_LINUX_H_
+#define CRASHPAD_SNAPSHOT_LINUX_STACK_UNWINDER_LINUX_H_
+
+#include <memory>
+#include <vector>
+
+#include "snapshot/cpu_context.h"
+#include "snapshot/elf/elf_cfi_reader.h"
+#include "snapshot/linux/process_reader_linux.h"
+#include "util/linux/address_types.h"
+
+namespace crashpad {
+namespace internal {
+
+//! \brief Unwinds the stacks of a process’ threads using the call frame
+//!     information in the `.eh_frame` sections of the process’ modules.
+//!
+//! Unwinding is supported on x86, x86_64, and ARM64. Each module’s call frame
+//! information is located the first time a frame in the module is unwound,
+//! and is shared by all threads unwound by the same object.
+class StackUnwinderLinux {
+ public:
+  //! \brief A frame found by unwinding a thread’s stack.
+  struct Frame {
+    //! \brief The frame’s instruction pointer. In frames other than the
+    //!     innermost one and those interrupted by a signal, this is a return
+    //!     address.
+    LinuxVMAddress instruction_pointer;
+
+    //! \brief The frame’s stack pointer.
+    LinuxVMAddress stack_pointer;
+  };
+
+  //! \param[in] process_reader A ProcessReaderLinux for the process whose
+  //!     threads are to be unwound.
+  explicit StackUnwinderLinux(ProcessReaderLinux* process_reader);
+
+  StackUnwinderLinux(const StackUnwinderLinux&) = delete;
+  StackUnwinderLinux& operator=(const StackUnwinderLinux&) = delete;
+
+  ~StackUnwinderLinux();
+
+  //! \brief Unwinds a thread’s stack.
+  //!
+  //! \param[in] context The thread’s CPU context.
+  //! \param[in] stack_start The lowest address of the thread’s stack region.
+  //! \param[in] stack_end The address just beyond the thread’s stack region.
+  //!     Unwinding stops at any frame outside of the stack region.
+  //! \param[out] frames The frames found, innermost first, beginning with the
+  //!     one for \a context.
+  //! \param[out] live_stack_end The address just beyond the outermost frame,
+  //!     valid if this method returns `true`.
+  //! \return `true` if the outermost frame was reached, whose return address
+  //!     is marked as undefined by its call frame information. `false` if
+  //!     unwinding stopped before that, such as at a function with no call
+  //!     frame information, with the frames found until then in \a frames.
+  bool Unwind(const CPUContext& context,
+              LinuxVMAddress stack_start,
+              LinuxVMAddress stack_end,
+              std::vector<Frame>* frames,
+              LinuxVMAddress* live_stack_end);
+
+ private:
+  struct Module {
+    LinuxVMAddress address;
+    LinuxVMSize size;
+    ElfImageReader* elf_reader;  // weak
+    std::unique_ptr<ElfCFIReader> cfi_reader;
+    bool cfi_reader_initialized;
+  };
+
+  // Returns the call frame information reader for the module containing
+  // address, or nullptr if there is none.
+  const ElfCFIReader* CFIReaderForAddress(LinuxVMAddress address);
+
+  std::vector<Module> modules_;
+  ProcessReaderLinux* process_reader_;  // weak
+  bool modules_initialized_;
+};
+
+}  // namespace internal
+}  // namespace crashpad
+
+#endif  // CRASHPAD_SNAPSHOT_LINUX_STACK_UNWINDER_LINUX_H_
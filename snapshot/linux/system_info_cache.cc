@@ -0,0 +1,233 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "snapshot/linux/system_info_cache.h"
+
+#include <sys/utsname.h>
+
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "base/check_op.h"
+#include "base/files/file_path.h"
+#include "base/logging.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_piece.h"
+#include "base/strings/stringprintf.h"
+#include "util/file/file_io.h"
+#include "util/misc/clock.h"
+#include "util/numeric/in_range_cast.h"
+#include "util/string/split_string.h"
+
+#if BUILDFLAG(IS_ANDROID)
+#include <sys/system_properties.h>
+#endif
+
+namespace crashpad {
+
+namespace {
+
+bool ReadCPUsOnline(uint32_t* first_cpu, uint8_t* cpu_count) {
+  std::string contents;
+  if (!LoggingReadEntireFile(base::FilePath("/sys/devices/system/cpu/online"),
+                             &contents)) {
+    return false;
+  }
+  if (contents.back() != '\n') {
+    LOG(ERROR) << "format error";
+    return false;
+  }
+  contents.pop_back();
+
+  unsigned int count = 0;
+  unsigned int first = 0;
+  bool have_first = false;
+  std::vector<std::string> ranges = SplitString(contents, ',');
+  for (const auto& range : ranges) {
+    std::string left, right;
+    if (SplitStringFirst(range, '-', &left, &right)) {
+      unsigned int start, end;
+      if (!StringToUint(base::StringPiece(left), &start) ||
+          !StringToUint(base::StringPiece(right), &end) || end <= start) {
+        LOG(ERROR) << "format error: " << range;
+        return false;
+      }
+      if (end <= start) {
+        LOG(ERROR) << "format error";
+        return false;
+      }
+      count += end - start + 1;
+      if (!have_first) {
+        first = start;
+        have_first = true;
+      }
+    } else {
+      unsigned int cpuno;
+      if (!StringToUint(base::StringPiece(range), &cpuno)) {
+        LOG(ERROR) << "format error";
+        return false;
+      }
+      if (!have_first) {
+        first = cpuno;
+        have_first = true;
+      }
+      ++count;
+    }
+  }
+  if (!have_first) {
+    LOG(ERROR) << "no cpus online";
+    return false;
+  }
+  *cpu_count = InRangeCast<uint8_t>(count, std::numeric_limits<uint8_t>::max());
+  *first_cpu = first;
+  return true;
+}
+
+#if BUILDFLAG(IS_ANDROID)
+bool ReadProperty(const char* property, std::string* value) {
+  char value_buffer[PROP_VALUE_MAX];
+  int length = __system_property_get(property, value_buffer);
+  if (length <= 0) {
+    LOG(ERROR) << "Couldn't read property " << property;
+    return false;
+  }
+  *value = value_buffer;
+  return true;
+}
+#endif  // BUILDFLAG(IS_ANDROID)
+
+}  // namespace
+
+SystemInfoCache::SystemInfo::SystemInfo()
+    : os_version_full(),
+      os_version_build(),
+      machine_description(),
+      os_version_major(-1),
+      os_version_minor(-1),
+      os_version_bugfix(-1),
+      target_cpu(0),
+      cpu_count(0)
+#if defined(ARCH_CPU_X86_FAMILY)
+      ,
+      cpuid()
+#endif  // ARCH_CPU_X86_FAMILY
+{
+}
+
+SystemInfoCache::SystemInfo::~SystemInfo() = default;
+
+void SystemInfoCache::SystemInfo::Read() {
+#if BUILDFLAG(IS_ANDROID)
+  std::string build_string;
+  if (ReadProperty("ro.build.fingerprint", &build_string)) {
+    os_version_build = build_string;
+    os_version_full = build_string;
+  }
+
+  std::string prop;
+  if (ReadProperty("ro.product.model", &prop)) {
+    machine_description += prop;
+  }
+  if (ReadProperty("ro.product.board", &prop)) {
+    if (!machine_description.empty()) {
+      machine_description.push_back(' ');
+    }
+    machine_description += prop;
+  }
+#endif  // BUILDFLAG(IS_ANDROID)
+
+  utsname uts;
+  if (uname(&uts) != 0) {
+    PLOG(WARNING) << "uname";
+  } else {
+    if (!os_version_full.empty()) {
+      os_version_full.push_back(' ');
+    }
+    os_version_full += base::StringPrintf(
+        "%s %s %s %s", uts.sysname, uts.release, uts.version, uts.machine);
+  }
+  ReadKernelVersion(uts.release);
+
+  if (!os_version_build.empty()) {
+    os_version_build.push_back(' ');
+  }
+  os_version_build += uts.version;
+  os_version_build.push_back(' ');
+  os_version_build += uts.machine;
+
+  if (!ReadCPUsOnline(&target_cpu, &cpu_count)) {
+    target_cpu = 0;
+    cpu_count = 0;
+  }
+}
+
+void SystemInfoCache::SystemInfo::ReadKernelVersion(
+    const std::string& version_string) {
+  std::vector<std::string> versions = SplitString(version_string, '.');
+  if (versions.size() < 3) {
+    LOG(WARNING) << "format error";
+    return;
+  }
+
+  if (!StringToInt(base::StringPiece(versions[0]), &os_version_major)) {
+    LOG(WARNING) << "no kernel version";
+    return;
+  }
+  DCHECK_GE(os_version_major, 3);
+
+  if (!StringToInt(base::StringPiece(versions[1]), &os_version_minor)) {
+    LOG(WARNING) << "no major revision";
+    return;
+  }
+  DCHECK_GE(os_version_minor, 0);
+
+  size_t minor_rev_end = versions[2].find_first_not_of("0123456789");
+  if (minor_rev_end == std::string::npos) {
+    minor_rev_end = versions[2].size();
+  }
+  if (!StringToInt(base::StringPiece(versions[2].c_str(), minor_rev_end),
+                   &os_version_bugfix)) {
+    LOG(WARNING) << "no minor revision";
+    return;
+  }
+  DCHECK_GE(os_version_bugfix, 0);
+
+  if (!os_version_build.empty()) {
+    os_version_build.push_back(' ');
+  }
+  os_version_build += versions[2].substr(minor_rev_end);
+}
+
+SystemInfoCache::SystemInfoCache(double max_age)
+    : system_info_(),
+      read_time_ns_(0),
+      lock_(),
+      max_age_ns_(static_cast<uint64_t>(max_age * 1E9)) {}
+
+SystemInfoCache::~SystemInfoCache() = default;
+
+std::shared_ptr<const SystemInfoCache::SystemInfo> SystemInfoCache::Get() {
+  base::AutoLock lock(lock_);
+  const uint64_t now_ns = ClockMonotonicNanoseconds();
+  if (!system_info_ || now_ns - read_time_ns_ >= max_age_ns_) {
+    auto system_info = std::make_shared<SystemInfo>();
+    system_info->Read();
+    system_info_ = std::move(system_info);
+    read_time_ns_ = now_ns;
+  }
+  return system_info_;
+}
+
+}  // namespace crashpad
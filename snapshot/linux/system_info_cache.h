@@ -0,0 +1,106 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_SNAPSHOT_LINUX_SYSTEM_INFO_CACHE_H_
+#define CRASHPAD_SNAPSHOT_LINUX_SYSTEM_INFO_CACHE_H_
+
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+
+#include "base/synchronization/lock.h"
+#include "build/build_config.h"
+
+#if defined(ARCH_CPU_X86_FAMILY)
+#include "snapshot/x86/cpuid_reader.h"
+#endif  // ARCH_CPU_X86_FAMILY
+
+namespace crashpad {
+
+//! \brief Keeps what internal::SystemSnapshotLinux reads about the system
+//!     between snapshots, so that later snapshots can skip reading it again.
+//!
+//! The system information is read again once it is older than the maximum age
+//! given to the constructor, so that changes such as CPUs coming online are
+//! eventually picked up.
+//!
+//! This class is thread-safe.
+class SystemInfoCache {
+ public:
+  //! \brief Information about the system that doesn’t depend on the process
+  //!     being snapshotted.
+  struct SystemInfo {
+    SystemInfo();
+    ~SystemInfo();
+
+    //! \brief Reads the information about the running system.
+    void Read();
+
+    //! \see SystemSnapshot::OSVersionFull
+    std::string os_version_full;
+
+    //! \brief The \a build output of SystemSnapshot::OSVersion.
+    std::string os_version_build;
+
+    //! \see SystemSnapshot::MachineDescription
+    std::string machine_description;
+
+    //! \brief The \a major output of SystemSnapshot::OSVersion, or `-1`.
+    int os_version_major;
+
+    //! \brief The \a minor output of SystemSnapshot::OSVersion, or `-1`.
+    int os_version_minor;
+
+    //! \brief The \a bugfix output of SystemSnapshot::OSVersion, or `-1`.
+    int os_version_bugfix;
+
+    //! \brief The number of the first CPU that is online.
+    uint32_t target_cpu;
+
+    //! \see SystemSnapshot::CPUCount
+    uint8_t cpu_count;
+
+#if defined(ARCH_CPU_X86_FAMILY)
+    //! \brief The results of `cpuid`.
+    internal::CpuidReader cpuid;
+#endif  // ARCH_CPU_X86_FAMILY
+
+   private:
+    void ReadKernelVersion(const std::string& version_string);
+  };
+
+  //! \param[in] max_age The number of seconds for which system information is
+  //!     kept before it is read again.
+  explicit SystemInfoCache(double max_age);
+
+  SystemInfoCache(const SystemInfoCache&) = delete;
+  SystemInfoCache& operator=(const SystemInfoCache&) = delete;
+
+  ~SystemInfoCache();
+
+  //! \brief Returns the system information, reading it first if it hasn’t been
+  //!     read yet or is older than the maximum age.
+  std::shared_ptr<const SystemInfo> Get();
+
+ private:
+  std::shared_ptr<const SystemInfo> system_info_;
+  uint64_t read_time_ns_;
+  base::Lock lock_;
+  const uint64_t max_age_ns_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_SNAPSHOT_LINUX_SYSTEM_INFO_CACHE_H_
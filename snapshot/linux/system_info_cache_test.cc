@@ -0,0 +1,60 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "snapshot/linux/system_info_cache.h"
+
+#include <memory>
+
+#include "gtest/gtest.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+TEST(SystemInfoCache, Get) {
+  SystemInfoCache cache(60 * 60);
+  std::shared_ptr<const SystemInfoCache::SystemInfo> system_info = cache.Get();
+  ASSERT_TRUE(system_info);
+
+  EXPECT_GT(system_info->cpu_count, 0u);
+  EXPECT_GE(system_info->os_version_major, 3);
+  EXPECT_FALSE(system_info->os_version_build.empty());
+  EXPECT_FALSE(system_info->os_version_full.empty());
+
+  // The information is kept until it’s older than the maximum age.
+  EXPECT_EQ(cache.Get(), system_info);
+
+  SystemInfoCache::SystemInfo read_info;
+  read_info.Read();
+  EXPECT_EQ(system_info->os_version_full, read_info.os_version_full);
+  EXPECT_EQ(system_info->os_version_build, read_info.os_version_build);
+  EXPECT_EQ(system_info->machine_description, read_info.machine_description);
+}
+
+TEST(SystemInfoCache, Expire) {
+  SystemInfoCache cache(0);
+  std::shared_ptr<const SystemInfoCache::SystemInfo> system_info = cache.Get();
+  ASSERT_TRUE(system_info);
+
+  // With no maximum age, the information is read again each time, and what was
+  // returned before remains valid.
+  std::shared_ptr<const SystemInfoCache::SystemInfo> reread_info = cache.Get();
+  ASSERT_TRUE(reread_info);
+  EXPECT_NE(reread_info, system_info);
+  EXPECT_EQ(reread_info->os_version_full, system_info->os_version_full);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
@@ -18,17 +18,15 @@
 #include <stdint.h>
 #include <time.h>
 
+#include <memory>
 #include <string>
 
 #include "build/build_config.h"
 #include "snapshot/linux/process_reader_linux.h"
+#include "snapshot/linux/system_info_cache.h"
 #include "snapshot/system_snapshot.h"
 #include "util/misc/initialization_state_dcheck.h"
 
-#if defined(ARCH_CPU_X86_FAMILY)
-#include "snapshot/x86/cpuid_reader.h"
-#endif  // ARCH_CPU_X86_FAMILY
-
 namespace crashpad {
 namespace internal {
 
@@ -60,8 +58,12 @@ class SystemSnapshotLinux final : public SystemSnapshot {
   //!     Otherwise, it would need to base its determination on the current
   //!     time, which may be different than the snapshot time for snapshots
   //!     generated around the daylight saving transition time.
+  //! \param[in] system_info_cache A cache of what earlier snapshots read about
+  //!     the system. Optional. Without it, the system information is read for
+  //!     this snapshot alone.
   void Initialize(ProcessReaderLinux* process_reader,
-                  const timeval* snapshot_time);
+                  const timeval* snapshot_time,
+                  SystemInfoCache* system_info_cache = nullptr);
 
   // SystemSnapshot:
 
@@ -91,20 +93,9 @@ class SystemSnapshotLinux final : public SystemSnapshot {
                 std::string* daylight_name) const override;
 
  private:
-  void ReadKernelVersion(const std::string& version_string);
-
-  std::string os_version_full_;
-  std::string os_version_build_;
+  std::shared_ptr<const SystemInfoCache::SystemInfo> system_info_;
   ProcessReaderLinux* process_reader_;  // weak
   const timeval* snapshot_time_;  // weak
-#if defined(ARCH_CPU_X86_FAMILY)
-  CpuidReader cpuid_;
-#endif  // ARCH_CPU_X86_FAMILY
-  int os_version_major_;
-  int os_version_minor_;
-  int os_version_bugfix_;
-  uint32_t target_cpu_;
-  uint8_t cpu_count_;
   InitializationStateDcheck initialized_;
 };
 
@@ -16,6 +16,9 @@
 
 #include <sched.h>
 
+#include <algorithm>
+#include <utility>
+
 #include "base/logging.h"
 #include "snapshot/linux/capture_memory_delegate_linux.h"
 #include "snapshot/linux/cpu_context_linux.h"
@@ -125,6 +128,26 @@ int ComputeThreadPriority(int static_priority,
   return priority;
 }
 
+// Returns the frame pointer from context, or 0 if the architecture doesn’t
+// conventionally chain frame records through a register.
+uint64_t FramePointer(const CPUContext& context) {
+  switch (context.architecture) {
+#if defined(ARCH_CPU_X86_FAMILY)
+    case kCPUArchitectureX86:
+      return context.x86->ebp;
+    case kCPUArchitectureX86_64:
+      return context.x86_64->rbp;
+#elif defined(ARCH_CPU_ARM_FAMILY)
+    case kCPUArchitectureARM:
+      return context.arm->fp;
+    case kCPUArchitectureARM64:
+      return context.arm64->regs[29];
+#endif
+    default:
+      return 0;
+  }
+}
+
 }  // namespace
 
 ThreadSnapshotLinux::ThreadSnapshotLinux()
@@ -133,6 +156,7 @@ ThreadSnapshotLinux::ThreadSnapshotLinux()
       context_(),
       stack_(),
       thread_specific_data_address_(0),
+      uncaptured_stack_size_(0),
       thread_name_(),
       thread_id_(-1),
       priority_(-1),
@@ -143,7 +167,10 @@ ThreadSnapshotLinux::~ThreadSnapshotLinux() {}
 bool ThreadSnapshotLinux::Initialize(
     ProcessReaderLinux* process_reader,
     const ProcessReaderLinux::Thread& thread,
-    uint32_t* gather_indirectly_referenced_memory_bytes_remaining) {
+    CaptureMemoryPlanLinux* capture_memory_plan,
+    uint32_t stack_capture_limit,
+    uint32_t stack_frame_window_size,
+    StackUnwinderLinux* stack_unwinder) {
   INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
 
 #if defined(ARCH_CPU_X86_FAMILY)
@@ -194,9 +221,46 @@ bool ThreadSnapshotLinux::Initialize(
 #error Port.
 #endif
 
-  stack_.Initialize(process_reader->Memory(),
-                    thread.stack_region_address,
-                    thread.stack_region_size);
+  // Nothing beyond the outermost frame is in use, so once unwinding has found
+  // it, the rest of the stack region is left out. The margin keeps anything
+  // the outermost function reads just beyond its frame, such as its arguments
+  // on x86.
+  LinuxVMSize live_stack_size = thread.stack_region_size;
+  if (stack_unwinder) {
+    std::vector<StackUnwinderLinux::Frame> frames;
+    LinuxVMAddress live_stack_end;
+    if (stack_unwinder->Unwind(
+            context_,
+            thread.stack_region_address,
+            thread.stack_region_address + thread.stack_region_size,
+            &frames,
+            &live_stack_end)) {
+      constexpr LinuxVMSize kLiveStackMargin = 512;
+      live_stack_size = std::min(
+          live_stack_size,
+          live_stack_end - thread.stack_region_address + kLiveStackMargin);
+    }
+    unwound_frames_.reserve(frames.size());
+    for (const StackUnwinderLinux::Frame& frame : frames) {
+      unwound_frames_.push_back(frame.instruction_pointer);
+    }
+  }
+
+  // The part of the stack nearest the stack pointer holds the innermost
+  // frames, so that is what is kept when the stack is larger than the limit.
+  LinuxVMSize stack_size = live_stack_size;
+  if (stack_capture_limit && stack_size > stack_capture_limit) {
+    stack_size = stack_capture_limit;
+    uncaptured_stack_size_ = live_stack_size - stack_size;
+  }
+  stack_.Initialize(
+      process_reader->Memory(), thread.stack_region_address, stack_size);
+  if (uncaptured_stack_size_ && stack_frame_window_size) {
+    CaptureFrameWindows(process_reader,
+                        thread.stack_region_address + stack_size,
+                        thread.stack_region_address + live_stack_size,
+                        stack_frame_window_size);
+  }
 
   thread_specific_data_address_ =
       thread.thread_info.thread_specific_data_address;
@@ -210,12 +274,24 @@ bool ThreadSnapshotLinux::Initialize(
                 thread.static_priority, thread.sched_policy, thread.nice_value)
           : -1;
 
-  CaptureMemoryDelegateLinux capture_memory_delegate(
-      process_reader,
-      &thread,
-      &pointed_to_memory_,
-      gather_indirectly_referenced_memory_bytes_remaining);
-  CaptureMemory::PointedToByContext(context_, &capture_memory_delegate);
+  if (capture_memory_plan) {
+    CaptureMemoryDelegateLinux capture_memory_delegate(process_reader,
+                                                       &thread,
+                                                       thread.tid,
+                                                       &pointed_to_memory_,
+                                                       capture_memory_plan);
+    CaptureMemory::PointedToByContext(context_, &capture_memory_delegate);
+
+    // The stack pointer is normally aligned, but a thread stopped at an
+    // arbitrary instruction may have it misaligned for a moment. Its stack
+    // can’t be scanned in that case.
+    const size_t pointer_size =
+        process_reader->Is64Bit() ? sizeof(uint64_t) : sizeof(uint32_t);
+    if (stack_.Address() % pointer_size == 0 &&
+        stack_.Size() % pointer_size == 0) {
+      CaptureMemory::PointedToByMemoryRange(stack_, &capture_memory_delegate);
+    }
+  }
 
   INITIALIZATION_STATE_SET_VALID(initialized_);
   return true;
@@ -259,12 +335,90 @@ uint64_t ThreadSnapshotLinux::ThreadSpecificDataAddress() const {
 std::vector<const MemorySnapshot*> ThreadSnapshotLinux::ExtraMemory() const {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
   std::vector<const MemorySnapshot*> result;
-  result.reserve(pointed_to_memory_.size());
+  result.reserve(pointed_to_memory_.size() + frame_windows_.size());
   for (const auto& pointed_to_memory : pointed_to_memory_) {
     result.push_back(pointed_to_memory.get());
   }
+  for (const auto& frame_window : frame_windows_) {
+    result.push_back(frame_window.get());
+  }
   return result;
 }
 
+uint64_t ThreadSnapshotLinux::UncapturedStackSize() const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  return uncaptured_stack_size_;
+}
+
+std::vector<uint64_t> ThreadSnapshotLinux::UnwoundFrames() const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  return unwound_frames_;
+}
+
+void ThreadSnapshotLinux::CaptureFrameWindows(
+    ProcessReaderLinux* process_reader,
+    LinuxVMAddress window_start,
+    LinuxVMAddress stack_end,
+    LinuxVMSize window_size) {
+  // Frames are followed no further than this, so that a corrupt or cyclic
+  // chain can’t capture an unbounded number of windows.
+  constexpr size_t kMaxFrames = 1024;
+
+  const bool is_64_bit = process_reader->Is64Bit();
+  const LinuxVMSize pointer_size = is_64_bit ? sizeof(uint64_t)
+                                             : sizeof(uint32_t);
+
+  // Each frame record begins with the caller’s frame pointer. Callers’ frames
+  // are at higher addresses, so the chain must strictly ascend. Windows that
+  // meet are merged into one region.
+  std::vector<std::pair<LinuxVMAddress, LinuxVMAddress>> windows;
+  LinuxVMAddress captured_end = window_start;
+  LinuxVMAddress frame =
+      process_reader->PointerToAddress(FramePointer(context_));
+  for (size_t frame_count = 0;
+       frame_count < kMaxFrames && frame % pointer_size == 0 &&
+       frame >= stack_.Address() && frame < stack_end &&
+       stack_end - frame >= 2 * pointer_size;
+       ++frame_count) {
+    const LinuxVMAddress end = frame + std::min(window_size, stack_end - frame);
+    if (end > captured_end) {
+      const LinuxVMAddress base = std::max(frame, captured_end);
+      if (!windows.empty() && windows.back().second == base) {
+        windows.back().second = end;
+      } else {
+        windows.emplace_back(base, end);
+      }
+      captured_end = end;
+    }
+
+    LinuxVMAddress next_frame;
+    if (is_64_bit) {
+      uint64_t value;
+      if (!process_reader->Memory()->Read(frame, sizeof(value), &value)) {
+        break;
+      }
+      next_frame = value;
+    } else {
+      uint32_t value;
+      if (!process_reader->Memory()->Read(frame, sizeof(value), &value)) {
+        break;
+      }
+      next_frame = value;
+    }
+    next_frame = process_reader->PointerToAddress(next_frame);
+    if (next_frame <= frame) {
+      break;
+    }
+    frame = next_frame;
+  }
+
+  for (const auto& window : windows) {
+    frame_windows_.push_back(std::make_unique<MemorySnapshotGeneric>());
+    frame_windows_.back()->Initialize(process_reader->Memory(),
+                                      window.first,
+                                      window.second - window.first);
+  }
+}
+
 }  // namespace internal
 }  // namespace crashpad
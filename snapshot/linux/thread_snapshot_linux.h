@@ -17,9 +17,13 @@
 
 #include <stdint.h>
 
+#include <vector>
+
 #include "build/build_config.h"
 #include "snapshot/cpu_context.h"
+#include "snapshot/linux/capture_memory_plan_linux.h"
 #include "snapshot/linux/process_reader_linux.h"
+#include "snapshot/linux/stack_unwinder_linux.h"
 #include "snapshot/memory_snapshot.h"
 #include "snapshot/memory_snapshot_generic.h"
 #include "snapshot/thread_snapshot.h"
@@ -44,13 +48,31 @@ class ThreadSnapshotLinux final : public ThreadSnapshot {
   //!     the thread.
   //! \param[in] thread The thread within the ProcessReaderLinux for
   //!     which the snapshot should be created.
+  //! \param[in] capture_memory_plan The plan to add the memory pointed to by
+  //!     the thread’s registers and stack to, or `nullptr` if no such memory
+  //!     should be captured. The memory is captured when the plan’s
+  //!     CaptureMemoryPlanLinux::Capture() is called.
+  //! \param[in] stack_capture_limit The maximum number of bytes of the
+  //!     thread’s stack to capture, or `0` for no limit.
+  //! \param[in] stack_frame_window_size The number of bytes to capture at each
+  //!     frame record found beyond \a stack_capture_limit by following the
+  //!     frame pointer chain, or `0` to capture nothing beyond it.
+  //! \param[in] stack_unwinder An unwinder to walk the thread’s stack with, or
+  //!     `nullptr` to not unwind it. When the outermost frame is reached, only
+  //!     the live part of the stack is captured, up to a small margin beyond
+  //!     that frame, and the frames found are returned by UnwoundFrames().
   //!
   //! \return `true` if the snapshot could be created, `false` otherwise with
   //!     a message logged.
+  //!
+  //! \sa CrashpadInfo::set_stack_capture_limit()
   bool Initialize(
       ProcessReaderLinux* process_reader,
       const ProcessReaderLinux::Thread& thread,
-      uint32_t* gather_indirectly_referenced_memory_bytes_remaining);
+      CaptureMemoryPlanLinux* capture_memory_plan,
+      uint32_t stack_capture_limit = 0,
+      uint32_t stack_frame_window_size = 0,
+      StackUnwinderLinux* stack_unwinder = nullptr);
 
   // ThreadSnapshot:
 
@@ -62,8 +84,18 @@ class ThreadSnapshotLinux final : public ThreadSnapshot {
   int Priority() const override;
   uint64_t ThreadSpecificDataAddress() const override;
   std::vector<const MemorySnapshot*> ExtraMemory() const override;
+  uint64_t UncapturedStackSize() const override;
+  std::vector<uint64_t> UnwoundFrames() const override;
 
  private:
+  // Follows the frame pointer chain from the frame pointer in context_ through
+  // [stack_.Address(), stack_end), adding a window of window_size bytes to
+  // frame_windows_ for each frame record found at or beyond window_start.
+  void CaptureFrameWindows(ProcessReaderLinux* process_reader,
+                           LinuxVMAddress window_start,
+                           LinuxVMAddress stack_end,
+                           LinuxVMSize window_size);
+
   union {
 #if defined(ARCH_CPU_X86_FAMILY)
     CPUContextX86 x86;
@@ -81,11 +113,14 @@ class ThreadSnapshotLinux final : public ThreadSnapshot {
   CPUContext context_;
   MemorySnapshotGeneric stack_;
   LinuxVMAddress thread_specific_data_address_;
+  LinuxVMSize uncaptured_stack_size_;
   std::string thread_name_;
   pid_t thread_id_;
   int priority_;
   InitializationStateDcheck initialized_;
   std::vector<std::unique_ptr<MemorySnapshotGeneric>> pointed_to_memory_;
+  std::vector<std::unique_ptr<MemorySnapshotGeneric>> frame_windows_;
+  std::vector<uint64_t> unwound_frames_;
 };
 
 }  // namespace internal
@@ -207,13 +207,31 @@ void MachOImageAnnotationsReader::ReadCrashpadAnnotationsList(
       return;
     }
 
-    if (current.size == 0) {
+    mach_vm_address_t value_address = current.value;
+    uint32_t value_size = current.size;
+    if (current.flags & Annotation::kFlagVersioned) {
+      VersionedAnnotationHeader header;
+      if (!process_reader_->Memory()->Read(
+              current.value - sizeof(header), sizeof(header), &header)) {
+        LOG(WARNING) << "could not read annotation header at index " << index
+                     << " in " << name_;
+        continue;
+      }
+
+      uint32_t value_offset;
+      if (!header.GetValueLocation(current.size, &value_offset, &value_size)) {
+        LOG(WARNING) << "invalid annotation header at index " << index
+                     << " in " << name_;
+      }
+      value_address += value_offset;
+    }
+
+    if (value_size == 0) {
       continue;
     }
 
     AnnotationSnapshot snapshot;
     snapshot.type = current.type;
-    snapshot.value.resize(current.size);
 
     if (!process_reader_->Memory()->ReadCStringSizeLimited(
             current.name, Annotation::kNameMaxLength, &snapshot.name)) {
@@ -223,9 +241,10 @@ void MachOImageAnnotationsReader::ReadCrashpadAnnotationsList(
     }
 
     size_t size =
-        std::min(static_cast<size_t>(current.size), Annotation::kValueMaxSize);
+        std::min(static_cast<size_t>(value_size), Annotation::kValueMaxSize);
+    snapshot.value.resize(size);
     if (!process_reader_->Memory()->Read(
-            current.value, size, snapshot.value.data())) {
+            value_address, size, snapshot.value.data())) {
       LOG(WARNING) << "could not read annotation value at index " << index
                    << " in " << name_;
       continue;
@@ -0,0 +1,77 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "snapshot/mac/mach_o_image_header_cache.h"
+
+#include "base/check.h"
+
+namespace crashpad {
+
+MachOImageHeaderCache::MachOImageHeaderCache(size_t max_bytes)
+    : entries_(), index_(), lock_(), max_bytes_(max_bytes), bytes_(0) {}
+
+MachOImageHeaderCache::~MachOImageHeaderCache() = default;
+
+std::shared_ptr<const MachOImageHeaderCache::Header>
+MachOImageHeaderCache::Find(const UUID& shared_cache_uuid, uint64_t offset) {
+  base::AutoLock lock(lock_);
+  auto iterator = index_.find(Key(shared_cache_uuid, offset));
+  if (iterator == index_.end()) {
+    return nullptr;
+  }
+
+  entries_.splice(entries_.begin(), entries_, iterator->second);
+  return iterator->second->header;
+}
+
+void MachOImageHeaderCache::Insert(const UUID& shared_cache_uuid,
+                                   uint64_t offset,
+                                   std::shared_ptr<const Header> header) {
+  DCHECK(header && !header->empty());
+
+  const size_t entry_size = EntrySize(*header);
+  if (entry_size > max_bytes_) {
+    return;
+  }
+
+  const Key key(shared_cache_uuid, offset);
+
+  base::AutoLock lock(lock_);
+  auto iterator = index_.find(key);
+  if (iterator != index_.end()) {
+    bytes_ -= EntrySize(*iterator->second->header);
+    index_.erase(iterator->second->key);
+    entries_.erase(iterator->second);
+  }
+
+  while (bytes_ + entry_size > max_bytes_) {
+    const Entry& oldest = entries_.back();
+    bytes_ -= EntrySize(*oldest.header);
+    index_.erase(oldest.key);
+    entries_.pop_back();
+  }
+
+  entries_.push_front(Entry{key, std::move(header)});
+  index_[key] = entries_.begin();
+  bytes_ += entry_size;
+}
+
+// static
+size_t MachOImageHeaderCache::EntrySize(const Header& header) {
+  // The key is stored in both the entry and the index.
+  return sizeof(Entry) + sizeof(Key) + sizeof(EntryList::iterator) +
+         sizeof(Header) + header.size();
+}
+
+}  // namespace crashpad
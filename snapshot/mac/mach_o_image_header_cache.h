@@ -0,0 +1,102 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_SNAPSHOT_MAC_MACH_O_IMAGE_HEADER_CACHE_H_
+#define CRASHPAD_SNAPSHOT_MAC_MACH_O_IMAGE_HEADER_CACHE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <list>
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "base/synchronization/lock.h"
+#include "util/misc/uuid.h"
+
+namespace crashpad {
+
+//! \brief Keeps the Mach-O headers and load commands of images in the dyld
+//!     shared cache, keyed by the shared cache’s UUID and the image’s offset
+//!     within it.
+//!
+//! An image in the shared cache has the same header and load commands in
+//! every process that maps the same shared cache, wherever the cache is slid
+//! to, so processes can share what one of them read. MachOImageReader parses
+//! the kept bytes instead of reading them from each process again, leaving
+//! mostly the process’ own images to be read per crash. The least recently
+//! used images are dropped once the cache reaches its memory cap.
+//!
+//! This class is thread-safe.
+class MachOImageHeaderCache {
+ public:
+  //! \brief An image’s `mach_header` and the load commands that follow it.
+  using Header = std::vector<uint8_t>;
+
+  //! \param[in] max_bytes About how much memory the cache may use.
+  explicit MachOImageHeaderCache(size_t max_bytes);
+
+  MachOImageHeaderCache(const MachOImageHeaderCache&) = delete;
+  MachOImageHeaderCache& operator=(const MachOImageHeaderCache&) = delete;
+
+  ~MachOImageHeaderCache();
+
+  //! \brief Finds an image’s header.
+  //!
+  //! \param[in] shared_cache_uuid The UUID of the shared cache containing the
+  //!     image.
+  //! \param[in] offset The offset of the image’s `mach_header` from the start
+  //!     of the shared cache.
+  //!
+  //! \return The image’s header, or `nullptr` if it isn’t cached.
+  std::shared_ptr<const Header> Find(const UUID& shared_cache_uuid,
+                                     uint64_t offset);
+
+  //! \brief Records an image’s header, replacing anything recorded before.
+  //!
+  //! \param[in] shared_cache_uuid The UUID of the shared cache containing the
+  //!     image.
+  //! \param[in] offset The offset of the image’s `mach_header` from the start
+  //!     of the shared cache.
+  //! \param[in] header The image’s header, which must not be empty.
+  void Insert(const UUID& shared_cache_uuid,
+              uint64_t offset,
+              std::shared_ptr<const Header> header);
+
+ private:
+  using Key = std::pair<UUID, uint64_t>;
+
+  struct Entry {
+    Key key;
+    std::shared_ptr<const Header> header;
+  };
+
+  using EntryList = std::list<Entry>;
+
+  // The approximate memory used by an entry for header.
+  static size_t EntrySize(const Header& header);
+
+  // Ordered from most to least recently used.
+  EntryList entries_;
+  std::map<Key, EntryList::iterator> index_;
+  base::Lock lock_;
+  const size_t max_bytes_;
+  size_t bytes_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_SNAPSHOT_MAC_MACH_O_IMAGE_HEADER_CACHE_H_
@@ -0,0 +1,109 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "snapshot/mac/mach_o_image_header_cache.h"
+
+#include "gtest/gtest.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+UUID SharedCacheUUID(uint8_t value) {
+  uint8_t bytes[16];
+  for (size_t index = 0; index < sizeof(bytes); ++index) {
+    bytes[index] = value;
+  }
+  UUID uuid;
+  uuid.InitializeFromBytes(bytes);
+  return uuid;
+}
+
+std::shared_ptr<const MachOImageHeaderCache::Header> Header(size_t size,
+                                                            uint8_t value) {
+  return std::make_shared<const MachOImageHeaderCache::Header>(size, value);
+}
+
+TEST(MachOImageHeaderCache, FindAndInsert) {
+  MachOImageHeaderCache cache(64 * 1024);
+  EXPECT_FALSE(cache.Find(SharedCacheUUID(1), 0x1000));
+
+  cache.Insert(SharedCacheUUID(1), 0x1000, Header(0x800, 1));
+  cache.Insert(SharedCacheUUID(1), 0x2000, Header(0x400, 2));
+  cache.Insert(SharedCacheUUID(2), 0x1000, Header(0x200, 3));
+
+  std::shared_ptr<const MachOImageHeaderCache::Header> header =
+      cache.Find(SharedCacheUUID(1), 0x1000);
+  ASSERT_TRUE(header);
+  EXPECT_EQ(header->size(), 0x800u);
+  EXPECT_EQ(header->front(), 1);
+
+  header = cache.Find(SharedCacheUUID(1), 0x2000);
+  ASSERT_TRUE(header);
+  EXPECT_EQ(header->front(), 2);
+
+  // The same offset in a different shared cache is a different image.
+  header = cache.Find(SharedCacheUUID(2), 0x1000);
+  ASSERT_TRUE(header);
+  EXPECT_EQ(header->front(), 3);
+
+  EXPECT_FALSE(cache.Find(SharedCacheUUID(2), 0x2000));
+  EXPECT_FALSE(cache.Find(SharedCacheUUID(3), 0x1000));
+
+  cache.Insert(SharedCacheUUID(1), 0x1000, Header(0x100, 4));
+  header = cache.Find(SharedCacheUUID(1), 0x1000);
+  ASSERT_TRUE(header);
+  EXPECT_EQ(header->size(), 0x100u);
+  EXPECT_EQ(header->front(), 4);
+}
+
+TEST(MachOImageHeaderCache, EvictsLeastRecentlyUsed) {
+  // Room for about two of the headers below.
+  MachOImageHeaderCache cache(2 * 0x1000 + 0x800);
+
+  cache.Insert(SharedCacheUUID(1), 0x1000, Header(0x1000, 1));
+  cache.Insert(SharedCacheUUID(1), 0x2000, Header(0x1000, 2));
+  EXPECT_TRUE(cache.Find(SharedCacheUUID(1), 0x1000));
+
+  // 0x2000 is the least recently used and is dropped to make room for 0x3000.
+  cache.Insert(SharedCacheUUID(1), 0x3000, Header(0x1000, 3));
+  EXPECT_TRUE(cache.Find(SharedCacheUUID(1), 0x1000));
+  EXPECT_FALSE(cache.Find(SharedCacheUUID(1), 0x2000));
+  EXPECT_TRUE(cache.Find(SharedCacheUUID(1), 0x3000));
+}
+
+TEST(MachOImageHeaderCache, HeaderLargerThanCache) {
+  MachOImageHeaderCache cache(0x800);
+  cache.Insert(SharedCacheUUID(1), 0x1000, Header(0x1000, 1));
+  EXPECT_FALSE(cache.Find(SharedCacheUUID(1), 0x1000));
+}
+
+TEST(MachOImageHeaderCache, HeaderOutlivesEviction) {
+  MachOImageHeaderCache cache(0x1000 + 0x800);
+  cache.Insert(SharedCacheUUID(1), 0x1000, Header(0x1000, 1));
+  std::shared_ptr<const MachOImageHeaderCache::Header> header =
+      cache.Find(SharedCacheUUID(1), 0x1000);
+  ASSERT_TRUE(header);
+
+  cache.Insert(SharedCacheUUID(1), 0x2000, Header(0x1000, 2));
+  EXPECT_FALSE(cache.Find(SharedCacheUUID(1), 0x1000));
+
+  // A reader that found the header before it was dropped can still use it.
+  EXPECT_EQ(header->size(), 0x1000u);
+  EXPECT_EQ(header->front(), 1);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
@@ -48,6 +48,7 @@ MachOImageReader::MachOImageReader()
       uuid_(),
       address_(0),
       size_(0),
+      header_size_(0),
       slide_(0),
       source_version_(0),
       symtab_command_(),
@@ -56,6 +57,7 @@ MachOImageReader::MachOImageReader()
       id_dylib_command_(),
       process_reader_(nullptr),
       file_type_(0),
+      flags_(0),
       initialized_(),
       symbol_table_initialized_() {
 }
@@ -103,6 +105,9 @@ bool MachOImageReader::Initialize(ProcessReaderMac* process_reader,
       return false;
   }
 
+  flags_ = mach_header.flags;
+  header_size_ = mach_header.Size() + mach_header.sizeofcmds;
+
   const uint32_t kExpectedSegmentCommand =
       is_64_bit ? LC_SEGMENT_64 : LC_SEGMENT;
   const uint32_t kUnexpectedSegmentCommand =
@@ -311,6 +316,11 @@ bool MachOImageReader::Initialize(ProcessReaderMac* process_reader,
   return true;
 }
 
+bool MachOImageReader::InSharedCache() const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  return (flags_ & MH_DYLIB_IN_CACHE) != 0;
+}
+
 const MachOImageSegmentReader* MachOImageReader::GetSegmentByName(
     const std::string& segment_name) const {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
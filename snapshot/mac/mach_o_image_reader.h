@@ -78,6 +78,17 @@ class MachOImageReader {
   //! `MH_DYLINKER`, and `MH_BUNDLE`.
   uint32_t FileType() const { return file_type_; }
 
+  //! \brief Returns whether the Mach-O image is in the dyld shared cache.
+  //!
+  //! This is determined by the `MH_DYLIB_IN_CACHE` flag in the `mach_header`
+  //! or `mach_header_64`, which is set on images in the shared cache starting
+  //! in macOS 11.
+  bool InSharedCache() const;
+
+  //! \brief Returns the size of the Mach-O image’s `mach_header` or
+  //!     `mach_header_64` together with the load commands that follow it.
+  mach_vm_size_t HeaderSize() const { return header_size_; }
+
   //! \brief Returns the Mach-O image’s load address.
   //!
   //! This is the value passed as \a address to Initialize().
@@ -328,6 +339,7 @@ class MachOImageReader {
   crashpad::UUID uuid_;
   mach_vm_address_t address_;
   mach_vm_size_t size_;
+  mach_vm_size_t header_size_;
   mach_vm_size_t slide_;
   uint64_t source_version_;
   std::unique_ptr<process_types::symtab_command> symtab_command_;
@@ -342,6 +354,7 @@ class MachOImageReader {
   std::unique_ptr<process_types::dylib_command> id_dylib_command_;
   ProcessReaderMac* process_reader_;  // weak
   uint32_t file_type_;
+  uint32_t flags_;
   InitializationStateDcheck initialized_;
 
   // symbol_table_initialized_ protects symbol_table_: symbol_table_ can only
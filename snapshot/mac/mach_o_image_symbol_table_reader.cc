@@ -60,56 +60,29 @@ class MachOImageSymbolTableReaderInitializer {
 
   ~MachOImageSymbolTableReaderInitializer() {}
 
-  //! \brief Reads the symbol table from another process.
+  //! \brief Reads every external defined symbol from another process.
   //!
   //! \sa MachOImageSymbolTableReader::Initialize()
   bool Initialize(const process_types::symtab_command* symtab_command,
                   const process_types::dysymtab_command* dysymtab_command,
                   MachOImageSymbolTableReader::SymbolInformationMap*
                       external_defined_symbols) {
-    mach_vm_address_t symtab_address =
-        AddressForLinkEditComponent(symtab_command->symoff);
-    uint32_t symbol_count = symtab_command->nsyms;
-    size_t nlist_size = process_types::nlist::ExpectedSize(process_reader_);
-    mach_vm_size_t symtab_size = symbol_count * nlist_size;
-    if (!IsInLinkEditSegment(symtab_address, symtab_size, "symtab")) {
+    MachOImageSymbolTableReader::ExternalDefinedSymbolIndex index;
+    uint32_t skip_count;
+    if (!LocateExternalDefinedSymbols(
+            symtab_command, dysymtab_command, &index, &skip_count)) {
       return false;
     }
 
-    // If a dysymtab is present, use it to filter the symtab for just the
-    // portion used for extdefsym. If no dysymtab is present, the entire symtab
-    // will need to be consulted.
-    uint32_t skip_count = 0;
-    if (dysymtab_command) {
-      if (dysymtab_command->iextdefsym >= symtab_command->nsyms ||
-          dysymtab_command->iextdefsym + dysymtab_command->nextdefsym >
-              symtab_command->nsyms) {
-        LOG(WARNING) << base::StringPrintf(
-                            "dysymtab extdefsym %u + %u > symtab nsyms %u",
-                            dysymtab_command->iextdefsym,
-                            dysymtab_command->nextdefsym,
-                            symtab_command->nsyms) << module_info_;
-        return false;
-      }
-
-      skip_count = dysymtab_command->iextdefsym;
-      mach_vm_size_t skip_size = skip_count * nlist_size;
-      symtab_address += skip_size;
-      symtab_size -= skip_size;
-      symbol_count = dysymtab_command->nextdefsym;
-    }
-
-    mach_vm_address_t strtab_address =
-        AddressForLinkEditComponent(symtab_command->stroff);
-    mach_vm_size_t strtab_size = symtab_command->strsize;
-    if (!IsInLinkEditSegment(strtab_address, strtab_size, "strtab")) {
-      return false;
-    }
+    const uint32_t symbol_count = index.symbol_count;
+    const mach_vm_size_t strtab_size = index.strtab_size;
 
     std::unique_ptr<process_types::nlist[]> symbols(
-        new process_types::nlist[symtab_command->nsyms]);
-    if (!process_types::nlist::ReadArrayInto(
-            process_reader_, symtab_address, symbol_count, &symbols[0])) {
+        new process_types::nlist[symbol_count]);
+    if (!process_types::nlist::ReadArrayInto(process_reader_,
+                                             index.symbols_address,
+                                             symbol_count,
+                                             &symbols[0])) {
       LOG(WARNING) << "could not read symbol table" << module_info_;
       return false;
     }
@@ -135,7 +108,7 @@ class MachOImageSymbolTableReaderInitializer {
 
           if (!string_table) {
             string_table = process_reader_->Memory()->ReadMapped(
-                strtab_address, strtab_size);
+                index.strtab_address, strtab_size);
             if (!string_table) {
               LOG(WARNING) << "could not read string table" << module_info_;
               return false;
@@ -194,7 +167,171 @@ class MachOImageSymbolTableReaderInitializer {
     return true;
   }
 
+  //! \brief Locates the external defined symbols and the string table in
+  //!     another process, without reading them.
+  //!
+  //! If a dysymtab is present, it identifies the portion of the symtab used
+  //! for extdefsym. If no dysymtab is present, the entire symtab will need to
+  //! be consulted.
+  //!
+  //! \param[in] symtab_command The `LC_SYMTAB` load command.
+  //! \param[in] dysymtab_command The `LC_DYSYMTAB` load command, or `nullptr`.
+  //! \param[out] index The location of the symbols and strings.
+  //! \param[out] skip_count The index in the symtab of the first symbol in
+  //!     \a index.
+  //!
+  //! \return `true` on success. `false` on failure, with a message logged.
+  bool LocateExternalDefinedSymbols(
+      const process_types::symtab_command* symtab_command,
+      const process_types::dysymtab_command* dysymtab_command,
+      MachOImageSymbolTableReader::ExternalDefinedSymbolIndex* index,
+      uint32_t* skip_count) {
+    mach_vm_address_t symtab_address =
+        AddressForLinkEditComponent(symtab_command->symoff);
+    uint32_t symbol_count = symtab_command->nsyms;
+    size_t nlist_size = process_types::nlist::ExpectedSize(process_reader_);
+    mach_vm_size_t symtab_size = symbol_count * nlist_size;
+    if (!IsInLinkEditSegment(symtab_address, symtab_size, "symtab")) {
+      return false;
+    }
+
+    *skip_count = 0;
+    if (dysymtab_command) {
+      if (dysymtab_command->iextdefsym >= symtab_command->nsyms ||
+          dysymtab_command->iextdefsym + dysymtab_command->nextdefsym >
+              symtab_command->nsyms) {
+        LOG(WARNING) << base::StringPrintf(
+                            "dysymtab extdefsym %u + %u > symtab nsyms %u",
+                            dysymtab_command->iextdefsym,
+                            dysymtab_command->nextdefsym,
+                            symtab_command->nsyms) << module_info_;
+        return false;
+      }
+
+      *skip_count = dysymtab_command->iextdefsym;
+      symtab_address += *skip_count * nlist_size;
+      symbol_count = dysymtab_command->nextdefsym;
+    }
+
+    mach_vm_address_t strtab_address =
+        AddressForLinkEditComponent(symtab_command->stroff);
+    mach_vm_size_t strtab_size = symtab_command->strsize;
+    if (!IsInLinkEditSegment(strtab_address, strtab_size, "strtab")) {
+      return false;
+    }
+
+    index->symbols_address = symtab_address;
+    index->symbol_count = symbol_count;
+    index->strtab_address = strtab_address;
+    index->strtab_size = strtab_size;
+    return true;
+  }
+
+  //! \brief Looks up an external defined symbol by binary search of symbols
+  //!     sorted by name.
+  //!
+  //! Only the symbols and names visited by the search are read.
+  //!
+  //! \param[in] index The symbols to search, as located by
+  //!     LocateExternalDefinedSymbols() from an `LC_DYSYMTAB`.
+  //! \param[in] name The name of the symbol to look up.
+  //! \param[out] symbol_info Information about the symbol, if \a found.
+  //! \param[out] found Whether the symbol was found.
+  //!
+  //! \return `true` if the search completed, with \a found set. `false` if
+  //!     the symbols were found not to be sorted, or if something unexpected
+  //!     was read, in which case every symbol should be read instead to
+  //!     diagnose the problem.
+  bool SearchExternalDefinedSymbols(
+      const MachOImageSymbolTableReader::ExternalDefinedSymbolIndex& index,
+      const std::string& name,
+      MachOImageSymbolTableReader::SymbolInformation* symbol_info,
+      bool* found) {
+    *found = false;
+
+    const size_t nlist_size =
+        process_types::nlist::ExpectedSize(process_reader_);
+
+    // The names of the symbols just outside of [low, high), when they’ve been
+    // read. A name that doesn’t fall strictly between them means that the
+    // symbols aren’t sorted.
+    std::string low_name;
+    std::string high_name;
+    uint32_t low = 0;
+    uint32_t high = index.symbol_count;
+    while (low < high) {
+      const uint32_t middle = low + (high - low) / 2;
+
+      process_types::nlist symbol;
+      if (!symbol.Read(process_reader_,
+                       index.symbols_address + middle * nlist_size) ||
+          symbol.n_strx >= index.strtab_size) {
+        return false;
+      }
+
+      std::string symbol_name;
+      if (!process_reader_->Memory()->ReadCStringSizeLimited(
+              index.strtab_address + symbol.n_strx,
+              index.strtab_size - symbol.n_strx,
+              &symbol_name)) {
+        return false;
+      }
+
+      if ((low > 0 && symbol_name <= low_name) ||
+          (high < index.symbol_count && symbol_name >= high_name)) {
+        return false;
+      }
+
+      const int comparison = symbol_name.compare(name);
+      if (comparison < 0) {
+        low = middle + 1;
+        low_name = std::move(symbol_name);
+      } else if (comparison > 0) {
+        high = middle;
+        high_name = std::move(symbol_name);
+      } else {
+        return ExternalDefinedSymbolInformation(symbol, symbol_info, found);
+      }
+    }
+
+    return true;
+  }
+
  private:
+  //! \brief Converts an `nlist` found in the extdefsym portion of the symtab
+  //!     to a SymbolInformation.
+  //!
+  //! \return `true` with \a found set to `true` for an external defined
+  //!     symbol, or to `false` for an external indirect symbol, which isn’t
+  //!     supported. `false` if the symbol isn’t valid in extdefsym.
+  static bool ExternalDefinedSymbolInformation(
+      const process_types::nlist& symbol,
+      MachOImageSymbolTableReader::SymbolInformation* symbol_info,
+      bool* found) {
+    if ((symbol.n_type & N_STAB) != 0 || (symbol.n_type & N_PEXT) != 0 ||
+        (symbol.n_type & N_EXT) == 0) {
+      return false;
+    }
+
+    uint8_t symbol_type = symbol.n_type & N_TYPE;
+    if (symbol_type == N_INDR) {
+      // See the comment about indirect symbols in Initialize().
+      *found = false;
+      return true;
+    }
+
+    if ((symbol_type != N_ABS && symbol_type != N_SECT) ||
+        (symbol_type == N_ABS && symbol.n_sect != NO_SECT) ||
+        (symbol_type == N_SECT && symbol.n_sect == NO_SECT)) {
+      return false;
+    }
+
+    symbol_info->value = symbol.n_value;
+    symbol_info->section = symbol.n_sect;
+    *found = true;
+    return true;
+  }
+
   //! \brief Computes the address for data in the `__LINKEDIT` segment
   //!     identified by its file offset in a Mach-O image.
   //!
@@ -256,7 +393,15 @@ class MachOImageSymbolTableReaderInitializer {
 }  // namespace internal
 
 MachOImageSymbolTableReader::MachOImageSymbolTableReader()
-    : external_defined_symbols_(), initialized_() {
+    : module_info_(),
+      process_reader_(nullptr),
+      symtab_command_(nullptr),
+      dysymtab_command_(nullptr),
+      linkedit_segment_(nullptr),
+      index_(),
+      external_defined_symbols_(),
+      external_defined_symbols_read_(false),
+      initialized_() {
 }
 
 MachOImageSymbolTableReader::~MachOImageSymbolTableReader() {
@@ -270,12 +415,25 @@ bool MachOImageSymbolTableReader::Initialize(
     const std::string& module_info) {
   INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
 
-  internal::MachOImageSymbolTableReaderInitializer initializer(process_reader,
-                                                               linkedit_segment,
-                                                               module_info);
-  if (!initializer.Initialize(
-          symtab_command, dysymtab_command, &external_defined_symbols_)) {
-    return false;
+  module_info_ = module_info;
+  process_reader_ = process_reader;
+  symtab_command_ = symtab_command;
+  dysymtab_command_ = dysymtab_command;
+  linkedit_segment_ = linkedit_segment;
+
+  if (dysymtab_command) {
+    internal::MachOImageSymbolTableReaderInitializer initializer(
+        process_reader, linkedit_segment, module_info);
+    uint32_t skip_count;
+    if (!initializer.LocateExternalDefinedSymbols(
+            symtab_command, dysymtab_command, &index_, &skip_count)) {
+      return false;
+    }
+  } else {
+    if (!ReadExternalDefinedSymbols(&external_defined_symbols_)) {
+      return false;
+    }
+    external_defined_symbols_read_ = true;
   }
 
   INITIALIZATION_STATE_SET_VALID(initialized_);
@@ -288,10 +446,51 @@ MachOImageSymbolTableReader::LookUpExternalDefinedSymbol(
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
 
   const auto& iterator = external_defined_symbols_.find(name);
-  if (iterator == external_defined_symbols_.end()) {
+  if (iterator != external_defined_symbols_.end()) {
+    return &iterator->second;
+  }
+
+  if (external_defined_symbols_read_) {
     return nullptr;
   }
-  return &iterator->second;
+
+  internal::MachOImageSymbolTableReaderInitializer initializer(
+      process_reader_, linkedit_segment_, module_info_);
+  SymbolInformation symbol_info;
+  bool found;
+  if (initializer.SearchExternalDefinedSymbols(
+          index_, name, &symbol_info, &found) &&
+      found) {
+    return &external_defined_symbols_.insert(std::make_pair(name, symbol_info))
+                .first->second;
+  }
+
+  // The search only checks the order of the symbols that it visits, so a
+  // symbol that it didn’t find may still be present if the symbols aren’t
+  // sorted. Read all of them to be certain, reporting anything wrong with them
+  // if they can’t be searched. Merging them in leaves symbols already returned
+  // where they are.
+  external_defined_symbols_read_ = true;
+  SymbolInformationMap external_defined_symbols;
+  if (!ReadExternalDefinedSymbols(&external_defined_symbols)) {
+    return nullptr;
+  }
+  external_defined_symbols_.insert(external_defined_symbols.begin(),
+                                   external_defined_symbols.end());
+
+  const auto& read_iterator = external_defined_symbols_.find(name);
+  if (read_iterator == external_defined_symbols_.end()) {
+    return nullptr;
+  }
+  return &read_iterator->second;
+}
+
+bool MachOImageSymbolTableReader::ReadExternalDefinedSymbols(
+    SymbolInformationMap* external_defined_symbols) const {
+  internal::MachOImageSymbolTableReaderInitializer initializer(
+      process_reader_, linkedit_segment_, module_info_);
+  return initializer.Initialize(
+      symtab_command_, dysymtab_command_, external_defined_symbols);
 }
 
 }  // namespace crashpad
@@ -64,6 +64,29 @@ class MachOImageSymbolTableReader {
   // MachOImageSymbolTableReaderInitializer.
   using SymbolInformationMap = std::map<std::string, SymbolInformation>;
 
+  //! \brief The location of an image’s external defined symbols and of the
+  //!     string table that names them.
+  //!
+  //! The linker sorts external defined symbols by name, so when an image’s
+  //! `LC_DYSYMTAB` identifies where they are, symbols can be found by binary
+  //! search without reading the entire symbol table.
+  //!
+  //! This is public so that the type is available to
+  //! MachOImageSymbolTableReaderInitializer.
+  struct ExternalDefinedSymbolIndex {
+    //! \brief The address of the first external defined symbol’s `nlist`.
+    mach_vm_address_t symbols_address;
+
+    //! \brief The number of external defined symbols.
+    uint32_t symbol_count;
+
+    //! \brief The address of the string table.
+    mach_vm_address_t strtab_address;
+
+    //! \brief The size of the string table.
+    mach_vm_size_t strtab_size;
+  };
+
   MachOImageSymbolTableReader();
 
   MachOImageSymbolTableReader(const MachOImageSymbolTableReader&) = delete;
@@ -77,6 +100,11 @@ class MachOImageSymbolTableReader {
   //! This method must only be called once on an object. This method must be
   //! called successfully before any other method in this class may be called.
   //!
+  //! When \a dysymtab_command is present, this only checks that the symbol
+  //! table and string table lie within \a linkedit_segment. Their contents are
+  //! not read or validated until LookUpExternalDefinedSymbol() needs them, so
+  //! success does not mean that the symbol table is well-formed.
+  //!
   //! \param[in] process_reader The reader for the remote process.
   //! \param[in] symtab_command The `LC_SYMTAB` load command that identifies
   //!     the symbol table.
@@ -86,7 +114,8 @@ class MachOImageSymbolTableReader {
   //!     modules that do not have this information. When present, \a
   //!     dysymtab_command is an optimization that allows the symbol table
   //!     reader to only examine symbol table entries known to be relevant for
-  //!     its purposes.
+  //!     its purposes, and allows symbols to be looked up by binary search
+  //!     instead of reading every symbol up front.
   //! \param[in] linkedit_segment The `__LINKEDIT` segment. This segment should
   //!     contain the data referenced by \a symtab_command and \a
   //!     dysymtab_command. This may be any segment in the module, but by
@@ -118,6 +147,14 @@ class MachOImageSymbolTableReader {
   //!     does not take ownership; the lifetime of the returned object is scoped
   //!     to the lifetime of this MachOImageSymbolTableReader object.
   //!
+  //! When the image has an `LC_DYSYMTAB` load command, this reads only the
+  //! symbols and names visited by a binary search of the image’s external
+  //! defined symbols. If the search doesn’t find \a name, or finds the
+  //! symbols not to be sorted or not to be valid, every external defined
+  //! symbol is read and validated, as happens for images without
+  //! `LC_DYSYMTAB`. If that fails, no further symbols will be found. Symbols
+  //! that were found before that remain valid.
+  //!
   //! \note Symbol values returned via this interface are not adjusted for
   //!     “slide.” For slide-adjusted values, use the higher-level
   //!     MachOImageReader::LookUpExternalDefinedSymbol() interface.
@@ -125,7 +162,29 @@ class MachOImageSymbolTableReader {
       const std::string& name) const;
 
  private:
-  SymbolInformationMap external_defined_symbols_;
+  //! \brief Reads every external defined symbol.
+  //!
+  //! \param[out] external_defined_symbols The symbols read, keyed by name.
+  //!
+  //! \return `true` on success. `false` on failure, with a message logged.
+  bool ReadExternalDefinedSymbols(
+      SymbolInformationMap* external_defined_symbols) const;
+
+  // The weak pointers point into the MachOImageReader that owns this object.
+  std::string module_info_;
+  ProcessReaderMac* process_reader_;  // weak
+  const process_types::symtab_command* symtab_command_;  // weak
+  const process_types::dysymtab_command* dysymtab_command_;  // weak
+  const MachOImageSegmentReader* linkedit_segment_;  // weak
+
+  ExternalDefinedSymbolIndex index_;
+
+  // The symbols found so far by binary search of index_, kept so that the
+  // pointers returned to callers stay valid. Once
+  // external_defined_symbols_read_ is set, this also holds every external
+  // defined symbol, unless reading them failed.
+  mutable SymbolInformationMap external_defined_symbols_;
+  mutable bool external_defined_symbols_read_;
   InitializationStateDcheck initialized_;
 };
 
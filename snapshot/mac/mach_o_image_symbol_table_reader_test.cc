@@ -0,0 +1,282 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "snapshot/mac/mach_o_image_symbol_table_reader.h"
+
+#include <mach-o/loader.h>
+#include <mach-o/nlist.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "build/build_config.h"
+#include "gtest/gtest.h"
+#include "snapshot/mac/mach_o_image_segment_reader.h"
+#include "snapshot/mac/process_reader_mac.h"
+#include "snapshot/mac/process_types.h"
+#include "util/misc/from_pointer_cast.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+// Native types and constants, in cases where the 32-bit and 64-bit versions
+// are different.
+#if defined(ARCH_CPU_64_BITS)
+using SegmentCommand = segment_command_64;
+constexpr uint32_t kSegmentCommand = LC_SEGMENT_64;
+using Nlist = nlist_64;
+#else
+using SegmentCommand = segment_command;
+constexpr uint32_t kSegmentCommand = LC_SEGMENT;
+
+// This needs to be called “struct nlist” because “nlist” without the struct
+// refers to the nlist() function.
+using Nlist = struct nlist;
+#endif
+
+struct TestSymbol {
+  std::string name;
+  uint8_t type;
+  uint8_t section;
+  uint64_t value;
+};
+
+// Returns external defined symbols sorted by name, as the linker writes them.
+std::vector<TestSymbol> SortedSymbols() {
+  return {
+      {"_a", N_SECT | N_EXT, 1, 0x1000},
+      {"_b", N_SECT | N_EXT, 1, 0x1010},
+      {"_c", N_ABS | N_EXT, NO_SECT, 0x1020},
+      {"_d", N_SECT | N_EXT, 2, 0x1030},
+      {"_e", N_SECT | N_EXT, 1, 0x1040},
+      {"_f", N_SECT | N_EXT, 2, 0x1050},
+      {"_g", N_SECT | N_EXT, 1, 0x1060},
+  };
+}
+
+// A __LINKEDIT segment in this process holding a symbol table and the string
+// table that names its symbols, along with the load commands that describe
+// them.
+class TestLinkEdit {
+ public:
+  explicit TestLinkEdit(const std::vector<TestSymbol>& symbols)
+      : contents_(),
+        segment_command_(),
+        symtab_command_(),
+        dysymtab_command_(),
+        linkedit_segment_() {
+    const size_t symtab_size = symbols.size() * sizeof(Nlist);
+    std::string strtab(1, '\0');
+    contents_.resize(symtab_size);
+    for (size_t index = 0; index < symbols.size(); ++index) {
+      Nlist symbol = {};
+      symbol.n_un.n_strx = static_cast<uint32_t>(strtab.size());
+      symbol.n_type = symbols[index].type;
+      symbol.n_sect = symbols[index].section;
+      symbol.n_value = symbols[index].value;
+      memcpy(&contents_[index * sizeof(Nlist)], &symbol, sizeof(symbol));
+      strtab.append(symbols[index].name.c_str(),
+                    symbols[index].name.size() + 1);
+    }
+    contents_.insert(contents_.end(), strtab.begin(), strtab.end());
+
+    segment_command_.cmd = kSegmentCommand;
+    segment_command_.cmdsize = sizeof(segment_command_);
+    strncpy(segment_command_.segname,
+            SEG_LINKEDIT,
+            sizeof(segment_command_.segname));
+    segment_command_.vmaddr = FromPointerCast<uintptr_t>(contents_.data());
+    segment_command_.vmsize = contents_.size();
+    segment_command_.filesize = contents_.size();
+
+    symtab_command_.cmd = LC_SYMTAB;
+    symtab_command_.cmdsize = sizeof(symtab_command_);
+    symtab_command_.nsyms = static_cast<uint32_t>(symbols.size());
+    symtab_command_.stroff = static_cast<uint32_t>(symtab_size);
+    symtab_command_.strsize = static_cast<uint32_t>(strtab.size());
+
+    dysymtab_command_.cmd = LC_DYSYMTAB;
+    dysymtab_command_.cmdsize = sizeof(dysymtab_command_);
+    dysymtab_command_.nextdefsym = static_cast<uint32_t>(symbols.size());
+  }
+
+  TestLinkEdit(const TestLinkEdit&) = delete;
+  TestLinkEdit& operator=(const TestLinkEdit&) = delete;
+
+  ~TestLinkEdit() {}
+
+  // Reads the load commands back through process_reader. This must be called
+  // successfully before InitializeReader().
+  bool Initialize(ProcessReaderMac* process_reader) {
+    if (!linkedit_segment_.Initialize(
+            process_reader,
+            FromPointerCast<mach_vm_address_t>(&segment_command_),
+            std::string(),
+            std::string(),
+            MH_DYLIB)) {
+      return false;
+    }
+    linkedit_segment_.SetSlide(0);
+
+    return process_symtab_command_.Read(
+               process_reader,
+               FromPointerCast<mach_vm_address_t>(&symtab_command_)) &&
+           process_dysymtab_command_.Read(
+               process_reader,
+               FromPointerCast<mach_vm_address_t>(&dysymtab_command_));
+  }
+
+  // Initializes reader, which searches the symbols if use_dysymtab is true,
+  // and otherwise reads every symbol up front.
+  bool InitializeReader(ProcessReaderMac* process_reader,
+                        bool use_dysymtab,
+                        MachOImageSymbolTableReader* reader) const {
+    return reader->Initialize(
+        process_reader,
+        &process_symtab_command_,
+        use_dysymtab ? &process_dysymtab_command_ : nullptr,
+        &linkedit_segment_,
+        std::string());
+  }
+
+  // Gives the symbol at index a name that lies outside of the string table.
+  void CorruptSymbolName(size_t index) {
+    Nlist symbol;
+    memcpy(&symbol, &contents_[index * sizeof(Nlist)], sizeof(symbol));
+    symbol.n_un.n_strx = symtab_command_.strsize;
+    memcpy(&contents_[index * sizeof(Nlist)], &symbol, sizeof(symbol));
+  }
+
+ private:
+  std::vector<char> contents_;
+  SegmentCommand segment_command_;
+  symtab_command symtab_command_;
+  dysymtab_command dysymtab_command_;
+  process_types::symtab_command process_symtab_command_;
+  process_types::dysymtab_command process_dysymtab_command_;
+  MachOImageSegmentReader linkedit_segment_;
+};
+
+// Returns the names of symbols, and names that sort before, between, and
+// after them.
+std::vector<std::string> NamesToLookUp(const std::vector<TestSymbol>& symbols) {
+  std::vector<std::string> names = {"", "_", "_0", "_bb", "_z"};
+  for (const TestSymbol& symbol : symbols) {
+    names.push_back(symbol.name);
+  }
+  return names;
+}
+
+// Expects a search of the symbols to find what reading all of them finds.
+void ExpectSearchMatchesRead(const std::vector<TestSymbol>& symbols) {
+  TestLinkEdit link_edit(symbols);
+  ProcessReaderMac process_reader;
+  ASSERT_TRUE(process_reader.Initialize(mach_task_self()));
+  ASSERT_TRUE(link_edit.Initialize(&process_reader));
+
+  MachOImageSymbolTableReader read_reader;
+  ASSERT_TRUE(link_edit.InitializeReader(&process_reader, false, &read_reader));
+
+  for (const std::string& name : NamesToLookUp(symbols)) {
+    SCOPED_TRACE(name);
+
+    // Each name is looked up by a new reader, so that none of the lookups
+    // relies on symbols read by another.
+    MachOImageSymbolTableReader search_reader;
+    ASSERT_TRUE(
+        link_edit.InitializeReader(&process_reader, true, &search_reader));
+
+    const MachOImageSymbolTableReader::SymbolInformation* read_symbol =
+        read_reader.LookUpExternalDefinedSymbol(name);
+    const MachOImageSymbolTableReader::SymbolInformation* search_symbol =
+        search_reader.LookUpExternalDefinedSymbol(name);
+    ASSERT_EQ(!!search_symbol, !!read_symbol);
+    if (read_symbol) {
+      EXPECT_EQ(search_symbol->value, read_symbol->value);
+      EXPECT_EQ(search_symbol->section, read_symbol->section);
+    }
+  }
+}
+
+TEST(MachOImageSymbolTableReader, Sorted) {
+  const std::vector<TestSymbol> symbols = SortedSymbols();
+  ASSERT_NO_FATAL_FAILURE(ExpectSearchMatchesRead(symbols));
+
+  TestLinkEdit link_edit(symbols);
+  ProcessReaderMac process_reader;
+  ASSERT_TRUE(process_reader.Initialize(mach_task_self()));
+  ASSERT_TRUE(link_edit.Initialize(&process_reader));
+  MachOImageSymbolTableReader reader;
+  ASSERT_TRUE(link_edit.InitializeReader(&process_reader, true, &reader));
+
+  for (const TestSymbol& symbol : symbols) {
+    SCOPED_TRACE(symbol.name);
+    const MachOImageSymbolTableReader::SymbolInformation* symbol_info =
+        reader.LookUpExternalDefinedSymbol(symbol.name);
+    ASSERT_TRUE(symbol_info);
+    EXPECT_EQ(symbol_info->value, symbol.value);
+    EXPECT_EQ(symbol_info->section, symbol.section);
+
+    // Looking the symbol up again returns the same information.
+    EXPECT_EQ(reader.LookUpExternalDefinedSymbol(symbol.name), symbol_info);
+  }
+  EXPECT_FALSE(reader.LookUpExternalDefinedSymbol("_bb"));
+}
+
+TEST(MachOImageSymbolTableReader, Unsorted) {
+  // Two symbols are out of order, in a way that doesn’t disturb the symbols
+  // that a search visits. A search for _b doesn’t find it, so it can only be
+  // found by reading every symbol.
+  std::vector<TestSymbol> symbols = SortedSymbols();
+  std::swap(symbols[0], symbols[1]);
+  ASSERT_NO_FATAL_FAILURE(ExpectSearchMatchesRead(symbols));
+
+  // The search notices that these are out of order.
+  std::reverse(symbols.begin(), symbols.end());
+  ASSERT_NO_FATAL_FAILURE(ExpectSearchMatchesRead(symbols));
+}
+
+TEST(MachOImageSymbolTableReader, Corrupt) {
+  // The middle symbol is the first one that a search visits, so every search
+  // finds that its name is bad, and falls back to reading every symbol.
+  const std::vector<TestSymbol> symbols = SortedSymbols();
+  TestLinkEdit link_edit(symbols);
+  link_edit.CorruptSymbolName(symbols.size() / 2);
+  ProcessReaderMac process_reader;
+  ASSERT_TRUE(process_reader.Initialize(mach_task_self()));
+  ASSERT_TRUE(link_edit.Initialize(&process_reader));
+
+  // Reading every symbol up front fails.
+  MachOImageSymbolTableReader read_reader;
+  EXPECT_FALSE(
+      link_edit.InitializeReader(&process_reader, false, &read_reader));
+
+  // Initialize() doesn’t read the symbols, so it succeeds, but reading them
+  // fails, so no symbol is found.
+  MachOImageSymbolTableReader search_reader;
+  ASSERT_TRUE(
+      link_edit.InitializeReader(&process_reader, true, &search_reader));
+  for (const std::string& name : NamesToLookUp(symbols)) {
+    EXPECT_FALSE(search_reader.LookUpExternalDefinedSymbol(name)) << name;
+  }
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
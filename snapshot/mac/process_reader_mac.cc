@@ -28,10 +28,40 @@
 #include "base/strings/stringprintf.h"
 #include "snapshot/mac/mach_o_image_reader.h"
 #include "snapshot/mac/process_types.h"
-#include "util/misc/scoped_forbid_return.h"
+#include "util/thread/thread.h"
 
 namespace {
 
+// The largest image header that is added to a MachOImageHeaderCache. Images in
+// the shared cache have much smaller headers than this.
+constexpr mach_vm_size_t kMaxCachedHeaderSize = 64 * 1024;
+
+// The largest image header that ReadModuleHeader() reads in one piece.
+constexpr mach_vm_size_t kMaxBulkHeaderSize = 1024 * 1024;
+
+// Reads an image’s mach_header and load commands with a single read. Returns
+// nullptr if they can’t be read that way, leaving MachOImageReader to read them
+// piecemeal and report any problem.
+std::shared_ptr<const MachOImageHeaderCache::Header> ReadModuleHeader(
+    ProcessReaderMac* process_reader,
+    mach_vm_address_t address) {
+  process_types::mach_header mach_header;
+  if (!mach_header.Read(process_reader, address)) {
+    return nullptr;
+  }
+
+  const mach_vm_size_t size = mach_header.Size() + mach_header.sizeofcmds;
+  if (size > kMaxBulkHeaderSize) {
+    return nullptr;
+  }
+
+  auto header = std::make_shared<MachOImageHeaderCache::Header>(size);
+  if (!process_reader->Memory()->Read(address, size, header->data())) {
+    return nullptr;
+  }
+  return header;
+}
+
 void MachTimeValueToTimeval(const time_value& mach, timeval* tv) {
   tv->tv_sec = mach.seconds;
   tv->tv_usec = mach.microseconds;
@@ -71,6 +101,27 @@ kern_return_t MachVMRegionRecurseDeepest(task_t task,
 
 namespace crashpad {
 
+// Gathers the details of threads in ProcessReaderMac::threads_. Several of
+// these may run at once, alongside the thread that called Threads().
+class ProcessReaderMac::ThreadInitializerThread : public crashpad::Thread {
+ public:
+  ThreadInitializerThread(ProcessReaderMac* reader,
+                          std::atomic<size_t>* next_index)
+      : reader_(reader), next_index_(next_index) {}
+
+  ThreadInitializerThread(const ThreadInitializerThread&) = delete;
+  ThreadInitializerThread& operator=(const ThreadInitializerThread&) = delete;
+
+  ~ThreadInitializerThread() override {}
+
+ private:
+  // Thread:
+  void ThreadMain() override { reader_->InitializeThreadDetails(next_index_); }
+
+  ProcessReaderMac* reader_;  // weak
+  std::atomic<size_t>* next_index_;
+};
+
 ProcessReaderMac::Thread::Thread()
     : thread_context(),
       float_context(),
@@ -94,7 +145,9 @@ ProcessReaderMac::ProcessReaderMac()
       modules_(),
       module_readers_(),
       process_memory_(),
+      header_cache_(nullptr),
       task_(TASK_NULL),
+      thread_initialization_threads_(1),
       initialized_(),
 #if defined(CRASHPAD_MAC_32_BIT_SUPPORT)
       is_64_bit_(false),
@@ -110,7 +163,9 @@ ProcessReaderMac::~ProcessReaderMac() {
   }
 }
 
-bool ProcessReaderMac::Initialize(task_t task) {
+bool ProcessReaderMac::Initialize(task_t task,
+                                  unsigned int thread_initialization_threads,
+                                  MachOImageHeaderCache* header_cache) {
   INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
 
   if (!process_info_.InitializeWithTask(task)) {
@@ -121,13 +176,21 @@ bool ProcessReaderMac::Initialize(task_t task) {
     return false;
   }
 
+  // The task is suspended while it is being read, so its image headers,
+  // load commands, and annotations can be read through mappings that are kept
+  // for the life of this object.
+  process_memory_.SetMappingCacheSize(
+      ProcessMemoryMac::kDefaultMaxCachedMappings);
+
 #if defined(CRASHPAD_MAC_32_BIT_SUPPORT)
   is_64_bit_ = process_info_.Is64Bit();
 #else  // CRASHPAD_MAC_32_BIT_SUPPORT
   DCHECK(process_info_.Is64Bit());
 #endif  // CRASHPAD_MAC_32_BIT_SUPPORT
 
+  header_cache_ = header_cache;
   task_ = task;
+  thread_initialization_threads_ = std::max(1u, thread_initialization_threads);
 
   INITIALIZATION_STATE_SET_VALID(initialized_);
   return true;
@@ -259,157 +322,195 @@ void ProcessReaderMac::InitializeThreads() {
     return;
   }
 
-  // The send rights in the |threads| array won’t have their send rights managed
-  // by anything until they’re added to |threads_| by the loop below. Any early
-  // return (or exception) that happens between here and the completion of the
-  // loop below will leak thread port send rights.
-  ScopedForbidReturn threads_need_owners;
-
   base::mac::ScopedMachVM threads_vm(
       reinterpret_cast<vm_address_t>(threads),
       mach_vm_round_page(thread_count * sizeof(*threads)));
 
+  // threads_ owns the send rights in the |threads| array from here on.
+  threads_.resize(thread_count);
   for (size_t index = 0; index < thread_count; ++index) {
-    Thread thread;
-    thread.port = threads[index];
+    threads_[index].port = threads[index];
+  }
 
+  // Each thread’s details are gathered by exactly one thread, which writes only
+  // to that thread’s element of threads_. The calling thread does its share of
+  // the work too.
+  std::atomic<size_t> next_index(0);
+  const size_t worker_count =
+      std::max(size_t{1},
+               std::min(size_t{thread_initialization_threads_},
+                        threads_.size())) -
+      1;
+  std::vector<std::unique_ptr<ThreadInitializerThread>> workers;
+  workers.reserve(worker_count);
+  for (size_t index = 0; index < worker_count; ++index) {
+    workers.push_back(
+        std::make_unique<ThreadInitializerThread>(this, &next_index));
+    workers.back()->Start();
+  }
+  InitializeThreadDetails(&next_index);
+  for (const auto& worker : workers) {
+    worker->Join();
+  }
+
+  threads_.erase(std::remove_if(threads_.begin(),
+                                threads_.end(),
+                                [](const Thread& thread) {
+                                  return thread.port == THREAD_NULL;
+                                }),
+                 threads_.end());
+}
+
+void ProcessReaderMac::InitializeThreadDetails(
+    std::atomic<size_t>* next_index) {
+  for (size_t index = (*next_index)++; index < threads_.size();
+       index = (*next_index)++) {
+    Thread& thread = threads_[index];
+    if (!InitializeThread(&thread)) {
+      kern_return_t kr = mach_port_deallocate(mach_task_self(), thread.port);
+      MACH_LOG_IF(ERROR, kr != KERN_SUCCESS, kr) << "mach_port_deallocate";
+      thread.port = THREAD_NULL;
+    }
+  }
+}
+
+bool ProcessReaderMac::InitializeThread(Thread* thread) {
 #if defined(ARCH_CPU_X86_FAMILY)
-    const thread_state_flavor_t kThreadStateFlavor =
-        Is64Bit() ? x86_THREAD_STATE64 : x86_THREAD_STATE32;
-    mach_msg_type_number_t thread_state_count =
-        Is64Bit() ? x86_THREAD_STATE64_COUNT : x86_THREAD_STATE32_COUNT;
-
-    // TODO(mark): Use the AVX variants instead of the FLOAT variants?
-    const thread_state_flavor_t kFloatStateFlavor =
-        Is64Bit() ? x86_FLOAT_STATE64 : x86_FLOAT_STATE32;
-    mach_msg_type_number_t float_state_count =
-        Is64Bit() ? x86_FLOAT_STATE64_COUNT : x86_FLOAT_STATE32_COUNT;
-
-    const thread_state_flavor_t kDebugStateFlavor =
-        Is64Bit() ? x86_DEBUG_STATE64 : x86_DEBUG_STATE32;
-    mach_msg_type_number_t debug_state_count =
-        Is64Bit() ? x86_DEBUG_STATE64_COUNT : x86_DEBUG_STATE32_COUNT;
+  const thread_state_flavor_t kThreadStateFlavor =
+      Is64Bit() ? x86_THREAD_STATE64 : x86_THREAD_STATE32;
+  mach_msg_type_number_t thread_state_count =
+      Is64Bit() ? x86_THREAD_STATE64_COUNT : x86_THREAD_STATE32_COUNT;
+
+  // TODO(mark): Use the AVX variants instead of the FLOAT variants?
+  const thread_state_flavor_t kFloatStateFlavor =
+      Is64Bit() ? x86_FLOAT_STATE64 : x86_FLOAT_STATE32;
+  mach_msg_type_number_t float_state_count =
+      Is64Bit() ? x86_FLOAT_STATE64_COUNT : x86_FLOAT_STATE32_COUNT;
+
+  const thread_state_flavor_t kDebugStateFlavor =
+      Is64Bit() ? x86_DEBUG_STATE64 : x86_DEBUG_STATE32;
+  mach_msg_type_number_t debug_state_count =
+      Is64Bit() ? x86_DEBUG_STATE64_COUNT : x86_DEBUG_STATE32_COUNT;
 #elif defined(ARCH_CPU_ARM64)
-    const thread_state_flavor_t kThreadStateFlavor = ARM_THREAD_STATE64;
-    mach_msg_type_number_t thread_state_count = ARM_THREAD_STATE64_COUNT;
-
-    const thread_state_flavor_t kFloatStateFlavor = ARM_NEON_STATE64;
-    mach_msg_type_number_t float_state_count = ARM_NEON_STATE64_COUNT;
+  const thread_state_flavor_t kThreadStateFlavor = ARM_THREAD_STATE64;
+  mach_msg_type_number_t thread_state_count = ARM_THREAD_STATE64_COUNT;
 
-    const thread_state_flavor_t kDebugStateFlavor = ARM_DEBUG_STATE64;
-    mach_msg_type_number_t debug_state_count = ARM_DEBUG_STATE64_COUNT;
+  const thread_state_flavor_t kFloatStateFlavor = ARM_NEON_STATE64;
+  mach_msg_type_number_t float_state_count = ARM_NEON_STATE64_COUNT;
 #endif
 
-    kr = thread_get_state(
-        thread.port,
-        kThreadStateFlavor,
-        reinterpret_cast<thread_state_t>(&thread.thread_context),
-        &thread_state_count);
-    if (kr != KERN_SUCCESS) {
-      MACH_LOG(ERROR, kr) << "thread_get_state(" << kThreadStateFlavor << ")";
-      continue;
-    }
-
-    kr = thread_get_state(
-        thread.port,
-        kFloatStateFlavor,
-        reinterpret_cast<thread_state_t>(&thread.float_context),
-        &float_state_count);
-    if (kr != KERN_SUCCESS) {
-      MACH_LOG(ERROR, kr) << "thread_get_state(" << kFloatStateFlavor << ")";
-      continue;
-    }
+  kern_return_t kr = thread_get_state(
+      thread->port,
+      kThreadStateFlavor,
+      reinterpret_cast<thread_state_t>(&thread->thread_context),
+      &thread_state_count);
+  if (kr != KERN_SUCCESS) {
+    MACH_LOG(ERROR, kr) << "thread_get_state(" << kThreadStateFlavor << ")";
+    return false;
+  }
 
-    kr = thread_get_state(
-        thread.port,
-        kDebugStateFlavor,
-        reinterpret_cast<thread_state_t>(&thread.debug_context),
-        &debug_state_count);
-    if (kr != KERN_SUCCESS) {
-      MACH_LOG(ERROR, kr) << "thread_get_state(" << kDebugStateFlavor << ")";
-      continue;
-    }
+  kr = thread_get_state(
+      thread->port,
+      kFloatStateFlavor,
+      reinterpret_cast<thread_state_t>(&thread->float_context),
+      &float_state_count);
+  if (kr != KERN_SUCCESS) {
+    MACH_LOG(ERROR, kr) << "thread_get_state(" << kFloatStateFlavor << ")";
+    return false;
+  }
 
-    thread_basic_info basic_info;
-    mach_msg_type_number_t count = THREAD_BASIC_INFO_COUNT;
-    kr = thread_info(thread.port,
-                     THREAD_BASIC_INFO,
-                     reinterpret_cast<thread_info_t>(&basic_info),
-                     &count);
-    if (kr != KERN_SUCCESS) {
-      MACH_LOG(WARNING, kr) << "thread_info(THREAD_BASIC_INFO)";
-    } else {
-      thread.suspend_count = basic_info.suspend_count;
-    }
+#if defined(ARCH_CPU_X86_FAMILY)
+  // On ARM64, the debug state is left zeroed instead of being read, saving a
+  // call per thread: CPUContextARM64 has nowhere to keep it, and minidumps
+  // record ARM64 debug registers as zero.
+  kr = thread_get_state(
+      thread->port,
+      kDebugStateFlavor,
+      reinterpret_cast<thread_state_t>(&thread->debug_context),
+      &debug_state_count);
+  if (kr != KERN_SUCCESS) {
+    MACH_LOG(ERROR, kr) << "thread_get_state(" << kDebugStateFlavor << ")";
+    return false;
+  }
+#endif  // ARCH_CPU_X86_FAMILY
+
+  thread_basic_info basic_info;
+  mach_msg_type_number_t count = THREAD_BASIC_INFO_COUNT;
+  kr = thread_info(thread->port,
+                   THREAD_BASIC_INFO,
+                   reinterpret_cast<thread_info_t>(&basic_info),
+                   &count);
+  if (kr != KERN_SUCCESS) {
+    MACH_LOG(WARNING, kr) << "thread_info(THREAD_BASIC_INFO)";
+  } else {
+    thread->suspend_count = basic_info.suspend_count;
+  }
 
-    thread_identifier_info identifier_info;
-    count = THREAD_IDENTIFIER_INFO_COUNT;
-    kr = thread_info(thread.port,
-                     THREAD_IDENTIFIER_INFO,
-                     reinterpret_cast<thread_info_t>(&identifier_info),
-                     &count);
-    if (kr != KERN_SUCCESS) {
-      MACH_LOG(WARNING, kr) << "thread_info(THREAD_IDENTIFIER_INFO)";
-    } else {
-      thread.id = identifier_info.thread_id;
-
-      // thread_identifier_info::thread_handle contains the base of the
-      // thread-specific data area, which on x86 and x86_64 is the thread’s base
-      // address of the %gs segment. 10.9.2 xnu-2422.90.20/osfmk/kern/thread.c
-      // thread_info_internal() gets the value from
-      // machine_thread::cthread_self, which is the same value used to set the
-      // %gs base in xnu-2422.90.20/osfmk/i386/pcb_native.c
-      // act_machine_switch_pcb().
-      //
-      // This address is the internal pthread’s _pthread::tsd[], an array of
-      // void* values that can be indexed by pthread_key_t values.
-      thread.thread_specific_data_address = identifier_info.thread_handle;
-    }
+  thread_identifier_info identifier_info;
+  count = THREAD_IDENTIFIER_INFO_COUNT;
+  kr = thread_info(thread->port,
+                   THREAD_IDENTIFIER_INFO,
+                   reinterpret_cast<thread_info_t>(&identifier_info),
+                   &count);
+  if (kr != KERN_SUCCESS) {
+    MACH_LOG(WARNING, kr) << "thread_info(THREAD_IDENTIFIER_INFO)";
+  } else {
+    thread->id = identifier_info.thread_id;
+
+    // thread_identifier_info::thread_handle contains the base of the
+    // thread-specific data area, which on x86 and x86_64 is the thread’s base
+    // address of the %gs segment. 10.9.2 xnu-2422.90.20/osfmk/kern/thread.c
+    // thread_info_internal() gets the value from
+    // machine_thread::cthread_self, which is the same value used to set the
+    // %gs base in xnu-2422.90.20/osfmk/i386/pcb_native.c
+    // act_machine_switch_pcb().
+    //
+    // This address is the internal pthread’s _pthread::tsd[], an array of
+    // void* values that can be indexed by pthread_key_t values.
+    thread->thread_specific_data_address = identifier_info.thread_handle;
+  }
 
-    thread_extended_info extended_info;
-    count = THREAD_EXTENDED_INFO_COUNT;
-    kr = thread_info(thread.port,
-                     THREAD_EXTENDED_INFO,
-                     reinterpret_cast<thread_info_t>(&extended_info),
-                     &count);
-    if (kr != KERN_SUCCESS) {
-      MACH_LOG(WARNING, kr) << "thread_info(THREAD_EXTENDED_INFO)";
-    } else {
-      thread.name.assign(
-          extended_info.pth_name,
-          strnlen(extended_info.pth_name, sizeof(extended_info.pth_name)));
-    }
+  thread_extended_info extended_info;
+  count = THREAD_EXTENDED_INFO_COUNT;
+  kr = thread_info(thread->port,
+                   THREAD_EXTENDED_INFO,
+                   reinterpret_cast<thread_info_t>(&extended_info),
+                   &count);
+  if (kr != KERN_SUCCESS) {
+    MACH_LOG(WARNING, kr) << "thread_info(THREAD_EXTENDED_INFO)";
+  } else {
+    thread->name.assign(
+        extended_info.pth_name,
+        strnlen(extended_info.pth_name, sizeof(extended_info.pth_name)));
+  }
 
-    thread_precedence_policy precedence;
-    count = THREAD_PRECEDENCE_POLICY_COUNT;
-    boolean_t get_default = FALSE;
-    kr = thread_policy_get(thread.port,
-                           THREAD_PRECEDENCE_POLICY,
-                           reinterpret_cast<thread_policy_t>(&precedence),
-                           &count,
-                           &get_default);
-    if (kr != KERN_SUCCESS) {
-      MACH_LOG(INFO, kr) << "thread_policy_get";
-    } else {
-      thread.priority = precedence.importance;
-    }
+  thread_precedence_policy precedence;
+  count = THREAD_PRECEDENCE_POLICY_COUNT;
+  boolean_t get_default = FALSE;
+  kr = thread_policy_get(thread->port,
+                         THREAD_PRECEDENCE_POLICY,
+                         reinterpret_cast<thread_policy_t>(&precedence),
+                         &count,
+                         &get_default);
+  if (kr != KERN_SUCCESS) {
+    MACH_LOG(INFO, kr) << "thread_policy_get";
+  } else {
+    thread->priority = precedence.importance;
+  }
 
 #if defined(ARCH_CPU_X86_FAMILY)
-    mach_vm_address_t stack_pointer = Is64Bit()
-                                          ? thread.thread_context.t64.__rsp
-                                          : thread.thread_context.t32.__esp;
+  mach_vm_address_t stack_pointer = Is64Bit()
+                                        ? thread->thread_context.t64.__rsp
+                                        : thread->thread_context.t32.__esp;
 #elif defined(ARCH_CPU_ARM64)
-    mach_vm_address_t stack_pointer =
-        arm_thread_state64_get_sp(thread.thread_context);
+  mach_vm_address_t stack_pointer =
+      arm_thread_state64_get_sp(thread->thread_context);
 #endif
 
-    thread.stack_region_address =
-        CalculateStackRegion(stack_pointer, &thread.stack_region_size);
-
-    threads_.push_back(thread);
-  }
+  thread->stack_region_address =
+      CalculateStackRegion(stack_pointer, &thread->stack_region_size);
 
-  threads_need_owners.Disarm();
+  return true;
 }
 
 void ProcessReaderMac::InitializeModules() {
@@ -471,6 +572,21 @@ void ProcessReaderMac::InitializeModules() {
     return;
   }
 
+  // Images in the shared cache have the same headers in every process that
+  // maps the same shared cache, wherever it was slid to, so header_cache_ keeps
+  // them by their offset from the shared cache’s base address.
+  UUID shared_cache_uuid;
+  shared_cache_uuid.InitializeToZero();
+  mach_vm_address_t shared_cache_address = 0;
+  if (header_cache_ && all_image_infos.version >= 15) {
+    shared_cache_uuid.InitializeFromBytes(all_image_infos.sharedCacheUUID);
+    UUID zero_uuid;
+    zero_uuid.InitializeToZero();
+    if (shared_cache_uuid != zero_uuid) {
+      shared_cache_address = all_image_infos.sharedCacheBaseAddress;
+    }
+  }
+
   size_t main_executable_count = 0;
   bool found_dyld = false;
   modules_.reserve(image_info_vector.size());
@@ -483,10 +599,11 @@ void ProcessReaderMac::InitializeModules() {
       // Proceed anyway with an empty module name.
     }
 
-    std::unique_ptr<MachOImageReader> reader(new MachOImageReader());
-    if (!reader->Initialize(this, image_info.imageLoadAddress, module.name)) {
-      reader.reset();
-    }
+    std::unique_ptr<MachOImageReader> reader =
+        CreateModuleReader(image_info.imageLoadAddress,
+                           module.name,
+                           shared_cache_uuid,
+                           shared_cache_address);
 
     module.reader = reader.get();
 
@@ -567,11 +684,11 @@ void ProcessReaderMac::InitializeModules() {
     }
     std::string module_name = !module.name.empty() ? module.name : "(dyld)";
 
-    std::unique_ptr<MachOImageReader> reader(new MachOImageReader());
-    if (!reader->Initialize(
-            this, all_image_infos.dyldImageLoadAddress, module_name)) {
-      reader.reset();
-    }
+    std::unique_ptr<MachOImageReader> reader =
+        CreateModuleReader(all_image_infos.dyldImageLoadAddress,
+                           module_name,
+                           shared_cache_uuid,
+                           shared_cache_address);
 
     module.reader = reader.get();
 
@@ -597,6 +714,44 @@ void ProcessReaderMac::InitializeModules() {
   }
 }
 
+std::unique_ptr<MachOImageReader> ProcessReaderMac::CreateModuleReader(
+    mach_vm_address_t address,
+    const std::string& name,
+    const UUID& shared_cache_uuid,
+    mach_vm_address_t shared_cache_address) {
+  const bool use_cache =
+      shared_cache_address != 0 && address >= shared_cache_address;
+  const uint64_t shared_cache_offset = address - shared_cache_address;
+
+  std::shared_ptr<const MachOImageHeaderCache::Header> header;
+  if (use_cache) {
+    header = header_cache_->Find(shared_cache_uuid, shared_cache_offset);
+  }
+  const bool header_was_cached = !!header;
+
+  // Otherwise, the header is read in one piece, so that MachOImageReader’s
+  // many small reads of the mach_header and each load command are satisfied
+  // from a local copy.
+  if (!header) {
+    header = ReadModuleHeader(this, address);
+  }
+  if (header) {
+    process_memory_.AddKnownRegion(address, header);
+  }
+
+  std::unique_ptr<MachOImageReader> reader(new MachOImageReader());
+  if (!reader->Initialize(this, address, name)) {
+    return nullptr;
+  }
+
+  if (use_cache && !header_was_cached && header && reader->InSharedCache() &&
+      reader->HeaderSize() <= kMaxCachedHeaderSize) {
+    header_cache_->Insert(shared_cache_uuid, shared_cache_offset, header);
+  }
+
+  return reader;
+}
+
 mach_vm_address_t ProcessReaderMac::CalculateStackRegion(
     mach_vm_address_t stack_pointer,
     mach_vm_size_t* stack_region_size) {
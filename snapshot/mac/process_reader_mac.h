@@ -22,11 +22,13 @@
 #include <sys/types.h>
 #include <time.h>
 
+#include <atomic>
 #include <memory>
 #include <string>
 #include <vector>
 
 #include "build/build_config.h"
+#include "snapshot/mac/mach_o_image_header_cache.h"
 #include "util/misc/initialization_state_dcheck.h"
 #include "util/posix/process_info.h"
 #include "util/process/process_memory_mac.h"
@@ -122,11 +124,22 @@ class ProcessReaderMac {
   //!
   //! \param[in] task A send right to the target task’s task port. This object
   //!     does not take ownership of the send right.
+  //! \param[in] thread_initialization_threads The number of threads, including
+  //!     the calling thread, used to gather the registers and other details of
+  //!     each of the target task’s threads. The order of threads is the same
+  //!     regardless.
+  //! \param[in] header_cache A cache of the headers of images in the dyld
+  //!     shared cache, shared with other ProcessReaderMac objects. Headers of
+  //!     images in the shared cache are taken from it instead of being read
+  //!     from the task where possible, and are added to it otherwise. Optional,
+  //!     may be `nullptr`. If not `nullptr`, it must outlive this object.
   //!
   //! \return `true` on success, indicating that this object will respond
   //!     validly to further method calls. `false` on failure. On failure, no
   //!     further method calls should be made.
-  bool Initialize(task_t task);
+  bool Initialize(task_t task,
+                  unsigned int thread_initialization_threads = 1,
+                  MachOImageHeaderCache* header_cache = nullptr);
 
   //! \return `true` if the target task is a 64-bit process.
 #if defined(CRASHPAD_MAC_32_BIT_SUPPORT) || DOXYGEN
@@ -186,14 +199,45 @@ class ProcessReaderMac {
   mach_vm_address_t DyldAllImageInfo(mach_vm_size_t* all_image_info_size);
 
  private:
+  class ThreadInitializerThread;
+
   //! Performs lazy initialization of the \a threads_ vector on behalf of
   //! Threads().
   void InitializeThreads();
 
+  //! \brief Gathers the details of elements of \a threads_ on behalf of
+  //!     InitializeThreads(), taking the index of each from \a next_index,
+  //!     until none remain.
+  //!
+  //! The port of a thread whose registers can’t be read is deallocated and set
+  //! to `THREAD_NULL`.
+  void InitializeThreadDetails(std::atomic<size_t>* next_index);
+
+  //! \brief Gathers the registers and other details of \a thread, whose port
+  //!     must be set, on behalf of InitializeThreadDetails().
+  //!
+  //! \return `false` if the thread’s registers could not be read, with a
+  //!     message logged.
+  bool InitializeThread(Thread* thread);
+
   //! Performs lazy initialization of the \a modules_ vector on behalf of
   //! Modules().
   void InitializeModules();
 
+  //! \brief Creates a reader for the Mach-O image at \a address on behalf of
+  //!     InitializeModules().
+  //!
+  //! If \a shared_cache_address is not `0`, \a header_cache_ is used for the
+  //! image if it is in the dyld shared cache with UUID \a shared_cache_uuid
+  //! that is mapped at \a shared_cache_address.
+  //!
+  //! \return The reader, or `nullptr` if it could not be initialized.
+  std::unique_ptr<MachOImageReader> CreateModuleReader(
+      mach_vm_address_t address,
+      const std::string& name,
+      const UUID& shared_cache_uuid,
+      mach_vm_address_t shared_cache_address);
+
   //! \brief Calculates the base address and size of the region used as a
   //!     thread’s stack.
   //!
@@ -254,7 +298,9 @@ class ProcessReaderMac {
   std::vector<Module> modules_;
   std::vector<std::unique_ptr<MachOImageReader>> module_readers_;
   ProcessMemoryMac process_memory_;
+  MachOImageHeaderCache* header_cache_;  // weak
   task_t task_;  // weak
+  unsigned int thread_initialization_threads_;
   InitializationStateDcheck initialized_;
 
 #if defined(CRASHPAD_MAC_32_BIT_SUPPORT)
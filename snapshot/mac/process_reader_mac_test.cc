@@ -482,11 +482,13 @@ uint64_t GetThreadID() {
 
 class ProcessReaderThreadedChild final : public MachMultiprocess {
  public:
-  explicit ProcessReaderThreadedChild(const std::string thread_name_prefix,
-                                      size_t thread_count)
+  ProcessReaderThreadedChild(const std::string thread_name_prefix,
+                             size_t thread_count,
+                             unsigned int thread_initialization_threads = 1)
       : MachMultiprocess(),
         thread_name_prefix_(thread_name_prefix),
-        thread_count_(thread_count) {}
+        thread_count_(thread_count),
+        thread_initialization_threads_(thread_initialization_threads) {}
 
   ProcessReaderThreadedChild(const ProcessReaderThreadedChild&) = delete;
   ProcessReaderThreadedChild& operator=(const ProcessReaderThreadedChild&) =
@@ -497,7 +499,8 @@ class ProcessReaderThreadedChild final : public MachMultiprocess {
  private:
   void MachMultiprocessParent() override {
     ProcessReaderMac process_reader;
-    ASSERT_TRUE(process_reader.Initialize(ChildTask()));
+    ASSERT_TRUE(
+        process_reader.Initialize(ChildTask(), thread_initialization_threads_));
 
     FileHandle read_handle = ReadPipeHandle();
 
@@ -614,6 +617,7 @@ class ProcessReaderThreadedChild final : public MachMultiprocess {
 
   const std::string thread_name_prefix_;
   size_t thread_count_;
+  unsigned int thread_initialization_threads_;
 };
 
 TEST(ProcessReaderMac, ChildOneThread) {
@@ -631,6 +635,16 @@ TEST(ProcessReaderMac, ChildSeveralThreads) {
   process_reader_threaded_child.Run();
 }
 
+TEST(ProcessReaderMac, ChildSeveralThreadsInitializedConcurrently) {
+  constexpr size_t kChildThreads = 64;
+  constexpr unsigned int kThreadInitializationThreads = 4;
+  ProcessReaderThreadedChild process_reader_threaded_child(
+      "ChildSeveralThreadsInitializedConcurrently",
+      kChildThreads,
+      kThreadInitializationThreads);
+  process_reader_threaded_child.Run();
+}
+
 template <typename T>
 T GetDyldFunction(const char* symbol) {
   static void* dl_handle = []() -> void* {
@@ -38,7 +38,9 @@ ProcessSnapshotMac::ProcessSnapshotMac()
 ProcessSnapshotMac::~ProcessSnapshotMac() {
 }
 
-bool ProcessSnapshotMac::Initialize(task_t task) {
+bool ProcessSnapshotMac::Initialize(task_t task,
+                                    unsigned int thread_snapshot_threads,
+                                    MachOImageHeaderCache* header_cache) {
   INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
 
   if (gettimeofday(&snapshot_time_, nullptr) != 0) {
@@ -46,7 +48,8 @@ bool ProcessSnapshotMac::Initialize(task_t task) {
     return false;
   }
 
-  if (!process_reader_.Initialize(task)) {
+  if (!process_reader_.Initialize(
+          task, thread_snapshot_threads, header_cache)) {
     return false;
   }
 
@@ -126,6 +129,37 @@ void ProcessSnapshotMac::GetCrashpadOptions(
   *options = local_options;
 }
 
+void ProcessSnapshotMac::PreserveMemory() {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+
+  std::vector<const MemorySnapshot*> memory;
+  for (const auto& thread : threads_) {
+    memory.push_back(thread->Stack());
+    for (const MemorySnapshot* extra_memory : thread->ExtraMemory()) {
+      memory.push_back(extra_memory);
+    }
+  }
+  for (const auto& module : modules_) {
+    for (const MemorySnapshot* extra_memory : module->ExtraMemory()) {
+      memory.push_back(extra_memory);
+    }
+  }
+  if (exception_) {
+    for (const MemorySnapshot* extra_memory : exception_->ExtraMemory()) {
+      memory.push_back(extra_memory);
+    }
+  }
+
+  // Memory that can’t be preserved is read from the task when it’s needed, as
+  // it would be without preserving.
+  const ProcessMemoryMac* process_memory = process_reader_.Memory();
+  for (const MemorySnapshot* snapshot : memory) {
+    if (snapshot) {
+      process_memory->PreserveRegion(snapshot->Address(), snapshot->Size());
+    }
+  }
+}
+
 pid_t ProcessSnapshotMac::ProcessID() const {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
   return process_reader_.ProcessID();
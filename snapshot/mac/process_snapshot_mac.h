@@ -28,6 +28,7 @@
 #include "snapshot/crashpad_info_client_options.h"
 #include "snapshot/exception_snapshot.h"
 #include "snapshot/mac/exception_snapshot_mac.h"
+#include "snapshot/mac/mach_o_image_header_cache.h"
 #include "snapshot/mac/module_snapshot_mac.h"
 #include "snapshot/mac/process_reader_mac.h"
 #include "snapshot/mac/system_snapshot_mac.h"
@@ -58,10 +59,18 @@ class ProcessSnapshotMac final : public ProcessSnapshot {
   //! \brief Initializes the object.
   //!
   //! \param[in] task The task to create a snapshot from.
+  //! \param[in] thread_snapshot_threads The number of threads, including the
+  //!     calling thread, used to gather the registers and other details of the
+  //!     task’s threads, passed to ProcessReaderMac::Initialize().
+  //! \param[in] header_cache A cache of the headers of images in the dyld
+  //!     shared cache, shared with other snapshots, passed to
+  //!     ProcessReaderMac::Initialize(). Optional, may be `nullptr`.
   //!
   //! \return `true` if the snapshot could be created, `false` otherwise with
   //!     an appropriate message logged.
-  bool Initialize(task_t task);
+  bool Initialize(task_t task,
+                  unsigned int thread_snapshot_threads = 1,
+                  MachOImageHeaderCache* header_cache = nullptr);
 
   //! \brief Initializes the object’s exception.
   //!
@@ -115,6 +124,17 @@ class ProcessSnapshotMac final : public ProcessSnapshot {
   //!     the process.
   void GetCrashpadOptions(CrashpadInfoClientOptions* options);
 
+  //! \brief Preserves copy-on-write copies of the memory that the snapshot’s
+  //!     MemorySnapshot objects read, so that the task may be resumed before
+  //!     they’re read.
+  //!
+  //! The memory of thread stacks, and the extra memory of threads, modules,
+  //! and the exception, is preserved with ProcessMemoryMac::PreserveRegion().
+  //! Reads of that memory afterwards see its contents as of this call. This
+  //! should be called while the task is suspended, after InitializeException()
+  //! if an exception is to be included.
+  void PreserveMemory();
+
   // ProcessSnapshot:
 
   pid_t ProcessID() const override;
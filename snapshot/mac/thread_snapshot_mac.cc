@@ -133,5 +133,13 @@ std::vector<const MemorySnapshot*> ThreadSnapshotMac::ExtraMemory() const {
   return std::vector<const MemorySnapshot*>();
 }
 
+uint64_t ThreadSnapshotMac::UncapturedStackSize() const {
+  return 0;
+}
+
+std::vector<uint64_t> ThreadSnapshotMac::UnwoundFrames() const {
+  return std::vector<uint64_t>();
+}
+
 }  // namespace internal
 }  // namespace crashpad
@@ -67,6 +67,8 @@ class ThreadSnapshotMac final : public ThreadSnapshot {
   int Priority() const override;
   uint64_t ThreadSpecificDataAddress() const override;
   std::vector<const MemorySnapshot*> ExtraMemory() const override;
+  uint64_t UncapturedStackSize() const override;
+  std::vector<uint64_t> UnwoundFrames() const override;
 
  private:
   union {
@@ -18,6 +18,7 @@
 
 #include "base/format_macros.h"
 #include "base/logging.h"
+#include "base/notreached.h"
 #include "base/strings/stringprintf.h"
 #include "util/numeric/checked_range.h"
 
@@ -81,6 +82,15 @@ bool DetermineMergedRangeImpl(bool log,
 
 }  // namespace
 
+bool MemorySnapshot::SupportsReadRange() const {
+  return false;
+}
+
+bool MemorySnapshot::ReadRange(size_t offset, size_t size, void* buffer) const {
+  NOTREACHED();
+  return false;
+}
+
 bool LoggingDetermineMergedRange(const MemorySnapshot* a,
                                  const MemorySnapshot* b,
                                  CheckedRange<uint64_t, size_t>* merged) {
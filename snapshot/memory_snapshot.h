@@ -75,6 +75,27 @@ class MemorySnapshot {
   //!     success and `false` on failure.
   virtual bool Read(Delegate* delegate) const = 0;
 
+  //! \brief Returns `true` if ReadRange() is supported.
+  //!
+  //! The default implementation returns `false`.
+  virtual bool SupportsReadRange() const;
+
+  //! \brief Copies part of the memory snapshot’s data into a caller-provided
+  //!     buffer.
+  //!
+  //! This allows a large memory snapshot to be consumed in pieces, without
+  //! holding all of its data in memory at once as Read() may. It may only be
+  //! called if SupportsReadRange() returns `true`.
+  //!
+  //! \param[in] offset The offset, from Address(), of the data to read.
+  //! \param[in] size The number of bytes to read. \a offset + \a size must not
+  //!     exceed Size().
+  //! \param[out] buffer The buffer into which the data is copied. It must be
+  //!     at least \a size bytes.
+  //!
+  //! \return `true` on success, `false` on failure with a message logged.
+  virtual bool ReadRange(size_t offset, size_t size, void* buffer) const;
+
   //! \brief Creates a new MemorySnapshot based on merging this one with \a
   //!     other.
   //!
@@ -0,0 +1,115 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "snapshot/memory_snapshot_batch.h"
+
+#include <algorithm>
+#include <ios>
+#include <utility>
+
+#include "base/check_op.h"
+#include "base/logging.h"
+
+namespace crashpad {
+namespace internal {
+
+MemorySnapshotBatch::MemorySnapshotBatch(const ProcessMemory* process_memory)
+    : regions_(), process_memory_(process_memory) {}
+
+MemorySnapshotBatch::~MemorySnapshotBatch() = default;
+
+size_t MemorySnapshotBatch::AddRegion(VMAddress address, size_t size) {
+  Region region;
+  region.address = address;
+  region.size = size;
+  region.fetched = false;
+  region.succeeded = false;
+  regions_.push_back(std::move(region));
+  return regions_.size() - 1;
+}
+
+bool MemorySnapshotBatch::ReadRegion(size_t index,
+                                     MemorySnapshot::Delegate* delegate) {
+  DCHECK_LT(index, regions_.size());
+  Region& region = regions_[index];
+
+  if (!region.fetched) {
+    FetchPendingRegions(index);
+  }
+  DCHECK(region.fetched);
+
+  if (!region.succeeded) {
+    LOG(ERROR) << "failed to read " << region.size << " bytes at 0x"
+               << std::hex << region.address;
+    return false;
+  }
+
+  std::unique_ptr<uint8_t[]> data(std::move(region.data));
+  if (!data) {
+    // The region’s contents were already supplied to a delegate and discarded.
+    // Read it again on its own.
+    data.reset(new uint8_t[region.size]);
+    if (!process_memory_->Read(region.address, region.size, data.get())) {
+      return false;
+    }
+  }
+  return delegate->MemorySnapshotDelegateRead(data.get(), region.size);
+}
+
+void MemorySnapshotBatch::DiscardRegion(size_t index) {
+  DCHECK_LT(index, regions_.size());
+  Region& region = regions_[index];
+  region.fetched = true;
+  region.succeeded = false;
+  region.data.reset();
+}
+
+void MemorySnapshotBatch::FetchPendingRegions(size_t first_index) {
+  std::vector<ProcessMemory::BatchRead> reads;
+  std::vector<Region*> pending;
+  size_t batch_size = 0;
+  for (size_t index = first_index; index < regions_.size(); ++index) {
+    Region& region = regions_[index];
+    if (region.fetched) {
+      continue;
+    }
+    if (!pending.empty() && region.size > kMaxBatchSize - batch_size) {
+      break;
+    }
+    batch_size += std::min(region.size, kMaxBatchSize);
+    region.data.reset(new uint8_t[region.size]);
+
+    ProcessMemory::BatchRead read;
+    read.address = region.address;
+    read.size = region.size;
+    read.buffer = region.data.get();
+    read.succeeded = false;
+    reads.push_back(read);
+    pending.push_back(&region);
+  }
+
+  process_memory_->ReadBatch(&reads);
+
+  for (size_t index = 0; index < pending.size(); ++index) {
+    Region* region = pending[index];
+    region->fetched = true;
+    region->succeeded = reads[index].succeeded;
+    if (!region->succeeded) {
+      region->data.reset();
+    }
+  }
+}
+
+}  // namespace internal
+}  // namespace crashpad
@@ -0,0 +1,108 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_SNAPSHOT_MEMORY_SNAPSHOT_BATCH_H_
+#define CRASHPAD_SNAPSHOT_MEMORY_SNAPSHOT_BATCH_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+#include <memory>
+#include <vector>
+
+#include "snapshot/memory_snapshot.h"
+#include "util/misc/address_types.h"
+#include "util/process/process_memory.h"
+
+namespace crashpad {
+namespace internal {
+
+//! \brief Collects many small memory regions of a process so that they can be
+//!     read with a single ProcessMemory::ReadBatch() call.
+//!
+//! Regions are still read lazily: nothing is read until the first region is
+//! requested with ReadRegion(). At that point, the requested region and the
+//! regions added after it that have not been read are read at once, up to
+//! kMaxBatchSize bytes. The contents of each region are held until the region
+//! is requested, at which point they are discarded.
+//!
+//! This is intended for the many small regions captured around pointer-like
+//! values, which would otherwise each require a separate system call when a
+//! minidump is written.
+class MemorySnapshotBatch {
+ public:
+  //! \brief The largest number of bytes read, and held, by a single batch,
+  //!     unless a single region is larger.
+  static constexpr size_t kMaxBatchSize = 1024 * 1024;
+
+  //! \param[in] process_memory A reader for the process being snapshotted.
+  explicit MemorySnapshotBatch(const ProcessMemory* process_memory);
+
+  MemorySnapshotBatch(const MemorySnapshotBatch&) = delete;
+  MemorySnapshotBatch& operator=(const MemorySnapshotBatch&) = delete;
+
+  ~MemorySnapshotBatch();
+
+  //! \brief Adds a region to the batch.
+  //!
+  //! \param[in] address The base address of the region, in the snapshot
+  //!     process’ address space.
+  //! \param[in] size The size of the region.
+  //!
+  //! \return An identifier for the region, to be passed to ReadRegion().
+  size_t AddRegion(VMAddress address, size_t size);
+
+  //! \brief Reads a region previously added by AddRegion(), supplying its
+  //!     contents to \a delegate as MemorySnapshot::Read() would.
+  //!
+  //! \param[in] region The identifier returned by AddRegion().
+  //! \param[in] delegate The object to receive the region’s contents.
+  //!
+  //! \return `false` if the region could not be read, with a message logged.
+  //!     Otherwise, the return value of
+  //!     MemorySnapshot::Delegate::MemorySnapshotDelegateRead().
+  bool ReadRegion(size_t region, MemorySnapshot::Delegate* delegate);
+
+  //! \brief Drops a region previously added by AddRegion() that is no longer
+  //!     needed, so that it isn’t read with the rest of the batch.
+  //!
+  //! \param[in] region The identifier returned by AddRegion(). It must not be
+  //!     passed to ReadRegion() afterwards.
+  void DiscardRegion(size_t region);
+
+  //! \return The reader for the process being snapshotted.
+  const ProcessMemory* Memory() const { return process_memory_; }
+
+ private:
+  struct Region {
+    VMAddress address;
+    size_t size;
+    std::unique_ptr<uint8_t[]> data;
+    bool fetched;
+    bool succeeded;
+  };
+
+  // Reads the region at first_index, and as many of the regions that follow it
+  // and have not been fetched yet as fit in kMaxBatchSize.
+  void FetchPendingRegions(size_t first_index);
+
+  std::vector<Region> regions_;
+  const ProcessMemory* process_memory_;  // weak
+};
+
+}  // namespace internal
+}  // namespace crashpad
+
+#endif  // CRASHPAD_SNAPSHOT_MEMORY_SNAPSHOT_BATCH_H_
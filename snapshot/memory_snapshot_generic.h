@@ -21,6 +21,7 @@
 #include "base/logging.h"
 #include "base/numerics/safe_math.h"
 #include "snapshot/memory_snapshot.h"
+#include "snapshot/memory_snapshot_batch.h"
 #include "util/misc/address_types.h"
 #include "util/misc/initialization_state_dcheck.h"
 #include "util/process/process_memory.h"
@@ -55,11 +56,48 @@ class MemorySnapshotGeneric final : public MemorySnapshot {
                   VMSize size) {
     INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
     process_memory_ = process_memory;
+    batch_ = nullptr;
+    batch_region_ = 0;
     address_ = address;
     size_ = base::checked_cast<size_t>(size);
     INITIALIZATION_STATE_SET_VALID(initialized_);
   }
 
+  //! \brief Initializes the object as a region of \a batch.
+  //!
+  //! Memory is read lazily, as with Initialize(), but the first Read() of any
+  //! region of \a batch reads all of the batch’s regions at once.
+  //!
+  //! \param[in] batch The batch to add this memory region to. It must outlive
+  //!     this object.
+  //! \param[in] address The base address of the memory region to snapshot, in
+  //!     the snapshot process’ address space.
+  //! \param[in] size The size of the memory region to snapshot.
+  void InitializeWithBatch(MemorySnapshotBatch* batch,
+                           VMAddress address,
+                           VMSize size) {
+    INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
+    process_memory_ = batch->Memory();
+    address_ = address;
+    size_ = base::checked_cast<size_t>(size);
+    batch_ = batch;
+    batch_region_ = batch_->AddRegion(address_, size_);
+    INITIALIZATION_STATE_SET_VALID(initialized_);
+  }
+
+  //! \brief Drops this object’s region of its batch, for an object initialized
+  //!     by InitializeWithBatch() whose memory is no longer wanted.
+  //!
+  //! This object must not be read afterwards. It is intended to be called just
+  //! before the object is destroyed, which by itself leaves the region to be
+  //! read with the rest of the batch.
+  void DiscardBatchRegion() {
+    INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+    if (batch_) {
+      batch_->DiscardRegion(batch_region_);
+    }
+  }
+
   // MemorySnapshot:
 
   uint64_t Address() const override {
@@ -79,6 +117,10 @@ class MemorySnapshotGeneric final : public MemorySnapshot {
       return delegate->MemorySnapshotDelegateRead(nullptr, size_);
     }
 
+    if (batch_) {
+      return batch_->ReadRegion(batch_region_, delegate);
+    }
+
     std::unique_ptr<uint8_t[]> buffer(new uint8_t[size_]);
     if (!process_memory_->Read(address_, size_, buffer.get())) {
       return false;
@@ -86,6 +128,22 @@ class MemorySnapshotGeneric final : public MemorySnapshot {
     return delegate->MemorySnapshotDelegateRead(buffer.get(), size_);
   }
 
+  bool SupportsReadRange() const override {
+    INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+
+    // Batched regions are small and are read along with the rest of their
+    // batch.
+    return !batch_;
+  }
+
+  bool ReadRange(size_t offset, size_t size, void* buffer) const override {
+    INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+    DCHECK(!batch_);
+    DCHECK_LE(offset, size_);
+    DCHECK_LE(size, size_ - offset);
+    return process_memory_->Read(address_ + offset, size, buffer);
+  }
+
   const MemorySnapshot* MergeWithOtherSnapshot(
       const MemorySnapshot* other) const override {
     const MemorySnapshotGeneric* other_as_memory_snapshot_concrete =
@@ -110,6 +168,8 @@ class MemorySnapshotGeneric final : public MemorySnapshot {
       const MemorySnapshot* other);
 
   const ProcessMemory* process_memory_;  // weak
+  MemorySnapshotBatch* batch_;  // weak
+  size_t batch_region_;
   VMAddress address_;
   size_t size_;
   InitializationStateDcheck initialized_;
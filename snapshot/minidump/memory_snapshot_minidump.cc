@@ -14,23 +14,33 @@
 
 #include "snapshot/minidump/memory_snapshot_minidump.h"
 
+#include <stdio.h>
+#include <string.h>
+
+#include <algorithm>
 #include <memory>
 
+#include "base/logging.h"
 #include "base/numerics/safe_math.h"
+#include "util/numeric/safe_assignment.h"
 
 namespace crashpad {
 namespace internal {
 
 MemorySnapshotMinidump::MemorySnapshotMinidump()
     : MemorySnapshot(),
+      file_reader_(nullptr),
+      file_data_(nullptr),
       address_(0),
-      data_(),
+      size_(0),
+      segments_(),
       initialized_() {}
 
 MemorySnapshotMinidump::~MemorySnapshotMinidump() {}
 
 bool MemorySnapshotMinidump::Initialize(FileReaderInterface* file_reader,
-                                        RVA location) {
+                                        RVA location,
+                                        const uint8_t* file_data) {
   INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
 
   MINIDUMP_MEMORY_DESCRIPTOR descriptor;
@@ -43,14 +53,30 @@ bool MemorySnapshotMinidump::Initialize(FileReaderInterface* file_reader,
     return false;
   }
 
-  address_ = descriptor.StartOfMemoryRange;
-  data_.resize(descriptor.Memory.DataSize);
-
-  if (!file_reader->SeekSet(descriptor.Memory.Rva)) {
+  if (!InitializeWithData(file_reader,
+                          descriptor.StartOfMemoryRange,
+                          descriptor.Memory.Rva,
+                          descriptor.Memory.DataSize,
+                          file_data)) {
     return false;
   }
 
-  if (!file_reader->ReadExactly(data_.data(), data_.size())) {
+  INITIALIZATION_STATE_SET_VALID(initialized_);
+  return true;
+}
+
+bool MemorySnapshotMinidump::InitializeFromMemory64(
+    FileReaderInterface* file_reader,
+    const MINIDUMP_MEMORY_DESCRIPTOR64& descriptor,
+    uint64_t data_offset,
+    const uint8_t* file_data) {
+  INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
+
+  if (!InitializeWithData(file_reader,
+                          descriptor.StartOfMemoryRange,
+                          data_offset,
+                          descriptor.DataSize,
+                          file_data)) {
     return false;
   }
 
@@ -58,6 +84,39 @@ bool MemorySnapshotMinidump::Initialize(FileReaderInterface* file_reader,
   return true;
 }
 
+bool MemorySnapshotMinidump::InitializeWithData(
+    FileReaderInterface* file_reader,
+    uint64_t address,
+    uint64_t data_offset,
+    uint64_t size,
+    const uint8_t* file_data) {
+  // Make sure that the data is present so that a truncated file is still
+  // detected here, although the data isn’t read until it’s needed.
+  const FileOffset file_size = file_reader->Seek(0, SEEK_END);
+  if (file_size < 0) {
+    return false;
+  }
+  if (data_offset > static_cast<uint64_t>(file_size) ||
+      size > static_cast<uint64_t>(file_size) - data_offset) {
+    LOG(ERROR) << "memory data out of range";
+    return false;
+  }
+
+  if (!AssignIfInRange(&size_, size)) {
+    LOG(ERROR) << "memory size " << size << " out of range";
+    return false;
+  }
+
+  file_reader_ = file_reader;
+  file_data_ = file_data;
+  address_ = address;
+  if (size_ > 0) {
+    segments_.push_back({static_cast<FileOffset>(data_offset), size_});
+  }
+
+  return true;
+}
+
 uint64_t MemorySnapshotMinidump::Address() const {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
   return address_;
@@ -65,13 +124,64 @@ uint64_t MemorySnapshotMinidump::Address() const {
 
 size_t MemorySnapshotMinidump::Size() const {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
-  return data_.size();
+  return size_;
 }
 
 bool MemorySnapshotMinidump::Read(Delegate* delegate) const {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
-  return delegate->MemorySnapshotDelegateRead(
-      const_cast<uint8_t*>(data_.data()), data_.size());
+
+  if (size_ == 0) {
+    return delegate->MemorySnapshotDelegateRead(nullptr, size_);
+  }
+
+  // Delegates may modify the data they’re given, so it’s always copied, even
+  // out of file_data_.
+  std::unique_ptr<uint8_t[]> buffer(new uint8_t[size_]);
+  if (!ReadRange(0, size_, buffer.get())) {
+    return false;
+  }
+
+  return delegate->MemorySnapshotDelegateRead(buffer.get(), size_);
+}
+
+bool MemorySnapshotMinidump::SupportsReadRange() const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  return true;
+}
+
+bool MemorySnapshotMinidump::ReadRange(size_t offset,
+                                       size_t size,
+                                       void* buffer) const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  DCHECK_LE(offset, size_);
+  DCHECK_LE(size, size_ - offset);
+
+  uint8_t* buffer_bytes = static_cast<uint8_t*>(buffer);
+  for (const Segment& segment : segments_) {
+    if (size == 0) {
+      break;
+    }
+    if (offset >= segment.size) {
+      offset -= segment.size;
+      continue;
+    }
+
+    const size_t segment_size = std::min(segment.size - offset, size);
+    const FileOffset segment_offset =
+        segment.offset + static_cast<FileOffset>(offset);
+    if (file_data_) {
+      memcpy(buffer_bytes, file_data_ + segment_offset, segment_size);
+    } else if (!file_reader_->SeekSet(segment_offset) ||
+               !file_reader_->ReadExactly(buffer_bytes, segment_size)) {
+      return false;
+    }
+    buffer_bytes += segment_size;
+    size -= segment_size;
+    offset = 0;
+  }
+  DCHECK_EQ(size, 0u);
+
+  return true;
 }
 
 const MemorySnapshot* MemorySnapshotMinidump::MergeWithOtherSnapshot(
@@ -87,23 +197,48 @@ const MemorySnapshot* MemorySnapshotMinidump::MergeWithOtherSnapshot(
     return other_cast->MergeWithOtherSnapshot(this);
   }
 
+  // Snapshots whose data is in memory may have been made through different file
+  // readers of that memory.
+  if (file_data_ ? other_cast->file_data_ != file_data_
+                 : (other_cast->file_reader_ != file_reader_ ||
+                    other_cast->file_data_)) {
+    LOG(ERROR) << "different file_reader_ for snapshots";
+    return nullptr;
+  }
+
   CheckedRange<uint64_t, size_t> merged(0, 0);
   if (!LoggingDetermineMergedRange(this, other, &merged)) {
     return nullptr;
   }
 
   auto result = std::make_unique<MemorySnapshotMinidump>();
+  INITIALIZATION_STATE_SET_INITIALIZING(result->initialized_);
+  result->file_reader_ = file_reader_;
+  result->file_data_ = file_data_;
   result->address_ = merged.base();
-  result->data_ = data_;
-
-  if (result->data_.size() == merged.size()) {
-    return result.release();
+  result->size_ = merged.size();
+
+  if (size_ == merged.size()) {
+    result->segments_ = segments_;
+  } else {
+    // Take this snapshot’s data up to where other’s begins, and all of other’s
+    // data after that.
+    size_t remaining =
+        base::checked_cast<size_t>(other_cast->address_ - address_);
+    for (const Segment& segment : segments_) {
+      if (remaining == 0) {
+        break;
+      }
+      const size_t size = std::min(segment.size, remaining);
+      result->segments_.push_back({segment.offset, size});
+      remaining -= size;
+    }
+    result->segments_.insert(result->segments_.end(),
+                             other_cast->segments_.begin(),
+                             other_cast->segments_.end());
   }
 
-  result->data_.resize(
-      base::checked_cast<size_t>(other_cast->address_ - address_));
-  result->data_.insert(result->data_.end(), other_cast->data_.begin(),
-                       other_cast->data_.end());
+  INITIALIZATION_STATE_SET_VALID(result->initialized_);
   return result.release();
 }
 
@@ -17,6 +17,7 @@
 
 #include <windows.h>
 #include <dbghelp.h>
+#include <stdint.h>
 
 #include <vector>
 
@@ -26,6 +27,8 @@
 
 namespace crashpad {
 namespace internal {
+
+//! \brief A MemorySnapshot based on a memory range in a minidump file.
 class MemorySnapshotMinidump : public MemorySnapshot {
  public:
   MemorySnapshotMinidump();
@@ -37,24 +40,73 @@ class MemorySnapshotMinidump : public MemorySnapshot {
 
   //! \brief Initializes the object.
   //!
+  //! Only the memory descriptor is read here. The memory itself is read from
+  //! \a file_reader when Read() is called, and is discarded when Read()
+  //! returns. If \a file_data is provided, the memory is instead copied
+  //! straight out of \a file_data, without reading from \a file_reader.
+  //!
   //! \param[in] file_reader A file reader corresponding to a minidump file.
-  //!     The file reader must support seeking.
+  //!     The file reader must support seeking, and must outlive this object.
   //! \param[in] location The location within the file where we will find a
   //!     MINIDUMP_MEMORY_DESCRIPTOR from which to initialize this object.
+  //! \param[in] file_data The entire contents of the file that \a file_reader
+  //!     reads, such as a MappedFileReader’s mapping, or `nullptr`. If
+  //!     provided, this must outlive this object.
   //!
   //! \return `true` if the snapshot could be created, `false` otherwise with
   //!     an appropriate message logged.
-  bool Initialize(FileReaderInterface* file_reader, RVA location);
+  bool Initialize(FileReaderInterface* file_reader,
+                  RVA location,
+                  const uint8_t* file_data = nullptr);
+
+  //! \brief Initializes the object from a MINIDUMP_MEMORY64_LIST entry.
+  //!
+  //! As with Initialize(), the memory itself is read when it is needed.
+  //!
+  //! \param[in] file_reader A file reader corresponding to a minidump file.
+  //!     The file reader must support seeking, and must outlive this object.
+  //! \param[in] descriptor The MINIDUMP_MEMORY_DESCRIPTOR64 identifying the
+  //!     memory range.
+  //! \param[in] data_offset The location within the file of the memory range’s
+  //!     data, which is not carried in \a descriptor.
+  //! \param[in] file_data As for Initialize().
+  //!
+  //! \return `true` if the snapshot could be created, `false` otherwise with
+  //!     an appropriate message logged.
+  bool InitializeFromMemory64(FileReaderInterface* file_reader,
+                              const MINIDUMP_MEMORY_DESCRIPTOR64& descriptor,
+                              uint64_t data_offset,
+                              const uint8_t* file_data = nullptr);
 
   uint64_t Address() const override;
   size_t Size() const override;
   bool Read(Delegate* delegate) const override;
+  bool SupportsReadRange() const override;
+  bool ReadRange(size_t offset, size_t size, void* buffer) const override;
   const MemorySnapshot* MergeWithOtherSnapshot(
       const MemorySnapshot* other) const override;
 
  private:
+  // Checks that size bytes of data at data_offset are within the file, and
+  // initializes the object to refer to them.
+  bool InitializeWithData(FileReaderInterface* file_reader,
+                          uint64_t address,
+                          uint64_t data_offset,
+                          uint64_t size,
+                          const uint8_t* file_data);
+
+  // A run of the snapshot’s data stored contiguously in the minidump file.
+  // Merged snapshots consist of several of these, one following the other.
+  struct Segment {
+    FileOffset offset;
+    size_t size;
+  };
+
+  FileReaderInterface* file_reader_;  // weak
+  const uint8_t* file_data_;  // weak
   uint64_t address_;
-  std::vector<uint8_t> data_;
+  size_t size_;
+  std::vector<Segment> segments_;
   InitializationStateDcheck initialized_;
 };
 
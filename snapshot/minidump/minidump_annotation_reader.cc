@@ -115,5 +115,51 @@ bool ReadMinidumpAnnotationList(FileReaderInterface* file_reader,
   return true;
 }
 
+bool ReadMinidumpAnnotationThreadList(
+    FileReaderInterface* file_reader,
+    const MINIDUMP_LOCATION_DESCRIPTOR& location,
+    std::vector<AnnotationSnapshot>* list) {
+  if (location.Rva == 0) {
+    return true;
+  }
+
+  if (location.DataSize < sizeof(MinidumpAnnotationThreadList)) {
+    LOG(ERROR) << "annotation thread list size mismatch";
+    return false;
+  }
+
+  if (!file_reader->SeekSet(location.Rva)) {
+    return false;
+  }
+
+  uint32_t count;
+  if (!file_reader->ReadExactly(&count, sizeof(count))) {
+    return false;
+  }
+
+  if (count != list->size()) {
+    LOG(ERROR) << "annotation thread count mismatch";
+    return false;
+  }
+
+  if (location.DataSize !=
+      sizeof(MinidumpAnnotationThreadList) + count * sizeof(uint64_t)) {
+    LOG(ERROR) << "annotation thread size mismatch";
+    return false;
+  }
+
+  std::vector<uint64_t> thread_ids(count);
+  if (!file_reader->ReadExactly(thread_ids.data(),
+                                count * sizeof(uint64_t))) {
+    return false;
+  }
+
+  for (size_t i = 0; i < count; ++i) {
+    (*list)[i].thread_id = thread_ids[i];
+  }
+
+  return true;
+}
+
 }  // namespace internal
 }  // namespace crashpad
@@ -35,6 +35,20 @@ bool ReadMinidumpAnnotationList(FileReaderInterface* file_reader,
                                 const MINIDUMP_LOCATION_DESCRIPTOR& location,
                                 std::vector<AnnotationSnapshot>* list);
 
+//! \brief Reads a MinidumpAnnotationThreadList from a minidump file at \a
+//!     location in \a file_reader, and sets AnnotationSnapshot::thread_id of
+//!     each object in \a list from it.
+//!
+//! \a list must have been read by ReadMinidumpAnnotationList() from the
+//! MinidumpAnnotationList corresponding to this MinidumpAnnotationThreadList.
+//!
+//! \return `true` on success, with \a list updated. `false` on failure, with a
+//!     message logged.
+bool ReadMinidumpAnnotationThreadList(
+    FileReaderInterface* file_reader,
+    const MINIDUMP_LOCATION_DESCRIPTOR& location,
+    std::vector<AnnotationSnapshot>* list);
+
 }  // namespace internal
 }  // namespace crashpad
 
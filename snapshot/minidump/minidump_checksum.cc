@@ -0,0 +1,92 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "snapshot/minidump/minidump_checksum.h"
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "base/logging.h"
+#include "minidump/minidump_extensions.h"
+#include "third_party/zlib/zlib_crashpad.h"
+
+namespace crashpad {
+
+MinidumpChecksumResult CheckMinidumpChecksum(FileReaderInterface* file_reader) {
+  const FileOffset start_offset = file_reader->SeekGet();
+  MINIDUMP_HEADER header;
+  if (start_offset < 0 ||
+      !file_reader->ReadExactly(&header, sizeof(header)) ||
+      header.Signature != MINIDUMP_SIGNATURE ||
+      header.Version != MINIDUMP_VERSION ||
+      !file_reader->SeekSet(start_offset + header.StreamDirectoryRva)) {
+    return MinidumpChecksumResult::kNone;
+  }
+
+  // The checksum is the last stream written, but is looked for anywhere in the
+  // directory.
+  MINIDUMP_LOCATION_DESCRIPTOR location = {};
+  bool found = false;
+  for (uint32_t index = 0; index < header.NumberOfStreams; ++index) {
+    MINIDUMP_DIRECTORY directory;
+    if (!file_reader->ReadExactly(&directory, sizeof(directory))) {
+      return MinidumpChecksumResult::kNone;
+    }
+    if (directory.StreamType == kMinidumpStreamTypeCrashpadChecksum) {
+      location = directory.Location;
+      found = true;
+    }
+  }
+  if (!found) {
+    return MinidumpChecksumResult::kNone;
+  }
+
+  MinidumpChecksum checksum;
+  if (location.DataSize < sizeof(checksum) ||
+      location.Rva < sizeof(header) ||
+      !file_reader->SeekSet(start_offset + location.Rva) ||
+      !file_reader->ReadExactly(&checksum, sizeof(checksum))) {
+    LOG(ERROR) << "minidump checksum unreadable";
+    return MinidumpChecksumResult::kMismatch;
+  }
+  if (checksum.Version != MinidumpChecksum::kVersion) {
+    return MinidumpChecksumResult::kNone;
+  }
+
+  if (!file_reader->SeekSet(start_offset + sizeof(header))) {
+    return MinidumpChecksumResult::kNone;
+  }
+  uLong crc = crc32(0, nullptr, 0);
+  std::vector<uint8_t> buffer(64 * 1024);
+  size_t remaining = location.Rva - sizeof(header);
+  while (remaining > 0) {
+    const size_t size = std::min(remaining, buffer.size());
+    if (!file_reader->ReadExactly(buffer.data(), size)) {
+      LOG(ERROR) << "minidump truncated";
+      return MinidumpChecksumResult::kMismatch;
+    }
+    crc = crc32(crc, buffer.data(), static_cast<uInt>(size));
+    remaining -= size;
+  }
+
+  if (static_cast<uint32_t>(crc) != checksum.Crc32) {
+    LOG(ERROR) << "minidump checksum mismatch";
+    return MinidumpChecksumResult::kMismatch;
+  }
+  return MinidumpChecksumResult::kMatch;
+}
+
+}  // namespace crashpad
@@ -0,0 +1,50 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_SNAPSHOT_MINIDUMP_MINIDUMP_CHECKSUM_H_
+#define CRASHPAD_SNAPSHOT_MINIDUMP_MINIDUMP_CHECKSUM_H_
+
+#include "util/file/file_reader.h"
+
+namespace crashpad {
+
+//! \brief The result of CheckMinidumpChecksum().
+enum class MinidumpChecksumResult {
+  //! \brief The minidump doesn’t carry a checksum that can be checked.
+  kNone,
+
+  //! \brief The minidump’s contents match its checksum.
+  kMatch,
+
+  //! \brief The minidump’s contents don’t match its checksum, or are
+  //!     truncated, so it was corrupted after it was written.
+  kMismatch,
+};
+
+//! \brief Checks a minidump against the checksum written by
+//!     MinidumpFileWriter::SetWriteChecksum().
+//!
+//! The minidump is read once, from the end of its header to the start of its
+//! MinidumpChecksum.
+//!
+//! \param[in] file_reader The minidump, positioned at its start. It is left at
+//!     an unspecified position.
+//!
+//! \return A MinidumpChecksumResult. A message is logged for
+//!     MinidumpChecksumResult::kMismatch.
+MinidumpChecksumResult CheckMinidumpChecksum(FileReaderInterface* file_reader);
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_SNAPSHOT_MINIDUMP_MINIDUMP_CHECKSUM_H_
@@ -0,0 +1,63 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "snapshot/minidump/minidump_compression.h"
+
+#include <stdint.h>
+
+#include <memory>
+
+#include "util/stream/file_writer_output_stream.h"
+#include "util/stream/zlib_output_stream.h"
+
+namespace crashpad {
+
+bool IsCompressedMinidump(FileReaderInterface* file_reader) {
+  const FileOffset start_offset = file_reader->SeekGet();
+  if (start_offset < 0) {
+    return false;
+  }
+
+  uint8_t header[2];
+  const bool read = file_reader->ReadExactly(header, sizeof(header));
+  if (!file_reader->SeekSet(start_offset) || !read) {
+    return false;
+  }
+
+  // RFC 1950 §2.2: the low nibble of CMF is 8 for deflate, and CMF * 256 + FLG
+  // is a multiple of 31. An uncompressed minidump begins with its signature,
+  // “MDMP”, which never satisfies this.
+  return (header[0] & 0x0f) == 8 && ((header[0] << 8) | header[1]) % 31 == 0;
+}
+
+bool DecompressMinidump(FileReaderInterface* file_reader,
+                        FileWriterInterface* file_writer) {
+  ZlibOutputStream stream(ZlibOutputStream::Mode::kDecompress,
+                          std::make_unique<FileWriterOutputStream>(file_writer));
+  FileOperationResult read_result;
+  do {
+    uint8_t buffer[4096];
+    read_result = file_reader->Read(buffer, sizeof(buffer));
+    if (read_result < 0) {
+      return false;
+    }
+
+    if (read_result > 0 && !stream.Write(buffer, read_result)) {
+      return false;
+    }
+  } while (read_result > 0);
+  return stream.Flush();
+}
+
+}  // namespace crashpad
@@ -0,0 +1,46 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_SNAPSHOT_MINIDUMP_MINIDUMP_COMPRESSION_H_
+#define CRASHPAD_SNAPSHOT_MINIDUMP_MINIDUMP_COMPRESSION_H_
+
+#include "util/file/file_reader.h"
+#include "util/file/file_writer.h"
+
+namespace crashpad {
+
+//! \brief Determines whether a file holds a compressed minidump, as written by
+//!     MinidumpFileWriter::WriteCompressedMinidump().
+//!
+//! \param[in] file_reader The file to examine, positioned at the start of the
+//!     minidump. Its position is restored before returning.
+//!
+//! \return `true` if the file begins with a zlib stream header. `false` if it
+//!     does not, or if it could not be read.
+bool IsCompressedMinidump(FileReaderInterface* file_reader);
+
+//! \brief Decompresses a minidump written by
+//!     MinidumpFileWriter::WriteCompressedMinidump().
+//!
+//! \param[in] file_reader The compressed minidump, positioned at its start. It
+//!     is read to its end.
+//! \param[in] file_writer The writer to receive the decompressed minidump.
+//!
+//! \return `true` on success. `false` on failure, with a message logged.
+bool DecompressMinidump(FileReaderInterface* file_reader,
+                        FileWriterInterface* file_writer);
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_SNAPSHOT_MINIDUMP_MINIDUMP_COMPRESSION_H_
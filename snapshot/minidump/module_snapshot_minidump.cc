@@ -17,6 +17,8 @@
 #include <stddef.h>
 #include <string.h>
 
+#include <algorithm>
+
 #include "base/logging.h"
 #include "base/notreached.h"
 #include "minidump/minidump_extensions.h"
@@ -247,9 +249,10 @@ bool ModuleSnapshotMinidump::InitializeModuleCrashpadInfo(
     return true;
   }
 
-  MinidumpModuleCrashpadInfo minidump_module_crashpad_info;
+  // Version 1 structures end before annotation_object_threads.
+  MinidumpModuleCrashpadInfo minidump_module_crashpad_info = {};
   if (minidump_module_crashpad_info_location->DataSize <
-      sizeof(minidump_module_crashpad_info)) {
+      offsetof(MinidumpModuleCrashpadInfo, annotation_object_threads)) {
     LOG(ERROR) << "minidump_module_crashpad_info size mismatch";
     return false;
   }
@@ -258,17 +261,27 @@ bool ModuleSnapshotMinidump::InitializeModuleCrashpadInfo(
     return false;
   }
 
-  if (!file_reader->ReadExactly(&minidump_module_crashpad_info,
-                                sizeof(minidump_module_crashpad_info))) {
+  if (!file_reader->ReadExactly(
+          &minidump_module_crashpad_info,
+          std::min(static_cast<size_t>(
+                       minidump_module_crashpad_info_location->DataSize),
+                   sizeof(minidump_module_crashpad_info)))) {
     return false;
   }
 
-  if (minidump_module_crashpad_info.version !=
-      MinidumpModuleCrashpadInfo::kVersion) {
+  if (minidump_module_crashpad_info.version <
+          MinidumpModuleCrashpadInfo::kVersionWithoutAnnotationObjectThreads ||
+      minidump_module_crashpad_info.version >
+          MinidumpModuleCrashpadInfo::kVersion) {
     LOG(ERROR) << "minidump_module_crashpad_info version mismatch";
     return false;
   }
 
+  if (minidump_module_crashpad_info.version <
+      MinidumpModuleCrashpadInfo::kVersion) {
+    minidump_module_crashpad_info.annotation_object_threads = {};
+  }
+
   if (!ReadMinidumpStringList(file_reader,
                               minidump_module_crashpad_info.list_annotations,
                               &annotations_vector_)) {
@@ -289,6 +302,13 @@ bool ModuleSnapshotMinidump::InitializeModuleCrashpadInfo(
     return false;
   }
 
+  if (!ReadMinidumpAnnotationThreadList(
+          file_reader,
+          minidump_module_crashpad_info.annotation_object_threads,
+          &annotation_objects_)) {
+    return false;
+  }
+
   return true;
 }
 
@@ -0,0 +1,108 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "snapshot/minidump/process_memory_minidump.h"
+
+#include <inttypes.h>
+
+#include <algorithm>
+#include <iterator>
+#include <limits>
+
+#include "base/check_op.h"
+#include "base/logging.h"
+#include "base/strings/stringprintf.h"
+
+namespace crashpad {
+namespace internal {
+
+ProcessMemoryMinidump::ProcessMemoryMinidump()
+    : ProcessMemory(), regions_(), initialized_() {}
+
+ProcessMemoryMinidump::~ProcessMemoryMinidump() {}
+
+void ProcessMemoryMinidump::Initialize(
+    const std::vector<const MemorySnapshot*>& regions) {
+  INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
+
+  std::vector<const MemorySnapshot*> sorted_regions(regions);
+  std::sort(sorted_regions.begin(),
+            sorted_regions.end(),
+            [](const MemorySnapshot* left, const MemorySnapshot* right) {
+              if (left->Address() != right->Address()) {
+                return left->Address() < right->Address();
+              }
+              return left->Size() > right->Size();
+            });
+
+  // Each region is trimmed to begin where the ones before it end, and dropped
+  // if nothing is left of it.
+  regions_.clear();
+  regions_.reserve(sorted_regions.size());
+  VMAddress covered_end = 0;
+  for (const MemorySnapshot* snapshot : sorted_regions) {
+    DCHECK(snapshot->SupportsReadRange());
+    const VMAddress address = snapshot->Address();
+    VMSize size = snapshot->Size();
+    if (size > std::numeric_limits<VMAddress>::max() - address) {
+      size = std::numeric_limits<VMAddress>::max() - address;
+    }
+    const VMAddress end = address + size;
+    const VMAddress start = std::max(address, covered_end);
+    if (start >= end) {
+      continue;
+    }
+
+    regions_.push_back(
+        {start, end - start, snapshot, static_cast<size_t>(start - address)});
+    covered_end = end;
+  }
+
+  INITIALIZATION_STATE_SET_VALID(initialized_);
+}
+
+ssize_t ProcessMemoryMinidump::ReadUpTo(VMAddress address,
+                                        size_t size,
+                                        void* buffer) const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+
+  auto next = std::upper_bound(
+      regions_.begin(),
+      regions_.end(),
+      address,
+      [](VMAddress address, const Region& region) {
+        return address < region.address;
+      });
+  if (next == regions_.begin() ||
+      address - std::prev(next)->address >= std::prev(next)->size) {
+    LOG(ERROR) << base::StringPrintf("no memory captured at 0x%" PRIx64,
+                                     address);
+    return -1;
+  }
+
+  const Region& region = *std::prev(next);
+  const VMSize region_offset = address - region.address;
+  const size_t read_size = static_cast<size_t>(
+      std::min(static_cast<VMSize>(size), region.size - region_offset));
+  if (!region.snapshot->ReadRange(
+          region.offset + static_cast<size_t>(region_offset),
+          read_size,
+          buffer)) {
+    return -1;
+  }
+  return read_size;
+}
+
+}  // namespace internal
+}  // namespace crashpad
@@ -0,0 +1,76 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_SNAPSHOT_MINIDUMP_PROCESS_MEMORY_MINIDUMP_H_
+#define CRASHPAD_SNAPSHOT_MINIDUMP_PROCESS_MEMORY_MINIDUMP_H_
+
+#include <sys/types.h>
+
+#include <vector>
+
+#include "snapshot/memory_snapshot.h"
+#include "util/misc/address_types.h"
+#include "util/misc/initialization_state_dcheck.h"
+#include "util/process/process_memory.h"
+
+namespace crashpad {
+namespace internal {
+
+//! \brief Reads a process’ memory from the regions of it captured in a
+//!     minidump.
+//!
+//! The regions are indexed by address, so that each read finds the region that
+//! holds it in logarithmic time, rather than by searching the minidump’s
+//! MemorySnapshot objects one by one. Where regions overlap, the one at the
+//! lower address, or the larger of two at the same address, is read. Memory
+//! that wasn’t captured can’t be read.
+class ProcessMemoryMinidump final : public ProcessMemory {
+ public:
+  ProcessMemoryMinidump();
+
+  ProcessMemoryMinidump(const ProcessMemoryMinidump&) = delete;
+  ProcessMemoryMinidump& operator=(const ProcessMemoryMinidump&) = delete;
+
+  ~ProcessMemoryMinidump();
+
+  //! \brief Initializes this object to read from \a regions.
+  //!
+  //! This method must be called successfully prior to calling any other method
+  //! in this class.
+  //!
+  //! \param[in] regions The captured memory regions. Each must support
+  //!     MemorySnapshot::ReadRange(), and must outlive this object.
+  void Initialize(const std::vector<const MemorySnapshot*>& regions);
+
+ private:
+  // The part of a captured region, from offset onwards, that is read for
+  // [address, address + size).
+  struct Region {
+    VMAddress address;
+    VMSize size;
+    const MemorySnapshot* snapshot;  // weak
+    size_t offset;
+  };
+
+  ssize_t ReadUpTo(VMAddress address, size_t size, void* buffer) const override;
+
+  // Regions sorted by address. They don’t overlap.
+  std::vector<Region> regions_;
+  InitializationStateDcheck initialized_;
+};
+
+}  // namespace internal
+}  // namespace crashpad
+
+#endif  // CRASHPAD_SNAPSHOT_MINIDUMP_PROCESS_MEMORY_MINIDUMP_H_
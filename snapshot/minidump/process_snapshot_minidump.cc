@@ -14,17 +14,25 @@
 
 #include "snapshot/minidump/process_snapshot_minidump.h"
 
+#include <stdio.h>
+
+#include <algorithm>
+#include <memory>
 #include <utility>
 
 #include "base/logging.h"
 #include "base/notreached.h"
+#include "base/numerics/safe_conversions.h"
 #include "base/strings/utf_string_conversions.h"
 #include "build/build_config.h"
 #include "minidump/minidump_extensions.h"
 #include "snapshot/memory_map_region_snapshot.h"
+#include "snapshot/minidump/minidump_checksum.h"
+#include "snapshot/minidump/minidump_compression.h"
 #include "snapshot/minidump/minidump_simple_string_dictionary_reader.h"
 #include "snapshot/minidump/minidump_string_reader.h"
 #include "util/file/file_io.h"
+#include "util/thread/thread.h"
 
 namespace crashpad {
 
@@ -45,6 +53,32 @@ class MemoryMapRegionSnapshotMinidump : public MemoryMapRegionSnapshot {
 
 }  // namespace internal
 
+class ProcessSnapshotMinidump::StreamThread final : public Thread {
+ public:
+  StreamThread(ProcessSnapshotMinidump* process_snapshot,
+               StreamGroupQueue* queue)
+      : Thread(), process_snapshot_(process_snapshot), queue_(queue) {}
+
+  StreamThread(const StreamThread&) = delete;
+  StreamThread& operator=(const StreamThread&) = delete;
+
+  ~StreamThread() override {}
+
+ private:
+  // Thread:
+  void ThreadMain() override {
+    process_snapshot_->InitializeQueuedStreams(queue_);
+  }
+
+  ProcessSnapshotMinidump* process_snapshot_;  // weak
+  StreamGroupQueue* queue_;  // weak
+};
+
+ProcessSnapshotMinidump::StreamGroupQueue::StreamGroupQueue()
+    : groups(), next(0), succeeded() {}
+
+ProcessSnapshotMinidump::StreamGroupQueue::~StreamGroupQueue() = default;
+
 ProcessSnapshotMinidump::ProcessSnapshotMinidump()
     : ProcessSnapshot(),
       header_(),
@@ -55,13 +89,22 @@ ProcessSnapshotMinidump::ProcessSnapshotMinidump()
       unloaded_modules_(),
       mem_regions_(),
       mem_regions_exposed_(),
+      process_memory_(),
       custom_streams_(),
       crashpad_info_(),
       system_snapshot_(),
       exception_snapshot_(),
       arch_(CPUArchitecture::kCPUArchitectureUnknown),
       annotations_simple_map_(),
+      machine_description_(),
+      misc_info_(),
       file_reader_(nullptr),
+      file_data_(nullptr),
+      decompressed_file_(),
+      buffered_file_(),
+      stream_readers_(),
+      streams_initialized_(),
+      streams_lock_(),
       process_id_(kInvalidProcessID),
       create_time_(0),
       user_time_(0),
@@ -73,54 +116,42 @@ ProcessSnapshotMinidump::~ProcessSnapshotMinidump() {}
 bool ProcessSnapshotMinidump::Initialize(FileReaderInterface* file_reader) {
   INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
 
-  file_reader_ = file_reader;
-
-  if (!file_reader_->SeekSet(0)) {
+  if (!InitializeFully(file_reader, nullptr, 1)) {
     return false;
   }
 
-  if (!file_reader_->ReadExactly(&header_, sizeof(header_))) {
-    return false;
-  }
+  INITIALIZATION_STATE_SET_VALID(initialized_);
+  return true;
+}
 
-  if (header_.Signature != MINIDUMP_SIGNATURE) {
-    LOG(ERROR) << "minidump signature mismatch";
-    return false;
-  }
+bool ProcessSnapshotMinidump::Initialize(MappedFileReader* mapped_file,
+                                         size_t thread_count) {
+  INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
 
-  if (header_.Version != MINIDUMP_VERSION) {
-    LOG(ERROR) << "minidump version mismatch";
+  if (!InitializeFully(mapped_file, mapped_file->data(), thread_count)) {
     return false;
   }
 
-  if (!file_reader->SeekSet(header_.StreamDirectoryRva)) {
-    return false;
-  }
+  INITIALIZATION_STATE_SET_VALID(initialized_);
+  return true;
+}
 
-  stream_directory_.resize(header_.NumberOfStreams);
-  if (!stream_directory_.empty() &&
-      !file_reader_->ReadExactly(
-          &stream_directory_[0],
-          header_.NumberOfStreams * sizeof(stream_directory_[0]))) {
+bool ProcessSnapshotMinidump::InitializeLazily(MappedFileReader* mapped_file) {
+  INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
+
+  if (!InitializeHeader(mapped_file, mapped_file->data())) {
     return false;
   }
 
-  for (const MINIDUMP_DIRECTORY& directory : stream_directory_) {
-    const MinidumpStreamType stream_type =
-        static_cast<MinidumpStreamType>(directory.StreamType);
-    if (stream_map_.find(stream_type) != stream_map_.end()) {
-      LOG(ERROR) << "duplicate streams for type " << directory.StreamType;
-      return false;
-    }
+  INITIALIZATION_STATE_SET_VALID(initialized_);
+  return true;
+}
 
-    stream_map_[stream_type] = &directory.Location;
-  }
+bool ProcessSnapshotMinidump::InitializeLazily(
+    FileReaderInterface* file_reader) {
+  INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
 
-  if (!InitializeCrashpadInfo() || !InitializeMiscInfo() ||
-      !InitializeModules() || !InitializeSystemSnapshot() ||
-      !InitializeMemoryInfo() || !InitializeExtraMemory() ||
-      !InitializeThreads() || !InitializeCustomMinidumpStreams() ||
-      !InitializeExceptionSnapshot()) {
+  if (!InitializeHeader(file_reader, nullptr)) {
     return false;
   }
 
@@ -130,12 +161,13 @@ bool ProcessSnapshotMinidump::Initialize(FileReaderInterface* file_reader) {
 
 crashpad::ProcessID ProcessSnapshotMinidump::ProcessID() const {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  EnsureStreamsInitialized(StreamGroup::kMiscInfo);
   return process_id_;
 }
 
 crashpad::ProcessID ProcessSnapshotMinidump::ParentProcessID() const {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
-  NOTREACHED();  // https://crashpad.chromium.org/bug/10
+  // Minidumps don’t record the parent process.
   return 0;
 }
 
@@ -147,6 +179,7 @@ void ProcessSnapshotMinidump::SnapshotTime(timeval* snapshot_time) const {
 
 void ProcessSnapshotMinidump::ProcessStartTime(timeval* start_time) const {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  EnsureStreamsInitialized(StreamGroup::kMiscInfo);
   start_time->tv_sec = create_time_;
   start_time->tv_usec = 0;
 }
@@ -154,6 +187,7 @@ void ProcessSnapshotMinidump::ProcessStartTime(timeval* start_time) const {
 void ProcessSnapshotMinidump::ProcessCPUTimes(timeval* user_time,
                                               timeval* system_time) const {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  EnsureStreamsInitialized(StreamGroup::kMiscInfo);
   user_time->tv_sec = user_time_;
   user_time->tv_usec = 0;
   system_time->tv_sec = kernel_time_;
@@ -162,33 +196,32 @@ void ProcessSnapshotMinidump::ProcessCPUTimes(timeval* user_time,
 
 void ProcessSnapshotMinidump::ReportID(UUID* report_id) const {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  EnsureStreamsInitialized(StreamGroup::kCrashpadInfo);
   *report_id = crashpad_info_.report_id;
 }
 
 void ProcessSnapshotMinidump::ClientID(UUID* client_id) const {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  EnsureStreamsInitialized(StreamGroup::kCrashpadInfo);
   *client_id = crashpad_info_.client_id;
 }
 
 const std::map<std::string, std::string>&
 ProcessSnapshotMinidump::AnnotationsSimpleMap() const {
-  // TODO(mark): This method should not be const, although the interface
-  // currently imposes this requirement. Making it non-const would allow
-  // annotations_simple_map_ to be lazily constructed: InitializeCrashpadInfo()
-  // could be called here, and from other locations that require it, rather than
-  // calling it from Initialize().
-  // https://crashpad.chromium.org/bug/9
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  EnsureStreamsInitialized(StreamGroup::kCrashpadInfo);
   return annotations_simple_map_;
 }
 
 const SystemSnapshot* ProcessSnapshotMinidump::System() const {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  EnsureStreamsInitialized(StreamGroup::kSystem);
   return &system_snapshot_;
 }
 
 std::vector<const ThreadSnapshot*> ProcessSnapshotMinidump::Threads() const {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  EnsureStreamsInitialized(StreamGroup::kThreads);
   std::vector<const ThreadSnapshot*> threads;
   for (const auto& thread : threads_) {
     threads.push_back(thread.get());
@@ -198,6 +231,7 @@ std::vector<const ThreadSnapshot*> ProcessSnapshotMinidump::Threads() const {
 
 std::vector<const ModuleSnapshot*> ProcessSnapshotMinidump::Modules() const {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  EnsureStreamsInitialized(StreamGroup::kModules);
   std::vector<const ModuleSnapshot*> modules;
   for (const auto& module : modules_) {
     modules.push_back(module.get());
@@ -208,12 +242,14 @@ std::vector<const ModuleSnapshot*> ProcessSnapshotMinidump::Modules() const {
 std::vector<UnloadedModuleSnapshot> ProcessSnapshotMinidump::UnloadedModules()
     const {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
-  NOTREACHED();  // https://crashpad.chromium.org/bug/10
+  // TODO(jperaza): Read the unloaded module list stream.
+  // https://crashpad.chromium.org/bug/10
   return unloaded_modules_;
 }
 
 const ExceptionSnapshot* ProcessSnapshotMinidump::Exception() const {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  EnsureStreamsInitialized(StreamGroup::kException);
   if (exception_snapshot_.IsValid()) {
     return &exception_snapshot_;
   }
@@ -224,18 +260,21 @@ const ExceptionSnapshot* ProcessSnapshotMinidump::Exception() const {
 std::vector<const MemoryMapRegionSnapshot*> ProcessSnapshotMinidump::MemoryMap()
     const {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  EnsureStreamsInitialized(StreamGroup::kMemoryInfo);
   return mem_regions_exposed_;
 }
 
 std::vector<HandleSnapshot> ProcessSnapshotMinidump::Handles() const {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
-  NOTREACHED();  // https://crashpad.chromium.org/bug/10
+  // TODO(jperaza): Read the handle data stream.
+  // https://crashpad.chromium.org/bug/10
   return std::vector<HandleSnapshot>();
 }
 
 std::vector<const MemorySnapshot*> ProcessSnapshotMinidump::ExtraMemory()
     const {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  EnsureStreamsInitialized(StreamGroup::kExtraMemory);
   std::vector<const MemorySnapshot*> chunks;
   for (const auto& chunk : extra_memory_) {
     chunks.push_back(chunk.get());
@@ -245,12 +284,14 @@ std::vector<const MemorySnapshot*> ProcessSnapshotMinidump::ExtraMemory()
 
 const ProcessMemory* ProcessSnapshotMinidump::Memory() const {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
-  return nullptr;
+  EnsureStreamsInitialized(StreamGroup::kExtraMemory);
+  return &process_memory_;
 }
 
 std::vector<const MinidumpStream*>
 ProcessSnapshotMinidump::CustomMinidumpStreams() const {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  EnsureStreamsInitialized(StreamGroup::kCustomStreams);
 
   std::vector<const MinidumpStream*> result;
   result.reserve(custom_streams_.size());
@@ -260,7 +301,280 @@ ProcessSnapshotMinidump::CustomMinidumpStreams() const {
   return result;
 }
 
-bool ProcessSnapshotMinidump::InitializeCrashpadInfo() {
+bool ProcessSnapshotMinidump::InitializeHeader(
+    FileReaderInterface* file_reader,
+    const uint8_t* file_data) {
+  if (!file_reader->SeekSet(0)) {
+    return false;
+  }
+
+  if (IsCompressedMinidump(file_reader)) {
+    decompressed_file_ = std::make_unique<StringFile>();
+    if (!DecompressMinidump(file_reader, decompressed_file_.get())) {
+      return false;
+    }
+    file_reader = decompressed_file_.get();
+    file_data = reinterpret_cast<const uint8_t*>(
+        decompressed_file_->string().data());
+  }
+
+  if (!file_data) {
+    buffered_file_ = std::make_unique<BufferedFileReader>(file_reader);
+    file_reader = buffered_file_.get();
+  }
+
+  file_reader_ = file_reader;
+  file_data_ = file_data;
+
+  if (!file_reader_->SeekSet(0)) {
+    return false;
+  }
+
+  if (!file_reader_->ReadExactly(&header_, sizeof(header_))) {
+    return false;
+  }
+
+  if (header_.Signature != MINIDUMP_SIGNATURE) {
+    LOG(ERROR) << "minidump signature mismatch";
+    return false;
+  }
+
+  if (header_.Version != MINIDUMP_VERSION) {
+    LOG(ERROR) << "minidump version mismatch";
+    return false;
+  }
+
+  if (!file_reader->SeekSet(header_.StreamDirectoryRva)) {
+    return false;
+  }
+
+  stream_directory_.resize(header_.NumberOfStreams);
+  if (!stream_directory_.empty() &&
+      !file_reader_->ReadExactly(
+          &stream_directory_[0],
+          header_.NumberOfStreams * sizeof(stream_directory_[0]))) {
+    return false;
+  }
+
+  for (const MINIDUMP_DIRECTORY& directory : stream_directory_) {
+    const MinidumpStreamType stream_type =
+        static_cast<MinidumpStreamType>(directory.StreamType);
+    if (stream_map_.find(stream_type) != stream_map_.end()) {
+      LOG(ERROR) << "duplicate streams for type " << directory.StreamType;
+      return false;
+    }
+
+    stream_map_[stream_type] = &directory.Location;
+  }
+
+  return true;
+}
+
+bool ProcessSnapshotMinidump::InitializeFully(FileReaderInterface* file_reader,
+                                              const uint8_t* file_data,
+                                              size_t thread_count) {
+  if (!InitializeHeader(file_reader, file_data)) {
+    return false;
+  }
+
+  // A minidump that doesn’t match its checksum was corrupted after it was
+  // written.
+  if (!file_reader_->SeekSet(0) ||
+      CheckMinidumpChecksum(file_reader_) ==
+          MinidumpChecksumResult::kMismatch) {
+    return false;
+  }
+
+  // Streams can only be read concurrently from a file whose contents are in
+  // memory, because each thread needs a file position of its own.
+  if (thread_count > 1 && file_data_) {
+    return InitializeStreamsConcurrently(thread_count);
+  }
+
+  for (size_t group = 0; group < static_cast<size_t>(StreamGroup::kCount);
+       ++group) {
+    if (!InitializeStreams(static_cast<StreamGroup>(group), file_reader_)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool ProcessSnapshotMinidump::InitializeStreamsConcurrently(
+    size_t thread_count) {
+  const FileOffset file_size = file_reader_->Seek(0, SEEK_END);
+  if (file_size < 0) {
+    return false;
+  }
+  for (auto& stream_reader : stream_readers_) {
+    stream_reader = std::make_unique<MemoryFileReader>(
+        file_data_, base::checked_cast<size_t>(file_size));
+  }
+
+  // A group can only be initialized once the group it depends on has been, so
+  // the groups are initialized in waves. Each wave has the groups that are as
+  // far down a chain of dependencies as each other, which depend only on
+  // groups from earlier waves, and whose streams and data are separate from
+  // those of the others in the wave. Each group’s data ends up the same
+  // whichever thread it’s initialized on, and in whichever order.
+  size_t depths[static_cast<size_t>(StreamGroup::kCount)];
+  size_t max_depth = 0;
+  for (size_t group = 0; group < static_cast<size_t>(StreamGroup::kCount);
+       ++group) {
+    size_t depth = 0;
+    for (StreamGroup dependency =
+             StreamGroupDependency(static_cast<StreamGroup>(group));
+         dependency != StreamGroup::kCount;
+         dependency = StreamGroupDependency(dependency)) {
+      ++depth;
+    }
+    depths[group] = depth;
+    max_depth = std::max(max_depth, depth);
+  }
+
+  for (size_t depth = 0; depth <= max_depth; ++depth) {
+    StreamGroupQueue queue;
+    for (size_t group = 0; group < static_cast<size_t>(StreamGroup::kCount);
+         ++group) {
+      if (depths[group] == depth) {
+        queue.groups.push_back(static_cast<StreamGroup>(group));
+        streams_initialized_[group] = true;
+      }
+    }
+
+    // The calling thread initializes groups too.
+    std::vector<std::unique_ptr<StreamThread>> threads;
+    const size_t thread_limit = std::min(thread_count, queue.groups.size());
+    for (size_t index = 1; index < thread_limit; ++index) {
+      threads.push_back(std::make_unique<StreamThread>(this, &queue));
+      threads.back()->Start();
+    }
+    InitializeQueuedStreams(&queue);
+    for (const auto& thread : threads) {
+      thread->Join();
+    }
+
+    for (StreamGroup group : queue.groups) {
+      if (!queue.succeeded[static_cast<size_t>(group)]) {
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+void ProcessSnapshotMinidump::InitializeQueuedStreams(StreamGroupQueue* queue) {
+  for (size_t index = queue->next++; index < queue->groups.size();
+       index = queue->next++) {
+    const StreamGroup group = queue->groups[index];
+    const size_t group_index = static_cast<size_t>(group);
+    queue->succeeded[group_index] =
+        InitializeStreamGroup(group, stream_readers_[group_index].get());
+  }
+}
+
+// static
+ProcessSnapshotMinidump::StreamGroup
+ProcessSnapshotMinidump::StreamGroupDependency(StreamGroup group) {
+  switch (group) {
+    case StreamGroup::kModules:
+      return StreamGroup::kCrashpadInfo;
+    case StreamGroup::kSystem:
+      return StreamGroup::kMiscInfo;
+    case StreamGroup::kThreads:
+    case StreamGroup::kException:
+      return StreamGroup::kSystem;
+    case StreamGroup::kCrashpadInfo:
+    case StreamGroup::kMiscInfo:
+    case StreamGroup::kMemoryInfo:
+    case StreamGroup::kExtraMemory:
+    case StreamGroup::kCustomStreams:
+    case StreamGroup::kCount:
+      break;
+  }
+
+  return StreamGroup::kCount;
+}
+
+bool ProcessSnapshotMinidump::InitializeStreams(
+    StreamGroup group,
+    FileReaderInterface* file_reader) {
+  const size_t index = static_cast<size_t>(group);
+  if (streams_initialized_[index]) {
+    return true;
+  }
+  streams_initialized_[index] = true;
+
+  // Initialize() has already initialized, successfully, every group that group
+  // depends on. InitializeLazily() carries on with whatever its dependencies
+  // could provide, so the results of initializing them are ignored.
+  const StreamGroup dependency = StreamGroupDependency(group);
+  if (dependency != StreamGroup::kCount) {
+    InitializeStreams(dependency, file_reader);
+  }
+
+  return InitializeStreamGroup(group, file_reader);
+}
+
+bool ProcessSnapshotMinidump::InitializeStreamGroup(
+    StreamGroup group,
+    FileReaderInterface* file_reader) {
+  switch (group) {
+    case StreamGroup::kCrashpadInfo:
+      return InitializeCrashpadInfo(file_reader);
+    case StreamGroup::kMiscInfo:
+      return InitializeMiscInfo(file_reader);
+    case StreamGroup::kModules:
+      return InitializeModules(file_reader);
+    case StreamGroup::kSystem:
+      return InitializeSystemSnapshot(file_reader);
+    case StreamGroup::kMemoryInfo:
+      return InitializeMemoryInfo(file_reader);
+    case StreamGroup::kExtraMemory: {
+      const bool success = InitializeExtraMemory(file_reader) &&
+                           InitializeMemory64List(file_reader);
+
+      // Memory() reads whatever memory could be initialized.
+      std::vector<const MemorySnapshot*> regions;
+      regions.reserve(extra_memory_.size());
+      for (const auto& memory : extra_memory_) {
+        regions.push_back(memory.get());
+      }
+      process_memory_.Initialize(regions);
+      return success;
+    }
+    case StreamGroup::kThreads:
+      return InitializeThreads(file_reader);
+    case StreamGroup::kCustomStreams:
+      return InitializeCustomMinidumpStreams(file_reader);
+    case StreamGroup::kException:
+      return InitializeExceptionSnapshot(file_reader);
+    case StreamGroup::kCount:
+      break;
+  }
+
+  NOTREACHED();
+  return false;
+}
+
+void ProcessSnapshotMinidump::EnsureStreamsInitialized(
+    StreamGroup group) const {
+  base::AutoLock lock(streams_lock_);
+
+  // The ProcessSnapshot interface requires the methods that call this to be
+  // const, although initializing the streams they return modifies this
+  // object. https://crashpad.chromium.org/bug/9
+  if (!const_cast<ProcessSnapshotMinidump*>(this)->InitializeStreams(
+          group, file_reader_)) {
+    LOG(ERROR) << "failed to initialize stream group "
+               << static_cast<size_t>(group);
+  }
+}
+
+bool ProcessSnapshotMinidump::InitializeCrashpadInfo(
+    FileReaderInterface* file_reader) {
   const auto& stream_it = stream_map_.find(kMinidumpStreamTypeCrashpadInfo);
   if (stream_it == stream_map_.end()) {
     return true;
@@ -271,11 +585,11 @@ bool ProcessSnapshotMinidump::InitializeCrashpadInfo() {
     return false;
   }
 
-  if (!file_reader_->SeekSet(stream_it->second->Rva)) {
+  if (!file_reader->SeekSet(stream_it->second->Rva)) {
     return false;
   }
 
-  if (!file_reader_->ReadExactly(&crashpad_info_, sizeof(crashpad_info_))) {
+  if (!file_reader->ReadExactly(&crashpad_info_, sizeof(crashpad_info_))) {
     return false;
   }
 
@@ -285,18 +599,19 @@ bool ProcessSnapshotMinidump::InitializeCrashpadInfo() {
   }
 
   return internal::ReadMinidumpSimpleStringDictionary(
-      file_reader_,
+      file_reader,
       crashpad_info_.simple_annotations,
       &annotations_simple_map_);
 }
 
-bool ProcessSnapshotMinidump::InitializeMiscInfo() {
+bool ProcessSnapshotMinidump::InitializeMiscInfo(
+    FileReaderInterface* file_reader) {
   const auto& stream_it = stream_map_.find(kMinidumpStreamTypeMiscInfo);
   if (stream_it == stream_map_.end()) {
     return true;
   }
 
-  if (!file_reader_->SeekSet(stream_it->second->Rva)) {
+  if (!file_reader->SeekSet(stream_it->second->Rva)) {
     return false;
   }
 
@@ -310,26 +625,36 @@ bool ProcessSnapshotMinidump::InitializeMiscInfo() {
     return false;
   }
 
-  MINIDUMP_MISC_INFO_5 info;
-  if (!file_reader_->ReadExactly(&info, size)) {
+  MINIDUMP_MISC_INFO_5 info = {};
+  if (!file_reader->ReadExactly(&info, size)) {
     return false;
   }
+  misc_info_ = info;
 
   switch (stream_it->second->DataSize) {
     case sizeof(MINIDUMP_MISC_INFO_5):
-    case sizeof(MINIDUMP_MISC_INFO_4):
+    case sizeof(MINIDUMP_MISC_INFO_4): {
 #if defined(WCHAR_T_IS_UTF16)
       full_version_ = base::WideToUTF8(info.BuildString);
 #else
       full_version_ = base::UTF16ToUTF8(info.BuildString);
 #endif
-      full_version_ = full_version_.substr(0, full_version_.find(';'));
+      // MinidumpMiscInfoWriter joins the OS version and the machine description
+      // with "; ".
+      const size_t separator = full_version_.find(';');
+      if (separator != std::string::npos) {
+        const size_t description =
+            full_version_.find_first_not_of(' ', separator + 1);
+        if (description != std::string::npos) {
+          machine_description_ = full_version_.substr(description);
+        }
+      }
+      full_version_ = full_version_.substr(0, separator);
       [[fallthrough]];
+    }
     case sizeof(MINIDUMP_MISC_INFO_3):
     case sizeof(MINIDUMP_MISC_INFO_2):
     case sizeof(MINIDUMP_MISC_INFO):
-      // TODO(jperaza): Save the remaining misc info.
-      // https://crashpad.chromium.org/bug/10
       process_id_ = info.ProcessId;
       create_time_ = info.ProcessCreateTime;
       user_time_ = info.ProcessUserTime;
@@ -339,14 +664,16 @@ bool ProcessSnapshotMinidump::InitializeMiscInfo() {
   return true;
 }
 
-bool ProcessSnapshotMinidump::InitializeModules() {
+bool ProcessSnapshotMinidump::InitializeModules(
+    FileReaderInterface* file_reader) {
   const auto& stream_it = stream_map_.find(kMinidumpStreamTypeModuleList);
   if (stream_it == stream_map_.end()) {
     return true;
   }
 
   std::map<uint32_t, MINIDUMP_LOCATION_DESCRIPTOR> module_crashpad_info_links;
-  if (!InitializeModulesCrashpadInfo(&module_crashpad_info_links)) {
+  if (!InitializeModulesCrashpadInfo(file_reader,
+                                     &module_crashpad_info_links)) {
     return false;
   }
 
@@ -355,12 +682,12 @@ bool ProcessSnapshotMinidump::InitializeModules() {
     return false;
   }
 
-  if (!file_reader_->SeekSet(stream_it->second->Rva)) {
+  if (!file_reader->SeekSet(stream_it->second->Rva)) {
     return false;
   }
 
   uint32_t module_count;
-  if (!file_reader_->ReadExactly(&module_count, sizeof(module_count))) {
+  if (!file_reader->ReadExactly(&module_count, sizeof(module_count))) {
     return false;
   }
 
@@ -383,7 +710,7 @@ bool ProcessSnapshotMinidump::InitializeModules() {
 
     auto module = std::make_unique<internal::ModuleSnapshotMinidump>();
     if (!module->Initialize(
-            file_reader_, module_rva, module_crashpad_info_location)) {
+            file_reader, module_rva, module_crashpad_info_location)) {
       return false;
     }
 
@@ -394,6 +721,7 @@ bool ProcessSnapshotMinidump::InitializeModules() {
 }
 
 bool ProcessSnapshotMinidump::InitializeModulesCrashpadInfo(
+    FileReaderInterface* file_reader,
     std::map<uint32_t, MINIDUMP_LOCATION_DESCRIPTOR>*
         module_crashpad_info_links) {
   module_crashpad_info_links->clear();
@@ -412,13 +740,13 @@ bool ProcessSnapshotMinidump::InitializeModulesCrashpadInfo(
     return false;
   }
 
-  if (!file_reader_->SeekSet(crashpad_info_.module_list.Rva)) {
+  if (!file_reader->SeekSet(crashpad_info_.module_list.Rva)) {
     return false;
   }
 
   uint32_t crashpad_module_count;
-  if (!file_reader_->ReadExactly(&crashpad_module_count,
-                                 sizeof(crashpad_module_count))) {
+  if (!file_reader->ReadExactly(&crashpad_module_count,
+                                sizeof(crashpad_module_count))) {
     return false;
   }
 
@@ -431,7 +759,7 @@ bool ProcessSnapshotMinidump::InitializeModulesCrashpadInfo(
 
   std::unique_ptr<MinidumpModuleCrashpadInfoLink[]> minidump_links(
       new MinidumpModuleCrashpadInfoLink[crashpad_module_count]);
-  if (!file_reader_->ReadExactly(
+  if (!file_reader->ReadExactly(
           &minidump_links[0],
           crashpad_module_count * sizeof(MinidumpModuleCrashpadInfoLink))) {
     return false;
@@ -456,7 +784,8 @@ bool ProcessSnapshotMinidump::InitializeModulesCrashpadInfo(
   return true;
 }
 
-bool ProcessSnapshotMinidump::InitializeMemoryInfo() {
+bool ProcessSnapshotMinidump::InitializeMemoryInfo(
+    FileReaderInterface* file_reader) {
   const auto& stream_it = stream_map_.find(kMinidumpStreamTypeMemoryInfoList);
   if (stream_it == stream_map_.end()) {
     return true;
@@ -467,13 +796,13 @@ bool ProcessSnapshotMinidump::InitializeMemoryInfo() {
     return false;
   }
 
-  if (!file_reader_->SeekSet(stream_it->second->Rva)) {
+  if (!file_reader->SeekSet(stream_it->second->Rva)) {
     return false;
   }
 
   MINIDUMP_MEMORY_INFO_LIST list;
 
-  if (!file_reader_->ReadExactly(&list, sizeof(list))) {
+  if (!file_reader->ReadExactly(&list, sizeof(list))) {
     return false;
   }
 
@@ -495,7 +824,7 @@ bool ProcessSnapshotMinidump::InitializeMemoryInfo() {
   for (uint32_t i = 0; i < list.NumberOfEntries; i++) {
     MINIDUMP_MEMORY_INFO info;
 
-    if (!file_reader_->ReadExactly(&info, sizeof(info))) {
+    if (!file_reader->ReadExactly(&info, sizeof(info))) {
       return false;
     }
 
@@ -507,7 +836,8 @@ bool ProcessSnapshotMinidump::InitializeMemoryInfo() {
   return true;
 }
 
-bool ProcessSnapshotMinidump::InitializeExtraMemory() {
+bool ProcessSnapshotMinidump::InitializeExtraMemory(
+    FileReaderInterface* file_reader) {
   const auto& stream_it = stream_map_.find(kMinidumpStreamTypeMemoryList);
   if (stream_it == stream_map_.end()) {
     return true;
@@ -518,7 +848,7 @@ bool ProcessSnapshotMinidump::InitializeExtraMemory() {
     return false;
   }
 
-  if (!file_reader_->SeekSet(stream_it->second->Rva)) {
+  if (!file_reader->SeekSet(stream_it->second->Rva)) {
     return false;
   }
 
@@ -530,28 +860,87 @@ bool ProcessSnapshotMinidump::InitializeExtraMemory() {
       sizeof(MINIDUMP_MEMORY_LIST) == 4,
       "MINIDUMP_MEMORY_LIST's only actual field should be an uint32_t");
   uint32_t num_ranges;
-  if (!file_reader_->ReadExactly(&num_ranges, sizeof(num_ranges))) {
+  if (!file_reader->ReadExactly(&num_ranges, sizeof(num_ranges))) {
     return false;
   }
 
   // We have to manually keep track of the locations of the entries in the
   // contiguous list of MINIDUMP_MEMORY_DESCRIPTORs, because the Initialize()
   // function jumps around the file to find the contents of each snapshot.
-  FileOffset location = file_reader_->SeekGet();
+  FileOffset location = file_reader->SeekGet();
   for (uint32_t i = 0; i < num_ranges; i++) {
-    extra_memory_.emplace_back(
-        std::make_unique<internal::MemorySnapshotMinidump>());
-    if (!extra_memory_.back()->Initialize(file_reader_,
-                                          static_cast<RVA>(location))) {
+    auto memory = std::make_unique<internal::MemorySnapshotMinidump>();
+    if (!memory->Initialize(
+            file_reader, static_cast<RVA>(location), file_data_)) {
       return false;
     }
+    extra_memory_.push_back(std::move(memory));
     location += sizeof(MINIDUMP_MEMORY_DESCRIPTOR);
   }
 
   return true;
 }
 
-bool ProcessSnapshotMinidump::InitializeThreads() {
+bool ProcessSnapshotMinidump::InitializeMemory64List(
+    FileReaderInterface* file_reader) {
+  const auto& stream_it = stream_map_.find(kMinidumpStreamTypeMemory64List);
+  if (stream_it == stream_map_.end()) {
+    return true;
+  }
+
+  MINIDUMP_MEMORY64_LIST list;
+  if (stream_it->second->DataSize < sizeof(list)) {
+    LOG(ERROR) << "memory64_list size mismatch";
+    return false;
+  }
+
+  if (!file_reader->SeekSet(stream_it->second->Rva)) {
+    return false;
+  }
+
+  if (!file_reader->ReadExactly(&list, sizeof(list))) {
+    return false;
+  }
+
+  if (list.NumberOfMemoryRanges >
+      (stream_it->second->DataSize - sizeof(list)) /
+          sizeof(MINIDUMP_MEMORY_DESCRIPTOR64)) {
+    LOG(ERROR) << "memory64_list size mismatch";
+    return false;
+  }
+
+  // The data of each range immediately follows that of the one before it.
+  uint64_t data_offset = list.BaseRva;
+  for (uint64_t i = 0; i < list.NumberOfMemoryRanges; ++i) {
+    MINIDUMP_MEMORY_DESCRIPTOR64 descriptor;
+    if (!file_reader->ReadExactly(&descriptor, sizeof(descriptor))) {
+      return false;
+    }
+    const FileOffset next_descriptor = file_reader->SeekGet();
+    if (next_descriptor < 0) {
+      return false;
+    }
+
+    auto memory = std::make_unique<internal::MemorySnapshotMinidump>();
+    if (!memory->InitializeFromMemory64(
+            file_reader, descriptor, data_offset, file_data_)) {
+      return false;
+    }
+    extra_memory_.push_back(std::move(memory));
+
+    // InitializeFromMemory64() checked that the data is within the file, so
+    // this can’t overflow.
+    data_offset += descriptor.DataSize;
+    if (!file_reader->SeekSet(next_descriptor)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool ProcessSnapshotMinidump::InitializeThreads(
+    FileReaderInterface* file_reader) {
   const auto& stream_it = stream_map_.find(kMinidumpStreamTypeThreadList);
   if (stream_it == stream_map_.end()) {
     return true;
@@ -562,12 +951,12 @@ bool ProcessSnapshotMinidump::InitializeThreads() {
     return false;
   }
 
-  if (!file_reader_->SeekSet(stream_it->second->Rva)) {
+  if (!file_reader->SeekSet(stream_it->second->Rva)) {
     return false;
   }
 
   uint32_t thread_count;
-  if (!file_reader_->ReadExactly(&thread_count, sizeof(thread_count))) {
+  if (!file_reader->ReadExactly(&thread_count, sizeof(thread_count))) {
     return false;
   }
 
@@ -577,7 +966,7 @@ bool ProcessSnapshotMinidump::InitializeThreads() {
     return false;
   }
 
-  if (!InitializeThreadNames()) {
+  if (!InitializeThreadNames(file_reader)) {
     return false;
   }
 
@@ -586,7 +975,8 @@ bool ProcessSnapshotMinidump::InitializeThreads() {
                            thread_index * sizeof(MINIDUMP_THREAD);
 
     auto thread = std::make_unique<internal::ThreadSnapshotMinidump>();
-    if (!thread->Initialize(file_reader_, thread_rva, arch_, thread_names_)) {
+    if (!thread->Initialize(
+            file_reader, thread_rva, arch_, thread_names_, file_data_)) {
       return false;
     }
 
@@ -596,7 +986,8 @@ bool ProcessSnapshotMinidump::InitializeThreads() {
   return true;
 }
 
-bool ProcessSnapshotMinidump::InitializeThreadNames() {
+bool ProcessSnapshotMinidump::InitializeThreadNames(
+    FileReaderInterface* file_reader) {
   const auto& stream_it = stream_map_.find(kMinidumpStreamTypeThreadNameList);
   if (stream_it == stream_map_.end()) {
     return true;
@@ -607,13 +998,13 @@ bool ProcessSnapshotMinidump::InitializeThreadNames() {
     return false;
   }
 
-  if (!file_reader_->SeekSet(stream_it->second->Rva)) {
+  if (!file_reader->SeekSet(stream_it->second->Rva)) {
     return false;
   }
 
   uint32_t thread_name_count;
-  if (!file_reader_->ReadExactly(&thread_name_count,
-                                 sizeof(thread_name_count))) {
+  if (!file_reader->ReadExactly(&thread_name_count,
+                                sizeof(thread_name_count))) {
     return false;
   }
 
@@ -629,17 +1020,17 @@ bool ProcessSnapshotMinidump::InitializeThreadNames() {
     const RVA thread_name_rva =
         stream_it->second->Rva + sizeof(thread_name_count) +
         thread_name_index * sizeof(MINIDUMP_THREAD_NAME);
-    if (!file_reader_->SeekSet(thread_name_rva)) {
+    if (!file_reader->SeekSet(thread_name_rva)) {
       return false;
     }
     MINIDUMP_THREAD_NAME minidump_thread_name;
-    if (!file_reader_->ReadExactly(&minidump_thread_name,
-                                   sizeof(minidump_thread_name))) {
+    if (!file_reader->ReadExactly(&minidump_thread_name,
+                                  sizeof(minidump_thread_name))) {
       return false;
     }
     std::string name;
     if (!internal::ReadMinidumpUTF16String(
-            file_reader_, minidump_thread_name.RvaOfThreadName, &name)) {
+            file_reader, minidump_thread_name.RvaOfThreadName, &name)) {
       return false;
     }
 
@@ -651,7 +1042,8 @@ bool ProcessSnapshotMinidump::InitializeThreadNames() {
   return true;
 }
 
-bool ProcessSnapshotMinidump::InitializeSystemSnapshot() {
+bool ProcessSnapshotMinidump::InitializeSystemSnapshot(
+    FileReaderInterface* file_reader) {
   const auto& stream_it = stream_map_.find(kMinidumpStreamTypeSystemInfo);
   if (stream_it == stream_map_.end()) {
     return true;
@@ -662,8 +1054,11 @@ bool ProcessSnapshotMinidump::InitializeSystemSnapshot() {
     return false;
   }
 
-  if (!system_snapshot_.Initialize(
-          file_reader_, stream_it->second->Rva, full_version_)) {
+  if (!system_snapshot_.Initialize(file_reader,
+                                   stream_it->second->Rva,
+                                   full_version_,
+                                   machine_description_,
+                                   misc_info_)) {
     return false;
   }
 
@@ -671,7 +1066,8 @@ bool ProcessSnapshotMinidump::InitializeSystemSnapshot() {
   return true;
 }
 
-bool ProcessSnapshotMinidump::InitializeCustomMinidumpStreams() {
+bool ProcessSnapshotMinidump::InitializeCustomMinidumpStreams(
+    FileReaderInterface* file_reader) {
   for (size_t i = 0; i < stream_directory_.size(); i++) {
     const auto& stream = stream_directory_[i];
 
@@ -686,8 +1082,8 @@ bool ProcessSnapshotMinidump::InitializeCustomMinidumpStreams() {
     }
 
     std::vector<uint8_t> data(stream.Location.DataSize);
-    if (!file_reader_->SeekSet(stream.Location.Rva) ||
-        !file_reader_->ReadExactly(data.data(), data.size())) {
+    if (!file_reader->SeekSet(stream.Location.Rva) ||
+        !file_reader->ReadExactly(data.data(), data.size())) {
       LOG(ERROR) << "Failed to read stream with ID 0x" << std::hex
                  << stream_type << std::dec << " at index " << i;
       return false;
@@ -700,7 +1096,8 @@ bool ProcessSnapshotMinidump::InitializeCustomMinidumpStreams() {
   return true;
 }
 
-bool ProcessSnapshotMinidump::InitializeExceptionSnapshot() {
+bool ProcessSnapshotMinidump::InitializeExceptionSnapshot(
+    FileReaderInterface* file_reader) {
   const auto& stream_it = stream_map_.find(kMinidumpStreamTypeException);
   if (stream_it == stream_map_.end()) {
     return true;
@@ -712,7 +1109,7 @@ bool ProcessSnapshotMinidump::InitializeExceptionSnapshot() {
   }
 
   if (!exception_snapshot_.Initialize(
-          file_reader_, arch_, stream_it->second->Rva)) {
+          file_reader, arch_, stream_it->second->Rva)) {
     return false;
   }
 
@@ -20,17 +20,22 @@
 #include <stdint.h>
 #include <sys/time.h>
 
+#include <array>
+#include <atomic>
+#include <bitset>
 #include <map>
 #include <memory>
 #include <string>
 #include <vector>
 
+#include "base/synchronization/lock.h"
 #include "minidump/minidump_extensions.h"
 #include "snapshot/exception_snapshot.h"
 #include "snapshot/memory_snapshot.h"
 #include "snapshot/minidump/exception_snapshot_minidump.h"
 #include "snapshot/minidump/minidump_stream.h"
 #include "snapshot/minidump/module_snapshot_minidump.h"
+#include "snapshot/minidump/process_memory_minidump.h"
 #include "snapshot/minidump/system_snapshot_minidump.h"
 #include "snapshot/minidump/thread_snapshot_minidump.h"
 #include "snapshot/module_snapshot.h"
@@ -38,7 +43,11 @@
 #include "snapshot/system_snapshot.h"
 #include "snapshot/thread_snapshot.h"
 #include "snapshot/unloaded_module_snapshot.h"
+#include "util/file/buffered_file_reader.h"
 #include "util/file/file_reader.h"
+#include "util/file/mapped_file_reader.h"
+#include "util/file/memory_file_reader.h"
+#include "util/file/string_file.h"
 #include "util/misc/initialization_state_dcheck.h"
 #include "util/misc/uuid.h"
 #include "util/process/process_id.h"
@@ -62,12 +71,80 @@ class ProcessSnapshotMinidump final : public ProcessSnapshot {
   //! \brief Initializes the object.
   //!
   //! \param[in] file_reader A file reader corresponding to a minidump file.
-  //!     The file reader must support seeking.
+  //!     The file reader must support seeking. Minidumps compressed by
+  //!     MinidumpFileWriter::WriteCompressedMinidump() are also accepted, and
+  //!     are decompressed into memory. Memory snapshot data is read from
+  //!     the file reader as it is needed, so it must outlive this object.
+  //!
+  //! A minidump that carries a checksum, written as enabled by
+  //! MinidumpFileWriter::SetWriteChecksum(), is checked against it, and isn’t
+  //! used if it doesn’t match.
   //!
   //! \return `true` if the snapshot could be created, `false` otherwise with
   //!     an appropriate message logged.
   bool Initialize(FileReaderInterface* file_reader);
 
+  //! \brief Initializes the object from a mapped minidump file, reading
+  //!     streams that don’t depend on one another concurrently.
+  //!
+  //! This behaves like Initialize(), except that the streams are read on up to
+  //! \a thread_count threads at once, each reading from its own position in
+  //! the file, and memory snapshot data is copied straight out of \a
+  //! mapped_file. The thread list, memory lists, module list, and so on of a
+  //! large minidump are then read on separate cores. The snapshot is the same
+  //! for any number of threads.
+  //!
+  //! \param[in] mapped_file A mapped minidump file, which must outlive this
+  //!     object. Minidumps compressed by
+  //!     MinidumpFileWriter::WriteCompressedMinidump() are also accepted, and
+  //!     are decompressed into memory.
+  //! \param[in] thread_count The greatest number of threads, including the
+  //!     calling thread, to read streams on. `1` reads every stream on the
+  //!     calling thread.
+  //!
+  //! \return `true` if the snapshot could be created, `false` otherwise with
+  //!     an appropriate message logged.
+  bool Initialize(MappedFileReader* mapped_file, size_t thread_count);
+
+  //! \brief Initializes the object, deferring the reading of each stream until
+  //!     it is first needed.
+  //!
+  //! Only the minidump header and stream directory are read here. Each stream
+  //! is read the first time a method that returns its data is called, along
+  //! with any streams it depends on, and memory snapshot data is copied
+  //! straight out of \a mapped_file. This makes it cheap to open a large
+  //! minidump in order to examine only a part of it.
+  //!
+  //! Unlike Initialize(), this doesn’t detect problems with the streams
+  //! themselves. A stream that can’t be read has a message logged when it is
+  //! first needed, and the methods that return its data return what could be
+  //! read of it.
+  //!
+  //! \param[in] mapped_file A mapped minidump file, which must outlive this
+  //!     object. Minidumps compressed by
+  //!     MinidumpFileWriter::WriteCompressedMinidump() are also accepted, and
+  //!     are decompressed into memory.
+  //!
+  //! \return `true` if the snapshot could be created, `false` otherwise with
+  //!     an appropriate message logged.
+  bool InitializeLazily(MappedFileReader* mapped_file);
+
+  //! \brief Initializes the object, deferring the reading of each stream until
+  //!     it is first needed, from a file reader that isn’t mapped.
+  //!
+  //! This behaves like InitializeLazily(MappedFileReader*), except that stream
+  //! and memory snapshot data is read from \a file_reader as it is needed. It
+  //! suits file readers for which reading is expensive, such as
+  //! HTTPRangeFileReader, because only the parts of the file that are needed
+  //! are read.
+  //!
+  //! \param[in] file_reader A file reader corresponding to a minidump file,
+  //!     which must support seeking and outlive this object.
+  //!
+  //! \return `true` if the snapshot could be created, `false` otherwise with
+  //!     an appropriate message logged.
+  bool InitializeLazily(FileReaderInterface* file_reader);
+
   // ProcessSnapshot:
 
   crashpad::ProcessID ProcessID() const override;
@@ -100,51 +177,125 @@ class ProcessSnapshotMinidump final : public ProcessSnapshot {
   std::vector<const MinidumpStream*> CustomMinidumpStreams() const;
 
  private:
+  // The groups of streams initialized by InitializeStreams(), in the order that
+  // Initialize() initializes them. Each group may depend only on groups that
+  // precede it.
+  enum class StreamGroup : size_t {
+    kCrashpadInfo = 0,
+    kMiscInfo,
+    kModules,
+    kSystem,
+    kMemoryInfo,
+    kExtraMemory,
+    kThreads,
+    kCustomStreams,
+    kException,
+
+    kCount,
+  };
+
+  // Stream groups waiting to be initialized by InitializeQueuedStreams(), and
+  // whether each of them was initialized successfully, indexed by StreamGroup.
+  struct StreamGroupQueue {
+    StreamGroupQueue();
+    ~StreamGroupQueue();
+
+    std::vector<StreamGroup> groups;
+    std::atomic<size_t> next;
+    std::array<bool, static_cast<size_t>(StreamGroup::kCount)> succeeded;
+  };
+
+  class StreamThread;
+
+  // Reads the header and stream directory from file_reader, on behalf of
+  // Initialize() and InitializeLazily().
+  bool InitializeHeader(FileReaderInterface* file_reader,
+                        const uint8_t* file_data);
+
+  // Reads the header, checks the checksum, and initializes every group of
+  // streams, on behalf of Initialize(). The groups are initialized on up to
+  // thread_count threads if the file’s contents are in memory.
+  bool InitializeFully(FileReaderInterface* file_reader,
+                       const uint8_t* file_data,
+                       size_t thread_count);
+
+  // Initializes every group of streams on up to thread_count threads, reading
+  // each group from file_data_ through its element of stream_readers_.
+  bool InitializeStreamsConcurrently(size_t thread_count);
+
+  // Initializes the groups in queue, one at a time until none remain. This
+  // runs on each of the threads used by InitializeStreamsConcurrently().
+  void InitializeQueuedStreams(StreamGroupQueue* queue);
+
+  // Returns the group that group depends on, or StreamGroup::kCount if it
+  // doesn’t depend on any.
+  static StreamGroup StreamGroupDependency(StreamGroup group);
+
+  // Initializes the streams in group, reading them from file_reader, first
+  // initializing the groups that it depends on.
+  bool InitializeStreams(StreamGroup group, FileReaderInterface* file_reader);
+
+  // Initializes the streams in group, reading them from file_reader, on behalf
+  // of InitializeStreams(). The groups that group depends on must already have
+  // been initialized.
+  bool InitializeStreamGroup(StreamGroup group,
+                             FileReaderInterface* file_reader);
+
+  // Initializes the streams in group on behalf of the methods that return
+  // their data, if they haven’t been already. This only has work to do when
+  // initialized by InitializeLazily().
+  void EnsureStreamsInitialized(StreamGroup group) const;
+
   // Initializes data carried in a MinidumpCrashpadInfo stream on behalf of
   // Initialize().
-  bool InitializeCrashpadInfo();
+  bool InitializeCrashpadInfo(FileReaderInterface* file_reader);
 
   // Initializes data carried in a MINIDUMP_MODULE_LIST stream on behalf of
   // Initialize().
-  bool InitializeModules();
+  bool InitializeModules(FileReaderInterface* file_reader);
 
   // Initializes data carried in a MINIDUMP_THREAD_LIST stream on behalf of
   // Initialize().
-  bool InitializeThreads();
+  bool InitializeThreads(FileReaderInterface* file_reader);
 
   // Initializes data carried in a MINIDUMP_THREAD_NAME_LIST stream on behalf of
   // Initialize().
-  bool InitializeThreadNames();
+  bool InitializeThreadNames(FileReaderInterface* file_reader);
 
   // Initializes data carried in a MINIDUMP_MEMORY_INFO_LIST stream on behalf of
   // Initialize().
-  bool InitializeMemoryInfo();
+  bool InitializeMemoryInfo(FileReaderInterface* file_reader);
 
   // Initializes data carried in a MINIDUMP_MEMORY_LIST stream on behalf of
   // Initialize().
-  bool InitializeExtraMemory();
+  bool InitializeExtraMemory(FileReaderInterface* file_reader);
+
+  // Initializes data carried in a MINIDUMP_MEMORY64_LIST stream on behalf of
+  // Initialize(). Its memory is treated as extra memory.
+  bool InitializeMemory64List(FileReaderInterface* file_reader);
 
   // Initializes data carried in a MINIDUMP_SYSTEM_INFO stream on behalf of
   // Initialize().
-  bool InitializeSystemSnapshot();
+  bool InitializeSystemSnapshot(FileReaderInterface* file_reader);
 
   // Initializes data carried in a MinidumpModuleCrashpadInfoList structure on
   // behalf of InitializeModules(). This makes use of MinidumpCrashpadInfo as
   // well, so it must be called after InitializeCrashpadInfo().
   bool InitializeModulesCrashpadInfo(
+      FileReaderInterface* file_reader,
       std::map<uint32_t, MINIDUMP_LOCATION_DESCRIPTOR>*
           module_crashpad_info_links);
 
   // Initializes data carried in a MINIDUMP_MISC_INFO structure on behalf of
   // Initialize().
-  bool InitializeMiscInfo();
+  bool InitializeMiscInfo(FileReaderInterface* file_reader);
 
   // Initializes custom minidump streams.
-  bool InitializeCustomMinidumpStreams();
+  bool InitializeCustomMinidumpStreams(FileReaderInterface* file_reader);
 
   // Initializes data carried in a MINIDUMP_EXCEPTION_STREAM stream on behalf of
   // Initialize().
-  bool InitializeExceptionSnapshot();
+  bool InitializeExceptionSnapshot(FileReaderInterface* file_reader);
 
   MINIDUMP_HEADER header_;
   std::vector<MINIDUMP_DIRECTORY> stream_directory_;
@@ -157,6 +308,9 @@ class ProcessSnapshotMinidump final : public ProcessSnapshot {
       mem_regions_;
   std::vector<const MemoryMapRegionSnapshot*> mem_regions_exposed_;
   std::vector<std::unique_ptr<internal::MemorySnapshotMinidump>> extra_memory_;
+
+  // Reads from extra_memory_ by address, on behalf of Memory().
+  internal::ProcessMemoryMinidump process_memory_;
   std::vector<std::unique_ptr<MinidumpStream>> custom_streams_;
   MinidumpCrashpadInfo crashpad_info_;
   internal::SystemSnapshotMinidump system_snapshot_;
@@ -164,7 +318,41 @@ class ProcessSnapshotMinidump final : public ProcessSnapshot {
   CPUArchitecture arch_;
   std::map<std::string, std::string> annotations_simple_map_;
   std::string full_version_;
+  std::string machine_description_;
+
+  // The misc info stream, with the fields beyond those that the stream
+  // carries left zeroed. Its Flags1 field tells which of the fields are valid.
+  MINIDUMP_MISC_INFO_5 misc_info_;
+
   FileReaderInterface* file_reader_;  // weak
+
+  // The entire contents of the file that file_reader_ reads, when they are in
+  // memory.
+  const uint8_t* file_data_;  // weak
+
+  // Holds the decompressed minidump when Initialize() is given a compressed
+  // one, in which case file_reader_ refers to this.
+  std::unique_ptr<StringFile> decompressed_file_;
+
+  // Buffers reads from the file reader given to Initialize() when the file
+  // isn’t in memory, in which case file_reader_ refers to this. Parsing makes
+  // many small reads of nearby data, which this serves without a system call
+  // for each.
+  std::unique_ptr<BufferedFileReader> buffered_file_;
+
+  // The readers that InitializeStreamsConcurrently() reads each group of
+  // streams through, indexed by StreamGroup. These are kept because the
+  // snapshots made from the streams refer to them.
+  std::array<std::unique_ptr<MemoryFileReader>,
+             static_cast<size_t>(StreamGroup::kCount)>
+      stream_readers_;
+
+  // The groups of streams that have been initialized, or that have failed to
+  // be, indexed by StreamGroup. After Initialize() returns, this and the data
+  // of the streams that aren’t yet initialized are guarded by streams_lock_.
+  // InitializeStreamsConcurrently() changes this only on its calling thread.
+  std::bitset<static_cast<size_t>(StreamGroup::kCount)> streams_initialized_;
+  mutable base::Lock streams_lock_;
   crashpad::ProcessID process_id_;
   uint32_t create_time_;
   uint32_t user_time_;
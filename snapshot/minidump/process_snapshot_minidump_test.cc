@@ -21,6 +21,8 @@
 #include <algorithm>
 #include <iterator>
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "base/numerics/safe_math.h"
 #include "base/strings/utf_string_conversions.h"
@@ -29,8 +31,12 @@
 #include "snapshot/memory_map_region_snapshot.h"
 #include "snapshot/minidump/minidump_annotation_reader.h"
 #include "snapshot/module_snapshot.h"
+#include "test/scoped_temp_dir.h"
+#include "util/file/file_io.h"
+#include "util/file/mapped_file_reader.h"
 #include "util/file/string_file.h"
 #include "util/misc/pdb_structures.h"
+#include "util/process/process_memory.h"
 
 namespace crashpad {
 namespace test {
@@ -229,6 +235,23 @@ void WriteMinidumpAnnotationList(
       sizeof(MinidumpAnnotationList) + count * sizeof(MinidumpAnnotation);
 }
 
+void WriteMinidumpAnnotationThreadList(
+    MINIDUMP_LOCATION_DESCRIPTOR* location,
+    FileWriterInterface* writer,
+    const std::vector<AnnotationSnapshot>& annotations) {
+  location->Rva = static_cast<RVA>(writer->SeekGet());
+
+  auto count = static_cast<uint32_t>(annotations.size());
+  EXPECT_TRUE(writer->Write(&count, sizeof(count)));
+
+  for (const auto& it : annotations) {
+    EXPECT_TRUE(writer->Write(&it.thread_id, sizeof(it.thread_id)));
+  }
+
+  location->DataSize =
+      sizeof(MinidumpAnnotationThreadList) + count * sizeof(uint64_t);
+}
+
 TEST(ProcessSnapshotMinidump, ClientID) {
   StringFile string_file;
 
@@ -463,8 +486,13 @@ TEST(ProcessSnapshotMinidump, Modules) {
       {"2", 0xEDD1, {0x11, 0x22, 0x33}},
       {"threeeeee", 0xDADA, {'f'}},
   };
+  annotations_4[2].thread_id = 0xB0BB1E;
   WriteMinidumpAnnotationList(
       &crashpad_module_4.annotation_objects, &string_file, annotations_4);
+  WriteMinidumpAnnotationThreadList(
+      &crashpad_module_4.annotation_object_threads,
+      &string_file,
+      annotations_4);
 
   MinidumpModuleCrashpadInfoLink crashpad_module_4_link = {};
   crashpad_module_4_link.minidump_module_list_index = 3;
@@ -899,6 +927,7 @@ TEST(ProcessSnapshotMinidump, System) {
   EXPECT_EQ(s->GetOperatingSystem(),
             SystemSnapshot::OperatingSystem::kOperatingSystemFuchsia);
   EXPECT_EQ(s->OSVersionFull(), "MyOSVersion");
+  EXPECT_EQ(s->MachineDescription(), "MyMachineDescription");
 
   int major, minor, bugfix;
   std::string build;
@@ -1343,6 +1372,293 @@ TEST(ProcessSnapshotMinidump, Stacks) {
   EXPECT_EQ(delegate.result, minidump_stack);
 }
 
+// Writes a minidump with a memory list describing regions. Each region’s data
+// is written to the file, and its descriptor claims claimed_size bytes of it
+// if that’s nonzero, or the size of data otherwise.
+struct MemoryListRegion {
+  uint64_t address;
+  std::string data;
+  uint32_t claimed_size;
+};
+
+void WriteMinidumpWithMemoryList(StringFile* string_file,
+                                 const std::vector<MemoryListRegion>& regions) {
+  MINIDUMP_HEADER header = {};
+  ASSERT_TRUE(string_file->Write(&header, sizeof(header)));
+
+  std::vector<MINIDUMP_MEMORY_DESCRIPTOR> descriptors;
+  for (const MemoryListRegion& region : regions) {
+    MINIDUMP_MEMORY_DESCRIPTOR descriptor = {};
+    descriptor.StartOfMemoryRange = region.address;
+    descriptor.Memory.DataSize =
+        region.claimed_size ? region.claimed_size
+                            : base::checked_cast<uint32_t>(region.data.size());
+    descriptor.Memory.Rva = static_cast<RVA>(string_file->SeekGet());
+    ASSERT_TRUE(string_file->Write(region.data.data(), region.data.size()));
+    descriptors.push_back(descriptor);
+  }
+
+  MINIDUMP_DIRECTORY memory_list_directory = {};
+  memory_list_directory.StreamType = kMinidumpStreamTypeMemoryList;
+  memory_list_directory.Location.DataSize = base::checked_cast<uint32_t>(
+      sizeof(MINIDUMP_MEMORY_LIST) +
+      descriptors.size() * sizeof(MINIDUMP_MEMORY_DESCRIPTOR));
+  memory_list_directory.Location.Rva = static_cast<RVA>(string_file->SeekGet());
+
+  uint32_t descriptor_count = base::checked_cast<uint32_t>(descriptors.size());
+  ASSERT_TRUE(string_file->Write(&descriptor_count, sizeof(descriptor_count)));
+  ASSERT_TRUE(string_file->Write(
+      descriptors.data(), descriptors.size() * sizeof(descriptors[0])));
+
+  header.StreamDirectoryRva = static_cast<RVA>(string_file->SeekGet());
+  ASSERT_TRUE(
+      string_file->Write(&memory_list_directory, sizeof(memory_list_directory)));
+
+  header.Signature = MINIDUMP_SIGNATURE;
+  header.Version = MINIDUMP_VERSION;
+  header.NumberOfStreams = 1;
+  ASSERT_TRUE(string_file->SeekSet(0));
+  ASSERT_TRUE(string_file->Write(&header, sizeof(header)));
+}
+
+TEST(ProcessSnapshotMinidump, ExtraMemory) {
+  StringFile string_file;
+  ASSERT_NO_FATAL_FAILURE(WriteMinidumpWithMemoryList(
+      &string_file, {{0x1000, "abcdef", 0}, {0x1004, "EFGHIJ", 0}}));
+
+  ProcessSnapshotMinidump process_snapshot;
+  ASSERT_TRUE(process_snapshot.Initialize(&string_file));
+
+  std::vector<const MemorySnapshot*> extra_memory =
+      process_snapshot.ExtraMemory();
+  ASSERT_EQ(extra_memory.size(), 2u);
+  EXPECT_EQ(extra_memory[0]->Address(), 0x1000u);
+  EXPECT_EQ(extra_memory[0]->Size(), 6u);
+  EXPECT_EQ(extra_memory[1]->Address(), 0x1004u);
+  EXPECT_EQ(extra_memory[1]->Size(), 6u);
+
+  ReadToVector delegate;
+  ASSERT_TRUE(extra_memory[1]->Read(&delegate));
+  EXPECT_EQ(std::string(delegate.result.begin(), delegate.result.end()),
+            "EFGHIJ");
+
+  // The merged region takes the first region’s data up to where the second
+  // begins, and is read from both places in the file.
+  std::unique_ptr<const MemorySnapshot> merged(
+      extra_memory[1]->MergeWithOtherSnapshot(extra_memory[0]));
+  ASSERT_TRUE(merged);
+  EXPECT_EQ(merged->Address(), 0x1000u);
+  EXPECT_EQ(merged->Size(), 10u);
+  ASSERT_TRUE(merged->Read(&delegate));
+  EXPECT_EQ(std::string(delegate.result.begin(), delegate.result.end()),
+            "abcdEFGHIJ");
+}
+
+TEST(ProcessSnapshotMinidump, ExtraMemoryOutOfRange) {
+  StringFile string_file;
+  ASSERT_NO_FATAL_FAILURE(
+      WriteMinidumpWithMemoryList(&string_file, {{0x1000, "abcdef", 0x10000}}));
+
+  ProcessSnapshotMinidump process_snapshot;
+  EXPECT_FALSE(process_snapshot.Initialize(&string_file));
+}
+
+TEST(ProcessSnapshotMinidump, ExtraMemoryReadRange) {
+  StringFile string_file;
+  ASSERT_NO_FATAL_FAILURE(WriteMinidumpWithMemoryList(
+      &string_file, {{0x1000, "abcdef", 0}, {0x1004, "EFGHIJ", 0}}));
+
+  ProcessSnapshotMinidump process_snapshot;
+  ASSERT_TRUE(process_snapshot.Initialize(&string_file));
+
+  std::vector<const MemorySnapshot*> extra_memory =
+      process_snapshot.ExtraMemory();
+  ASSERT_EQ(extra_memory.size(), 2u);
+  std::unique_ptr<const MemorySnapshot> merged(
+      extra_memory[1]->MergeWithOtherSnapshot(extra_memory[0]));
+  ASSERT_TRUE(merged);
+  ASSERT_TRUE(merged->SupportsReadRange());
+
+  // A range spanning both places in the file that the merged region is read
+  // from.
+  char buffer[5];
+  ASSERT_TRUE(merged->ReadRange(2, sizeof(buffer), buffer));
+  EXPECT_EQ(std::string(buffer, sizeof(buffer)), "cdEFG");
+
+  ASSERT_TRUE(merged->ReadRange(6, 4, buffer));
+  EXPECT_EQ(std::string(buffer, 4), "GHIJ");
+}
+
+TEST(ProcessSnapshotMinidump, Memory) {
+  StringFile string_file;
+  ASSERT_NO_FATAL_FAILURE(
+      WriteMinidumpWithMemoryList(&string_file,
+                                  {{0x3000, "uvwxyz", 0},
+                                   {0x1004, "EFGHIJ", 0},
+                                   {0x1000, "abcdef", 0},
+                                   {0x1005, "f", 0}}));
+
+  ProcessSnapshotMinidump process_snapshot;
+  ASSERT_TRUE(process_snapshot.Initialize(&string_file));
+
+  const ProcessMemory* memory = process_snapshot.Memory();
+  ASSERT_TRUE(memory);
+
+  char buffer[10];
+  ASSERT_TRUE(memory->Read(0x3002, 3, buffer));
+  EXPECT_EQ(std::string(buffer, 3), "wxy");
+
+  // Where regions overlap, the one at the lower address is read, and a read
+  // carries on into the region that follows it.
+  ASSERT_TRUE(memory->Read(0x1000, sizeof(buffer), buffer));
+  EXPECT_EQ(std::string(buffer, sizeof(buffer)), "abcdefGHIJ");
+
+  // Memory that wasn’t captured can’t be read.
+  EXPECT_FALSE(memory->Read(0x0fff, 2, buffer));
+  EXPECT_FALSE(memory->Read(0x1008, 4, buffer));
+  EXPECT_FALSE(memory->Read(0x2000, 1, buffer));
+  EXPECT_FALSE(memory->Read(0x3006, 1, buffer));
+}
+
+// Writes string_file’s contents to a file in temp_dir and maps it.
+void MapMinidump(const StringFile& string_file,
+                 const ScopedTempDir& temp_dir,
+                 MappedFileReader* mapped_file) {
+  const base::FilePath path =
+      temp_dir.path().Append(FILE_PATH_LITERAL("minidump.dmp"));
+  {
+    ScopedFileHandle handle(LoggingOpenFileForWrite(
+        path, FileWriteMode::kCreateOrFail, FilePermissions::kOwnerOnly));
+    ASSERT_TRUE(handle.is_valid());
+    ASSERT_TRUE(LoggingWriteFile(handle.get(),
+                                 string_file.string().data(),
+                                 string_file.string().size()));
+  }
+  ASSERT_TRUE(mapped_file->Open(path));
+}
+
+TEST(ProcessSnapshotMinidump, InitializeLazily) {
+  StringFile string_file;
+  ASSERT_NO_FATAL_FAILURE(WriteMinidumpWithMemoryList(
+      &string_file, {{0x1000, "abcdef", 0}, {0x1004, "EFGHIJ", 0}}));
+
+  ScopedTempDir temp_dir;
+  MappedFileReader mapped_file;
+  ASSERT_NO_FATAL_FAILURE(MapMinidump(string_file, temp_dir, &mapped_file));
+
+  ProcessSnapshotMinidump process_snapshot;
+  ASSERT_TRUE(process_snapshot.InitializeLazily(&mapped_file));
+
+  EXPECT_TRUE(process_snapshot.Threads().empty());
+  EXPECT_TRUE(process_snapshot.AnnotationsSimpleMap().empty());
+
+  std::vector<const MemorySnapshot*> extra_memory =
+      process_snapshot.ExtraMemory();
+  ASSERT_EQ(extra_memory.size(), 2u);
+  EXPECT_EQ(extra_memory[0]->Address(), 0x1000u);
+  EXPECT_EQ(extra_memory[0]->Size(), 6u);
+
+  // The memory is initialized only once.
+  EXPECT_EQ(process_snapshot.ExtraMemory(), extra_memory);
+
+  ReadToVector delegate;
+  ASSERT_TRUE(extra_memory[0]->Read(&delegate));
+  EXPECT_EQ(std::string(delegate.result.begin(), delegate.result.end()),
+            "abcdef");
+
+  std::unique_ptr<const MemorySnapshot> merged(
+      extra_memory[1]->MergeWithOtherSnapshot(extra_memory[0]));
+  ASSERT_TRUE(merged);
+  ASSERT_TRUE(merged->Read(&delegate));
+  EXPECT_EQ(std::string(delegate.result.begin(), delegate.result.end()),
+            "abcdEFGHIJ");
+
+  char buffer[5];
+  ASSERT_TRUE(merged->ReadRange(2, sizeof(buffer), buffer));
+  EXPECT_EQ(std::string(buffer, sizeof(buffer)), "cdEFG");
+}
+
+TEST(ProcessSnapshotMinidump, InitializeLazilyOutOfRange) {
+  StringFile string_file;
+  ASSERT_NO_FATAL_FAILURE(
+      WriteMinidumpWithMemoryList(&string_file, {{0x1000, "abcdef", 0x10000}}));
+
+  ScopedTempDir temp_dir;
+  MappedFileReader mapped_file;
+  ASSERT_NO_FATAL_FAILURE(MapMinidump(string_file, temp_dir, &mapped_file));
+
+  // The memory list isn’t read until it’s needed, and then only what could be
+  // read of it is returned.
+  ProcessSnapshotMinidump process_snapshot;
+  ASSERT_TRUE(process_snapshot.InitializeLazily(&mapped_file));
+  EXPECT_TRUE(process_snapshot.ExtraMemory().empty());
+}
+
+TEST(ProcessSnapshotMinidump, InitializeLazilyFromFileReader) {
+  StringFile string_file;
+  ASSERT_NO_FATAL_FAILURE(WriteMinidumpWithMemoryList(
+      &string_file, {{0x1000, "abcdef", 0}, {0x2000, "ghijkl", 0}}));
+
+  ProcessSnapshotMinidump process_snapshot;
+  ASSERT_TRUE(process_snapshot.InitializeLazily(&string_file));
+
+  std::vector<const MemorySnapshot*> extra_memory =
+      process_snapshot.ExtraMemory();
+  ASSERT_EQ(extra_memory.size(), 2u);
+
+  ReadToVector delegate;
+  ASSERT_TRUE(extra_memory[1]->Read(&delegate));
+  EXPECT_EQ(std::string(delegate.result.begin(), delegate.result.end()),
+            "ghijkl");
+}
+
+TEST(ProcessSnapshotMinidump, InitializeConcurrently) {
+  StringFile string_file;
+  ASSERT_NO_FATAL_FAILURE(WriteMinidumpWithMemoryList(
+      &string_file, {{0x1000, "abcdef", 0}, {0x1004, "EFGHIJ", 0}}));
+
+  ScopedTempDir temp_dir;
+  MappedFileReader mapped_file;
+  ASSERT_NO_FATAL_FAILURE(MapMinidump(string_file, temp_dir, &mapped_file));
+
+  ProcessSnapshotMinidump process_snapshot;
+  ASSERT_TRUE(process_snapshot.Initialize(&mapped_file, 4));
+
+  EXPECT_TRUE(process_snapshot.Threads().empty());
+  EXPECT_TRUE(process_snapshot.Modules().empty());
+
+  std::vector<const MemorySnapshot*> extra_memory =
+      process_snapshot.ExtraMemory();
+  ASSERT_EQ(extra_memory.size(), 2u);
+  EXPECT_EQ(extra_memory[0]->Address(), 0x1000u);
+  EXPECT_EQ(extra_memory[1]->Address(), 0x1004u);
+
+  std::unique_ptr<const MemorySnapshot> merged(
+      extra_memory[1]->MergeWithOtherSnapshot(extra_memory[0]));
+  ASSERT_TRUE(merged);
+  ReadToVector delegate;
+  ASSERT_TRUE(merged->Read(&delegate));
+  EXPECT_EQ(std::string(delegate.result.begin(), delegate.result.end()),
+            "abcdEFGHIJ");
+
+  char buffer[6];
+  ASSERT_TRUE(process_snapshot.Memory()->Read(0x1002, sizeof(buffer), buffer));
+  EXPECT_EQ(std::string(buffer, sizeof(buffer)), "cdefGH");
+}
+
+TEST(ProcessSnapshotMinidump, InitializeConcurrentlyOutOfRange) {
+  StringFile string_file;
+  ASSERT_NO_FATAL_FAILURE(
+      WriteMinidumpWithMemoryList(&string_file, {{0x1000, "abcdef", 0x10000}}));
+
+  ScopedTempDir temp_dir;
+  MappedFileReader mapped_file;
+  ASSERT_NO_FATAL_FAILURE(MapMinidump(string_file, temp_dir, &mapped_file));
+
+  ProcessSnapshotMinidump process_snapshot;
+  EXPECT_FALSE(process_snapshot.Initialize(&mapped_file, 4));
+}
+
 TEST(ProcessSnapshotMinidump, CustomMinidumpStreams) {
   StringFile string_file;
 
@@ -14,23 +14,92 @@
 
 #include "snapshot/minidump/system_snapshot_minidump.h"
 
-#include "base/notreached.h"
+#include <string>
+
+#include "base/strings/utf_string_conversions.h"
 #include "snapshot/minidump/minidump_string_reader.h"
 
 namespace crashpad {
 namespace internal {
 
+namespace {
+
+// Converts a fixed-size UTF-16 field of a minidump structure, which is
+// NUL-terminated unless it fills the field.
+template <typename Char, size_t kSize>
+std::string FixedUTF16ToUTF8(const Char (&field)[kSize]) {
+  static_assert(sizeof(Char) == sizeof(char16_t), "UTF-16 field");
+  size_t length = 0;
+  while (length < kSize && field[length]) {
+    ++length;
+  }
+  return base::UTF16ToUTF8(
+      std::u16string(reinterpret_cast<const char16_t*>(field), length));
+}
+
+// The cpuid bits that MinidumpSystemInfoWriter maps to and from the PF_*
+// bits of MINIDUMP_SYSTEM_INFO::OtherCpuInfo for x86_64.
+struct FeatureBit {
+  int cpuid_bit;
+  int minidump_bit;
+};
+
+constexpr FeatureBit kAMD64Features[] = {
+    {4, PF_RDTSC_INSTRUCTION_AVAILABLE},
+    {6, PF_PAE_ENABLED},
+    {23, PF_MMX_INSTRUCTIONS_AVAILABLE},
+    {25, PF_XMMI_INSTRUCTIONS_AVAILABLE},
+    {26, PF_XMMI64_INSTRUCTIONS_AVAILABLE},
+    {32, PF_SSE3_INSTRUCTIONS_AVAILABLE},
+    {45, PF_COMPARE_EXCHANGE128},
+    {58, PF_XSAVE_ENABLED},
+    {62, PF_RDRAND_INSTRUCTION_AVAILABLE},
+};
+
+constexpr FeatureBit kAMD64ExtendedFeatures[] = {
+    {27, PF_RDTSCP_INSTRUCTION_AVAILABLE},
+    {31, PF_3DNOW_INSTRUCTIONS_AVAILABLE},
+};
+
+constexpr FeatureBit kAMD64Leaf7Features[] = {
+    {0, PF_RDWRFSGSBASE_AVAILABLE},
+};
+
+template <size_t kCount>
+uint64_t CPUIDFeatures(uint64_t minidump_features,
+                       const FeatureBit (&map)[kCount]) {
+  uint64_t cpuid_features = 0;
+  for (const auto& feature : map) {
+    if (minidump_features & (UINT64_C(1) << feature.minidump_bit)) {
+      cpuid_features |= UINT64_C(1) << feature.cpuid_bit;
+    }
+  }
+  return cpuid_features;
+}
+
+}  // namespace
+
 SystemSnapshotMinidump::SystemSnapshotMinidump()
-    : SystemSnapshot(), minidump_system_info_(), initialized_() {}
+    : SystemSnapshot(),
+      minidump_system_info_(),
+      misc_info_(),
+      minidump_build_name_(),
+      full_version_(),
+      machine_description_(),
+      initialized_() {}
 
 SystemSnapshotMinidump::~SystemSnapshotMinidump() {}
 
 bool SystemSnapshotMinidump::Initialize(FileReaderInterface* file_reader,
                                         RVA minidump_system_info_rva,
-                                        const std::string& version) {
+                                        const std::string& version,
+                                        const std::string& machine_description,
+                                        const MINIDUMP_MISC_INFO_5& misc_info) {
   INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
 
   full_version_ = version;
+  machine_description_ = machine_description;
+  misc_info_ = misc_info;
 
   if (!file_reader->SeekSet(minidump_system_info_rva)) {
     return false;
@@ -98,37 +167,62 @@ std::string SystemSnapshotMinidump::CPUVendor() const {
 void SystemSnapshotMinidump::CPUFrequency(uint64_t* current_hz,
                                           uint64_t* max_hz) const {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
-  NOTREACHED();  // https://crashpad.chromium.org/bug/10
+  constexpr uint64_t kHzPerMHz = 1000000;
+  if (misc_info_.Flags1 & MINIDUMP_MISC1_PROCESSOR_POWER_INFO) {
+    *current_hz = misc_info_.ProcessorCurrentMhz * kHzPerMHz;
+    *max_hz = misc_info_.ProcessorMaxMhz * kHzPerMHz;
+  } else {
+    *current_hz = 0;
+    *max_hz = 0;
+  }
 }
 
 uint32_t SystemSnapshotMinidump::CPUX86Signature() const {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
-  NOTREACHED();  // https://crashpad.chromium.org/bug/10
+  if (GetCPUArchitecture() == kCPUArchitectureX86) {
+    return minidump_system_info_.Cpu.X86CpuInfo.VersionInformation;
+  }
   return 0;
 }
 
 uint64_t SystemSnapshotMinidump::CPUX86Features() const {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
-  NOTREACHED();  // https://crashpad.chromium.org/bug/10
-  return 0;
+  switch (GetCPUArchitecture()) {
+    case kCPUArchitectureX86:
+      return minidump_system_info_.Cpu.X86CpuInfo.FeatureInformation;
+    case kCPUArchitectureX86_64:
+      return CPUIDFeatures(AMD64ProcessorFeatures(), kAMD64Features);
+    default:
+      return 0;
+  }
 }
 
 uint64_t SystemSnapshotMinidump::CPUX86ExtendedFeatures() const {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
-  NOTREACHED();  // https://crashpad.chromium.org/bug/10
-  return 0;
+  switch (GetCPUArchitecture()) {
+    case kCPUArchitectureX86:
+      return minidump_system_info_.Cpu.X86CpuInfo.AMDExtendedCpuFeatures;
+    case kCPUArchitectureX86_64:
+      return CPUIDFeatures(AMD64ProcessorFeatures(), kAMD64ExtendedFeatures);
+    default:
+      return 0;
+  }
 }
 
 uint32_t SystemSnapshotMinidump::CPUX86Leaf7Features() const {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
-  NOTREACHED();  // https://crashpad.chromium.org/bug/10
+  if (GetCPUArchitecture() == kCPUArchitectureX86_64) {
+    return static_cast<uint32_t>(
+        CPUIDFeatures(AMD64ProcessorFeatures(), kAMD64Leaf7Features));
+  }
   return 0;
 }
 
 bool SystemSnapshotMinidump::CPUX86SupportsDAZ() const {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
-  NOTREACHED();  // https://crashpad.chromium.org/bug/10
-  return false;
+  return GetCPUArchitecture() == kCPUArchitectureX86_64 &&
+         (AMD64ProcessorFeatures() &
+          (UINT64_C(1) << PF_SSE_DAZ_MODE_AVAILABLE));
 }
 
 SystemSnapshot::OperatingSystem SystemSnapshotMinidump::GetOperatingSystem()
@@ -176,14 +270,13 @@ std::string SystemSnapshotMinidump::OSVersionFull() const {
 
 std::string SystemSnapshotMinidump::MachineDescription() const {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
-  NOTREACHED();  // https://crashpad.chromium.org/bug/10
-  return std::string();
+  return machine_description_;
 }
 
 bool SystemSnapshotMinidump::NXEnabled() const {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
-  NOTREACHED();  // https://crashpad.chromium.org/bug/10
-  return false;
+  return GetCPUArchitecture() == kCPUArchitectureX86_64 &&
+         (AMD64ProcessorFeatures() & (UINT64_C(1) << PF_NX_ENABLED));
 }
 
 void SystemSnapshotMinidump::TimeZone(DaylightSavingTimeStatus* dst_status,
@@ -192,7 +285,29 @@ void SystemSnapshotMinidump::TimeZone(DaylightSavingTimeStatus* dst_status,
                                       std::string* standard_name,
                                       std::string* daylight_name) const {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
-  NOTREACHED();  // https://crashpad.chromium.org/bug/10
+  if (!(misc_info_.Flags1 & MINIDUMP_MISC3_TIMEZONE)) {
+    *dst_status = kDoesNotObserveDaylightSavingTime;
+    *standard_offset_seconds = 0;
+    *daylight_offset_seconds = 0;
+    standard_name->clear();
+    daylight_name->clear();
+    return;
+  }
+
+  // This reverses MinidumpMiscInfoWriter::InitializeFromSnapshot(). The biases
+  // are in minutes west of UTC and of standard time, and the offsets are in
+  // seconds east of UTC.
+  const TIME_ZONE_INFORMATION& time_zone = misc_info_.TimeZone;
+  *dst_status = static_cast<DaylightSavingTimeStatus>(misc_info_.TimeZoneId);
+  *standard_offset_seconds = time_zone.Bias * -60;
+  *daylight_offset_seconds =
+      *standard_offset_seconds - time_zone.DaylightBias * 60;
+  *standard_name = FixedUTF16ToUTF8(time_zone.StandardName);
+  *daylight_name = FixedUTF16ToUTF8(time_zone.DaylightName);
+}
+
+uint64_t SystemSnapshotMinidump::AMD64ProcessorFeatures() const {
+  return minidump_system_info_.Cpu.OtherCpuInfo.ProcessorFeatures[0];
 }
 
 }  // namespace internal
@@ -16,6 +16,9 @@
 #define CRASHPAD_SNAPSHOT_MINIDUMP_SYSTEM_SNAPSHOT_MINIDUMP_H_
 
 #include <windows.h>
+#include <dbghelp.h>
+
+#include <string>
 
 #include "minidump/minidump_extensions.h"
 #include "snapshot/system_snapshot.h"
@@ -43,12 +46,19 @@ class SystemSnapshotMinidump : public SystemSnapshot {
   //!     which the thread’s MINIDUMP_SYSTEM_INFO structure is located.
   //! \param[in] version The OS version taken from the build string in
   //!     MINIDUMP_MISC_INFO_4.
+  //! \param[in] machine_description The machine description taken from the
+  //!     build string in MINIDUMP_MISC_INFO_4.
+  //! \param[in] misc_info The minidump’s MINIDUMP_MISC_INFO stream, which
+  //!     provides the CPU frequency and time zone when its `Flags1` field
+  //!     says that they are present.
   //!
   //! \return `true` if the snapshot could be created, `false` otherwise with
   //!     an appropriate message logged.
   bool Initialize(FileReaderInterface* file_reader,
                   RVA minidump_system_info_rva,
-                  const std::string& version);
+                  const std::string& version,
+                  const std::string& machine_description,
+                  const MINIDUMP_MISC_INFO_5& misc_info);
 
   CPUArchitecture GetCPUArchitecture() const override;
   uint32_t CPURevision() const override;
@@ -76,9 +86,15 @@ class SystemSnapshotMinidump : public SystemSnapshot {
                 std::string* daylight_name) const override;
 
  private:
+  // The bits of ProcessorFeatures in MINIDUMP_SYSTEM_INFO::OtherCpuInfo, for
+  // kCPUArchitectureX86_64.
+  uint64_t AMD64ProcessorFeatures() const;
+
   MINIDUMP_SYSTEM_INFO minidump_system_info_;
+  MINIDUMP_MISC_INFO_5 misc_info_;
   std::string minidump_build_name_;
   std::string full_version_;
+  std::string machine_description_;
   InitializationStateDcheck initialized_;
 };
 
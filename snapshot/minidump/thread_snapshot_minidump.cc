@@ -37,7 +37,8 @@ bool ThreadSnapshotMinidump::Initialize(
     FileReaderInterface* file_reader,
     RVA minidump_thread_rva,
     CPUArchitecture arch,
-    const std::map<uint32_t, std::string>& thread_names) {
+    const std::map<uint32_t, std::string>& thread_names,
+    const uint8_t* file_data) {
   INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
   std::vector<unsigned char> minidump_context;
 
@@ -67,7 +68,7 @@ bool ThreadSnapshotMinidump::Initialize(
   RVA stack_info_location =
       minidump_thread_rva + offsetof(MINIDUMP_THREAD, Stack);
 
-  if (!stack_.Initialize(file_reader, stack_info_location)) {
+  if (!stack_.Initialize(file_reader, stack_info_location, file_data)) {
     return false;
   }
   const auto thread_name_iter = thread_names.find(minidump_thread_.ThreadId);
@@ -122,5 +123,15 @@ std::vector<const MemorySnapshot*> ThreadSnapshotMinidump::ExtraMemory() const {
   return std::vector<const MemorySnapshot*>();
 }
 
+uint64_t ThreadSnapshotMinidump::UncapturedStackSize() const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  return 0;
+}
+
+std::vector<uint64_t> ThreadSnapshotMinidump::UnwoundFrames() const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  return std::vector<uint64_t>();
+}
+
 }  // namespace internal
 }  // namespace crashpad
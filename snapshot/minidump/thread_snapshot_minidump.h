@@ -50,13 +50,16 @@ class ThreadSnapshotMinidump : public ThreadSnapshot {
   //!     Used to decode CPU Context.
   //! \param[in] thread_names Map from thread ID to thread name previously read
   //!     from the minidump's MINIDUMP_THREAD_NAME_LIST.
+  //! \param[in] file_data The entire contents of the file that \a file_reader
+  //!     reads, or `nullptr`. See MemorySnapshotMinidump::Initialize().
   //!
   //! \return `true` if the snapshot could be created, `false` otherwise with
   //!     an appropriate message logged.
   bool Initialize(FileReaderInterface* file_reader,
                   RVA minidump_thread_rva,
                   CPUArchitecture arch,
-                  const std::map<uint32_t, std::string>& thread_names);
+                  const std::map<uint32_t, std::string>& thread_names,
+                  const uint8_t* file_data = nullptr);
 
   const CPUContext* Context() const override;
   const MemorySnapshot* Stack() const override;
@@ -66,6 +69,8 @@ class ThreadSnapshotMinidump : public ThreadSnapshot {
   int Priority() const override;
   uint64_t ThreadSpecificDataAddress() const override;
   std::vector<const MemorySnapshot*> ExtraMemory() const override;
+  uint64_t UncapturedStackSize() const override;
+  std::vector<uint64_t> UnwoundFrames() const override;
 
  private:
   //! \brief Initializes the CPU Context
@@ -16,11 +16,367 @@
 
 #include <string.h>
 
+#include <algorithm>
+#include <limits>
+#include <memory>
+
+#include "build/build_config.h"
+
+#if defined(ARCH_CPU_X86_FAMILY)
+#include <emmintrin.h>
+#elif defined(ARCH_CPU_ARM64)
+#include <arm_neon.h>
+#endif
+
 namespace crashpad {
 namespace internal {
 
 namespace {
 
+// Words in [low, low + span] that aren’t small may point into one of ranges and
+// must be looked up in it. All other words that aren’t small
+// are redacted without a lookup. low is always above kSmallWordMax, so small
+// words are never candidates.
+template <typename Pointer>
+void CandidateSpan(const RangeSet* ranges, Pointer* low, Pointer* span) {
+  constexpr VMAddress kFirstLargeWord =
+      MemorySnapshotSanitized::kSmallWordMax + 1;
+  constexpr VMAddress kMaxWord = std::numeric_limits<Pointer>::max();
+  VMAddress lowest, highest;
+  if (!ranges->Bounds(&lowest, &highest) || highest < kFirstLargeWord ||
+      lowest > kMaxWord) {
+    // Nothing can be found in ranges. Checking kFirstLargeWord alone keeps
+    // the vector loops free of a special case.
+    *low = static_cast<Pointer>(kFirstLargeWord);
+    *span = 0;
+    return;
+  }
+  lowest = std::max(lowest, kFirstLargeWord);
+  highest = std::min(highest, kMaxWord);
+  *low = static_cast<Pointer>(lowest);
+  *span = static_cast<Pointer>(highest - lowest);
+}
+
+// Redacts the words in words[0, count), with count at most
+// RangeSet::kMaxContainsMany, that are neither small nor in [low, low + span],
+// computed modulo 2^N where N is the width of Pointer. Returns a mask with bit
+// index set for each word that isn’t small but is in that span, and so must
+// still be checked against the ranges.
+template <typename Pointer>
+uint64_t DefaceOutsideSpanScalar(Pointer* words,
+                                 size_t count,
+                                 Pointer low,
+                                 Pointer span) {
+  uint64_t candidates = 0;
+  for (size_t index = 0; index < count; ++index) {
+    if (words[index] <= MemorySnapshotSanitized::kSmallWordMax) {
+      continue;
+    }
+    if (static_cast<Pointer>(words[index] - low) <= span) {
+      candidates |= uint64_t{1} << index;
+    } else {
+      words[index] = static_cast<Pointer>(MemorySnapshotSanitized::kDefaced);
+    }
+  }
+  return candidates;
+}
+
+// DefaceOutsideSpan() produces the same result as DefaceOutsideSpanScalar(),
+// but examines several words at a time, blending kDefaced in for those that are
+// neither small nor in the span. Stacks are mostly made of such words, so only
+// a few are left to be looked up in the ranges.
+
+#if defined(ARCH_CPU_X86_FAMILY)
+
+// SSE2 has no unsigned comparisons, so the sign bits of both operands are
+// flipped to compare them as signed values instead. It has no 64-bit
+// comparisons either, so those are made from 32-bit comparisons of each half.
+
+uint64_t DefaceOutsideSpan(uint32_t* words,
+                           size_t count,
+                           uint32_t low,
+                           uint32_t span) {
+  const __m128i sign = _mm_set1_epi32(static_cast<int>(0x80000000));
+  const __m128i small_max = _mm_xor_si128(
+      _mm_set1_epi32(static_cast<int>(MemorySnapshotSanitized::kSmallWordMax)),
+      sign);
+  const __m128i low_v = _mm_set1_epi32(static_cast<int>(low));
+  const __m128i span_v =
+      _mm_xor_si128(_mm_set1_epi32(static_cast<int>(span)), sign);
+  const __m128i defaced = _mm_set1_epi32(static_cast<int>(
+      static_cast<uint32_t>(MemorySnapshotSanitized::kDefaced)));
+  uint64_t candidates = 0;
+  size_t index = 0;
+  for (; index + 4 <= count; index += 4) {
+    __m128i* address = reinterpret_cast<__m128i*>(words + index);
+    const __m128i value = _mm_loadu_si128(address);
+    const __m128i large =
+        _mm_cmpgt_epi32(_mm_xor_si128(value, sign), small_max);
+    const __m128i outside = _mm_cmpgt_epi32(
+        _mm_xor_si128(_mm_sub_epi32(value, low_v), sign), span_v);
+    const __m128i deface = _mm_and_si128(large, outside);
+    _mm_storeu_si128(address,
+                     _mm_or_si128(_mm_andnot_si128(deface, value),
+                                  _mm_and_si128(deface, defaced)));
+    candidates |= static_cast<uint64_t>(_mm_movemask_ps(
+                      _mm_castsi128_ps(_mm_andnot_si128(outside, large))))
+                  << index;
+  }
+  if (index < count) {
+    candidates |=
+        DefaceOutsideSpanScalar(words + index, count - index, low, span)
+        << index;
+  }
+  return candidates;
+}
+
+// Returns all ones in each 64-bit lane of a that is greater than the same lane
+// of b, where the sign bits of both halves of each lane have been flipped.
+__m128i CompareGreater64(__m128i a, __m128i b) {
+  const __m128i greater = _mm_cmpgt_epi32(a, b);
+  const __m128i equal = _mm_cmpeq_epi32(a, b);
+
+  // A 64-bit value is greater if its high half is, or if its high half is
+  // equal and its low half is greater.
+  return _mm_or_si128(
+      _mm_shuffle_epi32(greater, _MM_SHUFFLE(3, 3, 1, 1)),
+      _mm_and_si128(_mm_shuffle_epi32(equal, _MM_SHUFFLE(3, 3, 1, 1)),
+                    _mm_shuffle_epi32(greater, _MM_SHUFFLE(2, 2, 0, 0))));
+}
+
+uint64_t DefaceOutsideSpan(uint64_t* words,
+                           size_t count,
+                           uint64_t low,
+                           uint64_t span) {
+  const __m128i sign = _mm_set1_epi32(static_cast<int>(0x80000000));
+  const __m128i small_max = _mm_xor_si128(
+      _mm_set1_epi64x(MemorySnapshotSanitized::kSmallWordMax), sign);
+  const __m128i low_v = _mm_set1_epi64x(low);
+  const __m128i span_v = _mm_xor_si128(_mm_set1_epi64x(span), sign);
+  const __m128i defaced = _mm_set1_epi64x(MemorySnapshotSanitized::kDefaced);
+  uint64_t candidates = 0;
+  size_t index = 0;
+  for (; index + 2 <= count; index += 2) {
+    __m128i* address = reinterpret_cast<__m128i*>(words + index);
+    const __m128i value = _mm_loadu_si128(address);
+    const __m128i large =
+        CompareGreater64(_mm_xor_si128(value, sign), small_max);
+    const __m128i outside = CompareGreater64(
+        _mm_xor_si128(_mm_sub_epi64(value, low_v), sign), span_v);
+    const __m128i deface = _mm_and_si128(large, outside);
+    _mm_storeu_si128(address,
+                     _mm_or_si128(_mm_andnot_si128(deface, value),
+                                  _mm_and_si128(deface, defaced)));
+    candidates |= static_cast<uint64_t>(_mm_movemask_pd(
+                      _mm_castsi128_pd(_mm_andnot_si128(outside, large))))
+                  << index;
+  }
+  if (index < count) {
+    candidates |=
+        DefaceOutsideSpanScalar(words + index, count - index, low, span)
+        << index;
+  }
+  return candidates;
+}
+
+#elif defined(ARCH_CPU_ARM64)
+
+uint64_t DefaceOutsideSpan(uint32_t* words,
+                           size_t count,
+                           uint32_t low,
+                           uint32_t span) {
+  const uint32x4_t small_max = vdupq_n_u32(
+      static_cast<uint32_t>(MemorySnapshotSanitized::kSmallWordMax));
+  const uint32x4_t low_v = vdupq_n_u32(low);
+  const uint32x4_t span_v = vdupq_n_u32(span);
+  const uint32x4_t defaced =
+      vdupq_n_u32(static_cast<uint32_t>(MemorySnapshotSanitized::kDefaced));
+  static constexpr uint32_t kLaneBits[] = {1, 2, 4, 8};
+  const uint32x4_t lane_bits = vld1q_u32(kLaneBits);
+  uint64_t candidates = 0;
+  size_t index = 0;
+  for (; index + 4 <= count; index += 4) {
+    const uint32x4_t value = vld1q_u32(words + index);
+    const uint32x4_t large = vcgtq_u32(value, small_max);
+    const uint32x4_t outside = vcgtq_u32(vsubq_u32(value, low_v), span_v);
+    vst1q_u32(words + index,
+              vbslq_u32(vandq_u32(large, outside), defaced, value));
+    candidates |= static_cast<uint64_t>(vaddvq_u32(
+                      vandq_u32(vbicq_u32(large, outside), lane_bits)))
+                  << index;
+  }
+  if (index < count) {
+    candidates |=
+        DefaceOutsideSpanScalar(words + index, count - index, low, span)
+        << index;
+  }
+  return candidates;
+}
+
+uint64_t DefaceOutsideSpan(uint64_t* words,
+                           size_t count,
+                           uint64_t low,
+                           uint64_t span) {
+  const uint64x2_t small_max =
+      vdupq_n_u64(MemorySnapshotSanitized::kSmallWordMax);
+  const uint64x2_t low_v = vdupq_n_u64(low);
+  const uint64x2_t span_v = vdupq_n_u64(span);
+  const uint64x2_t defaced = vdupq_n_u64(MemorySnapshotSanitized::kDefaced);
+  static constexpr uint64_t kLaneBits[] = {1, 2};
+  const uint64x2_t lane_bits = vld1q_u64(kLaneBits);
+  uint64_t candidates = 0;
+  size_t index = 0;
+  for (; index + 2 <= count; index += 2) {
+    const uint64x2_t value = vld1q_u64(words + index);
+    const uint64x2_t large = vcgtq_u64(value, small_max);
+    const uint64x2_t outside = vcgtq_u64(vsubq_u64(value, low_v), span_v);
+    vst1q_u64(words + index,
+              vbslq_u64(vandq_u64(large, outside), defaced, value));
+    candidates |=
+        vaddvq_u64(vandq_u64(vbicq_u64(large, outside), lane_bits)) << index;
+  }
+  if (index < count) {
+    candidates |=
+        DefaceOutsideSpanScalar(words + index, count - index, low, span)
+        << index;
+  }
+  return candidates;
+}
+
+#else
+
+template <typename Pointer>
+uint64_t DefaceOutsideSpan(Pointer* words,
+                           size_t count,
+                           Pointer low,
+                           Pointer span) {
+  return DefaceOutsideSpanScalar(words, count, low, span);
+}
+
+#endif
+
+// Redacts the words in words[0, count), with count at most
+// RangeSet::kMaxContainsMany, at indices set in candidates that don’t point into
+// one of ranges. The candidates are looked up together.
+template <typename Pointer>
+void SanitizeCandidates(const RangeSet* ranges,
+                        Pointer* words,
+                        size_t count,
+                        uint64_t candidates) {
+  if (!candidates) {
+    return;
+  }
+
+  Pointer values[RangeSet::kMaxContainsMany];
+  size_t value_count = 0;
+  for (size_t index = 0; index < count; ++index) {
+    if (candidates & (uint64_t{1} << index)) {
+      values[value_count++] = words[index];
+    }
+  }
+
+  const uint64_t contained = ranges->ContainsMany(values, value_count);
+  size_t value_index = 0;
+  for (size_t index = 0; index < count; ++index) {
+    if ((candidates & (uint64_t{1} << index)) &&
+        !(contained & (uint64_t{1} << value_index++))) {
+      words[index] = static_cast<Pointer>(MemorySnapshotSanitized::kDefaced);
+    }
+  }
+}
+
+// Redacts the words in words[0, count) that are neither small nor point into
+// one of ranges.
+template <typename Pointer>
+void SanitizeWords(const RangeSet* ranges, Pointer* words, size_t count) {
+  Pointer low, span;
+  CandidateSpan(ranges, &low, &span);
+  for (size_t index = 0; index < count;
+       index += RangeSet::kMaxContainsMany) {
+    const size_t batch_count =
+        std::min(count - index, RangeSet::kMaxContainsMany);
+    const uint64_t candidates =
+        DefaceOutsideSpan(words + index, batch_count, low, span);
+    SanitizeCandidates(ranges, words + index, batch_count, candidates);
+  }
+}
+
+// Redacts the data read from address in a snapshot. Bytes that do not form a
+// whole pointer-aligned word within data are always redacted.
+template <typename Pointer>
+void Sanitize(const RangeSet* ranges,
+              VMAddress address,
+              void* data,
+              size_t size) {
+  const Pointer defaced =
+      static_cast<Pointer>(MemorySnapshotSanitized::kDefaced);
+
+  // Sanitize up to a word-aligned address.
+  const size_t aligned_offset = std::min(
+      size,
+      static_cast<size_t>(
+          ((address + sizeof(Pointer) - 1) & ~(sizeof(Pointer) - 1)) -
+          address));
+  memcpy(data, &defaced, aligned_offset);
+
+  // Sanitize words that aren't small and don't look like pointers.
+  size_t word_count = (size - aligned_offset) / sizeof(Pointer);
+  auto words =
+      reinterpret_cast<Pointer*>(static_cast<char*>(data) + aligned_offset);
+  SanitizeWords(ranges, words, word_count);
+
+  // Sanitize trailing bytes beyond the word-sized items.
+  const size_t sanitized_bytes = aligned_offset + word_count * sizeof(Pointer);
+  memcpy(static_cast<char*>(data) + sanitized_bytes,
+         &defaced,
+         size - sanitized_bytes);
+}
+
+template <typename Pointer>
+bool ReadAndSanitizeRange(const MemorySnapshot* snapshot,
+                          const RangeSet* ranges,
+                          size_t offset,
+                          size_t size,
+                          void* buffer) {
+  // Words that straddle either end of the range must be inspected whole, so
+  // widen the range to word boundaries, or to the ends of the snapshot where
+  // those aren’t word-aligned. This produces the same result as sanitizing the
+  // entire snapshot at once.
+  const VMAddress snapshot_begin = snapshot->Address();
+  const VMAddress snapshot_end = snapshot_begin + snapshot->Size();
+  const VMAddress begin = snapshot_begin + offset;
+  const VMAddress end = begin + size;
+
+  VMAddress word_begin = begin & ~VMAddress{sizeof(Pointer) - 1};
+  if (word_begin < snapshot_begin) {
+    word_begin = snapshot_begin;
+  }
+  VMAddress word_end =
+      (end + sizeof(Pointer) - 1) & ~VMAddress{sizeof(Pointer) - 1};
+  if (word_end > snapshot_end) {
+    word_end = snapshot_end;
+  }
+
+  if (word_begin == begin && word_end == end) {
+    if (!snapshot->ReadRange(offset, size, buffer)) {
+      return false;
+    }
+    Sanitize<Pointer>(ranges, begin, buffer, size);
+    return true;
+  }
+
+  const size_t word_size = static_cast<size_t>(word_end - word_begin);
+  std::unique_ptr<uint8_t[]> words(new uint8_t[word_size]);
+  if (!snapshot->ReadRange(static_cast<size_t>(word_begin - snapshot_begin),
+                           word_size,
+                           words.get())) {
+    return false;
+  }
+  Sanitize<Pointer>(ranges, word_begin, words.get(), word_size);
+  memcpy(buffer, words.get() + (begin - word_begin), size);
+  return true;
+}
+
 class MemorySanitizer : public MemorySnapshot::Delegate {
  public:
   MemorySanitizer(MemorySnapshot::Delegate* delegate,
@@ -39,43 +395,14 @@ class MemorySanitizer : public MemorySnapshot::Delegate {
 
   bool MemorySnapshotDelegateRead(void* data, size_t size) override {
     if (is_64_bit_) {
-      Sanitize<uint64_t>(data, size);
+      Sanitize<uint64_t>(ranges_, address_, data, size);
     } else {
-      Sanitize<uint32_t>(data, size);
+      Sanitize<uint32_t>(ranges_, address_, data, size);
     }
     return delegate_->MemorySnapshotDelegateRead(data, size);
   }
 
  private:
-  template <typename Pointer>
-  void Sanitize(void* data, size_t size) {
-    const Pointer defaced =
-        static_cast<Pointer>(MemorySnapshotSanitized::kDefaced);
-
-    // Sanitize up to a word-aligned address.
-    const size_t aligned_offset =
-        ((address_ + sizeof(Pointer) - 1) & ~(sizeof(Pointer) - 1)) - address_;
-    memcpy(data, &defaced, aligned_offset);
-
-    // Sanitize words that aren't small and don't look like pointers.
-    size_t word_count = (size - aligned_offset) / sizeof(Pointer);
-    auto words =
-        reinterpret_cast<Pointer*>(static_cast<char*>(data) + aligned_offset);
-    for (size_t index = 0; index < word_count; ++index) {
-      if (words[index] > MemorySnapshotSanitized::kSmallWordMax &&
-          !ranges_->Contains(words[index])) {
-        words[index] = defaced;
-      }
-    }
-
-    // Sanitize trailing bytes beyond the word-sized items.
-    const size_t sanitized_bytes =
-        aligned_offset + word_count * sizeof(Pointer);
-    memcpy(static_cast<char*>(data) + sanitized_bytes,
-           &defaced,
-           size - sanitized_bytes);
-  }
-
   MemorySnapshot::Delegate* delegate_;
   RangeSet* ranges_;
   VMAddress address_;
@@ -104,5 +431,18 @@ bool MemorySnapshotSanitized::Read(Delegate* delegate) const {
   return snapshot_->Read(&sanitizer);
 }
 
+bool MemorySnapshotSanitized::SupportsReadRange() const {
+  return snapshot_->SupportsReadRange();
+}
+
+bool MemorySnapshotSanitized::ReadRange(size_t offset,
+                                        size_t size,
+                                        void* buffer) const {
+  return is_64_bit_ ? ReadAndSanitizeRange<uint64_t>(
+                          snapshot_, ranges_, offset, size, buffer)
+                    : ReadAndSanitizeRange<uint32_t>(
+                          snapshot_, ranges_, offset, size, buffer);
+}
+
 }  // namespace internal
 }  // namespace crashpad
@@ -57,6 +57,8 @@ class MemorySnapshotSanitized final : public MemorySnapshot {
   uint64_t Address() const override;
   size_t Size() const override;
   bool Read(Delegate* delegate) const override;
+  bool SupportsReadRange() const override;
+  bool ReadRange(size_t offset, size_t size, void* buffer) const override;
 
   const MemorySnapshot* MergeWithOtherSnapshot(
       const MemorySnapshot* other) const override {
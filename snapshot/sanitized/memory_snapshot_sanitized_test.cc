@@ -0,0 +1,211 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "snapshot/sanitized/memory_snapshot_sanitized.h"
+
+#include <string.h>
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+// A MemorySnapshot of the contents of a buffer.
+class BufferMemorySnapshot final : public MemorySnapshot {
+ public:
+  BufferMemorySnapshot(uint64_t address, const void* data, size_t size)
+      : data_(static_cast<const uint8_t*>(data),
+              static_cast<const uint8_t*>(data) + size),
+        address_(address) {}
+
+  BufferMemorySnapshot(const BufferMemorySnapshot&) = delete;
+  BufferMemorySnapshot& operator=(const BufferMemorySnapshot&) = delete;
+
+  ~BufferMemorySnapshot() override = default;
+
+  // MemorySnapshot:
+
+  uint64_t Address() const override { return address_; }
+  size_t Size() const override { return data_.size(); }
+
+  bool Read(Delegate* delegate) const override {
+    std::vector<uint8_t> copy(data_);
+    return delegate->MemorySnapshotDelegateRead(copy.data(), copy.size());
+  }
+
+  bool SupportsReadRange() const override { return true; }
+
+  bool ReadRange(size_t offset, size_t size, void* buffer) const override {
+    if (offset > data_.size() || size > data_.size() - offset) {
+      return false;
+    }
+    memcpy(buffer, data_.data() + offset, size);
+    return true;
+  }
+
+  const MemorySnapshot* MergeWithOtherSnapshot(
+      const MemorySnapshot* other) const override {
+    return nullptr;
+  }
+
+ private:
+  std::vector<uint8_t> data_;
+  uint64_t address_;
+};
+
+class ReadToVector : public MemorySnapshot::Delegate {
+ public:
+  explicit ReadToVector(std::vector<uint8_t>* data) : data_(data) {}
+
+  bool MemorySnapshotDelegateRead(void* data, size_t size) override {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    data_->assign(bytes, bytes + size);
+    return true;
+  }
+
+ private:
+  std::vector<uint8_t>* data_;
+};
+
+// Words are examined several at a time, so the tests use word counts that
+// leave some over, and values on either side of each boundary that matters.
+template <typename Pointer>
+void TestSanitizeWords(RangeSet* ranges,
+                       const std::vector<Pointer>& words,
+                       const std::vector<bool>& kept) {
+  ASSERT_EQ(words.size(), kept.size());
+  constexpr uint64_t kAddress = 0x10000;
+  constexpr bool kIs64Bit = sizeof(Pointer) == 8;
+
+  for (size_t count = 0; count <= words.size(); ++count) {
+    SCOPED_TRACE(count);
+    BufferMemorySnapshot snapshot(
+        kAddress, words.data(), count * sizeof(Pointer));
+    internal::MemorySnapshotSanitized sanitized(&snapshot, ranges, kIs64Bit);
+
+    std::vector<uint8_t> data;
+    ReadToVector delegate(&data);
+    ASSERT_TRUE(sanitized.Read(&delegate));
+    ASSERT_EQ(data.size(), count * sizeof(Pointer));
+
+    std::vector<uint8_t> range_data(data.size());
+    ASSERT_TRUE(sanitized.ReadRange(0, range_data.size(), range_data.data()));
+    EXPECT_EQ(range_data, data);
+
+    for (size_t index = 0; index < count; ++index) {
+      SCOPED_TRACE(index);
+      Pointer word;
+      memcpy(&word, &data[index * sizeof(Pointer)], sizeof(word));
+      EXPECT_EQ(word,
+                kept[index] ? words[index]
+                            : static_cast<Pointer>(
+                                  internal::MemorySnapshotSanitized::kDefaced));
+    }
+  }
+}
+
+TEST(MemorySnapshotSanitized, Words64) {
+  RangeSet ranges;
+  ranges.Insert(0x7f0000001000, 0x1000);
+  ranges.Insert(0x7f0000010000, 0x100);
+
+  constexpr uint64_t kSmallWordMax =
+      internal::MemorySnapshotSanitized::kSmallWordMax;
+  const std::vector<uint64_t> words = {
+      0,
+      kSmallWordMax,
+      kSmallWordMax + 1,
+      0x7f0000000fff,
+      0x7f0000001000,
+      0x7f0000001fff,
+      0x7f0000002000,
+      0x7f0000008000,
+      0x7f0000010080,
+      0x7f0000010100,
+      0xffffffff00001000,
+      0x00000001ffffffff,
+      0x800000000000,
+  };
+  const std::vector<bool> kept = {
+      true,
+      true,
+      false,
+      false,
+      true,
+      true,
+      false,
+      false,
+      true,
+      false,
+      false,
+      false,
+      false,
+  };
+  TestSanitizeWords(&ranges, words, kept);
+}
+
+TEST(MemorySnapshotSanitized, Words32) {
+  RangeSet ranges;
+  ranges.Insert(0x10000, 0x1000);
+  ranges.Insert(0xfffff000, 0x1000);
+  ranges.Insert(0x100000000, 0x1000);
+
+  constexpr uint32_t kSmallWordMax =
+      internal::MemorySnapshotSanitized::kSmallWordMax;
+  const std::vector<uint32_t> words = {
+      0,
+      kSmallWordMax,
+      kSmallWordMax + 1,
+      0xffff,
+      0x10000,
+      0x10fff,
+      0x11000,
+      0x80000000,
+      0xffffefff,
+      0xfffff000,
+      0xffffffff,
+  };
+  const std::vector<bool> kept = {
+      true,
+      true,
+      false,
+      false,
+      true,
+      true,
+      false,
+      false,
+      false,
+      true,
+      true,
+  };
+  TestSanitizeWords(&ranges, words, kept);
+}
+
+TEST(MemorySnapshotSanitized, NoRanges) {
+  RangeSet ranges;
+
+  constexpr uint64_t kSmallWordMax =
+      internal::MemorySnapshotSanitized::kSmallWordMax;
+  const std::vector<uint64_t> words = {
+      0, kSmallWordMax, kSmallWordMax + 1, kSmallWordMax + 2, 0x7f0000001000};
+  const std::vector<bool> kept = {true, true, false, false, false};
+  TestSanitizeWords(&ranges, words, kept);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
@@ -14,27 +14,20 @@
 
 #include "snapshot/sanitized/module_snapshot_sanitized.h"
 
+#include <utility>
+
 namespace crashpad {
 namespace internal {
 
-namespace {
-
-bool KeyIsAllowed(const std::string& name,
-                  const std::vector<std::string>& allowed_keys) {
-  for (const auto& key : allowed_keys) {
-    if (name == key) {
-      return true;
-    }
-  }
-  return false;
-}
-
-}  // namespace
-
 ModuleSnapshotSanitized::ModuleSnapshotSanitized(
     const ModuleSnapshot* snapshot,
-    const std::vector<std::string>* allowed_annotations)
-    : snapshot_(snapshot), allowed_annotations_(allowed_annotations) {}
+    const std::unordered_set<std::string>* allowed_annotations)
+    : snapshot_(snapshot),
+      allowed_annotations_(allowed_annotations),
+      annotations_simple_map_(),
+      annotation_objects_(),
+      initialized_annotations_simple_map_(),
+      initialized_annotation_objects_() {}
 
 ModuleSnapshotSanitized::~ModuleSnapshotSanitized() = default;
 
@@ -94,31 +87,36 @@ std::vector<std::string> ModuleSnapshotSanitized::AnnotationsVector() const {
 
 std::map<std::string, std::string>
 ModuleSnapshotSanitized::AnnotationsSimpleMap() const {
-  std::map<std::string, std::string> annotations =
-      snapshot_->AnnotationsSimpleMap();
-  if (allowed_annotations_) {
-    for (auto kv = annotations.begin(); kv != annotations.end(); ++kv) {
-      if (!KeyIsAllowed(kv->first, *allowed_annotations_)) {
-        annotations.erase(kv);
+  if (!allowed_annotations_) {
+    return snapshot_->AnnotationsSimpleMap();
+  }
+
+  if (initialized_annotations_simple_map_.is_uninitialized()) {
+    for (auto& kv : snapshot_->AnnotationsSimpleMap()) {
+      if (allowed_annotations_->count(kv.first)) {
+        annotations_simple_map_.insert(std::move(kv));
       }
     }
+    initialized_annotations_simple_map_.set_valid();
   }
-  return annotations;
+  return annotations_simple_map_;
 }
 
 std::vector<AnnotationSnapshot> ModuleSnapshotSanitized::AnnotationObjects()
     const {
-  std::vector<AnnotationSnapshot> annotations = snapshot_->AnnotationObjects();
-  if (allowed_annotations_) {
-    std::vector<AnnotationSnapshot> allowed;
-    for (const auto& anno : annotations) {
-      if (KeyIsAllowed(anno.name, *allowed_annotations_)) {
-        allowed.push_back(anno);
+  if (!allowed_annotations_) {
+    return snapshot_->AnnotationObjects();
+  }
+
+  if (initialized_annotation_objects_.is_uninitialized()) {
+    for (auto& anno : snapshot_->AnnotationObjects()) {
+      if (allowed_annotations_->count(anno.name)) {
+        annotation_objects_.push_back(std::move(anno));
       }
     }
-    annotations.swap(allowed);
+    initialized_annotation_objects_.set_valid();
   }
-  return annotations;
+  return annotation_objects_;
 }
 
 std::set<CheckedRange<uint64_t>> ModuleSnapshotSanitized::ExtraMemoryRanges()
@@ -15,10 +15,13 @@
 #ifndef CRASHPAD_SNAPSHOT_SANITIZED_MODULE_SNAPSHOT_SANITIZED_H_
 #define CRASHPAD_SNAPSHOT_SANITIZED_MODULE_SNAPSHOT_SANITIZED_H_
 
+#include <map>
 #include <string>
+#include <unordered_set>
 #include <vector>
 
 #include "snapshot/module_snapshot.h"
+#include "util/misc/initialization_state.h"
 
 namespace crashpad {
 namespace internal {
@@ -30,11 +33,12 @@ class ModuleSnapshotSanitized final : public ModuleSnapshot {
   //! \brief Constructs this object.
   //!
   //! \param[in] snapshot The ModuleSnapshot to sanitize.
-  //! \param[in] allowed_annotations A list of annotation names to allow to be
+  //! \param[in] allowed_annotations A set of annotation names to allow to be
   //!     returned by AnnotationsSimpleMap() or AnnotationObjects(). If
   //!     `nullptr`, all annotations will be returned.
-  ModuleSnapshotSanitized(const ModuleSnapshot* snapshot,
-                          const std::vector<std::string>* allowed_annotations);
+  ModuleSnapshotSanitized(
+      const ModuleSnapshot* snapshot,
+      const std::unordered_set<std::string>* allowed_annotations);
 
   ModuleSnapshotSanitized(const ModuleSnapshotSanitized&) = delete;
   ModuleSnapshotSanitized& operator=(const ModuleSnapshotSanitized&) = delete;
@@ -67,7 +71,14 @@ class ModuleSnapshotSanitized final : public ModuleSnapshot {
 
  private:
   const ModuleSnapshot* snapshot_;
-  const std::vector<std::string>* allowed_annotations_;
+  const std::unordered_set<std::string>* allowed_annotations_;
+
+  // The annotations are filtered the first time they’re asked for, and kept
+  // for later calls.
+  mutable std::map<std::string, std::string> annotations_simple_map_;
+  mutable std::vector<AnnotationSnapshot> annotation_objects_;
+  mutable InitializationState initialized_annotations_simple_map_;
+  mutable InitializationState initialized_annotation_objects_;
 };
 
 }  // namespace internal
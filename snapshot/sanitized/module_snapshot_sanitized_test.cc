@@ -0,0 +1,82 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "snapshot/sanitized/module_snapshot_sanitized.h"
+
+#include "gtest/gtest.h"
+#include "snapshot/test/test_module_snapshot.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+TEST(ModuleSnapshotSanitized, FiltersAnnotations) {
+  TestModuleSnapshot module;
+  module.SetAnnotationsSimpleMap({{"allowed", "1"},
+                                  {"allowed_prefix", "2"},
+                                  {"denied", "3"},
+                                  {"also_allowed", "4"}});
+  const std::vector<uint8_t> value = {'v'};
+  module.SetAnnotationObjects({AnnotationSnapshot("allowed", 1, value),
+                               AnnotationSnapshot("denied", 1, value),
+                               AnnotationSnapshot("allowed", 2, value),
+                               AnnotationSnapshot("also_allowed", 1, value)});
+
+  const std::unordered_set<std::string> allowed = {"allowed", "also_allowed"};
+  internal::ModuleSnapshotSanitized sanitized(&module, &allowed);
+
+  const std::map<std::string, std::string> expected_map = {
+      {"allowed", "1"}, {"also_allowed", "4"}};
+  const std::vector<AnnotationSnapshot> expected_objects = {
+      AnnotationSnapshot("allowed", 1, value),
+      AnnotationSnapshot("allowed", 2, value),
+      AnnotationSnapshot("also_allowed", 1, value)};
+
+  // The results are the same when asked for again.
+  for (int pass = 0; pass < 2; ++pass) {
+    SCOPED_TRACE(pass);
+    EXPECT_EQ(sanitized.AnnotationsSimpleMap(), expected_map);
+    EXPECT_EQ(sanitized.AnnotationObjects(), expected_objects);
+  }
+}
+
+TEST(ModuleSnapshotSanitized, AllowsAllAnnotations) {
+  TestModuleSnapshot module;
+  const std::map<std::string, std::string> simple_map = {{"a", "1"},
+                                                         {"b", "2"}};
+  module.SetAnnotationsSimpleMap(simple_map);
+  const std::vector<AnnotationSnapshot> objects = {
+      AnnotationSnapshot("a", 1, std::vector<uint8_t>())};
+  module.SetAnnotationObjects(objects);
+
+  internal::ModuleSnapshotSanitized sanitized(&module, nullptr);
+  EXPECT_EQ(sanitized.AnnotationsSimpleMap(), simple_map);
+  EXPECT_EQ(sanitized.AnnotationObjects(), objects);
+}
+
+TEST(ModuleSnapshotSanitized, NoAllowedAnnotations) {
+  TestModuleSnapshot module;
+  module.SetAnnotationsSimpleMap({{"a", "1"}});
+  module.SetAnnotationObjects(
+      {AnnotationSnapshot("a", 1, std::vector<uint8_t>())});
+
+  const std::unordered_set<std::string> allowed;
+  internal::ModuleSnapshotSanitized sanitized(&module, &allowed);
+  EXPECT_TRUE(sanitized.AnnotationsSimpleMap().empty());
+  EXPECT_TRUE(sanitized.AnnotationObjects().empty());
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
@@ -91,7 +91,12 @@ bool ProcessSnapshotSanitized::Initialize(
     bool sanitize_stacks) {
   INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
   snapshot_ = snapshot;
-  allowed_annotations_ = std::move(allowed_annotations);
+  if (allowed_annotations) {
+    // Modules look up each of their annotations in this set, so it’s built
+    // once here rather than searching the list for every annotation.
+    allowed_annotations_ = std::make_unique<std::unordered_set<std::string>>(
+        allowed_annotations->begin(), allowed_annotations->end());
+  }
   sanitize_stacks_ = sanitize_stacks;
 
   if (target_module_address) {
@@ -157,6 +162,7 @@ bool ProcessSnapshotSanitized::Initialize(
       threads_.emplace_back(std::make_unique<internal::ThreadSnapshotSanitized>(
           thread, &address_ranges_));
     }
+    address_ranges_.Freeze();
   }
 
   process_memory_.Initialize(snapshot_->Memory(), allowed_memory_ranges.get());
@@ -17,6 +17,7 @@
 
 #include <memory>
 #include <string>
+#include <unordered_set>
 #include <vector>
 
 #include "snapshot/exception_snapshot.h"
@@ -105,7 +106,7 @@ class ProcessSnapshotSanitized final : public ProcessSnapshot {
   RangeSet address_ranges_;
   const ProcessSnapshot* snapshot_;
   ProcessMemorySanitized process_memory_;
-  std::unique_ptr<const std::vector<std::string>> allowed_annotations_;
+  std::unique_ptr<const std::unordered_set<std::string>> allowed_annotations_;
   bool sanitize_stacks_;
   InitializationStateDcheck initialized_;
 };
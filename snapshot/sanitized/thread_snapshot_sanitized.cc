@@ -23,7 +23,15 @@ ThreadSnapshotSanitized::ThreadSnapshotSanitized(const ThreadSnapshot* snapshot,
                                                  RangeSet* ranges)
     : ThreadSnapshot(),
       snapshot_(snapshot),
-      stack_(snapshot_->Stack(), ranges, snapshot_->Context()->Is64Bit()) {}
+      stack_(snapshot_->Stack(), ranges, snapshot_->Context()->Is64Bit()),
+      extra_memory_() {
+  // Extra memory may hold frame records from beyond a stack capture limit, so
+  // it’s sanitized the same way as the stack.
+  for (const MemorySnapshot* memory : snapshot_->ExtraMemory()) {
+    extra_memory_.push_back(std::make_unique<MemorySnapshotSanitized>(
+        memory, ranges, snapshot_->Context()->Is64Bit()));
+  }
+}
 
 ThreadSnapshotSanitized::~ThreadSnapshotSanitized() = default;
 
@@ -57,10 +65,20 @@ uint64_t ThreadSnapshotSanitized::ThreadSpecificDataAddress() const {
 
 std::vector<const MemorySnapshot*> ThreadSnapshotSanitized::ExtraMemory()
     const {
-  // TODO(jperaza): If/when ExtraMemory() is used, decide whether and how it
-  // should be sanitized.
-  DCHECK(snapshot_->ExtraMemory().empty());
-  return std::vector<const MemorySnapshot*>();
+  std::vector<const MemorySnapshot*> extra_memory;
+  extra_memory.reserve(extra_memory_.size());
+  for (const auto& memory : extra_memory_) {
+    extra_memory.push_back(memory.get());
+  }
+  return extra_memory;
+}
+
+uint64_t ThreadSnapshotSanitized::UncapturedStackSize() const {
+  return snapshot_->UncapturedStackSize();
+}
+
+std::vector<uint64_t> ThreadSnapshotSanitized::UnwoundFrames() const {
+  return snapshot_->UnwoundFrames();
 }
 
 }  // namespace internal
@@ -17,7 +17,9 @@
 
 #include "snapshot/thread_snapshot.h"
 
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "snapshot/sanitized/memory_snapshot_sanitized.h"
 #include "util/misc/range_set.h"
@@ -51,10 +53,13 @@ class ThreadSnapshotSanitized final : public ThreadSnapshot {
   int Priority() const override;
   uint64_t ThreadSpecificDataAddress() const override;
   std::vector<const MemorySnapshot*> ExtraMemory() const override;
+  uint64_t UncapturedStackSize() const override;
+  std::vector<uint64_t> UnwoundFrames() const override;
 
  private:
   const ThreadSnapshot* snapshot_;
   MemorySnapshotSanitized stack_;
+  std::vector<std::unique_ptr<MemorySnapshotSanitized>> extra_memory_;
 };
 
 }  // namespace internal
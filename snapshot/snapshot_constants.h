@@ -23,6 +23,12 @@ namespace crashpad {
 //! \note This maximum was chosen arbitrarily and may change in the future.
 constexpr size_t kMaxNumberOfAnnotations = 200;
 
+//! \brief The maximum number of per-thread crashpad::AnnotationList objects
+//!     that will be read from a client process.
+//!
+//! \note This maximum was chosen arbitrarily and may change in the future.
+constexpr size_t kMaxNumberOfThreadAnnotationLists = 1024;
+
 }  // namespace crashpad
 
 #endif  // SNAPSHOT_SNAPSHOT_CONSTANTS_H_
@@ -14,15 +14,22 @@
 
 #include "snapshot/test/test_memory_snapshot.h"
 
+#include <string.h>
+
 #include <memory>
 #include <string>
 
+#include "base/check_op.h"
+
 namespace crashpad {
 namespace test {
 
 TestMemorySnapshot::TestMemorySnapshot()
-    : address_(0), size_(0), value_('\0'), should_fail_(false) {
-}
+    : address_(0),
+      size_(0),
+      value_('\0'),
+      should_fail_(false),
+      supports_read_range_(false) {}
 
 TestMemorySnapshot::~TestMemorySnapshot() {
 }
@@ -48,6 +55,24 @@ bool TestMemorySnapshot::Read(Delegate* delegate) const {
   return delegate->MemorySnapshotDelegateRead(&buffer[0], size_);
 }
 
+bool TestMemorySnapshot::SupportsReadRange() const {
+  return supports_read_range_;
+}
+
+bool TestMemorySnapshot::ReadRange(size_t offset,
+                                   size_t size,
+                                   void* buffer) const {
+  DCHECK(supports_read_range_);
+  DCHECK_LE(offset, size_);
+  DCHECK_LE(size, size_ - offset);
+  if (should_fail_) {
+    return false;
+  }
+
+  memset(buffer, value_, size);
+  return true;
+}
+
 const MemorySnapshot* TestMemorySnapshot::MergeWithOtherSnapshot(
     const MemorySnapshot* other) const {
   CheckedRange<uint64_t, size_t> merged(0, 0);
@@ -58,6 +83,7 @@ const MemorySnapshot* TestMemorySnapshot::MergeWithOtherSnapshot(
   result->SetAddress(merged.base());
   result->SetSize(merged.size());
   result->SetValue(value_);
+  result->SetSupportsReadRange(supports_read_range_);
   return result.release();
 }
 
@@ -45,11 +45,18 @@ class TestMemorySnapshot final : public MemorySnapshot {
 
   void SetShouldFailRead(bool should_fail) { should_fail_ = true; }
 
+  //! \brief Sets whether this snapshot supports ReadRange().
+  void SetSupportsReadRange(bool supports_read_range) {
+    supports_read_range_ = supports_read_range;
+  }
+
   // MemorySnapshot:
 
   uint64_t Address() const override;
   size_t Size() const override;
   bool Read(Delegate* delegate) const override;
+  bool SupportsReadRange() const override;
+  bool ReadRange(size_t offset, size_t size, void* buffer) const override;
   const MemorySnapshot* MergeWithOtherSnapshot(
       const MemorySnapshot* other) const override;
 
@@ -58,6 +65,7 @@ class TestMemorySnapshot final : public MemorySnapshot {
   size_t size_;
   char value_;
   bool should_fail_;
+  bool supports_read_range_;
 };
 
 }  // namespace test
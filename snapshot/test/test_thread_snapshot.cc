@@ -24,7 +24,8 @@ TestThreadSnapshot::TestThreadSnapshot()
       thread_id_(0),
       suspend_count_(0),
       priority_(0),
-      thread_specific_data_address_(0) {
+      thread_specific_data_address_(0),
+      uncaptured_stack_size_(0) {
   context_.x86 = &context_union_.x86;
 }
 
@@ -67,5 +68,13 @@ std::vector<const MemorySnapshot*> TestThreadSnapshot::ExtraMemory() const {
   return extra_memory;
 }
 
+uint64_t TestThreadSnapshot::UncapturedStackSize() const {
+  return uncaptured_stack_size_;
+}
+
+std::vector<uint64_t> TestThreadSnapshot::UnwoundFrames() const {
+  return unwound_frames_;
+}
+
 }  // namespace test
 }  // namespace crashpad
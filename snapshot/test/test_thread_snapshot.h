@@ -72,6 +72,12 @@ class TestThreadSnapshot final : public ThreadSnapshot {
   void SetThreadSpecificDataAddress(uint64_t thread_specific_data_address) {
     thread_specific_data_address_ = thread_specific_data_address;
   }
+  void SetUncapturedStackSize(uint64_t uncaptured_stack_size) {
+    uncaptured_stack_size_ = uncaptured_stack_size;
+  }
+  void SetUnwoundFrames(const std::vector<uint64_t>& unwound_frames) {
+    unwound_frames_ = unwound_frames;
+  }
 
   //! \brief Add a memory snapshot to be returned by ExtraMemory().
   //!
@@ -92,6 +98,8 @@ class TestThreadSnapshot final : public ThreadSnapshot {
   int Priority() const override;
   uint64_t ThreadSpecificDataAddress() const override;
   std::vector<const MemorySnapshot*> ExtraMemory() const override;
+  uint64_t UncapturedStackSize() const override;
+  std::vector<uint64_t> UnwoundFrames() const override;
 
  private:
   union {
@@ -105,7 +113,9 @@ class TestThreadSnapshot final : public ThreadSnapshot {
   int suspend_count_;
   int priority_;
   uint64_t thread_specific_data_address_;
+  uint64_t uncaptured_stack_size_;
   std::vector<std::unique_ptr<MemorySnapshot>> extra_memory_;
+  std::vector<uint64_t> unwound_frames_;
 };
 
 }  // namespace test
@@ -77,6 +77,21 @@ class ThreadSnapshot {
   //!     are scoped to the lifetime of the ThreadSnapshot object that they
   //!     were obtained from.
   virtual std::vector<const MemorySnapshot*> ExtraMemory() const = 0;
+
+  //! \brief Returns the number of bytes of the thread’s stack region beyond the
+  //!     end of Stack() that were not captured.
+  //!
+  //! This is nonzero only when the stack was larger than a limit set by
+  //! CrashpadInfo::set_stack_capture_limit(). Any memory captured from the
+  //! uncaptured part of the stack appears in ExtraMemory().
+  virtual uint64_t UncapturedStackSize() const = 0;
+
+  //! \brief Returns the instruction pointers of the thread’s frames found by
+  //!     unwinding its stack when the snapshot was taken, innermost first.
+  //!
+  //! Each frame’s instruction pointer other than the innermost one’s is
+  //! normally a return address. This is empty if the stack was not unwound.
+  virtual std::vector<uint64_t> UnwoundFrames() const = 0;
 };
 
 }  // namespace crashpad
@@ -33,6 +33,7 @@ ModuleSnapshotWin::ModuleSnapshotWin()
       name_(),
       pdb_name_(),
       uuid_(),
+      initialized_debug_directory_(),
       memory_range_(),
       streams_(),
       vs_fixed_file_info_(),
@@ -62,19 +63,9 @@ bool ModuleSnapshotWin::Initialize(
     return false;
   }
 
-  DWORD age_dword;
-  if (pe_image_reader_->DebugDirectoryInformation(
-          &uuid_, &age_dword, &pdb_name_)) {
-    static_assert(sizeof(DWORD) == sizeof(uint32_t), "unexpected age size");
-    age_ = age_dword;
-  } else {
-    // If we fully supported all old debugging formats, we would want to extract
-    // and emit a different type of CodeView record here (as old Microsoft tools
-    // would do). As we don't expect to ever encounter a module that wouldn't be
-    // using .PDB that we actually have symbols for, we simply set a plausible
-    // name here, but this will never correspond to symbols that we have.
-    pdb_name_ = base::WideToUTF8(name_);
-  }
+  // The CodeView record, like the version resource, is only read when first
+  // needed, as most of the time spent on a module would otherwise be spent on
+  // information that not every consumer uses.
 
   if (!memory_range_.Initialize(process_reader_->Memory(),
                                 process_reader_->Is64Bit())) {
@@ -185,12 +176,14 @@ ModuleSnapshot::ModuleType ModuleSnapshotWin::GetModuleType() const {
 
 void ModuleSnapshotWin::UUIDAndAge(crashpad::UUID* uuid, uint32_t* age) const {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  InitializeDebugDirectoryInformation();
   *uuid = uuid_;
   *age = age_;
 }
 
 std::string ModuleSnapshotWin::DebugFileName() const {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  InitializeDebugDirectoryInformation();
   return pdb_name_;
 }
 
@@ -286,14 +279,45 @@ const VS_FIXEDFILEINFO* ModuleSnapshotWin::VSFixedFileInfo() const {
                                                     : nullptr;
 }
 
+void ModuleSnapshotWin::InitializeDebugDirectoryInformation() const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+
+  if (!initialized_debug_directory_.is_uninitialized()) {
+    return;
+  }
+  initialized_debug_directory_.set_valid();
+
+  DWORD age_dword;
+  if (pe_image_reader_->DebugDirectoryInformation(
+          &uuid_, &age_dword, &pdb_name_)) {
+    static_assert(sizeof(DWORD) == sizeof(uint32_t), "unexpected age size");
+    age_ = age_dword;
+  } else {
+    // If we fully supported all old debugging formats, we would want to extract
+    // and emit a different type of CodeView record here (as old Microsoft tools
+    // would do). As we don't expect to ever encounter a module that wouldn't be
+    // using .PDB that we actually have symbols for, we simply set a plausible
+    // name here, but this will never correspond to symbols that we have.
+    pdb_name_ = base::WideToUTF8(name_);
+  }
+}
+
 template <class Traits>
 void ModuleSnapshotWin::GetCrashpadExtraMemoryRanges(
     std::set<CheckedRange<uint64_t>>* ranges) const {
   if (!crashpad_info_ || !crashpad_info_->ExtraMemoryRanges())
     return;
 
-  std::vector<SimpleAddressRangeBag::Entry> simple_ranges(
-      SimpleAddressRangeBag::num_entries);
+  // Sanity limit on the number of entries, in case the count is corrupt.
+  constexpr uint32_t kMaxExtraMemoryRanges = 64 * 1024;
+  const uint32_t count = crashpad_info_->ExtraMemoryRangesCount();
+  if (count > kMaxExtraMemoryRanges) {
+    LOG(WARNING) << "too many extra memory ranges (" << count << ") in "
+                 << base::WideToUTF8(name_);
+    return;
+  }
+
+  std::vector<SimpleAddressRangeBag::Entry> simple_ranges(count);
   if (!process_reader_->Memory()->Read(
           crashpad_info_->ExtraMemoryRanges(),
           simple_ranges.size() * sizeof(simple_ranges[0]),
@@ -111,9 +111,17 @@ class ModuleSnapshotWin final : public ModuleSnapshot {
   // on the first call.
   const VS_FIXEDFILEINFO* VSFixedFileInfo() const;
 
+  // Initializes pdb_name_, uuid_, and age_ from the module’s CodeView record
+  // if they have not yet been initialized.
+  void InitializeDebugDirectoryInformation() const;
+
   std::wstring name_;
-  std::string pdb_name_;
-  UUID uuid_;
+  // InitializeDebugDirectoryInformation() is logically const, but updates
+  // these members and age_ on the first call. See
+  // https://crashpad.chromium.org/bug/9.
+  mutable std::string pdb_name_;
+  mutable UUID uuid_;
+  mutable InitializationState initialized_debug_directory_;
   ProcessMemoryRange memory_range_;
   // Too const-y: https://crashpad.chromium.org/bug/9.
   mutable std::vector<std::unique_ptr<const UserMinidumpStream>> streams_;
@@ -125,7 +133,7 @@ class ModuleSnapshotWin final : public ModuleSnapshot {
   std::unique_ptr<PEImageReader> pe_image_reader_;
   std::unique_ptr<CrashpadInfoReader> crashpad_info_;
   time_t timestamp_;
-  uint32_t age_;
+  mutable uint32_t age_;
   InitializationStateDcheck initialized_;
 };
 
@@ -39,6 +39,7 @@ struct Annotation {
   typename Traits::Pointer value;
   uint32_t size;
   uint16_t type;
+  uint16_t flags;
 };
 
 template <class Traits>
@@ -95,7 +96,7 @@ void PEImageAnnotationsReader::ReadCrashpadSimpleAnnotations(
 
   std::vector<SimpleStringDictionary::Entry>
       simple_annotations(SimpleStringDictionary::num_entries);
-  if (!process_reader_->Memory()->Read(
+  if (!process_reader_->CachedMemory()->Read(
           crashpad_info.simple_annotations,
           simple_annotations.size() * sizeof(simple_annotations[0]),
           &simple_annotations[0])) {
@@ -130,9 +131,9 @@ void PEImageAnnotationsReader::ReadCrashpadAnnotationsList(
   }
 
   process_types::AnnotationList<Traits> annotation_list_object;
-  if (!process_reader_->Memory()->Read(crashpad_info.annotations_list,
-                                       sizeof(annotation_list_object),
-                                       &annotation_list_object)) {
+  if (!process_reader_->CachedMemory()->Read(crashpad_info.annotations_list,
+                                             sizeof(annotation_list_object),
+                                             &annotation_list_object)) {
     LOG(WARNING) << "could not read annotations list object in "
                  << base::WideToUTF8(name_);
     return;
@@ -143,14 +144,33 @@ void PEImageAnnotationsReader::ReadCrashpadAnnotationsList(
        current.link_node != annotation_list_object.tail_pointer &&
        index < kMaxNumberOfAnnotations;
        ++index) {
-    if (!process_reader_->Memory()->Read(
+    if (!process_reader_->CachedMemory()->Read(
             current.link_node, sizeof(current), &current)) {
       LOG(WARNING) << "could not read annotation at index " << index << " in "
                    << base::WideToUTF8(name_);
       return;
     }
 
-    if (current.size == 0) {
+    WinVMAddress value_address = current.value;
+    uint32_t value_size = current.size;
+    if (current.flags & Annotation::kFlagVersioned) {
+      VersionedAnnotationHeader header;
+      if (!process_reader_->CachedMemory()->Read(
+              current.value - sizeof(header), sizeof(header), &header)) {
+        LOG(WARNING) << "could not read annotation header at index " << index
+                     << " in " << base::WideToUTF8(name_);
+        continue;
+      }
+
+      uint32_t value_offset;
+      if (!header.GetValueLocation(current.size, &value_offset, &value_size)) {
+        LOG(WARNING) << "invalid annotation header at index " << index
+                     << " in " << base::WideToUTF8(name_);
+      }
+      value_address += value_offset;
+    }
+
+    if (value_size == 0) {
       continue;
     }
 
@@ -158,7 +178,8 @@ void PEImageAnnotationsReader::ReadCrashpadAnnotationsList(
     snapshot.type = current.type;
 
     char name[Annotation::kNameMaxLength];
-    if (!process_reader_->Memory()->Read(current.name, std::size(name), name)) {
+    if (!process_reader_->CachedMemory()->Read(
+            current.name, std::size(name), name)) {
       LOG(WARNING) << "could not read annotation name at index " << index
                    << " in " << base::WideToUTF8(name_);
       continue;
@@ -168,10 +189,10 @@ void PEImageAnnotationsReader::ReadCrashpadAnnotationsList(
     snapshot.name = std::string(name, name_length);
 
     size_t value_length =
-        std::min(static_cast<size_t>(current.size), Annotation::kValueMaxSize);
+        std::min(static_cast<size_t>(value_size), Annotation::kValueMaxSize);
     snapshot.value.resize(value_length);
-    if (!process_reader_->Memory()->Read(
-            current.value, value_length, snapshot.value.data())) {
+    if (!process_reader_->CachedMemory()->Read(
+            value_address, value_length, snapshot.value.data())) {
       LOG(WARNING) << "could not read annotation value at index " << index
                    << " in " << base::WideToUTF8(name_);
       continue;
@@ -17,7 +17,10 @@
 #include <string.h>
 #include <winternl.h>
 
+#include <atomic>
 #include <memory>
+#include <utility>
+#include <vector>
 
 #include "base/notreached.h"
 #include "base/numerics/safe_conversions.h"
@@ -36,6 +39,15 @@ namespace crashpad {
 
 namespace {
 
+// The access that ReadThreadData() needs to each thread.
+constexpr ACCESS_MASK kThreadAccess =
+    THREAD_GET_CONTEXT | THREAD_SUSPEND_RESUME | THREAD_QUERY_INFORMATION;
+
+// The buffer size that was last large enough to hold the system’s process
+// information, used as the starting size for the next query, so that later
+// snapshots don’t have to repeat the search for a size that fits.
+std::atomic<ULONG> g_process_information_buffer_size(16384);
+
 // Gets a pointer to the process information structure after a given one, or
 // null when iteration is complete, assuming they've been retrieved in a block
 // via NtQuerySystemInformation().
@@ -60,7 +72,7 @@ template <class Traits>
 process_types::SYSTEM_PROCESS_INFORMATION<Traits>* GetProcessInformation(
     HANDLE process_handle,
     std::unique_ptr<uint8_t[]>* buffer) {
-  ULONG buffer_size = 16384;
+  ULONG buffer_size = g_process_information_buffer_size;
   ULONG actual_size;
   buffer->reset(new uint8_t[buffer_size]);
   NTSTATUS status;
@@ -96,6 +108,7 @@ process_types::SYSTEM_PROCESS_INFORMATION<Traits>* GetProcessInformation(
   }
 
   DCHECK_LE(actual_size, buffer_size);
+  g_process_information_buffer_size = buffer_size;
 
   process_types::SYSTEM_PROCESS_INFORMATION<Traits>* process =
       reinterpret_cast<process_types::SYSTEM_PROCESS_INFORMATION<Traits>*>(
@@ -117,12 +130,10 @@ template <class Traits>
 HANDLE OpenThread(
     const process_types::SYSTEM_THREAD_INFORMATION<Traits>& thread_info) {
   HANDLE handle;
-  ACCESS_MASK query_access =
-      THREAD_GET_CONTEXT | THREAD_SUSPEND_RESUME | THREAD_QUERY_INFORMATION;
   OBJECT_ATTRIBUTES object_attributes;
   InitializeObjectAttributes(&object_attributes, nullptr, 0, nullptr, nullptr);
   NTSTATUS status = crashpad::NtOpenThread(
-      &handle, query_access, &object_attributes, &thread_info.ClientId);
+      &handle, kThreadAccess, &object_attributes, &thread_info.ClientId);
   if (!NT_SUCCESS(status)) {
     NTSTATUS_LOG(ERROR, status) << "NtOpenThread";
     return nullptr;
@@ -130,6 +141,58 @@ HANDLE OpenThread(
   return handle;
 }
 
+//! \brief Opens each thread in a process by walking the process’ own thread
+//!     list with NtGetNextThread().
+//!
+//! This avoids retrieving the information for every process and thread on the
+//! system, which GetProcessInformation() must do.
+//!
+//! \return `true` on success, with the threads appended to \a threads.
+//!     `false` if the process’ threads can’t be walked, with a message logged.
+bool OpenThreadsInProcess(HANDLE process_handle,
+                          std::vector<ScopedKernelHANDLE>* threads) {
+  HANDLE thread_handle = nullptr;
+  for (;;) {
+    HANDLE next_thread_handle;
+    NTSTATUS status = crashpad::NtGetNextThread(process_handle,
+                                                thread_handle,
+                                                kThreadAccess,
+                                                0,
+                                                0,
+                                                &next_thread_handle);
+    if (status == STATUS_NO_MORE_ENTRIES) {
+      return true;
+    }
+    if (!NT_SUCCESS(status)) {
+      NTSTATUS_LOG(ERROR, status) << "NtGetNextThread";
+      threads->clear();
+      return false;
+    }
+    threads->push_back(ScopedKernelHANDLE(next_thread_handle));
+    thread_handle = next_thread_handle;
+  }
+}
+
+//! \brief Opens each thread in a process found by GetProcessInformation().
+template <class Traits>
+void OpenThreadsFromSystemInformation(
+    HANDLE process_handle,
+    std::vector<ScopedKernelHANDLE>* threads) {
+  std::unique_ptr<uint8_t[]> buffer;
+  process_types::SYSTEM_PROCESS_INFORMATION<Traits>* process_information =
+      GetProcessInformation<Traits>(process_handle, &buffer);
+  if (!process_information)
+    return;
+
+  for (unsigned long i = 0; i < process_information->NumberOfThreads; ++i) {
+    ScopedKernelHANDLE thread_handle(
+        OpenThread(process_information->Threads[i]));
+    if (thread_handle.is_valid()) {
+      threads->push_back(std::move(thread_handle));
+    }
+  }
+}
+
 // It's necessary to suspend the thread to grab CONTEXT. SuspendThread has a
 // side-effect of returning the SuspendCount of the thread on success, so we
 // fill out these two pieces of semi-unrelated data in the same function.
@@ -290,6 +353,7 @@ ProcessReaderWin::ProcessReaderWin()
     : process_(INVALID_HANDLE_VALUE),
       process_info_(),
       process_memory_(),
+      cached_memory_(),
       threads_(),
       modules_(),
       suspension_state_(),
@@ -310,11 +374,26 @@ bool ProcessReaderWin::Initialize(HANDLE process,
     return false;
   if (!process_memory_.Initialize(process))
     return false;
+  cached_memory_.Initialize(&process_memory_, &process_info_.MemoryInfo());
 
   INITIALIZATION_STATE_SET_VALID(initialized_);
   return true;
 }
 
+void ProcessReaderWin::ReadMemoryFrom(HANDLE process_clone) {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  process_memory_.ReadFrom(process_clone);
+}
+
+const ProcessMemory* ProcessReaderWin::CachedMemory() const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+
+  if (suspension_state_ == ProcessSuspensionState::kSuspended) {
+    return &cached_memory_;
+  }
+  return &process_memory_;
+}
+
 bool ProcessReaderWin::StartTime(timeval* start_time) const {
   FILETIME creation, exit, kernel, user;
   if (!GetProcessTimes(process_, &creation, &exit, &kernel, &user)) {
@@ -383,21 +462,26 @@ template <class Traits>
 void ProcessReaderWin::ReadThreadData(bool is_64_reading_32) {
   DCHECK(threads_.empty());
 
-  std::unique_ptr<uint8_t[]> buffer;
-  process_types::SYSTEM_PROCESS_INFORMATION<Traits>* process_information =
-      GetProcessInformation<Traits>(process_, &buffer);
-  if (!process_information)
-    return;
-
-  for (unsigned long i = 0; i < process_information->NumberOfThreads; ++i) {
-    const process_types::SYSTEM_THREAD_INFORMATION<Traits>& thread_info =
-        process_information->Threads[i];
-    ProcessReaderWin::Thread thread;
-    thread.id = thread_info.ClientId.UniqueThread;
+  std::vector<ScopedKernelHANDLE> thread_handles;
+  if (!OpenThreadsInProcess(process_, &thread_handles)) {
+    OpenThreadsFromSystemInformation<Traits>(process_, &thread_handles);
+  }
 
-    ScopedKernelHANDLE thread_handle(OpenThread(thread_info));
-    if (!thread_handle.is_valid())
+  for (const ScopedKernelHANDLE& thread_handle : thread_handles) {
+    process_types::THREAD_BASIC_INFORMATION<Traits> thread_basic_info;
+    NTSTATUS status = crashpad::NtQueryInformationThread(
+        thread_handle.get(),
+        static_cast<THREADINFOCLASS>(ThreadBasicInformation),
+        &thread_basic_info,
+        sizeof(thread_basic_info),
+        nullptr);
+    if (!NT_SUCCESS(status)) {
+      NTSTATUS_LOG(ERROR, status) << "NtQueryInformationThread";
       continue;
+    }
+
+    ProcessReaderWin::Thread thread;
+    thread.id = thread_basic_info.ClientId.UniqueThread;
 
     if (!FillThreadContextAndSuspendCount<Traits>(thread_handle.get(),
                                                   &thread,
@@ -413,19 +497,7 @@ void ProcessReaderWin::ReadThreadData(bool is_64_reading_32) {
     // same time if it's useful.
     thread.priority_class = NORMAL_PRIORITY_CLASS;
 
-    thread.priority = thread_info.Priority;
-
-    process_types::THREAD_BASIC_INFORMATION<Traits> thread_basic_info;
-    NTSTATUS status = crashpad::NtQueryInformationThread(
-        thread_handle.get(),
-        static_cast<THREADINFOCLASS>(ThreadBasicInformation),
-        &thread_basic_info,
-        sizeof(thread_basic_info),
-        nullptr);
-    if (!NT_SUCCESS(status)) {
-      NTSTATUS_LOG(ERROR, status) << "NtQueryInformationThread";
-      continue;
-    }
+    thread.priority = thread_basic_info.Priority;
 
     // Read the TIB (Thread Information Block) which is the first element of the
     // TEB, for its stack fields.
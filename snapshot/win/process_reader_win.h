@@ -23,6 +23,7 @@
 
 #include "build/build_config.h"
 #include "util/misc/initialization_state_dcheck.h"
+#include "util/process/caching_process_memory_win.h"
 #include "util/process/process_memory_win.h"
 #include "util/win/address_types.h"
 #include "util/win/process_info.h"
@@ -119,6 +120,25 @@ class ProcessReaderWin {
   //! \brief Return a memory reader for the target process.
   const ProcessMemoryWin* Memory() const { return &process_memory_; }
 
+  //! \brief Reads the target process’ memory through \a process_clone from now
+  //!     on.
+  //!
+  //! Memory readers returned by Memory() and CachedMemory() read from the
+  //! clone, including those already given out. Other information continues
+  //! to be read from the target process.
+  //!
+  //! \param[in] process_clone A handle to a clone of the target process’
+  //!     address space, made while the target process was suspended. It must
+  //!     remain valid for as long as this object is used.
+  void ReadMemoryFrom(HANDLE process_clone);
+
+  //! \brief Return a memory reader for the target process suited to the many
+  //!     small reads made while walking module structures.
+  //!
+  //! If the target process is suspended, this reads ahead and caches memory in
+  //! CachingProcessMemoryWin::kChunkSize chunks. Otherwise, it is Memory().
+  const ProcessMemory* CachedMemory() const;
+
   //! \brief Determines the target process' start time.
   //!
   //! \param[out] start_time The time that the process started.
@@ -161,6 +181,7 @@ class ProcessReaderWin {
   HANDLE process_;
   ProcessInfo process_info_;
   ProcessMemoryWin process_memory_;
+  CachingProcessMemoryWin cached_memory_;
   std::vector<Thread> threads_;
   std::vector<ProcessInfo::Module> modules_;
   ProcessSuspensionState suspension_state_;
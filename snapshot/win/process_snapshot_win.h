@@ -82,6 +82,18 @@ class ProcessSnapshotWin final : public ProcessSnapshot {
                   WinVMAddress exception_information_address,
                   WinVMAddress debug_critical_section_address);
 
+  //! \brief Reads the process’ memory through \a process_clone from now on.
+  //!
+  //! This allows the process to be resumed once this object has been
+  //! initialized, while its memory is read as it was when it was suspended.
+  //!
+  //! \param[in] process_clone A handle to a clone of the process’ address
+  //!     space, made while it was suspended, such as by ProcessVaClone. It
+  //!     must remain valid for as long as this object is used.
+  void ReadMemoryFrom(HANDLE process_clone) {
+    process_reader_.ReadMemoryFrom(process_clone);
+  }
+
   //! \brief Sets the value to be returned by ReportID().
   //!
   //! The crash report ID is under the control of the snapshot producer, which
@@ -83,7 +83,7 @@ bool ProcessSubrangeReader::ReadMemory(WinVMAddress address,
     return false;
   }
 
-  return process_reader_->Memory()->Read(
+  return process_reader_->CachedMemory()->Read(
       address, base::checked_cast<size_t>(size), into);
 }
 
@@ -196,5 +196,15 @@ std::vector<const MemorySnapshot*> ThreadSnapshotWin::ExtraMemory() const {
   return result;
 }
 
+uint64_t ThreadSnapshotWin::UncapturedStackSize() const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  return 0;
+}
+
+std::vector<uint64_t> ThreadSnapshotWin::UnwoundFrames() const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  return std::vector<uint64_t>();
+}
+
 }  // namespace internal
 }  // namespace crashpad
@@ -0,0 +1,29 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_THIRD_PARTY_ZSTD_ZSTD_CRASHPAD_H_
+#define CRASHPAD_THIRD_PARTY_ZSTD_ZSTD_CRASHPAD_H_
+
+// #include this file instead of the system version of <zstd.h>. It will
+// #include <zstd.h> if the build has been configured with Zstandard support,
+// and defines CRASHPAD_ZSTD_SUPPORTED as 1 if so, or 0 if not.
+
+#if defined(CRASHPAD_ZSTD_SOURCE_SYSTEM)
+#include <zstd.h>
+#define CRASHPAD_ZSTD_SUPPORTED 1
+#else
+#define CRASHPAD_ZSTD_SUPPORTED 0
+#endif
+
+#endif  // CRASHPAD_THIRD_PARTY_ZSTD_ZSTD_CRASHPAD_H_
@@ -18,6 +18,7 @@
 #include "base/files/file_path.h"
 #include "build/build_config.h"
 #include "tools/tool_support.h"
+#include "util/stdlib/string_number_conversion.h"
 #include "util/stream/file_encoder.h"
 
 namespace crashpad {
@@ -32,6 +33,8 @@ void Usage(const base::FilePath& me) {
 "  -e, --encode   compress and encode the input file to a base94 encoded"
                   " file\n"
 "  -d, --decode   decode and decompress a base94 encoded file\n"
+"      --threads=N\n"
+"                 compress on N threads when encoding\n"
 "      --help     display this help and exit\n"
 "      --version  output version information and exit\n",
           me.value().c_str());
@@ -49,6 +52,10 @@ int Base94EncoderMain(int argc, char* argv[]) {
     kOptionEncode = 'e',
     kOptionDecode = 'd',
 
+    // Long options without short equivalents.
+    kOptionLastChar = 255,
+    kOptionThreads,
+
     // Standard options.
     kOptionHelp = -2,
     kOptionVersion = -3,
@@ -58,11 +65,14 @@ int Base94EncoderMain(int argc, char* argv[]) {
     bool encoding;
     base::FilePath input_file;
     base::FilePath output_file;
+    unsigned int threads;
   } options = {};
+  options.threads = 1;
 
   static constexpr option long_options[] = {
       {"encode", no_argument, nullptr, kOptionEncode},
       {"decode", no_argument, nullptr, kOptionDecode},
+      {"threads", required_argument, nullptr, kOptionThreads},
       {"help", no_argument, nullptr, kOptionHelp},
       {"version", no_argument, nullptr, kOptionVersion},
       {nullptr, 0, nullptr, 0},
@@ -80,6 +90,12 @@ int Base94EncoderMain(int argc, char* argv[]) {
         options.encoding = false;
         encoding_valid = true;
         break;
+      case kOptionThreads:
+        if (!StringToNumber(optarg, &options.threads) || options.threads < 1) {
+          ToolSupport::UsageHint(me, "--threads requires a positive number");
+          return EXIT_FAILURE;
+        }
+        break;
       case kOptionHelp:
         Usage(me);
         return EXIT_SUCCESS;
@@ -112,7 +128,8 @@ int Base94EncoderMain(int argc, char* argv[]) {
   FileEncoder encoder(options.encoding ? crashpad::FileEncoder::Mode::kEncode
                                        : crashpad::FileEncoder::Mode::kDecode,
                       options.input_file,
-                      options.output_file);
+                      options.output_file,
+                      options.threads);
   return encoder.Process() ? EXIT_SUCCESS : EXIT_FAILURE;
 }
 
@@ -14,6 +14,7 @@
 
 #include <errno.h>
 #include <getopt.h>
+#include <inttypes.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -21,6 +22,8 @@
 #include <sys/types.h>
 #include <time.h>
 
+#include <algorithm>
+#include <atomic>
 #include <iterator>
 #include <memory>
 #include <string>
@@ -31,6 +34,7 @@
 #include "base/files/file_path.h"
 #include "base/numerics/safe_conversions.h"
 #include "base/strings/utf_string_conversions.h"
+#include "base/synchronization/lock.h"
 #include "build/build_config.h"
 #include "client/crash_report_database.h"
 #include "client/settings.h"
@@ -39,6 +43,7 @@
 #include "util/file/file_reader.h"
 #include "util/misc/uuid.h"
 #include "util/stdlib/string_number_conversion.h"
+#include "util/thread/thread.h"
 
 namespace crashpad {
 namespace {
@@ -59,6 +64,17 @@ void Usage(const base::FilePath& me) {
 "      --show-completed-reports    show reports not eligible for upload\n"
 "      --show-all-report-info      with --show-*-reports, show more information\n"
 "      --show-report=UUID          show report stored under UUID\n"
+"      --show-statistics           show the numbers and total size of reports\n"
+"      --select-reports=STATE      select reports in STATE: pending, completed,\n"
+"                                  or all\n"
+"      --select-reports-from-stdin select reports by UUID from standard input\n"
+"      --created-before=TIME       only select reports created before TIME\n"
+"      --larger-than=BYTES         only select reports larger than BYTES\n"
+"      --delete-selected-reports   delete the selected reports\n"
+"      --request-upload-selected-reports\n"
+"                                  request upload of the selected reports\n"
+"      --threads=N                 operate on N selected reports at a time\n"
+"      --json                      show selected reports as JSON lines\n"
 "      --set-uploads-enabled=BOOL  enable or disable uploads\n"
 "      --set-last-upload-attempt-time=TIME\n"
 "                                  set the last-upload-attempt time to TIME\n"
@@ -71,12 +87,23 @@ void Usage(const base::FilePath& me) {
   ToolSupport::UsageTail(me);
 }
 
+enum class BulkOperation {
+  kNone,
+  kDelete,
+  kRequestUpload,
+};
+
 struct Options {
   std::vector<UUID> show_reports;
   std::vector<base::FilePath> new_report_paths;
   const char* database;
   const char* set_last_upload_attempt_time_string;
   time_t set_last_upload_attempt_time;
+  const char* created_before_string;
+  time_t created_before;
+  uint64_t larger_than;
+  BulkOperation bulk_operation;
+  unsigned int threads;
   bool create;
   bool show_client_id;
   bool show_uploads_enabled;
@@ -84,8 +111,13 @@ struct Options {
   bool show_pending_reports;
   bool show_completed_reports;
   bool show_all_report_info;
+  bool show_statistics;
   bool set_uploads_enabled;
   bool has_set_uploads_enabled;
+  bool select_pending_reports;
+  bool select_completed_reports;
+  bool select_reports_from_stdin;
+  bool json;
   bool utc;
 };
 
@@ -248,6 +280,21 @@ void ShowReport(const CrashReportDatabase::Report& report,
   printf("%sUpload attempts: %d\n", spaces.c_str(), report.upload_attempts);
 }
 
+// Shows the numbers and total size of reports in |statistics|. |space_count| is
+// the number of spaces to print before each line that is printed.
+void ShowStatistics(const CrashReportDatabase::Statistics& statistics,
+                    size_t space_count) {
+  std::string spaces(space_count, ' ');
+
+  printf("%sPending reports: %zu\n",
+         spaces.c_str(),
+         statistics.pending_reports);
+  printf("%sCompleted reports: %zu\n",
+         spaces.c_str(),
+         statistics.completed_reports);
+  printf("%sTotal size: %" PRIu64 "\n", spaces.c_str(), statistics.total_size);
+}
+
 // Shows information about a vector of |reports|. |space_count| is the number of
 // spaces to print before each line that is printed. |options| will be consulted
 // to determine whether to show expanded information
@@ -267,6 +314,247 @@ void ShowReports(const std::vector<CrashReportDatabase::Report>& reports,
   }
 }
 
+// Returns true if |report| passes the --created-before and --larger-than
+// filters in |options|.
+bool ReportMatchesFilters(const CrashReportDatabase::Report& report,
+                          const Options& options) {
+  if (options.created_before_string &&
+      report.creation_time >= options.created_before) {
+    return false;
+  }
+  return report.total_size > options.larger_than;
+}
+
+// Reads UUIDs from standard input, one per line, appending them to |uuids|.
+// Blank lines are ignored. Returns false with a message printed if a line isn’t
+// a UUID.
+bool ReadUUIDsFromStdin(const base::FilePath& me, std::vector<UUID>* uuids) {
+  char line[128];
+  while (fgets(line, sizeof(line), stdin)) {
+    size_t length = strlen(line);
+    while (length > 0 && strchr(" \t\r\n", line[length - 1])) {
+      line[--length] = '\0';
+    }
+    if (length == 0) {
+      continue;
+    }
+
+    UUID uuid;
+    if (!uuid.InitializeFromString(line)) {
+      fprintf(stderr,
+              "%" PRFilePath ": Not a UUID: %s\n",
+              me.value().c_str(),
+              line);
+      return false;
+    }
+    uuids->push_back(uuid);
+  }
+  return true;
+}
+
+// Operates on the reports selected by --select-reports and
+// --select-reports-from-stdin on a pool of threads, writing a line to stdout
+// for each. A CrashReportDatabase object mustn’t be used on more than one
+// thread at a time, so each thread opens the database for itself. The database
+// coordinates access among these as it does among processes.
+class SelectedReportProcessor {
+ public:
+  struct SelectedReport {
+    CrashReportDatabase::Report report;
+
+    // If true, only report.uuid is valid, and the rest of |report| must be
+    // looked up and filtered before operating on it.
+    bool needs_lookup;
+  };
+
+  SelectedReportProcessor(const Options& options,
+                          const base::FilePath& database_path,
+                          const std::vector<SelectedReport>& reports)
+      : options_(options),
+        database_path_(database_path),
+        reports_(reports),
+        next_index_(0),
+        failures_(0),
+        output_lock_() {}
+
+  SelectedReportProcessor(const SelectedReportProcessor&) = delete;
+  SelectedReportProcessor& operator=(const SelectedReportProcessor&) = delete;
+
+  // Operates on every selected report, using |database| on the calling thread.
+  // Returns the number of reports that couldn’t be looked up or operated on.
+  size_t Run(CrashReportDatabase* database) {
+    const size_t worker_count =
+        std::max(size_t{1},
+                 std::min(size_t{options_.threads}, reports_.size())) -
+        1;
+    std::vector<std::unique_ptr<ProcessorThread>> workers;
+    for (size_t index = 0; index < worker_count; ++index) {
+      workers.push_back(std::make_unique<ProcessorThread>(this));
+      workers.back()->Start();
+    }
+
+    ProcessReports(database);
+
+    for (const auto& worker : workers) {
+      worker->Join();
+    }
+
+    return failures_;
+  }
+
+ private:
+  class ProcessorThread : public Thread {
+   public:
+    explicit ProcessorThread(SelectedReportProcessor* processor)
+        : Thread(), processor_(processor) {}
+
+    ProcessorThread(const ProcessorThread&) = delete;
+    ProcessorThread& operator=(const ProcessorThread&) = delete;
+
+    ~ProcessorThread() override {}
+
+   private:
+    void ThreadMain() override {
+      // If the database can’t be opened here, the other threads will operate
+      // on this thread’s share of the reports.
+      std::unique_ptr<CrashReportDatabase> database =
+          CrashReportDatabase::InitializeWithoutCreating(
+              processor_->database_path_);
+      if (database) {
+        processor_->ProcessReports(database.get());
+      }
+    }
+
+    SelectedReportProcessor* processor_;  // weak
+  };
+
+  // Operates on reports until there are none left.
+  void ProcessReports(CrashReportDatabase* database) {
+    size_t index;
+    while ((index = next_index_.fetch_add(1, std::memory_order_relaxed)) <
+           reports_.size()) {
+      std::string line;
+      if (!ProcessReport(database, reports_[index], &line)) {
+        ++failures_;
+      }
+      if (!line.empty()) {
+        Write(line);
+      }
+    }
+  }
+
+  // Operates on |selected|, setting |line| to its line of output, or leaving
+  // it empty if the report doesn’t pass the filters after being looked up.
+  bool ProcessReport(CrashReportDatabase* database,
+                     const SelectedReport& selected,
+                     std::string* line) {
+    const UUID& uuid = selected.report.uuid;
+    const CrashReportDatabase::Report* report = &selected.report;
+    CrashReportDatabase::Report looked_up_report;
+    if (selected.needs_lookup) {
+      CrashReportDatabase::OperationStatus status =
+          database->LookUpCrashReport(uuid, &looked_up_report);
+      if (status != CrashReportDatabase::kNoError) {
+        FormatLine(uuid, nullptr, StatusToResult(status, nullptr), line);
+        return false;
+      }
+      if (!ReportMatchesFilters(looked_up_report, options_)) {
+        return true;
+      }
+      report = &looked_up_report;
+    }
+
+    CrashReportDatabase::OperationStatus status = CrashReportDatabase::kNoError;
+    const char* result = nullptr;
+    switch (options_.bulk_operation) {
+      case BulkOperation::kNone:
+        break;
+      case BulkOperation::kDelete:
+        status = database->DeleteReport(uuid);
+        result = StatusToResult(status, "deleted");
+        break;
+      case BulkOperation::kRequestUpload:
+        status = database->RequestUpload(uuid);
+        result = StatusToResult(status, "upload requested");
+        break;
+    }
+
+    FormatLine(uuid, report, result, line);
+    return status == CrashReportDatabase::kNoError;
+  }
+
+  // Returns the result to show for an operation that returned |status|, with
+  // |success| shown if it succeeded.
+  static const char* StatusToResult(CrashReportDatabase::OperationStatus status,
+                                    const char* success) {
+    switch (status) {
+      case CrashReportDatabase::kNoError:
+        return success;
+      case CrashReportDatabase::kReportNotFound:
+        return "not found";
+      default:
+        return "failed";
+    }
+  }
+
+  // Sets |line| to the output for the report identified by |uuid|. |report|
+  // may be nullptr if the report couldn’t be looked up, and |result| may be
+  // nullptr if no operation was performed.
+  void FormatLine(const UUID& uuid,
+                  const CrashReportDatabase::Report* report,
+                  const char* result,
+                  std::string* line) {
+    if (!options_.json) {
+      line->assign(uuid.ToString());
+      if (result) {
+        line->append(": ").append(result);
+      }
+      line->push_back('\n');
+      return;
+    }
+
+    line->assign("{\"uuid\":").append(
+        ToolSupport::JSONString(uuid.ToString()));
+    if (report) {
+      line->append(",\"path\":")
+          .append(ToolSupport::JSONString(
+              ToolSupport::FilePathToCommandLineArgument(report->file_path)));
+      if (!report->id.empty()) {
+        line->append(",\"remote_id\":")
+            .append(ToolSupport::JSONString(report->id));
+      }
+      line->append(",\"creation_time\":")
+          .append(std::to_string(report->creation_time))
+          .append(",\"uploaded\":")
+          .append(BoolToString(report->uploaded))
+          .append(",\"last_upload_attempt_time\":")
+          .append(std::to_string(report->last_upload_attempt_time))
+          .append(",\"upload_attempts\":")
+          .append(std::to_string(report->upload_attempts))
+          .append(",\"total_size\":")
+          .append(std::to_string(report->total_size));
+    }
+    if (result) {
+      line->append(",\"result\":").append(ToolSupport::JSONString(result));
+    }
+    line->append("}\n");
+  }
+
+  // Writes |data| to stdout without interleaving it with other threads’
+  // output.
+  void Write(const std::string& data) {
+    base::AutoLock lock(output_lock_);
+    fwrite(data.data(), 1, data.size(), stdout);
+  }
+
+  const Options& options_;
+  const base::FilePath database_path_;
+  const std::vector<SelectedReport>& reports_;
+  std::atomic<size_t> next_index_;
+  std::atomic<size_t> failures_;
+  base::Lock output_lock_;
+};
+
 int DatabaseUtilMain(int argc, char* argv[]) {
   const base::FilePath argv0(
       ToolSupport::CommandLineArgumentToFilePathStringType(argv[0]));
@@ -286,9 +574,18 @@ int DatabaseUtilMain(int argc, char* argv[]) {
     kOptionShowCompletedReports,
     kOptionShowAllReportInfo,
     kOptionShowReport,
+    kOptionShowStatistics,
     kOptionSetUploadsEnabled,
     kOptionSetLastUploadAttemptTime,
     kOptionNewReport,
+    kOptionSelectReports,
+    kOptionSelectReportsFromStdin,
+    kOptionCreatedBefore,
+    kOptionLargerThan,
+    kOptionDeleteSelectedReports,
+    kOptionRequestUploadSelectedReports,
+    kOptionThreads,
+    kOptionJSON,
     kOptionUTC,
 
     // Standard options.
@@ -312,6 +609,7 @@ int DatabaseUtilMain(int argc, char* argv[]) {
        kOptionShowCompletedReports},
       {"show-all-report-info", no_argument, nullptr, kOptionShowAllReportInfo},
       {"show-report", required_argument, nullptr, kOptionShowReport},
+      {"show-statistics", no_argument, nullptr, kOptionShowStatistics},
       {"set-uploads-enabled",
        required_argument,
        nullptr,
@@ -321,6 +619,23 @@ int DatabaseUtilMain(int argc, char* argv[]) {
        nullptr,
        kOptionSetLastUploadAttemptTime},
       {"new-report", required_argument, nullptr, kOptionNewReport},
+      {"select-reports", required_argument, nullptr, kOptionSelectReports},
+      {"select-reports-from-stdin",
+       no_argument,
+       nullptr,
+       kOptionSelectReportsFromStdin},
+      {"created-before", required_argument, nullptr, kOptionCreatedBefore},
+      {"larger-than", required_argument, nullptr, kOptionLargerThan},
+      {"delete-selected-reports",
+       no_argument,
+       nullptr,
+       kOptionDeleteSelectedReports},
+      {"request-upload-selected-reports",
+       no_argument,
+       nullptr,
+       kOptionRequestUploadSelectedReports},
+      {"threads", required_argument, nullptr, kOptionThreads},
+      {"json", no_argument, nullptr, kOptionJSON},
       {"utc", no_argument, nullptr, kOptionUTC},
       {"help", no_argument, nullptr, kOptionHelp},
       {"version", no_argument, nullptr, kOptionVersion},
@@ -328,6 +643,8 @@ int DatabaseUtilMain(int argc, char* argv[]) {
   };
 
   Options options = {};
+  options.bulk_operation = BulkOperation::kNone;
+  options.threads = 1;
 
   int opt;
   while ((opt = getopt_long(argc, argv, "d:", long_options, nullptr)) != -1) {
@@ -373,6 +690,10 @@ int DatabaseUtilMain(int argc, char* argv[]) {
         options.show_reports.push_back(uuid);
         break;
       }
+      case kOptionShowStatistics: {
+        options.show_statistics = true;
+        break;
+      }
       case kOptionSetUploadsEnabled: {
         if (!StringToBool(optarg, &options.set_uploads_enabled)) {
           ToolSupport::UsageHint(me, "--set-uploads-enabled requires a BOOL");
@@ -390,6 +711,56 @@ int DatabaseUtilMain(int argc, char* argv[]) {
             ToolSupport::CommandLineArgumentToFilePathStringType(optarg)));
         break;
       }
+      case kOptionSelectReports: {
+        if (strcmp(optarg, "pending") == 0) {
+          options.select_pending_reports = true;
+        } else if (strcmp(optarg, "completed") == 0) {
+          options.select_completed_reports = true;
+        } else if (strcmp(optarg, "all") == 0) {
+          options.select_pending_reports = true;
+          options.select_completed_reports = true;
+        } else {
+          ToolSupport::UsageHint(
+              me, "--select-reports requires pending, completed, or all");
+          return EXIT_FAILURE;
+        }
+        break;
+      }
+      case kOptionSelectReportsFromStdin: {
+        options.select_reports_from_stdin = true;
+        break;
+      }
+      case kOptionCreatedBefore: {
+        options.created_before_string = optarg;
+        break;
+      }
+      case kOptionLargerThan: {
+        if (!StringToNumber(optarg, &options.larger_than)) {
+          ToolSupport::UsageHint(me, "--larger-than requires a number");
+          return EXIT_FAILURE;
+        }
+        break;
+      }
+      case kOptionDeleteSelectedReports: {
+        options.bulk_operation = BulkOperation::kDelete;
+        break;
+      }
+      case kOptionRequestUploadSelectedReports: {
+        options.bulk_operation = BulkOperation::kRequestUpload;
+        break;
+      }
+      case kOptionThreads: {
+        if (!StringToNumber(optarg, &options.threads) ||
+            options.threads < 1) {
+          ToolSupport::UsageHint(me, "--threads requires a positive number");
+          return EXIT_FAILURE;
+        }
+        break;
+      }
+      case kOptionJSON: {
+        options.json = true;
+        break;
+      }
       case kOptionUTC: {
         options.utc = true;
         break;
@@ -429,13 +800,36 @@ int DatabaseUtilMain(int argc, char* argv[]) {
     }
   }
 
-  // --new-report is treated as a show operation because it produces output.
+  if (options.created_before_string &&
+      !StringToTime(options.created_before_string,
+                    &options.created_before,
+                    options.utc)) {
+    ToolSupport::UsageHint(me, "--created-before requires a TIME");
+    return EXIT_FAILURE;
+  }
+
+  const bool select_reports = options.select_pending_reports ||
+                              options.select_completed_reports ||
+                              options.select_reports_from_stdin;
+  if (!select_reports &&
+      (options.created_before_string || options.larger_than ||
+       options.bulk_operation != BulkOperation::kNone)) {
+    ToolSupport::UsageHint(me,
+                           "--select-reports or --select-reports-from-stdin "
+                           "is required to filter or operate on reports");
+    return EXIT_FAILURE;
+  }
+
+  // --new-report is treated as a show operation because it produces output, as
+  // is selecting reports.
   const size_t show_operations = options.show_client_id +
                                  options.show_uploads_enabled +
                                  options.show_last_upload_attempt_time +
                                  options.show_pending_reports +
                                  options.show_completed_reports +
                                  options.show_reports.size() +
+                                 options.show_statistics +
+                                 select_reports +
                                  options.new_report_paths.size();
   const size_t set_operations =
       options.has_set_uploads_enabled +
@@ -551,6 +945,20 @@ int DatabaseUtilMain(int argc, char* argv[]) {
     }
   }
 
+  if (options.show_statistics) {
+    CrashReportDatabase::Statistics statistics;
+    if (database->GetStatistics(&statistics) !=
+        CrashReportDatabase::kNoError) {
+      return EXIT_FAILURE;
+    }
+
+    if (show_operations > 1) {
+      printf("Statistics:\n");
+    }
+
+    ShowStatistics(statistics, show_operations > 1 ? 2 : 0);
+  }
+
   if (options.has_set_uploads_enabled &&
       !settings->SetUploadsEnabled(options.set_uploads_enabled)) {
     return EXIT_FAILURE;
@@ -563,6 +971,62 @@ int DatabaseUtilMain(int argc, char* argv[]) {
   }
 
   bool used_stdin = false;
+  if (select_reports) {
+    std::vector<SelectedReportProcessor::SelectedReport> selected_reports;
+    const auto select = [&options, &selected_reports](
+                            const std::vector<CrashReportDatabase::Report>&
+                                reports) {
+      for (const CrashReportDatabase::Report& report : reports) {
+        if (ReportMatchesFilters(report, options)) {
+          selected_reports.push_back({report, false});
+        }
+      }
+    };
+
+    if (options.select_pending_reports) {
+      std::vector<CrashReportDatabase::Report> pending_reports;
+      if (database->GetPendingReports(&pending_reports) !=
+          CrashReportDatabase::kNoError) {
+        return EXIT_FAILURE;
+      }
+      select(pending_reports);
+    }
+
+    if (options.select_completed_reports) {
+      std::vector<CrashReportDatabase::Report> completed_reports;
+      if (database->GetCompletedReports(&completed_reports) !=
+          CrashReportDatabase::kNoError) {
+        return EXIT_FAILURE;
+      }
+      select(completed_reports);
+    }
+
+    if (options.select_reports_from_stdin) {
+      used_stdin = true;
+      std::vector<UUID> uuids;
+      if (!ReadUUIDsFromStdin(me, &uuids)) {
+        return EXIT_FAILURE;
+      }
+      for (const UUID& uuid : uuids) {
+        CrashReportDatabase::Report report;
+        report.uuid = uuid;
+        selected_reports.push_back({report, true});
+      }
+    }
+
+    SelectedReportProcessor processor(
+        options, database_path, selected_reports);
+    size_t failures = processor.Run(database.get());
+    fflush(stdout);
+    if (failures) {
+      fprintf(stderr,
+              "%" PRFilePath ": %zu selected reports failed\n",
+              me.value().c_str(),
+              failures);
+      return EXIT_FAILURE;
+    }
+  }
+
   for (const base::FilePath& new_report_path : options.new_report_paths) {
     std::unique_ptr<FileReaderInterface> file_reader;
 
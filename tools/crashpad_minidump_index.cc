@@ -0,0 +1,424 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "base/files/file_path.h"
+#include "base/logging.h"
+#include "base/synchronization/lock.h"
+#include "build/build_config.h"
+#include "client/crash_report_database.h"
+#include "handler/minidump_to_upload_parameters.h"
+#include "snapshot/minidump/process_snapshot_minidump.h"
+#include "tools/tool_support.h"
+#include "util/file/directory_reader.h"
+#include "util/file/filesystem.h"
+#include "util/file/mapped_file_reader.h"
+#include "util/stdlib/string_number_conversion.h"
+#include "util/thread/thread.h"
+
+namespace crashpad {
+namespace {
+
+void Usage(const base::FilePath& me) {
+  // clang-format off
+  fprintf(stderr,
+"Usage: %" PRFilePath " [OPTION]... [PATH]...\n"
+"Extract upload parameters from many minidumps.\n"
+"\n"
+"  -d, --database=PATH       index every report in the database at PATH\n"
+"  -f, --field=KEY           output the parameter KEY, may be repeated\n"
+"      --format=FORMAT       output FORMAT, json (default) or csv\n"
+"      --threads=N           read N minidumps at a time\n"
+"      --help                display this help and exit\n"
+"      --version             output version information and exit\n",
+          me.value().c_str());
+  // clang-format on
+  ToolSupport::UsageTail(me);
+}
+
+enum class OutputFormat {
+  kJSON,
+  kCSV,
+};
+
+struct Options {
+  std::vector<base::FilePath> databases;
+  std::vector<std::string> fields;
+  OutputFormat format;
+  unsigned int threads;
+};
+
+// Returns |string| as a CSV field, quoted only if it needs to be.
+std::string CSVField(const std::string& string) {
+  if (string.find_first_of(",\"\r\n") == std::string::npos) {
+    return string;
+  }
+
+  std::string csv("\"");
+  for (char c : string) {
+    if (c == '"') {
+      csv.push_back('"');
+    }
+    csv.push_back(c);
+  }
+  csv.push_back('"');
+  return csv;
+}
+
+std::string FilePathToUTF8(const base::FilePath& path) {
+  return ToolSupport::FilePathToCommandLineArgument(path);
+}
+
+// Appends the minidumps in |directory| and its subdirectories to |paths|.
+// Returns false with a message logged if a directory can’t be read.
+bool AddDirectory(const base::FilePath& directory,
+                  std::vector<base::FilePath>* paths) {
+  DirectoryReader reader;
+  if (!reader.Open(directory)) {
+    return false;
+  }
+
+  static constexpr base::FilePath::CharType kMinidumpExtension[] =
+      FILE_PATH_LITERAL(".dmp");
+  static constexpr size_t kMinidumpExtensionLength =
+      std::size(kMinidumpExtension) - 1;
+
+  bool success = true;
+  base::FilePath filename;
+  DirectoryReader::Result result;
+  while ((result = reader.NextFile(&filename)) ==
+         DirectoryReader::Result::kSuccess) {
+    const base::FilePath path = directory.Append(filename);
+    if (IsDirectory(path, false)) {
+      success &= AddDirectory(path, paths);
+    } else if (IsRegularFile(path) &&
+               path.value().size() > kMinidumpExtensionLength &&
+               path.value().compare(
+                   path.value().size() - kMinidumpExtensionLength,
+                   kMinidumpExtensionLength,
+                   kMinidumpExtension) == 0) {
+      paths->push_back(path);
+    }
+  }
+
+  return success && result == DirectoryReader::Result::kNoMoreFiles;
+}
+
+// Appends the reports in the database at |database_path| to |paths|. Returns
+// false with a message logged if the database can’t be read.
+bool AddDatabase(const base::FilePath& database_path,
+                 std::vector<base::FilePath>* paths) {
+  std::unique_ptr<CrashReportDatabase> database(
+      CrashReportDatabase::InitializeWithoutCreating(database_path));
+  if (!database) {
+    return false;
+  }
+
+  std::vector<CrashReportDatabase::Report> reports;
+  if (database->GetPendingReports(&reports) != CrashReportDatabase::kNoError) {
+    return false;
+  }
+  std::vector<CrashReportDatabase::Report> completed_reports;
+  if (database->GetCompletedReports(&completed_reports) !=
+      CrashReportDatabase::kNoError) {
+    return false;
+  }
+  reports.insert(
+      reports.end(), completed_reports.begin(), completed_reports.end());
+
+  for (const CrashReportDatabase::Report& report : reports) {
+    paths->push_back(report.file_path);
+  }
+  return true;
+}
+
+// Reads minidumps on a pool of threads, writing a line to stdout for each.
+class MinidumpIndexer {
+ public:
+  MinidumpIndexer(const Options& options,
+                  const std::vector<base::FilePath>& paths)
+      : options_(options),
+        paths_(paths),
+        next_index_(0),
+        failures_(0),
+        output_lock_() {}
+
+  MinidumpIndexer(const MinidumpIndexer&) = delete;
+  MinidumpIndexer& operator=(const MinidumpIndexer&) = delete;
+
+  // Reads every minidump, returning the number that couldn’t be read.
+  size_t Run() {
+    if (options_.format == OutputFormat::kCSV) {
+      std::string header(CSVField("path"));
+      for (const std::string& field : options_.fields) {
+        header.append(",").append(CSVField(field));
+      }
+      header.push_back('\n');
+      Write(header);
+    }
+
+    const size_t worker_count =
+        std::max(size_t{1},
+                 std::min(size_t{options_.threads}, paths_.size())) -
+        1;
+    std::vector<std::unique_ptr<IndexerThread>> workers;
+    for (size_t index = 0; index < worker_count; ++index) {
+      workers.push_back(std::make_unique<IndexerThread>(this));
+      workers.back()->Start();
+    }
+
+    IndexFiles();
+
+    for (const auto& worker : workers) {
+      worker->Join();
+    }
+
+    return failures_;
+  }
+
+ private:
+  class IndexerThread : public Thread {
+   public:
+    explicit IndexerThread(MinidumpIndexer* indexer)
+        : Thread(), indexer_(indexer) {}
+
+    IndexerThread(const IndexerThread&) = delete;
+    IndexerThread& operator=(const IndexerThread&) = delete;
+
+    ~IndexerThread() override {}
+
+   private:
+    void ThreadMain() override { indexer_->IndexFiles(); }
+
+    MinidumpIndexer* indexer_;  // weak
+  };
+
+  // Reads minidumps until there are none left.
+  void IndexFiles() {
+    size_t index;
+    while ((index = next_index_.fetch_add(1, std::memory_order_relaxed)) <
+           paths_.size()) {
+      std::string line;
+      if (IndexFile(paths_[index], &line)) {
+        Write(line);
+      } else {
+        ++failures_;
+      }
+    }
+  }
+
+  // Reads the minidump at |path|, setting |line| to its line of output.
+  bool IndexFile(const base::FilePath& path, std::string* line) {
+    MappedFileReader mapped_file;
+    ProcessSnapshotMinidump snapshot;
+    if (!mapped_file.Open(path) || !snapshot.InitializeLazily(&mapped_file)) {
+      LOG(ERROR) << "couldn’t read " << FilePathToUTF8(path);
+      return false;
+    }
+
+    const std::map<std::string, std::string> parameters =
+        BreakpadHTTPFormParametersFromMinidump(&snapshot);
+
+    if (options_.format == OutputFormat::kCSV) {
+      line->assign(CSVField(FilePathToUTF8(path)));
+      for (const std::string& field : options_.fields) {
+        line->push_back(',');
+        const auto it = parameters.find(field);
+        if (it != parameters.end()) {
+          line->append(CSVField(it->second));
+        }
+      }
+    } else {
+      line->assign("{\"path\":")
+          .append(ToolSupport::JSONString(FilePathToUTF8(path)));
+      const auto append = [line](const std::string& key,
+                                 const std::string& value) {
+        line->append(",")
+            .append(ToolSupport::JSONString(key))
+            .append(":")
+            .append(ToolSupport::JSONString(value));
+      };
+      if (options_.fields.empty()) {
+        for (const auto& parameter : parameters) {
+          append(parameter.first, parameter.second);
+        }
+      } else {
+        for (const std::string& field : options_.fields) {
+          const auto it = parameters.find(field);
+          if (it != parameters.end()) {
+            append(it->first, it->second);
+          }
+        }
+      }
+      line->push_back('}');
+    }
+    line->push_back('\n');
+    return true;
+  }
+
+  // Writes |data| to stdout without interleaving it with other threads’
+  // output.
+  void Write(const std::string& data) {
+    base::AutoLock lock(output_lock_);
+    fwrite(data.data(), 1, data.size(), stdout);
+  }
+
+  const Options& options_;
+  const std::vector<base::FilePath>& paths_;
+  std::atomic<size_t> next_index_;
+  std::atomic<size_t> failures_;
+  base::Lock output_lock_;
+};
+
+int MinidumpIndexMain(int argc, char* argv[]) {
+  const base::FilePath argv0(
+      ToolSupport::CommandLineArgumentToFilePathStringType(argv[0]));
+  const base::FilePath me(argv0.BaseName());
+
+  enum OptionFlags {
+    // “Short” (single-character) options.
+    kOptionDatabase = 'd',
+    kOptionField = 'f',
+
+    // Long options without short equivalents.
+    kOptionLastChar = 255,
+    kOptionFormat,
+    kOptionThreads,
+
+    // Standard options.
+    kOptionHelp = -2,
+    kOptionVersion = -3,
+  };
+
+  static constexpr option long_options[] = {
+      {"database", required_argument, nullptr, kOptionDatabase},
+      {"field", required_argument, nullptr, kOptionField},
+      {"format", required_argument, nullptr, kOptionFormat},
+      {"threads", required_argument, nullptr, kOptionThreads},
+      {"help", no_argument, nullptr, kOptionHelp},
+      {"version", no_argument, nullptr, kOptionVersion},
+      {nullptr, 0, nullptr, 0},
+  };
+
+  Options options = {};
+  options.format = OutputFormat::kJSON;
+  options.threads = std::max(1u, std::thread::hardware_concurrency());
+
+  int opt;
+  while ((opt = getopt_long(argc, argv, "d:f:", long_options, nullptr)) !=
+         -1) {
+    switch (opt) {
+      case kOptionDatabase: {
+        options.databases.push_back(base::FilePath(
+            ToolSupport::CommandLineArgumentToFilePathStringType(optarg)));
+        break;
+      }
+      case kOptionField: {
+        options.fields.push_back(optarg);
+        break;
+      }
+      case kOptionFormat: {
+        if (strcmp(optarg, "json") == 0) {
+          options.format = OutputFormat::kJSON;
+        } else if (strcmp(optarg, "csv") == 0) {
+          options.format = OutputFormat::kCSV;
+        } else {
+          ToolSupport::UsageHint(me, "--format requires json or csv");
+          return EXIT_FAILURE;
+        }
+        break;
+      }
+      case kOptionThreads: {
+        if (!StringToNumber(optarg, &options.threads) ||
+            options.threads < 1) {
+          ToolSupport::UsageHint(me, "--threads requires a positive number");
+          return EXIT_FAILURE;
+        }
+        break;
+      }
+      case kOptionHelp: {
+        Usage(me);
+        return EXIT_SUCCESS;
+      }
+      case kOptionVersion: {
+        ToolSupport::Version(me);
+        return EXIT_SUCCESS;
+      }
+      default: {
+        ToolSupport::UsageHint(me, nullptr);
+        return EXIT_FAILURE;
+      }
+    }
+  }
+  argc -= optind;
+  argv += optind;
+
+  if (options.databases.empty() && argc == 0) {
+    ToolSupport::UsageHint(me, "nothing to do");
+    return EXIT_FAILURE;
+  }
+
+  if (options.format == OutputFormat::kCSV && options.fields.empty()) {
+    ToolSupport::UsageHint(me, "--format=csv requires --field");
+    return EXIT_FAILURE;
+  }
+
+  bool success = true;
+  std::vector<base::FilePath> paths;
+  for (const base::FilePath& database : options.databases) {
+    success &= AddDatabase(database, &paths);
+  }
+  for (int index = 0; index < argc; ++index) {
+    const base::FilePath path(
+        ToolSupport::CommandLineArgumentToFilePathStringType(argv[index]));
+    if (IsDirectory(path, true)) {
+      success &= AddDirectory(path, &paths);
+    } else {
+      paths.push_back(path);
+    }
+  }
+
+  MinidumpIndexer indexer(options, paths);
+  if (indexer.Run() != 0) {
+    success = false;
+  }
+
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+}  // namespace
+}  // namespace crashpad
+
+#if BUILDFLAG(IS_POSIX)
+int main(int argc, char* argv[]) {
+  return crashpad::MinidumpIndexMain(argc, argv);
+}
+#elif BUILDFLAG(IS_WIN)
+int wmain(int argc, wchar_t* argv[]) {
+  return crashpad::ToolSupport::Wmain(argc, argv, crashpad::MinidumpIndexMain);
+}
+#endif  // BUILDFLAG(IS_POSIX)
@@ -17,8 +17,12 @@
 #include <stdlib.h>
 #include <sys/types.h>
 
+#include <algorithm>
+#include <atomic>
 #include <memory>
+#include <set>
 #include <string>
+#include <vector>
 
 #include "base/logging.h"
 #include "base/strings/stringprintf.h"
@@ -28,6 +32,7 @@
 #include "util/file/file_writer.h"
 #include "util/process/process_id.h"
 #include "util/stdlib/string_number_conversion.h"
+#include "util/thread/thread.h"
 
 #if BUILDFLAG(IS_POSIX)
 #include <unistd.h>
@@ -48,8 +53,13 @@
 #include "util/win/scoped_process_suspend.h"
 #include "util/win/xp_compat.h"
 #elif BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+#include "snapshot/elf/elf_image_info_cache.h"
 #include "snapshot/linux/process_snapshot_linux.h"
+#include "snapshot/linux/system_info_cache.h"
+#include "util/file/directory_reader.h"
+#include "util/file/file_io.h"
 #include "util/linux/direct_ptrace_connection.h"
+#include "util/string/split_string.h"
 #endif  // BUILDFLAG(IS_APPLE)
 
 namespace crashpad {
@@ -58,11 +68,18 @@ namespace {
 void Usage(const base::FilePath& me) {
   // clang-format off
   fprintf(stderr,
-"Usage: %" PRFilePath " [OPTION]... PID\n"
-"Generate a minidump file containing a snapshot of a running process.\n"
+"Usage: %" PRFilePath " [OPTION]... [PID]...\n"
+"Generate minidump files containing snapshots of running processes.\n"
 "\n"
 "  -r, --no-suspend   don't suspend the target process during dump generation\n"
 "  -o, --output=FILE  write the minidump to FILE instead of minidump.PID\n"
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+"      --name=NAME    also dump each process whose command name is NAME\n"
+"      --cgroup=PATH  also dump each process in the cgroup at PATH\n"
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+"      --stacks-only  write thread stacks but no other memory\n"
+"  -j, --threads=N    dump N processes at a time\n"
 "      --help         display this help and exit\n"
 "      --version      output version information and exit\n",
           me.value().c_str());
@@ -70,6 +87,276 @@ void Usage(const base::FilePath& me) {
   ToolSupport::UsageTail(me);
 }
 
+struct Options {
+  std::string dump_path;
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+  std::vector<std::string> names;
+  std::vector<std::string> cgroups;
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+  unsigned int threads;
+  bool suspend;
+  bool stacks_only;
+};
+
+// A process to dump.
+struct Target {
+  ProcessID pid;
+  std::string dump_path;
+#if BUILDFLAG(IS_APPLE)
+  task_t task;  // weak
+#endif  // BUILDFLAG(IS_APPLE)
+};
+
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+
+// The number of bytes of what’s known about ELF images by build ID that are
+// kept while dumping processes that load the same images.
+constexpr size_t kImageInfoCacheBytes = 256 * 1024;
+
+// The number of seconds for which what’s known about the system is kept. This
+// outlasts any run of this program.
+constexpr double kSystemInfoCacheMaxAge = 60;
+
+// Adds the ID of each process whose command name, as found in /proc/PID/comm,
+// is |name| to |pids|.
+bool AddProcessesNamed(const std::string& name, std::set<ProcessID>* pids) {
+  DirectoryReader reader;
+  if (!reader.Open(base::FilePath("/proc"))) {
+    return false;
+  }
+
+  base::FilePath entry;
+  DirectoryReader::Result result;
+  while ((result = reader.NextFile(&entry)) ==
+         DirectoryReader::Result::kSuccess) {
+    ProcessID pid;
+    if (!StringToNumber(entry.value(), &pid)) {
+      continue;
+    }
+
+    // The process may exit at any time, so failing to read its name isn’t an
+    // error.
+    ScopedFileHandle handle(OpenFileForRead(
+        base::FilePath("/proc").Append(entry.value()).Append("comm")));
+    if (!handle.is_valid()) {
+      continue;
+    }
+    char comm[32];
+    FileOperationResult length = ReadFile(handle.get(), comm, sizeof(comm));
+    if (length <= 0) {
+      continue;
+    }
+    std::string process_name(comm, length);
+    if (process_name.back() == '\n') {
+      process_name.pop_back();
+    }
+    if (process_name == name) {
+      pids->insert(pid);
+    }
+  }
+  return result == DirectoryReader::Result::kNoMoreFiles;
+}
+
+// Adds the ID of each process in the cgroup whose directory is |path| to
+// |pids|.
+bool AddProcessesInCgroup(const std::string& path, std::set<ProcessID>* pids) {
+  std::string contents;
+  if (!LoggingReadEntireFile(base::FilePath(path).Append("cgroup.procs"),
+                             &contents)) {
+    return false;
+  }
+
+  for (const std::string& line : SplitString(contents, '\n')) {
+    if (line.empty()) {
+      continue;
+    }
+    ProcessID pid;
+    if (!StringToNumber(line, &pid)) {
+      LOG(ERROR) << "format error";
+      return false;
+    }
+    pids->insert(pid);
+  }
+  return true;
+}
+
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+
+// Dumps targets on a pool of threads.
+class DumpGenerator {
+ public:
+  DumpGenerator(const Options& options, const std::vector<Target>& targets)
+      : options_(options),
+        targets_(targets),
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+        image_info_cache_(kImageInfoCacheBytes),
+        system_info_cache_(kSystemInfoCacheMaxAge),
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+        next_index_(0),
+        failures_(0) {
+  }
+
+  DumpGenerator(const DumpGenerator&) = delete;
+  DumpGenerator& operator=(const DumpGenerator&) = delete;
+
+  // Dumps every target, returning the number that couldn’t be dumped.
+  size_t Run() {
+    const size_t worker_count =
+        std::max(size_t{1},
+                 std::min(size_t{options_.threads}, targets_.size())) -
+        1;
+    std::vector<std::unique_ptr<GeneratorThread>> workers;
+    for (size_t index = 0; index < worker_count; ++index) {
+      workers.push_back(std::make_unique<GeneratorThread>(this));
+      workers.back()->Start();
+    }
+
+    GenerateDumps();
+
+    for (const auto& worker : workers) {
+      worker->Join();
+    }
+
+    return failures_;
+  }
+
+ private:
+  class GeneratorThread : public Thread {
+   public:
+    explicit GeneratorThread(DumpGenerator* generator)
+        : Thread(), generator_(generator) {}
+
+    GeneratorThread(const GeneratorThread&) = delete;
+    GeneratorThread& operator=(const GeneratorThread&) = delete;
+
+    ~GeneratorThread() override {}
+
+   private:
+    void ThreadMain() override { generator_->GenerateDumps(); }
+
+    DumpGenerator* generator_;  // weak
+  };
+
+  // Dumps targets until there are none left.
+  void GenerateDumps() {
+    size_t index;
+    while ((index = next_index_.fetch_add(1, std::memory_order_relaxed)) <
+           targets_.size()) {
+      if (!GenerateDump(targets_[index])) {
+        ++failures_;
+      }
+    }
+  }
+
+  // Dumps |target|. Everything is done on the calling thread, because on Linux,
+  // a process may only be traced by the thread that attached to it.
+  bool GenerateDump(const Target& target) {
+#if BUILDFLAG(IS_APPLE)
+    if (target.pid == getpid()) {
+      if (options_.suspend) {
+        LOG(ERROR) << "cannot suspend myself";
+        return false;
+      }
+      LOG(WARNING) << "operating on myself";
+    }
+#elif BUILDFLAG(IS_WIN)
+    ScopedKernelHANDLE process(
+        OpenProcess(kXPProcessAllAccess, false, target.pid));
+    if (!process.is_valid()) {
+      PLOG(ERROR) << "could not open process " << target.pid;
+      return false;
+    }
+#endif  // BUILDFLAG(IS_APPLE)
+
+#if BUILDFLAG(IS_APPLE)
+    std::unique_ptr<ScopedTaskSuspend> suspend;
+    if (options_.suspend) {
+      suspend.reset(new ScopedTaskSuspend(target.task));
+    }
+#elif BUILDFLAG(IS_WIN)
+    std::unique_ptr<ScopedProcessSuspend> suspend;
+    if (options_.suspend) {
+      suspend.reset(new ScopedProcessSuspend(process.get()));
+    }
+#endif  // BUILDFLAG(IS_APPLE)
+
+#if BUILDFLAG(IS_APPLE)
+    ProcessSnapshotMac process_snapshot;
+    if (!process_snapshot.Initialize(target.task)) {
+      return false;
+    }
+#elif BUILDFLAG(IS_WIN)
+    ProcessSnapshotWin process_snapshot;
+    if (!process_snapshot.Initialize(process.get(),
+                                     options_.suspend
+                                         ? ProcessSuspensionState::kSuspended
+                                         : ProcessSuspensionState::kRunning,
+                                     0,
+                                     0)) {
+      return false;
+    }
+#elif BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+    // TODO(jperaza): https://crashpad.chromium.org/bug/30.
+    DirectPtraceConnection task;
+    if (!task.Initialize(target.pid)) {
+      return false;
+    }
+    ProcessSnapshotLinux process_snapshot;
+    if (!process_snapshot.Initialize(&task,
+                                     1,
+                                     1,
+                                     nullptr,
+                                     &image_info_cache_,
+                                     &system_info_cache_)) {
+      return false;
+    }
+#endif  // BUILDFLAG(IS_APPLE)
+
+    FileWriter file_writer;
+    base::FilePath dump_path(
+        ToolSupport::CommandLineArgumentToFilePathStringType(
+            target.dump_path));
+    if (!file_writer.Open(dump_path,
+                          FileWriteMode::kTruncateOrCreate,
+                          FilePermissions::kWorldReadable)) {
+      return false;
+    }
+
+    MinidumpSnapshotFilter filter;
+    if (options_.stacks_only) {
+      filter.extra_memory = false;
+      filter.memory_map = false;
+      filter.handles = false;
+      filter.user_streams = false;
+    }
+
+    MinidumpFileWriter minidump;
+    minidump.InitializeFromSnapshot(&process_snapshot, filter);
+    if (!minidump.WriteEverything(&file_writer)) {
+      file_writer.Close();
+      if (unlink(target.dump_path.c_str()) != 0) {
+        PLOG(ERROR) << "unlink";
+      }
+      return false;
+    }
+
+    return true;
+  }
+
+  const Options& options_;
+  const std::vector<Target>& targets_;
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+  ElfImageInfoCache image_info_cache_;
+  SystemInfoCache system_info_cache_;
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+  std::atomic<size_t> next_index_;
+  std::atomic<size_t> failures_;
+};
+
 int GenerateDumpMain(int argc, char* argv[]) {
   const base::FilePath argv0(
       ToolSupport::CommandLineArgumentToFilePathStringType(argv[0]));
@@ -77,34 +364,46 @@ int GenerateDumpMain(int argc, char* argv[]) {
 
   enum OptionFlags {
     // “Short” (single-character) options.
+    kOptionThreads = 'j',
     kOptionOutput = 'o',
     kOptionNoSuspend = 'r',
 
     // Long options without short equivalents.
     kOptionLastChar = 255,
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+    kOptionName,
+    kOptionCgroup,
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+    kOptionStacksOnly,
 
     // Standard options.
     kOptionHelp = -2,
     kOptionVersion = -3,
   };
 
-  struct {
-    std::string dump_path;
-    ProcessID pid;
-    bool suspend;
-  } options = {};
+  Options options = {};
+  options.threads = 1;
   options.suspend = true;
 
   static constexpr option long_options[] = {
       {"no-suspend", no_argument, nullptr, kOptionNoSuspend},
       {"output", required_argument, nullptr, kOptionOutput},
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+      {"name", required_argument, nullptr, kOptionName},
+      {"cgroup", required_argument, nullptr, kOptionCgroup},
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+      {"stacks-only", no_argument, nullptr, kOptionStacksOnly},
+      {"threads", required_argument, nullptr, kOptionThreads},
       {"help", no_argument, nullptr, kOptionHelp},
       {"version", no_argument, nullptr, kOptionVersion},
       {nullptr, 0, nullptr, 0},
   };
 
   int opt;
-  while ((opt = getopt_long(argc, argv, "o:r", long_options, nullptr)) != -1) {
+  while ((opt = getopt_long(argc, argv, "j:o:r", long_options, nullptr)) !=
+         -1) {
     switch (opt) {
       case kOptionOutput:
         options.dump_path = optarg;
@@ -112,6 +411,25 @@ int GenerateDumpMain(int argc, char* argv[]) {
       case kOptionNoSuspend:
         options.suspend = false;
         break;
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+      case kOptionName:
+        options.names.push_back(optarg);
+        break;
+      case kOptionCgroup:
+        options.cgroups.push_back(optarg);
+        break;
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+      case kOptionStacksOnly:
+        options.stacks_only = true;
+        break;
+      case kOptionThreads:
+        if (!StringToNumber(optarg, &options.threads) ||
+            options.threads < 1) {
+          ToolSupport::UsageHint(me, "--threads requires a positive number");
+          return EXIT_FAILURE;
+        }
+        break;
       case kOptionHelp:
         Usage(me);
         return EXIT_SUCCESS;
@@ -126,110 +444,92 @@ int GenerateDumpMain(int argc, char* argv[]) {
   argc -= optind;
   argv += optind;
 
-  if (argc != 1) {
-    ToolSupport::UsageHint(me, "PID is required");
-    return EXIT_FAILURE;
+  std::set<ProcessID> pids;
+  for (int index = 0; index < argc; ++index) {
+    ProcessID pid;
+    if (!StringToNumber(argv[index], &pid) || pid <= 0) {
+      fprintf(stderr,
+              "%" PRFilePath ": invalid PID: %s\n",
+              me.value().c_str(),
+              argv[index]);
+      return EXIT_FAILURE;
+    }
+    pids.insert(pid);
   }
 
-  if (!StringToNumber(argv[0], &options.pid) || options.pid <= 0) {
-    fprintf(stderr,
-            "%" PRFilePath ": invalid PID: %s\n",
-            me.value().c_str(),
-            argv[0]);
-    return EXIT_FAILURE;
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+  // Processes found by name or cgroup never include this one, which may match
+  // but can’t be traced by itself.
+  std::set<ProcessID> selected_pids;
+  for (const std::string& name : options.names) {
+    if (!AddProcessesNamed(name, &selected_pids)) {
+      return EXIT_FAILURE;
+    }
+  }
+  for (const std::string& cgroup : options.cgroups) {
+    if (!AddProcessesInCgroup(cgroup, &selected_pids)) {
+      return EXIT_FAILURE;
+    }
   }
+  selected_pids.erase(getpid());
+  pids.insert(selected_pids.begin(), selected_pids.end());
 
-#if BUILDFLAG(IS_APPLE)
-  task_t task = TaskForPID(options.pid);
-  if (task == TASK_NULL) {
+  if (pids.empty() && (!options.names.empty() || !options.cgroups.empty())) {
+    fprintf(
+        stderr, "%" PRFilePath ": no processes found\n", me.value().c_str());
     return EXIT_FAILURE;
   }
-  base::mac::ScopedMachSendRight task_owner(task);
-
-  // This tool may have been installed as a setuid binary so that TaskForPID()
-  // could succeed. Drop any privileges now that they’re no longer necessary.
-  DropPrivileges();
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
 
-  if (options.pid == getpid()) {
-    if (options.suspend) {
-      LOG(ERROR) << "cannot suspend myself";
-      return EXIT_FAILURE;
-    }
-    LOG(WARNING) << "operating on myself";
-  }
-#elif BUILDFLAG(IS_WIN)
-  ScopedKernelHANDLE process(
-      OpenProcess(kXPProcessAllAccess, false, options.pid));
-  if (!process.is_valid()) {
-    PLOG(ERROR) << "could not open process " << options.pid;
+  if (pids.empty()) {
+    ToolSupport::UsageHint(me, "PID is required");
     return EXIT_FAILURE;
   }
-#endif  // BUILDFLAG(IS_APPLE)
 
-  if (options.dump_path.empty()) {
-    options.dump_path = base::StringPrintf("minidump.%" PRI_PROCESS_ID,
-                                           options.pid);
+  if (!options.dump_path.empty() && pids.size() > 1) {
+    ToolSupport::UsageHint(me, "--output requires a single PID");
+    return EXIT_FAILURE;
   }
 
-  {
-#if BUILDFLAG(IS_APPLE)
-    std::unique_ptr<ScopedTaskSuspend> suspend;
-    if (options.suspend) {
-      suspend.reset(new ScopedTaskSuspend(task));
-    }
-#elif BUILDFLAG(IS_WIN)
-    std::unique_ptr<ScopedProcessSuspend> suspend;
-    if (options.suspend) {
-      suspend.reset(new ScopedProcessSuspend(process.get()));
-    }
-#endif  // BUILDFLAG(IS_APPLE)
+  std::vector<Target> targets;
+  for (ProcessID pid : pids) {
+    Target target = {};
+    target.pid = pid;
+    target.dump_path =
+        options.dump_path.empty()
+            ? base::StringPrintf("minidump.%" PRI_PROCESS_ID, pid)
+            : options.dump_path;
+    targets.push_back(target);
+  }
 
 #if BUILDFLAG(IS_APPLE)
-    ProcessSnapshotMac process_snapshot;
-    if (!process_snapshot.Initialize(task)) {
-      return EXIT_FAILURE;
-    }
-#elif BUILDFLAG(IS_WIN)
-    ProcessSnapshotWin process_snapshot;
-    if (!process_snapshot.Initialize(process.get(),
-                                     options.suspend
-                                         ? ProcessSuspensionState::kSuspended
-                                         : ProcessSuspensionState::kRunning,
-                                     0,
-                                     0)) {
-      return EXIT_FAILURE;
-    }
-#elif BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
-    // TODO(jperaza): https://crashpad.chromium.org/bug/30.
-    DirectPtraceConnection task;
-    if (!task.Initialize(options.pid)) {
-      return EXIT_FAILURE;
-    }
-    ProcessSnapshotLinux process_snapshot;
-    if (!process_snapshot.Initialize(&task)) {
+  // Every task port is obtained before any privileges are dropped.
+  std::vector<base::mac::ScopedMachSendRight> task_owners;
+  for (Target& target : targets) {
+    target.task = TaskForPID(target.pid);
+    if (target.task == TASK_NULL) {
       return EXIT_FAILURE;
     }
-#endif  // BUILDFLAG(IS_APPLE)
+    task_owners.emplace_back(target.task);
+  }
 
-    FileWriter file_writer;
-    base::FilePath dump_path(
-        ToolSupport::CommandLineArgumentToFilePathStringType(
-            options.dump_path));
-    if (!file_writer.Open(dump_path,
-                          FileWriteMode::kTruncateOrCreate,
-                          FilePermissions::kWorldReadable)) {
-      return EXIT_FAILURE;
-    }
+  // This tool may have been installed as a setuid binary so that TaskForPID()
+  // could succeed. Drop any privileges now that they’re no longer necessary.
+  DropPrivileges();
+#endif  // BUILDFLAG(IS_APPLE)
 
-    MinidumpFileWriter minidump;
-    minidump.InitializeFromSnapshot(&process_snapshot);
-    if (!minidump.WriteEverything(&file_writer)) {
-      file_writer.Close();
-      if (unlink(options.dump_path.c_str()) != 0) {
-        PLOG(ERROR) << "unlink";
-      }
-      return EXIT_FAILURE;
+  DumpGenerator generator(options, targets);
+  size_t failures = generator.Run();
+  if (failures) {
+    if (targets.size() > 1) {
+      fprintf(stderr,
+              "%" PRFilePath ": %zu of %zu processes not dumped\n",
+              me.value().c_str(),
+              failures,
+              targets.size());
     }
+    return EXIT_FAILURE;
   }
 
   return EXIT_SUCCESS;
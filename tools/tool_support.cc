@@ -110,4 +110,42 @@ std::string ToolSupport::FilePathToCommandLineArgument(
 #endif  // BUILDFLAG(IS_POSIX)
 }
 
+// static
+std::string ToolSupport::JSONString(const std::string& string) {
+  std::string json("\"");
+  for (char c : string) {
+    switch (c) {
+      case '"':
+        json.append("\\\"");
+        break;
+      case '\\':
+        json.append("\\\\");
+        break;
+      case '\n':
+        json.append("\\n");
+        break;
+      case '\r':
+        json.append("\\r");
+        break;
+      case '\t':
+        json.append("\\t");
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          char escape[7];
+          snprintf(escape,
+                   sizeof(escape),
+                   "\\u%04x",
+                   static_cast<unsigned char>(c));
+          json.append(escape);
+        } else {
+          json.push_back(c);
+        }
+        break;
+    }
+  }
+  json.push_back('"');
+  return json;
+}
+
 }  // namespace crashpad
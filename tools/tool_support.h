@@ -86,6 +86,12 @@ class ToolSupport {
   //! Wmain().
   static std::string FilePathToCommandLineArgument(
       const base::FilePath& file_path);
+
+  //! \brief Returns \a string as a quoted JSON string.
+  //!
+  //! Bytes that aren’t control characters are passed through, so the result is
+  //! only valid UTF-8 if \a string is.
+  static std::string JSONString(const std::string& string);
 };
 
 }  // namespace crashpad
@@ -1,22 +1,68 @@
 #include "crash_loop_detection.h"
 
-#include <ctime>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
 
-#include <deque>
+#include <algorithm>
+#include <ctime>
 #include <fstream>
-#include <limits>
-#include <sstream>
 #include <string>
 #include <vector>
 
+#include "base/logging.h"
 #include "build/build_config.h"
+#include "util/file/file_io.h"
+#include "util/file/filesystem.h"
+#include "util/stdlib/string_number_conversion.h"
 #include "util/string/split_string.h"
 
+#if BUILDFLAG(IS_POSIX)
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "base/posix/eintr_wrapper.h"
+#include "util/posix/scoped_mmap.h"
+#endif  // BUILDFLAG(IS_POSIX)
+
 namespace crashpad {
 namespace backtrace {
 namespace crash_loop_detection {
 
-static auto CsvFileName(const base::FilePath& database)
+namespace {
+
+// The state is kept in a fixed-size file: a RingHeader followed by capacity
+// RingRecord slots. The record with sequence number s is always in slot
+// (s - 1) % capacity, so appending a record or marking one as crashed
+// rewrites exactly one slot in place. Creating, resizing or repairing the ring
+// writes a new file and renames it over the old one, so the ring is never left
+// partially written. Because the ring may be replaced, access to it is
+// serialized by locking a separate lock file.
+
+constexpr uint32_t kRingMagic = 0x646c6363;  // 'ccld'
+constexpr uint32_t kRingVersion = 1;
+
+struct RingHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t capacity;
+  uint32_t reserved;
+};
+
+struct RingRecord {
+  // Starts at 1 for the first record appended, and is 0 for an unused slot.
+  uint64_t sequence;
+  UUID uuid;
+  int64_t start_time;
+  int64_t crash_time;
+  uint32_t crashed;
+  uint32_t reserved;
+};
+
+static_assert(sizeof(RingHeader) == 16, "RingHeader size");
+static_assert(sizeof(RingRecord) == 48, "RingRecord size");
+
+base::FilePath::StringType CsvFileName(const base::FilePath& database)
 {
 #if BUILDFLAG(IS_WIN)
   return database.value() + L"/crash_loop_detection.csv";
@@ -25,99 +71,353 @@ static auto CsvFileName(const base::FilePath& database)
 #endif
 }
 
-using CrashData = std::deque<std::vector<std::string>>;
+base::FilePath RingFilePath(const base::FilePath& database)
+{
+  return database.Append(FILE_PATH_LITERAL("crash_loop_detection.ring"));
+}
 
-static CrashData LoadCrashData(const base::FilePath& database,
-                               int max_entries = std::numeric_limits<int>::max())
+base::FilePath NewRingFilePath(const base::FilePath& database)
 {
-  CrashData lines;
-  auto csv_file = CsvFileName(database);
-  std::ifstream f(csv_file);
+  return database.Append(FILE_PATH_LITERAL("crash_loop_detection.ring.new"));
+}
+
+base::FilePath LockFilePath(const base::FilePath& database)
+{
+  return database.Append(FILE_PATH_LITERAL("crash_loop_detection.lock"));
+}
+
+size_t SlotOffset(uint32_t slot)
+{
+  return sizeof(RingHeader) + slot * sizeof(RingRecord);
+}
+
+size_t RingFileSize(uint32_t capacity)
+{
+  return SlotOffset(capacity);
+}
+
+// Reads the records of a crash_loop_detection.csv written by earlier
+// versions, oldest first. Each line is “start_time,uuid,crashed” with an
+// optional “,crash_time”.
+std::vector<RingRecord> ImportCsv(const base::FilePath& database)
+{
+  std::vector<RingRecord> records;
+  std::ifstream f(CsvFileName(database));
 
   for (std::string line; std::getline(f, line);) {
-    if (line.size() && line.back() == '\n')
-      line.pop_back();
-    lines.push_back(SplitString(line, ','));
-    if (lines.size() > max_entries)
-      lines.pop_front();
+    std::vector<std::string> fields = SplitString(line, ',');
+    if (fields.size() < 3)
+      continue;
+
+    RingRecord record = {};
+    long long start_time;
+    if (!StringToNumber(fields[0], &start_time) ||
+        !record.uuid.InitializeFromString(fields[1])) {
+      continue;
+    }
+    record.start_time = start_time;
+    record.crashed = fields[2] != "0";
+
+    long long crash_time;
+    if (fields.size() > 3 && StringToNumber(fields[3], &crash_time))
+      record.crash_time = crash_time;
+
+    records.push_back(record);
   }
-  return lines;
+  return records;
 }
 
-static bool WriteCrashData(const base::FilePath& database,
-                           const CrashData& data)
-{
-  std::deque<std::string> lines;
-  std::ofstream f(CsvFileName(database), std::ios::trunc);
+// An open and locked crash loop detection ring file.
+class RingFile {
+ public:
+  RingFile() = default;
 
-  if (!f)
-    return false;
+  RingFile(const RingFile&) = delete;
+  RingFile& operator=(const RingFile&) = delete;
+
+  ~RingFile() = default;
+
+  // Opens the ring in database, importing crash_loop_detection.csv if there is
+  // no valid ring yet. If capacity is not 0, a missing ring is created with
+  // that many slots, and an existing ring with a different number of slots is
+  // resized, keeping its newest records. If capacity is 0, a missing ring is
+  // only created to import a CSV file, and an existing ring is used as is.
+  bool Open(const base::FilePath& database, uint32_t capacity)
+  {
+    const base::FilePath csv_path(CsvFileName(database));
+    const bool csv_exists = IsRegularFile(csv_path);
+    const base::FilePath path = RingFilePath(database);
+    if (capacity == 0 && !csv_exists && !IsRegularFile(path))
+      return false;
+
+    lock_file_.reset(LoggingOpenFileForReadAndWrite(
+        LockFilePath(database),
+        FileWriteMode::kReuseOrCreate,
+        FilePermissions::kOwnerOnly));
+    if (!lock_file_.is_valid() ||
+        LoggingLockFile(lock_file_.get(),
+                        FileLocking::kExclusive,
+                        FileLockingBlocking::kBlocking) !=
+            FileLockingResult::kSuccess) {
+      return false;
+    }
+
+    file_.reset(OpenFileForReadAndWrite(
+        path, FileWriteMode::kReuseOrFail, FilePermissions::kOwnerOnly));
+    RingHeader header;
+    bool valid = false;
+    if (file_.is_valid()) {
+      const FileOffset size = LoggingFileSizeByHandle(file_.get());
+      valid = size >= static_cast<FileOffset>(sizeof(header)) &&
+              LoggingReadFileExactly(file_.get(), &header, sizeof(header)) &&
+              header.magic == kRingMagic && header.version == kRingVersion &&
+              header.capacity > 0 &&
+              size == static_cast<FileOffset>(RingFileSize(header.capacity));
+    }
 
-  for (const auto& vec : data) {
-    std::stringstream str;
-    for (const auto& el : vec)
-      str << el << ',';
-    auto line = str.str();
-    if (line.size()) {
-      if (&vec == &data.back())
-        line.pop_back();
-      else
-        line.back() = '\n';
+    if (!valid) {
+      if (capacity == 0 && !csv_exists)
+        return false;
+
+      std::vector<RingRecord> records;
+      if (csv_exists)
+        records = ImportCsv(database);
+      if (!Rebuild(
+              database,
+              records,
+              capacity != 0 ? capacity : crash_loop_detection_max_entries)) {
+        return false;
+      }
+    } else if (capacity != 0 && header.capacity != capacity) {
+      capacity_ = header.capacity;
+      if (!Map() || !Rebuild(database, Records(), capacity))
+        return false;
+    } else {
+      capacity_ = header.capacity;
     }
-    f << line;
+
+    // The CSV file is only removed once the ring holding its records is in
+    // place. If that was interrupted, the CSV file is removed now.
+    if (csv_exists)
+      LoggingRemoveFile(csv_path);
+
+    return Map();
   }
 
-  return true;
-}
+  uint32_t capacity() const { return capacity_; }
+
+  const RingRecord& Slot(uint32_t slot) const
+  {
+    DCHECK_LT(slot, capacity_);
+    return records_[slot];
+  }
+
+  // Returns the records in use, oldest first.
+  std::vector<RingRecord> Records() const
+  {
+    std::vector<RingRecord> records;
+    for (uint32_t slot = 0; slot < capacity_; ++slot) {
+      if (records_[slot].sequence != 0)
+        records.push_back(records_[slot]);
+    }
+    std::sort(records.begin(),
+              records.end(),
+              [](const RingRecord& lhs, const RingRecord& rhs) {
+                return lhs.sequence < rhs.sequence;
+              });
+    return records;
+  }
+
+  // Returns the highest sequence number in use, or 0 if the ring is empty.
+  uint64_t LastSequence() const
+  {
+    uint64_t sequence = 0;
+    for (uint32_t slot = 0; slot < capacity_; ++slot)
+      sequence = std::max(sequence, records_[slot].sequence);
+    return sequence;
+  }
+
+  // Writes record into slot and flushes it to disk.
+  bool WriteSlot(uint32_t slot, const RingRecord& record)
+  {
+    DCHECK_LT(slot, capacity_);
+    const size_t offset = SlotOffset(slot);
+
+#if BUILDFLAG(IS_POSIX)
+    // The mapping shares the page cache with the file, so it observes the
+    // write without being remapped.
+    if (HANDLE_EINTR(pwrite(file_.get(), &record, sizeof(record), offset)) !=
+        static_cast<ssize_t>(sizeof(record))) {
+      PLOG(ERROR) << "pwrite";
+      return false;
+    }
+    if (msync(mapping_.addr(), mapping_.len(), MS_SYNC) != 0) {
+      PLOG(ERROR) << "msync";
+      return false;
+    }
+#else
+    if (LoggingSeekFile(file_.get(), offset, SEEK_SET) !=
+            static_cast<FileOffset>(offset) ||
+        !LoggingWriteFile(file_.get(), &record, sizeof(record)) ||
+        !LoggingSyncFile(file_.get())) {
+      return false;
+    }
+    contents_[slot] = record;
+#endif  // BUILDFLAG(IS_POSIX)
+    return true;
+  }
+
+ private:
+  // Replaces the ring with one of capacity slots holding the newest of
+  // records, renumbered from 1. The old ring remains until the new one has been
+  // written in full and synced.
+  bool Rebuild(const base::FilePath& database,
+               const std::vector<RingRecord>& records,
+               uint32_t capacity)
+  {
+    std::vector<uint8_t> contents(RingFileSize(capacity));
+    RingHeader header = {};
+    header.magic = kRingMagic;
+    header.version = kRingVersion;
+    header.capacity = capacity;
+    memcpy(contents.data(), &header, sizeof(header));
+
+    const size_t keep = std::min<size_t>(records.size(), capacity);
+    for (size_t index = 0; index < keep; ++index) {
+      RingRecord record = records[records.size() - keep + index];
+      record.sequence = index + 1;
+      memcpy(&contents[SlotOffset(static_cast<uint32_t>(index))],
+             &record,
+             sizeof(record));
+    }
+
+    const base::FilePath new_path = NewRingFilePath(database);
+    {
+      ScopedFileHandle new_file(
+          LoggingOpenFileForWrite(new_path,
+                                  FileWriteMode::kTruncateOrCreate,
+                                  FilePermissions::kOwnerOnly));
+      if (!new_file.is_valid() ||
+          !LoggingWriteFile(new_file.get(), contents.data(), contents.size()) ||
+          !LoggingSyncFile(new_file.get())) {
+        return false;
+      }
+    }
+
+    // The old ring is closed before it’s replaced, as Windows requires.
+#if BUILDFLAG(IS_POSIX)
+    mapping_.Reset();
+#endif  // BUILDFLAG(IS_POSIX)
+    records_ = nullptr;
+    file_.reset();
+
+    const base::FilePath path = RingFilePath(database);
+    if (!MoveFileOrDirectory(new_path, path))
+      return false;
+
+    file_.reset(LoggingOpenFileForReadAndWrite(
+        path, FileWriteMode::kReuseOrFail, FilePermissions::kOwnerOnly));
+    if (!file_.is_valid())
+      return false;
+
+    capacity_ = capacity;
+    return true;
+  }
+
+  // Makes records_ refer to the slots currently in the file.
+  bool Map()
+  {
+#if BUILDFLAG(IS_POSIX)
+    if (!mapping_.ResetMmap(nullptr,
+                            RingFileSize(capacity_),
+                            PROT_READ,
+                            MAP_SHARED,
+                            file_.get(),
+                            0)) {
+      return false;
+    }
+    records_ = reinterpret_cast<const RingRecord*>(
+        mapping_.addr_as<const uint8_t*>() + sizeof(RingHeader));
+#else
+    contents_.resize(capacity_);
+    if (LoggingSeekFile(file_.get(), sizeof(RingHeader), SEEK_SET) !=
+            static_cast<FileOffset>(sizeof(RingHeader)) ||
+        !LoggingReadFileExactly(file_.get(),
+                                contents_.data(),
+                                capacity_ * sizeof(RingRecord))) {
+      return false;
+    }
+    records_ = contents_.data();
+#endif  // BUILDFLAG(IS_POSIX)
+    return true;
+  }
+
+  ScopedFileHandle lock_file_;
+  ScopedFileHandle file_;
+#if BUILDFLAG(IS_POSIX)
+  ScopedMmap mapping_;
+#else
+  std::vector<RingRecord> contents_;
+#endif  // BUILDFLAG(IS_POSIX)
+  const RingRecord* records_ = nullptr;
+  uint32_t capacity_ = 0;
+};
+
+}  // namespace
 
 bool CrashLoopDetectionAppend(const base::FilePath& database,
                               UUID uuid,
                               int max_entries)
 {
-  auto lines = LoadCrashData(database, max_entries - 1);
+  if (max_entries <= 0) {
+    LOG(ERROR) << "invalid max_entries " << max_entries;
+    return false;
+  }
 
-  time_t current_time = time(nullptr);
-  std::vector<std::string> new_line = {
-      std::to_string(current_time), uuid.ToString(), "0"};
-  lines.push_back(std::move(new_line));
+  RingFile ring;
+  if (!ring.Open(database, static_cast<uint32_t>(max_entries)))
+    return false;
 
-  return WriteCrashData(database, lines);
+  RingRecord record = {};
+  record.sequence = ring.LastSequence() + 1;
+  record.uuid = uuid;
+  record.start_time = time(nullptr);
+  return ring.WriteSlot((record.sequence - 1) % ring.capacity(), record);
 }
 
 bool CrashLoopDetectionSetCrashed(const base::FilePath& database, UUID uuid)
 {
-  auto lines = LoadCrashData(database);
-  bool success{};
-  std::string uuid_str = uuid.ToString();
+  RingFile ring;
+  if (!ring.Open(database, 0))
+    return false;
 
-  for (auto& line : lines) {
-    if (line.size() < 3)
+  bool success{};
+  for (uint32_t slot = 0; slot < ring.capacity(); ++slot) {
+    RingRecord record = ring.Slot(slot);
+    if (record.sequence == 0 || record.uuid != uuid)
       continue;
-    if (line[1] == uuid_str) {
-      success = true;
-      line[2] = "1";
-      if (line.size() > 3)
-        line[3] = std::to_string(time(nullptr));
-      else
-        line.push_back(std::to_string(time(nullptr)));
-    }
+
+    record.crashed = 1;
+    record.crash_time = time(nullptr);
+    if (!ring.WriteSlot(slot, record))
+      return false;
+    success = true;
   }
 
-  return success && WriteCrashData(database, lines);
+  return success;
 }
 
 int ConsecutiveCrashesCount(const base::FilePath& database)
 {
-  auto lines = LoadCrashData(database);
+  RingFile ring;
+  if (!ring.Open(database, 0))
+    return 0;
 
-  auto is_crashing = [](const auto& line) {
-    if (line.size() >= 3 && line[2] != "0")
-      return false;
-    return true;
-  };
+  const std::vector<RingRecord> records = ring.Records();
+  auto is_running = [](const RingRecord& record) { return !record.crashed; };
 
-  auto it = std::find_if(lines.rbegin(), lines.rend(), is_crashing);
-  return std::distance(lines.rbegin(), it);
+  auto it = std::find_if(records.rbegin(), records.rend(), is_running);
+  return static_cast<int>(std::distance(records.rbegin(), it));
 }
 
 }  // namespace crash_loop_detection
@@ -0,0 +1,269 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/backtrace/crash_loop_detection.h"
+
+#include <string>
+#include <vector>
+
+#include "base/files/file_path.h"
+#include "gtest/gtest.h"
+#include "test/scoped_temp_dir.h"
+#include "util/file/file_io.h"
+#include "util/file/filesystem.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+using backtrace::crash_loop_detection::ConsecutiveCrashesCount;
+using backtrace::crash_loop_detection::CrashLoopDetectionAppend;
+using backtrace::crash_loop_detection::CrashLoopDetectionSetCrashed;
+
+// The sizes of the ring file’s header and of each of its slots.
+constexpr FileOffset kHeaderSize = 16;
+constexpr FileOffset kSlotSize = 48;
+
+class CrashLoopDetection : public testing::Test {
+ protected:
+  CrashLoopDetection() : temp_dir_() {}
+
+  const base::FilePath& database() const { return temp_dir_.path(); }
+
+  base::FilePath RingPath() const {
+    return database().Append(FILE_PATH_LITERAL("crash_loop_detection.ring"));
+  }
+
+  base::FilePath CsvPath() const {
+    return database().Append(FILE_PATH_LITERAL("crash_loop_detection.csv"));
+  }
+
+  // Returns the size of the ring file, or -1 if it can’t be opened.
+  FileOffset RingSize() const {
+    ScopedFileHandle file(LoggingOpenFileForRead(RingPath()));
+    return file.is_valid() ? LoggingFileSizeByHandle(file.get()) : -1;
+  }
+
+  // Replaces the ring file with contents.
+  void WriteRing(const std::string& contents) {
+    ScopedFileHandle file(
+        LoggingOpenFileForWrite(RingPath(),
+                                FileWriteMode::kTruncateOrCreate,
+                                FilePermissions::kOwnerOnly));
+    ASSERT_TRUE(file.is_valid());
+    ASSERT_TRUE(LoggingWriteFile(file.get(), contents.data(), contents.size()));
+  }
+
+  // Appends count new records with max_entries, returning their UUIDs.
+  std::vector<UUID> Append(size_t count, int max_entries) {
+    std::vector<UUID> uuids(count);
+    for (UUID& uuid : uuids) {
+      EXPECT_TRUE(uuid.InitializeWithNew());
+      EXPECT_TRUE(CrashLoopDetectionAppend(database(), uuid, max_entries));
+    }
+    return uuids;
+  }
+
+ private:
+  ScopedTempDir temp_dir_;
+};
+
+TEST_F(CrashLoopDetection, Empty) {
+  // Nothing is created by only reading.
+  EXPECT_EQ(ConsecutiveCrashesCount(database()), 0);
+
+  UUID uuid;
+  ASSERT_TRUE(uuid.InitializeWithNew());
+  EXPECT_FALSE(CrashLoopDetectionSetCrashed(database(), uuid));
+  EXPECT_FALSE(IsRegularFile(RingPath()));
+
+  EXPECT_FALSE(CrashLoopDetectionAppend(database(), uuid, 0));
+  EXPECT_FALSE(IsRegularFile(RingPath()));
+}
+
+TEST_F(CrashLoopDetection, SetCrashedAndConsecutiveCrashesCount) {
+  const std::vector<UUID> uuids = Append(4, 10);
+  EXPECT_EQ(RingSize(), kHeaderSize + 10 * kSlotSize);
+  EXPECT_EQ(ConsecutiveCrashesCount(database()), 0);
+
+  UUID unknown;
+  ASSERT_TRUE(unknown.InitializeWithNew());
+  EXPECT_FALSE(CrashLoopDetectionSetCrashed(database(), unknown));
+
+  // Only crashes since the last run that didn’t crash are counted.
+  ASSERT_TRUE(CrashLoopDetectionSetCrashed(database(), uuids[0]));
+  EXPECT_EQ(ConsecutiveCrashesCount(database()), 0);
+  ASSERT_TRUE(CrashLoopDetectionSetCrashed(database(), uuids[3]));
+  EXPECT_EQ(ConsecutiveCrashesCount(database()), 1);
+  ASSERT_TRUE(CrashLoopDetectionSetCrashed(database(), uuids[2]));
+  EXPECT_EQ(ConsecutiveCrashesCount(database()), 2);
+
+  // Marking a record as crashed again changes nothing.
+  ASSERT_TRUE(CrashLoopDetectionSetCrashed(database(), uuids[2]));
+  EXPECT_EQ(ConsecutiveCrashesCount(database()), 2);
+
+  ASSERT_TRUE(CrashLoopDetectionSetCrashed(database(), uuids[1]));
+  EXPECT_EQ(ConsecutiveCrashesCount(database()), 4);
+
+  // A new run that hasn’t crashed ends the streak.
+  Append(1, 10);
+  EXPECT_EQ(ConsecutiveCrashesCount(database()), 0);
+}
+
+TEST_F(CrashLoopDetection, AppendWrapsAround) {
+  const std::vector<UUID> uuids = Append(7, 3);
+  EXPECT_EQ(RingSize(), kHeaderSize + 3 * kSlotSize);
+
+  // Only the newest records are kept.
+  for (size_t index = 0; index < 4; ++index) {
+    EXPECT_FALSE(CrashLoopDetectionSetCrashed(database(), uuids[index]))
+        << index;
+  }
+  for (size_t index = 4; index < 7; ++index) {
+    EXPECT_TRUE(CrashLoopDetectionSetCrashed(database(), uuids[index]))
+        << index;
+  }
+  EXPECT_EQ(ConsecutiveCrashesCount(database()), 3);
+
+  // The newest record, not the one in the first slot, is the most recent.
+  const std::vector<UUID> more = Append(1, 3);
+  EXPECT_EQ(ConsecutiveCrashesCount(database()), 0);
+  ASSERT_TRUE(CrashLoopDetectionSetCrashed(database(), more[0]));
+  EXPECT_EQ(ConsecutiveCrashesCount(database()), 3);
+  EXPECT_FALSE(CrashLoopDetectionSetCrashed(database(), uuids[4]));
+}
+
+TEST_F(CrashLoopDetection, ImportCsv) {
+  UUID uuids[3];
+  for (UUID& uuid : uuids) {
+    ASSERT_TRUE(uuid.InitializeWithNew());
+  }
+  const std::string csv = "100," + uuids[0].ToString() + ",1,150\n" +
+                          "not a record\n" +
+                          "200," + uuids[1].ToString() + ",0\n" +
+                          "300," + uuids[2].ToString() + ",1,350\n";
+  {
+    ScopedFileHandle file(LoggingOpenFileForWrite(
+        CsvPath(), FileWriteMode::kCreateOrFail, FilePermissions::kOwnerOnly));
+    ASSERT_TRUE(file.is_valid());
+    ASSERT_TRUE(LoggingWriteFile(file.get(), csv.data(), csv.size()));
+  }
+
+  // Reading imports the CSV file into a ring of the default size, and removes
+  // it.
+  EXPECT_EQ(ConsecutiveCrashesCount(database()), 1);
+  EXPECT_FALSE(IsRegularFile(CsvPath()));
+  EXPECT_EQ(RingSize(),
+            kHeaderSize +
+                backtrace::crash_loop_detection::
+                        crash_loop_detection_max_entries *
+                    kSlotSize);
+
+  ASSERT_TRUE(CrashLoopDetectionSetCrashed(database(), uuids[1]));
+  EXPECT_EQ(ConsecutiveCrashesCount(database()), 3);
+
+  // Appending keeps the imported records.
+  const std::vector<UUID> more = Append(1, 10);
+  ASSERT_TRUE(CrashLoopDetectionSetCrashed(database(), more[0]));
+  EXPECT_EQ(ConsecutiveCrashesCount(database()), 4);
+}
+
+TEST_F(CrashLoopDetection, ImportCsvOnAppend) {
+  UUID uuid;
+  ASSERT_TRUE(uuid.InitializeWithNew());
+  const std::string csv = "100," + uuid.ToString() + ",1\n";
+  {
+    ScopedFileHandle file(LoggingOpenFileForWrite(
+        CsvPath(), FileWriteMode::kCreateOrFail, FilePermissions::kOwnerOnly));
+    ASSERT_TRUE(file.is_valid());
+    ASSERT_TRUE(LoggingWriteFile(file.get(), csv.data(), csv.size()));
+  }
+
+  const std::vector<UUID> uuids = Append(1, 5);
+  EXPECT_FALSE(IsRegularFile(CsvPath()));
+  EXPECT_EQ(RingSize(), kHeaderSize + 5 * kSlotSize);
+  ASSERT_TRUE(CrashLoopDetectionSetCrashed(database(), uuids[0]));
+  EXPECT_EQ(ConsecutiveCrashesCount(database()), 2);
+}
+
+TEST_F(CrashLoopDetection, Resize) {
+  const std::vector<UUID> uuids = Append(3, 3);
+  ASSERT_TRUE(CrashLoopDetectionSetCrashed(database(), uuids[1]));
+  ASSERT_TRUE(CrashLoopDetectionSetCrashed(database(), uuids[2]));
+  EXPECT_EQ(ConsecutiveCrashesCount(database()), 2);
+
+  // Growing keeps every record.
+  const std::vector<UUID> grown = Append(1, 6);
+  EXPECT_EQ(RingSize(), kHeaderSize + 6 * kSlotSize);
+  EXPECT_EQ(ConsecutiveCrashesCount(database()), 0);
+  ASSERT_TRUE(CrashLoopDetectionSetCrashed(database(), grown[0]));
+  EXPECT_EQ(ConsecutiveCrashesCount(database()), 3);
+  ASSERT_TRUE(CrashLoopDetectionSetCrashed(database(), uuids[0]));
+  EXPECT_EQ(ConsecutiveCrashesCount(database()), 4);
+
+  // Shrinking keeps the newest records.
+  const std::vector<UUID> shrunk = Append(1, 2);
+  EXPECT_EQ(RingSize(), kHeaderSize + 2 * kSlotSize);
+  EXPECT_FALSE(CrashLoopDetectionSetCrashed(database(), uuids[2]));
+  ASSERT_TRUE(CrashLoopDetectionSetCrashed(database(), shrunk[0]));
+  EXPECT_EQ(ConsecutiveCrashesCount(database()), 2);
+
+  // The rebuilt rings were moved into place.
+  EXPECT_FALSE(IsRegularFile(
+      database().Append(FILE_PATH_LITERAL("crash_loop_detection.ring.new"))));
+}
+
+TEST_F(CrashLoopDetection, TruncatedRing) {
+  const std::vector<UUID> uuids = Append(2, 4);
+  ASSERT_TRUE(CrashLoopDetectionSetCrashed(database(), uuids[1]));
+  EXPECT_EQ(ConsecutiveCrashesCount(database()), 1);
+
+  ASSERT_NO_FATAL_FAILURE(WriteRing(std::string(kHeaderSize + kSlotSize, 1)));
+
+  // A ring that’s not the expected size isn’t read.
+  EXPECT_EQ(ConsecutiveCrashesCount(database()), 0);
+  EXPECT_FALSE(CrashLoopDetectionSetCrashed(database(), uuids[0]));
+
+  // Appending replaces it with a new ring.
+  const std::vector<UUID> more = Append(1, 4);
+  EXPECT_EQ(RingSize(), kHeaderSize + 4 * kSlotSize);
+  EXPECT_FALSE(CrashLoopDetectionSetCrashed(database(), uuids[1]));
+  ASSERT_TRUE(CrashLoopDetectionSetCrashed(database(), more[0]));
+  EXPECT_EQ(ConsecutiveCrashesCount(database()), 1);
+}
+
+TEST_F(CrashLoopDetection, CorruptRing) {
+  Append(2, 4);
+
+  // The file is the right size for a ring of 4, but its header is garbage.
+  ASSERT_NO_FATAL_FAILURE(
+      WriteRing(std::string(kHeaderSize + 4 * kSlotSize, '\xff')));
+  EXPECT_EQ(ConsecutiveCrashesCount(database()), 0);
+
+  const std::vector<UUID> more = Append(1, 4);
+  EXPECT_EQ(RingSize(), kHeaderSize + 4 * kSlotSize);
+  EXPECT_EQ(ConsecutiveCrashesCount(database()), 0);
+  ASSERT_TRUE(CrashLoopDetectionSetCrashed(database(), more[0]));
+  EXPECT_EQ(ConsecutiveCrashesCount(database()), 1);
+
+  // An empty file is replaced too.
+  ASSERT_NO_FATAL_FAILURE(WriteRing(std::string()));
+  EXPECT_EQ(ConsecutiveCrashesCount(database()), 0);
+  Append(1, 4);
+  EXPECT_EQ(RingSize(), kHeaderSize + 4 * kSlotSize);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
@@ -0,0 +1,164 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/file/async_file_writer.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "base/check_op.h"
+#include "base/logging.h"
+#include "util/thread/thread.h"
+
+namespace crashpad {
+
+class AsyncFileWriter::WriterThread final : public Thread {
+ public:
+  explicit WriterThread(AsyncFileWriter* writer) : Thread(), writer_(writer) {}
+
+  WriterThread(const WriterThread&) = delete;
+  WriterThread& operator=(const WriterThread&) = delete;
+
+  ~WriterThread() override {}
+
+ private:
+  void ThreadMain() override { writer_->WriterThreadMain(); }
+
+  AsyncFileWriter* writer_;  // weak
+};
+
+AsyncFileWriter::AsyncFileWriter(FileWriterInterface* file_writer,
+                                 size_t buffer_size)
+    : mutex_(),
+      condition_(),
+      filling_(),
+      writing_(),
+      buffer_size_(buffer_size),
+      file_writer_(file_writer),
+      writer_thread_(),
+      failed_(false),
+      stopping_(false) {
+  DCHECK_GT(buffer_size_, 0u);
+  filling_.reserve(buffer_size_);
+  writing_.reserve(buffer_size_);
+
+  writer_thread_ = std::make_unique<WriterThread>(this);
+  writer_thread_->Start();
+}
+
+AsyncFileWriter::~AsyncFileWriter() {
+  DCHECK(filling_.empty());
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  condition_.notify_all();
+  writer_thread_->Join();
+}
+
+bool AsyncFileWriter::Flush() {
+  if (!filling_.empty() && !HandOff()) {
+    return false;
+  }
+  return WaitForWriter();
+}
+
+bool AsyncFileWriter::Write(const void* data, size_t size) {
+  const uint8_t* bytes = static_cast<const uint8_t*>(data);
+  while (size > 0) {
+    const size_t copy_size = std::min(size, buffer_size_ - filling_.size());
+    filling_.insert(filling_.end(), bytes, bytes + copy_size);
+    bytes += copy_size;
+    size -= copy_size;
+
+    if (filling_.size() == buffer_size_ && !HandOff()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool AsyncFileWriter::WriteIoVec(std::vector<WritableIoVec>* iovecs) {
+  if (iovecs->empty()) {
+    LOG(ERROR) << "WriteIoVec(): no iovecs";
+    return false;
+  }
+
+  for (const WritableIoVec& iov : *iovecs) {
+    if (!Write(iov.iov_base, iov.iov_len)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool AsyncFileWriter::ReserveSpace(FileOffset size) {
+  return Flush() && file_writer_->ReserveSpace(size);
+}
+
+FileOffset AsyncFileWriter::Seek(FileOffset offset, int whence) {
+  if (!Flush()) {
+    return -1;
+  }
+  return file_writer_->Seek(offset, whence);
+}
+
+bool AsyncFileWriter::HandOff() {
+  DCHECK(!filling_.empty());
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  condition_.wait(lock, [this] { return writing_.empty(); });
+  if (failed_) {
+    filling_.clear();
+    return false;
+  }
+
+  std::swap(filling_, writing_);
+  lock.unlock();
+  condition_.notify_all();
+  return true;
+}
+
+bool AsyncFileWriter::WaitForWriter() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  condition_.wait(lock, [this] { return writing_.empty(); });
+  return !failed_;
+}
+
+void AsyncFileWriter::WriterThreadMain() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    condition_.wait(lock, [this] { return stopping_ || !writing_.empty(); });
+    if (writing_.empty()) {
+      // Stopping, with nothing left to write.
+      return;
+    }
+
+    // After a failure, the data is discarded. Otherwise, the buffer being
+    // written is only changed by this thread until it’s emptied, so it can be
+    // written without holding the lock.
+    if (!failed_) {
+      lock.unlock();
+      const bool wrote = file_writer_->Write(writing_.data(), writing_.size());
+      lock.lock();
+      failed_ = !wrote;
+    }
+
+    writing_.clear();
+    condition_.notify_all();
+  }
+}
+
+}  // namespace crashpad
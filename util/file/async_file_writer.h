@@ -0,0 +1,104 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_UTIL_FILE_ASYNC_FILE_WRITER_H_
+#define CRASHPAD_UTIL_FILE_ASYNC_FILE_WRITER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "util/file/file_writer.h"
+
+namespace crashpad {
+
+//! \brief A file writer that writes to another FileWriterInterface on a
+//!     background thread, so that producing data overlaps with writing it.
+//!
+//! Data is copied into one of two buffers. When a buffer fills, it’s handed to
+//! the background thread to be written while the other buffer is filled. A
+//! caller that fills a buffer before the previous one has been written waits
+//! for that write to finish, so at most two buffers of data are held.
+//!
+//! An error writing to the underlying writer is reported by the next call
+//! that waits for the background thread, and by every call after it. Data
+//! written to this object is not guaranteed to reach the underlying writer
+//! until Flush() is called. Seek() and ReserveSpace() flush before they’re
+//! passed on. Flush() must be called before this object is destroyed.
+//!
+//! Apart from the background thread’s use of the underlying writer, this class
+//! is not thread-safe.
+class AsyncFileWriter : public FileWriterInterface {
+ public:
+  //! \brief The default size of each buffer.
+  static constexpr size_t kDefaultBufferSize = 1024 * 1024;
+
+  //! \param[in] file_writer The file writer to receive the data. It is only
+  //!     used from the background thread, until Flush() returns. This object
+  //!     must outlive the AsyncFileWriter.
+  //! \param[in] buffer_size The number of bytes in each buffer.
+  explicit AsyncFileWriter(FileWriterInterface* file_writer,
+                           size_t buffer_size = kDefaultBufferSize);
+
+  AsyncFileWriter(const AsyncFileWriter&) = delete;
+  AsyncFileWriter& operator=(const AsyncFileWriter&) = delete;
+
+  ~AsyncFileWriter() override;
+
+  //! \brief Writes all data written to this object to the underlying file
+  //!     writer, and waits for it to be written.
+  //!
+  //! \return `true` on success. `false` if any write failed, with an
+  //!     appropriate message logged.
+  bool Flush();
+
+  // FileWriterInterface:
+  bool Write(const void* data, size_t size) override;
+  bool WriteIoVec(std::vector<WritableIoVec>* iovecs) override;
+  bool ReserveSpace(FileOffset size) override;
+
+  // FileSeekerInterface:
+  FileOffset Seek(FileOffset offset, int whence) override;
+
+ private:
+  class WriterThread;
+
+  // Hands the buffer being filled to the background thread, after waiting for
+  // it to finish writing the previous one.
+  bool HandOff();
+
+  // Waits for the background thread to finish writing, and returns whether
+  // every write so far has succeeded.
+  bool WaitForWriter();
+
+  void WriterThreadMain();
+
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  std::vector<uint8_t> filling_;
+  std::vector<uint8_t> writing_;  // Guarded by mutex_.
+  const size_t buffer_size_;
+  FileWriterInterface* file_writer_;  // weak
+  std::unique_ptr<WriterThread> writer_thread_;
+  bool failed_;  // Guarded by mutex_.
+  bool stopping_;  // Guarded by mutex_.
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_UTIL_FILE_ASYNC_FILE_WRITER_H_
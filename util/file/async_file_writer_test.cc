@@ -0,0 +1,121 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/file/async_file_writer.h"
+
+#include <stdio.h>
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "util/file/string_file.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+class FailingStringFile final : public StringFile {
+ public:
+  FailingStringFile() : StringFile() {}
+
+  FailingStringFile(const FailingStringFile&) = delete;
+  FailingStringFile& operator=(const FailingStringFile&) = delete;
+
+  ~FailingStringFile() override {}
+
+  // StringFile:
+  bool Write(const void* data, size_t size) override { return false; }
+};
+
+TEST(AsyncFileWriter, Write) {
+  StringFile string_file;
+  AsyncFileWriter writer(&string_file, 4);
+
+  EXPECT_TRUE(writer.Write("ab", 2));
+  EXPECT_TRUE(writer.Write("cdefghij", 8));
+  EXPECT_TRUE(writer.Write("k", 1));
+  ASSERT_TRUE(writer.Flush());
+  EXPECT_EQ(string_file.string(), "abcdefghijk");
+
+  // Flushing with nothing buffered does nothing.
+  ASSERT_TRUE(writer.Flush());
+  EXPECT_EQ(string_file.string(), "abcdefghijk");
+}
+
+TEST(AsyncFileWriter, WriteIoVec) {
+  StringFile string_file;
+  AsyncFileWriter writer(&string_file, 4);
+
+  std::vector<WritableIoVec> iovecs;
+  iovecs.push_back(WritableIoVec{"abc", 3});
+  iovecs.push_back(WritableIoVec{"defgh", 5});
+  EXPECT_TRUE(writer.WriteIoVec(&iovecs));
+
+  std::vector<WritableIoVec> no_iovecs;
+  EXPECT_FALSE(writer.WriteIoVec(&no_iovecs));
+
+  ASSERT_TRUE(writer.Flush());
+  EXPECT_EQ(string_file.string(), "abcdefgh");
+}
+
+TEST(AsyncFileWriter, Large) {
+  StringFile string_file;
+  std::string expected;
+  {
+    AsyncFileWriter writer(&string_file, 1000);
+    for (int index = 0; index < 1000; ++index) {
+      const std::string data(index % 7 + 1, 'a' + index % 26);
+      expected += data;
+      ASSERT_TRUE(writer.Write(data.data(), data.size()));
+    }
+    ASSERT_TRUE(writer.Flush());
+  }
+  EXPECT_EQ(string_file.string(), expected);
+}
+
+TEST(AsyncFileWriter, Seek) {
+  StringFile string_file;
+  AsyncFileWriter writer(&string_file, 16);
+
+  EXPECT_TRUE(writer.Write("abcdef", 6));
+
+  // Seeking flushes first, so the position reflects everything written.
+  EXPECT_EQ(writer.Seek(0, SEEK_CUR), 6);
+  EXPECT_EQ(string_file.string(), "abcdef");
+
+  EXPECT_EQ(writer.Seek(2, SEEK_SET), 2);
+  EXPECT_TRUE(writer.Write("CD", 2));
+  EXPECT_EQ(writer.Seek(0, SEEK_END), 6);
+  EXPECT_TRUE(writer.Write("g", 1));
+  ASSERT_TRUE(writer.Flush());
+  EXPECT_EQ(string_file.string(), "abCDefg");
+}
+
+TEST(AsyncFileWriter, Failure) {
+  FailingStringFile string_file;
+  AsyncFileWriter writer(&string_file, 4);
+
+  // The failure is reported once the background thread has seen it, and from
+  // then on.
+  EXPECT_TRUE(writer.Write("ab", 2));
+  EXPECT_FALSE(writer.Flush());
+  EXPECT_FALSE(writer.Write("abcdefghijkl", 12));
+  EXPECT_FALSE(writer.Flush());
+  EXPECT_EQ(writer.Seek(0, SEEK_CUR), -1);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
@@ -0,0 +1,132 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/file/buffered_file_reader.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include <algorithm>
+
+#include "base/check_op.h"
+#include "base/logging.h"
+#include "base/numerics/safe_math.h"
+
+namespace crashpad {
+
+BufferedFileReader::BufferedFileReader(FileReaderInterface* file_reader,
+                                       size_t buffer_size)
+    : buffer_(new uint8_t[buffer_size]),
+      buffer_size_(buffer_size),
+      buffer_used_(0),
+      buffer_offset_(0),
+      position_(-1),
+      end_(-1),
+      file_reader_(file_reader) {
+  DCHECK_GT(buffer_size_, 0u);
+}
+
+BufferedFileReader::~BufferedFileReader() = default;
+
+FileOperationResult BufferedFileReader::Read(void* data, size_t size) {
+  if (!EnsurePosition()) {
+    return -1;
+  }
+
+  if (position_ >= buffer_offset_ &&
+      position_ - buffer_offset_ < static_cast<FileOffset>(buffer_used_)) {
+    const size_t buffer_position =
+        static_cast<size_t>(position_ - buffer_offset_);
+    const size_t copy_size = std::min(size, buffer_used_ - buffer_position);
+    memcpy(data, buffer_.get() + buffer_position, copy_size);
+    position_ += static_cast<FileOffset>(copy_size);
+    return static_cast<FileOperationResult>(copy_size);
+  }
+
+  if (!file_reader_->SeekSet(position_)) {
+    return -1;
+  }
+
+  if (size >= buffer_size_) {
+    const FileOperationResult rv = file_reader_->Read(data, size);
+    if (rv > 0) {
+      position_ += rv;
+    }
+    return rv;
+  }
+
+  buffer_used_ = 0;
+  const FileOperationResult rv =
+      file_reader_->Read(buffer_.get(), buffer_size_);
+  if (rv <= 0) {
+    return rv;
+  }
+  buffer_offset_ = position_;
+  buffer_used_ = static_cast<size_t>(rv);
+
+  const size_t copy_size = std::min(size, buffer_used_);
+  memcpy(data, buffer_.get(), copy_size);
+  position_ += static_cast<FileOffset>(copy_size);
+  return static_cast<FileOperationResult>(copy_size);
+}
+
+FileOffset BufferedFileReader::Seek(FileOffset offset, int whence) {
+  FileOffset base_offset;
+  switch (whence) {
+    case SEEK_SET:
+      base_offset = 0;
+      break;
+
+    case SEEK_CUR:
+      if (!EnsurePosition()) {
+        return -1;
+      }
+      base_offset = position_;
+      break;
+
+    case SEEK_END:
+      if (end_ < 0) {
+        end_ = file_reader_->Seek(0, SEEK_END);
+        if (end_ < 0) {
+          return -1;
+        }
+      }
+      base_offset = end_;
+      break;
+
+    default:
+      LOG(ERROR) << "Seek(): invalid whence " << whence;
+      return -1;
+  }
+
+  base::CheckedNumeric<FileOffset> new_offset(base_offset);
+  new_offset += offset;
+  FileOffset new_position;
+  if (!new_offset.AssignIfValid(&new_position) || new_position < 0) {
+    LOG(ERROR) << "Seek(): new_offset invalid";
+    return -1;
+  }
+
+  position_ = new_position;
+  return position_;
+}
+
+bool BufferedFileReader::EnsurePosition() {
+  if (position_ < 0) {
+    position_ = file_reader_->SeekGet();
+  }
+  return position_ >= 0;
+}
+
+}  // namespace crashpad
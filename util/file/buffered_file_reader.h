@@ -0,0 +1,85 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_UTIL_FILE_BUFFERED_FILE_READER_H_
+#define CRASHPAD_UTIL_FILE_BUFFERED_FILE_READER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+
+#include "util/file/file_reader.h"
+
+namespace crashpad {
+
+//! \brief A file reader that serves small reads and nearby seeks from a
+//!     read-ahead buffer filled from another FileReaderInterface.
+//!
+//! Seeks only record the new position, so a seek followed by a read of data
+//! already in the buffer makes no calls to the underlying reader. A read that
+//! misses the buffer refills it with a single seek and read of the underlying
+//! reader, starting at the current position. Reads at least as large as the
+//! buffer bypass it.
+//!
+//! The underlying reader is always repositioned before it’s read, so other
+//! code may use it between calls to this object. The file must not be modified
+//! while this object reads it, because buffered data and the file’s size,
+//! once learned, are reused.
+class BufferedFileReader : public FileReaderInterface {
+ public:
+  //! \brief The default size of the buffer.
+  static constexpr size_t kDefaultBufferSize = 64 * 1024;
+
+  //! \param[in] file_reader The file reader to read from. This object must
+  //!     outlive the BufferedFileReader. Reading starts at its current
+  //!     position.
+  //! \param[in] buffer_size The number of bytes to read ahead.
+  explicit BufferedFileReader(FileReaderInterface* file_reader,
+                              size_t buffer_size = kDefaultBufferSize);
+
+  BufferedFileReader(const BufferedFileReader&) = delete;
+  BufferedFileReader& operator=(const BufferedFileReader&) = delete;
+
+  ~BufferedFileReader() override;
+
+  // FileReaderInterface:
+  FileOperationResult Read(void* data, size_t size) override;
+
+  // FileSeekerInterface:
+  FileOffset Seek(FileOffset offset, int whence) override;
+
+ private:
+  //! \brief Sets position_ from the underlying reader if it isn’t known yet.
+  bool EnsurePosition();
+
+  std::unique_ptr<uint8_t[]> buffer_;
+  size_t buffer_size_;
+  size_t buffer_used_;
+
+  // The file offset of buffer_[0].
+  FileOffset buffer_offset_;
+
+  // The current position, or -1 until it’s been obtained from file_reader_.
+  FileOffset position_;
+
+  // The size of the file, or -1 until it’s been obtained from file_reader_.
+  FileOffset end_;
+
+  FileReaderInterface* file_reader_;  // weak
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_UTIL_FILE_BUFFERED_FILE_READER_H_
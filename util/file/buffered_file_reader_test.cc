@@ -0,0 +1,168 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/file/buffered_file_reader.h"
+
+#include <stdio.h>
+
+#include <string>
+
+#include "gtest/gtest.h"
+#include "util/file/string_file.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+class CountingStringFile final : public StringFile {
+ public:
+  CountingStringFile() : StringFile(), reads_(0), seeks_(0) {}
+
+  CountingStringFile(const CountingStringFile&) = delete;
+  CountingStringFile& operator=(const CountingStringFile&) = delete;
+
+  ~CountingStringFile() override {}
+
+  size_t reads() const { return reads_; }
+  size_t seeks() const { return seeks_; }
+
+  // StringFile:
+  FileOperationResult Read(void* data, size_t size) override {
+    ++reads_;
+    return StringFile::Read(data, size);
+  }
+
+  FileOffset Seek(FileOffset offset, int whence) override {
+    ++seeks_;
+    return StringFile::Seek(offset, whence);
+  }
+
+ private:
+  size_t reads_;
+  size_t seeks_;
+};
+
+std::string TestData(size_t size) {
+  std::string data(size, '\0');
+  for (size_t index = 0; index < size; ++index) {
+    data[index] = static_cast<char>(index * 7 + index / 256);
+  }
+  return data;
+}
+
+TEST(BufferedFileReader, SeeksWithinBuffer) {
+  CountingStringFile file;
+  const std::string data = TestData(1000);
+  file.SetString(data);
+
+  BufferedFileReader reader(&file, 256);
+  char buffer[16];
+  ASSERT_TRUE(reader.SeekSet(100));
+  ASSERT_TRUE(reader.ReadExactly(buffer, sizeof(buffer)));
+  EXPECT_EQ(std::string(buffer, sizeof(buffer)), data.substr(100, 16));
+  const size_t reads = file.reads();
+  const size_t seeks = file.seeks();
+
+  // Seeking and reading within the buffered data doesn’t touch the file.
+  ASSERT_TRUE(reader.SeekSet(300));
+  ASSERT_TRUE(reader.ReadExactly(buffer, sizeof(buffer)));
+  EXPECT_EQ(std::string(buffer, sizeof(buffer)), data.substr(300, 16));
+  ASSERT_TRUE(reader.SeekSet(116));
+  ASSERT_TRUE(reader.ReadExactly(buffer, sizeof(buffer)));
+  EXPECT_EQ(std::string(buffer, sizeof(buffer)), data.substr(116, 16));
+  EXPECT_EQ(reader.SeekGet(), 132);
+  EXPECT_EQ(file.reads(), reads);
+  EXPECT_EQ(file.seeks(), seeks);
+
+  // A read that straddles the end of the buffer refills it.
+  ASSERT_TRUE(reader.SeekSet(350));
+  ASSERT_TRUE(reader.ReadExactly(buffer, sizeof(buffer)));
+  EXPECT_EQ(std::string(buffer, sizeof(buffer)), data.substr(350, 16));
+  EXPECT_GT(file.reads(), reads);
+}
+
+TEST(BufferedFileReader, MatchesUnbufferedReads) {
+  StringFile file;
+  const std::string data = TestData(5000);
+  file.SetString(data);
+
+  BufferedFileReader reader(&file, 64);
+  const struct {
+    FileOffset offset;
+    size_t size;
+  } kReads[] = {
+      {0, 1},
+      {1, 63},
+      {60, 10},
+      {4990, 10},
+      {10, 200},
+      {64, 64},
+      {3000, 1000},
+      {20, 30},
+  };
+  for (const auto& read : kReads) {
+    SCOPED_TRACE(read.offset);
+    ASSERT_TRUE(reader.SeekSet(read.offset));
+    std::string buffer(read.size, '\0');
+    ASSERT_TRUE(reader.ReadExactly(&buffer[0], buffer.size()));
+    EXPECT_EQ(buffer, data.substr(read.offset, read.size));
+    EXPECT_EQ(reader.SeekGet(),
+              read.offset + static_cast<FileOffset>(read.size));
+  }
+}
+
+TEST(BufferedFileReader, EndOfFile) {
+  StringFile file;
+  const std::string data = TestData(100);
+  file.SetString(data);
+
+  BufferedFileReader reader(&file, 64);
+  EXPECT_EQ(reader.Seek(-10, SEEK_END), 90);
+  char buffer[20];
+  EXPECT_EQ(reader.Read(buffer, sizeof(buffer)), 10);
+  EXPECT_EQ(std::string(buffer, 10), data.substr(90));
+  EXPECT_EQ(reader.Read(buffer, sizeof(buffer)), 0);
+
+  ASSERT_TRUE(reader.SeekSet(95));
+  EXPECT_FALSE(reader.ReadExactly(buffer, sizeof(buffer)));
+
+  EXPECT_EQ(reader.Seek(200, SEEK_SET), 200);
+  EXPECT_EQ(reader.Read(buffer, sizeof(buffer)), 0);
+
+  EXPECT_EQ(reader.Seek(-1, SEEK_SET), -1);
+}
+
+TEST(BufferedFileReader, StartsAtCurrentPosition) {
+  StringFile file;
+  const std::string data = TestData(100);
+  file.SetString(data);
+  ASSERT_TRUE(file.SeekSet(40));
+
+  BufferedFileReader reader(&file, 16);
+  EXPECT_EQ(reader.SeekGet(), 40);
+  char buffer[8];
+  ASSERT_TRUE(reader.ReadExactly(buffer, sizeof(buffer)));
+  EXPECT_EQ(std::string(buffer, sizeof(buffer)), data.substr(40, 8));
+
+  // Moving the underlying file doesn’t disturb the reader.
+  ASSERT_TRUE(file.SeekSet(0));
+  ASSERT_TRUE(reader.ReadExactly(buffer, sizeof(buffer)));
+  EXPECT_EQ(std::string(buffer, sizeof(buffer)), data.substr(48, 8));
+  ASSERT_TRUE(reader.ReadExactly(buffer, sizeof(buffer)));
+  EXPECT_EQ(std::string(buffer, sizeof(buffer)), data.substr(56, 8));
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
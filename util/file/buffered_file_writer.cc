@@ -0,0 +1,105 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/file/buffered_file_writer.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "base/check_op.h"
+#include "base/logging.h"
+
+namespace crashpad {
+
+BufferedFileWriter::BufferedFileWriter(FileWriterInterface* file_writer,
+                                       size_t buffer_size)
+    : buffer_(new uint8_t[buffer_size]),
+      buffer_size_(buffer_size),
+      buffer_used_(0),
+      file_writer_(file_writer) {
+  DCHECK_GT(buffer_size_, 0u);
+}
+
+BufferedFileWriter::~BufferedFileWriter() {
+  DCHECK_EQ(buffer_used_, 0u);
+}
+
+bool BufferedFileWriter::Flush() {
+  if (buffer_used_ == 0) {
+    return true;
+  }
+
+  const size_t size = buffer_used_;
+  buffer_used_ = 0;
+  return file_writer_->Write(buffer_.get(), size);
+}
+
+bool BufferedFileWriter::Write(const void* data, size_t size) {
+  if (size <= buffer_size_ - buffer_used_) {
+    memcpy(buffer_.get() + buffer_used_, data, size);
+    buffer_used_ += size;
+    return true;
+  }
+
+  std::vector<WritableIoVec> iovecs;
+  if (buffer_used_ > 0) {
+    iovecs.push_back(WritableIoVec{buffer_.get(), buffer_used_});
+    buffer_used_ = 0;
+  }
+  iovecs.push_back(WritableIoVec{data, size});
+  return file_writer_->WriteIoVec(&iovecs);
+}
+
+bool BufferedFileWriter::WriteIoVec(std::vector<WritableIoVec>* iovecs) {
+  if (iovecs->empty()) {
+    LOG(ERROR) << "WriteIoVec(): no iovecs";
+    return false;
+  }
+
+  size_t size = 0;
+  for (const WritableIoVec& iov : *iovecs) {
+    size += iov.iov_len;
+  }
+
+  if (size <= buffer_size_ - buffer_used_) {
+    for (const WritableIoVec& iov : *iovecs) {
+      memcpy(buffer_.get() + buffer_used_, iov.iov_base, iov.iov_len);
+      buffer_used_ += iov.iov_len;
+    }
+    return true;
+  }
+
+  if (buffer_used_ > 0) {
+    iovecs->insert(iovecs->begin(),
+                   WritableIoVec{buffer_.get(), buffer_used_});
+    buffer_used_ = 0;
+  }
+  return file_writer_->WriteIoVec(iovecs);
+}
+
+FileOffset BufferedFileWriter::Seek(FileOffset offset, int whence) {
+  // Reporting the current position doesn’t require flushing.
+  if (offset == 0 && whence == SEEK_CUR) {
+    FileOffset position = file_writer_->Seek(0, SEEK_CUR);
+    return position < 0 ? position : position + buffer_used_;
+  }
+
+  if (!Flush()) {
+    return -1;
+  }
+
+  return file_writer_->Seek(offset, whence);
+}
+
+}  // namespace crashpad
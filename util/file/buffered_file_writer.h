@@ -0,0 +1,79 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_UTIL_FILE_BUFFERED_FILE_WRITER_H_
+#define CRASHPAD_UTIL_FILE_BUFFERED_FILE_WRITER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <vector>
+
+#include "util/file/file_writer.h"
+
+namespace crashpad {
+
+//! \brief A file writer that gathers small writes into fewer, larger writes to
+//!     another FileWriterInterface.
+//!
+//! Writes that fit in the buffer are copied into it. A write that doesn’t fit
+//! is issued together with the buffered data as a single
+//! FileWriterInterface::WriteIoVec() call on the underlying writer, so that
+//! each batch costs one `writev()` on POSIX regardless of how many pieces it
+//! was assembled from.
+//!
+//! Data written to this object is not guaranteed to reach the underlying
+//! writer until Flush() is called or a Seek() other than a query of the current
+//! position is made. Flush() must be called before this object is destroyed.
+class BufferedFileWriter : public FileWriterInterface {
+ public:
+  //! \brief The default size of the buffer.
+  static constexpr size_t kDefaultBufferSize = 64 * 1024;
+
+  //! \param[in] file_writer The file writer to receive the buffered data. This
+  //!     object must outlive the BufferedFileWriter.
+  //! \param[in] buffer_size The number of bytes to buffer before writing to
+  //!     \a file_writer.
+  explicit BufferedFileWriter(FileWriterInterface* file_writer,
+                              size_t buffer_size = kDefaultBufferSize);
+
+  BufferedFileWriter(const BufferedFileWriter&) = delete;
+  BufferedFileWriter& operator=(const BufferedFileWriter&) = delete;
+
+  ~BufferedFileWriter() override;
+
+  //! \brief Writes any buffered data to the underlying file writer.
+  //!
+  //! \return `true` on success. `false` on failure, with an appropriate message
+  //!     logged.
+  bool Flush();
+
+  // FileWriterInterface:
+  bool Write(const void* data, size_t size) override;
+  bool WriteIoVec(std::vector<WritableIoVec>* iovecs) override;
+
+  // FileSeekerInterface:
+  FileOffset Seek(FileOffset offset, int whence) override;
+
+ private:
+  std::unique_ptr<uint8_t[]> buffer_;
+  size_t buffer_size_;
+  size_t buffer_used_;
+  FileWriterInterface* file_writer_;  // weak
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_UTIL_FILE_BUFFERED_FILE_WRITER_H_
@@ -0,0 +1,140 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/file/buffered_file_writer.h"
+
+#include <stdio.h>
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "util/file/string_file.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+class RecordingStringFile final : public StringFile {
+ public:
+  RecordingStringFile()
+      : StringFile(), write_sizes_(), in_write_iovec_(false) {}
+
+  RecordingStringFile(const RecordingStringFile&) = delete;
+  RecordingStringFile& operator=(const RecordingStringFile&) = delete;
+
+  ~RecordingStringFile() override {}
+
+  // The number of bytes passed to each Write() or WriteIoVec() call.
+  const std::vector<size_t>& write_sizes() const { return write_sizes_; }
+
+  // StringFile:
+  bool Write(const void* data, size_t size) override {
+    // StringFile::WriteIoVec() is implemented in terms of Write().
+    if (!in_write_iovec_) {
+      write_sizes_.push_back(size);
+    }
+    return StringFile::Write(data, size);
+  }
+
+  bool WriteIoVec(std::vector<WritableIoVec>* iovecs) override {
+    size_t size = 0;
+    for (const WritableIoVec& iov : *iovecs) {
+      size += iov.iov_len;
+    }
+    write_sizes_.push_back(size);
+
+    in_write_iovec_ = true;
+    bool rv = StringFile::WriteIoVec(iovecs);
+    in_write_iovec_ = false;
+    return rv;
+  }
+
+ private:
+  std::vector<size_t> write_sizes_;
+  bool in_write_iovec_;
+};
+
+TEST(BufferedFileWriter, SmallWrites) {
+  RecordingStringFile string_file;
+  BufferedFileWriter writer(&string_file, 8);
+
+  EXPECT_TRUE(writer.Write("abc", 3));
+  EXPECT_TRUE(writer.Write("de", 2));
+  std::vector<WritableIoVec> iovecs = {{"f", 1}, {"gh", 2}};
+  EXPECT_TRUE(writer.WriteIoVec(&iovecs));
+  EXPECT_TRUE(string_file.string().empty());
+  EXPECT_EQ(writer.Seek(0, SEEK_CUR), 8);
+
+  EXPECT_TRUE(writer.Flush());
+  EXPECT_EQ(string_file.string(), "abcdefgh");
+  EXPECT_EQ(string_file.write_sizes(), std::vector<size_t>({8}));
+
+  // Flushing an empty buffer doesn’t write anything.
+  EXPECT_TRUE(writer.Flush());
+  EXPECT_EQ(string_file.write_sizes().size(), 1u);
+}
+
+TEST(BufferedFileWriter, Overflow) {
+  RecordingStringFile string_file;
+  BufferedFileWriter writer(&string_file, 8);
+
+  // A write that doesn’t fit goes out along with what was buffered before it.
+  EXPECT_TRUE(writer.Write("abcdef", 6));
+  EXPECT_TRUE(writer.Write("ghi", 3));
+  EXPECT_EQ(string_file.string(), "abcdefghi");
+
+  // Writes larger than the buffer go straight through.
+  EXPECT_TRUE(writer.Write("0123456789", 10));
+  EXPECT_EQ(string_file.string(), "abcdefghi0123456789");
+
+  EXPECT_TRUE(writer.Write("jk", 2));
+  std::vector<WritableIoVec> iovecs = {{"lmnop", 5}, {"qrs", 3}};
+  EXPECT_TRUE(writer.WriteIoVec(&iovecs));
+  EXPECT_EQ(string_file.string(), "abcdefghi0123456789jklmnopqrs");
+
+  EXPECT_TRUE(writer.Flush());
+  EXPECT_EQ(string_file.write_sizes(), std::vector<size_t>({9, 10, 10}));
+}
+
+TEST(BufferedFileWriter, Seek) {
+  RecordingStringFile string_file;
+  BufferedFileWriter writer(&string_file, 8);
+
+  EXPECT_TRUE(writer.Write("abcd", 4));
+  EXPECT_EQ(writer.Seek(0, SEEK_CUR), 4);
+  EXPECT_TRUE(string_file.string().empty());
+
+  // Any other seek flushes first.
+  EXPECT_EQ(writer.Seek(1, SEEK_SET), 1);
+  EXPECT_EQ(string_file.string(), "abcd");
+
+  EXPECT_TRUE(writer.Write("XY", 2));
+  EXPECT_TRUE(writer.Flush());
+  EXPECT_EQ(string_file.string(), "aXYd");
+}
+
+TEST(BufferedFileWriter, NoIoVecs) {
+  RecordingStringFile string_file;
+  BufferedFileWriter writer(&string_file);
+
+  std::vector<WritableIoVec> iovecs;
+  EXPECT_FALSE(writer.WriteIoVec(&iovecs));
+  EXPECT_TRUE(writer.Flush());
+  EXPECT_TRUE(string_file.write_sizes().empty());
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
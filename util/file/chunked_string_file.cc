@@ -0,0 +1,228 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/file/chunked_string_file.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+#include "base/check_op.h"
+#include "base/logging.h"
+#include "util/numeric/safe_assignment.h"
+
+namespace crashpad {
+
+ChunkedStringFile::ChunkedStringFile(size_t chunk_size)
+    : chunks_(), chunk_size_(chunk_size), size_(0), offset_(0) {
+  DCHECK_GT(chunk_size_, 0u);
+}
+
+ChunkedStringFile::~ChunkedStringFile() {}
+
+std::string ChunkedStringFile::ToString() const {
+  std::string string(size_, '\0');
+  if (size_) {
+    ReadAt(0, &string[0], size_);
+  }
+  return string;
+}
+
+void ChunkedStringFile::Reset() {
+  chunks_.clear();
+  size_ = 0;
+  offset_ = 0;
+}
+
+size_t ChunkedStringFile::ReadAt(size_t offset, void* data, size_t size) const {
+  if (offset >= size_) {
+    return 0;
+  }
+
+  const size_t nread = std::min(size, size_ - offset);
+  char* destination = reinterpret_cast<char*>(data);
+  size_t remaining = nread;
+  while (remaining) {
+    const size_t chunk_offset = offset % chunk_size_;
+    const size_t copy_size = std::min(remaining, chunk_size_ - chunk_offset);
+    memcpy(destination, &chunks_[offset / chunk_size_][chunk_offset],
+           copy_size);
+    destination += copy_size;
+    offset += copy_size;
+    remaining -= copy_size;
+  }
+  return nread;
+}
+
+bool ChunkedStringFile::WriteTo(FileWriterInterface* file_writer) const {
+  for (size_t offset = 0; offset < size_; offset += chunk_size_) {
+    if (!file_writer->Write(chunks_[offset / chunk_size_].get(),
+                            std::min(chunk_size_, size_ - offset))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+FileOperationResult ChunkedStringFile::Read(void* data, size_t size) {
+  DCHECK(offset_.IsValid());
+
+  const size_t offset = offset_.ValueOrDie();
+  if (offset >= size_) {
+    return 0;
+  }
+
+  base::CheckedNumeric<FileOperationResult> new_offset = offset_;
+  new_offset += std::min(size, size_ - offset);
+  if (!new_offset.IsValid()) {
+    LOG(ERROR) << "Read(): file too large";
+    return -1;
+  }
+
+  const size_t nread = ReadAt(offset, data, size);
+  offset_ = new_offset;
+
+  return nread;
+}
+
+bool ChunkedStringFile::Write(const void* data, size_t size) {
+  DCHECK(offset_.IsValid());
+
+  const size_t offset = offset_.ValueOrDie();
+
+  base::CheckedNumeric<FileOperationResult> new_offset = offset_;
+  new_offset += size;
+  if (!new_offset.IsValid()) {
+    LOG(ERROR) << "Write(): file too large";
+    return false;
+  }
+
+  if (offset > size_) {
+    // Fill the gap left by seeking past the end of the file with zeroes, as a
+    // real file would read back.
+    Store(size_, nullptr, offset - size_);
+  }
+  Store(offset, data, size);
+  offset_ = new_offset;
+
+  return true;
+}
+
+bool ChunkedStringFile::WriteIoVec(std::vector<WritableIoVec>* iovecs) {
+  DCHECK(offset_.IsValid());
+
+  if (iovecs->empty()) {
+    LOG(ERROR) << "WriteIoVec(): no iovecs";
+    return false;
+  }
+
+  // Avoid writing anything at all if it would cause an overflow.
+  base::CheckedNumeric<FileOperationResult> new_offset = offset_;
+  for (const WritableIoVec& iov : *iovecs) {
+    new_offset += iov.iov_len;
+    if (!new_offset.IsValid()) {
+      LOG(ERROR) << "WriteIoVec(): file too large";
+      return false;
+    }
+  }
+
+  for (const WritableIoVec& iov : *iovecs) {
+    if (!Write(iov.iov_base, iov.iov_len)) {
+      return false;
+    }
+  }
+
+#ifndef NDEBUG
+  // The interface says that |iovecs| is not sacred, so scramble it to make sure
+  // that nobody depends on it.
+  memset(&(*iovecs)[0], 0xa5, sizeof((*iovecs)[0]) * iovecs->size());
+#endif
+
+  return true;
+}
+
+FileOffset ChunkedStringFile::Seek(FileOffset offset, int whence) {
+  DCHECK(offset_.IsValid());
+
+  size_t base_offset;
+
+  switch (whence) {
+    case SEEK_SET:
+      base_offset = 0;
+      break;
+
+    case SEEK_CUR:
+      base_offset = offset_.ValueOrDie();
+      break;
+
+    case SEEK_END:
+      base_offset = size_;
+      break;
+
+    default:
+      LOG(ERROR) << "Seek(): invalid whence " << whence;
+      return -1;
+  }
+
+  FileOffset base_offset_fileoffset;
+  if (!AssignIfInRange(&base_offset_fileoffset, base_offset)) {
+    LOG(ERROR) << "Seek(): base_offset " << base_offset
+               << " invalid for FileOffset";
+    return -1;
+  }
+  base::CheckedNumeric<FileOffset> new_offset(base_offset_fileoffset);
+  new_offset += offset;
+  if (!new_offset.IsValid()) {
+    LOG(ERROR) << "Seek(): new_offset invalid";
+    return -1;
+  }
+  size_t new_offset_sizet;
+  if (!new_offset.AssignIfValid(&new_offset_sizet)) {
+    LOG(ERROR) << "Seek(): new_offset " << new_offset.ValueOrDie()
+               << " invalid for size_t";
+    return -1;
+  }
+
+  offset_ = new_offset_sizet;
+
+  return base::ValueOrDieForType<FileOffset>(offset_);
+}
+
+void ChunkedStringFile::Store(size_t offset, const void* data, size_t size) {
+  const size_t end = offset + size;
+  const size_t chunk_count = (end + chunk_size_ - 1) / chunk_size_;
+  while (chunks_.size() < chunk_count) {
+    // Chunks are left uninitialized, because every byte below size_ is stored
+    // before it can be read.
+    chunks_.push_back(std::unique_ptr<char[]>(new char[chunk_size_]));
+  }
+
+  const char* source = reinterpret_cast<const char*>(data);
+  while (offset < end) {
+    const size_t chunk_offset = offset % chunk_size_;
+    const size_t store_size = std::min(end - offset, chunk_size_ - chunk_offset);
+    char* destination = &chunks_[offset / chunk_size_][chunk_offset];
+    if (source) {
+      memcpy(destination, source, store_size);
+      source += store_size;
+    } else {
+      memset(destination, 0, store_size);
+    }
+    offset += store_size;
+  }
+
+  size_ = std::max(size_, end);
+}
+
+}  // namespace crashpad
@@ -0,0 +1,112 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_UTIL_FILE_CHUNKED_STRING_FILE_H_
+#define CRASHPAD_UTIL_FILE_CHUNKED_STRING_FILE_H_
+
+#include <stddef.h>
+#include <sys/types.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/numerics/safe_math.h"
+#include "util/file/file_io.h"
+#include "util/file/file_reader.h"
+#include "util/file/file_writer.h"
+
+namespace crashpad {
+
+//! \brief A file reader and writer backed by a virtual file held in memory as a
+//!     list of fixed-size chunks.
+//!
+//! This behaves as StringFile, but growing the file allocates new chunks
+//! instead of reallocating and copying everything written so far. This keeps
+//! the cost of building a large file, such as a minidump, in memory
+//! proportional to its size, and avoids the temporary doubling of memory use
+//! that growing a single buffer can cause.
+//!
+//! The contents can be read without disturbing the file position by ReadAt(),
+//! which ChunkedStringFileHTTPBodyStream uses to upload them without first
+//! copying them into a contiguous buffer.
+class ChunkedStringFile : public FileReaderInterface,
+                          public FileWriterInterface {
+ public:
+  //! \brief The default size of each chunk.
+  static constexpr size_t kDefaultChunkSize = 64 * 1024;
+
+  //! \param[in] chunk_size The size of each chunk of the virtual file.
+  explicit ChunkedStringFile(size_t chunk_size = kDefaultChunkSize);
+
+  ChunkedStringFile(const ChunkedStringFile&) = delete;
+  ChunkedStringFile& operator=(const ChunkedStringFile&) = delete;
+
+  ~ChunkedStringFile() override;
+
+  //! \brief Returns the size of the virtual file.
+  size_t size() const { return size_; }
+
+  //! \brief Returns a copy of the virtual file’s contents.
+  std::string ToString() const;
+
+  //! \brief Resets the virtual file’s contents to be empty, releasing its
+  //!     memory, and resets its file position to `0`.
+  void Reset();
+
+  //! \brief Copies data from the virtual file without using or affecting its
+  //!     file position.
+  //!
+  //! \param[in] offset The offset in the virtual file to copy data from.
+  //! \param[out] data The buffer to copy data to.
+  //! \param[in] size The maximum number of bytes to copy.
+  //!
+  //! \return The number of bytes copied, which is less than \a size only when
+  //!     the end of the virtual file is reached.
+  size_t ReadAt(size_t offset, void* data, size_t size) const;
+
+  //! \brief Writes the virtual file’s contents to \a file_writer directly from
+  //!     its chunks, without using or affecting its file position.
+  //!
+  //! \return `true` on success, `false` if \a file_writer failed.
+  bool WriteTo(FileWriterInterface* file_writer) const;
+
+  // FileReaderInterface:
+  FileOperationResult Read(void* data, size_t size) override;
+
+  // FileWriterInterface:
+  bool Write(const void* data, size_t size) override;
+  bool WriteIoVec(std::vector<WritableIoVec>* iovecs) override;
+
+  // FileSeekerInterface:
+  FileOffset Seek(FileOffset offset, int whence) override;
+
+ private:
+  //! \brief Stores \a size bytes from \a data at \a offset, allocating chunks
+  //!     as needed. If \a data is `nullptr`, stores zeroes instead.
+  void Store(size_t offset, const void* data, size_t size);
+
+  std::vector<std::unique_ptr<char[]>> chunks_;
+  const size_t chunk_size_;
+
+  //! \brief The size of the virtual file.
+  size_t size_;
+
+  //! \brief The file offset of the virtual file.
+  base::CheckedNumeric<size_t> offset_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_UTIL_FILE_CHUNKED_STRING_FILE_H_
@@ -0,0 +1,210 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/file/chunked_string_file.h"
+
+#include <string.h>
+
+#include <limits>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "util/file/string_file.h"
+#include "util/misc/implicit_cast.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+TEST(ChunkedStringFile, EmptyFile) {
+  ChunkedStringFile file;
+  EXPECT_EQ(file.size(), 0u);
+  EXPECT_TRUE(file.ToString().empty());
+  EXPECT_EQ(file.Seek(0, SEEK_CUR), 0);
+  EXPECT_TRUE(file.Write("", 0));
+  EXPECT_EQ(file.size(), 0u);
+  EXPECT_EQ(file.Seek(0, SEEK_CUR), 0);
+
+  char c = '6';
+  EXPECT_EQ(file.Read(&c, 1), 0);
+  EXPECT_EQ(c, '6');
+  EXPECT_EQ(file.ReadAt(0, &c, 1), 0u);
+  EXPECT_EQ(c, '6');
+  EXPECT_EQ(file.Seek(0, SEEK_CUR), 0);
+}
+
+TEST(ChunkedStringFile, SpanChunks) {
+  ChunkedStringFile file(4);
+
+  EXPECT_TRUE(file.Write("abcdefghij", 10));
+  EXPECT_EQ(file.size(), 10u);
+  EXPECT_EQ(file.ToString(), "abcdefghij");
+  EXPECT_EQ(file.Seek(0, SEEK_CUR), 10);
+
+  EXPECT_EQ(file.Seek(3, SEEK_SET), 3);
+  EXPECT_TRUE(file.Write("DEFGH", 5));
+  EXPECT_EQ(file.size(), 10u);
+  EXPECT_EQ(file.ToString(), "abcDEFGHij");
+  EXPECT_EQ(file.Seek(0, SEEK_CUR), 8);
+
+  EXPECT_EQ(file.Seek(2, SEEK_SET), 2);
+  char buf[16];
+  EXPECT_EQ(file.Read(buf, 7), 7);
+  EXPECT_EQ(std::string(buf, 7), "cDEFGHi");
+  EXPECT_EQ(file.Seek(0, SEEK_CUR), 9);
+  EXPECT_EQ(file.Read(buf, sizeof(buf)), 1);
+  EXPECT_EQ(buf[0], 'j');
+  EXPECT_EQ(file.Read(buf, sizeof(buf)), 0);
+  EXPECT_EQ(file.Seek(0, SEEK_CUR), 10);
+
+  EXPECT_EQ(file.ReadAt(7, buf, sizeof(buf)), 3u);
+  EXPECT_EQ(std::string(buf, 3), "Hij");
+  EXPECT_EQ(file.ReadAt(10, buf, sizeof(buf)), 0u);
+  EXPECT_EQ(file.Seek(0, SEEK_CUR), 10);
+
+  EXPECT_TRUE(file.Write("klmnopqrstuvwxyz", 16));
+  EXPECT_EQ(file.size(), 26u);
+  EXPECT_EQ(file.ToString(), "abcDEFGHijklmnopqrstuvwxyz");
+
+  file.Reset();
+  EXPECT_EQ(file.size(), 0u);
+  EXPECT_TRUE(file.ToString().empty());
+  EXPECT_EQ(file.Seek(0, SEEK_CUR), 0);
+}
+
+TEST(ChunkedStringFile, WriteTo) {
+  ChunkedStringFile file(4);
+  StringFile string_file;
+  EXPECT_TRUE(file.WriteTo(&string_file));
+  EXPECT_TRUE(string_file.string().empty());
+
+  EXPECT_TRUE(file.Write("abcdefghij", 10));
+  EXPECT_EQ(file.Seek(2, SEEK_SET), 2);
+  EXPECT_TRUE(file.WriteTo(&string_file));
+  EXPECT_EQ(string_file.string(), "abcdefghij");
+  EXPECT_EQ(file.Seek(0, SEEK_CUR), 2);
+}
+
+TEST(ChunkedStringFile, WriteInvalid) {
+  ChunkedStringFile file;
+
+  EXPECT_FALSE(file.Write(
+      "",
+      implicit_cast<size_t>(std::numeric_limits<FileOperationResult>::max()) +
+          1));
+  EXPECT_EQ(file.size(), 0u);
+  EXPECT_EQ(file.Seek(0, SEEK_CUR), 0);
+
+  EXPECT_TRUE(file.Write("a", 1));
+  EXPECT_FALSE(file.Write(
+      "",
+      implicit_cast<size_t>(std::numeric_limits<FileOperationResult>::max())));
+  EXPECT_EQ(file.ToString(), "a");
+  EXPECT_EQ(file.Seek(0, SEEK_CUR), 1);
+}
+
+TEST(ChunkedStringFile, WriteIoVec) {
+  ChunkedStringFile file(3);
+
+  std::vector<WritableIoVec> iovecs;
+  WritableIoVec iov;
+  iov.iov_base = "";
+  iov.iov_len = 0;
+  iovecs.push_back(iov);
+  iov.iov_base = "abcd";
+  iov.iov_len = 4;
+  iovecs.push_back(iov);
+  iov.iov_base = "ef";
+  iov.iov_len = 2;
+  iovecs.push_back(iov);
+  EXPECT_TRUE(file.WriteIoVec(&iovecs));
+  EXPECT_EQ(file.ToString(), "abcdef");
+  EXPECT_EQ(file.Seek(0, SEEK_CUR), 6);
+
+  iovecs.clear();
+  EXPECT_FALSE(file.WriteIoVec(&iovecs));
+  EXPECT_EQ(file.ToString(), "abcdef");
+
+  iov.iov_base = "g";
+  iov.iov_len = 1;
+  iovecs.push_back(iov);
+  iov.iov_len =
+      implicit_cast<size_t>(std::numeric_limits<FileOperationResult>::max());
+  iovecs.push_back(iov);
+  EXPECT_FALSE(file.WriteIoVec(&iovecs));
+  EXPECT_EQ(file.ToString(), "abcdef");
+  EXPECT_EQ(file.Seek(0, SEEK_CUR), 6);
+}
+
+TEST(ChunkedStringFile, SeekSparse) {
+  ChunkedStringFile file(4);
+
+  EXPECT_EQ(file.Seek(3, SEEK_SET), 3);
+  EXPECT_EQ(file.size(), 0u);
+  EXPECT_TRUE(file.Write("abc", 3));
+  EXPECT_EQ(file.ToString(), std::string("\0\0\0abc", 6));
+
+  EXPECT_EQ(file.Seek(7, SEEK_END), 13);
+  char c;
+  EXPECT_EQ(file.Read(&c, 1), 0);
+  EXPECT_EQ(file.size(), 6u);
+  EXPECT_TRUE(file.Write("def", 3));
+  EXPECT_EQ(file.ToString(), std::string("\0\0\0abc\0\0\0\0\0\0\0def", 16));
+  EXPECT_EQ(file.Seek(0, SEEK_CUR), 16);
+
+  // Chunks allocated for the gap read back as zeroes after being rewritten.
+  EXPECT_EQ(file.Seek(-9, SEEK_END), 7);
+  EXPECT_TRUE(file.Write("g", 1));
+  EXPECT_EQ(file.ToString(), std::string("\0\0\0abc\0g\0\0\0\0\0def", 16));
+}
+
+TEST(ChunkedStringFile, SeekInvalid) {
+  ChunkedStringFile file;
+
+  EXPECT_EQ(file.Seek(1, SEEK_SET), 1);
+  EXPECT_LT(file.Seek(-1, SEEK_SET), 0);
+  EXPECT_EQ(file.Seek(0, SEEK_CUR), 1);
+  EXPECT_LT(file.Seek(std::numeric_limits<FileOffset>::min(), SEEK_SET), 0);
+  EXPECT_EQ(file.Seek(0, SEEK_CUR), 1);
+
+  static_assert(SEEK_SET != 3 && SEEK_CUR != 3 && SEEK_END != 3,
+                "3 must be invalid for whence");
+  EXPECT_LT(file.Seek(0, 3), 0);
+  EXPECT_EQ(file.Seek(0, SEEK_CUR), 1);
+}
+
+TEST(ChunkedStringFile, MatchesStringFile) {
+  ChunkedStringFile chunked_file(7);
+  StringFile string_file;
+
+  // Interleave writes, sparse seeks, and rewrites of varying sizes so that
+  // they start and end both within and at the edges of chunks.
+  std::string data;
+  for (size_t index = 0; index < 64; ++index) {
+    data.push_back(static_cast<char>('A' + index % 26));
+  }
+  for (size_t index = 0; index < 40; ++index) {
+    const FileOffset offset = static_cast<FileOffset>((index * 11) % 97);
+    const size_t size = (index * 5) % 23;
+    ASSERT_EQ(chunked_file.Seek(offset, SEEK_SET), offset);
+    ASSERT_EQ(string_file.Seek(offset, SEEK_SET), offset);
+    ASSERT_TRUE(chunked_file.Write(&data[index], size));
+    ASSERT_TRUE(string_file.Write(&data[index], size));
+    ASSERT_EQ(chunked_file.ToString(), string_file.string());
+  }
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
@@ -15,10 +15,12 @@
 #ifndef CRASHPAD_UTIL_FILE_DELIMITED_FILE_READER_H_
 #define CRASHPAD_UTIL_FILE_DELIMITED_FILE_READER_H_
 
-#include <stdint.h>
+#include <stddef.h>
 
+#include <memory>
 #include <string>
 
+#include "base/strings/string_piece.h"
 #include "util/file/file_reader.h"
 
 namespace crashpad {
@@ -29,8 +31,8 @@ namespace crashpad {
 //! characters. When the delimiter character is the newline character
 //! (<code>'\\n'</code>), the file is interpreted as a series of lines.
 //!
-//! It is safe to mix GetDelim() and GetLine() calls, if appropriate for the
-//! format being interpreted.
+//! It is safe to mix GetDelim(), GetLine(), GetDelimView(), and GetLineView()
+//! calls, if appropriate for the format being interpreted.
 //!
 //! This is a replacement for the standard library’s `getdelim()` and
 //! `getline()` functions, adapted to work with FileReaderInterface objects
@@ -49,7 +51,15 @@ class DelimitedFileReader {
     kEndOfFile,
   };
 
-  explicit DelimitedFileReader(FileReaderInterface* file_reader);
+  //! \brief The default size of the buffer that the file is read into.
+  static constexpr size_t kDefaultBufferSize = 4096;
+
+  //! \param[in] file_reader The file to read from.
+  //! \param[in] buffer_size The number of bytes to read from the file at a
+  //!     time. Fields that fit within this many bytes can usually be returned
+  //!     by GetDelimView() and GetLineView() without being copied.
+  explicit DelimitedFileReader(FileReaderInterface* file_reader,
+                               size_t buffer_size = kDefaultBufferSize);
 
   DelimitedFileReader(const DelimitedFileReader&) = delete;
   DelimitedFileReader& operator=(const DelimitedFileReader&) = delete;
@@ -81,11 +91,38 @@ class DelimitedFileReader {
   //!     returned.
   Result GetLine(std::string* line);
 
+  //! \brief Reads a single field from the file, without copying it when
+  //!     possible.
+  //!
+  //! This behaves as GetDelim(), but \a field refers to data held by this
+  //! object. It is normally a view into the buffer that the file was read
+  //! into, and is only copied when it spans more than one read from the file.
+  //!
+  //! \param[in] delimiter The delimiter character that terminates the field.
+  //! \param[out] field The field read from the file, valid until the next call
+  //!     to any method of this object or its destruction.
+  //!
+  //! \return a #Result value. \a field is only valid when Result::kSuccess is
+  //!     returned.
+  Result GetDelimView(char delimiter, base::StringPiece* field);
+
+  //! \brief Reads a single line from the file, without copying it when
+  //!     possible.
+  //!
+  //! This behaves as GetLine(), with the lifetime of \a line as described for
+  //! GetDelimView().
+  Result GetLineView(base::StringPiece* line);
+
  private:
-  char buf_[4096];
+  std::unique_ptr<char[]> buf_;
+  size_t buf_size_;
+  size_t buf_pos_;  // Index into buf_ of the start of the next field.
+  size_t buf_len_;  // The size of buf_ that’s been filled.
+
+  // Holds a field that spans more than one read from the file.
+  std::string spanning_field_;
+
   FileReaderInterface* file_reader_;  // weak
-  uint16_t buf_pos_;  // Index into buf_ of the start of the next field.
-  uint16_t buf_len_;  // The size of buf_ that’s been filled.
   bool eof_;  // Caches the EOF signal when detected following a partial field.
 };
 
@@ -18,6 +18,7 @@
 #include <vector>
 
 #include "base/format_macros.h"
+#include "base/strings/string_piece.h"
 #include "base/strings/stringprintf.h"
 #include "gtest/gtest.h"
 #include "util/file/string_file.h"
@@ -360,6 +361,70 @@ TEST(DelimitedFileReader, EdgeCases) {
   }
 }
 
+TEST(DelimitedFileReader, Views) {
+  StringFile string_file;
+  static constexpr char kString[] = "field\nspanning field\n\nlast";
+  string_file.SetString(std::string(kString, std::size(kString) - 1));
+
+  // The buffer is smaller than some fields, so those span refills.
+  DelimitedFileReader delimited_file_reader(&string_file, 6);
+
+  base::StringPiece line;
+  ASSERT_EQ(delimited_file_reader.GetLineView(&line),
+            DelimitedFileReader::Result::kSuccess);
+  EXPECT_EQ(line, "field\n");
+  ASSERT_EQ(delimited_file_reader.GetLineView(&line),
+            DelimitedFileReader::Result::kSuccess);
+  EXPECT_EQ(line, "spanning field\n");
+  ASSERT_EQ(delimited_file_reader.GetDelimView(' ', &line),
+            DelimitedFileReader::Result::kSuccess);
+  EXPECT_EQ(line, "\nlast");
+  EXPECT_EQ(delimited_file_reader.GetLineView(&line),
+            DelimitedFileReader::Result::kEndOfFile);
+
+  // Mixing views and copies works.
+  string_file.SetString("a b\ncd\n");
+  ASSERT_EQ(delimited_file_reader.GetDelimView(' ', &line),
+            DelimitedFileReader::Result::kSuccess);
+  EXPECT_EQ(line, "a ");
+  std::string copy;
+  ASSERT_EQ(delimited_file_reader.GetLine(&copy),
+            DelimitedFileReader::Result::kSuccess);
+  EXPECT_EQ(copy, "b\n");
+  ASSERT_EQ(delimited_file_reader.GetLineView(&line),
+            DelimitedFileReader::Result::kSuccess);
+  EXPECT_EQ(line, "cd\n");
+  EXPECT_EQ(delimited_file_reader.GetLineView(&line),
+            DelimitedFileReader::Result::kEndOfFile);
+}
+
+TEST(DelimitedFileReader, BufferSizes) {
+  std::string contents;
+  for (size_t index = 0; index < 100; ++index) {
+    contents.append(index % 13, static_cast<char>('a' + index % 26));
+    contents.push_back('\n');
+  }
+
+  static constexpr size_t kBufferSizes[] = {1, 2, 7, 64, 4096};
+  for (size_t buffer_size : kBufferSizes) {
+    SCOPED_TRACE(base::StringPrintf("buffer_size %" PRIuS, buffer_size));
+
+    StringFile string_file;
+    string_file.SetString(contents);
+    DelimitedFileReader delimited_file_reader(&string_file, buffer_size);
+
+    std::string read;
+    base::StringPiece line;
+    while (delimited_file_reader.GetLineView(&line) ==
+           DelimitedFileReader::Result::kSuccess) {
+      ASSERT_FALSE(line.empty());
+      EXPECT_EQ(line.back(), '\n');
+      read.append(line.data(), line.size());
+    }
+    EXPECT_EQ(read, contents);
+  }
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace crashpad
@@ -14,6 +14,17 @@
 
 #include "util/file/file_helper.h"
 
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+
+#include "base/posix/eintr_wrapper.h"
+
+#if !defined(FICLONE)
+#define FICLONE _IOW(0x94, 9, int)
+#endif
+#endif
+
 namespace crashpad {
 
 void CopyFileContent(FileReaderInterface* file_reader,
@@ -31,4 +42,23 @@ void CopyFileContent(FileReaderInterface* file_reader,
   } while (read_result > 0);
 }
 
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+bool CloneFileContent(FileHandle source, FileHandle destination) {
+  return HANDLE_EINTR(ioctl(destination, FICLONE, source)) == 0;
+}
+#endif
+
+void CloneOrCopyFileContent(FileHandle source, FileWriter* file_writer) {
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+  // A clone is made without reading or writing the file’s data. If the
+  // filesystem can’t make one, the file is copied.
+  if (CloneFileContent(source, file_writer->fd())) {
+    return;
+  }
+#endif
+
+  WeakFileHandleFileReader file_reader(source);
+  CopyFileContent(&file_reader, file_writer);
+}
+
 }  // namespace crashpad
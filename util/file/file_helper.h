@@ -15,6 +15,8 @@
 #ifndef CRASHPAD_UTIL_FILE_FILE_HELPER_H_
 #define CRASHPAD_UTIL_FILE_FILE_HELPER_H_
 
+#include "build/build_config.h"
+#include "util/file/file_io.h"
 #include "util/file/file_reader.h"
 #include "util/file/file_writer.h"
 
@@ -24,6 +26,31 @@ namespace crashpad {
 void CopyFileContent(FileReaderInterface* file_reader,
                      FileWriterInterface* file_writer);
 
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID) || \
+    DOXYGEN
+//! \brief Makes the file open at \a destination a copy-on-write clone of the
+//!     whole file open at \a source.
+//!
+//! On filesystems that support it, such as btrfs and XFS, the clone shares the
+//! source’s data blocks, so it is made in time independent of the file’s size,
+//! and later changes to either file aren’t seen in the other.
+//!
+//! \return `true` on success. `false` if the files can’t be cloned, such as
+//!     because their filesystem doesn’t support it or they are on different
+//!     filesystems, without logging anything. The caller is expected to fall
+//!     back to CopyFileContent().
+bool CloneFileContent(FileHandle source, FileHandle destination);
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID) || DOXYGEN
+
+//! \brief Makes the file written by \a file_writer a clone of the whole file
+//!     open at \a source where CloneFileContent() can, and otherwise copies
+//!     \a source to it with CopyFileContent().
+//!
+//! \a source is copied from its current position, so it should be at its
+//! start. It needn’t be a regular file: a pipe can’t be cloned, but is copied.
+void CloneOrCopyFileContent(FileHandle source, FileWriter* file_writer);
+
 }  // namespace crashpad
 
 #endif  // CRASHPAD_UTIL_FILE_FILE_HELPER_H_
@@ -0,0 +1,119 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/file/file_helper.h"
+
+#include <string>
+
+#include "base/files/file_path.h"
+#include "build/build_config.h"
+#include "gtest/gtest.h"
+#include "test/errors.h"
+#include "test/scoped_temp_dir.h"
+#include "util/file/file_io.h"
+#include "util/file/file_writer.h"
+
+#if BUILDFLAG(IS_POSIX)
+#include <unistd.h>
+
+#include "base/files/scoped_file.h"
+#endif  // BUILDFLAG(IS_POSIX)
+
+namespace crashpad {
+namespace test {
+namespace {
+
+// Returns contents that take several of CopyFileContent()’s reads, and that
+// include bytes that a string-based copy might lose.
+std::string TestContents() {
+  std::string contents;
+  for (size_t index = 0; index < 3 * 4096 + 17; ++index) {
+    contents.push_back(static_cast<char>(index * 7));
+  }
+  return contents;
+}
+
+TEST(FileHelper, CloneOrCopyFileContent) {
+  ScopedTempDir temp_dir;
+  const base::FilePath source_path(
+      temp_dir.path().Append(FILE_PATH_LITERAL("source")));
+  const std::string contents = TestContents();
+  {
+    ScopedFileHandle source(
+        LoggingOpenFileForWrite(source_path,
+                                FileWriteMode::kCreateOrFail,
+                                FilePermissions::kOwnerOnly));
+    ASSERT_TRUE(source.is_valid());
+    ASSERT_TRUE(
+        LoggingWriteFile(source.get(), contents.data(), contents.size()));
+  }
+
+  // Whether the file is cloned depends on the filesystem of temp_dir. Either
+  // way, the result is the same.
+  ScopedFileHandle source(LoggingOpenFileForRead(source_path));
+  ASSERT_TRUE(source.is_valid());
+  const base::FilePath destination_path(
+      temp_dir.path().Append(FILE_PATH_LITERAL("destination")));
+  FileWriter writer;
+  ASSERT_TRUE(writer.Open(destination_path,
+                          FileWriteMode::kCreateOrFail,
+                          FilePermissions::kOwnerOnly));
+  CloneOrCopyFileContent(source.get(), &writer);
+  writer.Close();
+
+  std::string destination_contents;
+  ASSERT_TRUE(LoggingReadEntireFile(destination_path, &destination_contents));
+  EXPECT_EQ(destination_contents, contents);
+}
+
+#if BUILDFLAG(IS_POSIX)
+TEST(FileHelper, CloneOrCopyFileContentFromPipe) {
+  int pipe_fds[2];
+  ASSERT_EQ(pipe(pipe_fds), 0) << ErrnoMessage("pipe");
+  base::ScopedFD read_fd(pipe_fds[0]);
+  base::ScopedFD write_fd(pipe_fds[1]);
+
+  // The contents fit in the pipe’s buffer, so they can all be written before
+  // any are read.
+  const std::string contents = TestContents();
+  ASSERT_TRUE(
+      LoggingWriteFile(write_fd.get(), contents.data(), contents.size()));
+  write_fd.reset();
+
+  ScopedTempDir temp_dir;
+  const base::FilePath destination_path(
+      temp_dir.path().Append(FILE_PATH_LITERAL("destination")));
+  FileWriter writer;
+  ASSERT_TRUE(writer.Open(destination_path,
+                          FileWriteMode::kCreateOrFail,
+                          FilePermissions::kOwnerOnly));
+
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+  // No filesystem can clone a pipe, so this tests falling back to copying.
+  EXPECT_FALSE(CloneFileContent(read_fd.get(), writer.fd()));
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+
+  CloneOrCopyFileContent(read_fd.get(), &writer);
+  writer.Close();
+
+  std::string destination_contents;
+  ASSERT_TRUE(LoggingReadEntireFile(destination_path, &destination_contents));
+  EXPECT_EQ(destination_contents, contents);
+}
+#endif  // BUILDFLAG(IS_POSIX)
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
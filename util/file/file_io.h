@@ -433,6 +433,10 @@ FileHandle LoggingOpenFileForWrite(const base::FilePath& path,
 //!
 //! Unlike other file open operations, this function doesn't set `O_CLOEXEC`.
 //!
+//! A file opened with `memfd_create()` allows seals to be added to it with
+//! `F_ADD_SEALS`, so that it can be made immutable before it's handed to
+//! another process.
+//!
 //! \param name A name associated with the file. This name does not indicate any
 //!     exact path and may not be used at all, depending on the strategy used to
 //!     create the file. The name should not contain any '/' characters.
@@ -518,6 +522,27 @@ FileOffset LoggingSeekFile(FileHandle file, FileOffset offset, int whence);
 //! \return `true` on success, or `false`, and a message will be logged.
 bool LoggingTruncateFile(FileHandle file);
 
+//! \brief Allocates storage for \a size bytes of the given \a file, starting at
+//!     \a offset, without changing its length.
+//!
+//! This is an optimization for callers that know how much they’re about to
+//! write: the file system can allocate the space in one extent instead of
+//! growing the file write by write, and running out of space is discovered
+//! before anything is written. Where the platform or file system can’t reserve
+//! space, this does nothing and succeeds.
+//!
+//! \return `true` on success or if reserving space isn’t supported, or `false`,
+//!     and a message will be logged.
+bool LoggingReserveFileSpace(FileHandle file,
+                             FileOffset offset,
+                             FileOffset size);
+
+//! \brief Wraps `fsync()` or `FlushFileBuffers()`, writing the contents and
+//!     attributes of the given \a file to its storage device.
+//!
+//! \return `true` on success, or `false`, and a message will be logged.
+bool LoggingSyncFile(FileHandle file);
+
 //! \brief Wraps `close()` or `CloseHandle()`, logging an error if the operation
 //!     fails.
 //!
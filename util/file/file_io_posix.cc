@@ -32,6 +32,10 @@
 #include "build/build_config.h"
 #include "util/misc/random_string.h"
 
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+#include <linux/falloc.h>
+#endif
+
 namespace crashpad {
 
 namespace {
@@ -157,7 +161,8 @@ FileHandle LoggingOpenFileForWrite(const base::FilePath& path,
 FileHandle LoggingOpenMemoryFileForReadAndWrite(const base::FilePath& name) {
   DCHECK(name.value().find('/') == std::string::npos);
 
-  int result = HANDLE_EINTR(memfd_create(name.value().c_str(), 0));
+  int result =
+      HANDLE_EINTR(memfd_create(name.value().c_str(), MFD_ALLOW_SEALING));
   if (result >= 0 || errno != ENOSYS) {
     PLOG_IF(ERROR, result < 0) << "memfd_create";
     return result;
@@ -250,6 +255,35 @@ bool LoggingTruncateFile(FileHandle file) {
   return true;
 }
 
+bool LoggingReserveFileSpace(FileHandle file,
+                             FileOffset offset,
+                             FileOffset size) {
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+  if (size <= 0) {
+    return true;
+  }
+  if (HANDLE_EINTR(fallocate(file, FALLOC_FL_KEEP_SIZE, offset, size)) != 0) {
+    // These indicate that the file system or the kind of file doesn’t support
+    // reserving space, which only costs the optimization.
+    if (errno == EOPNOTSUPP || errno == ENOSYS || errno == ENODEV ||
+        errno == ESPIPE) {
+      return true;
+    }
+    PLOG(ERROR) << "fallocate";
+    return false;
+  }
+#endif
+  return true;
+}
+
+bool LoggingSyncFile(FileHandle file) {
+  if (HANDLE_EINTR(fsync(file)) != 0) {
+    PLOG(ERROR) << "fsync";
+    return false;
+  }
+  return true;
+}
+
 bool LoggingCloseFile(FileHandle file) {
   int rv = IGNORE_EINTR(close(file));
   PLOG_IF(ERROR, rv != 0) << "close";
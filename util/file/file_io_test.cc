@@ -741,6 +741,27 @@ TEST(FileIO, FileSizeByHandle) {
   EXPECT_EQ(LoggingFileSizeByHandle(file_handle.get()), 9);
 }
 
+TEST(FileIO, ReserveFileSpace) {
+  ScopedTempDir temp_dir;
+  base::FilePath file_path =
+      temp_dir.path().Append(FILE_PATH_LITERAL("reserved"));
+
+  ScopedFileHandle file_handle(LoggingOpenFileForWrite(
+      file_path, FileWriteMode::kCreateOrFail, FilePermissions::kOwnerOnly));
+  ASSERT_NE(file_handle.get(), kInvalidFileHandle);
+
+  // Reserving space doesn’t change the file’s size or position.
+  ASSERT_TRUE(LoggingReserveFileSpace(file_handle.get(), 0, 4096));
+  EXPECT_EQ(LoggingFileSizeByHandle(file_handle.get()), 0);
+  EXPECT_EQ(LoggingSeekFile(file_handle.get(), 0, SEEK_CUR), 0);
+
+  static constexpr char data[] = "zippyzap";
+  ASSERT_TRUE(LoggingWriteFile(file_handle.get(), &data, sizeof(data)));
+  EXPECT_EQ(LoggingFileSizeByHandle(file_handle.get()), 9);
+
+  EXPECT_TRUE(LoggingReserveFileSpace(file_handle.get(), 9, 0));
+}
+
 FileHandle FileHandleForFILE(FILE* file) {
   int fd = fileno(file);
 #if BUILDFLAG(IS_POSIX)
@@ -254,6 +254,22 @@ bool LoggingTruncateFile(FileHandle file) {
   return true;
 }
 
+bool LoggingReserveFileSpace(FileHandle file,
+                             FileOffset offset,
+                             FileOffset size) {
+  // Windows can only set a file’s allocation size from its start, which
+  // doesn’t suit a write in progress, so nothing is reserved.
+  return true;
+}
+
+bool LoggingSyncFile(FileHandle file) {
+  if (!FlushFileBuffers(file)) {
+    PLOG(ERROR) << "FlushFileBuffers";
+    return false;
+  }
+  return true;
+}
+
 bool LoggingCloseFile(FileHandle file) {
   BOOL rv = CloseHandle(file);
   PLOG_IF(ERROR, !rv) << "CloseHandle";
@@ -139,6 +139,14 @@ class FileReader : public FileReaderInterface {
   //!     a Close().
   FileOffset Seek(FileOffset offset, int whence) override;
 
+  //! \brief Returns the file handle opened by Open().
+  //!
+  //! The handle remains owned by this object, and shares its file position.
+  //!
+  //! \note It is only valid to call this method between a successful Open() and
+  //!     a Close().
+  FileHandle file_handle() const { return file_.get(); }
+
  private:
   ScopedFileHandle file_;
   WeakFileHandleFileReader weak_file_handle_file_reader_;
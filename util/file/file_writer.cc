@@ -145,6 +145,15 @@ bool WeakFileHandleFileWriter::WriteIoVec(std::vector<WritableIoVec>* iovecs) {
   return true;
 }
 
+bool WeakFileHandleFileWriter::ReserveSpace(FileOffset size) {
+  DCHECK_NE(file_handle_, kInvalidFileHandle);
+  const FileOffset offset = LoggingSeekFile(file_handle_, 0, SEEK_CUR);
+  if (offset < 0) {
+    return false;
+  }
+  return LoggingReserveFileSpace(file_handle_, offset, size);
+}
+
 FileOffset WeakFileHandleFileWriter::Seek(FileOffset offset, int whence) {
   DCHECK_NE(file_handle_, kInvalidFileHandle);
   return LoggingSeekFile(file_handle_, offset, whence);
@@ -182,7 +191,9 @@ bool FileWriter::OpenMemfd(const base::FilePath& path) {
   weak_file_handle_file_writer_.set_file_handle(file_.get());
   return true;
 }
+#endif
 
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
 int FileWriter::fd() {
   return file_.get();
 }
@@ -195,6 +206,11 @@ void FileWriter::Close() {
   file_.reset();
 }
 
+bool FileWriter::Sync() {
+  DCHECK(file_.is_valid());
+  return LoggingSyncFile(file_.get());
+}
+
 bool FileWriter::Write(const void* data, size_t size) {
   DCHECK(file_.is_valid());
   return weak_file_handle_file_writer_.Write(data, size);
@@ -205,6 +221,11 @@ bool FileWriter::WriteIoVec(std::vector<WritableIoVec>* iovecs) {
   return weak_file_handle_file_writer_.WriteIoVec(iovecs);
 }
 
+bool FileWriter::ReserveSpace(FileOffset size) {
+  DCHECK(file_.is_valid());
+  return weak_file_handle_file_writer_.ReserveSpace(size);
+}
+
 FileOffset FileWriter::Seek(FileOffset offset, int whence) {
   DCHECK(file_.is_valid());
   return weak_file_handle_file_writer_.Seek(offset, whence);
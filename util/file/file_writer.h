@@ -63,6 +63,17 @@ class FileWriterInterface : public virtual FileSeekerInterface {
   //!
   //! \note The contents of \a iovecs are undefined when this method returns.
   virtual bool WriteIoVec(std::vector<WritableIoVec>* iovecs) = 0;
+
+  //! \brief Indicates that \a size bytes will be written following the current
+  //!     position, so that storage for them may be allocated up front.
+  //!
+  //! This is only a hint, and doesn’t change the position or what has been
+  //! written. Writers that don’t write to files, or can’t reserve space,
+  //! ignore it. The default implementation ignores it.
+  //!
+  //! \return `true` if the space was reserved or the hint was ignored, `false`
+  //!     if the space couldn’t be reserved, with an error message logged.
+  virtual bool ReserveSpace(FileOffset size) { return true; }
 };
 
 //! \brief A file writer backed by a FileHandle.
@@ -92,6 +103,9 @@ class WeakFileHandleFileWriter : public FileWriterInterface {
   bool Write(const void* data, size_t size) override;
   bool WriteIoVec(std::vector<WritableIoVec>* iovecs) override;
 
+  //! \brief Wraps LoggingReserveFileSpace() at the current position.
+  bool ReserveSpace(FileOffset size) override;
+
   // FileSeekerInterface:
 
   //! \copydoc FileWriterInterface::Seek()
@@ -146,10 +160,13 @@ class FileWriter : public FileWriterInterface {
   //! \note After a successful call, this method or Open() cannot be called
   //      again until after Close().
   bool OpenMemfd(const base::FilePath& path);
+#endif
 
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
   //! \brief Returns the underlying file descriptor.
   //!
-  //! \note This is used when this writes to a Memfd.
+  //! \note This is used when this writes to a Memfd, and to clone a file into
+  //!     this one with CloneFileContent().
   int fd();
 #endif
 
@@ -160,6 +177,12 @@ class FileWriter : public FileWriterInterface {
   //!     to this method.
   void Close();
 
+  //! \brief Wraps LoggingSyncFile().
+  //!
+  //! \note It is only valid to call this method between a successful Open() and
+  //!     a Close().
+  bool Sync();
+
   // FileWriterInterface:
 
   //! \copydoc FileWriterInterface::Write()
@@ -174,6 +197,12 @@ class FileWriter : public FileWriterInterface {
   //!     a Close().
   bool WriteIoVec(std::vector<WritableIoVec>* iovecs) override;
 
+  //! \copydoc WeakFileHandleFileWriter::ReserveSpace()
+  //!
+  //! \note It is only valid to call this method between a successful Open() and
+  //!     a Close().
+  bool ReserveSpace(FileOffset size) override;
+
   // FileSeekerInterface:
 
   //! \copydoc FileWriterInterface::Seek()
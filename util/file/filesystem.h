@@ -111,6 +111,17 @@ bool LoggingRemoveFile(const base::FilePath& path);
 //! \return `true` if the directory was removed. Otherwise, `false`.
 bool LoggingRemoveDirectory(const base::FilePath& path);
 
+//! \brief Writes a directory’s entries to its storage device, logging a
+//!     message on failure.
+//!
+//! This makes the creation, removal, and renaming of the directory’s entries
+//! durable. On Windows, where directories can’t be synced this way, this does
+//! nothing.
+//!
+//! \param[in] path The path to the directory to sync.
+//! \return `true` on success. `false` on failure with a message logged.
+bool LoggingSyncDirectory(const base::FilePath& path);
+
 //! \brief Returns the size of the file at |filepath|.
 //!    The function will ignore symlinks (not follow them, not add them to
 //!    the returned size).
@@ -127,6 +138,22 @@ uint64_t GetFileSize(const base::FilePath& filepath);
 //! \return The sum of the size of the files in |dirPath|.
 uint64_t GetDirectorySize(const base::FilePath& dirPath);
 
+//! \brief Creates a hard link to a file.
+//!
+//! \param[in] existing The path to the file to link to.
+//! \param[in] link The path of the link to create, which must not exist.
+//!
+//! \return `true` on success. `false` if the link can’t be created, such as
+//!     because the filesystem doesn’t support hard links or the paths are on
+//!     different filesystems, without logging anything. The caller is expected
+//!     to fall back to copying the file.
+bool MakeHardLink(const base::FilePath& existing, const base::FilePath& link);
+
+//! \brief Returns the number of hard links to the file at |filepath|.
+//!
+//! \return The number of links, or `0` on failure with a message logged.
+uint64_t GetFileLinkCount(const base::FilePath& filepath);
+
 }  // namespace crashpad
 
 #endif  // CRASHPAD_UTIL_FILE_FILESYSTEM_H_
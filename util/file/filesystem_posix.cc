@@ -15,12 +15,14 @@
 #include "util/file/filesystem.h"
 
 #include <errno.h>
+#include <fcntl.h>
 #include <stdio.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
 
 #include "base/logging.h"
+#include "base/posix/eintr_wrapper.h"
 #include "build/build_config.h"
 #include "util/file/directory_reader.h"
 
@@ -113,6 +115,16 @@ bool LoggingRemoveDirectory(const base::FilePath& path) {
   return true;
 }
 
+bool LoggingSyncDirectory(const base::FilePath& path) {
+  ScopedFileHandle handle(HANDLE_EINTR(
+      open(path.value().c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC)));
+  if (!handle.is_valid()) {
+    PLOG(ERROR) << "open " << path.value();
+    return false;
+  }
+  return LoggingSyncFile(handle.get());
+}
+
 uint64_t GetFileSize(const base::FilePath& filepath) {
   if (!IsRegularFile(filepath)) {
     return 0;
@@ -147,4 +159,17 @@ uint64_t GetDirectorySize(const base::FilePath& dirpath) {
   }
   return size;
 }
+bool MakeHardLink(const base::FilePath& existing, const base::FilePath& link) {
+  return ::link(existing.value().c_str(), link.value().c_str()) == 0;
+}
+
+uint64_t GetFileLinkCount(const base::FilePath& filepath) {
+  struct stat statbuf;
+  if (lstat(filepath.value().c_str(), &statbuf) != 0) {
+    PLOG(ERROR) << "lstat " << filepath.value();
+    return 0;
+  }
+  return statbuf.st_nlink;
+}
+
 }  // namespace crashpad
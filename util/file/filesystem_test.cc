@@ -447,6 +447,27 @@ TEST(Filesystem, RemoveDirectory) {
   EXPECT_TRUE(LoggingRemoveDirectory(dir));
 }
 
+TEST(Filesystem, SyncDirectory) {
+  ScopedTempDir temp_dir;
+
+  base::FilePath dir(temp_dir.path().Append(FILE_PATH_LITERAL("dir")));
+#if !BUILDFLAG(IS_WIN)
+  EXPECT_FALSE(LoggingSyncDirectory(dir));
+#endif  // !BUILDFLAG(IS_WIN)
+
+  ASSERT_TRUE(
+      LoggingCreateDirectory(dir, FilePermissions::kWorldReadable, false));
+  base::FilePath file(dir.Append(FILE_PATH_LITERAL("file")));
+  FileWriter writer;
+  ASSERT_TRUE(writer.Open(
+      file, FileWriteMode::kCreateOrFail, FilePermissions::kOwnerOnly));
+  ASSERT_TRUE(writer.Write(kTestFileContent, sizeof(kTestFileContent)));
+  EXPECT_TRUE(writer.Sync());
+  writer.Close();
+
+  EXPECT_TRUE(LoggingSyncDirectory(dir));
+}
+
 #if !BUILDFLAG(IS_FUCHSIA)
 
 TEST(Filesystem, RemoveDirectory_SymbolicLinks) {
@@ -530,6 +551,37 @@ TEST(Filesystem, GetDirectorySize) {
   EXPECT_EQ(filesize, 2 * sizeof(kTestFileContent));
 }
 
+#if !BUILDFLAG(IS_FUCHSIA)
+
+TEST(Filesystem, MakeHardLink) {
+  ScopedTempDir temp_dir;
+  base::FilePath file(temp_dir.path().Append(FILE_PATH_LITERAL("file")));
+  base::FilePath link(temp_dir.path().Append(FILE_PATH_LITERAL("link")));
+  EXPECT_FALSE(MakeHardLink(file, link));
+
+  FileWriter writer;
+  ASSERT_TRUE(writer.Open(
+      file, FileWriteMode::kCreateOrFail, FilePermissions::kOwnerOnly));
+  ASSERT_TRUE(writer.Write(kTestFileContent, sizeof(kTestFileContent)));
+  writer.Close();
+  EXPECT_EQ(GetFileLinkCount(file), 1u);
+
+  ASSERT_TRUE(MakeHardLink(file, link));
+  EXPECT_TRUE(IsRegularFile(link));
+  EXPECT_EQ(GetFileSize(link), sizeof(kTestFileContent));
+  EXPECT_EQ(GetFileLinkCount(file), 2u);
+  EXPECT_EQ(GetFileLinkCount(link), 2u);
+
+  // The link must not already exist.
+  EXPECT_FALSE(MakeHardLink(file, link));
+
+  EXPECT_TRUE(LoggingRemoveFile(file));
+  EXPECT_EQ(GetFileLinkCount(link), 1u);
+  EXPECT_EQ(GetFileSize(link), sizeof(kTestFileContent));
+}
+
+#endif  // !BUILDFLAG(IS_FUCHSIA)
+
 }  // namespace
 }  // namespace test
 }  // namespace crashpad
@@ -160,6 +160,12 @@ bool LoggingRemoveDirectory(const base::FilePath& path) {
   return LoggingRemoveDirectoryImpl(path);
 }
 
+bool LoggingSyncDirectory(const base::FilePath& path) {
+  // Windows has no equivalent to syncing a directory, and NTFS journals the
+  // changes to directory entries.
+  return true;
+}
+
 uint64_t GetFileSize(const base::FilePath& filepath) {
   struct _stati64 statbuf;
   if (!IsRegularFile(filepath)) {
@@ -196,4 +202,32 @@ uint64_t GetDirectorySize(const base::FilePath& dirpath) {
   return size;
 }
 
+bool MakeHardLink(const base::FilePath& existing, const base::FilePath& link) {
+  return CreateHardLink(
+      link.value().c_str(), existing.value().c_str(), nullptr);
+}
+
+uint64_t GetFileLinkCount(const base::FilePath& filepath) {
+  ScopedFileHandle handle(
+      ::CreateFile(filepath.value().c_str(),
+                   FILE_READ_ATTRIBUTES,
+                   FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                   nullptr,
+                   OPEN_EXISTING,
+                   FILE_FLAG_OPEN_REPARSE_POINT,
+                   nullptr));
+  if (!handle.is_valid()) {
+    PLOG(ERROR) << "CreateFile " << base::WideToUTF8(filepath.value());
+    return 0;
+  }
+
+  BY_HANDLE_FILE_INFORMATION information;
+  if (!GetFileInformationByHandle(handle.get(), &information)) {
+    PLOG(ERROR) << "GetFileInformationByHandle "
+                << base::WideToUTF8(filepath.value());
+    return 0;
+  }
+  return information.nNumberOfLinks;
+}
+
 }  // namespace crashpad
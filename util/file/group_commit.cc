@@ -0,0 +1,115 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/file/group_commit.h"
+
+#include <chrono>
+#include <utility>
+
+#include "base/check_op.h"
+
+namespace crashpad {
+
+GroupCommit::Change::Change(GroupCommit* group)
+    : group_(group), in_flight_(true) {
+  group_->Begin();
+}
+
+GroupCommit::Change::~Change() {
+  if (in_flight_) {
+    group_->Abandon();
+  }
+}
+
+bool GroupCommit::Change::Commit() {
+  DCHECK(in_flight_);
+  in_flight_ = false;
+  return group_->Commit();
+}
+
+GroupCommit::GroupCommit(std::function<bool()> sync, double window)
+    : mutex_(),
+      condition_(),
+      sync_(std::move(sync)),
+      window_(window),
+      in_flight_(0),
+      commit_count_(0),
+      attempted_count_(0),
+      synced_count_(0),
+      syncing_(false) {
+  DCHECK_GE(window_, 0);
+}
+
+GroupCommit::~GroupCommit() {
+  DCHECK_EQ(in_flight_, 0u);
+}
+
+void GroupCommit::Begin() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ++in_flight_;
+}
+
+void GroupCommit::Abandon() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  DCHECK_GT(in_flight_, 0u);
+  --in_flight_;
+
+  // A thread waiting for changes in flight to join its group may no longer
+  // need to.
+  condition_.notify_all();
+}
+
+bool GroupCommit::Commit() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  DCHECK_GT(in_flight_, 0u);
+  --in_flight_;
+  const uint64_t commit = ++commit_count_;
+  condition_.notify_all();
+
+  while (attempted_count_ < commit) {
+    if (syncing_) {
+      condition_.wait(lock);
+      continue;
+    }
+
+    // Lead the next group, first giving the changes still in flight a chance
+    // to join it.
+    syncing_ = true;
+    if (in_flight_ > 0 && window_ > 0) {
+      const auto deadline = std::chrono::steady_clock::now() +
+                            std::chrono::duration_cast<
+                                std::chrono::steady_clock::duration>(
+                                std::chrono::duration<double>(window_));
+      condition_.wait_until(
+          lock, deadline, [this]() { return in_flight_ == 0; });
+    }
+
+    const uint64_t group_end = commit_count_;
+    lock.unlock();
+    const bool synced = sync_();
+    lock.lock();
+
+    attempted_count_ = group_end;
+    if (synced) {
+      synced_count_ = group_end;
+    }
+    syncing_ = false;
+    condition_.notify_all();
+  }
+
+  // A later successful sync also covers a commit whose own group failed.
+  return synced_count_ >= commit;
+}
+
+}  // namespace crashpad
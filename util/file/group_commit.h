@@ -0,0 +1,108 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_UTIL_FILE_GROUP_COMMIT_H_
+#define CRASHPAD_UTIL_FILE_GROUP_COMMIT_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+
+namespace crashpad {
+
+//! \brief Shares the syncs that make changes durable among changes made at
+//!     about the same time.
+//!
+//! A change made by several steps, such as writing a file and then renaming
+//! it into place, is only durable once a sync that began after its last step
+//! has finished. A single sync, such as of the directory that several files
+//! were renamed into, can commit many changes at once. Each change is
+//! represented by a Change object, which is constructed before the change
+//! begins and committed once the change is complete. The first change to be
+//! committed while others are still in flight waits for up to the window for
+//! them to be committed too, then syncs once for all of them. A change
+//! committed while no others are in flight is synced right away.
+//!
+//! This class is thread-safe.
+class GroupCommit {
+ public:
+  //! \brief A change that is made durable by a group commit.
+  class Change {
+   public:
+    //! \brief Marks a change to be committed by \a group as in flight.
+    explicit Change(GroupCommit* group);
+
+    Change(const Change&) = delete;
+    Change& operator=(const Change&) = delete;
+
+    //! \brief Marks the change as no longer in flight, if it was not
+    //!     committed.
+    ~Change();
+
+    //! \brief Returns once a sync that began after this call has finished.
+    //!
+    //! This must be called at most once.
+    //!
+    //! \return `true` if the sync succeeded, or `false` if it failed.
+    bool Commit();
+
+   private:
+    GroupCommit* group_;  // weak
+    bool in_flight_;
+  };
+
+  //! \param[in] sync The function that makes changes durable. It returns
+  //!     `true` on success. It is always called from a thread that is
+  //!     committing a change, and never by more than one thread at a time.
+  //! \param[in] window The longest time, in seconds, that a change waits for
+  //!     others in flight to join its group. With a window of `0`, changes
+  //!     only share a sync when they are committed while an earlier sync is
+  //!     in progress.
+  GroupCommit(std::function<bool()> sync, double window);
+
+  GroupCommit(const GroupCommit&) = delete;
+  GroupCommit& operator=(const GroupCommit&) = delete;
+
+  ~GroupCommit();
+
+ private:
+  void Begin();
+  void Abandon();
+  bool Commit();
+
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  const std::function<bool()> sync_;
+  const double window_;
+
+  // The number of changes begun but not yet committed or abandoned.
+  size_t in_flight_;
+
+  // Commits are numbered in order. Every commit up to synced_count_ has been
+  // covered by a successful sync, and every commit up to attempted_count_ by a
+  // sync that has finished.
+  uint64_t commit_count_;
+  uint64_t attempted_count_;
+  uint64_t synced_count_;
+
+  // Whether a thread is syncing, or waiting to sync, for a group.
+  bool syncing_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_UTIL_FILE_GROUP_COMMIT_H_
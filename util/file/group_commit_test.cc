@@ -0,0 +1,176 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/file/group_commit.h"
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "util/misc/clock.h"
+#include "util/thread/thread.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+// Long enough that a test waiting for it would time out.
+constexpr double kLongWindow = 60;
+constexpr uint64_t kLongWindowNanoseconds = 60'000'000'000;
+
+class CommitThread : public Thread {
+ public:
+  explicit CommitThread(GroupCommit::Change* change)
+      : Thread(), change_(change), result_(false) {}
+
+  CommitThread(const CommitThread&) = delete;
+  CommitThread& operator=(const CommitThread&) = delete;
+
+  ~CommitThread() override {}
+
+  bool result() const { return result_; }
+
+ private:
+  void ThreadMain() override { result_ = change_->Commit(); }
+
+  GroupCommit::Change* change_;  // weak
+  bool result_;
+};
+
+class AbandonThread : public Thread {
+ public:
+  explicit AbandonThread(std::unique_ptr<GroupCommit::Change> change)
+      : Thread(), change_(std::move(change)) {}
+
+  AbandonThread(const AbandonThread&) = delete;
+  AbandonThread& operator=(const AbandonThread&) = delete;
+
+  ~AbandonThread() override {}
+
+ private:
+  void ThreadMain() override {
+    SleepNanoseconds(10'000'000);
+    change_.reset();
+  }
+
+  std::unique_ptr<GroupCommit::Change> change_;
+};
+
+TEST(GroupCommit, LoneChangeSyncsRightAway) {
+  std::atomic<int> syncs(0);
+  GroupCommit group(
+      [&syncs]() {
+        ++syncs;
+        return true;
+      },
+      kLongWindow);
+
+  const uint64_t start = ClockMonotonicNanoseconds();
+  for (int index = 0; index < 3; ++index) {
+    GroupCommit::Change change(&group);
+    EXPECT_TRUE(change.Commit());
+  }
+  EXPECT_LT(ClockMonotonicNanoseconds() - start, kLongWindowNanoseconds / 2);
+  EXPECT_EQ(syncs, 3);
+}
+
+TEST(GroupCommit, ChangesInFlightShareSync) {
+  std::atomic<int> syncs(0);
+  GroupCommit group(
+      [&syncs]() {
+        ++syncs;
+        return true;
+      },
+      kLongWindow);
+
+  // Every change is in flight before any is committed, so the first to be
+  // committed waits for the rest, and a single sync commits all of them.
+  constexpr size_t kChanges = 8;
+  std::vector<std::unique_ptr<GroupCommit::Change>> changes;
+  std::vector<std::unique_ptr<CommitThread>> threads;
+  for (size_t index = 0; index < kChanges; ++index) {
+    changes.push_back(std::make_unique<GroupCommit::Change>(&group));
+    threads.push_back(std::make_unique<CommitThread>(changes.back().get()));
+  }
+
+  const uint64_t start = ClockMonotonicNanoseconds();
+  for (auto& thread : threads) {
+    thread->Start();
+  }
+  for (auto& thread : threads) {
+    thread->Join();
+    EXPECT_TRUE(thread->result());
+  }
+  EXPECT_LT(ClockMonotonicNanoseconds() - start, kLongWindowNanoseconds / 2);
+  EXPECT_EQ(syncs, 1);
+}
+
+TEST(GroupCommit, AbandonedChangeReleasesGroup) {
+  std::atomic<int> syncs(0);
+  GroupCommit group(
+      [&syncs]() {
+        ++syncs;
+        return true;
+      },
+      kLongWindow);
+
+  GroupCommit::Change change(&group);
+  AbandonThread thread(std::make_unique<GroupCommit::Change>(&group));
+  const uint64_t start = ClockMonotonicNanoseconds();
+  thread.Start();
+  EXPECT_TRUE(change.Commit());
+  thread.Join();
+  EXPECT_LT(ClockMonotonicNanoseconds() - start, kLongWindowNanoseconds / 2);
+  EXPECT_EQ(syncs, 1);
+}
+
+TEST(GroupCommit, WindowExpires) {
+  std::atomic<int> syncs(0);
+  GroupCommit group(
+      [&syncs]() {
+        ++syncs;
+        return true;
+      },
+      0.01);
+
+  // A change in flight that isn’t committed within the window is left for the
+  // next group.
+  GroupCommit::Change straggler(&group);
+  {
+    GroupCommit::Change change(&group);
+    EXPECT_TRUE(change.Commit());
+  }
+  EXPECT_EQ(syncs, 1);
+  EXPECT_TRUE(straggler.Commit());
+  EXPECT_EQ(syncs, 2);
+}
+
+TEST(GroupCommit, FailedSync) {
+  bool succeed = false;
+  GroupCommit group([&succeed]() { return succeed; }, 0);
+
+  {
+    GroupCommit::Change change(&group);
+    EXPECT_FALSE(change.Commit());
+  }
+
+  succeed = true;
+  GroupCommit::Change change(&group);
+  EXPECT_TRUE(change.Commit());
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
@@ -0,0 +1,86 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_UTIL_FILE_MAPPED_FILE_READER_H_
+#define CRASHPAD_UTIL_FILE_MAPPED_FILE_READER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "base/files/file_path.h"
+#include "util/file/file_io.h"
+#include "util/file/file_reader.h"
+
+namespace crashpad {
+
+//! \brief A file reader that maps a file into memory.
+//!
+//! Open() maps an entire file read-only. Its contents are then available
+//! directly through data(), without being copied, as well as through the
+//! FileReaderInterface, which copies out of the mapping like any other file
+//! reader. The file must not be truncated while it is mapped.
+class MappedFileReader : public FileReaderInterface {
+ public:
+  MappedFileReader();
+
+  MappedFileReader(const MappedFileReader&) = delete;
+  MappedFileReader& operator=(const MappedFileReader&) = delete;
+
+  ~MappedFileReader() override;
+
+  //! \brief Maps a file, replacing any file mapped previously, and resets the
+  //!     file position to `0`.
+  //!
+  //! \param[in] path The file to map.
+  //!
+  //! \return `true` on success. `false` on failure, with a message logged.
+  bool Open(const base::FilePath& path);
+
+  //! \brief Unmaps the file, if one is mapped.
+  void Close();
+
+  //! \brief Returns the contents of the mapped file, or `nullptr` if no file
+  //!     is mapped or the file is empty.
+  const uint8_t* data() const { return data_; }
+
+  //! \brief Returns the size of the mapped file.
+  size_t size() const { return size_; }
+
+  // FileReaderInterface:
+  FileOperationResult Read(void* data, size_t size) override;
+
+  // FileSeekerInterface:
+  FileOffset Seek(FileOffset offset, int whence) override;
+
+ private:
+  //! \brief Maps the first \a size bytes of \a file, setting data_ and size_.
+  //!
+  //! This is implemented separately for each platform.
+  //!
+  //! \return `true` on success. `false` on failure, with a message logged.
+  bool Map(FileHandle file, size_t size);
+
+  //! \brief Releases the mapping made by Map().
+  //!
+  //! This is implemented separately for each platform.
+  void Unmap();
+
+  const uint8_t* data_;
+  size_t size_;
+  size_t offset_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_UTIL_FILE_MAPPED_FILE_READER_H_
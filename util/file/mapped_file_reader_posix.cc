@@ -0,0 +1,41 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/file/mapped_file_reader.h"
+
+#include <sys/mman.h>
+
+#include "base/logging.h"
+
+namespace crashpad {
+
+bool MappedFileReader::Map(FileHandle file, size_t size) {
+  void* addr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+  if (addr == MAP_FAILED) {
+    PLOG(ERROR) << "mmap";
+    return false;
+  }
+
+  data_ = static_cast<const uint8_t*>(addr);
+  size_ = size;
+  return true;
+}
+
+void MappedFileReader::Unmap() {
+  if (munmap(const_cast<uint8_t*>(data_), size_) != 0) {
+    PLOG(ERROR) << "munmap";
+  }
+}
+
+}  // namespace crashpad
@@ -0,0 +1,94 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/file/mapped_file_reader.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include <string>
+
+#include "gtest/gtest.h"
+#include "test/scoped_temp_dir.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+void WriteTestFile(const base::FilePath& path, const std::string& contents) {
+  ScopedFileHandle handle(LoggingOpenFileForWrite(
+      path, FileWriteMode::kCreateOrFail, FilePermissions::kOwnerOnly));
+  ASSERT_TRUE(handle.is_valid());
+  ASSERT_TRUE(LoggingWriteFile(handle.get(), contents.data(), contents.size()));
+}
+
+TEST(MappedFileReader, MapAndRead) {
+  ScopedTempDir temp_dir;
+  const base::FilePath path =
+      temp_dir.path().Append(FILE_PATH_LITERAL("mapped"));
+  const std::string contents("mapped file contents");
+  ASSERT_NO_FATAL_FAILURE(WriteTestFile(path, contents));
+
+  MappedFileReader reader;
+  ASSERT_TRUE(reader.Open(path));
+  ASSERT_EQ(reader.size(), contents.size());
+  ASSERT_TRUE(reader.data());
+  EXPECT_EQ(memcmp(reader.data(), contents.data(), contents.size()), 0);
+
+  char buffer[6];
+  ASSERT_TRUE(reader.ReadExactly(buffer, sizeof(buffer)));
+  EXPECT_EQ(std::string(buffer, sizeof(buffer)), "mapped");
+  EXPECT_EQ(reader.Seek(0, SEEK_CUR), 6);
+
+  EXPECT_EQ(reader.Seek(-8, SEEK_END), 12);
+  EXPECT_EQ(reader.Read(buffer, sizeof(buffer)), 6);
+  EXPECT_EQ(std::string(buffer, sizeof(buffer)), "conten");
+  EXPECT_EQ(reader.Read(buffer, sizeof(buffer)), 2);
+  EXPECT_EQ(reader.Read(buffer, sizeof(buffer)), 0);
+
+  EXPECT_EQ(reader.Seek(-1, SEEK_SET), -1);
+  EXPECT_EQ(reader.Seek(7, SEEK_SET), 7);
+
+  reader.Close();
+  EXPECT_FALSE(reader.data());
+  EXPECT_EQ(reader.size(), 0u);
+  EXPECT_EQ(reader.Read(buffer, sizeof(buffer)), 0);
+}
+
+TEST(MappedFileReader, EmptyFile) {
+  ScopedTempDir temp_dir;
+  const base::FilePath path =
+      temp_dir.path().Append(FILE_PATH_LITERAL("empty"));
+  ASSERT_NO_FATAL_FAILURE(WriteTestFile(path, std::string()));
+
+  MappedFileReader reader;
+  ASSERT_TRUE(reader.Open(path));
+  EXPECT_FALSE(reader.data());
+  EXPECT_EQ(reader.size(), 0u);
+
+  char c;
+  EXPECT_EQ(reader.Read(&c, 1), 0);
+}
+
+TEST(MappedFileReader, NonexistentFile) {
+  ScopedTempDir temp_dir;
+  MappedFileReader reader;
+  EXPECT_FALSE(
+      reader.Open(temp_dir.path().Append(FILE_PATH_LITERAL("nonexistent"))));
+  EXPECT_FALSE(reader.data());
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
@@ -0,0 +1,50 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/file/mapped_file_reader.h"
+
+#include <windows.h>
+
+#include "base/logging.h"
+#include "util/win/scoped_handle.h"
+
+namespace crashpad {
+
+bool MappedFileReader::Map(FileHandle file, size_t size) {
+  ScopedKernelHANDLE mapping(
+      CreateFileMapping(file, nullptr, PAGE_READONLY, 0, 0, nullptr));
+  if (!mapping.is_valid()) {
+    PLOG(ERROR) << "CreateFileMapping";
+    return false;
+  }
+
+  // The view keeps the mapping alive after its handle is closed.
+  void* view = MapViewOfFile(mapping.get(), FILE_MAP_READ, 0, 0, size);
+  if (!view) {
+    PLOG(ERROR) << "MapViewOfFile";
+    return false;
+  }
+
+  data_ = static_cast<const uint8_t*>(view);
+  size_ = size;
+  return true;
+}
+
+void MappedFileReader::Unmap() {
+  if (!UnmapViewOfFile(data_)) {
+    PLOG(ERROR) << "UnmapViewOfFile";
+  }
+}
+
+}  // namespace crashpad
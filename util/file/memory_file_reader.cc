@@ -0,0 +1,76 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/file/memory_file_reader.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include <algorithm>
+
+#include "base/logging.h"
+#include "base/numerics/safe_math.h"
+
+namespace crashpad {
+
+MemoryFileReader::MemoryFileReader(const uint8_t* data, size_t size)
+    : FileReaderInterface(), data_(data), size_(size), offset_(0) {}
+
+MemoryFileReader::~MemoryFileReader() = default;
+
+FileOperationResult MemoryFileReader::Read(void* data, size_t size) {
+  if (offset_ >= size_) {
+    return 0;
+  }
+
+  const size_t nread = std::min(size, size_ - offset_);
+  memcpy(data, data_ + offset_, nread);
+  offset_ += nread;
+  return nread;
+}
+
+FileOffset MemoryFileReader::Seek(FileOffset offset, int whence) {
+  size_t base_offset;
+  switch (whence) {
+    case SEEK_SET:
+      base_offset = 0;
+      break;
+
+    case SEEK_CUR:
+      base_offset = offset_;
+      break;
+
+    case SEEK_END:
+      base_offset = size_;
+      break;
+
+    default:
+      LOG(ERROR) << "Seek(): invalid whence " << whence;
+      return -1;
+  }
+
+  base::CheckedNumeric<FileOffset> new_offset(
+      base::checked_cast<FileOffset>(base_offset));
+  new_offset += offset;
+  size_t new_offset_sizet;
+  if (!new_offset.AssignIfValid(&new_offset_sizet)) {
+    LOG(ERROR) << "Seek(): new_offset invalid";
+    return -1;
+  }
+
+  offset_ = new_offset_sizet;
+  return base::checked_cast<FileOffset>(offset_);
+}
+
+}  // namespace crashpad
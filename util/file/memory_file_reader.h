@@ -0,0 +1,57 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_UTIL_FILE_MEMORY_FILE_READER_H_
+#define CRASHPAD_UTIL_FILE_MEMORY_FILE_READER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "util/file/file_io.h"
+#include "util/file/file_reader.h"
+
+namespace crashpad {
+
+//! \brief A file reader for a file whose contents are already in memory that
+//!     the reader doesn’t own.
+//!
+//! Each MemoryFileReader has a file position of its own, so several of them
+//! may read the same contents, such as those of a MappedFileReader, on
+//! different threads at once.
+class MemoryFileReader : public FileReaderInterface {
+ public:
+  //! \param[in] data The contents of the file, which must outlive this object.
+  //! \param[in] size The size of \a data.
+  MemoryFileReader(const uint8_t* data, size_t size);
+
+  MemoryFileReader(const MemoryFileReader&) = delete;
+  MemoryFileReader& operator=(const MemoryFileReader&) = delete;
+
+  ~MemoryFileReader() override;
+
+  // FileReaderInterface:
+  FileOperationResult Read(void* data, size_t size) override;
+
+  // FileSeekerInterface:
+  FileOffset Seek(FileOffset offset, int whence) override;
+
+ private:
+  const uint8_t* const data_;  // weak
+  const size_t size_;
+  size_t offset_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_UTIL_FILE_MEMORY_FILE_READER_H_
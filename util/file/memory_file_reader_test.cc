@@ -0,0 +1,67 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/file/memory_file_reader.h"
+
+#include <stdio.h>
+
+#include <string>
+
+#include "gtest/gtest.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+TEST(MemoryFileReader, Read) {
+  const std::string contents("memory file contents");
+  MemoryFileReader reader(reinterpret_cast<const uint8_t*>(contents.data()),
+                          contents.size());
+
+  char buffer[6];
+  ASSERT_TRUE(reader.ReadExactly(buffer, sizeof(buffer)));
+  EXPECT_EQ(std::string(buffer, sizeof(buffer)), "memory");
+  EXPECT_EQ(reader.Seek(0, SEEK_CUR), 6);
+
+  EXPECT_EQ(reader.Seek(-8, SEEK_END), 12);
+  EXPECT_EQ(reader.Read(buffer, sizeof(buffer)), 6);
+  EXPECT_EQ(std::string(buffer, sizeof(buffer)), "conten");
+  EXPECT_EQ(reader.Read(buffer, sizeof(buffer)), 2);
+  EXPECT_EQ(reader.Read(buffer, sizeof(buffer)), 0);
+
+  // Seeking past the end is allowed, but there’s nothing to read there.
+  EXPECT_EQ(reader.Seek(100, SEEK_SET), 100);
+  EXPECT_EQ(reader.Read(buffer, sizeof(buffer)), 0);
+  EXPECT_EQ(reader.Seek(-1, SEEK_SET), -1);
+}
+
+TEST(MemoryFileReader, IndependentPositions) {
+  const std::string contents("0123456789");
+  const uint8_t* data = reinterpret_cast<const uint8_t*>(contents.data());
+  MemoryFileReader reader_1(data, contents.size());
+  MemoryFileReader reader_2(data, contents.size());
+
+  ASSERT_TRUE(reader_1.SeekSet(7));
+
+  char buffer[3];
+  ASSERT_TRUE(reader_2.ReadExactly(buffer, sizeof(buffer)));
+  EXPECT_EQ(std::string(buffer, sizeof(buffer)), "012");
+  ASSERT_TRUE(reader_1.ReadExactly(buffer, sizeof(buffer)));
+  EXPECT_EQ(std::string(buffer, sizeof(buffer)), "789");
+  EXPECT_EQ(reader_2.SeekGet(), 3);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
@@ -41,6 +41,11 @@ FileOffset IOSIntermediateDumpFilePath::Size() const {
   return LoggingFileSizeByHandle(handle_.get());
 }
 
+FileHandle IOSIntermediateDumpFilePath::Handle() const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  return handle_.get();
+}
+
 IOSIntermediateDumpByteArray::IOSIntermediateDumpByteArray(const void* data,
                                                            size_t size) {
   string_file_ = std::make_unique<StringFile>();
@@ -29,6 +29,13 @@ class IOSIntermediateDumpInterface {
  public:
   virtual FileReaderInterface* FileReader() const = 0;
   virtual FileOffset Size() const = 0;
+
+  //! \brief Returns a handle to the file containing the intermediate dump, or
+  //!     kInvalidFileHandle if it is not backed by a file.
+  //!
+  //! When valid, IOSIntermediateDumpReader maps the file into memory rather
+  //! than reading it through FileReader().
+  virtual FileHandle Handle() const { return kInvalidFileHandle; }
 };
 
 //! \brief An intermediate dump backed by a FilePath. FilePath is unlinked
@@ -41,6 +48,7 @@ class IOSIntermediateDumpFilePath : public IOSIntermediateDumpInterface {
   // IOSIntermediateDumpInterface:
   FileReaderInterface* FileReader() const override;
   FileOffset Size() const override;
+  FileHandle Handle() const override;
 
  private:
   ScopedFileHandle handle_;
@@ -14,6 +14,8 @@
 
 #include "util/ios/ios_intermediate_dump_map.h"
 
+#include <algorithm>
+
 #include "util/ios/ios_intermediate_dump_data.h"
 #include "util/ios/ios_intermediate_dump_list.h"
 #include "util/ios/ios_intermediate_dump_object.h"
@@ -23,7 +25,19 @@ using crashpad::internal::IntermediateDumpKey;
 namespace crashpad {
 namespace internal {
 
-IOSIntermediateDumpMap::IOSIntermediateDumpMap() : map_() {}
+namespace {
+
+bool EntryKeyLess(
+    const std::pair<IntermediateDumpKey,
+                    std::unique_ptr<IOSIntermediateDumpObject>>& entry,
+    const IntermediateDumpKey& key) {
+  return entry.first < key;
+}
+
+}  // namespace
+
+IOSIntermediateDumpMap::IOSIntermediateDumpMap()
+    : map_(), serialized_data_(nullptr), serialized_size_(0) {}
 
 IOSIntermediateDumpMap::~IOSIntermediateDumpMap() {}
 
@@ -33,36 +47,55 @@ IOSIntermediateDumpMap::Type IOSIntermediateDumpMap::GetType() const {
 
 const IOSIntermediateDumpData* IOSIntermediateDumpMap::GetAsData(
     const IntermediateDumpKey& key) const {
-  auto object_it = map_.find(key);
-  if (object_it != map_.end()) {
-    IOSIntermediateDumpObject* object = object_it->second.get();
-    if (object->GetType() == Type::kData)
-      return static_cast<IOSIntermediateDumpData*>(object);
-  }
+  IOSIntermediateDumpObject* object = Find(key);
+  if (object && object->GetType() == Type::kData)
+    return static_cast<IOSIntermediateDumpData*>(object);
   return nullptr;
 }
 
 const IOSIntermediateDumpList* IOSIntermediateDumpMap::GetAsList(
     const IntermediateDumpKey& key) const {
-  auto object_it = map_.find(key);
-  if (object_it != map_.end()) {
-    IOSIntermediateDumpObject* object = object_it->second.get();
-    if (object->GetType() == Type::kList)
-      return static_cast<IOSIntermediateDumpList*>(object);
-  }
+  IOSIntermediateDumpObject* object = Find(key);
+  if (object && object->GetType() == Type::kList)
+    return static_cast<IOSIntermediateDumpList*>(object);
   return nullptr;
 }
 
 const IOSIntermediateDumpMap* IOSIntermediateDumpMap::GetAsMap(
     const IntermediateDumpKey& key) const {
-  auto object_it = map_.find(key);
-  if (object_it != map_.end()) {
-    IOSIntermediateDumpObject* object = object_it->second.get();
-    if (object->GetType() == Type::kMap)
-      return static_cast<IOSIntermediateDumpMap*>(object);
-  }
+  IOSIntermediateDumpObject* object = Find(key);
+  if (object && object->GetType() == Type::kMap)
+    return static_cast<IOSIntermediateDumpMap*>(object);
   return nullptr;
 }
 
+IOSIntermediateDumpObject* IOSIntermediateDumpMap::Find(
+    const IntermediateDumpKey& key) const {
+  auto entry_it =
+      std::lower_bound(map_.begin(), map_.end(), key, EntryKeyLess);
+  if (entry_it != map_.end() && entry_it->first == key)
+    return entry_it->second.get();
+  return nullptr;
+}
+
+bool IOSIntermediateDumpMap::Set(
+    const IntermediateDumpKey& key,
+    std::unique_ptr<IOSIntermediateDumpObject> object) {
+  // Appending is cheapest, and is the case for keys written in order.
+  if (map_.empty() || map_.back().first < key) {
+    map_.emplace_back(key, std::move(object));
+    return false;
+  }
+
+  auto entry_it =
+      std::lower_bound(map_.begin(), map_.end(), key, EntryKeyLess);
+  if (entry_it != map_.end() && entry_it->first == key) {
+    entry_it->second = std::move(object);
+    return true;
+  }
+  map_.emplace(entry_it, key, std::move(object));
+  return false;
+}
+
 }  // namespace internal
 }  // namespace crashpad
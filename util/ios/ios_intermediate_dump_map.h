@@ -15,8 +15,12 @@
 #ifndef CRASHPAD_UTIL_IOS_PACK_IOS_MAP_H_
 #define CRASHPAD_UTIL_IOS_PACK_IOS_MAP_H_
 
-#include <map>
+#include <stddef.h>
+#include <stdint.h>
+
 #include <memory>
+#include <utility>
+#include <vector>
 
 #include "util/ios/ios_intermediate_dump_format.h"
 #include "util/ios/ios_intermediate_dump_object.h"
@@ -29,7 +33,9 @@ class IOSIntermediateDumpData;
 
 //! \brief A map object containing a IntermediateDump Key-Object pair.
 //!
-//! Also provides an element access helper.
+//! Also provides an element access helper. Objects are kept in a vector sorted
+//! by key, which is cheaper to build and search than a node-based map for the
+//! small number of keys in each intermediate dump map.
 class IOSIntermediateDumpMap : public IOSIntermediateDumpObject {
  public:
   IOSIntermediateDumpMap();
@@ -59,10 +65,34 @@ class IOSIntermediateDumpMap : public IOSIntermediateDumpObject {
   //! \brief Returns `true` if the map is empty.
   bool empty() const { return map_.empty(); }
 
+  //! \brief Returns the serialized contents of the map in the intermediate
+  //!     dump that it was read from, or `nullptr` for the root map.
+  //!
+  //! Maps with the same serialized contents have the same keys and values, so
+  //! this allows data read from a map to be reused for an identical one.
+  const uint8_t* serialized_data() const { return serialized_data_; }
+
+  //! \brief Returns the size of serialized_data(), which is `0` if the
+  //!     intermediate dump ended before the map did.
+  size_t serialized_size() const { return serialized_size_; }
+
  private:
   friend class IOSIntermediateDumpReader;
-  std::map<IntermediateDumpKey, std::unique_ptr<IOSIntermediateDumpObject>>
-      map_;
+
+  using Entry =
+      std::pair<IntermediateDumpKey, std::unique_ptr<IOSIntermediateDumpObject>>;
+
+  // Returns the object for key, or nullptr if there is none.
+  IOSIntermediateDumpObject* Find(const IntermediateDumpKey& key) const;
+
+  // Sets the object for key, replacing and returning true if one was already
+  // present.
+  bool Set(const IntermediateDumpKey& key,
+           std::unique_ptr<IOSIntermediateDumpObject> object);
+
+  std::vector<Entry> map_;
+  const uint8_t* serialized_data_;  // weak
+  size_t serialized_size_;
 };
 
 }  // namespace internal
@@ -14,9 +14,11 @@
 
 #include "util/ios/ios_intermediate_dump_reader.h"
 
+#include <string.h>
+#include <sys/mman.h>
+
 #include <memory>
 #include <stack>
-#include <vector>
 
 #include "base/logging.h"
 #include "util/file/filesystem.h"
@@ -29,19 +31,77 @@
 namespace crashpad {
 namespace internal {
 
+namespace {
+
+// Reads the contents of an intermediate dump in memory, giving out pointers
+// into them rather than copies.
+class DumpCursor {
+ public:
+  DumpCursor(const uint8_t* data, size_t size)
+      : data_(data), size_(size), offset_(0) {}
+
+  DumpCursor(const DumpCursor&) = delete;
+  DumpCursor& operator=(const DumpCursor&) = delete;
+
+  // Copies the next sizeof(T) bytes into value, which needn't be aligned in the
+  // intermediate dump.
+  template <typename T>
+  bool Read(T* value) {
+    const uint8_t* bytes = Advance(sizeof(*value));
+    if (!bytes)
+      return false;
+    memcpy(value, bytes, sizeof(*value));
+    return true;
+  }
+
+  // Returns a pointer to the next length bytes and moves past them, or returns
+  // nullptr if fewer than length bytes remain.
+  const uint8_t* Advance(size_t length) {
+    if (length > size_ - offset_)
+      return nullptr;
+    const uint8_t* bytes = data_ + offset_;
+    offset_ += length;
+    return bytes;
+  }
+
+  bool AtEnd() const { return offset_ == size_; }
+
+  // Returns a pointer to the next byte to be read.
+  const uint8_t* Position() const { return data_ + offset_; }
+
+ private:
+  const uint8_t* data_;
+  size_t size_;
+  size_t offset_;
+};
+
+}  // namespace
+
+IOSIntermediateDumpReader::IOSIntermediateDumpReader()
+    : mapping_(),
+      buffer_(),
+      contents_(nullptr),
+      contents_size_(0),
+      intermediate_dump_(),
+      initialized_() {}
+
 IOSIntermediateDumpReaderInitializeResult IOSIntermediateDumpReader::Initialize(
     const IOSIntermediateDumpInterface& dump_interface) {
   INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
 
   // Don't initialize empty files.
   FileOffset size = dump_interface.Size();
-  if (size == 0) {
+  if (size <= 0) {
+    return IOSIntermediateDumpReaderInitializeResult::kFailure;
+  }
+
+  if (!Load(dump_interface, static_cast<size_t>(size))) {
     return IOSIntermediateDumpReaderInitializeResult::kFailure;
   }
 
   IOSIntermediateDumpReaderInitializeResult result =
       IOSIntermediateDumpReaderInitializeResult::kSuccess;
-  if (!Parse(dump_interface.FileReader(), size)) {
+  if (!Parse()) {
     LOG(ERROR) << "Intermediate dump parsing failed";
     result = IOSIntermediateDumpReaderInitializeResult::kIncomplete;
   }
@@ -55,21 +115,44 @@ const IOSIntermediateDumpMap* IOSIntermediateDumpReader::RootMap() {
   return &intermediate_dump_;
 }
 
-bool IOSIntermediateDumpReader::Parse(FileReaderInterface* reader,
-                                      FileOffset file_size) {
+bool IOSIntermediateDumpReader::Load(
+    const IOSIntermediateDumpInterface& dump_interface,
+    size_t size) {
+  FileHandle handle = dump_interface.Handle();
+  if (handle != kInvalidFileHandle &&
+      mapping_.ResetMmap(nullptr, size, PROT_READ, MAP_PRIVATE, handle, 0)) {
+    contents_ = mapping_.addr_as<const uint8_t*>();
+    contents_size_ = size;
+    return true;
+  }
+
+  // Without a mapping, read everything at once rather than piece by piece.
+  FileReaderInterface* reader = dump_interface.FileReader();
+  buffer_.reset(new uint8_t[size]);
+  if (reader->Seek(0, SEEK_SET) != 0 ||
+      !reader->ReadExactly(buffer_.get(), size)) {
+    buffer_.reset();
+    return false;
+  }
+  contents_ = buffer_.get();
+  contents_size_ = size;
+  return true;
+}
+
+bool IOSIntermediateDumpReader::Parse() {
+  DumpCursor cursor(contents_, contents_size_);
   std::stack<IOSIntermediateDumpObject*> stack;
   stack.push(&intermediate_dump_);
   using Command = IOSIntermediateDumpWriter::CommandType;
   using Type = IOSIntermediateDumpObject::Type;
 
   Command command;
-  if (!reader->ReadExactly(&command, sizeof(Command)) ||
-      command != Command::kRootMapStart) {
+  if (!cursor.Read(&command) || command != Command::kRootMapStart) {
     LOG(ERROR) << "Unexpected start to root map.";
     return false;
   }
 
-  while (reader->ReadExactly(&command, sizeof(Command))) {
+  while (cursor.Read(&command)) {
     constexpr int kMaxStackDepth = 10;
     if (stack.size() > kMaxStackDepth) {
       LOG(ERROR) << "Unexpected depth of intermediate dump data.";
@@ -79,20 +162,21 @@ bool IOSIntermediateDumpReader::Parse(FileReaderInterface* reader,
     IOSIntermediateDumpObject* parent = stack.top();
     switch (command) {
       case Command::kMapStart: {
-        std::unique_ptr<IOSIntermediateDumpMap> new_map(
-            new IOSIntermediateDumpMap());
+        auto new_map = std::make_unique<IOSIntermediateDumpMap>();
         if (parent->GetType() == Type::kMap) {
           const auto parent_map = static_cast<IOSIntermediateDumpMap*>(parent);
-          stack.push(new_map.get());
           IntermediateDumpKey key;
-          if (!reader->ReadExactly(&key, sizeof(key)))
+          if (!cursor.Read(&key))
             return false;
           if (key == IntermediateDumpKey::kInvalid)
             return false;
-          parent_map->map_[key] = std::move(new_map);
+          new_map->serialized_data_ = cursor.Position();
+          stack.push(new_map.get());
+          parent_map->Set(key, std::move(new_map));
         } else if (parent->GetType() == Type::kList) {
           const auto parent_list =
               static_cast<IOSIntermediateDumpList*>(parent);
+          new_map->serialized_data_ = cursor.Position();
           stack.push(new_map.get());
           parent_list->push_back(std::move(new_map));
         } else {
@@ -109,14 +193,14 @@ bool IOSIntermediateDumpReader::Parse(FileReaderInterface* reader,
         }
 
         IntermediateDumpKey key;
-        if (!reader->ReadExactly(&key, sizeof(key)))
+        if (!cursor.Read(&key))
           return false;
         if (key == IntermediateDumpKey::kInvalid)
           return false;
 
         auto parent_map = static_cast<IOSIntermediateDumpMap*>(parent);
         stack.push(new_list.get());
-        parent_map->map_[key] = std::move(new_list);
+        parent_map->Set(key, std::move(new_list));
         break;
       }
       case Command::kMapEnd:
@@ -129,6 +213,12 @@ bool IOSIntermediateDumpReader::Parse(FileReaderInterface* reader,
           LOG(ERROR) << "Unexpected map end not in a map.";
           return false;
         }
+        {
+          // The serialized contents end before this command.
+          const auto map = static_cast<IOSIntermediateDumpMap*>(parent);
+          map->serialized_size_ =
+              cursor.Position() - sizeof(command) - map->serialized_data_;
+        }
         stack.pop();
         break;
       case Command::kArrayEnd:
@@ -148,13 +238,13 @@ bool IOSIntermediateDumpReader::Parse(FileReaderInterface* reader,
           return false;
         }
         IntermediateDumpKey key;
-        if (!reader->ReadExactly(&key, sizeof(key)))
+        if (!cursor.Read(&key))
           return false;
         if (key == IntermediateDumpKey::kInvalid)
           return false;
 
         size_t value_length;
-        if (!reader->ReadExactly(&value_length, sizeof(value_length))) {
+        if (!cursor.Read(&value_length)) {
           return false;
         }
 
@@ -165,16 +255,17 @@ bool IOSIntermediateDumpReader::Parse(FileReaderInterface* reader,
           return false;
         }
 
-        std::vector<uint8_t> data(value_length);
-        if (!reader->ReadExactly(data.data(), value_length)) {
+        const uint8_t* value = cursor.Advance(value_length);
+        if (!value) {
+          LOG(ERROR) << "Property extends beyond end of file.";
           return false;
         }
         auto parent_map = static_cast<IOSIntermediateDumpMap*>(parent);
-        if (parent_map->map_.find(key) != parent_map->map_.end()) {
+        if (parent_map->Set(key,
+                            std::make_unique<IOSIntermediateDumpData>(
+                                value, value_length))) {
           LOG(ERROR) << "Inserting duplicate key";
         }
-        parent_map->map_[key] =
-            std::make_unique<IOSIntermediateDumpData>(std::move(data));
         break;
       }
       case Command::kRootMapEnd: {
@@ -183,7 +274,7 @@ bool IOSIntermediateDumpReader::Parse(FileReaderInterface* reader,
           return false;
         }
 
-        if (reader->Seek(0, SEEK_CUR) != file_size) {
+        if (!cursor.AtEnd()) {
           LOG(ERROR) << "Root map ended before end of file.";
           return false;
         }
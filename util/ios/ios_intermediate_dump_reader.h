@@ -15,9 +15,15 @@
 #ifndef CRASHPAD_UTIL_IOS_IOS_INTERMEDIATE_DUMP_READER_H_
 #define CRASHPAD_UTIL_IOS_IOS_INTERMEDIATE_DUMP_READER_H_
 
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+
 #include "util/ios/ios_intermediate_dump_interface.h"
 #include "util/ios/ios_intermediate_dump_map.h"
 #include "util/misc/initialization_state_dcheck.h"
+#include "util/posix/scoped_mmap.h"
 
 namespace crashpad {
 namespace internal {
@@ -38,9 +44,13 @@ enum class IOSIntermediateDumpReaderInitializeResult : int {
 };
 
 //! \brief Open and parse iOS intermediate dumps.
+//!
+//! The intermediate dump is mapped into memory when it is backed by a file, or
+//! otherwise read into memory at once. Parsing indexes it without copying, so
+//! each IOSIntermediateDumpData refers to bytes owned by this object.
 class IOSIntermediateDumpReader {
  public:
-  IOSIntermediateDumpReader() {}
+  IOSIntermediateDumpReader();
 
   IOSIntermediateDumpReader(const IOSIntermediateDumpReader&) = delete;
   IOSIntermediateDumpReader& operator=(const IOSIntermediateDumpReader&) =
@@ -63,10 +73,20 @@ class IOSIntermediateDumpReader {
 
   //! \brief Returns an IOSIntermediateDumpMap corresponding to the root of the
   //!     intermediate dump.
+  //!
+  //! The returned object and the data it contains remain valid for the
+  //! lifetime of this object.
   const IOSIntermediateDumpMap* RootMap();
 
  private:
-  bool Parse(FileReaderInterface* reader, FileOffset file_size);
+  // Maps or reads the contents of dump_interface into contents_.
+  bool Load(const IOSIntermediateDumpInterface& dump_interface, size_t size);
+  bool Parse();
+
+  ScopedMmap mapping_;
+  std::unique_ptr<uint8_t[]> buffer_;
+  const uint8_t* contents_;
+  size_t contents_size_;
   IOSIntermediateDumpMap intermediate_dump_;
   InitializationStateDcheck initialized_;
 };
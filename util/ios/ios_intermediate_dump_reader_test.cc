@@ -17,6 +17,9 @@
 #include <fcntl.h>
 #include <mach/vm_map.h>
 
+#include <string>
+#include <vector>
+
 #include "base/posix/eintr_wrapper.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -248,11 +251,10 @@ TEST_F(IOSIntermediateDumpReaderTest, ReadValidData) {
     EXPECT_EQ(data->GetString(), "random_data");
 
     // Load as bytes.
-    auto bytes = data->bytes();
-    vm_size_t data_size = bytes.size();
+    vm_size_t data_size = data->size();
     EXPECT_EQ(data_size, 11UL);
 
-    const char* data_bytes = reinterpret_cast<const char*>(bytes.data());
+    const char* data_bytes = reinterpret_cast<const char*>(data->data());
     EXPECT_EQ(std::string(data_bytes, data_size), "random_data");
   }
 
@@ -260,6 +262,89 @@ TEST_F(IOSIntermediateDumpReaderTest, ReadValidData) {
   EXPECT_EQ(system_info, nullptr);
 }
 
+TEST_F(IOSIntermediateDumpReaderTest, SerializedMapData) {
+  internal::IOSIntermediateDumpReader reader;
+  {
+    IOSIntermediateDumpWriter::ScopedRootMap scopedRoot(writer_.get());
+    IOSIntermediateDumpWriter::ScopedArray moduleArray(writer_.get(),
+                                                       Key::kModules);
+    for (uint64_t address : {0x1000, 0x1000, 0x2000}) {
+      IOSIntermediateDumpWriter::ScopedArrayMap moduleMap(writer_.get());
+      EXPECT_TRUE(writer_->AddProperty(Key::kAddress, &address));
+    }
+  }
+
+  EXPECT_TRUE(writer_->Close());
+  EXPECT_EQ(reader.Initialize(dump_interface()), Result::kSuccess);
+
+  auto root_map = reader.RootMap();
+  EXPECT_EQ(root_map->serialized_data(), nullptr);
+
+  const auto modules = root_map->GetAsList(Key::kModules);
+  ASSERT_NE(modules, nullptr);
+  ASSERT_EQ(modules->size(), 3u);
+  std::vector<std::string> serialized;
+  for (const auto& module : *modules) {
+    ASSERT_NE(module->serialized_data(), nullptr);
+    EXPECT_GT(module->serialized_size(), 0u);
+    serialized.emplace_back(
+        reinterpret_cast<const char*>(module->serialized_data()),
+        module->serialized_size());
+  }
+
+  // Identical maps have identical serialized contents.
+  EXPECT_EQ(serialized[0], serialized[1]);
+  EXPECT_NE(serialized[0], serialized[2]);
+}
+
+TEST_F(IOSIntermediateDumpReaderTest, UnorderedAndDuplicateKeys) {
+  {
+    IOSIntermediateDumpWriter::ScopedRootMap scopedRoot(writer_.get());
+    IOSIntermediateDumpWriter::ScopedMap map(writer_.get(), Key::kProcessInfo);
+    pid_t pid = 3;
+    EXPECT_TRUE(writer_->AddProperty(Key::kPID, &pid));
+    pid = 2;
+    EXPECT_TRUE(writer_->AddProperty(Key::kParentPID, &pid));
+    pid = 1;
+    EXPECT_TRUE(writer_->AddProperty(Key::kPID, &pid));
+  }
+  EXPECT_TRUE(writer_->Close());
+
+  // Read the dump both from its file, which is memory-mapped, and from a copy
+  // in a byte array, which is not.
+  std::string contents(dump_interface().Size(), '\0');
+  ASSERT_TRUE(
+      dump_interface().FileReader()->ReadExactly(&contents[0], contents.size()));
+  internal::IOSIntermediateDumpByteArray byte_array_interface(contents.data(),
+                                                              contents.size());
+
+  for (const internal::IOSIntermediateDumpInterface* interface :
+       {static_cast<const internal::IOSIntermediateDumpInterface*>(
+            &dump_interface()),
+        static_cast<const internal::IOSIntermediateDumpInterface*>(
+            &byte_array_interface)}) {
+    internal::IOSIntermediateDumpReader reader;
+    EXPECT_EQ(reader.Initialize(*interface), Result::kSuccess);
+
+    const auto process_info = reader.RootMap()->GetAsMap(Key::kProcessInfo);
+    ASSERT_NE(process_info, nullptr);
+
+    // The last value written for a key is the one that’s kept.
+    pid_t pid;
+    const auto pid_data = process_info->GetAsData(Key::kPID);
+    ASSERT_NE(pid_data, nullptr);
+    EXPECT_TRUE(pid_data->GetValue(&pid));
+    EXPECT_EQ(pid, 1);
+
+    const auto parent_pid_data = process_info->GetAsData(Key::kParentPID);
+    ASSERT_NE(parent_pid_data, nullptr);
+    EXPECT_TRUE(parent_pid_data->GetValue(&pid));
+    EXPECT_EQ(pid, 2);
+
+    EXPECT_EQ(process_info->GetAsData(Key::kProcessInfo), nullptr);
+  }
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace crashpad
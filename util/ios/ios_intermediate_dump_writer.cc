@@ -17,9 +17,11 @@
 #include <fcntl.h>
 #include <mach/mach.h>
 #include <string.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
 #include <algorithm>
+#include <iterator>
 #include <ostream>
 
 #include "base/check.h"
@@ -46,6 +48,31 @@ bool RawLoggingWriteFile(int fd, const void* data, size_t size) {
   return true;
 }
 
+// Writes all of iovecs, picking up after any partial write, with
+// CRASHPAD_RAW_LOG. iovecs is modified.
+bool RawLoggingWritevFile(int fd, iovec* iovecs, size_t count) {
+  while (count > 0) {
+    ssize_t bytes_written =
+        HANDLE_EINTR(writev(fd, iovecs, static_cast<int>(count)));
+    if (bytes_written <= 0) {
+      CRASHPAD_RAW_LOG_ERROR(bytes_written, "RawLoggingWritevFile");
+      return false;
+    }
+
+    size_t remaining = bytes_written;
+    while (count > 0 && remaining >= iovecs[0].iov_len) {
+      remaining -= iovecs[0].iov_len;
+      ++iovecs;
+      --count;
+    }
+    if (count > 0) {
+      iovecs[0].iov_base = static_cast<char*>(iovecs[0].iov_base) + remaining;
+      iovecs[0].iov_len -= remaining;
+    }
+  }
+  return true;
+}
+
 // Similar to LoggingCloseFile but with CRASHPAD_RAW_LOG.
 bool RawLoggingCloseFile(int fd) {
   int rv = IGNORE_EINTR(close(fd));
@@ -55,11 +82,14 @@ bool RawLoggingCloseFile(int fd) {
   return rv == 0;
 }
 
-IOSIntermediateDumpWriter::~IOSIntermediateDumpWriter() {
+template <size_t kBufferSize>
+BasicIOSIntermediateDumpWriter<kBufferSize>::~BasicIOSIntermediateDumpWriter() {
   CHECK_EQ(fd_, -1) << "Call Close() before this object is destroyed.";
 }
 
-bool IOSIntermediateDumpWriter::Open(const base::FilePath& path) {
+template <size_t kBufferSize>
+bool BasicIOSIntermediateDumpWriter<kBufferSize>::Open(
+    const base::FilePath& path) {
   // Set data protection class D (No protection). A file with this type of
   // protection can be read from or written to at any time.
   // See:
@@ -79,7 +109,8 @@ bool IOSIntermediateDumpWriter::Open(const base::FilePath& path) {
   return true;
 }
 
-bool IOSIntermediateDumpWriter::Close() {
+template <size_t kBufferSize>
+bool BasicIOSIntermediateDumpWriter<kBufferSize>::Close() {
   if (fd_ < 0) {
     return true;
   }
@@ -91,9 +122,11 @@ bool IOSIntermediateDumpWriter::Close() {
   return RawLoggingCloseFile(fd);
 }
 
-bool IOSIntermediateDumpWriter::AddPropertyCString(IntermediateDumpKey key,
-                                                   size_t max_length,
-                                                   const char* value) {
+template <size_t kBufferSize>
+bool BasicIOSIntermediateDumpWriter<kBufferSize>::AddPropertyCString(
+    IntermediateDumpKey key,
+    size_t max_length,
+    const char* value) {
   constexpr size_t kMaxStringBytes = 1024;
   if (max_length > kMaxStringBytes) {
     CRASHPAD_RAW_LOG("AddPropertyCString max_length too large");
@@ -108,10 +141,12 @@ bool IOSIntermediateDumpWriter::AddPropertyCString(IntermediateDumpKey key,
   return false;
 }
 
-bool IOSIntermediateDumpWriter::ReadCStringInternal(const char* value,
-                                                    char* buffer,
-                                                    size_t max_length,
-                                                    size_t* string_length) {
+template <size_t kBufferSize>
+bool BasicIOSIntermediateDumpWriter<kBufferSize>::ReadCStringInternal(
+    const char* value,
+    char* buffer,
+    size_t max_length,
+    size_t* string_length) {
   size_t length = 0;
   while (length < max_length) {
     vm_address_t data_address = reinterpret_cast<vm_address_t>(value + length);
@@ -149,55 +184,68 @@ bool IOSIntermediateDumpWriter::ReadCStringInternal(const char* value,
   return false;
 }
 
-bool IOSIntermediateDumpWriter::AddPropertyInternal(IntermediateDumpKey key,
-                                                    const char* value,
-                                                    size_t value_length) {
+template <size_t kBufferSize>
+bool BasicIOSIntermediateDumpWriter<kBufferSize>::AddPropertyInternal(
+    IntermediateDumpKey key,
+    const char* value,
+    size_t value_length) {
   ScopedVMRead<char> vmread;
   if (!vmread.Read(value, value_length))
     return false;
   return Property(key, vmread.get(), value_length);
 }
 
-bool IOSIntermediateDumpWriter::ArrayMapStart() {
+template <size_t kBufferSize>
+bool BasicIOSIntermediateDumpWriter<kBufferSize>::ArrayMapStart() {
   const CommandType command_type = CommandType::kMapStart;
   return BufferedWrite(&command_type, sizeof(command_type));
 }
 
-bool IOSIntermediateDumpWriter::MapStart(IntermediateDumpKey key) {
+template <size_t kBufferSize>
+bool BasicIOSIntermediateDumpWriter<kBufferSize>::MapStart(
+    IntermediateDumpKey key) {
   const CommandType command_type = CommandType::kMapStart;
   return BufferedWrite(&command_type, sizeof(command_type)) &&
          BufferedWrite(&key, sizeof(key));
 }
 
-bool IOSIntermediateDumpWriter::ArrayStart(IntermediateDumpKey key) {
+template <size_t kBufferSize>
+bool BasicIOSIntermediateDumpWriter<kBufferSize>::ArrayStart(
+    IntermediateDumpKey key) {
   const CommandType command_type = CommandType::kArrayStart;
   return BufferedWrite(&command_type, sizeof(command_type)) &&
          BufferedWrite(&key, sizeof(key));
 }
 
-bool IOSIntermediateDumpWriter::MapEnd() {
+template <size_t kBufferSize>
+bool BasicIOSIntermediateDumpWriter<kBufferSize>::MapEnd() {
   const CommandType command_type = CommandType::kMapEnd;
   return BufferedWrite(&command_type, sizeof(command_type));
 }
 
-bool IOSIntermediateDumpWriter::ArrayEnd() {
+template <size_t kBufferSize>
+bool BasicIOSIntermediateDumpWriter<kBufferSize>::ArrayEnd() {
   const CommandType command_type = CommandType::kArrayEnd;
   return BufferedWrite(&command_type, sizeof(command_type));
 }
 
-bool IOSIntermediateDumpWriter::RootMapStart() {
+template <size_t kBufferSize>
+bool BasicIOSIntermediateDumpWriter<kBufferSize>::RootMapStart() {
   const CommandType command_type = CommandType::kRootMapStart;
   return BufferedWrite(&command_type, sizeof(command_type));
 }
 
-bool IOSIntermediateDumpWriter::RootMapEnd() {
+template <size_t kBufferSize>
+bool BasicIOSIntermediateDumpWriter<kBufferSize>::RootMapEnd() {
   const CommandType command_type = CommandType::kRootMapEnd;
   return BufferedWrite(&command_type, sizeof(command_type));
 }
 
-bool IOSIntermediateDumpWriter::Property(IntermediateDumpKey key,
-                                         const void* value,
-                                         size_t value_length) {
+template <size_t kBufferSize>
+bool BasicIOSIntermediateDumpWriter<kBufferSize>::Property(
+    IntermediateDumpKey key,
+    const void* value,
+    size_t value_length) {
   const CommandType command_type = CommandType::kProperty;
   return BufferedWrite(&command_type, sizeof(command_type)) &&
          BufferedWrite(&key, sizeof(key)) &&
@@ -205,17 +253,39 @@ bool IOSIntermediateDumpWriter::Property(IntermediateDumpKey key,
          BufferedWrite(value, value_length);
 }
 
-bool IOSIntermediateDumpWriter::FlushWriteBuffer() {
+template <size_t kBufferSize>
+bool BasicIOSIntermediateDumpWriter<kBufferSize>::FlushWriteBuffer() {
   size_t size = buffer_occupied_;
   buffer_occupied_ = 0;
   return RawLoggingWriteFile(fd_, buffer_, size);
 }
 
-bool IOSIntermediateDumpWriter::BufferedWrite(const void* data,
-                                              size_t data_size) {
+template <size_t kBufferSize>
+bool BasicIOSIntermediateDumpWriter<kBufferSize>::FlushWriteBufferWithData(
+    const void* data,
+    size_t size) {
+  iovec iovecs[2];
+  iovecs[0].iov_base = buffer_;
+  iovecs[0].iov_len = buffer_occupied_;
+  iovecs[1].iov_base = const_cast<void*>(data);
+  iovecs[1].iov_len = size;
+  buffer_occupied_ = 0;
+  return RawLoggingWritevFile(fd_, iovecs, std::size(iovecs));
+}
+
+template <size_t kBufferSize>
+bool BasicIOSIntermediateDumpWriter<kBufferSize>::BufferedWrite(
+    const void* data,
+    size_t data_size) {
+  // Data too large to be buffered is written along with anything already in
+  // `buffer_`, which is usually the header of the property that `data` is the
+  // value of.
+  if (data_size >= kBufferSize) {
+    return FlushWriteBufferWithData(data, data_size);
+  }
+
   const char* data_char = static_cast<const char*>(data);
-  // If `buffer_` is occupied, fill it up first, and flush if full.
-  if (buffer_occupied_ > 0) {
+  while (data_size > 0) {
     size_t data_size_to_copy =
         std::min(kBufferSize - buffer_occupied_, data_size);
     memcpy(buffer_ + buffer_occupied_, data_char, data_size_to_copy);
@@ -230,31 +300,11 @@ bool IOSIntermediateDumpWriter::BufferedWrite(const void* data,
     }
   }
 
-  // Either `data_size` is big enough that it could fill `buffer_`, trigger
-  // a FlushWriteBuffer, and reset `buffer_occuppied_` to zero, or there is no
-  // data left to process.
-  DCHECK(buffer_occupied_ == 0 || data_size == 0);
-
-  // Write the rest of the `data` in an increment of kBufferSize.
-  if (data_size >= kBufferSize) {
-    DCHECK_EQ(buffer_occupied_, 0u);
-    size_t data_size_to_write = data_size - (data_size % kBufferSize);
-    if (!RawLoggingWriteFile(fd_, data_char, data_size_to_write)) {
-      return false;
-    }
-    data_char += data_size_to_write;
-    data_size -= data_size_to_write;
-  }
-
-  // If there's any `data` left, put it in `buffer_`.
-  if (data_size > 0) {
-    DCHECK_EQ(buffer_occupied_, 0u);
-    memcpy(buffer_, data_char, data_size);
-    buffer_occupied_ = data_size;
-  }
-
   return true;
 }
 
+template class BasicIOSIntermediateDumpWriter<
+    kIOSIntermediateDumpWriterBufferSize>;
+
 }  // namespace internal
 }  // namespace crashpad
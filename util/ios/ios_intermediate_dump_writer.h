@@ -15,6 +15,7 @@
 #ifndef CRASHPAD_UTIL_IOS_IOS_INTERMEDIATE_DUMP_WRITER_H_
 #define CRASHPAD_UTIL_IOS_IOS_INTERMEDIATE_DUMP_WRITER_H_
 
+#include <stddef.h>
 #include <sys/types.h>
 
 #include "base/files/file_path.h"
@@ -23,6 +24,9 @@
 namespace crashpad {
 namespace internal {
 
+//! \brief The default size of the write buffer of IOSIntermediateDumpWriter.
+constexpr size_t kIOSIntermediateDumpWriterBufferSize = 16 * 1024;
+
 //! \brief Wrapper class for writing intermediate dump file.
 //!
 //! Due to the limitations of in-process handling, an intermediate dump file is
@@ -38,16 +42,28 @@ namespace internal {
 //!
 //!  Similar to JSON, maps can contain other maps, arrays and properties.
 //!
+//! Writes are collected in a buffer of \a kBufferSize bytes, so that most
+//! commands don’t each need a system call. Values at least as large as the
+//! buffer, such as thread stacks, are written directly from their source
+//! along with the buffered data preceding them, in a single `writev()`.
+//!
 //! Note: All methods are `RUNS-DURING-CRASH`.
-class IOSIntermediateDumpWriter final {
+//!
+//! \tparam kBufferSize The size of the write buffer, which is part of the
+//!     object. Most users should use IOSIntermediateDumpWriter.
+template <size_t kBufferSize>
+class BasicIOSIntermediateDumpWriter final {
  public:
-  IOSIntermediateDumpWriter() : buffer_occupied_(0), fd_(-1) {}
+  static_assert(kBufferSize > 0, "kBufferSize must be positive");
 
-  IOSIntermediateDumpWriter(const IOSIntermediateDumpWriter&) = delete;
-  IOSIntermediateDumpWriter& operator=(const IOSIntermediateDumpWriter&) =
+  BasicIOSIntermediateDumpWriter() : buffer_occupied_(0), fd_(-1) {}
+
+  BasicIOSIntermediateDumpWriter(const BasicIOSIntermediateDumpWriter&) =
       delete;
+  BasicIOSIntermediateDumpWriter& operator=(
+      const BasicIOSIntermediateDumpWriter&) = delete;
 
-  ~IOSIntermediateDumpWriter();
+  ~BasicIOSIntermediateDumpWriter();
 
   //! \brief Command instructions for the intermediate dump reader.
   enum class CommandType : uint8_t {
@@ -93,7 +109,7 @@ class IOSIntermediateDumpWriter final {
   //! \brief A scoped wrapper for calls to RootMapStart and RootMapEnd.
   class ScopedRootMap {
    public:
-    explicit ScopedRootMap(IOSIntermediateDumpWriter* writer)
+    explicit ScopedRootMap(BasicIOSIntermediateDumpWriter* writer)
         : writer_(writer) {
       writer->RootMapStart();
     }
@@ -104,13 +120,13 @@ class IOSIntermediateDumpWriter final {
     ~ScopedRootMap() { writer_->RootMapEnd(); }
 
    private:
-    IOSIntermediateDumpWriter* writer_;
+    BasicIOSIntermediateDumpWriter* writer_;
   };
 
   //! \brief A scoped wrapper for calls to MapStart and MapEnd.
   class ScopedMap {
    public:
-    explicit ScopedMap(IOSIntermediateDumpWriter* writer,
+    explicit ScopedMap(BasicIOSIntermediateDumpWriter* writer,
                        IntermediateDumpKey key)
         : writer_(writer) {
       writer->MapStart(key);
@@ -122,13 +138,13 @@ class IOSIntermediateDumpWriter final {
     ~ScopedMap() { writer_->MapEnd(); }
 
    private:
-    IOSIntermediateDumpWriter* writer_;
+    BasicIOSIntermediateDumpWriter* writer_;
   };
 
   //! \brief A scoped wrapper for calls to ArrayMapStart and MapEnd.
   class ScopedArrayMap {
    public:
-    explicit ScopedArrayMap(IOSIntermediateDumpWriter* writer)
+    explicit ScopedArrayMap(BasicIOSIntermediateDumpWriter* writer)
         : writer_(writer) {
       writer->ArrayMapStart();
     }
@@ -139,13 +155,13 @@ class IOSIntermediateDumpWriter final {
     ~ScopedArrayMap() { writer_->MapEnd(); }
 
    private:
-    IOSIntermediateDumpWriter* writer_;
+    BasicIOSIntermediateDumpWriter* writer_;
   };
 
   //! \brief A scoped wrapper for calls to ArrayStart and ArrayEnd.
   class ScopedArray {
    public:
-    explicit ScopedArray(IOSIntermediateDumpWriter* writer,
+    explicit ScopedArray(BasicIOSIntermediateDumpWriter* writer,
                          IntermediateDumpKey key)
         : writer_(writer) {
       writer->ArrayStart(key);
@@ -157,7 +173,7 @@ class IOSIntermediateDumpWriter final {
     ~ScopedArray() { writer_->ArrayEnd(); }
 
    private:
-    IOSIntermediateDumpWriter* writer_;
+    BasicIOSIntermediateDumpWriter* writer_;
   };
 
   //! \return The `true` if able to AddPropertyInternal the \a key \a value
@@ -231,15 +247,17 @@ class IOSIntermediateDumpWriter final {
 
   //! \return `true` if able to write \a data up to \a size. The \a data might
   //!     not be written to fd_  until `buffer_` is full or the writer is
-  //!     closed. All writes will be 4096 bytes (the size of your kBufferSize)
-  //!     except for the final flush, which might be partial.
+  //!     closed. If \a size is at least kBufferSize, \a data and anything
+  //!     already in `buffer_` are written immediately, without copying \a data
+  //!     to `buffer_`.
   bool BufferedWrite(const void* data, size_t size);
 
   //! \return `true` if able to write `buffer_` up to `buffer_occupied_`.
   bool FlushWriteBuffer();
 
-  //! \brief The maximum size of the write buffer.
-  static constexpr size_t kBufferSize = 4096;
+  //! \return `true` if able to write `buffer_` up to `buffer_occupied_`,
+  //!     followed by \a data up to \a size, in a single `writev()`.
+  bool FlushWriteBufferWithData(const void* data, size_t size);
 
   //! \brief The write data buffer and amount of that buffer occupied with data
   //!   to be written.
@@ -249,6 +267,13 @@ class IOSIntermediateDumpWriter final {
   int fd_;
 };
 
+extern template class BasicIOSIntermediateDumpWriter<
+    kIOSIntermediateDumpWriterBufferSize>;
+
+//! \brief The intermediate dump writer used by the in-process handler.
+using IOSIntermediateDumpWriter =
+    BasicIOSIntermediateDumpWriter<kIOSIntermediateDumpWriterBufferSize>;
+
 }  // namespace internal
 }  // namespace crashpad
 
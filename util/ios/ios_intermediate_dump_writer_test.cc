@@ -108,6 +108,30 @@ TEST_F(IOSIntermediateDumpWriterTest, Property) {
   ASSERT_EQ(contents, result);
 }
 
+TEST_F(IOSIntermediateDumpWriterTest, LargeProperty) {
+  // A value larger than the write buffer is written directly, after the
+  // buffered commands preceding it.
+  const std::string value(
+      internal::kIOSIntermediateDumpWriterBufferSize * 2 + 1, 'A');
+  EXPECT_TRUE(writer_->Open(path()));
+  {
+    IOSIntermediateDumpWriter::ScopedRootMap rootMap(writer_.get());
+    EXPECT_TRUE(
+        writer_->AddPropertyBytes(Key::kVersion, value.data(), value.size()));
+  }
+  EXPECT_TRUE(writer_->Close());
+
+  std::string contents;
+  ASSERT_TRUE(LoggingReadEntireFile(path(), &contents));
+  const size_t value_length = value.size();
+  std::string result("\6\5\1\0", 4);
+  result.append(reinterpret_cast<const char*>(&value_length),
+                sizeof(value_length));
+  result.append(value);
+  result.append("\a", 1);
+  ASSERT_EQ(contents, result);
+}
+
 TEST_F(IOSIntermediateDumpWriterTest, PropertyString) {
   EXPECT_TRUE(writer_->Open(path()));
   EXPECT_TRUE(writer_->AddPropertyCString(Key::kVersion, 64, "version"));
@@ -14,32 +14,159 @@
 
 #include "util/ios/scoped_vm_read.h"
 
+#include <pthread.h>
+#include <sys/mman.h>
+
+#include <atomic>
+
 #include "util/ios/raw_logging.h"
 
 namespace crashpad {
 namespace internal {
 
+namespace {
+
+// Arena allocations are aligned to this, which is enough for any type read.
+constexpr size_t kArenaAlignment = 16;
+
+// These are only written by ScopedVMReadArena::Initialize(), which publishes
+// g_arena_size last.
+vm_address_t g_arena_base;
+std::atomic<size_t> g_arena_size;
+
+// The thread ID of the thread using the arena, or 0 if it isn’t in use.
+std::atomic<uint64_t> g_arena_thread_id;
+
+// Only accessed by the thread using the arena.
+size_t g_arena_used;
+size_t g_arena_high_water;
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free,
+              "std::atomic<uint64_t> may not be signal-safe");
+static_assert(std::atomic<size_t>::is_always_lock_free,
+              "std::atomic<size_t> may not be signal-safe");
+
+uint64_t CurrentThreadID() {
+  uint64_t thread_id;
+  // This is only safe when passing pthread_self(), otherwise this can lock.
+  pthread_threadid_np(pthread_self(), &thread_id);
+  return thread_id;
+}
+
+size_t ArenaRoundUp(size_t size) {
+  return (size + kArenaAlignment - 1) & ~(kArenaAlignment - 1);
+}
+
+// Returns the address of size bytes of the arena, or 0 if the arena isn’t in
+// use by this thread or there isn’t enough room.
+vm_address_t ArenaAllocate(size_t size) {
+  const size_t arena_size = g_arena_size.load(std::memory_order_acquire);
+  if (arena_size == 0 ||
+      g_arena_thread_id.load(std::memory_order_relaxed) != CurrentThreadID()) {
+    return 0;
+  }
+
+  const size_t rounded_size = ArenaRoundUp(size);
+  if (rounded_size < size || rounded_size > arena_size - g_arena_used) {
+    return 0;
+  }
+
+  const vm_address_t address = g_arena_base + g_arena_used;
+  g_arena_used += rounded_size;
+  if (g_arena_used > g_arena_high_water) {
+    g_arena_high_water = g_arena_used;
+  }
+  return address;
+}
+
+// Reclaims an allocation made by ArenaAllocate() if it is the most recent one
+// still outstanding. Anything else is reclaimed when the arena is released.
+void ArenaFree(vm_address_t address, size_t size) {
+  const size_t rounded_size = ArenaRoundUp(size);
+  if (address + rounded_size == g_arena_base + g_arena_used) {
+    g_arena_used -= rounded_size;
+  }
+}
+
+}  // namespace
+
+ScopedVMReadArena::ScopedVMReadArena() : active_(false) {
+  if (g_arena_size.load(std::memory_order_acquire) == 0) {
+    return;
+  }
+  uint64_t expected = 0;
+  active_ = g_arena_thread_id.compare_exchange_strong(expected,
+                                                      CurrentThreadID());
+}
+
+ScopedVMReadArena::~ScopedVMReadArena() {
+  if (!active_) {
+    return;
+  }
+
+  // Outside of a crash, don’t leave the pages that were used counted against
+  // the process.
+  if (g_arena_high_water > 0 &&
+      madvise(reinterpret_cast<void*>(g_arena_base),
+              round_page(g_arena_high_water),
+              MADV_FREE) != 0) {
+    CRASHPAD_RAW_LOG("madvise");
+  }
+  g_arena_used = 0;
+  g_arena_high_water = 0;
+  g_arena_thread_id.store(0, std::memory_order_release);
+}
+
+// static
+bool ScopedVMReadArena::Initialize(size_t size) {
+  if (g_arena_size.load(std::memory_order_acquire) != 0) {
+    return true;
+  }
+
+  const vm_size_t arena_size = round_page(size);
+  vm_address_t arena_base;
+  kern_return_t kr = vm_allocate(
+      mach_task_self(), &arena_base, arena_size, VM_FLAGS_ANYWHERE);
+  if (kr != KERN_SUCCESS) {
+    CRASHPAD_RAW_LOG_ERROR(kr, "vm_allocate");
+    return false;
+  }
+  g_arena_base = arena_base;
+  g_arena_size.store(arena_size, std::memory_order_release);
+  return true;
+}
+
 ScopedVMReadInternal::ScopedVMReadInternal()
-    : data_(0), vm_read_data_(0), vm_read_data_count_(0) {}
+    : data_(0), vm_read_data_(0), vm_read_data_count_(0), arena_size_(0) {}
 
 ScopedVMReadInternal::~ScopedVMReadInternal() {
-  if (data_) {
-    kern_return_t kr =
-        vm_deallocate(mach_task_self(), vm_read_data_, vm_read_data_count_);
-    if (kr != KERN_SUCCESS)
-      CRASHPAD_RAW_LOG_ERROR(kr, "vm_deallocate");
-  }
+  Release();
 }
 
 bool ScopedVMReadInternal::Read(const void* data, const size_t data_length) {
-  if (data_) {
-    kern_return_t kr =
-        vm_deallocate(mach_task_self(), vm_read_data_, vm_read_data_count_);
-    if (kr != KERN_SUCCESS)
-      CRASHPAD_RAW_LOG_ERROR(kr, "vm_deallocate");
-    data_ = 0;
-  }
+  Release();
+
   vm_address_t data_address = reinterpret_cast<vm_address_t>(data);
+  if (data_length > 0) {
+    vm_address_t arena_data = ArenaAllocate(data_length);
+    if (arena_data) {
+      vm_size_t bytes_read = 0;
+      kern_return_t kr = vm_read_overwrite(mach_task_self(),
+                                           data_address,
+                                           data_length,
+                                           arena_data,
+                                           &bytes_read);
+      if (kr != KERN_SUCCESS || bytes_read != data_length) {
+        // It's expected that this will sometimes fail. Don't log here.
+        ArenaFree(arena_data, data_length);
+        return false;
+      }
+      data_ = arena_data;
+      arena_size_ = data_length;
+      return true;
+    }
+  }
+
   vm_address_t page_region_address = trunc_page(data_address);
   vm_size_t page_region_size =
       round_page(data_address - page_region_address + data_length);
@@ -62,5 +189,21 @@ bool ScopedVMReadInternal::Read(const void* data, const size_t data_length) {
   }
 }
 
+void ScopedVMReadInternal::Release() {
+  if (!data_) {
+    return;
+  }
+  if (arena_size_) {
+    ArenaFree(data_, arena_size_);
+    arena_size_ = 0;
+  } else {
+    kern_return_t kr =
+        vm_deallocate(mach_task_self(), vm_read_data_, vm_read_data_count_);
+    if (kr != KERN_SUCCESS)
+      CRASHPAD_RAW_LOG_ERROR(kr, "vm_deallocate");
+  }
+  data_ = 0;
+}
+
 }  // namespace internal
 }  // namespace crashpad
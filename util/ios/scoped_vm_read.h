@@ -16,11 +16,53 @@
 #define CRASHPAD_UTIL_IOS_SCOPED_VM_READ_H_
 
 #include <mach/mach.h>
-
+#include <stddef.h>
 
 namespace crashpad {
 namespace internal {
 
+//! \brief Makes a pre-allocated scratch arena available to ScopedVMRead on the
+//!     calling thread for the lifetime of this object.
+//!
+//! While the arena is in use, ScopedVMRead copies data into it with
+//! `vm_read_overwrite()`, rather than mapping new memory with `vm_read()` and
+//! unmapping it with `vm_deallocate()` for each object read. Arena memory is
+//! reclaimed as ScopedVMRead objects are destroyed or re-read, in the reverse
+//! order that it was handed out, and all of it is reclaimed when this object is
+//! destroyed. Reads that don’t fit in the arena fall back to `vm_read()`.
+//!
+//! Only one thread can use the arena at a time. If the arena hasn’t been
+//! initialized, or another thread is using it, this object has no effect.
+//! Every ScopedVMRead that reads into the arena must be destroyed before this
+//! object is.
+//!
+//! Note: RUNS-DURING-CRASH, other than Initialize().
+class ScopedVMReadArena {
+ public:
+  ScopedVMReadArena();
+
+  ScopedVMReadArena(const ScopedVMReadArena&) = delete;
+  ScopedVMReadArena& operator=(const ScopedVMReadArena&) = delete;
+
+  ~ScopedVMReadArena();
+
+  //! \brief Allocates the arena. This must be called before any crash, and
+  //!     later calls have no effect.
+  //!
+  //! \param[in] size The size of the arena, which will be rounded up to a
+  //!     multiple of the page size.
+  //!
+  //! \return `true` if the arena was allocated by this or an earlier call.
+  static bool Initialize(size_t size);
+
+  //! \return `true` if the arena is available to the calling thread.
+  bool is_active() const { return active_; }
+
+ private:
+  bool active_;
+};
+
+
 //! \brief Non-templated internal class to be used by ScopedVMRead.
 //!
 //! Note: RUNS-DURING-CRASH.
@@ -46,6 +88,9 @@ class ScopedVMReadInternal {
   vm_address_t data() const { return data_; }
 
  private:
+  // Releases any previously read data.
+  void Release();
+
   // The address of the requested data.
   vm_address_t data_;
 
@@ -54,11 +99,18 @@ class ScopedVMReadInternal {
 
   // The size of the pages that were actually read.
   mach_msg_type_number_t vm_read_data_count_;
+
+  // If the data was copied into the ScopedVMReadArena rather than being read
+  // with vm_read, the size of the arena allocation, and 0 otherwise.
+  size_t arena_size_;
 };
 
 //! \brief A scoped wrapper for calls to `vm_read` and `vm_deallocate`.  Allows
 //!     in-process handler to safely read memory for the intermediate dump.
 //!
+//! While a ScopedVMReadArena is active on the calling thread, data is copied
+//! into the arena instead.
+//!
 //! Note: RUNS-DURING-CRASH.
 template <typename T>
 class ScopedVMRead {
@@ -14,8 +14,11 @@
 
 #include "util/ios/scoped_vm_read.h"
 
+#include <string.h>
 #include <sys/time.h>
 
+#include <vector>
+
 #include "base/mac/scoped_mach_vm.h"
 #include "gtest/gtest.h"
 
@@ -79,6 +82,46 @@ TEST(ScopedVMReadTest, MissingMiddleVM) {
   ASSERT_TRUE(vmread_missing_middle.Read(region, page_size));
 }
 
+TEST(ScopedVMReadTest, Arena) {
+  ASSERT_TRUE(internal::ScopedVMReadArena::Initialize(getpagesize()));
+
+  constexpr char read_me[] = "read me";
+  {
+    internal::ScopedVMReadArena arena;
+    ASSERT_TRUE(arena.is_active());
+
+    // Only one arena can be active at a time.
+    internal::ScopedVMReadArena nested_arena;
+    EXPECT_FALSE(nested_arena.is_active());
+
+    internal::ScopedVMRead<char> vmread_string;
+    ASSERT_TRUE(vmread_string.Read(read_me, strlen(read_me)));
+    EXPECT_STREQ(read_me, vmread_string.get());
+
+    // Reads that don’t fit in the arena fall back to vm_read().
+    std::vector<char> large(getpagesize() * 2, 'x');
+    internal::ScopedVMRead<char> vmread_large;
+    ASSERT_TRUE(vmread_large.Read(large.data(), large.size()));
+    EXPECT_EQ(memcmp(large.data(), vmread_large.get(), large.size()), 0);
+
+    // Re-reading into the arena reuses the space.
+    for (int iteration = 0; iteration < 1000; ++iteration) {
+      timeval time_of_day;
+      EXPECT_TRUE(gettimeofday(&time_of_day, nullptr) == 0);
+      internal::ScopedVMRead<timeval> vmread_time;
+      ASSERT_TRUE(vmread_time.Read(&time_of_day));
+      EXPECT_EQ(time_of_day.tv_usec, vmread_time->tv_usec);
+    }
+
+    internal::ScopedVMRead<vm_address_t> vmread_bad;
+    ASSERT_FALSE(vmread_bad.Read(reinterpret_cast<void*>(0x1000), 1));
+  }
+
+  // Once the arena is released, another one can be made.
+  internal::ScopedVMReadArena arena;
+  EXPECT_TRUE(arena.is_active());
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace crashpad
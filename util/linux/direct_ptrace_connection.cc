@@ -14,6 +14,8 @@
 
 #include "util/linux/direct_ptrace_connection.h"
 
+#include <string.h>
+
 #include <utility>
 
 #include "util/file/file_io.h"
@@ -25,6 +27,7 @@ DirectPtraceConnection::DirectPtraceConnection()
     : PtraceConnection(),
       attachments_(),
       memory_(),
+      task_file_reader_(),
       pid_(-1),
       ptracer_(/* can_log= */ true),
       initialized_() {}
@@ -39,6 +42,12 @@ bool DirectPtraceConnection::Initialize(pid_t pid) {
   }
   pid_ = pid;
 
+  // Without the task directory, files in it are read by full path instead.
+  task_file_reader_ = std::make_unique<ProcTaskFileReader>();
+  if (!task_file_reader_->Initialize(pid)) {
+    task_file_reader_.reset();
+  }
+
   INITIALIZATION_STATE_SET_VALID(initialized_);
   return true;
 }
@@ -57,6 +66,39 @@ bool DirectPtraceConnection::Attach(pid_t tid) {
   return true;
 }
 
+void DirectPtraceConnection::AttachThreads(const std::vector<pid_t>& tids,
+                                           std::vector<bool>* attached) {
+  // Every thread is asked to stop before waiting for any of them, so that the
+  // threads stop at nearly the same time instead of one after another, and
+  // the threads still running can’t change memory for as long.
+  std::vector<bool> interrupted(tids.size());
+  for (size_t index = 0; index < tids.size(); ++index) {
+    interrupted[index] =
+        PtraceSeizeAndInterrupt(tids[index], /* can_log= */ false);
+  }
+
+  attached->resize(tids.size());
+  for (size_t index = 0; index < tids.size(); ++index) {
+    if (!interrupted[index]) {
+      // PTRACE_SEIZE isn’t supported before Linux 3.4, so fall back to
+      // PTRACE_ATTACH, which also logs why the thread couldn’t be attached.
+      (*attached)[index] = Attach(tids[index]);
+      continue;
+    }
+
+    if (!PtraceWaitForStop(tids[index], /* can_log= */ true)) {
+      PtraceDetach(tids[index], /* can_log= */ false);
+      (*attached)[index] = false;
+      continue;
+    }
+
+    auto attach = std::make_unique<ScopedPtraceAttach>();
+    attach->ResetAdopt(tids[index]);
+    attachments_.push_back(std::move(attach));
+    (*attached)[index] = true;
+  }
+}
+
 bool DirectPtraceConnection::Is64Bit() {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
   return ptracer_.Is64Bit();
@@ -67,12 +109,30 @@ bool DirectPtraceConnection::GetThreadInfo(pid_t tid, ThreadInfo* info) {
   return ptracer_.GetThreadInfo(tid, info);
 }
 
+bool DirectPtraceConnection::GetThreadInfoWithoutFloatContext(
+    pid_t tid,
+    ThreadInfo* info) {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  memset(&info->float_context, 0, sizeof(info->float_context));
+  return ptracer_.GetThreadInfo(tid, info, /* float_context= */ false);
+}
+
 bool DirectPtraceConnection::ReadFileContents(const base::FilePath& path,
                                               std::string* contents) {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
   return LoggingReadEntireFile(path, contents);
 }
 
+bool DirectPtraceConnection::ReadThreadFileContents(pid_t tid,
+                                                    const char* name,
+                                                    std::string* contents) {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  if (!task_file_reader_) {
+    return PtraceConnection::ReadThreadFileContents(tid, name, contents);
+  }
+  return task_file_reader_->ReadFile(tid, name, contents);
+}
+
 ProcessMemoryLinux* DirectPtraceConnection::Memory() {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
   if (!memory_) {
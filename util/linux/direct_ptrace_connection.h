@@ -20,6 +20,7 @@
 #include <memory>
 #include <vector>
 
+#include "util/linux/proc_task_reader.h"
 #include "util/linux/ptrace_connection.h"
 #include "util/linux/ptracer.h"
 #include "util/linux/scoped_ptrace_attach.h"
@@ -54,10 +55,16 @@ class DirectPtraceConnection : public PtraceConnection {
 
   pid_t GetProcessID() override;
   bool Attach(pid_t tid) override;
+  void AttachThreads(const std::vector<pid_t>& tids,
+                     std::vector<bool>* attached) override;
   bool Is64Bit() override;
   bool GetThreadInfo(pid_t tid, ThreadInfo* info) override;
+  bool GetThreadInfoWithoutFloatContext(pid_t tid, ThreadInfo* info) override;
   bool ReadFileContents(const base::FilePath& path,
                         std::string* contents) override;
+  bool ReadThreadFileContents(pid_t tid,
+                              const char* name,
+                              std::string* contents) override;
   ProcessMemoryLinux* Memory() override;
   bool Threads(std::vector<pid_t>* threads) override;
   ssize_t ReadUpTo(VMAddress, size_t size, void* buffer) override;
@@ -65,6 +72,7 @@ class DirectPtraceConnection : public PtraceConnection {
  private:
   std::vector<std::unique_ptr<ScopedPtraceAttach>> attachments_;
   std::unique_ptr<ProcessMemoryLinux> memory_;
+  std::unique_ptr<ProcTaskFileReader> task_file_reader_;
   pid_t pid_;
   Ptracer ptracer_;
   InitializationStateDcheck initialized_;
@@ -0,0 +1,136 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/linux/directory_watcher.h"
+
+#include <errno.h>
+#include <limits.h>
+#include <poll.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#include <iterator>
+#include <string>
+
+#include "base/logging.h"
+#include "base/posix/eintr_wrapper.h"
+
+namespace crashpad {
+
+DirectoryWatcher::DirectoryWatcher()
+    : inotify_fd_(), stop_event_(), initialized_() {}
+
+DirectoryWatcher::~DirectoryWatcher() {}
+
+bool DirectoryWatcher::Initialize(const base::FilePath& directory) {
+  INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
+
+  inotify_fd_.reset(inotify_init1(IN_CLOEXEC | IN_NONBLOCK));
+  if (!inotify_fd_.is_valid()) {
+    PLOG(ERROR) << "inotify_init1";
+    return false;
+  }
+
+  if (inotify_add_watch(inotify_fd_.get(),
+                        directory.value().c_str(),
+                        IN_MODIFY | IN_MOVED_TO | IN_ONLYDIR) < 0) {
+    PLOG(ERROR) << "inotify_add_watch " << directory.value();
+    return false;
+  }
+
+  stop_event_.reset(eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK));
+  if (!stop_event_.is_valid()) {
+    PLOG(ERROR) << "eventfd";
+    return false;
+  }
+
+  INITIALIZATION_STATE_SET_VALID(initialized_);
+  return true;
+}
+
+bool DirectoryWatcher::WaitForChanges(std::vector<base::FilePath>* names) {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+
+  pollfd pollfds[2] = {};
+  pollfds[0].fd = stop_event_.get();
+  pollfds[0].events = POLLIN;
+  pollfds[1].fd = inotify_fd_.get();
+  pollfds[1].events = POLLIN;
+  if (HANDLE_EINTR(poll(pollfds, std::size(pollfds), -1)) < 0) {
+    PLOG(ERROR) << "poll";
+    return false;
+  }
+
+  if (pollfds[0].revents != 0) {
+    return false;
+  }
+
+  if (pollfds[1].revents & (POLLERR | POLLHUP | POLLNVAL)) {
+    LOG(ERROR) << "poll: unexpected events 0x" << std::hex
+               << pollfds[1].revents;
+    return false;
+  }
+
+  names->clear();
+
+  // Each read returns only whole events, and at least one event fits in the
+  // buffer.
+  alignas(inotify_event) char
+      buffer[16 * (sizeof(inotify_event) + NAME_MAX + 1)];
+  while (true) {
+    ssize_t bytes_read =
+        HANDLE_EINTR(read(inotify_fd_.get(), buffer, sizeof(buffer)));
+    if (bytes_read < 0) {
+      if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        return true;
+      }
+      PLOG(ERROR) << "read";
+      return false;
+    }
+    if (bytes_read == 0) {
+      LOG(ERROR) << "read: unexpected EOF";
+      return false;
+    }
+
+    for (ssize_t offset = 0; offset < bytes_read;) {
+      inotify_event event;
+      memcpy(&event, buffer + offset, sizeof(event));
+
+      if (event.mask & IN_Q_OVERFLOW) {
+        names->push_back(base::FilePath());
+      } else if (event.mask & IN_IGNORED) {
+        LOG(ERROR) << "watched directory was removed";
+        return false;
+      } else if (event.len > 0) {
+        const char* name = buffer + offset + sizeof(event);
+        names->push_back(
+            base::FilePath(std::string(name, strnlen(name, event.len))));
+      }
+
+      offset += sizeof(event) + event.len;
+    }
+  }
+}
+
+void DirectoryWatcher::Stop() {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+
+  uint64_t value = 1;
+  LoggingWriteFile(stop_event_.get(), &value, sizeof(value));
+}
+
+}  // namespace crashpad
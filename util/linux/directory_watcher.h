@@ -0,0 +1,76 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_UTIL_LINUX_DIRECTORY_WATCHER_H_
+#define CRASHPAD_UTIL_LINUX_DIRECTORY_WATCHER_H_
+
+#include <vector>
+
+#include "base/files/file_path.h"
+#include "util/file/file_io.h"
+#include "util/misc/initialization_state_dcheck.h"
+
+namespace crashpad {
+
+//! \brief Uses inotify to wait for files in a directory to be written to or
+//!     moved into it.
+//!
+//! A file is reported when data is written to it, and each time it is renamed
+//! into the directory. Several writes in quick succession may be reported
+//! together. Changes in subdirectories are not reported.
+class DirectoryWatcher {
+ public:
+  DirectoryWatcher();
+
+  DirectoryWatcher(const DirectoryWatcher&) = delete;
+  DirectoryWatcher& operator=(const DirectoryWatcher&) = delete;
+
+  ~DirectoryWatcher();
+
+  //! \brief Starts watching a directory.
+  //!
+  //! This method must be successfully called before calling any other.
+  //!
+  //! \param[in] directory The directory to watch.
+  //!
+  //! \return `true` on success. `false` on failure, with a message logged.
+  bool Initialize(const base::FilePath& directory);
+
+  //! \brief Waits for files in the directory to change.
+  //!
+  //! \param[out] names The names of the files that changed, relative to the
+  //!     watched directory. A file that changed more than once since the last
+  //!     call may be listed more than once. An empty name indicates that
+  //!     changes were lost because too many were queued, so any file may have
+  //!     changed.
+  //!
+  //! \return `true` on success, with \a names set. `false` if Stop() was
+  //!     called or on failure, with a message logged on failure.
+  bool WaitForChanges(std::vector<base::FilePath>* names);
+
+  //! \brief Causes any current or future call to WaitForChanges() to return
+  //!     `false`.
+  //!
+  //! This method may be called from any thread.
+  void Stop();
+
+ private:
+  ScopedFileHandle inotify_fd_;
+  ScopedFileHandle stop_event_;
+  InitializationStateDcheck initialized_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_UTIL_LINUX_DIRECTORY_WATCHER_H_
@@ -0,0 +1,116 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/linux/directory_watcher.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "test/scoped_temp_dir.h"
+#include "util/file/file_io.h"
+#include "util/file/filesystem.h"
+#include "util/thread/thread.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+void WriteTestFile(const base::FilePath& path) {
+  ScopedFileHandle handle(LoggingOpenFileForWrite(
+      path, FileWriteMode::kTruncateOrCreate, FilePermissions::kOwnerOnly));
+  ASSERT_TRUE(handle.is_valid());
+  ASSERT_TRUE(LoggingWriteFile(handle.get(), "data", 4));
+}
+
+bool Contains(const std::vector<base::FilePath>& names,
+              const base::FilePath& name) {
+  return std::find(names.begin(), names.end(), name) != names.end();
+}
+
+TEST(DirectoryWatcher, WrittenAndMovedFiles) {
+  ScopedTempDir temp_dir;
+  const base::FilePath subdirectory(
+      temp_dir.path().Append(FILE_PATH_LITERAL("subdirectory")));
+  ASSERT_TRUE(LoggingCreateDirectory(
+      subdirectory, FilePermissions::kOwnerOnly, false));
+
+  DirectoryWatcher watcher;
+  ASSERT_TRUE(watcher.Initialize(temp_dir.path()));
+
+  const base::FilePath written(FILE_PATH_LITERAL("written"));
+  ASSERT_NO_FATAL_FAILURE(WriteTestFile(temp_dir.path().Append(written)));
+
+  std::vector<base::FilePath> names;
+  ASSERT_TRUE(watcher.WaitForChanges(&names));
+  EXPECT_TRUE(Contains(names, written));
+
+  // Changes in subdirectories aren’t reported, but moving a file out of one
+  // is.
+  const base::FilePath moved(FILE_PATH_LITERAL("moved"));
+  ASSERT_NO_FATAL_FAILURE(WriteTestFile(subdirectory.Append(moved)));
+  ASSERT_TRUE(MoveFileOrDirectory(subdirectory.Append(moved),
+                                  temp_dir.path().Append(moved)));
+
+  ASSERT_TRUE(watcher.WaitForChanges(&names));
+  EXPECT_EQ(names, std::vector<base::FilePath>({moved}));
+}
+
+class StopThread : public Thread {
+ public:
+  explicit StopThread(DirectoryWatcher* watcher)
+      : Thread(), watcher_(watcher) {}
+
+  StopThread(const StopThread&) = delete;
+  StopThread& operator=(const StopThread&) = delete;
+
+  ~StopThread() override {}
+
+ private:
+  void ThreadMain() override { watcher_->Stop(); }
+
+  DirectoryWatcher* watcher_;  // weak
+};
+
+TEST(DirectoryWatcher, Stop) {
+  ScopedTempDir temp_dir;
+
+  DirectoryWatcher watcher;
+  ASSERT_TRUE(watcher.Initialize(temp_dir.path()));
+
+  StopThread thread(&watcher);
+  thread.Start();
+
+  std::vector<base::FilePath> names;
+  EXPECT_FALSE(watcher.WaitForChanges(&names));
+  thread.Join();
+
+  // Once stopped, the watcher stays stopped, even if there are changes to
+  // report.
+  ASSERT_NO_FATAL_FAILURE(
+      WriteTestFile(temp_dir.path().Append(FILE_PATH_LITERAL("file"))));
+  EXPECT_FALSE(watcher.WaitForChanges(&names));
+}
+
+TEST(DirectoryWatcher, MissingDirectory) {
+  ScopedTempDir temp_dir;
+
+  DirectoryWatcher watcher;
+  EXPECT_FALSE(watcher.Initialize(
+      temp_dir.path().Append(FILE_PATH_LITERAL("missing"))));
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
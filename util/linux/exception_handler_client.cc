@@ -15,11 +15,17 @@
 #include "util/linux/exception_handler_client.h"
 
 #include <errno.h>
+#include <fcntl.h>
+#include <linux/futex.h>
 #include <signal.h>
+#include <sys/mman.h>
 #include <sys/prctl.h>
+#include <sys/socket.h>
 #include <sys/wait.h>
 #include <unistd.h>
 
+#include <iterator>
+
 #include "base/logging.h"
 #include "base/posix/eintr_wrapper.h"
 #include "build/build_config.h"
@@ -61,10 +67,33 @@ class ScopedSigprocmaskRestore {
   bool mask_is_set_;
 };
 
+// Creates a shared memory object of size bytes to hold a region shared with
+// the handler. The object is sealed so that it can’t be shrunk, which would
+// make the handler’s accesses to its mapping fault.
+ScopedFileHandle CreateSharedRegion(const char* name, size_t size) {
+  ScopedFileHandle memfd(
+      HANDLE_EINTR(memfd_create(name, MFD_CLOEXEC | MFD_ALLOW_SEALING)));
+  if (!memfd.is_valid()) {
+    PLOG(ERROR) << "memfd_create";
+    return ScopedFileHandle();
+  }
+  if (HANDLE_EINTR(ftruncate(memfd.get(), size)) != 0) {
+    PLOG(ERROR) << "ftruncate";
+    return ScopedFileHandle();
+  }
+  if (HANDLE_EINTR(fcntl(memfd.get(), F_ADD_SEALS, F_SEAL_SHRINK)) != 0) {
+    PLOG(ERROR) << "fcntl F_ADD_SEALS";
+    return ScopedFileHandle();
+  }
+  return memfd;
+}
+
 }  // namespace
 
 ExceptionHandlerClient::ExceptionHandlerClient(int sock, bool multiple_clients)
     : server_sock_(sock),
+      crash_signal_region_(nullptr),
+      crash_signal_sock_(-1),
       ptracer_(-1),
       can_set_ptracer_(true),
       multiple_clients_(multiple_clients) {}
@@ -85,10 +114,159 @@ bool ExceptionHandlerClient::GetHandlerCredentials(ucred* creds) {
       server_sock_, &response, sizeof(response), creds);
 }
 
+bool ExceptionHandlerClient::RegisterCrashSignalRegion(
+    ScopedMmap* region,
+    ScopedFileHandle* wake_sock) {
+  using CrashSignalRegion = ExceptionHandlerProtocol::CrashSignalRegion;
+
+  ScopedFileHandle memfd(
+      CreateSharedRegion("crashpad_crash_signal", sizeof(CrashSignalRegion)));
+  if (!memfd.is_valid()) {
+    return false;
+  }
+
+  ScopedMmap local_region;
+  if (!local_region.ResetMmap(nullptr,
+                              sizeof(CrashSignalRegion),
+                              PROT_READ | PROT_WRITE,
+                              MAP_SHARED,
+                              memfd.get(),
+                              0)) {
+    return false;
+  }
+  auto signal_region = local_region.addr_as<CrashSignalRegion*>();
+  signal_region->version = CrashSignalRegion::kVersion;
+  signal_region->pid = getpid();
+
+  int socks[2];
+  if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, socks) != 0) {
+    PLOG(ERROR) << "socketpair";
+    return false;
+  }
+  ScopedFileHandle local_sock(socks[0]);
+  ScopedFileHandle handler_sock(socks[1]);
+
+  ExceptionHandlerProtocol::ClientToServerMessage message = {};
+  message.type =
+      ExceptionHandlerProtocol::ClientToServerMessage::kTypeRegisterCrashSignal;
+  const int fds[] = {memfd.get(), handler_sock.get()};
+  if (UnixCredentialSocket::SendMsg(
+          server_sock_, &message, sizeof(message), fds, std::size(fds)) != 0) {
+    return false;
+  }
+  handler_sock.reset();
+
+  ExceptionHandlerProtocol::ServerToClientMessage response;
+  if (!LoggingReadFileExactly(local_sock.get(), &response, sizeof(response))) {
+    return false;
+  }
+  if (response.type != ExceptionHandlerProtocol::ServerToClientMessage::
+                           kTypeCrashSignalRegistered) {
+    LOG(ERROR) << "crash signal region rejected";
+    return false;
+  }
+
+  region->ResetAddrLen(local_region.release(), sizeof(CrashSignalRegion));
+  wake_sock->swap(local_sock);
+  return true;
+}
+
+bool ExceptionHandlerClient::SetAnnotations(
+    const std::map<std::string, std::string>& annotations) {
+  std::string serialized;
+  for (const auto& annotation : annotations) {
+    serialized.append(annotation.first);
+    serialized.push_back('\0');
+    serialized.append(annotation.second);
+    serialized.push_back('\0');
+  }
+  if (serialized.size() >
+      ExceptionHandlerProtocol::kMaxClientAnnotationsSize) {
+    LOG(ERROR) << "annotations too large " << serialized.size();
+    return false;
+  }
+
+  ScopedFileHandle memfd(
+      HANDLE_EINTR(memfd_create("crashpad_annotations", MFD_CLOEXEC)));
+  if (!memfd.is_valid()) {
+    PLOG(ERROR) << "memfd_create";
+    return false;
+  }
+  if (!LoggingWriteFile(memfd.get(), serialized.data(), serialized.size())) {
+    return false;
+  }
+
+  ExceptionHandlerProtocol::ClientToServerMessage message = {};
+  message.type =
+      ExceptionHandlerProtocol::ClientToServerMessage::kTypeSetAnnotations;
+  const int fd = memfd.get();
+  return UnixCredentialSocket::SendMsg(
+             server_sock_, &message, sizeof(message), &fd, 1) == 0;
+}
+
+bool ExceptionHandlerClient::RegisterHangWatchdogRegion(ScopedMmap* region) {
+  using HangWatchdogRegion = ExceptionHandlerProtocol::HangWatchdogRegion;
+
+  ScopedFileHandle memfd(CreateSharedRegion("crashpad_hang_watchdog",
+                                            sizeof(HangWatchdogRegion)));
+  if (!memfd.is_valid()) {
+    return false;
+  }
+
+  ScopedMmap local_region;
+  if (!local_region.ResetMmap(nullptr,
+                              sizeof(HangWatchdogRegion),
+                              PROT_READ | PROT_WRITE,
+                              MAP_SHARED,
+                              memfd.get(),
+                              0)) {
+    return false;
+  }
+  auto watchdog_region = local_region.addr_as<HangWatchdogRegion*>();
+  watchdog_region->version = HangWatchdogRegion::kVersion;
+  watchdog_region->pid = getpid();
+
+  ExceptionHandlerProtocol::ClientToServerMessage message = {};
+  message.type = ExceptionHandlerProtocol::ClientToServerMessage::
+      kTypeRegisterHangWatchdog;
+  const int fd = memfd.get();
+  if (UnixCredentialSocket::SendMsg(
+          server_sock_, &message, sizeof(message), &fd, 1) != 0) {
+    return false;
+  }
+
+  region->ResetAddrLen(local_region.release(), sizeof(HangWatchdogRegion));
+  return true;
+}
+
+bool ExceptionHandlerClient::RequestStackSampling() {
+  ExceptionHandlerProtocol::ClientToServerMessage message = {};
+  message.type = ExceptionHandlerProtocol::ClientToServerMessage::
+      kTypeRequestStackSampling;
+  return UnixCredentialSocket::SendMsg(
+             server_sock_, &message, sizeof(message)) == 0;
+}
+
+void ExceptionHandlerClient::SetCrashSignalRegion(
+    ExceptionHandlerProtocol::CrashSignalRegion* region,
+    int wake_sock) {
+  crash_signal_region_ = region;
+  crash_signal_sock_ = wake_sock;
+}
+
 int ExceptionHandlerClient::RequestCrashDump(
     const ExceptionHandlerProtocol::ClientInformation& info) {
   VMAddress sp = FromPointerCast<VMAddress>(&sp);
 
+  // A child forked from the process that registered the region shares it, but
+  // the handler would attribute the request to the parent.
+  if (crash_signal_region_ && crash_signal_region_->pid == sys_getpid()) {
+    int status = SignalCrashDumpThroughRegion(info, sp);
+    if (status != ENOSPC) {
+      return status;
+    }
+  }
+
   if (multiple_clients_) {
     return SignalCrashDump(info, sp);
   }
@@ -155,6 +333,64 @@ int ExceptionHandlerClient::SendCrashDumpRequest(
   return UnixCredentialSocket::SendMsg(server_sock_, &message, sizeof(message));
 }
 
+int ExceptionHandlerClient::SignalCrashDumpThroughRegion(
+    const ExceptionHandlerProtocol::ClientInformation& info,
+    VMAddress stack_pointer) {
+  using CrashSignalSlot = ExceptionHandlerProtocol::CrashSignalSlot;
+
+  // A slot that timed out waiting for the handler stays kStateDumping until
+  // the handler is done with it, so it isn’t reused while the handler may
+  // still write to it.
+  CrashSignalSlot* slot = nullptr;
+  for (CrashSignalSlot& candidate : crash_signal_region_->slots) {
+    int32_t state = __atomic_load_n(&candidate.state, __ATOMIC_ACQUIRE);
+    if ((state == CrashSignalSlot::kStateFree ||
+         state == CrashSignalSlot::kStateDone) &&
+        __atomic_compare_exchange_n(&candidate.state,
+                                    &state,
+                                    CrashSignalSlot::kStateClaimed,
+                                    false,
+                                    __ATOMIC_ACQUIRE,
+                                    __ATOMIC_RELAXED)) {
+      slot = &candidate;
+      break;
+    }
+  }
+  if (!slot) {
+    return ENOSPC;
+  }
+
+  slot->requesting_thread_stack_address = stack_pointer;
+  slot->client_info = info;
+  __atomic_store_n(
+      &slot->state, CrashSignalSlot::kStateRequested, __ATOMIC_RELEASE);
+
+  const char wake = 0;
+  if (HANDLE_EINTR(send(
+          crash_signal_sock_, &wake, sizeof(wake), MSG_NOSIGNAL)) !=
+      sizeof(wake)) {
+    int error = errno;
+    __atomic_store_n(
+        &slot->state, CrashSignalSlot::kStateFree, __ATOMIC_RELEASE);
+    return error;
+  }
+
+  kernel_timespec timeout;
+  timeout.tv_sec = 5;
+  timeout.tv_nsec = 0;
+  int32_t state;
+  while ((state = __atomic_load_n(&slot->state, __ATOMIC_ACQUIRE)) !=
+         CrashSignalSlot::kStateDone) {
+    // The region is shared with the handler, so this can’t be a private
+    // futex.
+    if (sys_futex(&slot->state, FUTEX_WAIT, state, &timeout, nullptr, 0) != 0 &&
+        errno != EAGAIN && errno != EINTR) {
+      return errno;
+    }
+  }
+  return 0;
+}
+
 int ExceptionHandlerClient::WaitForCrashDumpComplete() {
   ExceptionHandlerProtocol::ServerToClientMessage message;
 
@@ -18,7 +18,12 @@
 #include <sys/socket.h>
 #include <sys/types.h>
 
+#include <map>
+#include <string>
+
+#include "util/file/file_io.h"
 #include "util/linux/exception_handler_protocol.h"
+#include "util/posix/scoped_mmap.h"
 
 namespace crashpad {
 
@@ -48,10 +53,69 @@ class ExceptionHandlerClient {
   //! \return `true` on success. Otherwise, `false` with a message logged.
   bool GetHandlerCredentials(ucred* creds);
 
+  //! \brief Registers a CrashSignalRegion for this process with the handler.
+  //!
+  //! Once registered, crash dumps may be requested through the region by
+  //! passing it to SetCrashSignalRegion(), which avoids a message on the
+  //! socket at crash time. The handler must support
+  //! ExceptionHandlerProtocol::ClientToServerMessage::kTypeRegisterCrashSignal.
+  //!
+  //! \param[out] region The mapped CrashSignalRegion, valid if this method
+  //!     returns `true`.
+  //! \param[out] wake_sock The socket used to wake the handler, valid if this
+  //!     method returns `true`.
+  //! \return `true` on success. Otherwise, `false` with a message logged.
+  bool RegisterCrashSignalRegion(ScopedMmap* region,
+                                 ScopedFileHandle* wake_sock);
+
+  //! \brief Sets annotations for the handler to add to crash reports for
+  //!     this process.
+  //!
+  //! This lets a handler shared by several unrelated clients, such as one
+  //! started with `--daemon`, record annotations that differ between them. The
+  //! handler must support
+  //! ExceptionHandlerProtocol::ClientToServerMessage::kTypeSetAnnotations.
+  //!
+  //! \param[in] annotations The annotations to set, replacing any set by an
+  //!     earlier call.
+  //! \return `true` on success. Otherwise, `false` with a message logged.
+  bool SetAnnotations(const std::map<std::string, std::string>& annotations);
+
+  //! \brief Registers a HangWatchdogRegion for this process with the handler.
+  //!
+  //! The handler watches the threads entered in the region for hangs, if it
+  //! has been started to do so. The handler must support
+  //! ExceptionHandlerProtocol::ClientToServerMessage::kTypeRegisterHangWatchdog.
+  //!
+  //! \param[out] region The mapped HangWatchdogRegion, with no threads
+  //!     entered, valid if this method returns `true`.
+  //! \return `true` on success. Otherwise, `false` with a message logged.
+  bool RegisterHangWatchdogRegion(ScopedMmap* region);
+
+  //! \brief Asks the handler to sample the stacks of this process' threads.
+  //!
+  //! The handler must support
+  //! ExceptionHandlerProtocol::ClientToServerMessage::kTypeRequestStackSampling.
+  //!
+  //! \return `true` on success. Otherwise, `false` with a message logged.
+  bool RequestStackSampling();
+
+  //! \brief Sets a CrashSignalRegion registered with
+  //!     RegisterCrashSignalRegion() for RequestCrashDump() to use.
+  //!
+  //! \param[in] region The region, or `nullptr` to only use the socket.
+  //! \param[in] wake_sock The socket registered with \a region.
+  void SetCrashSignalRegion(ExceptionHandlerProtocol::CrashSignalRegion* region,
+                            int wake_sock);
+
   //! \brief Request a crash dump from the ExceptionHandlerServer.
   //!
   //! This method blocks until the crash dump is complete.
   //!
+  //! If a CrashSignalRegion has been set with SetCrashSignalRegion() and has a
+  //! free slot, the request is made through it. Otherwise, it is sent on the
+  //! socket.
+  //!
   //! \param[in] info Information about this client.
   //! \return 0 on success or an error code on failure.
   int RequestCrashDump(const ExceptionHandlerProtocol::ClientInformation& info);
@@ -75,8 +139,13 @@ class ExceptionHandlerClient {
   int SignalCrashDump(const ExceptionHandlerProtocol::ClientInformation& info,
                       VMAddress stack_pointer);
   int WaitForCrashDumpComplete();
+  int SignalCrashDumpThroughRegion(
+      const ExceptionHandlerProtocol::ClientInformation& info,
+      VMAddress stack_pointer);
 
   int server_sock_;
+  ExceptionHandlerProtocol::CrashSignalRegion* crash_signal_region_;
+  int crash_signal_sock_;
   pid_t ptracer_;
   bool can_set_ptracer_;
   bool multiple_clients_;
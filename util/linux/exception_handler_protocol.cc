@@ -14,18 +14,34 @@
 
 #include "util/linux/exception_handler_protocol.h"
 
+#include <stddef.h>
+
 #include "build/build_config.h"
 
 namespace crashpad {
 
+// Futex words must be naturally aligned.
+static_assert(
+    offsetof(ExceptionHandlerProtocol::CrashSignalRegion, slots) % 8 == 0 &&
+        sizeof(ExceptionHandlerProtocol::CrashSignalSlot) % 8 == 0,
+    "CrashSignalSlot::state misaligned");
+
+// Heartbeats are accessed atomically.
+static_assert(
+    offsetof(ExceptionHandlerProtocol::HangWatchdogRegion, threads) % 8 == 0 &&
+        sizeof(ExceptionHandlerProtocol::HangWatchdogThread) % 8 == 0 &&
+        offsetof(ExceptionHandlerProtocol::HangWatchdogThread, heartbeat_ns) %
+                8 ==
+            0,
+    "HangWatchdogThread::heartbeat_ns misaligned");
+
 ExceptionHandlerProtocol::ClientInformation::ClientInformation()
     : exception_information_address(0),
-      sanitization_information_address(0)
+      sanitization_information_address(0),
 #if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS)
-      ,
-      crash_loop_before_time(0)
+      crash_loop_before_time(0),
 #endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS)
-{
+      simulated(0) {
 }
 
 ExceptionHandlerProtocol::ClientToServerMessage::ClientToServerMessage()
@@ -57,6 +57,14 @@ class ExceptionHandlerProtocol {
     //!     `/sbin/crash_reporter`.
     uint64_t crash_loop_before_time;
 #endif
+
+    //! \brief Nonzero if the client is requesting a dump without having
+    //!     crashed, such as with CrashpadClient::DumpWithoutCrash(), rather
+    //!     than for a crash signal.
+    //!
+    //! A handler may limit how often such dumps are taken, and takes them
+    //! after dumps of crashes.
+    uint32_t simulated;
   };
 
   //! \brief The signal used to indicate a crash dump is complete.
@@ -66,6 +74,14 @@ class ExceptionHandlerProtocol {
   //! the dump is either done or has failed and the client may continue.
   static constexpr int kDumpDoneSignal = SIGCONT;
 
+  //! \brief The name in the abstract socket namespace on which a handler
+  //!     started with `--daemon` listens for clients by default.
+  static constexpr char kDefaultDaemonSocketName[] = "crashpad_handler";
+
+  //! \brief The largest annotations object accepted with
+  //!     ClientToServerMessage::kTypeSetAnnotations.
+  static constexpr size_t kMaxClientAnnotationsSize = 64 * 1024;
+
   //! \brief The message passed from client to server.
   struct ClientToServerMessage {
     static constexpr int32_t kVersion = 1;
@@ -81,7 +97,43 @@ class ExceptionHandlerProtocol {
       kTypeCheckCredentials,
 
       //! \brief Used to request a crash dump for the sending client.
-      kTypeCrashDumpRequest
+      kTypeCrashDumpRequest,
+
+      //! \brief Registers a CrashSignalRegion for the sending client.
+      //!
+      //! The message carries two file descriptors with `SCM_RIGHTS`: a shared
+      //! memory object holding the CrashSignalRegion, sealed with
+      //! `F_SEAL_SHRINK`, and a connected socket used to wake the server. The
+      //! server replies on that socket with kTypeCrashSignalRegistered or
+      //! kTypeCrashSignalRejected.
+      kTypeRegisterCrashSignal,
+
+      //! \brief Sets annotations to add to crash reports for the sending
+      //!     client.
+      //!
+      //! The message carries one file descriptor with `SCM_RIGHTS`: a shared
+      //! memory object of at most kMaxClientAnnotationsSize bytes, holding
+      //! each annotation as a NUL-terminated key followed by a NUL-terminated
+      //! value. The annotations replace any set by an earlier message, and
+      //! are added to the handler's own process annotations, taking
+      //! precedence over them. There is no reply.
+      kTypeSetAnnotations,
+
+      //! \brief Registers a HangWatchdogRegion for the sending client.
+      //!
+      //! The message carries one file descriptor with `SCM_RIGHTS`: a shared
+      //! memory object holding the HangWatchdogRegion, sealed with
+      //! `F_SEAL_SHRINK`. The region replaces any
+      //! registered by an earlier message. A handler that isn't watching for
+      //! hangs ignores it. There is no reply.
+      kTypeRegisterHangWatchdog,
+
+      //! \brief Asks the handler to periodically sample the stacks of the
+      //!     sending client's threads.
+      //!
+      //! The recent samples are added to the client's crash and hang reports.
+      //! A handler that isn't sampling stacks ignores it. There is no reply.
+      kTypeRequestStackSampling
     };
 
     Type type;
@@ -114,7 +166,14 @@ class ExceptionHandlerProtocol {
 
       //! \brief Indicicates that the handler was unable to produce a crash
       //!     dump.
-      kTypeCrashDumpFailed
+      kTypeCrashDumpFailed,
+
+      //! \brief Indicates that the handler accepted a CrashSignalRegion.
+      kTypeCrashSignalRegistered,
+
+      //! \brief Indicates that the handler did not accept a
+      //!     CrashSignalRegion.
+      kTypeCrashSignalRejected
     };
 
     Type type;
@@ -123,6 +182,118 @@ class ExceptionHandlerProtocol {
     pid_t pid;
   };
 
+  //! \brief A crash dump request made through a CrashSignalRegion.
+  struct CrashSignalSlot {
+    enum State : int32_t {
+      //! \brief The slot has never been used.
+      kStateFree,
+
+      //! \brief The client is filling in the slot.
+      kStateClaimed,
+
+      //! \brief The client has requested a crash dump.
+      kStateRequested,
+
+      //! \brief The server is handling the request.
+      kStateDumping,
+
+      //! \brief The server has finished handling the request, and the slot may
+      //!     be used again.
+      kStateDone
+    };
+
+    //! \brief One of State, used as a futex by the client to wait for the
+    //!     server to finish handling its request.
+    int32_t state;
+
+    int32_t reserved;
+
+    //! \brief A stack address of the thread requesting the crash dump.
+    VMAddress requesting_thread_stack_address;
+
+    //! \brief Information about the client making the request.
+    ClientInformation client_info;
+  };
+
+  //! \brief Memory shared between a client and the server through which the
+  //!     client can request crash dumps without a message on its socket.
+  //!
+  //! The server records the client's credentials when the region is
+  //! registered. To request a crash dump, the client claims a slot, fills it
+  //! in, and writes a byte to the socket registered with the region.
+  struct CrashSignalRegion {
+    static constexpr int32_t kVersion = 1;
+
+    //! \brief The number of requests that may be in progress at once.
+    static constexpr size_t kSlotCount = 4;
+
+    //! \brief The version of this structure the client is using.
+    int32_t version;
+
+    //! \brief The process ID of the client that registered the region.
+    //!
+    //! Slots must only be used by this process. In particular, a child forked
+    //! from the client shares the region but must not use it.
+    pid_t pid;
+
+    CrashSignalSlot slots[kSlotCount];
+  };
+
+  //! \brief A thread watched for hangs through a HangWatchdogRegion.
+  //!
+  //! The fields are naturally aligned so that they can be accessed atomically.
+  struct HangWatchdogThread {
+    enum State : int32_t {
+      //! \brief The entry isn't in use.
+      kStateFree,
+
+      //! \brief The client is filling in the entry.
+      kStateClaimed,
+
+      //! \brief The thread is being watched.
+      kStateWatched
+    };
+
+    //! \brief One of State.
+    int32_t state;
+
+    //! \brief The thread ID of the watched thread.
+    pid_t thread_id;
+
+    //! \brief The number of milliseconds after its last heartbeat at which
+    //!     the thread is considered hung.
+    uint32_t timeout_ms;
+
+    //! \brief The thread ID of a thread that the watched thread is waiting
+    //!     for, such as the holder of a lock, or 0.
+    pid_t blocking_thread_id;
+
+    //! \brief The time of the thread's last heartbeat, from
+    //!     `CLOCK_MONOTONIC`, in nanoseconds.
+    uint64_t heartbeat_ns;
+  };
+
+  //! \brief Memory shared between a client and the server through which the
+  //!     server watches the client's threads for hangs.
+  //!
+  //! Each watched thread updates its heartbeat regularly. The server polls the
+  //! region, and takes a reduced snapshot of a client with a thread whose
+  //! heartbeat is overdue.
+  struct HangWatchdogRegion {
+    static constexpr int32_t kVersion = 1;
+
+    //! \brief The number of threads that may be watched at once.
+    static constexpr size_t kThreadCount = 32;
+
+    //! \brief The version of this structure the client is using.
+    int32_t version;
+
+    //! \brief The process ID of the client that registered the region.
+    pid_t pid;
+
+    HangWatchdogThread threads[kThreadCount];
+  };
+
   ExceptionHandlerProtocol() = delete;
   ExceptionHandlerProtocol(const ExceptionHandlerProtocol&) = delete;
   ExceptionHandlerProtocol& operator=(const ExceptionHandlerProtocol&) = delete;
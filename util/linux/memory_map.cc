@@ -18,24 +18,106 @@
 #include <string.h>
 #include <sys/sysmacros.h>
 
+#include <algorithm>
+#include <limits>
+
 #include "base/bit_cast.h"
 #include "base/files/file_path.h"
 #include "base/logging.h"
 #include "build/build_config.h"
-#include "util/file/delimited_file_reader.h"
-#include "util/file/file_io.h"
-#include "util/file/string_file.h"
-#include "util/stdlib/string_number_conversion.h"
 
 namespace crashpad {
 
 namespace {
 
+// Converts the |length| characters at |field| to a number in |base|, which
+// must be 10 or 16. Unlike StringToNumber(), this doesn’t need a
+// NUL-terminated copy of the field. Returns false if the field is empty,
+// contains anything other than digits, or overflows Type.
 template <typename Type>
-bool HexStringToNumber(const std::string& string, Type* number) {
-  return StringToNumber("0x" + string, number);
+bool FieldToNumber(const char* field,
+                   size_t length,
+                   unsigned int base,
+                   Type* number) {
+  if (length == 0) {
+    return false;
+  }
+
+  const uint64_t max = static_cast<uint64_t>(std::numeric_limits<Type>::max());
+  uint64_t value = 0;
+  for (size_t index = 0; index < length; ++index) {
+    const char c = field[index];
+    unsigned int digit;
+    if (c >= '0' && c <= '9') {
+      digit = c - '0';
+    } else if (base == 16 && c >= 'a' && c <= 'f') {
+      digit = c - 'a' + 10;
+    } else if (base == 16 && c >= 'A' && c <= 'F') {
+      digit = c - 'A' + 10;
+    } else {
+      return false;
+    }
+    if (value > (max - digit) / base) {
+      return false;
+    }
+    value = value * base + digit;
+  }
+
+  *number = static_cast<Type>(value);
+  return true;
 }
 
+// Splits the contents of a maps file into fields in place, without copying
+// them.
+class MapsLexer {
+ public:
+  explicit MapsLexer(const std::string& contents)
+      : cursor_(contents.data()), end_(contents.data() + contents.size()) {}
+
+  MapsLexer(const MapsLexer&) = delete;
+  MapsLexer& operator=(const MapsLexer&) = delete;
+
+  bool AtEnd() const { return cursor_ == end_; }
+
+  // Sets |field| and |length| to describe the characters up to the next
+  // |delimiter| and advances past the delimiter. Returns false if there is no
+  // subsequent |delimiter|.
+  bool ReadField(char delimiter, const char** field, size_t* length) {
+    const char* delimiter_position = static_cast<const char*>(
+        memchr(cursor_, delimiter, end_ - cursor_));
+    if (!delimiter_position) {
+      return false;
+    }
+    *field = cursor_;
+    *length = delimiter_position - cursor_;
+    cursor_ = delimiter_position + 1;
+    return true;
+  }
+
+  // Reads a field terminated by |delimiter| consisting of at least
+  // |min_digits| hexadecimal digits.
+  template <typename Type>
+  bool ReadHex(char delimiter, size_t min_digits, Type* number) {
+    const char* field;
+    size_t length;
+    return ReadField(delimiter, &field, &length) && length >= min_digits &&
+           FieldToNumber(field, length, 16, number);
+  }
+
+  // Reads a field terminated by |delimiter| consisting of decimal digits.
+  template <typename Type>
+  bool ReadDecimal(char delimiter, Type* number) {
+    const char* field;
+    size_t length;
+    return ReadField(delimiter, &field, &length) &&
+           FieldToNumber(field, length, 10, number);
+  }
+
+ private:
+  const char* cursor_;
+  const char* end_;
+};
+
 // The result from parsing a line from the maps file.
 enum class ParseResult {
   // A line was successfully parsed.
@@ -52,44 +134,35 @@ enum class ParseResult {
   kError
 };
 
-// Reads a line from a maps file being read by maps_file_reader and extends
-// mappings with a new MemoryMap::Mapping describing the line.
-ParseResult ParseMapsLine(DelimitedFileReader* maps_file_reader,
+// Reads a line from a maps file being split by lexer and extends mappings with
+// a new MemoryMap::Mapping describing the line.
+ParseResult ParseMapsLine(MapsLexer* lexer,
                           std::vector<MemoryMap::Mapping>* mappings) {
-  std::string field;
-  LinuxVMAddress start_address;
-  switch (maps_file_reader->GetDelim('-', &field)) {
-    case DelimitedFileReader::Result::kError:
-      return ParseResult::kError;
-    case DelimitedFileReader::Result::kEndOfFile:
-      return ParseResult::kEndOfFile;
-    case DelimitedFileReader::Result::kSuccess:
-      field.pop_back();
-      if (!HexStringToNumber(field, &start_address)) {
-        LOG(ERROR) << "format error";
-        return ParseResult::kError;
-      }
-      if (!mappings->empty() && start_address < mappings->back().range.End()) {
-        return ParseResult::kRetry;
-      }
+  if (lexer->AtEnd()) {
+    return ParseResult::kEndOfFile;
   }
 
-  LinuxVMAddress end_address;
-  if (maps_file_reader->GetDelim(' ', &field) !=
-          DelimitedFileReader::Result::kSuccess ||
-      (field.pop_back(), !HexStringToNumber(field, &end_address))) {
+  LinuxVMAddress start_address;
+  if (!lexer->ReadHex('-', 1, &start_address)) {
     LOG(ERROR) << "format error";
     return ParseResult::kError;
   }
-  if (end_address < start_address) {
+  if (!mappings->empty() && start_address < mappings->back().range.End()) {
+    return ParseResult::kRetry;
+  }
+
+  LinuxVMAddress end_address;
+  if (!lexer->ReadHex(' ', 1, &end_address) || end_address < start_address) {
     LOG(ERROR) << "format error";
     return ParseResult::kError;
   }
+
+  const char* field;
+  size_t length;
+
   // Skip zero-length mappings.
   if (end_address == start_address) {
-    std::string rest_of_line;
-    if (maps_file_reader->GetLine(&rest_of_line) !=
-        DelimitedFileReader::Result::kSuccess) {
+    if (!lexer->ReadField('\n', &field, &length)) {
       LOG(ERROR) << "format error";
       return ParseResult::kError;
     }
@@ -106,17 +179,15 @@ ParseResult ParseMapsLine(DelimitedFileReader* maps_file_reader,
   MemoryMap::Mapping mapping;
   mapping.range.SetRange(is_64_bit, start_address, end_address - start_address);
 
-  if (maps_file_reader->GetDelim(' ', &field) !=
-          DelimitedFileReader::Result::kSuccess ||
-      (field.pop_back(), field.size() != 4)) {
+  if (!lexer->ReadField(' ', &field, &length) || length != 4) {
     LOG(ERROR) << "format error";
     return ParseResult::kError;
   }
 #define SET_FIELD(actual_c, outval, true_chars, false_chars) \
   do {                                                       \
-    if (strchr(true_chars, actual_c)) {                      \
+    if (actual_c && strchr(true_chars, actual_c)) {          \
       *outval = true;                                        \
-    } else if (strchr(false_chars, actual_c)) {              \
+    } else if (actual_c && strchr(false_chars, actual_c)) {  \
       *outval = false;                                       \
     } else {                                                 \
       LOG(ERROR) << "format error";                          \
@@ -129,56 +200,29 @@ ParseResult ParseMapsLine(DelimitedFileReader* maps_file_reader,
   SET_FIELD(field[3], &mapping.shareable, "sS", "p");
 #undef SET_FIELD
 
-  if (maps_file_reader->GetDelim(' ', &field) !=
-          DelimitedFileReader::Result::kSuccess ||
-      (field.pop_back(), !HexStringToNumber(field, &mapping.offset))) {
-    LOG(ERROR) << "format error";
-    return ParseResult::kError;
-  }
-
   uint32_t major;
-  if (maps_file_reader->GetDelim(':', &field) !=
-          DelimitedFileReader::Result::kSuccess ||
-      (field.pop_back(), field.size()) < 2 ||
-      !HexStringToNumber(field, &major)) {
-    LOG(ERROR) << "format error";
-    return ParseResult::kError;
-  }
-
   uint32_t minor;
-  if (maps_file_reader->GetDelim(' ', &field) !=
-          DelimitedFileReader::Result::kSuccess ||
-      (field.pop_back(), field.size()) < 2 ||
-      !HexStringToNumber(field, &minor)) {
+  if (!lexer->ReadHex(' ', 1, &mapping.offset) ||
+      !lexer->ReadHex(':', 2, &major) || !lexer->ReadHex(' ', 2, &minor) ||
+      !lexer->ReadDecimal(' ', &mapping.inode)) {
     LOG(ERROR) << "format error";
     return ParseResult::kError;
   }
-
   mapping.device = makedev(major, minor);
 
-  if (maps_file_reader->GetDelim(' ', &field) !=
-          DelimitedFileReader::Result::kSuccess ||
-      (field.pop_back(), !StringToNumber(field, &mapping.inode))) {
-    LOG(ERROR) << "format error";
-    return ParseResult::kError;
-  }
-
-  if (maps_file_reader->GetDelim('\n', &field) !=
-      DelimitedFileReader::Result::kSuccess) {
-    LOG(ERROR) << "format error";
-    return ParseResult::kError;
-  }
-  if (field.back() != '\n') {
+  if (!lexer->ReadField('\n', &field, &length)) {
     LOG(ERROR) << "format error";
     return ParseResult::kError;
   }
-  field.pop_back();
 
   mappings->push_back(mapping);
 
-  size_t path_start = field.find_first_not_of(' ');
-  if (path_start != std::string::npos) {
-    mappings->back().name = field.substr(path_start);
+  size_t path_start = 0;
+  while (path_start < length && field[path_start] == ' ') {
+    ++path_start;
+  }
+  if (path_start < length) {
+    mappings->back().name.assign(field + path_start, length - path_start);
   }
   return ParseResult::kSuccess;
 }
@@ -233,6 +277,10 @@ struct FastRange {
   VMSize size;
 };
 
+bool HasPrefix(const std::string& string, const char* prefix) {
+  return string.compare(0, strlen(prefix), prefix) == 0;
+}
+
 }  // namespace
 
 MemoryMap::Mapping::Mapping()
@@ -246,7 +294,13 @@ MemoryMap::Mapping::Mapping()
       executable(false),
       shareable(false) {}
 
-MemoryMap::MemoryMap() : mappings_(), connection_(nullptr), initialized_() {}
+MemoryMap::MemoryMap()
+    : mappings_(),
+      mapping_bases_(),
+      name_index_(),
+      file_index_(),
+      connection_(nullptr),
+      initialized_() {}
 
 MemoryMap::~MemoryMap() {}
 
@@ -267,10 +321,10 @@ bool MemoryMap::Initialize(PtraceConnection* connection) {
   // If the maps file is not read atomically, entries can be read multiple times
   // or missed entirely. The kernel reads entries from this file into a page
   // sized buffer, so maps files larger than a page require multiple reads.
-  // Attempt to reduce the time between reads by reading the entire file into a
-  // StringFile before attempting to parse it. If ParseMapsLine detects
-  // duplicate, overlapping, or out-of-order entries, it will trigger restarting
-  // the read up to |attempts| times.
+  // Attempt to reduce the time between reads by reading the entire file into
+  // memory before attempting to parse it. If ParseMapsLine detects duplicate,
+  // overlapping, or out-of-order entries, it will trigger restarting the read
+  // up to |attempts| times.
   int attempts = 3;
   do {
     std::string contents;
@@ -280,15 +334,15 @@ bool MemoryMap::Initialize(PtraceConnection* connection) {
       return false;
     }
 
-    StringFile maps_file;
-    maps_file.SetString(contents);
-    DelimitedFileReader maps_file_reader(&maps_file);
+    mappings_.clear();
+    MapsLexer lexer(contents);
 
     ParseResult result;
-    while ((result = ParseMapsLine(&maps_file_reader, &mappings_)) ==
+    while ((result = ParseMapsLine(&lexer, &mappings_)) ==
            ParseResult::kSuccess) {
     }
     if (result == ParseResult::kEndOfFile) {
+      BuildIndexes();
       INITIALIZATION_STATE_SET_VALID(initialized_);
       return true;
     }
@@ -303,28 +357,61 @@ bool MemoryMap::Initialize(PtraceConnection* connection) {
   return false;
 }
 
+void MemoryMap::BuildIndexes() {
+  mapping_bases_.reserve(mappings_.size());
+  for (size_t index = 0; index < mappings_.size(); ++index) {
+    const Mapping& mapping = mappings_[index];
+    mapping_bases_.push_back(mapping.range.Base());
+
+    // emplace() doesn’t replace an existing entry, so the lowest mapping with
+    // each name is the one indexed.
+    name_index_.emplace(mapping.name, index);
+
+    if (mapping.device != 0 || mapping.inode != 0) {
+      file_index_[std::make_pair(mapping.device, mapping.inode)].push_back(
+          index);
+    }
+  }
+}
+
+bool MemoryMap::FindIndex(const Mapping& mapping, size_t* index) const {
+  auto base = std::lower_bound(
+      mapping_bases_.begin(), mapping_bases_.end(), mapping.range.Base());
+  if (base == mapping_bases_.end() || *base != mapping.range.Base()) {
+    return false;
+  }
+
+  size_t candidate = base - mapping_bases_.begin();
+  if (!mapping.Equals(mappings_[candidate])) {
+    return false;
+  }
+
+  *index = candidate;
+  return true;
+}
+
 const MemoryMap::Mapping* MemoryMap::FindMapping(LinuxVMAddress address) const {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
   address = connection_->Memory()->PointerToAddress(address);
 
-  for (const auto& mapping : mappings_) {
-    if (mapping.range.Base() <= address && mapping.range.End() > address) {
-      return &mapping;
-    }
+  // Find the last mapping with a base at or below address.
+  auto base =
+      std::upper_bound(mapping_bases_.begin(), mapping_bases_.end(), address);
+  if (base == mapping_bases_.begin()) {
+    return nullptr;
   }
-  return nullptr;
+
+  const Mapping& mapping = mappings_[(base - mapping_bases_.begin()) - 1];
+  return mapping.range.End() > address ? &mapping : nullptr;
 }
 
 const MemoryMap::Mapping* MemoryMap::FindMappingWithName(
     const std::string& name) const {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
 
-  for (const auto& mapping : mappings_) {
-    if (mapping.name == name) {
-      return &mapping;
-    }
-  }
-  return nullptr;
+  auto iterator = name_index_.find(name);
+  return iterator == name_index_.end() ? nullptr
+                                       : &mappings_[iterator->second];
 }
 
 std::vector<CheckedRange<VMAddress>> MemoryMap::GetReadableRanges(
@@ -335,13 +422,22 @@ std::vector<CheckedRange<VMAddress>> MemoryMap::GetReadableRanges(
   VMAddress range_end = range.end();
   std::vector<FastRange> overlapping;
 
+  // Start from the first mapping that ends at or above the target range, which
+  // is either the last mapping with a base at or below range_base or the one
+  // after it.
+  size_t first = std::upper_bound(
+                     mapping_bases_.begin(), mapping_bases_.end(), range_base) -
+                 mapping_bases_.begin();
+  if (first > 0 && mappings_[first - 1].range.End() >= range_base) {
+    --first;
+  }
+
   // Find all readable ranges overlapping the target range, maintaining order.
-  for (const auto& mapping : mappings_) {
-    if (!mapping.readable)
-      continue;
-    if (mapping.range.End() < range_base)
-      continue;
+  for (size_t index = first; index < mappings_.size(); ++index) {
+    const Mapping& mapping = mappings_[index];
     if (mapping.range.Base() >= range_end)
+      break;
+    if (!mapping.readable)
       continue;
     // Special case: the "[vvar]" region is marked readable, but we can't
     // access it.
@@ -378,24 +474,58 @@ std::vector<CheckedRange<VMAddress>> MemoryMap::GetReadableRanges(
   return result;
 }
 
+std::vector<CheckedRange<VMAddress>> MemoryMap::GetFullMemoryRanges(
+    VMSize max_mapping_size) const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+
+  std::vector<CheckedRange<VMAddress, VMSize>> result;
+  for (const Mapping& mapping : mappings_) {
+    if (!mapping.readable ||
+        (mapping.inode == 0 && HasPrefix(mapping.name, "[vvar"))) {
+      continue;
+    }
+    if (mapping.inode != 0 && !mapping.writable) {
+      continue;
+    }
+    if (HasPrefix(mapping.name, "/dev/") &&
+        !HasPrefix(mapping.name, "/dev/ashmem") &&
+        !HasPrefix(mapping.name, "/dev/shm/") &&
+        !HasPrefix(mapping.name, "/dev/zero")) {
+      continue;
+    }
+    if (max_mapping_size && mapping.range.Size() > max_mapping_size) {
+      continue;
+    }
+
+    if (!result.empty() && result.back().end() == mapping.range.Base()) {
+      result.back().SetRange(result.back().base(),
+                             result.back().size() + mapping.range.Size());
+    } else {
+      result.emplace_back(mapping.range.Base(), mapping.range.Size());
+    }
+    DCHECK(result.back().IsValid());
+  }
+
+  return result;
+}
+
 std::unique_ptr<MemoryMap::Iterator> MemoryMap::FindFilePossibleMmapStarts(
     const Mapping& mapping) const {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
 
   std::vector<const Mapping*> possible_starts;
 
+  size_t mapping_index;
+  if (!FindIndex(mapping, &mapping_index)) {
+    LOG(ERROR) << "mapping not found";
+    return std::make_unique<SparseReverseIterator>();
+  }
+
   // If the mapping is anonymous, as is for the VDSO, there is no mapped file to
   // find the start of, so just return the input mapping.
   if (mapping.device == 0 && mapping.inode == 0) {
-    for (const auto& candidate : mappings_) {
-      if (mapping.Equals(candidate)) {
-        possible_starts.push_back(&candidate);
-        return std::make_unique<SparseReverseIterator>(possible_starts);
-      }
-    }
-
-    LOG(ERROR) << "mapping not found";
-    return std::make_unique<SparseReverseIterator>();
+    possible_starts.push_back(&mappings_[mapping_index]);
+    return std::make_unique<SparseReverseIterator>(possible_starts);
   }
 
 #if BUILDFLAG(IS_ANDROID)
@@ -418,46 +548,44 @@ std::unique_ptr<MemoryMap::Iterator> MemoryMap::FindFilePossibleMmapStarts(
 
     std::string libname =
         mapping.name.substr(strlen(kRelro), libname_end - strlen(kRelro));
-    for (const auto& candidate : mappings_) {
-      if (candidate.name.rfind(libname) != std::string::npos) {
-        possible_starts.push_back(&candidate);
-      }
-      if (mapping.Equals(candidate)) {
-        return std::make_unique<SparseReverseIterator>(possible_starts);
+    for (size_t index = 0; index <= mapping_index; ++index) {
+      if (mappings_[index].name.rfind(libname) != std::string::npos) {
+        possible_starts.push_back(&mappings_[index]);
       }
     }
+    return std::make_unique<SparseReverseIterator>(possible_starts);
   }
 #endif  // BUILDFLAG(IS_ANDROID)
 
-  for (const auto& candidate : mappings_) {
-    if (candidate.device == mapping.device &&
-        candidate.inode == mapping.inode
-#if !BUILDFLAG(IS_ANDROID)
-        // Libraries on Android may be mapped from zipfiles (APKs), in which
-        // case the offset is not 0.
-        && candidate.offset == 0
-#endif  // !BUILDFLAG(IS_ANDROID)
-    ) {
-      possible_starts.push_back(&candidate);
+  // The index lists every mapping of this file in ascending order, and
+  // includes mapping itself.
+  auto file = file_index_.find(std::make_pair(mapping.device, mapping.inode));
+  DCHECK(file != file_index_.end());
+  for (size_t candidate_index : file->second) {
+    if (candidate_index > mapping_index) {
+      break;
     }
-    if (mapping.Equals(candidate)) {
-      return std::make_unique<SparseReverseIterator>(possible_starts);
+#if !BUILDFLAG(IS_ANDROID)
+    // Libraries on Android may be mapped from zipfiles (APKs), in which case
+    // the offset is not 0.
+    if (mappings_[candidate_index].offset != 0) {
+      continue;
     }
+#endif  // !BUILDFLAG(IS_ANDROID)
+    possible_starts.push_back(&mappings_[candidate_index]);
   }
-
-  LOG(ERROR) << "mapping not found";
-  return std::make_unique<SparseReverseIterator>();
+  return std::make_unique<SparseReverseIterator>(possible_starts);
 }
 
 std::unique_ptr<MemoryMap::Iterator> MemoryMap::ReverseIteratorFrom(
     const Mapping& target) const {
-  for (auto riter = mappings_.crbegin(); riter != mappings_.rend(); ++riter) {
-    if (riter->Equals(target)) {
-      return std::make_unique<FullReverseIterator>(riter, mappings_.rend());
-    }
+  size_t index;
+  if (FindIndex(target, &index)) {
+    return std::make_unique<FullReverseIterator>(
+        mappings_.crbegin() + (mappings_.size() - 1 - index), mappings_.crend());
   }
-  return std::make_unique<FullReverseIterator>(mappings_.rend(),
-                                               mappings_.rend());
+  return std::make_unique<FullReverseIterator>(mappings_.crend(),
+                                               mappings_.crend());
 }
 
 }  // namespace crashpad
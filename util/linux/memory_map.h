@@ -17,8 +17,10 @@
 
 #include <sys/types.h>
 
+#include <map>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "util/linux/address_types.h"
@@ -30,6 +32,10 @@ namespace crashpad {
 
 //! \brief Accesses information about mapped memory in another process.
 //!
+//! Mappings are kept sorted by address, so that lookups by address are binary
+//! searches, and are indexed by name and by mapped file when this object is
+//! initialized. This keeps lookups fast in processes with very many mappings.
+//!
 //! The target process must be stopped to guarantee correct mappings. If the
 //! target process is not stopped, mappings may be invalid after the return from
 //! Initialize(), and even mappings existing at the time Initialize() was called
@@ -77,6 +83,10 @@ class MemoryMap {
   //!     it was obtained from.
   const Mapping* FindMappingWithName(const std::string& name) const;
 
+  //! \return All of the mappings, sorted by address. They are scoped to the
+  //!     lifetime of the MemoryMap object that they were obtained from.
+  const std::vector<Mapping>& Mappings() const { return mappings_; }
+
   //! \brief Given a range to be read from the target process, returns a vector
   //!     of ranges, representing the readable portions of the original range.
   //!
@@ -87,6 +97,23 @@ class MemoryMap {
   std::vector<CheckedRange<uint64_t>> GetReadableRanges(
       const CheckedRange<LinuxVMAddress, LinuxVMSize>& range) const;
 
+  //! \brief Returns the ranges of memory to capture in a full-memory snapshot
+  //!     of the process.
+  //!
+  //! Mappings that can’t be read, such as guard pages and reserved address
+  //! space, are left out. So are read-only mappings of files, whose contents
+  //! can be recovered from the files, and mappings of devices other than shared
+  //! memory, which may not be safe to read.
+  //!
+  //! \param[in] max_mapping_size Mappings larger than this are left out, so
+  //!     that large regions of address space that are mapped readable but
+  //!     largely unused aren’t captured. `0` leaves out no mappings by size.
+  //!
+  //! \return A vector of ranges, sorted by address, with abutting ranges
+  //!     coalesced.
+  std::vector<CheckedRange<uint64_t>> GetFullMemoryRanges(
+      LinuxVMSize max_mapping_size) const;
+
   //! \brief An abstract base class for iterating over ordered sets of mappings
   //!   in a MemoryMap.
   class Iterator {
@@ -138,7 +165,30 @@ class MemoryMap {
   std::unique_ptr<Iterator> ReverseIteratorFrom(const Mapping& mapping) const;
 
  private:
+  //! \brief Finds the index in #mappings_ of the mapping equal to \a mapping.
+  //!
+  //! \return `true` with \a index set on success, or `false` if no mapping
+  //!     equal to \a mapping is found.
+  bool FindIndex(const Mapping& mapping, size_t* index) const;
+
+  //! \brief Builds #mapping_bases_, #name_index_, and #file_index_ from
+  //!     #mappings_.
+  void BuildIndexes();
+
+  // Sorted by address, non-overlapping, and without zero-length mappings.
   std::vector<Mapping> mappings_;
+
+  // The base address of each mapping in mappings_, so that searches by address
+  // don’t need to touch the much larger Mapping objects.
+  std::vector<LinuxVMAddress> mapping_bases_;
+
+  // Maps a name to the index of the lowest mapping with that name.
+  std::map<std::string, size_t> name_index_;
+
+  // Maps a (device, inode) pair to the ascending indices of the mappings of
+  // that file.
+  std::map<std::pair<dev_t, ino_t>, std::vector<size_t>> file_index_;
+
   PtraceConnection* connection_;
   InitializationStateDcheck initialized_;
 };
@@ -20,6 +20,8 @@
 #include <sys/stat.h>
 #include <unistd.h>
 
+#include <vector>
+
 #include "base/files/file_path.h"
 #include "base/strings/stringprintf.h"
 #include "build/build_config.h"
@@ -121,6 +123,63 @@ TEST(MemoryMap, SelfBasic) {
   EXPECT_TRUE(mapping->shareable);
 }
 
+TEST(MemoryMap, SelfLookups) {
+  const size_t page_size = getpagesize();
+
+  // Split a mapping into readable, unreadable, and readable parts.
+  ScopedMmap mmapping;
+  ASSERT_TRUE(mmapping.ResetMmap(nullptr,
+                                 page_size * 3,
+                                 PROT_READ,
+                                 MAP_PRIVATE | MAP_ANON,
+                                 -1,
+                                 0));
+  ASSERT_EQ(mprotect(mmapping.addr_as<char*>() + page_size, page_size, 0), 0)
+      << ErrnoMessage("mprotect");
+
+  FakePtraceConnection connection;
+  ASSERT_TRUE(connection.Initialize(getpid()));
+
+  MemoryMap map;
+  ASSERT_TRUE(map.Initialize(&connection));
+
+  // Every mapping at or below the stack is found by each of its addresses, by
+  // its name, and as the start of a reverse iteration.
+  auto stack_address = FromPointerCast<LinuxVMAddress>(&map);
+  const MemoryMap::Mapping* stack_mapping = map.FindMapping(stack_address);
+  ASSERT_TRUE(stack_mapping);
+  auto mappings = map.ReverseIteratorFrom(*stack_mapping);
+  ASSERT_GT(mappings->Count(), 0u);
+  const MemoryMap::Mapping* previous = nullptr;
+  const MemoryMap::Mapping* mapping;
+  while ((mapping = mappings->Next())) {
+    if (previous) {
+      EXPECT_LE(mapping->range.End(), previous->range.Base());
+    }
+    EXPECT_EQ(map.FindMapping(mapping->range.Base()), mapping);
+    EXPECT_EQ(map.FindMapping(mapping->range.End() - 1), mapping);
+    EXPECT_EQ(map.ReverseIteratorFrom(*mapping)->Next(), mapping);
+
+    const MemoryMap::Mapping* named = map.FindMappingWithName(mapping->name);
+    ASSERT_TRUE(named);
+    EXPECT_EQ(named->name, mapping->name);
+    EXPECT_LE(named->range.Base(), mapping->range.Base());
+    previous = mapping;
+  }
+
+  EXPECT_FALSE(map.FindMappingWithName("crashpad_no_such_mapping"));
+
+  const auto mapping_address = mmapping.addr_as<LinuxVMAddress>();
+  std::vector<CheckedRange<uint64_t>> readable = map.GetReadableRanges(
+      CheckedRange<LinuxVMAddress, LinuxVMSize>(mapping_address + 1,
+                                                page_size * 3 - 2));
+  ASSERT_EQ(readable.size(), 2u);
+  EXPECT_EQ(readable[0].base(), mapping_address + 1);
+  EXPECT_EQ(readable[0].size(), page_size - 1);
+  EXPECT_EQ(readable[1].base(), mapping_address + page_size * 2);
+  EXPECT_EQ(readable[1].size(), page_size - 1);
+}
+
 void InitializeFile(const base::FilePath& path,
                     size_t size,
                     ScopedFileHandle* handle) {
@@ -665,6 +724,65 @@ TEST(MemoryMap, FindFilePossibleMmapStarts_MultipleStarts) {
 #endif
 }
 
+bool RangesContain(const std::vector<CheckedRange<uint64_t>>& ranges,
+                   LinuxVMAddress address) {
+  for (const auto& range : ranges) {
+    if (range.ContainsValue(address)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+TEST(MemoryMap, FullMemoryRanges) {
+  const size_t page_size = getpagesize();
+
+  ScopedMmap anonymous_mapping;
+  ASSERT_TRUE(anonymous_mapping.ResetMmap(nullptr,
+                                          page_size * 2,
+                                          PROT_READ | PROT_WRITE,
+                                          MAP_PRIVATE | MAP_ANON,
+                                          -1,
+                                          0));
+
+  ScopedMmap reserved_mapping;
+  ASSERT_TRUE(reserved_mapping.ResetMmap(
+      nullptr, page_size, PROT_NONE, MAP_PRIVATE | MAP_ANON, -1, 0));
+
+  ScopedTempDir temp_dir;
+  base::FilePath path =
+      temp_dir.path().Append(FILE_PATH_LITERAL("FullMemoryRangesTestFile"));
+  ScopedFileHandle handle;
+  ASSERT_NO_FATAL_FAILURE(InitializeFile(path, page_size, &handle));
+
+  ScopedMmap file_mapping;
+  ASSERT_TRUE(file_mapping.ResetMmap(
+      nullptr, page_size, PROT_READ, MAP_PRIVATE, handle.get(), 0));
+
+  FakePtraceConnection connection;
+  ASSERT_TRUE(connection.Initialize(getpid()));
+
+  MemoryMap map;
+  ASSERT_TRUE(map.Initialize(&connection));
+
+  std::vector<CheckedRange<uint64_t>> ranges = map.GetFullMemoryRanges(0);
+  ASSERT_FALSE(ranges.empty());
+  EXPECT_TRUE(
+      RangesContain(ranges, anonymous_mapping.addr_as<LinuxVMAddress>()));
+  EXPECT_TRUE(RangesContain(ranges, FromPointerCast<LinuxVMAddress>(&map)));
+  EXPECT_FALSE(
+      RangesContain(ranges, reserved_mapping.addr_as<LinuxVMAddress>()));
+  EXPECT_FALSE(RangesContain(ranges, file_mapping.addr_as<LinuxVMAddress>()));
+  for (size_t index = 1; index < ranges.size(); ++index) {
+    EXPECT_GT(ranges[index].base(), ranges[index - 1].end());
+  }
+
+  // Mappings larger than the limit are left out.
+  ranges = map.GetFullMemoryRanges(page_size);
+  EXPECT_FALSE(
+      RangesContain(ranges, anonymous_mapping.addr_as<LinuxVMAddress>()));
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace crashpad
@@ -14,13 +14,9 @@
 
 #include "util/linux/proc_stat_reader.h"
 
-#include <stdio.h>
 #include <time.h>
 #include <unistd.h>
 
-#include <iterator>
-
-#include "base/files/file_path.h"
 #include "base/logging.h"
 #include "util/file/file_io.h"
 #include "util/misc/lexing.h"
@@ -48,9 +44,7 @@ ProcStatReader::~ProcStatReader() {}
 bool ProcStatReader::Initialize(PtraceConnection* connection, pid_t tid) {
   INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
 
-  char path[32];
-  snprintf(path, std::size(path), "/proc/%d/stat", tid);
-  if (!connection->ReadFileContents(base::FilePath(path), &contents_)) {
+  if (!connection->ReadThreadFileContents(tid, "stat", &contents_)) {
     return false;
   }
 
@@ -26,7 +26,7 @@
 
 namespace crashpad {
 
-//! \brief Reads the /proc/[pid]/stat file for a thread.
+//! \brief Reads the /proc/[pid]/task/[tid]/stat file for a thread.
 class ProcStatReader {
  public:
   ProcStatReader();
@@ -14,12 +14,14 @@
 
 #include "util/linux/proc_task_reader.h"
 
+#include <fcntl.h>
 #include <stdio.h>
 
 #include <iterator>
 
 #include "base/files/file_path.h"
 #include "base/logging.h"
+#include "base/posix/eintr_wrapper.h"
 #include "base/strings/string_number_conversions.h"
 #include "util/file/directory_reader.h"
 #include "util/misc/as_underlying_type.h"
@@ -57,4 +59,51 @@ bool ReadThreadIDs(pid_t pid, std::vector<pid_t>* tids) {
   return true;
 }
 
+ProcTaskFileReader::ProcTaskFileReader() : task_dir_(), initialized_() {}
+
+ProcTaskFileReader::~ProcTaskFileReader() = default;
+
+bool ProcTaskFileReader::Initialize(pid_t pid) {
+  INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
+
+  char path[32];
+  snprintf(path, std::size(path), "/proc/%d/task", pid);
+  task_dir_.reset(
+      HANDLE_EINTR(open(path, O_RDONLY | O_DIRECTORY | O_CLOEXEC)));
+  if (!task_dir_.is_valid()) {
+    PLOG(ERROR) << "open " << path;
+    return false;
+  }
+
+  INITIALIZATION_STATE_SET_VALID(initialized_);
+  return true;
+}
+
+bool ProcTaskFileReader::ReadFile(pid_t tid,
+                                  const char* name,
+                                  std::string* contents) const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+
+  char path[64];
+  snprintf(path, std::size(path), "%d/%s", tid, name);
+  ScopedFileHandle file(HANDLE_EINTR(
+      openat(task_dir_.get(), path, O_RDONLY | O_NOCTTY | O_CLOEXEC)));
+  if (!file.is_valid()) {
+    PLOG(ERROR) << "openat " << path;
+    return false;
+  }
+
+  contents->clear();
+  char buffer[4096];
+  FileOperationResult rv;
+  while ((rv = crashpad::ReadFile(file.get(), buffer, sizeof(buffer))) > 0) {
+    contents->append(buffer, rv);
+  }
+  if (rv < 0) {
+    PLOG(ERROR) << "read " << path;
+    return false;
+  }
+  return true;
+}
+
 }  // namespace crashpad
@@ -17,8 +17,12 @@
 
 #include <sys/types.h>
 
+#include <string>
 #include <vector>
 
+#include "util/file/file_io.h"
+#include "util/misc/initialization_state_dcheck.h"
+
 namespace crashpad {
 
 //! \brief Enumerates the thread IDs of a process by reading
@@ -30,6 +34,44 @@ namespace crashpad {
 //!     are logged, but won't cause this function to return `false`.
 bool ReadThreadIDs(pid_t pid, std::vector<pid_t>* tids);
 
+//! \brief Reads files in the <code>/proc/<i>pid</i>/task/<i>tid</i></code>
+//!     directories of a process’ threads.
+//!
+//! The <code>/proc/<i>pid</i>/task</code> directory is opened once, and each
+//! file is opened relative to it with `openat()`, so that reading the same
+//! files for many threads doesn’t resolve the whole path for each of them.
+//!
+//! ReadFile() may be called on several threads at once.
+class ProcTaskFileReader {
+ public:
+  ProcTaskFileReader();
+
+  ProcTaskFileReader(const ProcTaskFileReader&) = delete;
+  ProcTaskFileReader& operator=(const ProcTaskFileReader&) = delete;
+
+  ~ProcTaskFileReader();
+
+  //! \brief Opens the task directory of a process.
+  //!
+  //! \param[in] pid The process ID of the process.
+  //! \return `true` on success. `false` on failure with a message logged.
+  bool Initialize(pid_t pid);
+
+  //! \brief Reads the entire contents of a file in a thread’s directory.
+  //!
+  //! \param[in] tid The thread ID of the thread.
+  //! \param[in] name The name of the file, such as `"comm"` or `"stat"`.
+  //! \param[out] contents The file contents, valid if this method returns
+  //!     `true`. Its storage is reused, so a caller reading many files can
+  //!     avoid allocating for each of them by passing the same string.
+  //! \return `true` on success. `false` on failure with a message logged.
+  bool ReadFile(pid_t tid, const char* name, std::string* contents) const;
+
+ private:
+  ScopedFileHandle task_dir_;
+  InitializationStateDcheck initialized_;
+};
+
 }  // namespace crashpad
 
 #endif  // CRASHPAD_UTIL_LINUX_PROC_TASK_READER_H_
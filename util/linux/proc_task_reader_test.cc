@@ -14,10 +14,16 @@
 
 #include "util/linux/proc_task_reader.h"
 
+#include <string.h>
+
+#include <string>
+
+#include "base/files/file_path.h"
 #include "base/strings/stringprintf.h"
 #include "gtest/gtest.h"
 #include "test/multiprocess_exec.h"
 #include "third_party/lss/lss.h"
+#include "util/file/file_io.h"
 #include "util/synchronization/semaphore.h"
 #include "util/thread/thread.h"
 
@@ -90,6 +96,41 @@ TEST(ProcTaskReader, BadPID) {
   EXPECT_FALSE(ReadThreadIDs(0, &tids));
 }
 
+TEST(ProcTaskFileReader, Self) {
+  ProcTaskFileReader reader;
+  ASSERT_TRUE(reader.Initialize(getpid()));
+
+  ScopedBlockingThread thread;
+  thread.Start();
+  const pid_t tid = thread.ThreadID();
+
+  for (pid_t read_tid : {getpid(), tid}) {
+    SCOPED_TRACE(base::StringPrintf("tid %d", read_tid));
+    for (const char* name : {"comm", "stat"}) {
+      SCOPED_TRACE(name);
+      std::string contents;
+      ASSERT_TRUE(reader.ReadFile(read_tid, name, &contents));
+
+      std::string expected;
+      ASSERT_TRUE(LoggingReadEntireFile(
+          base::FilePath(base::StringPrintf(
+              "/proc/%d/task/%d/%s", getpid(), read_tid, name)),
+          &expected));
+      if (strcmp(name, "comm") == 0) {
+        EXPECT_EQ(contents, expected);
+      } else {
+        // Times in the stat file may have changed between the two reads, but
+        // the thread ID that it starts with won’t have.
+        EXPECT_EQ(contents.substr(0, contents.find(' ')),
+                  expected.substr(0, expected.find(' ')));
+      }
+    }
+  }
+
+  std::string contents;
+  EXPECT_FALSE(reader.ReadFile(getpid(), "nonexistent", &contents));
+}
+
 CRASHPAD_CHILD_TEST_MAIN(ProcTaskTestChild) {
   FileHandle in = StdioFileHandle(StdioStream::kStandardInput);
   FileHandle out = StdioFileHandle(StdioStream::kStandardOutput);
@@ -28,6 +28,7 @@
 #include "base/posix/eintr_wrapper.h"
 #include "third_party/lss/lss.h"
 #include "util/linux/scoped_ptrace_attach.h"
+#include "util/linux/socket.h"
 #include "util/misc/memory_sanitizer.h"
 #include "util/posix/scoped_mmap.h"
 
@@ -220,6 +221,26 @@ int PtraceBroker::RunImpl(AttachmentsArray* attachments) {
         continue;
       }
 
+      case Request::kTypeOpenFile: {
+        ScopedFileHandle handle;
+        int result = ReceiveAndOpenFilePath(request.path.path_length,
+                                            /* is_directory= */ false,
+                                            &handle);
+        if (result != 0) {
+          return result;
+        }
+
+        if (!handle.is_valid()) {
+          continue;
+        }
+
+        result = SendFileHandle(handle.get());
+        if (result != 0) {
+          return result;
+        }
+        continue;
+      }
+
       case Request::kTypeReadMemory: {
         int result =
             SendMemory(request.tid, request.iov.base, request.iov.size);
@@ -229,6 +250,14 @@ int PtraceBroker::RunImpl(AttachmentsArray* attachments) {
         continue;
       }
 
+      case Request::kTypeReadMemoryV: {
+        int result = ReceiveRangesAndSendMemory(request.tid, request.iovs.count);
+        if (result != 0) {
+          return result;
+        }
+        continue;
+      }
+
       case Request::kTypeListDirectory: {
         ScopedFileHandle handle;
         int result = ReceiveAndOpenFilePath(request.path.path_length,
@@ -298,6 +327,12 @@ int PtraceBroker::SendFileContents(FileHandle handle) {
   return 0;
 }
 
+int PtraceBroker::SendFileHandle(FileHandle handle) {
+  int32_t message = 0;
+  return UnixCredentialSocket::SendMsg(
+      sock_, &message, sizeof(message), &handle, 1);
+}
+
 void PtraceBroker::TryOpeningMemFile() {
   if (tried_opening_mem_file_) {
     return;
@@ -361,6 +396,28 @@ int PtraceBroker::SendMemory(pid_t pid, VMAddress address, VMSize size) {
   return 0;
 }
 
+int PtraceBroker::ReceiveRangesAndSendMemory(pid_t pid, VMSize count) {
+  // The client sends every range before reading any of the responses, so all
+  // of the ranges must be received before responding to avoid both sides
+  // blocking on a full socket.
+  if (count > kMaxReadMemoryRanges) {
+    return EINVAL;
+  }
+
+  MemoryRange ranges[kMaxReadMemoryRanges];
+  if (!ReadFileExactly(sock_, ranges, sizeof(ranges[0]) * count)) {
+    return errno;
+  }
+
+  for (size_t index = 0; index < count; ++index) {
+    int result = SendMemory(pid, ranges[index].base, ranges[index].size);
+    if (result != 0) {
+      return result;
+    }
+  }
+  return 0;
+}
+
 #if defined(MEMORY_SANITIZER)
 // MSan doesn't intercept syscall() and doesn't see that buffer is initialized.
 __attribute__((no_sanitize("memory")))
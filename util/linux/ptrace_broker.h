@@ -85,11 +85,27 @@ class PtraceBroker {
 
       //! \brief Causes the broker to return from Run(), detaching all attached
       //!     threads. Does not respond.
-      kTypeExit
+      kTypeExit,
+
+      //! \brief Reads several regions of memory from the attached process.
+      //!     The request is followed by `iovs.count` MemoryRange structures,
+      //!     no more than kMaxReadMemoryRanges. The data for each region is
+      //!     returned in turn, in the same form as a response to
+      //!     kTypeReadMemory. An error reading one region does not prevent the
+      //!     following regions from being read.
+      kTypeReadMemoryV,
+
+      //! \brief Opens a file for reading and passes its file descriptor back,
+      //!     so that its contents don’t need to be copied through the socket.
+      //!     The first message is an OpenResult, as for kTypeReadFile. If the
+      //!     OpenResult is kOpenResultSuccess, it is followed by a message
+      //!     containing an int32_t with the value `0`, carrying the file
+      //!     descriptor with `SCM_RIGHTS`.
+      kTypeOpenFile
     } type;
 
     //! \brief The thread ID associated with this request. Valid for kTypeAttach,
-    //!     kTypeGetThreadInfo, and kTypeReadMemory.
+    //!     kTypeGetThreadInfo, kTypeReadMemory, and kTypeReadMemoryV.
     pid_t tid;
 
     union {
@@ -103,7 +119,15 @@ class PtraceBroker {
         VMSize size;
       } iov;
 
-      //! \brief Specifies the file path to read for a kTypeReadFile request.
+      //! \brief Specifies the number of memory regions to read for a
+      //!     kTypeReadMemoryV request.
+      struct {
+        //! \brief The number of MemoryRange structures following the request.
+        VMSize count;
+      } iovs;
+
+      //! \brief Specifies the file path to read for a kTypeReadFile,
+      //!     kTypeOpenFile, or kTypeListDirectory request.
       struct {
         //! \brief The number of bytes in #path. The path should not include a
         //!     `NUL`-terminator.
@@ -115,6 +139,20 @@ class PtraceBroker {
     };
   };
 
+  //! \brief The maximum number of memory regions in a kTypeReadMemoryV
+  //!     request.
+  static constexpr size_t kMaxReadMemoryRanges = 64;
+
+  //! \brief A memory region to read, sent following a Request with type
+  //!     kTypeReadMemoryV.
+  struct MemoryRange {
+    //! \brief The base address of the memory region.
+    VMAddress base;
+
+    //! \brief The size of the memory region.
+    VMSize size;
+  };
+
   //! \brief A result used in operations that accept paths.
   //!
   //! Positive values of this enum are reserved for sending errno values.
@@ -198,9 +236,11 @@ class PtraceBroker {
   int SendReadError(ReadError err);
   int SendOpenResult(OpenResult result);
   int SendFileContents(FileHandle handle);
+  int SendFileHandle(FileHandle handle);
   int SendDirectory(FileHandle handle);
   void TryOpeningMemFile();
   int SendMemory(pid_t pid, VMAddress address, VMSize size);
+  int ReceiveRangesAndSendMemory(pid_t pid, VMSize count);
   int ReceiveAndOpenFilePath(VMSize path_length,
                              bool is_directory,
                              ScopedFileHandle* handle);
@@ -14,12 +14,15 @@
 
 #include "util/linux/ptrace_broker.h"
 
+#include <string.h>
 #include <sys/socket.h>
 #include <sys/syscall.h>
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <iterator>
 #include <utility>
+#include <vector>
 
 #include "build/build_config.h"
 #include "gtest/gtest.h"
@@ -205,6 +208,33 @@ class SameBitnessTest : public Multiprocess {
                               &unmapped),
               -1);
 
+    std::vector<char> batch_buffers(4 * 3);
+    ProcessMemory::BatchRead reads[4] = {
+        {mapping_.addr_as<VMAddress>(), 3, &batch_buffers[0], false},
+        {mapping_.addr_as<VMAddress>() + mapping_.len(),
+         3,
+         &batch_buffers[3],
+         false},
+        {mapping_.addr_as<VMAddress>() + mapping_.len() - 3,
+         3,
+         &batch_buffers[6],
+         false},
+        {mapping_.addr_as<VMAddress>() + mapping_.len() - 1,
+         3,
+         &batch_buffers[9],
+         false},
+    };
+    client.ReadUpToV(reads, std::size(reads));
+    EXPECT_TRUE(reads[0].succeeded);
+    EXPECT_EQ(memcmp(&batch_buffers[0], expected_buffer, 3), 0);
+    EXPECT_FALSE(reads[1].succeeded);
+    EXPECT_TRUE(reads[2].succeeded);
+    EXPECT_EQ(memcmp(&batch_buffers[6],
+                     expected_buffer + mapping_.len() - 3,
+                     3),
+              0);
+    EXPECT_FALSE(reads[3].succeeded);
+
     std::string file_root = file_dir.value() + '/';
     broker.SetFileRoot(file_root.c_str());
 
@@ -17,11 +17,15 @@
 #include <errno.h>
 #include <stdio.h>
 #include <string.h>
+#include <sys/socket.h>
 
+#include <algorithm>
 #include <iterator>
 #include <string>
+#include <utility>
 
 #include "base/logging.h"
+#include "base/posix/eintr_wrapper.h"
 #include "base/strings/string_number_conversions.h"
 #include "util/file/file_io.h"
 #include "util/linux/ptrace_broker.h"
@@ -41,6 +45,57 @@ bool ReceiveAndLogError(int sock, const std::string& operation) {
   return true;
 }
 
+// Receives the message carrying a file descriptor sent in response to a
+// kTypeOpenFile request.
+bool ReceiveFileHandle(int sock, ScopedFileHandle* handle) {
+  int32_t message;
+  iovec iov;
+  iov.iov_base = &message;
+  iov.iov_len = sizeof(message);
+
+  msghdr msg = {};
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+
+  // Credentials are received along with the file descriptor if the socket has
+  // SO_PASSCRED set.
+  char cmsg_buf[CMSG_SPACE(sizeof(int)) + CMSG_SPACE(sizeof(ucred))];
+  msg.msg_control = cmsg_buf;
+  msg.msg_controllen = sizeof(cmsg_buf);
+
+  ssize_t rv = HANDLE_EINTR(recvmsg(sock, &msg, MSG_CMSG_CLOEXEC));
+  if (rv < 0) {
+    PLOG(ERROR) << "recvmsg";
+    return false;
+  }
+
+  ScopedFileHandle local_handle;
+  size_t handle_count = 0;
+  for (cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg;
+       cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+    if (cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS) {
+      continue;
+    }
+    const unsigned char* data = CMSG_DATA(cmsg);
+    size_t fd_count = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+    for (size_t index = 0; index < fd_count; ++index) {
+      int fd;
+      memcpy(&fd, data + index * sizeof(int), sizeof(fd));
+      local_handle.reset(fd);
+      ++handle_count;
+    }
+  }
+
+  if (rv != sizeof(message) || message != 0 ||
+      (msg.msg_flags & (MSG_TRUNC | MSG_CTRUNC)) || handle_count != 1) {
+    LOG(ERROR) << "unexpected file handle message";
+    return false;
+  }
+
+  *handle = std::move(local_handle);
+  return true;
+}
+
 bool ReceiveAndLogReadError(int sock, const std::string& operation) {
   PtraceBroker::ReadError err;
   if (!LoggingReadFileExactly(sock, &err, sizeof(err))) {
@@ -213,8 +268,10 @@ bool PtraceClient::ReadFileContents(const base::FilePath& path,
                                     std::string* contents) {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
 
+  // The broker opens the file and passes back its file descriptor, so that
+  // large files such as maps don’t need to be copied through the socket.
   PtraceBroker::Request request = {};
-  request.type = PtraceBroker::Request::kTypeReadFile;
+  request.type = PtraceBroker::Request::kTypeOpenFile;
   request.path.path_length = path.value().size();
 
   if (!LoggingWriteFile(sock_, &request, sizeof(request)) ||
@@ -222,30 +279,11 @@ bool PtraceClient::ReadFileContents(const base::FilePath& path,
     return false;
   }
 
-  std::string local_contents;
-  int32_t read_result;
-  do {
-    if (!LoggingReadFileExactly(sock_, &read_result, sizeof(read_result))) {
-      return false;
-    }
-
-    if (read_result < 0) {
-      ReceiveAndLogReadError(sock_, "ReadFileContents");
-      return false;
-    }
-
-    if (read_result > 0) {
-      size_t old_length = local_contents.size();
-      local_contents.resize(old_length + read_result);
-      if (!LoggingReadFileExactly(
-              sock_, &local_contents[old_length], read_result)) {
-        return false;
-      }
-    }
-  } while (read_result > 0);
-
-  contents->swap(local_contents);
-  return true;
+  ScopedFileHandle handle;
+  if (!ReceiveFileHandle(sock_, &handle)) {
+    return false;
+  }
+  return LoggingReadToEOF(handle.get(), contents);
 }
 
 ProcessMemoryLinux* PtraceClient::Memory() {
@@ -343,6 +381,68 @@ ssize_t PtraceClient::ReadUpTo(VMAddress address, size_t size, void* buffer) {
   return total_read;
 }
 
+void PtraceClient::ReadUpToV(ProcessMemory::BatchRead* reads, size_t count) {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+
+  for (size_t index = 0; index < count; ++index) {
+    reads[index].succeeded = false;
+  }
+
+  while (count > 0) {
+    const size_t batch_count =
+        std::min(count, PtraceBroker::kMaxReadMemoryRanges);
+
+    PtraceBroker::Request request = {};
+    request.type = PtraceBroker::Request::kTypeReadMemoryV;
+    request.tid = pid_;
+    request.iovs.count = batch_count;
+
+    PtraceBroker::MemoryRange ranges[PtraceBroker::kMaxReadMemoryRanges];
+    for (size_t index = 0; index < batch_count; ++index) {
+      ranges[index].base = reads[index].address;
+      ranges[index].size = reads[index].size;
+    }
+
+    if (!LoggingWriteFile(sock_, &request, sizeof(request)) ||
+        !LoggingWriteFile(sock_, ranges, sizeof(ranges[0]) * batch_count)) {
+      return;
+    }
+
+    for (size_t index = 0; index < batch_count; ++index) {
+      char* buffer_c = reinterpret_cast<char*>(reads[index].buffer);
+      size_t size = reads[index].size;
+      while (size > 0) {
+        int32_t bytes_read;
+        if (!LoggingReadFileExactly(sock_, &bytes_read, sizeof(bytes_read))) {
+          return;
+        }
+
+        if (bytes_read < 0) {
+          if (!ReceiveAndLogReadError(sock_, "PtraceBroker ReadMemoryV")) {
+            return;
+          }
+          break;
+        }
+
+        if (bytes_read == 0) {
+          break;
+        }
+
+        if (!LoggingReadFileExactly(sock_, buffer_c, bytes_read)) {
+          return;
+        }
+
+        size -= bytes_read;
+        buffer_c += bytes_read;
+      }
+      reads[index].succeeded = size == 0;
+    }
+
+    reads += batch_count;
+    count -= batch_count;
+  }
+}
+
 bool PtraceClient::SendFilePath(const char* path, size_t length) {
   if (!LoggingWriteFile(sock_, path, length)) {
     return false;
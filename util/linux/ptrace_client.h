@@ -63,6 +63,7 @@ class PtraceClient : public PtraceConnection {
   ProcessMemoryLinux* Memory() override;
   bool Threads(std::vector<pid_t>* threads) override;
   ssize_t ReadUpTo(VMAddress address, size_t size, void* buffer) override;
+  void ReadUpToV(ProcessMemory::BatchRead* reads, size_t count) override;
 
  private:
   bool SendFilePath(const char* path, size_t length);
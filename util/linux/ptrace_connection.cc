@@ -0,0 +1,69 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/linux/ptrace_connection.h"
+
+#include <string.h>
+
+#include "base/strings/stringprintf.h"
+
+namespace crashpad {
+
+bool PtraceConnection::GetThreadInfoWithoutFloatContext(pid_t tid,
+                                                        ThreadInfo* info) {
+  if (!GetThreadInfo(tid, info)) {
+    return false;
+  }
+  memset(&info->float_context, 0, sizeof(info->float_context));
+  return true;
+}
+
+void PtraceConnection::AttachThreads(const std::vector<pid_t>& tids,
+                                     std::vector<bool>* attached) {
+  attached->resize(tids.size());
+  for (size_t index = 0; index < tids.size(); ++index) {
+    (*attached)[index] = Attach(tids[index]);
+  }
+}
+
+bool PtraceConnection::ReadThreadFileContents(pid_t tid,
+                                              const char* name,
+                                              std::string* contents) {
+  return ReadFileContents(
+      base::FilePath(base::StringPrintf(
+          "/proc/%d/task/%d/%s", GetProcessID(), tid, name)),
+      contents);
+}
+
+void PtraceConnection::ReadUpToV(ProcessMemory::BatchRead* reads,
+                                 size_t count) {
+  for (size_t index = 0; index < count; ++index) {
+    ProcessMemory::BatchRead& read = reads[index];
+    char* buffer = static_cast<char*>(read.buffer);
+    VMAddress address = read.address;
+    size_t remaining = read.size;
+    while (remaining > 0) {
+      ssize_t bytes_read = ReadUpTo(address, remaining, buffer);
+      if (bytes_read <= 0) {
+        break;
+      }
+      buffer += bytes_read;
+      address += bytes_read;
+      remaining -= bytes_read;
+    }
+    read.succeeded = remaining == 0;
+  }
+}
+
+}  // namespace crashpad
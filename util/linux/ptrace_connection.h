@@ -41,6 +41,19 @@ class PtraceConnection {
   //! \return `true` on success. `false` on failure with a message logged.
   virtual bool Attach(pid_t tid) = 0;
 
+  //! \brief Adds several new threads to this connection.
+  //!
+  //! The default implementation calls Attach() for each thread in turn, so
+  //! that each thread is stopped only after the previous one has. Connections
+  //! that can do so may override this to ask every thread to stop before
+  //! waiting for any of them, which stops them faster and closer together.
+  //!
+  //! \param[in] tids The thread IDs of the threads to attach.
+  //! \param[out] attached Whether each thread in \a tids was attached. A
+  //!     message is logged for each thread that couldn’t be attached.
+  virtual void AttachThreads(const std::vector<pid_t>& tids,
+                             std::vector<bool>* attached);
+
   //! \brief Returns `true` if connected to a 64-bit process.
   virtual bool Is64Bit() = 0;
 
@@ -51,6 +64,18 @@ class PtraceConnection {
   //! \return `true` on success. `false` on failure with a message logged.
   virtual bool GetThreadInfo(pid_t tid, ThreadInfo* info) = 0;
 
+  //! \brief Retrieves a ThreadInfo for a target thread, except for its
+  //!     floating-point context.
+  //!
+  //! ThreadInfo::float_context is zeroed. The default implementation calls
+  //! GetThreadInfo() and then clears the floating-point context. Connections
+  //! that can do so may override this to skip collecting it.
+  //!
+  //! \param[in] tid The thread ID of the target thread.
+  //! \param[out] info Information about the thread.
+  //! \return `true` on success. `false` on failure with a message logged.
+  virtual bool GetThreadInfoWithoutFloatContext(pid_t tid, ThreadInfo* info);
+
   //! \brief Reads the entire contents of a file.
   //!
   //! \param[in] path The path of the file to read.
@@ -60,6 +85,24 @@ class PtraceConnection {
   virtual bool ReadFileContents(const base::FilePath& path,
                                 std::string* contents) = 0;
 
+  //! \brief Reads the entire contents of a file in the
+  //!     <code>/proc/<i>pid</i>/task/<i>tid</i></code> directory of one of the
+  //!     connected process’ threads.
+  //!
+  //! The default implementation calls ReadFileContents(). Connections that can
+  //! read these files directly may override this to read them relative to a
+  //! single descriptor for the task directory. See ProcTaskFileReader. This
+  //! may be called on several threads at once.
+  //!
+  //! \param[in] tid The thread ID of the thread.
+  //! \param[in] name The name of the file, such as `"comm"` or `"stat"`.
+  //! \param[out] contents The file contents, valid if this method returns
+  //!     `true`.
+  //! \return `true` on success. `false` on failure with a message logged.
+  virtual bool ReadThreadFileContents(pid_t tid,
+                                      const char* name,
+                                      std::string* contents);
+
   //! \brief Returns a memory reader for the connected process.
   //!
   //! The caller does not take ownership of the reader. The reader is valid for
@@ -87,6 +130,19 @@ class PtraceConnection {
   //! \return the number of bytes copied, 0 if there is no more data to read, or
   //!     -1 on failure with a message logged.
   virtual ssize_t ReadUpTo(VMAddress address, size_t size, void* buffer) = 0;
+
+  //! \brief Copies several memory regions from the connected process into
+  //!     caller-provided buffers in the current process.
+  //!
+  //! The default implementation calls ReadUpTo() for each region. Connections
+  //! for which each read is expensive may override this to read the regions
+  //! together.
+  //!
+  //! \param[in,out] reads The regions to read, in the connected process'
+  //!     address space. On return, ProcessMemory::BatchRead::succeeded is set
+  //!     for each region that was read completely, and cleared for the rest.
+  //! \param[in] count The number of elements in \a reads.
+  virtual void ReadUpToV(ProcessMemory::BatchRead* reads, size_t count);
 };
 
 }  // namespace crashpad
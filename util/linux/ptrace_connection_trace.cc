@@ -0,0 +1,632 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/linux/ptrace_connection_trace.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include <algorithm>
+#include <iterator>
+
+#include "base/check_op.h"
+#include "base/logging.h"
+
+namespace crashpad {
+
+namespace {
+
+// "CPTR" in little-endian byte order.
+constexpr uint32_t kTraceMagic = 0x52545043;
+constexpr uint32_t kTraceVersion = 1;
+
+#pragma pack(push, 1)
+struct TraceHeader {
+  uint32_t magic;
+  uint32_t version;
+
+  // sizeof(ThreadInfo) in the recording build, which must match the replaying
+  // build’s for the recorded registers to be understood.
+  uint32_t thread_info_size;
+
+  int32_t pid;
+  uint8_t is_64_bit;
+};
+#pragma pack(pop)
+
+// Each record begins with its type. Results begin with a uint8_t that is 1 for
+// success, followed by what was returned only if the request succeeded.
+// Strings and memory are a uint64_t size followed by the data.
+enum RecordType : uint8_t {
+  // int32_t tid, result.
+  kRecordAttach = 1,
+
+  // result, uint64_t count, int32_t tids[count]. The thread IDs are recorded
+  // even on failure, as PtraceConnection::Threads() may return some.
+  kRecordThreads,
+
+  // int32_t tid, result, ThreadInfo.
+  kRecordThreadInfo,
+
+  // int32_t tid, result, ThreadInfo.
+  kRecordThreadInfoWithoutFloatContext,
+
+  // string path, result, string contents.
+  kRecordFile,
+
+  // int32_t tid, string name, result, string contents.
+  kRecordThreadFile,
+
+  // uint64_t address, memory.
+  kRecordMemory,
+};
+
+template <typename T>
+void Append(std::string* record, const T& value) {
+  record->append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void AppendString(std::string* record, const void* data, size_t size) {
+  Append(record, uint64_t{size});
+  record->append(static_cast<const char*>(data), size);
+}
+
+void AppendString(std::string* record, const std::string& string) {
+  AppendString(record, string.data(), string.size());
+}
+
+// Reads values from a trace held in memory.
+class TraceParser {
+ public:
+  explicit TraceParser(const std::string& trace) : trace_(trace), offset_(0) {}
+
+  TraceParser(const TraceParser&) = delete;
+  TraceParser& operator=(const TraceParser&) = delete;
+
+  ~TraceParser() {}
+
+  template <typename T>
+  bool Read(T* value) {
+    if (trace_.size() - offset_ < sizeof(*value)) {
+      return false;
+    }
+    memcpy(static_cast<void*>(value), trace_.data() + offset_, sizeof(*value));
+    offset_ += sizeof(*value);
+    return true;
+  }
+
+  bool ReadString(std::string* string) {
+    uint64_t size;
+    if (!Read(&size) || trace_.size() - offset_ < size) {
+      return false;
+    }
+    string->assign(trace_, offset_, size);
+    offset_ += size;
+    return true;
+  }
+
+  bool AtEnd() const { return offset_ == trace_.size(); }
+
+ private:
+  const std::string& trace_;
+  size_t offset_;
+};
+
+}  // namespace
+
+RecordingPtraceConnection::RecordingPtraceConnection()
+    : PtraceConnection(),
+      recorded_memory_(),
+      memory_(),
+      lock_(),
+      connection_(nullptr),
+      trace_(nullptr),
+      recording_(false),
+      initialized_() {}
+
+RecordingPtraceConnection::~RecordingPtraceConnection() {}
+
+bool RecordingPtraceConnection::Initialize(PtraceConnection* connection,
+                                           FileWriterInterface* trace) {
+  INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
+  connection_ = connection;
+  trace_ = trace;
+
+  TraceHeader header = {};
+  header.magic = kTraceMagic;
+  header.version = kTraceVersion;
+  header.thread_info_size = sizeof(ThreadInfo);
+  header.pid = connection_->GetProcessID();
+  header.is_64_bit = connection_->Is64Bit();
+  if (!trace_->Write(&header, sizeof(header))) {
+    return false;
+  }
+  recording_ = true;
+
+  INITIALIZATION_STATE_SET_VALID(initialized_);
+  return true;
+}
+
+pid_t RecordingPtraceConnection::GetProcessID() {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  return connection_->GetProcessID();
+}
+
+bool RecordingPtraceConnection::Attach(pid_t tid) {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  const bool attached = connection_->Attach(tid);
+  std::string record;
+  Append(&record, kRecordAttach);
+  Append(&record, int32_t{tid});
+  Append(&record, uint8_t{attached});
+  WriteRecord(record);
+  return attached;
+}
+
+void RecordingPtraceConnection::AttachThreads(const std::vector<pid_t>& tids,
+                                              std::vector<bool>* attached) {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  connection_->AttachThreads(tids, attached);
+  std::string record;
+  for (size_t index = 0; index < tids.size(); ++index) {
+    Append(&record, kRecordAttach);
+    Append(&record, int32_t{tids[index]});
+    Append(&record, uint8_t{(*attached)[index]});
+  }
+  WriteRecord(record);
+}
+
+bool RecordingPtraceConnection::Is64Bit() {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  return connection_->Is64Bit();
+}
+
+bool RecordingPtraceConnection::GetThreadInfo(pid_t tid, ThreadInfo* info) {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  const bool success = connection_->GetThreadInfo(tid, info);
+  std::string record;
+  Append(&record, kRecordThreadInfo);
+  Append(&record, int32_t{tid});
+  Append(&record, uint8_t{success});
+  if (success) {
+    Append(&record, *info);
+  }
+  WriteRecord(record);
+  return success;
+}
+
+bool RecordingPtraceConnection::GetThreadInfoWithoutFloatContext(
+    pid_t tid,
+    ThreadInfo* info) {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  const bool success = connection_->GetThreadInfoWithoutFloatContext(tid, info);
+  std::string record;
+  Append(&record, kRecordThreadInfoWithoutFloatContext);
+  Append(&record, int32_t{tid});
+  Append(&record, uint8_t{success});
+  if (success) {
+    Append(&record, *info);
+  }
+  WriteRecord(record);
+  return success;
+}
+
+bool RecordingPtraceConnection::ReadFileContents(const base::FilePath& path,
+                                                 std::string* contents) {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  const bool success = connection_->ReadFileContents(path, contents);
+  std::string record;
+  Append(&record, kRecordFile);
+  AppendString(&record, path.value());
+  Append(&record, uint8_t{success});
+  if (success) {
+    AppendString(&record, *contents);
+  }
+  WriteRecord(record);
+  return success;
+}
+
+bool RecordingPtraceConnection::ReadThreadFileContents(pid_t tid,
+                                                       const char* name,
+                                                       std::string* contents) {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  const bool success =
+      connection_->ReadThreadFileContents(tid, name, contents);
+  std::string record;
+  Append(&record, kRecordThreadFile);
+  Append(&record, int32_t{tid});
+  AppendString(&record, name, strlen(name));
+  Append(&record, uint8_t{success});
+  if (success) {
+    AppendString(&record, *contents);
+  }
+  WriteRecord(record);
+  return success;
+}
+
+ProcessMemoryLinux* RecordingPtraceConnection::Memory() {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  if (!memory_) {
+    memory_ = std::make_unique<ProcessMemoryLinux>(this, true);
+  }
+  return memory_.get();
+}
+
+bool RecordingPtraceConnection::Threads(std::vector<pid_t>* threads) {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  const bool success = connection_->Threads(threads);
+  std::string record;
+  Append(&record, kRecordThreads);
+  Append(&record, uint8_t{success});
+  Append(&record, uint64_t{threads->size()});
+  for (pid_t tid : *threads) {
+    Append(&record, int32_t{tid});
+  }
+  WriteRecord(record);
+  return success;
+}
+
+ssize_t RecordingPtraceConnection::ReadUpTo(VMAddress address,
+                                            size_t size,
+                                            void* buffer) {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  const ssize_t bytes_read = connection_->ReadUpTo(address, size, buffer);
+  if (bytes_read > 0) {
+    RecordMemory(address, buffer, bytes_read);
+  }
+  return bytes_read;
+}
+
+void RecordingPtraceConnection::ReadUpToV(ProcessMemory::BatchRead* reads,
+                                          size_t count) {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  connection_->ReadUpToV(reads, count);
+  for (size_t index = 0; index < count; ++index) {
+    const ProcessMemory::BatchRead& read = reads[index];
+    if (read.succeeded && read.size > 0) {
+      RecordMemory(read.address, read.buffer, read.size);
+    }
+  }
+}
+
+void RecordingPtraceConnection::RecordMemory(VMAddress address,
+                                             const void* data,
+                                             size_t size) {
+  VMAddress start = address;
+  VMAddress end = address + size;
+  {
+    base::AutoLock lock(lock_);
+
+    // Find the first range that overlaps or adjoins [start, end).
+    auto it = recorded_memory_.upper_bound(start);
+    if (it != recorded_memory_.begin() && std::prev(it)->second >= start) {
+      --it;
+    }
+    if (it != recorded_memory_.end() && it->first <= start &&
+        it->second >= end) {
+      return;
+    }
+
+    while (it != recorded_memory_.end() && it->first <= end) {
+      start = std::min(start, it->first);
+      end = std::max(end, it->second);
+      it = recorded_memory_.erase(it);
+    }
+    recorded_memory_[start] = end;
+  }
+
+  std::string record;
+  Append(&record, kRecordMemory);
+  Append(&record, uint64_t{address});
+  AppendString(&record, data, size);
+  WriteRecord(record);
+}
+
+void RecordingPtraceConnection::WriteRecord(const std::string& record) {
+  base::AutoLock lock(lock_);
+  if (recording_ && !trace_->Write(record.data(), record.size())) {
+    LOG(ERROR) << "trace write failed, recording stopped";
+    recording_ = false;
+  }
+}
+
+ReplayPtraceConnection::ReplayPtraceConnection()
+    : PtraceConnection(),
+      memory_ranges_(),
+      attached_(),
+      thread_info_(),
+      files_(),
+      thread_files_(),
+      threads_(false, std::vector<pid_t>()),
+      memory_(),
+      pid_(-1),
+      is_64_bit_(false),
+      initialized_() {}
+
+ReplayPtraceConnection::~ReplayPtraceConnection() {}
+
+bool ReplayPtraceConnection::Initialize(FileReaderInterface* trace) {
+  INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
+
+  std::string contents;
+  char buffer[4096];
+  FileOperationResult bytes_read;
+  while ((bytes_read = trace->Read(buffer, sizeof(buffer))) > 0) {
+    contents.append(buffer, bytes_read);
+  }
+  if (bytes_read < 0) {
+    return false;
+  }
+
+  TraceParser parser(contents);
+  TraceHeader header;
+  if (!parser.Read(&header) || header.magic != kTraceMagic ||
+      header.version != kTraceVersion) {
+    LOG(ERROR) << "not a trace";
+    return false;
+  }
+  if (header.thread_info_size != sizeof(ThreadInfo)) {
+    LOG(ERROR) << "trace recorded for another architecture";
+    return false;
+  }
+  pid_ = header.pid;
+  is_64_bit_ = header.is_64_bit != 0;
+
+  // Where a request was recorded more than once, the first result is kept.
+  bool have_threads = false;
+  while (!parser.AtEnd()) {
+    RecordType type;
+    int32_t tid;
+    uint8_t success;
+    bool parsed;
+    parser.Read(&type);
+    switch (type) {
+      case kRecordAttach: {
+        parsed = parser.Read(&tid) && parser.Read(&success);
+        if (parsed) {
+          attached_.emplace(tid, success != 0);
+        }
+        break;
+      }
+      case kRecordThreads: {
+        uint64_t count;
+        parsed = parser.Read(&success) && parser.Read(&count);
+        std::vector<pid_t> threads;
+        for (uint64_t index = 0; parsed && index < count; ++index) {
+          parsed = parser.Read(&tid);
+          threads.push_back(tid);
+        }
+        if (parsed && !have_threads) {
+          threads_ = Recorded<std::vector<pid_t>>(success != 0, threads);
+          have_threads = true;
+        }
+        break;
+      }
+      case kRecordThreadInfo:
+      case kRecordThreadInfoWithoutFloatContext: {
+        Recorded<ThreadInfo> info;
+        parsed = parser.Read(&tid) && parser.Read(&success);
+        info.first = success != 0;
+        if (parsed && info.first) {
+          parsed = parser.Read(&info.second);
+        }
+        if (parsed) {
+          thread_info_.emplace(
+              std::make_pair(pid_t{tid}, type == kRecordThreadInfo), info);
+        }
+        break;
+      }
+      case kRecordFile: {
+        std::string path;
+        Recorded<std::string> file;
+        parsed = parser.ReadString(&path) && parser.Read(&success);
+        file.first = success != 0;
+        if (parsed && file.first) {
+          parsed = parser.ReadString(&file.second);
+        }
+        if (parsed) {
+          files_.emplace(path, file);
+        }
+        break;
+      }
+      case kRecordThreadFile: {
+        std::string name;
+        Recorded<std::string> file;
+        parsed = parser.Read(&tid) && parser.ReadString(&name) &&
+                 parser.Read(&success);
+        file.first = success != 0;
+        if (parsed && file.first) {
+          parsed = parser.ReadString(&file.second);
+        }
+        if (parsed) {
+          thread_files_.emplace(std::make_pair(pid_t{tid}, name), file);
+        }
+        break;
+      }
+      case kRecordMemory: {
+        uint64_t address;
+        std::string data;
+        parsed = parser.Read(&address) && parser.ReadString(&data);
+        if (parsed && !data.empty()) {
+          AddMemory(address, std::move(data));
+        }
+        break;
+      }
+      default:
+        LOG(ERROR) << "unknown trace record type";
+        return false;
+    }
+    if (!parsed) {
+      LOG(ERROR) << "trace truncated";
+      return false;
+    }
+  }
+
+  INITIALIZATION_STATE_SET_VALID(initialized_);
+  return true;
+}
+
+pid_t ReplayPtraceConnection::GetProcessID() {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  return pid_;
+}
+
+bool ReplayPtraceConnection::Attach(pid_t tid) {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  auto it = attached_.find(tid);
+  if (it == attached_.end()) {
+    LOG(ERROR) << "attach to thread " << tid << " not recorded";
+    return false;
+  }
+  if (!it->second) {
+    LOG(ERROR) << "attach to thread " << tid << " failed";
+  }
+  return it->second;
+}
+
+bool ReplayPtraceConnection::Is64Bit() {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  return is_64_bit_;
+}
+
+bool ReplayPtraceConnection::GetThreadInfo(pid_t tid, ThreadInfo* info) {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  auto it = thread_info_.find(std::make_pair(tid, true));
+  if (it == thread_info_.end()) {
+    LOG(ERROR) << "thread " << tid << " info not recorded";
+    return false;
+  }
+  if (!it->second.first) {
+    LOG(ERROR) << "thread " << tid << " info failed";
+    return false;
+  }
+  *info = it->second.second;
+  return true;
+}
+
+bool ReplayPtraceConnection::GetThreadInfoWithoutFloatContext(
+    pid_t tid,
+    ThreadInfo* info) {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  auto it = thread_info_.find(std::make_pair(tid, false));
+  if (it == thread_info_.end()) {
+    return PtraceConnection::GetThreadInfoWithoutFloatContext(tid, info);
+  }
+  if (!it->second.first) {
+    LOG(ERROR) << "thread " << tid << " info failed";
+    return false;
+  }
+  *info = it->second.second;
+  return true;
+}
+
+bool ReplayPtraceConnection::ReadFileContents(const base::FilePath& path,
+                                              std::string* contents) {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  auto it = files_.find(path.value());
+  if (it == files_.end()) {
+    LOG(ERROR) << path.value() << " not recorded";
+    return false;
+  }
+  if (!it->second.first) {
+    LOG(ERROR) << path.value() << " read failed";
+    return false;
+  }
+  *contents = it->second.second;
+  return true;
+}
+
+bool ReplayPtraceConnection::ReadThreadFileContents(pid_t tid,
+                                                    const char* name,
+                                                    std::string* contents) {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  auto it = thread_files_.find(std::make_pair(tid, std::string(name)));
+  if (it == thread_files_.end()) {
+    return PtraceConnection::ReadThreadFileContents(tid, name, contents);
+  }
+  if (!it->second.first) {
+    LOG(ERROR) << "thread " << tid << " " << name << " read failed";
+    return false;
+  }
+  *contents = it->second.second;
+  return true;
+}
+
+ProcessMemoryLinux* ReplayPtraceConnection::Memory() {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  if (!memory_) {
+    memory_ = std::make_unique<ProcessMemoryLinux>(this, true);
+  }
+  return memory_.get();
+}
+
+bool ReplayPtraceConnection::Threads(std::vector<pid_t>* threads) {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  *threads = threads_.second;
+  if (!threads_.first) {
+    LOG(ERROR) << "threads failed or not recorded";
+  }
+  return threads_.first;
+}
+
+ssize_t ReplayPtraceConnection::ReadUpTo(VMAddress address,
+                                         size_t size,
+                                         void* buffer) {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  auto it = memory_ranges_.upper_bound(address);
+  if (it == memory_ranges_.begin() ||
+      address - std::prev(it)->first >= std::prev(it)->second.size()) {
+    LOG(ERROR) << "memory at 0x" << std::hex << address << std::dec
+               << " not recorded";
+    return -1;
+  }
+  --it;
+  const size_t offset = address - it->first;
+  const size_t bytes_read = std::min(size, it->second.size() - offset);
+  memcpy(buffer, it->second.data() + offset, bytes_read);
+  return bytes_read;
+}
+
+void ReplayPtraceConnection::AddMemory(VMAddress address, std::string data) {
+  VMAddress start = address;
+  VMAddress end = address + data.size();
+
+  // Find the first range that overlaps or adjoins [start, end).
+  auto first = memory_ranges_.upper_bound(start);
+  if (first != memory_ranges_.begin() &&
+      std::prev(first)->first + std::prev(first)->second.size() >= start) {
+    --first;
+  }
+  auto last = first;
+  while (last != memory_ranges_.end() && last->first <= end) {
+    start = std::min(start, last->first);
+    end = std::max(end, last->first + last->second.size());
+    ++last;
+  }
+  if (first == last) {
+    memory_ranges_.emplace(address, std::move(data));
+    return;
+  }
+
+  // Where ranges overlap, the data already recorded is kept.
+  std::string merged(end - start, '\0');
+  memcpy(&merged[address - start], data.data(), data.size());
+  for (auto it = first; it != last; ++it) {
+    memcpy(&merged[it->first - start], it->second.data(), it->second.size());
+  }
+  memory_ranges_.erase(first, last);
+  memory_ranges_.emplace(start, std::move(merged));
+}
+
+}  // namespace crashpad
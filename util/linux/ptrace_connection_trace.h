@@ -0,0 +1,166 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_UTIL_LINUX_PTRACE_CONNECTION_TRACE_H_
+#define CRASHPAD_UTIL_LINUX_PTRACE_CONNECTION_TRACE_H_
+
+#include <sys/types.h>
+
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/files/file_path.h"
+#include "base/synchronization/lock.h"
+#include "util/file/file_reader.h"
+#include "util/file/file_writer.h"
+#include "util/linux/ptrace_connection.h"
+#include "util/misc/initialization_state_dcheck.h"
+#include "util/process/process_memory_linux.h"
+
+namespace crashpad {
+
+//! \brief A PtraceConnection that passes requests to another connection and
+//!     records what each returned in a trace.
+//!
+//! The trace holds the threads, registers, files, and memory that were read,
+//! so that the same capture can be repeated without the process by a
+//! ReplayPtraceConnection. Memory that is read more than once is recorded once.
+//! A trace can only be replayed by a build for the same architecture.
+//!
+//! Memory is always read through the other connection’s
+//! PtraceConnection::ReadUpTo() and PtraceConnection::ReadUpToV(), which may be
+//! slower than reading it directly, so recording is meant for capturing traces
+//! rather than for handling crashes.
+class RecordingPtraceConnection : public PtraceConnection {
+ public:
+  RecordingPtraceConnection();
+
+  RecordingPtraceConnection(const RecordingPtraceConnection&) = delete;
+  RecordingPtraceConnection& operator=(const RecordingPtraceConnection&) =
+      delete;
+
+  ~RecordingPtraceConnection();
+
+  //! \brief Initializes this connection.
+  //!
+  //! If the trace can’t be written to later, a message is logged and recording
+  //! stops, but requests continue to be passed to \a connection.
+  //!
+  //! \param[in] connection The connection to pass requests to. It must outlive
+  //!     this object.
+  //! \param[in] trace The writer to record the trace to. It must outlive this
+  //!     object.
+  //! \return `true` on success. `false` on failure with a message logged.
+  bool Initialize(PtraceConnection* connection, FileWriterInterface* trace);
+
+  // PtraceConnection:
+
+  pid_t GetProcessID() override;
+  bool Attach(pid_t tid) override;
+  void AttachThreads(const std::vector<pid_t>& tids,
+                     std::vector<bool>* attached) override;
+  bool Is64Bit() override;
+  bool GetThreadInfo(pid_t tid, ThreadInfo* info) override;
+  bool GetThreadInfoWithoutFloatContext(pid_t tid, ThreadInfo* info) override;
+  bool ReadFileContents(const base::FilePath& path,
+                        std::string* contents) override;
+  bool ReadThreadFileContents(pid_t tid,
+                              const char* name,
+                              std::string* contents) override;
+  ProcessMemoryLinux* Memory() override;
+  bool Threads(std::vector<pid_t>* threads) override;
+  ssize_t ReadUpTo(VMAddress address, size_t size, void* buffer) override;
+  void ReadUpToV(ProcessMemory::BatchRead* reads, size_t count) override;
+
+ private:
+  void RecordMemory(VMAddress address, const void* data, size_t size);
+  void WriteRecord(const std::string& record);
+
+  // The ranges of memory already recorded, from start address to end address.
+  // Overlapping and adjacent ranges are merged.
+  std::map<VMAddress, VMAddress> recorded_memory_;
+  std::unique_ptr<ProcessMemoryLinux> memory_;
+  base::Lock lock_;
+  PtraceConnection* connection_;  // weak
+  FileWriterInterface* trace_;  // weak
+  bool recording_;
+  InitializationStateDcheck initialized_;
+};
+
+//! \brief A PtraceConnection that answers requests from a trace recorded by a
+//!     RecordingPtraceConnection, without a process.
+//!
+//! Requests that weren’t recorded fail with a message logged. Memory can be
+//! read from any part of a range that was recorded. This class may be used
+//! from several threads at once once it has been initialized.
+class ReplayPtraceConnection : public PtraceConnection {
+ public:
+  ReplayPtraceConnection();
+
+  ReplayPtraceConnection(const ReplayPtraceConnection&) = delete;
+  ReplayPtraceConnection& operator=(const ReplayPtraceConnection&) = delete;
+
+  ~ReplayPtraceConnection();
+
+  //! \brief Initializes this connection by reading a trace.
+  //!
+  //! \param[in] trace The reader to read the trace from. It is only used
+  //!     during this call.
+  //! \return `true` on success. `false` on failure with a message logged.
+  bool Initialize(FileReaderInterface* trace);
+
+  // PtraceConnection:
+
+  pid_t GetProcessID() override;
+  bool Attach(pid_t tid) override;
+  bool Is64Bit() override;
+  bool GetThreadInfo(pid_t tid, ThreadInfo* info) override;
+  bool GetThreadInfoWithoutFloatContext(pid_t tid, ThreadInfo* info) override;
+  bool ReadFileContents(const base::FilePath& path,
+                        std::string* contents) override;
+  bool ReadThreadFileContents(pid_t tid,
+                              const char* name,
+                              std::string* contents) override;
+  ProcessMemoryLinux* Memory() override;
+  bool Threads(std::vector<pid_t>* threads) override;
+  ssize_t ReadUpTo(VMAddress address, size_t size, void* buffer) override;
+
+ private:
+  // Whether a recorded request succeeded, and what it returned if it did.
+  template <typename T>
+  using Recorded = std::pair<bool, T>;
+
+  void AddMemory(VMAddress address, std::string data);
+
+  // The recorded memory, by start address. Overlapping and adjacent ranges are
+  // merged.
+  std::map<VMAddress, std::string> memory_ranges_;
+  std::map<pid_t, bool> attached_;
+  std::map<std::pair<pid_t, bool>, Recorded<ThreadInfo>> thread_info_;
+  std::map<std::string, Recorded<std::string>> files_;
+  std::map<std::pair<pid_t, std::string>, Recorded<std::string>>
+      thread_files_;
+  Recorded<std::vector<pid_t>> threads_;
+  std::unique_ptr<ProcessMemoryLinux> memory_;
+  pid_t pid_;
+  bool is_64_bit_;
+  InitializationStateDcheck initialized_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_UTIL_LINUX_PTRACE_CONNECTION_TRACE_H_
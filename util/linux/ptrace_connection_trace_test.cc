@@ -0,0 +1,244 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/linux/ptrace_connection_trace.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "util/file/string_file.h"
+#include "util/misc/from_pointer_cast.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+// Answers requests from a buffer in this process and a fixed set of files.
+class StubPtraceConnection : public PtraceConnection {
+ public:
+  explicit StubPtraceConnection(const std::string* memory)
+      : PtraceConnection(), memory_(memory), reads_(0) {}
+
+  StubPtraceConnection(const StubPtraceConnection&) = delete;
+  StubPtraceConnection& operator=(const StubPtraceConnection&) = delete;
+
+  ~StubPtraceConnection() override {}
+
+  VMAddress MemoryAddress() const {
+    return FromPointerCast<VMAddress>(memory_->data());
+  }
+
+  size_t reads() const { return reads_; }
+
+  // PtraceConnection:
+
+  pid_t GetProcessID() override { return kPid; }
+  bool Attach(pid_t tid) override { return tid != kMissingTid; }
+  bool Is64Bit() override { return sizeof(void*) == 8; }
+
+  bool GetThreadInfo(pid_t tid, ThreadInfo* info) override {
+    if (tid == kMissingTid) {
+      return false;
+    }
+    memset(static_cast<void*>(info), tid, sizeof(*info));
+    return true;
+  }
+
+  bool ReadFileContents(const base::FilePath& path,
+                        std::string* contents) override {
+    if (path.value() != "/proc/1234/maps") {
+      return false;
+    }
+    *contents = "maps";
+    return true;
+  }
+
+  ProcessMemoryLinux* Memory() override { return nullptr; }
+
+  bool Threads(std::vector<pid_t>* threads) override {
+    *threads = {kPid, kPid + 1, kMissingTid};
+    return true;
+  }
+
+  ssize_t ReadUpTo(VMAddress address, size_t size, void* buffer) override {
+    ++reads_;
+    if (address < MemoryAddress() ||
+        address >= MemoryAddress() + memory_->size()) {
+      return -1;
+    }
+    const size_t offset = address - MemoryAddress();
+    size = std::min(size, memory_->size() - offset);
+    memcpy(buffer, memory_->data() + offset, size);
+    return size;
+  }
+
+  static constexpr pid_t kPid = 1234;
+  static constexpr pid_t kMissingTid = 1240;
+
+ private:
+  const std::string* memory_;  // weak
+  size_t reads_;
+};
+
+TEST(PtraceConnectionTrace, RecordAndReplay) {
+  std::string memory;
+  for (size_t index = 0; index < 256; ++index) {
+    memory.push_back(static_cast<char>(index));
+  }
+  StubPtraceConnection stub(&memory);
+  const VMAddress address = stub.MemoryAddress();
+
+  StringFile trace;
+  {
+    RecordingPtraceConnection recorder;
+    ASSERT_TRUE(recorder.Initialize(&stub, &trace));
+    EXPECT_EQ(recorder.GetProcessID(), StubPtraceConnection::kPid);
+
+    std::vector<pid_t> threads;
+    ASSERT_TRUE(recorder.Threads(&threads));
+    std::vector<bool> attached;
+    recorder.AttachThreads(threads, &attached);
+    EXPECT_EQ(attached, std::vector<bool>({true, true, false}));
+
+    ThreadInfo info;
+    EXPECT_TRUE(recorder.GetThreadInfo(StubPtraceConnection::kPid, &info));
+    EXPECT_FALSE(
+        recorder.GetThreadInfo(StubPtraceConnection::kMissingTid, &info));
+
+    std::string contents;
+    EXPECT_TRUE(recorder.ReadFileContents(base::FilePath("/proc/1234/maps"),
+                                          &contents));
+    EXPECT_FALSE(recorder.ReadFileContents(base::FilePath("/proc/1234/auxv"),
+                                           &contents));
+
+    // Two reads that overlap, and one that adjoins them.
+    char buffer[64];
+    ProcessMemoryLinux* process_memory = recorder.Memory();
+    ASSERT_TRUE(process_memory->Read(address + 16, 32, buffer));
+    ASSERT_TRUE(process_memory->Read(address + 32, 32, buffer));
+    ASSERT_TRUE(process_memory->Read(address + 64, 16, buffer));
+  }
+
+  StringFile replay_trace;
+  replay_trace.SetString(trace.string());
+  ReplayPtraceConnection replay;
+  ASSERT_TRUE(replay.Initialize(&replay_trace));
+  EXPECT_EQ(replay.GetProcessID(), StubPtraceConnection::kPid);
+  EXPECT_EQ(replay.Is64Bit(), stub.Is64Bit());
+
+  std::vector<pid_t> threads;
+  ASSERT_TRUE(replay.Threads(&threads));
+  EXPECT_EQ(threads,
+            std::vector<pid_t>({StubPtraceConnection::kPid,
+                                StubPtraceConnection::kPid + 1,
+                                StubPtraceConnection::kMissingTid}));
+  EXPECT_TRUE(replay.Attach(StubPtraceConnection::kPid + 1));
+  EXPECT_FALSE(replay.Attach(StubPtraceConnection::kMissingTid));
+  EXPECT_FALSE(replay.Attach(StubPtraceConnection::kPid + 2));
+
+  ThreadInfo expected_info;
+  stub.GetThreadInfo(StubPtraceConnection::kPid, &expected_info);
+  ThreadInfo info;
+  ASSERT_TRUE(replay.GetThreadInfo(StubPtraceConnection::kPid, &info));
+  EXPECT_EQ(memcmp(&info, &expected_info, sizeof(info)), 0);
+  EXPECT_FALSE(replay.GetThreadInfo(StubPtraceConnection::kMissingTid, &info));
+  EXPECT_FALSE(replay.GetThreadInfo(StubPtraceConnection::kPid + 1, &info));
+
+  ASSERT_TRUE(replay.GetThreadInfoWithoutFloatContext(
+      StubPtraceConnection::kPid, &info));
+  EXPECT_EQ(memcmp(&info.thread_context,
+                   &expected_info.thread_context,
+                   sizeof(info.thread_context)),
+            0);
+  const FloatContext zero_float_context = {};
+  EXPECT_EQ(memcmp(&info.float_context,
+                   &zero_float_context,
+                   sizeof(info.float_context)),
+            0);
+
+  std::string contents;
+  ASSERT_TRUE(
+      replay.ReadFileContents(base::FilePath("/proc/1234/maps"), &contents));
+  EXPECT_EQ(contents, "maps");
+  EXPECT_FALSE(
+      replay.ReadFileContents(base::FilePath("/proc/1234/auxv"), &contents));
+  EXPECT_FALSE(
+      replay.ReadFileContents(base::FilePath("/proc/1234/stat"), &contents));
+
+  // The recorded reads were merged, so any part of them can be read.
+  char buffer[64];
+  ProcessMemoryLinux* process_memory = replay.Memory();
+  ASSERT_TRUE(process_memory->Read(address + 20, 60, buffer));
+  EXPECT_EQ(memcmp(buffer, memory.data() + 20, 60), 0);
+  EXPECT_FALSE(process_memory->Read(address + 8, 16, buffer));
+  EXPECT_FALSE(process_memory->Read(address + 72, 16, buffer));
+}
+
+TEST(PtraceConnectionTrace, MemoryRecordedOnce) {
+  std::string memory(4096, 'm');
+  StubPtraceConnection stub(&memory);
+
+  StringFile trace;
+  RecordingPtraceConnection recorder;
+  ASSERT_TRUE(recorder.Initialize(&stub, &trace));
+
+  std::vector<char> buffer(memory.size());
+  ProcessMemoryLinux* process_memory = recorder.Memory();
+  ASSERT_TRUE(
+      process_memory->Read(stub.MemoryAddress(), memory.size(), buffer.data()));
+  const size_t trace_size = trace.string().size();
+  EXPECT_GT(trace_size, memory.size());
+
+  ASSERT_TRUE(
+      process_memory->Read(stub.MemoryAddress() + 100, 100, buffer.data()));
+  ASSERT_TRUE(
+      process_memory->Read(stub.MemoryAddress(), memory.size(), buffer.data()));
+  EXPECT_EQ(trace.string().size(), trace_size);
+  EXPECT_EQ(stub.reads(), 3u);
+}
+
+TEST(PtraceConnectionTrace, BadTrace) {
+  StringFile trace;
+  ReplayPtraceConnection empty;
+  EXPECT_FALSE(empty.Initialize(&trace));
+
+  std::string memory(16, 'm');
+  StubPtraceConnection stub(&memory);
+  {
+    RecordingPtraceConnection recorder;
+    ASSERT_TRUE(recorder.Initialize(&stub, &trace));
+    std::string contents;
+    ASSERT_TRUE(recorder.ReadFileContents(base::FilePath("/proc/1234/maps"),
+                                          &contents));
+  }
+
+  StringFile truncated_trace;
+  const std::string& contents = trace.string();
+  truncated_trace.SetString(contents.substr(0, contents.size() - 1));
+  ReplayPtraceConnection truncated;
+  EXPECT_FALSE(truncated.Initialize(&truncated_trace));
+
+  StringFile complete_trace;
+  complete_trace.SetString(trace.string());
+  ReplayPtraceConnection complete;
+  EXPECT_TRUE(complete.Initialize(&complete_trace));
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
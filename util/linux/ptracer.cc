@@ -488,12 +488,13 @@ bool Ptracer::Is64Bit() {
   return is_64_bit_;
 }
 
-bool Ptracer::GetThreadInfo(pid_t tid, ThreadInfo* info) {
+bool Ptracer::GetThreadInfo(pid_t tid, ThreadInfo* info, bool float_context) {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
 
   if (is_64_bit_) {
     return GetGeneralPurposeRegisters64(tid, &info->thread_context, can_log_) &&
-           GetFloatingPointRegisters64(tid, &info->float_context, can_log_) &&
+           (!float_context ||
+            GetFloatingPointRegisters64(tid, &info->float_context, can_log_)) &&
            GetThreadArea64(tid,
                            info->thread_context,
                            &info->thread_specific_data_address,
@@ -501,7 +502,8 @@ bool Ptracer::GetThreadInfo(pid_t tid, ThreadInfo* info) {
   }
 
   return GetGeneralPurposeRegisters32(tid, &info->thread_context, can_log_) &&
-         GetFloatingPointRegisters32(tid, &info->float_context, can_log_) &&
+         (!float_context ||
+          GetFloatingPointRegisters32(tid, &info->float_context, can_log_)) &&
          GetThreadArea32(tid,
                          info->thread_context,
                          &info->thread_specific_data_address,
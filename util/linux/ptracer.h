@@ -69,9 +69,11 @@ class Ptracer {
   //!
   //! \param[in] tid The thread ID of the thread to collect information for.
   //! \param[out] info A ThreadInfo for the thread.
+  //! \param[in] float_context Whether to collect ThreadInfo::float_context.
+  //!     If `false`, it is left unchanged, saving a `ptrace` request.
   //! \return `true` on success. `false` on failure with a message logged, if
   //!     enabled.
-  bool GetThreadInfo(pid_t tid, ThreadInfo* info);
+  bool GetThreadInfo(pid_t tid, ThreadInfo* info, bool float_context = true);
 
   //! \brief Uses `ptrace` to read memory from the process with process ID \a
   //!     pid, up to a maximum number of bytes.
@@ -27,7 +27,23 @@ bool PtraceAttach(pid_t pid, bool can_log) {
     PLOG_IF(ERROR, can_log) << "ptrace";
     return false;
   }
+  return PtraceWaitForStop(pid, can_log);
+}
+
+bool PtraceSeizeAndInterrupt(pid_t pid, bool can_log) {
+  if (ptrace(PTRACE_SEIZE, pid, nullptr, nullptr) != 0) {
+    PLOG_IF(ERROR, can_log) << "ptrace";
+    return false;
+  }
+  if (ptrace(PTRACE_INTERRUPT, pid, nullptr, nullptr) != 0) {
+    PLOG_IF(ERROR, can_log) << "ptrace";
+    PtraceDetach(pid, false);
+    return false;
+  }
+  return true;
+}
 
+bool PtraceWaitForStop(pid_t pid, bool can_log) {
   int status;
   if (HANDLE_EINTR(waitpid(pid, &status, __WALL)) < 0) {
     PLOG_IF(ERROR, can_log) << "waitpid";
@@ -74,4 +90,9 @@ bool ScopedPtraceAttach::ResetAttach(pid_t pid) {
   return true;
 }
 
+void ScopedPtraceAttach::ResetAdopt(pid_t pid) {
+  Reset();
+  pid_ = pid;
+}
+
 }  // namespace crashpad
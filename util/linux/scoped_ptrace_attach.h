@@ -29,6 +29,29 @@ namespace crashpad {
 //!     can_log is `true`.
 bool PtraceAttach(pid_t pid, bool can_log = true);
 
+//! \brief Attaches to the process with process ID \a pid with `PTRACE_SEIZE`
+//!     and asks it to stop with `PTRACE_INTERRUPT`, without waiting for it to
+//!     stop.
+//!
+//! This allows many threads to be asked to stop before waiting for any of
+//! them, so that they stop at nearly the same time. Call PtraceWaitForStop()
+//! afterwards to wait for the stop.
+//!
+//! \param pid The process ID of the process to attach to.
+//! \param can_log Whether this function may log messages on failure.
+//! \return `true` on success. `false` on failure with a message logged if \a
+//!     can_log is `true`. `PTRACE_SEIZE` isn’t supported before Linux 3.4.
+bool PtraceSeizeAndInterrupt(pid_t pid, bool can_log = true);
+
+//! \brief Blocks until the attached process with process ID \a pid has
+//!     stopped by calling `waitpid()`.
+//!
+//! \param pid The process ID of the process to wait for.
+//! \param can_log Whether this function may log messages on failure.
+//! \return `true` on success. `false` on failure with a message logged if \a
+//!     can_log is `true`.
+bool PtraceWaitForStop(pid_t pid, bool can_log = true);
+
 //! \brief Detaches the process  with process ID \a pid. The process must
 //!     already be ptrace attached.
 //!
@@ -62,6 +85,11 @@ class ScopedPtraceAttach {
   //! \return `true` on success. `false` on failure, with a message logged.
   bool ResetAttach(pid_t pid);
 
+  //! \brief Detaches from any previously attached process, and takes over an
+  //!     existing attachment to the stopped process with process ID \a pid,
+  //!     such as one made by PtraceSeizeAndInterrupt() and PtraceWaitForStop().
+  void ResetAdopt(pid_t pid);
+
  private:
   pid_t pid_;
 };
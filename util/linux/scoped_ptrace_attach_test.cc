@@ -94,6 +94,51 @@ TEST(ScopedPtraceAttach, AttachChild) {
   test.Run();
 }
 
+class SeizeChildTest : public AttachTest {
+ public:
+  SeizeChildTest() : AttachTest() {}
+
+  SeizeChildTest(const SeizeChildTest&) = delete;
+  SeizeChildTest& operator=(const SeizeChildTest&) = delete;
+
+  ~SeizeChildTest() {}
+
+ private:
+  void MultiprocessParent() override {
+    // Wait for the child to set the parent as its ptracer.
+    char c;
+    CheckedReadFileExactly(ReadPipeHandle(), &c, sizeof(c));
+
+    pid_t pid = ChildPID();
+
+    ASSERT_TRUE(PtraceSeizeAndInterrupt(pid));
+    ASSERT_TRUE(PtraceWaitForStop(pid));
+
+    ScopedPtraceAttach attachment;
+    attachment.ResetAdopt(pid);
+    EXPECT_EQ(ptrace(PTRACE_PEEKDATA, pid, &kWord, nullptr), kWord)
+        << ErrnoMessage("ptrace");
+    attachment.Reset();
+
+    ASSERT_EQ(ptrace(PTRACE_PEEKDATA, pid, &kWord, nullptr), -1);
+    EXPECT_EQ(errno, ESRCH) << ErrnoMessage("ptrace");
+  }
+
+  void MultiprocessChild() override {
+    ScopedPrSetPtracer set_ptracer(getppid(), /* may_log= */ true);
+
+    char c = '\0';
+    CheckedWriteFile(WritePipeHandle(), &c, sizeof(c));
+
+    CheckedReadFileAtEOF(ReadPipeHandle());
+  }
+};
+
+TEST(ScopedPtraceAttach, SeizeChild) {
+  SeizeChildTest test;
+  test.Run();
+}
+
 class AttachToParentResetTest : public AttachTest {
  public:
   AttachToParentResetTest() : AttachTest() {}
@@ -14,6 +14,9 @@
 
 #include "util/linux/socket.h"
 
+#include <stddef.h>
+#include <string.h>
+#include <sys/un.h>
 #include <unistd.h>
 
 #include "base/check_op.h"
@@ -23,6 +26,38 @@
 
 namespace crashpad {
 
+namespace {
+
+bool MakeAbstractAddress(const std::string& name,
+                         sockaddr_un* addr,
+                         socklen_t* addr_len) {
+  // The leading NUL byte of sun_path places the name in the abstract
+  // namespace, where it needs no filesystem path and disappears with the last
+  // socket bound to it.
+  if (name.empty() || name.size() >= sizeof(addr->sun_path)) {
+    LOG(ERROR) << "invalid socket name " << name;
+    return false;
+  }
+
+  memset(addr, 0, sizeof(*addr));
+  addr->sun_family = AF_UNIX;
+  memcpy(addr->sun_path + 1, name.data(), name.size());
+  *addr_len = offsetof(sockaddr_un, sun_path) + 1 + name.size();
+  return true;
+}
+
+bool SetPassCred(int sock) {
+  int optval = 1;
+  if (setsockopt(sock, SOL_SOCKET, SO_PASSCRED, &optval, sizeof(optval)) !=
+      0) {
+    PLOG(ERROR) << "setsockopt";
+    return false;
+  }
+  return true;
+}
+
+}  // namespace
+
 constexpr size_t UnixCredentialSocket::kMaxSendRecvMsgFDs;
 
 // static
@@ -51,6 +86,84 @@ bool UnixCredentialSocket::CreateCredentialSocketpair(ScopedFileHandle* sock1,
   return true;
 }
 
+// static
+bool UnixCredentialSocket::CreateCredentialListeningSocket(
+    const std::string& name,
+    ScopedFileHandle* sock) {
+  sockaddr_un addr;
+  socklen_t addr_len;
+  if (!MakeAbstractAddress(name, &addr, &addr_len)) {
+    return false;
+  }
+
+  ScopedFileHandle local_sock(socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0));
+  if (!local_sock.is_valid()) {
+    PLOG(ERROR) << "socket";
+    return false;
+  }
+
+  if (!SetPassCred(local_sock.get())) {
+    return false;
+  }
+
+  if (bind(local_sock.get(), reinterpret_cast<sockaddr*>(&addr), addr_len) !=
+      0) {
+    PLOG(ERROR) << "bind";
+    return false;
+  }
+
+  if (listen(local_sock.get(), SOMAXCONN) != 0) {
+    PLOG(ERROR) << "listen";
+    return false;
+  }
+
+  sock->swap(local_sock);
+  return true;
+}
+
+// static
+bool UnixCredentialSocket::ConnectCredentialSocket(const std::string& name,
+                                                   ScopedFileHandle* sock,
+                                                   ucred* peer_creds) {
+  sockaddr_un addr;
+  socklen_t addr_len;
+  if (!MakeAbstractAddress(name, &addr, &addr_len)) {
+    return false;
+  }
+
+  ScopedFileHandle local_sock(socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0));
+  if (!local_sock.is_valid()) {
+    PLOG(ERROR) << "socket";
+    return false;
+  }
+
+  if (!SetPassCred(local_sock.get())) {
+    return false;
+  }
+
+  if (HANDLE_EINTR(connect(local_sock.get(),
+                           reinterpret_cast<sockaddr*>(&addr),
+                           addr_len)) != 0) {
+    PLOG(ERROR) << "connect";
+    return false;
+  }
+
+  if (peer_creds) {
+    socklen_t creds_len = sizeof(*peer_creds);
+    if (getsockopt(local_sock.get(),
+                   SOL_SOCKET,
+                   SO_PEERCRED,
+                   peer_creds,
+                   &creds_len) != 0) {
+      PLOG(ERROR) << "getsockopt";
+      return false;
+    }
+  }
+
+  sock->swap(local_sock);
+  return true;
+}
+
 // static
 int UnixCredentialSocket::SendMsg(int fd,
                                   const void* buf,
@@ -18,6 +18,7 @@
 #include <sys/socket.h>
 #include <sys/types.h>
 
+#include <string>
 #include <vector>
 
 #include "util/file/file_io.h"
@@ -41,6 +42,30 @@ class UnixCredentialSocket {
   static bool CreateCredentialSocketpair(ScopedFileHandle* s1,
                                          ScopedFileHandle* s2);
 
+  //! \brief Creates an `AF_UNIX` family socket with `SO_PASSCRED` set,
+  //!     listening on \a name in the abstract socket namespace.
+  //!
+  //! Sockets accepted from the listening socket inherit `SO_PASSCRED`.
+  //!
+  //! \param[in] name The name to listen on, without the leading NUL byte
+  //!     that places it in the abstract namespace.
+  //! \param[out] sock The listening socket.
+  //! \return `true` on success. Otherwise, `false` with a message logged.
+  static bool CreateCredentialListeningSocket(const std::string& name,
+                                              ScopedFileHandle* sock);
+
+  //! \brief Connects an `AF_UNIX` family socket with `SO_PASSCRED` set to a
+  //!     socket created by CreateCredentialListeningSocket().
+  //!
+  //! \param[in] name The name the listening socket was created with.
+  //! \param[out] sock The connected socket.
+  //! \param[out] peer_creds The credentials of the process that created the
+  //!     listening socket, as reported by `SO_PEERCRED`. Optional.
+  //! \return `true` on success. Otherwise, `false` with a message logged.
+  static bool ConnectCredentialSocket(const std::string& name,
+                                      ScopedFileHandle* sock,
+                                      ucred* peer_creds = nullptr);
+
   //! \brief The maximum number of file descriptors that may be sent/received
   //!     with `SendMsg()` or `RecvMsg()`.
   static constexpr size_t kMaxSendRecvMsgFDs = 4;
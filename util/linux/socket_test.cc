@@ -14,7 +14,11 @@
 
 #include "util/linux/socket.h"
 
+#include <sys/socket.h>
+#include <unistd.h>
+
 #include "base/posix/eintr_wrapper.h"
+#include "base/strings/stringprintf.h"
 #include "gtest/gtest.h"
 #include "util/linux/socket.h"
 
@@ -132,6 +136,46 @@ TEST(Socket, RecvClosesFileDescriptors) {
   }
 }
 
+TEST(Socket, ListenAndConnect) {
+  const std::string name =
+      base::StringPrintf("crashpad_socket_test_%d", getpid());
+
+  ScopedFileHandle listen_sock;
+  ASSERT_TRUE(
+      UnixCredentialSocket::CreateCredentialListeningSocket(name, &listen_sock));
+
+  ScopedFileHandle duplicate_sock;
+  EXPECT_FALSE(UnixCredentialSocket::CreateCredentialListeningSocket(
+      name, &duplicate_sock));
+
+  ScopedFileHandle send_sock;
+  ucred peer_creds;
+  ASSERT_TRUE(UnixCredentialSocket::ConnectCredentialSocket(
+      name, &send_sock, &peer_creds));
+  EXPECT_EQ(peer_creds.pid, getpid());
+  EXPECT_EQ(peer_creds.uid, geteuid());
+
+  ScopedFileHandle recv_sock(
+      HANDLE_EINTR(accept4(listen_sock.get(), nullptr, nullptr, SOCK_CLOEXEC)));
+  ASSERT_TRUE(recv_sock.is_valid());
+
+  char msg = 42;
+  ASSERT_EQ(UnixCredentialSocket::SendMsg(send_sock.get(), &msg, sizeof(msg)),
+            0);
+
+  char recv_msg = 0;
+  ucred creds;
+  ASSERT_TRUE(UnixCredentialSocket::RecvMsg(
+      recv_sock.get(), &recv_msg, sizeof(recv_msg), &creds));
+  EXPECT_EQ(recv_msg, msg);
+  EXPECT_EQ(creds.pid, getpid());
+
+  listen_sock.reset();
+  ScopedFileHandle unconnected_sock;
+  EXPECT_FALSE(
+      UnixCredentialSocket::ConnectCredentialSocket(name, &unconnected_sock));
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace crashpad
@@ -31,9 +31,14 @@ ScopedTaskSuspend::ScopedTaskSuspend(task_t task) : task_(task) {
 }
 
 ScopedTaskSuspend::~ScopedTaskSuspend() {
+  Resume();
+}
+
+void ScopedTaskSuspend::Resume() {
   if (task_ != TASK_NULL) {
     kern_return_t kr = task_resume(task_);
     MACH_LOG_IF(ERROR, kr != KERN_SUCCESS, kr) << "task_resume";
+    task_ = TASK_NULL;
   }
 }
 
@@ -37,6 +37,11 @@ class ScopedTaskSuspend {
 
   ~ScopedTaskSuspend();
 
+  //! \brief Resumes the other task before this object is destroyed.
+  //!
+  //! After this is called, destroying the object does nothing.
+  void Resume();
+
  private:
   task_t task_;
 };
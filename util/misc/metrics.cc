@@ -14,10 +14,15 @@
 
 #include "util/misc/metrics.h"
 
+#include <atomic>
+
 #include "base/metrics/histogram_functions.h"
 #include "base/metrics/histogram_macros.h"
+#include "base/notreached.h"
 #include "base/numerics/safe_conversions.h"
 #include "build/build_config.h"
+#include "util/misc/clock.h"
+#include "util/misc/trace_events.h"
 
 #if BUILDFLAG(IS_APPLE)
 #define METRICS_OS_NAME "Mac"
@@ -56,6 +61,10 @@ void ExceptionProcessing(ExceptionProcessingState state) {
                             ExceptionProcessingState::kMaxValue);
 }
 
+// The total duration of each TimedOperation, in nanoseconds.
+std::atomic<uint64_t> g_operation_duration_totals[static_cast<size_t>(
+    Metrics::TimedOperation::kMaxValue)];
+
 }  // namespace
 
 // static
@@ -122,6 +131,127 @@ void Metrics::HandlerCrashed(uint32_t exception_code) {
       "Crashpad.HandlerCrash.ExceptionCode." METRICS_OS_NAME, exception_code);
 }
 
+// static
+void Metrics::OperationDuration(TimedOperation operation,
+                                uint64_t nanoseconds) {
+  if (operation < TimedOperation::kMaxValue) {
+    g_operation_duration_totals[static_cast<size_t>(operation)].fetch_add(
+        nanoseconds, std::memory_order_relaxed);
+  }
+
+  const int32_t microseconds =
+      base::saturated_cast<int32_t>(nanoseconds / 1000);
+
+  // Each call site of a histogram macro must use a single name, so each
+  // operation gets its own invocation. Durations of up to ten minutes are
+  // distinguished.
+#define OPERATION_DURATION_HISTOGRAM(name) \
+  UMA_HISTOGRAM_CUSTOM_COUNTS(name, microseconds, 1, 600 * 1000 * 1000, 100)
+
+  switch (operation) {
+    case TimedOperation::kSuspend:
+      OPERATION_DURATION_HISTOGRAM("Crashpad.OperationDuration.Suspend");
+      break;
+    case TimedOperation::kSnapshot:
+      OPERATION_DURATION_HISTOGRAM("Crashpad.OperationDuration.Snapshot");
+      break;
+    case TimedOperation::kSanitize:
+      OPERATION_DURATION_HISTOGRAM("Crashpad.OperationDuration.Sanitize");
+      break;
+    case TimedOperation::kMinidumpWrite:
+      OPERATION_DURATION_HISTOGRAM("Crashpad.OperationDuration.MinidumpWrite");
+      break;
+    case TimedOperation::kUpload:
+      OPERATION_DURATION_HISTOGRAM("Crashpad.OperationDuration.Upload");
+      break;
+    case TimedOperation::kPrune:
+      OPERATION_DURATION_HISTOGRAM("Crashpad.OperationDuration.Prune");
+      break;
+    case TimedOperation::kIntermediateDumpConversion:
+      OPERATION_DURATION_HISTOGRAM(
+          "Crashpad.OperationDuration.IntermediateDumpConversion");
+      break;
+    case TimedOperation::kHandlerStartup:
+      OPERATION_DURATION_HISTOGRAM("Crashpad.OperationDuration.HandlerStartup");
+      break;
+    case TimedOperation::kMaxValue:
+      NOTREACHED();
+  }
+
+#undef OPERATION_DURATION_HISTOGRAM
+}
+
+// static
+uint64_t Metrics::TotalOperationDuration(TimedOperation operation) {
+  if (operation >= TimedOperation::kMaxValue) {
+    NOTREACHED();
+    return 0;
+  }
+  return g_operation_duration_totals[static_cast<size_t>(operation)].load(
+      std::memory_order_relaxed);
+}
+
+// static
+const char* Metrics::TimedOperationName(TimedOperation operation) {
+  switch (operation) {
+    case TimedOperation::kSuspend:
+      return "Suspend";
+    case TimedOperation::kSnapshot:
+      return "Snapshot";
+    case TimedOperation::kSanitize:
+      return "Sanitize";
+    case TimedOperation::kMinidumpWrite:
+      return "MinidumpWrite";
+    case TimedOperation::kUpload:
+      return "Upload";
+    case TimedOperation::kPrune:
+      return "Prune";
+    case TimedOperation::kIntermediateDumpConversion:
+      return "IntermediateDumpConversion";
+    case TimedOperation::kHandlerStartup:
+      return "HandlerStartup";
+    case TimedOperation::kMaxValue:
+      break;
+  }
+  NOTREACHED();
+  return "";
+}
+
+// static
+void Metrics::HandlerResourceUsage(uint64_t resident_bytes,
+                                   uint64_t peak_resident_bytes,
+                                   uint32_t thread_count,
+                                   uint32_t open_file_count,
+                                   uint32_t pending_dump_count,
+                                   uint64_t upload_backlog_bytes) {
+  UMA_HISTOGRAM_MEMORY_KB("Crashpad.HandlerResourceUsage.ResidentSize",
+                          base::saturated_cast<int>(resident_bytes / 1024));
+  UMA_HISTOGRAM_MEMORY_KB(
+      "Crashpad.HandlerResourceUsage.PeakResidentSize",
+      base::saturated_cast<int>(peak_resident_bytes / 1024));
+  UMA_HISTOGRAM_COUNTS_1000("Crashpad.HandlerResourceUsage.ThreadCount",
+                            thread_count);
+  UMA_HISTOGRAM_COUNTS_10000("Crashpad.HandlerResourceUsage.OpenFileCount",
+                             open_file_count);
+  UMA_HISTOGRAM_COUNTS_1000("Crashpad.HandlerResourceUsage.PendingDumpCount",
+                            pending_dump_count);
+  UMA_HISTOGRAM_MEMORY_LARGE_MB(
+      "Crashpad.HandlerResourceUsage.UploadBacklogSize",
+      base::saturated_cast<int>(upload_backlog_bytes / (1024 * 1024)));
+}
+
+Metrics::ScopedOperationTimer::ScopedOperationTimer(TimedOperation operation)
+    : start_nanoseconds_(ClockMonotonicNanoseconds()), operation_(operation) {}
+
+Metrics::ScopedOperationTimer::~ScopedOperationTimer() {
+  const uint64_t end_nanoseconds = ClockMonotonicNanoseconds();
+  OperationDuration(operation_, end_nanoseconds - start_nanoseconds_);
+  if (TraceEvents::IsEnabled()) {
+    TraceEvents::AddEvent(
+        TimedOperationName(operation_), start_nanoseconds_, end_nanoseconds);
+  }
+}
+
 #if BUILDFLAG(IS_IOS)
 // static
 void Metrics::MissingIntermediateDumpKey(
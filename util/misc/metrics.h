@@ -160,6 +160,16 @@ class Metrics {
     //! \brief Failure to open a memfd caused this crash dump to be skipped.
     kOpenMemfdFailed = 12,
 
+    //! \brief The crash dump was skipped because reports of crashes with the
+    //!     same signature were written recently.
+    kSkippedDueToDuplicateSignature = 13,
+
+    //! \brief The dump was skipped because its client had requested too many
+    //!     dumps without crashing.
+    //!
+    //! This value is only used on Linux/Android.
+    kSkippedDueToClientQuota = 14,
+
     //! \brief The number of values in this enumeration; not a valid value.
     kMaxValue
   };
@@ -213,6 +223,96 @@ class Metrics {
   //! This is currently only reported on Windows.
   static void HandlerCrashed(uint32_t exception_code);
 
+  //! \brief Operations whose durations are recorded by OperationDuration().
+  //!
+  //! \note These are used as metrics enumeration values, so new values should
+  //!     always be added at the end, before TimedOperation::kMaxValue.
+  enum class TimedOperation : int32_t {
+    //! \brief Attaching to a client process and suspending its threads.
+    //!
+    //! This value is only used on Linux/Android.
+    kSuspend = 0,
+
+    //! \brief Capturing a snapshot of a client process.
+    //!
+    //! This value is only used on Linux/Android.
+    kSnapshot = 1,
+
+    //! \brief Preparing a sanitized view of a process snapshot.
+    //!
+    //! This value is only used on Linux/Android.
+    kSanitize = 2,
+
+    //! \brief Writing a minidump file.
+    kMinidumpWrite = 3,
+
+    //! \brief Uploading a crash report.
+    kUpload = 4,
+
+    //! \brief Pruning a crash report database.
+    kPrune = 5,
+
+    //! \brief Converting an intermediate dump to a minidump.
+    //!
+    //! This value is only used on iOS.
+    kIntermediateDumpConversion = 6,
+
+    //! \brief Starting the handler, from once HandlerMain() has parsed its
+    //!     arguments until the handler is ready to serve clients.
+    kHandlerStartup = 7,
+
+    //! \brief The number of values in this enumeration; not a valid value.
+    kMaxValue
+  };
+
+  //! \brief Reports how long an operation took.
+  //!
+  //! Durations are recorded in microseconds, in a separate histogram for each
+  //! operation. When built against Chromium’s base with `--metrics-dir`, these
+  //! histograms are persisted to the metrics directory.
+  static void OperationDuration(TimedOperation operation, uint64_t nanoseconds);
+
+  //! \brief Returns the total duration of all instances of an operation
+  //!     reported to OperationDuration() in this process, in nanoseconds.
+  static uint64_t TotalOperationDuration(TimedOperation operation);
+
+  //! \brief Returns the name of an operation, as used for its trace events.
+  static const char* TimedOperationName(TimedOperation operation);
+
+  //! \brief Reports a sample of the handler’s own resource usage.
+  //!
+  //! \param[in] resident_bytes The handler’s resident set size.
+  //! \param[in] peak_resident_bytes The handler’s peak resident set size.
+  //! \param[in] thread_count The number of threads in the handler.
+  //! \param[in] open_file_count The number of file descriptors that the
+  //!     handler has open.
+  //! \param[in] pending_dump_count The number of dump requests waiting to be
+  //!     handled.
+  //! \param[in] upload_backlog_bytes The total size of the reports waiting to
+  //!     be uploaded.
+  static void HandlerResourceUsage(uint64_t resident_bytes,
+                                   uint64_t peak_resident_bytes,
+                                   uint32_t thread_count,
+                                   uint32_t open_file_count,
+                                   uint32_t pending_dump_count,
+                                   uint64_t upload_backlog_bytes);
+
+  //! \brief Reports the duration of an operation from the construction of this
+  //!     object to its destruction, whether or not the operation succeeds.
+  class ScopedOperationTimer {
+   public:
+    explicit ScopedOperationTimer(TimedOperation operation);
+
+    ScopedOperationTimer(const ScopedOperationTimer&) = delete;
+    ScopedOperationTimer& operator=(const ScopedOperationTimer&) = delete;
+
+    ~ScopedOperationTimer();
+
+   private:
+    uint64_t start_nanoseconds_;
+    TimedOperation operation_;
+  };
+
 #if BUILDFLAG(IS_IOS) || DOXYGEN
   //! \brief Records a missing key from an intermediate dump.
   static void MissingIntermediateDumpKey(
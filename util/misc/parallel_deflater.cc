@@ -0,0 +1,292 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/misc/parallel_deflater.h"
+
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+#include <memory>
+
+#include "base/check_op.h"
+#include "base/logging.h"
+#include "base/numerics/safe_conversions.h"
+#include "third_party/zlib/zlib_crashpad.h"
+#include "util/misc/zlib.h"
+#include "util/thread/thread.h"
+
+namespace crashpad {
+
+namespace {
+
+// The size of deflate’s sliding window, and so the most data that a block can
+// usefully be primed with.
+constexpr size_t kDictionarySize = 32 * 1024;
+
+// The values of zlib’s internal MAX_WBITS and DEF_MEM_LEVEL. Negative window
+// bits produce raw deflate data, without a wrapper.
+constexpr int kZlibMaxWindowBits = 15;
+constexpr int kZlibDefaultMemoryLevel = 8;
+
+struct Block {
+  // The data to compress, and the data preceding it to prime the compressor
+  // with.
+  const uint8_t* data;
+  size_t size;
+  const uint8_t* dictionary;
+  size_t dictionary_size;
+
+  // Whether this is the last block of the stream.
+  bool last;
+
+  // Results.
+  std::vector<uint8_t> output;
+  uint32_t checksum;
+  bool success;
+};
+
+// Compresses a single block to raw deflate data. Blocks other than the last
+// are ended with a sync flush, which leaves their output on a byte boundary
+// without marking the end of the stream.
+void CompressBlock(ParallelDeflater::Format format, int level, Block* block) {
+  block->success = false;
+  block->checksum =
+      format == ParallelDeflater::Format::kGzip
+          ? static_cast<uint32_t>(
+                crc32(crc32(0, nullptr, 0), block->data, block->size))
+          : static_cast<uint32_t>(
+                adler32(adler32(0, nullptr, 0), block->data, block->size));
+
+  z_stream stream = {};
+  int zr = deflateInit2(&stream,
+                        level,
+                        Z_DEFLATED,
+                        -kZlibMaxWindowBits,
+                        kZlibDefaultMemoryLevel,
+                        Z_DEFAULT_STRATEGY);
+  if (zr != Z_OK) {
+    LOG(ERROR) << "deflateInit2: " << ZlibErrorString(zr);
+    return;
+  }
+
+  if (block->dictionary_size > 0) {
+    zr = deflateSetDictionary(&stream,
+                              block->dictionary,
+                              static_cast<uInt>(block->dictionary_size));
+    if (zr != Z_OK) {
+      LOG(ERROR) << "deflateSetDictionary: " << ZlibErrorString(zr);
+      deflateEnd(&stream);
+      return;
+    }
+  }
+
+  // A sync flush adds an empty stored block of at most 10 bytes, including
+  // those needed to finish the previous one.
+  block->output.resize(deflateBound(&stream, static_cast<uLong>(block->size)) +
+                       10);
+  stream.next_in = const_cast<uint8_t*>(block->data);
+  stream.avail_in = static_cast<uInt>(block->size);
+  stream.next_out = block->output.data();
+  stream.avail_out = static_cast<uInt>(block->output.size());
+  const int flush = block->last ? Z_FINISH : Z_SYNC_FLUSH;
+  zr = deflate(&stream, flush);
+  if (zr != (block->last ? Z_STREAM_END : Z_OK) || stream.avail_in != 0) {
+    LOG(ERROR) << "deflate: " << ZlibErrorString(zr);
+    deflateEnd(&stream);
+    return;
+  }
+  block->output.resize(block->output.size() - stream.avail_out);
+
+  zr = deflateEnd(&stream);
+  // deflateEnd() reports Z_DATA_ERROR for a stream that wasn’t finished.
+  if (zr != Z_OK && !(zr == Z_DATA_ERROR && !block->last)) {
+    LOG(ERROR) << "deflateEnd: " << ZlibErrorString(zr);
+    return;
+  }
+  block->success = true;
+}
+
+// Compresses blocks, taking the index of each next block from next_index.
+void CompressBlocks(ParallelDeflater::Format format,
+                    int level,
+                    std::vector<Block>* blocks,
+                    std::atomic<size_t>* next_index) {
+  for (size_t index = (*next_index)++; index < blocks->size();
+       index = (*next_index)++) {
+    CompressBlock(format, level, &(*blocks)[index]);
+  }
+}
+
+class BlockThread : public Thread {
+ public:
+  BlockThread(ParallelDeflater::Format format,
+              int level,
+              std::vector<Block>* blocks,
+              std::atomic<size_t>* next_index)
+      : format_(format),
+        level_(level),
+        blocks_(blocks),
+        next_index_(next_index) {}
+
+  BlockThread(const BlockThread&) = delete;
+  BlockThread& operator=(const BlockThread&) = delete;
+
+  ~BlockThread() override = default;
+
+ private:
+  void ThreadMain() override {
+    CompressBlocks(format_, level_, blocks_, next_index_);
+  }
+
+  ParallelDeflater::Format format_;
+  int level_;
+  std::vector<Block>* blocks_;
+  std::atomic<size_t>* next_index_;
+};
+
+void AppendBigEndian32(uint32_t value, std::vector<uint8_t>* output) {
+  for (int shift = 24; shift >= 0; shift -= 8) {
+    output->push_back(static_cast<uint8_t>(value >> shift));
+  }
+}
+
+void AppendLittleEndian32(uint32_t value, std::vector<uint8_t>* output) {
+  for (int shift = 0; shift < 32; shift += 8) {
+    output->push_back(static_cast<uint8_t>(value >> shift));
+  }
+}
+
+}  // namespace
+
+ParallelDeflater::ParallelDeflater(Format format,
+                                   int level,
+                                   unsigned int threads)
+    : dictionary_(),
+      format_(format),
+      level_(level),
+      threads_(threads),
+      checksum_(format == Format::kGzip
+                    ? static_cast<uint32_t>(crc32(0, nullptr, 0))
+                    : static_cast<uint32_t>(adler32(0, nullptr, 0))),
+      total_size_(0),
+      started_(false),
+      finished_(false) {
+  DCHECK_GE(threads_, 1u);
+}
+
+ParallelDeflater::~ParallelDeflater() = default;
+
+bool ParallelDeflater::Compress(const uint8_t* data,
+                                size_t size,
+                                bool finish,
+                                std::vector<uint8_t>* output) {
+  DCHECK(!finished_);
+
+  if (!started_) {
+    started_ = true;
+    if (format_ == Format::kGzip) {
+      // ID1, ID2, CM = deflate, no flags, no modification time, no extra
+      // flags, and an unknown operating system, as RFC 1952 permits.
+      static constexpr uint8_t kGzipHeader[] = {
+          0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff};
+      output->insert(
+          output->end(), std::begin(kGzipHeader), std::end(kGzipHeader));
+    } else {
+      // CMF: deflate with a 32 kB window. FLG: the compression level as
+      // described by RFC 1950, no preset dictionary, and the check bits.
+      const int resolved_level = level_ == Z_DEFAULT_COMPRESSION ? 6 : level_;
+      const uint8_t level_flag = resolved_level < 2   ? 0
+                                 : resolved_level < 6 ? 1
+                                 : resolved_level == 6 ? 2
+                                                      : 3;
+      const uint16_t header = (0x78 << 8) | (level_flag << 6);
+      output->push_back(0x78);
+      output->push_back(
+          static_cast<uint8_t>((header | (31 - header % 31)) & 0xff));
+    }
+  }
+
+  if (size == 0 && !finish) {
+    return true;
+  }
+
+  // An empty stream still needs a final block.
+  std::vector<Block> blocks(std::max<size_t>(
+      (size + kBlockSize - 1) / kBlockSize, 1));
+  for (size_t index = 0; index < blocks.size(); ++index) {
+    Block& block = blocks[index];
+    const size_t offset = index * kBlockSize;
+    block.data = data + offset;
+    block.size = std::min(kBlockSize, size - offset);
+    if (index == 0) {
+      block.dictionary = dictionary_.data();
+      block.dictionary_size = dictionary_.size();
+    } else {
+      block.dictionary_size = std::min(kDictionarySize, offset);
+      block.dictionary = block.data - block.dictionary_size;
+    }
+    block.last = finish && index == blocks.size() - 1;
+  }
+
+  std::atomic<size_t> next_index(0);
+  std::vector<std::unique_ptr<BlockThread>> workers;
+  const size_t worker_count =
+      std::min(static_cast<size_t>(threads_), blocks.size()) - 1;
+  for (size_t index = 0; index < worker_count; ++index) {
+    workers.push_back(
+        std::make_unique<BlockThread>(format_, level_, &blocks, &next_index));
+    workers.back()->Start();
+  }
+  CompressBlocks(format_, level_, &blocks, &next_index);
+  for (const auto& worker : workers) {
+    worker->Join();
+  }
+
+  for (const Block& block : blocks) {
+    if (!block.success) {
+      return false;
+    }
+    output->insert(output->end(), block.output.begin(), block.output.end());
+    checksum_ = format_ == Format::kGzip
+                    ? static_cast<uint32_t>(crc32_combine(
+                          checksum_, block.checksum, block.size))
+                    : static_cast<uint32_t>(adler32_combine(
+                          checksum_, block.checksum, block.size));
+  }
+  total_size_ += size;
+
+  // Keep the end of the data to prime the first block of the next call.
+  if (size >= kDictionarySize) {
+    dictionary_.assign(data + size - kDictionarySize, data + size);
+  } else {
+    dictionary_.insert(dictionary_.end(), data, data + size);
+    if (dictionary_.size() > kDictionarySize) {
+      dictionary_.erase(dictionary_.begin(),
+                        dictionary_.end() - kDictionarySize);
+    }
+  }
+
+  if (finish) {
+    finished_ = true;
+    if (format_ == Format::kGzip) {
+      AppendLittleEndian32(checksum_, output);
+      AppendLittleEndian32(static_cast<uint32_t>(total_size_), output);
+    } else {
+      AppendBigEndian32(checksum_, output);
+    }
+  }
+  return true;
+}
+
+}  // namespace crashpad
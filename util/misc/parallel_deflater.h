@@ -0,0 +1,99 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_UTIL_MISC_PARALLEL_DEFLATER_H_
+#define CRASHPAD_UTIL_MISC_PARALLEL_DEFLATER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+namespace crashpad {
+
+//! \brief Compresses data with deflate on several threads, producing a single
+//!     zlib or `gzip` stream.
+//!
+//! Data is split into blocks of kBlockSize bytes, which are compressed
+//! independently, up to one per thread at a time, and then joined in order.
+//! Each block is primed with the 32 kB of data preceding it, so that matches
+//! can still reach back across block boundaries, and all but the last block
+//! end on a byte boundary so that they can be concatenated. The checksums of
+//! the blocks are combined into the checksum of the whole stream. The result
+//! is a standard stream that any zlib or `gzip` decompressor can read,
+//! slightly larger than one compressed on a single thread.
+class ParallelDeflater {
+ public:
+  //! \brief The wrapper placed around the deflate data.
+  enum class Format {
+    //! \brief The zlib wrapper, as produced by `deflateInit()`.
+    kZlib,
+
+    //! \brief The `gzip` wrapper.
+    kGzip,
+  };
+
+  //! \brief The amount of data compressed as a unit on one thread.
+  static constexpr size_t kBlockSize = 128 * 1024;
+
+  //! \param[in] format The wrapper to produce.
+  //! \param[in] level The zlib compression level, such as
+  //!     `Z_DEFAULT_COMPRESSION`.
+  //! \param[in] threads The maximum number of threads to compress on,
+  //!     including the calling thread. This must be at least `1`.
+  ParallelDeflater(Format format, int level, unsigned int threads);
+
+  ParallelDeflater(const ParallelDeflater&) = delete;
+  ParallelDeflater& operator=(const ParallelDeflater&) = delete;
+
+  ~ParallelDeflater();
+
+  //! \brief The amount of input that keeps every thread busy for one call to
+  //!     Compress().
+  size_t BatchSize() const { return kBlockSize * threads_; }
+
+  //! \brief Compresses more data.
+  //!
+  //! Data may be supplied in pieces of any size, but pieces smaller than
+  //! BatchSize() leave threads idle and end blocks early, at some cost to the
+  //! compression ratio.
+  //!
+  //! \param[in] data The data to compress.
+  //! \param[in] size The size of \a data.
+  //! \param[in] finish Whether \a data ends the stream. When `true`, the
+  //!     stream’s trailer is produced, and this object may not be used again.
+  //! \param[out] output The compressed data, appended to what it already
+  //!     contains. This begins with the stream’s header on the first call.
+  //!
+  //! \return `true` on success. `false` on failure, with a message logged.
+  bool Compress(const uint8_t* data,
+                size_t size,
+                bool finish,
+                std::vector<uint8_t>* output);
+
+ private:
+  // Up to the last 32 kB of data passed to Compress().
+  std::vector<uint8_t> dictionary_;
+  const Format format_;
+  const int level_;
+  const unsigned int threads_;
+  uint32_t checksum_;
+  uint64_t total_size_;
+  bool started_;
+  bool finished_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_UTIL_MISC_PARALLEL_DEFLATER_H_
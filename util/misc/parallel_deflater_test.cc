@@ -0,0 +1,141 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/misc/parallel_deflater.h"
+
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "third_party/zlib/zlib_crashpad.h"
+#include "util/misc/zlib.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+// Data that compresses, with repeats both within and across blocks.
+std::vector<uint8_t> TestData(size_t size) {
+  std::vector<uint8_t> data(size);
+  uint32_t state = 1;
+  for (size_t index = 0; index < size; ++index) {
+    if (index >= 1000 && index % 5000 < 2000) {
+      data[index] = data[index - 1000];
+    } else {
+      state = state * 1103515245 + 12345;
+      data[index] = static_cast<uint8_t>('a' + (state >> 16) % 16);
+    }
+  }
+  return data;
+}
+
+std::vector<uint8_t> Inflate(const std::vector<uint8_t>& compressed,
+                             int window_bits) {
+  z_stream stream = {};
+  EXPECT_EQ(inflateInit2(&stream, window_bits), Z_OK);
+  std::vector<uint8_t> output;
+  stream.next_in = const_cast<uint8_t*>(compressed.data());
+  stream.avail_in = static_cast<uInt>(compressed.size());
+  int zr;
+  do {
+    uint8_t buffer[4096];
+    stream.next_out = buffer;
+    stream.avail_out = sizeof(buffer);
+    zr = inflate(&stream, Z_NO_FLUSH);
+    output.insert(output.end(), buffer, stream.next_out);
+  } while (zr == Z_OK);
+  EXPECT_EQ(zr, Z_STREAM_END) << ZlibErrorString(zr);
+  EXPECT_EQ(stream.avail_in, 0u);
+  EXPECT_EQ(inflateEnd(&stream), Z_OK);
+  return output;
+}
+
+void TestRoundTrip(ParallelDeflater::Format format,
+                   int level,
+                   unsigned int threads,
+                   size_t size,
+                   size_t piece_size) {
+  SCOPED_TRACE(testing::Message() << "threads " << threads << ", size "
+                                  << size << ", piece size " << piece_size);
+  const std::vector<uint8_t> data = TestData(size);
+  ParallelDeflater deflater(format, level, threads);
+  std::vector<uint8_t> compressed;
+  size_t offset = 0;
+  do {
+    const size_t piece = std::min(piece_size, size - offset);
+    ASSERT_TRUE(deflater.Compress(
+        data.data() + offset, piece, offset + piece == size, &compressed));
+    offset += piece;
+  } while (offset < size);
+
+  const int window_bits = format == ParallelDeflater::Format::kGzip
+                              ? ZlibWindowBitsWithGzipWrapper(15)
+                              : 15;
+  EXPECT_EQ(Inflate(compressed, window_bits), data);
+  if (size > 0) {
+    EXPECT_LT(compressed.size(), size);
+  }
+}
+
+TEST(ParallelDeflater, Gzip) {
+  constexpr size_t kBlockSize = ParallelDeflater::kBlockSize;
+  for (unsigned int threads : {1, 4}) {
+    TestRoundTrip(ParallelDeflater::Format::kGzip,
+                  Z_DEFAULT_COMPRESSION,
+                  threads,
+                  0,
+                  1);
+    TestRoundTrip(ParallelDeflater::Format::kGzip,
+                  Z_DEFAULT_COMPRESSION,
+                  threads,
+                  100,
+                  100);
+    TestRoundTrip(ParallelDeflater::Format::kGzip,
+                  Z_DEFAULT_COMPRESSION,
+                  threads,
+                  kBlockSize * 9 + 1234,
+                  kBlockSize * threads);
+    TestRoundTrip(ParallelDeflater::Format::kGzip,
+                  1,
+                  threads,
+                  kBlockSize * 3,
+                  kBlockSize * 3);
+    TestRoundTrip(ParallelDeflater::Format::kGzip,
+                  Z_DEFAULT_COMPRESSION,
+                  threads,
+                  kBlockSize * 2 + 5000,
+                  10000);
+  }
+}
+
+TEST(ParallelDeflater, Zlib) {
+  constexpr size_t kBlockSize = ParallelDeflater::kBlockSize;
+  for (int level : {1, 5, Z_DEFAULT_COMPRESSION, Z_BEST_COMPRESSION}) {
+    SCOPED_TRACE(testing::Message() << "level " << level);
+    TestRoundTrip(ParallelDeflater::Format::kZlib, level, 3, 0, 1);
+    TestRoundTrip(ParallelDeflater::Format::kZlib,
+                  level,
+                  3,
+                  kBlockSize * 7 + 99,
+                  kBlockSize * 3);
+    TestRoundTrip(
+        ParallelDeflater::Format::kZlib, level, 3, kBlockSize + 1, 4096);
+  }
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
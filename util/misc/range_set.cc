@@ -16,8 +16,40 @@
 
 #include <algorithm>
 
+#include "base/check_op.h"
+
 namespace crashpad {
 
+namespace {
+
+// Fills the subtree of tree rooted at index, in Eytzinger order, from sorted.
+// *next is the index in sorted of the next range to place.
+template <typename Range>
+void FillEytzinger(const std::vector<Range>& sorted,
+                   std::vector<Range>* tree,
+                   size_t index,
+                   size_t* next) {
+  if (index >= tree->size()) {
+    return;
+  }
+  FillEytzinger(sorted, tree, 2 * index, next);
+  (*tree)[index] = sorted[(*next)++];
+  FillEytzinger(sorted, tree, 2 * index + 1, next);
+}
+
+// The number of steps from the root of an Eytzinger tree of count items to its
+// deepest leaf.
+size_t EytzingerDepth(size_t count) {
+  size_t depth = 0;
+  while (count) {
+    count >>= 1;
+    ++depth;
+  }
+  return depth;
+}
+
+}  // namespace
+
 RangeSet::RangeSet() = default;
 
 RangeSet::~RangeSet() = default;
@@ -27,29 +59,116 @@ void RangeSet::Insert(VMAddress base, VMSize size) {
     return;
   }
 
+  eytzinger_.clear();
+
   VMAddress last = base + size - 1;
 
-  auto overlapping_range = ranges_.lower_bound(base);
-#define OVERLAPPING_RANGES_BASE overlapping_range->second
-#define OVERLAPPING_RANGES_LAST overlapping_range->first
-  while (overlapping_range != ranges_.end() &&
-         OVERLAPPING_RANGES_BASE <= last) {
-    base = std::min(base, OVERLAPPING_RANGES_BASE);
-    last = std::max(last, OVERLAPPING_RANGES_LAST);
-    auto tmp = overlapping_range;
-    ++overlapping_range;
-    ranges_.erase(tmp);
+  // Ranges from first to the end of the set end at or above base. Those from
+  // first up to end also begin at or below last, so they overlap the new range.
+  auto first = std::lower_bound(
+      ranges_.begin(),
+      ranges_.end(),
+      base,
+      [](const Range& range, VMAddress a) { return range.last < a; });
+  auto end = first;
+  while (end != ranges_.end() && end->base <= last) {
+    base = std::min(base, end->base);
+    last = std::max(last, end->last);
+    ++end;
+  }
+
+  if (first == end) {
+    ranges_.insert(first, Range{base, last});
+  } else {
+    first->base = base;
+    first->last = last;
+    ranges_.erase(first + 1, end);
   }
-#undef OVERLAPPING_RANGES_BASE
-#undef OVERLAPPING_RANGES_LAST
+}
 
-  ranges_[last] = base;
+void RangeSet::Freeze() {
+  eytzinger_.resize(ranges_.size() + 1);
+  size_t next = 0;
+  FillEytzinger(ranges_, &eytzinger_, 1, &next);
 }
 
 bool RangeSet::Contains(VMAddress address) const {
-  auto range_above_address = ranges_.lower_bound(address);
+  if (!eytzinger_.empty()) {
+    return ContainsMany(&address, 1) != 0;
+  }
+
+  auto range_above_address = std::lower_bound(
+      ranges_.begin(),
+      ranges_.end(),
+      address,
+      [](const Range& range, VMAddress a) { return range.last < a; });
   return range_above_address != ranges_.end() &&
-         range_above_address->second <= address;
+         range_above_address->base <= address;
+}
+
+uint64_t RangeSet::ContainsMany(const uint32_t* addresses,
+                                size_t count) const {
+  return ContainsManyImpl(addresses, count);
+}
+
+uint64_t RangeSet::ContainsMany(const uint64_t* addresses,
+                                size_t count) const {
+  return ContainsManyImpl(addresses, count);
+}
+
+template <typename T>
+uint64_t RangeSet::ContainsManyImpl(const T* addresses, size_t count) const {
+  DCHECK_LE(count, kMaxContainsMany);
+
+  uint64_t mask = 0;
+  if (eytzinger_.empty()) {
+    for (size_t index = 0; index < count; ++index) {
+      mask |= static_cast<uint64_t>(Contains(addresses[index])) << index;
+    }
+    return mask;
+  }
+
+  // Each search steps down one level of the tree at a time, to the right when
+  // the range there ends below the address, until it falls off the bottom. The
+  // searches are interleaved so that their memory accesses overlap, and every
+  // step is taken for every search, one that has already finished staying put.
+  const size_t size = eytzinger_.size() - 1;
+  const size_t depth = EytzingerDepth(size);
+  size_t nodes[kMaxContainsMany];
+  std::fill(nodes, nodes + count, 1);
+  for (size_t level = 0; level < depth; ++level) {
+    for (size_t index = 0; index < count; ++index) {
+      const size_t node = nodes[index];
+      const bool right =
+          eytzinger_[std::min(node, size)].last < addresses[index];
+      nodes[index] = node <= size ? 2 * node + right : node;
+    }
+  }
+
+  for (size_t index = 0; index < count; ++index) {
+    // The lowest range ending at or above the address is where the search last
+    // went left. Undo the steps to the right after that, and that one.
+    size_t node = nodes[index];
+    while (node & 1) {
+      node >>= 1;
+    }
+    node >>= 1;
+
+    // If the search never went left, every range ends below the address.
+    mask |= static_cast<uint64_t>(node != 0 &&
+                                  eytzinger_[node].base <= addresses[index])
+            << index;
+  }
+  return mask;
+}
+
+bool RangeSet::Bounds(VMAddress* lowest, VMAddress* highest) const {
+  if (ranges_.empty()) {
+    return false;
+  }
+  *lowest = ranges_.front().base;
+  *highest = ranges_.back().last;
+  return true;
 }
 
 }  // namespace crashpad
@@ -15,15 +15,26 @@
 #ifndef CRASHPAD_UTIL_MISC_RANGE_SET_H_
 #define CRASHPAD_UTIL_MISC_RANGE_SET_H_
 
-#include <map>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
 
 #include "util/misc/address_types.h"
 
 namespace crashpad {
 
 //! \brief A set of VMAddress ranges.
+//!
+//! A set is typically built by several calls to Insert() and then searched
+//! many times. Once the set is complete, Freeze() rearranges it for faster
+//! searches.
 class RangeSet {
  public:
+  //! \brief The largest number of addresses that ContainsMany() accepts at
+  //!     once.
+  static constexpr size_t kMaxContainsMany = 64;
+
   RangeSet();
 
   RangeSet(const RangeSet&) = delete;
@@ -35,16 +46,62 @@ class RangeSet {
   //!
   //! \param[in] base The low address of the range.
   //! \param[in] size The size of the range.
+  //!
+  //! This undoes any earlier call to Freeze().
   void Insert(VMAddress base, VMSize size);
 
+  //! \brief Arranges the ranges in this set for faster searches by Contains()
+  //!     and ContainsMany().
+  //!
+  //! This should be called once all ranges have been inserted.
+  void Freeze();
+
   //! \brief Returns `true` if \a address falls within a range in this set.
   bool Contains(VMAddress address) const;
 
+  //! \brief Determines which of several addresses fall within a range in this
+  //!     set.
+  //!
+  //! This searches for all of the addresses at once, which is faster than
+  //! calling Contains() for each of them in turn once the set is frozen.
+  //!
+  //! \param[in] addresses The addresses to search for.
+  //! \param[in] count The number of addresses, at most kMaxContainsMany.
+  //!
+  //! \return A mask with bit `n` set if `addresses[n]` falls within a range in
+  //!     this set.
+  uint64_t ContainsMany(const uint32_t* addresses, size_t count) const;
+  uint64_t ContainsMany(const uint64_t* addresses, size_t count) const;
+
+  //! \brief Returns the lowest and highest addresses within any range in this
+  //!     set.
+  //!
+  //! Addresses outside of [\a lowest, \a highest] are not contained in the set,
+  //! so callers checking many addresses can rule those out without calling
+  //! Contains().
+  //!
+  //! \return `true` on success, or `false` if the set is empty.
+  bool Bounds(VMAddress* lowest, VMAddress* highest) const;
+
  private:
-  // Keys are the highest address in the range. Values are the base address of
-  // the range. Overlapping ranges are merged on insertion. Adjacent ranges may
-  // be merged.
-  std::map<VMAddress, VMAddress> ranges_;
+  struct Range {
+    VMAddress base;
+    VMAddress last;
+  };
+
+  template <typename T>
+  uint64_t ContainsManyImpl(const T* addresses, size_t count) const;
+
+  // Sorted by address. Overlapping ranges are merged on insertion. Adjacent
+  // ranges may be merged. Sets are built once and then searched many times, so
+  // this is kept flat rather than as a tree.
+  std::vector<Range> ranges_;
+
+  // Once frozen, ranges_ in Eytzinger order: the children of the range at index
+  // k are at 2k and 2k + 1, and index 0 is unused. A search walks down from
+  // index 1 without branching on the comparisons, and the ranges it looks at
+  // first share cache lines. Empty when not frozen.
+  std::vector<Range> eytzinger_;
 };
 
 }  // namespace crashpad
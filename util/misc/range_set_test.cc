@@ -16,6 +16,8 @@
 
 #include <sys/types.h>
 
+#include <iterator>
+#include <limits>
 #include <memory>
 
 #include "base/format_macros.h"
@@ -111,6 +113,89 @@ TEST(RangeSet, LargeOverlappingRanges) {
   EXPECT_TRUE(ranges.Contains(addr + kBufferSize - 1));
 }
 
+TEST(RangeSet, Bounds) {
+  RangeSet ranges;
+  VMAddress lowest, highest;
+  EXPECT_FALSE(ranges.Bounds(&lowest, &highest));
+
+  ranges.Insert(37, 16);
+  ASSERT_TRUE(ranges.Bounds(&lowest, &highest));
+  EXPECT_EQ(lowest, 37u);
+  EXPECT_EQ(highest, 52u);
+
+  ranges.Insert(100, 1);
+  ranges.Insert(9, 9);
+  ASSERT_TRUE(ranges.Bounds(&lowest, &highest));
+  EXPECT_EQ(lowest, 9u);
+  EXPECT_EQ(highest, 100u);
+  EXPECT_FALSE(ranges.Contains(18));
+  EXPECT_FALSE(ranges.Contains(99));
+}
+
+TEST(RangeSet, Freeze) {
+  RangeSet ranges;
+  ranges.Freeze();
+  EXPECT_FALSE(ranges.Contains(0));
+
+  for (VMAddress base = 100; base < 1000; base += 100) {
+    ranges.Insert(base, 10);
+  }
+  ranges.Insert(std::numeric_limits<VMAddress>::max() - 9, 10);
+
+  for (int frozen = 0; frozen < 2; ++frozen) {
+    SCOPED_TRACE(frozen);
+    if (frozen) {
+      ranges.Freeze();
+    }
+
+    for (VMAddress address = 0; address < 1100; ++address) {
+      SCOPED_TRACE(address);
+      EXPECT_EQ(ranges.Contains(address),
+                address >= 100 && address < 1000 && address % 100 < 10);
+    }
+    EXPECT_TRUE(ranges.Contains(std::numeric_limits<VMAddress>::max()));
+    EXPECT_TRUE(ranges.Contains(std::numeric_limits<VMAddress>::max() - 9));
+    EXPECT_FALSE(ranges.Contains(std::numeric_limits<VMAddress>::max() - 10));
+  }
+
+  // Inserting a range after freezing the set must still find it.
+  ranges.Insert(2000, 10);
+  EXPECT_TRUE(ranges.Contains(2005));
+  EXPECT_TRUE(ranges.Contains(105));
+}
+
+TEST(RangeSet, ContainsMany) {
+  RangeSet ranges;
+  ranges.Insert(0x1000, 0x100);
+  ranges.Insert(0x3000, 0x100);
+  ranges.Insert(0x100000000, 0x100);
+
+  const uint64_t addresses64[] = {
+      0, 0xfff, 0x1000, 0x10ff, 0x1100, 0x3080, 0x100000080, 0x200000000};
+  const uint32_t addresses32[] = {0, 0xfff, 0x1000, 0x10ff, 0x1100, 0x3080};
+  constexpr uint64_t kExpected64 = 0b01101100;
+  constexpr uint64_t kExpected32 = 0b101100;
+
+  EXPECT_EQ(ranges.ContainsMany(addresses64, 0), 0u);
+  EXPECT_EQ(ranges.ContainsMany(addresses64, std::size(addresses64)),
+            kExpected64);
+  EXPECT_EQ(ranges.ContainsMany(addresses32, std::size(addresses32)),
+            kExpected32);
+
+  ranges.Freeze();
+  EXPECT_EQ(ranges.ContainsMany(addresses64, 0), 0u);
+  EXPECT_EQ(ranges.ContainsMany(addresses64, std::size(addresses64)),
+            kExpected64);
+  EXPECT_EQ(ranges.ContainsMany(addresses32, std::size(addresses32)),
+            kExpected32);
+
+  uint64_t many[RangeSet::kMaxContainsMany];
+  for (size_t index = 0; index < std::size(many); ++index) {
+    many[index] = 0x1000 + index * 8;
+  }
+  EXPECT_EQ(ranges.ContainsMany(many, std::size(many)), 0xffffffffu);
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace crashpad
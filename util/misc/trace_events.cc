@@ -0,0 +1,198 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/misc/trace_events.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+
+#include <atomic>
+#include <memory>
+#include <string>
+
+#include "base/logging.h"
+#include "base/strings/stringprintf.h"
+#include "base/synchronization/lock.h"
+#include "build/build_config.h"
+#include "util/file/file_io.h"
+#include "util/misc/clock.h"
+
+#if BUILDFLAG(IS_POSIX)
+#include <unistd.h>
+#endif  // BUILDFLAG(IS_POSIX)
+
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+#include <sys/syscall.h>
+#elif BUILDFLAG(IS_APPLE)
+#include <pthread.h>
+#elif BUILDFLAG(IS_WIN)
+#include <windows.h>
+#endif
+
+namespace crashpad {
+
+namespace {
+
+struct TraceSink {
+  ScopedFileHandle file;
+  base::Lock lock;
+  uint64_t process_id;
+};
+
+std::atomic<TraceSink*> g_sink;
+
+thread_local TraceEvents::ScopedContext* g_context;
+
+uint64_t CurrentProcessID() {
+#if BUILDFLAG(IS_WIN)
+  return GetCurrentProcessId();
+#else
+  return static_cast<uint64_t>(getpid());
+#endif  // BUILDFLAG(IS_WIN)
+}
+
+uint64_t CurrentThreadID() {
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+  return static_cast<uint64_t>(syscall(SYS_gettid));
+#elif BUILDFLAG(IS_APPLE)
+  uint64_t thread_id;
+  pthread_threadid_np(pthread_self(), &thread_id);
+  return thread_id;
+#elif BUILDFLAG(IS_WIN)
+  return GetCurrentThreadId();
+#else
+  // Trace viewers only need thread IDs to be distinct.
+  static std::atomic<uint64_t> next_thread_id(1);
+  thread_local uint64_t thread_id = next_thread_id++;
+  return thread_id;
+#endif
+}
+
+bool WriteString(TraceSink* sink, const std::string& string) {
+  base::AutoLock lock(sink->lock);
+  return LoggingWriteFile(sink->file.get(), string.data(), string.size());
+}
+
+}  // namespace
+
+// static
+bool TraceEvents::StartWritingToFile(const base::FilePath& path) {
+  DCHECK(!IsEnabled());
+
+  auto sink = std::make_unique<TraceSink>();
+  sink->file.reset(LoggingOpenFileForWrite(
+      path, FileWriteMode::kReuseOrCreate, FilePermissions::kOwnerOnly));
+  if (!sink->file.is_valid()) {
+    return false;
+  }
+  const FileOffset offset = LoggingSeekFile(sink->file.get(), 0, SEEK_END);
+  if (offset < 0) {
+    return false;
+  }
+  sink->process_id = CurrentProcessID();
+
+  std::string start(offset == 0 ? "[\n" : "");
+  start += base::StringPrintf(
+      "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%" PRIu64
+      ",\"args\":{\"name\":\"crashpad_handler\"}},\n",
+      sink->process_id);
+  if (!WriteString(sink.get(), start)) {
+    return false;
+  }
+
+  g_sink.store(sink.release(), std::memory_order_release);
+  return true;
+}
+
+// static
+void TraceEvents::StopWritingForTesting() {
+  delete g_sink.exchange(nullptr, std::memory_order_acq_rel);
+}
+
+// static
+bool TraceEvents::IsEnabled() {
+  return g_sink.load(std::memory_order_acquire) != nullptr;
+}
+
+// static
+void TraceEvents::AddEvent(const char* name,
+                           uint64_t start_ns,
+                           uint64_t end_ns) {
+  TraceSink* sink = g_sink.load(std::memory_order_acquire);
+  if (!sink) {
+    return;
+  }
+
+  std::string args;
+  const ScopedContext* context = g_context;
+  if (context && context->client_process_id_ != kInvalidProcessID) {
+    args += base::StringPrintf(
+        "\"client_pid\":%" PRIu64,
+        static_cast<uint64_t>(context->client_process_id_));
+  }
+  if (context && context->has_report_id_) {
+    if (!args.empty()) {
+      args.push_back(',');
+    }
+    args += "\"report_uuid\":\"" + context->report_id_.ToString() + "\"";
+  }
+
+  // Timestamps are in microseconds.
+  WriteString(sink,
+              base::StringPrintf("{\"name\":\"%s\",\"cat\":\"crashpad\","
+                                 "\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,"
+                                 "\"pid\":%" PRIu64 ",\"tid\":%" PRIu64
+                                 ",\"args\":{%s}},\n",
+                                 name,
+                                 start_ns / 1e3,
+                                 (end_ns - start_ns) / 1e3,
+                                 sink->process_id,
+                                 CurrentThreadID(),
+                                 args.c_str()));
+}
+
+// static
+void TraceEvents::SetReportID(const UUID& report_id) {
+  if (g_context) {
+    g_context->report_id_ = report_id;
+    g_context->has_report_id_ = true;
+  }
+}
+
+TraceEvents::ScopedContext::ScopedContext()
+    : ScopedContext(kInvalidProcessID) {}
+
+TraceEvents::ScopedContext::ScopedContext(ProcessID client_process_id)
+    : report_id_(),
+      previous_(g_context),
+      client_process_id_(client_process_id),
+      has_report_id_(false) {
+  g_context = this;
+}
+
+TraceEvents::ScopedContext::~ScopedContext() {
+  DCHECK_EQ(g_context, this);
+  g_context = previous_;
+}
+
+TraceEvents::ScopedEvent::ScopedEvent(const char* name)
+    : name_(name), start_ns_(IsEnabled() ? ClockMonotonicNanoseconds() : 0) {}
+
+TraceEvents::ScopedEvent::~ScopedEvent() {
+  if (start_ns_) {
+    AddEvent(name_, start_ns_, ClockMonotonicNanoseconds());
+  }
+}
+
+}  // namespace crashpad
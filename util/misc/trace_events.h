@@ -0,0 +1,121 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_UTIL_MISC_TRACE_EVENTS_H_
+#define CRASHPAD_UTIL_MISC_TRACE_EVENTS_H_
+
+#include <stdint.h>
+
+#include "base/files/file_path.h"
+#include "util/misc/uuid.h"
+#include "util/process/process_id.h"
+
+namespace crashpad {
+
+//! \brief Writes trace events for the phases of handling exceptions and crash
+//!     reports, to show where the time taken by a dump goes.
+//!
+//! Events are written in the Chrome JSON trace event format, which can be
+//! opened by Perfetto and by `chrome://tracing`. Each event is a complete
+//! (`"ph":"X"`) event written when its phase ends, with the client process ID
+//! and report UUID from the thread’s ScopedContext as arguments. The file is
+//! a JSON array that is never closed, which both viewers accept, so that a
+//! trace remains usable when the handler exits without warning. Events are
+//! appended to an existing file, so that a handler that is restarted continues
+//! the same trace with its new process ID.
+//!
+//! Tracing is disabled until StartWritingToFile() is called, and costs next to
+//! nothing while disabled.
+class TraceEvents {
+ public:
+  TraceEvents() = delete;
+  TraceEvents(const TraceEvents&) = delete;
+  TraceEvents& operator=(const TraceEvents&) = delete;
+
+  //! \brief Begins writing trace events to the file at \a path.
+  //!
+  //! This may only be called once in a process.
+  //!
+  //! \return `true` on success, or `false` with a message logged if the file
+  //!     couldn’t be opened, in which case tracing remains disabled.
+  static bool StartWritingToFile(const base::FilePath& path);
+
+  //! \brief Stops writing trace events and closes the file.
+  //!
+  //! This must not be called while another thread may be writing an event.
+  static void StopWritingForTesting();
+
+  //! \return `true` if trace events are being written.
+  static bool IsEnabled();
+
+  //! \brief Writes an event named \a name that began at \a start_ns and ended
+  //!     at \a end_ns, as measured by ClockMonotonicNanoseconds().
+  //!
+  //! \a name must be a string that doesn’t need to be escaped in JSON.
+  static void AddEvent(const char* name, uint64_t start_ns, uint64_t end_ns);
+
+  //! \brief Sets the report UUID given as an argument to trace events written
+  //!     by this thread until the innermost ScopedContext is destroyed.
+  //!
+  //! This does nothing if this thread has no ScopedContext.
+  static void SetReportID(const UUID& report_id);
+
+  //! \brief Sets the arguments given to trace events written by this thread for
+  //!     the lifetime of this object.
+  //!
+  //! Contexts nest. The previous context is restored when this object is
+  //! destroyed.
+  class ScopedContext {
+   public:
+    //! \brief Sets a context with no client process.
+    ScopedContext();
+
+    //! \brief Sets a context for the client process \a client_process_id.
+    explicit ScopedContext(ProcessID client_process_id);
+
+    ScopedContext(const ScopedContext&) = delete;
+    ScopedContext& operator=(const ScopedContext&) = delete;
+
+    ~ScopedContext();
+
+   private:
+    friend class TraceEvents;
+
+    UUID report_id_;
+    ScopedContext* previous_;
+    ProcessID client_process_id_;
+    bool has_report_id_;
+  };
+
+  //! \brief Writes an event for the lifetime of this object.
+  class ScopedEvent {
+   public:
+    //! \param[in] name The name of the event. It must outlive this object and
+    //!     be a string that doesn’t need to be escaped in JSON.
+    explicit ScopedEvent(const char* name);
+
+    ScopedEvent(const ScopedEvent&) = delete;
+    ScopedEvent& operator=(const ScopedEvent&) = delete;
+
+    ~ScopedEvent();
+
+   private:
+    const char* name_;
+    uint64_t start_ns_;
+  };
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_UTIL_MISC_TRACE_EVENTS_H_
@@ -0,0 +1,120 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/misc/trace_events.h"
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "test/scoped_temp_dir.h"
+#include "util/file/file_io.h"
+#include "util/misc/metrics.h"
+#include "util/string/split_string.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+// Returns the lines of the trace that contain |needle|.
+std::vector<std::string> FindLines(const std::string& trace,
+                                   const std::string& needle) {
+  std::vector<std::string> lines;
+  for (const std::string& line : SplitString(trace, '\n')) {
+    if (line.find(needle) != std::string::npos) {
+      lines.push_back(line);
+    }
+  }
+  return lines;
+}
+
+TEST(TraceEvents, WriteToFile) {
+  EXPECT_FALSE(TraceEvents::IsEnabled());
+  {
+    // Nothing is recorded while tracing is disabled.
+    TraceEvents::ScopedEvent event("Disabled");
+  }
+
+  ScopedTempDir temp_dir;
+  const base::FilePath path(temp_dir.path().Append(FILE_PATH_LITERAL("trace")));
+  ASSERT_TRUE(TraceEvents::StartWritingToFile(path));
+  EXPECT_TRUE(TraceEvents::IsEnabled());
+
+  UUID report_id;
+  ASSERT_TRUE(report_id.InitializeFromString(
+      "00112233-4455-6677-8899-aabbccddeeff"));
+  {
+    TraceEvents::ScopedEvent event("NoContext");
+  }
+  {
+    TraceEvents::ScopedContext context(1234);
+    {
+      TraceEvents::ScopedEvent event("Client");
+    }
+    TraceEvents::SetReportID(report_id);
+    {
+      Metrics::ScopedOperationTimer timer(Metrics::TimedOperation::kPrune);
+    }
+    {
+      TraceEvents::ScopedContext inner_context;
+      TraceEvents::ScopedEvent event("Inner");
+    }
+  }
+  TraceEvents::StopWritingForTesting();
+  EXPECT_FALSE(TraceEvents::IsEnabled());
+
+  std::string trace;
+  ASSERT_TRUE(LoggingReadEntireFile(path, &trace));
+  EXPECT_EQ(trace.substr(0, 2), "[\n");
+  EXPECT_EQ(FindLines(trace, "\"process_name\"").size(), 1u);
+  EXPECT_TRUE(FindLines(trace, "\"Disabled\"").empty());
+
+  std::vector<std::string> lines = FindLines(trace, "\"NoContext\"");
+  ASSERT_EQ(lines.size(), 1u);
+  EXPECT_NE(lines[0].find("\"ph\":\"X\""), std::string::npos);
+  EXPECT_NE(lines[0].find("\"args\":{}"), std::string::npos);
+
+  lines = FindLines(trace, "\"Client\"");
+  ASSERT_EQ(lines.size(), 1u);
+  EXPECT_NE(lines[0].find("\"args\":{\"client_pid\":1234}"), std::string::npos);
+
+  lines = FindLines(trace, "\"Prune\"");
+  ASSERT_EQ(lines.size(), 1u);
+  EXPECT_NE(lines[0].find("\"args\":{\"client_pid\":1234,\"report_uuid\":"
+                          "\"00112233-4455-6677-8899-aabbccddeeff\"}"),
+            std::string::npos);
+
+  // An inner context replaces the outer one’s arguments.
+  lines = FindLines(trace, "\"Inner\"");
+  ASSERT_EQ(lines.size(), 1u);
+  EXPECT_NE(lines[0].find("\"args\":{}"), std::string::npos);
+
+  // Writing again continues the same trace.
+  ASSERT_TRUE(TraceEvents::StartWritingToFile(path));
+  {
+    TraceEvents::ScopedEvent event("Again");
+  }
+  TraceEvents::StopWritingForTesting();
+
+  std::string continued_trace;
+  ASSERT_TRUE(LoggingReadEntireFile(path, &continued_trace));
+  EXPECT_EQ(continued_trace.substr(0, trace.size()), trace);
+  EXPECT_EQ(FindLines(continued_trace, "[").size(), 1u);
+  EXPECT_EQ(FindLines(continued_trace, "\"process_name\"").size(), 2u);
+  EXPECT_EQ(FindLines(continued_trace, "\"Again\"").size(), 1u);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
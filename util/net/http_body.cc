@@ -14,16 +14,28 @@
 
 #include "util/net/http_body.h"
 
+#include <stdio.h>
 #include <string.h>
 
 #include <algorithm>
 #include <limits>
 
 #include "base/check.h"
+#include "base/check_op.h"
 #include "util/misc/implicit_cast.h"
 
 namespace crashpad {
 
+bool HTTPBodyStream::GetBytesInPlace(const uint8_t** data,
+                                     size_t max_len,
+                                     size_t* size) {
+  return false;
+}
+
+bool HTTPBodyStream::GetRemainingSize(uint64_t* size) {
+  return false;
+}
+
 StringHTTPBodyStream::StringHTTPBodyStream(const std::string& string)
     : HTTPBodyStream(), string_(string), bytes_read_() {
 }
@@ -46,6 +58,20 @@ FileOperationResult StringHTTPBodyStream::GetBytesBuffer(uint8_t* buffer,
   return num_bytes_returned;
 }
 
+bool StringHTTPBodyStream::GetBytesInPlace(const uint8_t** data,
+                                           size_t max_len,
+                                           size_t* size) {
+  *data = reinterpret_cast<const uint8_t*>(string_.data()) + bytes_read_;
+  *size = std::min(max_len, string_.length() - bytes_read_);
+  bytes_read_ += *size;
+  return true;
+}
+
+bool StringHTTPBodyStream::GetRemainingSize(uint64_t* size) {
+  *size = string_.length() - bytes_read_;
+  return true;
+}
+
 FileReaderHTTPBodyStream::FileReaderHTTPBodyStream(FileReaderInterface* reader)
     : HTTPBodyStream(), reader_(reader), reached_eof_(false) {
   DCHECK(reader_);
@@ -66,6 +92,91 @@ FileOperationResult FileReaderHTTPBodyStream::GetBytesBuffer(uint8_t* buffer,
   return rv;
 }
 
+bool FileReaderHTTPBodyStream::GetRemainingSize(uint64_t* size) {
+  if (reached_eof_) {
+    *size = 0;
+    return true;
+  }
+
+  FileOffset position = reader_->Seek(0, SEEK_CUR);
+  if (position < 0) {
+    return false;
+  }
+  FileOffset end = reader_->Seek(0, SEEK_END);
+  if (end < 0 || !reader_->SeekSet(position)) {
+    return false;
+  }
+
+  *size = end > position ? end - position : 0;
+  return true;
+}
+
+ChunkedStringFileHTTPBodyStream::ChunkedStringFileHTTPBodyStream(
+    const ChunkedStringFile* file)
+    : HTTPBodyStream(), file_(file), bytes_read_(0) {
+  DCHECK(file_);
+}
+
+ChunkedStringFileHTTPBodyStream::~ChunkedStringFileHTTPBodyStream() {}
+
+FileOperationResult ChunkedStringFileHTTPBodyStream::GetBytesBuffer(
+    uint8_t* buffer,
+    size_t max_len) {
+  size_t num_bytes_returned = file_->ReadAt(
+      bytes_read_,
+      buffer,
+      std::min(max_len,
+               implicit_cast<size_t>(
+                   std::numeric_limits<FileOperationResult>::max())));
+  bytes_read_ += num_bytes_returned;
+  return num_bytes_returned;
+}
+
+bool ChunkedStringFileHTTPBodyStream::GetRemainingSize(uint64_t* size) {
+  *size = file_->size() > bytes_read_ ? file_->size() - bytes_read_ : 0;
+  return true;
+}
+
+MappedFileHTTPBodyStream::MappedFileHTTPBodyStream(
+    const MappedFileReader* file)
+    : HTTPBodyStream(), file_(file), bytes_read_(0) {
+  DCHECK(file_);
+}
+
+MappedFileHTTPBodyStream::~MappedFileHTTPBodyStream() {}
+
+FileOperationResult MappedFileHTTPBodyStream::GetBytesBuffer(uint8_t* buffer,
+                                                             size_t max_len) {
+  const uint8_t* data;
+  size_t num_bytes_returned;
+  GetBytesInPlace(
+      &data,
+      std::min(max_len,
+               implicit_cast<size_t>(
+                   std::numeric_limits<FileOperationResult>::max())),
+      &num_bytes_returned);
+  if (num_bytes_returned) {
+    memcpy(buffer, data, num_bytes_returned);
+  }
+  return num_bytes_returned;
+}
+
+bool MappedFileHTTPBodyStream::GetBytesInPlace(const uint8_t** data,
+                                               size_t max_len,
+                                               size_t* size) {
+  DCHECK_LE(bytes_read_, file_->size());
+  *data = file_->data() + bytes_read_;
+  *size = std::min(max_len, file_->size() - bytes_read_);
+  bytes_read_ += *size;
+  return true;
+}
+
+bool MappedFileHTTPBodyStream::GetRemainingSize(uint64_t* size) {
+  DCHECK_LE(bytes_read_, file_->size());
+  *size = file_->size() - bytes_read_;
+  return true;
+}
+
 CompositeHTTPBodyStream::CompositeHTTPBodyStream(
     const CompositeHTTPBodyStream::PartsList& parts)
     : HTTPBodyStream(), parts_(parts), current_part_(parts_.begin()) {
@@ -100,4 +211,36 @@ FileOperationResult CompositeHTTPBodyStream::GetBytesBuffer(uint8_t* buffer,
   return bytes_copied;
 }
 
+bool CompositeHTTPBodyStream::GetBytesInPlace(const uint8_t** data,
+                                              size_t max_len,
+                                              size_t* size) {
+  while (current_part_ != parts_.end()) {
+    if (!(*current_part_)->GetBytesInPlace(data, max_len, size)) {
+      return false;
+    }
+    if (*size != 0) {
+      return true;
+    }
+
+    // The current part is at EOF, so move on to the next one.
+    ++current_part_;
+  }
+
+  *size = 0;
+  return true;
+}
+
+bool CompositeHTTPBodyStream::GetRemainingSize(uint64_t* size) {
+  uint64_t remaining_size = 0;
+  for (auto part = current_part_; part != parts_.end(); ++part) {
+    uint64_t part_size;
+    if (!(*part)->GetRemainingSize(&part_size)) {
+      return false;
+    }
+    remaining_size += part_size;
+  }
+  *size = remaining_size;
+  return true;
+}
+
 }  // namespace crashpad
@@ -21,8 +21,10 @@
 #include <string>
 #include <vector>
 
+#include "util/file/chunked_string_file.h"
 #include "util/file/file_io.h"
 #include "util/file/file_reader.h"
+#include "util/file/mapped_file_reader.h"
 
 namespace crashpad {
 
@@ -44,6 +46,42 @@ class HTTPBodyStream {
   virtual FileOperationResult GetBytesBuffer(uint8_t* buffer,
                                              size_t max_len) = 0;
 
+  //! \brief Provides up to \a max_len bytes from the stream where they already
+  //!     are in memory, without copying them.
+  //!
+  //! This allows a consumer to send bytes that a stream holds in memory
+  //! directly, rather than first having them copied by GetBytesBuffer(). Both
+  //! methods advance the same stream position, so they may be used in any
+  //! order.
+  //!
+  //! \param[out] data Set to point to the bytes, which remain valid until the
+  //!     next call to either method or the destruction of this object.
+  //! \param[in] max_len The maximum number of bytes to provide.
+  //! \param[out] size The number of bytes at \a data. This is `0` when the
+  //!     stream has no more data.
+  //!
+  //! \return `true` on success. `false` if the bytes at the stream’s current
+  //!     position aren’t available in memory, in which case they must be read
+  //!     with GetBytesBuffer(). The default implementation always returns
+  //!     `false`.
+  virtual bool GetBytesInPlace(const uint8_t** data,
+                               size_t max_len,
+                               size_t* size);
+
+  //! \brief Determines the number of bytes that remain in the stream, without
+  //!     reading them.
+  //!
+  //! This allows a consumer to send the stream with a `Content-Length` header
+  //! instead of with `Transfer-Encoding: chunked`.
+  //!
+  //! \param[out] size The number of bytes from the stream’s current position
+  //!     to its end.
+  //!
+  //! \return `true` on success. `false` if the size isn’t known in advance, as
+  //!     for a stream that compresses its input. The default implementation
+  //!     always returns `false`.
+  virtual bool GetRemainingSize(uint64_t* size);
+
  protected:
   HTTPBodyStream() {}
 };
@@ -64,6 +102,10 @@ class StringHTTPBodyStream : public HTTPBodyStream {
 
   // HTTPBodyStream:
   FileOperationResult GetBytesBuffer(uint8_t* buffer, size_t max_len) override;
+  bool GetBytesInPlace(const uint8_t** data,
+                       size_t max_len,
+                       size_t* size) override;
+  bool GetRemainingSize(uint64_t* size) override;
 
  private:
   std::string string_;
@@ -88,11 +130,80 @@ class FileReaderHTTPBodyStream : public HTTPBodyStream {
   // HTTPBodyStream:
   FileOperationResult GetBytesBuffer(uint8_t* buffer, size_t max_len) override;
 
+  //! \copydoc HTTPBodyStream::GetRemainingSize
+  //!
+  //! The size is found by seeking the reader to its end and then back to its
+  //! current position, so this fails for a reader that can’t seek.
+  bool GetRemainingSize(uint64_t* size) override;
+
  private:
   FileReaderInterface* reader_;  // weak
   bool reached_eof_;
 };
 
+//! \brief An implementation of HTTPBodyStream that provides the contents of a
+//!     ChunkedStringFile for an HTTP body.
+//!
+//! The contents are copied directly from the file’s chunks into the buffers
+//! supplied to GetBytesBuffer(), without first being gathered into a
+//! contiguous string. The file’s own position is not used or affected.
+class ChunkedStringFileHTTPBodyStream : public HTTPBodyStream {
+ public:
+  //! \brief Creates a stream for reading from a ChunkedStringFile.
+  //!
+  //! \param[in] file The file whose contents this HTTPBodyStream will provide.
+  //!     The file must outlive this object and must not be written to while
+  //!     it is in use.
+  explicit ChunkedStringFileHTTPBodyStream(const ChunkedStringFile* file);
+
+  ChunkedStringFileHTTPBodyStream(const ChunkedStringFileHTTPBodyStream&) =
+      delete;
+  ChunkedStringFileHTTPBodyStream& operator=(
+      const ChunkedStringFileHTTPBodyStream&) = delete;
+
+  ~ChunkedStringFileHTTPBodyStream() override;
+
+  // HTTPBodyStream:
+  FileOperationResult GetBytesBuffer(uint8_t* buffer, size_t max_len) override;
+  bool GetRemainingSize(uint64_t* size) override;
+
+ private:
+  const ChunkedStringFile* file_;  // weak
+  size_t bytes_read_;
+};
+
+//! \brief An implementation of HTTPBodyStream that provides the contents of a
+//!     MappedFileReader for an HTTP body.
+//!
+//! Unlike FileReaderHTTPBodyStream, this provides the file’s contents in place
+//! through GetBytesInPlace(), so that they can be sent straight from the
+//! mapping. The reader’s own file position is not used or affected.
+class MappedFileHTTPBodyStream : public HTTPBodyStream {
+ public:
+  //! \brief Creates a stream for reading from a MappedFileReader.
+  //!
+  //! \param[in] file The mapped file whose contents this HTTPBodyStream will
+  //!     provide. The file must outlive this object and must remain mapped
+  //!     while it is in use.
+  explicit MappedFileHTTPBodyStream(const MappedFileReader* file);
+
+  MappedFileHTTPBodyStream(const MappedFileHTTPBodyStream&) = delete;
+  MappedFileHTTPBodyStream& operator=(const MappedFileHTTPBodyStream&) = delete;
+
+  ~MappedFileHTTPBodyStream() override;
+
+  // HTTPBodyStream:
+  FileOperationResult GetBytesBuffer(uint8_t* buffer, size_t max_len) override;
+  bool GetBytesInPlace(const uint8_t** data,
+                       size_t max_len,
+                       size_t* size) override;
+  bool GetRemainingSize(uint64_t* size) override;
+
+ private:
+  const MappedFileReader* file_;  // weak
+  size_t bytes_read_;
+};
+
 //! \brief An implementation of HTTPBodyStream that combines an array of
 //!     several other HTTPBodyStream objects into a single, unified stream.
 class CompositeHTTPBodyStream : public HTTPBodyStream {
@@ -114,6 +225,14 @@ class CompositeHTTPBodyStream : public HTTPBodyStream {
 
   // HTTPBodyStream:
   FileOperationResult GetBytesBuffer(uint8_t* buffer, size_t max_len) override;
+  bool GetBytesInPlace(const uint8_t** data,
+                       size_t max_len,
+                       size_t* size) override;
+
+  //! \copydoc HTTPBodyStream::GetRemainingSize
+  //!
+  //! The size is only known if it is known for each of the remaining parts.
+  bool GetRemainingSize(uint64_t* size) override;
 
  private:
   PartsList parts_;
@@ -14,6 +14,9 @@
 
 #include "util/net/http_body_gzip.h"
 
+#include <string.h>
+
+#include <algorithm>
 #include <utility>
 
 #include "base/logging.h"
@@ -23,11 +26,23 @@
 
 namespace crashpad {
 
-GzipHTTPBodyStream::GzipHTTPBodyStream(std::unique_ptr<HTTPBodyStream> source)
+GzipHTTPBodyStream::GzipHTTPBodyStream(std::unique_ptr<HTTPBodyStream> source,
+                                       int level,
+                                       unsigned int threads)
     : input_(),
       source_(std::move(source)),
       z_stream_(new z_stream()),
-      state_(State::kUninitialized) {}
+      deflater_(),
+      batch_(),
+      output_(),
+      output_offset_(0),
+      level_(level),
+      threads_(threads),
+      state_(State::kUninitialized) {
+  DCHECK_GE(level_, 0);
+  DCHECK_LE(level_, kMaximumLevel);
+  DCHECK_GE(threads_, 1u);
+}
 
 GzipHTTPBodyStream::~GzipHTTPBodyStream() {
   DCHECK(state_ == State::kUninitialized ||
@@ -45,6 +60,10 @@ FileOperationResult GzipHTTPBodyStream::GetBytesBuffer(uint8_t* buffer,
     return 0;
   }
 
+  if (threads_ > 1) {
+    return GetBytesBufferParallel(buffer, max_len);
+  }
+
   if (state_ == State::kUninitialized) {
     z_stream_->zalloc = Z_NULL;
     z_stream_->zfree = Z_NULL;
@@ -58,7 +77,7 @@ FileOperationResult GzipHTTPBodyStream::GetBytesBuffer(uint8_t* buffer,
     constexpr int kZlibDefaultMemoryLevel = 8;
 
     int zr = deflateInit2(z_stream_.get(),
-                          Z_DEFAULT_COMPRESSION,
+                          level_ == 0 ? Z_DEFAULT_COMPRESSION : level_,
                           Z_DEFLATED,
                           ZlibWindowBitsWithGzipWrapper(kZlibMaxWindowBits),
                           kZlibDefaultMemoryLevel,
@@ -110,6 +129,62 @@ FileOperationResult GzipHTTPBodyStream::GetBytesBuffer(uint8_t* buffer,
   return max_len - z_stream_->avail_out;
 }
 
+FileOperationResult GzipHTTPBodyStream::GetBytesBufferParallel(
+    uint8_t* buffer,
+    size_t max_len) {
+  if (state_ == State::kUninitialized) {
+    deflater_ = std::make_unique<ParallelDeflater>(
+        ParallelDeflater::Format::kGzip,
+        level_ == 0 ? Z_DEFAULT_COMPRESSION : level_,
+        threads_);
+    batch_.resize(deflater_->BatchSize());
+    state_ = State::kOperating;
+  }
+
+  size_t copied = 0;
+  while (copied < max_len) {
+    if (output_offset_ == output_.size()) {
+      if (state_ == State::kInputEOF) {
+        state_ = State::kFinished;
+        break;
+      }
+
+      // Read a whole batch, so that every thread has a block to compress.
+      size_t batch_size = 0;
+      while (state_ != State::kInputEOF && batch_size < batch_.size()) {
+        FileOperationResult input_bytes = source_->GetBytesBuffer(
+            &batch_[batch_size], batch_.size() - batch_size);
+        if (input_bytes == -1) {
+          state_ = State::kError;
+          return -1;
+        }
+        if (input_bytes == 0) {
+          state_ = State::kInputEOF;
+        }
+        batch_size += input_bytes;
+      }
+
+      output_.clear();
+      output_offset_ = 0;
+      if (!deflater_->Compress(batch_.data(),
+                               batch_size,
+                               state_ == State::kInputEOF,
+                               &output_)) {
+        state_ = State::kError;
+        return -1;
+      }
+      continue;
+    }
+
+    const size_t size =
+        std::min(max_len - copied, output_.size() - output_offset_);
+    memcpy(buffer + copied, &output_[output_offset_], size);
+    copied += size;
+    output_offset_ += size;
+  }
+  return copied;
+}
+
 void GzipHTTPBodyStream::Done(State state) {
   DCHECK(state_ == State::kOperating || state_ == State::kInputEOF) << state_;
   DCHECK(state == State::kFinished || state == State::kError) << state;
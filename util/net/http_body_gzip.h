@@ -19,8 +19,10 @@
 #include <sys/types.h>
 
 #include <memory>
+#include <vector>
 
 #include "util/file/file_io.h"
+#include "util/misc/parallel_deflater.h"
 #include "util/net/http_body.h"
 
 extern "C" {
@@ -33,7 +35,19 @@ namespace crashpad {
 //!     HTTPBodyStream.
 class GzipHTTPBodyStream : public HTTPBodyStream {
  public:
-  explicit GzipHTTPBodyStream(std::unique_ptr<HTTPBodyStream> source);
+  //! \brief The highest compression level accepted by the constructor.
+  static constexpr int kMaximumLevel = 9;
+
+  //! \param[in] source The stream to compress.
+  //! \param[in] level The compression level, from `1` to #kMaximumLevel, or
+  //!     `0` to use zlib’s default level. Higher levels produce smaller output
+  //!     at the expense of more CPU time.
+  //! \param[in] threads The number of threads to compress on. With more than
+  //!     `1`, \a source is read in batches that are compressed in parallel by
+  //!     a ParallelDeflater, which produces slightly larger output.
+  explicit GzipHTTPBodyStream(std::unique_ptr<HTTPBodyStream> source,
+                              int level = 0,
+                              unsigned int threads = 1);
 
   GzipHTTPBodyStream(const GzipHTTPBodyStream&) = delete;
   GzipHTTPBodyStream& operator=(const GzipHTTPBodyStream&) = delete;
@@ -56,9 +70,22 @@ class GzipHTTPBodyStream : public HTTPBodyStream {
   // logs a message and transitions state_ to State::kError.
   void Done(State state);
 
+  // GetBytesBuffer() for more than one thread.
+  FileOperationResult GetBytesBufferParallel(uint8_t* buffer, size_t max_len);
+
   uint8_t input_[4096];
   std::unique_ptr<HTTPBodyStream> source_;
   std::unique_ptr<z_stream> z_stream_;
+
+  // Used instead of z_stream_ with more than one thread. Compressed batches
+  // are held in output_ until they have been read from output_offset_ on.
+  std::unique_ptr<ParallelDeflater> deflater_;
+  std::vector<uint8_t> batch_;
+  std::vector<uint8_t> output_;
+  size_t output_offset_;
+
+  const int level_;
+  const unsigned int threads_;
   State state_;
 };
 
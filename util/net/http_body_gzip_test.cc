@@ -17,6 +17,7 @@
 #include <string.h>
 
 #include <algorithm>
+#include <iterator>
 #include <memory>
 #include <string>
 #include <utility>
@@ -27,6 +28,7 @@
 #include "third_party/zlib/zlib_crashpad.h"
 #include "util/misc/zlib.h"
 #include "util/net/http_body.h"
+#include "util/net/http_body_test_util.h"
 
 namespace crashpad {
 namespace test {
@@ -175,6 +177,50 @@ TEST(GzipHTTPBodyStream, ManyBytes_Random) {
   TestGzipDeflateInflate(base::RandBytesAsString(kManyBytes));
 }
 
+TEST(GzipHTTPBodyStream, Level) {
+  const std::string string = MakeString(kManyBytes);
+  std::string compressed[2];
+  const int kLevels[] = {1, GzipHTTPBodyStream::kMaximumLevel};
+  for (size_t index = 0; index < std::size(kLevels); ++index) {
+    SCOPED_TRACE(kLevels[index]);
+    GzipHTTPBodyStream gzip_stream(std::make_unique<StringHTTPBodyStream>(string),
+                                   kLevels[index]);
+    compressed[index] = ReadStreamToString(&gzip_stream);
+
+    std::string decompressed;
+    ASSERT_NO_FATAL_FAILURE(
+        GzipInflate(compressed[index], &decompressed, string.size()));
+    EXPECT_EQ(decompressed, string);
+  }
+
+  EXPECT_LE(compressed[1].size(), compressed[0].size());
+}
+
+TEST(GzipHTTPBodyStream, Threads) {
+  // Several batches at any of these thread counts, ending partway through a
+  // block.
+  const std::string string = MakeString(kManyBytes * 10);
+  for (unsigned int threads : {2, 3, 8}) {
+    SCOPED_TRACE(threads);
+    GzipHTTPBodyStream gzip_stream(
+        std::make_unique<StringHTTPBodyStream>(string), 0, threads);
+    const std::string compressed = ReadStreamToString(&gzip_stream);
+    EXPECT_LT(compressed.size(), string.size());
+
+    std::string decompressed;
+    ASSERT_NO_FATAL_FAILURE(
+        GzipInflate(compressed, &decompressed, string.size()));
+    EXPECT_EQ(decompressed, string);
+  }
+
+  GzipHTTPBodyStream gzip_stream(
+      std::make_unique<StringHTTPBodyStream>(std::string()), 0, 4);
+  std::string decompressed;
+  ASSERT_NO_FATAL_FAILURE(
+      GzipInflate(ReadStreamToString(&gzip_stream), &decompressed, 1));
+  EXPECT_TRUE(decompressed.empty());
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace crashpad
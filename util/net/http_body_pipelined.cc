@@ -0,0 +1,150 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/net/http_body_pipelined.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+#include "base/check_op.h"
+#include "util/thread/thread.h"
+
+namespace crashpad {
+
+class PipelinedHTTPBodyStream::ReaderThread : public Thread {
+ public:
+  explicit ReaderThread(PipelinedHTTPBodyStream* stream)
+      : Thread(), stream_(stream) {}
+
+  ReaderThread(const ReaderThread&) = delete;
+  ReaderThread& operator=(const ReaderThread&) = delete;
+
+  ~ReaderThread() override {}
+
+ private:
+  // Thread:
+  void ThreadMain() override { stream_->ReadSource(); }
+
+  PipelinedHTTPBodyStream* stream_;  // weak
+};
+
+PipelinedHTTPBodyStream::PipelinedHTTPBodyStream(
+    std::unique_ptr<HTTPBodyStream> source,
+    size_t buffer_size)
+    : source_(std::move(source)),
+      buffers_(),
+      buffer_size_(buffer_size),
+      empty_buffers_(static_cast<int>(std::size(buffers_))),
+      full_buffers_(0),
+      reader_thread_(),
+      stopping_(false),
+      buffer_index_(0),
+      buffer_offset_(0),
+      have_buffer_(false),
+      state_(State::kUninitialized) {
+  DCHECK_GT(buffer_size_, 0u);
+}
+
+PipelinedHTTPBodyStream::~PipelinedHTTPBodyStream() {
+  if (reader_thread_) {
+    // The reader thread only waits for an empty buffer, so one more is enough
+    // to wake it to notice stopping_.
+    stopping_ = true;
+    empty_buffers_.Signal();
+    reader_thread_->Join();
+  }
+}
+
+FileOperationResult PipelinedHTTPBodyStream::GetBytesBuffer(uint8_t* buffer,
+                                                            size_t max_len) {
+  if (state_ == State::kError) {
+    return -1;
+  }
+
+  if (state_ == State::kFinished) {
+    return 0;
+  }
+
+  if (state_ == State::kUninitialized) {
+    for (Buffer& pipeline_buffer : buffers_) {
+      pipeline_buffer.data.reset(new uint8_t[buffer_size_]);
+    }
+    reader_thread_ = std::make_unique<ReaderThread>(this);
+    reader_thread_->Start();
+    state_ = State::kOperating;
+  }
+
+  if (!have_buffer_) {
+    full_buffers_.Wait();
+    have_buffer_ = true;
+    buffer_offset_ = 0;
+  }
+
+  const Buffer& pipeline_buffer = buffers_[buffer_index_];
+  if (buffer_offset_ == pipeline_buffer.size) {
+    // Full buffers are handed back as soon as they’ve been read, so this is
+    // the last buffer.
+    DCHECK_LE(pipeline_buffer.status, 0);
+    if (pipeline_buffer.status < 0) {
+      state_ = State::kError;
+      return -1;
+    }
+    state_ = State::kFinished;
+    return 0;
+  }
+
+  const size_t copy_size =
+      std::min(max_len, pipeline_buffer.size - buffer_offset_);
+  memcpy(buffer, pipeline_buffer.data.get() + buffer_offset_, copy_size);
+  buffer_offset_ += copy_size;
+
+  if (buffer_offset_ == pipeline_buffer.size && pipeline_buffer.status > 0) {
+    have_buffer_ = false;
+    buffer_index_ = (buffer_index_ + 1) % std::size(buffers_);
+    empty_buffers_.Signal();
+  }
+
+  return copy_size;
+}
+
+void PipelinedHTTPBodyStream::ReadSource() {
+  for (size_t index = 0;; index = (index + 1) % std::size(buffers_)) {
+    empty_buffers_.Wait();
+    if (stopping_) {
+      return;
+    }
+
+    Buffer& pipeline_buffer = buffers_[index];
+    pipeline_buffer.size = 0;
+    do {
+      pipeline_buffer.status = source_->GetBytesBuffer(
+          pipeline_buffer.data.get() + pipeline_buffer.size,
+          buffer_size_ - pipeline_buffer.size);
+      if (pipeline_buffer.status > 0) {
+        pipeline_buffer.size += static_cast<size_t>(pipeline_buffer.status);
+      }
+    } while (pipeline_buffer.status > 0 &&
+             pipeline_buffer.size < buffer_size_);
+
+    full_buffers_.Signal();
+    if (pipeline_buffer.status <= 0) {
+      return;
+    }
+  }
+}
+
+}  // namespace crashpad
@@ -0,0 +1,106 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_UTIL_NET_HTTP_BODY_PIPELINED_H_
+#define CRASHPAD_UTIL_NET_HTTP_BODY_PIPELINED_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <memory>
+
+#include "util/file/file_io.h"
+#include "util/net/http_body.h"
+#include "util/synchronization/semaphore.h"
+
+namespace crashpad {
+
+//! \brief An implementation of HTTPBodyStream that reads another
+//!     HTTPBodyStream on a separate thread, ahead of its own reader.
+//!
+//! The source stream is read into two fixed-size buffers in turn, each filled
+//! completely unless the source ends, so that the work done by the source, such
+//! as reading a file or compressing data, overlaps with the work done by the
+//! reader of this stream, such as sending data over the network. Memory use is
+//! bounded by the two buffers, regardless of the length of the source stream.
+//!
+//! The source stream is only accessed from the separate thread, which is
+//! started by the first call to GetBytesBuffer().
+class PipelinedHTTPBodyStream : public HTTPBodyStream {
+ public:
+  //! \brief The default size of each buffer.
+  static constexpr size_t kDefaultBufferSize = 64 * 1024;
+
+  //! \param[in] source The stream to read from.
+  //! \param[in] buffer_size The size of each of the two buffers.
+  explicit PipelinedHTTPBodyStream(std::unique_ptr<HTTPBodyStream> source,
+                                   size_t buffer_size = kDefaultBufferSize);
+
+  PipelinedHTTPBodyStream(const PipelinedHTTPBodyStream&) = delete;
+  PipelinedHTTPBodyStream& operator=(const PipelinedHTTPBodyStream&) = delete;
+
+  //! \brief Stops reading from the source stream, waiting for any read that is
+  //!     in progress to complete.
+  ~PipelinedHTTPBodyStream() override;
+
+  // HTTPBodyStream:
+  FileOperationResult GetBytesBuffer(uint8_t* buffer, size_t max_len) override;
+
+ private:
+  class ReaderThread;
+
+  struct Buffer {
+    std::unique_ptr<uint8_t[]> data;
+    size_t size;
+
+    // The result of the read from the source stream that ended this buffer: a
+    // positive number if the buffer is full and the source has more data, `0`
+    // if the source reached its end, or `-1` if the source failed.
+    FileOperationResult status;
+  };
+
+  enum State : int {
+    kUninitialized,
+    kOperating,
+    kFinished,
+    kError,
+  };
+
+  // Fills buffers_ from source_ until the source ends or fails, or until
+  // stopping_ is set. Called on the reader thread.
+  void ReadSource();
+
+  std::unique_ptr<HTTPBodyStream> source_;
+  Buffer buffers_[2];
+  const size_t buffer_size_;
+
+  // Signaled by the reader of this stream when it is done with a buffer, and
+  // by the reader thread when it has filled one.
+  Semaphore empty_buffers_;
+  Semaphore full_buffers_;
+
+  std::unique_ptr<ReaderThread> reader_thread_;
+  std::atomic<bool> stopping_;
+
+  // Only accessed by the reader of this stream.
+  size_t buffer_index_;
+  size_t buffer_offset_;
+  bool have_buffer_;
+  State state_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_UTIL_NET_HTTP_BODY_PIPELINED_H_
@@ -0,0 +1,148 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/net/http_body_pipelined.h"
+
+#include <string.h>
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "gtest/gtest.h"
+#include "util/net/http_body.h"
+#include "util/net/http_body_test_util.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+// Returns its string one byte at a time, and then fails if fail is true.
+class TrickleHTTPBodyStream : public HTTPBodyStream {
+ public:
+  TrickleHTTPBodyStream(const std::string& string, bool fail)
+      : string_(string), offset_(0), fail_(fail) {}
+
+  TrickleHTTPBodyStream(const TrickleHTTPBodyStream&) = delete;
+  TrickleHTTPBodyStream& operator=(const TrickleHTTPBodyStream&) = delete;
+
+  ~TrickleHTTPBodyStream() override {}
+
+  // HTTPBodyStream:
+  FileOperationResult GetBytesBuffer(uint8_t* buffer, size_t max_len) override {
+    if (offset_ == string_.size()) {
+      return fail_ ? -1 : 0;
+    }
+    buffer[0] = string_[offset_++];
+    return 1;
+  }
+
+ private:
+  std::string string_;
+  size_t offset_;
+  bool fail_;
+};
+
+std::string TestString(size_t length) {
+  std::string string(length, '\0');
+  for (size_t index = 0; index < length; ++index) {
+    string[index] = static_cast<char>('a' + index % 26);
+  }
+  return string;
+}
+
+TEST(PipelinedHTTPBodyStream, Empty) {
+  PipelinedHTTPBodyStream stream(
+      std::make_unique<StringHTTPBodyStream>(std::string()));
+  EXPECT_EQ(ReadStreamToString(&stream), std::string());
+}
+
+class PipelinedHTTPBodyStreamBufferSize
+    : public testing::TestWithParam<size_t> {};
+
+TEST_P(PipelinedHTTPBodyStreamBufferSize, ReadsSource) {
+  // Sizes around multiples of the pipeline’s buffer size.
+  constexpr size_t kPipelineBufferSize = 16;
+  for (size_t length : {1, 15, 16, 17, 32, 33, 100}) {
+    SCOPED_TRACE(length);
+    const std::string string = TestString(length);
+    PipelinedHTTPBodyStream stream(
+        std::make_unique<StringHTTPBodyStream>(string), kPipelineBufferSize);
+    EXPECT_EQ(ReadStreamToString(&stream, GetParam()), string);
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(VariableBufferSize,
+                         PipelinedHTTPBodyStreamBufferSize,
+                         testing::Values(1, 2, 15, 16, 17, 64));
+
+TEST(PipelinedHTTPBodyStream, FillsBuffers) {
+  // Although the source returns a byte at a time, reads return whole buffers.
+  constexpr size_t kPipelineBufferSize = 8;
+  const std::string string = TestString(20);
+  PipelinedHTTPBodyStream stream(
+      std::make_unique<TrickleHTTPBodyStream>(string, false),
+      kPipelineBufferSize);
+
+  uint8_t buffer[32];
+  EXPECT_EQ(stream.GetBytesBuffer(buffer, sizeof(buffer)), 8);
+  EXPECT_EQ(memcmp(buffer, &string[0], 8), 0);
+  EXPECT_EQ(stream.GetBytesBuffer(buffer, sizeof(buffer)), 8);
+  EXPECT_EQ(memcmp(buffer, &string[8], 8), 0);
+  EXPECT_EQ(stream.GetBytesBuffer(buffer, sizeof(buffer)), 4);
+  EXPECT_EQ(memcmp(buffer, &string[16], 4), 0);
+  EXPECT_EQ(stream.GetBytesBuffer(buffer, sizeof(buffer)), 0);
+  EXPECT_EQ(stream.GetBytesBuffer(buffer, sizeof(buffer)), 0);
+}
+
+TEST(PipelinedHTTPBodyStream, SourceFailure) {
+  // Data read before the failure is returned before the failure is.
+  constexpr size_t kPipelineBufferSize = 8;
+  const std::string string = TestString(10);
+  PipelinedHTTPBodyStream stream(
+      std::make_unique<TrickleHTTPBodyStream>(string, true),
+      kPipelineBufferSize);
+
+  uint8_t buffer[32];
+  EXPECT_EQ(stream.GetBytesBuffer(buffer, sizeof(buffer)), 8);
+  EXPECT_EQ(stream.GetBytesBuffer(buffer, sizeof(buffer)), 2);
+  EXPECT_EQ(memcmp(buffer, &string[8], 2), 0);
+  EXPECT_EQ(stream.GetBytesBuffer(buffer, sizeof(buffer)), -1);
+  EXPECT_EQ(stream.GetBytesBuffer(buffer, sizeof(buffer)), -1);
+}
+
+TEST(PipelinedHTTPBodyStream, DestroyedBeforeEnd) {
+  // Destroying the stream stops the reader thread, which will have filled both
+  // buffers and be waiting for another.
+  constexpr size_t kPipelineBufferSize = 8;
+  PipelinedHTTPBodyStream stream(
+      std::make_unique<StringHTTPBodyStream>(TestString(1000)),
+      kPipelineBufferSize);
+
+  uint8_t buffer[4];
+  EXPECT_EQ(stream.GetBytesBuffer(buffer, sizeof(buffer)), 4);
+}
+
+TEST(PipelinedHTTPBodyStream, Stacked) {
+  const std::string string = TestString(1000);
+  PipelinedHTTPBodyStream stream(
+      std::make_unique<PipelinedHTTPBodyStream>(
+          std::make_unique<TrickleHTTPBodyStream>(string, false), 64),
+      100);
+  EXPECT_EQ(ReadStreamToString(&stream, 30), string);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
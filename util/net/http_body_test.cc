@@ -18,6 +18,8 @@
 
 #include "gtest/gtest.h"
 #include "test/test_paths.h"
+#include "util/file/chunked_string_file.h"
+#include "util/file/mapped_file_reader.h"
 #include "util/misc/implicit_cast.h"
 #include "util/net/http_body_test_util.h"
 
@@ -148,6 +150,75 @@ TEST(FileReaderHTTPBodyStream, ReadBinaryFile) {
   ExpectBufferSet(buf, '!', sizeof(buf));
 }
 
+TEST(ChunkedStringFileHTTPBodyStream, ReadChunks) {
+  // The chunk size and read buffer sizes were chosen so that reads both span
+  // and fall within chunks.
+  ChunkedStringFile file(5);
+  std::string expected;
+  for (char c = 'a'; c <= 'z'; ++c) {
+    expected.push_back(c);
+  }
+  ASSERT_TRUE(file.Write(expected.data(), expected.size()));
+
+  for (size_t buffer_size : {1, 3, 5, 7, 64}) {
+    ChunkedStringFileHTTPBodyStream stream(&file);
+    EXPECT_EQ(ReadStreamToString(&stream, buffer_size), expected);
+
+    uint8_t buf[8];
+    memset(buf, '!', sizeof(buf));
+    EXPECT_EQ(stream.GetBytesBuffer(buf, sizeof(buf)), 0);
+    ExpectBufferSet(buf, '!', sizeof(buf));
+  }
+
+  // The file’s position was not used or affected.
+  EXPECT_EQ(file.Seek(0, SEEK_CUR), static_cast<FileOffset>(expected.size()));
+}
+
+TEST(MappedFileHTTPBodyStream, ReadBinaryFile) {
+  // HEX contents of file: |FEEDFACE A11A15|.
+  base::FilePath path = TestPaths::TestDataRoot().Append(
+      FILE_PATH_LITERAL("util/net/testdata/binary_http_body.dat"));
+  constexpr uint8_t kExpected[] = {0xfe, 0xed, 0xfa, 0xce, 0xa1, 0x1a, 0x15};
+
+  MappedFileReader file;
+  ASSERT_TRUE(file.Open(path));
+
+  for (size_t buffer_size : {1, 4, 7, 64}) {
+    MappedFileHTTPBodyStream stream(&file);
+    EXPECT_EQ(ReadStreamToString(&stream, buffer_size),
+              std::string(reinterpret_cast<const char*>(kExpected),
+                          sizeof(kExpected)));
+
+    uint8_t buf[8];
+    memset(buf, '!', sizeof(buf));
+    EXPECT_EQ(stream.GetBytesBuffer(buf, sizeof(buf)), 0);
+    ExpectBufferSet(buf, '!', sizeof(buf));
+  }
+
+  // The bytes are provided in place, from the mapping, and both methods
+  // advance the same position.
+  MappedFileHTTPBodyStream stream(&file);
+  const uint8_t* data;
+  size_t size;
+  ASSERT_TRUE(stream.GetBytesInPlace(&data, 4, &size));
+  EXPECT_EQ(data, file.data());
+  EXPECT_EQ(size, 4u);
+
+  uint8_t buf[2];
+  EXPECT_EQ(stream.GetBytesBuffer(buf, sizeof(buf)), 2);
+  EXPECT_EQ(buf[0], 0xa1);
+  EXPECT_EQ(buf[1], 0x1a);
+
+  ASSERT_TRUE(stream.GetBytesInPlace(&data, 4, &size));
+  EXPECT_EQ(data, file.data() + 6);
+  EXPECT_EQ(size, 1u);
+  ASSERT_TRUE(stream.GetBytesInPlace(&data, 4, &size));
+  EXPECT_EQ(size, 0u);
+
+  // The reader’s position was not used or affected.
+  EXPECT_EQ(file.Seek(0, SEEK_CUR), 0);
+}
+
 TEST(CompositeHTTPBodyStream, TwoEmptyStrings) {
   std::vector<HTTPBodyStream*> parts;
   parts.push_back(new StringHTTPBodyStream(std::string()));
@@ -207,6 +278,87 @@ TEST_P(CompositeHTTPBodyStreamBufferSize, StringsAndFile) {
   EXPECT_EQ(actual_string, expected_string);
 }
 
+TEST(CompositeHTTPBodyStream, InPlace) {
+  base::FilePath path = TestPaths::TestDataRoot().Append(
+      FILE_PATH_LITERAL("util/net/testdata/ascii_http_body.txt"));
+  MappedFileReader file;
+  ASSERT_TRUE(file.Open(path));
+
+  std::vector<HTTPBodyStream*> parts;
+  parts.push_back(new StringHTTPBodyStream("Hello! "));
+  parts.push_back(new MappedFileHTTPBodyStream(&file));
+  parts.push_back(new MappedFileHTTPBodyStream(&file));
+  parts.push_back(new StringHTTPBodyStream(" Goodbye :)"));
+
+  CompositeHTTPBodyStream stream(parts);
+
+  // Each part is provided in place in turn, skipping past the end of each.
+  std::vector<std::string> pieces;
+  const uint8_t* data;
+  size_t size;
+  while (true) {
+    ASSERT_TRUE(stream.GetBytesInPlace(&data, 64, &size));
+    if (size == 0) {
+      break;
+    }
+    pieces.push_back(std::string(reinterpret_cast<const char*>(data), size));
+  }
+  EXPECT_EQ(pieces,
+            std::vector<std::string>({"Hello! ",
+                                      "This is a test.\n",
+                                      "This is a test.\n",
+                                      " Goodbye :)"}));
+
+  // A part that isn’t available in place must be read into a buffer.
+  FileReader reader;
+  ASSERT_TRUE(reader.Open(path));
+  parts.clear();
+  parts.push_back(new StringHTTPBodyStream("Hello! "));
+  parts.push_back(new FileReaderHTTPBodyStream(&reader));
+  CompositeHTTPBodyStream mixed_stream(parts);
+
+  ASSERT_TRUE(mixed_stream.GetBytesInPlace(&data, 64, &size));
+  EXPECT_EQ(std::string(reinterpret_cast<const char*>(data), size), "Hello! ");
+  EXPECT_FALSE(mixed_stream.GetBytesInPlace(&data, 64, &size));
+  EXPECT_EQ(ReadStreamToString(&mixed_stream, 4), "This is a test.\n");
+}
+
+TEST(CompositeHTTPBodyStream, GetRemainingSize) {
+  base::FilePath path = TestPaths::TestDataRoot().Append(
+      FILE_PATH_LITERAL("util/net/testdata/ascii_http_body.txt"));
+  FileReader reader;
+  ASSERT_TRUE(reader.Open(path));
+  MappedFileReader mapped_file;
+  ASSERT_TRUE(mapped_file.Open(path));
+  ChunkedStringFile chunked_file(5);
+  ASSERT_TRUE(chunked_file.Write("chunked", 7));
+
+  std::vector<HTTPBodyStream*> parts;
+  parts.push_back(new StringHTTPBodyStream("Hello! "));
+  parts.push_back(new FileReaderHTTPBodyStream(&reader));
+  parts.push_back(new MappedFileHTTPBodyStream(&mapped_file));
+  parts.push_back(new ChunkedStringFileHTTPBodyStream(&chunked_file));
+  parts.push_back(new StringHTTPBodyStream(" Goodbye :)"));
+  CompositeHTTPBodyStream stream(parts);
+
+  constexpr char kExpected[] =
+      "Hello! This is a test.\nThis is a test.\nchunked Goodbye :)";
+  uint64_t size;
+  ASSERT_TRUE(stream.GetRemainingSize(&size));
+  EXPECT_EQ(size, strlen(kExpected));
+
+  // The size remaining is reduced by what’s been read, and finding it doesn’t
+  // affect what’s read next.
+  uint8_t buf[10];
+  ASSERT_EQ(stream.GetBytesBuffer(buf, sizeof(buf)), 10);
+  ASSERT_TRUE(stream.GetRemainingSize(&size));
+  EXPECT_EQ(size, strlen(kExpected) - 10);
+  EXPECT_EQ(ReadStreamToString(&stream, 3), &kExpected[10]);
+
+  ASSERT_TRUE(stream.GetRemainingSize(&size));
+  EXPECT_EQ(size, 0u);
+}
+
 INSTANTIATE_TEST_SUITE_P(VariableBufferSize,
                          CompositeHTTPBodyStreamBufferSize,
                          testing::Values(1, 2, 9, 16, 31, 128, 1024));
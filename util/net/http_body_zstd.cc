@@ -0,0 +1,185 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/net/http_body_zstd.h"
+
+#include <utility>
+
+#include "base/check_op.h"
+#include "base/logging.h"
+#include "base/notreached.h"
+#include "third_party/zstd/zstd_crashpad.h"
+
+namespace crashpad {
+
+ZstdDictionary::ZstdDictionary() : data_(), id_(0) {}
+
+ZstdDictionary::~ZstdDictionary() = default;
+
+bool ZstdDictionary::Initialize(const base::FilePath& path) {
+  std::string data;
+  if (!LoggingReadEntireFile(path, &data)) {
+    return false;
+  }
+  return InitializeWithData(std::move(data));
+}
+
+bool ZstdDictionary::InitializeWithData(std::string data) {
+#if CRASHPAD_ZSTD_SUPPORTED
+  const unsigned int id = ZSTD_getDictID_fromDict(data.data(), data.size());
+  if (id == 0) {
+    LOG(ERROR) << "not a Zstandard dictionary with an ID";
+    return false;
+  }
+
+  data_ = std::move(data);
+  id_ = id;
+  return true;
+#else
+  LOG(ERROR) << "Zstandard is not supported by this build";
+  return false;
+#endif  // CRASHPAD_ZSTD_SUPPORTED
+}
+
+// static
+bool ZstdHTTPBodyStream::IsSupported() {
+  return CRASHPAD_ZSTD_SUPPORTED;
+}
+
+ZstdHTTPBodyStream::ZstdHTTPBodyStream(std::unique_ptr<HTTPBodyStream> source,
+                                       int level,
+                                       const ZstdDictionary* dictionary)
+    : input_(),
+      input_capacity_(0),
+      input_size_(0),
+      input_offset_(0),
+      source_(std::move(source)),
+      cctx_(nullptr),
+      dictionary_(dictionary),
+      level_(level),
+      state_(State::kUninitialized) {
+  DCHECK_GE(level_, 0);
+  DCHECK_LE(level_, kMaximumLevel);
+}
+
+ZstdHTTPBodyStream::~ZstdHTTPBodyStream() {
+#if CRASHPAD_ZSTD_SUPPORTED
+  ZSTD_freeCCtx(cctx_);
+#endif
+}
+
+FileOperationResult ZstdHTTPBodyStream::GetBytesBuffer(uint8_t* buffer,
+                                                       size_t max_len) {
+  if (state_ == State::kUninitialized) {
+    Initialize();
+  }
+
+  if (state_ == State::kError) {
+    return -1;
+  }
+
+  if (state_ == State::kFinished) {
+    return 0;
+  }
+
+#if CRASHPAD_ZSTD_SUPPORTED
+  ZSTD_outBuffer output = {buffer, max_len, 0};
+  while (state_ != State::kFinished && output.pos < output.size) {
+    if (state_ != State::kInputEOF && input_offset_ == input_size_) {
+      FileOperationResult input_bytes =
+          source_->GetBytesBuffer(input_.get(), input_capacity_);
+      if (input_bytes == -1) {
+        state_ = State::kError;
+        return -1;
+      }
+
+      if (input_bytes == 0) {
+        state_ = State::kInputEOF;
+      }
+
+      input_size_ = input_bytes;
+      input_offset_ = 0;
+    }
+
+    ZSTD_inBuffer input = {input_.get(), input_size_, input_offset_};
+    const size_t zr = ZSTD_compressStream2(
+        cctx_,
+        &output,
+        &input,
+        state_ == State::kInputEOF ? ZSTD_e_end : ZSTD_e_continue);
+    if (ZSTD_isError(zr)) {
+      LOG(ERROR) << "ZSTD_compressStream2: " << ZSTD_getErrorName(zr);
+      state_ = State::kError;
+      return -1;
+    }
+    input_offset_ = input.pos;
+
+    // With ZSTD_e_end, zr is the amount of compressed data remaining to be
+    // flushed, so the frame is complete when it reaches 0.
+    if (state_ == State::kInputEOF && zr == 0) {
+      state_ = State::kFinished;
+    }
+  }
+
+  return output.pos;
+#else
+  NOTREACHED();
+  return -1;
+#endif  // CRASHPAD_ZSTD_SUPPORTED
+}
+
+void ZstdHTTPBodyStream::Initialize() {
+  DCHECK_EQ(state_, State::kUninitialized);
+
+#if CRASHPAD_ZSTD_SUPPORTED
+  cctx_ = ZSTD_createCCtx();
+  if (!cctx_) {
+    LOG(ERROR) << "ZSTD_createCCtx";
+    state_ = State::kError;
+    return;
+  }
+
+  if (level_ != 0) {
+    const size_t zr =
+        ZSTD_CCtx_setParameter(cctx_, ZSTD_c_compressionLevel, level_);
+    if (ZSTD_isError(zr)) {
+      LOG(ERROR) << "ZSTD_CCtx_setParameter: " << ZSTD_getErrorName(zr);
+      state_ = State::kError;
+      return;
+    }
+  }
+
+  if (dictionary_) {
+    // The dictionary’s ID is written to the frame header, so that the receiver
+    // can tell which dictionary it needs.
+    const size_t zr = ZSTD_CCtx_loadDictionary(
+        cctx_, dictionary_->data().data(), dictionary_->data().size());
+    if (ZSTD_isError(zr)) {
+      LOG(ERROR) << "ZSTD_CCtx_loadDictionary: " << ZSTD_getErrorName(zr);
+      state_ = State::kError;
+      return;
+    }
+  }
+
+  // The recommended input size lets each call compress a whole block.
+  input_capacity_ = ZSTD_CStreamInSize();
+  input_.reset(new uint8_t[input_capacity_]);
+  state_ = State::kOperating;
+#else
+  LOG(ERROR) << "Zstandard is not supported by this build";
+  state_ = State::kError;
+#endif  // CRASHPAD_ZSTD_SUPPORTED
+}
+
+}  // namespace crashpad
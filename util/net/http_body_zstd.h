@@ -0,0 +1,131 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_UTIL_NET_HTTP_BODY_ZSTD_H_
+#define CRASHPAD_UTIL_NET_HTTP_BODY_ZSTD_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+
+#include "base/files/file_path.h"
+#include "util/file/file_io.h"
+#include "util/net/http_body.h"
+
+extern "C" {
+typedef struct ZSTD_CCtx_s ZSTD_CCtx;
+}  // extern "C"
+
+namespace crashpad {
+
+//! \brief A Zstandard dictionary, such as one made by `zstd --train` from
+//!     representative minidumps, used to compress small inputs that resemble
+//!     those that it was trained on much better than they compress alone.
+//!
+//! Data compressed with a dictionary can only be decompressed with the same
+//! dictionary, which is identified by its id().
+class ZstdDictionary {
+ public:
+  ZstdDictionary();
+
+  ZstdDictionary(const ZstdDictionary&) = delete;
+  ZstdDictionary& operator=(const ZstdDictionary&) = delete;
+
+  ~ZstdDictionary();
+
+  //! \brief Initializes the object with the dictionary in the file at \a path.
+  //!
+  //! \return `true` on success, `false` on failure with a message logged. The
+  //!     file must contain a Zstandard dictionary with a nonzero ID, as made by
+  //!     `zstd --train`. Raw content dictionaries aren’t accepted, because they
+  //!     carry no ID.
+  bool Initialize(const base::FilePath& path);
+
+  //! \brief Initializes the object with the dictionary in \a data.
+  //!
+  //! \return `true` on success, `false` on failure with a message logged. See
+  //!     Initialize().
+  bool InitializeWithData(std::string data);
+
+  //! \brief The ID stored in the dictionary.
+  uint32_t id() const { return id_; }
+
+  //! \brief The contents of the dictionary.
+  const std::string& data() const { return data_; }
+
+ private:
+  std::string data_;
+  uint32_t id_;
+};
+
+//! \brief An implementation of HTTPBodyStream that Zstandard-compresses another
+//!     HTTPBodyStream, producing data for the `zstd` content coding (RFC 8878).
+//!
+//! Zstandard support is optional at build time. If it is not available,
+//! IsSupported() returns `false`, and GetBytesBuffer() fails.
+class ZstdHTTPBodyStream : public HTTPBodyStream {
+ public:
+  //! \brief The highest compression level accepted by the constructor.
+  static constexpr int kMaximumLevel = 19;
+
+  //! \brief Returns whether Zstandard support was available to the build.
+  static bool IsSupported();
+
+  //! \param[in] source The stream to compress.
+  //! \param[in] level The compression level, from `1` to #kMaximumLevel, or
+  //!     `0` to use Zstandard’s default level. Higher levels produce smaller
+  //!     output at the expense of more CPU time.
+  //! \param[in] dictionary The dictionary to compress with, or `nullptr` to
+  //!     compress without one. If set, it must outlive this object.
+  explicit ZstdHTTPBodyStream(std::unique_ptr<HTTPBodyStream> source,
+                              int level = 0,
+                              const ZstdDictionary* dictionary = nullptr);
+
+  ZstdHTTPBodyStream(const ZstdHTTPBodyStream&) = delete;
+  ZstdHTTPBodyStream& operator=(const ZstdHTTPBodyStream&) = delete;
+
+  ~ZstdHTTPBodyStream() override;
+
+  // HTTPBodyStream:
+  FileOperationResult GetBytesBuffer(uint8_t* buffer, size_t max_len) override;
+
+ private:
+  enum State : int {
+    kUninitialized,
+    kOperating,
+    kInputEOF,
+    kFinished,
+    kError,
+  };
+
+  // Creates cctx_ and input_, and transitions state_ to State::kOperating. On
+  // failure, logs a message and transitions state_ to State::kError.
+  void Initialize();
+
+  std::unique_ptr<uint8_t[]> input_;
+  size_t input_capacity_;
+  size_t input_size_;
+  size_t input_offset_;
+  std::unique_ptr<HTTPBodyStream> source_;
+  ZSTD_CCtx* cctx_;  // owned
+  const ZstdDictionary* dictionary_;  // weak
+  const int level_;
+  State state_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_UTIL_NET_HTTP_BODY_ZSTD_H_
@@ -0,0 +1,208 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/net/http_body_zstd.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/rand_util.h"
+#include "base/strings/stringprintf.h"
+#include "gtest/gtest.h"
+#include "third_party/zstd/zstd_crashpad.h"
+#include "util/net/http_body.h"
+#include "util/net/http_body_test_util.h"
+
+#if CRASHPAD_ZSTD_SUPPORTED
+#include <zdict.h>
+#endif  // CRASHPAD_ZSTD_SUPPORTED
+
+namespace crashpad {
+namespace test {
+namespace {
+
+#if CRASHPAD_ZSTD_SUPPORTED
+
+void ZstdDecompress(const std::string& compressed,
+                    std::string* decompressed,
+                    const ZstdDictionary* dictionary = nullptr) {
+  decompressed->clear();
+
+  ZSTD_DCtx* dctx = ZSTD_createDCtx();
+  ASSERT_TRUE(dctx);
+  if (dictionary) {
+    const size_t zr = ZSTD_DCtx_loadDictionary(
+        dctx, dictionary->data().data(), dictionary->data().size());
+    if (ZSTD_isError(zr)) {
+      ZSTD_freeDCtx(dctx);
+      FAIL() << ZSTD_getErrorName(zr);
+    }
+  }
+
+  ZSTD_inBuffer input = {compressed.data(), compressed.size(), 0};
+  char buffer[4096];
+  size_t zr;
+  while (true) {
+    ZSTD_outBuffer output = {buffer, sizeof(buffer), 0};
+    zr = ZSTD_decompressStream(dctx, &output, &input);
+    if (ZSTD_isError(zr)) {
+      break;
+    }
+    decompressed->append(buffer, output.pos);
+
+    // Once all input is consumed, a buffer that isn’t filled means that there
+    // is nothing left to flush.
+    if (input.pos == input.size && output.pos < output.size) {
+      break;
+    }
+  }
+
+  ZSTD_freeDCtx(dctx);
+  ASSERT_FALSE(ZSTD_isError(zr)) << ZSTD_getErrorName(zr);
+
+  // The whole input is a single, complete frame.
+  EXPECT_EQ(zr, 0u);
+  EXPECT_EQ(input.pos, input.size);
+}
+
+std::string MakeString(size_t size) {
+  std::string string;
+  for (size_t i = 0; i < size; ++i) {
+    string.append(1, static_cast<char>((i % 256) ^ ((i >> 8) % 256)));
+  }
+  return string;
+}
+
+constexpr size_t kManyBytes = 375017;
+
+TEST(ZstdHTTPBodyStream, IsSupported) {
+  EXPECT_TRUE(ZstdHTTPBodyStream::IsSupported());
+}
+
+class ZstdHTTPBodyStreamBufferSize : public testing::TestWithParam<size_t> {};
+
+TEST_P(ZstdHTTPBodyStreamBufferSize, CompressDecompress) {
+  for (const std::string& string : {std::string(),
+                                    std::string("Z"),
+                                    std::string(kManyBytes, '\0'),
+                                    MakeString(kManyBytes),
+                                    base::RandBytesAsString(kManyBytes)}) {
+    SCOPED_TRACE(string.size());
+    ZstdHTTPBodyStream zstd_stream(
+        std::make_unique<StringHTTPBodyStream>(string));
+    const std::string compressed =
+        ReadStreamToString(&zstd_stream, GetParam());
+
+    // The frame’s magic number.
+    ASSERT_GE(compressed.size(), 4u);
+    EXPECT_EQ(compressed.substr(0, 4), std::string("\x28\xb5\x2f\xfd"));
+
+    std::string decompressed;
+    ASSERT_NO_FATAL_FAILURE(ZstdDecompress(compressed, &decompressed));
+    EXPECT_EQ(decompressed, string);
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(VariableBufferSize,
+                         ZstdHTTPBodyStreamBufferSize,
+                         testing::Values(1, 2, 9, 16, 31, 128, 4096));
+
+TEST(ZstdHTTPBodyStream, Level) {
+  const std::string string = MakeString(kManyBytes);
+  for (int level : {1, ZstdHTTPBodyStream::kMaximumLevel}) {
+    SCOPED_TRACE(level);
+    ZstdHTTPBodyStream zstd_stream(
+        std::make_unique<StringHTTPBodyStream>(string), level);
+    std::string decompressed;
+    ASSERT_NO_FATAL_FAILURE(
+        ZstdDecompress(ReadStreamToString(&zstd_stream), &decompressed));
+    EXPECT_EQ(decompressed, string);
+  }
+}
+
+TEST(ZstdHTTPBodyStream, Dictionary) {
+  // Reports that share most of their contents, as small minidumps do.
+  std::string samples;
+  std::vector<size_t> sample_sizes;
+  for (int i = 0; i < 1000; ++i) {
+    const std::string sample = base::StringPrintf(
+        "module=libexample.so version=1.2.%d annotation=value-%d "
+        "cpu=x86_64 os=Linux module=libc.so.6 guid=%08x",
+        i % 7,
+        i,
+        i * 2654435761u);
+    samples += sample;
+    sample_sizes.push_back(sample.size());
+  }
+
+  std::string dictionary_data(4096, '\0');
+  const size_t dictionary_size =
+      ZDICT_trainFromBuffer(&dictionary_data[0],
+                            dictionary_data.size(),
+                            samples.data(),
+                            sample_sizes.data(),
+                            static_cast<unsigned int>(sample_sizes.size()));
+  ASSERT_FALSE(ZDICT_isError(dictionary_size))
+      << ZDICT_getErrorName(dictionary_size);
+  dictionary_data.resize(dictionary_size);
+
+  ZstdDictionary dictionary;
+  ASSERT_TRUE(dictionary.InitializeWithData(dictionary_data));
+  EXPECT_NE(dictionary.id(), 0u);
+
+  const std::string string = samples.substr(0, sample_sizes[0]);
+  ZstdHTTPBodyStream plain_stream(
+      std::make_unique<StringHTTPBodyStream>(string));
+  const std::string plain = ReadStreamToString(&plain_stream);
+  ZstdHTTPBodyStream dictionary_stream(
+      std::make_unique<StringHTTPBodyStream>(string), 0, &dictionary);
+  const std::string compressed = ReadStreamToString(&dictionary_stream);
+  EXPECT_LT(compressed.size(), plain.size());
+
+  // The dictionary’s ID is in the frame header.
+  EXPECT_EQ(ZSTD_getDictID_fromFrame(compressed.data(), compressed.size()),
+            dictionary.id());
+
+  std::string decompressed;
+  ASSERT_NO_FATAL_FAILURE(
+      ZstdDecompress(compressed, &decompressed, &dictionary));
+  EXPECT_EQ(decompressed, string);
+}
+
+TEST(ZstdDictionary, RawContent) {
+  // Without a dictionary header, there is no ID to identify the dictionary.
+  ZstdDictionary dictionary;
+  EXPECT_FALSE(dictionary.InitializeWithData(MakeString(1024)));
+}
+
+#else  // CRASHPAD_ZSTD_SUPPORTED
+
+TEST(ZstdHTTPBodyStream, NotSupported) {
+  EXPECT_FALSE(ZstdHTTPBodyStream::IsSupported());
+
+  ZstdHTTPBodyStream zstd_stream(
+      std::make_unique<StringHTTPBodyStream>(std::string("data")));
+  uint8_t buffer[16];
+  EXPECT_EQ(zstd_stream.GetBytesBuffer(buffer, sizeof(buffer)), -1);
+
+  ZstdDictionary dictionary;
+  EXPECT_FALSE(dictionary.InitializeWithData(std::string("dictionary")));
+}
+
+#endif  // CRASHPAD_ZSTD_SUPPORTED
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
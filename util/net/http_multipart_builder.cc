@@ -17,14 +17,19 @@
 #include <string.h>
 #include <sys/types.h>
 
+#include <memory>
 #include <utility>
 #include <vector>
 
 #include "base/check.h"
+#include "base/check_op.h"
 #include "base/rand_util.h"
+#include "base/strings/string_number_conversions.h"
 #include "base/strings/stringprintf.h"
 #include "util/net/http_body.h"
 #include "util/net/http_body_gzip.h"
+#include "util/net/http_body_pipelined.h"
+#include "util/net/http_body_zstd.h"
 
 namespace crashpad {
 
@@ -116,13 +121,40 @@ HTTPMultipartBuilder::HTTPMultipartBuilder()
     : boundary_(GenerateBoundaryString()),
       form_data_(),
       file_attachments_(),
-      gzip_enabled_(false) {}
+      compression_(Compression::kNone),
+      compression_level_(0),
+      compression_threads_(1),
+      zstd_dictionary_(nullptr),
+      pipeline_enabled_(false) {}
 
 HTTPMultipartBuilder::~HTTPMultipartBuilder() {
 }
 
 void HTTPMultipartBuilder::SetGzipEnabled(bool gzip_enabled) {
-  gzip_enabled_ = gzip_enabled;
+  SetCompression(gzip_enabled ? Compression::kGzip : Compression::kNone);
+}
+
+void HTTPMultipartBuilder::SetCompression(Compression compression,
+                                          int level) {
+  DCHECK(compression != Compression::kZstd ||
+         ZstdHTTPBodyStream::IsSupported());
+  compression_ = compression;
+  compression_level_ = level;
+}
+
+void HTTPMultipartBuilder::SetPipelineEnabled(bool pipeline_enabled) {
+  pipeline_enabled_ = pipeline_enabled;
+}
+
+void HTTPMultipartBuilder::SetCompressionThreads(
+    unsigned int compression_threads) {
+  DCHECK_GE(compression_threads, 1u);
+  compression_threads_ = compression_threads;
+}
+
+void HTTPMultipartBuilder::SetZstdDictionary(
+    const ZstdDictionary* dictionary) {
+  zstd_dictionary_ = dictionary;
 }
 
 void HTTPMultipartBuilder::SetFormData(const std::string& key,
@@ -153,6 +185,66 @@ void HTTPMultipartBuilder::SetFileAttachment(
 }
 
 std::unique_ptr<HTTPBodyStream> HTTPMultipartBuilder::GetBodyStream() {
+  std::unique_ptr<HTTPBodyStream> stream = GetUncompressedBodyStream();
+  if (compression_ != Compression::kNone) {
+    if (pipeline_enabled_) {
+      // Read attachments on their own thread, ahead of compression.
+      stream = std::make_unique<PipelinedHTTPBodyStream>(std::move(stream));
+    }
+    if (compression_ == Compression::kZstd) {
+      stream = std::make_unique<ZstdHTTPBodyStream>(
+          std::move(stream), compression_level_, zstd_dictionary_);
+    } else {
+      stream = std::make_unique<GzipHTTPBodyStream>(
+          std::move(stream), compression_level_, compression_threads_);
+    }
+  }
+  if (pipeline_enabled_) {
+    stream = std::make_unique<PipelinedHTTPBodyStream>(std::move(stream));
+  }
+  return stream;
+}
+
+void HTTPMultipartBuilder::PopulateContentHeaders(
+    HTTPHeaders* http_headers) const {
+  std::string content_type =
+      base::StringPrintf("multipart/form-data; boundary=%s", boundary_.c_str());
+  (*http_headers)[kContentType] = content_type;
+
+  http_headers->erase(kContentLength);
+  switch (compression_) {
+    case Compression::kNone: {
+      uint64_t content_length;
+      if (GetUncompressedBodyStream()->GetRemainingSize(&content_length)) {
+        (*http_headers)[kContentLength] = base::NumberToString(content_length);
+      }
+      break;
+    }
+    case Compression::kGzip:
+      (*http_headers)[kContentEncoding] = "gzip";
+      break;
+    case Compression::kZstd:
+      (*http_headers)[kContentEncoding] = "zstd";
+      if (zstd_dictionary_) {
+        (*http_headers)[kZstdDictionaryIDHeader] =
+            base::NumberToString(zstd_dictionary_->id());
+      }
+      break;
+  }
+}
+
+void HTTPMultipartBuilder::EraseKey(const std::string& key) {
+  auto data_it = form_data_.find(key);
+  if (data_it != form_data_.end())
+    form_data_.erase(data_it);
+
+  auto file_it = file_attachments_.find(key);
+  if (file_it != file_attachments_.end())
+    file_attachments_.erase(file_it);
+}
+
+std::unique_ptr<HTTPBodyStream>
+HTTPMultipartBuilder::GetUncompressedBodyStream() const {
   // The objects inserted into this vector will be owned by the returned
   // CompositeHTTPBodyStream. Take care to not early-return without deleting
   // this memory.
@@ -182,34 +274,7 @@ std::unique_ptr<HTTPBodyStream> HTTPMultipartBuilder::GetBodyStream() {
   streams.push_back(
       new StringHTTPBodyStream("--"  + boundary_ + "--" + kCRLF));
 
-  auto composite =
-      std::unique_ptr<HTTPBodyStream>(new CompositeHTTPBodyStream(streams));
-  if (gzip_enabled_) {
-    return std::unique_ptr<HTTPBodyStream>(
-        new GzipHTTPBodyStream(std::move(composite)));
-  }
-  return composite;
-}
-
-void HTTPMultipartBuilder::PopulateContentHeaders(
-    HTTPHeaders* http_headers) const {
-  std::string content_type =
-      base::StringPrintf("multipart/form-data; boundary=%s", boundary_.c_str());
-  (*http_headers)[kContentType] = content_type;
-
-  if (gzip_enabled_) {
-    (*http_headers)[kContentEncoding] = "gzip";
-  }
-}
-
-void HTTPMultipartBuilder::EraseKey(const std::string& key) {
-  auto data_it = form_data_.find(key);
-  if (data_it != form_data_.end())
-    form_data_.erase(data_it);
-
-  auto file_it = file_attachments_.find(key);
-  if (file_it != file_attachments_.end())
-    file_attachments_.erase(file_it);
+  return std::make_unique<CompositeHTTPBodyStream>(streams);
 }
 
 }  // namespace crashpad
@@ -25,6 +25,12 @@
 namespace crashpad {
 
 class HTTPBodyStream;
+class ZstdDictionary;
+
+//! \brief The header name `"Crashpad-Zstd-Dictionary-ID"`, carrying the
+//!     decimal ID of the dictionary that a `zstd`-coded body was compressed
+//!     with. See HTTPMultipartBuilder::SetZstdDictionary().
+constexpr char kZstdDictionaryIDHeader[] = "Crashpad-Zstd-Dictionary-ID";
 
 //! \brief This class is used to build a MIME multipart message, conforming to
 //!     RFC 2046, for use as a HTTP request body.
@@ -37,15 +43,70 @@ class HTTPMultipartBuilder {
 
   ~HTTPMultipartBuilder();
 
+  //! \brief The compression that can be applied to the body stream.
+  enum class Compression {
+    //! \brief The body stream is not compressed.
+    kNone,
+
+    //! \brief The body stream is compressed by GzipHTTPBodyStream, and sent
+    //!     with `Content-Encoding: gzip`.
+    kGzip,
+
+    //! \brief The body stream is compressed by ZstdHTTPBodyStream, and sent
+    //!     with `Content-Encoding: zstd`.
+    kZstd,
+  };
+
   //! \brief Enables or disables `gzip` compression.
   //!
   //! \param[in] gzip_enabled Whether to enable or disable `gzip` compression.
   //!
   //! When `gzip` compression is enabled, the body stream returned by
   //! GetBodyStream() will be `gzip`-compressed, and the content headers set by
-  //! PopulateContentHeaders() will contain `Content-Encoding: gzip`.
+  //! PopulateContentHeaders() will contain `Content-Encoding: gzip`. This is
+  //! equivalent to calling SetCompression() with Compression::kGzip or
+  //! Compression::kNone.
   void SetGzipEnabled(bool gzip_enabled);
 
+  //! \brief Sets the compression applied to the body stream.
+  //!
+  //! \param[in] compression The compression to apply. The body stream
+  //!     returned by GetBodyStream() will be compressed accordingly, and the
+  //!     content headers set by PopulateContentHeaders() will contain the
+  //!     matching `Content-Encoding`. Compression::kZstd may only be used if
+  //!     ZstdHTTPBodyStream::IsSupported() returns `true`.
+  //! \param[in] level The compression level, or `0` for the default level of
+  //!     \a compression. See GzipHTTPBodyStream and ZstdHTTPBodyStream for the
+  //!     levels that they accept.
+  void SetCompression(Compression compression, int level = 0);
+
+  //! \brief Enables or disables pipelining of the body stream.
+  //!
+  //! \param[in] pipeline_enabled Whether to enable or disable pipelining.
+  //!
+  //! When pipelining is enabled, the body stream returned by GetBodyStream()
+  //! reads attachments and, if compression is enabled, compresses them
+  //! on separate threads using PipelinedHTTPBodyStream, so that this work
+  //! overlaps with the reader’s use of the stream.
+  void SetPipelineEnabled(bool pipeline_enabled);
+
+  //! \brief Sets the number of threads used to compress the body stream.
+  //!
+  //! \param[in] compression_threads The number of threads to compress on,
+  //!     which must be at least `1`. This only affects `gzip` compression. See
+  //!     GzipHTTPBodyStream. The default is `1`.
+  void SetCompressionThreads(unsigned int compression_threads);
+
+  //! \brief Sets the dictionary used for `zstd` compression.
+  //!
+  //! \param[in] dictionary The dictionary to compress with, or `nullptr` to
+  //!     compress without one, which is the default. This only affects
+  //!     Compression::kZstd. When it is used, the content headers set by
+  //!     PopulateContentHeaders() will also contain #kZstdDictionaryIDHeader.
+  //!     If set, the dictionary must outlive this object and the body streams
+  //!     returned by GetBodyStream().
+  void SetZstdDictionary(const ZstdDictionary* dictionary);
+
   //! \brief Sets a `Content-Disposition: form-data` key-value pair.
   //!
   //! \param[in] key The key of the form data, specified as the `name` in the
@@ -81,6 +142,12 @@ class HTTPMultipartBuilder {
   //!
   //! Any headers that this method adds will replace existing headers by the
   //! same name in \a http_headers.
+  //!
+  //! When the body stream isn’t compressed, its size is known in advance, and
+  //! a `Content-Length` header is added, so that it needn’t be sent with
+  //! `Transfer-Encoding: chunked`. This must be called before the contents of
+  //! any file attachments have been read. When the body stream is compressed,
+  //! any existing `Content-Length` header is removed.
   void PopulateContentHeaders(HTTPHeaders* http_headers) const;
 
  private:
@@ -94,10 +161,17 @@ class HTTPMultipartBuilder {
   // uniqueness across the entire HTTP body.
   void EraseKey(const std::string& key);
 
+  // Returns the body stream before any compression or pipelining is applied.
+  std::unique_ptr<HTTPBodyStream> GetUncompressedBodyStream() const;
+
   std::string boundary_;
   std::map<std::string, std::string> form_data_;
   std::map<std::string, FileAttachment> file_attachments_;
-  bool gzip_enabled_;
+  Compression compression_;
+  int compression_level_;
+  unsigned int compression_threads_;
+  const ZstdDictionary* zstd_dictionary_;  // weak
+  bool pipeline_enabled_;
 };
 
 }  // namespace crashpad
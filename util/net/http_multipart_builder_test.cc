@@ -18,11 +18,13 @@
 
 #include <vector>
 
+#include "base/strings/string_number_conversions.h"
 #include "gtest/gtest.h"
 #include "test/gtest_death.h"
 #include "test/test_paths.h"
 #include "util/net/http_body.h"
 #include "util/net/http_body_test_util.h"
+#include "util/net/http_body_zstd.h"
 
 namespace crashpad {
 namespace test {
@@ -157,6 +159,89 @@ TEST(HTTPMultipartBuilder, ThreeFileAttachments) {
   EXPECT_EQ(lines_it, lines.end());
 }
 
+TEST(HTTPMultipartBuilder, ContentLength) {
+  HTTPMultipartBuilder builder;
+  builder.SetFormData("key", "value");
+
+  base::FilePath ascii_http_body_path = TestPaths::TestDataRoot().Append(
+      FILE_PATH_LITERAL("util/net/testdata/ascii_http_body.txt"));
+  FileReader reader;
+  ASSERT_TRUE(reader.Open(ascii_http_body_path));
+  builder.SetFileAttachment("file", "minidump.dmp", &reader, "");
+
+  // Finding the length of the attachment doesn’t consume it.
+  HTTPHeaders headers;
+  builder.PopulateContentHeaders(&headers);
+  EXPECT_EQ(reader.SeekGet(), 0);
+
+  const std::string contents =
+      ReadStreamToString(builder.GetBodyStream().get());
+  ASSERT_NE(contents.find("This is a test.\n"), std::string::npos);
+  EXPECT_EQ(headers[kContentLength], base::NumberToString(contents.size()));
+}
+
+TEST(HTTPMultipartBuilder, PipelineEnabled) {
+  HTTPMultipartBuilder builder;
+  builder.SetFormData("key", "value");
+
+  base::FilePath ascii_http_body_path = TestPaths::TestDataRoot().Append(
+      FILE_PATH_LITERAL("util/net/testdata/ascii_http_body.txt"));
+  FileReader reader;
+  ASSERT_TRUE(reader.Open(ascii_http_body_path));
+  builder.SetFileAttachment("file", "minidump.dmp", &reader, "");
+
+  std::unique_ptr<HTTPBodyStream> body(builder.GetBodyStream());
+  ASSERT_TRUE(body.get());
+  const std::string contents = ReadStreamToString(body.get());
+  ASSERT_FALSE(contents.empty());
+
+  // Pipelining doesn’t change the body.
+  ASSERT_TRUE(reader.SeekSet(0));
+  builder.SetPipelineEnabled(true);
+  body = builder.GetBodyStream();
+  ASSERT_TRUE(body.get());
+  EXPECT_EQ(ReadStreamToString(body.get(), 7), contents);
+}
+
+TEST(HTTPMultipartBuilder, Compression) {
+  HTTPMultipartBuilder builder;
+  builder.SetFormData("key", "value");
+
+  HTTPHeaders headers;
+  builder.PopulateContentHeaders(&headers);
+  EXPECT_EQ(headers.find(kContentEncoding), headers.end());
+  const std::string uncompressed = ReadStreamToString(
+      builder.GetBodyStream().get());
+  EXPECT_EQ(headers[kContentLength], base::NumberToString(uncompressed.size()));
+
+  // The size of a compressed body isn’t known in advance, so it’s sent
+  // chunked, replacing any Content-Length header already present.
+  builder.SetCompression(HTTPMultipartBuilder::Compression::kGzip, 1);
+  builder.PopulateContentHeaders(&headers);
+  EXPECT_EQ(headers[kContentEncoding], "gzip");
+  EXPECT_EQ(headers.find(kContentLength), headers.end());
+  std::string compressed = ReadStreamToString(builder.GetBodyStream().get());
+  ASSERT_GE(compressed.size(), 2u);
+  EXPECT_EQ(compressed.substr(0, 2), "\37\213");
+
+  if (ZstdHTTPBodyStream::IsSupported()) {
+    builder.SetPipelineEnabled(true);
+    builder.SetCompression(HTTPMultipartBuilder::Compression::kZstd);
+    headers.clear();
+    builder.PopulateContentHeaders(&headers);
+    EXPECT_EQ(headers[kContentEncoding], "zstd");
+    compressed = ReadStreamToString(builder.GetBodyStream().get());
+    ASSERT_GE(compressed.size(), 4u);
+    EXPECT_EQ(compressed.substr(0, 4), "\x28\xb5\x2f\xfd");
+  }
+
+  builder.SetGzipEnabled(false);
+  headers.clear();
+  builder.PopulateContentHeaders(&headers);
+  EXPECT_EQ(headers.find(kContentEncoding), headers.end());
+  EXPECT_EQ(ReadStreamToString(builder.GetBodyStream().get()), uncompressed);
+}
+
 TEST(HTTPMultipartBuilder, OverwriteFormDataWithEscapedKey) {
   HTTPMultipartBuilder builder;
   static constexpr char kKey[] = "a 100% \"silly\"\r\ntest";
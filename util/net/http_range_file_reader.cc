@@ -0,0 +1,322 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/net/http_range_file_reader.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+#include "base/check_op.h"
+#include "base/logging.h"
+#include "base/numerics/safe_math.h"
+#include "base/strings/stringprintf.h"
+#include "util/net/http_body.h"
+#include "util/net/http_transport.h"
+#include "util/stdlib/string_number_conversion.h"
+
+namespace crashpad {
+
+namespace {
+
+constexpr char kContentRange[] = "Content-Range";
+
+// Reads the size of the whole file from the Content-Range of a response, with
+// an error logged if it is missing or invalid.
+bool GetCompleteLength(const HTTPTransport* transport, FileOffset* size) {
+  std::string content_range;
+  if (!transport->GetResponseHeader(kContentRange, &content_range)) {
+    LOG(ERROR) << "no " << kContentRange;
+    return false;
+  }
+
+  const size_t slash = content_range.rfind('/');
+  int64_t value;
+  if (slash == std::string::npos ||
+      !StringToNumber(content_range.substr(slash + 1), &value) || value < 0) {
+    LOG(ERROR) << "invalid " << kContentRange << " " << content_range;
+    return false;
+  }
+  *size = value;
+  return true;
+}
+
+}  // namespace
+
+HTTPRangeFileReader::HTTPRangeFileReader(size_t block_size,
+                                         size_t cache_blocks)
+    : FileReaderInterface(),
+      headers_(),
+      url_(),
+      blocks_(),
+      whole_file_(),
+      timeout_(15.0),
+      keep_alive_timeout_(60.0),
+      block_size_(block_size),
+      cache_blocks_(cache_blocks),
+      use_count_(0),
+      request_count_(0),
+      size_(-1),
+      position_(0),
+      http2_(false),
+      whole_file_fetched_(false) {
+  DCHECK_GT(block_size_, 0u);
+  DCHECK_GT(cache_blocks_, 0u);
+}
+
+HTTPRangeFileReader::~HTTPRangeFileReader() {}
+
+void HTTPRangeFileReader::SetHeader(const std::string& header,
+                                    const std::string& value) {
+  headers_[header] = value;
+}
+
+void HTTPRangeFileReader::SetTimeout(double timeout) {
+  timeout_ = timeout;
+}
+
+void HTTPRangeFileReader::SetKeepAliveTimeout(double timeout) {
+  keep_alive_timeout_ = timeout;
+}
+
+void HTTPRangeFileReader::SetHTTP2(bool http2) {
+  http2_ = http2;
+}
+
+bool HTTPRangeFileReader::Initialize(const std::string& url) {
+  url_ = url;
+  blocks_.clear();
+  whole_file_.clear();
+  whole_file_fetched_ = false;
+  size_ = -1;
+  position_ = 0;
+
+  std::unique_ptr<HTTPTransport> transport =
+      CreateTransport(0, static_cast<FileOffset>(block_size_) - 1);
+  if (!transport) {
+    return false;
+  }
+  std::string response_body;
+  transport->ExecuteSynchronously(&response_body);
+  ++request_count_;
+
+  const int status = transport->GetResponseStatus();
+  switch (status) {
+    case 200:
+      // The server doesn’t support range requests, and sent the whole file.
+      whole_file_.swap(response_body);
+      whole_file_fetched_ = true;
+      size_ = static_cast<FileOffset>(whole_file_.size());
+      return true;
+
+    case 206: {
+      FileOffset size;
+      if (!GetCompleteLength(transport.get(), &size)) {
+        return false;
+      }
+      if (static_cast<uint64_t>(response_body.size()) !=
+          std::min(static_cast<uint64_t>(block_size_),
+                   static_cast<uint64_t>(size))) {
+        LOG(ERROR) << "unexpected response size " << response_body.size();
+        return false;
+      }
+      size_ = size;
+      CacheBlock(0, std::move(response_body));
+      return true;
+    }
+
+    case 416: {
+      // No range of an empty file can be satisfied.
+      FileOffset size;
+      if (!GetCompleteLength(transport.get(), &size)) {
+        return false;
+      }
+      if (size != 0) {
+        LOG(ERROR) << "range not satisfiable for size " << size;
+        return false;
+      }
+      size_ = 0;
+      return true;
+    }
+
+    default:
+      LOG(ERROR) << "HTTP status " << status;
+      return false;
+  }
+}
+
+FileOperationResult HTTPRangeFileReader::Read(void* data, size_t size) {
+  DCHECK_GE(size_, 0);
+
+  if (position_ >= size_) {
+    return 0;
+  }
+  const uint64_t remaining = static_cast<uint64_t>(size_ - position_);
+  if (size > remaining) {
+    size = static_cast<size_t>(remaining);
+  }
+  size = std::min(
+      size,
+      static_cast<size_t>(std::numeric_limits<FileOperationResult>::max()));
+
+  if (whole_file_fetched_) {
+    memcpy(data, whole_file_.data() + position_, size);
+    position_ += size;
+    return size;
+  }
+
+  uint8_t* const bytes = static_cast<uint8_t*>(data);
+  const uint64_t last_index = (position_ + size - 1) / block_size_;
+  size_t copied = 0;
+  while (copied < size) {
+    const uint64_t offset = position_ + copied;
+    const uint64_t index = offset / block_size_;
+    auto block = blocks_.find(index);
+    if (block == blocks_.end()) {
+      // Fetch this block along with the missing blocks after it that the read
+      // also needs, in a single request.
+      uint64_t count = 1;
+      while (count < cache_blocks_ && index + count <= last_index &&
+             blocks_.find(index + count) == blocks_.end()) {
+        ++count;
+      }
+      if (!FetchBlocks(index, count)) {
+        return -1;
+      }
+      block = blocks_.find(index);
+      DCHECK(block != blocks_.end());
+    }
+    block->second.last_use = ++use_count_;
+
+    const size_t block_offset =
+        static_cast<size_t>(offset - index * block_size_);
+    DCHECK_LT(block_offset, block->second.data.size());
+    const size_t copy_size =
+        std::min(block->second.data.size() - block_offset, size - copied);
+    memcpy(bytes + copied, block->second.data.data() + block_offset, copy_size);
+    copied += copy_size;
+  }
+
+  position_ += size;
+  return size;
+}
+
+FileOffset HTTPRangeFileReader::Seek(FileOffset offset, int whence) {
+  DCHECK_GE(size_, 0);
+
+  FileOffset base_offset;
+  switch (whence) {
+    case SEEK_SET:
+      base_offset = 0;
+      break;
+
+    case SEEK_CUR:
+      base_offset = position_;
+      break;
+
+    case SEEK_END:
+      base_offset = size_;
+      break;
+
+    default:
+      LOG(ERROR) << "Seek(): invalid whence " << whence;
+      return -1;
+  }
+
+  base::CheckedNumeric<FileOffset> new_offset(base_offset);
+  new_offset += offset;
+  FileOffset new_position;
+  if (!new_offset.AssignIfValid(&new_position) || new_position < 0) {
+    LOG(ERROR) << "Seek(): new_offset invalid";
+    return -1;
+  }
+
+  position_ = new_position;
+  return position_;
+}
+
+std::unique_ptr<HTTPTransport> HTTPRangeFileReader::CreateTransport(
+    FileOffset start,
+    FileOffset end) {
+  std::unique_ptr<HTTPTransport> transport(HTTPTransport::Create());
+  if (!transport) {
+    return nullptr;
+  }
+  transport->SetURL(url_);
+  transport->SetMethod("GET");
+  for (const auto& header : headers_) {
+    transport->SetHeader(header.first, header.second);
+  }
+  transport->SetHeader(
+      "Range",
+      base::StringPrintf("bytes=%" PRId64 "-%" PRId64,
+                         static_cast<int64_t>(start),
+                         static_cast<int64_t>(end)));
+  transport->SetBodyStream(std::make_unique<StringHTTPBodyStream>(""));
+  transport->SetTimeout(timeout_);
+  transport->SetKeepAliveTimeout(keep_alive_timeout_);
+  transport->SetHTTP2(http2_);
+  return transport;
+}
+
+bool HTTPRangeFileReader::FetchBlocks(uint64_t first_block, uint64_t count) {
+  const uint64_t start = first_block * block_size_;
+  const uint64_t end =
+      std::min(start + count * block_size_, static_cast<uint64_t>(size_)) - 1;
+  std::unique_ptr<HTTPTransport> transport = CreateTransport(
+      static_cast<FileOffset>(start), static_cast<FileOffset>(end));
+  if (!transport) {
+    return false;
+  }
+  std::string response_body;
+  transport->ExecuteSynchronously(&response_body);
+  ++request_count_;
+
+  if (transport->GetResponseStatus() != 206 ||
+      static_cast<uint64_t>(response_body.size()) != end - start + 1) {
+    LOG(ERROR) << "range request failed, HTTP status "
+               << transport->GetResponseStatus();
+    return false;
+  }
+
+  for (uint64_t index = 0; index < count; ++index) {
+    CacheBlock(first_block + index,
+               response_body.substr(static_cast<size_t>(index * block_size_),
+                                    block_size_));
+  }
+  return true;
+}
+
+void HTTPRangeFileReader::CacheBlock(uint64_t index, std::string data) {
+  if (blocks_.size() >= cache_blocks_ && blocks_.find(index) == blocks_.end()) {
+    auto oldest = std::min_element(
+        blocks_.begin(),
+        blocks_.end(),
+        [](const std::pair<const uint64_t, Block>& left,
+           const std::pair<const uint64_t, Block>& right) {
+          return left.second.last_use < right.second.last_use;
+        });
+    blocks_.erase(oldest);
+  }
+
+  Block& block = blocks_[index];
+  block.data = std::move(data);
+  block.last_use = ++use_count_;
+}
+
+}  // namespace crashpad
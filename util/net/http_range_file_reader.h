@@ -0,0 +1,139 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_UTIL_NET_HTTP_RANGE_FILE_READER_H_
+#define CRASHPAD_UTIL_NET_HTTP_RANGE_FILE_READER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <map>
+#include <memory>
+#include <string>
+
+#include "util/file/file_io.h"
+#include "util/file/file_reader.h"
+
+namespace crashpad {
+
+class HTTPTransport;
+
+//! \brief A file reader that reads a file on a HTTP server with range
+//!     requests, fetching only the parts of it that are read.
+//!
+//! The file is fetched in blocks, which are kept in a cache of limited size so
+//! that nearby and repeated reads don’t make further requests. A read that
+//! needs several blocks that aren’t cached fetches each run of consecutive
+//! missing blocks with a single request. Connections are kept open between
+//! requests.
+//!
+//! This makes it cheap to open a large file on a server to examine only a part
+//! of it, such as by ProcessSnapshotMinidump::InitializeLazily(). The file must
+//! not change while it is read. If the server doesn’t support range requests,
+//! the whole file is fetched by Initialize() and kept in memory.
+class HTTPRangeFileReader : public FileReaderInterface {
+ public:
+  //! \brief The number of bytes fetched at once if not specified otherwise.
+  static constexpr size_t kDefaultBlockSize = 64 * 1024;
+
+  //! \brief The number of blocks cached if not specified otherwise.
+  static constexpr size_t kDefaultCacheBlocks = 64;
+
+  //! \param[in] block_size The number of bytes fetched at once.
+  //! \param[in] cache_blocks The maximum number of blocks cached. This is also
+  //!     the most that a single request fetches.
+  explicit HTTPRangeFileReader(size_t block_size = kDefaultBlockSize,
+                               size_t cache_blocks = kDefaultCacheBlocks);
+
+  HTTPRangeFileReader(const HTTPRangeFileReader&) = delete;
+  HTTPRangeFileReader& operator=(const HTTPRangeFileReader&) = delete;
+
+  ~HTTPRangeFileReader() override;
+
+  //! \brief Sets a HTTP header-value pair sent with each request, such as for
+  //!     authorization. See HTTPTransport::SetHeader().
+  void SetHeader(const std::string& header, const std::string& value);
+
+  //! \brief Sets the timeout for each request. See HTTPTransport::SetTimeout().
+  void SetTimeout(double timeout);
+
+  //! \brief Sets the time for which connections are kept open between
+  //!     requests. See HTTPTransport::SetKeepAliveTimeout().
+  void SetKeepAliveTimeout(double timeout);
+
+  //! \brief Allows requests to be made using HTTP/2. See
+  //!     HTTPTransport::SetHTTP2().
+  void SetHTTP2(bool http2);
+
+  //! \brief Fetches the first block of the file at \a url, learning the size
+  //!     of the file, and positions the reader at the start of the file.
+  //!
+  //! This method must be called successfully before the file is read or
+  //! sought, and after any of the setters that are to apply.
+  //!
+  //! \param[in] url The URL of the file.
+  //!
+  //! \return `true` on success. `false` on failure, with a message logged.
+  bool Initialize(const std::string& url);
+
+  //! \brief Returns the number of requests made, for diagnostics.
+  size_t request_count() const { return request_count_; }
+
+  // FileReaderInterface:
+  FileOperationResult Read(void* data, size_t size) override;
+
+  // FileSeekerInterface:
+  FileOffset Seek(FileOffset offset, int whence) override;
+
+ private:
+  struct Block {
+    std::string data;
+    uint64_t last_use;
+  };
+
+  // Creates a transport for a request for the bytes [start, end] of the file.
+  std::unique_ptr<HTTPTransport> CreateTransport(FileOffset start,
+                                                 FileOffset end);
+
+  // Fetches count blocks starting at first_block with a single request, and
+  // caches them.
+  bool FetchBlocks(uint64_t first_block, uint64_t count);
+
+  // Adds a block to the cache, evicting the least recently used block if the
+  // cache is full.
+  void CacheBlock(uint64_t index, std::string data);
+
+  std::map<std::string, std::string> headers_;
+  std::string url_;
+  std::map<uint64_t, Block> blocks_;
+
+  // The whole file, if the server didn’t honor the range request made by
+  // Initialize().
+  std::string whole_file_;
+
+  double timeout_;
+  double keep_alive_timeout_;
+  size_t block_size_;
+  size_t cache_blocks_;
+  uint64_t use_count_;
+  size_t request_count_;
+  FileOffset size_;
+  FileOffset position_;
+  bool http2_;
+  bool whole_file_fetched_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_UTIL_NET_HTTP_RANGE_FILE_READER_H_
@@ -0,0 +1,305 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/net/http_resumable_upload.h"
+
+#include <inttypes.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <utility>
+
+#include "base/logging.h"
+#include "base/strings/stringprintf.h"
+#include "util/net/http_body.h"
+#include "util/net/http_headers.h"
+#include "util/net/http_transport.h"
+#include "util/net/url.h"
+#include "util/stdlib/string_number_conversion.h"
+
+namespace crashpad {
+
+namespace {
+
+constexpr char kTusResumable[] = "Tus-Resumable";
+constexpr char kTusVersion[] = "1.0.0";
+constexpr char kUploadLength[] = "Upload-Length";
+constexpr char kUploadMetadata[] = "Upload-Metadata";
+constexpr char kUploadOffset[] = "Upload-Offset";
+
+std::string Base64Encode(const std::string& data) {
+  static constexpr char kAlphabet[] =
+      "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  std::string encoded;
+  encoded.reserve((data.size() + 2) / 3 * 4);
+  for (size_t index = 0; index < data.size(); index += 3) {
+    const size_t count = std::min(data.size() - index, size_t{3});
+    uint32_t group = static_cast<uint8_t>(data[index]) << 16;
+    if (count > 1) {
+      group |= static_cast<uint8_t>(data[index + 1]) << 8;
+    }
+    if (count > 2) {
+      group |= static_cast<uint8_t>(data[index + 2]);
+    }
+    encoded += kAlphabet[(group >> 18) & 0x3f];
+    encoded += kAlphabet[(group >> 12) & 0x3f];
+    encoded += count > 1 ? kAlphabet[(group >> 6) & 0x3f] : '=';
+    encoded += count > 2 ? kAlphabet[group & 0x3f] : '=';
+  }
+  return encoded;
+}
+
+// Reads the server’s offset from a response, with an error logged if it is
+// missing or invalid.
+bool GetUploadOffset(const HTTPTransport* transport,
+                     FileOffset size,
+                     FileOffset* offset) {
+  std::string offset_string;
+  int64_t value;
+  if (!transport->GetResponseHeader(kUploadOffset, &offset_string) ||
+      !StringToNumber(offset_string, &value) || value < 0 || value > size) {
+    LOG(ERROR) << "invalid " << kUploadOffset;
+    return false;
+  }
+  *offset = value;
+  return true;
+}
+
+// Reads at most size bytes from a FileReaderInterface.
+class LimitedFileReaderHTTPBodyStream : public HTTPBodyStream {
+ public:
+  LimitedFileReaderHTTPBodyStream(FileReaderInterface* reader, size_t size)
+      : HTTPBodyStream(), reader_(reader), remaining_(size) {}
+
+  LimitedFileReaderHTTPBodyStream(const LimitedFileReaderHTTPBodyStream&) =
+      delete;
+  LimitedFileReaderHTTPBodyStream& operator=(
+      const LimitedFileReaderHTTPBodyStream&) = delete;
+
+  ~LimitedFileReaderHTTPBodyStream() override {}
+
+  // HTTPBodyStream:
+  FileOperationResult GetBytesBuffer(uint8_t* buffer, size_t max_len) override {
+    if (remaining_ == 0) {
+      return 0;
+    }
+    const FileOperationResult rv =
+        reader_->Read(buffer, std::min(max_len, remaining_));
+    if (rv == 0) {
+      LOG(ERROR) << "unexpected end of upload body";
+      return -1;
+    }
+    if (rv > 0) {
+      remaining_ -= rv;
+    }
+    return rv;
+  }
+
+ private:
+  FileReaderInterface* reader_;  // weak
+  size_t remaining_;
+};
+
+}  // namespace
+
+HTTPResumableUpload::HTTPResumableUpload()
+    : metadata_(),
+      transport_factory_([](const std::string& url) {
+        std::unique_ptr<HTTPTransport> transport(HTTPTransport::Create());
+        if (transport) {
+          transport->SetURL(url);
+        }
+        return transport;
+      }),
+      chunk_size_(kDefaultChunkSize),
+      lock_(),
+      transport_(nullptr),
+      canceled_(false) {}
+
+HTTPResumableUpload::~HTTPResumableUpload() {}
+
+void HTTPResumableUpload::SetMetadata(const std::string& key,
+                                      const std::string& value) {
+  DCHECK_EQ(key.find_first_of(" ,"), std::string::npos);
+  metadata_[key] = value;
+}
+
+void HTTPResumableUpload::SetTransportFactory(
+    TransportFactory transport_factory) {
+  transport_factory_ = std::move(transport_factory);
+}
+
+void HTTPResumableUpload::SetChunkSize(size_t chunk_size) {
+  DCHECK_GT(chunk_size, 0u);
+  chunk_size_ = chunk_size;
+}
+
+void HTTPResumableUpload::Cancel() {
+  base::AutoLock lock(lock_);
+  canceled_ = true;
+  if (transport_) {
+    transport_->Cancel();
+  }
+}
+
+bool HTTPResumableUpload::Create(const std::string& url,
+                                 FileOffset size,
+                                 std::string* location) {
+  std::unique_ptr<HTTPTransport> transport = CreateTransport(url, "POST");
+  if (!transport) {
+    return false;
+  }
+  transport->SetHeader(
+      kUploadLength,
+      base::StringPrintf("%" PRId64, static_cast<int64_t>(size)));
+  if (!metadata_.empty()) {
+    std::string metadata;
+    for (const auto& kv : metadata_) {
+      if (!metadata.empty()) {
+        metadata += ",";
+      }
+      metadata += kv.first + " " + Base64Encode(kv.second);
+    }
+    transport->SetHeader(kUploadMetadata, metadata);
+  }
+  transport->SetHeader(kContentLength, "0");
+  transport->SetBodyStream(std::make_unique<StringHTTPBodyStream>(""));
+
+  std::string response_body;
+  Execute(transport.get(), &response_body);
+  std::string reference;
+  if (transport->GetResponseStatus() != 201 ||
+      !transport->GetResponseHeader("Location", &reference) ||
+      reference.empty()) {
+    LOG(ERROR) << "upload creation failed, HTTP status "
+               << transport->GetResponseStatus();
+    return false;
+  }
+
+  *location = ResolveURLReference(url, reference);
+  return !location->empty();
+}
+
+HTTPResumableUpload::Result HTTPResumableUpload::Send(
+    const std::string& location,
+    FileReaderInterface* body,
+    FileOffset size,
+    std::string* response_body) {
+  const FileOffset body_start = body->SeekGet();
+  if (body_start < 0) {
+    return Result::kRetry;
+  }
+
+  // Ask the server how much of the body it already has.
+  std::unique_ptr<HTTPTransport> transport = CreateTransport(location, "HEAD");
+  if (!transport) {
+    return Result::kRetry;
+  }
+  transport->SetBodyStream(std::make_unique<StringHTTPBodyStream>(""));
+  Execute(transport.get(), response_body);
+  const int head_status = transport->GetResponseStatus();
+  if (head_status == 403 || head_status == 404 || head_status == 410) {
+    LOG(WARNING) << "upload gone, HTTP status " << head_status;
+    return Result::kUploadGone;
+  }
+
+  FileOffset offset;
+  if ((head_status != 200 && head_status != 204) ||
+      !GetUploadOffset(transport.get(), size, &offset)) {
+    LOG(ERROR) << "upload offset unknown, HTTP status " << head_status;
+    return Result::kRetry;
+  }
+  if (offset > 0) {
+    LOG(INFO) << "resuming upload at " << offset << " of " << size;
+  }
+
+  // Send the rest of the body in chunks, so that each chunk the server
+  // acknowledges is kept even if a later request fails.
+  response_body->clear();
+  while (true) {
+    if (offset == size) {
+      return Result::kSuccess;
+    }
+
+    const size_t chunk_size = static_cast<size_t>(
+        std::min(static_cast<FileOffset>(chunk_size_), size - offset));
+    if (body->Seek(body_start + offset, SEEK_SET) != body_start + offset) {
+      return Result::kRetry;
+    }
+
+    transport = CreateTransport(location, "PATCH");
+    if (!transport) {
+      return Result::kRetry;
+    }
+    transport->SetHeader(kContentType, "application/offset+octet-stream");
+    transport->SetHeader(kContentLength,
+                         base::StringPrintf("%zu", chunk_size));
+    transport->SetHeader(
+        kUploadOffset,
+        base::StringPrintf("%" PRId64, static_cast<int64_t>(offset)));
+    transport->SetBodyStream(
+        std::make_unique<LimitedFileReaderHTTPBodyStream>(body, chunk_size));
+
+    Execute(transport.get(), response_body);
+    const int patch_status = transport->GetResponseStatus();
+    if (patch_status == 403 || patch_status == 404 || patch_status == 410) {
+      LOG(WARNING) << "upload gone, HTTP status " << patch_status;
+      return Result::kUploadGone;
+    }
+
+    FileOffset new_offset;
+    if (patch_status < 200 || patch_status > 204 ||
+        !GetUploadOffset(transport.get(), size, &new_offset)) {
+      LOG(ERROR) << "upload interrupted at " << offset << " of " << size
+                 << ", HTTP status " << patch_status;
+      return Result::kRetry;
+    }
+
+    if (new_offset <= offset) {
+      LOG(ERROR) << "upload made no progress at " << offset;
+      return Result::kRetry;
+    }
+    offset = new_offset;
+  }
+}
+
+std::unique_ptr<HTTPTransport> HTTPResumableUpload::CreateTransport(
+    const std::string& url,
+    const std::string& method) {
+  std::unique_ptr<HTTPTransport> transport(transport_factory_(url));
+  if (!transport) {
+    return nullptr;
+  }
+  transport->SetMethod(method);
+  transport->SetHeader(kTusResumable, kTusVersion);
+  return transport;
+}
+
+void HTTPResumableUpload::Execute(HTTPTransport* transport,
+                                  std::string* response_body) {
+  {
+    base::AutoLock lock(lock_);
+    if (canceled_) {
+      transport->Cancel();
+    }
+    transport_ = transport;
+  }
+
+  transport->ExecuteSynchronously(response_body);
+
+  base::AutoLock lock(lock_);
+  transport_ = nullptr;
+}
+
+}  // namespace crashpad
@@ -0,0 +1,144 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_UTIL_NET_HTTP_RESUMABLE_UPLOAD_H_
+#define CRASHPAD_UTIL_NET_HTTP_RESUMABLE_UPLOAD_H_
+
+#include <stddef.h>
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+
+#include "base/synchronization/lock.h"
+#include "util/file/file_io.h"
+#include "util/file/file_reader.h"
+
+namespace crashpad {
+
+class HTTPTransport;
+
+//! \brief Uploads a body with the tus resumable upload protocol, version
+//!     1.0.0, so that an upload that fails part of the way through can later
+//!     continue from where the server’s copy of it ends.
+//!
+//! An upload is first created with Create(), which obtains the URL of the
+//! upload from the server. The caller records this URL, and passes it to
+//! Send() for this and every later attempt. Each attempt asks the server how
+//! much of the body it has, and sends the rest in requests of at most
+//! SetChunkSize() bytes, so that data the server has acknowledged is never
+//! sent again, even if the server doesn’t keep the data of an interrupted
+//! request.
+//!
+//! The body must be the same on every attempt.
+class HTTPResumableUpload {
+ public:
+  //! \brief The result of Send().
+  enum class Result {
+    //! \brief The server has the whole body.
+    kSuccess,
+
+    //! \brief The upload did not complete, and may be continued by calling
+    //!     Send() again later.
+    kRetry,
+
+    //! \brief The server no longer knows the upload, or doesn’t support
+    //!     resumable uploads. A new upload must be created to try again.
+    kUploadGone,
+  };
+
+  //! \brief The number of bytes sent per request if not specified otherwise.
+  static constexpr size_t kDefaultChunkSize = 4 * 1024 * 1024;
+
+  HTTPResumableUpload();
+
+  HTTPResumableUpload(const HTTPResumableUpload&) = delete;
+  HTTPResumableUpload& operator=(const HTTPResumableUpload&) = delete;
+
+  ~HTTPResumableUpload();
+
+  //! \brief Sets a key-value pair sent with Create() in the `Upload-Metadata`
+  //!     header field, which servers may use to interpret the body.
+  //!
+  //! \param[in] key The key, which must not contain spaces or commas.
+  //! \param[in] value The value, which may contain any bytes.
+  void SetMetadata(const std::string& key, const std::string& value);
+
+  //! \brief A function that creates a transport for a request to a URL, with
+  //!     the URL set, or returns `nullptr` on failure.
+  using TransportFactory =
+      std::function<std::unique_ptr<HTTPTransport>(const std::string& url)>;
+
+  //! \brief Sets the function that creates the transport for each request, so
+  //!     that the caller can configure timeouts and the like as it does for
+  //!     its other requests. By default, HTTPTransport::Create() is used.
+  void SetTransportFactory(TransportFactory transport_factory);
+
+  //! \brief Sets the maximum number of bytes sent per request.
+  void SetChunkSize(size_t chunk_size);
+
+  //! \brief Cancels the request in progress, and any made later, so that
+  //!     Create() fails and Send() returns Result::kRetry promptly.
+  //!
+  //! This method may be called from any thread. See HTTPTransport::Cancel().
+  void Cancel();
+
+  //! \brief Creates an upload on a server.
+  //!
+  //! \param[in] url The URL at which the server creates uploads.
+  //! \param[in] size The size of the body to upload.
+  //! \param[out] location The URL of the new upload, to be passed to Send().
+  //!
+  //! \return `true` on success. `false` on failure, with a message logged.
+  bool Create(const std::string& url, FileOffset size, std::string* location);
+
+  //! \brief Sends the part of a body that the server doesn’t already have.
+  //!
+  //! \param[in] location The URL of the upload, as obtained from Create().
+  //! \param[in] body The body to upload, read from its current position. Its
+  //!     position is changed.
+  //! \param[in] size The size of the body, as given to Create().
+  //! \param[out] response_body The body of the server’s response to the
+  //!     request that completed the upload, if any, on success.
+  //!
+  //! \return A Result value.
+  Result Send(const std::string& location,
+              FileReaderInterface* body,
+              FileOffset size,
+              std::string* response_body);
+
+ private:
+  // Creates a transport for a request to url, with the headers common to all
+  // requests set.
+  std::unique_ptr<HTTPTransport> CreateTransport(const std::string& url,
+                                                 const std::string& method);
+
+  // Makes the request configured in transport, where Cancel() can cancel it.
+  void Execute(HTTPTransport* transport, std::string* response_body);
+
+  std::map<std::string, std::string> metadata_;
+  TransportFactory transport_factory_;
+  size_t chunk_size_;
+
+  // The transport of the request in progress, and whether Cancel() has been
+  // called.
+  base::Lock lock_;
+  HTTPTransport* transport_;  // weak
+  bool canceled_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_UTIL_NET_HTTP_RESUMABLE_UPLOAD_H_
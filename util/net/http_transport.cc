@@ -16,19 +16,71 @@
 
 #include <utility>
 
+#include "base/check.h"
 #include "util/net/http_body.h"
+#include "util/thread/thread.h"
 
 namespace crashpad {
 
+namespace {
+
+std::string ToLowerASCII(const std::string& string) {
+  std::string lower(string);
+  for (char& c : lower) {
+    if (c >= 'A' && c <= 'Z') {
+      c += 'a' - 'A';
+    }
+  }
+  return lower;
+}
+
+}  // namespace
+
+// Makes a request for HTTPTransport::ExecuteAsynchronously().
+class HTTPTransport::AsyncThread final : public Thread {
+ public:
+  AsyncThread(HTTPTransport* transport, CompletionCallback callback)
+      : Thread(), transport_(transport), callback_(std::move(callback)) {}
+
+  AsyncThread(const AsyncThread&) = delete;
+  AsyncThread& operator=(const AsyncThread&) = delete;
+
+  ~AsyncThread() override {}
+
+ private:
+  // Thread:
+  void ThreadMain() override {
+    std::string response_body;
+    const bool success = transport_->ExecuteSynchronously(&response_body);
+    if (callback_) {
+      callback_(success, response_body);
+    }
+  }
+
+  HTTPTransport* transport_;  // weak
+  CompletionCallback callback_;
+};
+
 HTTPTransport::HTTPTransport()
     : url_(),
       method_("POST"),
       headers_(),
+      response_headers_(),
       body_stream_(),
-      timeout_(15.0) {
+      response_status_(0),
+      timeout_(15.0),
+      connect_timeout_(0),
+      tls_handshake_timeout_(0),
+      idle_timeout_(0),
+      keep_alive_timeout_(0),
+      http2_(false),
+      async_thread_(),
+      canceled_(false) {
 }
 
 HTTPTransport::~HTTPTransport() {
+  // The request’s thread would outlive the subclass that makes the request.
+  DCHECK(!async_thread_);
 }
 
 void HTTPTransport::SetURL(const std::string& url) {
@@ -52,8 +104,64 @@ void HTTPTransport::SetTimeout(double timeout) {
   timeout_ = timeout;
 }
 
+void HTTPTransport::SetConnectTimeout(double timeout) {
+  connect_timeout_ = timeout;
+}
+
+void HTTPTransport::SetTLSHandshakeTimeout(double timeout) {
+  tls_handshake_timeout_ = timeout;
+}
+
+void HTTPTransport::SetIdleTimeout(double timeout) {
+  idle_timeout_ = timeout;
+}
+
 void HTTPTransport::SetRootCACertificatePath(const base::FilePath& cert) {
   root_ca_certificate_path_ = cert;
 }
 
+void HTTPTransport::SetKeepAliveTimeout(double timeout) {
+  keep_alive_timeout_ = timeout;
+}
+
+void HTTPTransport::SetHTTP2(bool http2) {
+  http2_ = http2;
+}
+
+void HTTPTransport::ExecuteAsynchronously(CompletionCallback callback) {
+  DCHECK(!async_thread_);
+  async_thread_ = std::make_unique<AsyncThread>(this, std::move(callback));
+  async_thread_->Start();
+}
+
+void HTTPTransport::WaitForCompletion() {
+  if (async_thread_) {
+    async_thread_->Join();
+    async_thread_.reset();
+  }
+}
+
+void HTTPTransport::Cancel() {
+  canceled_ = true;
+  OnCancel();
+}
+
+bool HTTPTransport::GetResponseHeader(const std::string& header,
+                                      std::string* value) const {
+  const auto it = response_headers_.find(ToLowerASCII(header));
+  if (it == response_headers_.end()) {
+    return false;
+  }
+  *value = it->second;
+  return true;
+}
+
+void HTTPTransport::SetResponseHeaders(const HTTPHeaders& response_headers) {
+  response_headers_.clear();
+  for (const auto& response_header : response_headers) {
+    response_headers_[ToLowerASCII(response_header.first)] =
+        response_header.second;
+  }
+}
+
 }  // namespace crashpad
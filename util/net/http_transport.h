@@ -15,6 +15,8 @@
 #ifndef CRASHPAD_UTIL_NET_HTTP_TRANSPORT_H_
 #define CRASHPAD_UTIL_NET_HTTP_TRANSPORT_H_
 
+#include <atomic>
+#include <functional>
 #include <memory>
 #include <string>
 
@@ -24,10 +26,14 @@
 namespace crashpad {
 
 class HTTPBodyStream;
+class Thread;
 
 //! \brief HTTPTransport executes a HTTP request using the specified URL, HTTP
-//!     method, headers, and body. This class can only issue a synchronous
-//!     HTTP request.
+//!     method, headers, and body.
+//!
+//! The request may be made synchronously, with ExecuteSynchronously(), or on
+//! a thread of its own, with ExecuteAsynchronously(). A request in progress
+//! can be canceled from any thread with Cancel().
 //!
 //! This class cannot be instantiated directly. A concrete subclass must be
 //! instantiated instead, which provides an implementation to execute the
@@ -74,6 +80,35 @@ class HTTPTransport {
   //! \param[in] timeout The request timeout, in seconds.
   void SetTimeout(double timeout);
 
+  //! \brief Sets the timeout for connecting to the server, including resolving
+  //!     its name.
+  //!
+  //! The libcurl-based transport limits connecting and the TLS handshake
+  //! together, by the sum of this and SetTLSHandshakeTimeout(). The macOS
+  //! transport ignores this setting.
+  //!
+  //! \param[in] timeout The timeout, in seconds. The default, `0`, leaves
+  //!     connecting limited only by SetTimeout().
+  void SetConnectTimeout(double timeout);
+
+  //! \brief Sets the timeout for the TLS handshake with the server.
+  //!
+  //! The WinHTTP-based transport limits the TLS handshake by
+  //! SetIdleTimeout() instead, and the macOS transport ignores this setting.
+  //!
+  //! \param[in] timeout The timeout, in seconds. The default, `0`, leaves the
+  //!     handshake limited only by SetTimeout().
+  void SetTLSHandshakeTimeout(double timeout);
+
+  //! \brief Sets the longest time for which sending the request or receiving
+  //!     the response may make no progress.
+  //!
+  //! The libcurl-based transport measures this in whole seconds.
+  //!
+  //! \param[in] timeout The timeout, in seconds. The default, `0`, leaves the
+  //!     request limited only by SetTimeout().
+  void SetIdleTimeout(double timeout);
+
   //! \brief Sets a certificate file to be used in lieu of the system CA cert
   //!     bundle.
   //!
@@ -84,6 +119,37 @@ class HTTPTransport {
   //!     cert to be used for TLS connections.
   void SetRootCACertificatePath(const base::FilePath& cert);
 
+  //! \brief Allows the connection used for the request to be reused by later
+  //!     requests to the same server.
+  //!
+  //! When enabled, the connection is kept open after a successful request if
+  //! the server permits it, and is offered to the next HTTPTransport in this
+  //! process that makes a request to the same scheme, host, and port. TLS
+  //! configuration and sessions are also shared, so that new connections can
+  //! resume an earlier session instead of performing a full handshake. This is
+  //! only implemented by the socket-based transport; the other transports
+  //! manage connections through the operating system and ignore this setting.
+  //!
+  //! \param[in] timeout The maximum time, in seconds, that an idle connection
+  //!     is kept open for reuse. The default, `0`, disables connection reuse,
+  //!     causing a new connection to be established for each request and
+  //!     closed after it.
+  void SetKeepAliveTimeout(double timeout);
+
+  //! \brief Allows the request to be made using HTTP/2.
+  //!
+  //! When enabled, HTTPS requests negotiate HTTP/2 with servers that support
+  //! it, and concurrent requests in this process to the same server are
+  //! multiplexed as streams of a single connection instead of each making a
+  //! connection of its own. An idle connection is kept open for reuse for the
+  //! time given to SetKeepAliveTimeout(), or for as long as the transport’s
+  //! connection cache allows if that is `0`. This is only implemented by the
+  //! libcurl-based transport; the other transports make HTTP/1.1 requests or
+  //! negotiate the protocol themselves, and ignore this setting.
+  //!
+  //! \param[in] http2 Whether HTTP/2 may be used. The default is `false`.
+  void SetHTTP2(bool http2);
+
   //! \brief Performs the HTTP request with the configured parameters and waits
   //!     for the execution to complete.
   //!
@@ -92,28 +158,124 @@ class HTTPTransport {
   //!     if the response body is not required.
   //!
   //! \return Whether or not the request was successful, defined as returning
-  //!     a HTTP status code in the range 200-203 (inclusive).
+  //!     a HTTP status code in the range 200-203 (inclusive), or 206 in
+  //!     response to a request with a `Range` header.
   virtual bool ExecuteSynchronously(std::string* response_body) = 0;
 
+  //! \brief A callback invoked when a request made by ExecuteAsynchronously()
+  //!     completes.
+  //!
+  //! \param[in] success The value that ExecuteSynchronously() would have
+  //!     returned.
+  //! \param[in] response_body The HTTP response body, on success.
+  using CompletionCallback =
+      std::function<void(bool success, const std::string& response_body)>;
+
+  //! \brief Performs the HTTP request with the configured parameters on a
+  //!     thread of its own, and returns without waiting for it to complete.
+  //!
+  //! This object must not be changed, and no other request may be made with
+  //! it, until WaitForCompletion() has been called, which must also be done
+  //! before it is destroyed.
+  //!
+  //! \param[in] callback Called on the request’s thread when it completes.
+  void ExecuteAsynchronously(CompletionCallback callback);
+
+  //! \brief Waits for a request made by ExecuteAsynchronously() to complete,
+  //!     once its callback has returned.
+  //!
+  //! This returns immediately if no request was made by
+  //! ExecuteAsynchronously() since the last call.
+  void WaitForCompletion();
+
+  //! \brief Cancels the request in progress, and any made later.
+  //!
+  //! A canceled request fails promptly, without waiting for its timeouts.
+  //! This method may be called from any thread, including while
+  //! ExecuteSynchronously() is running on another. The macOS transport can
+  //! only cancel a request while it is sending the request body, or before
+  //! it has started.
+  void Cancel();
+
+  //! \brief Returns the value of a header field from the response to the most
+  //!     recent request made by ExecuteSynchronously().
+  //!
+  //! Response headers are only recorded by the socket-based and libcurl-based
+  //! transports. They may not be recorded for requests that fail.
+  //!
+  //! \param[in] header The HTTP header name, compared case-insensitively.
+  //! \param[out] value The value of the header, if present.
+  //!
+  //! \return `true` if the header was present in the response, with \a value
+  //!     set to its value. `false` otherwise.
+  bool GetResponseHeader(const std::string& header, std::string* value) const;
+
+  //! \brief Returns the HTTP status code of the response to the most recent
+  //!     request made by ExecuteSynchronously().
+  //!
+  //! The status code is recorded whenever a response is received, even if
+  //! ExecuteSynchronously() does not consider it successful, so that callers
+  //! can act on statuses such as `204 No Content` or `404 Not Found`.
+  //!
+  //! \return The status code, or `0` if no response was received.
+  int GetResponseStatus() const { return response_status_; }
+
  protected:
   HTTPTransport();
 
+  //! \brief Records the header fields of a response, replacing those recorded
+  //!     for any earlier response. To be called by subclasses.
+  void SetResponseHeaders(const HTTPHeaders& response_headers);
+
+  //! \brief Records the status code of a response, or `0` if none was
+  //!     received. To be called by subclasses.
+  void SetResponseStatus(int response_status) {
+    response_status_ = response_status;
+  }
+
+  //! \brief Interrupts the request in progress, if any, so that it fails
+  //!     promptly.
+  //!
+  //! This is called by Cancel(), on the thread that calls it, after
+  //! canceled() has begun returning `true`. Subclasses whose requests can
+  //! block without checking canceled() override it.
+  virtual void OnCancel() {}
+
+  //! \return `true` once Cancel() has been called.
+  bool canceled() const { return canceled_; }
+
   const std::string& url() const { return url_; }
   const std::string& method() const { return method_; }
   const HTTPHeaders& headers() const { return headers_; }
   HTTPBodyStream* body_stream() const { return body_stream_.get(); }
   double timeout() const { return timeout_; }
+  double connect_timeout() const { return connect_timeout_; }
+  double tls_handshake_timeout() const { return tls_handshake_timeout_; }
+  double idle_timeout() const { return idle_timeout_; }
+  double keep_alive_timeout() const { return keep_alive_timeout_; }
+  bool http2() const { return http2_; }
   const base::FilePath& root_ca_certificate_path() const {
     return root_ca_certificate_path_;
   }
 
  private:
+  class AsyncThread;
+
   std::string url_;
   std::string method_;
   base::FilePath root_ca_certificate_path_;
   HTTPHeaders headers_;
+  HTTPHeaders response_headers_;  // Names are stored in lowercase.
   std::unique_ptr<HTTPBodyStream> body_stream_;
+  int response_status_;
   double timeout_;
+  double connect_timeout_;
+  double tls_handshake_timeout_;
+  double idle_timeout_;
+  double keep_alive_timeout_;
+  bool http2_;
+  std::unique_ptr<Thread> async_thread_;
+  std::atomic<bool> canceled_;
 };
 
 }  // namespace crashpad
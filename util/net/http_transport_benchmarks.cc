@@ -0,0 +1,373 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Measures the latency and throughput of uploads through HTTPTransport.
+//
+// An HTTP server runs on a thread in this process, and each iteration uploads a
+// body to it with the HTTPTransport implementation that this build uses:
+// HTTPTransportSocket or libcurl on Linux, depending on
+// crashpad_http_transport_impl, WinHTTP on Windows, and NSURLSession on macOS.
+// Bodies of each configured size are uploaded as a single part or split into
+// parts joined by CompositeHTTPBodyStream, with a Content-Length header or
+// chunked, and compressed with GzipHTTPBodyStream or not. A gzip-compressed
+// body is always chunked, because its length isn’t known in advance, as in
+// crash report uploads. The server checks the size of each body that it
+// receives, so a transport that corrupts bodies fails the benchmark.
+//
+// The body data is half random and half zeroes, in alternating pages, which
+// compresses about as well as a typical minidump.
+//
+// With --url, bodies are uploaded to another server instead, such as one that
+// uses TLS, and aren’t checked.
+
+#include <getopt.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/files/file_path.h"
+#include "base/rand_util.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/stringprintf.h"
+#include "build/build_config.h"
+#include "util/net/http_body.h"
+#include "util/net/http_body_gzip.h"
+#include "util/net/http_headers.h"
+#include "util/net/http_transport.h"
+#include "util/string/split_string.h"
+#include "util/thread/thread.h"
+
+#if COMPILER_MSVC
+#pragma warning(push)
+#pragma warning(disable: 4244 4245 4267 4702)
+#endif
+
+#define CPPHTTPLIB_ZLIB_SUPPORT
+#include "third_party/cpp-httplib/cpp-httplib/httplib.h"
+
+#if COMPILER_MSVC
+#pragma warning(pop)
+#endif
+
+namespace crashpad {
+namespace {
+
+constexpr size_t kPageSize = 4096;
+
+// Runs an httplib::Server that has already been bound to a port.
+class ServerThread : public Thread {
+ public:
+  explicit ServerThread(httplib::Server* server) : Thread(), server_(server) {}
+
+  ServerThread(const ServerThread&) = delete;
+  ServerThread& operator=(const ServerThread&) = delete;
+
+  ~ServerThread() override {}
+
+ private:
+  void ThreadMain() override { server_->listen_after_bind(); }
+
+  httplib::Server* server_;  // weak
+};
+
+struct Case {
+  size_t size;
+  size_t parts;
+  bool gzip;
+  bool chunked;
+};
+
+std::string CaseName(const Case& c) {
+  return base::StringPrintf("%zu/parts=%zu/%s%s",
+                            c.size,
+                            c.parts,
+                            c.gzip ? "gzip/" : "",
+                            c.chunked ? "chunked" : "sized");
+}
+
+// Returns the body for |c|, taken from the start of |data|.
+std::unique_ptr<HTTPBodyStream> MakeBody(const Case& c,
+                                         const std::string& data) {
+  std::unique_ptr<HTTPBodyStream> body;
+  if (c.parts == 1) {
+    body = std::make_unique<StringHTTPBodyStream>(data.substr(0, c.size));
+  } else {
+    CompositeHTTPBodyStream::PartsList parts;
+    const size_t part_size = c.size / c.parts;
+    for (size_t part = 0; part < c.parts; ++part) {
+      const size_t offset = part * part_size;
+      const size_t length =
+          part == c.parts - 1 ? c.size - offset : part_size;
+      parts.push_back(new StringHTTPBodyStream(data.substr(offset, length)));
+    }
+    body = std::make_unique<CompositeHTTPBodyStream>(parts);
+  }
+
+  if (c.gzip) {
+    body = std::make_unique<GzipHTTPBodyStream>(std::move(body));
+  }
+  return body;
+}
+
+// Uploads the body for |c| to |url|, returning false on failure.
+bool Upload(const Case& c,
+            const std::string& data,
+            const std::string& url,
+            size_t keep_alive) {
+  std::unique_ptr<HTTPTransport> transport(HTTPTransport::Create());
+  if (!transport) {
+    return false;
+  }
+  transport->SetURL(url);
+  transport->SetMethod("POST");
+  transport->SetHeader(kContentType, "application/octet-stream");
+  if (c.gzip) {
+    transport->SetHeader(kContentEncoding, "gzip");
+  }
+  if (!c.chunked) {
+    transport->SetHeader(kContentLength, base::NumberToString(c.size));
+  }
+  transport->SetKeepAliveTimeout(keep_alive);
+  transport->SetBodyStream(MakeBody(c, data));
+
+  std::string response_body;
+  return transport->ExecuteSynchronously(&response_body);
+}
+
+double Percentile(const std::vector<double>& sorted, double percentile) {
+  const size_t rank = static_cast<size_t>(percentile * sorted.size() / 100);
+  return sorted[std::min(rank, sorted.size() - 1)];
+}
+
+void PrintHeader() {
+  printf("%-36s %10s %10s %10s %12s\n",
+         "Benchmark",
+         "p50",
+         "p90",
+         "p99",
+         "Throughput");
+}
+
+void PrintResults(const Case& c, std::vector<double> seconds) {
+  std::sort(seconds.begin(), seconds.end());
+  const double median = Percentile(seconds, 50);
+  printf("%-36s %7.3f ms %7.3f ms %7.3f ms %7.1f MB/s\n",
+         CaseName(c).c_str(),
+         median * 1e3,
+         Percentile(seconds, 90) * 1e3,
+         Percentile(seconds, 99) * 1e3,
+         median > 0 ? c.size / median / 1e6 : 0);
+}
+
+void Usage(const std::string& me) {
+  // clang-format off
+  fprintf(stderr,
+"Usage: %s [OPTION]...\n"
+"Benchmark uploads through HTTPTransport to a server in this process.\n"
+"\n"
+"      --iterations=N     uploads of each body (default 20)\n"
+"      --keep-alive=SECS  reuse connections for up to SECS (default 0)\n"
+"      --parts=N          also upload bodies in N parts (default 16)\n"
+"      --sizes=N,...      body sizes in bytes (default 4096,262144,4194304)\n"
+"      --url=URL          upload to URL instead of a server in this process\n"
+"      --help             display this help and exit\n",
+          me.c_str());
+  // clang-format on
+}
+
+int HTTPTransportBenchmarksMain(int argc, char* argv[]) {
+  const std::string me = base::FilePath(argv[0]).BaseName().value();
+
+  enum OptionFlags {
+    // Long options without short equivalents.
+    kOptionLastChar = 255,
+    kOptionIterations,
+    kOptionKeepAlive,
+    kOptionParts,
+    kOptionSizes,
+    kOptionURL,
+
+    // Standard options.
+    kOptionHelp = -2,
+  };
+
+  size_t iterations = 20;
+  size_t keep_alive = 0;
+  size_t parts = 16;
+  std::vector<size_t> sizes = {4096, 256 * 1024, 4 * 1024 * 1024};
+  std::string url;
+
+  static constexpr option long_options[] = {
+      {"iterations", required_argument, nullptr, kOptionIterations},
+      {"keep-alive", required_argument, nullptr, kOptionKeepAlive},
+      {"parts", required_argument, nullptr, kOptionParts},
+      {"sizes", required_argument, nullptr, kOptionSizes},
+      {"url", required_argument, nullptr, kOptionURL},
+      {"help", no_argument, nullptr, kOptionHelp},
+      {nullptr, 0, nullptr, 0},
+  };
+
+  int opt;
+  while ((opt = getopt_long(argc, argv, "", long_options, nullptr)) != -1) {
+    size_t* size_option = nullptr;
+    switch (opt) {
+      case kOptionIterations:
+        size_option = &iterations;
+        break;
+      case kOptionKeepAlive:
+        size_option = &keep_alive;
+        break;
+      case kOptionParts:
+        size_option = &parts;
+        break;
+      case kOptionSizes:
+        sizes.clear();
+        for (const std::string& size : SplitString(optarg, ',')) {
+          sizes.push_back(0);
+          if (!base::StringToSizeT(size, &sizes.back()) || !sizes.back()) {
+            fprintf(stderr, "%s: invalid size: %s\n", me.c_str(), size.c_str());
+            return EXIT_FAILURE;
+          }
+        }
+        break;
+      case kOptionURL:
+        url = optarg;
+        break;
+      case kOptionHelp:
+        Usage(me);
+        return EXIT_SUCCESS;
+      default:
+        fprintf(stderr, "Try '%s --help' for more information.\n", me.c_str());
+        return EXIT_FAILURE;
+    }
+
+    if (size_option && !base::StringToSizeT(optarg, size_option)) {
+      fprintf(stderr, "%s: invalid number: %s\n", me.c_str(), optarg);
+      return EXIT_FAILURE;
+    }
+  }
+
+  if (optind != argc || iterations == 0 || parts == 0 || sizes.empty()) {
+    fprintf(stderr, "Try '%s --help' for more information.\n", me.c_str());
+    return EXIT_FAILURE;
+  }
+
+  const size_t max_size = *std::max_element(sizes.begin(), sizes.end());
+  std::string data(max_size, '\0');
+  for (size_t offset = 0; offset < data.size(); offset += 2 * kPageSize) {
+    base::RandBytes(&data[offset], std::min(kPageSize, data.size() - offset));
+  }
+
+  httplib::Server server;
+  std::atomic<size_t> received_size(0);
+  std::unique_ptr<ServerThread> server_thread;
+  const bool local_server = url.empty();
+  if (local_server) {
+    // The server keeps idle connections open for a few seconds regardless of
+    // --keep-alive, which is long enough for the uploads here to reuse them.
+    server.set_keep_alive_max_count(iterations + 1);
+    server.Post("/upload",
+                [&received_size](const httplib::Request& request,
+                                 httplib::Response& response) {
+                  received_size = request.body.size();
+                  response.status = 200;
+                  response.set_content("ok", "text/plain");
+                });
+
+    const int port = server.bind_to_any_port("127.0.0.1");
+    if (port < 0) {
+      fprintf(stderr, "%s: couldn’t bind server\n", me.c_str());
+      return EXIT_FAILURE;
+    }
+    url = base::StringPrintf("http://127.0.0.1:%d/upload", port);
+    server_thread = std::make_unique<ServerThread>(&server);
+    server_thread->Start();
+  }
+
+  std::vector<size_t> part_counts = {1};
+  if (parts > 1) {
+    part_counts.push_back(parts);
+  }
+
+  std::vector<Case> cases;
+  for (size_t size : sizes) {
+    for (size_t case_parts : part_counts) {
+      if (case_parts > size) {
+        continue;
+      }
+      cases.push_back({size, case_parts, false, false});
+      cases.push_back({size, case_parts, false, true});
+      cases.push_back({size, case_parts, true, true});
+    }
+  }
+
+  printf("url=%s iterations=%zu keep_alive=%zu\n\n",
+         url.c_str(),
+         iterations,
+         keep_alive);
+  PrintHeader();
+
+  int status = EXIT_SUCCESS;
+  for (const Case& c : cases) {
+    std::vector<double> seconds;
+    for (size_t iteration = 0; iteration < iterations; ++iteration) {
+      received_size = 0;
+      auto start = std::chrono::steady_clock::now();
+      if (!Upload(c, data, url, keep_alive)) {
+        fprintf(
+            stderr, "%s: %s: upload failed\n", me.c_str(), CaseName(c).c_str());
+        status = EXIT_FAILURE;
+        break;
+      }
+      seconds.push_back(std::chrono::duration<double>(
+                            std::chrono::steady_clock::now() - start)
+                            .count());
+      if (local_server && received_size != c.size) {
+        fprintf(stderr,
+                "%s: %s: server received %zu bytes\n",
+                me.c_str(),
+                CaseName(c).c_str(),
+                size_t{received_size});
+        status = EXIT_FAILURE;
+        break;
+      }
+    }
+    if (status != EXIT_SUCCESS) {
+      break;
+    }
+    PrintResults(c, seconds);
+  }
+
+  if (server_thread) {
+    server.stop();
+    server_thread->Join();
+  }
+
+  return status;
+}
+
+}  // namespace
+}  // namespace crashpad
+
+int main(int argc, char* argv[]) {
+  return crashpad::HTTPTransportBenchmarksMain(argc, argv);
+}
@@ -16,23 +16,34 @@
 
 #include <curl/curl.h>
 #include <dlfcn.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
 #include <string.h>
 #include <sys/utsname.h>
+#include <unistd.h>
 
 #include <algorithm>
 #include <limits>
+#include <map>
+#include <string>
+#include <vector>
 
 #include "base/check.h"
 #include "base/logging.h"
 #include "base/numerics/safe_math.h"
+#include "base/posix/eintr_wrapper.h"
 #include "base/scoped_generic.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/stringprintf.h"
+#include "base/synchronization/lock.h"
 #include "build/build_config.h"
 #include "package.h"
 #include "util/misc/no_cfi_icall.h"
 #include "util/net/http_body.h"
 #include "util/numeric/safe_assignment.h"
+#include "util/synchronization/semaphore.h"
+#include "util/thread/thread.h"
 
 namespace crashpad {
 
@@ -79,6 +90,57 @@ class Libcurl {
     return Get()->curl_global_init_(flags);
   }
 
+  static CURLMcode CurlMultiAddHandle(CURLM* multi, CURL* curl) {
+    return Get()->curl_multi_add_handle_(multi, curl);
+  }
+
+  static CURLMsg* CurlMultiInfoRead(CURLM* multi, int* msgs_in_queue) {
+    return Get()->curl_multi_info_read_(multi, msgs_in_queue);
+  }
+
+  static CURLM* CurlMultiInit() { return Get()->curl_multi_init_(); }
+
+  static CURLMcode CurlMultiPerform(CURLM* multi, int* running_handles) {
+    return Get()->curl_multi_perform_(multi, running_handles);
+  }
+
+  static CURLMcode CurlMultiRemoveHandle(CURLM* multi, CURL* curl) {
+    return Get()->curl_multi_remove_handle_(multi, curl);
+  }
+
+  template <typename Parameter>
+  static CURLMcode CurlMultiSetOpt(CURLM* multi,
+                                   CURLMoption option,
+                                   Parameter param) {
+    return Get()->curl_multi_setopt_(multi, option, param);
+  }
+
+  static const char* CurlMultiStrError(CURLMcode code) {
+    return Get()->curl_multi_strerror_(code);
+  }
+
+  static CURLMcode CurlMultiWait(CURLM* multi,
+                                 curl_waitfd* extra_fds,
+                                 unsigned int extra_nfds,
+                                 int timeout_ms,
+                                 int* numfds) {
+    return Get()->curl_multi_wait_(
+        multi, extra_fds, extra_nfds, timeout_ms, numfds);
+  }
+
+  static CURLSH* CurlShareInit() { return Get()->curl_share_init_(); }
+
+  template <typename Parameter>
+  static CURLSHcode CurlShareSetOpt(CURLSH* share,
+                                    CURLSHoption option,
+                                    Parameter param) {
+    return Get()->curl_share_setopt_(share, option, param);
+  }
+
+  static const char* CurlShareStrError(CURLSHcode code) {
+    return Get()->curl_share_strerror_(code);
+  }
+
   static void CurlSlistFreeAll(struct curl_slist* slist) {
     return Get()->curl_slist_free_all_(slist);
   }
@@ -139,6 +201,17 @@ class Libcurl {
     LINK_OR_RETURN_FALSE(curl_easy_getinfo);
     LINK_OR_RETURN_FALSE(curl_easy_setopt);
     LINK_OR_RETURN_FALSE(curl_global_init);
+    LINK_OR_RETURN_FALSE(curl_multi_add_handle);
+    LINK_OR_RETURN_FALSE(curl_multi_info_read);
+    LINK_OR_RETURN_FALSE(curl_multi_init);
+    LINK_OR_RETURN_FALSE(curl_multi_perform);
+    LINK_OR_RETURN_FALSE(curl_multi_remove_handle);
+    LINK_OR_RETURN_FALSE(curl_multi_setopt);
+    LINK_OR_RETURN_FALSE(curl_multi_strerror);
+    LINK_OR_RETURN_FALSE(curl_multi_wait);
+    LINK_OR_RETURN_FALSE(curl_share_init);
+    LINK_OR_RETURN_FALSE(curl_share_setopt);
+    LINK_OR_RETURN_FALSE(curl_share_strerror);
     LINK_OR_RETURN_FALSE(curl_slist_free_all);
     LINK_OR_RETURN_FALSE(curl_slist_append);
     LINK_OR_RETURN_FALSE(curl_version);
@@ -155,6 +228,17 @@ class Libcurl {
   NoCfiIcall<decltype(curl_easy_getinfo)*> curl_easy_getinfo_;
   NoCfiIcall<decltype(curl_easy_setopt)*> curl_easy_setopt_;
   NoCfiIcall<decltype(curl_global_init)*> curl_global_init_;
+  NoCfiIcall<decltype(curl_multi_add_handle)*> curl_multi_add_handle_;
+  NoCfiIcall<decltype(curl_multi_info_read)*> curl_multi_info_read_;
+  NoCfiIcall<decltype(curl_multi_init)*> curl_multi_init_;
+  NoCfiIcall<decltype(curl_multi_perform)*> curl_multi_perform_;
+  NoCfiIcall<decltype(curl_multi_remove_handle)*> curl_multi_remove_handle_;
+  NoCfiIcall<decltype(curl_multi_setopt)*> curl_multi_setopt_;
+  NoCfiIcall<decltype(curl_multi_strerror)*> curl_multi_strerror_;
+  NoCfiIcall<decltype(curl_multi_wait)*> curl_multi_wait_;
+  NoCfiIcall<decltype(curl_share_init)*> curl_share_init_;
+  NoCfiIcall<decltype(curl_share_setopt)*> curl_share_setopt_;
+  NoCfiIcall<decltype(curl_share_strerror)*> curl_share_strerror_;
   NoCfiIcall<decltype(curl_slist_free_all)*> curl_slist_free_all_;
   NoCfiIcall<decltype(curl_slist_append)*> curl_slist_append_;
   NoCfiIcall<decltype(curl_version)*> curl_version_;
@@ -269,6 +353,269 @@ struct ScopedCURLTraits {
 };
 using ScopedCURL = base::ScopedGeneric<CURL*, ScopedCURLTraits>;
 
+// A libcurl share handle through which HTTPTransportLibcurl objects that have
+// enabled connection reuse share idle connections, TLS sessions, and DNS
+// results.
+class CurlShare {
+ public:
+  CurlShare(const CurlShare&) = delete;
+  CurlShare& operator=(const CurlShare&) = delete;
+
+  //! \return The process-wide share handle, or `nullptr` if it couldn’t be
+  //!     created, with a message logged.
+  static CURLSH* Get() {
+    static CURLSH* share = Create();
+    return share;
+  }
+
+ private:
+  CurlShare() = delete;
+
+  static CURLSH* Create() {
+    CURLSH* share = Libcurl::CurlShareInit();
+    if (!share) {
+      LOG(ERROR) << "curl_share_init";
+      return nullptr;
+    }
+
+    CURLSHcode curl_err;
+    if ((curl_err = Libcurl::CurlShareSetOpt(
+             share, CURLSHOPT_LOCKFUNC, LockFunction)) != CURLSHE_OK ||
+        (curl_err = Libcurl::CurlShareSetOpt(
+             share, CURLSHOPT_UNLOCKFUNC, UnlockFunction)) != CURLSHE_OK) {
+      LOG(ERROR) << "curl_share_setopt: "
+                 << Libcurl::CurlShareStrError(curl_err);
+      return nullptr;
+    }
+
+    // Sharing connections requires libcurl 7.57.0. With older versions, only
+    // the TLS sessions and DNS results are shared, which still saves a full
+    // handshake per connection.
+    for (curl_lock_data data : {
+             CURL_LOCK_DATA_DNS,
+             CURL_LOCK_DATA_SSL_SESSION,
+#if LIBCURL_VERSION_NUM >= 0x073900
+             CURL_LOCK_DATA_CONNECT,
+#endif
+         }) {
+      curl_err = Libcurl::CurlShareSetOpt(share, CURLSHOPT_SHARE, data);
+      if (curl_err != CURLSHE_OK) {
+        LOG(WARNING) << "curl_share_setopt: "
+                     << Libcurl::CurlShareStrError(curl_err);
+      }
+    }
+
+    return share;
+  }
+
+  static base::Lock* Locks() {
+    static base::Lock* locks = new base::Lock[CURL_LOCK_DATA_LAST];
+    return locks;
+  }
+
+  static void LockFunction(CURL* curl,
+                           curl_lock_data data,
+                           curl_lock_access access,
+                           void* userptr) {
+    Locks()[data].Acquire();
+  }
+
+  static void UnlockFunction(CURL* curl, curl_lock_data data, void* userptr) {
+    Locks()[data].Release();
+  }
+};
+
+// A process-wide multi handle, driven by a thread of its own, that makes the
+// requests of transports with HTTP/2 enabled. libcurl only multiplexes
+// transfers made through the same multi handle, so requests made with
+// curl_easy_perform() on separate threads each need a connection of their own
+// even when the share handle lets them reuse idle ones. The multi handle keeps
+// its own cache of connections and DNS results.
+class CurlMulti {
+ public:
+  CurlMulti(const CurlMulti&) = delete;
+  CurlMulti& operator=(const CurlMulti&) = delete;
+
+  //! \return The process-wide multi handle, or `nullptr` if it couldn’t be
+  //!     created, with a message logged.
+  static CurlMulti* Get() {
+    static CurlMulti* multi = Create();
+    return multi;
+  }
+
+  //! \brief Makes the request configured in \a curl, as curl_easy_perform()
+  //!     would, multiplexing it with other requests in progress.
+  //!
+  //! The callbacks configured in \a curl are called on the multi handle’s
+  //! thread while this method waits.
+  CURLcode Perform(CURL* curl) {
+    Transfer transfer(curl);
+    {
+      base::AutoLock lock(lock_);
+      added_.push_back(&transfer);
+    }
+    Wake();
+    transfer.done.Wait();
+    return transfer.result;
+  }
+
+ private:
+  struct Transfer {
+    explicit Transfer(CURL* curl)
+        : curl(curl), result(CURLE_FAILED_INIT), done(0) {}
+
+    CURL* curl;
+    CURLcode result;
+    Semaphore done;
+  };
+
+  class MultiThread : public Thread {
+   public:
+    explicit MultiThread(CurlMulti* multi) : Thread(), multi_(multi) {}
+
+    MultiThread(const MultiThread&) = delete;
+    MultiThread& operator=(const MultiThread&) = delete;
+
+    ~MultiThread() override {}
+
+   private:
+    // Thread:
+    void ThreadMain() override { multi_->Run(); }
+
+    CurlMulti* multi_;  // weak
+  };
+
+  CurlMulti(CURLM* multi, int wake_read_fd, int wake_write_fd)
+      : multi_(multi),
+        wake_read_fd_(wake_read_fd),
+        wake_write_fd_(wake_write_fd),
+        lock_(),
+        added_(),
+        thread_(this) {}
+
+  ~CurlMulti() = delete;
+
+  static CurlMulti* Create() {
+    CURLM* multi = Libcurl::CurlMultiInit();
+    if (!multi) {
+      LOG(ERROR) << "curl_multi_init";
+      return nullptr;
+    }
+
+#if LIBCURL_VERSION_NUM >= 0x072b00
+    // This is the default since libcurl 7.62.0.
+    CURLMcode curl_err = Libcurl::CurlMultiSetOpt(
+        multi, CURLMOPT_PIPELINING, static_cast<long>(CURLPIPE_MULTIPLEX));
+    if (curl_err != CURLM_OK) {
+      LOG(WARNING) << "curl_multi_setopt: "
+                   << Libcurl::CurlMultiStrError(curl_err);
+    }
+#endif
+
+    int wake_fds[2];
+    if (pipe(wake_fds) != 0) {
+      PLOG(ERROR) << "pipe";
+      return nullptr;
+    }
+    for (int fd : wake_fds) {
+      if (fcntl(fd, F_SETFD, FD_CLOEXEC) != 0 ||
+          fcntl(fd, F_SETFL, O_NONBLOCK) != 0) {
+        PLOG(ERROR) << "fcntl";
+        return nullptr;
+      }
+    }
+
+    CurlMulti* curl_multi = new CurlMulti(multi, wake_fds[0], wake_fds[1]);
+    curl_multi->thread_.Start();
+    return curl_multi;
+  }
+
+  // Interrupts the wait in Run() so that newly-added transfers are started.
+  void Wake() {
+    const char byte = 0;
+    if (HANDLE_EINTR(write(wake_write_fd_, &byte, sizeof(byte))) < 0 &&
+        errno != EAGAIN) {
+      PLOG(ERROR) << "write";
+    }
+  }
+
+  void Run() {
+    std::map<CURL*, Transfer*> transfers;
+    while (true) {
+      std::vector<Transfer*> added;
+      {
+        base::AutoLock lock(lock_);
+        added.swap(added_);
+      }
+      for (Transfer* transfer : added) {
+        CURLMcode curl_err =
+            Libcurl::CurlMultiAddHandle(multi_, transfer->curl);
+        if (curl_err != CURLM_OK) {
+          LOG(ERROR) << "curl_multi_add_handle: "
+                     << Libcurl::CurlMultiStrError(curl_err);
+          transfer->done.Signal();
+          continue;
+        }
+        transfers[transfer->curl] = transfer;
+      }
+
+      int running;
+      CURLMcode curl_err = Libcurl::CurlMultiPerform(multi_, &running);
+      if (curl_err != CURLM_OK) {
+        LOG(ERROR) << "curl_multi_perform: "
+                   << Libcurl::CurlMultiStrError(curl_err);
+      }
+
+      CURLMsg* message;
+      int messages;
+      while ((message = Libcurl::CurlMultiInfoRead(multi_, &messages))) {
+        if (message->msg != CURLMSG_DONE) {
+          continue;
+        }
+        // message is invalidated by curl_multi_remove_handle().
+        CURL* const curl = message->easy_handle;
+        const CURLcode result = message->data.result;
+        Libcurl::CurlMultiRemoveHandle(multi_, curl);
+
+        auto iterator = transfers.find(curl);
+        DCHECK(iterator != transfers.end());
+        Transfer* const transfer = iterator->second;
+        transfers.erase(iterator);
+        transfer->result = result;
+        transfer->done.Signal();
+      }
+
+      // libcurl’s own timeouts need attention at least this often.
+      constexpr int kMaxWaitMilliseconds = 1000;
+      curl_waitfd wake_fd = {};
+      wake_fd.fd = wake_read_fd_;
+      wake_fd.events = CURL_WAIT_POLLIN;
+      curl_err = Libcurl::CurlMultiWait(
+          multi_, &wake_fd, 1, kMaxWaitMilliseconds, nullptr);
+      if (curl_err != CURLM_OK) {
+        LOG(ERROR) << "curl_multi_wait: "
+                   << Libcurl::CurlMultiStrError(curl_err);
+      }
+      if (wake_fd.revents) {
+        char buffer[64];
+        while (HANDLE_EINTR(read(wake_read_fd_, buffer, sizeof(buffer))) > 0) {
+        }
+      }
+    }
+  }
+
+  CURLM* multi_;
+  int wake_read_fd_;
+  int wake_write_fd_;
+
+  // Guards added_, the transfers added by Perform() and not yet given to the
+  // multi handle.
+  base::Lock lock_;
+  std::vector<Transfer*> added_;
+
+  MultiThread thread_;
+};
+
 class CurlSList {
  public:
   CurlSList() : list_(nullptr) {}
@@ -336,6 +683,15 @@ class HTTPTransportLibcurl final : public HTTPTransport {
                                   size_t size,
                                   size_t nitems,
                                   void* userdata);
+  static size_t WriteResponseHeader(char* buffer,
+                                    size_t size,
+                                    size_t nitems,
+                                    void* userdata);
+  static int TransferProgress(void* clientp,
+                              curl_off_t dltotal,
+                              curl_off_t dlnow,
+                              curl_off_t ultotal,
+                              curl_off_t ulnow);
 };
 
 HTTPTransportLibcurl::HTTPTransportLibcurl() : HTTPTransport() {}
@@ -346,6 +702,8 @@ bool HTTPTransportLibcurl::ExecuteSynchronously(std::string* response_body) {
   DCHECK(body_stream());
 
   response_body->clear();
+  SetResponseHeaders(HTTPHeaders());
+  SetResponseStatus(0);
 
   // curl_easy_init() will do this on the first call if it hasn’t been done yet,
   // but not in a thread-safe way as is done here.
@@ -402,6 +760,72 @@ bool HTTPTransportLibcurl::ExecuteSynchronously(std::string* response_body) {
                        CURLOPT_TIMEOUT_MS,
                        static_cast<long>(timeout() * kMillisecondsPerSecond));
 
+  // libcurl’s connection timeout covers the TLS handshake too.
+  const double connection_timeout =
+      connect_timeout() + tls_handshake_timeout();
+  if (connection_timeout > 0) {
+    TRY_CURL_EASY_SETOPT(
+        curl.get(),
+        CURLOPT_CONNECTTIMEOUT_MS,
+        std::max(static_cast<long>(connection_timeout * kMillisecondsPerSecond),
+                 1l));
+  }
+
+  // A transfer that moves less than a byte per second for the idle timeout is
+  // abandoned.
+  if (idle_timeout() > 0) {
+    TRY_CURL_EASY_SETOPT(curl.get(), CURLOPT_LOW_SPEED_LIMIT, 1l);
+    TRY_CURL_EASY_SETOPT(
+        curl.get(),
+        CURLOPT_LOW_SPEED_TIME,
+        std::max(static_cast<long>(ceil(idle_timeout())), 1l));
+  }
+
+  // The progress callback is called at least once per second, even while
+  // nothing is transferred, and aborts the transfer once it is canceled.
+  TRY_CURL_EASY_SETOPT(curl.get(), CURLOPT_XFERINFOFUNCTION, TransferProgress);
+  TRY_CURL_EASY_SETOPT(curl.get(), CURLOPT_XFERINFODATA, this);
+  TRY_CURL_EASY_SETOPT(curl.get(), CURLOPT_NOPROGRESS, 0l);
+
+  // HTTP/2 requests are made through the multi handle, which keeps its own
+  // connections, so that they can be multiplexed.
+  CurlMulti* const multi = http2() ? CurlMulti::Get() : nullptr;
+  if (multi) {
+    // Older versions of libcurl, and those built without HTTP/2 support, make
+    // HTTP/1.1 requests.
+#if LIBCURL_VERSION_NUM >= 0x072f00
+    constexpr long kHTTPVersion = CURL_HTTP_VERSION_2TLS;
+#else
+    constexpr long kHTTPVersion = CURL_HTTP_VERSION_2_0;
+#endif
+    CURLcode curl_err =
+        Libcurl::CurlEasySetOpt(curl.get(), CURLOPT_HTTP_VERSION, kHTTPVersion);
+    if (curl_err != CURLE_OK) {
+      LOG(WARNING) << CurlErrorMessage(curl_err, "curl_easy_setopt");
+    }
+
+    // Wait for a connection being established by another request to the same
+    // server, in case it can be multiplexed, instead of making another.
+    TRY_CURL_EASY_SETOPT(curl.get(), CURLOPT_PIPEWAIT, 1l);
+  }
+
+  if (keep_alive_timeout() > 0) {
+    CURLSH* share = multi ? nullptr : CurlShare::Get();
+    if (share) {
+      TRY_CURL_EASY_SETOPT(curl.get(), CURLOPT_SHARE, share);
+    }
+#if LIBCURL_VERSION_NUM >= 0x074100
+    // With older versions of libcurl, idle connections are kept for as long
+    // as libcurl’s connection cache allows.
+    if (share || multi) {
+      TRY_CURL_EASY_SETOPT(curl.get(),
+                           CURLOPT_MAXAGE_CONN,
+                           std::max(static_cast<long>(keep_alive_timeout()),
+                                    1l));
+    }
+#endif
+  }
+
   // If the request body size is known ahead of time, a Content-Length header
   // field will be present. Store that to use as CURLOPT_POSTFIELDSIZE_LARGE,
   // which will both set the Content-Length field in the request header and
@@ -419,8 +843,14 @@ bool HTTPTransportLibcurl::ExecuteSynchronously(std::string* response_body) {
     }
   }
 
-  if (method() == "POST") {
+  // PUT and PATCH requests carry a body just as POST requests do, so they are
+  // made as POST requests with the method replaced.
+  if (method() == "POST" || method() == "PUT" || method() == "PATCH") {
     TRY_CURL_EASY_SETOPT(curl.get(), CURLOPT_POST, 1l);
+    if (method() != "POST") {
+      TRY_CURL_EASY_SETOPT(
+          curl.get(), CURLOPT_CUSTOMREQUEST, method().c_str());
+    }
 
     // By default when sending a POST request, libcurl includes an “Expect:
     // 100-continue” header field. Althogh this header is specified in HTTP/1.1
@@ -445,6 +875,10 @@ bool HTTPTransportLibcurl::ExecuteSynchronously(std::string* response_body) {
       TRY_CURL_EASY_SETOPT(
           curl.get(), CURLOPT_POSTFIELDSIZE_LARGE, content_length_curl);
     }
+  } else if (method() == "HEAD") {
+    // A response to a HEAD request has no body, whatever its header fields
+    // say.
+    TRY_CURL_EASY_SETOPT(curl.get(), CURLOPT_NOBODY, 1l);
   } else if (method() != "GET") {
     // Untested.
     TRY_CURL_EASY_SETOPT(curl.get(), CURLOPT_CUSTOMREQUEST, method().c_str());
@@ -457,6 +891,11 @@ bool HTTPTransportLibcurl::ExecuteSynchronously(std::string* response_body) {
   TRY_CURL_EASY_SETOPT(curl.get(), CURLOPT_WRITEFUNCTION, WriteResponseBody);
   TRY_CURL_EASY_SETOPT(curl.get(), CURLOPT_WRITEDATA, response_body);
 
+  HTTPHeaders response_headers;
+  TRY_CURL_EASY_SETOPT(
+      curl.get(), CURLOPT_HEADERFUNCTION, WriteResponseHeader);
+  TRY_CURL_EASY_SETOPT(curl.get(), CURLOPT_HEADERDATA, &response_headers);
+
 #undef TRY_CURL_EASY_SETOPT
 #undef TRY_CURL_SLIST_APPEND
 
@@ -464,8 +903,14 @@ bool HTTPTransportLibcurl::ExecuteSynchronously(std::string* response_body) {
   // that response_body is cleared.
   ScopedClearString clear_response_body(response_body);
 
+  if (canceled()) {
+    LOG(ERROR) << "canceled";
+    return false;
+  }
+
   // Do it.
-  CURLcode curl_err = Libcurl::CurlEasyPerform(curl.get());
+  CURLcode curl_err = multi ? multi->Perform(curl.get())
+                            : Libcurl::CurlEasyPerform(curl.get());
   if (curl_err != CURLE_OK) {
     LOG(ERROR) << CurlErrorMessage(curl_err, "curl_easy_perform");
     return false;
@@ -479,7 +924,10 @@ bool HTTPTransportLibcurl::ExecuteSynchronously(std::string* response_body) {
     return false;
   }
 
-  if (status != 200) {
+  SetResponseHeaders(response_headers);
+  SetResponseStatus(static_cast<int>(status));
+
+  if (status != 200 && status != 206) {
     LOG(ERROR) << base::StringPrintf("HTTP status %ld", status);
     return false;
   }
@@ -497,6 +945,9 @@ size_t HTTPTransportLibcurl::ReadRequestBody(char* buffer,
                                              void* userdata) {
   HTTPTransportLibcurl* self =
       reinterpret_cast<HTTPTransportLibcurl*>(userdata);
+  if (self->canceled()) {
+    return CURL_READFUNC_ABORT;
+  }
 
   // This libcurl callback mimics the silly stdio-style fread() interface: size
   // and nitems have been separated and must be multiplied.
@@ -508,13 +959,23 @@ size_t HTTPTransportLibcurl::ReadRequestBody(char* buffer,
       len,
       static_cast<size_t>(std::numeric_limits<FileOperationResult>::max()));
 
-  FileOperationResult bytes_read = self->body_stream()->GetBytesBuffer(
-      reinterpret_cast<uint8_t*>(buffer), len);
-  if (bytes_read < 0) {
-    return CURL_READFUNC_ABORT;
+  // The body stream may return less than was asked for even before its end.
+  // Fill as much of the buffer as possible, so that libcurl sends fewer, larger
+  // chunks.
+  size_t total_read = 0;
+  while (total_read < len) {
+    FileOperationResult bytes_read = self->body_stream()->GetBytesBuffer(
+        reinterpret_cast<uint8_t*>(buffer) + total_read, len - total_read);
+    if (bytes_read < 0) {
+      return CURL_READFUNC_ABORT;
+    }
+    if (bytes_read == 0) {
+      break;
+    }
+    total_read += bytes_read;
   }
 
-  return bytes_read;
+  return total_read;
 }
 
 // static
@@ -533,6 +994,53 @@ size_t HTTPTransportLibcurl::WriteResponseBody(char* buffer,
   return len;
 }
 
+// static
+size_t HTTPTransportLibcurl::WriteResponseHeader(char* buffer,
+                                                 size_t size,
+                                                 size_t nitems,
+                                                 void* userdata) {
+  HTTPHeaders* response_headers = reinterpret_cast<HTTPHeaders*>(userdata);
+
+  // This libcurl callback mimics the silly stdio-style fread() interface: size
+  // and nitems have been separated and must be multiplied.
+  base::CheckedNumeric<size_t> checked_len = base::CheckMul(size, nitems);
+  size_t len = checked_len.ValueOrDefault(std::numeric_limits<size_t>::max());
+
+  // The callback is called once for each line, including the status line of
+  // each response received, such as informational and redirect responses
+  // preceding the final one. Only the final response’s headers are kept.
+  const std::string line(buffer, len);
+  if (line.compare(0, 5, "HTTP/") == 0) {
+    response_headers->clear();
+    return len;
+  }
+
+  const size_t colon = line.find(':');
+  if (colon == std::string::npos) {
+    return len;
+  }
+
+  static constexpr char kWhitespace[] = " \t\r\n";
+  const size_t value_begin = line.find_first_not_of(kWhitespace, colon + 1);
+  const size_t value_end = line.find_last_not_of(kWhitespace);
+  (*response_headers)[line.substr(0, colon)] =
+      value_begin == std::string::npos
+          ? std::string()
+          : line.substr(value_begin, value_end - value_begin + 1);
+  return len;
+}
+
+// static
+int HTTPTransportLibcurl::TransferProgress(void* clientp,
+                                           curl_off_t dltotal,
+                                           curl_off_t dlnow,
+                                           curl_off_t ultotal,
+                                           curl_off_t ulnow) {
+  const HTTPTransportLibcurl* self =
+      reinterpret_cast<HTTPTransportLibcurl*>(clientp);
+  return self->canceled() ? 1 : 0;
+}
+
 }  // namespace
 
 // static
@@ -208,9 +208,38 @@ class HTTPTransportMac final : public HTTPTransport {
   ~HTTPTransportMac() override;
 
   bool ExecuteSynchronously(std::string* response_body) override;
+
+ private:
+  // Fails once the request is canceled, which is the only way to interrupt a
+  // request made with NSURLConnection.
+  class CancelableHTTPBodyStream final : public HTTPBodyStream {
+   public:
+    explicit CancelableHTTPBodyStream(HTTPTransportMac* transport)
+        : transport_(transport) {}
+
+    CancelableHTTPBodyStream(const CancelableHTTPBodyStream&) = delete;
+    CancelableHTTPBodyStream& operator=(const CancelableHTTPBodyStream&) =
+        delete;
+
+    // HTTPBodyStream:
+    FileOperationResult GetBytesBuffer(uint8_t* buffer,
+                                       size_t max_len) override {
+      if (transport_->canceled()) {
+        LOG(ERROR) << "canceled";
+        return -1;
+      }
+      return transport_->body_stream()->GetBytesBuffer(buffer, max_len);
+    }
+
+   private:
+    HTTPTransportMac* transport_;  // weak
+  };
+
+  CancelableHTTPBodyStream cancelable_body_stream_;
 };
 
-HTTPTransportMac::HTTPTransportMac() : HTTPTransport() {
+HTTPTransportMac::HTTPTransportMac()
+    : HTTPTransport(), cancelable_body_stream_(this) {
 }
 
 HTTPTransportMac::~HTTPTransportMac() {
@@ -219,13 +248,22 @@ HTTPTransportMac::~HTTPTransportMac() {
 bool HTTPTransportMac::ExecuteSynchronously(std::string* response_body) {
   DCHECK(body_stream());
 
+  SetResponseHeaders(HTTPHeaders());
+  SetResponseStatus(0);
+
+  if (canceled()) {
+    LOG(ERROR) << "canceled";
+    return false;
+  }
+
   @autoreleasepool {
     NSString* url_ns_string = base::SysUTF8ToNSString(url());
     NSURL* url = [NSURL URLWithString:url_ns_string];
-    NSMutableURLRequest* request =
-        [NSMutableURLRequest requestWithURL:url
-                                cachePolicy:NSURLRequestUseProtocolCachePolicy
-                            timeoutInterval:timeout()];
+    // The timeout interval limits how long the request may be idle.
+    NSMutableURLRequest* request = [NSMutableURLRequest
+         requestWithURL:url
+            cachePolicy:NSURLRequestUseProtocolCachePolicy
+        timeoutInterval:idle_timeout() > 0 ? idle_timeout() : timeout()];
     [request setHTTPMethod:base::SysUTF8ToNSString(method())];
 
     // If left to its own devices, CFNetwork would build a user-agent string
@@ -242,7 +280,7 @@ bool HTTPTransportMac::ExecuteSynchronously(std::string* response_body) {
 
     base::scoped_nsobject<NSInputStream> input_stream(
         [[CrashpadHTTPBodyStreamTransport alloc]
-            initWithBodyStream:body_stream()]);
+            initWithBodyStream:&cancelable_body_stream_]);
     [request setHTTPBodyStream:input_stream.get()];
 
     NSURLResponse* response = nil;
@@ -274,7 +312,20 @@ bool HTTPTransportMac::ExecuteSynchronously(std::string* response_body) {
       return false;
     }
     NSInteger http_status = [http_response statusCode];
-    if (http_status < 200 || http_status > 203) {
+    SetResponseStatus(static_cast<int>(http_status));
+
+    HTTPHeaders response_headers;
+    NSDictionary* header_fields = [http_response allHeaderFields];
+    for (NSString* name in header_fields) {
+      id value = [header_fields objectForKey:name];
+      if ([value isKindOfClass:[NSString class]]) {
+        response_headers[base::SysNSStringToUTF8(name)] =
+            base::SysNSStringToUTF8(value);
+      }
+    }
+    SetResponseHeaders(response_headers);
+
+    if ((http_status < 200 || http_status > 203) && http_status != 206) {
       LOG(ERROR) << base::StringPrintf("HTTP status %ld",
                                        implicit_cast<long>(http_status));
       return false;
@@ -13,23 +13,35 @@
 // limitations under the License.
 
 #include <fcntl.h>
-#include <netdb.h>
 #include <poll.h>
 #include <string.h>
+#include <strings.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
 
+#include <algorithm>
 #include <iterator>
+#include <limits>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
 
+#include "base/files/scoped_file.h"
 #include "base/logging.h"
 #include "base/numerics/safe_conversions.h"
 #include "base/posix/eintr_wrapper.h"
 #include "base/scoped_generic.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/stringprintf.h"
+#include "base/synchronization/lock.h"
 #include "build/build_config.h"
 #include "util/file/file_io.h"
+#include "util/misc/clock.h"
 #include "util/net/http_body.h"
 #include "util/net/http_transport.h"
+#include "util/net/resolver_cache.h"
 #include "util/net/url.h"
 #include "util/stdlib/string_number_conversion.h"
 #include "util/string/split_string.h"
@@ -44,9 +56,15 @@ namespace {
 
 constexpr const char kCRLFTerminator[] = "\r\n";
 
+#if defined(MSG_NOSIGNAL)
+constexpr int kSendFlags = MSG_NOSIGNAL;
+#else
+constexpr int kSendFlags = 0;
+#endif
+
 class HTTPTransportSocket final : public HTTPTransport {
  public:
-  HTTPTransportSocket() = default;
+  HTTPTransportSocket();
 
   HTTPTransportSocket(const HTTPTransportSocket&) = delete;
   HTTPTransportSocket& operator=(const HTTPTransportSocket&) = delete;
@@ -54,98 +72,399 @@ class HTTPTransportSocket final : public HTTPTransport {
   ~HTTPTransportSocket() override = default;
 
   bool ExecuteSynchronously(std::string* response_body) override;
+
+ private:
+  // HTTPTransport:
+  void OnCancel() override;
+
+  // A pipe written to by OnCancel(), whose read end becoming readable wakes
+  // a request waiting for its socket.
+  base::ScopedFD cancel_read_fd_;
+  base::ScopedFD cancel_write_fd_;
 };
 
-struct ScopedAddrinfoTraits {
-  static addrinfo* InvalidValue() { return nullptr; }
-  static void Free(addrinfo* ai) { freeaddrinfo(ai); }
+//! \brief Waits for a request’s socket to become ready, within the request’s
+//!     timeouts, and until the request is canceled.
+class SocketWaiter {
+ public:
+  //! \param[in] cancel_fd A file descriptor that becomes readable when the
+  //!     request is canceled, or `-1`.
+  //! \param[in] timeout The timeout for the whole request, in seconds, or `0`
+  //!     for none.
+  //! \param[in] idle_timeout The longest wait while sending the request or
+  //!     receiving the response, in seconds, or `0` for no limit.
+  SocketWaiter(int cancel_fd, double timeout, double idle_timeout)
+      : cancel_fd_(cancel_fd),
+        deadline_(Deadline(timeout)),
+        phase_deadline_(0),
+        idle_timeout_(idle_timeout),
+        in_transfer_(false) {}
+
+  SocketWaiter(const SocketWaiter&) = delete;
+  SocketWaiter& operator=(const SocketWaiter&) = delete;
+
+  //! \brief Begins connecting or the TLS handshake, which may take \a timeout
+  //!     seconds, or any time within the request’s timeout if `0`.
+  void BeginHandshake(double timeout) {
+    phase_deadline_ = Deadline(timeout);
+    in_transfer_ = false;
+  }
+
+  //! \brief Begins sending the request and receiving the response, each wait
+  //!     during which is limited by the idle timeout.
+  void BeginTransfer() {
+    phase_deadline_ = 0;
+    in_transfer_ = true;
+  }
+
+  //! \brief Waits for \a sock to become ready for \a events, or to fail.
+  //!
+  //! \return `true` if \a sock is ready or has failed, in which case the
+  //!     operation that follows reports the failure. `false` on timeout,
+  //!     cancellation, or error, with a message logged.
+  bool Wait(int sock, short events) {
+    size_t ready;
+    return WaitAny(std::vector<int>(1, sock), events, 0, &ready);
+  }
+
+  //! \brief Waits for any of \a socks to become ready for \a events, or to
+  //!     fail, for at most \a max_wait seconds.
+  //!
+  //! \param[in] socks The sockets to wait for.
+  //! \param[in] events The events to wait for on each socket.
+  //! \param[in] max_wait The longest time to wait, in seconds, or `0` to wait
+  //!     as long as the request’s timeouts allow.
+  //! \param[out] ready The index in \a socks of a socket that is ready or has
+  //!     failed, or the size of \a socks if \a max_wait passed first.
+  //!
+  //! \return `true` on success. `false` on timeout, cancellation, or error,
+  //!     with a message logged.
+  bool WaitAny(const std::vector<int>& socks,
+               short events,
+               double max_wait,
+               size_t* ready) {
+    uint64_t deadline = deadline_;
+    if (phase_deadline_ && (!deadline || phase_deadline_ < deadline)) {
+      deadline = phase_deadline_;
+    }
+    if (in_transfer_ && idle_timeout_ > 0) {
+      const uint64_t idle_deadline = Deadline(idle_timeout_);
+      if (!deadline || idle_deadline < deadline) {
+        deadline = idle_deadline;
+      }
+    }
+    const uint64_t max_wait_deadline = Deadline(max_wait);
+
+    std::vector<pollfd> pollfds(socks.size() + 1);
+    for (size_t index = 0; index < socks.size(); ++index) {
+      pollfds[index].fd = socks[index];
+      pollfds[index].events = events;
+    }
+    pollfd& cancel_pollfd = pollfds.back();
+    cancel_pollfd.fd = cancel_fd_;
+    cancel_pollfd.events = POLLIN;
+    while (true) {
+      const uint64_t now = ClockMonotonicNanoseconds();
+      if (deadline && now >= deadline) {
+        LOG(ERROR) << "timed out";
+        return false;
+      }
+      if (max_wait_deadline && now >= max_wait_deadline) {
+        *ready = socks.size();
+        return true;
+      }
+
+      uint64_t wait_deadline = deadline;
+      if (max_wait_deadline &&
+          (!wait_deadline || max_wait_deadline < wait_deadline)) {
+        wait_deadline = max_wait_deadline;
+      }
+      int timeout_ms = -1;
+      if (wait_deadline) {
+        // Round up, so that the deadline has passed when poll() times out.
+        timeout_ms = static_cast<int>(
+            std::min((wait_deadline - now + 999999) / 1000000,
+                     uint64_t{std::numeric_limits<int>::max()}));
+      }
+
+      const int ret =
+          HANDLE_EINTR(poll(pollfds.data(), pollfds.size(), timeout_ms));
+      if (ret < 0) {
+        PLOG(ERROR) << "poll";
+        return false;
+      }
+      if (cancel_pollfd.revents) {
+        LOG(ERROR) << "canceled";
+        return false;
+      }
+      for (size_t index = 0; index < socks.size(); ++index) {
+        if (pollfds[index].revents) {
+          *ready = index;
+          return true;
+        }
+      }
+    }
+  }
+
+ private:
+  // Returns the monotonic time timeout seconds from now, or 0 if timeout is
+  // 0.
+  static uint64_t Deadline(double timeout) {
+    if (timeout <= 0) {
+      return 0;
+    }
+    return ClockMonotonicNanoseconds() + static_cast<uint64_t>(timeout * 1E9);
+  }
+
+  int cancel_fd_;
+  uint64_t deadline_;
+  uint64_t phase_deadline_;
+  double idle_timeout_;
+  bool in_transfer_;
 };
-using ScopedAddrinfo = base::ScopedGeneric<addrinfo*, ScopedAddrinfoTraits>;
 
+//! \brief A stream over a nonblocking socket, which waits for the socket with
+//!     a SocketWaiter.
 class Stream {
  public:
   virtual ~Stream() = default;
 
+  //! \brief Sets the waiter used by the request in progress. This must be
+  //!     called before the stream is used by each request.
+  void SetWaiter(SocketWaiter* waiter) { waiter_ = waiter; }
+
   virtual bool LoggingWrite(const void* data, size_t size) = 0;
+
+  //! \brief Writes the \a count buffers in \a iov, in order.
+  //!
+  //! The default implementation gathers the buffers and writes them with a
+  //! single call to LoggingWrite(), which suits streams that copy what they
+  //! write anyway, such as those that encrypt it.
+  virtual bool LoggingWriteV(const iovec* iov, size_t count) {
+    std::string gathered;
+    for (size_t index = 0; index < count; ++index) {
+      gathered.append(static_cast<const char*>(iov[index].iov_base),
+                      iov[index].iov_len);
+    }
+    return LoggingWrite(gathered.data(), gathered.size());
+  }
+
   virtual bool LoggingRead(void* data, size_t size) = 0;
   virtual bool LoggingReadToEOF(std::string* contents) = 0;
+
+ protected:
+  Stream() : waiter_(nullptr) {}
+
+  SocketWaiter* waiter() const { return waiter_; }
+
+ private:
+  SocketWaiter* waiter_;  // weak
 };
 
 class FdStream : public Stream {
  public:
-  explicit FdStream(int fd) : fd_(fd) { CHECK(fd_ >= 0); }
+  explicit FdStream(int fd) : Stream(), fd_(fd) { CHECK(fd_ >= 0); }
 
   FdStream(const FdStream&) = delete;
   FdStream& operator=(const FdStream&) = delete;
 
   bool LoggingWrite(const void* data, size_t size) override {
-    return LoggingWriteFile(fd_, data, size);
+    const char* buffer = static_cast<const char*>(data);
+    while (size > 0) {
+      const ssize_t rv = HANDLE_EINTR(send(fd_, buffer, size, kSendFlags));
+      if (rv < 0) {
+        if ((errno == EAGAIN || errno == EWOULDBLOCK) &&
+            waiter()->Wait(fd_, POLLOUT)) {
+          continue;
+        }
+        if (errno != EAGAIN && errno != EWOULDBLOCK) {
+          PLOG(ERROR) << "send";
+        }
+        return false;
+      }
+      buffer += rv;
+      size -= rv;
+    }
+    return true;
+  }
+
+  bool LoggingWriteV(const iovec* iov, size_t count) override {
+    // sendmsg() may send only part of the buffers, so keep a copy of the
+    // vector that can be advanced past what has been sent.
+    std::vector<iovec> remaining(iov, iov + count);
+    size_t index = 0;
+    while (true) {
+      while (index < remaining.size() && remaining[index].iov_len == 0) {
+        ++index;
+      }
+      if (index == remaining.size()) {
+        return true;
+      }
+
+      msghdr message = {};
+      message.msg_iov = &remaining[index];
+      message.msg_iovlen =
+          static_cast<decltype(message.msg_iovlen)>(remaining.size() - index);
+      const ssize_t rv = HANDLE_EINTR(sendmsg(fd_, &message, kSendFlags));
+      if (rv < 0) {
+        if ((errno == EAGAIN || errno == EWOULDBLOCK) &&
+            waiter()->Wait(fd_, POLLOUT)) {
+          continue;
+        }
+        if (errno != EAGAIN && errno != EWOULDBLOCK) {
+          PLOG(ERROR) << "sendmsg";
+        }
+        return false;
+      }
+
+      size_t sent = rv;
+      while (sent > 0) {
+        const size_t advance = std::min(sent, remaining[index].iov_len);
+        remaining[index].iov_base =
+            static_cast<char*>(remaining[index].iov_base) + advance;
+        remaining[index].iov_len -= advance;
+        sent -= advance;
+        if (remaining[index].iov_len == 0) {
+          ++index;
+        }
+      }
+    }
   }
 
   bool LoggingRead(void* data, size_t size) override {
-    return LoggingReadFileExactly(fd_, data, size);
+    char* buffer = static_cast<char*>(data);
+    while (size > 0) {
+      const ssize_t rv = ReadSome(buffer, size);
+      if (rv <= 0) {
+        if (rv == 0) {
+          LOG(ERROR) << "recv: unexpected EOF";
+        }
+        return false;
+      }
+      buffer += rv;
+      size -= rv;
+    }
+    return true;
   }
 
   bool LoggingReadToEOF(std::string* result) override {
-    return crashpad::LoggingReadToEOF(fd_, result);
+    result->clear();
+    char buffer[4096];
+    ssize_t rv;
+    while ((rv = ReadSome(buffer, sizeof(buffer))) > 0) {
+      result->append(buffer, rv);
+    }
+    if (rv < 0) {
+      result->clear();
+      return false;
+    }
+    return true;
   }
 
  private:
+  // Reads up to size bytes once some are available. Returns the number of
+  // bytes read, 0 at EOF, or -1 on failure with a message logged.
+  ssize_t ReadSome(char* buffer, size_t size) {
+    while (true) {
+      const ssize_t rv = HANDLE_EINTR(recv(fd_, buffer, size, 0));
+      if (rv >= 0) {
+        return rv;
+      }
+      if (errno != EAGAIN && errno != EWOULDBLOCK) {
+        PLOG(ERROR) << "recv";
+        return -1;
+      }
+      if (!waiter()->Wait(fd_, POLLIN)) {
+        return -1;
+      }
+    }
+  }
+
   int fd_;
 };
 
 #if defined(CRASHPAD_USE_BORINGSSL)
-class SSLStream : public Stream {
- public:
-  SSLStream() = default;
+struct ScopedSSLCTXTraits {
+  static SSL_CTX* InvalidValue() { return nullptr; }
+  static void Free(SSL_CTX* ctx) { SSL_CTX_free(ctx); }
+};
+using ScopedSSLCTX = base::ScopedGeneric<SSL_CTX*, ScopedSSLCTXTraits>;
 
-  SSLStream(const SSLStream&) = delete;
-  SSLStream& operator=(const SSLStream&) = delete;
+struct ScopedSSLSessionTraits {
+  static SSL_SESSION* InvalidValue() { return nullptr; }
+  static void Free(SSL_SESSION* session) { SSL_SESSION_free(session); }
+};
+using ScopedSSLSession =
+    base::ScopedGeneric<SSL_SESSION*, ScopedSSLSessionTraits>;
 
-  bool Initialize(const base::FilePath& root_cert_path,
-                  int sock,
-                  const std::string& hostname) {
-    SSL_library_init();
+ScopedSSLCTX CreateSSLContext(const base::FilePath& root_cert_path) {
+  SSL_library_init();
 
-    ctx_.reset(SSL_CTX_new(TLS_method()));
-    if (!ctx_.is_valid()) {
-      LOG(ERROR) << "SSL_CTX_new";
-      return false;
-    }
+  ScopedSSLCTX ctx(SSL_CTX_new(TLS_method()));
+  if (!ctx.is_valid()) {
+    LOG(ERROR) << "SSL_CTX_new";
+    return ScopedSSLCTX();
+  }
 
-    if (SSL_CTX_set_min_proto_version(ctx_.get(), TLS1_2_VERSION) <= 0) {
-      LOG(ERROR) << "SSL_CTX_set_min_proto_version";
-      return false;
-    }
+  if (SSL_CTX_set_min_proto_version(ctx.get(), TLS1_2_VERSION) <= 0) {
+    LOG(ERROR) << "SSL_CTX_set_min_proto_version";
+    return ScopedSSLCTX();
+  }
 
-    SSL_CTX_set_verify(ctx_.get(), SSL_VERIFY_PEER, nullptr);
-    SSL_CTX_set_verify_depth(ctx_.get(), 5);
+  SSL_CTX_set_verify(ctx.get(), SSL_VERIFY_PEER, nullptr);
+  SSL_CTX_set_verify_depth(ctx.get(), 5);
 
-    if (!root_cert_path.empty()) {
-      if (SSL_CTX_load_verify_locations(
-              ctx_.get(), root_cert_path.value().c_str(), nullptr) <= 0) {
-        LOG(ERROR) << "SSL_CTX_load_verify_locations";
-        return false;
-      }
-    } else {
+  if (!root_cert_path.empty()) {
+    if (SSL_CTX_load_verify_locations(
+            ctx.get(), root_cert_path.value().c_str(), nullptr) <= 0) {
+      LOG(ERROR) << "SSL_CTX_load_verify_locations";
+      return ScopedSSLCTX();
+    }
+  } else {
 #if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS)
-      if (SSL_CTX_load_verify_locations(
-              ctx_.get(), nullptr, "/etc/ssl/certs") <= 0) {
-        LOG(ERROR) << "SSL_CTX_load_verify_locations";
-        return false;
-      }
+    if (SSL_CTX_load_verify_locations(ctx.get(), nullptr, "/etc/ssl/certs") <=
+        0) {
+      LOG(ERROR) << "SSL_CTX_load_verify_locations";
+      return ScopedSSLCTX();
+    }
 #elif BUILDFLAG(IS_FUCHSIA)
-      if (SSL_CTX_load_verify_locations(
-              ctx_.get(), "/config/ssl/cert.pem", nullptr) <= 0) {
-        LOG(ERROR) << "SSL_CTX_load_verify_locations";
-        return false;
-      }
+    if (SSL_CTX_load_verify_locations(
+            ctx.get(), "/config/ssl/cert.pem", nullptr) <= 0) {
+      LOG(ERROR) << "SSL_CTX_load_verify_locations";
+      return ScopedSSLCTX();
+    }
 #else
 #error cert store location
 #endif
-    }
+  }
 
-    ssl_.reset(SSL_new(ctx_.get()));
+  return ctx;
+}
+
+class SSLStream : public Stream {
+ public:
+  SSLStream() : Stream(), ssl_(), sock_(-1) {}
+
+  SSLStream(const SSLStream&) = delete;
+  SSLStream& operator=(const SSLStream&) = delete;
+
+  //! \brief Performs the TLS handshake on \a sock.
+  //!
+  //! \param[in] ctx The context to create the connection from. The connection
+  //!     takes its own reference to \a ctx.
+  //! \param[in] session A session from an earlier connection to the same
+  //!     server to attempt to resume, or `nullptr` to perform a full
+  //!     handshake.
+  //! \param[in] sock The connected socket.
+  //! \param[in] hostname The name of the server, used for SNI.
+  //!
+  //! SetWaiter() must be called first.
+  bool Initialize(SSL_CTX* ctx,
+                  SSL_SESSION* session,
+                  int sock,
+                  const std::string& hostname) {
+    sock_ = sock;
+    ssl_.reset(SSL_new(ctx));
     if (!ssl_.is_valid()) {
       LOG(ERROR) << "SSL_new";
       return false;
@@ -165,27 +484,62 @@ class SSLStream : public Stream {
       return false;
     }
 
-    if (SSL_connect(ssl_.get()) <= 0) {
-      LOG(ERROR) << "SSL_connect";
-      return false;
+    // Failing to offer the session only costs a full handshake.
+    if (session && SSL_set_session(ssl_.get(), session) <= 0) {
+      LOG(WARNING) << "SSL_set_session";
+    }
+
+    int rv;
+    while ((rv = SSL_connect(ssl_.get())) <= 0) {
+      if (!WaitAfter(rv)) {
+        LOG(ERROR) << "SSL_connect";
+        return false;
+      }
     }
 
     return true;
   }
 
+  //! \brief Returns a new reference to the connection’s session, which can be
+  //!     used to resume it on a later connection.
+  ScopedSSLSession GetSession() {
+    return ScopedSSLSession(SSL_get1_session(ssl_.get()));
+  }
+
   bool LoggingWrite(const void* data, size_t size) override {
-    return SSL_write(ssl_.get(), data, size) != 0;
+    int rv;
+    while ((rv = SSL_write(
+                ssl_.get(), data, base::checked_cast<int>(size))) <= 0) {
+      if (!WaitAfter(rv)) {
+        LOG(ERROR) << "SSL_write";
+        return false;
+      }
+    }
+    return true;
   }
 
   bool LoggingRead(void* data, size_t size) override {
-    return SSL_read(ssl_.get(), data, size) != 0;
+    char* buffer = static_cast<char*>(data);
+    while (size > 0) {
+      int rv = ReadSome(
+          buffer,
+          static_cast<int>(
+              std::min(size, size_t{std::numeric_limits<int>::max()})));
+      if (rv <= 0) {
+        LOG(ERROR) << "SSL_read";
+        return false;
+      }
+      buffer += rv;
+      size -= rv;
+    }
+    return true;
   }
 
   bool LoggingReadToEOF(std::string* contents) override {
     contents->clear();
     char buffer[4096];
-    FileOperationResult rv;
-    while ((rv = SSL_read(ssl_.get(), buffer, sizeof(buffer))) > 0) {
+    int rv;
+    while ((rv = ReadSome(buffer, sizeof(buffer))) > 0) {
       DCHECK_LE(static_cast<size_t>(rv), sizeof(buffer));
       contents->append(buffer, rv);
     }
@@ -198,12 +552,6 @@ class SSLStream : public Stream {
   }
 
  private:
-  struct ScopedSSLCTXTraits {
-    static SSL_CTX* InvalidValue() { return nullptr; }
-    static void Free(SSL_CTX* ctx) { SSL_CTX_free(ctx); }
-  };
-  using ScopedSSLCTX = base::ScopedGeneric<SSL_CTX*, ScopedSSLCTXTraits>;
-
   struct ScopedSSLTraits {
     static SSL* InvalidValue() { return nullptr; }
     static void Free(SSL* ssl) {
@@ -213,182 +561,479 @@ class SSLStream : public Stream {
   };
   using ScopedSSL = base::ScopedGeneric<SSL*, ScopedSSLTraits>;
 
-  ScopedSSLCTX ctx_;
+  // Waits for the socket after an SSL function returned rv, if it asked to
+  // read or write more. Returns false if the function failed otherwise, or if
+  // waiting failed.
+  bool WaitAfter(int rv) {
+    switch (SSL_get_error(ssl_.get(), rv)) {
+      case SSL_ERROR_WANT_READ:
+        return waiter()->Wait(sock_, POLLIN);
+      case SSL_ERROR_WANT_WRITE:
+        return waiter()->Wait(sock_, POLLOUT);
+      default:
+        return false;
+    }
+  }
+
+  // Reads up to size bytes once some are available. Returns the number of
+  // bytes read, 0 at EOF, or -1 on failure.
+  int ReadSome(char* buffer, int size) {
+    int rv;
+    while ((rv = SSL_read(ssl_.get(), buffer, size)) <= 0) {
+      if (rv == 0 ||
+          SSL_get_error(ssl_.get(), rv) == SSL_ERROR_ZERO_RETURN) {
+        return 0;
+      }
+      if (!WaitAfter(rv)) {
+        return -1;
+      }
+    }
+    return rv;
+  }
+
   ScopedSSL ssl_;
+  int sock_;
 };
 #endif
 
-bool WaitUntilSocketIsReady(int sock) {
-  pollfd pollfds;
+//! \brief A connected socket and the stream used to communicate over it.
+class Connection {
+ public:
+  Connection(base::ScopedFD sock, std::unique_ptr<Stream> stream)
+      : sock_(std::move(sock)), stream_(std::move(stream)) {}
+
+  Connection(const Connection&) = delete;
+  Connection& operator=(const Connection&) = delete;
+
+  int sock() const { return sock_.get(); }
+  Stream* stream() const { return stream_.get(); }
+
+ private:
+  // stream_ may refer to sock_, so it is declared after sock_ in order to be
+  // destroyed first.
+  base::ScopedFD sock_;
+  std::unique_ptr<Stream> stream_;
+};
+
+//! \brief Determines whether an idle connection can still be used.
+//!
+//! A server may close an idle connection at any time. An idle connection that
+//! has become readable has either been closed or has received data that was
+//! never requested, and must not be reused in either case.
+bool IsIdleConnectionUsable(int sock) {
+  pollfd pollfds = {};
   pollfds.fd = sock;
-  pollfds.events = POLLIN | POLLPRI | POLLOUT;
-  constexpr int kTimeoutMS = 1000;
-  int ret = HANDLE_EINTR(poll(&pollfds, 1, kTimeoutMS));
+  pollfds.events = POLLIN;
+  int ret = HANDLE_EINTR(poll(&pollfds, 1, 0));
   if (ret < 0) {
     PLOG(ERROR) << "poll";
     return false;
-  } else if (ret == 1) {
-    if (pollfds.revents & POLLERR) {
-      int err;
-      socklen_t err_len = sizeof(err);
-      if (getsockopt(sock, SOL_SOCKET, SO_ERROR, &err, &err_len) != 0) {
-        PLOG(ERROR) << "getsockopt";
-      } else {
-        errno = err;
-        PLOG(ERROR) << "POLLERR";
-      }
-      return false;
-    }
-    if (pollfds.revents & POLLHUP) {
-      return false;
-    }
-    return (pollfds.revents & POLLIN) != 0 || (pollfds.revents & POLLOUT) != 0;
   }
-
-  // Timeout.
-  return false;
+  return ret == 0;
 }
 
-class ScopedSetNonblocking {
+//! \brief Idle connections and TLS state shared by all HTTPTransportSocket
+//!     objects in the process that have enabled connection reuse.
+class ConnectionPool {
  public:
-  explicit ScopedSetNonblocking(int sock) : sock_(sock) {
-    int flags = fcntl(sock, F_GETFL, 0);
-    if (flags < 0) {
-      PLOG(ERROR) << "fcntl";
-      sock_ = -1;
-      return;
-    }
+  ConnectionPool(const ConnectionPool&) = delete;
+  ConnectionPool& operator=(const ConnectionPool&) = delete;
+
+  static ConnectionPool* Get() {
+    static ConnectionPool* const pool = new ConnectionPool();
+    return pool;
+  }
 
-    if (fcntl(sock_, F_SETFL, flags | O_NONBLOCK) < 0) {
-      PLOG(ERROR) << "fcntl";
-      sock_ = -1;
+  //! \brief Removes an idle connection made with \a key from the pool.
+  //!
+  //! Connections that have expired or been closed by the server are discarded.
+  //!
+  //! \return A connection, or `nullptr` if none is available.
+  std::unique_ptr<Connection> Take(const std::string& key) {
+    // Discarded connections are closed after the lock is released.
+    std::vector<std::unique_ptr<Connection>> discarded;
+    std::unique_ptr<Connection> connection;
+
+    base::AutoLock lock(lock_);
+    const uint64_t now = ClockMonotonicNanoseconds();
+    for (auto it = idle_connections_.begin();
+         it != idle_connections_.end();) {
+      if (now >= it->expiration_time ||
+          !IsIdleConnectionUsable(it->connection->sock())) {
+        discarded.push_back(std::move(it->connection));
+        it = idle_connections_.erase(it);
+      } else if (!connection && it->key == key) {
+        connection = std::move(it->connection);
+        it = idle_connections_.erase(it);
+      } else {
+        ++it;
+      }
     }
+    return connection;
   }
 
-  ScopedSetNonblocking(const ScopedSetNonblocking&) = delete;
-  ScopedSetNonblocking& operator=(const ScopedSetNonblocking&) = delete;
+  //! \brief Adds an idle connection made with \a key to the pool.
+  //!
+  //! \param[in] key Identifies the server that \a connection is connected to.
+  //! \param[in] connection The connection. It must not have any request in
+  //!     progress.
+  //! \param[in] idle_timeout The number of nanoseconds after which \a
+  //!     connection expires if it has not been taken from the pool.
+  void Put(const std::string& key,
+           std::unique_ptr<Connection> connection,
+           uint64_t idle_timeout) {
+    std::unique_ptr<Connection> evicted;
+
+    base::AutoLock lock(lock_);
+    if (idle_connections_.size() >= kMaxIdleConnections) {
+      evicted = std::move(idle_connections_.front().connection);
+      idle_connections_.erase(idle_connections_.begin());
+    }
 
-  ~ScopedSetNonblocking() {
-    if (sock_ >= 0) {
-      int flags = fcntl(sock_, F_GETFL, 0);
-      if (flags < 0) {
-        PLOG(ERROR) << "fcntl";
-        return;
-      }
+    IdleConnection idle_connection;
+    idle_connection.key = key;
+    idle_connection.connection = std::move(connection);
+    idle_connection.expiration_time =
+        ClockMonotonicNanoseconds() + idle_timeout;
+    idle_connections_.push_back(std::move(idle_connection));
+  }
 
-      if (fcntl(sock_, F_SETFL, flags & (~O_NONBLOCK)) < 0) {
-        PLOG(ERROR) << "fcntl";
-      }
+#if defined(CRASHPAD_USE_BORINGSSL)
+  //! \brief Returns a context that verifies servers using \a root_cert_path,
+  //!     creating it the first time it is needed.
+  //!
+  //! \return The context, which remains owned by the pool and valid for the
+  //!     lifetime of the process, or `nullptr` on failure with a message
+  //!     logged.
+  SSL_CTX* GetSSLContext(const base::FilePath& root_cert_path) {
+    base::AutoLock lock(lock_);
+    ScopedSSLCTX& ctx = ssl_contexts_[root_cert_path.value()];
+    if (!ctx.is_valid()) {
+      ctx = CreateSSLContext(root_cert_path);
+    }
+    return ctx.get();
+  }
+
+  //! \brief Returns a new reference to the session most recently stored for
+  //!     \a key, or an invalid object if there is none.
+  ScopedSSLSession GetSSLSession(const std::string& key) {
+    base::AutoLock lock(lock_);
+    const auto it = ssl_sessions_.find(key);
+    if (it == ssl_sessions_.end() || !it->second.is_valid()) {
+      return ScopedSSLSession();
     }
+    SSL_SESSION_up_ref(it->second.get());
+    return ScopedSSLSession(it->second.get());
   }
 
+  //! \brief Stores \a session for resumption by later connections made with
+  //!     \a key.
+  void SetSSLSession(const std::string& key, ScopedSSLSession session) {
+    base::AutoLock lock(lock_);
+    ssl_sessions_[key] = std::move(session);
+  }
+#endif  // CRASHPAD_USE_BORINGSSL
+
  private:
-  int sock_;
+  struct IdleConnection {
+    std::string key;
+    std::unique_ptr<Connection> connection;
+    uint64_t expiration_time;
+  };
+
+  //! \brief The maximum number of idle connections kept, across all servers.
+  static constexpr size_t kMaxIdleConnections = 4;
+
+  ConnectionPool() = default;
+
+  base::Lock lock_;
+
+  // Ordered from least to most recently added.
+  std::vector<IdleConnection> idle_connections_;
+
+#if defined(CRASHPAD_USE_BORINGSSL)
+  std::map<base::FilePath::StringType, ScopedSSLCTX> ssl_contexts_;
+  std::map<std::string, ScopedSSLSession> ssl_sessions_;
+#endif  // CRASHPAD_USE_BORINGSSL
 };
 
-base::ScopedFD CreateSocket(const std::string& hostname,
-                            const std::string& port) {
-  addrinfo hints = {};
-  hints.ai_family = AF_UNSPEC;
-  hints.ai_socktype = SOCK_STREAM;
-  hints.ai_protocol = 0;
-  hints.ai_flags = 0;
-
-  addrinfo* addrinfo_raw;
-  if (getaddrinfo(hostname.c_str(), port.c_str(), &hints, &addrinfo_raw) < 0) {
-    PLOG(ERROR) << "getaddrinfo";
+// Makes sock nonblocking. Returns false on failure, with a message logged.
+bool SetNonblocking(int sock) {
+  const int flags = fcntl(sock, F_GETFL, 0);
+  if (flags < 0) {
+    PLOG(ERROR) << "fcntl";
+    return false;
+  }
+  if (fcntl(sock, F_SETFL, flags | O_NONBLOCK) < 0) {
+    PLOG(ERROR) << "fcntl";
+    return false;
+  }
+  return true;
+}
+
+// Starts connecting a nonblocking socket to address. Returns an invalid socket
+// on failure, with a message logged. Sets *connected to whether the connection
+// was made immediately, or is still in progress.
+base::ScopedFD StartConnecting(const ResolvedAddress& address,
+                               bool* connected) {
+  *connected = false;
+  base::ScopedFD sock(
+      socket(address.family, address.socktype, address.protocol));
+  if (!sock.is_valid()) {
+    PLOG(WARNING) << "socket";
     return base::ScopedFD();
   }
-  ScopedAddrinfo addrinfo(addrinfo_raw);
 
-  for (const auto* ap = addrinfo.get(); ap; ap = ap->ai_next) {
-    base::ScopedFD result(
-        socket(ap->ai_family, ap->ai_socktype, ap->ai_protocol));
-    if (!result.is_valid()) {
-      continue;
+  // The socket is nonblocking so that each wait for it is limited by the
+  // request’s timeouts, and can be interrupted by cancellation.
+  if (!SetNonblocking(sock.get())) {
+    return base::ScopedFD();
+  }
+
+  if (HANDLE_EINTR(connect(sock.get(),
+                           reinterpret_cast<const sockaddr*>(&address.address),
+                           address.address_length)) < 0) {
+    if (errno != EINPROGRESS) {
+      PLOG(WARNING) << "connect";
+      return base::ScopedFD();
     }
+  } else {
+    *connected = true;
+  }
+  return sock;
+}
 
-    {
-      // Set socket to non-blocking to avoid hanging for a long time if the
-      // network is down.
-      ScopedSetNonblocking nonblocking(result.get());
+// Returns a nonblocking socket connected to one of addresses, waiting for the
+// connection with waiter, and sets *connected_index to the index of that
+// address.
+//
+// This follows the “Happy Eyeballs” algorithm of RFC 8305 §5: connections are
+// attempted in order, with each attempt started once the one before it fails
+// or has been in progress for the connection attempt delay, and the first to
+// succeed is used. An unreachable address thus delays connecting by no more
+// than the connection attempt delay, rather than by the connection timeout.
+base::ScopedFD ConnectToAny(const std::vector<ResolvedAddress>& addresses,
+                            SocketWaiter* waiter,
+                            size_t* connected_index) {
+  // The connection attempt delay recommended by RFC 8305 §8.
+  constexpr double kConnectionAttemptDelay = 0.25;
+
+  struct Attempt {
+    base::ScopedFD sock;
+    size_t address_index;
+  };
+  std::vector<Attempt> attempts;
+  size_t next_address = 0;
+  bool start_attempt = true;
+  while (true) {
+    if (start_attempt && next_address < addresses.size()) {
+      bool connected;
+      base::ScopedFD sock(StartConnecting(addresses[next_address], &connected));
+      if (connected) {
+        *connected_index = next_address;
+        return sock;
+      }
+      ++next_address;
+      if (!sock.is_valid()) {
+        continue;
+      }
+      attempts.push_back({std::move(sock), next_address - 1});
+      start_attempt = false;
+    }
 
-      if (HANDLE_EINTR(connect(result.get(), ap->ai_addr, ap->ai_addrlen)) <
-          0) {
-        if (errno != EINPROGRESS) {
-          PLOG(ERROR) << "connect";
-        } else if (WaitUntilSocketIsReady(result.get())) {
-          return result;
-        }
-        return base::ScopedFD();
+    if (attempts.empty()) {
+      if (next_address < addresses.size()) {
+        start_attempt = true;
+        continue;
       }
+      LOG(ERROR) << "no address could be connected to";
+      return base::ScopedFD();
+    }
+
+    std::vector<int> socks;
+    for (const Attempt& attempt : attempts) {
+      socks.push_back(attempt.sock.get());
+    }
+    size_t ready;
+    if (!waiter->WaitAny(socks,
+                         POLLOUT,
+                         next_address < addresses.size()
+                             ? kConnectionAttemptDelay
+                             : 0,
+                         &ready)) {
+      return base::ScopedFD();
+    }
+    start_attempt = true;
+    if (ready == attempts.size()) {
+      // The connection attempt delay passed.
+      continue;
+    }
 
-      return result;
+    Attempt& attempt = attempts[ready];
+    int err;
+    socklen_t err_len = sizeof(err);
+    if (getsockopt(attempt.sock.get(), SOL_SOCKET, SO_ERROR, &err, &err_len) !=
+        0) {
+      PLOG(WARNING) << "getsockopt";
+    } else if (err == 0) {
+      *connected_index = attempt.address_index;
+      return std::move(attempt.sock);
+    } else {
+      errno = err;
+      PLOG(WARNING) << "connect";
     }
+    attempts.erase(attempts.begin() + ready);
   }
+}
 
-  return base::ScopedFD();
+// Returns a nonblocking socket connected to hostname and port, waiting for
+// the connection with waiter.
+base::ScopedFD CreateSocket(const std::string& hostname,
+                            const std::string& port,
+                            SocketWaiter* waiter) {
+  ResolverCache* const resolver_cache = ResolverCache::Get();
+  std::vector<ResolvedAddress> addresses;
+  if (!resolver_cache->Resolve(hostname, port, &addresses)) {
+    return base::ScopedFD();
+  }
+
+  size_t connected_index;
+  base::ScopedFD sock(ConnectToAny(addresses, waiter, &connected_index));
+  if (!sock.is_valid()) {
+    // The addresses may have changed, so resolve them again next time.
+    resolver_cache->Forget(hostname, port);
+  } else if (connected_index != 0) {
+    resolver_cache->Prefer(hostname, port, addresses[connected_index]);
+  }
+  return sock;
+}
+
+// Returns the value of the header named |name|, compared case-insensitively,
+// or nullptr if it isn't present.
+const std::string* FindHeader(const HTTPHeaders& headers, const char* name) {
+  for (const auto& header : headers) {
+    if (strcasecmp(header.first.c_str(), name) == 0) {
+      return &header.second;
+    }
+  }
+  return nullptr;
 }
 
+// Writes an HTTP/1.0 request if |host| is empty. Otherwise, writes an HTTP/1.1
+// request, for which connections persist by default, identifying the server as
+// |host|.
 bool WriteRequest(Stream* stream,
                   const std::string& method,
                   const std::string& resource,
+                  const std::string& host,
                   const HTTPHeaders& headers,
                   HTTPBodyStream* body_stream) {
-  std::string request_line = base::StringPrintf(
-      "%s %s HTTP/1.0\r\n", method.c_str(), resource.c_str());
-  if (!stream->LoggingWrite(request_line.data(), request_line.size()))
-    return false;
+  // The request line and headers are gathered into a single write, so that
+  // they don’t each cost a system call, and a TLS record when using TLS.
+  std::string header_block =
+      base::StringPrintf("%s %s HTTP/%s\r\n",
+                         method.c_str(),
+                         resource.c_str(),
+                         host.empty() ? "1.0" : "1.1");
+
+  if (!host.empty() && !FindHeader(headers, "Host")) {
+    header_block += base::StringPrintf("Host: %s\r\n", host.c_str());
+  }
 
-  // Write headers, and determine if Content-Length has been specified.
+  // Add headers, and determine if Content-Length has been specified.
   bool chunked = true;
   size_t content_length = 0;
   for (const auto& header : headers) {
-    std::string header_str = base::StringPrintf(
+    header_block += base::StringPrintf(
         "%s: %s\r\n", header.first.c_str(), header.second.c_str());
     if (header.first == kContentLength) {
       chunked = !base::StringToSizeT(header.second, &content_length);
       DCHECK(!chunked);
     }
-
-    if (!stream->LoggingWrite(header_str.data(), header_str.size()))
-      return false;
   }
 
   // If no Content-Length, then encode as chunked, so add that header too.
   if (chunked) {
-    static constexpr const char kTransferEncodingChunked[] =
-        "Transfer-Encoding: chunked\r\n";
-    if (!stream->LoggingWrite(kTransferEncodingChunked,
-                              strlen(kTransferEncodingChunked))) {
-      return false;
-    }
+    header_block += "Transfer-Encoding: chunked\r\n";
   }
 
-  if (!stream->LoggingWrite(kCRLFTerminator, strlen(kCRLFTerminator))) {
+  header_block += kCRLFTerminator;
+  if (!stream->LoggingWrite(header_block.data(), header_block.size())) {
     return false;
   }
 
-  FileOperationResult data_bytes;
+  constexpr size_t kCRLFSize = std::size(kCRLFTerminator) - 1;
+  constexpr size_t kChunkDataSize = 64 * 1024;
+  struct __attribute__((packed)) ChunkBuffer {
+    char size[8];
+    char crlf[2];
+    uint8_t data[kChunkDataSize + kCRLFSize];
+  };
+  static_assert(sizeof(ChunkBuffer) == sizeof(ChunkBuffer::size) +
+                                           sizeof(ChunkBuffer::crlf) +
+                                           sizeof(ChunkBuffer::data),
+                "ChunkBuffer should not have padding");
+  std::unique_ptr<ChunkBuffer> chunk_buffer(new ChunkBuffer);
+  ChunkBuffer& buf = *chunk_buffer;
+
+  // Bytes that the body stream holds in memory, such as the contents of a
+  // mapped file, are written from where they are rather than being copied into
+  // buf first. Runs shorter than this are still gathered into buf, so that
+  // they don’t each cost a write, and a chunk.
+  constexpr size_t kInPlaceMinimumSize = 16 * 1024;
+
+  bool eof = false;
+  size_t data_bytes;
   do {
-    constexpr size_t kCRLFSize = std::size(kCRLFTerminator) - 1;
-    struct __attribute__((packed)) {
-      char size[8];
-      char crlf[2];
-      uint8_t data[32 * 1024 + kCRLFSize];
-    } buf;
-    static_assert(
-        sizeof(buf) == sizeof(buf.size) + sizeof(buf.crlf) + sizeof(buf.data),
-        "buf should not have padding");
-
-    // Read a block of data.
-    data_bytes =
-        body_stream->GetBytesBuffer(buf.data, sizeof(buf.data) - kCRLFSize);
-    if (data_bytes == -1) {
-      return false;
+    const uint8_t* data = buf.data;
+    data_bytes = 0;
+    const uint8_t* in_place_data;
+    size_t in_place_bytes;
+    if (!eof && body_stream->GetBytesInPlace(
+                    &in_place_data, kChunkDataSize, &in_place_bytes)) {
+      eof = in_place_bytes == 0;
+      if (in_place_bytes >= kInPlaceMinimumSize) {
+        data = in_place_data;
+      } else if (in_place_bytes > 0) {
+        memcpy(buf.data, in_place_data, in_place_bytes);
+      }
+      data_bytes = in_place_bytes;
+    }
+
+    // Read a block of data. The body stream may return less than was asked for
+    // even before its end, so keep reading until the block is full, making each
+    // chunk, and each write, as large as possible.
+    while (data == buf.data && !eof && data_bytes < kChunkDataSize) {
+      FileOperationResult read_bytes = body_stream->GetBytesBuffer(
+          buf.data + data_bytes, kChunkDataSize - data_bytes);
+      if (read_bytes == -1) {
+        return false;
+      }
+      DCHECK_GE(read_bytes, 0);
+      DCHECK_LE(static_cast<size_t>(read_bytes), kChunkDataSize - data_bytes);
+      eof = read_bytes == 0;
+      data_bytes += static_cast<size_t>(read_bytes);
+    }
+
+    if (data != buf.data) {
+      // The data is in place, so it can’t be framed in buf. The chunk size and
+      // terminating CR and LF, if needed, are written around it.
+      if (chunked) {
+        const std::string size =
+            base::StringPrintf("%zx%s", data_bytes, kCRLFTerminator);
+        const iovec iov[] = {
+            {const_cast<char*>(size.data()), size.size()},
+            {const_cast<uint8_t*>(data), data_bytes},
+            {const_cast<char*>(kCRLFTerminator), kCRLFSize},
+        };
+        if (!stream->LoggingWriteV(iov, std::size(iov))) {
+          return false;
+        }
+      } else if (!stream->LoggingWrite(data, data_bytes)) {
+        return false;
+      }
+      continue;
     }
-    DCHECK_GE(data_bytes, 0);
-    DCHECK_LE(static_cast<size_t>(data_bytes), sizeof(buf.data) - kCRLFSize);
 
     void* write_start;
     size_t write_size;
@@ -429,8 +1074,9 @@ bool WriteRequest(Stream* stream,
 
     // write_size will be 0 at EOF in non-chunked mode. Skip the write in that
     // case. In contrast, at EOF in chunked mode, a zero-length chunk must be
-    // sent to signal EOF. This will happen when processing the EOF indicated by
-    // a 0 return from body_stream()->GetBytesBuffer() above.
+    // sent to signal EOF. This will happen on the pass after the one that
+    // reached the EOF indicated by a 0 return from
+    // body_stream()->GetBytesBuffer() above.
     if (write_size != 0) {
       if (!stream->LoggingWrite(write_start, write_size))
         return false;
@@ -458,7 +1104,10 @@ bool StartsWith(const std::string& str, const char* with, size_t len) {
   return str.compare(0, len, with) == 0;
 }
 
-bool ReadResponseLine(Stream* stream) {
+// On success, |persistent| is set to whether the server's HTTP version keeps
+// connections open by default, and |status| is set to the response's status
+// code.
+bool ReadResponseLine(Stream* stream, bool* persistent, unsigned int* status) {
   std::string response_line;
   if (!ReadLine(stream, &response_line)) {
     LOG(ERROR) << "ReadLine";
@@ -472,10 +1121,8 @@ bool ReadResponseLine(Stream* stream) {
       response_line.at(strlen(kHttp10) + 3) != ' ') {
     return false;
   }
-  unsigned int http_status = 0;
-  return base::StringToUint(response_line.substr(strlen(kHttp10), 3),
-                            &http_status) &&
-         http_status >= 200 && http_status <= 203;
+  *persistent = StartsWith(response_line, kHttp11, strlen(kHttp11));
+  return base::StringToUint(response_line.substr(strlen(kHttp10), 3), status);
 }
 
 bool ReadResponseHeaders(Stream* stream, HTTPHeaders* headers) {
@@ -504,48 +1151,163 @@ bool ReadResponseHeaders(Stream* stream, HTTPHeaders* headers) {
 }
 
 bool ReadContentChunked(Stream* stream, std::string* body) {
-  // TODO(scottmg): https://crashpad.chromium.org/bug/196.
-  LOG(ERROR) << "TODO(scottmg): chunked response read";
-  return false;
+  for (;;) {
+    std::string line;
+    if (!ReadLine(stream, &line)) {
+      return false;
+    }
+
+    // The hexadecimal chunk size may be followed by chunk extensions, which
+    // are ignored.
+    int chunk_size;
+    if (!base::HexStringToInt(line.substr(0, line.find_first_of(";\r\n")),
+                              &chunk_size) ||
+        chunk_size < 0) {
+      LOG(ERROR) << "invalid chunk size";
+      return false;
+    }
+
+    if (chunk_size == 0) {
+      break;
+    }
+
+    const size_t offset = body->size();
+    body->resize(offset + chunk_size);
+    if (!stream->LoggingRead(&(*body)[offset], chunk_size)) {
+      return false;
+    }
+
+    char crlf[2];
+    if (!stream->LoggingRead(crlf, sizeof(crlf))) {
+      return false;
+    }
+    if (memcmp(crlf, kCRLFTerminator, sizeof(crlf)) != 0) {
+      LOG(ERROR) << "invalid chunk terminator";
+      return false;
+    }
+  }
+
+  // Skip any trailer fields.
+  for (;;) {
+    std::string line;
+    if (!ReadLine(stream, &line)) {
+      return false;
+    }
+    if (line == kCRLFTerminator) {
+      return true;
+    }
+  }
 }
 
-bool ReadResponse(Stream* stream, std::string* response_body) {
+// Reads a complete response, whatever its status. On success, |status| is set
+// to the response's status code, |response_headers| is set to the response's
+// header fields, and |reusable| is set to whether the connection may be used
+// for another request. |head_request| is whether the request's method was HEAD.
+bool ReadResponse(Stream* stream,
+                  bool head_request,
+                  unsigned int* status,
+                  std::string* response_body,
+                  HTTPHeaders* response_headers,
+                  bool* reusable) {
   response_body->clear();
+  response_headers->clear();
+  *reusable = false;
 
-  if (!ReadResponseLine(stream)) {
+  bool persistent;
+  if (!ReadResponseLine(stream, &persistent, status)) {
     return false;
   }
 
-  HTTPHeaders response_headers;
-  if (!ReadResponseHeaders(stream, &response_headers)) {
+  if (!ReadResponseHeaders(stream, response_headers)) {
     return false;
   }
 
-  auto it = response_headers.find("Content-Length");
-  size_t len = 0;
-  if (it != response_headers.end()) {
-    if (!base::StringToSizeT(it->second, &len)) {
-      LOG(ERROR) << "invalid Content-Length";
+  const std::string* connection = FindHeader(*response_headers, "Connection");
+  if (connection) {
+    if (strcasecmp(connection->c_str(), "close") == 0) {
+      persistent = false;
+    } else if (strcasecmp(connection->c_str(), "keep-alive") == 0) {
+      persistent = true;
+    }
+  }
+
+  // Responses to HEAD requests, and 204 and 304 responses, never have a body,
+  // whatever their header fields say (RFC 9112 §6.3).
+  if (head_request || *status == 204 || *status == 304) {
+    *reusable = persistent;
+    return true;
+  }
+
+  // Transfer-Encoding takes precedence over Content-Length (RFC 7230 §3.3.3).
+  const std::string* transfer_encoding =
+      FindHeader(*response_headers, "Transfer-Encoding");
+  if (transfer_encoding && *transfer_encoding == "chunked") {
+    if (!ReadContentChunked(stream, response_body)) {
+      response_body->clear();
       return false;
     }
+    *reusable = persistent;
+    return true;
   }
 
-  if (len) {
-    response_body->resize(len, 0);
-    return stream->LoggingRead(&(*response_body)[0], len);
+  const std::string* content_length =
+      FindHeader(*response_headers, kContentLength);
+  if (content_length) {
+    size_t len;
+    if (!base::StringToSizeT(*content_length, &len)) {
+      LOG(ERROR) << "invalid Content-Length";
+      return false;
+    }
+
+    if (len) {
+      response_body->resize(len, 0);
+      if (!stream->LoggingRead(&(*response_body)[0], len)) {
+        response_body->clear();
+        return false;
+      }
+    }
+    *reusable = persistent;
+    return true;
   }
 
-  it = response_headers.find("Transfer-Encoding");
-  bool chunked = false;
-  if (it != response_headers.end() && it->second == "chunked") {
-    chunked = true;
+  // Without a length, the body is delimited by the server closing the
+  // connection.
+  return stream->LoggingReadToEOF(response_body);
+}
+
+HTTPTransportSocket::HTTPTransportSocket()
+    : HTTPTransport(), cancel_read_fd_(), cancel_write_fd_() {
+  // Without the pipe, a request is only canceled between its phases.
+  int fds[2];
+  if (pipe(fds) != 0) {
+    PLOG(WARNING) << "pipe";
+    return;
   }
+  cancel_read_fd_.reset(fds[0]);
+  cancel_write_fd_.reset(fds[1]);
+}
 
-  return chunked ? ReadContentChunked(stream, response_body)
-                 : stream->LoggingReadToEOF(response_body);
+void HTTPTransportSocket::OnCancel() {
+  if (cancel_write_fd_.is_valid()) {
+    // The pipe is never read from, so it stays readable once written to.
+    static constexpr char kByte = 0;
+    if (HANDLE_EINTR(write(cancel_write_fd_.get(), &kByte, 1)) != 1) {
+      PLOG(ERROR) << "write";
+    }
+  }
 }
 
 bool HTTPTransportSocket::ExecuteSynchronously(std::string* response_body) {
+  SetResponseHeaders(HTTPHeaders());
+  SetResponseStatus(0);
+
+  if (canceled()) {
+    LOG(ERROR) << "canceled";
+    return false;
+  }
+
+  SocketWaiter waiter(cancel_read_fd_.get(), timeout(), idle_timeout());
+
   std::string scheme, hostname, port, resource;
   if (!CrackURL(url(), &scheme, &hostname, &port, &resource)) {
     return false;
@@ -556,34 +1318,129 @@ bool HTTPTransportSocket::ExecuteSynchronously(std::string* response_body) {
                           << "'";
 #endif
 
-  base::ScopedFD sock(CreateSocket(hostname, port));
-  if (!sock.is_valid()) {
-    return false;
+  ConnectionPool* const pool =
+      keep_alive_timeout() > 0 ? ConnectionPool::Get() : nullptr;
+
+  // Connections are only shared between requests made to the same server with
+  // the same TLS configuration.
+  std::string host;
+  std::string connection_key;
+  if (pool) {
+    host = hostname;
+    if (!((scheme == "http" && port == "80") ||
+          (scheme == "https" && port == "443"))) {
+      host.append(":" + port);
+    }
+    connection_key =
+        base::StringPrintf("%s://%s:%s %s",
+                           scheme.c_str(),
+                           hostname.c_str(),
+                           port.c_str(),
+                           root_ca_certificate_path().value().c_str());
+  }
+
+  // A pooled connection can't be retried if the server has closed it since it
+  // was checked, because the body stream has been consumed by then. The
+  // request fails, and is retried by the caller.
+  std::unique_ptr<Connection> connection;
+  if (pool) {
+    connection = pool->Take(connection_key);
   }
 
 #if defined(CRASHPAD_USE_BORINGSSL)
-  std::unique_ptr<Stream> stream;
-  if (scheme == "https") {
-    auto ssl_stream = std::make_unique<SSLStream>();
-    if (!ssl_stream->Initialize(
-            root_ca_certificate_path(), sock.get(), hostname)) {
-      LOG(ERROR) << "SSLStream Initialize";
+  // Set when a new TLS connection is established, so that its session can be
+  // stored for resumption once the response, which may bring a new session
+  // ticket, has been read.
+  SSLStream* new_ssl_stream = nullptr;
+#endif  // CRASHPAD_USE_BORINGSSL
+
+  if (!connection) {
+    // Name resolution is not limited by the connection timeout, and can’t be
+    // canceled.
+    waiter.BeginHandshake(connect_timeout());
+    base::ScopedFD sock(CreateSocket(hostname, port, &waiter));
+    if (!sock.is_valid()) {
       return false;
     }
-    stream = std::move(ssl_stream);
-  } else {
-    stream = std::make_unique<FdStream>(sock.get());
-  }
+
+#if defined(CRASHPAD_USE_BORINGSSL)
+    std::unique_ptr<Stream> stream;
+    if (scheme == "https") {
+      ScopedSSLCTX owned_ctx;
+      SSL_CTX* ctx;
+      ScopedSSLSession session;
+      if (pool) {
+        ctx = pool->GetSSLContext(root_ca_certificate_path());
+        session = pool->GetSSLSession(connection_key);
+      } else {
+        owned_ctx = CreateSSLContext(root_ca_certificate_path());
+        ctx = owned_ctx.get();
+      }
+      if (!ctx) {
+        return false;
+      }
+
+      waiter.BeginHandshake(tls_handshake_timeout());
+      auto ssl_stream = std::make_unique<SSLStream>();
+      ssl_stream->SetWaiter(&waiter);
+      if (!ssl_stream->Initialize(ctx, session.get(), sock.get(), hostname)) {
+        LOG(ERROR) << "SSLStream Initialize";
+        return false;
+      }
+      new_ssl_stream = ssl_stream.get();
+      stream = std::move(ssl_stream);
+    } else {
+      stream = std::make_unique<FdStream>(sock.get());
+    }
 #else  // CRASHPAD_USE_BORINGSSL
-  std::unique_ptr<Stream> stream(std::make_unique<FdStream>(sock.get()));
+    std::unique_ptr<Stream> stream(std::make_unique<FdStream>(sock.get()));
 #endif  // CRASHPAD_USE_BORINGSSL
 
-  if (!WriteRequest(
-          stream.get(), method(), resource, headers(), body_stream())) {
+    connection =
+        std::make_unique<Connection>(std::move(sock), std::move(stream));
+  }
+
+  waiter.BeginTransfer();
+  connection->stream()->SetWaiter(&waiter);
+  if (!WriteRequest(connection->stream(),
+                    method(),
+                    resource,
+                    host,
+                    headers(),
+                    body_stream())) {
+    return false;
+  }
+
+  unsigned int status;
+  HTTPHeaders response_headers;
+  bool reusable;
+  if (!ReadResponse(connection->stream(),
+                    method() == "HEAD",
+                    &status,
+                    response_body,
+                    &response_headers,
+                    &reusable)) {
     return false;
   }
+  SetResponseStatus(static_cast<int>(status));
+  SetResponseHeaders(response_headers);
+
+  if (pool) {
+#if defined(CRASHPAD_USE_BORINGSSL)
+    if (new_ssl_stream) {
+      pool->SetSSLSession(connection_key, new_ssl_stream->GetSession());
+    }
+#endif  // CRASHPAD_USE_BORINGSSL
+
+    if (reusable) {
+      pool->Put(connection_key,
+                std::move(connection),
+                static_cast<uint64_t>(keep_alive_timeout() * 1E9));
+    }
+  }
 
-  if (!ReadResponse(stream.get(), response_body)) {
+  if ((status < 200 || status > 203) && status != 206) {
+    response_body->clear();
     return false;
   }
 
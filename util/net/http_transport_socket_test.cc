@@ -0,0 +1,147 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <string.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/files/scoped_file.h"
+#include "base/posix/eintr_wrapper.h"
+#include "gtest/gtest.h"
+#include "test/errors.h"
+#include "util/file/file_io.h"
+#include "util/net/http_body.h"
+#include "util/net/http_transport.h"
+#include "util/net/resolver_cache.h"
+#include "util/thread/thread.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+// Returns a TCP socket bound to an ephemeral port on the loopback address,
+// with address set to where it’s bound.
+base::ScopedFD BindLoopbackSocket(ResolvedAddress* address) {
+  base::ScopedFD sock(socket(AF_INET, SOCK_STREAM, 0));
+  EXPECT_TRUE(sock.is_valid()) << ErrnoMessage("socket");
+  if (!sock.is_valid()) {
+    return base::ScopedFD();
+  }
+
+  *address = {};
+  sockaddr_in* sin = reinterpret_cast<sockaddr_in*>(&address->address);
+  sin->sin_family = AF_INET;
+  sin->sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  address->address_length = sizeof(*sin);
+  if (bind(sock.get(),
+           reinterpret_cast<sockaddr*>(&address->address),
+           address->address_length) != 0) {
+    ADD_FAILURE() << ErrnoMessage("bind");
+    return base::ScopedFD();
+  }
+  if (getsockname(sock.get(),
+                  reinterpret_cast<sockaddr*>(&address->address),
+                  &address->address_length) != 0) {
+    ADD_FAILURE() << ErrnoMessage("getsockname");
+    return base::ScopedFD();
+  }
+  address->family = AF_INET;
+  address->socktype = SOCK_STREAM;
+  address->protocol = IPPROTO_TCP;
+  return sock;
+}
+
+// Accepts one connection, reads a request without a body, and responds to it.
+class ServerThread final : public Thread {
+ public:
+  explicit ServerThread(int listen_sock) : listen_sock_(listen_sock) {}
+
+  ServerThread(const ServerThread&) = delete;
+  ServerThread& operator=(const ServerThread&) = delete;
+
+  ~ServerThread() override {}
+
+ private:
+  void ThreadMain() override {
+    base::ScopedFD sock(HANDLE_EINTR(accept(listen_sock_, nullptr, nullptr)));
+    ASSERT_TRUE(sock.is_valid()) << ErrnoMessage("accept");
+
+    std::string request;
+    while (request.find("\r\n\r\n") == std::string::npos) {
+      char buf[256];
+      FileOperationResult rv = ReadFile(sock.get(), buf, sizeof(buf));
+      ASSERT_GT(rv, 0);
+      request.append(buf, rv);
+    }
+
+    static constexpr char kResponse[] =
+        "HTTP/1.1 200 OK\r\n"
+        "Content-Length: 2\r\n"
+        "Connection: close\r\n"
+        "\r\n"
+        "OK";
+    ASSERT_TRUE(LoggingWriteFile(sock.get(), kResponse, strlen(kResponse)));
+  }
+
+  int listen_sock_;
+};
+
+TEST(HTTPTransportSocket, FallBackToSecondAddress) {
+  // Nothing listens on the first address, so connecting to it is refused.
+  ResolvedAddress refused_address;
+  base::ScopedFD refused_sock(BindLoopbackSocket(&refused_address));
+  ASSERT_TRUE(refused_sock.is_valid());
+
+  ResolvedAddress listening_address;
+  base::ScopedFD listening_sock(BindLoopbackSocket(&listening_address));
+  ASSERT_TRUE(listening_sock.is_valid());
+  ASSERT_EQ(listen(listening_sock.get(), 1), 0) << ErrnoMessage("listen");
+
+  // The name is never resolved by getaddrinfo(), because it’s cached.
+  static constexpr char kHostname[] = "fallback.invalid";
+  static constexpr char kPort[] = "80";
+  ResolverCache* const resolver_cache = ResolverCache::Get();
+  resolver_cache->SetForTesting(
+      kHostname, kPort, {refused_address, listening_address});
+
+  ServerThread server(listening_sock.get());
+  server.Start();
+
+  std::unique_ptr<HTTPTransport> transport(HTTPTransport::Create());
+  transport->SetURL(std::string("http://") + kHostname + "/");
+  transport->SetHeader("Content-Length", "0");
+  transport->SetBodyStream(std::make_unique<StringHTTPBodyStream>(""));
+  std::string response_body;
+  const bool success = transport->ExecuteSynchronously(&response_body);
+  server.Join();
+  ASSERT_TRUE(success);
+  EXPECT_EQ(response_body, "OK");
+
+  // The address that was connected to is tried first next time.
+  std::vector<ResolvedAddress> addresses;
+  ASSERT_TRUE(resolver_cache->Resolve(kHostname, kPort, &addresses));
+  ASSERT_EQ(addresses.size(), 2u);
+  EXPECT_TRUE(addresses[0] == listening_address);
+  EXPECT_TRUE(addresses[1] == refused_address);
+
+  resolver_cache->Forget(kHostname, kPort);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
@@ -67,7 +67,10 @@ class HTTPTransportTestFixture : public MultiprocessExec {
         response_code_(http_response_code),
         request_validator_(request_validator),
         cert_(),
-        scheme_and_host_() {
+        scheme_and_host_(),
+        keep_alive_timeout_(0),
+        asynchronous_(false),
+        http2_(false) {
     base::FilePath server_path = TestPaths::Executable().DirName().Append(
         FILE_PATH_LITERAL("http_transport_test_server")
 #if BUILDFLAG(IS_WIN)
@@ -95,6 +98,12 @@ class HTTPTransportTestFixture : public MultiprocessExec {
 
   const HTTPHeaders& headers() { return headers_; }
 
+  void SetKeepAliveTimeout(double timeout) { keep_alive_timeout_ = timeout; }
+
+  void SetAsynchronous(bool asynchronous) { asynchronous_ = asynchronous; }
+
+  void SetHTTP2(bool http2) { http2_ = http2; }
+
  private:
   void MultiprocessParent() override {
     // Use Logging*File() instead of Checked*File() so that the test can fail
@@ -132,16 +141,44 @@ class HTTPTransportTestFixture : public MultiprocessExec {
       transport->SetHeader(pair.first, pair.second);
     }
     transport->SetBodyStream(std::move(body_stream_));
+    transport->SetKeepAliveTimeout(keep_alive_timeout_);
+    transport->SetHTTP2(http2_);
 
     std::string response_body;
-    bool success = transport->ExecuteSynchronously(&response_body);
+    bool success;
+    if (asynchronous_) {
+      bool completed = false;
+      transport->ExecuteAsynchronously(
+          [&](bool async_success, const std::string& async_response_body) {
+            completed = true;
+            success = async_success;
+            response_body = async_response_body;
+          });
+      transport->WaitForCompletion();
+      EXPECT_TRUE(completed);
+    } else {
+      success = transport->ExecuteSynchronously(&response_body);
+    }
+    EXPECT_EQ(transport->GetResponseStatus(), response_code_);
     if (response_code_ >= 200 && response_code_ <= 203) {
       EXPECT_TRUE(success);
       std::string expect_response_body = random_string + "\r\n";
       EXPECT_EQ(response_body, expect_response_body);
+
+#if !BUILDFLAG(IS_APPLE) && !BUILDFLAG(IS_WIN)
+      // Header names are matched case-insensitively.
+      std::string accept_encoding;
+      EXPECT_TRUE(
+          transport->GetResponseHeader("ACCEPT-ENCODING", &accept_encoding));
+      EXPECT_EQ(accept_encoding, "gzip, zstd");
+#endif  // !BUILDFLAG(IS_APPLE) && !BUILDFLAG(IS_WIN)
     } else {
       EXPECT_FALSE(success);
       EXPECT_TRUE(response_body.empty());
+
+      std::string accept_encoding;
+      EXPECT_FALSE(
+          transport->GetResponseHeader("Accept-Encoding", &accept_encoding));
     }
 
     // Read until the child's stdout closes.
@@ -163,6 +200,9 @@ class HTTPTransportTestFixture : public MultiprocessExec {
   RequestValidator request_validator_;
   base::FilePath cert_;
   std::string scheme_and_host_;
+  double keep_alive_timeout_;
+  bool asynchronous_;
+  bool http2_;
 };
 
 constexpr char kMultipartFormData[] = "multipart/form-data";
@@ -273,6 +313,34 @@ TEST_P(HTTPTransport, ValidFormData_Gzip) {
   test.Run();
 }
 
+TEST_P(HTTPTransport, ValidFormData_KeepAlive) {
+  HTTPMultipartBuilder builder;
+  builder.SetFormData("key1", "test");
+  builder.SetFormData("key2", "--abcdefg123");
+
+  HTTPHeaders headers;
+  builder.PopulateContentHeaders(&headers);
+
+  HTTPTransportTestFixture test(
+      GetParam(), headers, builder.GetBodyStream(), 200, &ValidFormData);
+  test.SetKeepAliveTimeout(10);
+  test.Run();
+}
+
+TEST_P(HTTPTransport, ValidFormData_Asynchronous) {
+  HTTPMultipartBuilder builder;
+  builder.SetFormData("key1", "test");
+  builder.SetFormData("key2", "--abcdefg123");
+
+  HTTPHeaders headers;
+  builder.PopulateContentHeaders(&headers);
+
+  HTTPTransportTestFixture test(
+      GetParam(), headers, builder.GetBodyStream(), 200, &ValidFormData);
+  test.SetAsynchronous(true);
+  test.Run();
+}
+
 constexpr char kTextPlain[] = "text/plain";
 
 void ErrorResponse(HTTPTransportTestFixture* fixture,
@@ -323,6 +391,45 @@ TEST_P(HTTPTransport, UnchunkedPlainText) {
   test.Run();
 }
 
+TEST_P(HTTPTransport, ValidFormData_HTTP2) {
+  // The test server only speaks HTTP/1.1, which must still be used when HTTP/2
+  // is allowed.
+  HTTPMultipartBuilder builder;
+  builder.SetFormData("key1", "test");
+  builder.SetFormData("key2", "--abcdefg123");
+
+  HTTPHeaders headers;
+  builder.PopulateContentHeaders(&headers);
+
+  HTTPTransportTestFixture test(
+      GetParam(), headers, builder.GetBodyStream(), 200, &ValidFormData);
+  test.SetHTTP2(true);
+  test.Run();
+}
+
+TEST(HTTPTransportCancel, BeforeExecution) {
+  std::unique_ptr<crashpad::HTTPTransport> transport(
+      crashpad::HTTPTransport::Create());
+  ASSERT_TRUE(transport);
+  transport->SetURL("http://localhost:1/upload");
+  transport->SetBodyStream(std::make_unique<StringHTTPBodyStream>(kTextBody));
+  transport->Cancel();
+
+  std::string response_body;
+  EXPECT_FALSE(transport->ExecuteSynchronously(&response_body));
+  EXPECT_TRUE(response_body.empty());
+
+  // Cancellation lasts for the life of the transport.
+  bool completed = false;
+  transport->ExecuteAsynchronously(
+      [&completed](bool success, const std::string& response_body) {
+        completed = true;
+        EXPECT_FALSE(success);
+      });
+  transport->WaitForCompletion();
+  EXPECT_TRUE(completed);
+}
+
 void RunUpload33k(const std::string& scheme, bool has_content_length) {
   // On macOS, NSMutableURLRequest winds up calling into a CFReadStream’s Read()
   // callback with a 32kB buffer. Make sure that it’s able to get everything
@@ -21,6 +21,21 @@
 // form the response body in a successful response (one with code 200). The
 // server will process one HTTP request, deliver the prearranged response to the
 // client, and write the entire request to stdout. It will then terminate.
+//
+// With --multiple, the server instead processes requests, delivering the same
+// response to each, until its stdin is closed. It then writes all of the
+// requests to stdout, and terminates.
+//
+// A HEAD request, as made to ask whether the server already has a crash report,
+// is answered with the prearranged response code, or with the one given by
+// --head-response-code=CODE. A successful response carries the prearranged
+// response in a Crashpad-Report-Present header field.
+
+#include <string.h>
+
+#include <chrono>
+#include <mutex>
+#include <thread>
 
 #include "base/logging.h"
 #include "base/numerics/safe_conversions.h"
@@ -28,6 +43,7 @@
 #include "build/build_config.h"
 #include "tools/tool_support.h"
 #include "util/file/file_io.h"
+#include "util/stdlib/string_number_conversion.h"
 
 #if COMPILER_MSVC
 #pragma warning(push)
@@ -48,7 +64,31 @@
 namespace crashpad {
 namespace {
 
+int Usage() {
+  LOG(ERROR) << "usage: http_transport_test_server [--multiple] "
+                "[--head-response-code=CODE] [cert.pem key.pem]";
+  return 1;
+}
+
 int HttpTransportTestServerMain(int argc, char* argv[]) {
+  static constexpr char kHeadResponseCodeOption[] = "--head-response-code=";
+  static constexpr size_t kHeadResponseCodeOptionLength =
+      sizeof(kHeadResponseCodeOption) - 1;
+
+  bool multiple = false;
+  int head_response_code = 0;
+  for (; argc > 1 && strncmp(argv[1], "--", 2) == 0; --argc, ++argv) {
+    if (strcmp(argv[1], "--multiple") == 0) {
+      multiple = true;
+    } else if (strncmp(argv[1],
+                       kHeadResponseCodeOption,
+                       kHeadResponseCodeOptionLength) != 0 ||
+               !StringToNumber(argv[1] + kHeadResponseCodeOptionLength,
+                               &head_response_code)) {
+      return Usage();
+    }
+  }
+
   std::unique_ptr<httplib::Server> server;
   if (argc == 1) {
     server.reset(new httplib::Server);
@@ -57,8 +97,7 @@ int HttpTransportTestServerMain(int argc, char* argv[]) {
     server.reset(new httplib::SSLServer(argv[1], argv[2]));
 #endif
   } else {
-    LOG(ERROR) << "usage: http_transport_test_server [cert.pem key.pem]";
-    return 1;
+    return Usage();
   }
 
 
@@ -72,30 +111,56 @@ int HttpTransportTestServerMain(int argc, char* argv[]) {
   uint16_t response_code;
   char response[16];
 
+  // With --multiple, requests may be handled concurrently.
+  std::mutex to_stdout_lock;
   std::string to_stdout;
 
+  // Records a request, and stops the server if it only handles one.
+  auto record_request = [multiple, &server, &to_stdout, &to_stdout_lock](
+                            const char* method, const httplib::Request& req) {
+    std::lock_guard<std::mutex> guard(to_stdout_lock);
+    to_stdout += base::StringPrintf("%s /upload HTTP/1.0\r\n", method);
+    for (const auto& h : req.headers) {
+      to_stdout += base::StringPrintf(
+          "%s: %s\r\n", h.first.c_str(), h.second.c_str());
+    }
+    to_stdout += "\r\n";
+    to_stdout += req.body;
+
+    if (!multiple) {
+      server->stop();
+    }
+  };
+
   server->Post("/upload",
-               [&response, &response_code, &server, &to_stdout](
+               [&response, &response_code, &record_request](
                    const httplib::Request& req, httplib::Response& res) {
                  res.status = response_code;
                  if (response_code == 200) {
+                   res.set_header("Accept-Encoding", "gzip, zstd");
                    res.set_content(std::string(response, 16) + "\r\n",
                                    "text/plain");
                  } else {
                    res.set_content("error", "text/plain");
                  }
 
-                 to_stdout += "POST /upload HTTP/1.0\r\n";
-                 for (const auto& h : req.headers) {
-                   to_stdout += base::StringPrintf(
-                       "%s: %s\r\n", h.first.c_str(), h.second.c_str());
-                 }
-                 to_stdout += "\r\n";
-                 to_stdout += req.body;
-
-                 server->stop();
+                 record_request("POST", req);
                });
 
+  // cpp-httplib routes HEAD requests to GET handlers.
+  server->Get("/upload",
+              [&response, &response_code, head_response_code, &record_request](
+                  const httplib::Request& req, httplib::Response& res) {
+                res.status =
+                    head_response_code ? head_response_code : response_code;
+                if (res.status == 200) {
+                  res.set_header("Crashpad-Report-Present",
+                                 std::string(response, 16).c_str());
+                }
+
+                record_request("HEAD", req);
+              });
+
   uint16_t port =
       base::checked_cast<uint16_t>(server->bind_to_any_port("localhost"));
 
@@ -110,8 +175,28 @@ int HttpTransportTestServerMain(int argc, char* argv[]) {
                          &response,
                          sizeof(response));
 
+  std::thread stdin_thread;
+  if (multiple) {
+    stdin_thread = std::thread([&server]() {
+      char c;
+      while (ReadFile(StdioFileHandle(StdioStream::kStandardInput), &c, 1) >
+             0) {
+      }
+
+      // The server can’t be stopped before it has started listening.
+      while (!server->is_running()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      }
+      server->stop();
+    });
+  }
+
   server->listen_after_bind();
 
+  if (stdin_thread.joinable()) {
+    stdin_thread.join();
+  }
+
   LoggingWriteFile(StdioFileHandle(StdioStream::kStandardOutput),
                    to_stdout.data(),
                    to_stdout.size());
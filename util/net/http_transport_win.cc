@@ -24,6 +24,7 @@
 #include <winhttp.h>
 
 #include <iterator>
+#include <tuple>
 
 #include "base/logging.h"
 #include "base/numerics/safe_conversions.h"
@@ -31,6 +32,7 @@
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/stringprintf.h"
 #include "base/strings/utf_string_conversions.h"
+#include "base/synchronization/lock.h"
 #include "build/build_config.h"
 #include "package.h"
 #include "util/file/file_io.h"
@@ -142,17 +144,80 @@ class HTTPTransportWin final : public HTTPTransport {
   bool ExecuteSynchronously(std::string* response_body) override;
 
  private:
+  class ScopedCancelableRequest;
+
+  // HTTPTransport:
+  void OnCancel() override;
 
   static void AddNewTLSOnWindows7(const ScopedHINTERNET& session);
+
+  // The request handle of the request in progress, which OnCancel() closes to
+  // interrupt it, and whether it has done so.
+  base::Lock request_lock_;
+  HINTERNET request_;  // weak
+  bool request_closed_;
+};
+
+// Makes a request handle known to OnCancel() for its lifetime. A handle closed
+// by OnCancel() is released from its owner instead of being closed again.
+class HTTPTransportWin::ScopedCancelableRequest {
+ public:
+  ScopedCancelableRequest(HTTPTransportWin* transport,
+                          ScopedHINTERNET* request)
+      : transport_(transport), request_(request) {
+    base::AutoLock lock(transport_->request_lock_);
+    transport_->request_ = request_->get();
+    transport_->request_closed_ = false;
+  }
+
+  ScopedCancelableRequest(const ScopedCancelableRequest&) = delete;
+  ScopedCancelableRequest& operator=(const ScopedCancelableRequest&) = delete;
+
+  ~ScopedCancelableRequest() {
+    base::AutoLock lock(transport_->request_lock_);
+    if (transport_->request_closed_) {
+      std::ignore = request_->release();
+    }
+    transport_->request_ = nullptr;
+    transport_->request_closed_ = false;
+  }
+
+ private:
+  HTTPTransportWin* transport_;  // weak
+  ScopedHINTERNET* request_;  // weak
 };
 
-HTTPTransportWin::HTTPTransportWin() : HTTPTransport() {
+HTTPTransportWin::HTTPTransportWin()
+    : HTTPTransport(),
+      request_lock_(),
+      request_(nullptr),
+      request_closed_(false) {
 }
 
 HTTPTransportWin::~HTTPTransportWin() {
 }
 
+void HTTPTransportWin::OnCancel() {
+  // Closing the request handle makes the WinHTTP call in progress, if any,
+  // fail with ERROR_WINHTTP_OPERATION_CANCELLED, and each later call fail.
+  base::AutoLock lock(request_lock_);
+  if (request_ && !request_closed_) {
+    if (!WinHttpCloseHandle(request_)) {
+      LOG(ERROR) << WinHttpMessage("WinHttpCloseHandle");
+    }
+    request_closed_ = true;
+  }
+}
+
 bool HTTPTransportWin::ExecuteSynchronously(std::string* response_body) {
+  SetResponseHeaders(HTTPHeaders());
+  SetResponseStatus(0);
+
+  if (canceled()) {
+    LOG(ERROR) << "canceled";
+    return false;
+  }
+
   ScopedHINTERNET session(WinHttpOpen(base::UTF8ToWide(UserAgent()).c_str(),
                                       WINHTTP_ACCESS_TYPE_DEFAULT_PROXY,
                                       WINHTTP_NO_PROXY_NAME,
@@ -163,12 +228,21 @@ bool HTTPTransportWin::ExecuteSynchronously(std::string* response_body) {
     return false;
   }
 
-  int timeout_in_ms = static_cast<int>(timeout() * 1000);
+  // WinHTTP has no overall timeout. Each phase without a timeout of its own is
+  // limited by the request’s timeout, and the TLS handshake by the send and
+  // receive timeouts.
+  const int timeout_in_ms = static_cast<int>(timeout() * 1000);
+  const int connect_timeout_in_ms =
+      connect_timeout() > 0 ? static_cast<int>(connect_timeout() * 1000)
+                            : timeout_in_ms;
+  const int idle_timeout_in_ms = idle_timeout() > 0
+                                     ? static_cast<int>(idle_timeout() * 1000)
+                                     : timeout_in_ms;
   if (!WinHttpSetTimeouts(session.get(),
-                          timeout_in_ms,
-                          timeout_in_ms,
-                          timeout_in_ms,
-                          timeout_in_ms)) {
+                          connect_timeout_in_ms,
+                          connect_timeout_in_ms,
+                          idle_timeout_in_ms,
+                          idle_timeout_in_ms)) {
     LOG(ERROR) << WinHttpMessage("WinHttpSetTimeouts");
     return false;
   }
@@ -227,6 +301,12 @@ bool HTTPTransportWin::ExecuteSynchronously(std::string* response_body) {
     return false;
   }
 
+  ScopedCancelableRequest cancelable_request(this, &request);
+  if (canceled()) {
+    LOG(ERROR) << "canceled";
+    return false;
+  }
+
   // Add headers to the request.
   //
   // If Content-Length is not provided, implement chunked mode per RFC 7230
@@ -386,8 +466,50 @@ bool HTTPTransportWin::ExecuteSynchronously(std::string* response_body) {
     LOG(ERROR) << WinHttpMessage("WinHttpQueryHeaders");
     return false;
   }
+  SetResponseStatus(static_cast<int>(status_code));
+
+  // The raw header fields are the status line and one field per line, each
+  // ending in CRLF, then an empty line.
+  DWORD sizeof_raw_headers = 0;
+  WinHttpQueryHeaders(request.get(),
+                      WINHTTP_QUERY_RAW_HEADERS_CRLF,
+                      WINHTTP_HEADER_NAME_BY_INDEX,
+                      WINHTTP_NO_OUTPUT_BUFFER,
+                      &sizeof_raw_headers,
+                      WINHTTP_NO_HEADER_INDEX);
+  if (GetLastError() == ERROR_INSUFFICIENT_BUFFER) {
+    std::wstring raw_headers(sizeof_raw_headers / sizeof(wchar_t), L'\0');
+    if (WinHttpQueryHeaders(request.get(),
+                            WINHTTP_QUERY_RAW_HEADERS_CRLF,
+                            WINHTTP_HEADER_NAME_BY_INDEX,
+                            &raw_headers[0],
+                            &sizeof_raw_headers,
+                            WINHTTP_NO_HEADER_INDEX)) {
+      raw_headers.resize(sizeof_raw_headers / sizeof(wchar_t));
+      HTTPHeaders response_headers;
+      size_t line_start = raw_headers.find(L"\r\n");
+      while (line_start != std::wstring::npos) {
+        line_start += 2;
+        const size_t line_end = raw_headers.find(L"\r\n", line_start);
+        const std::wstring line = raw_headers.substr(
+            line_start,
+            line_end == std::wstring::npos ? std::wstring::npos
+                                           : line_end - line_start);
+        const size_t colon = line.find(L':');
+        if (colon != std::wstring::npos) {
+          const size_t value_start = line.find_first_not_of(L" \t", colon + 1);
+          response_headers[base::WideToUTF8(line.substr(0, colon))] =
+              value_start == std::wstring::npos
+                  ? std::string()
+                  : base::WideToUTF8(line.substr(value_start));
+        }
+        line_start = line_end;
+      }
+      SetResponseHeaders(response_headers);
+    }
+  }
 
-  if (status_code < 200 || status_code > 203) {
+  if ((status_code < 200 || status_code > 203) && status_code != 206) {
     LOG(ERROR) << base::StringPrintf("HTTP status %lu", status_code);
     return false;
   }
@@ -0,0 +1,179 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/net/resolver_cache.h"
+
+#include <netdb.h>
+#include <string.h>
+
+#include <algorithm>
+
+#include "base/logging.h"
+#include "base/scoped_generic.h"
+#include "util/misc/clock.h"
+
+namespace crashpad {
+
+namespace {
+
+struct ScopedAddrinfoTraits {
+  static addrinfo* InvalidValue() { return nullptr; }
+  static void Free(addrinfo* ai) { freeaddrinfo(ai); }
+};
+using ScopedAddrinfo = base::ScopedGeneric<addrinfo*, ScopedAddrinfoTraits>;
+
+}  // namespace
+
+bool operator==(const ResolvedAddress& a, const ResolvedAddress& b) {
+  return a.address_length == b.address_length && a.family == b.family &&
+         a.socktype == b.socktype && a.protocol == b.protocol &&
+         memcmp(&a.address, &b.address, a.address_length) == 0;
+}
+
+ResolverCache::ResolverCache(uint64_t ttl) : lock_(), entries_(), ttl_(ttl) {}
+
+ResolverCache::~ResolverCache() {}
+
+// static
+ResolverCache* ResolverCache::Get() {
+  static ResolverCache* const cache = new ResolverCache(kTTL);
+  return cache;
+}
+
+bool ResolverCache::Resolve(const std::string& hostname,
+                            const std::string& port,
+                            std::vector<ResolvedAddress>* addresses) {
+  const std::string key = hostname + ":" + port;
+  {
+    base::AutoLock lock(lock_);
+    const auto it = entries_.find(key);
+    if (it != entries_.end()) {
+      if (ClockMonotonicNanoseconds() < it->second.expiration_time) {
+        *addresses = it->second.addresses;
+        return true;
+      }
+      entries_.erase(it);
+    }
+  }
+
+  addrinfo hints = {};
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  hints.ai_protocol = 0;
+  hints.ai_flags = 0;
+
+  addrinfo* addrinfo_raw;
+  const int rv =
+      getaddrinfo(hostname.c_str(), port.c_str(), &hints, &addrinfo_raw);
+  if (rv != 0) {
+    LOG(ERROR) << "getaddrinfo: " << gai_strerror(rv);
+    return false;
+  }
+  ScopedAddrinfo addrinfo(addrinfo_raw);
+
+  // RFC 8305 §4 orders addresses by alternating between address families,
+  // starting with the family of the address that getaddrinfo() prefers, so
+  // that a network that’s broken for one family doesn’t hold up connecting
+  // with the other.
+  std::vector<ResolvedAddress> first_family;
+  std::vector<ResolvedAddress> other_families;
+  for (const auto* ap = addrinfo.get(); ap; ap = ap->ai_next) {
+    if (ap->ai_addrlen > sizeof(sockaddr_storage)) {
+      continue;
+    }
+    ResolvedAddress address = {};
+    memcpy(&address.address, ap->ai_addr, ap->ai_addrlen);
+    address.address_length = ap->ai_addrlen;
+    address.family = ap->ai_family;
+    address.socktype = ap->ai_socktype;
+    address.protocol = ap->ai_protocol;
+    if (first_family.empty() || first_family[0].family == ap->ai_family) {
+      first_family.push_back(address);
+    } else {
+      other_families.push_back(address);
+    }
+  }
+  if (first_family.empty()) {
+    LOG(ERROR) << "no addresses for " << hostname;
+    return false;
+  }
+
+  addresses->clear();
+  for (size_t index = 0;
+       index < first_family.size() || index < other_families.size();
+       ++index) {
+    if (index < first_family.size()) {
+      addresses->push_back(first_family[index]);
+    }
+    if (index < other_families.size()) {
+      addresses->push_back(other_families[index]);
+    }
+  }
+
+  base::AutoLock lock(lock_);
+  SetLocked(key, *addresses);
+  return true;
+}
+
+void ResolverCache::Prefer(const std::string& hostname,
+                           const std::string& port,
+                           const ResolvedAddress& address) {
+  base::AutoLock lock(lock_);
+  const auto it = entries_.find(hostname + ":" + port);
+  if (it == entries_.end()) {
+    return;
+  }
+
+  // The resolution may have been replaced by another request since address
+  // was taken from it, so address is found by its value.
+  std::vector<ResolvedAddress>& addresses = it->second.addresses;
+  const auto preferred =
+      std::find(addresses.begin(), addresses.end(), address);
+  if (preferred != addresses.end()) {
+    std::rotate(addresses.begin(), preferred, preferred + 1);
+  }
+}
+
+void ResolverCache::Forget(const std::string& hostname,
+                           const std::string& port) {
+  base::AutoLock lock(lock_);
+  entries_.erase(hostname + ":" + port);
+}
+
+void ResolverCache::SetForTesting(
+    const std::string& hostname,
+    const std::string& port,
+    const std::vector<ResolvedAddress>& addresses) {
+  base::AutoLock lock(lock_);
+  SetLocked(hostname + ":" + port, addresses);
+}
+
+void ResolverCache::SetLocked(const std::string& key,
+                              const std::vector<ResolvedAddress>& addresses) {
+  lock_.AssertAcquired();
+  if (entries_.size() >= kMaxEntries && entries_.find(key) == entries_.end()) {
+    auto oldest = entries_.begin();
+    for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+      if (it->second.expiration_time < oldest->second.expiration_time) {
+        oldest = it;
+      }
+    }
+    entries_.erase(oldest);
+  }
+  Entry& entry = entries_[key];
+  entry.addresses = addresses;
+  entry.expiration_time = ClockMonotonicNanoseconds() + ttl_;
+}
+
+}  // namespace crashpad
@@ -0,0 +1,116 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_UTIL_NET_RESOLVER_CACHE_H_
+#define CRASHPAD_UTIL_NET_RESOLVER_CACHE_H_
+
+#include <stdint.h>
+#include <sys/socket.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "base/synchronization/lock.h"
+
+namespace crashpad {
+
+//! \brief An address that a host name resolved to.
+struct ResolvedAddress {
+  sockaddr_storage address;
+  socklen_t address_length;
+  int family;
+  int socktype;
+  int protocol;
+};
+
+//! \brief Returns whether \a a and \a b are the same address, to be connected
+//!     to in the same way.
+bool operator==(const ResolvedAddress& a, const ResolvedAddress& b);
+
+//! \brief Host name resolutions, kept so that each connection to a server
+//!     needn’t wait for `getaddrinfo()`.
+//!
+//! `getaddrinfo()` doesn’t provide the DNS records’ TTLs, so resolutions are
+//! kept for a fixed time, and may be forgotten sooner, such as when no
+//! connection can be made to any of their addresses.
+class ResolverCache {
+ public:
+  //! \brief The number of nanoseconds for which Get() keeps a resolution.
+  static constexpr uint64_t kTTL = 60 * static_cast<uint64_t>(1E9);
+
+  //! \param[in] ttl The number of nanoseconds for which a resolution is kept.
+  explicit ResolverCache(uint64_t ttl);
+
+  ResolverCache(const ResolverCache&) = delete;
+  ResolverCache& operator=(const ResolverCache&) = delete;
+
+  ~ResolverCache();
+
+  //! \brief Returns the cache shared by all HTTP transports in the process.
+  static ResolverCache* Get();
+
+  //! \brief Resolves \a hostname and \a port, using a cached resolution if
+  //!     one is available.
+  //!
+  //! \param[out] addresses The addresses, ordered as described by RFC 8305
+  //!     §4.
+  //!
+  //! \return `true` on success. `false` on failure, with a message logged.
+  bool Resolve(const std::string& hostname,
+               const std::string& port,
+               std::vector<ResolvedAddress>* addresses);
+
+  //! \brief Moves \a address to the front of the cached resolution of \a
+  //!     hostname and \a port, so that the next connection attempts it first.
+  //!
+  //! This is used once a connection has been made to the address, so that an
+  //! unreachable address ahead of it doesn’t delay each later connection. If
+  //! the resolution was replaced since \a address was taken from it, and no
+  //! longer contains \a address, it’s left as it is.
+  void Prefer(const std::string& hostname,
+              const std::string& port,
+              const ResolvedAddress& address);
+
+  //! \brief Forgets the cached resolution of \a hostname and \a port, so
+  //!     that the next request resolves them again.
+  void Forget(const std::string& hostname, const std::string& port);
+
+  //! \brief Caches \a addresses as the resolution of \a hostname and \a port,
+  //!     as though they had just been resolved.
+  void SetForTesting(const std::string& hostname,
+                     const std::string& port,
+                     const std::vector<ResolvedAddress>& addresses);
+
+ private:
+  struct Entry {
+    std::vector<ResolvedAddress> addresses;
+    uint64_t expiration_time;
+  };
+
+  //! \brief The maximum number of resolutions kept, across all servers.
+  static constexpr size_t kMaxEntries = 8;
+
+  //! \brief Caches \a addresses for \a key. lock_ must be held.
+  void SetLocked(const std::string& key,
+                 const std::vector<ResolvedAddress>& addresses);
+
+  base::Lock lock_;
+  std::map<std::string, Entry> entries_;
+  uint64_t ttl_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_UTIL_NET_RESOLVER_CACHE_H_
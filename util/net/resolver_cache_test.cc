@@ -0,0 +1,138 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/net/resolver_cache.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+// A name that getaddrinfo() won’t be asked to resolve, because the tests that
+// use it have it cached.
+constexpr char kHostname[] = "resolver-cache.invalid";
+constexpr char kPort[] = "80";
+
+ResolvedAddress MakeAddress(const char* ip) {
+  ResolvedAddress address = {};
+  sockaddr_in* sin = reinterpret_cast<sockaddr_in*>(&address.address);
+  sin->sin_family = AF_INET;
+  sin->sin_port = htons(80);
+  EXPECT_EQ(inet_pton(AF_INET, ip, &sin->sin_addr), 1) << ip;
+  address.address_length = sizeof(*sin);
+  address.family = AF_INET;
+  address.socktype = SOCK_STREAM;
+  address.protocol = IPPROTO_TCP;
+  return address;
+}
+
+// Returns the IP addresses of addresses, in order.
+std::vector<std::string> IPs(const std::vector<ResolvedAddress>& addresses) {
+  std::vector<std::string> ips;
+  for (const ResolvedAddress& address : addresses) {
+    char ip[INET6_ADDRSTRLEN];
+    const void* addr =
+        address.family == AF_INET6
+            ? static_cast<const void*>(
+                  &reinterpret_cast<const sockaddr_in6*>(&address.address)
+                       ->sin6_addr)
+            : static_cast<const void*>(
+                  &reinterpret_cast<const sockaddr_in*>(&address.address)
+                       ->sin_addr);
+    EXPECT_NE(inet_ntop(address.family, addr, ip, sizeof(ip)), nullptr);
+    ips.push_back(ip);
+  }
+  return ips;
+}
+
+TEST(ResolverCache, CacheHit) {
+  ResolverCache cache(ResolverCache::kTTL);
+  cache.SetForTesting(
+      kHostname, kPort, {MakeAddress("192.0.2.1"), MakeAddress("192.0.2.2")});
+
+  std::vector<ResolvedAddress> addresses;
+  ASSERT_TRUE(cache.Resolve(kHostname, kPort, &addresses));
+  EXPECT_EQ(IPs(addresses),
+            (std::vector<std::string>{"192.0.2.1", "192.0.2.2"}));
+
+  // A resolution is cached too.
+  ASSERT_TRUE(cache.Resolve("127.0.0.1", kPort, &addresses));
+  EXPECT_EQ(IPs(addresses), std::vector<std::string>{"127.0.0.1"});
+  cache.Prefer("127.0.0.1", kPort, addresses[0]);
+  ASSERT_TRUE(cache.Resolve("127.0.0.1", kPort, &addresses));
+  EXPECT_EQ(IPs(addresses), std::vector<std::string>{"127.0.0.1"});
+}
+
+TEST(ResolverCache, Expiry) {
+  // Every resolution has expired by the time that it’s used, so the name is
+  // resolved again.
+  ResolverCache cache(0);
+  cache.SetForTesting("127.0.0.1", kPort, {MakeAddress("192.0.2.1")});
+
+  std::vector<ResolvedAddress> addresses;
+  ASSERT_TRUE(cache.Resolve("127.0.0.1", kPort, &addresses));
+  EXPECT_EQ(IPs(addresses), std::vector<std::string>{"127.0.0.1"});
+}
+
+TEST(ResolverCache, Forget) {
+  ResolverCache cache(ResolverCache::kTTL);
+  cache.SetForTesting("127.0.0.1", kPort, {MakeAddress("192.0.2.1")});
+  cache.Forget("127.0.0.1", kPort);
+
+  std::vector<ResolvedAddress> addresses;
+  ASSERT_TRUE(cache.Resolve("127.0.0.1", kPort, &addresses));
+  EXPECT_EQ(IPs(addresses), std::vector<std::string>{"127.0.0.1"});
+}
+
+TEST(ResolverCache, Prefer) {
+  ResolverCache cache(ResolverCache::kTTL);
+  const ResolvedAddress a = MakeAddress("192.0.2.1");
+  const ResolvedAddress b = MakeAddress("192.0.2.2");
+  const ResolvedAddress c = MakeAddress("192.0.2.3");
+  cache.SetForTesting(kHostname, kPort, {a, b, c});
+
+  std::vector<ResolvedAddress> addresses;
+  cache.Prefer(kHostname, kPort, b);
+  ASSERT_TRUE(cache.Resolve(kHostname, kPort, &addresses));
+  EXPECT_EQ(IPs(addresses),
+            (std::vector<std::string>{"192.0.2.2", "192.0.2.1", "192.0.2.3"}));
+
+  // An address that isn’t in the resolution changes nothing.
+  cache.Prefer(kHostname, kPort, MakeAddress("192.0.2.4"));
+  ASSERT_TRUE(cache.Resolve(kHostname, kPort, &addresses));
+  EXPECT_EQ(IPs(addresses),
+            (std::vector<std::string>{"192.0.2.2", "192.0.2.1", "192.0.2.3"}));
+
+  // Nor does one for a name that isn’t cached.
+  cache.Prefer("other.invalid", kPort, a);
+
+  // If the resolution was replaced after the address was connected to, the
+  // address is found wherever it is in the new resolution.
+  cache.SetForTesting(kHostname, kPort, {c, a, b});
+  cache.Prefer(kHostname, kPort, b);
+  ASSERT_TRUE(cache.Resolve(kHostname, kPort, &addresses));
+  EXPECT_EQ(IPs(addresses),
+            (std::vector<std::string>{"192.0.2.2", "192.0.2.3", "192.0.2.1"}));
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
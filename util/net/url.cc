@@ -89,4 +89,35 @@ bool CrackURL(const std::string& url,
   return true;
 }
 
+std::string ResolveURLReference(const std::string& base,
+                                const std::string& reference) {
+  // A reference that begins with a scheme is already absolute.
+  const size_t scheme_end = reference.find("://");
+  if (scheme_end != std::string::npos &&
+      reference.find_first_of("/?#") > scheme_end) {
+    return reference;
+  }
+
+  std::string scheme;
+  std::string host;
+  std::string port;
+  std::string rest;
+  if (!CrackURL(base, &scheme, &host, &port, &rest)) {
+    return std::string();
+  }
+
+  if (reference.compare(0, 2, "//") == 0) {
+    return scheme + ":" + reference;
+  }
+
+  const std::string origin = base.substr(0, base.size() - rest.size());
+  if (!reference.empty() && reference[0] == '/') {
+    return origin + reference;
+  }
+
+  // Replace the last segment of the base URL’s path.
+  const std::string path = rest.substr(0, rest.find_first_of("?#"));
+  return origin + path.substr(0, path.rfind('/') + 1) + reference;
+}
+
 }  // namespace crashpad
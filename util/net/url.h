@@ -45,6 +45,23 @@ bool CrackURL(const std::string& url,
               std::string* port,
               std::string* rest);
 
+//! \brief Resolves a URL reference, such as the value of a `Location` header
+//!     field, against the URL it was obtained from.
+//!
+//! This follows RFC 3986 §5.2 for the references that servers send in
+//! practice: absolute URLs, network-path references beginning with `//`,
+//! absolute-path references beginning with `/`, and relative-path references.
+//! Dot segments in relative-path references are not removed, and a reference
+//! consisting only of a query or fragment is treated as a relative path.
+//!
+//! \param[in] base The absolute URL that \a reference was obtained from, of the
+//!     form accepted by CrackURL().
+//! \param[in] reference The URL reference to resolve.
+//! \return The absolute URL that \a reference refers to, or an empty string if
+//!     \a base is not an absolute `http` or `https` URL, with an error logged.
+std::string ResolveURLReference(const std::string& base,
+                                const std::string& reference);
+
 }  // namespace crashpad
 
 #endif  // CRASHPAD_UTIL_NET_URL_H_
@@ -127,6 +127,40 @@ TEST(CrackURL, WithURLParams) {
   EXPECT_EQ(rest, "/things?blah=stuff:3");
 }
 
+TEST(ResolveURLReference, Absolute) {
+  EXPECT_EQ(ResolveURLReference("http://example.com/upload",
+                                "https://other.example.com/files/1"),
+            "https://other.example.com/files/1");
+}
+
+TEST(ResolveURLReference, NetworkPath) {
+  EXPECT_EQ(ResolveURLReference("https://example.com:8443/upload",
+                                "//files.example.com/1"),
+            "https://files.example.com/1");
+}
+
+TEST(ResolveURLReference, AbsolutePath) {
+  EXPECT_EQ(ResolveURLReference("https://example.com:8443/upload?a=b",
+                                "/files/1"),
+            "https://example.com:8443/files/1");
+  EXPECT_EQ(ResolveURLReference("http://example.com/upload",
+                                "/files/1?x=http://y"),
+            "http://example.com/files/1?x=http://y");
+}
+
+TEST(ResolveURLReference, RelativePath) {
+  EXPECT_EQ(ResolveURLReference("http://example.com/api/upload?a=b/c",
+                                "files/1"),
+            "http://example.com/api/files/1");
+  EXPECT_EQ(ResolveURLReference("http://example.com/upload", "1"),
+            "http://example.com/1");
+}
+
+TEST(ResolveURLReference, InvalidBase) {
+  EXPECT_EQ(ResolveURLReference("ftp://example.com/upload", "/files/1"), "");
+  EXPECT_EQ(ResolveURLReference("example.com", "files/1"), "");
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace crashpad
@@ -15,6 +15,8 @@
 #ifndef CRASHPAD_UTIL_POSIX_CLOSE_MULTIPLE_H_
 #define CRASHPAD_UTIL_POSIX_CLOSE_MULTIPLE_H_
 
+#include "build/build_config.h"
+
 namespace crashpad {
 
 //! \brief Close multiple file descriptors or mark them close-on-exec.
@@ -39,6 +41,24 @@ namespace crashpad {
 //!     fd. To not preserve any file descriptor, pass `-1` for this parameter.
 void CloseMultipleNowOrOnExec(int fd, int preserve_fd);
 
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+namespace internal {
+
+//! \brief Closes multiple file descriptors with `close_range()`, which
+//!     CloseMultipleNowOrOnExec() tries first. Exposed for testing.
+//!
+//! \param[in] fd The lowest file descriptor to close.
+//! \param[in] preserve_fd A file descriptor to preserve, as for
+//!     CloseMultipleNowOrOnExec().
+//!
+//! \return `true` on success. `false` if `close_range()` is not available or
+//!     failed, in which case some file descriptors may have been closed.
+bool CloseMultipleNowOrOnExecUsingCloseRange(int fd, int preserve_fd);
+
+}  // namespace internal
+#endif
+
+
 }  // namespace crashpad
 
 #endif  // CRASHPAD_UTIL_POSIX_CLOSE_MULTIPLE_H_
@@ -0,0 +1,129 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/posix/close_multiple.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <unistd.h>
+
+#include "base/files/scoped_file.h"
+#include "base/posix/eintr_wrapper.h"
+#include "base/strings/stringprintf.h"
+#include "build/build_config.h"
+#include "gtest/gtest.h"
+#include "test/errors.h"
+#include "test/multiprocess.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+// File descriptors from kFirstFD to kLastFD are opened and then closed. They
+// are well above the ones that Multiprocess uses to talk to the child.
+constexpr int kFirstFD = 100;
+constexpr int kLastFD = 103;
+
+// A file descriptor below kFirstFD, which is never closed.
+constexpr int kLowFD = 90;
+
+// Returns whether fd is open and will stay open across exec().
+bool IsOpen(int fd) {
+  int flags = fcntl(fd, F_GETFD);
+  if (flags == -1) {
+    EXPECT_EQ(errno, EBADF) << ErrnoMessage("fcntl");
+    return false;
+  }
+  return !(flags & FD_CLOEXEC);
+}
+
+// Opens fd as a duplicate of /dev/null.
+void OpenFD(int dev_null, int fd) {
+  ASSERT_EQ(dup2(dev_null, fd), fd) << ErrnoMessage("dup2");
+}
+
+// Closes file descriptors with close_function in a child process, because it
+// may close those that the test process relies on.
+class CloseMultipleTest final : public Multiprocess {
+ public:
+  using CloseFunction = bool (*)(int fd, int preserve_fd);
+
+  explicit CloseMultipleTest(CloseFunction close_function)
+      : Multiprocess(), close_function_(close_function) {}
+
+  CloseMultipleTest(const CloseMultipleTest&) = delete;
+  CloseMultipleTest& operator=(const CloseMultipleTest&) = delete;
+
+  ~CloseMultipleTest() {}
+
+ private:
+  void MultiprocessParent() override {}
+
+  void MultiprocessChild() override {
+    ASSERT_LT(ReadPipeHandle(), kLowFD);
+    ASSERT_LT(WritePipeHandle(), kLowFD);
+
+    base::ScopedFD dev_null(HANDLE_EINTR(open("/dev/null", O_RDONLY)));
+    ASSERT_TRUE(dev_null.is_valid()) << ErrnoMessage("open");
+    ASSERT_LT(dev_null.get(), kLowFD);
+
+    // Preserve nothing, the lowest file descriptor closed, one in the middle
+    // of those closed, and one below them.
+    for (int preserve_fd : {-1, kFirstFD, kFirstFD + 2, kLowFD}) {
+      SCOPED_TRACE(base::StringPrintf("preserve_fd %d", preserve_fd));
+
+      ASSERT_NO_FATAL_FAILURE(OpenFD(dev_null.get(), kLowFD));
+      for (int fd = kFirstFD; fd <= kLastFD; ++fd) {
+        ASSERT_NO_FATAL_FAILURE(OpenFD(dev_null.get(), fd));
+      }
+
+      ASSERT_TRUE(close_function_(kFirstFD, preserve_fd));
+
+      EXPECT_TRUE(IsOpen(dev_null.get()));
+      EXPECT_TRUE(IsOpen(kLowFD));
+      for (int fd = kFirstFD; fd <= kLastFD; ++fd) {
+        EXPECT_EQ(IsOpen(fd), fd == preserve_fd) << "fd " << fd;
+      }
+    }
+  }
+
+  CloseFunction close_function_;
+};
+
+TEST(CloseMultiple, CloseMultipleNowOrOnExec) {
+  CloseMultipleTest test([](int fd, int preserve_fd) {
+    CloseMultipleNowOrOnExec(fd, preserve_fd);
+    return true;
+  });
+  test.Run();
+}
+
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+TEST(CloseMultiple, CloseRange) {
+  // close_range() is only available since Linux 5.9. Where it isn’t,
+  // CloseMultipleNowOrOnExec() falls back to other methods, tested above.
+  using crashpad::internal::CloseMultipleNowOrOnExecUsingCloseRange;
+  if (!CloseMultipleNowOrOnExecUsingCloseRange(INT_MAX, -1)) {
+    GTEST_SKIP() << "close_range() unavailable";
+  }
+
+  CloseMultipleTest test(CloseMultipleNowOrOnExecUsingCloseRange);
+  test.Run();
+}
+#endif
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
@@ -19,6 +19,7 @@
 
 #include "base/files/file_path.h"
 #include "base/logging.h"
+#include "base/strings/string_piece.h"
 #include "util/file/delimited_file_reader.h"
 #include "util/file/file_reader.h"
 #include "util/file/string_file.h"
@@ -278,16 +279,16 @@ bool ProcessInfo::Arguments(std::vector<std::string>* argv) const {
   DelimitedFileReader cmdline_file_field_reader(&cmdline_file);
 
   std::vector<std::string> local_argv;
-  std::string argument;
+  base::StringPiece argument;
   DelimitedFileReader::Result result;
-  while ((result = cmdline_file_field_reader.GetDelim('\0', &argument)) ==
+  while ((result = cmdline_file_field_reader.GetDelimView('\0', &argument)) ==
          DelimitedFileReader::Result::kSuccess) {
     if (argument.back() != '\0') {
       LOG(ERROR) << "format error";
       return false;
     }
-    argument.pop_back();
-    local_argv.push_back(argument);
+    argument.remove_suffix(1);
+    local_argv.emplace_back(argument.data(), argument.size());
   }
   if (result != DelimitedFileReader::Result::kEndOfFile) {
     return false;
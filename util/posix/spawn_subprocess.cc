@@ -15,6 +15,7 @@
 #include "util/posix/spawn_subprocess.h"
 
 #include <errno.h>
+#include <signal.h>
 #include <spawn.h>
 #include <stdlib.h>
 #include <string.h>
@@ -33,13 +34,22 @@
 #include <android/api-level.h>
 #endif
 
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || \
+    (BUILDFLAG(IS_ANDROID) && __ANDROID_API__ >= 28)
+#include <sched.h>
+#include <sys/mman.h>
+
+#include "util/posix/scoped_mmap.h"
+#endif
+
 extern char** environ;
 
 namespace crashpad {
 
 namespace {
 
-#if BUILDFLAG(IS_APPLE)
+#if BUILDFLAG(IS_APPLE) || BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || \
+    (BUILDFLAG(IS_ANDROID) && __ANDROID_API__ >= 28)
 
 class PosixSpawnAttr {
  public:
@@ -61,12 +71,21 @@ class PosixSpawnAttr {
         << "posix_spawnattr_setflags";
   }
 
+  void SetSigMask(const sigset_t* sigmask) {
+    PCHECK((errno = posix_spawnattr_setsigmask(&attr_, sigmask)) == 0)
+        << "posix_spawnattr_setsigmask";
+  }
+
   const posix_spawnattr_t* Get() const { return &attr_; }
 
  private:
   posix_spawnattr_t attr_;
 };
 
+#endif
+
+#if BUILDFLAG(IS_APPLE)
+
 class PosixSpawnFileActions {
  public:
   PosixSpawnFileActions() {
@@ -96,6 +115,166 @@ class PosixSpawnFileActions {
 
 #endif
 
+// What the intermediate child needs to start the grandchild. argv and envp
+// are suitable for passing to posix_spawn*() and execv*().
+struct IntermediateChildArguments {
+  char* const* argv;
+  char* const* envp;
+  int preserve_fd;
+  bool use_path;
+
+  // If not nullptr, the signal mask to start the grandchild with. Otherwise,
+  // the grandchild inherits the intermediate child’s signal mask.
+  const sigset_t* sigmask;
+};
+
+// Runs in the intermediate child, starting the grandchild and exiting.
+void RunIntermediateChild(const IntermediateChildArguments& arguments) {
+  // Call setsid(), creating a new process group and a new session, both led
+  // by this process. The new process group has no controlling terminal. This
+  // disconnects it from signals generated by the parent process’ terminal.
+  //
+  // setsid() is done in the child instead of the grandchild so that the
+  // grandchild will not be a session leader. If it were a session leader, an
+  // accidental open() of a terminal device without O_NOCTTY would make that
+  // terminal the controlling terminal.
+  //
+  // It’s not desirable for the grandchild to have a controlling terminal. The
+  // grandchild manages its own lifetime, such as by monitoring clients on its
+  // own and exiting when it loses all clients and when it deems it
+  // appropraite to do so. It may serve clients in different process groups or
+  // sessions than its original client, and receiving signals intended for its
+  // original client’s process group could be harmful in that case.
+  PCHECK(setsid() != -1) << "setsid";
+
+  char* const* argv_for_spawn = arguments.argv;
+  char* const* envp_for_spawn = arguments.envp;
+
+#if BUILDFLAG(IS_ANDROID) && __ANDROID_API__ < 28
+  pid_t pid = fork();
+  if (pid < 0) {
+    PLOG(FATAL) << "fork";
+  }
+
+  if (pid > 0) {
+    // Child process.
+
+    // _exit() instead of exit(), because fork() was called.
+    _exit(EXIT_SUCCESS);
+  }
+
+  // Grandchild process.
+
+  CloseMultipleNowOrOnExec(STDERR_FILENO + 1, arguments.preserve_fd);
+
+#if BUILDFLAG(IS_ANDROID) && __ANDROID_API__ < 21
+  execve(argv_for_spawn[0], argv_for_spawn, envp_for_spawn);
+  PLOG(FATAL) << ("execve");
+#else
+  auto execve_fp = arguments.use_path ? execvpe : execve;
+  execve_fp(argv_for_spawn[0], argv_for_spawn, envp_for_spawn);
+  PLOG(FATAL) << (arguments.use_path ? "execvpe" : "execve");
+#endif
+
+#else
+  PosixSpawnAttr attr;
+#if BUILDFLAG(IS_APPLE)
+  attr.SetFlags(POSIX_SPAWN_CLOEXEC_DEFAULT);
+
+  PosixSpawnFileActions file_actions;
+  for (int fd = 0; fd <= STDERR_FILENO; ++fd) {
+    file_actions.AddInheritedFileDescriptor(fd);
+  }
+  file_actions.AddInheritedFileDescriptor(arguments.preserve_fd);
+
+  const posix_spawn_file_actions_t* file_actions_p = file_actions.Get();
+#else
+  CloseMultipleNowOrOnExec(STDERR_FILENO + 1, arguments.preserve_fd);
+
+  if (arguments.sigmask) {
+    attr.SetFlags(POSIX_SPAWN_SETSIGMASK);
+    attr.SetSigMask(arguments.sigmask);
+  }
+
+  const posix_spawn_file_actions_t* file_actions_p = nullptr;
+#endif
+  const posix_spawnattr_t* attr_p = attr.Get();
+
+  auto posix_spawn_fp = arguments.use_path ? posix_spawnp : posix_spawn;
+  if ((errno = posix_spawn_fp(nullptr,
+                              argv_for_spawn[0],
+                              file_actions_p,
+                              attr_p,
+                              argv_for_spawn,
+                              envp_for_spawn)) != 0) {
+    PLOG(FATAL) << (arguments.use_path ? "posix_spawnp" : "posix_spawn");
+  }
+
+  // _exit() instead of exit(), because the intermediate child was started by
+  // fork() or clone().
+  _exit(EXIT_SUCCESS);
+#endif
+}
+
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || \
+    (BUILDFLAG(IS_ANDROID) && __ANDROID_API__ >= 28)
+
+int IntermediateChildMain(void* arguments) {
+  RunIntermediateChild(*static_cast<IntermediateChildArguments*>(arguments));
+  return EXIT_FAILURE;
+}
+
+// Starts the intermediate child with clone(CLONE_VM | CLONE_VFORK), so that it
+// shares this process’ address space instead of copying its page tables as
+// fork() would. For a process with a large resident set, that copy dominates
+// the cost of spawning. As with vfork(), this thread is suspended until the
+// intermediate child exits, which it does as soon as posix_spawn() (itself
+// built on vfork() or an equivalent) has started the grandchild.
+//
+// The intermediate child must not disturb memory that this process relies on.
+// All signals are blocked while it runs, because any signal handler would run
+// on this process’ memory, and the grandchild is started with this thread’s
+// original signal mask instead.
+pid_t CloneIntermediateChild(IntermediateChildArguments* arguments) {
+  // This is generous for setsid(), CloseMultipleNowOrOnExec(), and
+  // posix_spawn(), but allows for logging a failure.
+  static constexpr size_t kStackSize = 256 * 1024;
+  ScopedMmap stack;
+  if (!stack.ResetMmap(nullptr,
+                       kStackSize,
+                       PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_STACK,
+                       -1,
+                       0)) {
+    return -1;
+  }
+
+  sigset_t all_signals;
+  sigfillset(&all_signals);
+  sigset_t old_sigmask;
+  if ((errno = pthread_sigmask(SIG_SETMASK, &all_signals, &old_sigmask)) !=
+      0) {
+    PLOG(ERROR) << "pthread_sigmask";
+    return -1;
+  }
+  arguments->sigmask = &old_sigmask;
+
+  // The stack grows down on every architecture supported here.
+  pid_t pid = clone(IntermediateChildMain,
+                    stack.addr_as<char*>() + stack.len(),
+                    CLONE_VM | CLONE_VFORK | SIGCHLD,
+                    arguments);
+  const int clone_errno = errno;
+  PCHECK((errno = pthread_sigmask(SIG_SETMASK, &old_sigmask, nullptr)) == 0)
+      << "pthread_sigmask";
+
+  errno = clone_errno;
+  PLOG_IF(ERROR, pid < 0) << "clone";
+  return pid;
+}
+
+#endif
+
 }  // namespace
 
 bool SpawnSubprocess(const std::vector<std::string>& argv,
@@ -123,6 +302,21 @@ bool SpawnSubprocess(const std::vector<std::string>& argv,
     envp_c.push_back(nullptr);
   }
 
+  IntermediateChildArguments arguments;
+
+  // &argv_c[0] is a pointer to a pointer to const char data, but because of
+  // how C (not C++) works, posix_spawn*() and execv*() want a pointer to
+  // a const pointer to char data. They modify neither the data nor the
+  // pointers, so the const_cast is safe.
+  arguments.argv = const_cast<char* const*>(argv_c.data());
+
+  // This cast is safe for the same reason that the argv cast is.
+  arguments.envp = envp ? const_cast<char* const*>(envp_c.data()) : environ;
+
+  arguments.preserve_fd = preserve_fd;
+  arguments.use_path = use_path;
+  arguments.sigmask = nullptr;
+
   // The three processes involved are parent, child, and grandchild. The child
   // exits immediately after spawning the grandchild, so the grandchild becomes
   // an orphan and its parent process ID becomes 1. This relieves the parent and
@@ -131,105 +325,34 @@ bool SpawnSubprocess(const std::vector<std::string>& argv,
   // parent shouldn’t be concerned with reaping it. This approach means that
   // accidental early termination of the handler process will not result in a
   // zombie process.
-  pid_t pid = fork();
-  if (pid < 0) {
-    PLOG(ERROR) << "fork";
-    return false;
-  }
-
-  if (pid == 0) {
-    // Child process.
-
-    if (child_function) {
-      child_function();
+  pid_t pid;
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || \
+    (BUILDFLAG(IS_ANDROID) && __ANDROID_API__ >= 28)
+  // child_function was only promised a forked process, which may do more than
+  // a child sharing this process’ address space can.
+  if (!child_function) {
+    pid = CloneIntermediateChild(&arguments);
+    if (pid < 0) {
+      return false;
     }
-
-    // Call setsid(), creating a new process group and a new session, both led
-    // by this process. The new process group has no controlling terminal. This
-    // disconnects it from signals generated by the parent process’ terminal.
-    //
-    // setsid() is done in the child instead of the grandchild so that the
-    // grandchild will not be a session leader. If it were a session leader, an
-    // accidental open() of a terminal device without O_NOCTTY would make that
-    // terminal the controlling terminal.
-    //
-    // It’s not desirable for the grandchild to have a controlling terminal. The
-    // grandchild manages its own lifetime, such as by monitoring clients on its
-    // own and exiting when it loses all clients and when it deems it
-    // appropraite to do so. It may serve clients in different process groups or
-    // sessions than its original client, and receiving signals intended for its
-    // original client’s process group could be harmful in that case.
-    PCHECK(setsid() != -1) << "setsid";
-
-    // &argv_c[0] is a pointer to a pointer to const char data, but because of
-    // how C (not C++) works, posix_spawn*() and execv*() want a pointer to
-    // a const pointer to char data. They modify neither the data nor the
-    // pointers, so the const_cast is safe.
-    char* const* argv_for_spawn = const_cast<char* const*>(argv_c.data());
-
-    // This cast is safe for the same reason that the argv_for_spawn cast is.
-    char* const* envp_for_spawn =
-        envp ? const_cast<char* const*>(envp_c.data()) : environ;
-
-#if BUILDFLAG(IS_ANDROID) && __ANDROID_API__ < 28
+  } else
+#endif
+  {
     pid = fork();
     if (pid < 0) {
-      PLOG(FATAL) << "fork";
+      PLOG(ERROR) << "fork";
+      return false;
     }
 
-    if (pid > 0) {
+    if (pid == 0) {
       // Child process.
 
-      // _exit() instead of exit(), because fork() was called.
-      _exit(EXIT_SUCCESS);
-    }
-
-    // Grandchild process.
-
-    CloseMultipleNowOrOnExec(STDERR_FILENO + 1, preserve_fd);
+      if (child_function) {
+        child_function();
+      }
 
-#if BUILDFLAG(IS_ANDROID) && __ANDROID_API__ < 21
-    execve(argv_for_spawn[0], argv_for_spawn, envp_for_spawn);
-    PLOG(FATAL) << ("execve");
-#else
-    auto execve_fp = use_path ? execvpe : execve;
-    execve_fp(argv_for_spawn[0], argv_for_spawn, envp_for_spawn);
-    PLOG(FATAL) << (use_path ? "execvpe" : "execve");
-#endif
-
-#else
-#if BUILDFLAG(IS_APPLE)
-    PosixSpawnAttr attr;
-    attr.SetFlags(POSIX_SPAWN_CLOEXEC_DEFAULT);
-
-    PosixSpawnFileActions file_actions;
-    for (int fd = 0; fd <= STDERR_FILENO; ++fd) {
-      file_actions.AddInheritedFileDescriptor(fd);
+      RunIntermediateChild(arguments);
     }
-    file_actions.AddInheritedFileDescriptor(preserve_fd);
-
-    const posix_spawnattr_t* attr_p = attr.Get();
-    const posix_spawn_file_actions_t* file_actions_p = file_actions.Get();
-#else
-    CloseMultipleNowOrOnExec(STDERR_FILENO + 1, preserve_fd);
-
-    const posix_spawnattr_t* attr_p = nullptr;
-    const posix_spawn_file_actions_t* file_actions_p = nullptr;
-#endif
-
-    auto posix_spawn_fp = use_path ? posix_spawnp : posix_spawn;
-    if ((errno = posix_spawn_fp(nullptr,
-                                argv_for_spawn[0],
-                                file_actions_p,
-                                attr_p,
-                                argv_for_spawn,
-                                envp_for_spawn)) != 0) {
-      PLOG(FATAL) << (use_path ? "posix_spawnp" : "posix_spawn");
-    }
-
-    // _exit() instead of exit(), because fork() was called.
-    _exit(EXIT_SUCCESS);
-#endif
   }
 
   // waitpid() for the child, so that it does not become a zombie process. The
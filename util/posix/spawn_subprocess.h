@@ -35,6 +35,11 @@ namespace crashpad {
 //! descriptor passed in \a preserve_fd, the grandchild will not inherit any
 //! file descriptors from the parent process.
 //!
+//! On Linux, unless \a child_function is given, the intermediate child is
+//! started with `clone()` sharing the parent’s address space, as with
+//! `vfork()`, so the cost of starting it does not grow with the size of the
+//! parent process.
+//!
 //! \param[in] argv The argument vector to start the grandchild process with.
 //!     `argv[0]` is used as the path to the executable.
 //! \param[in] envp A vector of environment variables of the form `var=value` to
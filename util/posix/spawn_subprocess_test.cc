@@ -0,0 +1,150 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/posix/spawn_subprocess.h"
+
+#include <fcntl.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+#include "base/check.h"
+#include "base/files/scoped_file.h"
+#include "base/posix/eintr_wrapper.h"
+#include "base/strings/stringprintf.h"
+#include "gtest/gtest.h"
+#include "test/errors.h"
+#include "test/main_arguments.h"
+#include "test/multiprocess_exec.h"
+#include "test/test_paths.h"
+#include "util/file/file_io.h"
+#include "util/stdlib/string_number_conversion.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+// What the grandchild reports about itself to the test.
+struct GrandchildReport {
+  pid_t pid;
+  pid_t sid;
+  bool closed_fd_open;
+  bool sigusr1_blocked;
+  bool sigusr2_blocked;
+};
+
+// The grandchild is started with the file descriptor to write its report to,
+// which SpawnSubprocess() was asked to preserve, and one that it was not.
+CRASHPAD_CHILD_TEST_MAIN(SpawnSubprocessGrandchild) {
+  const std::vector<std::string>& arguments = GetMainArguments();
+  int report_fd;
+  int closed_fd;
+  CHECK_EQ(arguments.size(), 4u);
+  CHECK(StringToNumber(arguments[2], &report_fd));
+  CHECK(StringToNumber(arguments[3], &closed_fd));
+
+  GrandchildReport report = {};
+  report.pid = getpid();
+  report.sid = getsid(0);
+  report.closed_fd_open = fcntl(closed_fd, F_GETFD) != -1;
+
+  sigset_t sigmask;
+  PCHECK(pthread_sigmask(SIG_SETMASK, nullptr, &sigmask) == 0)
+      << "pthread_sigmask";
+  report.sigusr1_blocked = sigismember(&sigmask, SIGUSR1) == 1;
+  report.sigusr2_blocked = sigismember(&sigmask, SIGUSR2) == 1;
+
+  CheckedWriteFile(report_fd, &report, sizeof(report));
+  return EXIT_SUCCESS;
+}
+
+void ChildFunction() {}
+
+// Spawns SpawnSubprocessGrandchild with SIGUSR2 blocked and SIGUSR1 not, and
+// checks what it reports.
+void SpawnAndCheckGrandchild(void (*child_function)()) {
+  int pipe_fds[2];
+  ASSERT_EQ(pipe(pipe_fds), 0) << ErrnoMessage("pipe");
+  base::ScopedFD read_fd(pipe_fds[0]);
+  base::ScopedFD write_fd(pipe_fds[1]);
+
+  // This isn’t close-on-exec, so only SpawnSubprocess() can keep it from the
+  // grandchild.
+  base::ScopedFD closed_fd(HANDLE_EINTR(open("/dev/null", O_RDONLY)));
+  ASSERT_TRUE(closed_fd.is_valid()) << ErrnoMessage("open");
+
+  const std::vector<std::string> argv = {
+      TestPaths::Executable().value(),
+      std::string(internal::kChildTestFunction) + "SpawnSubprocessGrandchild",
+      base::StringPrintf("%d", write_fd.get()),
+      base::StringPrintf("%d", closed_fd.get()),
+  };
+
+  sigset_t original_sigmask;
+  ASSERT_EQ(pthread_sigmask(SIG_SETMASK, nullptr, &original_sigmask), 0);
+  sigset_t sigmask = original_sigmask;
+  sigdelset(&sigmask, SIGUSR1);
+  sigaddset(&sigmask, SIGUSR2);
+  ASSERT_EQ(pthread_sigmask(SIG_SETMASK, &sigmask, nullptr), 0);
+
+  const bool spawned =
+      SpawnSubprocess(argv, nullptr, write_fd.get(), false, child_function);
+
+  sigset_t sigmask_after;
+  ASSERT_EQ(pthread_sigmask(SIG_SETMASK, &original_sigmask, &sigmask_after),
+            0);
+  ASSERT_TRUE(spawned);
+
+  // This thread’s signal mask is restored after spawning.
+  for (int sig = 1; sig < 32; ++sig) {
+    EXPECT_EQ(sigismember(&sigmask_after, sig), sigismember(&sigmask, sig))
+        << "signal " << sig;
+  }
+
+  // Reading fails at EOF if the grandchild exits without writing its report.
+  write_fd.reset();
+  GrandchildReport report;
+  ASSERT_TRUE(
+      LoggingReadFileExactly(read_fd.get(), &report, sizeof(report)));
+
+  EXPECT_NE(report.pid, getpid());
+
+  // The grandchild is in a new session, which it doesn’t lead.
+  EXPECT_NE(report.sid, getsid(0));
+  EXPECT_NE(report.sid, report.pid);
+
+  EXPECT_FALSE(report.closed_fd_open);
+
+  // The grandchild is started with this thread’s signal mask.
+  EXPECT_FALSE(report.sigusr1_blocked);
+  EXPECT_TRUE(report.sigusr2_blocked);
+}
+
+TEST(SpawnSubprocess, Spawn) {
+  SpawnAndCheckGrandchild(nullptr);
+}
+
+TEST(SpawnSubprocess, ChildFunction) {
+  // On Linux, a child_function means that the intermediate child is forked
+  // instead of sharing this process’ address space.
+  SpawnAndCheckGrandchild(ChildFunction);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
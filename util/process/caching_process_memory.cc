@@ -0,0 +1,162 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/process/caching_process_memory.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+#include "base/check_op.h"
+#include "base/logging.h"
+
+namespace crashpad {
+
+CachingProcessMemory::CachingProcessMemory()
+    : ProcessMemory(),
+      pages_(),
+      index_(),
+      memory_(nullptr),
+      max_pages_(0),
+      initialized_() {}
+
+CachingProcessMemory::~CachingProcessMemory() {}
+
+void CachingProcessMemory::Initialize(const ProcessMemory* memory,
+                                      size_t max_pages) {
+  INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
+  DCHECK_GT(max_pages, 0u);
+  memory_ = memory;
+  max_pages_ = max_pages;
+  INITIALIZATION_STATE_SET_VALID(initialized_);
+}
+
+void CachingProcessMemory::Clear() {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  base::AutoLock lock(lock_);
+  index_.clear();
+  pages_.clear();
+}
+
+const CachingProcessMemory::Page* CachingProcessMemory::FindPage(
+    VMAddress page_address) const {
+  auto iterator = index_.find(page_address);
+  if (iterator == index_.end()) {
+    return nullptr;
+  }
+  pages_.splice(pages_.begin(), pages_, iterator->second);
+  return &*iterator->second;
+}
+
+const CachingProcessMemory::Page* CachingProcessMemory::InsertPage(
+    std::list<Page>* new_page) const {
+  DCHECK_EQ(new_page->size(), 1u);
+
+  if (pages_.size() >= max_pages_) {
+    index_.erase(pages_.back().address);
+    pages_.pop_back();
+  }
+
+  pages_.splice(pages_.begin(), *new_page);
+  index_[pages_.front().address] = pages_.begin();
+  return &pages_.front();
+}
+
+void CachingProcessMemory::ReadPage(Page* page) const {
+  page->valid_size = 0;
+  while (page->valid_size < kPageSize) {
+    ssize_t bytes_read =
+        memory_->ReadUpTo(page->address + page->valid_size,
+                          kPageSize - page->valid_size,
+                          page->data + page->valid_size);
+    if (bytes_read <= 0) {
+      break;
+    }
+    DCHECK_LE(static_cast<size_t>(bytes_read), kPageSize - page->valid_size);
+    page->valid_size += bytes_read;
+  }
+}
+
+ssize_t CachingProcessMemory::ReadUpTo(VMAddress address,
+                                       size_t size,
+                                       void* buffer) const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+
+  if (size > kMaxCachedReadSize) {
+    return memory_->ReadUpTo(address, size, buffer);
+  }
+
+  const VMAddress page_address = address & ~VMAddress{kPageSize - 1};
+  const size_t page_offset = address - page_address;
+
+  // Returns the number of bytes copied from page, which is 0 if page doesn’t
+  // contain the byte at address.
+  auto copy_from_page = [page_offset, size, buffer](const Page& page) {
+    if (page.valid_size <= page_offset) {
+      return size_t{0};
+    }
+    const size_t copy_size = std::min(size, page.valid_size - page_offset);
+    memcpy(buffer, page.data + page_offset, copy_size);
+    return copy_size;
+  };
+
+  size_t bytes_copied = 0;
+  bool cached;
+  {
+    base::AutoLock lock(lock_);
+    const Page* page = FindPage(page_address);
+    cached = page != nullptr;
+    if (cached) {
+      bytes_copied = copy_from_page(*page);
+    }
+  }
+
+  if (!cached) {
+    std::list<Page> new_page(1);
+    new_page.front().address = page_address;
+    ReadPage(&new_page.front());
+
+    // Pages that couldn’t be read at all aren’t cached.
+    if (new_page.front().valid_size > 0) {
+      base::AutoLock lock(lock_);
+
+      // Another thread may have cached the same page while this one was
+      // reading it.
+      const Page* page = FindPage(page_address);
+      if (!page) {
+        page = InsertPage(&new_page);
+      }
+      bytes_copied = copy_from_page(*page);
+    }
+  }
+
+  if (bytes_copied == 0) {
+    // Let the underlying ProcessMemory report the failure, or read what it can
+    // if only the start of the page was unreadable.
+    return memory_->ReadUpTo(address, size, buffer);
+  }
+  return bytes_copied;
+}
+
+void CachingProcessMemory::ReadBatchInternal(BatchRead* reads,
+                                             size_t count) const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+
+  // Batched reads are typically of many distinct regions that are each read
+  // once, so pass them through to take advantage of any batching supported by
+  // the underlying ProcessMemory.
+  memory_->ReadBatchInternal(reads, count);
+}
+
+}  // namespace crashpad
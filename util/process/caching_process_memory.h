@@ -0,0 +1,120 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_UTIL_PROCESS_CACHING_PROCESS_MEMORY_H_
+#define CRASHPAD_UTIL_PROCESS_CACHING_PROCESS_MEMORY_H_
+
+#include <stdint.h>
+#include <sys/types.h>
+
+#include <list>
+#include <unordered_map>
+
+#include "base/synchronization/lock.h"
+#include "util/misc/address_types.h"
+#include "util/misc/initialization_state_dcheck.h"
+#include "util/process/process_memory.h"
+
+namespace crashpad {
+
+//! \brief Caches pages of memory read from another process.
+//!
+//! Small reads are satisfied from a bounded, least-recently-used cache of
+//! kPageSize-byte pages, each of which is read from the underlying
+//! ProcessMemory in its entirety the first time any part of it is needed. Reads
+//! larger than kMaxCachedReadSize bypass the cache.
+//!
+//! The cache is never invalidated, so this is only suitable for use while the
+//! target process is suspended, such as for the duration of a single snapshot
+//! capture.
+//!
+//! Memory may be read from multiple threads at once if the underlying
+//! ProcessMemory permits that. Pages are read from the underlying ProcessMemory
+//! without holding the cache's lock, so reads that miss the cache proceed in
+//! parallel.
+class CachingProcessMemory final : public ProcessMemory {
+ public:
+  //! \brief The size and alignment of cached pages.
+  static constexpr size_t kPageSize = 4096;
+
+  //! \brief The largest read that will be satisfied from the cache.
+  static constexpr size_t kMaxCachedReadSize = 4 * kPageSize;
+
+  //! \brief The number of pages cached if not specified otherwise.
+  static constexpr size_t kDefaultMaxPages = 256;
+
+  CachingProcessMemory();
+
+  CachingProcessMemory(const CachingProcessMemory&) = delete;
+  CachingProcessMemory& operator=(const CachingProcessMemory&) = delete;
+
+  ~CachingProcessMemory();
+
+  //! \brief Initializes this object to read memory from the underlying
+  //!     \a memory object.
+  //!
+  //! This method must be called successfully prior to calling any other method
+  //! in this class.
+  //!
+  //! \param[in] memory The memory object to read memory from.
+  //! \param[in] max_pages The maximum number of pages to cache.
+  void Initialize(const ProcessMemory* memory,
+                  size_t max_pages = kDefaultMaxPages);
+
+  //! \brief Discards all cached pages.
+  void Clear();
+
+ private:
+  struct Page {
+    VMAddress address;
+
+    // The number of bytes at the start of data that were readable. This may be
+    // less than kPageSize if the underlying ProcessMemory returned a short
+    // read.
+    size_t valid_size;
+
+    uint8_t data[kPageSize];
+  };
+
+  // Returns the cached page beginning at page_address, marking it as most
+  // recently used, or nullptr if it isn't cached. lock_ must be held.
+  const Page* FindPage(VMAddress page_address) const;
+
+  // Moves the page in new_page, which must hold exactly one page, into the
+  // cache, evicting the least recently used page if the cache is full. lock_
+  // must be held.
+  const Page* InsertPage(std::list<Page>* new_page) const;
+
+  // Reads as much of page->address as possible into page.
+  void ReadPage(Page* page) const;
+
+  ssize_t ReadUpTo(VMAddress address, size_t size, void* buffer) const override;
+  void ReadBatchInternal(BatchRead* reads, size_t count) const override;
+
+  // Guards pages_ and index_.
+  mutable base::Lock lock_;
+
+  // Pages ordered from most to least recently used, and an index into them by
+  // address.
+  mutable std::list<Page> pages_;
+  mutable std::unordered_map<VMAddress, std::list<Page>::iterator> index_;
+
+  const ProcessMemory* memory_;  // weak
+  size_t max_pages_;
+  InitializationStateDcheck initialized_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_UTIL_PROCESS_CACHING_PROCESS_MEMORY_H_
@@ -0,0 +1,239 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/process/caching_process_memory.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "util/thread/thread.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+// A ProcessMemory backed by a local buffer which appears at kBaseAddress and of
+// which only [readable_begin, readable_end) may be read.
+class FakeProcessMemory : public ProcessMemory {
+ public:
+  static constexpr VMAddress kBaseAddress = 0x10000;
+
+  explicit FakeProcessMemory(size_t size)
+      : data_(size),
+        readable_begin_(kBaseAddress),
+        readable_end_(kBaseAddress + size),
+        read_count_(0) {
+    for (size_t index = 0; index < data_.size(); ++index) {
+      data_[index] = static_cast<uint8_t>(index * 7);
+    }
+  }
+
+  FakeProcessMemory(const FakeProcessMemory&) = delete;
+  FakeProcessMemory& operator=(const FakeProcessMemory&) = delete;
+
+  void SetReadableRange(VMAddress begin, VMAddress end) {
+    readable_begin_ = begin;
+    readable_end_ = end;
+  }
+
+  uint8_t ExpectedByte(VMAddress address) const {
+    return data_[address - kBaseAddress];
+  }
+
+  size_t read_count() const { return read_count_; }
+
+ private:
+  ssize_t ReadUpTo(VMAddress address,
+                   size_t size,
+                   void* buffer) const override {
+    ++read_count_;
+    if (address < readable_begin_ || address >= readable_end_) {
+      return -1;
+    }
+    size = std::min(size, static_cast<size_t>(readable_end_ - address));
+    memcpy(buffer, &data_[address - kBaseAddress], size);
+    return size;
+  }
+
+  std::vector<uint8_t> data_;
+  VMAddress readable_begin_;
+  VMAddress readable_end_;
+  mutable std::atomic<size_t> read_count_;
+};
+
+constexpr size_t kPageSize = CachingProcessMemory::kPageSize;
+
+void ExpectBytes(const FakeProcessMemory& fake,
+                 VMAddress address,
+                 const std::vector<uint8_t>& bytes) {
+  for (size_t index = 0; index < bytes.size(); ++index) {
+    ASSERT_EQ(bytes[index], fake.ExpectedByte(address + index)) << index;
+  }
+}
+
+TEST(CachingProcessMemory, CachesPages) {
+  FakeProcessMemory fake(4 * kPageSize);
+  CachingProcessMemory memory;
+  memory.Initialize(&fake);
+
+  const VMAddress address = FakeProcessMemory::kBaseAddress + 16;
+  std::vector<uint8_t> bytes(64);
+  ASSERT_TRUE(memory.Read(address, bytes.size(), bytes.data()));
+  ExpectBytes(fake, address, bytes);
+  EXPECT_EQ(fake.read_count(), 1u);
+
+  ASSERT_TRUE(memory.Read(address + 128, bytes.size(), bytes.data()));
+  ExpectBytes(fake, address + 128, bytes);
+  EXPECT_EQ(fake.read_count(), 1u);
+
+  memory.Clear();
+  ASSERT_TRUE(memory.Read(address, bytes.size(), bytes.data()));
+  EXPECT_EQ(fake.read_count(), 2u);
+}
+
+TEST(CachingProcessMemory, ReadAcrossPages) {
+  FakeProcessMemory fake(4 * kPageSize);
+  CachingProcessMemory memory;
+  memory.Initialize(&fake);
+
+  const VMAddress address = FakeProcessMemory::kBaseAddress + kPageSize - 8;
+  std::vector<uint8_t> bytes(kPageSize + 16);
+  ASSERT_TRUE(memory.Read(address, bytes.size(), bytes.data()));
+  ExpectBytes(fake, address, bytes);
+  EXPECT_EQ(fake.read_count(), 3u);
+
+  bytes.resize(32);
+  ASSERT_TRUE(memory.Read(address, bytes.size(), bytes.data()));
+  ExpectBytes(fake, address, bytes);
+  EXPECT_EQ(fake.read_count(), 3u);
+}
+
+TEST(CachingProcessMemory, EvictsLeastRecentlyUsed) {
+  FakeProcessMemory fake(4 * kPageSize);
+  CachingProcessMemory memory;
+  memory.Initialize(&fake, 2);
+
+  const VMAddress page0 = FakeProcessMemory::kBaseAddress;
+  const VMAddress page1 = page0 + kPageSize;
+  const VMAddress page2 = page1 + kPageSize;
+  uint8_t byte;
+
+  ASSERT_TRUE(memory.Read(page0, sizeof(byte), &byte));
+  ASSERT_TRUE(memory.Read(page1, sizeof(byte), &byte));
+  ASSERT_TRUE(memory.Read(page0, sizeof(byte), &byte));
+  EXPECT_EQ(fake.read_count(), 2u);
+
+  // page1 is the least recently used and is evicted to make room for page2.
+  ASSERT_TRUE(memory.Read(page2, sizeof(byte), &byte));
+  EXPECT_EQ(fake.read_count(), 3u);
+  ASSERT_TRUE(memory.Read(page0, sizeof(byte), &byte));
+  EXPECT_EQ(fake.read_count(), 3u);
+  ASSERT_TRUE(memory.Read(page1, sizeof(byte), &byte));
+  EXPECT_EQ(byte, fake.ExpectedByte(page1));
+  EXPECT_EQ(fake.read_count(), 4u);
+}
+
+TEST(CachingProcessMemory, PartiallyReadablePage) {
+  FakeProcessMemory fake(2 * kPageSize);
+  const VMAddress readable_end = FakeProcessMemory::kBaseAddress + 100;
+  fake.SetReadableRange(FakeProcessMemory::kBaseAddress, readable_end);
+  CachingProcessMemory memory;
+  memory.Initialize(&fake);
+
+  std::vector<uint8_t> bytes(50);
+  ASSERT_TRUE(
+      memory.Read(FakeProcessMemory::kBaseAddress, bytes.size(), bytes.data()));
+  ExpectBytes(fake, FakeProcessMemory::kBaseAddress, bytes);
+
+  EXPECT_FALSE(memory.Read(readable_end - 10, 20, bytes.data()));
+  EXPECT_FALSE(memory.Read(readable_end, 1, bytes.data()));
+  EXPECT_FALSE(
+      memory.Read(FakeProcessMemory::kBaseAddress + kPageSize, 1, bytes.data()));
+}
+
+TEST(CachingProcessMemory, LargeReadsBypassCache) {
+  FakeProcessMemory fake(8 * kPageSize);
+  CachingProcessMemory memory;
+  memory.Initialize(&fake);
+
+  std::vector<uint8_t> bytes(CachingProcessMemory::kMaxCachedReadSize + 1);
+  ASSERT_TRUE(
+      memory.Read(FakeProcessMemory::kBaseAddress, bytes.size(), bytes.data()));
+  ExpectBytes(fake, FakeProcessMemory::kBaseAddress, bytes);
+  EXPECT_EQ(fake.read_count(), 1u);
+
+  uint8_t byte;
+  ASSERT_TRUE(memory.Read(FakeProcessMemory::kBaseAddress, 1, &byte));
+  EXPECT_EQ(fake.read_count(), 2u);
+}
+
+class CachingProcessMemoryReadThread : public Thread {
+ public:
+  CachingProcessMemoryReadThread() : memory_(nullptr), fake_(nullptr) {}
+
+  CachingProcessMemoryReadThread(const CachingProcessMemoryReadThread&) =
+      delete;
+  CachingProcessMemoryReadThread& operator=(
+      const CachingProcessMemoryReadThread&) = delete;
+
+  ~CachingProcessMemoryReadThread() {}
+
+  void SetTestParameters(const CachingProcessMemory* memory,
+                         const FakeProcessMemory* fake) {
+    memory_ = memory;
+    fake_ = fake;
+  }
+
+  // Thread:
+  void ThreadMain() override {
+    std::vector<uint8_t> bytes(kPageSize / 2);
+    for (size_t iteration = 0; iteration < 64; ++iteration) {
+      for (size_t page = 0; page < 8; ++page) {
+        const VMAddress address =
+            FakeProcessMemory::kBaseAddress + page * kPageSize + 100;
+        ASSERT_TRUE(memory_->Read(address, bytes.size(), bytes.data()));
+        ExpectBytes(*fake_, address, bytes);
+      }
+    }
+  }
+
+ private:
+  const CachingProcessMemory* memory_;
+  const FakeProcessMemory* fake_;
+};
+
+TEST(CachingProcessMemory, ConcurrentReads) {
+  FakeProcessMemory fake(8 * kPageSize);
+  CachingProcessMemory memory;
+  memory.Initialize(&fake, 4);
+
+  CachingProcessMemoryReadThread threads[8];
+  for (CachingProcessMemoryReadThread& thread : threads) {
+    thread.SetTestParameters(&memory, &fake);
+  }
+  for (CachingProcessMemoryReadThread& thread : threads) {
+    thread.Start();
+  }
+  for (CachingProcessMemoryReadThread& thread : threads) {
+    thread.Join();
+  }
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
@@ -0,0 +1,171 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/process/caching_process_memory_win.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+#include "base/check_op.h"
+#include "base/logging.h"
+#include "util/numeric/checked_range.h"
+
+namespace crashpad {
+
+CachingProcessMemoryWin::CachingProcessMemoryWin()
+    : ProcessMemory(),
+      chunks_(),
+      index_(),
+      memory_(nullptr),
+      memory_info_(nullptr),
+      max_chunks_(0),
+      initialized_() {}
+
+CachingProcessMemoryWin::~CachingProcessMemoryWin() {}
+
+void CachingProcessMemoryWin::Initialize(
+    const ProcessMemory* memory,
+    const ProcessInfo::MemoryBasicInformation64Vector* memory_info,
+    size_t max_chunks) {
+  INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
+  DCHECK_GT(max_chunks, 0u);
+  memory_ = memory;
+  memory_info_ = memory_info;
+  max_chunks_ = max_chunks;
+  INITIALIZATION_STATE_SET_VALID(initialized_);
+}
+
+void CachingProcessMemoryWin::Clear() {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  base::AutoLock lock(lock_);
+  index_.clear();
+  chunks_.clear();
+}
+
+const CachingProcessMemoryWin::Chunk* CachingProcessMemoryWin::FindChunk(
+    VMAddress chunk_address) const {
+  auto iterator = index_.find(chunk_address);
+  if (iterator == index_.end()) {
+    return nullptr;
+  }
+  chunks_.splice(chunks_.begin(), chunks_, iterator->second);
+  return &*iterator->second;
+}
+
+const CachingProcessMemoryWin::Chunk* CachingProcessMemoryWin::InsertChunk(
+    std::list<Chunk>* new_chunk) const {
+  DCHECK_EQ(new_chunk->size(), 1u);
+
+  if (chunks_.size() >= max_chunks_) {
+    index_.erase(chunks_.back().address);
+    chunks_.pop_back();
+  }
+
+  chunks_.splice(chunks_.begin(), *new_chunk);
+  index_[chunks_.front().address] = chunks_.begin();
+  return &chunks_.front();
+}
+
+void CachingProcessMemoryWin::ReadChunk(Chunk* chunk) const {
+  chunk->spans.clear();
+  if (memory_info_->empty()) {
+    return;
+  }
+
+  const std::vector<CheckedRange<WinVMAddress, WinVMSize>> ranges =
+      GetReadableRangesOfMemoryMap(
+          CheckedRange<WinVMAddress, WinVMSize>(chunk->address, kChunkSize),
+          *memory_info_);
+  if (ranges.empty()) {
+    return;
+  }
+
+  chunk->data.resize(kChunkSize);
+  for (const auto& range : ranges) {
+    Span span;
+    span.offset = static_cast<size_t>(range.base() - chunk->address);
+    span.size = 0;
+    const size_t range_size = static_cast<size_t>(range.size());
+    while (span.size < range_size) {
+      ssize_t bytes_read =
+          memory_->ReadUpTo(range.base() + span.size,
+                            range_size - span.size,
+                            chunk->data.data() + span.offset + span.size);
+      if (bytes_read <= 0) {
+        break;
+      }
+      DCHECK_LE(static_cast<size_t>(bytes_read), range_size - span.size);
+      span.size += bytes_read;
+    }
+    if (span.size > 0) {
+      chunk->spans.push_back(span);
+    }
+  }
+}
+
+ssize_t CachingProcessMemoryWin::ReadUpTo(VMAddress address,
+                                          size_t size,
+                                          void* buffer) const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+
+  if (size > kMaxCachedReadSize) {
+    return memory_->ReadUpTo(address, size, buffer);
+  }
+
+  const VMAddress chunk_address = address & ~VMAddress{kChunkSize - 1};
+  const size_t chunk_offset = address - chunk_address;
+
+  size_t bytes_copied = 0;
+  {
+    base::AutoLock lock(lock_);
+    const Chunk* chunk = FindChunk(chunk_address);
+    if (!chunk) {
+      std::list<Chunk> new_chunk(1);
+      new_chunk.front().address = chunk_address;
+      ReadChunk(&new_chunk.front());
+      chunk = InsertChunk(&new_chunk);
+    }
+
+    for (const Span& span : chunk->spans) {
+      if (chunk_offset < span.offset) {
+        break;
+      }
+      if (chunk_offset < span.offset + span.size) {
+        bytes_copied = std::min(size, span.offset + span.size - chunk_offset);
+        memcpy(buffer, chunk->data.data() + chunk_offset, bytes_copied);
+        break;
+      }
+    }
+  }
+
+  if (bytes_copied == 0) {
+    // Let the underlying ProcessMemory report the failure, or read what it can
+    // if the memory map is out of date.
+    return memory_->ReadUpTo(address, size, buffer);
+  }
+  return bytes_copied;
+}
+
+void CachingProcessMemoryWin::ReadBatchInternal(BatchRead* reads,
+                                                size_t count) const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+
+  // Batched reads are typically of many distinct regions that are each read
+  // once, so pass them through to take advantage of any batching supported by
+  // the underlying ProcessMemory.
+  memory_->ReadBatchInternal(reads, count);
+}
+
+}  // namespace crashpad
@@ -0,0 +1,135 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_UTIL_PROCESS_CACHING_PROCESS_MEMORY_WIN_H_
+#define CRASHPAD_UTIL_PROCESS_CACHING_PROCESS_MEMORY_WIN_H_
+
+#include <stdint.h>
+#include <sys/types.h>
+
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+#include "base/synchronization/lock.h"
+#include "util/misc/address_types.h"
+#include "util/misc/initialization_state_dcheck.h"
+#include "util/process/process_memory.h"
+#include "util/win/process_info.h"
+
+namespace crashpad {
+
+//! \brief Reads ahead and caches memory read from another Windows process in
+//!     large chunks.
+//!
+//! Small reads are satisfied from a bounded, least-recently-used cache of
+//! kChunkSize-byte chunks. The first time any part of a chunk is needed, each
+//! part of it that the target process’ memory map shows to be readable is
+//! read from the underlying ProcessMemory, one read per readable region. This
+//! way, walking the many small structures of a module costs a read for each
+//! chunk of the module rather than one for each structure. Reads larger than
+//! kMaxCachedReadSize bypass the cache.
+//!
+//! The cache is never invalidated, and the memory map is the one captured when
+//! the ProcessInfo was initialized, so this is only suitable for use while the
+//! target process is suspended, such as for the duration of a single snapshot
+//! capture.
+//!
+//! This class is thread-safe.
+class CachingProcessMemoryWin final : public ProcessMemory {
+ public:
+  //! \brief The size and alignment of cached chunks.
+  static constexpr size_t kChunkSize = 64 * 1024;
+
+  //! \brief The largest read that will be satisfied from the cache.
+  static constexpr size_t kMaxCachedReadSize = 16 * 1024;
+
+  //! \brief The number of chunks cached if not specified otherwise.
+  static constexpr size_t kDefaultMaxChunks = 64;
+
+  CachingProcessMemoryWin();
+
+  CachingProcessMemoryWin(const CachingProcessMemoryWin&) = delete;
+  CachingProcessMemoryWin& operator=(const CachingProcessMemoryWin&) = delete;
+
+  ~CachingProcessMemoryWin();
+
+  //! \brief Initializes this object to read memory from the underlying
+  //!     \a memory object.
+  //!
+  //! This method must be called successfully prior to calling any other method
+  //! in this class.
+  //!
+  //! \param[in] memory The memory object to read memory from.
+  //! \param[in] memory_info The memory map of the process that \a memory reads
+  //!     from, as returned by ProcessInfo::MemoryInfo(). Only the parts of a
+  //!     chunk that this shows to be readable are read ahead.
+  //! \param[in] max_chunks The maximum number of chunks to cache.
+  void Initialize(
+      const ProcessMemory* memory,
+      const ProcessInfo::MemoryBasicInformation64Vector* memory_info,
+      size_t max_chunks = kDefaultMaxChunks);
+
+  //! \brief Discards all cached chunks.
+  void Clear();
+
+ private:
+  // A readable part of a chunk, at offset bytes from its start.
+  struct Span {
+    size_t offset;
+    size_t size;
+  };
+
+  struct Chunk {
+    VMAddress address;
+
+    // The parts of data that were read, in increasing order of offset.
+    std::vector<Span> spans;
+
+    std::vector<uint8_t> data;
+  };
+
+  // Returns the cached chunk beginning at chunk_address, marking it as most
+  // recently used, or nullptr if it isn't cached. lock_ must be held.
+  const Chunk* FindChunk(VMAddress chunk_address) const;
+
+  // Moves the chunk in new_chunk, which must hold exactly one chunk, into the
+  // cache, evicting the least recently used chunk if the cache is full. lock_
+  // must be held.
+  const Chunk* InsertChunk(std::list<Chunk>* new_chunk) const;
+
+  // Reads the readable parts of chunk->address into chunk.
+  void ReadChunk(Chunk* chunk) const;
+
+  ssize_t ReadUpTo(VMAddress address, size_t size, void* buffer) const override;
+  void ReadBatchInternal(BatchRead* reads, size_t count) const override;
+
+  // Guards chunks_ and index_.
+  mutable base::Lock lock_;
+
+  // Chunks ordered from most to least recently used, and an index into them
+  // by address.
+  mutable std::list<Chunk> chunks_;
+  mutable std::unordered_map<VMAddress, std::list<Chunk>::iterator> index_;
+
+  const ProcessMemory* memory_;  // weak
+  // weak
+  const ProcessInfo::MemoryBasicInformation64Vector* memory_info_;
+  size_t max_chunks_;
+  InitializationStateDcheck initialized_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_UTIL_PROCESS_CACHING_PROCESS_MEMORY_WIN_H_
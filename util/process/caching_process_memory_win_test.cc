@@ -0,0 +1,212 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/process/caching_process_memory_win.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+constexpr size_t kChunkSize = CachingProcessMemoryWin::kChunkSize;
+
+// A ProcessMemory backed by a local buffer which appears at kBaseAddress, of
+// which [unreadable_begin, unreadable_end) may not be read.
+class FakeProcessMemory : public ProcessMemory {
+ public:
+  static constexpr VMAddress kBaseAddress = 0x100000;
+
+  explicit FakeProcessMemory(size_t size)
+      : data_(size), unreadable_begin_(0), unreadable_end_(0), read_count_(0) {
+    for (size_t index = 0; index < data_.size(); ++index) {
+      data_[index] = static_cast<uint8_t>(index * 7);
+    }
+  }
+
+  FakeProcessMemory(const FakeProcessMemory&) = delete;
+  FakeProcessMemory& operator=(const FakeProcessMemory&) = delete;
+
+  void SetUnreadableRange(VMAddress begin, VMAddress end) {
+    unreadable_begin_ = begin;
+    unreadable_end_ = end;
+  }
+
+  uint8_t ExpectedByte(VMAddress address) const {
+    return data_[address - kBaseAddress];
+  }
+
+  size_t read_count() const { return read_count_; }
+
+ private:
+  ssize_t ReadUpTo(VMAddress address,
+                   size_t size,
+                   void* buffer) const override {
+    ++read_count_;
+    const VMAddress end = kBaseAddress + data_.size();
+    if (address < kBaseAddress || address >= end ||
+        (address >= unreadable_begin_ && address < unreadable_end_)) {
+      return -1;
+    }
+    size = std::min(size, static_cast<size_t>(end - address));
+    if (address < unreadable_begin_) {
+      size = std::min(size, static_cast<size_t>(unreadable_begin_ - address));
+    }
+    memcpy(buffer, &data_[address - kBaseAddress], size);
+    return size;
+  }
+
+  std::vector<uint8_t> data_;
+  VMAddress unreadable_begin_;
+  VMAddress unreadable_end_;
+  mutable size_t read_count_;
+};
+
+MEMORY_BASIC_INFORMATION64 Region(VMAddress base, VMSize size, DWORD protect) {
+  MEMORY_BASIC_INFORMATION64 region = {};
+  region.BaseAddress = base;
+  region.AllocationBase = base;
+  region.AllocationProtect = PAGE_READWRITE;
+  region.RegionSize = size;
+  region.State = MEM_COMMIT;
+  region.Protect = protect;
+  region.Type = MEM_PRIVATE;
+  return region;
+}
+
+void ExpectBytes(const FakeProcessMemory& fake,
+                 VMAddress address,
+                 const std::vector<uint8_t>& bytes) {
+  for (size_t index = 0; index < bytes.size(); ++index) {
+    ASSERT_EQ(bytes[index], fake.ExpectedByte(address + index)) << index;
+  }
+}
+
+TEST(CachingProcessMemoryWin, ReadsAheadWholeChunk) {
+  FakeProcessMemory fake(2 * kChunkSize);
+  ProcessInfo::MemoryBasicInformation64Vector memory_info;
+  memory_info.push_back(
+      Region(FakeProcessMemory::kBaseAddress, 2 * kChunkSize, PAGE_READWRITE));
+  CachingProcessMemoryWin memory;
+  memory.Initialize(&fake, &memory_info);
+
+  std::vector<uint8_t> bytes(64);
+  const VMAddress address = FakeProcessMemory::kBaseAddress + 16;
+  ASSERT_TRUE(memory.Read(address, bytes.size(), bytes.data()));
+  ExpectBytes(fake, address, bytes);
+  EXPECT_EQ(fake.read_count(), 1u);
+
+  const VMAddress end_address =
+      FakeProcessMemory::kBaseAddress + kChunkSize - bytes.size();
+  ASSERT_TRUE(memory.Read(end_address, bytes.size(), bytes.data()));
+  ExpectBytes(fake, end_address, bytes);
+  EXPECT_EQ(fake.read_count(), 1u);
+
+  // A read across the end of the chunk reads the next chunk.
+  ASSERT_TRUE(memory.Read(end_address + 32, bytes.size(), bytes.data()));
+  ExpectBytes(fake, end_address + 32, bytes);
+  EXPECT_EQ(fake.read_count(), 2u);
+
+  memory.Clear();
+  ASSERT_TRUE(memory.Read(address, bytes.size(), bytes.data()));
+  EXPECT_EQ(fake.read_count(), 3u);
+}
+
+TEST(CachingProcessMemoryWin, SkipsUnreadableRegions) {
+  FakeProcessMemory fake(kChunkSize);
+  const VMAddress unreadable_begin = FakeProcessMemory::kBaseAddress + 0x1000;
+  const VMAddress unreadable_end = unreadable_begin + 0x1000;
+  fake.SetUnreadableRange(unreadable_begin, unreadable_end);
+
+  ProcessInfo::MemoryBasicInformation64Vector memory_info;
+  memory_info.push_back(
+      Region(FakeProcessMemory::kBaseAddress, 0x1000, PAGE_READONLY));
+  memory_info.push_back(Region(unreadable_begin, 0x1000, PAGE_NOACCESS));
+  memory_info.push_back(Region(unreadable_end,
+                               FakeProcessMemory::kBaseAddress + kChunkSize -
+                                   unreadable_end,
+                               PAGE_READONLY));
+  CachingProcessMemoryWin memory;
+  memory.Initialize(&fake, &memory_info);
+
+  // Each readable region of the chunk is read once.
+  std::vector<uint8_t> bytes(32);
+  ASSERT_TRUE(memory.Read(
+      FakeProcessMemory::kBaseAddress + 0x10, bytes.size(), bytes.data()));
+  ExpectBytes(fake, FakeProcessMemory::kBaseAddress + 0x10, bytes);
+  EXPECT_EQ(fake.read_count(), 2u);
+
+  ASSERT_TRUE(memory.Read(unreadable_end + 0x10, bytes.size(), bytes.data()));
+  ExpectBytes(fake, unreadable_end + 0x10, bytes);
+  EXPECT_EQ(fake.read_count(), 2u);
+
+  EXPECT_FALSE(memory.Read(unreadable_begin, bytes.size(), bytes.data()));
+  EXPECT_FALSE(memory.Read(unreadable_begin - 16, bytes.size(), bytes.data()));
+}
+
+TEST(CachingProcessMemoryWin, EvictsLeastRecentlyUsed) {
+  FakeProcessMemory fake(3 * kChunkSize);
+  ProcessInfo::MemoryBasicInformation64Vector memory_info;
+  memory_info.push_back(
+      Region(FakeProcessMemory::kBaseAddress, 3 * kChunkSize, PAGE_READWRITE));
+  CachingProcessMemoryWin memory;
+  memory.Initialize(&fake, &memory_info, 2);
+
+  const VMAddress chunk0 = FakeProcessMemory::kBaseAddress;
+  const VMAddress chunk1 = chunk0 + kChunkSize;
+  const VMAddress chunk2 = chunk1 + kChunkSize;
+  uint8_t byte;
+
+  ASSERT_TRUE(memory.Read(chunk0, sizeof(byte), &byte));
+  ASSERT_TRUE(memory.Read(chunk1, sizeof(byte), &byte));
+  ASSERT_TRUE(memory.Read(chunk0, sizeof(byte), &byte));
+  EXPECT_EQ(fake.read_count(), 2u);
+
+  // chunk1 is the least recently used and is evicted to make room for chunk2.
+  ASSERT_TRUE(memory.Read(chunk2, sizeof(byte), &byte));
+  EXPECT_EQ(fake.read_count(), 3u);
+  ASSERT_TRUE(memory.Read(chunk0, sizeof(byte), &byte));
+  EXPECT_EQ(fake.read_count(), 3u);
+  ASSERT_TRUE(memory.Read(chunk1, sizeof(byte), &byte));
+  EXPECT_EQ(byte, fake.ExpectedByte(chunk1));
+  EXPECT_EQ(fake.read_count(), 4u);
+}
+
+TEST(CachingProcessMemoryWin, LargeReadsBypassCache) {
+  FakeProcessMemory fake(kChunkSize);
+  ProcessInfo::MemoryBasicInformation64Vector memory_info;
+  memory_info.push_back(
+      Region(FakeProcessMemory::kBaseAddress, kChunkSize, PAGE_READWRITE));
+  CachingProcessMemoryWin memory;
+  memory.Initialize(&fake, &memory_info);
+
+  std::vector<uint8_t> bytes(CachingProcessMemoryWin::kMaxCachedReadSize + 1);
+  ASSERT_TRUE(
+      memory.Read(FakeProcessMemory::kBaseAddress, bytes.size(), bytes.data()));
+  ExpectBytes(fake, FakeProcessMemory::kBaseAddress, bytes);
+  EXPECT_EQ(fake.read_count(), 1u);
+
+  uint8_t byte;
+  ASSERT_TRUE(memory.Read(FakeProcessMemory::kBaseAddress, 1, &byte));
+  EXPECT_EQ(fake.read_count(), 2u);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
@@ -0,0 +1,184 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/process/file_backed_process_memory.h"
+
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include "base/check_op.h"
+#include "base/logging.h"
+#include "util/file/file_io.h"
+
+namespace crashpad {
+
+FileBackedProcessMemory::FileRange::FileRange()
+    : mapping(), data(nullptr), size(0) {}
+
+FileBackedProcessMemory::FileRange::FileRange(FileRange&& other) = default;
+
+FileBackedProcessMemory::FileRange&
+FileBackedProcessMemory::FileRange::operator=(FileRange&& other) = default;
+
+FileBackedProcessMemory::FileRange::~FileRange() = default;
+
+FileBackedProcessMemory::FileBackedProcessMemory()
+    : ProcessMemory(), file_ranges_(), memory_(nullptr), initialized_() {}
+
+FileBackedProcessMemory::~FileBackedProcessMemory() {}
+
+void FileBackedProcessMemory::Initialize(const ProcessMemory* memory) {
+  INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
+  memory_ = memory;
+  INITIALIZATION_STATE_SET_VALID(initialized_);
+}
+
+bool FileBackedProcessMemory::AddFileRange(VMAddress address,
+                                           VMSize size,
+                                           const base::FilePath& path,
+                                           off64_t offset,
+                                           dev_t device,
+                                           ino_t inode) {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+
+  if (size == 0 || offset < 0 || address + size < address) {
+    return false;
+  }
+
+  // Ranges may not overlap.
+  auto next = file_ranges_.lower_bound(address);
+  if (next != file_ranges_.end() && next->first - address < size) {
+    return false;
+  }
+  if (next != file_ranges_.begin()) {
+    auto previous = std::prev(next);
+    if (address - previous->first < previous->second.size) {
+      return false;
+    }
+  }
+
+  ScopedFileHandle handle(OpenFileForRead(path));
+  if (!handle.is_valid()) {
+    return false;
+  }
+
+  // Reading past the end of the file through the mapping would raise SIGBUS,
+  // so the file must be long enough to hold the whole range.
+  struct stat stat_buf;
+  if (fstat(handle.get(), &stat_buf) != 0 || !S_ISREG(stat_buf.st_mode) ||
+      stat_buf.st_dev != device || stat_buf.st_ino != inode ||
+      static_cast<uint64_t>(stat_buf.st_size) <
+          static_cast<uint64_t>(offset) + size) {
+    return false;
+  }
+
+  const off64_t page_mask = getpagesize() - 1;
+  const off64_t mapping_offset = offset & ~page_mask;
+  const size_t delta = static_cast<size_t>(offset - mapping_offset);
+  auto mapping = std::make_unique<ScopedMmap>(/* can_log= */ false);
+  if (!mapping->ResetMmap(nullptr,
+                          delta + size,
+                          PROT_READ,
+                          MAP_PRIVATE,
+                          handle.get(),
+                          mapping_offset)) {
+    return false;
+  }
+
+  FileRange file_range;
+  file_range.data = mapping->addr_as<const uint8_t*>() + delta;
+  file_range.size = size;
+  file_range.mapping = std::move(mapping);
+  file_ranges_.insert(std::make_pair(address, std::move(file_range)));
+  return true;
+}
+
+ssize_t FileBackedProcessMemory::ReadUpTo(VMAddress address,
+                                          size_t size,
+                                          void* buffer) const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+
+  auto next = file_ranges_.upper_bound(address);
+  if (next != file_ranges_.begin()) {
+    const auto previous = std::prev(next);
+    const FileRange& file_range = previous->second;
+    const VMSize range_offset = address - previous->first;
+    if (range_offset < file_range.size) {
+      const size_t copy_size = static_cast<size_t>(
+          std::min(static_cast<VMSize>(size), file_range.size - range_offset));
+      memcpy(buffer, file_range.data + range_offset, copy_size);
+      return copy_size;
+    }
+  }
+
+  // Stop short of the next file range, so that it’s read from its file.
+  if (next != file_ranges_.end() && next->first - address < size) {
+    size = static_cast<size_t>(next->first - address);
+  }
+  return memory_->ReadUpTo(address, size, buffer);
+}
+
+void FileBackedProcessMemory::ReadBatchInternal(BatchRead* reads,
+                                                size_t count) const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+
+  if (file_ranges_.empty()) {
+    memory_->ReadBatchInternal(reads, count);
+    return;
+  }
+
+  // Reads that touch a file range are served individually. The rest are passed
+  // through together, to keep any batching supported by the underlying memory.
+  std::vector<BatchRead> memory_reads;
+  std::vector<size_t> memory_indices;
+  for (size_t index = 0; index < count; ++index) {
+    BatchRead& read = reads[index];
+    if (OverlapsFileRange(read.address, read.size)) {
+      ProcessMemory::ReadBatchInternal(&read, 1);
+      continue;
+    }
+    memory_reads.push_back(read);
+    memory_indices.push_back(index);
+  }
+
+  if (memory_reads.empty()) {
+    return;
+  }
+  memory_->ReadBatchInternal(memory_reads.data(), memory_reads.size());
+  for (size_t index = 0; index < memory_reads.size(); ++index) {
+    reads[memory_indices[index]].succeeded = memory_reads[index].succeeded;
+  }
+}
+
+bool FileBackedProcessMemory::OverlapsFileRange(VMAddress address,
+                                                size_t size) const {
+  auto next = file_ranges_.upper_bound(address);
+  if (next != file_ranges_.end() && next->first - address < size) {
+    return true;
+  }
+  if (next == file_ranges_.begin()) {
+    return false;
+  }
+  const auto previous = std::prev(next);
+  return address - previous->first < previous->second.size;
+}
+
+}  // namespace crashpad
@@ -0,0 +1,116 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_UTIL_PROCESS_FILE_BACKED_PROCESS_MEMORY_H_
+#define CRASHPAD_UTIL_PROCESS_FILE_BACKED_PROCESS_MEMORY_H_
+
+#include <sys/types.h>
+
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "base/files/file_path.h"
+#include "util/misc/address_types.h"
+#include "util/misc/initialization_state_dcheck.h"
+#include "util/posix/scoped_mmap.h"
+#include "util/process/process_memory.h"
+
+namespace crashpad {
+
+//! \brief Reads parts of another process’ memory from the files that they were
+//!     mapped from.
+//!
+//! Every read of another process’ memory takes at least one system call, and,
+//! through a PtraceBroker, a round trip to another process. Parts of the
+//! target’s memory that are known to hold exactly what is in a file, such as
+//! the read-only segments of its modules, can instead be mapped from that file
+//! into this process, where they are normally already in the page cache, and
+//! read by copying. Everything else is read from the underlying ProcessMemory.
+//!
+//! Ranges must only be added for memory that the target can’t have modified
+//! since mapping it. Ranges must not be added while this object is being read
+//! from on other threads.
+class FileBackedProcessMemory final : public ProcessMemory {
+ public:
+  FileBackedProcessMemory();
+
+  FileBackedProcessMemory(const FileBackedProcessMemory&) = delete;
+  FileBackedProcessMemory& operator=(const FileBackedProcessMemory&) = delete;
+
+  ~FileBackedProcessMemory();
+
+  //! \brief Initializes this object to read memory from the underlying
+  //!     \a memory object, except for ranges added by AddFileRange().
+  //!
+  //! This method must be called successfully prior to calling any other method
+  //! in this class.
+  //!
+  //! \param[in] memory The memory object to read memory from.
+  void Initialize(const ProcessMemory* memory);
+
+  //! \brief Reads \a size bytes of the target’s memory at \a address from the
+  //!     file at \a path, at \a offset, from now on.
+  //!
+  //! The file is only used if its device and inode numbers are \a device and
+  //! \a inode, as reported for the target’s mapping of it, so that a file that
+  //! has since replaced the one that the target mapped isn’t read in its
+  //! place. The file is also not used if it is too short to hold the range.
+  //!
+  //! \param[in] address The address of the range in the target.
+  //! \param[in] size The size of the range.
+  //! \param[in] path The path of the file mapped at \a address.
+  //! \param[in] offset The offset in the file of the byte mapped at \a address.
+  //! \param[in] device The device number of the file mapped at \a address.
+  //! \param[in] inode The inode number of the file mapped at \a address.
+  //!
+  //! \return `true` if the range will be read from the file. `false` if it will
+  //!     continue to be read from the underlying ProcessMemory, which is not
+  //!     logged because files may be inaccessible, such as when the target is
+  //!     in another mount namespace.
+  bool AddFileRange(VMAddress address,
+                    VMSize size,
+                    const base::FilePath& path,
+                    off64_t offset,
+                    dev_t device,
+                    ino_t inode);
+
+ private:
+  struct FileRange {
+    FileRange();
+    FileRange(FileRange&& other);
+    FileRange& operator=(FileRange&& other);
+    ~FileRange();
+
+    std::unique_ptr<ScopedMmap> mapping;
+    const uint8_t* data;
+    VMSize size;
+  };
+
+  ssize_t ReadUpTo(VMAddress address, size_t size, void* buffer) const override;
+  void ReadBatchInternal(BatchRead* reads, size_t count) const override;
+
+  // Returns `true` if any part of [address, address + size) is in a file range.
+  bool OverlapsFileRange(VMAddress address, size_t size) const;
+
+  // File ranges by their addresses in the target. They don’t overlap.
+  std::map<VMAddress, FileRange> file_ranges_;
+
+  const ProcessMemory* memory_;  // weak
+  InitializationStateDcheck initialized_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_UTIL_PROCESS_FILE_BACKED_PROCESS_MEMORY_H_
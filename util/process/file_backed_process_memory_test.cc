@@ -0,0 +1,217 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/process/file_backed_process_memory.h"
+
+#include <string.h>
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "test/scoped_temp_dir.h"
+#include "util/file/file_io.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+// A ProcessMemory backed by a local buffer which appears at kBaseAddress, and
+// which counts the reads made of it.
+class FakeProcessMemory : public ProcessMemory {
+ public:
+  static constexpr VMAddress kBaseAddress = 0x10000;
+
+  explicit FakeProcessMemory(size_t size)
+      : data_(size, '\0'), read_count_(0), batch_count_(0) {
+    for (size_t index = 0; index < data_.size(); ++index) {
+      data_[index] = static_cast<char>(index * 7);
+    }
+  }
+
+  FakeProcessMemory(const FakeProcessMemory&) = delete;
+  FakeProcessMemory& operator=(const FakeProcessMemory&) = delete;
+
+  const std::string& data() const { return data_; }
+  size_t read_count() const { return read_count_; }
+  size_t batch_count() const { return batch_count_; }
+
+ private:
+  ssize_t ReadUpTo(VMAddress address,
+                   size_t size,
+                   void* buffer) const override {
+    ++read_count_;
+    if (address < kBaseAddress || address >= kBaseAddress + data_.size()) {
+      return -1;
+    }
+    size = std::min(size,
+                    static_cast<size_t>(kBaseAddress + data_.size() - address));
+    memcpy(buffer, &data_[address - kBaseAddress], size);
+    return size;
+  }
+
+  void ReadBatchInternal(BatchRead* reads, size_t count) const override {
+    ++batch_count_;
+    ProcessMemory::ReadBatchInternal(reads, count);
+  }
+
+  std::string data_;
+  mutable size_t read_count_;
+  mutable size_t batch_count_;
+};
+
+class FileBackedProcessMemoryTest : public testing::Test {
+ protected:
+  static constexpr size_t kMemorySize = 0x4000;
+
+  FileBackedProcessMemoryTest() : fake_(kMemorySize), temp_dir_() {}
+
+  void SetUp() override {
+    // The file holds different contents from the fake memory, so that it’s
+    // possible to tell which was read.
+    path_ = temp_dir_.path().Append(FILE_PATH_LITERAL("file"));
+    contents_.resize(kMemorySize);
+    for (size_t index = 0; index < contents_.size(); ++index) {
+      contents_[index] = static_cast<char>(index * 11 + 1);
+    }
+    ScopedFileHandle handle(LoggingOpenFileForWrite(
+        path_, FileWriteMode::kCreateOrFail, FilePermissions::kOwnerOnly));
+    ASSERT_TRUE(handle.is_valid());
+    ASSERT_TRUE(
+        LoggingWriteFile(handle.get(), contents_.data(), contents_.size()));
+
+    struct stat stat_buf;
+    ASSERT_EQ(stat(path_.value().c_str(), &stat_buf), 0);
+    device_ = stat_buf.st_dev;
+    inode_ = stat_buf.st_ino;
+
+    memory_.Initialize(&fake_);
+  }
+
+  std::string Read(VMAddress address, size_t size) {
+    std::string result(size, '\0');
+    EXPECT_TRUE(memory_.Read(address, size, &result[0]));
+    return result;
+  }
+
+  FakeProcessMemory fake_;
+  FileBackedProcessMemory memory_;
+  std::string contents_;
+  base::FilePath path_;
+  dev_t device_;
+  ino_t inode_;
+
+ private:
+  ScopedTempDir temp_dir_;
+};
+
+TEST_F(FileBackedProcessMemoryTest, ReadsFromFile) {
+  constexpr VMAddress kRangeAddress = FakeProcessMemory::kBaseAddress + 0x1000;
+  constexpr size_t kRangeSize = 0x1800;
+  constexpr off64_t kFileOffset = 0x123;
+  ASSERT_TRUE(memory_.AddFileRange(
+      kRangeAddress, kRangeSize, path_, kFileOffset, device_, inode_));
+
+  // Reads within the range come from the file, without reading the memory.
+  EXPECT_EQ(Read(kRangeAddress, 0x100), contents_.substr(kFileOffset, 0x100));
+  EXPECT_EQ(Read(kRangeAddress + kRangeSize - 0x10, 0x10),
+            contents_.substr(kFileOffset + kRangeSize - 0x10, 0x10));
+  EXPECT_EQ(fake_.read_count(), 0u);
+
+  // Reads outside the range come from the memory.
+  EXPECT_EQ(Read(FakeProcessMemory::kBaseAddress, 0x100),
+            fake_.data().substr(0, 0x100));
+  EXPECT_EQ(Read(kRangeAddress + kRangeSize, 0x100),
+            fake_.data().substr(0x1000 + kRangeSize, 0x100));
+
+  // A read that spans the range’s boundaries is put together from both.
+  const std::string spanning = Read(kRangeAddress - 0x10, kRangeSize + 0x20);
+  EXPECT_EQ(spanning.substr(0, 0x10), fake_.data().substr(0x1000 - 0x10, 0x10));
+  EXPECT_EQ(spanning.substr(0x10, kRangeSize),
+            contents_.substr(kFileOffset, kRangeSize));
+  EXPECT_EQ(spanning.substr(0x10 + kRangeSize),
+            fake_.data().substr(0x1000 + kRangeSize, 0x10));
+}
+
+TEST_F(FileBackedProcessMemoryTest, ReadBatch) {
+  constexpr VMAddress kRangeAddress = FakeProcessMemory::kBaseAddress + 0x1000;
+  constexpr size_t kRangeSize = 0x1000;
+  ASSERT_TRUE(memory_.AddFileRange(
+      kRangeAddress, kRangeSize, path_, 0, device_, inode_));
+
+  std::string outside_1(0x10, '\0');
+  std::string inside(0x10, '\0');
+  std::string spanning(0x20, '\0');
+  std::string outside_2(0x10, '\0');
+  std::vector<ProcessMemory::BatchRead> reads(4);
+  reads[0] = {FakeProcessMemory::kBaseAddress, 0x10, &outside_1[0], false};
+  reads[1] = {kRangeAddress + 0x100, 0x10, &inside[0], false};
+  reads[2] = {kRangeAddress + kRangeSize - 0x10, 0x20, &spanning[0], false};
+  reads[3] = {kRangeAddress + kRangeSize + 0x100, 0x10, &outside_2[0], false};
+  ASSERT_TRUE(memory_.ReadBatch(&reads));
+  for (const ProcessMemory::BatchRead& read : reads) {
+    EXPECT_TRUE(read.succeeded);
+  }
+
+  EXPECT_EQ(outside_1, fake_.data().substr(0, 0x10));
+  EXPECT_EQ(inside, contents_.substr(0x100, 0x10));
+  EXPECT_EQ(spanning.substr(0, 0x10),
+            contents_.substr(kRangeSize - 0x10, 0x10));
+  EXPECT_EQ(spanning.substr(0x10),
+            fake_.data().substr(0x1000 + kRangeSize, 0x10));
+  EXPECT_EQ(outside_2, fake_.data().substr(0x1000 + kRangeSize + 0x100, 0x10));
+
+  // The reads that don’t touch the file range are passed through together.
+  EXPECT_EQ(fake_.batch_count(), 1u);
+}
+
+TEST_F(FileBackedProcessMemoryTest, RejectsUnusableFiles) {
+  constexpr VMAddress kRangeAddress = FakeProcessMemory::kBaseAddress + 0x1000;
+
+  // A different file.
+  EXPECT_FALSE(memory_.AddFileRange(
+      kRangeAddress, 0x100, path_, 0, device_, inode_ + 1));
+
+  // A file too short for the range.
+  EXPECT_FALSE(memory_.AddFileRange(
+      kRangeAddress, kMemorySize, path_, 0x10, device_, inode_));
+
+  // A file that doesn’t exist.
+  EXPECT_FALSE(memory_.AddFileRange(kRangeAddress,
+                                    0x100,
+                                    path_.Append(FILE_PATH_LITERAL("missing")),
+                                    0,
+                                    device_,
+                                    inode_));
+
+  // Overlapping ranges.
+  ASSERT_TRUE(
+      memory_.AddFileRange(kRangeAddress, 0x100, path_, 0, device_, inode_));
+  EXPECT_FALSE(memory_.AddFileRange(
+      kRangeAddress + 0x80, 0x100, path_, 0, device_, inode_));
+  EXPECT_FALSE(memory_.AddFileRange(
+      kRangeAddress - 0x80, 0x100, path_, 0, device_, inode_));
+  EXPECT_TRUE(memory_.AddFileRange(
+      kRangeAddress + 0x100, 0x100, path_, 0, device_, inode_));
+
+  // Memory outside of the ranges is still read from the process.
+  EXPECT_EQ(Read(kRangeAddress + 0x200, 0x10),
+            fake_.data().substr(0x1200, 0x10));
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
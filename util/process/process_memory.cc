@@ -49,6 +49,27 @@ bool ProcessMemory::Read(VMAddress address, VMSize size, void* buffer) const {
   return true;
 }
 
+bool ProcessMemory::ReadBatch(std::vector<BatchRead>* reads) const {
+  if (reads->empty()) {
+    return true;
+  }
+
+  ReadBatchInternal(reads->data(), reads->size());
+
+  bool all_succeeded = true;
+  for (const BatchRead& read : *reads) {
+    all_succeeded &= read.succeeded;
+  }
+  return all_succeeded;
+}
+
+void ProcessMemory::ReadBatchInternal(BatchRead* reads, size_t count) const {
+  for (size_t index = 0; index < count; ++index) {
+    reads[index].succeeded =
+        Read(reads[index].address, reads[index].size, reads[index].buffer);
+  }
+}
+
 bool ProcessMemory::ReadCStringInternal(VMAddress address,
                                         bool has_size,
                                         VMSize size,
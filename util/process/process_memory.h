@@ -18,6 +18,7 @@
 #include <sys/types.h>
 
 #include <string>
+#include <vector>
 
 #include "build/build_config.h"
 #include "util/misc/address_types.h"
@@ -34,6 +35,24 @@ namespace crashpad {
 //! Implementations are platform-specific.
 class ProcessMemory {
  public:
+  //! \brief A region of memory to be copied by ReadBatch().
+  struct BatchRead {
+    //! \brief The address, in the target process’ address space, of the memory
+    //!     region to copy.
+    VMAddress address;
+
+    //! \brief The size, in bytes, of the memory region to copy.
+    size_t size;
+
+    //! \brief The buffer into which the memory region will be copied. Must be
+    //!     at least #size bytes.
+    void* buffer;
+
+    //! \brief Set by ReadBatch() to `true` if the entire region was copied to
+    //!     #buffer, and `false` otherwise.
+    bool succeeded;
+  };
+
   //! \brief Copies memory from the target process into a caller-provided buffer
   //!     in the current process.
   //!
@@ -48,6 +67,21 @@ class ProcessMemory {
   //!     failure, with a message logged.
   bool Read(VMAddress address, VMSize size, void* buffer) const;
 
+  //! \brief Copies multiple memory regions from the target process into
+  //!     caller-provided buffers in the current process.
+  //!
+  //! This is equivalent to calling Read() for each element of \a reads, but
+  //! implementations may be able to copy many regions with a single system
+  //! call. Each region is read independently, so a failure to read one region
+  //! does not prevent others from being read.
+  //!
+  //! \param[in,out] reads The regions to copy. BatchRead::succeeded is set for
+  //!     each element.
+  //!
+  //! \return `true` if every region was copied successfully. `false` if any
+  //!     region could not be copied, with a message logged.
+  bool ReadBatch(std::vector<BatchRead>* reads) const;
+
   //! \brief Reads a `NUL`-terminated C string from the target process into a
   //!     string in the current process.
   //!
@@ -89,6 +123,16 @@ class ProcessMemory {
  protected:
   ProcessMemory() = default;
 
+  //! \brief Copies multiple memory regions from the target process.
+  //!
+  //! The default implementation calls Read() for each region. Subclasses may
+  //! override this to copy several regions at once.
+  //!
+  //! \param[in,out] reads The regions to copy. BatchRead::succeeded must be set
+  //!     for each element.
+  //! \param[in] count The number of elements in \a reads.
+  virtual void ReadBatchInternal(BatchRead* reads, size_t count) const;
+
  private:
   //! \brief Copies memory from the target process into a caller-provided buffer
   //!     in the current process, up to a maximum number of bytes.
@@ -127,7 +171,11 @@ class ProcessMemory {
                                    VMSize size,
                                    std::string* string) const;
 
-  // Allow ProcessMemorySanitized to call ReadUpTo.
+  // Allow decorators of another ProcessMemory to call ReadUpTo and
+  // ReadBatchInternal.
+  friend class CachingProcessMemory;
+  friend class CachingProcessMemoryWin;
+  friend class FileBackedProcessMemory;
   friend class ProcessMemorySanitized;
 };
 
@@ -14,13 +14,18 @@
 
 #include "util/process/process_memory_linux.h"
 
+#include <errno.h>
 #include <fcntl.h>
+#include <limits.h>
 #include <stdio.h>
 #include <string.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
 #include <algorithm>
 #include <limits>
+#include <vector>
 
 #include "base/logging.h"
 #include "base/posix/eintr_wrapper.h"
@@ -31,17 +36,32 @@
 namespace crashpad {
 
 ProcessMemoryLinux::ProcessMemoryLinux(PtraceConnection* connection)
-    : ProcessMemory(), mem_fd_(), ignore_top_byte_(false) {
+    : ProcessMemoryLinux(connection, false) {}
+
+ProcessMemoryLinux::ProcessMemoryLinux(PtraceConnection* connection,
+                                       bool read_through_connection)
+    : ProcessMemory(),
+      mem_fd_(),
+      connection_(connection),
+      pid_(connection->GetProcessID()),
+      ignore_top_byte_(false),
+      use_process_vm_readv_(false) {
 #if defined(ARCH_CPU_ARM_FAMILY)
   if (connection->Is64Bit()) {
     ignore_top_byte_ = true;
   }
 #endif  // ARCH_CPU_ARM_FAMILY
 
-  char path[32];
-  snprintf(path, sizeof(path), "/proc/%d/mem", connection->GetProcessID());
-  mem_fd_.reset(HANDLE_EINTR(open(path, O_RDONLY | O_NOCTTY | O_CLOEXEC)));
+  if (!read_through_connection) {
+    char path[32];
+    snprintf(path, sizeof(path), "/proc/%d/mem", connection->GetProcessID());
+    mem_fd_.reset(HANDLE_EINTR(open(path, O_RDONLY | O_NOCTTY | O_CLOEXEC)));
+  }
   if (mem_fd_.is_valid()) {
+    // process_vm_readv() requires the same access to the target process as
+    // opening its mem file, so only try it when that succeeded. It is not
+    // usable through a PtraceBroker.
+    use_process_vm_readv_ = true;
     read_up_to_ = [this](VMAddress address, size_t size, void* buffer) {
       ssize_t bytes_read =
           HANDLE_EINTR(pread64(mem_fd_.get(), buffer, size, address));
@@ -73,4 +93,94 @@ ssize_t ProcessMemoryLinux::ReadUpTo(VMAddress address,
   return read_up_to_(PointerToAddress(address), size, buffer);
 }
 
+void ProcessMemoryLinux::ReadBatchInternal(BatchRead* reads,
+                                           size_t count) const {
+#if BUILDFLAG(IS_ANDROID)
+  // See FileWriter::WriteIoVec().
+  const size_t kIovMax = sysconf(_SC_IOV_MAX);
+#else
+  const size_t kIovMax = IOV_MAX;
+#endif
+
+  std::vector<iovec> local_iov;
+  std::vector<iovec> remote_iov;
+
+  if (!mem_fd_.is_valid()) {
+    // Memory is read through the connection, which may be able to read all of
+    // the regions at once.
+    if (!ignore_top_byte_) {
+      connection_->ReadUpToV(reads, count);
+      return;
+    }
+
+    std::vector<BatchRead> untagged_reads(reads, reads + count);
+    for (BatchRead& read : untagged_reads) {
+      read.address = PointerToAddress(read.address);
+    }
+    connection_->ReadUpToV(untagged_reads.data(), count);
+    for (size_t index = 0; index < count; ++index) {
+      reads[index].succeeded = untagged_reads[index].succeeded;
+    }
+    return;
+  }
+
+  size_t index = 0;
+  while (index < count) {
+    if (!use_process_vm_readv_) {
+      ProcessMemory::ReadBatchInternal(reads + index, count - index);
+      return;
+    }
+
+    const size_t batch_count = std::min(count - index, kIovMax);
+    local_iov.resize(batch_count);
+    remote_iov.resize(batch_count);
+    for (size_t batch_index = 0; batch_index < batch_count; ++batch_index) {
+      const BatchRead& read = reads[index + batch_index];
+      local_iov[batch_index].iov_base = read.buffer;
+      local_iov[batch_index].iov_len = read.size;
+      remote_iov[batch_index].iov_base =
+          reinterpret_cast<void*>(PointerToAddress(read.address));
+      remote_iov[batch_index].iov_len = read.size;
+    }
+
+    ssize_t bytes_read = syscall(SYS_process_vm_readv,
+                                 pid_,
+                                 local_iov.data(),
+                                 batch_count,
+                                 remote_iov.data(),
+                                 batch_count,
+                                 0);
+    if (bytes_read < 0) {
+      if (errno == ENOSYS || errno == EPERM) {
+        // Fall back to reading regions individually for this and every later
+        // batch.
+        use_process_vm_readv_ = false;
+        continue;
+      }
+
+      // Typically EFAULT, when the first remote region is not readable.
+      bytes_read = 0;
+    }
+
+    // process_vm_readv() stops at the first remote region that can’t be read
+    // completely. Every region before it was read.
+    size_t remaining = bytes_read;
+    const size_t batch_end = index + batch_count;
+    while (index < batch_end && remaining >= reads[index].size) {
+      reads[index].succeeded = true;
+      remaining -= reads[index].size;
+      ++index;
+    }
+
+    // Read the region that stopped the batch individually. This completes a
+    // partial read if the region is readable, or reports the error if it
+    // isn’t, and lets the next batch start after it.
+    if (index < batch_end) {
+      BatchRead& read = reads[index];
+      read.succeeded = Read(read.address, read.size, read.buffer);
+      ++index;
+    }
+  }
+}
+
 }  // namespace crashpad
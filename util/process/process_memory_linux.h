@@ -17,6 +17,7 @@
 
 #include <sys/types.h>
 
+#include <atomic>
 #include <functional>
 #include <string>
 
@@ -33,6 +34,14 @@ class ProcessMemoryLinux final : public ProcessMemory {
  public:
   explicit ProcessMemoryLinux(PtraceConnection* connection);
 
+  //! \param[in] connection The connection to the process.
+  //! \param[in] read_through_connection If `true`, memory is always read with
+  //!     PtraceConnection::ReadUpTo() and PtraceConnection::ReadUpToV(), even
+  //!     if the process’ `mem` file could be read directly. This is used by
+  //!     connections that record or replay reads.
+  ProcessMemoryLinux(PtraceConnection* connection,
+                     bool read_through_connection);
+
   ProcessMemoryLinux(const ProcessMemoryLinux&) = delete;
   ProcessMemoryLinux& operator=(const ProcessMemoryLinux&) = delete;
 
@@ -42,12 +51,27 @@ class ProcessMemoryLinux final : public ProcessMemory {
   //!     tags removed.
   VMAddress PointerToAddress(VMAddress address) const;
 
+  //! \brief Returns `true` if memory may be read from multiple threads at
+  //!     once.
+  //!
+  //! This is the case when the target process' memory is read directly. Reads
+  //! made through the PtraceConnection, such as when it is a PtraceClient, must
+  //! all be made from one thread.
+  bool SupportsConcurrentReads() const { return mem_fd_.is_valid(); }
+
  private:
   ssize_t ReadUpTo(VMAddress address, size_t size, void* buffer) const override;
+  void ReadBatchInternal(BatchRead* reads, size_t count) const override;
 
   std::function<ssize_t(VMAddress, size_t, void*)> read_up_to_;
   base::ScopedFD mem_fd_;
+  PtraceConnection* connection_;  // weak
+  pid_t pid_;
   bool ignore_top_byte_;
+
+  // Cleared if process_vm_readv() is found to be unusable for the target
+  // process, after which ReadBatchInternal() reads each region individually.
+  mutable std::atomic<bool> use_process_vm_readv_;
 };
 
 }  // namespace crashpad
@@ -18,6 +18,8 @@
 #include <string.h>
 
 #include <algorithm>
+#include <iterator>
+#include <utility>
 
 #include "base/logging.h"
 #include "base/mac/mach_logging.h"
@@ -63,7 +65,14 @@ ProcessMemoryMac::MappedMemory::MappedMemory(vm_address_t vm_address,
   DCHECK_LE(user_end, vm_end);
 }
 
-ProcessMemoryMac::ProcessMemoryMac() : task_(TASK_NULL), initialized_() {}
+ProcessMemoryMac::ProcessMemoryMac()
+    : known_regions_lock_(),
+      known_regions_(),
+      mapping_cache_lock_(),
+      mapping_cache_(),
+      max_cached_mappings_(0),
+      task_(TASK_NULL),
+      initialized_() {}
 
 bool ProcessMemoryMac::Initialize(task_t task) {
   INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
@@ -72,6 +81,61 @@ bool ProcessMemoryMac::Initialize(task_t task) {
   return true;
 }
 
+void ProcessMemoryMac::SetMappingCacheSize(size_t max_mappings) {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  base::AutoLock lock(mapping_cache_lock_);
+  max_cached_mappings_ = max_mappings;
+  while (mapping_cache_.size() > max_cached_mappings_) {
+    mapping_cache_.pop_back();
+  }
+}
+
+void ProcessMemoryMac::ClearMappingCache() {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  base::AutoLock lock(mapping_cache_lock_);
+  mapping_cache_.clear();
+}
+
+bool ProcessMemoryMac::AddKnownRegion(
+    mach_vm_address_t address,
+    std::shared_ptr<const std::vector<uint8_t>> data) {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  DCHECK(data && !data->empty());
+
+  base::AutoLock lock(known_regions_lock_);
+  auto next = known_regions_.lower_bound(address);
+  if ((next != known_regions_.end() &&
+       next->first - address < data->size()) ||
+      (next != known_regions_.begin() &&
+       address - std::prev(next)->first < std::prev(next)->second->size())) {
+    return false;
+  }
+  known_regions_.emplace_hint(next, address, std::move(data));
+  return true;
+}
+
+bool ProcessMemoryMac::PreserveRegion(mach_vm_address_t address,
+                                      size_t size) const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+
+  if (size == 0) {
+    return true;
+  }
+
+  // mach_vm_read() maps a copy-on-write copy of the region.
+  std::unique_ptr<MappedMemory> memory = ReadMapped(address, size);
+  if (!memory) {
+    return false;
+  }
+
+  base::AutoLock lock(preserved_regions_lock_);
+  auto& preserved = preserved_regions_[address];
+  if (!preserved || preserved->user_size_ < size) {
+    preserved = std::move(memory);
+  }
+  return true;
+}
+
 std::unique_ptr<ProcessMemoryMac::MappedMemory> ProcessMemoryMac::ReadMapped(
     mach_vm_address_t address,
     size_t size) const {
@@ -108,12 +172,128 @@ std::unique_ptr<ProcessMemoryMac::MappedMemory> ProcessMemoryMac::ReadMapped(
       new MappedMemory(region, region_size, address - region_address, size));
 }
 
+bool ProcessMemoryMac::ReadFromMappingCache(VMAddress address,
+                                            size_t size,
+                                            void* buffer) const {
+  const mach_vm_address_t region_address =
+      address & ~mach_vm_address_t{kCachedMappingSize - 1};
+  if (address - region_address + size > kCachedMappingSize) {
+    return false;
+  }
+
+  base::AutoLock lock(mapping_cache_lock_);
+  if (max_cached_mappings_ == 0) {
+    return false;
+  }
+
+  auto iterator = std::find_if(mapping_cache_.begin(),
+                               mapping_cache_.end(),
+                               [region_address](const CachedMapping& mapping) {
+                                 return mapping.address == region_address;
+                               });
+  if (iterator != mapping_cache_.end()) {
+    mapping_cache_.splice(mapping_cache_.begin(), mapping_cache_, iterator);
+  } else {
+    // The region may extend past the end of what is mapped in the target
+    // task, in which case the caller falls back to mapping only the pages it
+    // needs, so a failure here isn’t logged.
+    vm_offset_t region;
+    mach_msg_type_number_t region_count;
+    kern_return_t kr = mach_vm_read(
+        task_, region_address, kCachedMappingSize, &region, &region_count);
+    if (kr != KERN_SUCCESS) {
+      return false;
+    }
+    if (region_count != kCachedMappingSize) {
+      if (region_count)
+        vm_deallocate(mach_task_self(), region, region_count);
+      return false;
+    }
+
+    if (mapping_cache_.size() >= max_cached_mappings_) {
+      mapping_cache_.pop_back();
+    }
+    mapping_cache_.push_front(CachedMapping{
+        region_address,
+        std::unique_ptr<MappedMemory>(new MappedMemory(
+            region, kCachedMappingSize, 0, kCachedMappingSize))});
+  }
+
+  memcpy(buffer,
+         reinterpret_cast<const char*>(mapping_cache_.front().memory->data()) +
+             (address - region_address),
+         size);
+  return true;
+}
+
+size_t ProcessMemoryMac::ReadFromKnownRegions(VMAddress address,
+                                              size_t size,
+                                              void* buffer) const {
+  base::AutoLock lock(known_regions_lock_);
+  auto iterator = known_regions_.upper_bound(address);
+  if (iterator == known_regions_.begin()) {
+    return 0;
+  }
+  --iterator;
+
+  const std::vector<uint8_t>& data = *iterator->second;
+  const VMSize offset = address - iterator->first;
+  if (offset >= data.size()) {
+    return 0;
+  }
+
+  const size_t bytes_copied =
+      std::min(size, data.size() - static_cast<size_t>(offset));
+  memcpy(buffer, data.data() + offset, bytes_copied);
+  return bytes_copied;
+}
+
+size_t ProcessMemoryMac::ReadFromPreservedRegions(VMAddress address,
+                                                  size_t size,
+                                                  void* buffer) const {
+  base::AutoLock lock(preserved_regions_lock_);
+  auto iterator = preserved_regions_.upper_bound(address);
+  if (iterator == preserved_regions_.begin()) {
+    return 0;
+  }
+  --iterator;
+
+  const MappedMemory& memory = *iterator->second;
+  const VMSize offset = address - iterator->first;
+  if (offset >= memory.user_size_) {
+    return 0;
+  }
+
+  const size_t bytes_copied =
+      std::min(size, memory.user_size_ - static_cast<size_t>(offset));
+  memcpy(buffer,
+         reinterpret_cast<const char*>(memory.data()) + offset,
+         bytes_copied);
+  return bytes_copied;
+}
+
 ssize_t ProcessMemoryMac::ReadUpTo(VMAddress address,
                                    size_t size,
                                    void* buffer) const {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
   DCHECK_LE(size, (size_t)std::numeric_limits<ssize_t>::max());
 
+  const size_t known_bytes = ReadFromKnownRegions(address, size, buffer);
+  if (known_bytes > 0) {
+    return static_cast<ssize_t>(known_bytes);
+  }
+
+  const size_t preserved_bytes =
+      ReadFromPreservedRegions(address, size, buffer);
+  if (preserved_bytes > 0) {
+    return static_cast<ssize_t>(preserved_bytes);
+  }
+
+  if (size <= kMaxCachedReadSize &&
+      ReadFromMappingCache(address, size, buffer)) {
+    return static_cast<ssize_t>(size);
+  }
+
   std::unique_ptr<MappedMemory> memory = ReadMapped(address, size);
   if (!memory) {
     // If we can not read the entire mapping, try to perform a short read of the
@@ -18,10 +18,14 @@
 #include <mach/mach.h>
 #include <sys/types.h>
 
+#include <list>
+#include <map>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "base/mac/scoped_mach_vm.h"
+#include "base/synchronization/lock.h"
 #include "util/misc/address_types.h"
 #include "util/misc/initialization_state_dcheck.h"
 #include "util/process/process_memory.h"
@@ -90,6 +94,16 @@ class ProcessMemoryMac : public ProcessMemory {
     friend class ProcessMemoryMac;
   };
 
+  //! \brief The size and alignment of regions kept mapped by the mapping
+  //!     cache.
+  static constexpr size_t kCachedMappingSize = 64 * 1024;
+
+  //! \brief The largest read that will be satisfied from the mapping cache.
+  static constexpr size_t kMaxCachedReadSize = 16 * 1024;
+
+  //! \brief The number of regions kept mapped if not specified otherwise.
+  static constexpr size_t kDefaultMaxCachedMappings = 32;
+
   ProcessMemoryMac();
 
   ProcessMemoryMac(const ProcessMemoryMac&) = delete;
@@ -109,6 +123,67 @@ class ProcessMemoryMac : public ProcessMemory {
   //! \return `true` on success, `false` on failure with a message logged.
   bool Initialize(task_t task);
 
+  //! \brief Keeps recently mapped regions of the target task mapped, and
+  //!     satisfies small reads from them.
+  //!
+  //! Without the cache, every read maps the pages it touches and unmaps them
+  //! again. With it, a read of at most kMaxCachedReadSize bytes maps the whole
+  //! kCachedMappingSize-aligned region containing it, if it can, and keeps that
+  //! mapping for later reads. Up to \a max_mappings regions are kept, with the
+  //! least recently used dropped first.
+  //!
+  //! Mappings are copies of the target task’s memory as of when they were
+  //! made, and are never invalidated, so this is only suitable while the
+  //! target task is suspended, such as for the duration of a single snapshot
+  //! capture.
+  //!
+  //! \param[in] max_mappings The number of regions to keep mapped. If `0`,
+  //!     the cache is disabled, which is the default.
+  void SetMappingCacheSize(size_t max_mappings);
+
+  //! \brief Unmaps all regions kept by the mapping cache.
+  void ClearMappingCache();
+
+  //! \brief Satisfies reads from a region of the target task with a copy of
+  //!     its contents instead of reading them from the task.
+  //!
+  //! This is for memory whose contents are already known and can’t change,
+  //! such as the headers of images in the dyld shared cache, which are the
+  //! same in every task that maps the same shared cache. A read that begins
+  //! within the region is satisfied from \a data, up to the end of the region.
+  //! ReadMapped() is not affected.
+  //!
+  //! \param[in] address The address, in the target task’s address space, at
+  //!     which the region begins.
+  //! \param[in] data The contents of the region, which must not be empty.
+  //!
+  //! \return `true` if the region was added, or `false` if it overlaps a
+  //!     region added before, in which case reads within it are satisfied as
+  //!     they were before.
+  bool AddKnownRegion(mach_vm_address_t address,
+                      std::shared_ptr<const std::vector<uint8_t>> data);
+
+  //! \brief Takes a copy-on-write copy of a region of the target task, and
+  //!     satisfies later reads within it from the copy.
+  //!
+  //! This allows a suspended task to be resumed while its memory is still
+  //! being read: reads within preserved regions see the contents that the
+  //! region had when it was preserved, regardless of what the task does
+  //! afterwards. The copy is made by mapping the region, so the region’s
+  //! contents are only copied as the task modifies them. A read that begins
+  //! within a preserved region is satisfied from it, up to the end of the
+  //! region. ReadMapped() is not affected.
+  //!
+  //! \param[in] address The address, in the target task’s address space, at
+  //!     which the region begins. Regions may overlap regions preserved
+  //!     before, but a read is only satisfied from the preserved region that
+  //!     begins closest below it.
+  //! \param[in] size The size of the region.
+  //!
+  //! \return `true` on success, or `false` with a warning logged if the region
+  //!     couldn’t be mapped.
+  bool PreserveRegion(mach_vm_address_t address, size_t size) const;
+
   //! \brief Maps memory from the target task into the current task.
   //!
   //! This interface is an alternative to Read() that does not require the
@@ -126,8 +201,56 @@ class ProcessMemoryMac : public ProcessMemory {
                                            size_t size) const;
 
  private:
+  struct CachedMapping {
+    mach_vm_address_t address;
+    std::unique_ptr<MappedMemory> memory;
+  };
+
+  // Copies size bytes at address into buffer from the mapping cache, mapping
+  // the region containing them if it isn’t cached. Returns false without
+  // logging anything if the bytes aren’t within a single region or the region
+  // can’t be mapped.
+  bool ReadFromMappingCache(VMAddress address,
+                            size_t size,
+                            void* buffer) const;
+
+  // Copies up to size bytes at address into buffer from a region added by
+  // AddKnownRegion(). Returns the number of bytes copied, which is 0 if address
+  // isn’t within such a region.
+  size_t ReadFromKnownRegions(VMAddress address,
+                              size_t size,
+                              void* buffer) const;
+
+  // Copies up to size bytes at address into buffer from a region preserved by
+  // PreserveRegion(). Returns the number of bytes copied, which is 0 if address
+  // isn’t within such a region.
+  size_t ReadFromPreservedRegions(VMAddress address,
+                                  size_t size,
+                                  void* buffer) const;
+
   ssize_t ReadUpTo(VMAddress address, size_t size, void* buffer) const override;
 
+  // Guards known_regions_.
+  mutable base::Lock known_regions_lock_;
+
+  // Regions added by AddKnownRegion(), by address.
+  std::map<mach_vm_address_t, std::shared_ptr<const std::vector<uint8_t>>>
+      known_regions_;
+
+  // Guards preserved_regions_.
+  mutable base::Lock preserved_regions_lock_;
+
+  // Regions preserved by PreserveRegion(), by address.
+  mutable std::map<mach_vm_address_t, std::unique_ptr<MappedMemory>>
+      preserved_regions_;
+
+  // Guards mapping_cache_.
+  mutable base::Lock mapping_cache_lock_;
+
+  // Mappings ordered from most to least recently used.
+  mutable std::list<CachedMapping> mapping_cache_;
+
+  size_t max_cached_mappings_;
   task_t task_;  // weak
   InitializationStateDcheck initialized_;
 };
@@ -20,6 +20,7 @@
 #include <algorithm>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "base/mac/scoped_mach_port.h"
 #include "base/mac/scoped_mach_vm.h"
@@ -335,6 +336,122 @@ TEST(ProcessMemoryMac, MappedMemoryReadCString) {
   EXPECT_FALSE(mapped->ReadCString(12, &string));
 }
 
+TEST(ProcessMemoryMac, MappingCache) {
+  constexpr size_t kMappingSize = ProcessMemoryMac::kCachedMappingSize;
+  vm_address_t allocation = 0;
+  const vm_size_t kAllocationSize = 3 * kMappingSize;
+  kern_return_t kr = vm_allocate(
+      mach_task_self(), &allocation, kAllocationSize, VM_FLAGS_ANYWHERE);
+  ASSERT_EQ(kr, KERN_SUCCESS) << MachErrorMessage(kr, "vm_allocate");
+  base::mac::ScopedMachVM vm_owner(allocation, kAllocationSize);
+
+  // Use two whole mapping-aligned regions within the allocation.
+  const vm_address_t address =
+      (allocation + kMappingSize - 1) & ~vm_address_t{kMappingSize - 1};
+  char* region = reinterpret_cast<char*>(address);
+  for (size_t index = 0; index < 2 * kMappingSize; ++index) {
+    region[index] = (index % 256) ^ ((index >> 8) % 256);
+  }
+
+  ProcessMemoryMac memory;
+  ASSERT_TRUE(memory.Initialize(mach_task_self()));
+  memory.SetMappingCacheSize(2);
+
+  char result[16];
+  ASSERT_TRUE(memory.Read(address + 8, sizeof(result), result));
+  EXPECT_EQ(memcmp(region + 8, result, sizeof(result)), 0);
+
+  // The region stays mapped as it was when first read.
+  const char original = region[8];
+  region[8] = ~original;
+  ASSERT_TRUE(memory.Read(address + 8, sizeof(result), result));
+  EXPECT_EQ(result[0], original);
+
+  memory.ClearMappingCache();
+  ASSERT_TRUE(memory.Read(address + 8, sizeof(result), result));
+  EXPECT_EQ(result[0], region[8]);
+
+  // A read across two regions isn’t served from the cache, but still works.
+  const size_t across = kMappingSize - sizeof(result) / 2;
+  ASSERT_TRUE(memory.Read(address + across, sizeof(result), result));
+  EXPECT_EQ(memcmp(region + across, result, sizeof(result)), 0);
+
+  // When part of a region is unreadable, reads of the rest fall back to
+  // mapping only the pages they touch.
+  kr = vm_protect(mach_task_self(),
+                  address + 2 * kMappingSize - PAGE_SIZE,
+                  PAGE_SIZE,
+                  FALSE,
+                  VM_PROT_NONE);
+  ASSERT_EQ(kr, KERN_SUCCESS) << MachErrorMessage(kr, "vm_protect");
+  memory.ClearMappingCache();
+  ASSERT_TRUE(memory.Read(address + kMappingSize, sizeof(result), result));
+  EXPECT_EQ(memcmp(region + kMappingSize, result, sizeof(result)), 0);
+  EXPECT_FALSE(memory.Read(
+      address + 2 * kMappingSize - PAGE_SIZE, sizeof(result), result));
+
+  // A disabled cache keeps nothing mapped.
+  memory.SetMappingCacheSize(0);
+  region[8] = original;
+  ASSERT_TRUE(memory.Read(address + 8, sizeof(result), result));
+  EXPECT_EQ(result[0], original);
+  region[8] = ~original;
+  ASSERT_TRUE(memory.Read(address + 8, sizeof(result), result));
+  EXPECT_EQ(result[0], region[8]);
+}
+
+TEST(ProcessMemoryMac, KnownRegion) {
+  std::string string("0123456789");
+  const mach_vm_address_t address =
+      FromPointerCast<mach_vm_address_t>(string.data());
+
+  ProcessMemoryMac memory;
+  ASSERT_TRUE(memory.Initialize(mach_task_self()));
+
+  // Reads that begin within the region come from its copy, up to its end.
+  EXPECT_TRUE(memory.AddKnownRegion(
+      address + 2,
+      std::make_shared<const std::vector<uint8_t>>(4, uint8_t{'x'})));
+
+  // Regions that overlap it aren’t added.
+  EXPECT_FALSE(memory.AddKnownRegion(
+      address, std::make_shared<const std::vector<uint8_t>>(3, uint8_t{'y'})));
+  EXPECT_FALSE(memory.AddKnownRegion(
+      address + 5,
+      std::make_shared<const std::vector<uint8_t>>(1, uint8_t{'y'})));
+
+  char result[8];
+  ASSERT_TRUE(memory.Read(address + 2, 4, result));
+  EXPECT_EQ(std::string(result, 4), "xxxx");
+  ASSERT_TRUE(memory.Read(address, sizeof(result), result));
+  EXPECT_EQ(std::string(result, sizeof(result)), "01234567");
+  ASSERT_TRUE(memory.Read(address + 4, 4, result));
+  EXPECT_EQ(std::string(result, 4), "xx67");
+  ASSERT_TRUE(memory.Read(address + 6, 4, result));
+  EXPECT_EQ(std::string(result, 4), "6789");
+}
+
+TEST(ProcessMemoryMac, PreservedRegion) {
+  std::string string("0123456789");
+  const mach_vm_address_t address =
+      FromPointerCast<mach_vm_address_t>(string.data());
+
+  ProcessMemoryMac memory;
+  ASSERT_TRUE(memory.Initialize(mach_task_self()));
+  ASSERT_TRUE(memory.PreserveRegion(address + 2, 4));
+
+  // Reads that begin within the region see its contents as they were when it
+  // was preserved, up to its end.
+  string.replace(0, 8, "abcdefgh");
+  char result[8];
+  ASSERT_TRUE(memory.Read(address + 2, 4, result));
+  EXPECT_EQ(std::string(result, 4), "2345");
+  ASSERT_TRUE(memory.Read(address + 4, 4, result));
+  EXPECT_EQ(std::string(result, 4), "45gh");
+  ASSERT_TRUE(memory.Read(address, sizeof(result), result));
+  EXPECT_EQ(std::string(result, sizeof(result)), "abcdefgh");
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace crashpad
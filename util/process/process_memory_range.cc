@@ -78,6 +78,38 @@ bool ProcessMemoryRange::Read(VMAddress address,
   return memory_->Read(address, size, buffer);
 }
 
+bool ProcessMemoryRange::ReadBatch(
+    std::vector<ProcessMemory::BatchRead>* reads) const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+
+  std::vector<ProcessMemory::BatchRead> in_range_reads;
+  std::vector<size_t> in_range_indices;
+  in_range_reads.reserve(reads->size());
+  in_range_indices.reserve(reads->size());
+  bool all_in_range = true;
+  for (size_t index = 0; index < reads->size(); ++index) {
+    ProcessMemory::BatchRead& read = (*reads)[index];
+    CheckedVMAddressRange read_range(range_.Is64Bit(), read.address, read.size);
+    if (!read_range.IsValid() || !range_.ContainsRange(read_range)) {
+      read.succeeded = false;
+      all_in_range = false;
+      continue;
+    }
+    in_range_reads.push_back(read);
+    in_range_indices.push_back(index);
+  }
+  if (!all_in_range) {
+    LOG(ERROR) << "read out of range";
+  }
+
+  const bool all_read = memory_->ReadBatch(&in_range_reads);
+  for (size_t index = 0; index < in_range_reads.size(); ++index) {
+    (*reads)[in_range_indices[index]].succeeded =
+        in_range_reads[index].succeeded;
+  }
+  return all_in_range && all_read;
+}
+
 bool ProcessMemoryRange::ReadCStringSizeLimited(VMAddress address,
                                                 VMSize size,
                                                 std::string* string) const {
@@ -18,6 +18,7 @@
 #include <sys/types.h>
 
 #include <string>
+#include <vector>
 
 #include "util/misc/address_types.h"
 #include "util/misc/initialization_state_dcheck.h"
@@ -102,6 +103,19 @@ class ProcessMemoryRange {
   //!     failure, with a message logged.
   bool Read(VMAddress address, VMSize size, void* buffer) const;
 
+  //! \brief Copies several regions of memory from the target process into
+  //!     caller-provided buffers in the current process.
+  //!
+  //! Regions outside of the range fail without being read. The rest are read
+  //! with ProcessMemory::ReadBatch().
+  //!
+  //! \param[in,out] reads The regions to copy.
+  //!     ProcessMemory::BatchRead::succeeded is set for each element.
+  //!
+  //! \return `true` if every region was copied successfully. `false` if any
+  //!     region could not be copied, with a message logged.
+  bool ReadBatch(std::vector<ProcessMemory::BatchRead>* reads) const;
+
   //! \brief Reads a `NUL`-terminated C string from the target process into a
   //!     string in the current process.
   //!
@@ -16,6 +16,7 @@
 
 #include <iterator>
 #include <limits>
+#include <vector>
 
 #include "build/build_config.h"
 #include "gtest/gtest.h"
@@ -87,6 +88,18 @@ TEST(ProcessMemoryRange, Basic) {
       string2_addr, std::size(kTestObject.string2), &string));
   EXPECT_FALSE(range2.Read(object_addr, sizeof(object), &object));
 
+  // Batched reads fail individually if they’re outside the range.
+  char string1[std::size(kTestObject.string1)];
+  char string2[std::size(kTestObject.string2)];
+  std::vector<ProcessMemory::BatchRead> reads = {
+      {string1_addr, sizeof(string1), string1, false},
+      {string2_addr, sizeof(string2), string2, true},
+  };
+  EXPECT_FALSE(range2.ReadBatch(&reads));
+  EXPECT_TRUE(reads[0].succeeded);
+  EXPECT_STREQ(string1, kTestObject.string1);
+  EXPECT_FALSE(reads[1].succeeded);
+
   // String reads fail if the NUL terminator is outside the range.
   ASSERT_TRUE(range2.RestrictRange(string1_addr, strlen(kTestObject.string1)));
   EXPECT_FALSE(range2.ReadCStringSizeLimited(
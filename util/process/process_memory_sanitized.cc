@@ -37,8 +37,29 @@ bool ProcessMemorySanitized::Initialize(
     const std::vector<std::pair<VMAddress, VMAddress>>* allowed_ranges) {
   INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
   memory_ = memory;
-  if (allowed_ranges)
-    allowed_ranges_ = *allowed_ranges;
+
+  allowed_ranges_.clear();
+  if (allowed_ranges) {
+    std::vector<std::pair<VMAddress, VMAddress>> ranges;
+    ranges.reserve(allowed_ranges->size());
+    for (const auto& range : *allowed_ranges) {
+      if (range.first < range.second) {
+        ranges.push_back(range);
+      }
+    }
+    std::sort(ranges.begin(), ranges.end());
+
+    for (const auto& range : ranges) {
+      if (!allowed_ranges_.empty() &&
+          range.first <= allowed_ranges_.back().second) {
+        allowed_ranges_.back().second =
+            std::max(allowed_ranges_.back().second, range.second);
+      } else {
+        allowed_ranges_.push_back(range);
+      }
+    }
+  }
+
   INITIALIZATION_STATE_SET_VALID(initialized_);
   return true;
 }
@@ -48,11 +69,22 @@ ssize_t ProcessMemorySanitized::ReadUpTo(VMAddress address,
                                          void* buffer) const {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
 
-  VMAddress end = address + size;
-  for (auto&& entry : allowed_ranges_) {
-    if (address >= entry.first && address < entry.second &&
-        end >= entry.first && end <= entry.second) {
-      return memory_->ReadUpTo(address, size, buffer);
+  // Find the last range beginning at or below address.
+  auto range = std::upper_bound(
+      allowed_ranges_.begin(),
+      allowed_ranges_.end(),
+      address,
+      [](VMAddress address, const std::pair<VMAddress, VMAddress>& range) {
+        return address < range.first;
+      });
+  if (range != allowed_ranges_.begin()) {
+    --range;
+    if (address < range->second) {
+      const VMSize allowed_size = range->second - address;
+      return memory_->ReadUpTo(
+          address,
+          allowed_size < size ? static_cast<size_t>(allowed_size) : size,
+          buffer);
     }
   }
 
@@ -42,8 +42,13 @@ class ProcessMemorySanitized final : public ProcessMemory {
   //! This method must be called successfully prior to calling any other method
   //! in this class.
   //!
+  //! A read that begins in an allowed range but extends beyond it is
+  //! truncated to the allowed portion.
+  //!
   //! \param[in] memory The memory object to read memory from.
-  //! \param[in] allowed_ranges A list of allowed memory ranges.
+  //! \param[in] allowed_ranges A list of allowed memory ranges, each given as
+  //!     its base address and the address immediately following it. The
+  //!     ranges may be given in any order and may overlap.
   //!
   //! \return `true` on success, `false` on failure with a message logged.
   bool Initialize(
@@ -55,6 +60,8 @@ class ProcessMemorySanitized final : public ProcessMemory {
 
   const ProcessMemory* memory_;
   InitializationStateDcheck initialized_;
+
+  // Sorted by base address, with overlapping and adjacent ranges merged.
   std::vector<std::pair<VMAddress, VMAddress>> allowed_ranges_;
 };
 
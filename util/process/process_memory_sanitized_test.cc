@@ -14,6 +14,8 @@
 
 #include "util/process/process_memory_sanitized.h"
 
+#include <string>
+
 #include "build/build_config.h"
 #include "gtest/gtest.h"
 #include "test/process_type.h"
@@ -78,6 +80,73 @@ TEST(ProcessMemorySanitized, AllowedMemory) {
   EXPECT_FALSE(sanitized.Read(FromPointerCast<VMAddress>(str + 2), 1, &out));
 }
 
+TEST(ProcessMemorySanitized, MergedRanges) {
+#if BUILDFLAG(IS_ANDROID) || BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS)
+  FakePtraceConnection connection;
+  ASSERT_TRUE(connection.Initialize(GetSelfProcess()));
+  ProcessMemoryLinux memory(&connection);
+#else
+  ProcessMemoryNative memory;
+  ASSERT_TRUE(memory.Initialize(GetSelfProcess()));
+#endif  // BUILDFLAG(IS_ANDROID) || BUILDFLAG(IS_LINUX) ||
+        // BUILDFLAG(IS_CHROMEOS)
+
+  char str[8] = "ABCDEFG";
+  char out[8];
+  const VMAddress address = FromPointerCast<VMAddress>(str);
+
+  // Unordered, overlapping, and adjacent ranges covering [str + 1, str + 6).
+  std::vector<std::pair<VMAddress, VMAddress>> allowed_memory;
+  allowed_memory.push_back(std::make_pair(address + 4, address + 6));
+  allowed_memory.push_back(std::make_pair(address + 1, address + 3));
+  allowed_memory.push_back(std::make_pair(address + 2, address + 4));
+  allowed_memory.push_back(std::make_pair(address + 7, address + 7));
+
+  ProcessMemorySanitized sanitized;
+  sanitized.Initialize(&memory, &allowed_memory);
+
+  ASSERT_TRUE(sanitized.Read(address + 1, 5, &out));
+  EXPECT_EQ(std::string(out, 5), "BCDEF");
+  EXPECT_TRUE(sanitized.Read(address + 5, 1, &out));
+  EXPECT_FALSE(sanitized.Read(address, 1, &out));
+  EXPECT_FALSE(sanitized.Read(address + 1, 6, &out));
+  EXPECT_FALSE(sanitized.Read(address + 6, 1, &out));
+  EXPECT_FALSE(sanitized.Read(address + 7, 1, &out));
+}
+
+TEST(ProcessMemorySanitized, ReadAllowedPrefix) {
+#if BUILDFLAG(IS_ANDROID) || BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS)
+  FakePtraceConnection connection;
+  ASSERT_TRUE(connection.Initialize(GetSelfProcess()));
+  ProcessMemoryLinux memory(&connection);
+#else
+  ProcessMemoryNative memory;
+  ASSERT_TRUE(memory.Initialize(GetSelfProcess()));
+#endif  // BUILDFLAG(IS_ANDROID) || BUILDFLAG(IS_LINUX) ||
+        // BUILDFLAG(IS_CHROMEOS)
+
+  char str[16] = "ABC";
+  const VMAddress address = FromPointerCast<VMAddress>(str);
+
+  std::vector<std::pair<VMAddress, VMAddress>> allowed_memory;
+  allowed_memory.push_back(std::make_pair(address, address + 4));
+
+  ProcessMemorySanitized sanitized;
+  sanitized.Initialize(&memory, &allowed_memory);
+
+  // The string's terminator is within the allowed range, so the string can be
+  // read even though the requested size extends beyond it.
+  std::string result;
+  ASSERT_TRUE(sanitized.ReadCStringSizeLimited(address, sizeof(str), &result));
+  EXPECT_EQ(result, "ABC");
+
+  allowed_memory.clear();
+  allowed_memory.push_back(std::make_pair(address, address + 2));
+  ProcessMemorySanitized truncated;
+  truncated.Initialize(&memory, &allowed_memory);
+  EXPECT_FALSE(truncated.ReadCStringSizeLimited(address, sizeof(str), &result));
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace crashpad
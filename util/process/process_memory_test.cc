@@ -445,6 +445,46 @@ class ReadUnmappedTest : public MultiprocessAdaptor {
         memory.Read(page_addr1, base::GetPageSize() * 2, result.get()));
     EXPECT_FALSE(memory.Read(page_addr2, base::GetPageSize(), result.get()));
     EXPECT_FALSE(memory.Read(page_addr2 - 1, 2, result.get()));
+
+    // Regions following one that can’t be read are still read by ReadBatch().
+    std::unique_ptr<char[]> batch_result(new char[base::GetPageSize() * 5]);
+    std::vector<ProcessMemory::BatchRead> reads;
+    const auto add_read = [&reads, &batch_result](VMAddress address,
+                                                  size_t size) {
+      ProcessMemory::BatchRead read;
+      read.address = address;
+      read.size = size;
+      read.buffer = batch_result.get() + base::GetPageSize() * reads.size();
+      read.succeeded = false;
+      reads.push_back(read);
+    };
+    add_read(page_addr1, base::GetPageSize());
+    add_read(page_addr2 - 1, 2);
+    add_read(page_addr1 + 1, 10);
+    add_read(page_addr2, 1);
+    add_read(page_addr2 - 1, 1);
+    EXPECT_FALSE(memory.ReadBatch(&reads));
+
+    EXPECT_TRUE(reads[0].succeeded);
+    EXPECT_FALSE(reads[1].succeeded);
+    EXPECT_TRUE(reads[2].succeeded);
+    EXPECT_FALSE(reads[3].succeeded);
+    EXPECT_TRUE(reads[4].succeeded);
+
+    const char* buffer = static_cast<const char*>(reads[0].buffer);
+    for (size_t index = 0; index < base::GetPageSize(); ++index) {
+      ASSERT_EQ(buffer[index], static_cast<char>(index % 256));
+    }
+    buffer = static_cast<const char*>(reads[2].buffer);
+    for (size_t index = 0; index < 10; ++index) {
+      ASSERT_EQ(buffer[index], static_cast<char>((index + 1) % 256));
+    }
+    EXPECT_EQ(*static_cast<const char*>(reads[4].buffer),
+              static_cast<char>((base::GetPageSize() - 1) % 256));
+
+    reads.erase(reads.begin() + 3);
+    reads.erase(reads.begin() + 1);
+    EXPECT_TRUE(memory.ReadBatch(&reads));
   }
 };
 
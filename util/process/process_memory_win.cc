@@ -44,6 +44,11 @@ bool ProcessMemoryWin::Initialize(HANDLE handle) {
   return true;
 }
 
+void ProcessMemoryWin::ReadFrom(HANDLE handle) {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  handle_ = handle;
+}
+
 ssize_t ProcessMemoryWin::ReadUpTo(VMAddress address,
                                    size_t size,
                                    void* buffer) const {
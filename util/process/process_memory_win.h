@@ -45,6 +45,14 @@ class ProcessMemoryWin final : public ProcessMemory {
   //! \return `true` on success, `false` on failure with a message logged.
   bool Initialize(HANDLE handle);
 
+  //! \brief Reads memory through \a handle from now on.
+  //!
+  //! \param[in] handle The HANDLE of a process with the same address space
+  //!     layout as the one this object was initialized with, such as a clone of
+  //!     it made by ProcessVaClone. It must remain valid for as long as this
+  //!     object is used.
+  void ReadFrom(HANDLE handle);
+
   //! \brief Attempts to read \a size bytes from the target process starting at
   //!     address \a address into \a buffer. If some of the specified range is
   //!     not accessible, reads up to the first inaccessible byte.
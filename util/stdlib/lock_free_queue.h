@@ -0,0 +1,83 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_UTIL_STDLIB_LOCK_FREE_QUEUE_H_
+#define CRASHPAD_UTIL_STDLIB_LOCK_FREE_QUEUE_H_
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+namespace crashpad {
+
+//! \brief A queue that any number of threads may push elements onto without
+//!     taking a lock, and that one thread at a time drains.
+//!
+//! Pushed elements are kept in a singly-linked list whose head is swapped
+//! atomically, so that a producer never waits for the consumer or another
+//! producer, only retrying if another push raced with its own.
+template <typename T>
+class LockFreeQueue {
+ public:
+  LockFreeQueue() : head_(nullptr) {}
+
+  LockFreeQueue(const LockFreeQueue&) = delete;
+  LockFreeQueue& operator=(const LockFreeQueue&) = delete;
+
+  ~LockFreeQueue() {
+    Node* node = head_.load(std::memory_order_acquire);
+    while (node) {
+      Node* next = node->next;
+      delete node;
+      node = next;
+    }
+  }
+
+  //! \brief Adds \a element to the back of the queue.
+  void Push(const T& element) {
+    Node* node = new Node{element, head_.load(std::memory_order_relaxed)};
+    while (!head_.compare_exchange_weak(node->next,
+                                        node,
+                                        std::memory_order_release,
+                                        std::memory_order_relaxed)) {
+    }
+  }
+
+  //! \brief Atomically empties the queue and returns its previous contents, in
+  //!     the order that they were pushed.
+  std::vector<T> Drain() {
+    std::vector<T> contents;
+    Node* node = head_.exchange(nullptr, std::memory_order_acquire);
+    while (node) {
+      contents.push_back(node->element);
+      Node* next = node->next;
+      delete node;
+      node = next;
+    }
+    std::reverse(contents.begin(), contents.end());
+    return contents;
+  }
+
+ private:
+  struct Node {
+    T element;
+    Node* next;
+  };
+
+  std::atomic<Node*> head_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_UTIL_STDLIB_LOCK_FREE_QUEUE_H_
@@ -0,0 +1,120 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/stdlib/lock_free_queue.h"
+
+#include <algorithm>
+#include <iterator>
+
+#include "gtest/gtest.h"
+#include "util/thread/thread.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+constexpr int kElementsPerThread = 100;
+
+class LockFreeQueueTestThread : public Thread {
+ public:
+  LockFreeQueueTestThread() : queue_(nullptr), start_(0) {}
+
+  LockFreeQueueTestThread(const LockFreeQueueTestThread&) = delete;
+  LockFreeQueueTestThread& operator=(const LockFreeQueueTestThread&) = delete;
+
+  ~LockFreeQueueTestThread() {}
+
+  void SetTestParameters(LockFreeQueue<int>* queue, int start) {
+    queue_ = queue;
+    start_ = start;
+  }
+
+  // Thread:
+  void ThreadMain() override {
+    for (int i = start_; i < start_ + kElementsPerThread; ++i) {
+      queue_->Push(i);
+    }
+  }
+
+ private:
+  LockFreeQueue<int>* queue_;
+  int start_;
+};
+
+TEST(LockFreeQueue, Order) {
+  LockFreeQueue<int> queue;
+  EXPECT_TRUE(queue.Drain().empty());
+
+  queue.Push(3);
+  queue.Push(1);
+  queue.Push(2);
+  EXPECT_EQ(queue.Drain(), (std::vector<int>{3, 1, 2}));
+  EXPECT_TRUE(queue.Drain().empty());
+
+  // Elements left in the queue are freed when it’s destroyed.
+  queue.Push(4);
+}
+
+TEST(LockFreeQueue, Threads) {
+  LockFreeQueue<int> queue;
+  std::vector<int> vector;
+
+  LockFreeQueueTestThread threads[100];
+  for (size_t index = 0; index < std::size(threads); ++index) {
+    threads[index].SetTestParameters(
+        &queue, static_cast<int>(index * kElementsPerThread));
+  }
+
+  for (size_t index = 0; index < std::size(threads); ++index) {
+    threads[index].Start();
+
+    if (index % 10 == 0) {
+      // Drain the queue periodically to test that simultaneous Drain() and
+      // Push() operations work properly.
+      std::vector<int> drained = queue.Drain();
+      vector.insert(vector.end(), drained.begin(), drained.end());
+    }
+  }
+
+  for (LockFreeQueueTestThread& thread : threads) {
+    thread.Join();
+  }
+
+  std::vector<int> drained = queue.Drain();
+  vector.insert(vector.end(), drained.begin(), drained.end());
+
+  // Each thread’s elements appear in the order that it pushed them.
+  for (size_t index = 0; index < std::size(threads); ++index) {
+    const int start = static_cast<int>(index * kElementsPerThread);
+    auto previous = std::find(vector.begin(), vector.end(), start);
+    ASSERT_NE(previous, vector.end());
+    for (int element = start + 1; element < start + kElementsPerThread;
+         ++element) {
+      auto current = std::find(vector.begin(), vector.end(), element);
+      ASSERT_NE(current, vector.end());
+      EXPECT_LT(previous, current);
+      previous = current;
+    }
+  }
+
+  std::sort(vector.begin(), vector.end());
+  ASSERT_EQ(vector.size(), std::size(threads) * kElementsPerThread);
+  for (size_t index = 0; index < vector.size(); ++index) {
+    EXPECT_EQ(vector[index], static_cast<int>(index));
+  }
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
@@ -0,0 +1,346 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Measures how long Base94OutputStream takes to encode and decode a buffer of
+// configurable size, and compares it to the scalar encoder and decoder that it
+// replaced, which are kept here for that purpose. Both implementations must
+// produce the same output, and the benchmark fails if they don’t.
+
+#include <getopt.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/files/file_path.h"
+#include "base/numerics/safe_conversions.h"
+#include "base/rand_util.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/stringprintf.h"
+#include "util/stream/base94_output_stream.h"
+#include "util/stream/output_stream_interface.h"
+
+namespace crashpad {
+namespace {
+
+constexpr uint16_t kMaxValueOf14BitEncoding = (94 * 94 - 1) & 0x1FFF;
+
+// The encoder that Base94OutputStream used before it was table-driven.
+std::vector<uint8_t> ReferenceEncode(const std::vector<uint8_t>& data) {
+  std::vector<uint8_t> encoded;
+  uint32_t bit_buf = 0;
+  size_t bit_count = 0;
+  for (uint8_t byte : data) {
+    bit_buf |= byte << bit_count;
+    bit_count += 8;
+    if (bit_count < 14)
+      continue;
+
+    uint16_t block;
+    if ((bit_buf & 0x1FFF) > kMaxValueOf14BitEncoding) {
+      block = bit_buf & 0x1FFF;
+      bit_buf >>= 13;
+      bit_count -= 13;
+    } else {
+      block = bit_buf & 0x3FFF;
+      bit_buf >>= 14;
+      bit_count -= 14;
+    }
+    encoded.push_back(block % 94 + '!');
+    encoded.push_back(base::saturated_cast<uint8_t>(block / 94) + '!');
+  }
+
+  if (bit_count > 0) {
+    encoded.push_back(bit_buf % 94 + '!');
+    if (bit_buf > 93 || bit_count > 8)
+      encoded.push_back(base::saturated_cast<uint8_t>(bit_buf / 94) + '!');
+  }
+  return encoded;
+}
+
+// The decoder that Base94OutputStream used before it was table-driven. The
+// input must be valid.
+std::vector<uint8_t> ReferenceDecode(const std::vector<uint8_t>& data) {
+  std::vector<uint8_t> decoded;
+  uint32_t bit_buf = 0;
+  size_t bit_count = 0;
+  uint8_t symbol_buffer = 0;
+  for (uint8_t symbol : data) {
+    if (symbol_buffer == 0) {
+      symbol_buffer = symbol;
+      continue;
+    }
+    uint16_t v = (symbol_buffer - '!') + (symbol - '!') * 94;
+    symbol_buffer = 0;
+    bit_buf |= v << bit_count;
+    bit_count += (v & 0x1FFF) > kMaxValueOf14BitEncoding ? 13 : 14;
+    while (bit_count > 7) {
+      decoded.push_back(bit_buf & 0xff);
+      bit_buf >>= 8;
+      bit_count -= 8;
+    }
+  }
+
+  if (symbol_buffer != 0) {
+    bit_buf |= (symbol_buffer - '!') << bit_count;
+    decoded.push_back(bit_buf & 0xff);
+  }
+  return decoded;
+}
+
+// Collects what’s written to it.
+class VectorOutputStream : public OutputStreamInterface {
+ public:
+  VectorOutputStream() : data_() {}
+
+  VectorOutputStream(const VectorOutputStream&) = delete;
+  VectorOutputStream& operator=(const VectorOutputStream&) = delete;
+
+  ~VectorOutputStream() override {}
+
+  bool Write(const uint8_t* data, size_t size) override {
+    data_.insert(data_.end(), data, data + size);
+    return true;
+  }
+
+  bool Flush() override { return true; }
+
+  std::vector<uint8_t>* data() { return &data_; }
+
+ private:
+  std::vector<uint8_t> data_;
+};
+
+// Passes data through a Base94OutputStream in mode, writing it in chunks of
+// chunk_size bytes as FileEncoder does.
+std::vector<uint8_t> Base94Process(Base94OutputStream::Mode mode,
+                                   const std::vector<uint8_t>& data,
+                                   size_t chunk_size) {
+  std::vector<uint8_t> result;
+  result.reserve(data.size() * 2);
+  auto output_stream = std::make_unique<VectorOutputStream>();
+  output_stream->data()->swap(result);
+  VectorOutputStream* output = output_stream.get();
+
+  Base94OutputStream base94(mode, std::move(output_stream));
+  for (size_t offset = 0; offset < data.size(); offset += chunk_size) {
+    if (!base94.Write(data.data() + offset,
+                      std::min(chunk_size, data.size() - offset))) {
+      return std::vector<uint8_t>();
+    }
+  }
+  base94.Flush();
+
+  output->data()->swap(result);
+  return result;
+}
+
+class Benchmark {
+ public:
+  Benchmark(const std::string& name, size_t bytes)
+      : name_(name), seconds_(), bytes_(bytes) {}
+
+  Benchmark(const Benchmark&) = delete;
+  Benchmark& operator=(const Benchmark&) = delete;
+
+  ~Benchmark() {}
+
+  void AddIteration(std::chrono::steady_clock::duration elapsed) {
+    seconds_.push_back(std::chrono::duration<double>(elapsed).count());
+  }
+
+  double Min() const {
+    return seconds_.empty() ? 0
+                            : *std::min_element(seconds_.begin(),
+                                                seconds_.end());
+  }
+
+  static void PrintHeader() {
+    printf("%-24s %12s %12s %14s\n", "Benchmark", "Mean", "Min", "Throughput");
+  }
+
+  void Print() const {
+    if (seconds_.empty()) {
+      return;
+    }
+
+    double total = 0;
+    for (double seconds : seconds_) {
+      total += seconds;
+    }
+    const double mean = total / seconds_.size();
+
+    std::string throughput;
+    if (bytes_ && mean > 0) {
+      throughput = base::StringPrintf("%.1f MB/s", bytes_ / mean / 1e6);
+    }
+
+    printf("%-24s %9.3f ms %9.3f ms %14s\n",
+           name_.c_str(),
+           mean * 1e3,
+           Min() * 1e3,
+           throughput.c_str());
+  }
+
+ private:
+  std::string name_;
+  std::vector<double> seconds_;
+  size_t bytes_;
+};
+
+// Times function, which returns its output, adding it to benchmark and storing
+// the last output in result.
+template <typename Function>
+void Measure(Benchmark* benchmark,
+             size_t iterations,
+             std::vector<uint8_t>* result,
+             Function function) {
+  for (size_t iteration = 0; iteration < iterations; ++iteration) {
+    auto start = std::chrono::steady_clock::now();
+    *result = function();
+    benchmark->AddIteration(std::chrono::steady_clock::now() - start);
+  }
+}
+
+void Usage(const std::string& me) {
+  // clang-format off
+  fprintf(stderr,
+"Usage: %s [OPTION]...\n"
+"Benchmark Base94 encoding and decoding against the scalar implementation.\n"
+"\n"
+"      --chunk-size=N  bytes passed to each Write() (default 4096)\n"
+"      --iterations=N  repetitions of each benchmark (default 20)\n"
+"      --size=N        bytes of random data to encode (default 4194304)\n"
+"      --help          display this help and exit\n",
+          me.c_str());
+  // clang-format on
+}
+
+int Base94BenchmarksMain(int argc, char* argv[]) {
+  const std::string me = base::FilePath(argv[0]).BaseName().value();
+
+  enum OptionFlags {
+    // Long options without short equivalents.
+    kOptionLastChar = 255,
+    kOptionChunkSize,
+    kOptionIterations,
+    kOptionSize,
+
+    // Standard options.
+    kOptionHelp = -2,
+  };
+
+  size_t chunk_size = 4096;
+  size_t iterations = 20;
+  size_t size = 4 * 1024 * 1024;
+
+  static constexpr option long_options[] = {
+      {"chunk-size", required_argument, nullptr, kOptionChunkSize},
+      {"iterations", required_argument, nullptr, kOptionIterations},
+      {"size", required_argument, nullptr, kOptionSize},
+      {"help", no_argument, nullptr, kOptionHelp},
+      {nullptr, 0, nullptr, 0},
+  };
+
+  int opt;
+  while ((opt = getopt_long(argc, argv, "", long_options, nullptr)) != -1) {
+    size_t* size_option = nullptr;
+    switch (opt) {
+      case kOptionChunkSize:
+        size_option = &chunk_size;
+        break;
+      case kOptionIterations:
+        size_option = &iterations;
+        break;
+      case kOptionSize:
+        size_option = &size;
+        break;
+      case kOptionHelp:
+        Usage(me);
+        return EXIT_SUCCESS;
+      default:
+        fprintf(stderr, "Try '%s --help' for more information.\n", me.c_str());
+        return EXIT_FAILURE;
+    }
+
+    if (size_option && !base::StringToSizeT(optarg, size_option)) {
+      fprintf(stderr, "%s: invalid number: %s\n", me.c_str(), optarg);
+      return EXIT_FAILURE;
+    }
+  }
+
+  if (optind != argc || chunk_size == 0) {
+    fprintf(stderr, "Try '%s --help' for more information.\n", me.c_str());
+    return EXIT_FAILURE;
+  }
+
+  std::vector<uint8_t> data(size);
+  base::RandBytes(data.data(), data.size());
+
+  Benchmark reference_encode("Encode/Reference", size);
+  Benchmark encode("Encode/Base94OutputStream", size);
+  std::vector<uint8_t> reference_encoded;
+  std::vector<uint8_t> encoded;
+  Measure(&reference_encode, iterations, &reference_encoded, [&data]() {
+    return ReferenceEncode(data);
+  });
+  Measure(&encode, iterations, &encoded, [&data, chunk_size]() {
+    return Base94Process(Base94OutputStream::Mode::kEncode, data, chunk_size);
+  });
+  if (encoded != reference_encoded) {
+    fprintf(stderr, "%s: encoded output differs\n", me.c_str());
+    return EXIT_FAILURE;
+  }
+
+  Benchmark reference_decode("Decode/Reference", encoded.size());
+  Benchmark decode("Decode/Base94OutputStream", encoded.size());
+  std::vector<uint8_t> reference_decoded;
+  std::vector<uint8_t> decoded;
+  Measure(&reference_decode, iterations, &reference_decoded, [&encoded]() {
+    return ReferenceDecode(encoded);
+  });
+  Measure(&decode, iterations, &decoded, [&encoded, chunk_size]() {
+    return Base94Process(
+        Base94OutputStream::Mode::kDecode, encoded, chunk_size);
+  });
+  if (decoded != data || reference_decoded != data) {
+    fprintf(stderr, "%s: decoded output differs\n", me.c_str());
+    return EXIT_FAILURE;
+  }
+
+  printf("size=%zu chunk_size=%zu\n\n", size, chunk_size);
+  Benchmark::PrintHeader();
+  reference_encode.Print();
+  encode.Print();
+  reference_decode.Print();
+  decode.Print();
+  printf("\nEncode speedup %.2fx, decode speedup %.2fx (minimum times)\n",
+         encode.Min() > 0 ? reference_encode.Min() / encode.Min() : 0,
+         decode.Min() > 0 ? reference_decode.Min() / decode.Min() : 0);
+
+  return EXIT_SUCCESS;
+}
+
+}  // namespace
+}  // namespace crashpad
+
+int main(int argc, char* argv[]) {
+  return crashpad::Base94BenchmarksMain(argc, argv);
+}
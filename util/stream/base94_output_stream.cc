@@ -30,17 +30,44 @@ namespace {
 // bit is 1, the 14-bit number doesn’t exceed the max value.
 constexpr uint16_t kMaxValueOf14BitEncoding = (94 * 94 - 1) & 0x1FFF;
 
-constexpr size_t kMaxBuffer = 4096;
+// Marks a byte that isn’t a symbol in kDecodeTable.
+constexpr uint8_t kInvalidSymbol = 0xff;
 
 inline uint8_t EncodeByte(uint8_t byte) {
   DCHECK(byte < 94);
   return (byte >= 94u) ? 0xff : (byte + '!');
 }
 
-inline uint8_t DecodeByte(uint8_t byte) {
-  DCHECK(byte >= '!' && byte <= '~');
-  return std::min(static_cast<uint8_t>(byte - '!'), static_cast<uint8_t>(94));
-}
+// The two symbols that encode each block, for every block that can be encoded
+// in two symbols, so that encoding needs neither division nor a branch on the
+// block’s value.
+struct EncodeTable {
+  constexpr EncodeTable() : symbols() {
+    for (size_t block = 0; block < 94 * 94; ++block) {
+      symbols[block][0] = static_cast<uint8_t>(block % 94 + '!');
+      symbols[block][1] = static_cast<uint8_t>(block / 94 + '!');
+    }
+  }
+
+  uint8_t symbols[94 * 94][2];
+};
+
+constexpr EncodeTable kEncodeTable;
+
+// The value of each symbol, or kInvalidSymbol.
+struct DecodeTable {
+  constexpr DecodeTable() : values() {
+    for (size_t byte = 0; byte < 256; ++byte) {
+      values[byte] = byte >= '!' && byte <= '~'
+                         ? static_cast<uint8_t>(byte - '!')
+                         : kInvalidSymbol;
+    }
+  }
+
+  uint8_t values[256];
+};
+
+constexpr DecodeTable kDecodeTable;
 
 }  // namespace
 
@@ -49,13 +76,13 @@ Base94OutputStream::Base94OutputStream(
     std::unique_ptr<OutputStreamInterface> output_stream)
     : mode_(mode),
       output_stream_(std::move(output_stream)),
+      buffer_(),
+      buffer_size_(0),
       bit_buf_(0),
       bit_count_(0),
       symbol_buffer_(0),
       flush_needed_(false),
-      flushed_(false) {
-  buffer_.reserve(kMaxBuffer);
-}
+      flushed_(false) {}
 
 Base94OutputStream::~Base94OutputStream() {
   DCHECK(!flush_needed_);
@@ -78,59 +105,125 @@ bool Base94OutputStream::Flush() {
 }
 
 bool Base94OutputStream::Encode(const uint8_t* data, size_t size) {
+  // Work on local copies of the state, which the compiler can keep in
+  // registers. Writes to buffer_ might otherwise alias the members.
+  uint64_t bit_buf = bit_buf_;
+  size_t bit_count = bit_count_;
   const uint8_t* cur = data;
-  while (size--) {
-    bit_buf_ |= *(cur++) << bit_count_;
-    bit_count_ += 8;
-    if (bit_count_ < 14)
-      continue;
-
-    uint16_t block;
-    // Check if 13-bit or 14-bit data should be encoded.
-    if ((bit_buf_ & 0x1FFF) > kMaxValueOf14BitEncoding) {
-      block = bit_buf_ & 0x1FFF;
-      bit_buf_ >>= 13;
-      bit_count_ -= 13;
+  const uint8_t* const end = data + size;
+  while (cur != end) {
+    // Take in as many whole bytes as fit, so that several blocks can be
+    // encoded before bit_buf must be refilled.
+    if (end - cur >= 8) {
+      // Fewer than 14 bits are held, so between six and seven bytes fit.
+      const size_t bytes = (63 - bit_count) / 8;
+      uint64_t word = 0;
+      for (size_t index = 0; index < 8; ++index) {
+        word |= static_cast<uint64_t>(cur[index]) << (index * 8);
+      }
+      bit_buf |= (word & ((uint64_t{1} << (bytes * 8)) - 1)) << bit_count;
+      bit_count += bytes * 8;
+      cur += bytes;
     } else {
-      block = bit_buf_ & 0x3FFF;
-      bit_buf_ >>= 14;
-      bit_count_ -= 14;
+      while (bit_count <= 56 && cur != end) {
+        bit_buf |= static_cast<uint64_t>(*(cur++)) << bit_count;
+        bit_count += 8;
+      }
     }
-    buffer_.push_back(EncodeByte(block % 94));
-    buffer_.push_back(EncodeByte(base::saturated_cast<uint8_t>(block / 94)));
 
-    if (buffer_.size() > kMaxBuffer - 2 && !WriteOutputStream())
-      return false;
+    // Each block produces two symbols, and at most four blocks are available.
+    if (buffer_size_ > kBufferSize - 8) {
+      bit_buf_ = bit_buf;
+      bit_count_ = bit_count;
+      if (!WriteOutputStream())
+        return false;
+    }
+    uint8_t* out = buffer_ + buffer_size_;
+    while (bit_count >= 14) {
+      // Check if 13-bit or 14-bit data should be encoded.
+      const size_t block_bits =
+          (bit_buf & 0x1FFF) > kMaxValueOf14BitEncoding ? 13 : 14;
+      const size_t block = bit_buf & ((1 << block_bits) - 1);
+      bit_buf >>= block_bits;
+      bit_count -= block_bits;
+
+      out[0] = kEncodeTable.symbols[block][0];
+      out[1] = kEncodeTable.symbols[block][1];
+      out += 2;
+    }
+    buffer_size_ = out - buffer_;
   }
+  bit_buf_ = bit_buf;
+  bit_count_ = bit_count;
   return WriteOutputStream();
 }
 
 bool Base94OutputStream::Decode(const uint8_t* data, size_t size) {
+  // As in Encode(), work on local copies of the state.
+  uint64_t bit_buf = bit_buf_;
+  size_t bit_count = bit_count_;
+  uint8_t* out = buffer_ + buffer_size_;
   const uint8_t* cur = data;
-  while (size--) {
-    if (DecodeByte(*cur) == 94) {
+  const uint8_t* const end = data + size;
+
+  // Decodes a pair of symbols whose values are first and second.
+  const auto decode_pair = [&bit_buf, &bit_count, &out](uint32_t first,
+                                                         uint32_t second) {
+    const uint32_t v = first + second * 94;
+    bit_buf |= static_cast<uint64_t>(v) << bit_count;
+    bit_count += (v & 0x1FFF) > kMaxValueOf14BitEncoding ? 13 : 14;
+    // At most 21 bits are held, from which two bytes can be taken.
+    while (bit_count > 7) {
+      *(out++) = bit_buf & 0xff;
+      bit_buf >>= 8;
+      bit_count -= 8;
+    }
+  };
+
+  // Continue a pair whose first symbol was given to the last call.
+  if (symbol_buffer_ != 0 && cur != end) {
+    const uint8_t value = kDecodeTable.values[*cur];
+    if (value == kInvalidSymbol) {
       LOG(ERROR) << "Decode: invalid input";
       return false;
     }
-    if (symbol_buffer_ == 0) {
-      symbol_buffer_ = *cur;
-      cur++;
-      continue;
-    }
-    uint16_t v = DecodeByte(symbol_buffer_) + DecodeByte(*cur) * 94;
-    cur++;
+    decode_pair(kDecodeTable.values[static_cast<uint8_t>(symbol_buffer_)],
+                value);
     symbol_buffer_ = 0;
-    bit_buf_ |= v << bit_count_;
-    bit_count_ += (v & 0x1FFF) > kMaxValueOf14BitEncoding ? 13 : 14;
-    while (bit_count_ > 7) {
-      buffer_.push_back(bit_buf_ & 0xff);
-      bit_buf_ >>= 8;
-      bit_count_ -= 8;
-    }
-    if (buffer_.size() > kMaxBuffer - 2) {
+    ++cur;
+  }
+
+  while (end - cur >= 2) {
+    if (out - buffer_ > static_cast<ptrdiff_t>(kBufferSize - 2)) {
+      buffer_size_ = out - buffer_;
       if (!WriteOutputStream())
         return false;
+      out = buffer_;
+    }
+
+    const uint8_t first = kDecodeTable.values[cur[0]];
+    const uint8_t second = kDecodeTable.values[cur[1]];
+    if (first == kInvalidSymbol || second == kInvalidSymbol) {
+      buffer_size_ = out - buffer_;
+      bit_buf_ = bit_buf;
+      bit_count_ = bit_count;
+      LOG(ERROR) << "Decode: invalid input";
+      return false;
+    }
+    decode_pair(first, second);
+    cur += 2;
+  }
+
+  buffer_size_ = out - buffer_;
+  bit_buf_ = bit_buf;
+  bit_count_ = bit_count;
+
+  if (cur != end) {
+    if (kDecodeTable.values[*cur] == kInvalidSymbol) {
+      LOG(ERROR) << "Decode: invalid input";
+      return false;
     }
+    symbol_buffer_ = *cur;
   }
   return WriteOutputStream();
 }
@@ -139,9 +232,10 @@ bool Base94OutputStream::FinishEncoding() {
   if (bit_count_ == 0)
     return true;
   // Up to 13 bits data is left over.
-  buffer_.push_back(EncodeByte(bit_buf_ % 94));
+  buffer_[buffer_size_++] = EncodeByte(bit_buf_ % 94);
   if (bit_buf_ > 93 || bit_count_ > 8)
-    buffer_.push_back(EncodeByte(base::saturated_cast<uint8_t>(bit_buf_ / 94)));
+    buffer_[buffer_size_++] =
+        EncodeByte(base::saturated_cast<uint8_t>(bit_buf_ / 94));
   bit_count_ = 0;
   bit_buf_ = 0;
   return WriteOutputStream();
@@ -154,8 +248,10 @@ bool Base94OutputStream::FinishDecoding() {
     DCHECK(!bit_buf_);
     return true;
   }
-  bit_buf_ |= DecodeByte(symbol_buffer_) << bit_count_;
-  buffer_.push_back(bit_buf_ & 0xff);
+  bit_buf_ |= static_cast<uint64_t>(
+                  kDecodeTable.values[static_cast<uint8_t>(symbol_buffer_)])
+              << bit_count_;
+  buffer_[buffer_size_++] = bit_buf_ & 0xff;
   bit_buf_ >>= 8;
   // The remaining bits are either encode padding or zeros from bit shift.
   DCHECK(!bit_buf_);
@@ -163,11 +259,11 @@ bool Base94OutputStream::FinishDecoding() {
 }
 
 bool Base94OutputStream::WriteOutputStream() {
-  if (buffer_.empty())
+  if (buffer_size_ == 0)
     return true;
 
-  bool result = output_stream_->Write(buffer_.data(), buffer_.size());
-  buffer_.clear();
+  bool result = output_stream_->Write(buffer_, buffer_size_);
+  buffer_size_ = 0;
   return result;
 }
 
@@ -19,7 +19,6 @@
 #include <stdint.h>
 
 #include <memory>
-#include <vector>
 
 #include "util/stream/output_stream_interface.h"
 
@@ -64,10 +63,14 @@ class Base94OutputStream : public OutputStreamInterface {
   // Write encoded/decoded data to |output_stream_| and empty the |buffer_|.
   bool WriteOutputStream();
 
+  static constexpr size_t kBufferSize = 4096;
+
   Mode mode_;
   std::unique_ptr<OutputStreamInterface> output_stream_;
-  std::vector<uint8_t> buffer_;
-  uint32_t bit_buf_;
+  uint8_t buffer_[kBufferSize];
+  // The number of bytes in buffer_.
+  size_t buffer_size_;
+  uint64_t bit_buf_;
   // The number of valid bit in bit_buf_.
   size_t bit_count_;
   char symbol_buffer_;
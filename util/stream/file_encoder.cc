@@ -29,8 +29,12 @@ namespace crashpad {
 
 FileEncoder::FileEncoder(Mode mode,
                          const base::FilePath& input_path,
-                         const base::FilePath& output_path)
-    : mode_(mode), input_path_(input_path), output_path_(output_path) {}
+                         const base::FilePath& output_path,
+                         unsigned int compression_threads)
+    : mode_(mode),
+      input_path_(input_path),
+      output_path_(output_path),
+      compression_threads_(compression_threads) {}
 
 FileEncoder::~FileEncoder() {}
 
@@ -50,7 +54,8 @@ bool FileEncoder::Process() {
         ZlibOutputStream::Mode::kCompress,
         std::make_unique<Base94OutputStream>(
             Base94OutputStream::Mode::kEncode,
-            std::make_unique<FileOutputStream>(write_handle.get())));
+            std::make_unique<FileOutputStream>(write_handle.get())),
+        compression_threads_);
   } else {
     output = std::make_unique<Base94OutputStream>(
         Base94OutputStream::Mode::kDecode,
@@ -34,9 +34,12 @@ class FileEncoder {
   //! \param[in] mode The work mode of this object.
   //! \param[in] input_path The input file that this object reads from.
   //! \param[in] output_path The output file that this object writes to.
+  //! \param[in] compression_threads The number of threads to compress on in
+  //!     Mode::kEncode. See ZlibOutputStream.
   FileEncoder(Mode mode,
               const base::FilePath& input_path,
-              const base::FilePath& output_path);
+              const base::FilePath& output_path,
+              unsigned int compression_threads = 1);
 
   FileEncoder(const FileEncoder&) = delete;
   FileEncoder& operator=(const FileEncoder&) = delete;
@@ -53,6 +56,7 @@ class FileEncoder {
   Mode mode_;
   base::FilePath input_path_;
   base::FilePath output_path_;
+  unsigned int compression_threads_;
 };
 
 }  // namespace crashpad
@@ -20,15 +20,58 @@
 
 #include "base/check.h"
 #include "base/logging.h"
+#include "base/strings/stringprintf.h"
+#include "third_party/zlib/zlib_crashpad.h"
+#include "util/misc/clock.h"
 
 namespace crashpad {
 
-LogOutputStream::LogOutputStream(std::unique_ptr<Delegate> delegate)
+namespace {
+
+// In Mode::kChunks, a write the log rejects with -EAGAIN is retried this many
+// times, waiting twice as long before each retry as before the last, for
+// about a quarter of a second in all.
+constexpr int kMaxRetries = 8;
+constexpr uint64_t kInitialRetryDelayNs = 1000000;
+
+uint32_t ChunkChecksum(const char* data, size_t size) {
+  return static_cast<uint32_t>(crc32(crc32(0, nullptr, 0),
+                                     reinterpret_cast<const Bytef*>(data),
+                                     static_cast<uInt>(size)));
+}
+
+// Parses the eight lowercase hexadecimal digits at string.
+bool ParseHex32(const char* string, uint32_t* value) {
+  uint32_t result = 0;
+  for (size_t index = 0; index < 8; ++index) {
+    const char c = string[index];
+    uint32_t digit;
+    if (c >= '0' && c <= '9') {
+      digit = c - '0';
+    } else if (c >= 'a' && c <= 'f') {
+      digit = c - 'a' + 10;
+    } else {
+      return false;
+    }
+    result = (result << 4) | digit;
+  }
+  *value = result;
+  return true;
+}
+
+}  // namespace
+
+LogOutputStream::LogOutputStream(std::unique_ptr<Delegate> delegate, Mode mode)
     : delegate_(std::move(delegate)),
+      mode_(mode),
       output_count_(0),
+      pacing_delay_ns_(0),
+      sequence_(0),
       flush_needed_(false),
       flushed_(false) {
-  buffer_.reserve(delegate_->LineWidth());
+  DCHECK(mode_ == Mode::kLines ||
+         delegate_->LineWidth() > kChunkHeaderSize);
+  buffer_.reserve(DataWidth());
 }
 
 LogOutputStream::~LogOutputStream() {
@@ -39,17 +82,22 @@ bool LogOutputStream::Write(const uint8_t* data, size_t size) {
   DCHECK(!flushed_);
 
   static constexpr char kBeginMessage[] = "-----BEGIN CRASHPAD MINIDUMP-----";
-  if (output_count_ == 0 && WriteToLog(kBeginMessage) < 0) {
+  static constexpr char kBeginChunksMessage[] =
+      "-----BEGIN CRASHPAD MINIDUMP CHUNKS-----";
+  if (output_count_ == 0 && !flush_needed_ &&
+      WriteToLog(mode_ == Mode::kChunks ? kBeginChunksMessage
+                                        : kBeginMessage) < 0) {
     return false;
   }
 
   flush_needed_ = true;
+  const size_t data_width = DataWidth();
   while (size > 0) {
-    size_t m = std::min(delegate_->LineWidth() - buffer_.size(), size);
+    size_t m = std::min(data_width - buffer_.size(), size);
     buffer_.append(reinterpret_cast<const char*>(data), m);
     data += m;
     size -= m;
-    if (buffer_.size() == delegate_->LineWidth() && !WriteBuffer()) {
+    if (buffer_.size() == data_width && !WriteBuffer()) {
       return false;
     }
   }
@@ -69,7 +117,18 @@ bool LogOutputStream::WriteBuffer() {
     return false;
   }
 
-  int result = WriteToLog(buffer_.c_str());
+  int result;
+  if (mode_ == Mode::kChunks) {
+    const std::string chunk =
+        base::StringPrintf("%08x%08x",
+                           sequence_,
+                           ChunkChecksum(buffer_.data(), buffer_.size())) +
+        buffer_;
+    result = WriteToLog(chunk.c_str());
+    ++sequence_;
+  } else {
+    result = WriteToLog(buffer_.c_str());
+  }
   if (result < 0) {
     if (result == -EAGAIN) {
       WriteToLog(kAbortMessage);
@@ -83,7 +142,38 @@ bool LogOutputStream::WriteBuffer() {
 }
 
 int LogOutputStream::WriteToLog(const char* buf) {
-  return delegate_->Log(buf);
+  return mode_ == Mode::kChunks ? WriteToLogWithBackoff(buf)
+                                : delegate_->Log(buf);
+}
+
+int LogOutputStream::WriteToLogWithBackoff(const char* buf) {
+  if (pacing_delay_ns_ > 0) {
+    SleepNanoseconds(pacing_delay_ns_);
+  }
+
+  uint64_t delay_ns = kInitialRetryDelayNs;
+  int result = delegate_->Log(buf);
+  for (int retry = 0; result == -EAGAIN && retry < kMaxRetries; ++retry) {
+    SleepNanoseconds(delay_ns);
+    result = delegate_->Log(buf);
+    if (result >= 0) {
+      // The log needed this long to make room, so wait as long before each of
+      // the following writes, until they succeed on their own.
+      pacing_delay_ns_ = std::max(pacing_delay_ns_, delay_ns);
+      return result;
+    }
+    delay_ns *= 2;
+  }
+
+  if (result >= 0) {
+    pacing_delay_ns_ /= 2;
+  }
+  return result;
+}
+
+size_t LogOutputStream::DataWidth() const {
+  return mode_ == Mode::kChunks ? delegate_->LineWidth() - kChunkHeaderSize
+                                : delegate_->LineWidth();
 }
 
 bool LogOutputStream::Flush() {
@@ -93,11 +183,40 @@ bool LogOutputStream::Flush() {
     flushed_ = true;
 
     static constexpr char kEndMessage[] = "-----END CRASHPAD MINIDUMP-----";
-    if (!WriteBuffer() || WriteToLog(kEndMessage) < 0) {
+    if (!WriteBuffer()) {
       result = false;
+    } else if (mode_ == Mode::kChunks) {
+      const std::string end_message = base::StringPrintf(
+          "-----END CRASHPAD MINIDUMP CHUNKS %08x-----", sequence_);
+      result = WriteToLog(end_message.c_str()) >= 0;
+    } else {
+      result = WriteToLog(kEndMessage) >= 0;
     }
   }
   return result;
 }
 
+// static
+bool LogOutputStream::ParseChunk(const std::string& message,
+                                 uint32_t* sequence,
+                                 std::string* data) {
+  uint32_t checksum;
+  if (message.size() < kChunkHeaderSize ||
+      !ParseHex32(message.data(), sequence) ||
+      !ParseHex32(message.data() + 8, &checksum)) {
+    LOG(ERROR) << "invalid chunk header";
+    return false;
+  }
+
+  const char* chunk_data = message.data() + kChunkHeaderSize;
+  const size_t chunk_size = message.size() - kChunkHeaderSize;
+  if (ChunkChecksum(chunk_data, chunk_size) != checksum) {
+    LOG(ERROR) << "chunk " << *sequence << " checksum mismatch";
+    return false;
+  }
+
+  data->assign(chunk_data, chunk_size);
+  return true;
+}
+
 }  // namespace crashpad
@@ -26,8 +26,37 @@
 namespace crashpad {
 
 //! \brief This class outputs a stream of data as a series of log messages.
+//!
+//! The messages are bracketed by begin and end markers. If the output cap is
+//! reached or the log reports `-EAGAIN`, an abort marker is written and the
+//! output is abandoned.
+//!
+//! In Mode::kChunks, each message after the begin marker is a chunk,
+//! consisting of a kChunkHeaderSize-character header followed by the data. The
+//! header holds the chunk’s sequence number, starting at 0, and the CRC-32 of
+//! its data, each as eight lowercase hexadecimal digits. The end marker
+//! records the number of chunks written. A tool reassembling the output can
+//! use these to put chunks back in order, drop duplicates and corrupted
+//! chunks, and tell exactly which chunks the log lost. Chunks are meant to be
+//! much larger than lines. When the log reports `-EAGAIN`, the write is
+//! retried after a delay, and later writes are paced until the log keeps up.
 class LogOutputStream : public OutputStreamInterface {
  public:
+  //! \brief The format of the messages written.
+  enum class Mode {
+    //! \brief Data is written as it is, in messages of up to
+    //!     Delegate::LineWidth() bytes.
+    kLines,
+
+    //! \brief Data is written in numbered, checksummed chunks of up to
+    //!     Delegate::LineWidth() bytes, including their headers.
+    kChunks,
+  };
+
+  //! \brief The size of the header at the start of each chunk written in
+  //!     Mode::kChunks.
+  static constexpr size_t kChunkHeaderSize = 16;
+
   //! \brief An interface to a log output sink.
   class Delegate {
    public:
@@ -49,7 +78,10 @@ class LogOutputStream : public OutputStreamInterface {
     virtual size_t LineWidth() = 0;
   };
 
-  explicit LogOutputStream(std::unique_ptr<Delegate> delegate);
+  //! \param[in] delegate The log output sink.
+  //! \param[in] mode The format of the messages written to \a delegate.
+  explicit LogOutputStream(std::unique_ptr<Delegate> delegate,
+                           Mode mode = Mode::kLines);
 
   LogOutputStream(const LogOutputStream&) = delete;
   LogOutputStream& operator=(const LogOutputStream&) = delete;
@@ -60,15 +92,37 @@ class LogOutputStream : public OutputStreamInterface {
   bool Write(const uint8_t* data, size_t size) override;
   bool Flush() override;
 
+  //! \brief Parses a chunk written in Mode::kChunks.
+  //!
+  //! \param[in] message A message written between the begin and end markers.
+  //! \param[out] sequence The chunk’s sequence number.
+  //! \param[out] data The chunk’s data.
+  //!
+  //! \return `true` on success. `false` if \a message isn’t a chunk or its
+  //!     data doesn’t match its checksum, with a message logged.
+  static bool ParseChunk(const std::string& message,
+                         uint32_t* sequence,
+                         std::string* data);
+
  private:
   // Flushes buffer_, returning false on failure.
   bool WriteBuffer();
 
   int WriteToLog(const char* buf);
 
+  // Writes buf, retrying with increasing delays while the log reports -EAGAIN,
+  // and pacing later writes according to how long that took.
+  int WriteToLogWithBackoff(const char* buf);
+
+  // The largest amount of data written in a single message.
+  size_t DataWidth() const;
+
   std::string buffer_;
   std::unique_ptr<Delegate> delegate_;
+  Mode mode_;
   size_t output_count_;
+  uint64_t pacing_delay_ns_;
+  uint32_t sequence_;
   bool flush_needed_;
   bool flushed_;
 };
@@ -14,9 +14,12 @@
 
 #include "util/stream/log_output_stream.h"
 
+#include <errno.h>
+
 #include <algorithm>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "gtest/gtest.h"
 
@@ -120,6 +123,111 @@ TEST_F(LogOutputStreamTest, FlushAbort) {
       kAbortGuard);
 }
 
+constexpr size_t kChunkWidth = 256;
+
+class LogOutputStreamChunkTestDelegate final
+    : public LogOutputStream::Delegate {
+ public:
+  LogOutputStreamChunkTestDelegate(std::vector<std::string>* messages,
+                                   int rejections)
+      : messages_(messages), rejections_(rejections) {}
+  ~LogOutputStreamChunkTestDelegate() override = default;
+
+  int Log(const char* buf) override {
+    // Reject every other attempt while rejections remain, like a log that is
+    // struggling to keep up.
+    if (rejections_ > 0 && messages_->size() % 2 == 1) {
+      --rejections_;
+      return -EAGAIN;
+    }
+    messages_->push_back(buf);
+    EXPECT_LE(messages_->back().size(), kChunkWidth);
+    return static_cast<int>(messages_->back().size());
+  }
+
+  size_t OutputCap() override { return kOutputCap; }
+  size_t LineWidth() override { return kChunkWidth; }
+
+ private:
+  std::vector<std::string>* messages_;
+  int rejections_;
+};
+
+std::string ChunkTestInput(size_t size) {
+  std::string input;
+  for (size_t index = 0; index < size; ++index) {
+    input.push_back(static_cast<char>('!' + index % 94));
+  }
+  return input;
+}
+
+// Writes input in Mode::kChunks, returning the messages written.
+std::vector<std::string> WriteChunks(const std::string& input,
+                                     int rejections) {
+  std::vector<std::string> messages;
+  LogOutputStream stream(std::make_unique<LogOutputStreamChunkTestDelegate>(
+                             &messages, rejections),
+                         LogOutputStream::Mode::kChunks);
+  // Write in pieces that don’t line up with chunks.
+  for (size_t offset = 0; offset < input.size(); offset += 100) {
+    const size_t size = std::min<size_t>(100, input.size() - offset);
+    EXPECT_TRUE(stream.Write(
+        reinterpret_cast<const uint8_t*>(input.data() + offset), size));
+  }
+  EXPECT_TRUE(stream.Flush());
+  return messages;
+}
+
+TEST(LogOutputStreamChunks, WriteChunks) {
+  constexpr size_t kDataWidth = kChunkWidth - LogOutputStream::kChunkHeaderSize;
+  const std::string input = ChunkTestInput(kDataWidth * 3 + kDataWidth / 2);
+  const std::vector<std::string> messages = WriteChunks(input, 0);
+
+  ASSERT_EQ(messages.size(), 6u);
+  EXPECT_EQ(messages.front(), "-----BEGIN CRASHPAD MINIDUMP CHUNKS-----");
+  EXPECT_EQ(messages.back(), "-----END CRASHPAD MINIDUMP CHUNKS 00000004-----");
+
+  std::string output;
+  for (size_t index = 1; index < messages.size() - 1; ++index) {
+    uint32_t sequence;
+    std::string data;
+    ASSERT_TRUE(LogOutputStream::ParseChunk(messages[index], &sequence, &data));
+    EXPECT_EQ(sequence, index - 1);
+    EXPECT_EQ(data.size(), index < 4 ? kDataWidth : kDataWidth / 2);
+    output.append(data);
+  }
+  EXPECT_EQ(output, input);
+}
+
+TEST(LogOutputStreamChunks, ParseCorruptChunk) {
+  const std::vector<std::string> messages = WriteChunks(ChunkTestInput(10), 0);
+  ASSERT_EQ(messages.size(), 3u);
+
+  uint32_t sequence;
+  std::string data;
+  ASSERT_TRUE(LogOutputStream::ParseChunk(messages[1], &sequence, &data));
+  EXPECT_EQ(sequence, 0u);
+  EXPECT_EQ(data, ChunkTestInput(10));
+
+  std::string corrupt = messages[1];
+  ++corrupt.back();
+  EXPECT_FALSE(LogOutputStream::ParseChunk(corrupt, &sequence, &data));
+
+  EXPECT_FALSE(LogOutputStream::ParseChunk(
+      messages[1].substr(0, LogOutputStream::kChunkHeaderSize - 1),
+      &sequence,
+      &data));
+  EXPECT_FALSE(LogOutputStream::ParseChunk(messages[0], &sequence, &data));
+}
+
+TEST(LogOutputStreamChunks, RetryWhenLogIsFull) {
+  const std::string input = ChunkTestInput(kChunkWidth * 4);
+  const std::vector<std::string> expected = WriteChunks(input, 0);
+
+  // Rejected writes are retried, so nothing is lost.
+  EXPECT_EQ(WriteChunks(input, 3), expected);
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace crashpad
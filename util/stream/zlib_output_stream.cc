@@ -14,9 +14,11 @@
 
 #include "util/stream/zlib_output_stream.h"
 
+#include <algorithm>
 #include <iterator>
 
 #include "base/check.h"
+#include "base/check_op.h"
 #include "base/logging.h"
 #include "base/numerics/safe_conversions.h"
 #include "util/misc/zlib.h"
@@ -25,11 +27,18 @@ namespace crashpad {
 
 ZlibOutputStream::ZlibOutputStream(
     Mode mode,
-    std::unique_ptr<OutputStreamInterface> output_stream)
+    std::unique_ptr<OutputStreamInterface> output_stream,
+    unsigned int compression_threads)
     : output_stream_(std::move(output_stream)),
+      deflater_(),
+      parallel_input_(),
+      parallel_output_(),
       mode_(mode),
+      compression_threads_(compression_threads),
       initialized_(),
-      flush_needed_(false) {}
+      flush_needed_(false) {
+  DCHECK_GE(compression_threads_, 1u);
+}
 
 ZlibOutputStream::~ZlibOutputStream() {
   if (!initialized_.is_valid())
@@ -45,6 +54,31 @@ ZlibOutputStream::~ZlibOutputStream() {
 }
 
 bool ZlibOutputStream::Write(const uint8_t* data, size_t size) {
+  if (mode_ == Mode::kCompress && compression_threads_ > 1) {
+    if (!deflater_) {
+      deflater_ = std::make_unique<ParallelDeflater>(
+          ParallelDeflater::Format::kZlib,
+          Z_BEST_COMPRESSION,
+          compression_threads_);
+      parallel_input_.reserve(deflater_->BatchSize());
+    }
+
+    flush_needed_ = true;
+    while (size > 0) {
+      const size_t m =
+          std::min(deflater_->BatchSize() - parallel_input_.size(), size);
+      parallel_input_.insert(parallel_input_.end(), data, data + m);
+      data += m;
+      size -= m;
+      if (parallel_input_.size() == deflater_->BatchSize() &&
+          !WriteParallel(false)) {
+        flush_needed_ = false;
+        return false;
+      }
+    }
+    return true;
+  }
+
   if (initialized_.is_uninitialized()) {
     initialized_.set_invalid();
 
@@ -103,6 +137,15 @@ bool ZlibOutputStream::Write(const uint8_t* data, size_t size) {
 }
 
 bool ZlibOutputStream::Flush() {
+  if (deflater_) {
+    if (flush_needed_) {
+      flush_needed_ = false;
+      if (!WriteParallel(true))
+        return false;
+    }
+    return output_stream_->Flush();
+  }
+
   if (initialized_.is_valid() && flush_needed_) {
     flush_needed_ = false;
     int result = Z_OK;
@@ -119,6 +162,12 @@ bool ZlibOutputStream::Flush() {
           LOG(ERROR) << "inflate: " << zlib_stream_.msg;
           return false;
         }
+        // With output space remaining, Z_BUF_ERROR means that all input was
+        // consumed without reaching the end of the stream.
+        if (result == Z_BUF_ERROR && zlib_stream_.avail_out > 0) {
+          LOG(ERROR) << "inflate: truncated input";
+          return false;
+        }
       }
       if (!WriteOutputStream())
         return false;
@@ -138,4 +187,18 @@ bool ZlibOutputStream::WriteOutputStream() {
   return true;
 }
 
+bool ZlibOutputStream::WriteParallel(bool finish) {
+  parallel_output_.clear();
+  if (!deflater_->Compress(parallel_input_.data(),
+                           parallel_input_.size(),
+                           finish,
+                           &parallel_output_)) {
+    return false;
+  }
+  parallel_input_.clear();
+  return parallel_output_.empty() ||
+         output_stream_->Write(parallel_output_.data(),
+                               parallel_output_.size());
+}
+
 }  // namespace crashpad
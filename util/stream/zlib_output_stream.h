@@ -19,9 +19,11 @@
 #include <stdint.h>
 
 #include <memory>
+#include <vector>
 
 #include "third_party/zlib/zlib_crashpad.h"
 #include "util/misc/initialization_state.h"
+#include "util/misc/parallel_deflater.h"
 #include "util/stream/output_stream_interface.h"
 
 namespace crashpad {
@@ -39,6 +41,9 @@ class ZlibOutputStream : public OutputStreamInterface {
 
   //! \param[in] mode The work mode of this object.
   //! \param[in] output_stream The output_stream that this object writes to.
+  //! \param[in] compression_threads The number of threads to compress on in
+  //!     Mode::kCompress. With more than `1`, data is compressed in batches by
+  //!     a ParallelDeflater, which produces slightly larger output.
   //!
   //! To construct an output pipeline, the output stream needs an output stream
   //! to write the result to. For example, the code below constructs a
@@ -54,7 +59,8 @@ class ZlibOutputStream : public OutputStreamInterface {
   //!
   //!
   ZlibOutputStream(Mode mode,
-                   std::unique_ptr<OutputStreamInterface> output_stream);
+                   std::unique_ptr<OutputStreamInterface> output_stream,
+                   unsigned int compression_threads = 1);
 
   ZlibOutputStream(const ZlibOutputStream&) = delete;
   ZlibOutputStream& operator=(const ZlibOutputStream&) = delete;
@@ -70,10 +76,21 @@ class ZlibOutputStream : public OutputStreamInterface {
   // buffer in |zlib_stream_|.
   bool WriteOutputStream();
 
+  // Compresses parallel_input_ with deflater_ and writes the result to
+  // |output_stream_|.
+  bool WriteParallel(bool finish);
+
   uint8_t buffer_[4096];
   z_stream zlib_stream_;
   std::unique_ptr<OutputStreamInterface> output_stream_;
+
+  // Used instead of zlib_stream_ to compress on more than one thread.
+  std::unique_ptr<ParallelDeflater> deflater_;
+  std::vector<uint8_t> parallel_input_;
+  std::vector<uint8_t> parallel_output_;
+
   Mode mode_;
+  const unsigned int compression_threads_;
   InitializationState initialized_;  // protects zlib_stream_
   bool flush_needed_;
 };
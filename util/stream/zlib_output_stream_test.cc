@@ -18,6 +18,7 @@
 
 #include <algorithm>
 #include <iterator>
+#include <vector>
 
 #include "base/rand_util.h"
 #include "base/strings/stringprintf.h"
@@ -182,6 +183,50 @@ TEST_F(ZlibOutputStreamTest, WriteEmptyData) {
   EXPECT_TRUE(test_output_stream().all_data().empty());
 }
 
+TEST(ZlibOutputStream, DecompressTruncatedInput) {
+  std::vector<uint8_t> input(kLongDataLength);
+  for (size_t index = 0; index < input.size(); ++index) {
+    input[index] = static_cast<uint8_t>(index);
+  }
+
+  auto compressed_output_stream = std::make_unique<TestOutputStream>();
+  const TestOutputStream& compressed = *compressed_output_stream;
+  ZlibOutputStream compressor(ZlibOutputStream::Mode::kCompress,
+                              std::move(compressed_output_stream));
+  ASSERT_TRUE(compressor.Write(input.data(), input.size()));
+  ASSERT_TRUE(compressor.Flush());
+  ASSERT_GT(compressed.all_data().size(), 2u);
+
+  ZlibOutputStream decompressor(ZlibOutputStream::Mode::kDecompress,
+                                std::make_unique<TestOutputStream>());
+  EXPECT_TRUE(decompressor.Write(compressed.all_data().data(),
+                                 compressed.all_data().size() / 2));
+  EXPECT_FALSE(decompressor.Flush());
+}
+
+TEST(ZlibOutputStream, CompressionThreads) {
+  // More than one batch, ending partway through a block.
+  std::vector<uint8_t> input(ParallelDeflater::kBlockSize * 9 + 1000);
+  for (size_t index = 0; index < input.size(); ++index) {
+    input[index] = static_cast<uint8_t>((index % 256) ^ ((index >> 8) % 256));
+  }
+
+  auto test_output_stream = std::make_unique<TestOutputStream>();
+  const TestOutputStream& output = *test_output_stream;
+  auto compressed_output_stream = std::make_unique<TestOutputStream>();
+  ZlibOutputStream compressor(
+      ZlibOutputStream::Mode::kCompress,
+      std::make_unique<ZlibOutputStream>(ZlibOutputStream::Mode::kDecompress,
+                                         std::move(test_output_stream)),
+      4);
+  for (size_t offset = 0; offset < input.size(); offset += 4096) {
+    ASSERT_TRUE(compressor.Write(
+        &input[offset], std::min<size_t>(4096, input.size() - offset)));
+  }
+  ASSERT_TRUE(compressor.Flush());
+  EXPECT_EQ(output.all_data(), input);
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace crashpad
@@ -14,8 +14,12 @@
 
 #include "util/thread/thread_log_messages.h"
 
+#include <stdint.h>
+#include <string.h>
 #include <sys/types.h>
 
+#include <algorithm>
+
 #include "base/check_op.h"
 #include "base/logging.h"
 #include "base/threading/thread_local_storage.h"
@@ -24,9 +28,14 @@ namespace crashpad {
 
 namespace {
 
+// Each message in the buffer is preceded by its length.
+using MessageLength = uint32_t;
+
+}  // namespace
+
 // While an object of this class exists, it will be set as the log message
-// handler. A thread may register its thread-specific log message list to
-// receive messages produced just on that thread.
+// handler. A thread may register its ThreadLogMessages object to receive
+// messages produced just on that thread.
 //
 // Only one object of this class may exist in the program at a time as created
 // by GetInstance(). There must not be any log message handler in effect when it
@@ -37,10 +46,10 @@ class ThreadLogMessagesMaster {
   ThreadLogMessagesMaster(const ThreadLogMessagesMaster&) = delete;
   ThreadLogMessagesMaster& operator=(const ThreadLogMessagesMaster&) = delete;
 
-  void SetThreadMessageList(std::vector<std::string>* message_list) {
+  void SetThreadLogMessages(ThreadLogMessages* thread_log_messages) {
     DCHECK_EQ(logging::GetLogMessageHandler(), &LogMessageHandler);
-    DCHECK_NE(tls_.Get() != nullptr, message_list != nullptr);
-    tls_.Set(message_list);
+    DCHECK_NE(tls_.Get() != nullptr, thread_log_messages != nullptr);
+    tls_.Set(thread_log_messages);
   }
 
   static ThreadLogMessagesMaster* GetInstance() {
@@ -61,10 +70,10 @@ class ThreadLogMessagesMaster {
                                 int line,
                                 size_t message_start,
                                 const std::string& string) {
-    std::vector<std::string>* log_messages =
-        reinterpret_cast<std::vector<std::string>*>(GetInstance()->tls_.Get());
-    if (log_messages) {
-      log_messages->push_back(string);
+    ThreadLogMessages* thread_log_messages =
+        reinterpret_cast<ThreadLogMessages*>(GetInstance()->tls_.Get());
+    if (thread_log_messages) {
+      thread_log_messages->AppendMessage(string.data(), string.size());
     }
 
     // Don’t consume the message. Allow it to be logged as if nothing was set as
@@ -75,14 +84,98 @@ class ThreadLogMessagesMaster {
   base::ThreadLocalStorage::Slot tls_;
 };
 
-}  // namespace
-
-ThreadLogMessages::ThreadLogMessages() : log_messages_() {
-  ThreadLogMessagesMaster::GetInstance()->SetThreadMessageList(&log_messages_);
+ThreadLogMessages::ThreadLogMessages(size_t buffer_size)
+    : buffer_(new char[buffer_size]),
+      buffer_size_(buffer_size),
+      begin_(0),
+      size_(0),
+      message_count_(0),
+      dropped_message_count_(0) {
+  DCHECK_GT(buffer_size_, sizeof(MessageLength));
+  ThreadLogMessagesMaster::GetInstance()->SetThreadLogMessages(this);
 }
 
 ThreadLogMessages::~ThreadLogMessages() {
-  ThreadLogMessagesMaster::GetInstance()->SetThreadMessageList(nullptr);
+  ThreadLogMessagesMaster::GetInstance()->SetThreadLogMessages(nullptr);
+}
+
+std::vector<std::string> ThreadLogMessages::log_messages() const {
+  std::vector<std::string> log_messages;
+  log_messages.reserve(message_count_);
+  ForEachMessage([this, &log_messages](size_t offset, size_t length) {
+    log_messages.emplace_back(length, '\0');
+    CopyOut(offset, &log_messages.back()[0], length);
+  });
+  return log_messages;
+}
+
+std::string ThreadLogMessages::LogText() const {
+  std::string log_text(size_ - message_count_ * sizeof(MessageLength), '\0');
+  size_t text_offset = 0;
+  ForEachMessage([this, &log_text, &text_offset](size_t offset, size_t length) {
+    CopyOut(offset, &log_text[text_offset], length);
+    text_offset += length;
+  });
+  DCHECK_EQ(text_offset, log_text.size());
+  return log_text;
+}
+
+void ThreadLogMessages::AppendMessage(const char* message, size_t length) {
+  length = std::min(length, buffer_size_ - sizeof(MessageLength));
+  const size_t record_size = sizeof(MessageLength) + length;
+  while (buffer_size_ - size_ < record_size) {
+    DropOldestMessage();
+  }
+
+  const MessageLength message_length = static_cast<MessageLength>(length);
+  CopyIn(&message_length, sizeof(message_length));
+  CopyIn(message, length);
+  ++message_count_;
+}
+
+void ThreadLogMessages::DropOldestMessage() {
+  DCHECK_GT(message_count_, 0u);
+  MessageLength message_length;
+  CopyOut(0, &message_length, sizeof(message_length));
+  const size_t record_size = sizeof(message_length) + message_length;
+  begin_ = (begin_ + record_size) % buffer_size_;
+  size_ -= record_size;
+  --message_count_;
+  ++dropped_message_count_;
+}
+
+void ThreadLogMessages::CopyIn(const void* data, size_t size) {
+  DCHECK_LE(size, buffer_size_ - size_);
+  const size_t start = (begin_ + size_) % buffer_size_;
+  const size_t first_size = std::min(size, buffer_size_ - start);
+  memcpy(&buffer_[start], data, first_size);
+  memcpy(&buffer_[0],
+         static_cast<const char*>(data) + first_size,
+         size - first_size);
+  size_ += size;
+}
+
+void ThreadLogMessages::CopyOut(size_t offset, void* data, size_t size) const {
+  DCHECK_LE(offset + size, size_);
+  const size_t start = (begin_ + offset) % buffer_size_;
+  const size_t first_size = std::min(size, buffer_size_ - start);
+  memcpy(data, &buffer_[start], first_size);
+  memcpy(static_cast<char*>(data) + first_size,
+         &buffer_[0],
+         size - first_size);
+}
+
+template <typename Callback>
+void ThreadLogMessages::ForEachMessage(const Callback& callback) const {
+  size_t offset = 0;
+  for (size_t index = 0; index < message_count_; ++index) {
+    MessageLength message_length;
+    CopyOut(offset, &message_length, sizeof(message_length));
+    offset += sizeof(message_length);
+    callback(offset, message_length);
+    offset += message_length;
+  }
+  DCHECK_EQ(offset, size_);
 }
 
 }  // namespace crashpad
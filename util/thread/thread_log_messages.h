@@ -15,21 +15,38 @@
 #ifndef CRASHPAD_UTIL_THREAD_THREAD_LOG_MESSAGES_H_
 #define CRASHPAD_UTIL_THREAD_THREAD_LOG_MESSAGES_H_
 
+#include <stddef.h>
+
+#include <memory>
 #include <string>
 #include <vector>
 
 
 namespace crashpad {
 
+class ThreadLogMessagesMaster;
+
 //! \brief Captures log messages produced on the current thread during an
 //!     object’s lifetime.
 //!
+//! Messages are kept in a ring buffer of fixed size, allocated when the object
+//! is created, so capturing a message never allocates memory and never takes a
+//! lock shared with other threads. Once the buffer is full, the oldest messages
+//! are dropped to make room for new ones.
+//!
 //! At most one object of this class type may exist on a single thread at a
 //! time. When using this class, no other part of the program may call
-//! `logging::SetLogMessageHandler()` at any time.
+//! `logging::SetLogMessageHandler()` at any time. The accessors must be called
+//! on the thread that the object was created on.
 class ThreadLogMessages {
  public:
-  ThreadLogMessages();
+  //! \brief The default size of the buffer that messages are kept in.
+  static constexpr size_t kDefaultBufferSize = 16 * 1024;
+
+  //! \param[in] buffer_size The size of the buffer that messages are kept in,
+  //!     in bytes. Each message uses its length plus 4 bytes. A single message
+  //!     longer than the buffer can hold is truncated.
+  explicit ThreadLogMessages(size_t buffer_size = kDefaultBufferSize);
 
   ThreadLogMessages(const ThreadLogMessages&) = delete;
   ThreadLogMessages& operator=(const ThreadLogMessages&) = delete;
@@ -37,11 +54,42 @@ class ThreadLogMessages {
   ~ThreadLogMessages();
 
   //! \return The log messages collected on the thread that this object was
-  //!     created on since the time it was created.
-  const std::vector<std::string>& log_messages() const { return log_messages_; }
+  //!     created on since the time it was created, oldest first. Only the
+  //!     most recent messages are returned if the buffer has filled up.
+  std::vector<std::string> log_messages() const;
+
+  //! \return The log messages returned by log_messages(), concatenated. Each
+  //!     message as produced by the logging system already ends in a newline.
+  std::string LogText() const;
+
+  //! \return The number of log messages that were dropped because the buffer
+  //!     filled up.
+  size_t dropped_message_count() const { return dropped_message_count_; }
 
  private:
-  std::vector<std::string> log_messages_;
+  friend class ThreadLogMessagesMaster;
+
+  // Adds a message to the buffer, dropping the oldest messages as needed.
+  void AppendMessage(const char* message, size_t length);
+
+  void DropOldestMessage();
+
+  // Copy data into the buffer after the messages it contains, and out of it at
+  // offset bytes after the oldest message, wrapping around its end.
+  void CopyIn(const void* data, size_t size);
+  void CopyOut(size_t offset, void* data, size_t size) const;
+
+  // Calls callback(offset, length) for each message, oldest first, where
+  // offset is relative to the oldest message and refers to the message’s text.
+  template <typename Callback>
+  void ForEachMessage(const Callback& callback) const;
+
+  std::unique_ptr<char[]> buffer_;
+  const size_t buffer_size_;
+  size_t begin_;
+  size_t size_;
+  size_t message_count_;
+  size_t dropped_message_count_;
 };
 
 }  // namespace crashpad
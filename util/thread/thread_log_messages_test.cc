@@ -14,10 +14,13 @@
 
 #include "util/thread/thread_log_messages.h"
 
+#include <stdint.h>
 #include <string.h>
 #include <sys/types.h>
 
 #include <iterator>
+#include <string>
+#include <vector>
 
 #include "base/logging.h"
 #include "base/strings/stringprintf.h"
@@ -102,6 +105,56 @@ TEST(ThreadLogMessages, Basic) {
   }
 }
 
+TEST(ThreadLogMessages, Wraparound) {
+  // Logging must be enabled at least at this level for this test to work.
+  ASSERT_TRUE(LOG_IS_ON(WARNING));
+
+  // A buffer this size can’t hold all of the messages, and messages will wrap
+  // around its end.
+  ThreadLogMessages thread_log_messages(1000);
+
+  std::vector<std::string> expected_messages;
+  for (int index = 0; index < 100; ++index) {
+    std::string message = base::StringPrintf("message %d", index);
+    expected_messages.push_back(message);
+    LOG(WARNING) << message;
+  }
+
+  const std::vector<std::string>& log_messages =
+      thread_log_messages.log_messages();
+  ASSERT_FALSE(log_messages.empty());
+  ASSERT_LT(log_messages.size(), expected_messages.size());
+  EXPECT_EQ(thread_log_messages.dropped_message_count(),
+            expected_messages.size() - log_messages.size());
+
+  // The most recent messages are kept.
+  const size_t first_kept = expected_messages.size() - log_messages.size();
+  std::string expected_log_text;
+  for (size_t index = 0; index < log_messages.size(); ++index) {
+    ASSERT_NO_FATAL_FAILURE(ExpectLogMessage(
+        log_messages[index], expected_messages[first_kept + index]))
+        << "index " << index;
+    expected_log_text += log_messages[index];
+  }
+  EXPECT_EQ(thread_log_messages.LogText(), expected_log_text);
+}
+
+TEST(ThreadLogMessages, Truncated) {
+  // Logging must be enabled at least at this level for this test to work.
+  ASSERT_TRUE(LOG_IS_ON(WARNING));
+
+  static constexpr size_t kBufferSize = 64;
+  ThreadLogMessages thread_log_messages(kBufferSize);
+
+  LOG(WARNING) << std::string(kBufferSize * 2, 'x');
+
+  const std::vector<std::string>& log_messages =
+      thread_log_messages.log_messages();
+  ASSERT_EQ(log_messages.size(), 1u);
+  EXPECT_EQ(log_messages[0].size(), kBufferSize - sizeof(uint32_t));
+  EXPECT_EQ(thread_log_messages.dropped_message_count(), 0u);
+}
+
 class LoggingTestThread : public Thread {
  public:
   LoggingTestThread() : thread_number_(0), start_(0), count_(0) {}
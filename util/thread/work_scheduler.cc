@@ -0,0 +1,200 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/thread/work_scheduler.h"
+
+#include <algorithm>
+
+#include "base/check_op.h"
+#include "util/thread/thread.h"
+#include "util/thread/worker_thread.h"
+
+namespace crashpad {
+
+class WorkScheduler::SchedulerThread final : public Thread {
+ public:
+  explicit SchedulerThread(WorkScheduler* scheduler) : scheduler_(scheduler) {}
+
+  SchedulerThread(const SchedulerThread&) = delete;
+  SchedulerThread& operator=(const SchedulerThread&) = delete;
+
+  ~SchedulerThread() override = default;
+
+ private:
+  // Thread:
+  void ThreadMain() override { scheduler_->RunWork(); }
+
+  WorkScheduler* scheduler_;  // weak
+};
+
+WorkScheduler::WorkScheduler(size_t thread_count)
+    : lock_(),
+      work_changed_(),
+      work_done_(),
+      work_(),
+      threads_(),
+      thread_count_(thread_count),
+      stopping_(false) {
+  DCHECK_GE(thread_count_, 1u);
+}
+
+WorkScheduler::~WorkScheduler() {
+  DCHECK(threads_.empty());
+  DCHECK(work_.empty());
+}
+
+void WorkScheduler::Start() {
+  DCHECK(threads_.empty());
+
+  {
+    std::lock_guard<std::mutex> lock(lock_);
+    stopping_ = false;
+  }
+
+  for (size_t index = 0; index < thread_count_; ++index) {
+    threads_.push_back(std::make_unique<SchedulerThread>(this));
+    threads_.back()->Start();
+  }
+}
+
+void WorkScheduler::Stop() {
+  {
+    std::lock_guard<std::mutex> lock(lock_);
+    DCHECK(work_.empty());
+    stopping_ = true;
+  }
+  work_changed_.notify_all();
+
+  for (const auto& thread : threads_) {
+    thread->Join();
+  }
+  threads_.clear();
+}
+
+void WorkScheduler::AddWork(WorkerThread* worker_thread,
+                            double initial_work_delay) {
+  {
+    std::lock_guard<std::mutex> lock(lock_);
+    DCHECK(FindWork(worker_thread) == work_.end());
+    work_.push_back({worker_thread,
+                     DueTime(Clock::now(), initial_work_delay),
+                     false,
+                     false,
+                     false});
+  }
+  work_changed_.notify_one();
+}
+
+void WorkScheduler::RemoveWork(WorkerThread* worker_thread) {
+  std::unique_lock<std::mutex> lock(lock_);
+  auto work = FindWork(worker_thread);
+  DCHECK(work != work_.end());
+
+  // As on a WorkerThread’s own thread, work requested by DoWorkNow() before
+  // the WorkerThread was stopped is still done, but no more is scheduled.
+  work->stopping = true;
+  work->due = Clock::time_point::max();
+  work_done_.wait(lock, [&work]() {
+    return !work->running && !work->do_work_now;
+  });
+  work_.erase(work);
+}
+
+void WorkScheduler::DoWorkNow(WorkerThread* worker_thread) {
+  {
+    std::lock_guard<std::mutex> lock(lock_);
+    // The WorkerThread may have been stopped since the caller checked that it
+    // was running.
+    auto work = FindWork(worker_thread);
+    if (work == work_.end()) {
+      return;
+    }
+    work->do_work_now = true;
+  }
+  work_changed_.notify_one();
+}
+
+void WorkScheduler::RunWork() {
+  std::unique_lock<std::mutex> lock(lock_);
+  while (!stopping_) {
+    const Clock::time_point now = Clock::now();
+    Clock::time_point next_due = Clock::time_point::max();
+    auto next = work_.end();
+    for (auto work = work_.begin(); work != work_.end(); ++work) {
+      if (work->running) {
+        continue;
+      }
+      if (work->do_work_now || work->due <= now) {
+        next = work;
+        break;
+      }
+      next_due = std::min(next_due, work->due);
+    }
+
+    if (next == work_.end()) {
+      if (next_due == Clock::time_point::max()) {
+        work_changed_.wait(lock);
+      } else {
+        work_changed_.wait_until(lock, next_due);
+      }
+      continue;
+    }
+
+    // Elements of work_ are only erased by RemoveWork() once they aren’t
+    // running, so next remains valid while lock_ is released.
+    next->running = true;
+    next->do_work_now = false;
+    WorkerThread* worker_thread = next->worker_thread;
+    lock.unlock();
+
+    worker_thread->delegate_->DoWork(worker_thread);
+
+    lock.lock();
+    next->running = false;
+    if (!next->stopping) {
+      // As on a WorkerThread’s own thread, the interval counts from the
+      // completion of the work.
+      next->due = DueTime(Clock::now(), worker_thread->work_interval_);
+    }
+    work_done_.notify_all();
+
+    // The work may have been requested again while it was running, and this
+    // thread may have been the one notified.
+    if (next->do_work_now) {
+      work_changed_.notify_one();
+    }
+  }
+}
+
+std::list<WorkScheduler::Work>::iterator WorkScheduler::FindWork(
+    WorkerThread* worker_thread) {
+  return std::find_if(
+      work_.begin(), work_.end(), [worker_thread](const Work& work) {
+        return work.worker_thread == worker_thread;
+      });
+}
+
+// static
+WorkScheduler::Clock::time_point WorkScheduler::DueTime(Clock::time_point now,
+                                                        double delay) {
+  // Delays too long to represent, including WorkerThread::kIndefiniteWait,
+  // never come due.
+  const std::chrono::duration<double> delay_duration(delay);
+  if (delay_duration >= Clock::time_point::max() - now) {
+    return Clock::time_point::max();
+  }
+  return now + std::chrono::duration_cast<Clock::duration>(delay_duration);
+}
+
+}  // namespace crashpad
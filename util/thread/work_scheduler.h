@@ -0,0 +1,115 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_UTIL_THREAD_WORK_SCHEDULER_H_
+#define CRASHPAD_UTIL_THREAD_WORK_SCHEDULER_H_
+
+#include <stddef.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "util/thread/stoppable.h"
+
+namespace crashpad {
+
+class Thread;
+class WorkerThread;
+
+//! \brief Runs the work of several WorkerThread objects on a shared pool of
+//!     threads.
+//!
+//! A WorkerThread normally has a thread of its own, which wakes at its work
+//! interval. A WorkerThread given a WorkScheduler with
+//! WorkerThread::SetScheduler() instead has its Delegate::DoWork() called on
+//! one of the scheduler’s threads when its work is due, with the same timing
+//! as it would have on its own thread. Idle threads sleep until the earliest
+//! work is due, or indefinitely if no work is scheduled, so that a process
+//! with several mostly-idle WorkerThread objects needs fewer threads and
+//! wakes less often.
+//!
+//! The work of one WorkerThread is never run on more than one thread at a
+//! time. Work that takes a long time, such as an upload, occupies one of the
+//! scheduler’s threads while it runs, so the scheduler should have enough
+//! threads that other work isn’t held up for too long.
+class WorkScheduler final : public Stoppable {
+ public:
+  //! \param[in] thread_count The number of threads to run work on. Must be at
+  //!     least 1.
+  explicit WorkScheduler(size_t thread_count);
+
+  WorkScheduler(const WorkScheduler&) = delete;
+  WorkScheduler& operator=(const WorkScheduler&) = delete;
+
+  ~WorkScheduler();
+
+  // Stoppable:
+
+  //! \brief Starts the scheduler’s threads.
+  //!
+  //! WorkerThread objects using this scheduler may be started before this is
+  //! called, but their work won’t be done until it is.
+  void Start() override;
+
+  //! \brief Stops the scheduler’s threads.
+  //!
+  //! All WorkerThread objects using this scheduler must have been stopped
+  //! before this is called.
+  void Stop() override;
+
+ private:
+  friend class WorkerThread;
+
+  using Clock = std::chrono::steady_clock;
+
+  struct Work {
+    WorkerThread* worker_thread;  // weak
+    Clock::time_point due;
+    bool running;
+    bool do_work_now;
+    bool stopping;
+  };
+
+  class SchedulerThread;
+
+  // Called by WorkerThread to start, stop, and request its work.
+  void AddWork(WorkerThread* worker_thread, double initial_work_delay);
+  void RemoveWork(WorkerThread* worker_thread);
+  void DoWorkNow(WorkerThread* worker_thread);
+
+  // The main function of each of threads_.
+  void RunWork();
+
+  // Returns the element of work_ for worker_thread. lock_ must be held.
+  std::list<Work>::iterator FindWork(WorkerThread* worker_thread);
+
+  // Returns the time that is delay seconds after now.
+  static Clock::time_point DueTime(Clock::time_point now, double delay);
+
+  std::mutex lock_;
+  std::condition_variable work_changed_;
+  std::condition_variable work_done_;
+  std::list<Work> work_;
+  std::vector<std::unique_ptr<SchedulerThread>> threads_;
+  const size_t thread_count_;
+  bool stopping_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_UTIL_THREAD_WORK_SCHEDULER_H_
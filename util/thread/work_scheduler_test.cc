@@ -0,0 +1,129 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/thread/work_scheduler.h"
+
+#include <iterator>
+
+#include "gtest/gtest.h"
+#include "util/misc/clock.h"
+#include "util/synchronization/semaphore.h"
+#include "util/thread/worker_thread.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+constexpr uint64_t kNanosecondsPerSecond = static_cast<uint64_t>(1E9);
+
+class WorkDelegate : public WorkerThread::Delegate {
+ public:
+  WorkDelegate() {}
+
+  WorkDelegate(const WorkDelegate&) = delete;
+  WorkDelegate& operator=(const WorkDelegate&) = delete;
+
+  ~WorkDelegate() {}
+
+  void DoWork(const WorkerThread* thread) override {
+    if (work_count_ < waiting_for_count_) {
+      if (++work_count_ == waiting_for_count_) {
+        semaphore_.Signal();
+      }
+    }
+  }
+
+  void SetDesiredWorkCount(int times) { waiting_for_count_ = times; }
+
+  //! \brief Suspends the calling thread until the DoWork() has been called
+  //!     the number of times specified by SetDesiredWorkCount().
+  void WaitForWorkCount() { semaphore_.Wait(); }
+
+  int work_count() const { return work_count_; }
+
+ private:
+  Semaphore semaphore_{0};
+  int work_count_ = 0;
+  int waiting_for_count_ = -1;
+};
+
+TEST(WorkScheduler, DoWork) {
+  WorkScheduler scheduler(1);
+  scheduler.Start();
+
+  WorkDelegate delegates[3];
+  WorkerThread threads[] = {WorkerThread(0.05, &delegates[0]),
+                            WorkerThread(0.05, &delegates[1]),
+                            WorkerThread(0.05, &delegates[2])};
+  for (size_t index = 0; index < std::size(threads); ++index) {
+    threads[index].SetScheduler(&scheduler);
+    delegates[index].SetDesiredWorkCount(2);
+    threads[index].Start(0);
+    EXPECT_TRUE(threads[index].is_running());
+  }
+
+  for (size_t index = 0; index < std::size(threads); ++index) {
+    delegates[index].WaitForWorkCount();
+    threads[index].Stop();
+    EXPECT_FALSE(threads[index].is_running());
+  }
+
+  scheduler.Stop();
+}
+
+TEST(WorkScheduler, StopBeforeDoWork) {
+  WorkScheduler scheduler(2);
+  scheduler.Start();
+
+  WorkDelegate delegate;
+  WorkerThread thread(1, &delegate);
+  thread.SetScheduler(&scheduler);
+
+  thread.Start(15);
+  thread.Stop();
+
+  EXPECT_EQ(delegate.work_count(), 0);
+
+  scheduler.Stop();
+}
+
+TEST(WorkScheduler, DoWorkNow) {
+  WorkScheduler scheduler(1);
+  scheduler.Start();
+
+  WorkDelegate delegate;
+  WorkerThread thread(100, &delegate);
+  thread.SetScheduler(&scheduler);
+
+  uint64_t start = ClockMonotonicNanoseconds();
+
+  delegate.SetDesiredWorkCount(1);
+  thread.Start(0);
+  delegate.WaitForWorkCount();
+  EXPECT_EQ(delegate.work_count(), 1);
+
+  delegate.SetDesiredWorkCount(2);
+  thread.DoWorkNow();
+  delegate.WaitForWorkCount();
+  thread.Stop();
+  EXPECT_EQ(delegate.work_count(), 2);
+
+  EXPECT_GE(100 * kNanosecondsPerSecond, ClockMonotonicNanoseconds() - start);
+
+  scheduler.Stop();
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
@@ -16,6 +16,7 @@
 
 #include "base/check.h"
 #include "util/thread/thread.h"
+#include "util/thread/work_scheduler.h"
 
 namespace crashpad {
 
@@ -57,6 +58,7 @@ WorkerThread::WorkerThread(double work_interval,
                            WorkerThread::Delegate* delegate)
     : work_interval_(work_interval),
       delegate_(delegate),
+      scheduler_(nullptr),
       impl_(),
       running_(false),
       do_work_now_(false) {}
@@ -65,24 +67,43 @@ WorkerThread::~WorkerThread() {
   DCHECK(!running_);
 }
 
+void WorkerThread::SetScheduler(WorkScheduler* scheduler) {
+  DCHECK(!running_);
+  scheduler_ = scheduler;
+}
+
+void WorkerThread::SetWorkInterval(double work_interval) {
+  work_interval_ = work_interval;
+}
+
 void WorkerThread::Start(double initial_work_delay) {
   DCHECK(!impl_);
   DCHECK(!running_);
 
   running_ = true;
+  if (scheduler_) {
+    scheduler_->AddWork(this, initial_work_delay);
+    return;
+  }
+
   impl_.reset(new internal::WorkerThreadImpl(this, initial_work_delay));
   impl_->Start();
 }
 
 void WorkerThread::Stop() {
   DCHECK(running_);
-  DCHECK(impl_);
+  DCHECK(impl_ || scheduler_);
 
   if (!running_)
     return;
 
   running_ = false;
 
+  if (scheduler_) {
+    scheduler_->RemoveWork(this);
+    return;
+  }
+
   impl_->SignalSemaphore();
   impl_->Join();
   impl_.reset();
@@ -90,6 +111,11 @@ void WorkerThread::Stop() {
 
 void WorkerThread::DoWorkNow() {
   DCHECK(running_);
+  if (scheduler_) {
+    scheduler_->DoWorkNow(this);
+    return;
+  }
+
   do_work_now_ = true;
   impl_->SignalSemaphore();
 }
@@ -22,6 +22,8 @@
 
 namespace crashpad {
 
+class WorkScheduler;
+
 namespace internal {
 class WorkerThreadImpl;
 }  // namespace internal
@@ -59,6 +61,25 @@ class WorkerThread {
 
   ~WorkerThread();
 
+  //! \brief Runs this object’s work on the threads of \a scheduler, instead of
+  //!     on a thread of its own.
+  //!
+  //! This may not be called if the thread is_running().
+  //!
+  //! \param[in] scheduler The scheduler to run work on, or `nullptr` to use a
+  //!     dedicated thread. The scheduler must outlive any period during which
+  //!     this object is running.
+  void SetScheduler(WorkScheduler* scheduler);
+
+  //! \brief Changes the \a work_interval given to the constructor.
+  //!
+  //! This may be called before Start(), or from Delegate::DoWork(), in which
+  //! case \a work_interval applies from the wait that follows that call.
+  //!
+  //! \param[in] work_interval The new time interval in seconds at which the \a
+  //!     delegate runs. This can be #kIndefiniteWait.
+  void SetWorkInterval(double work_interval);
+
   //! \brief Starts the worker thread.
   //!
   //! This may not be called if the thread is_running().
@@ -91,9 +112,11 @@ class WorkerThread {
 
  private:
   friend class internal::WorkerThreadImpl;
+  friend class WorkScheduler;
 
   double work_interval_;
   Delegate* delegate_;  // weak
+  WorkScheduler* scheduler_;  // weak
   std::unique_ptr<internal::WorkerThreadImpl> impl_;
   bool running_;
   std::atomic_bool do_work_now_;
@@ -117,6 +117,58 @@ TEST(WorkerThread, Restart) {
   ASSERT_FALSE(thread.is_running());
 }
 
+// Shortens its thread’s work interval the first time that it does work.
+class ShorteningWorkDelegate final : public WorkDelegate {
+ public:
+  ShorteningWorkDelegate() : WorkDelegate(), thread_(nullptr) {}
+
+  ShorteningWorkDelegate(const ShorteningWorkDelegate&) = delete;
+  ShorteningWorkDelegate& operator=(const ShorteningWorkDelegate&) = delete;
+
+  ~ShorteningWorkDelegate() {}
+
+  void set_thread(WorkerThread* thread) { thread_ = thread; }
+
+  void DoWork(const WorkerThread* thread) override {
+    thread_->SetWorkInterval(0.05);
+    WorkDelegate::DoWork(thread);
+  }
+
+ private:
+  WorkerThread* thread_;  // weak
+};
+
+TEST(WorkerThread, SetWorkInterval) {
+  ShorteningWorkDelegate delegate;
+  WorkerThread thread(100, &delegate);
+  delegate.set_thread(&thread);
+
+  uint64_t start = ClockMonotonicNanoseconds();
+
+  // The interval set by the first DoWork() applies to the wait that follows
+  // it, so the second is done well within the original interval.
+  delegate.SetDesiredWorkCount(2);
+  thread.Start(0);
+  delegate.WaitForWorkCount();
+  thread.Stop();
+  EXPECT_EQ(delegate.work_count(), 2);
+
+  EXPECT_GE(100 * kNanosecondsPerSecond, ClockMonotonicNanoseconds() - start);
+
+  // An interval set before Start() applies from the start.
+  WorkDelegate plain_delegate;
+  WorkerThread plain_thread(100, &plain_delegate);
+  plain_thread.SetWorkInterval(0.05);
+
+  start = ClockMonotonicNanoseconds();
+  plain_delegate.SetDesiredWorkCount(2);
+  plain_thread.Start(0);
+  plain_delegate.WaitForWorkCount();
+  plain_thread.Stop();
+
+  EXPECT_GE(100 * kNanosecondsPerSecond, ClockMonotonicNanoseconds() - start);
+}
+
 TEST(WorkerThread, DoWorkNow) {
   WorkDelegate delegate;
   WorkerThread thread(100, &delegate);
@@ -0,0 +1,118 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/win/child_client_data.h"
+
+#include <vector>
+
+#include "base/logging.h"
+#include "base/strings/stringprintf.h"
+#include "base/strings/utf_string_conversions.h"
+#include "util/stdlib/string_number_conversion.h"
+#include "util/string/split_string.h"
+#include "util/win/handle.h"
+
+namespace crashpad {
+
+namespace {
+
+// The number of comma separated fields before the pipe name, which may itself
+// contain commas.
+constexpr size_t kFieldsBeforePipe = 5;
+
+bool HandleFromString(const std::string& str, HANDLE* handle) {
+  unsigned int handle_uint;
+  if (!StringToNumber(str, &handle_uint) ||
+      (*handle = IntToHandle(handle_uint)) == INVALID_HANDLE_VALUE) {
+    LOG(ERROR) << "could not convert '" << str << "' to HANDLE";
+    return false;
+  }
+  return true;
+}
+
+bool AddressFromString(const std::string& str, WinVMAddress* address) {
+  if (!StringToNumber(str, address)) {
+    LOG(ERROR) << "could not convert '" << str << "' to WinVMAddress";
+    return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+ChildClientData::ChildClientData()
+    : ipc_pipe_(),
+      crash_exception_information_(0),
+      non_crash_exception_information_(0),
+      request_crash_dump_(nullptr),
+      request_non_crash_dump_(nullptr),
+      non_crash_dump_completed_(nullptr),
+      is_valid_(false) {}
+
+ChildClientData::ChildClientData(HANDLE request_crash_dump,
+                                 HANDLE request_non_crash_dump,
+                                 HANDLE non_crash_dump_completed,
+                                 WinVMAddress crash_exception_information,
+                                 WinVMAddress non_crash_exception_information,
+                                 const std::wstring& ipc_pipe)
+    : ipc_pipe_(ipc_pipe),
+      crash_exception_information_(crash_exception_information),
+      non_crash_exception_information_(non_crash_exception_information),
+      request_crash_dump_(request_crash_dump),
+      request_non_crash_dump_(request_non_crash_dump),
+      non_crash_dump_completed_(non_crash_dump_completed),
+      is_valid_(true) {}
+
+bool ChildClientData::InitializeFromString(const std::string& str) {
+  std::vector<std::string> parts(SplitString(str, ','));
+  if (parts.size() <= kFieldsBeforePipe) {
+    LOG(ERROR) << "expected at least " << kFieldsBeforePipe + 1
+               << " comma separated arguments";
+    return false;
+  }
+
+  if (!HandleFromString(parts[0], &request_crash_dump_) ||
+      !HandleFromString(parts[1], &request_non_crash_dump_) ||
+      !HandleFromString(parts[2], &non_crash_dump_completed_) ||
+      !AddressFromString(parts[3], &crash_exception_information_) ||
+      !AddressFromString(parts[4], &non_crash_exception_information_)) {
+    return false;
+  }
+
+  std::string ipc_pipe = parts[kFieldsBeforePipe];
+  for (size_t index = kFieldsBeforePipe + 1; index < parts.size(); ++index) {
+    ipc_pipe.push_back(',');
+    ipc_pipe += parts[index];
+  }
+  if (ipc_pipe.empty()) {
+    LOG(ERROR) << "no pipe name";
+    return false;
+  }
+  ipc_pipe_ = base::UTF8ToWide(ipc_pipe);
+
+  is_valid_ = true;
+  return true;
+}
+
+std::string ChildClientData::StringRepresentation() const {
+  return base::StringPrintf("0x%x,0x%x,0x%x,0x%I64x,0x%I64x,%s",
+                            HandleToInt(request_crash_dump_),
+                            HandleToInt(request_non_crash_dump_),
+                            HandleToInt(non_crash_dump_completed_),
+                            crash_exception_information_,
+                            non_crash_exception_information_,
+                            base::WideToUTF8(ipc_pipe_).c_str());
+}
+
+}  // namespace crashpad
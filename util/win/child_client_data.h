@@ -0,0 +1,105 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_UTIL_WIN_CHILD_CLIENT_DATA_H_
+#define CRASHPAD_UTIL_WIN_CHILD_CLIENT_DATA_H_
+
+#include <windows.h>
+
+#include <string>
+
+#include "util/win/address_types.h"
+
+namespace crashpad {
+
+//! \brief A container for the registration that a client makes with the
+//!     handler on behalf of a child process, passed to the child so that it
+//!     can use the handler without registering itself.
+//!
+//! See CrashpadClient::RegisterChildProcess() and
+//! CrashpadClient::SetHandlerFromChildClientData().
+class ChildClientData {
+ public:
+  //! \brief Constructs an unintialized instance to be used with
+  //!     InitializeFromString().
+  ChildClientData();
+
+  //! \brief Constructs an instance of ChildClientData. This object does not
+  //!     take ownership of any of the referenced HANDLEs.
+  //!
+  //! \param[in] request_crash_dump An event, valid in the child, signalled from
+  //!     the child on crash.
+  //! \param[in] request_non_crash_dump An event, valid in the child, signalled
+  //!     from the child when it would like a dump to be taken, but allowed to
+  //!     continue afterwards.
+  //! \param[in] non_crash_dump_completed An event, valid in the child,
+  //!     signalled from the handler to tell the child that the non-crash dump
+  //!     has completed, and it can continue execution.
+  //! \param[in] crash_exception_information The address, in the child's
+  //!     address space, of an ExceptionInformation structure, used when
+  //!     handling a crash dump request.
+  //! \param[in] non_crash_exception_information The address, in the child's
+  //!     address space, of an ExceptionInformation structure, used when
+  //!     handling a non-crashing dump request.
+  //! \param[in] ipc_pipe The name of the handler's pipe, so that the child can
+  //!     register its own children.
+  ChildClientData(HANDLE request_crash_dump,
+                  HANDLE request_non_crash_dump,
+                  HANDLE non_crash_dump_completed,
+                  WinVMAddress crash_exception_information,
+                  WinVMAddress non_crash_exception_information,
+                  const std::wstring& ipc_pipe);
+
+  ChildClientData(const ChildClientData&) = delete;
+  ChildClientData& operator=(const ChildClientData&) = delete;
+
+  //! \brief Returns whether the object has been initialized successfully.
+  bool IsValid() const { return is_valid_; }
+
+  //! Initializes this object from a string representation presumed to have been
+  //!     created by StringRepresentation().
+  //!
+  //! \param[in] str The output of StringRepresentation().
+  //!
+  //! \return `true` on success, or `false` with a message logged on failure.
+  bool InitializeFromString(const std::string& str);
+
+  //! \brief Returns a string representation of the data of this object,
+  //!     suitable for passing on the command line or in the environment.
+  std::string StringRepresentation() const;
+
+  HANDLE request_crash_dump() const { return request_crash_dump_; }
+  HANDLE request_non_crash_dump() const { return request_non_crash_dump_; }
+  HANDLE non_crash_dump_completed() const { return non_crash_dump_completed_; }
+  WinVMAddress crash_exception_information() const {
+    return crash_exception_information_;
+  }
+  WinVMAddress non_crash_exception_information() const {
+    return non_crash_exception_information_;
+  }
+  const std::wstring& ipc_pipe() const { return ipc_pipe_; }
+
+ private:
+  std::wstring ipc_pipe_;
+  WinVMAddress crash_exception_information_;
+  WinVMAddress non_crash_exception_information_;
+  HANDLE request_crash_dump_;
+  HANDLE request_non_crash_dump_;
+  HANDLE non_crash_dump_completed_;
+  bool is_valid_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_UTIL_WIN_CHILD_CLIENT_DATA_H_
@@ -0,0 +1,75 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/win/child_client_data.h"
+
+#include "gtest/gtest.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+TEST(ChildClientData, Validity) {
+  ChildClientData ccd1;
+  EXPECT_FALSE(ccd1.IsValid());
+
+  ChildClientData ccd2(reinterpret_cast<HANDLE>(0x123),
+                       reinterpret_cast<HANDLE>(0x456),
+                       reinterpret_cast<HANDLE>(0x789),
+                       0x7fff000012345678ull,
+                       0x7fff000012345684ull,
+                       L"\\\\.\\pipe\\crashpad_1_ABC");
+  EXPECT_TRUE(ccd2.IsValid());
+}
+
+TEST(ChildClientData, RoundTrip) {
+  ChildClientData first(reinterpret_cast<HANDLE>(0x123),
+                        reinterpret_cast<HANDLE>(0x456),
+                        reinterpret_cast<HANDLE>(0x789),
+                        0x7fff000012345678ull,
+                        0x7fff000012345684ull,
+                        L"\\\\.\\pipe\\crashpad,with,commas");
+
+  std::string as_string = first.StringRepresentation();
+  EXPECT_EQ(as_string,
+            "0x123,0x456,0x789,0x7fff000012345678,0x7fff000012345684,"
+            "\\\\.\\pipe\\crashpad,with,commas");
+
+  ChildClientData second;
+  ASSERT_TRUE(second.InitializeFromString(as_string));
+  EXPECT_TRUE(second.IsValid());
+  EXPECT_EQ(second.request_crash_dump(), first.request_crash_dump());
+  EXPECT_EQ(second.request_non_crash_dump(), first.request_non_crash_dump());
+  EXPECT_EQ(second.non_crash_dump_completed(),
+            first.non_crash_dump_completed());
+  EXPECT_EQ(second.crash_exception_information(),
+            first.crash_exception_information());
+  EXPECT_EQ(second.non_crash_exception_information(),
+            first.non_crash_exception_information());
+  EXPECT_EQ(second.ipc_pipe(), first.ipc_pipe());
+}
+
+TEST(ChildClientData, Invalid) {
+  ChildClientData data;
+  EXPECT_FALSE(data.InitializeFromString(""));
+  EXPECT_FALSE(data.InitializeFromString("0x123,0x456,0x789,0x1000,0x1010"));
+  EXPECT_FALSE(data.InitializeFromString("0x123,0x456,0x789,0x1000,0x1010,"));
+  EXPECT_FALSE(
+      data.InitializeFromString("0x123,0x456,nope,0x1000,0x1010,pipe"));
+  EXPECT_FALSE(data.IsValid());
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
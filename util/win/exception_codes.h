@@ -30,6 +30,15 @@ enum ExceptionCodes : uint32_t {
   //!     confusion with real exception codes which tend to have those bits
   //!     set.
   kTriggeredExceptionCode = 0xcca11ed,
+
+  //! \brief The exception code (roughly "simulated") used in the exception
+  //!     record of a dump requested by CrashpadClient::DumpWithoutCrash(),
+  //!     so that it’s relatively obvious in a debugger that it’s not actually
+  //!     an exception.
+  //!
+  //! \note Like #kTriggeredExceptionCode, this value does not have any bits of
+  //!     the top nibble set.
+  kSimulatedExceptionCode = 0x517a7ed,
 };
 
 }  // namespace crashpad
@@ -18,8 +18,11 @@
 #include <string.h>
 #include <sys/types.h>
 
+#include <algorithm>
 #include <iterator>
+#include <memory>
 #include <utility>
+#include <vector>
 
 #include "base/logging.h"
 #include "base/numerics/safe_conversions.h"
@@ -30,6 +33,7 @@
 #include "util/misc/uuid.h"
 #include "util/win/get_function.h"
 #include "util/win/handle.h"
+#include "util/win/process_info.h"
 #include "util/win/registration_protocol_win.h"
 #include "util/win/safe_terminate_process.h"
 #include "util/win/xp_compat.h"
@@ -70,12 +74,14 @@ class PipeServiceContext {
                      ExceptionHandlerServer::Delegate* delegate,
                      base::Lock* clients_lock,
                      std::set<internal::ClientData*>* clients,
+                     HANDLE dump_semaphore,
                      uint64_t shutdown_token)
       : port_(port),
         pipe_(pipe),
         delegate_(delegate),
         clients_lock_(clients_lock),
         clients_(clients),
+        dump_semaphore_(dump_semaphore),
         shutdown_token_(shutdown_token) {}
 
   PipeServiceContext(const PipeServiceContext&) = delete;
@@ -86,6 +92,7 @@ class PipeServiceContext {
   ExceptionHandlerServer::Delegate* delegate() const { return delegate_; }
   base::Lock* clients_lock() const { return clients_lock_; }
   std::set<internal::ClientData*>* clients() const { return clients_; }
+  HANDLE dump_semaphore() const { return dump_semaphore_; }
   uint64_t shutdown_token() const { return shutdown_token_; }
 
  private:
@@ -94,6 +101,7 @@ class PipeServiceContext {
   ExceptionHandlerServer::Delegate* delegate_;  // weak
   base::Lock* clients_lock_;  // weak
   std::set<internal::ClientData*>* clients_;  // weak
+  HANDLE dump_semaphore_;  // weak
   uint64_t shutdown_token_;
 };
 
@@ -113,6 +121,7 @@ class ClientData {
              WinVMAddress crash_exception_information_address,
              WinVMAddress non_crash_exception_information_address,
              WinVMAddress debug_critical_section_address,
+             HANDLE dump_semaphore,
              WAITORTIMERCALLBACK crash_dump_request_callback,
              WAITORTIMERCALLBACK non_crash_dump_request_callback,
              WAITORTIMERCALLBACK process_end_callback)
@@ -132,7 +141,8 @@ class ClientData {
             crash_exception_information_address),
         non_crash_exception_information_address_(
             non_crash_exception_information_address),
-        debug_critical_section_address_(debug_critical_section_address) {
+        debug_critical_section_address_(debug_critical_section_address),
+        dump_semaphore_(dump_semaphore) {
     RegisterThreadPoolWaits(crash_dump_request_callback,
                             non_crash_dump_request_callback,
                             process_end_callback);
@@ -170,18 +180,24 @@ class ClientData {
     return debug_critical_section_address_;
   }
   HANDLE process() const { return process_.get(); }
+  HANDLE dump_semaphore() const { return dump_semaphore_; }
 
  private:
   void RegisterThreadPoolWaits(
       WAITORTIMERCALLBACK crash_dump_request_callback,
       WAITORTIMERCALLBACK non_crash_dump_request_callback,
       WAITORTIMERCALLBACK process_end_callback) {
+    // When dumps are limited by a semaphore, the dump callbacks are marked as
+    // long-running so that the thread pool adds threads for dumps of other
+    // clients instead of queueing the callbacks behind a dump in progress.
+    const ULONG dump_flags =
+        dump_semaphore_ ? WT_EXECUTELONGFUNCTION : WT_EXECUTEDEFAULT;
     if (!RegisterWaitForSingleObject(&crash_dump_request_thread_pool_wait_,
                                      crash_dump_requested_event_.get(),
                                      crash_dump_request_callback,
                                      this,
                                      INFINITE,
-                                     WT_EXECUTEDEFAULT)) {
+                                     dump_flags)) {
       LOG(ERROR) << "RegisterWaitForSingleObject crash dump requested";
     }
 
@@ -190,7 +206,7 @@ class ClientData {
                                      non_crash_dump_request_callback,
                                      this,
                                      INFINITE,
-                                     WT_EXECUTEDEFAULT)) {
+                                     dump_flags)) {
       LOG(ERROR) << "RegisterWaitForSingleObject non-crash dump requested";
     }
 
@@ -234,10 +250,126 @@ class ClientData {
   WinVMAddress crash_exception_information_address_;
   WinVMAddress non_crash_exception_information_address_;
   WinVMAddress debug_critical_section_address_;
+  HANDLE dump_semaphore_;  // weak
+};
+
+//! \brief A named pipe instance serviced with overlapped I/O by the threads of
+//!     a pool.
+//!
+//! At most one operation on the pipe is outstanding at a time, and only the
+//! thread that receives its completion touches this object until it starts
+//! the next one.
+struct PooledPipeInstance {
+  enum class State {
+    kConnecting,
+    kReading,
+    kWriting,
+  };
+
+  PooledPipeInstance(HANDLE port,
+                     HANDLE pipe,
+                     ExceptionHandlerServer::Delegate* delegate,
+                     base::Lock* clients_lock,
+                     std::set<internal::ClientData*>* clients,
+                     HANDLE dump_semaphore,
+                     uint64_t shutdown_token)
+      : overlapped(),
+        context(port,
+                pipe,
+                delegate,
+                clients_lock,
+                clients,
+                dump_semaphore,
+                shutdown_token),
+        message(),
+        response(),
+        state(State::kConnecting),
+        io_pending(false) {}
+
+  PooledPipeInstance(const PooledPipeInstance&) = delete;
+  PooledPipeInstance& operator=(const PooledPipeInstance&) = delete;
+
+  OVERLAPPED overlapped;
+  PipeServiceContext context;
+  ClientToServerMessage message;
+  ServerToClientMessage response;
+  State state;
+
+  // Whether an operation has been started and its completion not yet
+  // received.
+  bool io_pending;
 };
 
 }  // namespace internal
 
+namespace {
+
+// Holds one of the slots of a client’s dump semaphore, if it has one, for the
+// duration of a dump.
+class ScopedDumpSlot {
+ public:
+  explicit ScopedDumpSlot(HANDLE semaphore) : semaphore_(semaphore) {
+    if (semaphore_ &&
+        WaitForSingleObject(semaphore_, INFINITE) != WAIT_OBJECT_0) {
+      PLOG(ERROR) << "WaitForSingleObject";
+      semaphore_ = nullptr;
+    }
+  }
+
+  ScopedDumpSlot(const ScopedDumpSlot&) = delete;
+  ScopedDumpSlot& operator=(const ScopedDumpSlot&) = delete;
+
+  ~ScopedDumpSlot() {
+    if (semaphore_ && !ReleaseSemaphore(semaphore_, 1, nullptr)) {
+      PLOG(ERROR) << "ReleaseSemaphore";
+    }
+  }
+
+ private:
+  HANDLE semaphore_;  // weak
+};
+
+// Starts an overlapped read of a message from the client connected to
+// instance. Returns false with a message logged if the read could not be
+// started.
+bool StartPooledRead(internal::PooledPipeInstance* instance) {
+  instance->state = internal::PooledPipeInstance::State::kReading;
+  instance->overlapped = {};
+  instance->io_pending = true;
+  if (!ReadFile(instance->context.pipe(),
+                &instance->message,
+                sizeof(instance->message),
+                nullptr,
+                &instance->overlapped) &&
+      GetLastError() != ERROR_IO_PENDING) {
+    PLOG(ERROR) << "ReadFile";
+    instance->io_pending = false;
+    return false;
+  }
+  return true;
+}
+
+// Starts an overlapped write of instance's response. Returns false with a
+// message logged if the write could not be started.
+bool StartPooledWrite(internal::PooledPipeInstance* instance) {
+  instance->state = internal::PooledPipeInstance::State::kWriting;
+  instance->overlapped = {};
+  instance->io_pending = true;
+  if (!WriteFile(instance->context.pipe(),
+                 &instance->response,
+                 sizeof(instance->response),
+                 nullptr,
+                 &instance->overlapped) &&
+      GetLastError() != ERROR_IO_PENDING) {
+    PLOG(ERROR) << "WriteFile";
+    instance->io_pending = false;
+    return false;
+  }
+  return true;
+}
+
+}  // namespace
+
 ExceptionHandlerServer::Delegate::~Delegate() {
 }
 
@@ -247,6 +379,8 @@ ExceptionHandlerServer::ExceptionHandlerServer(bool persistent)
       first_pipe_instance_(),
       clients_lock_(),
       clients_(),
+      dump_semaphore_(),
+      pipe_instances_(0),
       persistent_(persistent) {
 }
 
@@ -260,6 +394,25 @@ void ExceptionHandlerServer::SetPipeName(const std::wstring& pipe_name) {
   pipe_name_ = pipe_name;
 }
 
+void ExceptionHandlerServer::SetMaxConcurrentDumps(
+    size_t max_concurrent_dumps) {
+  DCHECK(clients_.empty());
+  DCHECK_GE(max_concurrent_dumps, 1u);
+  if (max_concurrent_dumps <= 1) {
+    dump_semaphore_.reset();
+    return;
+  }
+
+  const LONG count = base::saturated_cast<LONG>(max_concurrent_dumps);
+  dump_semaphore_.reset(CreateSemaphore(nullptr, count, count, nullptr));
+  PLOG_IF(ERROR, !dump_semaphore_.is_valid()) << "CreateSemaphore";
+}
+
+void ExceptionHandlerServer::SetPipeInstances(size_t pipe_instances) {
+  DCHECK_LE(pipe_instances, static_cast<size_t>(PIPE_UNLIMITED_INSTANCES));
+  pipe_instances_ = pipe_instances;
+}
+
 void ExceptionHandlerServer::InitializeWithInheritedDataForInitialClient(
     const InitialClientData& initial_client_data,
     Delegate* delegate) {
@@ -296,6 +449,7 @@ void ExceptionHandlerServer::InitializeWithInheritedDataForInitialClient(
         initial_client_data.crash_exception_information(),
         initial_client_data.non_crash_exception_information(),
         initial_client_data.debug_critical_section_address(),
+        dump_semaphore_.get(),
         &OnCrashDumpEvent,
         &OnNonCrashDumpEvent,
         &OnProcessEnd);
@@ -305,8 +459,38 @@ void ExceptionHandlerServer::InitializeWithInheritedDataForInitialClient(
 
 void ExceptionHandlerServer::Run(Delegate* delegate) {
   uint64_t shutdown_token = base::RandUint64();
-  ScopedKernelHANDLE thread_handles[kPipeInstances];
-  for (size_t i = 0; i < std::size(thread_handles); ++i) {
+
+  // Without a pool, each pipe instance has its own thread. With a pool, only
+  // an inherited first instance, which wasn’t created for overlapped I/O, has
+  // its own thread.
+  const bool pooled = pipe_instances_ > 0;
+  size_t thread_instances = kPipeInstances;
+  size_t pooled_instances = 0;
+  DWORD max_instances = kPipeInstances;
+  if (pooled) {
+    thread_instances = first_pipe_instance_.is_valid() ? 1 : 0;
+    max_instances = static_cast<DWORD>(pipe_instances_);
+    if (first_pipe_instance_.is_valid() &&
+        !GetNamedPipeInfo(first_pipe_instance_.get(),
+                          nullptr,
+                          nullptr,
+                          nullptr,
+                          &max_instances)) {
+      PLOG(ERROR) << "GetNamedPipeInfo";
+      max_instances = kPipeInstances;
+    }
+    size_t instances = pipe_instances_;
+    if (max_instances != PIPE_UNLIMITED_INSTANCES &&
+        instances > max_instances) {
+      LOG(WARNING) << "pipe allows " << max_instances << " instances, not "
+                   << instances;
+      instances = max_instances;
+    }
+    pooled_instances = instances - std::min(instances, thread_instances);
+  }
+
+  std::vector<ScopedKernelHANDLE> thread_handles(thread_instances);
+  for (size_t i = 0; i < thread_handles.size(); ++i) {
     HANDLE pipe;
     if (first_pipe_instance_.is_valid()) {
       pipe = first_pipe_instance_.release();
@@ -324,12 +508,63 @@ void ExceptionHandlerServer::Run(Delegate* delegate) {
                                          delegate,
                                          &clients_lock_,
                                          &clients_,
+                                         dump_semaphore_.get(),
                                          shutdown_token);
     thread_handles[i].reset(
         CreateThread(nullptr, 0, &PipeServiceProc, context, 0, nullptr));
     PCHECK(thread_handles[i].is_valid()) << "CreateThread";
   }
 
+  // The pooled instances share a completion port, keyed by instance. A null
+  // key tells a pool thread to exit.
+  ScopedKernelHANDLE pool_port;
+  std::vector<std::unique_ptr<internal::PooledPipeInstance>> pool_instances;
+  std::vector<ScopedKernelHANDLE> pool_threads;
+  if (pooled_instances > 0) {
+    SYSTEM_INFO system_info;
+    GetSystemInfo(&system_info);
+    const size_t pool_thread_count = std::min(
+        pooled_instances,
+        std::max(static_cast<size_t>(system_info.dwNumberOfProcessors),
+                 size_t{1}));
+
+    pool_port.reset(
+        CreateIoCompletionPort(INVALID_HANDLE_VALUE,
+                               nullptr,
+                               0,
+                               static_cast<DWORD>(pool_thread_count)));
+    PCHECK(pool_port.is_valid()) << "CreateIoCompletionPort";
+
+    for (size_t i = 0; i < pooled_instances; ++i) {
+      HANDLE pipe = CreateNamedPipeInstance(
+          pipe_name_, thread_instances == 0 && i == 0, true, max_instances);
+      PCHECK(pipe != INVALID_HANDLE_VALUE) << "CreateNamedPipe";
+      auto instance =
+          std::make_unique<internal::PooledPipeInstance>(port_.get(),
+                                                         pipe,
+                                                         delegate,
+                                                         &clients_lock_,
+                                                         &clients_,
+                                                         dump_semaphore_.get(),
+                                                         shutdown_token);
+      PCHECK(CreateIoCompletionPort(pipe,
+                                    pool_port.get(),
+                                    reinterpret_cast<ULONG_PTR>(instance.get()),
+                                    0)) << "CreateIoCompletionPort";
+      pool_instances.push_back(std::move(instance));
+    }
+
+    for (size_t i = 0; i < pool_thread_count; ++i) {
+      pool_threads.emplace_back(CreateThread(
+          nullptr, 0, &PipePoolProc, pool_port.get(), 0, nullptr));
+      PCHECK(pool_threads.back().is_valid()) << "CreateThread";
+    }
+
+    for (auto& instance : pool_instances) {
+      ConnectPooledPipeInstance(instance.get());
+    }
+  }
+
   delegate->ExceptionHandlerServerStarted();
 
   // This is the main loop of the server. Most work is done on the threadpool,
@@ -357,8 +592,27 @@ void ExceptionHandlerServer::Run(Delegate* delegate) {
       break;
   }
 
+  // Stop the pool first, so that the shutdown requests below can only be
+  // received by the instances that have their own threads. Each pool thread
+  // exits on the first null key it receives.
+  for (size_t i = 0; i < pool_threads.size(); ++i) {
+    PostQueuedCompletionStatus(pool_port.get(), 0, 0, nullptr);
+  }
+  for (auto& handle : pool_threads)
+    WaitForSingleObject(handle.get(), INFINITE);
+  for (auto& instance : pool_instances) {
+    if (instance->io_pending) {
+      // The OVERLAPPED must stay valid until the cancelled operation is done.
+      HANDLE pipe = instance->context.pipe();
+      CancelIoEx(pipe, &instance->overlapped);
+      DWORD bytes;
+      GetOverlappedResult(pipe, &instance->overlapped, &bytes, true);
+    }
+  }
+  pool_instances.clear();
+
   // Signal to the named pipe instances that they should terminate.
-  for (size_t i = 0; i < std::size(thread_handles); ++i) {
+  for (size_t i = 0; i < thread_handles.size(); ++i) {
     ClientToServerMessage message;
     memset(&message, 0, sizeof(message));
     message.type = ClientToServerMessage::kShutdown;
@@ -400,6 +654,27 @@ bool ExceptionHandlerServer::ServiceClientConnection(
           service_context.pipe(), &message, sizeof(message)))
     return false;
 
+  ServerToClientMessage response;
+  bool shutdown;
+  if (HandleClientMessage(service_context, message, &response, &shutdown)) {
+    LoggingWriteFile(service_context.pipe(), &response, sizeof(response));
+  }
+  return shutdown;
+}
+
+// Handles a message received from a client on service_context.pipe(). Returns
+// true if response should be written back to the client. shutdown is set to
+// whether this was a valid shutdown request.
+//
+// static
+bool ExceptionHandlerServer::HandleClientMessage(
+    const internal::PipeServiceContext& service_context,
+    const ClientToServerMessage& message,
+    ServerToClientMessage* response,
+    bool* shutdown) {
+  *shutdown = false;
+  *response = {};
+
   switch (message.type) {
     case ClientToServerMessage::kShutdown: {
       if (message.shutdown.token != service_context.shutdown_token()) {
@@ -407,24 +682,18 @@ bool ExceptionHandlerServer::ServiceClientConnection(
                    << message.shutdown.token;
         return false;
       }
-      ServerToClientMessage shutdown_response = {};
-      LoggingWriteFile(service_context.pipe(),
-                       &shutdown_response,
-                       sizeof(shutdown_response));
+      *shutdown = true;
       return true;
     }
 
     case ClientToServerMessage::kPing: {
       // No action required, the fact that the message was processed is
       // sufficient.
-      ServerToClientMessage shutdown_response = {};
-      LoggingWriteFile(service_context.pipe(),
-                       &shutdown_response,
-                       sizeof(shutdown_response));
-      return false;
+      return true;
     }
 
     case ClientToServerMessage::kRegister:
+    case ClientToServerMessage::kRegisterChild:
       // Handled below.
       break;
 
@@ -439,18 +708,26 @@ bool ExceptionHandlerServer::ServiceClientConnection(
     return false;
   }
 
+  // A child is registered by its parent, which must be the pipe’s client.
+  const bool register_child =
+      message.type == ClientToServerMessage::kRegisterChild;
+  DWORD real_pid = 0;
   decltype(GetNamedPipeClientProcessId)* get_named_pipe_client_process_id =
       GetNamedPipeClientProcessIdFunction();
   if (get_named_pipe_client_process_id) {
     // GetNamedPipeClientProcessId is only available on Vista+.
-    DWORD real_pid = 0;
     if (get_named_pipe_client_process_id(service_context.pipe(), &real_pid) &&
+        !register_child &&
         message.registration.client_process_id != real_pid) {
       LOG(ERROR) << "forged client pid, real pid: " << real_pid
                  << ", got: " << message.registration.client_process_id;
       return false;
     }
   }
+  if (register_child && real_pid == 0) {
+    LOG(ERROR) << "child registration requires the parent's pid";
+    return false;
+  }
 
   // We attempt to open the process as us. This is the main case that should
   // almost always succeed as the server will generally be more privileged. If
@@ -473,6 +750,16 @@ bool ExceptionHandlerServer::ServiceClientConnection(
     }
   }
 
+  if (register_child) {
+    const ProcessID parent_pid = GetParentProcessID(client_process);
+    if (parent_pid != real_pid) {
+      LOG(ERROR) << "forged child registration, parent pid: " << parent_pid
+                 << ", got: " << real_pid;
+      CloseHandle(client_process);
+      return false;
+    }
+  }
+
   internal::ClientData* client;
   {
     base::AutoLock lock(*service_context.clients_lock());
@@ -489,6 +776,7 @@ bool ExceptionHandlerServer::ServiceClientConnection(
         message.registration.crash_exception_information,
         message.registration.non_crash_exception_information,
         message.registration.critical_section_address,
+        service_context.dump_semaphore(),
         &OnCrashDumpEvent,
         &OnNonCrashDumpEvent,
         &OnProcessEnd);
@@ -496,21 +784,16 @@ bool ExceptionHandlerServer::ServiceClientConnection(
   }
 
   // Duplicate the events back to the client so they can request a dump.
-  ServerToClientMessage response;
-  response.registration.request_crash_dump_event =
+  response->registration.request_crash_dump_event =
       HandleToInt(DuplicateEvent(
           client->process(), client->crash_dump_requested_event()));
-  response.registration.request_non_crash_dump_event =
+  response->registration.request_non_crash_dump_event =
       HandleToInt(DuplicateEvent(
           client->process(), client->non_crash_dump_requested_event()));
-  response.registration.non_crash_dump_completed_event =
+  response->registration.non_crash_dump_completed_event =
       HandleToInt(DuplicateEvent(
           client->process(), client->non_crash_dump_completed_event()));
-
-  if (!LoggingWriteFile(service_context.pipe(), &response, sizeof(response)))
-    return false;
-
-  return false;
+  return true;
 }
 
 // static
@@ -534,6 +817,128 @@ DWORD __stdcall ExceptionHandlerServer::PipeServiceProc(void* ctx) {
   return 0;
 }
 
+// static
+DWORD __stdcall ExceptionHandlerServer::PipePoolProc(void* ctx) {
+  HANDLE pool_port = ctx;
+
+  for (;;) {
+    DWORD bytes = 0;
+    ULONG_PTR key = 0;
+    OVERLAPPED* ov = nullptr;
+    bool ret =
+        !!GetQueuedCompletionStatus(pool_port, &bytes, &key, &ov, INFINITE);
+    DWORD error = ret ? ERROR_SUCCESS : GetLastError();
+    if (!ret && !ov) {
+      PLOG(ERROR) << "GetQueuedCompletionStatus";
+      break;
+    }
+    if (!key) {
+      // Shutting down.
+      break;
+    }
+
+    internal::PooledPipeInstance* instance =
+        reinterpret_cast<internal::PooledPipeInstance*>(key);
+    instance->io_pending = false;
+    ServicePooledPipeInstance(instance, error, bytes);
+  }
+
+  return 0;
+}
+
+// Waits for a client to connect to instance's pipe.
+//
+// static
+void ExceptionHandlerServer::ConnectPooledPipeInstance(
+    internal::PooledPipeInstance* instance) {
+  for (;;) {
+    instance->state = internal::PooledPipeInstance::State::kConnecting;
+    instance->overlapped = {};
+
+    // This is set before the operation starts, because another pool thread
+    // may receive its completion before ConnectNamedPipe() returns.
+    instance->io_pending = true;
+    if (ConnectNamedPipe(instance->context.pipe(), &instance->overlapped)) {
+      return;
+    }
+
+    switch (GetLastError()) {
+      case ERROR_IO_PENDING:
+        return;
+
+      case ERROR_PIPE_CONNECTED:
+        // A client connected before the call, and no completion will be
+        // posted. This loops instead of going through
+        // ServicePooledPipeInstance(), which would call back here, so that
+        // clients that keep connecting and failing can’t grow the stack.
+        instance->io_pending = false;
+        if (StartPooledRead(instance)) {
+          return;
+        }
+        DisconnectNamedPipe(instance->context.pipe());
+        break;
+
+      default:
+        // The instance stops listening, but the others carry on.
+        PLOG(ERROR) << "ConnectNamedPipe";
+        instance->io_pending = false;
+        return;
+    }
+  }
+}
+
+// Continues servicing instance after its last operation completed with error
+// and transferred bytes.
+//
+// static
+void ExceptionHandlerServer::ServicePooledPipeInstance(
+    internal::PooledPipeInstance* instance,
+    DWORD error,
+    DWORD bytes) {
+  using State = internal::PooledPipeInstance::State;
+
+  switch (instance->state) {
+    case State::kConnecting:
+      if (error != ERROR_SUCCESS && error != ERROR_PIPE_CONNECTED) {
+        SetLastError(error);
+        PLOG(ERROR) << "ConnectNamedPipe";
+      } else if (StartPooledRead(instance)) {
+        return;
+      }
+      break;
+
+    case State::kReading: {
+      if (error != ERROR_SUCCESS || bytes != sizeof(instance->message)) {
+        SetLastError(error);
+        PLOG(ERROR) << "ReadFile";
+        break;
+      }
+
+      // A pooled instance keeps listening after a shutdown request, which is
+      // only meant for the instances that have their own threads.
+      bool shutdown;
+      if (HandleClientMessage(instance->context,
+                              instance->message,
+                              &instance->response,
+                              &shutdown) &&
+          StartPooledWrite(instance)) {
+        return;
+      }
+      break;
+    }
+
+    case State::kWriting:
+      if (error != ERROR_SUCCESS || bytes != sizeof(instance->response)) {
+        SetLastError(error);
+        PLOG(ERROR) << "WriteFile";
+      }
+      break;
+  }
+
+  DisconnectNamedPipe(instance->context.pipe());
+  ConnectPooledPipeInstance(instance);
+}
+
 // static
 void __stdcall ExceptionHandlerServer::OnCrashDumpEvent(void* ctx, BOOLEAN) {
   // This function is executed on the thread pool.
@@ -541,6 +946,7 @@ void __stdcall ExceptionHandlerServer::OnCrashDumpEvent(void* ctx, BOOLEAN) {
   base::AutoLock lock(*client->lock());
 
   // Capture the exception.
+  ScopedDumpSlot dump_slot(client->dump_semaphore());
   unsigned int exit_code = client->delegate()->ExceptionHandlerServerException(
       client->process(),
       client->crash_exception_information_address(),
@@ -556,10 +962,13 @@ void __stdcall ExceptionHandlerServer::OnNonCrashDumpEvent(void* ctx, BOOLEAN) {
   base::AutoLock lock(*client->lock());
 
   // Capture the exception.
-  client->delegate()->ExceptionHandlerServerException(
-      client->process(),
-      client->non_crash_exception_information_address(),
-      client->debug_critical_section_address());
+  {
+    ScopedDumpSlot dump_slot(client->dump_semaphore());
+    client->delegate()->ExceptionHandlerServerException(
+        client->process(),
+        client->non_crash_exception_information_address(),
+        client->debug_critical_section_address());
+  }
 
   bool result = !!SetEvent(client->non_crash_dump_completed_event());
   PLOG_IF(ERROR, !result) << "SetEvent";
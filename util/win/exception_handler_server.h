@@ -22,6 +22,7 @@
 #include "util/file/file_io.h"
 #include "util/win/address_types.h"
 #include "util/win/initial_client_data.h"
+#include "util/win/registration_protocol_win_structs.h"
 #include "util/win/scoped_handle.h"
 
 namespace crashpad {
@@ -29,6 +30,7 @@ namespace crashpad {
 namespace internal {
 class PipeServiceContext;
 class ClientData;
+struct PooledPipeInstance;
 }  // namespace internal
 
 //! \brief Runs the main exception-handling server in Crashpad's handler
@@ -103,6 +105,44 @@ class ExceptionHandlerServer {
       const InitialClientData& initial_client_data,
       Delegate* delegate);
 
+  //! \brief Sets the maximum number of crash dumps, of different clients, to
+  //!     write at the same time.
+  //!
+  //! By default, dump requests are serviced by callbacks on the system thread
+  //! pool that the pool doesn’t expect to block, so when several clients crash
+  //! together, their dumps mostly wait for each other. When \a
+  //! max_concurrent_dumps is greater than 1, the callbacks are marked as
+  //! long-running, so that each runs on its own worker, and a semaphore limits
+  //! how many of them write a dump at once. Dumps of one client are still
+  //! written one at a time.
+  //!
+  //! This method must be called before
+  //! InitializeWithInheritedDataForInitialClient() and Run().
+  //!
+  //! \param[in] max_concurrent_dumps The number of dumps to write at once.
+  void SetMaxConcurrentDumps(size_t max_concurrent_dumps);
+
+  //! \brief Services client registrations on overlapped pipe instances
+  //!     shared by a pool of threads, instead of on kPipeInstances instances
+  //!     that each have their own thread.
+  //!
+  //! The pool has a thread for each processor, up to \a pipe_instances. This
+  //! lets registrations from many clients starting at once proceed in
+  //! parallel.
+  //!
+  //! All instances of a pipe must be created with the same maximum number of
+  //! instances, so if the first pipe instance was inherited with
+  //! InitializeWithInheritedDataForInitialClient(), no more instances are
+  //! created than it allows. That instance wasn’t created for overlapped I/O,
+  //! and keeps its own thread.
+  //!
+  //! This method must be called before Run().
+  //!
+  //! \param[in] pipe_instances The number of pipe instances to listen on, at
+  //!     most `PIPE_UNLIMITED_INSTANCES`. If `0`, each of kPipeInstances
+  //!     instances has its own thread.
+  void SetPipeInstances(size_t pipe_instances);
+
   //! \brief Runs the exception-handling server.
   //!
   //! \param[in] delegate The interface to which the exceptions are delegated
@@ -120,7 +160,17 @@ class ExceptionHandlerServer {
  private:
   static bool ServiceClientConnection(
       const internal::PipeServiceContext& service_context);
+  static bool HandleClientMessage(
+      const internal::PipeServiceContext& service_context,
+      const ClientToServerMessage& message,
+      ServerToClientMessage* response,
+      bool* shutdown);
   static DWORD __stdcall PipeServiceProc(void* ctx);
+  static DWORD __stdcall PipePoolProc(void* ctx);
+  static void ConnectPooledPipeInstance(internal::PooledPipeInstance* instance);
+  static void ServicePooledPipeInstance(internal::PooledPipeInstance* instance,
+                                        DWORD error,
+                                        DWORD bytes);
   static void __stdcall OnCrashDumpEvent(void* ctx, BOOLEAN);
   static void __stdcall OnNonCrashDumpEvent(void* ctx, BOOLEAN);
   static void __stdcall OnProcessEnd(void* ctx, BOOLEAN);
@@ -131,6 +181,8 @@ class ExceptionHandlerServer {
 
   base::Lock clients_lock_;
   std::set<internal::ClientData*> clients_;
+  ScopedKernelHANDLE dump_semaphore_;
+  size_t pipe_instances_;
 
   bool persistent_;
 };
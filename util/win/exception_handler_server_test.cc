@@ -15,14 +15,17 @@
 #include "util/win/exception_handler_server.h"
 
 #include <windows.h>
+#include <string.h>
 #include <sys/types.h>
 
+#include <memory>
 #include <string>
 #include <vector>
 
 #include "base/strings/utf_string_conversions.h"
 #include "client/crashpad_client.h"
 #include "gtest/gtest.h"
+#include "test/errors.h"
 #include "test/win/win_child_process.h"
 #include "util/thread/thread.h"
 #include "util/win/address_types.h"
@@ -218,6 +221,146 @@ TEST_F(ExceptionHandlerServerTest, MultipleConnections) {
   }
 }
 
+// Services registrations on a pool of overlapped pipe instances.
+class ExceptionHandlerServerPoolTest : public ExceptionHandlerServerTest {
+ public:
+  static constexpr size_t kPipeInstances = 4;
+
+  ExceptionHandlerServerPoolTest() : ExceptionHandlerServerTest() {
+    server().SetPipeInstances(kPipeInstances);
+  }
+
+  ExceptionHandlerServerPoolTest(const ExceptionHandlerServerPoolTest&) =
+      delete;
+  ExceptionHandlerServerPoolTest& operator=(
+      const ExceptionHandlerServerPoolTest&) = delete;
+};
+
+bool Ping(const std::wstring& pipe_name) {
+  ClientToServerMessage message;
+  memset(&message, 0, sizeof(message));
+  message.type = ClientToServerMessage::kPing;
+  ServerToClientMessage response;
+  return SendToCrashHandlerServer(pipe_name, message, &response);
+}
+
+// Pings the server repeatedly.
+class PingThread : public Thread {
+ public:
+  static constexpr int kPings = 20;
+
+  explicit PingThread(const std::wstring& pipe_name)
+      : pipe_name_(pipe_name), pings_(0) {}
+
+  PingThread(const PingThread&) = delete;
+  PingThread& operator=(const PingThread&) = delete;
+
+  ~PingThread() override {}
+
+  // The number of pings that succeeded.
+  int pings() const { return pings_; }
+
+ private:
+  // Thread:
+  void ThreadMain() override {
+    for (int i = 0; i < kPings; ++i) {
+      if (Ping(pipe_name_)) {
+        ++pings_;
+      }
+    }
+  }
+
+  std::wstring pipe_name_;
+  int pings_;
+};
+
+TEST_F(ExceptionHandlerServerPoolTest, StartAndStop) {
+  // Each pooled instance is waiting for a connection when the server is
+  // stopped, and stopping cancels those waits.
+  server_thread().Start();
+  ScopedStopServerAndJoinThread scoped_stop_server_and_join_thread(
+      &server(), &server_thread());
+  ASSERT_NO_FATAL_FAILURE(delegate().WaitForStart());
+}
+
+TEST_F(ExceptionHandlerServerPoolTest, StopWithPendingRead) {
+  // The client is destroyed after the server is stopped.
+  ScopedFileHANDLE client;
+
+  server_thread().Start();
+  ScopedStopServerAndJoinThread scoped_stop_server_and_join_thread(
+      &server(), &server_thread());
+  ASSERT_NO_FATAL_FAILURE(delegate().WaitForStart());
+
+  // This client connects but never sends a message, so the instance that it
+  // connected to is waiting to read one when the server is stopped.
+  client.reset(CreateFile(pipe_name().c_str(),
+                          GENERIC_READ | GENERIC_WRITE,
+                          0,
+                          nullptr,
+                          OPEN_EXISTING,
+                          SECURITY_SQOS_PRESENT | SECURITY_IDENTIFICATION,
+                          nullptr));
+  ASSERT_TRUE(client.is_valid()) << ErrorMessage("CreateFile");
+
+  // The other instances are still listening.
+  EXPECT_TRUE(Ping(pipe_name()));
+}
+
+TEST_F(ExceptionHandlerServerPoolTest, Ping) {
+  server_thread().Start();
+  ScopedStopServerAndJoinThread scoped_stop_server_and_join_thread(
+      &server(), &server_thread());
+  ASSERT_NO_FATAL_FAILURE(delegate().WaitForStart());
+
+  EXPECT_TRUE(Ping(pipe_name()));
+  EXPECT_TRUE(Ping(pipe_name()));
+}
+
+TEST_F(ExceptionHandlerServerPoolTest, ConcurrentPings) {
+  server_thread().Start();
+  ScopedStopServerAndJoinThread scoped_stop_server_and_join_thread(
+      &server(), &server_thread());
+  ASSERT_NO_FATAL_FAILURE(delegate().WaitForStart());
+
+  // More clients than pipe instances connect at once, so some find every
+  // instance busy, and instances are reconnected while clients wait.
+  std::vector<std::unique_ptr<PingThread>> threads;
+  for (size_t i = 0; i < kPipeInstances * 2; ++i) {
+    threads.push_back(std::make_unique<PingThread>(pipe_name()));
+    threads.back()->Start();
+  }
+  for (auto& thread : threads) {
+    thread->Join();
+    EXPECT_EQ(thread->pings(), PingThread::kPings);
+  }
+}
+
+TEST_F(ExceptionHandlerServerPoolTest, ConcurrentRegistrations) {
+  WinChildProcess::EntryPoint<TestClient>();
+
+  std::vector<std::unique_ptr<WinChildProcess::Handles>> handles;
+  for (size_t i = 0; i < kPipeInstances * 2; ++i) {
+    handles.push_back(WinChildProcess::Launch());
+  }
+
+  // Must ensure the delegate outlasts the server.
+  {
+    server_thread().Start();
+    ScopedStopServerAndJoinThread scoped_stop_server_and_join_thread(
+        &server(), &server_thread());
+    ASSERT_NO_FATAL_FAILURE(delegate().WaitForStart());
+
+    // Tell all the children where to connect, so that they register at once.
+    for (auto& child : handles) {
+      WriteWString(child->write.get(), pipe_name());
+    }
+    for (auto& child : handles) {
+      ASSERT_EQ(ReadWString(child->read.get()), L"OK");
+    }
+  }
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace crashpad
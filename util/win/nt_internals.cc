@@ -32,6 +32,13 @@ NTSTATUS NTAPI NtCreateThreadEx(PHANDLE ThreadHandle,
                                 SIZE_T MaximumStackSize,
                                 PVOID /*PPS_ATTRIBUTE_LIST*/ AttributeList);
 
+NTSTATUS NTAPI NtGetNextThread(HANDLE ProcessHandle,
+                               HANDLE ThreadHandle,
+                               ACCESS_MASK DesiredAccess,
+                               ULONG HandleAttributes,
+                               ULONG Flags,
+                               HANDLE* NewThreadHandle);
+
 NTSTATUS NTAPI NtOpenThread(HANDLE* ThreadHandle,
                             ACCESS_MASK DesiredAccess,
                             OBJECT_ATTRIBUTES* ObjectAttributes,
@@ -122,6 +129,22 @@ NTSTATUS NtOpenThread(PHANDLE thread_handle,
       const_cast<CLIENT_ID*>(reinterpret_cast<const CLIENT_ID*>(client_id)));
 }
 
+NTSTATUS NtGetNextThread(HANDLE process_handle,
+                         HANDLE thread_handle,
+                         ACCESS_MASK desired_access,
+                         ULONG handle_attributes,
+                         ULONG flags,
+                         HANDLE* new_thread_handle) {
+  static const auto nt_get_next_thread =
+      GET_FUNCTION_REQUIRED(L"ntdll.dll", ::NtGetNextThread);
+  return nt_get_next_thread(process_handle,
+                            thread_handle,
+                            desired_access,
+                            handle_attributes,
+                            flags,
+                            new_thread_handle);
+}
+
 NTSTATUS NtQueryObject(HANDLE handle,
                        OBJECT_INFORMATION_CLASS object_information_class,
                        void* object_information,
@@ -22,6 +22,8 @@
 
 // Copied from ntstatus.h because um/winnt.h conflicts with general inclusion of
 // ntstatus.h.
+#define STATUS_NO_MORE_ENTRIES ((NTSTATUS)0x8000001AL)
+#define STATUS_INVALID_INFO_CLASS ((NTSTATUS)0xC0000003L)
 #define STATUS_INFO_LENGTH_MISMATCH ((NTSTATUS)0xC0000004L)
 #define STATUS_BUFFER_TOO_SMALL ((NTSTATUS)0xC0000023L)
 #define STATUS_PROCESS_IS_TERMINATING ((NTSTATUS)0xC000010AL)
@@ -45,6 +47,9 @@ NtCreateThreadEx(PHANDLE thread_handle,
                  SIZE_T maximum_stack_size,
                  PVOID /*PPS_ATTRIBUTE_LIST*/ attribute_list);
 
+// winternal.h defines PROCESSINFOCLASS, but not all members.
+enum { ProcessHandleInformation = 51 };
+
 // winternal.h defines THREADINFOCLASS, but not all members.
 enum { ThreadBasicInformation = 0 };
 
@@ -69,6 +74,13 @@ NTSTATUS NtOpenThread(PHANDLE thread_handle,
                       POBJECT_ATTRIBUTES object_attributes,
                       const process_types::CLIENT_ID<Traits>* client_id);
 
+NTSTATUS NtGetNextThread(HANDLE process_handle,
+                         HANDLE thread_handle,
+                         ACCESS_MASK desired_access,
+                         ULONG handle_attributes,
+                         ULONG flags,
+                         HANDLE* new_thread_handle);
+
 NTSTATUS NtQueryObject(HANDLE handle,
                        OBJECT_INFORMATION_CLASS object_information_class,
                        void* object_information,
@@ -18,10 +18,13 @@
 #include <winternl.h>
 
 #include <algorithm>
+#include <atomic>
 #include <limits>
+#include <map>
 #include <memory>
 #include <new>
 #include <type_traits>
+#include <utility>
 
 #include "base/logging.h"
 #include "base/memory/free_deleter.h"
@@ -177,6 +180,44 @@ std::unique_ptr<uint8_t[]> QueryObject(
   return buffer;
 }
 
+// The buffer sizes that were last large enough to hold the handle information,
+// used as the starting sizes for the next query, so that later snapshots
+// don’t have to repeat the search for a size that fits.
+std::atomic<ULONG> g_process_handle_buffer_size(64 * 1024);
+std::atomic<ULONG> g_system_handle_buffer_size(2 * 1024 * 1024);
+
+// Returns the name of the type of handle, which is open in process, or an
+// empty string if the handle can’t be duplicated.
+std::wstring HandleTypeName(HANDLE process, HANDLE handle) {
+  HANDLE dup_handle;
+  if (!DuplicateHandle(process,
+                       handle,
+                       GetCurrentProcess(),
+                       &dup_handle,
+                       0,
+                       false,
+                       DUPLICATE_SAME_ACCESS)) {
+    return std::wstring();
+  }
+  ScopedKernelHANDLE scoped_dup_handle(dup_handle);
+
+  std::unique_ptr<uint8_t[]> object_type_information_buffer =
+      QueryObject(dup_handle,
+                  ObjectTypeInformation,
+                  sizeof(PUBLIC_OBJECT_TYPE_INFORMATION));
+  if (!object_type_information_buffer) {
+    return std::wstring();
+  }
+
+  PUBLIC_OBJECT_TYPE_INFORMATION* object_type_information =
+      reinterpret_cast<PUBLIC_OBJECT_TYPE_INFORMATION*>(
+          object_type_information_buffer.get());
+  DCHECK_EQ(object_type_information->TypeName.Length % sizeof(wchar_t), 0u);
+  return std::wstring(object_type_information->TypeName.Buffer,
+                      object_type_information->TypeName.Length /
+                          sizeof(wchar_t));
+}
+
 }  // namespace
 
 template <class Traits>
@@ -345,7 +386,102 @@ bool ReadMemoryInfo(HANDLE process, bool is_64_bit, ProcessInfo* process_info) {
 
 std::vector<ProcessInfo::Handle> ProcessInfo::BuildHandleVector(
     HANDLE process) const {
-  ULONG buffer_size = 2 * 1024 * 1024;
+  std::vector<Handle> handles;
+  if (BuildHandleVectorFromProcessSnapshot(process, &handles)) {
+    return handles;
+  }
+  return BuildHandleVectorFromSystemSnapshot(process);
+}
+
+bool ProcessInfo::BuildHandleVectorFromProcessSnapshot(
+    HANDLE process,
+    std::vector<Handle>* handles) const {
+  // STATUS_INFO_LENGTH_MISMATCH returns the size needed, but handles may be
+  // opened before the next attempt, so leave some room and retry a few times.
+  ULONG buffer_size = g_process_handle_buffer_size;
+  NTSTATUS status;
+  ULONG returned_length;
+  UniqueMallocPtr buffer;
+  for (int tries = 0; tries < 5; ++tries) {
+    buffer.reset();
+    buffer = UncheckedAllocate(buffer_size);
+    if (!buffer) {
+      LOG(ERROR) << "UncheckedAllocate";
+      return false;
+    }
+
+    returned_length = 0;
+    status = crashpad::NtQueryInformationProcess(
+        process,
+        static_cast<PROCESSINFOCLASS>(ProcessHandleInformation),
+        buffer.get(),
+        buffer_size,
+        &returned_length);
+    if (NT_SUCCESS(status) || status != STATUS_INFO_LENGTH_MISMATCH)
+      break;
+
+    buffer_size = std::max(buffer_size * 2, returned_length + 4096);
+  }
+
+  if (!NT_SUCCESS(status)) {
+    // Windows versions before 8 don’t have ProcessHandleInformation.
+    if (status != STATUS_INVALID_INFO_CLASS) {
+      NTSTATUS_LOG(ERROR, status)
+          << "NtQueryInformationProcess ProcessHandleInformation";
+    }
+    return false;
+  }
+  g_process_handle_buffer_size = buffer_size;
+
+  const auto& process_handle_snapshot_information =
+      *reinterpret_cast<process_types::PROCESS_HANDLE_SNAPSHOT_INFORMATION*>(
+          buffer.get());
+
+  DCHECK_LE(
+      offsetof(process_types::PROCESS_HANDLE_SNAPSHOT_INFORMATION, Handles) +
+          process_handle_snapshot_information.NumberOfHandles *
+              sizeof(process_handle_snapshot_information.Handles[0]),
+      returned_length);
+
+  // The counts are taken from the target process’ handle table, so the only
+  // thing that requires duplicating a handle is its type name. That’s looked
+  // up once per object type, rather than once per handle.
+  std::map<ULONG, std::wstring> type_names;
+
+  handles->clear();
+  handles->reserve(process_handle_snapshot_information.NumberOfHandles);
+  for (size_t i = 0; i < process_handle_snapshot_information.NumberOfHandles;
+       ++i) {
+    const auto& handle = process_handle_snapshot_information.Handles[i];
+
+    Handle result_handle;
+    result_handle.handle = HandleToInt(handle.HandleValue);
+    result_handle.attributes = handle.HandleAttributes;
+    result_handle.granted_access = handle.GrantedAccess;
+    result_handle.pointer_count = static_cast<uint32_t>(handle.PointerCount);
+    result_handle.handle_count = static_cast<uint32_t>(handle.HandleCount);
+
+    auto type_name = type_names.find(handle.ObjectTypeIndex);
+    if (type_name == type_names.end()) {
+      // Some handles cannot be duplicated, for example, handles of type
+      // EtwRegistration. An empty name is remembered for those too, so that
+      // the many handles of such types don’t each attempt it.
+      type_name = type_names
+                      .insert(std::make_pair(
+                          handle.ObjectTypeIndex,
+                          HandleTypeName(process, handle.HandleValue)))
+                      .first;
+    }
+    result_handle.type_name = type_name->second;
+
+    handles->push_back(result_handle);
+  }
+  return true;
+}
+
+std::vector<ProcessInfo::Handle>
+ProcessInfo::BuildHandleVectorFromSystemSnapshot(HANDLE process) const {
+  ULONG buffer_size = g_system_handle_buffer_size;
   // Typically if the buffer were too small, STATUS_INFO_LENGTH_MISMATCH would
   // return the correct size in the final argument, but it does not for
   // SystemExtendedHandleInformation, so we loop and attempt larger sizes.
@@ -376,6 +512,7 @@ std::vector<ProcessInfo::Handle> ProcessInfo::BuildHandleVector(
         << "NtQuerySystemInformation SystemExtendedHandleInformation";
     return std::vector<Handle>();
   }
+  g_system_handle_buffer_size = buffer_size;
 
   const auto& system_handle_information_ex =
       *reinterpret_cast<process_types::SYSTEM_HANDLE_INFORMATION_EX*>(
@@ -387,6 +524,7 @@ std::vector<ProcessInfo::Handle> ProcessInfo::BuildHandleVector(
             returned_length);
 
   std::vector<Handle> handles;
+  std::map<USHORT, std::wstring> type_names;
 
   for (size_t i = 0; i < system_handle_information_ex.NumberOfHandles; ++i) {
     const auto& handle = system_handle_information_ex.Handles[i];
@@ -438,23 +576,15 @@ std::vector<ProcessInfo::Handle> ProcessInfo::BuildHandleVector(
         result_handle.handle_count = object_basic_information->HandleCount - 1;
       }
 
-      std::unique_ptr<uint8_t[]> object_type_information_buffer =
-          QueryObject(dup_handle,
-                      ObjectTypeInformation,
-                      sizeof(PUBLIC_OBJECT_TYPE_INFORMATION));
-      if (object_type_information_buffer) {
-        PUBLIC_OBJECT_TYPE_INFORMATION* object_type_information =
-            reinterpret_cast<PUBLIC_OBJECT_TYPE_INFORMATION*>(
-                object_type_information_buffer.get());
-
-        DCHECK_EQ(object_type_information->TypeName.Length %
-                      sizeof(result_handle.type_name[0]),
-                  0u);
-        result_handle.type_name =
-            std::wstring(object_type_information->TypeName.Buffer,
-                         object_type_information->TypeName.Length /
-                             sizeof(result_handle.type_name[0]));
+      auto type_name = type_names.find(handle.ObjectTypeIndex);
+      if (type_name == type_names.end()) {
+        type_name = type_names
+                        .insert(std::make_pair(
+                            handle.ObjectTypeIndex,
+                            HandleTypeName(process, handle.HandleValue)))
+                        .first;
       }
+      result_handle.type_name = type_name->second;
     }
 
     handles.push_back(result_handle);
@@ -715,4 +845,33 @@ std::vector<CheckedRange<WinVMAddress, WinVMSize>> GetReadableRangesOfMemoryMap(
   return result;
 }
 
+crashpad::ProcessID GetParentProcessID(HANDLE process) {
+  // NtQueryInformationProcess() returns the structure native to this process,
+  // even when \a process is running under WOW64.
+#if defined(ARCH_CPU_64_BITS)
+  process_types::PROCESS_BASIC_INFORMATION<process_types::internal::Traits64>
+      process_basic_information;
+#else
+  process_types::PROCESS_BASIC_INFORMATION<process_types::internal::Traits32>
+      process_basic_information;
+#endif  // ARCH_CPU_64_BITS
+  ULONG bytes_returned;
+  NTSTATUS status =
+      crashpad::NtQueryInformationProcess(process,
+                                          ProcessBasicInformation,
+                                          &process_basic_information,
+                                          sizeof(process_basic_information),
+                                          &bytes_returned);
+  if (!NT_SUCCESS(status)) {
+    NTSTATUS_LOG(ERROR, status) << "NtQueryInformationProcess";
+    return 0;
+  }
+  if (bytes_returned != sizeof(process_basic_information)) {
+    LOG(ERROR) << "NtQueryInformationProcess incorrect size";
+    return 0;
+  }
+  return static_cast<DWORD>(
+      process_basic_information.InheritedFromUniqueProcessId);
+}
+
 }  // namespace crashpad
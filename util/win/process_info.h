@@ -174,8 +174,16 @@ class ProcessInfo {
                              bool is_64_bit,
                              ProcessInfo* process_info);
 
-  // This function is best-effort under low memory conditions.
+  // These functions are best-effort under low memory conditions.
+  // BuildHandleVector() uses BuildHandleVectorFromProcessSnapshot() where the
+  // system supports querying a single process’ handles (Windows 8 and later),
+  // and otherwise BuildHandleVectorFromSystemSnapshot(), which must retrieve
+  // and filter every handle in the system.
   std::vector<Handle> BuildHandleVector(HANDLE process) const;
+  bool BuildHandleVectorFromProcessSnapshot(HANDLE process,
+                                            std::vector<Handle>* handles) const;
+  std::vector<Handle> BuildHandleVectorFromSystemSnapshot(
+      HANDLE process) const;
 
   crashpad::ProcessID process_id_;
   crashpad::ProcessID inherited_from_process_id_;
@@ -217,6 +225,18 @@ std::vector<CheckedRange<WinVMAddress, WinVMSize>> GetReadableRangesOfMemoryMap(
     const CheckedRange<WinVMAddress, WinVMSize>& range,
     const ProcessInfo::MemoryBasicInformation64Vector& memory_info);
 
+//! \brief Returns the process ID of the process that created \a process.
+//!
+//! Unlike ProcessInfo::ParentProcessID(), this doesn’t read the process’
+//! memory, so it can be used for a process that was created suspended and
+//! hasn’t started running yet.
+//!
+//! \param[in] process A handle to the process, with `PROCESS_QUERY_INFORMATION`
+//!     or `PROCESS_QUERY_LIMITED_INFORMATION` access.
+//!
+//! \return The parent’s process ID, or `0` on failure with a message logged.
+crashpad::ProcessID GetParentProcessID(HANDLE process);
+
 }  // namespace crashpad
 
 #endif  // CRASHPAD_UTIL_WIN_PROCESS_INFO_H_
@@ -0,0 +1,75 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/win/process_va_clone.h"
+
+#include "base/check.h"
+#include "base/logging.h"
+#include "util/win/get_function.h"
+
+namespace crashpad {
+
+ProcessVaClone::ProcessVaClone() : snapshot_(nullptr), clone_handle_(nullptr) {}
+
+ProcessVaClone::~ProcessVaClone() {
+  if (snapshot_) {
+    // The free function is only called once the capture function was found.
+    static const auto pss_free_snapshot =
+        GET_FUNCTION_REQUIRED(L"kernel32.dll", ::PssFreeSnapshot);
+    DWORD result = pss_free_snapshot(GetCurrentProcess(), snapshot_);
+    if (result != ERROR_SUCCESS) {
+      SetLastError(result);
+      PLOG(ERROR) << "PssFreeSnapshot";
+    }
+  }
+}
+
+bool ProcessVaClone::Initialize(HANDLE process) {
+  DCHECK(!snapshot_);
+
+  static const auto pss_capture_snapshot =
+      GET_FUNCTION(L"kernel32.dll", ::PssCaptureSnapshot);
+  static const auto pss_query_snapshot =
+      GET_FUNCTION(L"kernel32.dll", ::PssQuerySnapshot);
+  if (!pss_capture_snapshot || !pss_query_snapshot) {
+    LOG(ERROR) << "PssCaptureSnapshot not available";
+    return false;
+  }
+
+  HPSS snapshot;
+  DWORD result =
+      pss_capture_snapshot(process, PSS_CAPTURE_VA_CLONE, 0, &snapshot);
+  if (result != ERROR_SUCCESS) {
+    SetLastError(result);
+    PLOG(ERROR) << "PssCaptureSnapshot";
+    return false;
+  }
+  snapshot_ = snapshot;
+
+  PSS_VA_CLONE_INFORMATION clone_information;
+  result = pss_query_snapshot(snapshot_,
+                              PSS_QUERY_VA_CLONE_INFORMATION,
+                              &clone_information,
+                              sizeof(clone_information));
+  if (result != ERROR_SUCCESS) {
+    SetLastError(result);
+    PLOG(ERROR) << "PssQuerySnapshot";
+    return false;
+  }
+
+  clone_handle_ = clone_information.VaCloneHandle;
+  return true;
+}
+
+}  // namespace crashpad
@@ -0,0 +1,62 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_UTIL_WIN_PROCESS_VA_CLONE_H_
+#define CRASHPAD_UTIL_WIN_PROCESS_VA_CLONE_H_
+
+#include <windows.h>
+#include <processsnapshot.h>
+
+namespace crashpad {
+
+//! \brief Makes a copy-on-write clone of another process’ address space with
+//!     `PssCaptureSnapshot()`.
+//!
+//! The clone’s memory can be read with `ReadProcessMemory()` through
+//! handle(), and keeps the contents that the process’ memory had when the
+//! clone was made, regardless of what the process does afterwards. This allows
+//! a suspended process to be resumed while its memory is still being read.
+//!
+//! Cloning requires Windows 8.1 or later.
+class ProcessVaClone {
+ public:
+  ProcessVaClone();
+
+  ProcessVaClone(const ProcessVaClone&) = delete;
+  ProcessVaClone& operator=(const ProcessVaClone&) = delete;
+
+  //! \brief Frees the clone, if one was made.
+  ~ProcessVaClone();
+
+  //! \brief Clones the address space of \a process.
+  //!
+  //! \param[in] process The process to clone, which must have been opened with
+  //!     `PROCESS_CREATE_PROCESS`, `PROCESS_DUP_HANDLE`,
+  //!     `PROCESS_QUERY_INFORMATION` and `PROCESS_VM_READ` access. To get a
+  //!     consistent view of its memory, the caller should suspend it first.
+  //!
+  //! \return `true` on success, or `false` with a message logged.
+  bool Initialize(HANDLE process);
+
+  //! \brief Returns a handle to the clone, valid for as long as this object.
+  HANDLE handle() const { return clone_handle_; }
+
+ private:
+  HPSS snapshot_;
+  HANDLE clone_handle_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_UTIL_WIN_PROCESS_VA_CLONE_H_
@@ -0,0 +1,49 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/win/process_va_clone.h"
+
+#include "gtest/gtest.h"
+#include "test/errors.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+TEST(ProcessVaClone, ReadsMemoryAsCloned) {
+  volatile int value = 1234;
+
+  ProcessVaClone clone;
+  ASSERT_TRUE(clone.Initialize(GetCurrentProcess()));
+  ASSERT_TRUE(clone.handle());
+
+  value = 5678;
+
+  // The clone keeps the value that was in memory when it was made.
+  int cloned_value = 0;
+  SIZE_T bytes_read = 0;
+  ASSERT_TRUE(ReadProcessMemory(clone.handle(),
+                                const_cast<int*>(&value),
+                                &cloned_value,
+                                sizeof(cloned_value),
+                                &bytes_read))
+      << ErrorMessage("ReadProcessMemory");
+  EXPECT_EQ(bytes_read, sizeof(cloned_value));
+  EXPECT_EQ(cloned_value, 1234);
+  EXPECT_EQ(value, 5678);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
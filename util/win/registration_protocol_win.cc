@@ -141,7 +141,9 @@ bool SendToCrashHandlerServer(const std::wstring& pipe_name,
 }
 
 HANDLE CreateNamedPipeInstance(const std::wstring& pipe_name,
-                               bool first_instance) {
+                               bool first_instance,
+                               bool overlapped,
+                               DWORD max_instances) {
   SECURITY_ATTRIBUTES security_attributes;
   SECURITY_ATTRIBUTES* security_attributes_pointer = nullptr;
 
@@ -160,11 +162,17 @@ HANDLE CreateNamedPipeInstance(const std::wstring& pipe_name,
     }
   }
 
+  if (!max_instances) {
+    max_instances = ExceptionHandlerServer::kPipeInstances;
+  }
+
   return CreateNamedPipe(
       pipe_name.c_str(),
-      PIPE_ACCESS_DUPLEX | (first_instance ? FILE_FLAG_FIRST_PIPE_INSTANCE : 0),
+      PIPE_ACCESS_DUPLEX |
+          (first_instance ? FILE_FLAG_FIRST_PIPE_INSTANCE : 0) |
+          (overlapped ? FILE_FLAG_OVERLAPPED : 0),
       PIPE_TYPE_MESSAGE | PIPE_READMODE_MESSAGE | PIPE_WAIT,
-      ExceptionHandlerServer::kPipeInstances,
+      max_instances,
       512,
       512,
       0,
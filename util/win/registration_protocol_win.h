@@ -44,8 +44,15 @@ bool SendToCrashHandlerServer(const std::wstring& pipe_name,
 //!     pipe name is not already in use when created. The first instance will be
 //!     created with an untrusted integrity SACL so instances of this pipe can
 //!     be connected to by processes of any integrity level.
+//! \param[in] overlapped If `true`, the named pipe instance will be created
+//!     with `FILE_FLAG_OVERLAPPED`.
+//! \param[in] max_instances The maximum number of instances of the pipe,
+//!     which must be the same for all instances. If `0`,
+//!     ExceptionHandlerServer::kPipeInstances.
 HANDLE CreateNamedPipeInstance(const std::wstring& pipe_name,
-                               bool first_instance);
+                               bool first_instance,
+                               bool overlapped = false,
+                               DWORD max_instances = 0);
 
 //! \brief Returns the `SECURITY_DESCRIPTOR` blob that will be used for creating
 //!     the connection pipe in CreateNamedPipeInstance().
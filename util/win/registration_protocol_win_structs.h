@@ -131,6 +131,14 @@ struct ClientToServerMessage {
     //!     No data is required, this just confirms that the server is ready to
     //!     accept client registrations.
     kPing,
+
+    //! \brief For RegistrationRequest, sent by a registered client on behalf
+    //!     of a child process that it created.
+    //!
+    //! RegistrationRequest::client_process_id is the child’s, the addresses are
+    //! in the child’s address space, and the events in the response are valid
+    //! in the child. The server only accepts this from the child’s parent.
+    kRegisterChild,
   } type;
 
   union {
@@ -47,6 +47,11 @@ class ScopedProcessSuspend {
   //! terminating, this method may be called to suppress that error message.
   void TolerateTermination();
 
+  //! \brief Resumes the other process before this object is destroyed.
+  //!
+  //! After this is called, destroying the object does nothing.
+  void Resume();
+
  private:
   HANDLE process_;
   bool tolerate_termination_ = false;